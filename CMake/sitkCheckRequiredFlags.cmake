@@ -41,6 +41,16 @@ if(MINGW)
   list(APPEND SimpleITK_PRIVATE_COMPILE_OPTIONS "-Wa,-mbig-obj" )
 endif()
 
+# The kernels dispatched at run-time for the instruction set of the
+# processor are not to contract into FMA, so the results are the same
+# for all instruction sets.
+if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+  check_cxx_compiler_flag( "-ffp-contract=off" SimpleITK_HAS_FP_CONTRACT_OFF )
+  if(SimpleITK_HAS_FP_CONTRACT_OFF)
+    list(APPEND SimpleITK_PRIVATE_COMPILE_OPTIONS "-ffp-contract=off" )
+  endif()
+endif()
+
 
 #
 # Search CMAKE_CXX_FLAGS for flags that should be considered required,
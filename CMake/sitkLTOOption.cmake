@@ -0,0 +1,23 @@
+#
+# Add the SimpleITK_USE_LTO CMake option to compile the SimpleITK
+# libraries, the wrapping modules and the executables with link-time
+# optimization, with CMake's INTERPROCEDURAL_OPTIMIZATION property.
+#
+# The calls from the Execute methods through the member function
+# factories to the ITK filters are in different translation units,
+# and are only inlined across them with link-time optimization.
+#
+include_guard(GLOBAL)
+
+option( SimpleITK_USE_LTO "Compile SimpleITK and the wrapping with link-time optimization." OFF )
+mark_as_advanced( SimpleITK_USE_LTO )
+
+if ( SimpleITK_USE_LTO )
+  include( CheckIPOSupported )
+  check_ipo_supported( RESULT _sitk_ipo_supported OUTPUT _sitk_ipo_output LANGUAGES CXX )
+  if ( NOT _sitk_ipo_supported )
+    message( FATAL_ERROR "Link-time optimization is not supported by the compiler: ${_sitk_ipo_output}" )
+  endif()
+  message( STATUS "Enabling link-time optimization" )
+  set( CMAKE_INTERPROCEDURAL_OPTIMIZATION ON )
+endif()
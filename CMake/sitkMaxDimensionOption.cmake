@@ -10,6 +10,10 @@ if(MSVC AND MSVC_VERSION VERSION_LESS 1900)
   set( SimpleITK_MAX_DIMENSION_DEFAULT 3 )
 endif()
 
+if ( SimpleITK_PIXEL_TYPE_PROFILE STREQUAL "Minimal" )
+  set( SimpleITK_MAX_DIMENSION_DEFAULT 3 )
+endif()
+
 if (DEFINED SimpleITK_4D_Image)
   message(WARNING "SimpleITK variable \"SimpleITK_4D_Image\" is \
                    deprecated set \"SimpleITK_MAX_DIMENSION\" instead." )
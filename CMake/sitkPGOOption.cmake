@@ -0,0 +1,93 @@
+#
+# A common CMake file for consistently initializing and verifying the
+# SimpleITK_PGO_MODE CMake variable, for profile-guided optimization
+# of the SimpleITK libraries and the wrapping with GCC or Clang.
+#
+# The optimization is in three steps, with the same profile directory:
+#
+#  1. Configure a build with SimpleITK_PGO_MODE=Generate and
+#  SimpleITK_BUILD_BENCHMARKS=ON, and build it. The libraries are
+#  instrumented.
+#  2. Build the "SimpleITKPGOTraining" target. It runs the benchmarks
+#  which write the profiles into SimpleITK_PGO_PROFILE_DIRECTORY, and
+#  merges them with llvm-profdata for Clang.
+#  3. Reconfigure the same build tree with SimpleITK_PGO_MODE=Use,
+#  usually with SimpleITK_USE_LTO=ON, and build it. The libraries are
+#  rebuilt optimized with the profiles.
+#
+# GCC finds the profiles by the paths of the object files, so steps 1
+# and 3 are to be in the same build tree with the same compiler and
+# sources. The functions without profiles, such as the filters not run
+# by the training, are optimized as usual where the compiler supports
+# it.
+#
+include_guard(GLOBAL)
+
+set( SimpleITK_PGO_MODE "None"
+  CACHE STRING "The step of the profile-guided optimization (None, Generate or Use)." )
+set_property( CACHE SimpleITK_PGO_MODE PROPERTY STRINGS "None" "Generate" "Use" )
+mark_as_advanced( SimpleITK_PGO_MODE )
+
+set( SimpleITK_PGO_PROFILE_DIRECTORY "${CMAKE_BINARY_DIR}/PGOProfiles"
+  CACHE PATH "The directory of the profiles written by the training for the profile-guided optimization." )
+mark_as_advanced( SimpleITK_PGO_PROFILE_DIRECTORY )
+
+if ( NOT SimpleITK_PGO_MODE MATCHES "^(None|Generate|Use)$" )
+  message( FATAL_ERROR "Expect \"SimpleITK_PGO_MODE\" as \"None\", \"Generate\" or \"Use\" but got \"${SimpleITK_PGO_MODE}\"." )
+endif()
+
+set( _sitk_pgo_flags "" )
+set( _sitk_pgo_compile_flags "" )
+
+if ( NOT SimpleITK_PGO_MODE STREQUAL "None" )
+
+  if ( NOT CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang" )
+    message( FATAL_ERROR "The profile-guided optimization is only supported with GCC and Clang, not \"${CMAKE_CXX_COMPILER_ID}\"." )
+  endif()
+
+  # Clang's profiles are merged into one file
+  set( SimpleITK_PGO_CLANG_PROFILE "${SimpleITK_PGO_PROFILE_DIRECTORY}/SimpleITK.profdata" )
+
+  if ( SimpleITK_PGO_MODE STREQUAL "Generate" )
+    file( MAKE_DIRECTORY "${SimpleITK_PGO_PROFILE_DIRECTORY}" )
+    if ( CMAKE_CXX_COMPILER_ID STREQUAL "GNU" )
+      # the counters are updated by the threads of the filters
+      set( _sitk_pgo_flags "-fprofile-generate=${SimpleITK_PGO_PROFILE_DIRECTORY}" "-fprofile-update=atomic" )
+    else()
+      set( _sitk_pgo_flags "-fprofile-generate=${SimpleITK_PGO_PROFILE_DIRECTORY}" )
+      string( REGEX MATCH "^[0-9]+" _sitk_clang_major "${CMAKE_CXX_COMPILER_VERSION}" )
+      get_filename_component( _sitk_clang_dir "${CMAKE_CXX_COMPILER}" DIRECTORY )
+      find_program( LLVM_PROFDATA_EXECUTABLE
+        NAMES llvm-profdata llvm-profdata-${_sitk_clang_major}
+        HINTS "${_sitk_clang_dir}"
+        DOC "The llvm-profdata executable merging the profiles of Clang." )
+      mark_as_advanced( LLVM_PROFDATA_EXECUTABLE )
+      if ( NOT LLVM_PROFDATA_EXECUTABLE )
+        message( FATAL_ERROR "The llvm-profdata executable is required to merge the profiles of Clang, set \"LLVM_PROFDATA_EXECUTABLE\"." )
+      endif()
+    endif()
+  else()
+    if ( CMAKE_CXX_COMPILER_ID STREQUAL "GNU" )
+      # the sources not run by the training have no profile
+      set( _sitk_pgo_flags "-fprofile-use=${SimpleITK_PGO_PROFILE_DIRECTORY}" "-fprofile-correction" )
+      set( _sitk_pgo_compile_flags "-Wno-missing-profile" )
+      # without it, the functions not run by the training are
+      # optimized for size
+      include( CheckCXXCompilerFlag )
+      check_cxx_compiler_flag( "-fprofile-partial-training" SimpleITK_HAS_PROFILE_PARTIAL_TRAINING )
+      if ( SimpleITK_HAS_PROFILE_PARTIAL_TRAINING )
+        list( APPEND _sitk_pgo_flags "-fprofile-partial-training" )
+      endif()
+    else()
+      if ( NOT EXISTS "${SimpleITK_PGO_CLANG_PROFILE}" )
+        message( FATAL_ERROR "The merged profile \"${SimpleITK_PGO_CLANG_PROFILE}\" does not exist, run the \"SimpleITKPGOTraining\" target of the \"Generate\" build." )
+      endif()
+      set( _sitk_pgo_flags "-fprofile-use=${SimpleITK_PGO_CLANG_PROFILE}" )
+      set( _sitk_pgo_compile_flags "-Wno-profile-instr-unprofiled" "-Wno-profile-instr-out-of-date" )
+    endif()
+  endif()
+
+  message( STATUS "Profile-guided optimization: ${SimpleITK_PGO_MODE} with \"${SimpleITK_PGO_PROFILE_DIRECTORY}\"" )
+  add_compile_options( ${_sitk_pgo_flags} ${_sitk_pgo_compile_flags} )
+  add_link_options( ${_sitk_pgo_flags} )
+endif()
@@ -0,0 +1,21 @@
+#
+# A common CMake file for consistently initializing and verifying the
+# SimpleITK_PIXEL_TYPE_PROFILE CMake variable.
+#
+# The "Full" profile instantiates the generated filters for all the
+# pixel types in their JSON description. The "Minimal" profile only
+# instantiates the generated filters for the uint8, uint16, int16 and
+# float32 scalar, vector and label pixel types, and defaults the
+# maximum image dimension to 3, to reduce the size of the libraries.
+#
+
+set( SimpleITK_PIXEL_TYPE_PROFILE "Full"
+  CACHE STRING "The pixel types instantiated for the generated image filters (Full or Minimal)." )
+set_property( CACHE SimpleITK_PIXEL_TYPE_PROFILE PROPERTY STRINGS "Full" "Minimal" )
+mark_as_advanced( SimpleITK_PIXEL_TYPE_PROFILE )
+
+if ( SimpleITK_PIXEL_TYPE_PROFILE STREQUAL "Minimal" )
+  set( SITK_PIXEL_TYPE_PROFILE_MINIMAL 1 )
+elseif ( NOT SimpleITK_PIXEL_TYPE_PROFILE STREQUAL "Full" )
+  message(FATAL_ERROR "Expect \"SimpleITK_PIXEL_TYPE_PROFILE\" as \"Full\" or \"Minimal\" but got \"${SimpleITK_PIXEL_TYPE_PROFILE}\".")
+endif()
@@ -124,5 +124,7 @@ sitk_check_dynamic_lookup(MODULE
   )
 
 include(sitkStripOption)
+include(sitkLTOOption)
+include(sitkPGOOption)
 include(sitkForbidDownloadsOption)
 include(sitkSITKLegacyNaming)
@@ -0,0 +1,61 @@
+#
+# A common CMake file for consistently initializing and verifying the
+# SimpleITK_TRACE_RANGE_BACKEND CMake variable.
+#
+# The backend annotates the Execute methods, the updates of the ITK
+# filters and the IO of SimpleITK with begin and end ranges for the
+# Intel ITT API (VTune), the NVIDIA Tools Extension (Nsight Systems)
+# or the Tracy profiler. The annotations are only emitted at run-time
+# when the SITK_TRACE_RANGES environment variable is enabled, and are
+# compiled out with the "None" backend.
+#
+
+set( SimpleITK_TRACE_RANGE_BACKEND "None"
+  CACHE STRING "The profiler annotating the execution ranges (None, ITT, NVTX or Tracy)." )
+set_property( CACHE SimpleITK_TRACE_RANGE_BACKEND PROPERTY STRINGS "None" "ITT" "NVTX" "Tracy" )
+mark_as_advanced( SimpleITK_TRACE_RANGE_BACKEND )
+
+set( SimpleITK_TRACE_RANGE_INCLUDE_DIRS "" )
+set( SimpleITK_TRACE_RANGE_LIBRARIES "" )
+
+if ( SimpleITK_TRACE_RANGE_BACKEND STREQUAL "ITT" )
+  find_path( ITT_INCLUDE_DIR ittnotify.h
+    HINTS ENV VTUNE_PROFILER_DIR ENV VTUNE_PROFILER_2023_DIR
+    PATH_SUFFIXES include sdk/include
+    DOC "Path to the file ittnotify.h of the Intel ITT API." )
+  find_library( ITT_LIBRARY NAMES ittnotify libittnotify
+    HINTS ENV VTUNE_PROFILER_DIR ENV VTUNE_PROFILER_2023_DIR
+    PATH_SUFFIXES lib64 lib sdk/lib64 sdk/lib32
+    DOC "The static ittnotify library of the Intel ITT API." )
+  mark_as_advanced( ITT_INCLUDE_DIR ITT_LIBRARY )
+  if ( NOT ITT_INCLUDE_DIR OR NOT ITT_LIBRARY )
+    message(FATAL_ERROR "The Intel ITT API is required by the \"ITT\" trace range backend, set \"ITT_INCLUDE_DIR\" and \"ITT_LIBRARY\".")
+  endif()
+  set( SITK_TRACE_RANGE_ITT 1 )
+  set( SimpleITK_TRACE_RANGE_INCLUDE_DIRS ${ITT_INCLUDE_DIR} )
+  set( SimpleITK_TRACE_RANGE_LIBRARIES ${ITT_LIBRARY} ${CMAKE_DL_LIBS} )
+elseif ( SimpleITK_TRACE_RANGE_BACKEND STREQUAL "NVTX" )
+  # NVTX version 3 is header only, and loads the tool with the
+  # NVTX_INJECTION64_PATH environment variable set by the profiler
+  find_path( NVTX_INCLUDE_DIR nvtx3/nvToolsExt.h
+    HINTS ENV CUDA_PATH ENV CUDA_HOME
+    PATH_SUFFIXES include
+    DOC "Path to the directory of the NVTX 3 headers." )
+  mark_as_advanced( NVTX_INCLUDE_DIR )
+  if ( NOT NVTX_INCLUDE_DIR )
+    message(FATAL_ERROR "The NVTX 3 headers are required by the \"NVTX\" trace range backend, set \"NVTX_INCLUDE_DIR\".")
+  endif()
+  set( SITK_TRACE_RANGE_NVTX 1 )
+  set( SimpleITK_TRACE_RANGE_INCLUDE_DIRS ${NVTX_INCLUDE_DIR} )
+  set( SimpleITK_TRACE_RANGE_LIBRARIES ${CMAKE_DL_LIBS} )
+elseif ( SimpleITK_TRACE_RANGE_BACKEND STREQUAL "Tracy" )
+  find_package( Tracy REQUIRED CONFIG )
+  set( SITK_TRACE_RANGE_TRACY 1 )
+  set( SimpleITK_TRACE_RANGE_LIBRARIES Tracy::TracyClient )
+elseif ( NOT SimpleITK_TRACE_RANGE_BACKEND STREQUAL "None" )
+  message(FATAL_ERROR "Expect \"SimpleITK_TRACE_RANGE_BACKEND\" as \"None\", \"ITT\", \"NVTX\" or \"Tracy\" but got \"${SimpleITK_TRACE_RANGE_BACKEND}\".")
+endif()
+
+if ( NOT SimpleITK_TRACE_RANGE_BACKEND STREQUAL "None" )
+  set( SITK_TRACE_RANGES 1 )
+endif()
@@ -0,0 +1,114 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkAutomaticConvolutionImageFilter_h
+#define itkAutomaticConvolutionImageFilter_h
+
+#include "itkConvolutionImageFilter.h"
+#include "itkPreparedKernelFFTConvolutionImageFilter.h"
+
+
+namespace itk {
+
+/** \class AutomaticConvolutionImageFilter
+ * \brief Convolution in the spatial domain or by FFT, whichever is
+ * estimated to be faster.
+ *
+ * With AutomaticFFT off, the default, the filter is the
+ * ConvolutionImageFilter. With AutomaticFFT on, the cost of the
+ * spatial convolution, the number of output pixels times the number
+ * of kernel pixels, is compared to the cost of the FFT convolution,
+ * FFTCostFactor times the number of pixels of the padded input times
+ * its base 2 logarithm, and the convolution is computed by a kept
+ * PreparedKernelFFTConvolutionImageFilter when it is cheaper, with the
+ * same Normalize flag, boundary condition and output region mode. The
+ * results of the two methods differ by the rounding of the transforms.
+ *
+ * \sa ConvolutionImageFilter, FFTConvolutionImageFilter
+ */
+template < class TInputImage, class TKernelImage = TInputImage, class TOutputImage = TInputImage >
+class AutomaticConvolutionImageFilter:
+    public ConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = AutomaticConvolutionImageFilter;
+  using Superclass = ConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using KernelImageType = TKernelImage;
+  using OutputImageType = TOutputImage;
+
+  using FFTConvolutionFilterType = PreparedKernelFFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(AutomaticConvolutionImageFilter, ConvolutionImageFilter);
+
+  /** Compute the convolution by FFT when it is estimated to be
+   * faster. Off by default. */
+  itkSetMacro( AutomaticFFT, bool );
+  itkGetConstMacro( AutomaticFFT, bool );
+  itkBooleanMacro( AutomaticFFT );
+
+  /** The relative cost of a pixel of the FFT convolution, 6 by
+   * default: two forward and one inverse transform of complex
+   * values. */
+  itkSetMacro( FFTCostFactor, double );
+  itkGetConstMacro( FFTCostFactor, double );
+
+  /** Whether the last update used the FFT convolution. */
+  itkGetConstMacro( UsedFFT, bool );
+
+  /** The estimate used by an update with AutomaticFFT. */
+  bool IsFFTFaster() const;
+
+protected:
+
+  AutomaticConvolutionImageFilter() = default;
+
+  ~AutomaticConvolutionImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The FFT convolution is used when it is estimated to be faster.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  AutomaticConvolutionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool   m_AutomaticFFT{false};
+  double m_FFTCostFactor{6.0};
+  bool   m_UsedFFT{false};
+
+  typename FFTConvolutionFilterType::Pointer m_FFTConvolutionFilter;
+};
+
+
+} // end namespace itk
+
+
+#include "itkAutomaticConvolutionImageFilter.hxx"
+
+#endif // itkAutomaticConvolutionImageFilter_h
@@ -0,0 +1,113 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkAutomaticConvolutionImageFilter_hxx
+#define itkAutomaticConvolutionImageFilter_hxx
+
+#include "itkAutomaticConvolutionImageFilter.h"
+
+#include "itkProgressAccumulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// IsFFTFaster
+//
+template < class TInputImage, class TKernelImage, class TOutputImage >
+bool
+AutomaticConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >::IsFFTFaster() const
+{
+  const typename OutputImageType::RegionType outputRegion = this->GetOutput()->GetRequestedRegion();
+  const typename KernelImageType::SizeType kernelSize = this->GetKernelImage()->GetLargestPossibleRegion().GetSize();
+
+  // the input is padded by the size of the kernel for the FFT
+  double kernelPixels = 1.0;
+  double paddedPixels = 1.0;
+  for ( unsigned int d = 0; d < OutputImageType::ImageDimension; ++d )
+    {
+    kernelPixels *= static_cast<double>( kernelSize[d] );
+    paddedPixels *= static_cast<double>( outputRegion.GetSize( d ) + 2 * ( kernelSize[d] / 2 ) );
+    }
+  const double spatialCost = static_cast<double>( outputRegion.GetNumberOfPixels() ) * kernelPixels;
+  const double fftCost = m_FFTCostFactor * paddedPixels * std::log2( std::max( paddedPixels, 2.0 ) );
+  return fftCost < spatialCost;
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TKernelImage, class TOutputImage >
+void
+AutomaticConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >::GenerateData()
+{
+  m_UsedFFT = m_AutomaticFFT && this->IsFFTFaster();
+  if ( !m_UsedFFT )
+    {
+    m_FFTConvolutionFilter = nullptr;
+    Superclass::GenerateData();
+    return;
+    }
+
+  // the FFT filter is kept with the spectrum of the kernel
+  if ( m_FFTConvolutionFilter.IsNull() )
+    {
+    m_FFTConvolutionFilter = FFTConvolutionFilterType::New();
+    }
+
+  typename ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+
+  m_FFTConvolutionFilter->SetInput( this->GetInput() );
+  m_FFTConvolutionFilter->SetKernelImage( this->GetKernelImage() );
+  m_FFTConvolutionFilter->SetNormalize( this->GetNormalize() );
+  m_FFTConvolutionFilter->SetBoundaryCondition( this->GetBoundaryCondition() );
+  m_FFTConvolutionFilter->SetOutputRegionMode( this->GetOutputRegionMode() );
+  m_FFTConvolutionFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  progress->RegisterInternalFilter( m_FFTConvolutionFilter, 1.0f );
+
+  m_FFTConvolutionFilter->GraftOutput( this->GetOutput() );
+  m_FFTConvolutionFilter->Update();
+  this->GraftOutput( m_FFTConvolutionFilter->GetOutput() );
+
+  // the inputs are not kept with the spectrum
+  m_FFTConvolutionFilter->SetInput( nullptr );
+  m_FFTConvolutionFilter->SetKernelImage( nullptr );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TKernelImage, class TOutputImage >
+void
+AutomaticConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "AutomaticFFT: " << m_AutomaticFFT << std::endl;
+  os << indent << "FFTCostFactor: " << m_FFTCostFactor << std::endl;
+  os << indent << "UsedFFT: " << m_UsedFFT << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkAutomaticConvolutionImageFilter_hxx
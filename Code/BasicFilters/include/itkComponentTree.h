@@ -0,0 +1,772 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkComponentTree_h
+#define itkComponentTree_h
+
+#include "itkMultiThreaderBase.h"
+#include "itkOffset.h"
+#include "itkSize.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+
+namespace itk {
+
+/** \brief The component tree of the level sets of a pixel buffer, the
+ * max-tree of the upper level sets or the min-tree of the lower ones,
+ * built with union-find sweeps of the sorted pixels.
+ *
+ * TCompare orders the levels from the leaves to the roots: the
+ * default std::greater builds the max-tree, and std::less the
+ * min-tree. The pixels which are not after a boundary in this order
+ * are sorted, by counting for the integers of at most 16 bits, and are
+ * added one by one to a union-find forest, each pixel becoming the
+ * root of the components of its neighbors which are already added, so
+ * that the components of all the thresholds are merged in a single
+ * sweep. After the build, the parent of a node, the pixel which
+ * represents a component, is the node of the component it is merged
+ * into at a later level, and the parent of the other pixels is the
+ * node of their component, as in the max-tree of Berger et al. The
+ * areas of the nodes are accumulated during the build.
+ *
+ * The parallel build sweeps slabs of the last dimension in parallel,
+ * and merges the trees of neighboring slabs by pairs, connecting the
+ * branches of the pixels across their boundary as Wilkinson et al., in
+ * log2 of the number of slabs rounds. The sorted pixels of the slabs
+ * are merged along. The tree of an image is then built once, for the
+ * attributes of several queries from the leaves to the roots or back.
+ *
+ * The tree needs three 32 bit indices per pixel, and a fourth one
+ * during the build.
+ *
+ * References:
+ * C. Berger, T. Geraud, R. Levillain, N. Widynski, A. Baillard and E.
+ * Bertin, "Effective Component Tree Computation with Application to
+ * Pattern Recognition in Astronomical Imaging", ICIP 2007.
+ * M. H. F. Wilkinson, H. Gao, W. H. Hesselink, J.-E. Jonker and A.
+ * Meijster, "Concurrent Computation of Attribute Filters on Shared
+ * Memory Parallel Machines", IEEE PAMI, 30(10): 1800-1813, 2008.
+ */
+template < typename TPixel, unsigned int VDimension, typename TCompare = std::greater< TPixel > >
+class ComponentTree
+{
+public:
+  using PixelType = TPixel;
+  using SizeType = Size< VDimension >;
+  using CompareType = TCompare;
+  using PixelIndexType = uint32_t;
+
+  static constexpr unsigned int ImageDimension = VDimension;
+
+  /** The parent of the pixels which are not part of the tree. */
+  static constexpr PixelIndexType Excluded = std::numeric_limits< PixelIndexType >::max();
+
+  /** Whether the tree can index the pixels of an image of size. */
+  static bool
+  CanIndex( const SizeType &size )
+  {
+    double numberOfPixels = 1.0;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      numberOfPixels *= static_cast<double>( size[d] );
+      }
+    return numberOfPixels < static_cast<double>( Excluded );
+  }
+
+  /** The boundary of the tree of all the comparable values, as the
+   * upper boundary of a max-tree. */
+  static PixelType
+  GetBoundaryOfAllValues()
+  {
+    using Limits = std::numeric_limits< PixelType >;
+    const PixelType highest = Limits::has_infinity ? Limits::infinity() : Limits::max();
+    const PixelType lowest = Limits::has_infinity ? static_cast<PixelType>( -Limits::infinity() ) : Limits::lowest();
+    return TCompare()( highest, lowest ) ? highest : lowest;
+  }
+
+  /** Build the tree of the pixels of values, a buffer of size, which
+   * are the boundary or after it in the order of TCompare, with the
+   * face or the full connectivity of the neighbors, in one sequential
+   * sweep. areaChanged is called with the previous and the new area
+   * of a component when it is created (from 0 to 1), grows, or is
+   * merged into another one (to 0), and levelCompleted with the value
+   * of the pixels added last, after all the pixels of a value are
+   * added. */
+  template < typename TAreaChanged, typename TLevelCompleted >
+  void
+  BuildSequentially( const PixelType *values,
+                     const SizeType &size,
+                     bool fullyConnected,
+                     PixelType boundary,
+                     TAreaChanged &&areaChanged,
+                     TLevelCompleted &&levelCompleted )
+  {
+    this->Initialize( values, size, fullyConnected, boundary );
+
+    std::vector< PixelIndexType > unionFind( m_NumberOfPixels, Excluded );
+    m_SortedPixels.resize( this->CountSlab( 0, m_NumberOfPixels ) );
+    this->SortSlab( 0, m_NumberOfPixels, m_SortedPixels.data() );
+    this->SweepSlab( 0, m_SortedPixels.size(), 0, m_NumberOfPixels, unionFind, areaChanged, levelCompleted );
+  }
+
+  /** Build the tree with the threads of multiThreader, in slabs of the
+   * last dimension. */
+  void
+  Build( const PixelType *values,
+         const SizeType &size,
+         bool fullyConnected,
+         PixelType boundary,
+         MultiThreaderBase *multiThreader,
+         unsigned int numberOfWorkUnits )
+  {
+    this->Initialize( values, size, fullyConnected, boundary );
+
+    const SizeValueType numberOfPlanes = size[VDimension - 1];
+    const SizeValueType planeSize = m_NumberOfPixels / std::max< SizeValueType >( numberOfPlanes, 1 );
+    const SizeValueType numberOfSlabs = std::max< SizeValueType >( std::min< SizeValueType >( numberOfWorkUnits, numberOfPlanes ), 1 );
+    std::vector< SizeValueType > slabBegin( numberOfSlabs + 1 );
+    for ( SizeValueType k = 0; k <= numberOfSlabs; ++k )
+      {
+      slabBegin[k] = ( k * numberOfPlanes / numberOfSlabs ) * planeSize;
+      }
+
+    auto nullAreaChanged = []( SizeValueType, SizeValueType ) {};
+    auto nullLevelCompleted = []( PixelType ) {};
+
+    // the sorted pixels of each slab in its segment
+    std::vector< SizeValueType > segmentBegin( numberOfSlabs + 1, 0 );
+    multiThreader->SetNumberOfWorkUnits( std::max( numberOfWorkUnits, 1u ) );
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfSlabs,
+      [&]( SizeValueType k )
+        {
+          segmentBegin[k + 1] = this->CountSlab( slabBegin[k], slabBegin[k + 1] );
+        },
+      nullptr );
+    std::partial_sum( segmentBegin.begin(), segmentBegin.end(), segmentBegin.begin() );
+    m_SortedPixels.resize( segmentBegin[numberOfSlabs] );
+
+    // the trees of the slabs
+    std::vector< PixelIndexType > unionFind( m_NumberOfPixels, Excluded );
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfSlabs,
+      [&]( SizeValueType k )
+        {
+          this->SortSlab( slabBegin[k], slabBegin[k + 1], m_SortedPixels.data() + segmentBegin[k] );
+          this->SweepSlab( segmentBegin[k], segmentBegin[k + 1], slabBegin[k], slabBegin[k + 1], unionFind, nullAreaChanged, nullLevelCompleted );
+        },
+      nullptr );
+    if ( numberOfSlabs == 1 )
+      {
+      return;
+      }
+
+    // the trees of pairs of neighboring groups of slabs merged across
+    // their boundary, with their sorted pixels
+    const TCompare compare;
+    const PixelType *sortedValues = m_Values;
+    for ( SizeValueType step = 1; step < numberOfSlabs; step *= 2 )
+      {
+      const SizeValueType numberOfPairs = ( numberOfSlabs + 2 * step - 1 ) / ( 2 * step );
+      multiThreader->ParallelizeArray(
+        0,
+        numberOfPairs,
+        [&]( SizeValueType pair )
+          {
+            const SizeValueType first = pair * 2 * step;
+            const SizeValueType middle = first + step;
+            if ( middle >= numberOfSlabs )
+              {
+              return;
+              }
+            const SizeValueType last = std::min( middle + step, numberOfSlabs );
+            this->ConnectSlabs( slabBegin[middle], planeSize );
+            std::inplace_merge( m_SortedPixels.begin() + segmentBegin[first],
+                                m_SortedPixels.begin() + segmentBegin[middle],
+                                m_SortedPixels.begin() + segmentBegin[last],
+                                [&compare, sortedValues]( PixelIndexType a, PixelIndexType b )
+                                  {
+                                    return compare( sortedValues[a], sortedValues[b] );
+                                  } );
+          },
+        nullptr );
+      }
+
+    // the parents of the pixels as the nodes of their components, in
+    // the buffer of the union-find
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfSlabs,
+      [&]( SizeValueType k )
+        {
+          for ( SizeValueType p = slabBegin[k]; p < slabBegin[k + 1]; ++p )
+            {
+            const PixelIndexType parent = m_Parent[p];
+            if ( parent == Excluded )
+              {
+              unionFind[p] = Excluded;
+              continue;
+              }
+            const PixelIndexType node = this->FindLevelRoot( static_cast<PixelIndexType>( p ) );
+            if ( node != p )
+              {
+              unionFind[p] = node;
+              }
+            else
+              {
+              unionFind[p] = ( parent == p ) ? parent : this->FindLevelRoot( parent );
+              }
+            }
+        },
+      nullptr );
+    m_Parent.swap( unionFind );
+  }
+
+  /** The pixels of the tree, sorted by TCompare. */
+  const std::vector< PixelIndexType > &
+  GetSortedPixels() const
+  {
+    return m_SortedPixels;
+  }
+
+  /** The node of the component of a pixel, or of the component it is
+   * merged into for a node, or Excluded. */
+  PixelIndexType
+  GetParent( PixelIndexType p ) const
+  {
+    return m_Parent[p];
+  }
+
+  /** Whether the pixel is the root of a tree of the forest. */
+  bool
+  IsRoot( PixelIndexType p ) const
+  {
+    return m_Parent[p] == p;
+  }
+
+  /** Whether the pixel is the node of its component. */
+  bool
+  IsNode( PixelIndexType p ) const
+  {
+    return m_Parent[p] != Excluded && ( m_Parent[p] == p || m_Values[m_Parent[p]] != m_Values[p] );
+  }
+
+  /** The number of pixels of the component of a node. */
+  SizeValueType
+  GetArea( PixelIndexType node ) const
+  {
+    return m_Areas[node];
+  }
+
+  /** Call function with the pixels of the tree, each pixel before the
+   * node of its component, and each node before its parent. */
+  template < typename TFunction >
+  void
+  ForEachFromLeaves( TFunction &&function ) const
+  {
+    const SizeValueType numberOfSortedPixels = m_SortedPixels.size();
+    SizeValueType begin = 0;
+    while ( begin < numberOfSortedPixels )
+      {
+      const PixelType level = m_Values[m_SortedPixels[begin]];
+      SizeValueType end = begin + 1;
+      while ( end < numberOfSortedPixels && m_Values[m_SortedPixels[end]] == level )
+        {
+        ++end;
+        }
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        if ( !this->IsNode( m_SortedPixels[i] ) )
+          {
+          function( m_SortedPixels[i] );
+          }
+        }
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        if ( this->IsNode( m_SortedPixels[i] ) )
+          {
+          function( m_SortedPixels[i] );
+          }
+        }
+      begin = end;
+      }
+  }
+
+  /** Call function with the pixels of the tree, each node after its
+   * parent, and each pixel after the node of its component. */
+  template < typename TFunction >
+  void
+  ForEachFromRoots( TFunction &&function ) const
+  {
+    SizeValueType end = m_SortedPixels.size();
+    while ( end > 0 )
+      {
+      const PixelType level = m_Values[m_SortedPixels[end - 1]];
+      SizeValueType begin = end - 1;
+      while ( begin > 0 && m_Values[m_SortedPixels[begin - 1]] == level )
+        {
+        --begin;
+        }
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        if ( this->IsNode( m_SortedPixels[i] ) )
+          {
+          function( m_SortedPixels[i] );
+          }
+        }
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        if ( !this->IsNode( m_SortedPixels[i] ) )
+          {
+          function( m_SortedPixels[i] );
+          }
+        }
+      end = begin;
+      }
+  }
+
+  /** The attribute filter of the tree in output, a buffer of the
+   * pixels: the nodes for which keep is true, and the roots, keep
+   * their level, and the pixels of the other ones have the level of
+   * the closest of their ancestors which is kept. keep must be a
+   * decreasing criterion from the roots to the leaves for the filter
+   * to be idempotent. The pixels which are not in the tree are
+   * unchanged. */
+  template < typename TKeep, typename TOutputPixel >
+  void
+  FilterNodes( TKeep &&keep, TOutputPixel *output ) const
+  {
+    for ( SizeValueType p = 0; p < m_NumberOfPixels; ++p )
+      {
+      if ( m_Parent[p] == Excluded )
+        {
+        output[p] = static_cast<TOutputPixel>( m_Values[p] );
+        }
+      }
+    this->ForEachFromRoots(
+      [&]( PixelIndexType p )
+        {
+          const PixelIndexType parent = m_Parent[p];
+          const bool kept = ( parent == p ) || ( this->IsNode( p ) && keep( p ) );
+          output[p] = kept ? static_cast<TOutputPixel>( m_Values[p] ) : output[parent];
+        } );
+  }
+
+  /** The geodesic reconstruction of marker, the values of a marker
+   * image pixel by pixel, under the values of the tree, by dilation
+   * for a max-tree and by erosion for a min-tree, in output, a buffer
+   * of the pixels. The level of a pixel is the latest of its level and
+   * of the first marker of its component, when this marker is before
+   * the level of the parent component, and else the level of its
+   * parent; the marker is so bounded by the values. The pixels which
+   * are not in the tree are unchanged. */
+  template < typename TMarker >
+  void
+  Reconstruct( TMarker &&marker, PixelType *output ) const
+  {
+    const TCompare compare;
+
+    // the first marker of the components, from the leaves
+    for ( SizeValueType p = 0; p < m_NumberOfPixels; ++p )
+      {
+      output[p] = ( m_Parent[p] == Excluded ) ? m_Values[p] : static_cast<PixelType>( marker( static_cast<PixelIndexType>( p ) ) );
+      }
+    this->ForEachFromLeaves(
+      [&]( PixelIndexType p )
+        {
+          const PixelIndexType parent = m_Parent[p];
+          if ( parent != p && compare( output[p], output[parent] ) )
+            {
+            output[parent] = output[p];
+            }
+        } );
+
+    // the levels of the reconstruction, from the roots
+    this->ForEachFromRoots(
+      [&]( PixelIndexType p )
+        {
+          const PixelIndexType parent = m_Parent[p];
+          if ( !this->IsNode( p ) )
+            {
+            output[p] = output[parent];
+            return;
+            }
+          const PixelType first = output[p];
+          const PixelType level = compare( m_Values[p], first ) ? first : m_Values[p];
+          output[p] = ( parent == p || compare( first, m_Values[parent] ) ) ? level : output[parent];
+        } );
+  }
+
+  /** Release the buffers of the tree. */
+  void
+  Release()
+  {
+    m_SortedPixels = std::vector< PixelIndexType >();
+    m_Parent = std::vector< PixelIndexType >();
+    m_Areas = std::vector< PixelIndexType >();
+    m_Values = nullptr;
+  }
+
+private:
+  bool
+  IsIncluded( PixelType value ) const
+  {
+    return value == m_Boundary || TCompare()( m_Boundary, value );
+  }
+
+  void
+  Initialize( const PixelType *values, const SizeType &size, bool fullyConnected, PixelType boundary )
+  {
+    m_Values = values;
+    m_Size = size;
+    m_Boundary = boundary;
+    m_NumberOfPixels = 1;
+    OffsetValueType strides[VDimension];
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      strides[d] = static_cast<OffsetValueType>( m_NumberOfPixels );
+      m_NumberOfPixels *= size[d];
+      }
+
+    // the offsets of the neighbors, with the face or the full
+    // connectivity
+    m_Neighbors.clear();
+    m_NeighborOffsets.clear();
+    SizeValueType numberOfOffsets = 1;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      numberOfOffsets *= 3;
+      }
+    for ( SizeValueType n = 0; n < numberOfOffsets; ++n )
+      {
+      Offset< VDimension > offset;
+      SizeValueType position = n;
+      unsigned int nonZero = 0;
+      OffsetValueType linear = 0;
+      for ( unsigned int d = 0; d < VDimension; ++d )
+        {
+        offset[d] = static_cast<OffsetValueType>( position % 3 ) - 1;
+        position /= 3;
+        nonZero += ( offset[d] != 0 );
+        linear += offset[d] * strides[d];
+        }
+      if ( nonZero != 0 && ( fullyConnected || nonZero == 1 ) )
+        {
+        m_Neighbors.push_back( offset );
+        m_NeighborOffsets.push_back( linear );
+        }
+      }
+
+    m_Parent.assign( m_NumberOfPixels, Excluded );
+    m_Areas.assign( m_NumberOfPixels, 0 );
+  }
+
+  /** Whether the neighbor n of the pixel at index is in the image. */
+  bool
+  IsInside( const OffsetValueType *index, size_t n ) const
+  {
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      const OffsetValueType shifted = index[d] + m_Neighbors[n][d];
+      if ( shifted < 0 || shifted >= static_cast<OffsetValueType>( m_Size[d] ) )
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+
+  void
+  ComputeIndex( SizeValueType p, OffsetValueType *index ) const
+  {
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      index[d] = static_cast<OffsetValueType>( p % m_Size[d] );
+      p /= m_Size[d];
+      }
+  }
+
+  SizeValueType
+  CountSlab( SizeValueType pixelBegin, SizeValueType pixelEnd ) const
+  {
+    SizeValueType count = 0;
+    for ( SizeValueType p = pixelBegin; p < pixelEnd; ++p )
+      {
+      count += this->IsIncluded( m_Values[p] );
+      }
+    return count;
+  }
+
+  /** The pixels of a slab which are in the tree, sorted in sorted. */
+  void
+  SortSlab( SizeValueType pixelBegin, SizeValueType pixelEnd, PixelIndexType *sorted ) const
+  {
+    constexpr bool CountingSort = std::is_integral< PixelType >::value && sizeof( PixelType ) <= 2;
+    if ( CountingSort )
+      {
+      // the pixels of each value at the position of the number of
+      // pixels of the values before it
+      const double lowest = static_cast<double>( std::numeric_limits< PixelType >::lowest() );
+      const SizeValueType numberOfValues = static_cast<SizeValueType>( static_cast<double>( std::numeric_limits< PixelType >::max() ) - lowest ) + 1;
+      const bool decreasing = TCompare()( PixelType( 1 ), PixelType( 0 ) );
+      auto valueIndex = [lowest, numberOfValues, decreasing]( PixelType value )
+        {
+          const SizeValueType increasing = static_cast<SizeValueType>( static_cast<double>( value ) - lowest );
+          return decreasing ? numberOfValues - 1 - increasing : increasing;
+        };
+
+      std::vector< SizeValueType > positions( numberOfValues + 1, 0 );
+      for ( SizeValueType p = pixelBegin; p < pixelEnd; ++p )
+        {
+        if ( this->IsIncluded( m_Values[p] ) )
+          {
+          ++positions[valueIndex( m_Values[p] ) + 1];
+          }
+        }
+      std::partial_sum( positions.begin(), positions.end(), positions.begin() );
+      for ( SizeValueType p = pixelBegin; p < pixelEnd; ++p )
+        {
+        if ( this->IsIncluded( m_Values[p] ) )
+          {
+          sorted[positions[valueIndex( m_Values[p] )]++] = static_cast<PixelIndexType>( p );
+          }
+        }
+      }
+    else
+      {
+      // the values which are not comparable, as NaN, are excluded
+      SizeValueType count = 0;
+      for ( SizeValueType p = pixelBegin; p < pixelEnd; ++p )
+        {
+        if ( this->IsIncluded( m_Values[p] ) )
+          {
+          sorted[count++] = static_cast<PixelIndexType>( p );
+          }
+        }
+      const PixelType *values = m_Values;
+      const TCompare compare;
+      std::sort( sorted, sorted + count,
+                 [values, &compare]( PixelIndexType a, PixelIndexType b )
+                   {
+                     return compare( values[a], values[b] ) || ( values[a] == values[b] && a < b );
+                   } );
+      }
+  }
+
+  /** The union-find sweep of the sorted pixels of a slab, the roots of
+   * the forest being the last pixels added, with the parents of the
+   * pixels as the nodes of their components. */
+  template < typename TAreaChanged, typename TLevelCompleted >
+  void
+  SweepSlab( SizeValueType sortedBegin,
+             SizeValueType sortedEnd,
+             SizeValueType pixelBegin,
+             SizeValueType pixelEnd,
+             std::vector< PixelIndexType > &unionFind,
+             TAreaChanged &&areaChanged,
+             TLevelCompleted &&levelCompleted )
+  {
+    auto findRoot = [&unionFind]( PixelIndexType p )
+      {
+        while ( unionFind[p] != p )
+          {
+          unionFind[p] = unionFind[unionFind[p]];
+          p = unionFind[p];
+          }
+        return p;
+      };
+
+    for ( SizeValueType i = sortedBegin; i < sortedEnd; ++i )
+      {
+      const PixelIndexType p = m_SortedPixels[i];
+      m_Parent[p] = p;
+      unionFind[p] = p;
+      m_Areas[p] = 1;
+      areaChanged( SizeValueType( 0 ), SizeValueType( 1 ) );
+
+      OffsetValueType index[VDimension];
+      this->ComputeIndex( p, index );
+      for ( size_t n = 0; n < m_Neighbors.size(); ++n )
+        {
+        if ( !this->IsInside( index, n ) )
+          {
+          continue;
+          }
+        const SizeValueType q = static_cast<SizeValueType>( static_cast<OffsetValueType>( p ) + m_NeighborOffsets[n] );
+        if ( q < pixelBegin || q >= pixelEnd || m_Parent[q] == Excluded )
+          {
+          continue;
+          }
+        const PixelIndexType root = findRoot( static_cast<PixelIndexType>( q ) );
+        if ( root != p )
+          {
+          m_Parent[root] = p;
+          unionFind[root] = p;
+          areaChanged( SizeValueType( m_Areas[root] ), SizeValueType( 0 ) );
+          areaChanged( SizeValueType( m_Areas[p] ), SizeValueType( m_Areas[p] + m_Areas[root] ) );
+          m_Areas[p] += m_Areas[root];
+          }
+        }
+
+      if ( i + 1 == sortedEnd || m_Values[m_SortedPixels[i + 1]] != m_Values[p] )
+        {
+        levelCompleted( m_Values[p] );
+        }
+      }
+
+    for ( SizeValueType i = sortedEnd; i > sortedBegin; --i )
+      {
+      const PixelIndexType p = m_SortedPixels[i - 1];
+      const PixelIndexType q = m_Parent[p];
+      if ( m_Values[m_Parent[q]] == m_Values[q] )
+        {
+        m_Parent[p] = m_Parent[q];
+        }
+      }
+  }
+
+  /** The node of the component of a pixel, without changing the tree. */
+  PixelIndexType
+  FindLevelRoot( PixelIndexType p ) const
+  {
+    while ( m_Parent[p] != p && m_Values[m_Parent[p]] == m_Values[p] )
+      {
+      p = m_Parent[p];
+      }
+    return p;
+  }
+
+  /** The node of the component of a pixel, the pixels on the way
+   * being attached to it. */
+  PixelIndexType
+  LevelRoot( PixelIndexType p )
+  {
+    const PixelIndexType node = this->FindLevelRoot( p );
+    while ( p != node )
+      {
+      const PixelIndexType next = m_Parent[p];
+      m_Parent[p] = node;
+      p = next;
+      }
+    return node;
+  }
+
+  /** The node of the component a node is merged into, or Excluded. */
+  PixelIndexType
+  ParentNode( PixelIndexType node )
+  {
+    return ( m_Parent[node] == node ) ? Excluded : this->LevelRoot( m_Parent[node] );
+  }
+
+  /** Merge the branches of two pixels, from their nodes to the roots,
+   * with the areas of the nodes. */
+  void
+  Connect( PixelIndexType x, PixelIndexType y )
+  {
+    const TCompare compare;
+    x = this->LevelRoot( x );
+    y = this->LevelRoot( y );
+    if ( compare( m_Values[y], m_Values[x] ) )
+      {
+      std::swap( x, y );
+      }
+
+    // the area of the branch of the other pixel below x
+    PixelIndexType carried = 0;
+    while ( x != y && y != Excluded )
+      {
+      const PixelIndexType z = this->ParentNode( x );
+      if ( z != Excluded && !compare( m_Values[y], m_Values[z] ) )
+        {
+        m_Areas[x] += carried;
+        x = z;
+        }
+      else
+        {
+        const PixelIndexType area = m_Areas[x];
+        m_Areas[x] += carried;
+        carried = area;
+        m_Parent[x] = y;
+        x = y;
+        y = z;
+        }
+      }
+    if ( y == Excluded )
+      {
+      while ( x != Excluded )
+        {
+        m_Areas[x] += carried;
+        x = this->ParentNode( x );
+        }
+      }
+  }
+
+  /** Connect the pixels of the planes on both sides of the boundary of
+   * two slabs. */
+  void
+  ConnectSlabs( SizeValueType boundaryBegin, SizeValueType planeSize )
+  {
+    for ( SizeValueType x = boundaryBegin - planeSize; x < boundaryBegin; ++x )
+      {
+      if ( m_Parent[x] == Excluded )
+        {
+        continue;
+        }
+      OffsetValueType index[VDimension];
+      this->ComputeIndex( x, index );
+      for ( size_t n = 0; n < m_Neighbors.size(); ++n )
+        {
+        if ( m_Neighbors[n][VDimension - 1] != 1 || !this->IsInside( index, n ) )
+          {
+          continue;
+          }
+        const SizeValueType y = static_cast<SizeValueType>( static_cast<OffsetValueType>( x ) + m_NeighborOffsets[n] );
+        if ( m_Parent[y] != Excluded )
+          {
+          this->Connect( static_cast<PixelIndexType>( x ), static_cast<PixelIndexType>( y ) );
+          }
+        }
+      }
+  }
+
+  const PixelType                    *m_Values{nullptr};
+  SizeType                            m_Size{};
+  PixelType                           m_Boundary{};
+  SizeValueType                       m_NumberOfPixels{0};
+  std::vector< Offset< VDimension > > m_Neighbors;
+  std::vector< OffsetValueType >      m_NeighborOffsets;
+  std::vector< PixelIndexType >       m_SortedPixels;
+  std::vector< PixelIndexType >       m_Parent;
+  std::vector< PixelIndexType >       m_Areas;
+};
+
+template < typename TPixel, unsigned int VDimension, typename TCompare >
+constexpr typename ComponentTree< TPixel, VDimension, TCompare >::PixelIndexType ComponentTree< TPixel, VDimension, TCompare >::Excluded;
+
+
+} // end namespace itk
+
+#endif // itkComponentTree_h
@@ -0,0 +1,162 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkComponentTreeImageFilter_h
+#define itkComponentTreeImageFilter_h
+
+#include "itkAreaClosingImageFilter.h"
+#include "itkAreaOpeningImageFilter.h"
+#include "itkComponentTreeQueries.h"
+#include "itkHConcaveImageFilter.h"
+#include "itkHConvexImageFilter.h"
+#include "itkHMaximaImageFilter.h"
+#include "itkHMinimaImageFilter.h"
+#include "itkReconstructionByDilationImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
+#include "itkRegionalMaximaImageFilter.h"
+#include "itkRegionalMinimaImageFilter.h"
+
+#include <functional>
+
+
+namespace itk {
+
+/** \class ComponentTreeImageFilter
+ * \brief A morphology filter computed on the component tree of the
+ * image.
+ *
+ * With UseComponentTree off, the default, the filter is the
+ * morphology filter TSuperclass, with its own sequential algorithm.
+ * With UseComponentTree on, the max-tree or the min-tree of the image
+ * is built once with the threads of the filter, in slabs merged by
+ * pairs, as the ComponentTree, and the output is computed from the
+ * attributes of its nodes by the query TQuery, in passes from the
+ * leaves to the roots and back. The options of the superclass are
+ * those of the query.
+ *
+ * The superclass is used for the images of 2^32 pixels or more.
+ *
+ * \sa ComponentTree
+ * \sa ComponentTreeAreaQuery
+ * \sa ComponentTreeHeightQuery
+ * \sa ComponentTreeRegionalQuery
+ * \sa ComponentTreeReconstructionQuery
+ */
+template < class TSuperclass, class TQuery >
+class ComponentTreeImageFilter:
+    public TSuperclass
+{
+public:
+  /** Standard Self type alias */
+  using Self = ComponentTreeImageFilter;
+  using Superclass = TSuperclass;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+
+  static constexpr unsigned int ImageDimension = OutputImageType::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeImageFilter, ImageToImageFilter);
+
+  /** Compute the output on the component tree of the image. Off by
+   * default. */
+  itkSetMacro( UseComponentTree, bool );
+  itkGetConstMacro( UseComponentTree, bool );
+  itkBooleanMacro( UseComponentTree );
+
+protected:
+
+  ComponentTreeImageFilter() = default;
+
+  ~ComponentTreeImageFilter() override = default;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ComponentTreeImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_UseComponentTree{false};
+};
+
+
+/** The morphology filters of SimpleITK on the component tree. */
+template < class TInputImage, class TOutputImage >
+using ComponentTreeAreaOpeningImageFilter =
+  ComponentTreeImageFilter< AreaOpeningImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeAreaQuery< std::greater< typename TInputImage::PixelType > > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeAreaClosingImageFilter =
+  ComponentTreeImageFilter< AreaClosingImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeAreaQuery< std::less< typename TInputImage::PixelType > > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeHMaximaImageFilter =
+  ComponentTreeImageFilter< HMaximaImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeHeightQuery< std::greater< typename TInputImage::PixelType >, false > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeHMinimaImageFilter =
+  ComponentTreeImageFilter< HMinimaImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeHeightQuery< std::less< typename TInputImage::PixelType >, false > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeHConvexImageFilter =
+  ComponentTreeImageFilter< HConvexImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeHeightQuery< std::greater< typename TInputImage::PixelType >, true > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeHConcaveImageFilter =
+  ComponentTreeImageFilter< HConcaveImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeHeightQuery< std::less< typename TInputImage::PixelType >, true > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeRegionalMaximaImageFilter =
+  ComponentTreeImageFilter< RegionalMaximaImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeRegionalQuery< std::greater< typename TInputImage::PixelType > > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeRegionalMinimaImageFilter =
+  ComponentTreeImageFilter< RegionalMinimaImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeRegionalQuery< std::less< typename TInputImage::PixelType > > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeReconstructionByDilationImageFilter =
+  ComponentTreeImageFilter< ReconstructionByDilationImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeReconstructionQuery< std::greater< typename TInputImage::PixelType > > >;
+
+template < class TInputImage, class TOutputImage >
+using ComponentTreeReconstructionByErosionImageFilter =
+  ComponentTreeImageFilter< ReconstructionByErosionImageFilter< TInputImage, TOutputImage >,
+                            ComponentTreeReconstructionQuery< std::less< typename TInputImage::PixelType > > >;
+
+
+} // end namespace itk
+
+
+#include "itkComponentTreeImageFilter.hxx"
+
+#endif // itkComponentTreeImageFilter_h
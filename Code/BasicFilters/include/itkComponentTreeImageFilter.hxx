@@ -0,0 +1,58 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkComponentTreeImageFilter_hxx
+#define itkComponentTreeImageFilter_hxx
+
+#include "itkComponentTreeImageFilter.h"
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TSuperclass, class TQuery >
+void
+ComponentTreeImageFilter< TSuperclass, TQuery >::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  if ( !m_UseComponentTree || !ComponentTree< typename InputImageType::PixelType, ImageDimension >::CanIndex( input->GetBufferedRegion().GetSize() ) )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->AllocateOutputs();
+  TQuery::Compute( *this );
+}
+
+
+//
+// PrintSelf
+//
+template < class TSuperclass, class TQuery >
+void
+ComponentTreeImageFilter< TSuperclass, TQuery >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "UseComponentTree: " << m_UseComponentTree << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkComponentTreeImageFilter_hxx
@@ -0,0 +1,256 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkComponentTreeQueries_h
+#define itkComponentTreeQueries_h
+
+#include "itkComponentTree.h"
+#include "itkNumericTraits.h"
+#include "itkRegionalMaximaImageFilter.h"
+#include "itkRegionalMinimaImageFilter.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace itk {
+
+/** The component tree of the input of a filter, built with the threads
+ * of the filter. */
+template < typename TCompare, typename TFilter, typename TImage >
+void
+BuildComponentTree( const TFilter &filter,
+                    const TImage *image,
+                    ComponentTree< typename TImage::PixelType, TImage::ImageDimension, TCompare > &tree )
+{
+  using TreeType = ComponentTree< typename TImage::PixelType, TImage::ImageDimension, TCompare >;
+  tree.Build( image->GetBufferPointer(),
+              image->GetBufferedRegion().GetSize(),
+              filter.GetFullyConnected(),
+              TreeType::GetBoundaryOfAllValues(),
+              filter.GetMultiThreader(),
+              filter.GetNumberOfWorkUnits() );
+}
+
+
+/** \brief The area opening, or closing with the min-tree, as the
+ * attribute filter of the areas of the nodes, in physical units with
+ * UseImageSpacing. The components of an area of at least Lambda are
+ * kept, as with the AttributeMorphologyBaseImageFilter. */
+template < typename TCompare >
+struct ComponentTreeAreaQuery
+{
+  template < typename TFilter >
+  static void
+  Compute( TFilter &filter )
+  {
+    using InputImageType = typename TFilter::InputImageType;
+    using TreeType = ComponentTree< typename InputImageType::PixelType, InputImageType::ImageDimension, TCompare >;
+
+    const InputImageType *input = filter.GetInput();
+    double pixelArea = 1.0;
+    if ( filter.GetUseImageSpacing() )
+      {
+      for ( unsigned int d = 0; d < InputImageType::ImageDimension; ++d )
+        {
+        pixelArea *= input->GetSpacing()[d];
+        }
+      }
+    const double lambda = static_cast<double>( filter.GetLambda() );
+
+    TreeType tree;
+    BuildComponentTree< TCompare >( filter, input, tree );
+    tree.FilterNodes( [&tree, pixelArea, lambda]( typename TreeType::PixelIndexType node )
+                        {
+                          return static_cast<double>( tree.GetArea( node ) ) * pixelArea >= lambda;
+                        },
+                      filter.GetOutput()->GetBufferPointer() );
+  }
+};
+
+
+/** \brief The h-maxima, or h-minima with the min-tree, as the
+ * reconstruction of the input shifted by Height under the input,
+ * from the first pixel of each component. The shifted values are
+ * clamped to the pixel type as with the ShiftScaleImageFilter of the
+ * superclass. With VContrast, the output is the difference with the
+ * input instead, as the h-convex and h-concave filters. */
+template < typename TCompare, bool VContrast >
+struct ComponentTreeHeightQuery
+{
+  template < typename TFilter >
+  static void
+  Compute( TFilter &filter )
+  {
+    using InputImageType = typename TFilter::InputImageType;
+    using OutputImageType = typename TFilter::OutputImageType;
+    using InputPixelType = typename InputImageType::PixelType;
+    using OutputPixelType = typename OutputImageType::PixelType;
+    using TreeType = ComponentTree< InputPixelType, InputImageType::ImageDimension, TCompare >;
+
+    const InputImageType *input = filter.GetInput();
+    const InputPixelType *values = input->GetBufferPointer();
+    const bool maxTree = TCompare()( InputPixelType( 1 ), InputPixelType( 0 ) );
+    const double shift = maxTree ? -static_cast<double>( filter.GetHeight() ) : static_cast<double>( filter.GetHeight() );
+    const double lowest = static_cast<double>( NumericTraits< InputPixelType >::NonpositiveMin() );
+    const double highest = static_cast<double>( NumericTraits< InputPixelType >::max() );
+
+    TreeType tree;
+    BuildComponentTree< TCompare >( filter, input, tree );
+
+    const SizeValueType numberOfPixels = input->GetBufferedRegion().GetNumberOfPixels();
+    std::vector< InputPixelType > extrema( numberOfPixels );
+    tree.Reconstruct( [=]( typename TreeType::PixelIndexType p )
+                        {
+                          const double shifted = static_cast<double>( values[p] ) + shift;
+                          return static_cast<InputPixelType>( std::min( std::max( shifted, lowest ), highest ) );
+                        },
+                      extrema.data() );
+    tree.Release();
+
+    OutputPixelType *output = filter.GetOutput()->GetBufferPointer();
+    for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+      {
+      if ( !VContrast )
+        {
+        output[p] = static_cast<OutputPixelType>( extrema[p] );
+        }
+      else
+        {
+        output[p] = maxTree ? static_cast<OutputPixelType>( values[p] - extrema[p] ) : static_cast<OutputPixelType>( extrema[p] - values[p] );
+        }
+      }
+  }
+};
+
+
+/** Whether the pixels of a flat image are the regional extrema. */
+template < typename TInputImage, typename TOutputImage >
+bool
+ComponentTreeFlatIsExtremum( const RegionalMaximaImageFilter< TInputImage, TOutputImage > &filter )
+{
+  return filter.GetFlatIsMaxima();
+}
+
+template < typename TInputImage, typename TOutputImage >
+bool
+ComponentTreeFlatIsExtremum( const RegionalMinimaImageFilter< TInputImage, TOutputImage > &filter )
+{
+  return filter.GetFlatIsMinima();
+}
+
+
+/** \brief The regional maxima, or minima with the min-tree, as the
+ * pixels of the leaves of the tree. */
+template < typename TCompare >
+struct ComponentTreeRegionalQuery
+{
+  template < typename TFilter >
+  static void
+  Compute( TFilter &filter )
+  {
+    using InputImageType = typename TFilter::InputImageType;
+    using OutputImageType = typename TFilter::OutputImageType;
+    using InputPixelType = typename InputImageType::PixelType;
+    using OutputPixelType = typename OutputImageType::PixelType;
+    using TreeType = ComponentTree< InputPixelType, InputImageType::ImageDimension, TCompare >;
+    using PixelIndexType = typename TreeType::PixelIndexType;
+
+    const InputImageType *input = filter.GetInput();
+    const InputPixelType *values = input->GetBufferPointer();
+    const SizeValueType numberOfPixels = input->GetBufferedRegion().GetNumberOfPixels();
+    const OutputPixelType foreground = filter.GetForegroundValue();
+    const OutputPixelType background = filter.GetBackgroundValue();
+    OutputPixelType *output = filter.GetOutput()->GetBufferPointer();
+
+    // a flat image has no extrema, unless all its pixels are
+    if ( std::all_of( values, values + numberOfPixels, [values]( InputPixelType v ) { return v == values[0]; } ) )
+      {
+      std::fill( output, output + numberOfPixels, ComponentTreeFlatIsExtremum( filter ) ? foreground : background );
+      return;
+      }
+
+    TreeType tree;
+    BuildComponentTree< TCompare >( filter, input, tree );
+
+    std::vector< bool > hasChild( numberOfPixels, false );
+    tree.ForEachFromLeaves( [&]( PixelIndexType p )
+                              {
+                                if ( tree.IsNode( p ) && !tree.IsRoot( p ) )
+                                  {
+                                  hasChild[tree.GetParent( p )] = true;
+                                  }
+                              } );
+    for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+      {
+      const PixelIndexType parent = tree.GetParent( static_cast<PixelIndexType>( p ) );
+      if ( parent == TreeType::Excluded )
+        {
+        output[p] = background;
+        continue;
+        }
+      const PixelIndexType node = tree.IsNode( static_cast<PixelIndexType>( p ) ) ? static_cast<PixelIndexType>( p ) : parent;
+      output[p] = hasChild[node] ? background : foreground;
+      }
+  }
+};
+
+
+/** \brief The reconstruction by dilation of the marker under the
+ * mask, or by erosion with the min-tree, on the tree of the mask: the
+ * level of each component is bounded by the first marker of its
+ * pixels. The marker is so bounded by the mask. */
+template < typename TCompare >
+struct ComponentTreeReconstructionQuery
+{
+  template < typename TFilter >
+  static void
+  Compute( TFilter &filter )
+  {
+    using MaskImageType = typename TFilter::MaskImageType;
+    using OutputImageType = typename TFilter::OutputImageType;
+    using MaskPixelType = typename MaskImageType::PixelType;
+    using OutputPixelType = typename OutputImageType::PixelType;
+    using TreeType = ComponentTree< MaskPixelType, MaskImageType::ImageDimension, TCompare >;
+
+    const MaskImageType *mask = filter.GetMaskImage();
+    const auto *markerValues = filter.GetMarkerImage()->GetBufferPointer();
+    const SizeValueType numberOfPixels = mask->GetBufferedRegion().GetNumberOfPixels();
+
+    TreeType tree;
+    BuildComponentTree< TCompare >( filter, mask, tree );
+
+    std::vector< MaskPixelType > reconstruction( numberOfPixels );
+    tree.Reconstruct( [markerValues]( typename TreeType::PixelIndexType p )
+                        {
+                          return static_cast<MaskPixelType>( markerValues[p] );
+                        },
+                      reconstruction.data() );
+    tree.Release();
+
+    OutputPixelType *output = filter.GetOutput()->GetBufferPointer();
+    for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+      {
+      output[p] = static_cast<OutputPixelType>( reconstruction[p] );
+      }
+  }
+};
+
+
+} // end namespace itk
+
+#endif // itkComponentTreeQueries_h
@@ -0,0 +1,125 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkComponentTreeThresholdMaximumConnectedComponentsImageFilter_h
+#define itkComponentTreeThresholdMaximumConnectedComponentsImageFilter_h
+
+#include "itkThresholdMaximumConnectedComponentsImageFilter.h"
+
+
+namespace itk {
+
+/** \class ComponentTreeThresholdMaximumConnectedComponentsImageFilter
+ * \brief The threshold maximizing the number of objects, from the
+ * numbers of objects of all the thresholds.
+ *
+ * With UseComponentTree off, the default, the filter is the
+ * ThresholdMaximumConnectedComponentsImageFilter, which bisects the
+ * range of the thresholds, and thresholds the image and labels its
+ * connected components for each of the thresholds it tries. With
+ * UseComponentTree on, the pixels are added to the components of
+ * their neighbors by decreasing values, in one union-find sweep of
+ * the ComponentTree, which counts the components of at least
+ * MinimumObjectSizeInPixels pixels after each value: these are the
+ * numbers of objects of all the thresholds, without any label image.
+ * The threshold is then the lowest value with the largest number of
+ * objects, the global maximum, where the bisection may stop at a
+ * local one. As with the superclass, the objects are the components
+ * of the face connected pixels between the threshold and
+ * UpperBoundary.
+ *
+ * The superclass is used for the images of 2^32 pixels or more.
+ *
+ * \sa ThresholdMaximumConnectedComponentsImageFilter, ComponentTree
+ */
+template < class TInputImage, class TOutputImage = TInputImage >
+class ComponentTreeThresholdMaximumConnectedComponentsImageFilter:
+    public ThresholdMaximumConnectedComponentsImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ComponentTreeThresholdMaximumConnectedComponentsImageFilter;
+  using Superclass = ThresholdMaximumConnectedComponentsImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ComponentTreeThresholdMaximumConnectedComponentsImageFilter, ThresholdMaximumConnectedComponentsImageFilter);
+
+  /** Count the objects of all the thresholds in one sweep of the
+   * component tree. Off by default. */
+  itkSetMacro( UseComponentTree, bool );
+  itkGetConstMacro( UseComponentTree, bool );
+  itkBooleanMacro( UseComponentTree );
+
+  /** The threshold of the last update, by either search. */
+  InputPixelType
+  GetThresholdValue() const
+  {
+    return m_ComponentTreeUpdated ? m_ThresholdValue : Superclass::GetThresholdValue();
+  }
+
+  /** The number of objects of the threshold of the last update. */
+  SizeValueType
+  GetNumberOfObjects() const
+  {
+    return m_ComponentTreeUpdated ? m_NumberOfObjects : Superclass::GetNumberOfObjects();
+  }
+
+protected:
+
+  ComponentTreeThresholdMaximumConnectedComponentsImageFilter() = default;
+
+  ~ComponentTreeThresholdMaximumConnectedComponentsImageFilter() override = default;
+
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its input
+  void GenerateInputRequestedRegion() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ComponentTreeThresholdMaximumConnectedComponentsImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool           m_UseComponentTree{false};
+  bool           m_ComponentTreeUpdated{false};
+  InputPixelType m_ThresholdValue{};
+  SizeValueType  m_NumberOfObjects{0};
+};
+
+
+} // end namespace itk
+
+
+#include "itkComponentTreeThresholdMaximumConnectedComponentsImageFilter.hxx"
+
+#endif // itkComponentTreeThresholdMaximumConnectedComponentsImageFilter_h
@@ -0,0 +1,146 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkComponentTreeThresholdMaximumConnectedComponentsImageFilter_hxx
+#define itkComponentTreeThresholdMaximumConnectedComponentsImageFilter_hxx
+
+#include "itkComponentTreeThresholdMaximumConnectedComponentsImageFilter.h"
+
+#include "itkComponentTree.h"
+#include "itkImageScanlineIterator.h"
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+ComponentTreeThresholdMaximumConnectedComponentsImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  using TreeType = ComponentTree< InputPixelType, ImageDimension >;
+
+  const InputImageType *input = this->GetInput();
+  const typename InputImageType::SizeType size = input->GetBufferedRegion().GetSize();
+
+  m_ComponentTreeUpdated = false;
+  if ( !m_UseComponentTree || !TreeType::CanIndex( size ) )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  // the number of components of at least the minimum size, after the
+  // pixels of each value are added
+  const SizeValueType minimumSize = this->GetMinimumObjectSizeInPixels();
+  SizeValueType numberOfComponents = 0;
+  auto isObject = [minimumSize]( SizeValueType area )
+    {
+      return area != 0 && area >= minimumSize;
+    };
+
+  const InputPixelType upperBoundary = this->GetUpperBoundary();
+  m_ThresholdValue = upperBoundary;
+  m_NumberOfObjects = 0;
+  bool found = false;
+
+  TreeType tree;
+  tree.BuildSequentially( input->GetBufferPointer(), size, false, upperBoundary,
+                          [&]( SizeValueType previousArea, SizeValueType area )
+                            {
+                              numberOfComponents += isObject( area );
+                              numberOfComponents -= isObject( previousArea );
+                            },
+                          [&]( InputPixelType value )
+                            {
+                              // the lowest of the thresholds with the most objects
+                              if ( !found || numberOfComponents >= m_NumberOfObjects )
+                                {
+                                m_ThresholdValue = value;
+                                m_NumberOfObjects = numberOfComponents;
+                                found = true;
+                                }
+                            } );
+  tree.Release();
+
+  // the pixels of the objects are between the threshold and the
+  // upper boundary
+  const InputPixelType lower = m_ThresholdValue;
+  const OutputPixelType insideValue = this->GetInsideValue();
+  const OutputPixelType outsideValue = this->GetOutsideValue();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    output->GetRequestedRegion(),
+    [&]( const RegionType &region )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, region );
+        ImageScanlineIterator<OutputImageType> outIt( output, region );
+        while ( !inIt.IsAtEnd() )
+          {
+          while ( !inIt.IsAtEndOfLine() )
+            {
+            const InputPixelType value = inIt.Get();
+            outIt.Set( ( lower <= value && value <= upperBoundary ) ? insideValue : outsideValue );
+            ++inIt;
+            ++outIt;
+            }
+          inIt.NextLine();
+          outIt.NextLine();
+          }
+      },
+    this );
+
+  m_ComponentTreeUpdated = true;
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+ComponentTreeThresholdMaximumConnectedComponentsImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+ComponentTreeThresholdMaximumConnectedComponentsImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "UseComponentTree: " << m_UseComponentTree << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkComponentTreeThresholdMaximumConnectedComponentsImageFilter_hxx
@@ -0,0 +1,184 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkCounterBasedNoiseImageFilter_h
+#define itkCounterBasedNoiseImageFilter_h
+
+#include "itkAdditiveGaussianNoiseImageFilter.h"
+#include "itkSaltAndPepperNoiseImageFilter.h"
+#include "itkShotNoiseImageFilter.h"
+#include "itkSpeckleNoiseImageFilter.h"
+#include "itkPhiloxRandomStream.h"
+
+
+namespace itk {
+
+/** \class CounterBasedNoise
+ * \brief The noise of a pixel of a noise filter, from the random
+ * stream of the pixel.
+ *
+ * The value is the value of the superclass before it is clamped to
+ * the output pixel type.
+ */
+template < class TNoiseFilter >
+struct CounterBasedNoise;
+
+template < class TInputImage, class TOutputImage >
+struct CounterBasedNoise< AdditiveGaussianNoiseImageFilter< TInputImage, TOutputImage > >
+{
+  using FilterType = AdditiveGaussianNoiseImageFilter< TInputImage, TOutputImage >;
+
+  static double Evaluate( const FilterType *filter, double value, PhiloxRandomStream &stream )
+  {
+    return value + filter->GetMean() + filter->GetStandardDeviation() * stream.GetNormalVariate();
+  }
+};
+
+template < class TInputImage, class TOutputImage >
+struct CounterBasedNoise< SaltAndPepperNoiseImageFilter< TInputImage, TOutputImage > >
+{
+  using FilterType = SaltAndPepperNoiseImageFilter< TInputImage, TOutputImage >;
+
+  static double Evaluate( const FilterType *filter, double value, PhiloxRandomStream &stream )
+  {
+    if ( stream.GetUniformVariate() < filter->GetProbability() )
+      {
+      return ( stream.GetUniformVariate() < 0.5 ) ? filter->GetSaltValue() : filter->GetPepperValue();
+      }
+    return value;
+  }
+};
+
+template < class TInputImage, class TOutputImage >
+struct CounterBasedNoise< ShotNoiseImageFilter< TInputImage, TOutputImage > >
+{
+  using FilterType = ShotNoiseImageFilter< TInputImage, TOutputImage >;
+
+  static double Evaluate( const FilterType *filter, double value, PhiloxRandomStream &stream )
+  {
+    const double scale = filter->GetScale();
+    const double lambda = scale * value;
+
+    // the Poisson variate by the method of Knuth, and the normal
+    // approximation of the superclass for the large values
+    if ( lambda < 50.0 )
+      {
+      const double limit = std::exp( -lambda );
+      long k = 0;
+      double p = 1.0;
+      do
+        {
+        ++k;
+        p *= stream.GetUniformVariate();
+        }
+      while ( p > limit );
+      return static_cast<double>( k - 1 ) / scale;
+      }
+    return ( lambda + std::sqrt( lambda ) * stream.GetNormalVariate() ) / scale;
+  }
+};
+
+template < class TInputImage, class TOutputImage >
+struct CounterBasedNoise< SpeckleNoiseImageFilter< TInputImage, TOutputImage > >
+{
+  using FilterType = SpeckleNoiseImageFilter< TInputImage, TOutputImage >;
+
+  static double Evaluate( const FilterType *filter, double value, PhiloxRandomStream &stream )
+  {
+    // the multiplicative noise of mean 1 and variance theta
+    const double theta = filter->GetStandardDeviation() * filter->GetStandardDeviation();
+    if ( theta == 0.0 )
+      {
+      return value;
+      }
+    return value * theta * stream.GetGammaVariate( 1.0 / theta );
+  }
+};
+
+
+/** \class CounterBasedNoiseImageFilter
+ * \brief Generate the noise of a noise filter by a counter based
+ * random generator, in parallel and independently of the threads.
+ *
+ * With UseCounterBasedGenerator off, the default, the filter is its
+ * superclass, whose generators are seeded for each thread, so that
+ * the noise depends on the number of threads. With
+ * UseCounterBasedGenerator on, the noise of each pixel is drawn from
+ * the PhiloxRandomStream keyed by the seed and counted from the offset
+ * of the pixel in the largest possible region, so that the output
+ * only depends on the seed, for any number of threads and any
+ * streaming. The noise has the distribution of the superclass, but
+ * not its values.
+ *
+ * \sa NoiseBaseImageFilter, PhiloxRandomStream
+ */
+template < class TSuperclass >
+class CounterBasedNoiseImageFilter:
+    public TSuperclass
+{
+public:
+  /** Standard Self type alias */
+  using Self = CounterBasedNoiseImageFilter;
+  using Superclass = TSuperclass;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+
+  static constexpr unsigned int ImageDimension = OutputImageType::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(CounterBasedNoiseImageFilter, NoiseBaseImageFilter);
+
+  /** Draw the noise from the counter based streams of the pixels. Off
+   * by default. */
+  itkSetMacro( UseCounterBasedGenerator, bool );
+  itkGetConstMacro( UseCounterBasedGenerator, bool );
+  itkBooleanMacro( UseCounterBasedGenerator );
+
+protected:
+
+  CounterBasedNoiseImageFilter() = default;
+
+  ~CounterBasedNoiseImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The pixels are split between the work units of the multi-threader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  CounterBasedNoiseImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_UseCounterBasedGenerator{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkCounterBasedNoiseImageFilter.hxx"
+
+#endif // itkCounterBasedNoiseImageFilter_h
@@ -0,0 +1,97 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkCounterBasedNoiseImageFilter_hxx
+#define itkCounterBasedNoiseImageFilter_hxx
+
+#include "itkCounterBasedNoiseImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TSuperclass >
+void
+CounterBasedNoiseImageFilter< TSuperclass >::GenerateData()
+{
+  if ( !m_UseCounterBasedGenerator )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  // the output may be the input, each pixel is read before it is written
+  this->AllocateOutputs();
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+
+  const OutputImageRegionType largest = output->GetLargestPossibleRegion();
+  const uint64_t key = this->GetSeed();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    output->GetRequestedRegion(),
+    [&]( const OutputImageRegionType &region )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, region );
+        ImageScanlineIterator<OutputImageType> outIt( output, region );
+        while ( !outIt.IsAtEnd() )
+          {
+          // the offset of the first pixel of the line in the largest region
+          const typename OutputImageType::IndexType index = outIt.GetIndex();
+          uint64_t pixel = 0;
+          for ( unsigned int d = ImageDimension; d > 0; --d )
+            {
+            pixel = pixel * largest.GetSize( d - 1 ) + static_cast<uint64_t>( index[d - 1] - largest.GetIndex( d - 1 ) );
+            }
+
+          while ( !outIt.IsAtEndOfLine() )
+            {
+            PhiloxRandomStream stream( key, pixel++ );
+            const double value = CounterBasedNoise< Superclass >::Evaluate( this, static_cast<double>( inIt.Get() ), stream );
+            outIt.Set( Self::ClampCast( value ) );
+            ++inIt;
+            ++outIt;
+            }
+          inIt.NextLine();
+          outIt.NextLine();
+          }
+      },
+    this );
+}
+
+
+//
+// PrintSelf
+//
+template < class TSuperclass >
+void
+CounterBasedNoiseImageFilter< TSuperclass >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "UseCounterBasedGenerator: " << m_UseCounterBasedGenerator << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkCounterBasedNoiseImageFilter_hxx
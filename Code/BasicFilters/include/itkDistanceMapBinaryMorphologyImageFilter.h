@@ -0,0 +1,122 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkDistanceMapBinaryMorphologyImageFilter_h
+#define itkDistanceMapBinaryMorphologyImageFilter_h
+
+#include "itkBinaryDilateImageFilter.h"
+#include "itkBinaryErodeImageFilter.h"
+
+#include <type_traits>
+
+
+namespace itk {
+
+/** \class DistanceMapBinaryMorphologyImageFilter
+ * \brief Binary dilation or erosion by a ball computed from a distance
+ * map.
+ *
+ * TMorphologyFilter is a BinaryDilateImageFilter or a
+ * BinaryErodeImageFilter with a FlatStructuringElement, whose
+ * parameters and output are kept. When UseDistanceMap is on and the
+ * kernel is a Ball with the same radius r in all the dimensions, the
+ * result is computed from the squared Euclidean distance map of the
+ * foreground pixels for the dilation, or of the other pixels for the
+ * erosion: a pixel is in the structuring element of an object pixel
+ * when its squared distance is at most r*r+r, as the ball contains the
+ * offsets within r+0.5. The cost then does not depend on the radius,
+ * instead of growing with the surface of the kernel.
+ *
+ * BoundaryToForeground is applied as the distance to the outside of
+ * the image. With another kernel, or when UseDistanceMap is off, the
+ * superclass algorithm is used.
+ *
+ * \sa SignedMaurerDistanceMapImageFilter
+ */
+template < class TMorphologyFilter >
+class DistanceMapBinaryMorphologyImageFilter:
+    public TMorphologyFilter
+{
+public:
+  /** Standard Self type alias */
+  using Self = DistanceMapBinaryMorphologyImageFilter;
+  using Superclass = TMorphologyFilter;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using KernelType = typename Superclass::KernelType;
+  using InputPixelType = typename InputImageType::PixelType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using RegionType = typename OutputImageType::RegionType;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+
+  /** Whether the filter dilates or erodes. */
+  static constexpr bool IsDilation =
+    std::is_same< TMorphologyFilter, BinaryDilateImageFilter< InputImageType, OutputImageType, KernelType > >::value;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(DistanceMapBinaryMorphologyImageFilter, BinaryMorphologyImageFilter);
+
+  /** Set/Get whether a ball kernel is computed from a distance map.
+   * Defaults to true. */
+  itkSetMacro( UseDistanceMap, bool );
+  itkGetConstMacro( UseDistanceMap, bool );
+  itkBooleanMacro( UseDistanceMap );
+
+  /** Whether the kernel is a Ball with the same radius in all the
+   * dimensions, so the distance map can be used. */
+  bool IsKernelIsotropicBall() const;
+
+protected:
+
+  DistanceMapBinaryMorphologyImageFilter();
+
+  ~DistanceMapBinaryMorphologyImageFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // The distance map and the output are computed by the threads of
+  // the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the distance map needs all of the input
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  DistanceMapBinaryMorphologyImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_UseDistanceMap;
+};
+
+
+} // end namespace itk
+
+
+#include "itkDistanceMapBinaryMorphologyImageFilter.hxx"
+
+#endif // itkDistanceMapBinaryMorphologyImageFilter_h
@@ -0,0 +1,256 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkDistanceMapBinaryMorphologyImageFilter_hxx
+#define itkDistanceMapBinaryMorphologyImageFilter_hxx
+
+#include "itkDistanceMapBinaryMorphologyImageFilter.h"
+
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressAccumulator.h"
+#include "itkSignedMaurerDistanceMapImageFilter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace itk {
+
+//
+// Constructor
+//
+template < class TMorphologyFilter >
+DistanceMapBinaryMorphologyImageFilter< TMorphologyFilter >::DistanceMapBinaryMorphologyImageFilter()
+{
+  this->m_UseDistanceMap = true;
+}
+
+
+//
+// IsKernelIsotropicBall
+//
+template < class TMorphologyFilter >
+bool
+DistanceMapBinaryMorphologyImageFilter< TMorphologyFilter >::IsKernelIsotropicBall() const
+{
+  const KernelType &kernel = this->GetKernel();
+  const typename KernelType::RadiusType radius = kernel.GetRadius();
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    if ( radius[d] != radius[0] )
+      {
+      return false;
+      }
+    }
+
+  const KernelType ball = KernelType::Ball( radius );
+  for ( unsigned int i = 0; i < kernel.Size(); ++i )
+    {
+    if ( kernel[i] != ball[i] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+
+//
+// GenerateData
+//
+template < class TMorphologyFilter >
+void
+DistanceMapBinaryMorphologyImageFilter< TMorphologyFilter >::GenerateData()
+{
+  if ( !this->m_UseDistanceMap || !this->IsKernelIsotropicBall() )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  using ObjectImageType = Image< unsigned char, ImageDimension >;
+  using DistanceImageType = Image< double, ImageDimension >;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+
+  const InputPixelType foregroundValue = this->GetForegroundValue();
+  const InputPixelType backgroundValue = this->GetBackgroundValue();
+
+  // the pixels whose structuring element is applied: the foreground
+  // of the dilation, and the background of the erosion
+  auto object = ObjectImageType::New();
+  object->CopyInformation( input );
+  object->SetRegions( region );
+  object->Allocate();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  std::atomic<bool> hasObject( false );
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [input, &object, foregroundValue, &hasObject]( const RegionType &lineRegion )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, lineRegion );
+        ImageScanlineIterator<ObjectImageType> objectIt( object, lineRegion );
+        bool found = false;
+        while ( !inIt.IsAtEnd() )
+          {
+          while ( !inIt.IsAtEndOfLine() )
+            {
+            const bool isObject = ( inIt.Get() == foregroundValue ) == IsDilation;
+            objectIt.Set( isObject );
+            found = found || isObject;
+            ++inIt;
+            ++objectIt;
+            }
+          inIt.NextLine();
+          objectIt.NextLine();
+          }
+        if ( found )
+          {
+          hasObject = true;
+          }
+      },
+    nullptr );
+
+  typename DistanceImageType::Pointer distance;
+  if ( hasObject )
+    {
+    auto progress = ProgressAccumulator::New();
+    progress->SetMiniPipelineFilter( this );
+
+    using DistanceFilterType = SignedMaurerDistanceMapImageFilter< ObjectImageType, DistanceImageType >;
+    auto distanceFilter = DistanceFilterType::New();
+    distanceFilter->SetInput( object );
+    distanceFilter->SetBackgroundValue( 0 );
+    distanceFilter->SquaredDistanceOn();
+    distanceFilter->UseImageSpacingOff();
+    distanceFilter->InsideIsPositiveOff();
+    distanceFilter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+    progress->RegisterInternalFilter( distanceFilter, 0.9f );
+    distanceFilter->Update();
+    distance = distanceFilter->GetOutput();
+    }
+  object = nullptr;
+
+  // the offsets within r + 0.5 of the center are in the ball
+  const double radius = static_cast<double>( this->GetKernel().GetRadius()[0] );
+  const double threshold = radius * radius + radius;
+
+  // the outside of the image is an object pixel for the dilation to
+  // the foreground, or the erosion from the background
+  const bool outsideIsObject = ( this->GetBoundaryToForeground() == IsDilation );
+  const typename RegionType::IndexType regionIndex = region.GetIndex();
+  const typename RegionType::SizeType regionSize = region.GetSize();
+  auto outsideDistance = [&regionIndex, &regionSize]( unsigned int d, IndexValueType index )
+    {
+      const double before = static_cast<double>( index - regionIndex[d] + 1 );
+      const double after = static_cast<double>( regionIndex[d] + static_cast<IndexValueType>( regionSize[d] ) - index );
+      const double nearest = std::min( before, after );
+      return nearest * nearest;
+    };
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [&]( const RegionType &lineRegion )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, lineRegion );
+        ImageScanlineIterator<OutputImageType> outIt( output, lineRegion );
+        while ( !inIt.IsAtEnd() )
+          {
+          typename RegionType::IndexType index = inIt.GetIndex();
+          const double *distanceLine = distance ? distance->GetBufferPointer() + distance->ComputeOffset( index ) : nullptr;
+
+          double lineOutsideDistance = std::numeric_limits<double>::infinity();
+          if ( outsideIsObject )
+            {
+            for ( unsigned int d = 1; d < ImageDimension; ++d )
+              {
+              lineOutsideDistance = std::min( lineOutsideDistance, outsideDistance( d, index[d] ) );
+              }
+            }
+
+          for ( SizeValueType x = 0; !inIt.IsAtEndOfLine(); ++x, ++inIt, ++outIt )
+            {
+            double squaredDistance = distanceLine ? distanceLine[x] : std::numeric_limits<double>::infinity();
+            if ( outsideIsObject )
+              {
+              squaredDistance = std::min( { squaredDistance,
+                                            lineOutsideDistance,
+                                            outsideDistance( 0, index[0] + static_cast<IndexValueType>( x ) ) } );
+              }
+
+            const InputPixelType value = inIt.Get();
+            const bool inStructuringElement = ( squaredDistance <= threshold );
+            if ( IsDilation && inStructuringElement )
+              {
+              outIt.Set( static_cast<OutputPixelType>( foregroundValue ) );
+              }
+            else if ( !IsDilation && inStructuringElement && value == foregroundValue )
+              {
+              outIt.Set( static_cast<OutputPixelType>( backgroundValue ) );
+              }
+            else
+              {
+              outIt.Set( static_cast<OutputPixelType>( value ) );
+              }
+            }
+          inIt.NextLine();
+          outIt.NextLine();
+          }
+      },
+    nullptr );
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TMorphologyFilter >
+void
+DistanceMapBinaryMorphologyImageFilter< TMorphologyFilter >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+
+  if ( this->m_UseDistanceMap )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TMorphologyFilter >
+void
+DistanceMapBinaryMorphologyImageFilter< TMorphologyFilter >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseDistanceMap: " << m_UseDistanceMap << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkDistanceMapBinaryMorphologyImageFilter_hxx
@@ -0,0 +1,114 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkDynamicProgrammingOtsuMultipleThresholdsImageFilter_h
+#define itkDynamicProgrammingOtsuMultipleThresholdsImageFilter_h
+
+#include "itkOtsuMultipleThresholdsImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class DynamicProgrammingOtsuMultipleThresholdsImageFilter
+ * \brief Multiple Otsu thresholds maximizing the between class
+ * variance of the histogram by dynamic programming.
+ *
+ * With DynamicProgramming off, the default, the filter is the
+ * OtsuMultipleThresholdsImageFilter, whose calculator searches all
+ * the combinations of thresholds, a cost growing as the power of the
+ * number of thresholds of the number of bins. With DynamicProgramming
+ * on, the between class variance, a sum over the classes of the
+ * squared sum of the class over its frequency, is maximized over the
+ * classes of the first bins for an increasing number of classes, at
+ * a cost of the number of classes times the squared number of bins.
+ * The histogram is the histogram of the superclass, computed in one
+ * pass over the image, and the thresholds are the same up to the
+ * choice between partitions of equal variances.
+ *
+ * The valley emphasis does not add over the classes, so the
+ * thresholds with ValleyEmphasis on are those of the superclass.
+ *
+ * \sa OtsuMultipleThresholdsImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class DynamicProgrammingOtsuMultipleThresholdsImageFilter:
+    public OtsuMultipleThresholdsImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = DynamicProgrammingOtsuMultipleThresholdsImageFilter;
+  using Superclass = OtsuMultipleThresholdsImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using HistogramGeneratorType = typename Superclass::HistogramGeneratorType;
+  using HistogramType = typename Superclass::HistogramType;
+  using ThresholdVectorType = typename Superclass::ThresholdVectorType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(DynamicProgrammingOtsuMultipleThresholdsImageFilter, OtsuMultipleThresholdsImageFilter);
+
+  /** Maximize the between class variance by dynamic programming.
+   * Off by default. */
+  itkSetMacro( DynamicProgramming, bool );
+  itkGetConstMacro( DynamicProgramming, bool );
+  itkBooleanMacro( DynamicProgramming );
+
+  /** The thresholds of the last update, by either search. */
+  const ThresholdVectorType &
+  GetEstimatedThresholds() const
+  {
+    return m_EstimatedThresholds;
+  }
+
+  /** The indices of the last bins of the first NumberOfClasses - 1
+   * classes of a histogram maximizing the between class variance, or
+   * an empty vector when there are fewer bins than classes. */
+  static std::vector<SizeValueType> ComputeThresholdBins( const HistogramType *histogram, unsigned int numberOfClasses );
+
+protected:
+
+  DynamicProgrammingOtsuMultipleThresholdsImageFilter() = default;
+
+  ~DynamicProgrammingOtsuMultipleThresholdsImageFilter() override = default;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  DynamicProgrammingOtsuMultipleThresholdsImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool                m_DynamicProgramming{false};
+  ThresholdVectorType m_EstimatedThresholds;
+};
+
+
+} // end namespace itk
+
+
+#include "itkDynamicProgrammingOtsuMultipleThresholdsImageFilter.hxx"
+
+#endif // itkDynamicProgrammingOtsuMultipleThresholdsImageFilter_h
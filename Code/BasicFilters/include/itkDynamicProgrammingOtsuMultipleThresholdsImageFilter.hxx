@@ -0,0 +1,178 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkDynamicProgrammingOtsuMultipleThresholdsImageFilter_hxx
+#define itkDynamicProgrammingOtsuMultipleThresholdsImageFilter_hxx
+
+#include "itkDynamicProgrammingOtsuMultipleThresholdsImageFilter.h"
+
+#include "itkProgressAccumulator.h"
+#include "itkThresholdLabelerImageFilter.h"
+
+namespace itk {
+
+//
+// ComputeThresholdBins
+//
+template < class TInputImage, class TOutputImage >
+std::vector<SizeValueType>
+DynamicProgrammingOtsuMultipleThresholdsImageFilter< TInputImage, TOutputImage >
+::ComputeThresholdBins( const HistogramType *histogram, unsigned int numberOfClasses )
+{
+  const SizeValueType numberOfBins = histogram->GetSize( 0 );
+  if ( numberOfClasses < 2 || numberOfBins < numberOfClasses )
+    {
+    return std::vector<SizeValueType>();
+    }
+
+  // the prefix sums of the frequencies and of the frequencies times
+  // the measurements of the bins
+  std::vector<double> frequency( numberOfBins + 1, 0.0 );
+  std::vector<double> moment( numberOfBins + 1, 0.0 );
+  for ( SizeValueType i = 0; i < numberOfBins; ++i )
+    {
+    const double f = static_cast<double>( histogram->GetFrequency( i, 0 ) );
+    frequency[i + 1] = frequency[i] + f;
+    moment[i + 1] = moment[i] + f * static_cast<double>( histogram->GetMeasurement( i, 0 ) );
+    }
+
+  // the contribution of the class of the bins [first, last] to the
+  // between class variance, up to the constant global terms
+  auto classVariance = [&frequency, &moment]( SizeValueType first, SizeValueType last )
+    {
+      const double w = frequency[last + 1] - frequency[first];
+      const double m = moment[last + 1] - moment[first];
+      return ( w > 0.0 ) ? m * m / w : 0.0;
+    };
+
+  // the maximum variance of the bins [0, last] in c + 1 classes, and
+  // the first bin of the last of these classes
+  std::vector< std::vector<double> > variance( numberOfClasses, std::vector<double>( numberOfBins, 0.0 ) );
+  std::vector< std::vector<SizeValueType> > firstBin( numberOfClasses, std::vector<SizeValueType>( numberOfBins, 0 ) );
+  for ( SizeValueType last = 0; last < numberOfBins; ++last )
+    {
+    variance[0][last] = classVariance( 0, last );
+    }
+  for ( unsigned int c = 1; c < numberOfClasses; ++c )
+    {
+    // the bins of the classes which follow
+    const SizeValueType lastOfClass = numberOfBins - ( numberOfClasses - c );
+    for ( SizeValueType last = c; last <= lastOfClass; ++last )
+      {
+      double best = -1.0;
+      SizeValueType bestFirst = c;
+      for ( SizeValueType first = c; first <= last; ++first )
+        {
+        const double v = variance[c - 1][first - 1] + classVariance( first, last );
+        if ( v > best )
+          {
+          best = v;
+          bestFirst = first;
+          }
+        }
+      variance[c][last] = best;
+      firstBin[c][last] = bestFirst;
+      }
+    }
+
+  // the last bins of the classes, from the last class
+  std::vector<SizeValueType> thresholds( numberOfClasses - 1 );
+  SizeValueType last = numberOfBins - 1;
+  for ( unsigned int c = numberOfClasses - 1; c > 0; --c )
+    {
+    last = firstBin[c][last] - 1;
+    thresholds[c - 1] = last;
+    }
+  return thresholds;
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+DynamicProgrammingOtsuMultipleThresholdsImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  if ( !m_DynamicProgramming || this->GetValleyEmphasis() )
+    {
+    Superclass::GenerateData();
+    m_EstimatedThresholds = this->GetThresholds();
+    return;
+    }
+
+  typename ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+
+  // the histogram of the superclass
+  typename HistogramGeneratorType::Pointer histogramGenerator = HistogramGeneratorType::New();
+  histogramGenerator->SetInput( this->GetInput() );
+  histogramGenerator->SetNumberOfBins( this->GetNumberOfHistogramBins() );
+  histogramGenerator->Compute();
+  const HistogramType *histogram = histogramGenerator->GetOutput();
+
+  const unsigned int numberOfClasses = static_cast<unsigned int>( this->GetNumberOfThresholds() ) + 1u;
+  const std::vector<SizeValueType> bins = Self::ComputeThresholdBins( histogram, numberOfClasses );
+  if ( bins.size() + 1u != numberOfClasses )
+    {
+    itkExceptionMacro( "The " << histogram->GetSize( 0 ) << " bins of the histogram are fewer than the "
+                       << numberOfClasses << " classes." );
+    }
+
+  // the maximum or the midpoint of the last bins of the classes, as
+  // OtsuMultipleThresholdsCalculator
+  m_EstimatedThresholds.resize( bins.size() );
+  for ( unsigned int j = 0; j < bins.size(); ++j )
+    {
+    if ( this->GetReturnBinMidpoint() )
+      {
+      m_EstimatedThresholds[j] = ( histogram->GetBinMin( 0, bins[j] ) + histogram->GetBinMax( 0, bins[j] ) ) / 2;
+      }
+    else
+      {
+      m_EstimatedThresholds[j] = histogram->GetBinMax( 0, bins[j] );
+      }
+    }
+
+  using ThresholdLabelerType = ThresholdLabelerImageFilter< TInputImage, TOutputImage >;
+  typename ThresholdLabelerType::Pointer threshold = ThresholdLabelerType::New();
+  progress->RegisterInternalFilter( threshold, 1.0f );
+  threshold->GraftOutput( this->GetOutput() );
+  threshold->SetInput( this->GetInput() );
+  threshold->SetRealThresholds( m_EstimatedThresholds );
+  threshold->SetLabelOffset( this->GetLabelOffset() );
+  threshold->Update();
+
+  this->GraftOutput( threshold->GetOutput() );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+DynamicProgrammingOtsuMultipleThresholdsImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "DynamicProgramming: " << m_DynamicProgramming << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkDynamicProgrammingOtsuMultipleThresholdsImageFilter_hxx
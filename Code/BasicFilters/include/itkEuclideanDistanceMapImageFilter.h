@@ -0,0 +1,164 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkEuclideanDistanceMapImageFilter_h
+#define itkEuclideanDistanceMapImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <limits>
+#include <type_traits>
+
+
+namespace itk {
+
+/** \class EuclideanDistanceMapImageFilter
+ * \brief Exact Euclidean distance transform of a binary image with
+ * separable passes.
+ *
+ * The output is the distance of each pixel to the nearest pixel of the
+ * object, the pixels which are not BackgroundValue, and 0 in the
+ * object. With SignedDistance, the pixels of the object have instead
+ * the distance to the nearest background pixel, negative unless
+ * InsideIsPositive. The distances are in physical units with
+ * UseImageSpacing, or else in pixels, and are squared with
+ * SquaredDistance.
+ *
+ * The squared distances are computed in the output image, a floating
+ * point image, with one pass per dimension of the lower envelope of
+ * parabolas of Felzenszwalb and Huttenlocher. Each pass is linear in
+ * the number of pixels, and its lines are split between the threads.
+ * A signed distance needs a second buffer of the size of the output.
+ *
+ * The distances larger than MaximumDistance are not propagated by the
+ * next passes, and are MaximumDistance in the output, so that a
+ * bounded distance map costs less on the lines far from the object.
+ * Without a bound, the pixels of an image without object have the
+ * largest value of the output pixel type.
+ *
+ * Reference: P. F. Felzenszwalb and D. P. Huttenlocher, "Distance
+ * Transforms of Sampled Functions", Theory of Computing, 8(19):
+ * 415-428, 2012.
+ *
+ * \sa SignedMaurerDistanceMapImageFilter, DanielssonDistanceMapImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class EuclideanDistanceMapImageFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = EuclideanDistanceMapImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  static_assert( std::is_floating_point<OutputPixelType>::value,
+                 "The output pixels must be floating point." );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(EuclideanDistanceMapImageFilter, ImageToImageFilter);
+
+  /** The value of the pixels which are not part of the object. */
+  itkSetMacro( BackgroundValue, InputPixelType );
+  itkGetConstMacro( BackgroundValue, InputPixelType );
+
+  /** Whether the pixels of the object have the distance to the
+   * background. Off by default. */
+  itkSetMacro( SignedDistance, bool );
+  itkGetConstMacro( SignedDistance, bool );
+  itkBooleanMacro( SignedDistance );
+
+  /** Whether the signed distances of the object are positive, and the
+   * others negative. Off by default. */
+  itkSetMacro( InsideIsPositive, bool );
+  itkGetConstMacro( InsideIsPositive, bool );
+  itkBooleanMacro( InsideIsPositive );
+
+  /** Whether the output is the squared distance. Off by default. */
+  itkSetMacro( SquaredDistance, bool );
+  itkGetConstMacro( SquaredDistance, bool );
+  itkBooleanMacro( SquaredDistance );
+
+  /** Whether the distances are in physical units. On by default. */
+  itkSetMacro( UseImageSpacing, bool );
+  itkGetConstMacro( UseImageSpacing, bool );
+  itkBooleanMacro( UseImageSpacing );
+
+  /** The largest distance which is computed, not squared. By default
+   * the distances are not bounded. */
+  itkSetMacro( MaximumDistance, double );
+  itkGetConstMacro( MaximumDistance, double );
+
+protected:
+
+  EuclideanDistanceMapImageFilter() = default;
+
+  ~EuclideanDistanceMapImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The lines of each pass are split between the threads of the
+  // multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  EuclideanDistanceMapImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  /** The squared distance transform of buffer along dimension, where
+   * the pixels are the squared distances of the previous passes. */
+  void TransformDimension( OutputPixelType *buffer, unsigned int dimension, double weight, double maximum );
+
+  InputPixelType m_BackgroundValue{};
+  bool m_SignedDistance{false};
+  bool m_InsideIsPositive{false};
+  bool m_SquaredDistance{false};
+  bool m_UseImageSpacing{true};
+  double m_MaximumDistance{std::numeric_limits<double>::max()};
+};
+
+
+} // end namespace itk
+
+
+#include "itkEuclideanDistanceMapImageFilter.hxx"
+
+#endif // itkEuclideanDistanceMapImageFilter_h
@@ -0,0 +1,271 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkEuclideanDistanceMapImageFilter_hxx
+#define itkEuclideanDistanceMapImageFilter_hxx
+
+#include "itkEuclideanDistanceMapImageFilter.h"
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
+#include "itkNumericTraits.h"
+
+#include <cmath>
+#include <vector>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  if ( m_MaximumDistance < 0.0 )
+    {
+    itkExceptionMacro( "The MaximumDistance " << m_MaximumDistance << " is negative!" );
+    }
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const RegionType region = output->GetBufferedRegion();
+  const OutputPixelType infinity = std::numeric_limits<OutputPixelType>::infinity();
+
+  // the squared distances to the object, and with a signed distance
+  // the squared distances to the background
+  OutputPixelType *outside = output->GetBufferPointer();
+  std::vector<OutputPixelType> insideBuffer( m_SignedDistance ? region.GetNumberOfPixels() : 0 );
+  OutputPixelType *inside = insideBuffer.data();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  const InputPixelType background = m_BackgroundValue;
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [input, output, outside, inside, background, infinity]( const RegionType &piece )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, piece );
+        while ( !inIt.IsAtEnd() )
+          {
+          SizeValueType offset = output->ComputeOffset( inIt.GetIndex() );
+          while ( !inIt.IsAtEndOfLine() )
+            {
+            const bool object = ( inIt.Get() != background );
+            outside[offset] = object ? 0 : infinity;
+            if ( inside )
+              {
+              inside[offset] = object ? infinity : 0;
+              }
+            ++offset;
+            ++inIt;
+            }
+          inIt.NextLine();
+          }
+      },
+    nullptr );
+
+  const double maximum = m_MaximumDistance * m_MaximumDistance;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const double spacing = m_UseImageSpacing ? output->GetSpacing()[d] : 1.0;
+    this->TransformDimension( outside, d, spacing * spacing, maximum );
+    if ( inside )
+      {
+      this->TransformDimension( inside, d, spacing * spacing, maximum );
+      }
+    }
+
+  // the distances beyond the bound, or to a missing object
+  OutputPixelType farthest = NumericTraits<OutputPixelType>::max();
+  if ( maximum < static_cast<double>( NumericTraits<OutputPixelType>::max() ) )
+    {
+    farthest = static_cast<OutputPixelType>( m_SquaredDistance ? maximum : m_MaximumDistance );
+    }
+
+  const bool squared = m_SquaredDistance;
+  const OutputPixelType insideSign = m_InsideIsPositive ? 1 : -1;
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    region.GetNumberOfPixels(),
+    [outside, inside, squared, insideSign, farthest, infinity]( SizeValueType i )
+      {
+        OutputPixelType value = outside[i];
+        OutputPixelType sign = 1;
+        if ( inside )
+          {
+          sign = -insideSign;
+          if ( value == 0 )
+            {
+            value = inside[i];
+            sign = insideSign;
+            }
+          }
+        value = ( value == infinity ) ? farthest : ( squared ? value : std::sqrt( value ) );
+        outside[i] = sign * value;
+      },
+    this );
+}
+
+
+//
+// TransformDimension
+//
+template < class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >::TransformDimension( OutputPixelType *buffer,
+                                                                                  unsigned int dimension,
+                                                                                  double weight,
+                                                                                  double maximum )
+{
+  const OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetBufferedRegion();
+  const OffsetValueType stride = output->GetOffsetTable()[dimension];
+  const SizeValueType length = region.GetSize( dimension );
+  const OutputPixelType infinity = std::numeric_limits<OutputPixelType>::infinity();
+
+  this->GetMultiThreader()->template ParallelizeImageRegionRestrictDirection<ImageDimension>(
+    dimension,
+    region,
+    [&]( const RegionType &piece )
+      {
+        // the samples of a line, and the lower envelope of their
+        // parabolas: the samples of the parabolas and the start of
+        // their intervals
+        std::vector<OutputPixelType> samples( length );
+        std::vector<SizeValueType> parabolas( length );
+        std::vector<double> starts( length + 1 );
+
+        RegionType lines = piece;
+        lines.SetSize( dimension, 1 );
+
+        ImageRegionConstIteratorWithIndex<OutputImageType> it( output, lines );
+        for ( ; !it.IsAtEnd(); ++it )
+          {
+          OutputPixelType *line = buffer + output->ComputeOffset( it.GetIndex() );
+
+          SizeValueType k = 0;
+          bool empty = true;
+          for ( SizeValueType q = 0; q < length; ++q )
+            {
+            const OutputPixelType sample = line[q * stride];
+            samples[q] = sample;
+            if ( sample == infinity )
+              {
+              continue;
+              }
+
+            const double height = sample + weight * q * q;
+            if ( empty )
+              {
+              parabolas[0] = q;
+              starts[0] = -std::numeric_limits<double>::infinity();
+              empty = false;
+              continue;
+              }
+
+            // remove the parabolas which are above the new one on all of
+            // their interval, the first one starting at -infinity
+            SizeValueType p = parabolas[k];
+            double start = ( height - ( samples[p] + weight * p * p ) ) / ( 2.0 * weight * ( q - p ) );
+            while ( start <= starts[k] )
+              {
+              --k;
+              p = parabolas[k];
+              start = ( height - ( samples[p] + weight * p * p ) ) / ( 2.0 * weight * ( q - p ) );
+              }
+            ++k;
+            parabolas[k] = q;
+            starts[k] = start;
+            }
+
+          if ( empty )
+            {
+            continue;
+            }
+          starts[k + 1] = std::numeric_limits<double>::infinity();
+
+          SizeValueType j = 0;
+          for ( SizeValueType q = 0; q < length; ++q )
+            {
+            while ( starts[j + 1] < q )
+              {
+              ++j;
+              }
+            const SizeValueType p = parabolas[j];
+            const double distance = weight * ( static_cast<double>( q ) - p ) * ( static_cast<double>( q ) - p ) + samples[p];
+            line[q * stride] = ( distance > maximum ) ? infinity : static_cast<OutputPixelType>( distance );
+            }
+          }
+      },
+    nullptr );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+EuclideanDistanceMapImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BackgroundValue: " << static_cast<typename NumericTraits<InputPixelType>::PrintType>( m_BackgroundValue ) << std::endl;
+  os << indent << "SignedDistance: " << m_SignedDistance << std::endl;
+  os << indent << "InsideIsPositive: " << m_InsideIsPositive << std::endl;
+  os << indent << "SquaredDistance: " << m_SquaredDistance << std::endl;
+  os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
+  os << indent << "MaximumDistance: " << m_MaximumDistance << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkEuclideanDistanceMapImageFilter_hxx
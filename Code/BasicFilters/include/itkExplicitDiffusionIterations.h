@@ -0,0 +1,352 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkExplicitDiffusionIterations_h
+#define itkExplicitDiffusionIterations_h
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+
+namespace itk {
+
+/** 3 to the power VExponent, the number of rows of the neighborhoods
+ * of VExponent + 1 dimensional images. */
+template < unsigned int VExponent >
+struct ExplicitDiffusionPowerOfThree
+{
+  static constexpr unsigned int Value = 3 * ExplicitDiffusionPowerOfThree< VExponent - 1 >::Value;
+};
+
+template <>
+struct ExplicitDiffusionPowerOfThree< 0 >
+{
+  static constexpr unsigned int Value = 1;
+};
+
+
+/** \brief The 3x3x...x3 neighborhood of a pixel in the buffer of an
+ * explicit diffusion iteration.
+ *
+ * The neighborhood refers to the 3^(VDimension-1) rows around the
+ * row of the pixel, and to the columns of the pixel and of its two
+ * neighbors in the rows. The rows and columns outside of the image
+ * are clamped to the border, as with the ZeroFluxNeumann boundary
+ * condition of the finite difference functions.
+ */
+template < typename TRealType, unsigned int VDimension >
+class ExplicitDiffusionNeighborhood
+{
+public:
+  using RealType = TRealType;
+
+  static constexpr unsigned int ImageDimension = VDimension;
+
+  /** The number of rows of the neighborhood, and the row of the
+   * pixel. */
+  static constexpr unsigned int NumberOfRows = ExplicitDiffusionPowerOfThree< VDimension - 1 >::Value;
+  static constexpr unsigned int CenterRow = NumberOfRows / 2;
+
+  ExplicitDiffusionNeighborhood( const RealType * const *rows, SizeValueType previous, SizeValueType column, SizeValueType next )
+    : m_Rows( rows ),
+      m_Columns{ { previous, column, next } }
+  {}
+
+  /** The value of the pixel. */
+  RealType
+  GetCenterPixel() const
+  {
+    return m_Rows[CenterRow][m_Columns[1]];
+  }
+
+  /** The value at the offset s, -1 or 1, along the axis i. */
+  RealType
+  GetPixel( unsigned int i, int s ) const
+  {
+    return ( i == 0 ) ? m_Rows[CenterRow][m_Columns[1 + s]] : m_Rows[static_cast<int>( CenterRow ) + s * static_cast<int>( RowStride( i ) )][m_Columns[1]];
+  }
+
+  /** The value at the offsets si along the axis i and sj along the
+   * axis j, for i != j. */
+  RealType
+  GetPixel( unsigned int i, int si, unsigned int j, int sj ) const
+  {
+    int row = static_cast<int>( CenterRow );
+    int column = 1;
+    if ( i == 0 )
+      {
+      column += si;
+      }
+    else
+      {
+      row += si * static_cast<int>( RowStride( i ) );
+      }
+    if ( j == 0 )
+      {
+      column += sj;
+      }
+    else
+      {
+      row += sj * static_cast<int>( RowStride( j ) );
+      }
+    return m_Rows[row][m_Columns[column]];
+  }
+
+  /** The distance between the rows of the neighbors along the axis
+   * i > 0. */
+  static constexpr unsigned int
+  RowStride( unsigned int i )
+  {
+    return ( i <= 1 ) ? 1 : 3 * RowStride( i - 1 );
+  }
+
+private:
+  const RealType * const            *m_Rows;
+  const std::array< SizeValueType, 3 > m_Columns;
+};
+
+/** \brief The buffers of the explicit iterations of a diffusion,
+ * kept across the iterations.
+ *
+ * Each iteration computes the update of every pixel from the
+ * neighborhood of the pixel in the current buffer, and writes the
+ * pixel plus the time step times the update to the other buffer,
+ * which becomes the current buffer of the next iteration. No buffer
+ * is allocated by the iterations, and the first buffer may be the
+ * buffer of the output image, as for an in-place filter.
+ *
+ * The image is processed in blocks of consecutive rows, which are
+ * distributed over the threads of the multithreader. The pixels
+ * inside the rows are computed by a loop without the clamping of the
+ * columns, which the compiler may vectorize. The sums of the blocks
+ * are added in the order of the blocks, so that the results do not
+ * depend on the number of threads.
+ */
+template < typename TRealType, unsigned int VDimension >
+class ExplicitDiffusionIterations
+{
+public:
+  using RealType = TRealType;
+  using NeighborhoodType = ExplicitDiffusionNeighborhood< TRealType, VDimension >;
+  using ScalesType = std::array< double, VDimension >;
+
+  static constexpr unsigned int ImageDimension = VDimension;
+
+  /** Set the size of the buffers and the scales of the derivatives
+   * along the axes. The first buffer is buffer, which holds the
+   * initial image, or a buffer of the iterations when buffer is null.
+   */
+  void Initialize( RealType *buffer,
+                   const std::array< SizeValueType, VDimension > &size,
+                   const ScalesType &scales,
+                   MultiThreaderBase *multiThreader,
+                   unsigned int numberOfWorkUnits )
+  {
+    m_Size = size;
+    m_Scales = scales;
+    m_MultiThreader = multiThreader;
+    m_NumberOfWorkUnits = std::max( numberOfWorkUnits, 1u );
+
+    m_NumberOfPixels = 1;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      m_Strides[d] = m_NumberOfPixels;
+      m_NumberOfPixels *= m_Size[d];
+      }
+
+    m_Buffers[0].clear();
+    m_Buffers[1].assign( m_NumberOfPixels, RealType( 0 ) );
+    if ( buffer == nullptr )
+      {
+      m_Buffers[0].assign( m_NumberOfPixels, RealType( 0 ) );
+      buffer = m_Buffers[0].data();
+      }
+    m_Current = buffer;
+    m_Next = m_Buffers[1].data();
+  }
+
+  /** Release the buffers of the iterations. */
+  void Release()
+  {
+    m_Buffers[0] = std::vector< RealType >();
+    m_Buffers[1] = std::vector< RealType >();
+    m_Current = nullptr;
+    m_Next = nullptr;
+  }
+
+  /** The buffer of the current image. */
+  RealType *
+  GetCurrentBuffer() const
+  {
+    return m_Current;
+  }
+
+  SizeValueType
+  GetNumberOfPixels() const
+  {
+    return m_NumberOfPixels;
+  }
+
+  const ScalesType &
+  GetScales() const
+  {
+    return m_Scales;
+  }
+
+  /** The mean of the squared magnitudes of the gradients of the
+   * current image, with central differences, as computed by
+   * ScalarAnisotropicDiffusionFunction. */
+  double
+  ComputeAverageGradientMagnitudeSquared()
+  {
+    const ScalesType scales = m_Scales;
+    const double sum = this->ParallelizeNeighborhoods( [scales]( const NeighborhoodType &it, SizeValueType )
+      {
+        double magnitude = 0.0;
+        for ( unsigned int i = 0; i < VDimension; ++i )
+          {
+          const double dx = 0.5 * ( double( it.GetPixel( i, 1 ) ) - double( it.GetPixel( i, -1 ) ) ) * scales[i];
+          magnitude += dx * dx;
+          }
+        return magnitude;
+      } );
+    return sum / static_cast<double>( m_NumberOfPixels );
+  }
+
+  /** Update the image with the time step times the updates of the
+   * scheme, scheme.ComputeUpdate( neighborhood ), and return the root
+   * mean square of the changes. */
+  template < typename TScheme >
+  double
+  Iterate( const TScheme &scheme, RealType timeStep )
+  {
+    RealType *next = m_Next;
+    const double sum = this->ParallelizeNeighborhoods( [&scheme, timeStep, next]( const NeighborhoodType &it, SizeValueType offset )
+      {
+        const RealType change = timeStep * scheme.ComputeUpdate( it );
+        next[offset] = it.GetCenterPixel() + change;
+        return double( change ) * double( change );
+      } );
+    std::swap( m_Current, m_Next );
+    return std::sqrt( sum / static_cast<double>( m_NumberOfPixels ) );
+  }
+
+private:
+  /** Call f( neighborhood, offset ) for the pixels of the current
+   * image, in parallel, and return the sum of the values. */
+  template < typename TFunction >
+  double
+  ParallelizeNeighborhoods( TFunction &&f )
+  {
+    constexpr SizeValueType BlockSize = 1 << 14;
+    const SizeValueType width = m_Size[0];
+    const SizeValueType numberOfLines = m_NumberOfPixels / width;
+    const SizeValueType linesPerBlock = std::max( BlockSize / width, SizeValueType( 1 ) );
+    const SizeValueType numberOfBlocks = ( numberOfLines + linesPerBlock - 1 ) / linesPerBlock;
+    const RealType *current = m_Current;
+
+    std::vector< double > blockSums( numberOfBlocks, 0.0 );
+    m_MultiThreader->SetNumberOfWorkUnits( m_NumberOfWorkUnits );
+    m_MultiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&]( SizeValueType block )
+        {
+          const RealType *rows[NeighborhoodType::NumberOfRows];
+          double sum = 0.0;
+
+          const SizeValueType lastLine = std::min( numberOfLines, ( block + 1 ) * linesPerBlock );
+          for ( SizeValueType line = block * linesPerBlock; line < lastLine; ++line )
+            {
+            // the index of the line along the axes above 0
+            std::array< SizeValueType, VDimension > index;
+            SizeValueType position = line;
+            for ( unsigned int d = 1; d < VDimension; ++d )
+              {
+              index[d] = position % m_Size[d];
+              position /= m_Size[d];
+              }
+
+            // the clamped rows of the neighborhoods of the line
+            for ( unsigned int row = 0; row < NeighborhoodType::NumberOfRows; ++row )
+              {
+              SizeValueType offset = 0;
+              unsigned int r = row;
+              for ( unsigned int d = 1; d < VDimension; ++d )
+                {
+                const int s = static_cast<int>( r % 3 ) - 1;
+                r /= 3;
+                SizeValueType i = index[d];
+                if ( s < 0 && i > 0 )
+                  {
+                  --i;
+                  }
+                else if ( s > 0 && i + 1 < m_Size[d] )
+                  {
+                  ++i;
+                  }
+                offset += i * m_Strides[d];
+                }
+              rows[row] = current + offset;
+              }
+
+            const SizeValueType lineOffset = line * width;
+            if ( width == 1 )
+              {
+              sum += f( NeighborhoodType( rows, 0, 0, 0 ), lineOffset );
+              continue;
+              }
+            sum += f( NeighborhoodType( rows, 0, 0, 1 ), lineOffset );
+            for ( SizeValueType x = 1; x + 1 < width; ++x )
+              {
+              sum += f( NeighborhoodType( rows, x - 1, x, x + 1 ), lineOffset + x );
+              }
+            sum += f( NeighborhoodType( rows, width - 2, width - 1, width - 1 ), lineOffset + width - 1 );
+            }
+          blockSums[block] = sum;
+        },
+      nullptr );
+
+    double sum = 0.0;
+    for ( double blockSum : blockSums )
+      {
+      sum += blockSum;
+      }
+    return sum;
+  }
+
+  std::array< SizeValueType, VDimension > m_Size;
+  std::array< SizeValueType, VDimension > m_Strides;
+  ScalesType                              m_Scales;
+  SizeValueType                           m_NumberOfPixels{ 0 };
+  MultiThreaderBase                      *m_MultiThreader{ nullptr };
+  unsigned int                            m_NumberOfWorkUnits{ 1 };
+
+  std::array< std::vector< RealType >, 2 > m_Buffers;
+  RealType                               *m_Current{ nullptr };
+  RealType                               *m_Next{ nullptr };
+};
+
+
+} // end namespace itk
+
+#endif // itkExplicitDiffusionIterations_h
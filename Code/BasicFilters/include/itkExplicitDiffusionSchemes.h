@@ -0,0 +1,278 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkExplicitDiffusionSchemes_h
+#define itkExplicitDiffusionSchemes_h
+
+#include "itkIntTypes.h"
+#include "itkMath.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+
+namespace itk {
+
+/** \brief The conductance of the anisotropic diffusion schemes.
+ *
+ * The average squared gradient magnitude is computed every
+ * ConductanceScalingUpdateInterval iterations unless it is fixed, and
+ * K = -2 ConductanceParameter^2 <|grad I|^2>, as in the
+ * InitializeIteration methods of AnisotropicDiffusionImageFilter and
+ * of the functions.
+ */
+template < typename TRealType, unsigned int VDimension >
+class AnisotropicDiffusionSchemeBase
+{
+public:
+  using RealType = TRealType;
+
+  template < typename TFilter, typename TIterations >
+  void
+  InitializeIteration( const TFilter *filter, TIterations &iterations, IdentifierType elapsedIterations )
+  {
+    if ( filter->GetGradientMagnitudeIsFixed() )
+      {
+      m_AverageGradientMagnitudeSquared = itk::Math::sqr( filter->GetFixedAverageGradientMagnitude() );
+      }
+    else if ( elapsedIterations % std::max( filter->GetConductanceScalingUpdateInterval(), 1u ) == 0 )
+      {
+      m_AverageGradientMagnitudeSquared = iterations.ComputeAverageGradientMagnitudeSquared();
+      }
+    m_K = static_cast<RealType>( m_AverageGradientMagnitudeSquared * filter->GetConductanceParameter() * filter->GetConductanceParameter() * -2.0 );
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      m_Scales[d] = static_cast<RealType>( iterations.GetScales()[d] );
+      }
+  }
+
+protected:
+  std::array< RealType, VDimension > m_Scales;
+  RealType                           m_K{ 0 };
+  double                             m_AverageGradientMagnitudeSquared{ 0.0 };
+};
+
+
+/** \brief The explicit scheme of GradientNDAnisotropicDiffusionFunction,
+ * the Perona-Malik equation with the conductance of the half
+ * derivatives.
+ */
+template < typename TRealType, unsigned int VDimension >
+class GradientAnisotropicDiffusionScheme
+  : public AnisotropicDiffusionSchemeBase< TRealType, VDimension >
+{
+public:
+  using RealType = TRealType;
+
+  template < typename TNeighborhood >
+  RealType
+  ComputeUpdate( const TNeighborhood &it ) const
+  {
+    const RealType center = it.GetCenterPixel();
+
+    // the central derivatives
+    RealType dx[VDimension] = {};
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      dx[i] = RealType( 0.5 ) * ( it.GetPixel( i, 1 ) - it.GetPixel( i, -1 ) ) * this->m_Scales[i];
+      }
+
+    RealType delta = 0;
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      // the half derivatives, with the conductance of the gradient
+      // magnitudes at the half pixels
+      RealType dxForward = ( it.GetPixel( i, 1 ) - center ) * this->m_Scales[i];
+      RealType dxBackward = ( center - it.GetPixel( i, -1 ) ) * this->m_Scales[i];
+
+      RealType accum = 0;
+      RealType accumBackward = 0;
+      for ( unsigned int j = 0; j < VDimension; ++j )
+        {
+        if ( j != i )
+          {
+          const RealType dxAug = RealType( 0.5 ) * ( it.GetPixel( i, 1, j, 1 ) - it.GetPixel( i, 1, j, -1 ) ) * this->m_Scales[j];
+          const RealType dxDim = RealType( 0.5 ) * ( it.GetPixel( i, -1, j, 1 ) - it.GetPixel( i, -1, j, -1 ) ) * this->m_Scales[j];
+          accum += RealType( 0.25 ) * itk::Math::sqr( dx[j] + dxAug );
+          accumBackward += RealType( 0.25 ) * itk::Math::sqr( dx[j] + dxDim );
+          }
+        }
+
+      RealType cx = 0;
+      RealType cxBackward = 0;
+      if ( this->m_K != RealType( 0 ) )
+        {
+        cx = std::exp( ( itk::Math::sqr( dxForward ) + accum ) / this->m_K );
+        cxBackward = std::exp( ( itk::Math::sqr( dxBackward ) + accumBackward ) / this->m_K );
+        }
+
+      delta += dxForward * cx - dxBackward * cxBackward;
+      }
+    return delta;
+  }
+};
+
+
+/** \brief The explicit scheme of CurvatureNDAnisotropicDiffusionFunction,
+ * the modified curvature diffusion equation of Whitaker and Xue.
+ */
+template < typename TRealType, unsigned int VDimension >
+class CurvatureAnisotropicDiffusionScheme
+  : public AnisotropicDiffusionSchemeBase< TRealType, VDimension >
+{
+public:
+  using RealType = TRealType;
+
+  template < typename TNeighborhood >
+  RealType
+  ComputeUpdate( const TNeighborhood &it ) const
+  {
+    constexpr RealType MinNorm = static_cast<RealType>( 1.0e-10 );
+    const RealType center = it.GetCenterPixel();
+
+    RealType dx[VDimension] = {};
+    RealType dxForward[VDimension] = {};
+    RealType dxBackward[VDimension] = {};
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      dxForward[i] = ( it.GetPixel( i, 1 ) - center ) * this->m_Scales[i];
+      dxBackward[i] = ( center - it.GetPixel( i, -1 ) ) * this->m_Scales[i];
+      dx[i] = RealType( 0.5 ) * ( it.GetPixel( i, 1 ) - it.GetPixel( i, -1 ) ) * this->m_Scales[i];
+      }
+
+    RealType speed = 0;
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      // the gradient magnitudes at the half pixels
+      RealType gradMagSq = dxForward[i] * dxForward[i];
+      RealType gradMagSqBackward = dxBackward[i] * dxBackward[i];
+      for ( unsigned int j = 0; j < VDimension; ++j )
+        {
+        if ( j != i )
+          {
+          const RealType dxAug = RealType( 0.5 ) * ( it.GetPixel( i, 1, j, 1 ) - it.GetPixel( i, 1, j, -1 ) ) * this->m_Scales[j];
+          const RealType dxDim = RealType( 0.5 ) * ( it.GetPixel( i, -1, j, 1 ) - it.GetPixel( i, -1, j, -1 ) ) * this->m_Scales[j];
+          gradMagSq += RealType( 0.25 ) * ( dx[j] + dxAug ) * ( dx[j] + dxAug );
+          gradMagSqBackward += RealType( 0.25 ) * ( dx[j] + dxDim ) * ( dx[j] + dxDim );
+          }
+        }
+      const RealType gradMag = std::sqrt( MinNorm + gradMagSq );
+      const RealType gradMagBackward = std::sqrt( MinNorm + gradMagSqBackward );
+
+      RealType cx = 0;
+      RealType cxBackward = 0;
+      if ( this->m_K != RealType( 0 ) )
+        {
+        cx = std::exp( gradMagSq / this->m_K );
+        cxBackward = std::exp( gradMagSqBackward / this->m_K );
+        }
+
+      // the conductance modified curvature
+      speed += ( dxForward[i] / gradMag ) * cx - ( dxBackward[i] / gradMagBackward ) * cxBackward;
+      }
+
+    // the upwind gradient magnitude
+    RealType propagationGradient = 0;
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      if ( speed > 0 )
+        {
+        propagationGradient += itk::Math::sqr( std::min( dxBackward[i], RealType( 0 ) ) ) + itk::Math::sqr( std::max( dxForward[i], RealType( 0 ) ) );
+        }
+      else
+        {
+        propagationGradient += itk::Math::sqr( std::max( dxBackward[i], RealType( 0 ) ) ) + itk::Math::sqr( std::min( dxForward[i], RealType( 0 ) ) );
+        }
+      }
+    return std::sqrt( propagationGradient ) * speed;
+  }
+};
+
+
+/** \brief The explicit scheme of CurvatureFlowFunction, the mean
+ * curvature times the gradient magnitude.
+ */
+template < typename TRealType, unsigned int VDimension >
+class CurvatureFlowScheme
+{
+public:
+  using RealType = TRealType;
+
+  template < typename TFilter, typename TIterations >
+  void
+  InitializeIteration( const TFilter *, TIterations &iterations, IdentifierType )
+  {
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      m_Scales[d] = static_cast<RealType>( iterations.GetScales()[d] );
+      }
+  }
+
+  template < typename TNeighborhood >
+  RealType
+  ComputeUpdate( const TNeighborhood &it ) const
+  {
+    const RealType center = it.GetCenterPixel();
+
+    RealType firstDerivative[VDimension] = {};
+    RealType secondDerivative[VDimension] = {};
+    RealType magnitudeSqr = 0;
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      firstDerivative[i] = RealType( 0.5 ) * ( it.GetPixel( i, 1 ) - it.GetPixel( i, -1 ) ) * m_Scales[i];
+      secondDerivative[i] = ( it.GetPixel( i, 1 ) - 2 * center + it.GetPixel( i, -1 ) ) * m_Scales[i] * m_Scales[i];
+      magnitudeSqr += firstDerivative[i] * firstDerivative[i];
+      }
+    if ( magnitudeSqr < RealType( 1e-9 ) )
+      {
+      return 0;
+      }
+
+    // dx^2 (dyy + dzz) + ... - 2 (dx dy dxy + ...)
+    RealType update = 0;
+    for ( unsigned int i = 0; i < VDimension; ++i )
+      {
+      RealType temp = 0;
+      for ( unsigned int j = 0; j < VDimension; ++j )
+        {
+        if ( j != i )
+          {
+          temp += secondDerivative[j];
+          }
+        }
+      update += temp * firstDerivative[i] * firstDerivative[i];
+
+      for ( unsigned int j = i + 1; j < VDimension; ++j )
+        {
+        const RealType crossDerivative = RealType( 0.25 ) *
+          ( it.GetPixel( i, -1, j, -1 ) - it.GetPixel( i, -1, j, 1 ) - it.GetPixel( i, 1, j, -1 ) + it.GetPixel( i, 1, j, 1 ) ) *
+          m_Scales[i] * m_Scales[j];
+        update -= 2 * firstDerivative[i] * firstDerivative[j] * crossDerivative;
+        }
+      }
+    return update / magnitudeSqr;
+  }
+
+private:
+  std::array< RealType, VDimension > m_Scales;
+};
+
+
+} // end namespace itk
+
+#endif // itkExplicitDiffusionSchemes_h
@@ -0,0 +1,118 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFastBilateralImageFilter_h
+#define itkFastBilateralImageFilter_h
+
+#include "itkBilateralImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class FastBilateralImageFilter
+ * \brief Bilateral filter with the approximation of a bilateral grid.
+ *
+ * When UseBilateralGrid is on, the bilateral filter is approximated as
+ * proposed by Paris and Durand: the pixels are accumulated in a grid
+ * of the space and the range of the intensities, sampled every
+ * DomainSigma in each dimension and every RangeSigma for the
+ * intensities. The grid is smoothed by a Gaussian of one cell in each
+ * of its dimensions, then the output is interpolated in it at the
+ * position and the intensity of each pixel. The cost then does not
+ * depend on the sigmas, and the memory of the grid decreases with
+ * them.
+ *
+ * The accumulation, the smoothing and the interpolation are split
+ * between the threads of the multithreader. The whole input is
+ * required.
+ *
+ * When UseBilateralGrid is off, the superclass algorithm is used.
+ *
+ * Reference: S. Paris and F. Durand, "A Fast Approximation of the
+ * Bilateral Filter using a Signal Processing Approach", International
+ * Journal of Computer Vision, 81(1): 24-52, 2009.
+ *
+ * \sa BilateralImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class FastBilateralImageFilter:
+    public BilateralImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = FastBilateralImageFilter;
+  using Superclass = BilateralImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(FastBilateralImageFilter, BilateralImageFilter);
+
+  /** Whether the bilateral grid is used. Off by default. */
+  itkSetMacro( UseBilateralGrid, bool );
+  itkGetConstMacro( UseBilateralGrid, bool );
+  itkBooleanMacro( UseBilateralGrid );
+
+protected:
+
+  FastBilateralImageFilter() = default;
+
+  ~FastBilateralImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The grid is computed by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the grid needs all of the input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the grid produces all of the output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  FastBilateralImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_UseBilateralGrid{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkFastBilateralImageFilter.hxx"
+
+#endif // itkFastBilateralImageFilter_h
@@ -0,0 +1,292 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFastBilateralImageFilter_hxx
+#define itkFastBilateralImageFilter_hxx
+
+#include "itkFastBilateralImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+FastBilateralImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  if ( !m_UseBilateralGrid )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  // the spatial dimensions then the range of the grid
+  constexpr unsigned int GridDimension = ImageDimension + 1;
+  // the cells on each side of the grid for the smoothing kernel
+  constexpr SizeValueType Padding = 2;
+
+  using InputPixelType = typename InputImageType::PixelType;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const typename InputImageType::SizeType size = input->GetBufferedRegion().GetSize();
+  const InputPixelType *inputBuffer = input->GetBufferPointer();
+  OutputPixelType *outputBuffer = output->GetBufferPointer();
+
+  // the sampling rates of the grid, in pixels and in intensities
+  double samplingRate[GridDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    samplingRate[d] = this->GetDomainSigma()[d] / input->GetSpacing()[d];
+    if ( !( samplingRate[d] > 0.0 ) )
+      {
+      itkExceptionMacro( << "DomainSigma must be positive: " << this->GetDomainSigma() );
+      }
+    }
+  samplingRate[ImageDimension] = this->GetRangeSigma();
+  if ( !( samplingRate[ImageDimension] > 0.0 ) )
+    {
+    itkExceptionMacro( << "RangeSigma must be positive: " << this->GetRangeSigma() );
+    }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // the images are processed by the slices of the slowest dimension
+  constexpr unsigned int SliceDimension = ImageDimension - 1;
+  const SizeValueType numberOfSlices = size[SliceDimension];
+  const SizeValueType sliceSize = input->GetBufferedRegion().GetNumberOfPixels() / numberOfSlices;
+
+  // call f( pixel offset, index ) for each pixel of slice
+  auto forEachPixelOfSlice = [&]( SizeValueType slice, const auto &f )
+    {
+      SizeValueType index[ImageDimension] = {};
+      index[SliceDimension] = slice;
+      const SizeValueType first = slice * sliceSize;
+      for ( SizeValueType p = first; p < first + sliceSize; ++p )
+        {
+        f( p, index );
+        for ( unsigned int d = 0; d < SliceDimension && ++index[d] == size[d]; ++d )
+          {
+          index[d] = 0;
+          }
+        }
+    };
+
+  // the range of the intensities
+  double minimum = std::numeric_limits<double>::max();
+  double maximum = std::numeric_limits<double>::lowest();
+  std::mutex mutex;
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfSlices,
+    [&]( SizeValueType slice )
+      {
+        const InputPixelType *first = inputBuffer + slice * sliceSize;
+        const auto range = std::minmax_element( first, first + sliceSize );
+        std::lock_guard<std::mutex> lock( mutex );
+        minimum = std::min( minimum, static_cast<double>( *range.first ) );
+        maximum = std::max( maximum, static_cast<double>( *range.second ) );
+      },
+    nullptr );
+
+  // the size and the strides of the grid
+  SizeValueType gridSize[GridDimension];
+  SizeValueType stride[GridDimension + 1];
+  stride[0] = 1;
+  for ( unsigned int k = 0; k < GridDimension; ++k )
+    {
+    const double extent = ( k < ImageDimension ) ? size[k] - 1.0 : maximum - minimum;
+    gridSize[k] = static_cast<SizeValueType>( std::lround( extent / samplingRate[k] ) ) + 1 + 2 * Padding;
+    stride[k + 1] = stride[k] * gridSize[k];
+    }
+  const SizeValueType numberOfCells = stride[GridDimension];
+
+  // the sums of the intensities and of the weights of the cells
+  std::vector<float> grid( 2 * numberOfCells, 0.0f );
+
+  auto gridCoordinate = [&]( unsigned int k, double x )
+    {
+      return x / samplingRate[k] + Padding;
+    };
+  auto intensity = [&]( InputPixelType value )
+    {
+      return static_cast<double>( value ) - minimum;
+    };
+
+  // accumulate the pixels into their nearest cell, the slices of a
+  // cell being accumulated by the same thread
+  std::vector<SizeValueType> firstSliceOfCell( gridSize[SliceDimension] + 1, numberOfSlices );
+  for ( SizeValueType slice = numberOfSlices; slice-- > 0; )
+    {
+    const auto cell = static_cast<SizeValueType>( std::lround( gridCoordinate( SliceDimension, slice ) ) );
+    std::fill( firstSliceOfCell.begin(), firstSliceOfCell.begin() + cell + 1, slice );
+    }
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    gridSize[SliceDimension],
+    [&]( SizeValueType cell )
+      {
+        for ( SizeValueType slice = firstSliceOfCell[cell]; slice < firstSliceOfCell[cell + 1]; ++slice )
+          {
+          forEachPixelOfSlice( slice, [&]( SizeValueType p, const SizeValueType *index )
+            {
+              const double value = intensity( inputBuffer[p] );
+              SizeValueType offset = static_cast<SizeValueType>( std::lround( gridCoordinate( ImageDimension, value ) ) ) * stride[ImageDimension];
+              for ( unsigned int d = 0; d < ImageDimension; ++d )
+                {
+                offset += static_cast<SizeValueType>( std::lround( gridCoordinate( d, index[d] ) ) ) * stride[d];
+                }
+              grid[2 * offset] += static_cast<float>( value );
+              grid[2 * offset + 1] += 1.0f;
+            } );
+          }
+      },
+    nullptr );
+
+  // smooth the grid by a Gaussian of one cell, in each of its dimensions
+  std::vector<float> smoothed( grid.size() );
+  for ( unsigned int k = 0; k < GridDimension; ++k )
+    {
+    const SizeValueType length = gridSize[k];
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfCells / length,
+      [&]( SizeValueType line )
+        {
+          constexpr float kernel[2 * Padding + 1] = { 1.0f / 16, 4.0f / 16, 6.0f / 16, 4.0f / 16, 1.0f / 16 };
+          const SizeValueType first = line % stride[k] + ( line / stride[k] ) * stride[k + 1];
+          for ( SizeValueType i = 0; i < length; ++i )
+            {
+            float sums[2] = { 0.0f, 0.0f };
+            const SizeValueType begin = ( i < Padding ) ? 0 : i - Padding;
+            const SizeValueType end = std::min( i + Padding + 1, length );
+            for ( SizeValueType j = begin; j < end; ++j )
+              {
+              const SizeValueType cell = first + j * stride[k];
+              sums[0] += kernel[j + Padding - i] * grid[2 * cell];
+              sums[1] += kernel[j + Padding - i] * grid[2 * cell + 1];
+              }
+            const SizeValueType cell = first + i * stride[k];
+            smoothed[2 * cell] = sums[0];
+            smoothed[2 * cell + 1] = sums[1];
+            }
+        },
+      nullptr );
+    std::swap( grid, smoothed );
+    }
+  smoothed.clear();
+  smoothed.shrink_to_fit();
+
+  // interpolate the grid at each pixel
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfSlices,
+    [&]( SizeValueType slice )
+      {
+        forEachPixelOfSlice( slice, [&]( SizeValueType p, const SizeValueType *index )
+          {
+            SizeValueType floor[GridDimension];
+            double fraction[GridDimension];
+            for ( unsigned int k = 0; k < GridDimension; ++k )
+              {
+              const double x = gridCoordinate( k, ( k < ImageDimension ) ? index[k] : intensity( inputBuffer[p] ) );
+              floor[k] = static_cast<SizeValueType>( x );
+              fraction[k] = x - floor[k];
+              }
+
+            double sums[2] = { 0.0, 0.0 };
+            for ( unsigned int corner = 0; corner < ( 1u << GridDimension ); ++corner )
+              {
+              double weight = 1.0;
+              SizeValueType cell = 0;
+              for ( unsigned int k = 0; k < GridDimension; ++k )
+                {
+                const bool upper = ( corner >> k ) & 1u;
+                weight *= upper ? fraction[k] : 1.0 - fraction[k];
+                cell += ( floor[k] + upper ) * stride[k];
+                }
+              sums[0] += weight * grid[2 * cell];
+              sums[1] += weight * grid[2 * cell + 1];
+              }
+
+            const double value = ( sums[1] > 0.0 ) ? sums[0] / sums[1] + minimum : static_cast<double>( inputBuffer[p] );
+            // the averages of integers are rounded
+            outputBuffer[p] = static_cast<OutputPixelType>( NumericTraits<OutputPixelType>::is_integer ? std::round( value ) : value );
+          } );
+      },
+    nullptr );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FastBilateralImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input && m_UseBilateralGrid )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FastBilateralImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  if ( m_UseBilateralGrid )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+FastBilateralImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseBilateralGrid: " << m_UseBilateralGrid << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkFastBilateralImageFilter_hxx
@@ -0,0 +1,158 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFastDiscreteGaussianImageFilter_h
+#define itkFastDiscreteGaussianImageFilter_h
+
+#include "itkDiscreteGaussianImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class FastDiscreteGaussianImageFilter
+ * \brief Gaussian smoothing with a selection of the algorithm.
+ *
+ * The Algorithm selects how the separable Gaussian is applied along
+ * each axis:
+ *
+ * - FIR uses the discrete kernels of the superclass.
+ * - IIR uses a third order recursive filter, with the poles of van
+ * Vliet, Young and Verbeek scaled to the variance, and the boundary
+ * initialization of Triggs and Sdika. The cost does not depend on
+ * the variance, with an error of about 2% of the kernel.
+ * - BoxCascade uses three box filters of the widths of Kovesi, at an
+ * even lower cost and with an error of about 5% of the kernel.
+ * - FFT multiplies the Fourier transform of the lines, padded by the
+ * kernel radius for MaximumError, with the transform of the Gaussian.
+ * - Automatic selects the fastest algorithm whose error is below
+ * MaximumError, from an estimate of the cost of each algorithm per
+ * pixel for the variance and the size of the image. The FIR is only
+ * selected when its kernels are no wider than MaximumKernelWidth.
+ *
+ * Except with FIR, the kernels are not limited by MaximumKernelWidth,
+ * the boundary is the ZeroFluxNeumann boundary condition, and the
+ * whole input is required. The lines of each axis are processed in
+ * blocks of adjacent lines which are interleaved, so that the kernels
+ * along the lines are vectorized across the lines of a block, and the
+ * blocks are split between the threads of the multithreader.
+ *
+ * References:
+ * L. J. van Vliet, I. T. Young and P. W. Verbeek, "Recursive Gaussian
+ * Derivative Filters", ICPR 1998.
+ * B. Triggs and M. Sdika, "Boundary Conditions for Young-van Vliet
+ * Recursive Filtering", IEEE Transactions on Signal Processing,
+ * 54(6): 2365-2367, 2006.
+ * P. Kovesi, "Fast Almost-Gaussian Filtering", DICTA 2010.
+ *
+ * \sa DiscreteGaussianImageFilter
+ * \sa SmoothingRecursiveGaussianImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class FastDiscreteGaussianImageFilter:
+    public DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = FastDiscreteGaussianImageFilter;
+  using Superclass = DiscreteGaussianImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RealType = typename NumericTraits< InputPixelType >::RealType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(FastDiscreteGaussianImageFilter, DiscreteGaussianImageFilter);
+
+  enum AlgorithmType
+  {
+    FIR,
+    IIR,
+    BoxCascade,
+    FFT,
+    Automatic
+  };
+
+  /** The algorithm of the smoothing. FIR by default. */
+  itkSetMacro( Algorithm, AlgorithmType );
+  itkGetConstMacro( Algorithm, AlgorithmType );
+
+  /** The algorithm used for the input, FIR, IIR, BoxCascade or FFT,
+   * which is selected when the Algorithm is Automatic. */
+  AlgorithmType GetSelectedAlgorithm() const;
+
+protected:
+
+  FastDiscreteGaussianImageFilter() = default;
+
+  ~FastDiscreteGaussianImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The axes are smoothed by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the lines need all of the input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the lines produce all of the output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The standard deviation of the kernel of each axis in pixels,
+   * zero for the axes which are not smoothed. */
+  void GetSigmas( double sigmas[ImageDimension] ) const;
+
+  /** The radius of the kernel of sigma for the MaximumError of axis. */
+  SizeValueType GetKernelRadius( unsigned int axis, double sigma ) const;
+
+  /** The smallest length of the Fourier transforms not less than
+   * length, with the prime factors 2, 3 and 5. */
+  static SizeValueType GetFFTLength( SizeValueType length );
+
+  /** Smooth the lines of axis of buffer, of the size of the output. */
+  void SmoothAxis( std::vector<RealType> &buffer, unsigned int axis, double sigma, AlgorithmType algorithm );
+
+private:
+  FastDiscreteGaussianImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  AlgorithmType m_Algorithm{FIR};
+};
+
+
+} // end namespace itk
+
+
+#include "itkFastDiscreteGaussianImageFilter.hxx"
+
+#endif // itkFastDiscreteGaussianImageFilter_h
@@ -0,0 +1,584 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFastDiscreteGaussianImageFilter_hxx
+#define itkFastDiscreteGaussianImageFilter_hxx
+
+#include "itkFastDiscreteGaussianImageFilter.h"
+
+#include "itkMath.h"
+#include "vnl/algo/vnl_fft_1d.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace itk {
+
+//
+// GetSelectedAlgorithm
+//
+template < class TInputImage, class TOutputImage >
+auto
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::GetSelectedAlgorithm() const -> AlgorithmType
+{
+  const InputImageType *input = this->GetInput();
+  if ( m_Algorithm != Automatic || !input )
+    {
+    return ( m_Algorithm == Automatic ) ? FIR : m_Algorithm;
+    }
+
+  // the errors of the kernels of the recursive filter and of the box
+  // cascade, as the sum of their absolute differences to the Gaussian,
+  // for the sigmas of at least MinimumSigma
+  constexpr double IIRError = 0.03;
+  constexpr double BoxCascadeError = 0.05;
+  constexpr double MinimumSigma = 2.0;
+
+  double sigmas[ImageDimension];
+  this->GetSigmas( sigmas );
+
+  const typename InputImageType::SizeType &size = input->GetLargestPossibleRegion().GetSize();
+
+  // the estimated operations per pixel of each algorithm
+  bool smoothed = false;
+  bool firAllowed = true;
+  bool iirAllowed = true;
+  bool boxCascadeAllowed = true;
+  double firCost = 0.0;
+  double iirCost = 0.0;
+  double boxCascadeCost = 0.0;
+  double fftCost = 0.0;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( !( sigmas[d] > 0.0 ) || size[d] < 2 )
+      {
+      continue;
+      }
+    smoothed = true;
+
+    const SizeValueType radius = this->GetKernelRadius( d, sigmas[d] );
+    const SizeValueType width = 2 * radius + 1;
+    firAllowed = firAllowed && width <= static_cast<SizeValueType>( this->GetMaximumKernelWidth() );
+    firCost += 2.0 * width;
+
+    const double maximumError = this->GetMaximumError()[d];
+    iirAllowed = iirAllowed && sigmas[d] >= MinimumSigma && maximumError >= IIRError;
+    iirCost += 16.0;
+    boxCascadeAllowed = boxCascadeAllowed && sigmas[d] >= MinimumSigma && maximumError >= BoxCascadeError;
+    boxCascadeCost += 9.0;
+
+    const SizeValueType length = GetFFTLength( size[d] + 2 * radius );
+    fftCost += 5.0 * std::log2( static_cast<double>( length ) ) * length / size[d] + 6.0;
+    }
+
+  if ( !smoothed )
+    {
+    return FIR;
+    }
+
+  AlgorithmType algorithm = FFT;
+  double cost = fftCost;
+  auto select = [&]( bool allowed, AlgorithmType candidate, double candidateCost )
+    {
+      if ( allowed && candidateCost < cost )
+        {
+        algorithm = candidate;
+        cost = candidateCost;
+        }
+    };
+  select( firAllowed, FIR, firCost );
+  select( iirAllowed, IIR, iirCost );
+  select( boxCascadeAllowed, BoxCascade, boxCascadeCost );
+  return algorithm;
+}
+
+
+//
+// GetSigmas
+//
+template < class TInputImage, class TOutputImage >
+void
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::GetSigmas( double sigmas[ImageDimension] ) const
+{
+  const InputImageType *input = this->GetInput();
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    double variance = 0.0;
+    if ( d < this->GetFilterDimensionality() )
+      {
+      variance = this->GetVariance()[d];
+      if ( this->GetUseImageSpacing() )
+        {
+        variance /= input->GetSpacing()[d] * input->GetSpacing()[d];
+        }
+      }
+    sigmas[d] = ( variance > 0.0 ) ? std::sqrt( variance ) : 0.0;
+    }
+}
+
+
+//
+// GetKernelRadius
+//
+template < class TInputImage, class TOutputImage >
+SizeValueType
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::GetKernelRadius( unsigned int axis, double sigma ) const
+{
+  // the radius for which the tails of the Gaussian are below the
+  // MaximumError, limited for the invalid errors
+  const double maximumError = this->GetMaximumError()[axis];
+  const SizeValueType maximumRadius = static_cast<SizeValueType>( std::ceil( 10.0 * sigma ) ) + 1;
+  SizeValueType radius = 0;
+  while ( radius < maximumRadius && std::erfc( ( radius + 0.5 ) / ( sigma * std::sqrt( 2.0 ) ) ) > maximumError )
+    {
+    ++radius;
+    }
+  return radius;
+}
+
+
+//
+// GetFFTLength
+//
+template < class TInputImage, class TOutputImage >
+SizeValueType
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::GetFFTLength( SizeValueType length )
+{
+  for ( ;; ++length )
+    {
+    SizeValueType remainder = length;
+    for ( SizeValueType factor : { 2, 3, 5 } )
+      {
+      while ( remainder % factor == 0 )
+        {
+        remainder /= factor;
+        }
+      }
+    if ( remainder == 1 )
+      {
+      return length;
+      }
+    }
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  const AlgorithmType algorithm = this->GetSelectedAlgorithm();
+  if ( algorithm == FIR )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  // the pixels copied by each work unit
+  constexpr SizeValueType ChunkSize = 1 << 16;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const typename OutputImageType::SizeType &size = output->GetBufferedRegion().GetSize();
+  const SizeValueType numberOfPixels = output->GetBufferedRegion().GetNumberOfPixels();
+  const SizeValueType numberOfChunks = ( numberOfPixels + ChunkSize - 1 ) / ChunkSize;
+  const InputPixelType *inputBuffer = input->GetBufferPointer();
+  OutputPixelType *outputBuffer = output->GetBufferPointer();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  std::vector<RealType> buffer( numberOfPixels );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        const SizeValueType last = std::min( ( chunk + 1 ) * ChunkSize, numberOfPixels );
+        for ( SizeValueType p = chunk * ChunkSize; p < last; ++p )
+          {
+          buffer[p] = static_cast<RealType>( inputBuffer[p] );
+          }
+      },
+    nullptr );
+
+  double sigmas[ImageDimension];
+  this->GetSigmas( sigmas );
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( sigmas[d] > 0.0 && size[d] > 1 )
+      {
+      this->SmoothAxis( buffer, d, sigmas[d], algorithm );
+      }
+    }
+
+  // the integers are rounded, and clamped for the overshoots of the
+  // approximations
+  const RealType lowest = static_cast<RealType>( NumericTraits<OutputPixelType>::NonpositiveMin() );
+  const RealType highest = static_cast<RealType>( NumericTraits<OutputPixelType>::max() );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        const SizeValueType last = std::min( ( chunk + 1 ) * ChunkSize, numberOfPixels );
+        for ( SizeValueType p = chunk * ChunkSize; p < last; ++p )
+          {
+          RealType value = buffer[p];
+          if ( NumericTraits<OutputPixelType>::is_integer )
+            {
+            value = std::min( std::max( std::round( value ), lowest ), highest );
+            }
+          outputBuffer[p] = static_cast<OutputPixelType>( value );
+          }
+      },
+    nullptr );
+}
+
+
+//
+// SmoothAxis
+//
+template < class TInputImage, class TOutputImage >
+void
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::SmoothAxis( std::vector<RealType> &buffer,
+                                                                        unsigned int axis,
+                                                                        double sigma,
+                                                                        AlgorithmType algorithm )
+{
+  // the lines interleaved in a block, and the rows before and after
+  // a line for the states of the recursive filter
+  constexpr SizeValueType BlockLines = 16;
+  constexpr SizeValueType Margin = 3;
+
+  const typename OutputImageType::SizeType &size = this->GetOutput()->GetBufferedRegion().GetSize();
+  SizeValueType stride = 1;
+  for ( unsigned int d = 0; d < axis; ++d )
+    {
+    stride *= size[d];
+    }
+  const SizeValueType length = size[axis];
+  const SizeValueType numberOfLines = buffer.size() / length;
+  const SizeValueType numberOfBlocks = ( numberOfLines + BlockLines - 1 ) / BlockLines;
+
+  // the recursive filter: the coefficients of the poles scaled so that
+  // the variance of the kernel is sigma^2, and the matrix of the
+  // states after the end of the line from the deviations of the last
+  // states of the causal pass, for a constant extension
+  RealType iirGain = 0;
+  RealType iirCoefficients[3] = {};
+  RealType iirBoundary[3][3] = {};
+  if ( algorithm == IIR )
+    {
+    const std::complex<double> complexPole( 1.40098, 1.00236 );
+    const double realPole = 1.85132;
+    auto variance = [&]( double q )
+      {
+        const std::complex<double> p = std::pow( complexPole, 1.0 / q );
+        const double r = std::pow( realPole, 1.0 / q );
+        return 2.0 * ( 2.0 * std::real( p / ( ( p - 1.0 ) * ( p - 1.0 ) ) ) + r / ( ( r - 1.0 ) * ( r - 1.0 ) ) );
+      };
+    double lower = 1e-3;
+    double upper = 1e3;
+    for ( unsigned int i = 0; i < 100; ++i )
+      {
+      const double q = std::sqrt( lower * upper );
+      ( variance( q ) < sigma * sigma ? lower : upper ) = q;
+      }
+    const double q = std::sqrt( lower * upper );
+    const std::complex<double> p = 1.0 / std::pow( complexPole, 1.0 / q );
+    const double r = 1.0 / std::pow( realPole, 1.0 / q );
+
+    double a[3];
+    a[0] = 2.0 * std::real( p ) + r;
+    a[1] = -( std::norm( p ) + 2.0 * std::real( p ) * r );
+    a[2] = std::norm( p ) * r;
+    const double gain = 1.0 - a[0] - a[1] - a[2];
+
+    // the responses to each deviation, until they vanish
+    const SizeValueType steps = static_cast<SizeValueType>( std::ceil( 20.0 * sigma ) ) + 64;
+    std::vector<double> causal( steps + 3 );
+    std::vector<double> anticausal( steps + 6 );
+    for ( unsigned int j = 0; j < 3; ++j )
+      {
+      std::fill( causal.begin(), causal.end(), 0.0 );
+      std::fill( anticausal.begin(), anticausal.end(), 0.0 );
+      causal[2 - j] = 1.0;
+      for ( SizeValueType n = 3; n < steps + 3; ++n )
+        {
+        causal[n] = a[0] * causal[n - 1] + a[1] * causal[n - 2] + a[2] * causal[n - 3];
+        }
+      for ( SizeValueType n = steps + 3; n-- > 3; )
+        {
+        anticausal[n] = gain * causal[n] + a[0] * anticausal[n + 1] + a[1] * anticausal[n + 2] + a[2] * anticausal[n + 3];
+        }
+      for ( unsigned int i = 0; i < 3; ++i )
+        {
+        iirBoundary[i][j] = static_cast<RealType>( anticausal[3 + i] );
+        }
+      }
+    iirGain = static_cast<RealType>( gain );
+    for ( unsigned int k = 0; k < 3; ++k )
+      {
+      iirCoefficients[k] = static_cast<RealType>( a[k] );
+      }
+    }
+
+  // the box cascade: the widths of three boxes of variance sigma^2
+  SizeValueType boxWidths[3] = {};
+  if ( algorithm == BoxCascade )
+    {
+    constexpr double Boxes = 3.0;
+    SizeValueType lowerWidth = static_cast<SizeValueType>( std::sqrt( 12.0 * sigma * sigma / Boxes + 1.0 ) );
+    lowerWidth -= ( lowerWidth % 2 == 0 );
+    lowerWidth = std::max<SizeValueType>( lowerWidth, 1 );
+    const double w = static_cast<double>( lowerWidth );
+    const double lowerBoxes = std::round( ( 12.0 * sigma * sigma - Boxes * w * w - 4.0 * Boxes * w - 3.0 * Boxes ) / ( -4.0 * w - 4.0 ) );
+    for ( unsigned int k = 0; k < 3; ++k )
+      {
+      boxWidths[k] = ( k < lowerBoxes ) ? lowerWidth : lowerWidth + 2;
+      }
+    }
+
+  // the Fourier transform: the padding of the tails of the kernel,
+  // and the transform of the Gaussian, normalized for the inverse
+  SizeValueType fftPadding = 0;
+  SizeValueType fftLength = 0;
+  std::vector<double> transfer;
+  if ( algorithm == FFT )
+    {
+    fftPadding = this->GetKernelRadius( axis, sigma );
+    fftLength = GetFFTLength( length + 2 * fftPadding );
+    transfer.resize( fftLength );
+    for ( SizeValueType k = 0; k < fftLength; ++k )
+      {
+      const double frequency = static_cast<double>( std::min( k, fftLength - k ) ) / fftLength;
+      transfer[k] = std::exp( -2.0 * Math::pi * Math::pi * sigma * sigma * frequency * frequency ) / fftLength;
+      }
+    }
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&]( SizeValueType block )
+      {
+        // the rows of the block, with the values of a line in the same
+        // column, and the unused columns are zeros
+        std::vector<RealType> rows( ( length + 2 * Margin ) * BlockLines, RealType() );
+        RealType *x = rows.data() + Margin * BlockLines;
+
+        const SizeValueType firstLine = block * BlockLines;
+        const SizeValueType numberOfColumns = std::min( BlockLines, numberOfLines - firstLine );
+        SizeValueType starts[BlockLines];
+        for ( SizeValueType b = 0; b < numberOfColumns; ++b )
+          {
+          const SizeValueType line = firstLine + b;
+          starts[b] = ( line / stride ) * stride * length + line % stride;
+          }
+
+        for ( SizeValueType i = 0; i < length; ++i )
+          {
+          for ( SizeValueType b = 0; b < numberOfColumns; ++b )
+            {
+            x[i * BlockLines + b] = buffer[starts[b] + i * stride];
+            }
+          }
+
+        if ( algorithm == IIR )
+          {
+          RealType last[BlockLines];
+          std::copy( x + ( length - 1 ) * BlockLines, x + length * BlockLines, last );
+          for ( SizeValueType m = 1; m <= Margin; ++m )
+            {
+            std::copy( x, x + BlockLines, x - m * BlockLines );
+            }
+
+          // the causal pass, from the states of a constant extension
+          for ( SizeValueType i = 0; i < length; ++i )
+            {
+            RealType *row = x + i * BlockLines;
+            for ( SizeValueType b = 0; b < BlockLines; ++b )
+              {
+              row[b] = iirGain * row[b]
+                + iirCoefficients[0] * row[b - BlockLines]
+                + iirCoefficients[1] * row[b - 2 * BlockLines]
+                + iirCoefficients[2] * row[b - 3 * BlockLines];
+              }
+            }
+
+          // the anticausal states after the end of the line
+          RealType *end = x + length * BlockLines;
+          for ( SizeValueType i = 0; i < Margin; ++i )
+            {
+            for ( SizeValueType b = 0; b < BlockLines; ++b )
+              {
+              end[i * BlockLines + b] = last[b]
+                + iirBoundary[i][0] * ( end[b - BlockLines] - last[b] )
+                + iirBoundary[i][1] * ( end[b - 2 * BlockLines] - last[b] )
+                + iirBoundary[i][2] * ( end[b - 3 * BlockLines] - last[b] );
+              }
+            }
+
+          // the anticausal pass
+          for ( SizeValueType i = length; i-- > 0; )
+            {
+            RealType *row = x + i * BlockLines;
+            for ( SizeValueType b = 0; b < BlockLines; ++b )
+              {
+              row[b] = iirGain * row[b]
+                + iirCoefficients[0] * row[b + BlockLines]
+                + iirCoefficients[1] * row[b + 2 * BlockLines]
+                + iirCoefficients[2] * row[b + 3 * BlockLines];
+              }
+            }
+          }
+        else if ( algorithm == BoxCascade )
+          {
+          std::vector<RealType> work( length * BlockLines );
+          RealType *source = x;
+          RealType *destination = work.data();
+          const IndexValueType lastRow = static_cast<IndexValueType>( length ) - 1;
+          auto clampedRow = [&]( IndexValueType i )
+            {
+              return source + std::min( std::max( i, IndexValueType( 0 ) ), lastRow ) * BlockLines;
+            };
+
+          for ( SizeValueType width : boxWidths )
+            {
+            const IndexValueType radius = static_cast<IndexValueType>( width / 2 );
+            const RealType scale = RealType( 1 ) / static_cast<RealType>( width );
+
+            RealType sums[BlockLines] = {};
+            for ( IndexValueType j = -radius; j <= radius; ++j )
+              {
+              const RealType *row = clampedRow( j );
+              for ( SizeValueType b = 0; b < BlockLines; ++b )
+                {
+                sums[b] += row[b];
+                }
+              }
+            for ( IndexValueType i = 0; i <= lastRow; ++i )
+              {
+              const RealType *added = clampedRow( i + radius + 1 );
+              const RealType *removed = clampedRow( i - radius );
+              RealType *row = destination + i * BlockLines;
+              for ( SizeValueType b = 0; b < BlockLines; ++b )
+                {
+                row[b] = sums[b] * scale;
+                sums[b] += added[b] - removed[b];
+                }
+              }
+            std::swap( source, destination );
+            }
+          if ( source != x )
+            {
+            std::copy( source, source + length * BlockLines, x );
+            }
+          }
+        else
+          {
+          // two lines are transformed together, as the real and the
+          // imaginary parts, since the transform of the kernel is real
+          vnl_fft_1d<double> fft( static_cast<int>( fftLength ) );
+          std::vector<std::complex<double>> signal( fftLength );
+          const IndexValueType lastRow = static_cast<IndexValueType>( length ) - 1;
+          for ( SizeValueType b = 0; b < numberOfColumns; b += 2 )
+            {
+            for ( SizeValueType k = 0; k < fftLength; ++k )
+              {
+              const IndexValueType i = std::min( std::max( static_cast<IndexValueType>( k ) - static_cast<IndexValueType>( fftPadding ), IndexValueType( 0 ) ), lastRow );
+              signal[k] = std::complex<double>( x[i * BlockLines + b], x[i * BlockLines + b + 1] );
+              }
+            fft.fwd_transform( signal );
+            for ( SizeValueType k = 0; k < fftLength; ++k )
+              {
+              signal[k] *= transfer[k];
+              }
+            fft.bwd_transform( signal );
+            for ( SizeValueType i = 0; i < length; ++i )
+              {
+              x[i * BlockLines + b] = static_cast<RealType>( signal[i + fftPadding].real() );
+              x[i * BlockLines + b + 1] = static_cast<RealType>( signal[i + fftPadding].imag() );
+              }
+            }
+          }
+
+        for ( SizeValueType i = 0; i < length; ++i )
+          {
+          for ( SizeValueType b = 0; b < numberOfColumns; ++b )
+            {
+            buffer[starts[b] + i * stride] = x[i * BlockLines + b];
+            }
+          }
+      },
+    nullptr );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input && this->GetSelectedAlgorithm() != FIR )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  if ( this->GetSelectedAlgorithm() != FIR )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+FastDiscreteGaussianImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Algorithm: " << m_Algorithm << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkFastDiscreteGaussianImageFilter_hxx
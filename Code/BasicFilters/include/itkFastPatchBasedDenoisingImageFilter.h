@@ -0,0 +1,143 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFastPatchBasedDenoisingImageFilter_h
+#define itkFastPatchBasedDenoisingImageFilter_h
+
+#include "itkPatchBasedDenoisingImageFilter.h"
+
+
+namespace itk {
+
+/** \class FastPatchBasedDenoisingImageFilter
+ * \brief Patch-based denoising with a non-local means of all the
+ * patches of a search window.
+ *
+ * When UseNonLocalMeans is on, each pixel is replaced by the average
+ * of the pixels of a window of SearchRadius around it, weighted by
+ * exp( -d^2 / ( 2 KernelBandwidthSigma^2 ) ) where d^2 is the sum of
+ * the squared differences of their patches of PatchRadius. The
+ * radii are converted to voxels as the PatchRadius of the superclass.
+ *
+ * The patch distances are computed for one offset of the window at a
+ * time, with running sums of the squared differences along each
+ * dimension, at a cost which does not depend on the patch size [1].
+ * The output is split into regions processed independently by the
+ * threads of the multithreader.
+ *
+ * When UseBlockwiseNonLocalMeans is also on, the weights are only
+ * computed at the centers of blocks of PatchRadius, spaced by the
+ * patch radius, and each block is restored as a whole from the
+ * blocks of the window [2]. A pixel is the weighted average of the
+ * restorations of the blocks which contain it.
+ *
+ * The boundary of the image is extended with the zero flux Neumann
+ * condition. The NumberOfIterations and the KernelBandwidthSigma of
+ * the first component are used, while the sampler, the noise model
+ * and the kernel bandwidth estimation are ignored.
+ *
+ * When UseNonLocalMeans is off, the superclass algorithm is used.
+ *
+ * [1] J. Darbon, A. Cunha, T. F. Chan, S. Osher and G. J. Jensen,
+ * "Fast nonlocal filtering applied to electron cryomicroscopy", IEEE
+ * ISBI, 2008.
+ *
+ * [2] P. Coupe, P. Yger, S. Prima, P. Hellier, C. Kervrann and
+ * C. Barillot, "An Optimized Blockwise Nonlocal Means Denoising Filter
+ * for 3-D Magnetic Resonance Images", IEEE Transactions on Medical
+ * Imaging, 27(4): 425-441, 2008.
+ *
+ * \sa PatchBasedDenoisingImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class FastPatchBasedDenoisingImageFilter:
+    public PatchBasedDenoisingImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = FastPatchBasedDenoisingImageFilter;
+  using Superclass = PatchBasedDenoisingImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(FastPatchBasedDenoisingImageFilter, PatchBasedDenoisingImageFilter);
+
+  /** Whether the non-local means are used. Off by default. */
+  itkSetMacro( UseNonLocalMeans, bool );
+  itkGetConstMacro( UseNonLocalMeans, bool );
+  itkBooleanMacro( UseNonLocalMeans );
+
+  /** Whether the non-local means restore blocks. Off by default. */
+  itkSetMacro( UseBlockwiseNonLocalMeans, bool );
+  itkGetConstMacro( UseBlockwiseNonLocalMeans, bool );
+  itkBooleanMacro( UseBlockwiseNonLocalMeans );
+
+  /** The radius of the search window of the non-local means. */
+  itkSetMacro( SearchRadius, unsigned int );
+  itkGetConstMacro( SearchRadius, unsigned int );
+
+protected:
+
+  FastPatchBasedDenoisingImageFilter() = default;
+
+  ~FastPatchBasedDenoisingImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The non-local means are computed by the threads of the
+  // multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the non-local means need all of the input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the non-local means produce all of the output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  FastPatchBasedDenoisingImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_UseNonLocalMeans{false};
+  bool m_UseBlockwiseNonLocalMeans{false};
+  unsigned int m_SearchRadius{5};
+};
+
+
+} // end namespace itk
+
+
+#include "itkFastPatchBasedDenoisingImageFilter.hxx"
+
+#endif // itkFastPatchBasedDenoisingImageFilter_h
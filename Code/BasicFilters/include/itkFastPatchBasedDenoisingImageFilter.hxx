@@ -0,0 +1,346 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFastPatchBasedDenoisingImageFilter_hxx
+#define itkFastPatchBasedDenoisingImageFilter_hxx
+
+#include "itkFastPatchBasedDenoisingImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+FastPatchBasedDenoisingImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  if ( !m_UseNonLocalMeans )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const auto & bandwidth = this->GetKernelBandwidthSigma();
+  const double sigma = ( bandwidth.GetSize() > 0 ) ? bandwidth[0] : 0.0;
+  if ( !( sigma > 0.0 ) )
+    {
+    itkExceptionMacro( << "KernelBandwidthSigma must be positive: " << bandwidth );
+    }
+  const double weightScale = 1.0 / ( 2.0 * sigma * sigma );
+
+  const RegionType bufferedRegion = output->GetBufferedRegion();
+  const typename OutputImageType::SizeType size = bufferedRegion.GetSize();
+
+  // the radii in voxels, as the patch radius of the superclass
+  const typename InputImageType::SpacingType & spacing = input->GetSpacing();
+  const double maxSpacing = *std::max_element( spacing.Begin(), spacing.End() );
+
+  SizeValueType patchRadius[ImageDimension];
+  SizeValueType searchRadius[ImageDimension];
+  SizeValueType blockStep[ImageDimension];
+  // the extent around a region of the squared differences of its patches
+  SizeValueType halo[ImageDimension];
+  // the extent of the padded image
+  SizeValueType margin[ImageDimension];
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const auto scale = static_cast<SizeValueType>( std::ceil( maxSpacing / spacing[d] ) );
+    patchRadius[d] = this->GetPatchRadius() * scale;
+    searchRadius[d] = m_SearchRadius * scale;
+    blockStep[d] = std::max<SizeValueType>( patchRadius[d], 1 );
+    halo[d] = ( m_UseBlockwiseNonLocalMeans ? 2 : 1 ) * patchRadius[d];
+    margin[d] = halo[d] + searchRadius[d];
+    }
+
+  // a copy of the image with a boundary of the margin, so that the
+  // patches of the search window are accessed without bound checks
+  SizeValueType paddedSize[ImageDimension];
+  OffsetValueType outputStride[ImageDimension];
+  OffsetValueType paddedStride[ImageDimension + 1];
+  outputStride[0] = 1;
+  paddedStride[0] = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    paddedSize[d] = size[d] + 2 * margin[d];
+    paddedStride[d + 1] = paddedStride[d] * static_cast<OffsetValueType>( paddedSize[d] );
+    if ( d + 1 < ImageDimension )
+      {
+      outputStride[d + 1] = outputStride[d] * static_cast<OffsetValueType>( size[d] );
+      }
+    }
+  std::vector<float> padded( paddedStride[ImageDimension] );
+
+  // the offsets of the search window in the padded image
+  std::vector<OffsetValueType> windowOffsets( 1, 0 );
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    std::vector<OffsetValueType> extended;
+    for ( OffsetValueType offset : windowOffsets )
+      {
+      for ( OffsetValueType i = -static_cast<OffsetValueType>( searchRadius[d] ); i <= static_cast<OffsetValueType>( searchRadius[d] ); ++i )
+        {
+        extended.push_back( offset + i * paddedStride[d] );
+        }
+      }
+    windowOffsets.swap( extended );
+    }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // copy the image into the padded image, with the zero flux Neumann
+  // boundary condition
+  auto pad = [&]( const auto *image )
+    {
+      const SizeValueType sliceSize = paddedStride[ImageDimension - 1];
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        paddedSize[ImageDimension - 1],
+        [&]( SizeValueType slice )
+          {
+            SizeValueType index[ImageDimension] = {};
+            index[ImageDimension - 1] = slice;
+            for ( SizeValueType p = slice * sliceSize; p < ( slice + 1 ) * sliceSize; ++p )
+              {
+              OffsetValueType offset = 0;
+              for ( unsigned int d = 0; d < ImageDimension; ++d )
+                {
+                const OffsetValueType i = static_cast<OffsetValueType>( index[d] ) - static_cast<OffsetValueType>( margin[d] );
+                offset += std::min( std::max<OffsetValueType>( i, 0 ), static_cast<OffsetValueType>( size[d] ) - 1 ) * outputStride[d];
+                }
+              padded[p] = static_cast<float>( image[offset] );
+              for ( unsigned int d = 0; d + 1 < ImageDimension && ++index[d] == paddedSize[d]; ++d )
+                {
+                index[d] = 0;
+                }
+              }
+          },
+        nullptr );
+    };
+
+  const unsigned int numberOfIterations = std::max( this->GetNumberOfIterations(), 1u );
+  for ( unsigned int iteration = 0; iteration < numberOfIterations; ++iteration )
+    {
+    if ( iteration == 0 )
+      {
+      pad( input->GetBufferPointer() );
+      }
+    else
+      {
+      pad( output->GetBufferPointer() );
+      }
+
+    this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+      bufferedRegion,
+      [&]( const RegionType &region )
+        {
+          // the pixels of the region extended by the halo
+          SizeValueType localSize[ImageDimension];
+          SizeValueType localStride[ImageDimension + 1];
+          localStride[0] = 1;
+          OffsetValueType first = 0;
+          for ( unsigned int d = 0; d < ImageDimension; ++d )
+            {
+            localSize[d] = region.GetSize( d ) + 2 * halo[d];
+            localStride[d + 1] = localStride[d] * localSize[d];
+            first += ( region.GetIndex( d ) - bufferedRegion.GetIndex( d ) + static_cast<OffsetValueType>( margin[d] - halo[d] ) ) * paddedStride[d];
+            }
+          const SizeValueType numberOfLocalPixels = localStride[ImageDimension];
+
+          std::vector<OffsetValueType> paddedOffsets( numberOfLocalPixels );
+          std::vector<SizeValueType> regionPixels;
+          std::vector<OffsetValueType> outputOffsets;
+          std::vector<SizeValueType> blockCenters;
+          SizeValueType index[ImageDimension] = {};
+          for ( SizeValueType k = 0; k < numberOfLocalPixels; ++k )
+            {
+            OffsetValueType paddedOffset = first;
+            OffsetValueType outputOffset = 0;
+            bool inRegion = true;
+            bool isCenter = m_UseBlockwiseNonLocalMeans;
+            for ( unsigned int d = 0; d < ImageDimension; ++d )
+              {
+              paddedOffset += static_cast<OffsetValueType>( index[d] ) * paddedStride[d];
+              const OffsetValueType i = region.GetIndex( d ) - bufferedRegion.GetIndex( d ) + static_cast<OffsetValueType>( index[d] ) - static_cast<OffsetValueType>( halo[d] );
+              outputOffset += i * outputStride[d];
+              inRegion = inRegion && index[d] >= halo[d] && index[d] < halo[d] + region.GetSize( d );
+              // the centers of the blocks which contain a pixel of the region
+              isCenter = isCenter && i >= 0 && i < static_cast<OffsetValueType>( size[d] ) && i % static_cast<OffsetValueType>( blockStep[d] ) == 0 &&
+                index[d] + patchRadius[d] >= halo[d] && index[d] < halo[d] + region.GetSize( d ) + patchRadius[d];
+              }
+            paddedOffsets[k] = paddedOffset;
+            if ( inRegion )
+              {
+              regionPixels.push_back( k );
+              outputOffsets.push_back( outputOffset );
+              }
+            if ( isCenter )
+              {
+              blockCenters.push_back( k );
+              }
+            for ( unsigned int d = 0; d < ImageDimension && ++index[d] == localSize[d]; ++d )
+              {
+              index[d] = 0;
+              }
+            }
+
+          // the sums along each dimension of a window of the patch radius,
+          // which are valid where the window is inside the extended region
+          std::vector<double> line( *std::max_element( localSize, localSize + ImageDimension ) );
+          auto boxSum = [&]( std::vector<double> &values )
+            {
+              for ( unsigned int d = 0; d < ImageDimension; ++d )
+                {
+                const SizeValueType radius = patchRadius[d];
+                const SizeValueType length = localSize[d];
+                if ( radius == 0 )
+                  {
+                  continue;
+                  }
+                for ( SizeValueType l = 0; l < numberOfLocalPixels / length; ++l )
+                  {
+                  const SizeValueType base = l % localStride[d] + ( l / localStride[d] ) * localStride[d + 1];
+                  for ( SizeValueType i = 0; i < length; ++i )
+                    {
+                    line[i] = values[base + i * localStride[d]];
+                    }
+                  double sum = std::accumulate( line.begin(), line.begin() + 2 * radius + 1, 0.0 );
+                  values[base + radius * localStride[d]] = sum;
+                  for ( SizeValueType i = radius + 1; i + radius < length; ++i )
+                    {
+                    sum += line[i + radius] - line[i - radius - 1];
+                    values[base + i * localStride[d]] = sum;
+                    }
+                  }
+                }
+            };
+
+          std::vector<double> distances( numberOfLocalPixels );
+          std::vector<double> weights( m_UseBlockwiseNonLocalMeans ? numberOfLocalPixels : 0 );
+          std::vector<double> sums( regionPixels.size(), 0.0 );
+          std::vector<double> weightSums( regionPixels.size(), 0.0 );
+
+          for ( const OffsetValueType windowOffset : windowOffsets )
+            {
+            for ( SizeValueType k = 0; k < numberOfLocalPixels; ++k )
+              {
+              const double difference = padded[paddedOffsets[k]] - padded[paddedOffsets[k] + windowOffset];
+              distances[k] = difference * difference;
+              }
+            boxSum( distances );
+
+            if ( !m_UseBlockwiseNonLocalMeans )
+              {
+              for ( SizeValueType i = 0; i < regionPixels.size(); ++i )
+                {
+                const SizeValueType k = regionPixels[i];
+                const double weight = std::exp( -distances[k] * weightScale );
+                sums[i] += weight * padded[paddedOffsets[k] + windowOffset];
+                weightSums[i] += weight;
+                }
+              continue;
+              }
+
+            // the weights of the blocks, summed over the blocks which
+            // contain each pixel
+            std::fill( weights.begin(), weights.end(), 0.0 );
+            for ( const SizeValueType k : blockCenters )
+              {
+              weights[k] = std::exp( -distances[k] * weightScale );
+              }
+            boxSum( weights );
+            for ( SizeValueType i = 0; i < regionPixels.size(); ++i )
+              {
+              const SizeValueType k = regionPixels[i];
+              sums[i] += weights[k] * padded[paddedOffsets[k] + windowOffset];
+              weightSums[i] += weights[k];
+              }
+            }
+
+          OutputPixelType *outputBuffer = output->GetBufferPointer();
+          for ( SizeValueType i = 0; i < regionPixels.size(); ++i )
+            {
+            // the averages of integers are rounded
+            const double value = sums[i] / weightSums[i];
+            outputBuffer[outputOffsets[i]] = static_cast<OutputPixelType>( NumericTraits<OutputPixelType>::is_integer ? std::round( value ) : value );
+            }
+        },
+      this );
+    }
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FastPatchBasedDenoisingImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input && m_UseNonLocalMeans )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FastPatchBasedDenoisingImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  if ( m_UseNonLocalMeans )
+    {
+    data->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+FastPatchBasedDenoisingImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseNonLocalMeans: " << m_UseNonLocalMeans << std::endl;
+  os << indent << "UseBlockwiseNonLocalMeans: " << m_UseBlockwiseNonLocalMeans << std::endl;
+  os << indent << "SearchRadius: " << m_SearchRadius << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkFastPatchBasedDenoisingImageFilter_hxx
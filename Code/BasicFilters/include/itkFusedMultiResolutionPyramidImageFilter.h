@@ -0,0 +1,151 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFusedMultiResolutionPyramidImageFilter_h
+#define itkFusedMultiResolutionPyramidImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class FusedMultiResolutionPyramidImageFilter
+ * \brief Compute the smoothed and shrunk levels of an image pyramid in
+ * a single pass over the input.
+ *
+ * Each level is an output of the filter, shrunk by its factor of
+ * ShrinkFactorsPerLevel along all the dimensions and smoothed by the
+ * Gaussian of its sigma of SmoothingSigmasPerLevel, in physical units
+ * when SmoothingSigmasAreSpecifiedInPhysicalUnits is on, the default,
+ * and in pixels otherwise.
+ *
+ * The smoothing is separable and is only evaluated at the shrunk
+ * pixels, so no smoothed image of the size of the input is
+ * computed. The rows of the input are read once, and smoothed and
+ * shrunk along the first dimension for all the levels together; the
+ * other dimensions are then smoothed and shrunk for each level in the
+ * smaller buffers.
+ *
+ * The pixels of a level are centered on the bins of factor pixels of
+ * the input, with the size and the geometry of the
+ * BinShrinkImageFilter. A dimension smaller than the factor is shrunk
+ * to one pixel. The Gaussian kernel is sampled at the input pixels
+ * about the center of the bin up to 4 sigmas, and normalized, with a
+ * zero flux Neumann boundary condition. A sigma of 0 averages the
+ * pixels of the bin, as the BinShrinkImageFilter.
+ *
+ * The whole input is requested.
+ *
+ * \sa BinShrinkImageFilter
+ * \sa MultiResolutionPyramidImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class FusedMultiResolutionPyramidImageFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = FusedMultiResolutionPyramidImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(FusedMultiResolutionPyramidImageFilter, ImageToImageFilter);
+
+  /** Set/Get the shrink factor of each level, which sets the number
+   * of outputs. */
+  void SetShrinkFactorsPerLevel( const std::vector< unsigned int > &shrinkFactors );
+  const std::vector< unsigned int > & GetShrinkFactorsPerLevel() const { return m_ShrinkFactorsPerLevel; }
+
+  /** Set/Get the smoothing sigma of each level. */
+  void SetSmoothingSigmasPerLevel( const std::vector< double > &smoothingSigmas );
+  const std::vector< double > & GetSmoothingSigmasPerLevel() const { return m_SmoothingSigmasPerLevel; }
+
+  itkSetMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits, bool);
+  itkGetConstMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits, bool);
+  itkBooleanMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits);
+
+  /** The number of levels of the pyramid. */
+  unsigned int GetNumberOfLevels() const { return static_cast< unsigned int >( m_ShrinkFactorsPerLevel.size() ); }
+
+  /** The level of the pyramid. */
+  OutputImageType * GetLevelOutput( unsigned int level ) { return this->GetOutput( level ); }
+
+protected:
+
+  FusedMultiResolutionPyramidImageFilter();
+
+  ~FusedMultiResolutionPyramidImageFilter() override = default;
+
+  void VerifyPreconditions() ITKv5_CONST override;
+
+  void GenerateOutputInformation() override;
+
+  void GenerateInputRequestedRegion() override;
+
+  void GenerateOutputRequestedRegion( DataObject *output ) override;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  FusedMultiResolutionPyramidImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  using RealType = OutputPixelType;
+
+  // the sampled kernel of a level along a dimension: the output
+  // pixel i is the sum of weights[j] times the input pixel
+  // i * factor + first + j
+  struct KernelType
+  {
+    SizeValueType factor{ 1 };
+    SizeValueType size{ 1 };
+    IndexValueType first{ 0 };
+    std::vector< RealType > weights;
+  };
+
+  KernelType ComputeKernel( unsigned int level, unsigned int dimension ) const;
+
+  std::vector< unsigned int > m_ShrinkFactorsPerLevel;
+  std::vector< double > m_SmoothingSigmasPerLevel;
+  bool m_SmoothingSigmasAreSpecifiedInPhysicalUnits{true};
+};
+
+
+} // end namespace itk
+
+
+#include "itkFusedMultiResolutionPyramidImageFilter.hxx"
+
+#endif // itkFusedMultiResolutionPyramidImageFilter_h
@@ -0,0 +1,405 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFusedMultiResolutionPyramidImageFilter_hxx
+#define itkFusedMultiResolutionPyramidImageFilter_hxx
+
+#include "itkFusedMultiResolutionPyramidImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace itk {
+
+template < class TInputImage, class TOutputImage >
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::FusedMultiResolutionPyramidImageFilter()
+  : m_ShrinkFactorsPerLevel( 1, 1u ),
+    m_SmoothingSigmasPerLevel( 1, 0.0 )
+{
+}
+
+
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::SetShrinkFactorsPerLevel( const std::vector< unsigned int > &shrinkFactors )
+{
+  if ( shrinkFactors == m_ShrinkFactorsPerLevel )
+    {
+    return;
+    }
+  m_ShrinkFactorsPerLevel = shrinkFactors;
+
+  // an output for each level
+  const DataObjectPointerArraySizeType numberOfLevels = std::max< DataObjectPointerArraySizeType >( shrinkFactors.size(), 1 );
+  this->SetNumberOfRequiredOutputs( numberOfLevels );
+  for ( DataObjectPointerArraySizeType i = this->GetNumberOfIndexedOutputs(); i < numberOfLevels; ++i )
+    {
+    this->SetNthOutput( i, this->MakeOutput( i ) );
+    }
+  while ( this->GetNumberOfIndexedOutputs() > numberOfLevels )
+    {
+    this->RemoveOutput( this->GetNumberOfIndexedOutputs() - 1 );
+    }
+  this->Modified();
+}
+
+
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::SetSmoothingSigmasPerLevel( const std::vector< double > &smoothingSigmas )
+{
+  if ( smoothingSigmas != m_SmoothingSigmasPerLevel )
+    {
+    m_SmoothingSigmasPerLevel = smoothingSigmas;
+    this->Modified();
+    }
+}
+
+
+//
+// VerifyPreconditions
+//
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::VerifyPreconditions() ITKv5_CONST
+{
+  Superclass::VerifyPreconditions();
+
+  if ( m_ShrinkFactorsPerLevel.empty() )
+    {
+    itkExceptionMacro( "The ShrinkFactorsPerLevel are empty!" );
+    }
+  if ( m_ShrinkFactorsPerLevel.size() != m_SmoothingSigmasPerLevel.size() )
+    {
+    itkExceptionMacro( "The " << m_ShrinkFactorsPerLevel.size() << " ShrinkFactorsPerLevel do not match the "
+                       << m_SmoothingSigmasPerLevel.size() << " SmoothingSigmasPerLevel!" );
+    }
+  for ( unsigned int level = 0; level < m_ShrinkFactorsPerLevel.size(); ++level )
+    {
+    if ( m_ShrinkFactorsPerLevel[level] == 0 )
+      {
+      itkExceptionMacro( "The shrink factor of the level " << level << " is 0!" );
+      }
+    if ( !( m_SmoothingSigmasPerLevel[level] >= 0.0 ) )
+      {
+      itkExceptionMacro( "The smoothing sigma of the level " << level << " is negative!" );
+      }
+    }
+}
+
+
+//
+// ComputeKernel
+//
+template < class TInputImage, class TOutputImage >
+typename FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::KernelType
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::ComputeKernel( unsigned int level, unsigned int dimension ) const
+{
+  const InputImageType *input = this->GetInput();
+  const SizeValueType inputSize = input->GetLargestPossibleRegion().GetSize( dimension );
+
+  KernelType kernel;
+  kernel.factor = std::max< SizeValueType >( std::min< SizeValueType >( m_ShrinkFactorsPerLevel[level], inputSize ), 1 );
+  kernel.size = std::max< SizeValueType >( inputSize / kernel.factor, 1 );
+
+  double sigma = m_SmoothingSigmasPerLevel[level];
+  if ( m_SmoothingSigmasAreSpecifiedInPhysicalUnits )
+    {
+    sigma /= input->GetSpacing()[dimension];
+    }
+
+  // the center of the bin of the output pixel
+  const double center = 0.5 * static_cast< double >( kernel.factor - 1 );
+
+  if ( sigma <= 0.0 )
+    {
+    kernel.first = 0;
+    kernel.weights.assign( kernel.factor, static_cast< RealType >( 1.0 / kernel.factor ) );
+    return kernel;
+    }
+
+  const IndexValueType first = std::min( static_cast< IndexValueType >( std::ceil( center - 4.0 * sigma ) ),
+                                         static_cast< IndexValueType >( std::floor( center ) ) );
+  const IndexValueType last = std::max( static_cast< IndexValueType >( std::floor( center + 4.0 * sigma ) ),
+                                        static_cast< IndexValueType >( std::ceil( center ) ) );
+  std::vector< double > weights;
+  double sum = 0.0;
+  for ( IndexValueType j = first; j <= last; ++j )
+    {
+    const double x = static_cast< double >( j ) - center;
+    weights.push_back( std::exp( -x * x / ( 2.0 * sigma * sigma ) ) );
+    sum += weights.back();
+    }
+
+  kernel.first = first;
+  for ( const double w : weights )
+    {
+    kernel.weights.push_back( static_cast< RealType >( w / sum ) );
+    }
+  return kernel;
+}
+
+
+//
+// GenerateOutputInformation
+//
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::GenerateOutputInformation()
+{
+  const InputImageType *input = this->GetInput();
+  const typename InputImageType::RegionType &inputRegion = input->GetLargestPossibleRegion();
+
+  for ( unsigned int level = 0; level < this->GetNumberOfLevels(); ++level )
+    {
+    OutputImageType *output = this->GetOutput( level );
+
+    typename OutputImageType::SizeType size;
+    typename OutputImageType::SpacingType spacing;
+    ContinuousIndex< double, ImageDimension > center;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      const KernelType kernel = this->ComputeKernel( level, d );
+      size[d] = kernel.size;
+      spacing[d] = input->GetSpacing()[d] * kernel.factor;
+      center[d] = inputRegion.GetIndex( d ) + 0.5 * static_cast< double >( kernel.factor - 1 );
+      }
+
+    typename OutputImageType::PointType origin;
+    input->TransformContinuousIndexToPhysicalPoint( center, origin );
+
+    output->SetLargestPossibleRegion( typename OutputImageType::RegionType( size ) );
+    output->SetSpacing( spacing );
+    output->SetOrigin( origin );
+    output->SetDirection( input->GetDirection() );
+    output->SetNumberOfComponentsPerPixel( 1 );
+    }
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  if ( auto *input = const_cast< InputImageType * >( this->GetInput() ) )
+    {
+    input->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+
+//
+// GenerateOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::GenerateOutputRequestedRegion( DataObject * )
+{
+  // the levels have different sizes, and are computed whole
+  for ( unsigned int level = 0; level < this->GetNumberOfLevels(); ++level )
+    {
+    this->GetOutput( level )->SetRequestedRegionToLargestPossibleRegion();
+    }
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  const unsigned int numberOfLevels = this->GetNumberOfLevels();
+
+  this->AllocateOutputs();
+
+  std::vector< std::vector< KernelType > > kernels( numberOfLevels );
+  for ( unsigned int level = 0; level < numberOfLevels; ++level )
+    {
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      kernels[level].push_back( this->ComputeKernel( level, d ) );
+      }
+    }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // split the items between the work units
+  auto parallelize = [this]( SizeValueType numberOfItems, const auto &function )
+    {
+      const SizeValueType numberOfChunks = std::max< SizeValueType >(
+        std::min< SizeValueType >( numberOfItems, this->GetMultiThreader()->GetNumberOfWorkUnits() ), 1 );
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        numberOfChunks,
+        [&]( SizeValueType chunk )
+          {
+            for ( SizeValueType item = chunk * numberOfItems / numberOfChunks; item < ( chunk + 1 ) * numberOfItems / numberOfChunks; ++item )
+              {
+              function( item );
+              }
+          },
+        nullptr );
+    };
+
+  auto clamp = []( IndexValueType index, SizeValueType size )
+    {
+      return static_cast< SizeValueType >( std::min( std::max< IndexValueType >( index, 0 ),
+                                                     static_cast< IndexValueType >( size ) - 1 ) );
+    };
+
+  // the rows of the input are read once, and smoothed and shrunk
+  // along the first dimension for all the levels
+  const typename InputImageType::SizeType inputSize = input->GetBufferedRegion().GetSize();
+  const SizeValueType rowLength = inputSize[0];
+  const SizeValueType numberOfRows = input->GetBufferedRegion().GetNumberOfPixels() / rowLength;
+  const InputPixelType *inputBuffer = input->GetBufferPointer();
+
+  std::vector< std::vector< RealType > > buffers( numberOfLevels );
+  std::vector< RealType * > rowOutputs( numberOfLevels );
+  for ( unsigned int level = 0; level < numberOfLevels; ++level )
+    {
+    if ( ImageDimension == 1 )
+      {
+      rowOutputs[level] = this->GetOutput( level )->GetBufferPointer();
+      }
+    else
+      {
+      buffers[level].resize( kernels[level][0].size * numberOfRows );
+      rowOutputs[level] = buffers[level].data();
+      }
+    }
+
+  parallelize( numberOfRows,
+               [&]( SizeValueType row )
+                 {
+                   const InputPixelType *in = inputBuffer + row * rowLength;
+                   for ( unsigned int level = 0; level < numberOfLevels; ++level )
+                     {
+                     const KernelType &kernel = kernels[level][0];
+                     RealType *out = rowOutputs[level] + row * kernel.size;
+                     for ( SizeValueType i = 0; i < kernel.size; ++i )
+                       {
+                       const IndexValueType start = static_cast< IndexValueType >( i * kernel.factor ) + kernel.first;
+                       RealType value = 0;
+                       for ( SizeValueType j = 0; j < kernel.weights.size(); ++j )
+                         {
+                         value += kernel.weights[j] * static_cast< RealType >( in[clamp( start + static_cast< IndexValueType >( j ), rowLength )] );
+                         }
+                       out[i] = value;
+                       }
+                     }
+                 } );
+
+  // the other dimensions are smoothed and shrunk by rows of the
+  // buffer of each level
+  for ( unsigned int level = 0; level < numberOfLevels; ++level )
+    {
+    typename InputImageType::SizeType size = inputSize;
+    size[0] = kernels[level][0].size;
+
+    std::vector< RealType > source;
+    source.swap( buffers[level] );
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      const KernelType &kernel = kernels[level][d];
+
+      SizeValueType inner = 1;
+      SizeValueType outer = 1;
+      for ( unsigned int k = 0; k < ImageDimension; ++k )
+        {
+        if ( k < d )
+          {
+          inner *= size[k];
+          }
+        else if ( k > d )
+          {
+          outer *= size[k];
+          }
+        }
+      const SizeValueType length = size[d];
+
+      std::vector< RealType > destination;
+      RealType *out = this->GetOutput( level )->GetBufferPointer();
+      if ( d + 1 < ImageDimension )
+        {
+        destination.resize( outer * kernel.size * inner );
+        out = destination.data();
+        }
+      const RealType *in = source.data();
+
+      parallelize( outer * kernel.size,
+                   [&]( SizeValueType item )
+                     {
+                       const SizeValueType o = item / kernel.size;
+                       const SizeValueType i = item % kernel.size;
+                       RealType *outRow = out + item * inner;
+                       std::fill( outRow, outRow + inner, RealType( 0 ) );
+                       const IndexValueType start = static_cast< IndexValueType >( i * kernel.factor ) + kernel.first;
+                       for ( SizeValueType j = 0; j < kernel.weights.size(); ++j )
+                         {
+                         const RealType weight = kernel.weights[j];
+                         const RealType *inRow = in + ( o * length + clamp( start + static_cast< IndexValueType >( j ), length ) ) * inner;
+                         for ( SizeValueType x = 0; x < inner; ++x )
+                           {
+                           outRow[x] += weight * inRow[x];
+                           }
+                         }
+                     } );
+
+      size[d] = kernel.size;
+      source.swap( destination );
+      }
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+FusedMultiResolutionPyramidImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "ShrinkFactorsPerLevel:";
+  for ( const unsigned int factor : m_ShrinkFactorsPerLevel )
+    {
+    os << " " << factor;
+    }
+  os << std::endl;
+  os << indent << "SmoothingSigmasPerLevel:";
+  for ( const double sigma : m_SmoothingSigmasPerLevel )
+    {
+    os << " " << sigma;
+    }
+  os << std::endl;
+  os << indent << "SmoothingSigmasAreSpecifiedInPhysicalUnits: " << m_SmoothingSigmasAreSpecifiedInPhysicalUnits << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkFusedMultiResolutionPyramidImageFilter_hxx
@@ -0,0 +1,180 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFusedStatisticsImageFilter_h
+#define itkFusedStatisticsImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkHistogram.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class FusedStatisticsImageFilter
+ * \brief Compute the statistics, the histogram and the quantiles of
+ * an image in a single pass.
+ *
+ * The minimum, maximum, mean, variance, sigma and sum of the pixels,
+ * their histogram and approximate quantiles are computed together by
+ * the threads of the filter, so the image is read only once instead of
+ * once by each of StatisticsImageFilter, MinimumMaximumImageFilter and
+ * the histogram based threshold filters.
+ *
+ * When a MaskImage is set, only the pixels whose mask is not 0 are
+ * included.
+ *
+ * With AutoMinimumMaximum, the default, the histogram spans the
+ * minimum and the maximum of the pixels. Each thread then bins its
+ * pixels into a histogram whose range grows when needed, and these are
+ * merged into NumberOfHistogramBins times HistogramOversampling bins
+ * between the minimum and the maximum, so the histogram and the
+ * quantiles are approximate. Otherwise the histogram spans
+ * HistogramMinimum to HistogramMaximum, and the pixels outside are not
+ * binned. Non finite pixels are never binned.
+ *
+ * The quantiles of the Quantiles probabilities are interpolated in the
+ * oversampled histogram.
+ *
+ * The input is passed through to the output without a copy.
+ */
+template < class TInputImage, class TMaskImage = Image< unsigned char, TInputImage::ImageDimension > >
+class FusedStatisticsImageFilter:
+    public ImageToImageFilter< TInputImage, TInputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = FusedStatisticsImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TInputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using MaskImageType = TMaskImage;
+  using PixelType = typename TInputImage::PixelType;
+  using RegionType = typename TInputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  using HistogramType = Statistics::Histogram< double >;
+  using HistogramPointer = typename HistogramType::Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(FusedStatisticsImageFilter, ImageToImageFilter);
+
+  /** Set/Get the optional mask image. */
+  itkSetInputMacro(MaskImage, MaskImageType);
+  itkGetInputMacro(MaskImage, MaskImageType);
+
+  /** Set/Get the number of bins of the histogram, 256 by default. */
+  itkSetClampMacro( NumberOfHistogramBins, unsigned int, 1, NumericTraits<unsigned int>::max() );
+  itkGetConstMacro( NumberOfHistogramBins, unsigned int );
+
+  /** Set/Get the number of bins used per histogram bin when the
+   * histogram range is computed from the pixels, 16 by default. */
+  itkSetClampMacro( HistogramOversampling, unsigned int, 1, 1024 );
+  itkGetConstMacro( HistogramOversampling, unsigned int );
+
+  /** Set/Get whether the histogram spans the minimum and the maximum
+   * of the pixels, or HistogramMinimum to HistogramMaximum. */
+  itkSetMacro( AutoMinimumMaximum, bool );
+  itkGetConstMacro( AutoMinimumMaximum, bool );
+  itkBooleanMacro( AutoMinimumMaximum );
+
+  itkSetMacro( HistogramMinimum, double );
+  itkGetConstMacro( HistogramMinimum, double );
+  itkSetMacro( HistogramMaximum, double );
+  itkGetConstMacro( HistogramMaximum, double );
+
+  /** Set/Get the probabilities, between 0 and 1, of the quantiles to
+   * compute. */
+  void SetQuantiles( const std::vector<double> &quantiles );
+  const std::vector<double> &GetQuantiles() const
+  { return m_Quantiles; }
+
+  /** The results of the last update. */
+  itkGetConstMacro( Minimum, double );
+  itkGetConstMacro( Maximum, double );
+  itkGetConstMacro( Mean, double );
+  itkGetConstMacro( Variance, double );
+  itkGetConstMacro( Sigma, double );
+  itkGetConstMacro( Sum, double );
+  itkGetConstMacro( Count, SizeValueType );
+
+  /** The histogram of NumberOfHistogramBins bins. */
+  const HistogramType *GetHistogram() const
+  { return m_Histogram.GetPointer(); }
+
+  /** The values of the Quantiles, NaN when no pixel was binned. */
+  const std::vector<double> &GetQuantileValues() const
+  { return m_QuantileValues; }
+
+protected:
+
+  FusedStatisticsImageFilter();
+
+  ~FusedStatisticsImageFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // The input is passed through to the output, and the statistics are
+  // computed by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its input
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  // The statistics of a region of the input
+  class Accumulator;
+
+  FusedStatisticsImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  unsigned int        m_NumberOfHistogramBins;
+  unsigned int        m_HistogramOversampling;
+  bool                m_AutoMinimumMaximum;
+  double              m_HistogramMinimum;
+  double              m_HistogramMaximum;
+  std::vector<double> m_Quantiles;
+
+  double              m_Minimum;
+  double              m_Maximum;
+  double              m_Mean;
+  double              m_Variance;
+  double              m_Sigma;
+  double              m_Sum;
+  SizeValueType       m_Count;
+  HistogramPointer    m_Histogram;
+  std::vector<double> m_QuantileValues;
+};
+
+
+} // end namespace itk
+
+
+#include "itkFusedStatisticsImageFilter.hxx"
+
+#endif // itkFusedStatisticsImageFilter_h
@@ -0,0 +1,450 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkFusedStatisticsImageFilter_hxx
+#define itkFusedStatisticsImageFilter_hxx
+
+#include "itkFusedStatisticsImageFilter.h"
+
+#include "itkCompensatedSummation.h"
+#include "itkImageScanlineConstIterator.h"
+#include "sitkInstructionSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace itk {
+
+//
+// Accumulator
+//
+// The statistics of the pixels of a region, and their histogram. When
+// the range of the histogram is not fixed, it starts at the first
+// binned value, and its bin width is doubled, merging pairs of bins,
+// when a value is outside, so the pixels are binned in a single pass.
+//
+template < class TInputImage, class TMaskImage >
+class FusedStatisticsImageFilter< TInputImage, TMaskImage >::Accumulator
+{
+public:
+  Accumulator( unsigned int numberOfBins, bool fixedRange, double lower, double upper )
+    : m_Count( 0 ),
+      m_Minimum( std::numeric_limits<double>::infinity() ),
+      m_Maximum( -std::numeric_limits<double>::infinity() ),
+      m_Binned( 0 ),
+      m_BinnedMinimum( std::numeric_limits<double>::infinity() ),
+      m_BinnedMaximum( -std::numeric_limits<double>::infinity() ),
+      m_Bins( numberOfBins, 0 ),
+      m_FixedRange( fixedRange ),
+      m_Lower( lower ),
+      m_Upper( upper ),
+      m_Width( 0.0 ),
+      m_InverseWidth( 0.0 )
+    {
+      if ( m_FixedRange )
+        {
+        this->SetWidth( ( upper - lower ) / numberOfBins );
+        }
+    }
+
+  void Add( double value )
+    {
+      ++m_Count;
+      m_Sum += value;
+      m_SumOfSquares += value * value;
+      m_Minimum = std::min( m_Minimum, value );
+      m_Maximum = std::max( m_Maximum, value );
+
+      if ( !std::isfinite( value ) || ( m_FixedRange && ( value < m_Lower || value > m_Upper ) ) )
+        {
+        return;
+        }
+      ++m_Binned;
+      m_BinnedMinimum = std::min( m_BinnedMinimum, value );
+      m_BinnedMaximum = std::max( m_BinnedMaximum, value );
+
+      if ( !m_FixedRange )
+        {
+        if ( m_Binned == 1 )
+          {
+          m_Lower = value;
+          ++m_Bins[0];
+          return;
+          }
+        if ( m_Width == 0.0 )
+          {
+          if ( value == m_Lower )
+            {
+            ++m_Bins[0];
+            return;
+            }
+          // the range of the first two distinct values
+          const double previous = m_Lower;
+          const SizeValueType count = m_Bins[0];
+          m_Bins[0] = 0;
+          m_Lower = std::min( previous, value );
+          this->SetWidth( std::max( ( std::max( previous, value ) - m_Lower ) / ( m_Bins.size() - 1 ),
+                                    std::numeric_limits<double>::denorm_min() ) );
+          m_Bins[this->GetBin( previous )] += count;
+          }
+        while ( value < m_Lower )
+          {
+          this->GrowDown();
+          }
+        while ( value >= m_Lower + m_Bins.size() * m_Width )
+          {
+          this->GrowUp();
+          }
+        }
+      ++m_Bins[this->GetBin( value )];
+    }
+
+  void MergeStatistics( const Accumulator &other )
+    {
+      m_Count += other.m_Count;
+      m_Sum += other.m_Sum;
+      m_SumOfSquares += other.m_SumOfSquares;
+      m_Minimum = std::min( m_Minimum, other.m_Minimum );
+      m_Maximum = std::max( m_Maximum, other.m_Maximum );
+      m_Binned += other.m_Binned;
+      m_BinnedMinimum = std::min( m_BinnedMinimum, other.m_BinnedMinimum );
+      m_BinnedMaximum = std::max( m_BinnedMaximum, other.m_BinnedMaximum );
+    }
+
+  // Add the bins to the histogram of the bins from lower, of width.
+  // With a range which is not fixed, each bin is added to the bin of
+  // its center.
+  void AddBinsTo( std::vector<SizeValueType> &bins, double lower, double width ) const
+    {
+      const SizeValueType numberOfBins = bins.size();
+      for ( SizeValueType i = 0; i < m_Bins.size(); ++i )
+        {
+        if ( m_Bins[i] == 0 )
+          {
+          continue;
+          }
+        if ( m_FixedRange )
+          {
+          bins[i] += m_Bins[i];
+          continue;
+          }
+        const double center = std::min( std::max( m_Lower + ( i + 0.5 ) * m_Width, m_BinnedMinimum ), m_BinnedMaximum );
+        const double x = ( width > 0.0 ) ? ( center - lower ) / width : 0.0;
+        const SizeValueType bin = ( x < numberOfBins ) ? static_cast<SizeValueType>( std::max( x, 0.0 ) ) : numberOfBins - 1;
+        bins[bin] += m_Bins[i];
+        }
+    }
+
+  SizeValueType                 m_Count;
+  CompensatedSummation<double>  m_Sum;
+  CompensatedSummation<double>  m_SumOfSquares;
+  double                        m_Minimum;
+  double                        m_Maximum;
+  SizeValueType                 m_Binned;
+  double                        m_BinnedMinimum;
+  double                        m_BinnedMaximum;
+
+private:
+  void SetWidth( double width )
+    {
+      m_Width = width;
+      m_InverseWidth = ( width > 0.0 ) ? 1.0 / width : 0.0;
+    }
+
+  SizeValueType GetBin( double value ) const
+    {
+      // NaN, from infinite ranges, goes to the last bin
+      const double x = ( value - m_Lower ) * m_InverseWidth;
+      return ( x < m_Bins.size() ) ? static_cast<SizeValueType>( std::max( x, 0.0 ) ) : m_Bins.size() - 1;
+    }
+
+  // double the width, keeping the lower bound
+  void GrowUp()
+    {
+      for ( SizeValueType i = 0; i < m_Bins.size(); ++i )
+        {
+        const SizeValueType count = m_Bins[i];
+        m_Bins[i] = 0;
+        m_Bins[i / 2] += count;
+        }
+      this->SetWidth( 2.0 * m_Width );
+    }
+
+  // double the width, keeping the upper bound
+  void GrowDown()
+    {
+      const SizeValueType numberOfBins = m_Bins.size();
+      for ( SizeValueType i = numberOfBins; i-- > 0; )
+        {
+        const SizeValueType count = m_Bins[i];
+        m_Bins[i] = 0;
+        m_Bins[( numberOfBins + i ) / 2] += count;
+        }
+      m_Lower -= numberOfBins * m_Width;
+      this->SetWidth( 2.0 * m_Width );
+    }
+
+  std::vector<SizeValueType> m_Bins;
+  bool                       m_FixedRange;
+  double                     m_Lower;
+  double                     m_Upper;
+  double                     m_Width;
+  double                     m_InverseWidth;
+};
+
+
+//
+// Constructor
+//
+template < class TInputImage, class TMaskImage >
+FusedStatisticsImageFilter< TInputImage, TMaskImage >::FusedStatisticsImageFilter()
+{
+  this->m_NumberOfHistogramBins = 256;
+  this->m_HistogramOversampling = 16;
+  this->m_AutoMinimumMaximum = true;
+  this->m_HistogramMinimum = 0.0;
+  this->m_HistogramMaximum = 0.0;
+
+  this->m_Minimum = NumericTraits<double>::quiet_NaN();
+  this->m_Maximum = NumericTraits<double>::quiet_NaN();
+  this->m_Mean = NumericTraits<double>::quiet_NaN();
+  this->m_Variance = NumericTraits<double>::quiet_NaN();
+  this->m_Sigma = NumericTraits<double>::quiet_NaN();
+  this->m_Sum = 0.0;
+  this->m_Count = 0;
+  this->m_Histogram = HistogramType::New();
+
+  this->AddOptionalInputName( "MaskImage" );
+}
+
+
+//
+// SetQuantiles
+//
+template < class TInputImage, class TMaskImage >
+void
+FusedStatisticsImageFilter< TInputImage, TMaskImage >::SetQuantiles( const std::vector<double> &quantiles )
+{
+  for ( double p : quantiles )
+    {
+    if ( !( p >= 0.0 && p <= 1.0 ) )
+      {
+      itkExceptionMacro("The quantile " << p << " is not between 0 and 1!");
+      }
+    }
+  if ( quantiles != this->m_Quantiles )
+    {
+    this->m_Quantiles = quantiles;
+    this->Modified();
+    }
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TMaskImage >
+void
+FusedStatisticsImageFilter< TInputImage, TMaskImage >::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  const MaskImageType *mask = this->GetMaskImage();
+
+  // the output is the input, as the statistics do not modify it
+  this->GetOutput()->Graft( const_cast<InputImageType *>( input ) );
+
+  const bool fixedRange = !this->m_AutoMinimumMaximum;
+  if ( fixedRange && !( this->m_HistogramMinimum < this->m_HistogramMaximum ) )
+    {
+    itkExceptionMacro("The histogram minimum " << this->m_HistogramMinimum
+                      << " is not less than the histogram maximum " << this->m_HistogramMaximum << "!");
+    }
+
+  // the growing histograms need at least two bins
+  const unsigned int numberOfFineBins = fixedRange ? this->m_NumberOfHistogramBins * this->m_HistogramOversampling
+    : std::max( this->m_NumberOfHistogramBins * this->m_HistogramOversampling, 2u );
+
+  std::vector<Accumulator> accumulators;
+  std::mutex mutex;
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    input->GetRequestedRegion(),
+    [&]( const RegionType &region )
+      {
+        Accumulator accumulator( numberOfFineBins, fixedRange, this->m_HistogramMinimum, this->m_HistogramMaximum );
+
+        simple::detail::InvokeWithInstructionSet( [&]
+          {
+            ImageScanlineConstIterator<InputImageType> it( input, region );
+            if ( mask )
+              {
+              ImageScanlineConstIterator<MaskImageType> maskIt( mask, region );
+              while ( !it.IsAtEnd() )
+                {
+                while ( !it.IsAtEndOfLine() )
+                  {
+                  if ( maskIt.Get() != NumericTraits<typename MaskImageType::PixelType>::ZeroValue() )
+                    {
+                    accumulator.Add( static_cast<double>( it.Get() ) );
+                    }
+                  ++it;
+                  ++maskIt;
+                  }
+                it.NextLine();
+                maskIt.NextLine();
+                }
+              }
+            else
+              {
+              while ( !it.IsAtEnd() )
+                {
+                while ( !it.IsAtEndOfLine() )
+                  {
+                  accumulator.Add( static_cast<double>( it.Get() ) );
+                  ++it;
+                  }
+                it.NextLine();
+                }
+              }
+          } );
+
+        std::lock_guard<std::mutex> lock( mutex );
+        accumulators.push_back( std::move( accumulator ) );
+      },
+    this );
+
+  Accumulator total( numberOfFineBins, fixedRange, this->m_HistogramMinimum, this->m_HistogramMaximum );
+  for ( const Accumulator &accumulator : accumulators )
+    {
+    total.MergeStatistics( accumulator );
+    }
+
+  const double nan = NumericTraits<double>::quiet_NaN();
+  const SizeValueType count = total.m_Count;
+  const double sum = total.m_Sum.GetSum();
+  this->m_Count = count;
+  this->m_Sum = sum;
+  this->m_Minimum = ( count > 0 ) ? total.m_Minimum : nan;
+  this->m_Maximum = ( count > 0 ) ? total.m_Maximum : nan;
+  this->m_Mean = ( count > 0 ) ? sum / count : nan;
+  this->m_Variance = ( count > 1 ) ? ( total.m_SumOfSquares.GetSum() - sum * sum / count ) / ( count - 1 ) : nan;
+  this->m_Sigma = ( count > 1 ) ? std::sqrt( this->m_Variance ) : nan;
+
+  // merge the histograms of the regions
+  const double lower = fixedRange ? this->m_HistogramMinimum : ( total.m_Binned > 0 ? total.m_BinnedMinimum : 0.0 );
+  const double upper = fixedRange ? this->m_HistogramMaximum : ( total.m_Binned > 0 ? total.m_BinnedMaximum : 0.0 );
+  const double width = ( upper - lower ) / numberOfFineBins;
+  std::vector<SizeValueType> fineBins( numberOfFineBins, 0 );
+  for ( const Accumulator &accumulator : accumulators )
+    {
+    accumulator.AddBinsTo( fineBins, lower, width );
+    }
+
+  const unsigned int oversampling = numberOfFineBins / this->m_NumberOfHistogramBins;
+  HistogramPointer histogram = HistogramType::New();
+  histogram->SetMeasurementVectorSize( 1 );
+  typename HistogramType::SizeType size( 1 );
+  size[0] = this->m_NumberOfHistogramBins;
+  typename HistogramType::MeasurementVectorType lowerBound( 1 );
+  typename HistogramType::MeasurementVectorType upperBound( 1 );
+  lowerBound[0] = lower;
+  upperBound[0] = upper;
+  histogram->Initialize( size, lowerBound, upperBound );
+  for ( SizeValueType fine = 0; fine < fineBins.size(); ++fine )
+    {
+    const SizeValueType bin = std::min<SizeValueType>( fine / oversampling, this->m_NumberOfHistogramBins - 1 );
+    histogram->IncreaseFrequency( bin, fineBins[fine] );
+    }
+  this->m_Histogram = histogram;
+
+  // interpolate the quantiles in the fine bins
+  this->m_QuantileValues.clear();
+  for ( double p : this->m_Quantiles )
+    {
+    if ( total.m_Binned == 0 )
+      {
+      this->m_QuantileValues.push_back( nan );
+      continue;
+      }
+    const double target = p * total.m_Binned;
+    double cumulative = 0.0;
+    double value = total.m_BinnedMaximum;
+    for ( SizeValueType fine = 0; fine < fineBins.size(); ++fine )
+      {
+      const double binCount = static_cast<double>( fineBins[fine] );
+      if ( binCount > 0.0 && cumulative + binCount >= target )
+        {
+        value = lower + ( fine + ( target - cumulative ) / binCount ) * width;
+        break;
+        }
+      cumulative += binCount;
+      }
+    this->m_QuantileValues.push_back( std::min( std::max( value, total.m_BinnedMinimum ), total.m_BinnedMaximum ) );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TMaskImage >
+void
+FusedStatisticsImageFilter< TInputImage, TMaskImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+
+  // set the output region to the largest and let the pipeline
+  // propagate the requested region to the inputs
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TMaskImage >
+void
+FusedStatisticsImageFilter< TInputImage, TMaskImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfHistogramBins: " << m_NumberOfHistogramBins << std::endl;
+  os << indent << "HistogramOversampling: " << m_HistogramOversampling << std::endl;
+  os << indent << "AutoMinimumMaximum: " << m_AutoMinimumMaximum << std::endl;
+  os << indent << "HistogramMinimum: " << m_HistogramMinimum << std::endl;
+  os << indent << "HistogramMaximum: " << m_HistogramMaximum << std::endl;
+  os << indent << "Quantiles:";
+  for ( double p : m_Quantiles )
+    {
+    os << " " << p;
+    }
+  os << std::endl;
+  os << indent << "Minimum: " << m_Minimum << std::endl;
+  os << indent << "Maximum: " << m_Maximum << std::endl;
+  os << indent << "Mean: " << m_Mean << std::endl;
+  os << indent << "Variance: " << m_Variance << std::endl;
+  os << indent << "Sigma: " << m_Sigma << std::endl;
+  os << indent << "Sum: " << m_Sum << std::endl;
+  os << indent << "Count: " << m_Count << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkFusedStatisticsImageFilter_hxx
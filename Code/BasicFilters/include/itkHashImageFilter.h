@@ -34,7 +34,17 @@ namespace itk {
  * with itk::Image and itk::VectorImage. It is modeled after the access
  * an ImageFileWriter provides to an ImageIO.
  *
- * \todo Update in-place on to default after fixing bug in InPlaceImageFilter
+ * The hash is computed from the buffer of the input, which is passed
+ * through to the output without a copy, as ChangeInformationImageFilter
+ * does.
+ *
+ * With a TreeHashChunkSize, the bytes of the image are divided into
+ * chunks of that size which are hashed in parallel, and the hash is the
+ * hash of their concatenated binary digests. It does not depend on the
+ * number of threads, but it differs from the hash of the whole buffer.
+ *
+ * With UseHashRegion, only the pixels of the HashRegion are read, and
+ * the hash is the one of the image of that region.
  */
 template < class TImageType >
 class HashImageFilter:
@@ -69,12 +79,29 @@ public:
   const HashObjectType* GetHashOutput() const
   { return static_cast<const HashObjectType *>( this->ProcessObject::GetOutput(1) ); }
 
-  enum  HashFunction { SHA1, MD5 };
+  /** The cryptographic SHA1 and MD5 hashes, and the much faster
+   * non-cryptographic 64-bit xxHash. */
+  enum  HashFunction { SHA1, MD5, XXH64 };
 
   /** Set/Get hashing function as enumerated type */
   itkSetMacro( HashFunction, HashFunction );
   itkGetMacro( HashFunction, HashFunction );
 
+  /** Set/Get the number of bytes of the chunks of the tree hash,
+   * rounded down to a whole number of pixel components. When 0, the
+   * default, the bytes are hashed sequentially. */
+  itkSetMacro( TreeHashChunkSize, SizeValueType );
+  itkGetConstMacro( TreeHashChunkSize, SizeValueType );
+
+  /** Set/Get the region of the input to hash, instead of the buffered
+   * region, when UseHashRegion is on. It must be inside the buffered
+   * region. */
+  itkSetMacro( HashRegion, RegionType );
+  itkGetConstReferenceMacro( HashRegion, RegionType );
+  itkSetMacro( UseHashRegion, bool );
+  itkGetConstMacro( UseHashRegion, bool );
+  itkBooleanMacro( UseHashRegion );
+
 /** Make a DataObject of the correct type to be used as the specified
    * output. */
   using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
@@ -91,9 +118,8 @@ protected:
 
   // See superclass for doxygen documentation
   //
-  // This method is to do work after the superclass potential threaded
-  // copy.
-  void AfterThreadedGenerateData() override;
+  // The input is passed through to the output, and hashed.
+  void GenerateData() override;
 
   // See superclass for doxygen documentation
   //
@@ -101,11 +127,17 @@ protected:
   void EnlargeOutputRequestedRegion(DataObject *data) override;
 
 private:
+  // A hash function, appended with pieces of the bytes
+  class HashContext;
+
   HashImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
 
 
-  HashFunction m_HashFunction;
+  HashFunction  m_HashFunction;
+  SizeValueType m_TreeHashChunkSize;
+  RegionType    m_HashRegion;
+  bool          m_UseHashRegion;
 };
 
 
@@ -21,10 +21,129 @@
 #include "itkHashImageFilter.h"
 
 #include "Ancillary/hl_sha1.h"
+#include "Ancillary/xxhash64.h"
 #include "itksys/MD5.h"
 
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
 namespace itk {
 
+//
+// HashContext
+//
+template<class TImageType>
+class HashImageFilter<TImageType>::HashContext
+{
+public:
+  explicit HashContext( HashFunction function )
+    : m_Function( function ),
+      m_MD5( nullptr )
+    {
+      switch ( m_Function )
+        {
+        case SHA1:
+          m_SHA1.SHA1Reset( &m_SHA1Context );
+          break;
+        case MD5:
+          m_MD5 = itksysMD5_New();
+          itksysMD5_Initialize( m_MD5 );
+          break;
+        case XXH64:
+          break;
+        }
+    }
+
+  ~HashContext()
+    {
+      if ( m_MD5 )
+        {
+        itksysMD5_Delete( m_MD5 );
+        }
+    }
+
+  HashContext(const HashContext &) = delete;
+  HashContext &operator=(const HashContext &) = delete;
+
+  void Update( const unsigned char *data, size_t length )
+    {
+      // the lengths of the appends of MD5 and SHA1 are limited to int
+      const size_t maximumLength = size_t(1) << 30;
+      while ( length > 0 )
+        {
+        const size_t n = std::min( length, maximumLength );
+        switch ( m_Function )
+          {
+          case SHA1:
+            m_SHA1.SHA1Input( &m_SHA1Context, data, static_cast<unsigned int>( n ) );
+            break;
+          case MD5:
+            itksysMD5_Append( m_MD5, data, static_cast<int>( n ) );
+            break;
+          case XXH64:
+            m_XXH64.Update( data, n );
+            break;
+          }
+        data += n;
+        length -= n;
+        }
+    }
+
+  std::vector<unsigned char> Digest()
+    {
+      switch ( m_Function )
+        {
+        case SHA1:
+        {
+        hl_uint8 digest[SHA1HashSize];
+        m_SHA1.SHA1Result( &m_SHA1Context, digest );
+        return std::vector<unsigned char>( digest, digest + SHA1HashSize );
+        }
+        case MD5:
+        {
+        unsigned char digest[16];
+        itksysMD5_Finalize( m_MD5, digest );
+        return std::vector<unsigned char>( digest, digest + 16 );
+        }
+        case XXH64:
+        default:
+        {
+        // the canonical big endian representation
+        const uint64_t value = m_XXH64.Digest();
+        std::vector<unsigned char> digest( 8 );
+        for ( unsigned int i = 0; i < 8; ++i )
+          {
+          digest[i] = static_cast<unsigned char>( value >> ( 8 * ( 7 - i ) ) );
+          }
+        return digest;
+        }
+        }
+    }
+
+  static std::string ToHex( const std::vector<unsigned char> &digest )
+    {
+      std::ostringstream os;
+      for ( unsigned char byte : digest )
+        {
+        // set the width to 2, fill with 0, and convert to hex
+        os.width(2);
+        os.fill('0');
+        os << std::hex << static_cast<unsigned int>( byte );
+        }
+      return os.str();
+    }
+
+private:
+  HashFunction   m_Function;
+  ::SHA1         m_SHA1;
+  ::HL_SHA1_CTX  m_SHA1Context;
+  itksysMD5     *m_MD5;
+  ::XXH64        m_XXH64;
+};
+
+
 //
 // Constructor
 //
@@ -32,11 +151,13 @@ template<class TImageType>
 HashImageFilter<TImageType>::HashImageFilter()
 {
   this->m_HashFunction = MD5;
+  this->m_TreeHashChunkSize = 0;
+  this->m_UseHashRegion = false;
 
   // create data object
   this->ProcessObject::SetNthOutput( 1, this->MakeOutput(1).GetPointer() );
 
-  // NOTE: Turning this on causes a crash due to a bug is InPlaceImageFilter
+  // the input is not copied to the output
   this->InPlaceOff();
 }
 
@@ -55,43 +176,21 @@ HashImageFilter<TImageType>::MakeOutput(DataObjectPointerArraySizeType idx)
 }
 
 //
-// AfterThreadedGenerateData
+// GenerateData
 //
 template<class TImageType>
 void
-HashImageFilter<TImageType>::AfterThreadedGenerateData()
+HashImageFilter<TImageType>::GenerateData()
 {
-  // NOTE: We have choose our super class to be the
-  // CastImageFilter. The filter is derived from the
-  // InPlaceFilter. The CastImageFilter will copy its input, in the
-  // best fashion based on the InPlace setting. We want the
-  // behavior. This methods is called after the caster has done it's
-  // work.
-
-  Superclass::AfterThreadedGenerateData();
-
   using ImageType = TImageType;
   using PixelType = typename ImageType::PixelType;
   using ValueType = typename NumericTraits<PixelType>::ValueType;
   using Swapper = itk::ByteSwapper<ValueType>;
 
-  struct MD5Holder
-  {
-    MD5Holder() : md5(itksysMD5_New()) {}
-    ~MD5Holder() {itksysMD5_Delete(md5);}
-    itksysMD5 *md5;
-  };
-  MD5Holder holder;
-
-  itksysMD5 *md5 = holder.md5;
-  itksysMD5_Initialize( md5 );
-
-  ::SHA1 sha1;
-  ::HL_SHA1_CTX sha1Context;
-  sha1.SHA1Reset ( &sha1Context );
-
   typename ImageType::ConstPointer input = this->GetInput();
 
+  // the output is the input, as the hash does not modify it
+  this->GetOutput()->Graft( const_cast<ImageType *>( input.GetPointer() ) );
 
   // make a good guess about the number of components in each pixel
   size_t numberOfComponent =   sizeof(PixelType) / sizeof(ValueType );
@@ -106,63 +205,97 @@ HashImageFilter<TImageType>::AfterThreadedGenerateData()
     itkExceptionMacro("Unsupported data type for hashing!");
     }
 
-  // we feel bad about accessing the data this way
-  ValueType *buffer = static_cast<ValueType*>( (void *)input->GetBufferPointer() );
-
-  typename ImageType::RegionType largestRegion = input->GetBufferedRegion();
-  const size_t numberOfValues = largestRegion.GetNumberOfPixels()*numberOfComponent;
-
-  // Possibly byte swap so we always calculate on little endian data
-  Swapper::SwapRangeFromSystemToLittleEndian ( buffer, numberOfValues );
-
-  // Update the hash
-  switch ( this->m_HashFunction )
+  const RegionType bufferedRegion = input->GetBufferedRegion();
+  const RegionType region = this->m_UseHashRegion ? this->m_HashRegion : bufferedRegion;
+  if ( !bufferedRegion.IsInside( region ) && region.GetNumberOfPixels() > 0 )
     {
-    case SHA1:
-      sha1.SHA1Input ( &sha1Context, (unsigned char*)buffer, numberOfValues*sizeof(ValueType) );
-      break;
-    case MD5:
-      itksysMD5_Append( md5, (unsigned char*)buffer, static_cast<int>( numberOfValues*sizeof(ValueType) ) );
-      break;
+    itkExceptionMacro("The hash region " << region << " is not inside the buffered region " << bufferedRegion << "!");
     }
 
-  // Calculate and return the hash value
-  switch ( this->m_HashFunction )
+  // The bytes of the region, in the order of its pixels, are contiguous
+  // spans of the buffer: its rows, or the whole buffer.
+  const size_t pixelSize = numberOfComponent * sizeof( ValueType );
+  const unsigned char *buffer = static_cast<const unsigned char *>( static_cast<const void *>( input->GetBufferPointer() ) );
+  const bool isBufferedRegion = ( region == bufferedRegion );
+  const size_t numberOfPixels = region.GetNumberOfPixels();
+  const size_t spanLength = ( numberOfPixels == 0 ) ? 0 : pixelSize * ( isBufferedRegion ? numberOfPixels : region.GetSize(0) );
+  const size_t numberOfSpans = ( numberOfPixels == 0 ) ? 0 : ( isBufferedRegion ? 1 : numberOfPixels / region.GetSize(0) );
+  const size_t numberOfBytes = spanLength * numberOfSpans;
+
+  auto spanPointer = [&]( size_t span )
     {
-    case SHA1:
+      typename RegionType::IndexType index = region.GetIndex();
+      for ( unsigned int d = 1; d < RegionType::ImageDimension; ++d )
+        {
+        index[d] += static_cast<IndexValueType>( span % region.GetSize(d) );
+        span /= region.GetSize(d);
+        }
+      return buffer + static_cast<size_t>( input->ComputeOffset( index ) ) * pixelSize;
+    };
+
+  // Hash the bytes from begin to end, which are whole values, byte
+  // swapped so the hash is always computed on little endian data.
+  auto hashBytes = [&]( HashContext &context, size_t begin, size_t end )
     {
-    const int HashSize = SHA1HashSize;
-     hl_uint8 Digest[1024];
-    sha1.SHA1Result ( &sha1Context, Digest );
-
-    // Convert binary to hex string representation
-
-    std::ostringstream os;
-    for(int i=0; i<HashSize; ++i)
-      {
-      // set the width to 2, fill with 0, and convert to hex
-      os.width(2);
-      os.fill('0');
-      os << std::hex << static_cast<unsigned int>(Digest[i]);
-      }
-
-    this->GetHashOutput()->Set( os.str() );
-
-    break;
-    }
-    case MD5:
+      std::vector<ValueType> swapped;
+      while ( begin < end )
+        {
+        const size_t span = begin / spanLength;
+        const size_t offset = begin % spanLength;
+        const size_t length = std::min( spanLength - offset, end - begin );
+        const unsigned char *data = spanPointer( span ) + offset;
+
+        if ( sizeof( ValueType ) == 1 || !Swapper::SystemIsBigEndian() )
+          {
+          context.Update( data, length );
+          }
+        else
+          {
+          const size_t blockLength = sizeof( ValueType ) << 14;
+          for ( size_t b = 0; b < length; b += blockLength )
+            {
+            const size_t n = std::min( blockLength, length - b );
+            swapped.resize( n / sizeof( ValueType ) );
+            std::memcpy( swapped.data(), data + b, n );
+            Swapper::SwapRangeFromSystemToLittleEndian( swapped.data(), swapped.size() );
+            context.Update( reinterpret_cast<const unsigned char *>( swapped.data() ), n );
+            }
+          }
+        begin += length;
+        }
+    };
+
+  HashContext context( this->m_HashFunction );
+  if ( this->m_TreeHashChunkSize == 0 )
     {
-    const size_t DigestSize = 32u;
-    char Digest[DigestSize];
-
-    // directly to HEX
-    itksysMD5_FinalizeHex( md5, Digest );
-
-    this->GetHashOutput()->Set( std::string(Digest, DigestSize) );
-    break;
+    hashBytes( context, 0, numberOfBytes );
     }
+  else
+    {
+    // hash the chunks in parallel, then their digests in order
+    const size_t chunkSize = std::max<size_t>( this->m_TreeHashChunkSize - this->m_TreeHashChunkSize % sizeof( ValueType ),
+                                               sizeof( ValueType ) );
+    const size_t numberOfChunks = ( numberOfBytes + chunkSize - 1 ) / chunkSize;
+    std::vector< std::vector<unsigned char> > digests( numberOfChunks );
+
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&]( SizeValueType chunk )
+        {
+          HashContext chunkContext( this->m_HashFunction );
+          hashBytes( chunkContext, chunk * chunkSize, std::min( ( chunk + 1 ) * chunkSize, numberOfBytes ) );
+          digests[chunk] = chunkContext.Digest();
+        },
+      this );
+
+    for ( const std::vector<unsigned char> &digest : digests )
+      {
+      context.Update( digest.data(), digest.size() );
+      }
     }
 
+  this->GetHashOutput()->Set( HashContext::ToHex( context.Digest() ) );
 }
 
 
@@ -191,6 +324,9 @@ HashImageFilter<TImageType>::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
 
   os << indent << "HashFunction: " << m_HashFunction << std::endl;
+  os << indent << "TreeHashChunkSize: " << m_TreeHashChunkSize << std::endl;
+  os << indent << "HashRegion: " << m_HashRegion << std::endl;
+  os << indent << "UseHashRegion: " << m_UseHashRegion << std::endl;
 }
 
 
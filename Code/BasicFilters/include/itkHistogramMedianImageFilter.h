@@ -0,0 +1,105 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkHistogramMedianImageFilter_h
+#define itkHistogramMedianImageFilter_h
+
+#include "itkBoxImageFilter.h"
+
+#include <type_traits>
+
+
+namespace itk {
+
+/** Whether the HistogramMedianImageFilter supports a pixel type: the
+ * integers of at most 16 bits. */
+template < typename TPixel >
+struct HistogramMedianSupportedPixel
+  : public std::integral_constant< bool, std::is_integral<TPixel>::value && sizeof(TPixel) <= 2 >
+{
+};
+
+
+/** \class HistogramMedianImageFilter
+ * \brief Exact median filter of the images of small integers with a
+ * moving histogram.
+ *
+ * The output is the same as with the MedianImageFilter, the median of
+ * the box neighborhood of Radius with the ZeroFluxNeumann boundary
+ * condition, for the pixel types of HistogramMedianSupportedPixel.
+ *
+ * Each line of the output is computed by moving the histogram of the
+ * neighborhood along the first dimension, removing and adding one
+ * column of the neighborhood at each pixel, as proposed by Huang. The
+ * median is then moved from its previous bin, skipping the empty
+ * blocks of bins with a second coarse histogram, so the cost of a
+ * pixel grows with the size of a column instead of the neighborhood.
+ *
+ * \sa MedianImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class HistogramMedianImageFilter:
+    public BoxImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = HistogramMedianImageFilter;
+  using Superclass = BoxImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using OutputImageRegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  static_assert( HistogramMedianSupportedPixel<InputPixelType>::value,
+                 "The pixels must be integers of at most 16 bits." );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(HistogramMedianImageFilter, BoxImageFilter);
+
+protected:
+
+  HistogramMedianImageFilter() = default;
+
+  ~HistogramMedianImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The lines of the output are split between the threads, which each
+  // move their own histogram along them.
+  void GenerateData() override;
+
+private:
+  HistogramMedianImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+};
+
+
+} // end namespace itk
+
+
+#include "itkHistogramMedianImageFilter.hxx"
+
+#endif // itkHistogramMedianImageFilter_h
@@ -0,0 +1,203 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkHistogramMedianImageFilter_hxx
+#define itkHistogramMedianImageFilter_hxx
+
+#include "itkHistogramMedianImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+HistogramMedianImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  using IndexType = typename OutputImageRegionType::IndexType;
+
+  // the bins of the values, in blocks of a coarse histogram
+  constexpr unsigned int NumberOfBins = 1u << ( 8 * sizeof( InputPixelType ) );
+  constexpr unsigned int BlockSize = ( sizeof( InputPixelType ) == 1 ) ? 16 : 256;
+  constexpr unsigned int NumberOfBlocks = NumberOfBins / BlockSize;
+  constexpr int BinOffset = -static_cast<int>( std::numeric_limits<InputPixelType>::min() );
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const OutputImageRegionType inputRegion = input->GetBufferedRegion();
+  const typename InputImageType::SizeType radius = this->GetRadius();
+
+  // the clamped rows of a column of the neighborhood, and its size
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    numberOfRows *= 2 * radius[d] + 1;
+    }
+  const SizeValueType neighborhoodSize = numberOfRows * ( 2 * radius[0] + 1 );
+  const SizeValueType rank = neighborhoodSize / 2;
+
+  const IndexValueType firstX = inputRegion.GetIndex( 0 );
+  const IndexValueType lastX = firstX + static_cast<IndexValueType>( inputRegion.GetSize( 0 ) ) - 1;
+  auto clampX = [firstX, lastX]( IndexValueType x )
+    {
+      return std::min( std::max( x, firstX ), lastX ) - firstX;
+    };
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  this->GetMultiThreader()->template ParallelizeImageRegionRestrictDirection<ImageDimension>(
+    0,
+    output->GetRequestedRegion(),
+    [&]( const OutputImageRegionType &region )
+      {
+        std::vector<uint32_t> bins( NumberOfBins, 0 );
+        std::vector<uint32_t> blocks( NumberOfBlocks, 0 );
+        std::vector<const InputPixelType *> rows( numberOfRows );
+
+        auto add = [&]( InputPixelType value )
+          {
+            const unsigned int bin = static_cast<unsigned int>( static_cast<int>( value ) + BinOffset );
+            ++bins[bin];
+            ++blocks[bin / BlockSize];
+            return bin;
+          };
+        auto remove = [&]( InputPixelType value )
+          {
+            const unsigned int bin = static_cast<unsigned int>( static_cast<int>( value ) + BinOffset );
+            --bins[bin];
+            --blocks[bin / BlockSize];
+            return bin;
+          };
+
+        ImageScanlineIterator<OutputImageType> outIt( output, region );
+        while ( !outIt.IsAtEnd() )
+          {
+          const IndexType index = outIt.GetIndex();
+
+          // the rows of the neighborhood, with the clamped indices of the
+          // ZeroFluxNeumann boundary condition
+          IndexType rowIndex = index;
+          for ( SizeValueType row = 0; row < numberOfRows; ++row )
+            {
+            SizeValueType position = row;
+            for ( unsigned int d = 1; d < ImageDimension; ++d )
+              {
+              const SizeValueType width = 2 * radius[d] + 1;
+              const IndexValueType first = inputRegion.GetIndex( d );
+              const IndexValueType last = first + static_cast<IndexValueType>( inputRegion.GetSize( d ) ) - 1;
+              const IndexValueType shifted = index[d] + static_cast<IndexValueType>( position % width ) - static_cast<IndexValueType>( radius[d] );
+              rowIndex[d] = std::min( std::max( shifted, first ), last );
+              position /= width;
+              }
+            rowIndex[0] = firstX;
+            rows[row] = input->GetBufferPointer() + input->ComputeOffset( rowIndex );
+            }
+
+          // the histogram of the first neighborhood of the line
+          const IndexValueType x0 = index[0];
+          const IndexValueType radiusX = static_cast<IndexValueType>( radius[0] );
+          for ( IndexValueType x = x0 - radiusX; x <= x0 + radiusX; ++x )
+            {
+            const IndexValueType column = clampX( x );
+            for ( const InputPixelType *row : rows )
+              {
+              add( row[column] );
+              }
+            }
+
+          // the median bin, and the number of values in the bins below it
+          unsigned int median = 0;
+          SizeValueType below = 0;
+
+          IndexValueType x = x0;
+          while ( true )
+            {
+            // move the median up or down, by blocks when possible
+            while ( below > rank )
+              {
+              if ( median % BlockSize == 0 && below - blocks[median / BlockSize - 1] > rank )
+                {
+                below -= blocks[median / BlockSize - 1];
+                median -= BlockSize;
+                continue;
+                }
+              --median;
+              below -= bins[median];
+              }
+            while ( below + bins[median] <= rank )
+              {
+              if ( median % BlockSize == 0 && below + blocks[median / BlockSize] <= rank )
+                {
+                below += blocks[median / BlockSize];
+                median += BlockSize;
+                continue;
+                }
+              below += bins[median];
+              ++median;
+              }
+
+            outIt.Set( static_cast<OutputPixelType>( static_cast<int>( median ) - BinOffset ) );
+            ++outIt;
+            if ( outIt.IsAtEndOfLine() )
+              {
+              break;
+              }
+
+            // move the neighborhood by one column
+            const IndexValueType removed = clampX( x - radiusX );
+            const IndexValueType added = clampX( x + radiusX + 1 );
+            if ( removed != added )
+              {
+              for ( const InputPixelType *row : rows )
+                {
+                below -= ( remove( row[removed] ) < median );
+                below += ( add( row[added] ) < median );
+                }
+              }
+            ++x;
+            }
+
+          // empty the histogram for the next line
+          for ( IndexValueType column = x - radiusX; column <= x + radiusX; ++column )
+            {
+            const IndexValueType clamped = clampX( column );
+            for ( const InputPixelType *row : rows )
+              {
+              remove( row[clamped] );
+              }
+            }
+
+          outIt.NextLine();
+          }
+      },
+    this );
+}
+
+
+} // end namespace itk
+
+#endif // itkHistogramMedianImageFilter_hxx
@@ -0,0 +1,129 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkHistogramScalarImageKmeansImageFilter_h
+#define itkHistogramScalarImageKmeansImageFilter_h
+
+#include "itkScalarImageKmeansImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class HistogramScalarImageKmeansImageFilter
+ * \brief K-means classification of the images of small integers on
+ * the histogram of their values.
+ *
+ * With UseHistogram off, the default, the filter is the
+ * ScalarImageKmeansImageFilter, which builds a k-d tree of all the
+ * pixels for the estimation of the means. With UseHistogram on and
+ * the integer pixels of at most 16 bits, the histogram of all the
+ * values is computed in one parallel pass over the image. The means
+ * are then estimated by the iterations of Lloyd on the values of the
+ * histogram, weighted by their frequencies, until the means do not
+ * change, with at most the 200 iterations of the superclass, at a
+ * cost which does not depend on the size of the image. The pixels are
+ * classified by a lookup table of the labels of all the values, in a
+ * second parallel pass.
+ *
+ * The means and the labels are those of the superclass, up to the
+ * classes of the values halfway between two means. The superclass is
+ * used for the other pixel types, and when an image region is set.
+ *
+ * \sa ScalarImageKmeansImageFilter
+ */
+template < class TInputImage, class TOutputImage = Image< unsigned char, TInputImage::ImageDimension > >
+class HistogramScalarImageKmeansImageFilter:
+    public ScalarImageKmeansImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = HistogramScalarImageKmeansImageFilter;
+  using Superclass = ScalarImageKmeansImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+  using RealPixelType = typename Superclass::RealPixelType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(HistogramScalarImageKmeansImageFilter, ScalarImageKmeansImageFilter);
+
+  /** Estimate the means on the histogram of the values. Off by
+   * default. */
+  itkSetMacro( UseHistogram, bool );
+  itkGetConstMacro( UseHistogram, bool );
+  itkBooleanMacro( UseHistogram );
+
+  /** Add a class with its initial mean, to the superclass too. */
+  void AddClassWithInitialMean( RealPixelType mean )
+  {
+    m_InitialMeans.push_back( static_cast<double>( mean ) );
+    Superclass::AddClassWithInitialMean( mean );
+  }
+
+  /** Restrict the classification to a region, with the superclass. */
+  void SetImageRegion( const RegionType &region )
+  {
+    m_ImageRegionDefined = true;
+    Superclass::SetImageRegion( region );
+  }
+
+  /** The means of the last update, by either estimation. */
+  const std::vector<double> &
+  GetEstimatedMeans() const
+  {
+    return m_EstimatedMeans;
+  }
+
+protected:
+
+  HistogramScalarImageKmeansImageFilter() = default;
+
+  ~HistogramScalarImageKmeansImageFilter() override = default;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  HistogramScalarImageKmeansImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool                m_UseHistogram{false};
+  bool                m_ImageRegionDefined{false};
+  std::vector<double> m_InitialMeans;
+  std::vector<double> m_EstimatedMeans;
+};
+
+
+} // end namespace itk
+
+
+#include "itkHistogramScalarImageKmeansImageFilter.hxx"
+
+#endif // itkHistogramScalarImageKmeansImageFilter_h
@@ -0,0 +1,195 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkHistogramScalarImageKmeansImageFilter_hxx
+#define itkHistogramScalarImageKmeansImageFilter_hxx
+
+#include "itkHistogramScalarImageKmeansImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+HistogramScalarImageKmeansImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  constexpr bool SupportedPixel = std::is_integral<InputPixelType>::value && sizeof( InputPixelType ) <= 2;
+  if ( !SupportedPixel || !m_UseHistogram || m_ImageRegionDefined || m_InitialMeans.empty() )
+    {
+    Superclass::GenerateData();
+    const auto finalMeans = this->GetFinalMeans();
+    m_EstimatedMeans.assign( finalMeans.begin(), finalMeans.end() );
+    return;
+    }
+
+  const InputImageType *input = this->GetInput();
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+
+  const double lowest = static_cast<double>( std::numeric_limits<InputPixelType>::lowest() );
+  const SizeValueType numberOfValues = static_cast<SizeValueType>( static_cast<double>( std::numeric_limits<InputPixelType>::max() ) - lowest ) + 1;
+  auto valueIndex = [lowest]( InputPixelType value )
+    {
+      return static_cast<SizeValueType>( static_cast<double>( value ) - lowest );
+    };
+
+  // the histogram of all the values, from the histograms of the
+  // regions of the threads
+  std::vector<SizeValueType> histogram( numberOfValues, 0 );
+  std::mutex mutex;
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [&]( const RegionType &threadRegion )
+      {
+        std::vector<SizeValueType> threadHistogram( numberOfValues, 0 );
+        ImageScanlineConstIterator<InputImageType> inIt( input, threadRegion );
+        while ( !inIt.IsAtEnd() )
+          {
+          while ( !inIt.IsAtEndOfLine() )
+            {
+            ++threadHistogram[valueIndex( inIt.Get() )];
+            ++inIt;
+            }
+          inIt.NextLine();
+          }
+        std::lock_guard<std::mutex> lock( mutex );
+        for ( SizeValueType v = 0; v < numberOfValues; ++v )
+          {
+          histogram[v] += threadHistogram[v];
+          }
+      },
+    nullptr );
+
+  // the class of the nearest mean, the first one for equal distances
+  // as with the MinimumDecisionRule of the superclass
+  const unsigned int numberOfClasses = static_cast<unsigned int>( m_InitialMeans.size() );
+  std::vector<double> means = m_InitialMeans;
+  auto nearestClass = [&means, numberOfClasses]( double value )
+    {
+      unsigned int nearest = 0;
+      double distance = std::abs( value - means[0] );
+      for ( unsigned int k = 1; k < numberOfClasses; ++k )
+        {
+        const double d = std::abs( value - means[k] );
+        if ( d < distance )
+          {
+          distance = d;
+          nearest = k;
+          }
+        }
+      return nearest;
+    };
+
+  // the iterations of Lloyd on the values, weighted by their
+  // frequencies, the means of the empty classes being kept
+  constexpr unsigned int MaximumIterations = 200;
+  std::vector<double> sums( numberOfClasses );
+  std::vector<double> weights( numberOfClasses );
+  for ( unsigned int iteration = 0; iteration < MaximumIterations; ++iteration )
+    {
+    std::fill( sums.begin(), sums.end(), 0.0 );
+    std::fill( weights.begin(), weights.end(), 0.0 );
+    for ( SizeValueType v = 0; v < numberOfValues; ++v )
+      {
+      if ( histogram[v] != 0 )
+        {
+        const double value = lowest + static_cast<double>( v );
+        const unsigned int k = nearestClass( value );
+        sums[k] += static_cast<double>( histogram[v] ) * value;
+        weights[k] += static_cast<double>( histogram[v] );
+        }
+      }
+
+    double change = 0.0;
+    for ( unsigned int k = 0; k < numberOfClasses; ++k )
+      {
+      if ( weights[k] > 0.0 )
+        {
+        const double mean = sums[k] / weights[k];
+        change += ( mean - means[k] ) * ( mean - means[k] );
+        means[k] = mean;
+        }
+      }
+    if ( change <= 0.0 )
+      {
+      break;
+      }
+    }
+  m_EstimatedMeans = means;
+
+  // the labels of the classes, spread over the range of the output
+  // with UseNonContiguousLabels as in the superclass
+  unsigned int labelInterval = 1;
+  if ( this->GetUseNonContiguousLabels() )
+    {
+    labelInterval = static_cast<unsigned int>( NumericTraits<OutputPixelType>::max() / numberOfClasses ) - 1;
+    }
+  std::vector<OutputPixelType> lookupTable( numberOfValues );
+  for ( SizeValueType v = 0; v < numberOfValues; ++v )
+    {
+    lookupTable[v] = static_cast<OutputPixelType>( nearestClass( lowest + static_cast<double>( v ) ) * labelInterval );
+    }
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    region,
+    [&]( const RegionType &threadRegion )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, threadRegion );
+        ImageScanlineIterator<OutputImageType> outIt( output, threadRegion );
+        while ( !inIt.IsAtEnd() )
+          {
+          while ( !inIt.IsAtEndOfLine() )
+            {
+            outIt.Set( lookupTable[valueIndex( inIt.Get() )] );
+            ++inIt;
+            ++outIt;
+            }
+          inIt.NextLine();
+          outIt.NextLine();
+          }
+      },
+    this );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+HistogramScalarImageKmeansImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "UseHistogram: " << m_UseHistogram << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkHistogramScalarImageKmeansImageFilter_hxx
@@ -0,0 +1,181 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceDeconvolutionIterations_h
+#define itkInPlaceDeconvolutionIterations_h
+
+#include "itkHalfHermitianToRealInverseFFTImageFilter.h"
+#include "itkMultiThreaderBase.h"
+#include "itkProgressAccumulator.h"
+#include "itkRealToHalfHermitianForwardFFTImageFilter.h"
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <vector>
+
+
+namespace itk {
+
+/** \brief The transforms and the buffers of the iterations of a
+ * deconvolution, kept across the iterations.
+ *
+ * The transfer function, the half Hermitian spectrum of the kernel,
+ * is set once. The forward and inverse real-to-complex transforms are
+ * the same filters for all the iterations, and the pointwise steps of
+ * an iteration are fused in parallel loops over the buffers, which
+ * write to the buffers of the previous iteration instead of new
+ * images. Only the outputs of the transforms are allocated by the FFT
+ * filters.
+ */
+template < typename TInternalImage, typename TInternalComplexImage >
+class InPlaceDeconvolutionIterations
+{
+public:
+  using InternalImageType = TInternalImage;
+  using InternalComplexImageType = TInternalComplexImage;
+  using InternalPixelType = typename TInternalImage::PixelType;
+  using ComplexPixelType = typename TInternalComplexImage::PixelType;
+
+  using FFTFilterType = RealToHalfHermitianForwardFFTImageFilter< InternalImageType, InternalComplexImageType >;
+  using IFFTFilterType = HalfHermitianToRealInverseFFTImageFilter< InternalComplexImageType, InternalImageType >;
+
+  /** Set the transfer function and the filters of the transforms,
+   * whose progress is reported to progress with the weight of each
+   * transform. */
+  void Initialize( InternalComplexImageType *transferFunction,
+                   bool xDimensionIsOdd,
+                   MultiThreaderBase *multiThreader,
+                   unsigned int numberOfWorkUnits,
+                   ProgressAccumulator *progress,
+                   float transformProgressWeight )
+  {
+    m_TransferFunction = transferFunction;
+    m_MultiThreader = multiThreader;
+    m_NumberOfWorkUnits = std::max( numberOfWorkUnits, 1u );
+
+    m_ForwardFFTFilter = FFTFilterType::New();
+    m_ForwardFFTFilter->SetNumberOfWorkUnits( m_NumberOfWorkUnits );
+    m_ForwardFFTFilter->ReleaseDataFlagOff();
+    progress->RegisterInternalFilter( m_ForwardFFTFilter, transformProgressWeight );
+
+    m_InverseFFTFilter = IFFTFilterType::New();
+    m_InverseFFTFilter->SetActualXDimensionIsOdd( xDimensionIsOdd );
+    m_InverseFFTFilter->SetNumberOfWorkUnits( m_NumberOfWorkUnits );
+    m_InverseFFTFilter->ReleaseDataFlagOff();
+    progress->RegisterInternalFilter( m_InverseFFTFilter, transformProgressWeight );
+  }
+
+  /** Release the filters and the transfer function. */
+  void Release()
+  {
+    m_TransferFunction = nullptr;
+    m_ForwardFFTFilter = nullptr;
+    m_InverseFFTFilter = nullptr;
+  }
+
+  /** The spectrum of an image, which is modified in place by the
+   * callers until the next transform. */
+  InternalComplexImageType *
+  Forward( const InternalImageType *image )
+  {
+    m_ForwardFFTFilter->SetInput( image );
+    m_ForwardFFTFilter->Modified();
+    m_ForwardFFTFilter->Update();
+    return m_ForwardFFTFilter->GetOutput();
+  }
+
+  /** The image of a spectrum. */
+  const InternalImageType *
+  Inverse( const InternalComplexImageType *spectrum )
+  {
+    m_InverseFFTFilter->SetInput( spectrum );
+    m_InverseFFTFilter->Modified();
+    m_InverseFFTFilter->Update();
+    return m_InverseFFTFilter->GetOutput();
+  }
+
+  /** The convolution of an image with the kernel, or the correlation
+   * with conjugate, through the spectrum of the forward filter. */
+  const InternalImageType *
+  Convolve( const InternalImageType *image, bool conjugate )
+  {
+    InternalComplexImageType *spectrum = this->Forward( image );
+    ComplexPixelType *s = spectrum->GetBufferPointer();
+    const ComplexPixelType *h = m_TransferFunction->GetBufferPointer();
+    this->template ParallelizeBuffer<0>( spectrum->GetBufferedRegion().GetNumberOfPixels(),
+                                         [s, h, conjugate]( SizeValueType begin, SizeValueType end )
+                                           {
+                                             for ( SizeValueType i = begin; i < end; ++i )
+                                               {
+                                               s[i] *= conjugate ? std::conj( h[i] ) : h[i];
+                                               }
+                                             return std::array<double, 0>();
+                                           } );
+    return this->Inverse( spectrum );
+  }
+
+  /** Call f( begin, end ) for blocks of [0, n), in parallel, and
+   * return the sums of the NumberOfSums values returned for the
+   * blocks, in the order of the blocks, so that they do not depend on
+   * the threads. */
+  template < unsigned int NumberOfSums, typename TFunction >
+  std::array<double, NumberOfSums>
+  ParallelizeBuffer( SizeValueType n, TFunction &&f )
+  {
+    constexpr SizeValueType BlockSize = 1 << 16;
+    const SizeValueType numberOfBlocks = ( n + BlockSize - 1 ) / BlockSize;
+    std::vector< std::array<double, NumberOfSums> > blockSums( numberOfBlocks );
+    m_MultiThreader->SetNumberOfWorkUnits( m_NumberOfWorkUnits );
+    m_MultiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&]( SizeValueType block )
+        {
+          blockSums[block] = f( block * BlockSize, std::min( n, ( block + 1 ) * BlockSize ) );
+        },
+      nullptr );
+    std::array<double, NumberOfSums> sums;
+    sums.fill( 0.0 );
+    for ( const std::array<double, NumberOfSums> &block : blockSums )
+      {
+      for ( unsigned int k = 0; k < NumberOfSums; ++k )
+        {
+        sums[k] += block[k];
+        }
+      }
+    return sums;
+  }
+
+  InternalComplexImageType *
+  GetTransferFunction() const
+  {
+    return m_TransferFunction;
+  }
+
+private:
+  typename InternalComplexImageType::Pointer m_TransferFunction;
+  typename FFTFilterType::Pointer            m_ForwardFFTFilter;
+  typename IFFTFilterType::Pointer           m_InverseFFTFilter;
+  MultiThreaderBase                         *m_MultiThreader{ nullptr };
+  unsigned int                               m_NumberOfWorkUnits{ 1 };
+};
+
+
+} // end namespace itk
+
+#endif // itkInPlaceDeconvolutionIterations_h
@@ -0,0 +1,137 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceDiffusionImageFilter_h
+#define itkInPlaceDiffusionImageFilter_h
+
+#include "itkCurvatureAnisotropicDiffusionImageFilter.h"
+#include "itkCurvatureFlowImageFilter.h"
+#include "itkExplicitDiffusionIterations.h"
+#include "itkExplicitDiffusionSchemes.h"
+#include "itkGradientAnisotropicDiffusionImageFilter.h"
+
+
+namespace itk {
+
+/** \class InPlaceDiffusionImageFilter
+ * \brief A diffusion filter with an explicit scheme updating two
+ * buffers in turn, and an optional early stop.
+ *
+ * With InPlaceIterations off, the default, the filter is the finite
+ * difference filter TSuperclass. With InPlaceIterations on, each
+ * iteration computes the updates of the scheme TScheme from one
+ * buffer and writes the updated image to the other buffer, in
+ * parallel over blocks of rows, as ExplicitDiffusionIterations. The
+ * output image is one of the buffers when the pixels are of the type
+ * of the iterations, and the input image is not copied when the
+ * filter runs in place. No update buffer is allocated at each
+ * iteration, and the threads are only synchronized once per
+ * iteration.
+ *
+ * With SinglePrecision on, the iterations are computed with float
+ * buffers for double images. With a positive MaximumRMSError, the
+ * iterations stop when the root mean square of the change of an
+ * iteration is below MaximumRMSError, and RMSChange and
+ * ElapsedIterations are those of the last iteration. Both options
+ * imply InPlaceIterations.
+ *
+ * The results are those of the superclass up to the rounding of the
+ * pixels.
+ *
+ * \sa ExplicitDiffusionIterations
+ * \sa GradientAnisotropicDiffusionScheme
+ * \sa CurvatureAnisotropicDiffusionScheme
+ * \sa CurvatureFlowScheme
+ */
+template < class TSuperclass, template < typename, unsigned int > class TScheme >
+class InPlaceDiffusionImageFilter:
+    public TSuperclass
+{
+public:
+  /** Standard Self type alias */
+  using Self = InPlaceDiffusionImageFilter;
+  using Superclass = TSuperclass;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using PixelType = typename Superclass::PixelType;
+
+  static constexpr unsigned int ImageDimension = OutputImageType::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(InPlaceDiffusionImageFilter, FiniteDifferenceImageFilter);
+
+  /** Update the buffers of the previous iteration with the explicit
+   * scheme. Off by default. */
+  itkSetMacro( InPlaceIterations, bool );
+  itkGetConstMacro( InPlaceIterations, bool );
+  itkBooleanMacro( InPlaceIterations );
+
+  /** Compute the iterations of double images with float
+   * buffers. Off by default. */
+  itkSetMacro( SinglePrecision, bool );
+  itkGetConstMacro( SinglePrecision, bool );
+  itkBooleanMacro( SinglePrecision );
+
+protected:
+
+  InPlaceDiffusionImageFilter() = default;
+
+  ~InPlaceDiffusionImageFilter() override = default;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  InPlaceDiffusionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  /** The iterations with TRealType buffers. */
+  template < typename TRealType >
+  void IterateInPlace();
+
+  bool m_InPlaceIterations{false};
+  bool m_SinglePrecision{false};
+};
+
+
+/** The diffusion filters of SimpleITK with the explicit schemes. */
+template < class TInputImage, class TOutputImage >
+using InPlaceGradientAnisotropicDiffusionImageFilter =
+  InPlaceDiffusionImageFilter< GradientAnisotropicDiffusionImageFilter< TInputImage, TOutputImage >, GradientAnisotropicDiffusionScheme >;
+
+template < class TInputImage, class TOutputImage >
+using InPlaceCurvatureAnisotropicDiffusionImageFilter =
+  InPlaceDiffusionImageFilter< CurvatureAnisotropicDiffusionImageFilter< TInputImage, TOutputImage >, CurvatureAnisotropicDiffusionScheme >;
+
+template < class TInputImage, class TOutputImage >
+using InPlaceCurvatureFlowImageFilter =
+  InPlaceDiffusionImageFilter< CurvatureFlowImageFilter< TInputImage, TOutputImage >, CurvatureFlowScheme >;
+
+
+} // end namespace itk
+
+
+#include "itkInPlaceDiffusionImageFilter.hxx"
+
+#endif // itkInPlaceDiffusionImageFilter_h
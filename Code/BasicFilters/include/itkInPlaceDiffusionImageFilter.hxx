@@ -0,0 +1,146 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceDiffusionImageFilter_hxx
+#define itkInPlaceDiffusionImageFilter_hxx
+
+#include "itkInPlaceDiffusionImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TSuperclass, template < typename, unsigned int > class TScheme >
+void
+InPlaceDiffusionImageFilter< TSuperclass, TScheme >::GenerateData()
+{
+  if ( !m_InPlaceIterations && !m_SinglePrecision && !( this->GetMaximumRMSError() > 0.0 ) )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  if ( m_SinglePrecision )
+    {
+    this->template IterateInPlace<float>();
+    }
+  else
+    {
+    this->template IterateInPlace<PixelType>();
+    }
+}
+
+
+//
+// IterateInPlace
+//
+template < class TSuperclass, template < typename, unsigned int > class TScheme >
+template < typename TRealType >
+void
+InPlaceDiffusionImageFilter< TSuperclass, TScheme >::IterateInPlace()
+{
+  using IterationsType = ExplicitDiffusionIterations< TRealType, ImageDimension >;
+
+  const InputImageType *input = this->GetInput();
+
+  // the output is the input when the filter runs in place
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const typename OutputImageType::RegionType region = output->GetBufferedRegion();
+
+  std::array< SizeValueType, ImageDimension > size;
+  typename IterationsType::ScalesType scales;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    size[d] = region.GetSize( d );
+    scales[d] = this->GetUseImageSpacing() ? 1.0 / output->GetSpacing()[d] : 1.0;
+    }
+
+  // the output buffer is the first buffer of the iterations when
+  // they have the type of the pixels
+  PixelType *outputBuffer = output->GetBufferPointer();
+  TRealType *firstBuffer = std::is_same< TRealType, PixelType >::value ? reinterpret_cast<TRealType *>( outputBuffer ) : nullptr;
+
+  IterationsType iterations;
+  iterations.Initialize( firstBuffer, size, scales, this->GetMultiThreader(), this->GetNumberOfWorkUnits() );
+
+  TRealType *current = iterations.GetCurrentBuffer();
+  if ( static_cast<const void *>( input->GetBufferPointer() ) != static_cast<const void *>( current ) )
+    {
+    ImageRegionConstIterator< InputImageType > inputIt( input, region );
+    for ( TRealType *pixel = current; !inputIt.IsAtEnd(); ++inputIt, ++pixel )
+      {
+      *pixel = static_cast<TRealType>( inputIt.Get() );
+      }
+    }
+
+  const unsigned int numberOfIterations = this->GetNumberOfIterations();
+  const TRealType timeStep = static_cast<TRealType>( this->GetTimeStep() );
+  TScheme< TRealType, ImageDimension > scheme;
+
+  this->SetElapsedIterations( 0 );
+  this->SetRMSChange( 0.0 );
+  this->UpdateProgress( 0.0f );
+  while ( this->GetElapsedIterations() < numberOfIterations && !this->GetAbortGenerateData() )
+    {
+    scheme.InitializeIteration( this, iterations, this->GetElapsedIterations() );
+    const double rmsChange = iterations.Iterate( scheme, timeStep );
+
+    this->SetRMSChange( rmsChange );
+    this->SetElapsedIterations( this->GetElapsedIterations() + 1 );
+    this->UpdateProgress( static_cast<float>( this->GetElapsedIterations() ) / static_cast<float>( numberOfIterations ) );
+    this->InvokeEvent( IterationEvent() );
+
+    if ( this->GetMaximumRMSError() > rmsChange )
+      {
+      break;
+      }
+    }
+
+  // the last iteration may be in the other buffer
+  current = iterations.GetCurrentBuffer();
+  if ( static_cast<const void *>( current ) != static_cast<const void *>( outputBuffer ) )
+    {
+    std::copy( current, current + iterations.GetNumberOfPixels(), outputBuffer );
+    }
+  iterations.Release();
+}
+
+
+//
+// PrintSelf
+//
+template < class TSuperclass, template < typename, unsigned int > class TScheme >
+void
+InPlaceDiffusionImageFilter< TSuperclass, TScheme >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "InPlaceIterations: " << m_InPlaceIterations << std::endl;
+  os << indent << "SinglePrecision: " << m_SinglePrecision << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkInPlaceDiffusionImageFilter_hxx
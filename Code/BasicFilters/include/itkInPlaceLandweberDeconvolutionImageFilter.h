@@ -0,0 +1,138 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceLandweberDeconvolutionImageFilter_h
+#define itkInPlaceLandweberDeconvolutionImageFilter_h
+
+#include "itkProjectedLandweberDeconvolutionImageFilter.h"
+#include "itkInPlaceDeconvolutionIterations.h"
+
+#include <type_traits>
+
+
+namespace itk {
+
+/** \class InPlaceLandweberDeconvolutionImageFilter
+ * \brief Landweber deconvolution with the buffers kept across the
+ * iterations.
+ *
+ * TSuperclass is the LandweberDeconvolutionImageFilter, or the
+ * ProjectedLandweberDeconvolutionImageFilter whose estimates are
+ * clamped to be non negative.
+ *
+ * With InPlaceIterations off, the default, the filter is the
+ * superclass. With InPlaceIterations on, each iteration is computed
+ * on the spectrum of the estimate: the transfer function times the
+ * spectrum of the input, and the squared modulus of the transfer
+ * function, are the same for all the iterations, so that an iteration
+ * has a single forward and a single inverse real-to-complex transform,
+ * and the pointwise steps update the buffers of the previous iteration
+ * in place.
+ *
+ * With a positive RelativeChangeThreshold, the iterations stop when
+ * the norm of the change of the estimate, relative to the norm of the
+ * estimate, is below the threshold. It implies InPlaceIterations.
+ *
+ * \sa LandweberDeconvolutionImageFilter
+ * \sa ProjectedLandweberDeconvolutionImageFilter
+ * \sa InPlaceDeconvolutionIterations
+ */
+template < class TInputImage, class TKernelImage = TInputImage, class TOutputImage = TInputImage, class TInternalPrecision = double,
+           class TSuperclass = LandweberDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision > >
+class InPlaceLandweberDeconvolutionImageFilter:
+    public TSuperclass
+{
+public:
+  /** Standard Self type alias */
+  using Self = InPlaceLandweberDeconvolutionImageFilter;
+  using Superclass = TSuperclass;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using IterativeDeconvolutionType = IterativeDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >;
+  using InternalImageType = typename Superclass::InternalImageType;
+  using InternalComplexImageType = typename Superclass::InternalComplexImageType;
+  using InternalPixelType = typename InternalImageType::PixelType;
+  using ComplexPixelType = typename InternalComplexImageType::PixelType;
+
+  /** Whether the estimates are clamped to be non negative. */
+  static constexpr bool Projected =
+    std::is_base_of< ProjectedLandweberDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >,
+                     TSuperclass >::value;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(InPlaceLandweberDeconvolutionImageFilter, LandweberDeconvolutionImageFilter);
+
+  /** Keep the transforms and the buffers across the iterations. Off
+   * by default. */
+  itkSetMacro( InPlaceIterations, bool );
+  itkGetConstMacro( InPlaceIterations, bool );
+  itkBooleanMacro( InPlaceIterations );
+
+  /** Stop when the relative change of the estimate is below the
+   * threshold. 0, which never stops, by default. */
+  itkSetMacro( RelativeChangeThreshold, double );
+  itkGetConstMacro( RelativeChangeThreshold, double );
+
+  /** The number of iterations of the last update. */
+  itkGetConstMacro( NumberOfElapsedIterations, unsigned int );
+
+protected:
+
+  InPlaceLandweberDeconvolutionImageFilter() = default;
+
+  ~InPlaceLandweberDeconvolutionImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The buffers of the iterations are allocated once.
+  void Initialize(ProgressAccumulator * progress, float progressWeight, float iterationProgressWeight) override;
+
+  void Iteration(ProgressAccumulator * progress, float iterationProgressWeight) override;
+
+  void Finish(ProgressAccumulator * progress, float progressWeight) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  InPlaceLandweberDeconvolutionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool         m_InPlaceIterations{false};
+  double       m_RelativeChangeThreshold{0.0};
+  unsigned int m_NumberOfElapsedIterations{0};
+
+  // the state of an update
+  bool m_UpdateInPlace{false};
+
+  InPlaceDeconvolutionIterations< InternalImageType, InternalComplexImageType > m_Iterations;
+
+  // the conjugate of the transfer function times the spectrum of the
+  // input
+  typename InternalComplexImageType::Pointer m_CorrelatedInput;
+};
+
+
+} // end namespace itk
+
+
+#include "itkInPlaceLandweberDeconvolutionImageFilter.hxx"
+
+#endif // itkInPlaceLandweberDeconvolutionImageFilter_h
@@ -0,0 +1,174 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceLandweberDeconvolutionImageFilter_hxx
+#define itkInPlaceLandweberDeconvolutionImageFilter_hxx
+
+#include "itkInPlaceLandweberDeconvolutionImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// Initialize
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision, class TSuperclass >
+void
+InPlaceLandweberDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision, TSuperclass >
+::Initialize(ProgressAccumulator * progress, float progressWeight, float iterationProgressWeight)
+{
+  m_NumberOfElapsedIterations = 0;
+  m_UpdateInPlace = m_InPlaceIterations || m_RelativeChangeThreshold > 0.0;
+  if ( !m_UpdateInPlace )
+    {
+    Superclass::Initialize( progress, progressWeight, iterationProgressWeight );
+    return;
+    }
+
+  // the current estimate starts as the padded input
+  IterativeDeconvolutionType::Initialize( progress, progressWeight, iterationProgressWeight );
+
+  // each iteration has a forward and an inverse transform
+  m_Iterations.Initialize( this->m_TransferFunction,
+                           this->GetXDimensionIsOdd(),
+                           this->GetMultiThreader(),
+                           this->GetNumberOfWorkUnits(),
+                           progress,
+                           0.5f * iterationProgressWeight );
+
+  const InternalComplexImageType *transformedInput = m_Iterations.Forward( this->m_CurrentEstimate );
+  m_CorrelatedInput = InternalComplexImageType::New();
+  m_CorrelatedInput->CopyInformation( transformedInput );
+  m_CorrelatedInput->SetRegions( transformedInput->GetBufferedRegion() );
+  m_CorrelatedInput->Allocate();
+
+  const ComplexPixelType *h = this->m_TransferFunction->GetBufferPointer();
+  const ComplexPixelType *y = transformedInput->GetBufferPointer();
+  ComplexPixelType *a = m_CorrelatedInput->GetBufferPointer();
+  m_Iterations.template ParallelizeBuffer<0>( transformedInput->GetBufferedRegion().GetNumberOfPixels(),
+                                              [=]( SizeValueType begin, SizeValueType end )
+    {
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        a[i] = std::conj( h[i] ) * y[i];
+        }
+      return std::array<double, 0>();
+    } );
+}
+
+
+//
+// Iteration
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision, class TSuperclass >
+void
+InPlaceLandweberDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision, TSuperclass >
+::Iteration(ProgressAccumulator * progress, float iterationProgressWeight)
+{
+  ++m_NumberOfElapsedIterations;
+  if ( !m_UpdateInPlace )
+    {
+    Superclass::Iteration( progress, iterationProgressWeight );
+    return;
+    }
+
+  // the spectrum of the estimate plus alpha times the correlation of
+  // the residual, conj(H) Y - |H|^2 X
+  InternalImageType *estimate = this->m_CurrentEstimate;
+  InternalComplexImageType *spectrum = m_Iterations.Forward( estimate );
+  ComplexPixelType *s = spectrum->GetBufferPointer();
+  const ComplexPixelType *h = this->m_TransferFunction->GetBufferPointer();
+  const ComplexPixelType *a = m_CorrelatedInput->GetBufferPointer();
+  const InternalPixelType alpha = static_cast<InternalPixelType>( this->GetAlpha() );
+  m_Iterations.template ParallelizeBuffer<0>( spectrum->GetBufferedRegion().GetNumberOfPixels(),
+                                              [=]( SizeValueType begin, SizeValueType end )
+    {
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        s[i] += alpha * ( a[i] - std::norm( h[i] ) * s[i] );
+        }
+      return std::array<double, 0>();
+    } );
+
+  // the next estimate, with the norms of its change and of the previous
+  // estimate
+  const InternalPixelType *updated = m_Iterations.Inverse( spectrum )->GetBufferPointer();
+  InternalPixelType *x = estimate->GetBufferPointer();
+  const std::array<double, 2> sums =
+    m_Iterations.template ParallelizeBuffer<2>( estimate->GetBufferedRegion().GetNumberOfPixels(),
+                                                [=]( SizeValueType begin, SizeValueType end )
+    {
+      std::array<double, 2> n{ { 0.0, 0.0 } };
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        const InternalPixelType value = Projected ? std::max( updated[i], InternalPixelType( 0 ) ) : updated[i];
+        n[0] += ( double( value ) - x[i] ) * ( double( value ) - x[i] );
+        n[1] += double( x[i] ) * x[i];
+        x[i] = value;
+        }
+      return n;
+    } );
+  estimate->Modified();
+
+  if ( m_RelativeChangeThreshold > 0.0 && std::sqrt( sums[0] ) < m_RelativeChangeThreshold * std::sqrt( sums[1] ) )
+    {
+    this->SetStopIteration( true );
+    }
+}
+
+
+//
+// Finish
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision, class TSuperclass >
+void
+InPlaceLandweberDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision, TSuperclass >
+::Finish(ProgressAccumulator * progress, float progressWeight)
+{
+  if ( !m_UpdateInPlace )
+    {
+    Superclass::Finish( progress, progressWeight );
+    return;
+    }
+
+  IterativeDeconvolutionType::Finish( progress, progressWeight );
+
+  m_Iterations.Release();
+  m_CorrelatedInput = nullptr;
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision, class TSuperclass >
+void
+InPlaceLandweberDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision, TSuperclass >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "InPlaceIterations: " << m_InPlaceIterations << std::endl;
+  os << indent << "RelativeChangeThreshold: " << m_RelativeChangeThreshold << std::endl;
+  os << indent << "NumberOfElapsedIterations: " << m_NumberOfElapsedIterations << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkInPlaceLandweberDeconvolutionImageFilter_hxx
@@ -0,0 +1,141 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceRichardsonLucyDeconvolutionImageFilter_h
+#define itkInPlaceRichardsonLucyDeconvolutionImageFilter_h
+
+#include "itkRichardsonLucyDeconvolutionImageFilter.h"
+#include "itkInPlaceDeconvolutionIterations.h"
+
+
+namespace itk {
+
+/** \class InPlaceRichardsonLucyDeconvolutionImageFilter
+ * \brief Richardson-Lucy deconvolution with the buffers kept across
+ * the iterations, and an optional acceleration.
+ *
+ * With InPlaceIterations off, the default, the filter is the
+ * RichardsonLucyDeconvolutionImageFilter. With InPlaceIterations on,
+ * each iteration convolves the estimate with the kernel and correlates
+ * the ratio of the input to the convolution with the kernel, through
+ * the same real-to-complex transforms and the transfer function of the
+ * first iteration, and the pointwise steps update the buffers of the
+ * previous iteration in place.
+ *
+ * With Acceleration on, the estimate is first extrapolated along the
+ * difference from the previous estimate, by the vector extrapolation
+ * of Biggs and Andrews, "Acceleration of iterative image restoration
+ * algorithms", Applied Optics 36(8), 1997, and clamped to be non
+ * negative. Fewer iterations are needed for the same estimate.
+ *
+ * With a positive RelativeChangeThreshold, the iterations stop when
+ * the norm of the change of the estimate, relative to the norm of the
+ * estimate, is below the threshold. Both options imply
+ * InPlaceIterations.
+ *
+ * \sa RichardsonLucyDeconvolutionImageFilter
+ * \sa InPlaceDeconvolutionIterations
+ */
+template < class TInputImage, class TKernelImage = TInputImage, class TOutputImage = TInputImage, class TInternalPrecision = double >
+class InPlaceRichardsonLucyDeconvolutionImageFilter:
+    public RichardsonLucyDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+{
+public:
+  /** Standard Self type alias */
+  using Self = InPlaceRichardsonLucyDeconvolutionImageFilter;
+  using Superclass = RichardsonLucyDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using IterativeDeconvolutionType = IterativeDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >;
+  using InternalImageType = typename Superclass::InternalImageType;
+  using InternalComplexImageType = typename Superclass::InternalComplexImageType;
+  using InternalPixelType = typename InternalImageType::PixelType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(InPlaceRichardsonLucyDeconvolutionImageFilter, RichardsonLucyDeconvolutionImageFilter);
+
+  /** Keep the transforms and the buffers across the iterations. Off
+   * by default. */
+  itkSetMacro( InPlaceIterations, bool );
+  itkGetConstMacro( InPlaceIterations, bool );
+  itkBooleanMacro( InPlaceIterations );
+
+  /** Extrapolate the estimate before each iteration. Off by
+   * default. */
+  itkSetMacro( Acceleration, bool );
+  itkGetConstMacro( Acceleration, bool );
+  itkBooleanMacro( Acceleration );
+
+  /** Stop when the relative change of the estimate is below the
+   * threshold. 0, which never stops, by default. */
+  itkSetMacro( RelativeChangeThreshold, double );
+  itkGetConstMacro( RelativeChangeThreshold, double );
+
+  /** The number of iterations of the last update. */
+  itkGetConstMacro( NumberOfElapsedIterations, unsigned int );
+
+protected:
+
+  InPlaceRichardsonLucyDeconvolutionImageFilter() = default;
+
+  ~InPlaceRichardsonLucyDeconvolutionImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The buffers of the iterations are allocated once.
+  void Initialize(ProgressAccumulator * progress, float progressWeight, float iterationProgressWeight) override;
+
+  void Iteration(ProgressAccumulator * progress, float iterationProgressWeight) override;
+
+  void Finish(ProgressAccumulator * progress, float progressWeight) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  InPlaceRichardsonLucyDeconvolutionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool         m_InPlaceIterations{false};
+  bool         m_Acceleration{false};
+  double       m_RelativeChangeThreshold{0.0};
+  unsigned int m_NumberOfElapsedIterations{0};
+
+  // the state of an update
+  bool   m_UpdateInPlace{false};
+  double m_AccelerationFactor{0.0};
+
+  InPlaceDeconvolutionIterations< InternalImageType, InternalComplexImageType > m_Iterations;
+
+  typename InternalImageType::Pointer m_PaddedInput;
+  typename InternalImageType::Pointer m_Ratio;
+  typename InternalImageType::Pointer m_Prediction;
+  typename InternalImageType::Pointer m_PreviousEstimate;
+  typename InternalImageType::Pointer m_Gradient;
+  typename InternalImageType::Pointer m_PreviousGradient;
+};
+
+
+} // end namespace itk
+
+
+#include "itkInPlaceRichardsonLucyDeconvolutionImageFilter.hxx"
+
+#endif // itkInPlaceRichardsonLucyDeconvolutionImageFilter_h
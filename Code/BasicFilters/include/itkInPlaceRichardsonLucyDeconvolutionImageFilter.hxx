@@ -0,0 +1,239 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkInPlaceRichardsonLucyDeconvolutionImageFilter_hxx
+#define itkInPlaceRichardsonLucyDeconvolutionImageFilter_hxx
+
+#include "itkInPlaceRichardsonLucyDeconvolutionImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// Initialize
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision >
+void
+InPlaceRichardsonLucyDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::Initialize(ProgressAccumulator * progress, float progressWeight, float iterationProgressWeight)
+{
+  m_NumberOfElapsedIterations = 0;
+  m_UpdateInPlace = m_InPlaceIterations || m_Acceleration || m_RelativeChangeThreshold > 0.0;
+  if ( !m_UpdateInPlace )
+    {
+    Superclass::Initialize( progress, progressWeight, iterationProgressWeight );
+    return;
+    }
+
+  // the current estimate starts as the padded input
+  IterativeDeconvolutionType::Initialize( progress, progressWeight, iterationProgressWeight );
+  const InternalImageType *estimate = this->m_CurrentEstimate;
+
+  // each iteration has two forward and two inverse transforms
+  m_Iterations.Initialize( this->m_TransferFunction,
+                           this->GetXDimensionIsOdd(),
+                           this->GetMultiThreader(),
+                           this->GetNumberOfWorkUnits(),
+                           progress,
+                           0.25f * iterationProgressWeight );
+
+  auto allocate = [estimate]()
+    {
+      typename InternalImageType::Pointer image = InternalImageType::New();
+      image->CopyInformation( estimate );
+      image->SetRegions( estimate->GetBufferedRegion() );
+      image->Allocate( true );
+      return image;
+    };
+
+  const SizeValueType n = estimate->GetBufferedRegion().GetNumberOfPixels();
+  m_PaddedInput = allocate();
+  std::copy( estimate->GetBufferPointer(), estimate->GetBufferPointer() + n, m_PaddedInput->GetBufferPointer() );
+  m_Ratio = allocate();
+  if ( m_Acceleration )
+    {
+    m_Prediction = allocate();
+    m_PreviousEstimate = allocate();
+    m_Gradient = allocate();
+    m_PreviousGradient = allocate();
+    }
+  m_AccelerationFactor = 0.0;
+}
+
+
+//
+// Iteration
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision >
+void
+InPlaceRichardsonLucyDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::Iteration(ProgressAccumulator * progress, float iterationProgressWeight)
+{
+  ++m_NumberOfElapsedIterations;
+  if ( !m_UpdateInPlace )
+    {
+    Superclass::Iteration( progress, iterationProgressWeight );
+    return;
+    }
+
+  // the threshold of the DivideOrZeroOutImageFilter of the superclass
+  const InternalPixelType divisionThreshold = static_cast<InternalPixelType>( 1e-5 );
+
+  InternalImageType *estimate = this->m_CurrentEstimate;
+  const SizeValueType n = estimate->GetBufferedRegion().GetNumberOfPixels();
+  InternalPixelType *x = estimate->GetBufferPointer();
+
+  // the extrapolated estimate
+  const InternalImageType *prediction = estimate;
+  if ( m_Acceleration )
+    {
+    InternalPixelType *p = m_Prediction->GetBufferPointer();
+    const InternalPixelType *previous = m_PreviousEstimate->GetBufferPointer();
+    const InternalPixelType alpha = static_cast<InternalPixelType>( m_AccelerationFactor );
+    m_Iterations.template ParallelizeBuffer<0>( n, [=]( SizeValueType begin, SizeValueType end )
+      {
+        for ( SizeValueType i = begin; i < end; ++i )
+          {
+          p[i] = std::max( x[i] + alpha * ( x[i] - previous[i] ), InternalPixelType( 0 ) );
+          }
+        return std::array<double, 0>();
+      } );
+    m_Prediction->Modified();
+    prediction = m_Prediction;
+    }
+  const InternalPixelType *p = prediction->GetBufferPointer();
+
+  // the ratio of the input to the convolution of the estimate
+  const InternalPixelType *y = m_PaddedInput->GetBufferPointer();
+  InternalPixelType *ratio = m_Ratio->GetBufferPointer();
+  const InternalPixelType *blurred = m_Iterations.Convolve( prediction, false )->GetBufferPointer();
+  m_Iterations.template ParallelizeBuffer<0>( n, [=]( SizeValueType begin, SizeValueType end )
+    {
+      for ( SizeValueType i = begin; i < end; ++i )
+        {
+        ratio[i] = ( std::abs( blurred[i] ) < divisionThreshold ) ? InternalPixelType( 0 ) : y[i] / blurred[i];
+        }
+      return std::array<double, 0>();
+    } );
+  m_Ratio->Modified();
+
+  // the estimate times the correlation of the ratio, with the norms of
+  // its change and of the previous estimate
+  const InternalPixelType *correction = m_Iterations.Convolve( m_Ratio, true )->GetBufferPointer();
+  double change = 0.0;
+  double norm = 0.0;
+  if ( m_Acceleration )
+    {
+    InternalPixelType *previous = m_PreviousEstimate->GetBufferPointer();
+    InternalPixelType *g = m_Gradient->GetBufferPointer();
+    InternalPixelType *previousG = m_PreviousGradient->GetBufferPointer();
+    const std::array<double, 4> sums = m_Iterations.template ParallelizeBuffer<4>( n, [=]( SizeValueType begin, SizeValueType end )
+      {
+        std::array<double, 4> s{ { 0.0, 0.0, 0.0, 0.0 } };
+        for ( SizeValueType i = begin; i < end; ++i )
+          {
+          const InternalPixelType updated = p[i] * correction[i];
+          previousG[i] = g[i];
+          g[i] = updated - p[i];
+          s[0] += double( g[i] ) * previousG[i];
+          s[1] += double( previousG[i] ) * previousG[i];
+          s[2] += ( double( updated ) - x[i] ) * ( double( updated ) - x[i] );
+          s[3] += double( x[i] ) * x[i];
+          previous[i] = x[i];
+          x[i] = updated;
+          }
+        return s;
+      } );
+
+    // the factor of the next extrapolation, from the last two changes
+    m_AccelerationFactor = ( sums[1] > 0.0 ) ? std::min( std::max( sums[0] / sums[1], 0.0 ), 0.999 ) : 0.0;
+    change = sums[2];
+    norm = sums[3];
+    }
+  else
+    {
+    const std::array<double, 2> sums = m_Iterations.template ParallelizeBuffer<2>( n, [=]( SizeValueType begin, SizeValueType end )
+      {
+        std::array<double, 2> s{ { 0.0, 0.0 } };
+        for ( SizeValueType i = begin; i < end; ++i )
+          {
+          const InternalPixelType updated = x[i] * correction[i];
+          s[0] += ( double( updated ) - x[i] ) * ( double( updated ) - x[i] );
+          s[1] += double( x[i] ) * x[i];
+          x[i] = updated;
+          }
+        return s;
+      } );
+    change = sums[0];
+    norm = sums[1];
+    }
+  estimate->Modified();
+
+  if ( m_RelativeChangeThreshold > 0.0 && std::sqrt( change ) < m_RelativeChangeThreshold * std::sqrt( norm ) )
+    {
+    this->SetStopIteration( true );
+    }
+}
+
+
+//
+// Finish
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision >
+void
+InPlaceRichardsonLucyDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::Finish(ProgressAccumulator * progress, float progressWeight)
+{
+  if ( !m_UpdateInPlace )
+    {
+    Superclass::Finish( progress, progressWeight );
+    return;
+    }
+
+  IterativeDeconvolutionType::Finish( progress, progressWeight );
+
+  m_Iterations.Release();
+  m_PaddedInput = nullptr;
+  m_Ratio = nullptr;
+  m_Prediction = nullptr;
+  m_PreviousEstimate = nullptr;
+  m_Gradient = nullptr;
+  m_PreviousGradient = nullptr;
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision >
+void
+InPlaceRichardsonLucyDeconvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "InPlaceIterations: " << m_InPlaceIterations << std::endl;
+  os << indent << "Acceleration: " << m_Acceleration << std::endl;
+  os << indent << "RelativeChangeThreshold: " << m_RelativeChangeThreshold << std::endl;
+  os << indent << "NumberOfElapsedIterations: " << m_NumberOfElapsedIterations << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkInPlaceRichardsonLucyDeconvolutionImageFilter_hxx
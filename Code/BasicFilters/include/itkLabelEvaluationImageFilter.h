@@ -0,0 +1,193 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkLabelEvaluationImageFilter_h
+#define itkLabelEvaluationImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <limits>
+#include <vector>
+
+
+namespace itk {
+
+/** \class LabelEvaluationImageFilter
+ * \brief Compute the overlap and surface distance measures of each
+ * label of a prediction against a reference label image, in a single
+ * evaluation.
+ *
+ * For each label of either image other than BackgroundValue, the
+ * Dice and Jaccard coefficients, the volume similarity, the Hausdorff
+ * distance, the 95th percentile of the Hausdorff distance and the
+ * average symmetric surface distance are computed, instead of running
+ * the LabelOverlapMeasuresImageFilter, the HausdorffDistanceImageFilter
+ * and distance maps for each label.
+ *
+ * The labels are first collected, then one traversal of the two images
+ * counts the pixels of each label in the reference, in the prediction
+ * and in both, and collects the surface pixels of the labels, the
+ * pixels with a face neighbor of another label, as with the
+ * LabelContourImageFilter, or on the border of the image. The
+ * distances between the surfaces of a label are then computed with an
+ * EuclideanDistanceMapImageFilter restricted to the bounding box of
+ * the surface of the label enlarged by MaximumDistance, so that the
+ * cost of a label is proportional to its extent and not to the size
+ * of the image. The labels are split between the threads.
+ *
+ * The volume similarity is one minus the absolute difference of the
+ * volumes over their sum, as defined by Taha and Hanbury, which is
+ * one for equal volumes, unlike the signed difference of the
+ * LabelOverlapMeasuresImageFilter. The distances are between the
+ * surfaces, in physical units with UseImageSpacing: the Hausdorff
+ * distance is the largest of the two directed distances, the 95th
+ * percentile is the largest of the linearly interpolated 95th
+ * percentiles of the distances from the surface pixels of each image
+ * to the other surface, and the average symmetric surface distance is
+ * the mean of the distances of both directions. A label missing from
+ * one of the images has infinite distances, and the distances larger
+ * than MaximumDistance are MaximumDistance.
+ *
+ * The results are stored in arrays indexed by the label position in
+ * GetLabels().
+ *
+ * The reference image is passed through to the output without a copy.
+ *
+ * Reference: A. A. Taha and A. Hanbury, "Metrics for evaluating 3D
+ * medical image segmentation: analysis, selection, and tool", BMC
+ * Medical Imaging, 15:29, 2015.
+ *
+ * \sa LabelOverlapMeasuresImageFilter, HausdorffDistanceImageFilter
+ */
+template < class TLabelImage >
+class LabelEvaluationImageFilter:
+    public ImageToImageFilter< TLabelImage, TLabelImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = LabelEvaluationImageFilter;
+  using Superclass = ImageToImageFilter< TLabelImage, TLabelImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using LabelImageType = TLabelImage;
+  using LabelPixelType = typename TLabelImage::PixelType;
+  using RegionType = typename TLabelImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TLabelImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(LabelEvaluationImageFilter, ImageToImageFilter);
+
+  /** Set/Get the reference image, the first input. */
+  void SetReferenceImage( const LabelImageType *image )
+  { this->SetInput( image ); }
+  const LabelImageType *GetReferenceImage() const
+  { return this->GetInput(); }
+
+  /** Set/Get the prediction image. */
+  itkSetInputMacro(PredictionImage, LabelImageType);
+  itkGetInputMacro(PredictionImage, LabelImageType);
+
+  /** The label which is not evaluated. 0 by default. */
+  itkSetMacro( BackgroundValue, LabelPixelType );
+  itkGetConstMacro( BackgroundValue, LabelPixelType );
+
+  /** Whether the distances are in physical units. On by default. */
+  itkSetMacro( UseImageSpacing, bool );
+  itkGetConstMacro( UseImageSpacing, bool );
+  itkBooleanMacro( UseImageSpacing );
+
+  /** The largest distance which is computed. By default the distances
+   * are not bounded. */
+  itkSetMacro( MaximumDistance, double );
+  itkGetConstMacro( MaximumDistance, double );
+
+  /** The sorted labels of the last update. */
+  const std::vector<LabelPixelType> &GetLabels() const
+  { return m_Labels; }
+
+  /** The measures of each label, at the index of the label position.
+   * @{
+   */
+  const std::vector<double> &GetDiceCoefficients() const
+  { return m_DiceCoefficients; }
+  const std::vector<double> &GetJaccardCoefficients() const
+  { return m_JaccardCoefficients; }
+  const std::vector<double> &GetVolumeSimilarities() const
+  { return m_VolumeSimilarities; }
+  const std::vector<double> &GetHausdorffDistances() const
+  { return m_HausdorffDistances; }
+  const std::vector<double> &GetHausdorffDistances95() const
+  { return m_HausdorffDistances95; }
+  const std::vector<double> &GetAverageSymmetricSurfaceDistances() const
+  { return m_AverageSymmetricSurfaceDistances; }
+  /** @} */
+
+protected:
+
+  LabelEvaluationImageFilter();
+
+  ~LabelEvaluationImageFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // The reference is passed through to the output, and the measures
+  // are computed by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its inputs
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  LabelEvaluationImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  /** The distances from the surface pixels at the offsets query to
+   * the nearest of the surface pixels at the offsets seeds, appended
+   * to distances. */
+  void ComputeSurfaceDistances( const std::vector<OffsetValueType> &query,
+                                const std::vector<OffsetValueType> &seeds,
+                                std::vector<float> &distances ) const;
+
+  LabelPixelType m_BackgroundValue{};
+  bool m_UseImageSpacing{true};
+  double m_MaximumDistance{std::numeric_limits<double>::infinity()};
+
+  std::vector<LabelPixelType> m_Labels;
+  std::vector<double>         m_DiceCoefficients;
+  std::vector<double>         m_JaccardCoefficients;
+  std::vector<double>         m_VolumeSimilarities;
+  std::vector<double>         m_HausdorffDistances;
+  std::vector<double>         m_HausdorffDistances95;
+  std::vector<double>         m_AverageSymmetricSurfaceDistances;
+};
+
+
+} // end namespace itk
+
+
+#include "itkLabelEvaluationImageFilter.hxx"
+
+#endif // itkLabelEvaluationImageFilter_h
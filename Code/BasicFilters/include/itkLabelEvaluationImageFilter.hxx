@@ -0,0 +1,483 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkLabelEvaluationImageFilter_hxx
+#define itkLabelEvaluationImageFilter_hxx
+
+#include "itkLabelEvaluationImageFilter.h"
+
+#include "itkEuclideanDistanceMapImageFilter.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineConstIterator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// Constructor
+//
+template < class TLabelImage >
+LabelEvaluationImageFilter< TLabelImage >::LabelEvaluationImageFilter()
+{
+  this->AddRequiredInputName( "PredictionImage" );
+}
+
+
+//
+// GenerateData
+//
+template < class TLabelImage >
+void
+LabelEvaluationImageFilter< TLabelImage >::GenerateData()
+{
+  using IndexType = typename RegionType::IndexType;
+
+  if ( m_MaximumDistance < 0.0 )
+    {
+    itkExceptionMacro( "The MaximumDistance " << m_MaximumDistance << " is negative!" );
+    }
+
+  const LabelImageType *reference = this->GetReferenceImage();
+  const LabelImageType *prediction = this->GetPredictionImage();
+
+  const RegionType region = reference->GetBufferedRegion();
+  if ( prediction->GetBufferedRegion() != region )
+    {
+    itkExceptionMacro( "The prediction region " << prediction->GetBufferedRegion()
+                       << " does not match the reference region " << region << "!" );
+    }
+
+  // the output is the reference, as the measures do not modify it
+  this->GetOutput()->Graft( const_cast<LabelImageType *>( reference ) );
+
+  // the parts of the image, each with its own accumulators
+  auto splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfWorkUnits(), 1u ) );
+  auto getPiece = [&]( SizeValueType piece )
+    {
+      RegionType pieceRegion = region;
+      splitter->GetSplit( static_cast<unsigned int>( piece ), numberOfPieces, pieceRegion );
+      return pieceRegion;
+    };
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // collect the labels of both images, which change little along the
+  // lines
+  std::vector< std::vector<LabelPixelType> > pieceLabels( numberOfPieces );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        std::vector<LabelPixelType> &labels = pieceLabels[piece];
+        size_t compacted = 0;
+        auto compact = [&labels, &compacted]()
+          {
+            std::sort( labels.begin(), labels.end() );
+            labels.erase( std::unique( labels.begin(), labels.end() ), labels.end() );
+            compacted = labels.size();
+          };
+
+        for ( const LabelImageType *image : { reference, prediction } )
+          {
+          ImageScanlineConstIterator<LabelImageType> it( image, getPiece( piece ) );
+          while ( !it.IsAtEnd() )
+            {
+            LabelPixelType last = it.Get();
+            labels.push_back( last );
+            while ( !it.IsAtEndOfLine() )
+              {
+              const LabelPixelType label = it.Get();
+              if ( label != last )
+                {
+                labels.push_back( label );
+                last = label;
+                }
+              ++it;
+              }
+            if ( labels.size() > 2 * compacted + 4096 )
+              {
+              compact();
+              }
+            it.NextLine();
+            }
+          }
+        compact();
+      },
+    nullptr );
+
+  this->m_Labels.clear();
+  for ( const std::vector<LabelPixelType> &labels : pieceLabels )
+    {
+    this->m_Labels.insert( this->m_Labels.end(), labels.begin(), labels.end() );
+    }
+  std::sort( this->m_Labels.begin(), this->m_Labels.end() );
+  this->m_Labels.erase( std::unique( this->m_Labels.begin(), this->m_Labels.end() ), this->m_Labels.end() );
+  this->m_Labels.erase( std::remove( this->m_Labels.begin(), this->m_Labels.end(), m_BackgroundValue ), this->m_Labels.end() );
+
+  const SizeValueType numberOfLabels = this->m_Labels.size();
+
+  // the position of a label, from a table when the labels are dense
+  // enough, or a binary search
+  std::vector<SizeValueType> table;
+  const LabelPixelType minimumLabel = numberOfLabels > 0 ? this->m_Labels.front() : LabelPixelType{};
+  if ( numberOfLabels > 0 )
+    {
+    const double range = static_cast<double>( this->m_Labels.back() ) - static_cast<double>( minimumLabel ) + 1.0;
+    if ( range <= 4.0 * numberOfLabels + 65536.0 )
+      {
+      table.resize( static_cast<SizeValueType>( range ) );
+      for ( SizeValueType i = 0; i < numberOfLabels; ++i )
+        {
+        table[static_cast<SizeValueType>( this->m_Labels[i] - minimumLabel )] = i;
+        }
+      }
+    }
+  auto position = [this, &table, minimumLabel]( LabelPixelType label ) -> SizeValueType
+    {
+      if ( !table.empty() )
+        {
+        return table[static_cast<SizeValueType>( label - minimumLabel )];
+        }
+      return std::lower_bound( this->m_Labels.begin(), this->m_Labels.end(), label ) - this->m_Labels.begin();
+    };
+
+  // whether the pixel at offset of index, of the label value, has a
+  // face neighbor of another label or is on the border of the image
+  const typename RegionType::IndexType first = region.GetIndex();
+  const typename RegionType::IndexType last = region.GetUpperIndex();
+  const OffsetValueType *strides = reference->GetOffsetTable();
+  auto isSurface = [&first, &last, strides]( const LabelPixelType *buffer, OffsetValueType offset, const IndexType &index )
+    {
+      const LabelPixelType value = buffer[offset];
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        if ( index[d] == first[d] || index[d] == last[d]
+             || buffer[offset - strides[d]] != value || buffer[offset + strides[d]] != value )
+          {
+          return true;
+          }
+        }
+      return false;
+    };
+
+  struct Accumulators
+  {
+    std::vector<SizeValueType> referenceCounts;
+    std::vector<SizeValueType> predictionCounts;
+    std::vector<SizeValueType> intersectionCounts;
+    std::vector< std::vector<OffsetValueType> > referenceSurfaces;
+    std::vector< std::vector<OffsetValueType> > predictionSurfaces;
+  };
+  std::vector<Accumulators> pieceAccumulators( numberOfPieces );
+
+  // count the pixels of the labels, and collect their surfaces
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        Accumulators &accumulators = pieceAccumulators[piece];
+        accumulators.referenceCounts.assign( numberOfLabels, 0 );
+        accumulators.predictionCounts.assign( numberOfLabels, 0 );
+        accumulators.intersectionCounts.assign( numberOfLabels, 0 );
+        accumulators.referenceSurfaces.resize( numberOfLabels );
+        accumulators.predictionSurfaces.resize( numberOfLabels );
+
+        const RegionType pieceRegion = getPiece( piece );
+        const SizeValueType lineLength = pieceRegion.GetSize( 0 );
+        const LabelPixelType *referenceBuffer = reference->GetBufferPointer();
+        const LabelPixelType *predictionBuffer = prediction->GetBufferPointer();
+
+        ImageScanlineConstIterator<LabelImageType> it( reference, pieceRegion );
+        while ( !it.IsAtEnd() )
+          {
+          IndexType index = it.GetIndex();
+          const IndexValueType x0 = index[0];
+          const OffsetValueType lineOffset = reference->ComputeOffset( index );
+
+          LabelPixelType lastReference = m_BackgroundValue;
+          LabelPixelType lastPrediction = m_BackgroundValue;
+          SizeValueType referencePosition = 0;
+          SizeValueType predictionPosition = 0;
+          for ( SizeValueType x = 0; x < lineLength; ++x )
+            {
+            const OffsetValueType offset = lineOffset + static_cast<OffsetValueType>( x );
+            index[0] = x0 + static_cast<IndexValueType>( x );
+
+            const LabelPixelType referenceLabel = referenceBuffer[offset];
+            if ( referenceLabel != m_BackgroundValue )
+              {
+              if ( referenceLabel != lastReference )
+                {
+                referencePosition = position( referenceLabel );
+                lastReference = referenceLabel;
+                }
+              ++accumulators.referenceCounts[referencePosition];
+              if ( isSurface( referenceBuffer, offset, index ) )
+                {
+                accumulators.referenceSurfaces[referencePosition].push_back( offset );
+                }
+              }
+
+            const LabelPixelType predictionLabel = predictionBuffer[offset];
+            if ( predictionLabel != m_BackgroundValue )
+              {
+              if ( predictionLabel != lastPrediction )
+                {
+                predictionPosition = position( predictionLabel );
+                lastPrediction = predictionLabel;
+                }
+              ++accumulators.predictionCounts[predictionPosition];
+              if ( predictionLabel == referenceLabel )
+                {
+                ++accumulators.intersectionCounts[predictionPosition];
+                }
+              if ( isSurface( predictionBuffer, offset, index ) )
+                {
+                accumulators.predictionSurfaces[predictionPosition].push_back( offset );
+                }
+              }
+            }
+          it.NextLine();
+          }
+      },
+    nullptr );
+
+  // sum the counts of the pieces, and join their surfaces in the order
+  // of the pieces
+  Accumulators total;
+  total.referenceCounts.assign( numberOfLabels, 0 );
+  total.predictionCounts.assign( numberOfLabels, 0 );
+  total.intersectionCounts.assign( numberOfLabels, 0 );
+  total.referenceSurfaces.resize( numberOfLabels );
+  total.predictionSurfaces.resize( numberOfLabels );
+  for ( Accumulators &accumulators : pieceAccumulators )
+    {
+    for ( SizeValueType i = 0; i < numberOfLabels; ++i )
+      {
+      total.referenceCounts[i] += accumulators.referenceCounts[i];
+      total.predictionCounts[i] += accumulators.predictionCounts[i];
+      total.intersectionCounts[i] += accumulators.intersectionCounts[i];
+      total.referenceSurfaces[i].insert( total.referenceSurfaces[i].end(),
+                                         accumulators.referenceSurfaces[i].begin(),
+                                         accumulators.referenceSurfaces[i].end() );
+      total.predictionSurfaces[i].insert( total.predictionSurfaces[i].end(),
+                                          accumulators.predictionSurfaces[i].begin(),
+                                          accumulators.predictionSurfaces[i].end() );
+      }
+    accumulators = Accumulators();
+    }
+
+  const double infinity = std::numeric_limits<double>::infinity();
+  this->m_DiceCoefficients.assign( numberOfLabels, 0.0 );
+  this->m_JaccardCoefficients.assign( numberOfLabels, 0.0 );
+  this->m_VolumeSimilarities.assign( numberOfLabels, 0.0 );
+  this->m_HausdorffDistances.assign( numberOfLabels, infinity );
+  this->m_HausdorffDistances95.assign( numberOfLabels, infinity );
+  this->m_AverageSymmetricSurfaceDistances.assign( numberOfLabels, infinity );
+
+  for ( SizeValueType i = 0; i < numberOfLabels; ++i )
+    {
+    const double referenceCount = static_cast<double>( total.referenceCounts[i] );
+    const double predictionCount = static_cast<double>( total.predictionCounts[i] );
+    const double intersectionCount = static_cast<double>( total.intersectionCounts[i] );
+    const double sum = referenceCount + predictionCount;
+    this->m_DiceCoefficients[i] = 2.0 * intersectionCount / sum;
+    this->m_JaccardCoefficients[i] = intersectionCount / ( sum - intersectionCount );
+    this->m_VolumeSimilarities[i] = 1.0 - std::abs( referenceCount - predictionCount ) / sum;
+    }
+
+  // the 95th percentile of the distances, which are reordered
+  auto percentile95 = []( std::vector<float> &distances )
+    {
+      const double rank = 0.95 * static_cast<double>( distances.size() - 1 );
+      const size_t below = static_cast<size_t>( rank );
+      std::nth_element( distances.begin(), distances.begin() + below, distances.end() );
+      const double lower = distances[below];
+      if ( below + 1 == distances.size() )
+        {
+        return lower;
+        }
+      const double upper = *std::min_element( distances.begin() + below + 1, distances.end() );
+      return lower + ( rank - static_cast<double>( below ) ) * ( upper - lower );
+    };
+
+  // the surface distances of each label, with the labels split
+  // between the threads
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfLabels,
+    [&]( SizeValueType i )
+      {
+        const std::vector<OffsetValueType> &referenceSurface = total.referenceSurfaces[i];
+        const std::vector<OffsetValueType> &predictionSurface = total.predictionSurfaces[i];
+        if ( referenceSurface.empty() || predictionSurface.empty() )
+          {
+          return;
+          }
+
+        std::vector<float> referenceDistances;
+        std::vector<float> predictionDistances;
+        this->ComputeSurfaceDistances( referenceSurface, predictionSurface, referenceDistances );
+        this->ComputeSurfaceDistances( predictionSurface, referenceSurface, predictionDistances );
+
+        double sum = 0.0;
+        double maximum = 0.0;
+        for ( const std::vector<float> *distances : { &referenceDistances, &predictionDistances } )
+          {
+          for ( float distance : *distances )
+            {
+            sum += distance;
+            maximum = std::max( maximum, static_cast<double>( distance ) );
+            }
+          }
+
+        this->m_HausdorffDistances[i] = maximum;
+        this->m_AverageSymmetricSurfaceDistances[i] =
+          sum / static_cast<double>( referenceDistances.size() + predictionDistances.size() );
+        this->m_HausdorffDistances95[i] = std::max( percentile95( referenceDistances ),
+                                                    percentile95( predictionDistances ) );
+      },
+    this );
+}
+
+
+//
+// ComputeSurfaceDistances
+//
+template < class TLabelImage >
+void
+LabelEvaluationImageFilter< TLabelImage >::ComputeSurfaceDistances( const std::vector<OffsetValueType> &query,
+                                                                    const std::vector<OffsetValueType> &seeds,
+                                                                    std::vector<float> &distances ) const
+{
+  using IndexType = typename RegionType::IndexType;
+  using SeedImageType = Image<uint8_t, ImageDimension>;
+  using DistanceImageType = Image<float, ImageDimension>;
+  using DistanceFilterType = EuclideanDistanceMapImageFilter<SeedImageType, DistanceImageType>;
+
+  const LabelImageType *reference = this->GetReferenceImage();
+  const RegionType region = reference->GetBufferedRegion();
+
+  auto boundingBox = [reference]( const std::vector<OffsetValueType> &offsets, IndexType &lower, IndexType &upper )
+    {
+      lower = upper = reference->ComputeIndex( offsets.front() );
+      for ( OffsetValueType offset : offsets )
+        {
+        const IndexType index = reference->ComputeIndex( offset );
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          lower[d] = std::min( lower[d], index[d] );
+          upper[d] = std::max( upper[d], index[d] );
+          }
+        }
+    };
+
+  IndexType queryLower, queryUpper, seedsLower, seedsUpper;
+  boundingBox( query, queryLower, queryUpper );
+  boundingBox( seeds, seedsLower, seedsUpper );
+
+  // the bounding box of the query, enlarged by the maximum distance
+  // within the bounding box of both surfaces, holds the nearest seeds
+  // closer than the maximum distance
+  IndexType lower, upper;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const double spacing = m_UseImageSpacing ? reference->GetSpacing()[d] : 1.0;
+    const double radius = std::ceil( m_MaximumDistance / spacing );
+    const IndexValueType margin = ( radius < static_cast<double>( region.GetSize( d ) ) )
+                                  ? static_cast<IndexValueType>( radius )
+                                  : static_cast<IndexValueType>( region.GetSize( d ) );
+    lower[d] = std::max( std::min( queryLower[d], seedsLower[d] ), queryLower[d] - margin );
+    upper[d] = std::min( std::max( queryUpper[d], seedsUpper[d] ), queryUpper[d] + margin );
+    }
+  RegionType domain;
+  domain.SetIndex( lower );
+  domain.SetUpperIndex( upper );
+
+  auto seedImage = SeedImageType::New();
+  seedImage->CopyInformation( reference );
+  seedImage->SetRegions( domain );
+  seedImage->Allocate( true );
+  for ( OffsetValueType offset : seeds )
+    {
+    const IndexType index = reference->ComputeIndex( offset );
+    if ( domain.IsInside( index ) )
+      {
+      seedImage->SetPixel( index, 1 );
+      }
+    }
+
+  // the labels are split between the threads, so each distance map is
+  // computed by the calling thread
+  auto distanceFilter = DistanceFilterType::New();
+  distanceFilter->SetInput( seedImage );
+  distanceFilter->SetUseImageSpacing( m_UseImageSpacing );
+  if ( std::isfinite( m_MaximumDistance ) )
+    {
+    distanceFilter->SetMaximumDistance( m_MaximumDistance );
+    }
+  distanceFilter->SetNumberOfWorkUnits( 1 );
+  distanceFilter->Update();
+
+  const DistanceImageType *distanceMap = distanceFilter->GetOutput();
+  distances.reserve( distances.size() + query.size() );
+  for ( OffsetValueType offset : query )
+    {
+    distances.push_back( distanceMap->GetPixel( reference->ComputeIndex( offset ) ) );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TLabelImage >
+void
+LabelEvaluationImageFilter< TLabelImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+
+  // set the output region to the largest and let the pipeline
+  // propagate the requested region to the inputs
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TLabelImage >
+void
+LabelEvaluationImageFilter< TLabelImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BackgroundValue: " << static_cast<typename NumericTraits<LabelPixelType>::PrintType>( m_BackgroundValue ) << std::endl;
+  os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
+  os << indent << "MaximumDistance: " << m_MaximumDistance << std::endl;
+  os << indent << "NumberOfLabels: " << m_Labels.size() << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkLabelEvaluationImageFilter_hxx
@@ -0,0 +1,151 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkLabelImageToSelectiveShapeLabelMapFilter_h
+#define itkLabelImageToSelectiveShapeLabelMapFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkShapeLabelMapFilter.h"
+#include "itkShapeLabelObject.h"
+
+
+namespace itk {
+
+/** \class LabelImageToSelectiveShapeLabelMapFilter
+ * \brief Convert a label image to a label map and valuate only the
+ * requested shape attributes.
+ *
+ * This filter is a LabelImageToShapeLabelMapFilter with one more
+ * attribute group. When ComputeMoments, ComputePerimeter,
+ * ComputeFeretDiameter and ComputeOrientedBoundingBox are all off,
+ * the ShapeLabelMapFilter is not run. Only the attributes which are
+ * computed from the lines of the label objects are valuated: the
+ * number of pixels, the physical size, the centroid, the bounding box,
+ * the number of pixels and the perimeter on the border, and the
+ * equivalent spherical radius and perimeter. The label objects are
+ * valuated in parallel, and the other attributes are left to 0.
+ *
+ * Otherwise the filter is the same as LabelImageToShapeLabelMapFilter:
+ * the perimeter, the Feret diameter and the oriented bounding box are
+ * computed by the ShapeLabelMapFilter, which always computes the
+ * moments.
+ *
+ * \sa LabelImageToShapeLabelMapFilter, ShapeLabelMapFilter
+ */
+template < class TInputImage,
+           class TOutputImage = LabelMap< ShapeLabelObject< SizeValueType, TInputImage::ImageDimension > > >
+class LabelImageToSelectiveShapeLabelMapFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = LabelImageToSelectiveShapeLabelMapFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using InputImagePixelType = typename InputImageType::PixelType;
+  using OutputImageType = TOutputImage;
+  using OutputImagePixelType = typename OutputImageType::PixelType;
+  using LabelObjectType = typename OutputImageType::LabelObjectType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  using LabelizerType = LabelImageToLabelMapFilter< InputImageType, OutputImageType >;
+  using LabelObjectValuatorType = ShapeLabelMapFilter< OutputImageType, InputImageType >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(LabelImageToSelectiveShapeLabelMapFilter, ImageToImageFilter);
+
+  /** Set/Get the value used as "background" in the output image.
+   * Defaults to NumericTraits<PixelType>::NonpositiveMin(). */
+  itkSetMacro( BackgroundValue, OutputImagePixelType );
+  itkGetConstMacro( BackgroundValue, OutputImagePixelType );
+
+  /** Set/Get whether the central moments and the attributes computed
+   * from them should be computed: the principal moments and axes, the
+   * elongation, the flatness and the equivalent ellipsoid diameter.
+   * Default value is true. */
+  itkSetMacro( ComputeMoments, bool );
+  itkGetConstReferenceMacro( ComputeMoments, bool );
+  itkBooleanMacro( ComputeMoments );
+
+  /** Set/Get whether the maximum Feret diameter should be computed or
+   * not. Default value is false. */
+  itkSetMacro( ComputeFeretDiameter, bool );
+  itkGetConstReferenceMacro( ComputeFeretDiameter, bool );
+  itkBooleanMacro( ComputeFeretDiameter );
+
+  /** Set/Get whether the perimeter, the roundness and the perimeter on
+   * border ratio should be computed or not. Default value is false. */
+  itkSetMacro( ComputePerimeter, bool );
+  itkGetConstReferenceMacro( ComputePerimeter, bool );
+  itkBooleanMacro( ComputePerimeter );
+
+  /** Set/Get whether the oriented bounding box should be computed or
+   * not. Default value is false. */
+  itkSetMacro( ComputeOrientedBoundingBox, bool );
+  itkGetConstReferenceMacro( ComputeOrientedBoundingBox, bool );
+  itkBooleanMacro( ComputeOrientedBoundingBox );
+
+protected:
+
+  LabelImageToSelectiveShapeLabelMapFilter();
+
+  ~LabelImageToSelectiveShapeLabelMapFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // Request the largest possible region of the input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  void GenerateData() override;
+
+  /** Valuate the attributes computed from the lines of a label
+   * object of the label map. */
+  static void ComputeLineAttributes( const OutputImageType *labelMap, LabelObjectType *labelObject );
+
+private:
+  LabelImageToSelectiveShapeLabelMapFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  OutputImagePixelType m_BackgroundValue;
+  bool                 m_ComputeMoments;
+  bool                 m_ComputeFeretDiameter;
+  bool                 m_ComputePerimeter;
+  bool                 m_ComputeOrientedBoundingBox;
+};
+
+
+} // end namespace itk
+
+
+#include "itkLabelImageToSelectiveShapeLabelMapFilter.hxx"
+
+#endif // itkLabelImageToSelectiveShapeLabelMapFilter_h
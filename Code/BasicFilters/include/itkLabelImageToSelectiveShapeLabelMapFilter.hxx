@@ -0,0 +1,313 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkLabelImageToSelectiveShapeLabelMapFilter_hxx
+#define itkLabelImageToSelectiveShapeLabelMapFilter_hxx
+
+#include "itkLabelImageToSelectiveShapeLabelMapFilter.h"
+
+#include "itkContinuousIndex.h"
+#include "itkGeometryUtilities.h"
+#include "itkProgressAccumulator.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk {
+
+//
+// Constructor
+//
+template < class TInputImage, class TOutputImage >
+LabelImageToSelectiveShapeLabelMapFilter< TInputImage, TOutputImage >::LabelImageToSelectiveShapeLabelMapFilter()
+{
+  this->m_BackgroundValue = NumericTraits<OutputImagePixelType>::NonpositiveMin();
+  this->m_ComputeMoments = true;
+  this->m_ComputeFeretDiameter = false;
+  this->m_ComputePerimeter = false;
+  this->m_ComputeOrientedBoundingBox = false;
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+LabelImageToSelectiveShapeLabelMapFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  // call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  // We need all the input.
+  InputImageType *input = const_cast<InputImageType *>( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+LabelImageToSelectiveShapeLabelMapFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetOutput()->SetRequestedRegion( this->GetOutput()->GetLargestPossibleRegion() );
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+LabelImageToSelectiveShapeLabelMapFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  // Create a process accumulator for tracking the progress of this minipipeline
+  typename ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter(this);
+
+  // Allocate the output
+  this->AllocateOutputs();
+
+  const bool onlyLineAttributes = !( this->m_ComputeMoments || this->m_ComputePerimeter
+                                     || this->m_ComputeFeretDiameter || this->m_ComputeOrientedBoundingBox );
+
+  typename LabelizerType::Pointer labelizer = LabelizerType::New();
+  labelizer->SetInput( this->GetInput() );
+  labelizer->SetBackgroundValue( this->m_BackgroundValue );
+  labelizer->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  progress->RegisterInternalFilter( labelizer, onlyLineAttributes ? 1.0f : .5f );
+
+  if ( onlyLineAttributes )
+    {
+    labelizer->GraftOutput( this->GetOutput() );
+    labelizer->Update();
+    this->GraftOutput( labelizer->GetOutput() );
+
+    // the label objects are independent, and valuated in parallel
+    OutputImageType *output = this->GetOutput();
+    std::vector<LabelObjectType *> labelObjects;
+    labelObjects.reserve( output->GetNumberOfLabelObjects() );
+    for ( typename OutputImageType::Iterator it( output ); !it.IsAtEnd(); ++it )
+      {
+      labelObjects.push_back( it.GetLabelObject() );
+      }
+
+    this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      labelObjects.size(),
+      [output, &labelObjects]( SizeValueType i ) { Self::ComputeLineAttributes( output, labelObjects[i] ); },
+      nullptr );
+    return;
+    }
+
+  typename LabelObjectValuatorType::Pointer valuator = LabelObjectValuatorType::New();
+  valuator->SetInput( labelizer->GetOutput() );
+  valuator->SetLabelImage( this->GetInput() );
+  valuator->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  valuator->SetComputePerimeter( this->m_ComputePerimeter );
+  valuator->SetComputeFeretDiameter( this->m_ComputeFeretDiameter );
+  valuator->SetComputeOrientedBoundingBox( this->m_ComputeOrientedBoundingBox );
+  progress->RegisterInternalFilter( valuator, .5f );
+
+  valuator->GraftOutput( this->GetOutput() );
+  valuator->Update();
+  this->GraftOutput( valuator->GetOutput() );
+}
+
+
+//
+// ComputeLineAttributes
+//
+// The same computations as the ShapeLabelMapFilter, from the lines
+// and without the moments.
+//
+template < class TInputImage, class TOutputImage >
+void
+LabelImageToSelectiveShapeLabelMapFilter< TInputImage, TOutputImage >::ComputeLineAttributes( const OutputImageType *labelMap,
+                                                                                              LabelObjectType *labelObject )
+{
+  using IndexType = typename OutputImageType::IndexType;
+  using RegionType = typename OutputImageType::RegionType;
+
+  const RegionType &largestRegion = labelMap->GetLargestPossibleRegion();
+  const IndexType borderMin = largestRegion.GetIndex();
+  IndexType borderMax = borderMin;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    borderMax[i] += static_cast<OffsetValueType>( largestRegion.GetSize(i) ) - 1;
+    }
+
+  // the size of a pixel, and of its faces
+  const typename OutputImageType::SpacingType &spacing = labelMap->GetSpacing();
+  double sizePerPixel = 1.0;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    sizePerPixel *= spacing[i];
+    }
+  std::vector<double> sizePerPixelPerDimension;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    sizePerPixelPerDimension.push_back( sizePerPixel / spacing[i] );
+    }
+
+  IndexType mins;
+  mins.Fill( NumericTraits<IndexValueType>::max() );
+  IndexType maxs;
+  maxs.Fill( NumericTraits<IndexValueType>::NonpositiveMin() );
+  ContinuousIndex<double, ImageDimension> centroid;
+  centroid.Fill( 0.0 );
+  SizeValueType numberOfPixels = 0;
+  SizeValueType numberOfPixelsOnBorder = 0;
+  double perimeterOnBorder = 0.0;
+
+  for ( SizeValueType l = 0; l < labelObject->GetNumberOfLines(); ++l )
+    {
+    const typename LabelObjectType::LineType &line = labelObject->GetLine( l );
+    const IndexType &idx = line.GetIndex();
+    const SizeValueType length = line.GetLength();
+    const IndexValueType last = idx[0] + static_cast<OffsetValueType>( length ) - 1;
+
+    numberOfPixels += length;
+
+    // the bounding box
+    mins[0] = std::min( mins[0], idx[0] );
+    maxs[0] = std::max( maxs[0], last );
+    for ( unsigned int i = 1; i < ImageDimension; ++i )
+      {
+      mins[i] = std::min( mins[i], idx[i] );
+      maxs[i] = std::max( maxs[i], idx[i] );
+      }
+
+    // the sum of the indexes of the line
+    centroid[0] += length * ( static_cast<double>( idx[0] ) + 0.5 * ( length - 1 ) );
+    for ( unsigned int i = 1; i < ImageDimension; ++i )
+      {
+      centroid[i] += static_cast<double>( length ) * idx[i];
+      }
+
+    // the pixels on the border
+    bool isOnBorder = false;
+    for ( unsigned int i = 1; i < ImageDimension; ++i )
+      {
+      if ( idx[i] == borderMin[i] || idx[i] == borderMax[i] )
+        {
+        isOnBorder = true;
+        break;
+        }
+      }
+    if ( isOnBorder )
+      {
+      // the line touches a border on a dimension other than 0, so
+      // all the line touches a border
+      numberOfPixelsOnBorder += length;
+      }
+    else
+      {
+      // only the ends of the line can touch the border of dimension 0
+      bool isOnBorder0 = false;
+      if ( idx[0] == borderMin[0] )
+        {
+        ++numberOfPixelsOnBorder;
+        isOnBorder0 = true;
+        }
+      if ( ( !isOnBorder0 || length > 1 ) && last == borderMax[0] )
+        {
+        ++numberOfPixelsOnBorder;
+        }
+      }
+
+    // the physical size on the border
+    if ( idx[0] == borderMin[0] )
+      {
+      perimeterOnBorder += sizePerPixelPerDimension[0];
+      }
+    if ( last == borderMax[0] )
+      {
+      perimeterOnBorder += sizePerPixelPerDimension[0];
+      }
+    for ( unsigned int i = 1; i < ImageDimension; ++i )
+      {
+      if ( idx[i] == borderMin[i] )
+        {
+        perimeterOnBorder += sizePerPixelPerDimension[i] * length;
+        }
+      if ( idx[i] == borderMax[i] )
+        {
+        perimeterOnBorder += sizePerPixelPerDimension[i] * length;
+        }
+      }
+    }
+
+  RegionType boundingBox;
+  boundingBox.SetIndex( mins );
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    boundingBox.SetSize( i, ( numberOfPixels > 0 ) ? static_cast<SizeValueType>( maxs[i] - mins[i] + 1 ) : 0 );
+    }
+
+  typename LabelObjectType::CentroidType physicalCentroid;
+  physicalCentroid.Fill( 0.0 );
+  if ( numberOfPixels > 0 )
+    {
+    for ( unsigned int i = 0; i < ImageDimension; ++i )
+      {
+      centroid[i] /= numberOfPixels;
+      }
+    labelMap->TransformContinuousIndexToPhysicalPoint( centroid, physicalCentroid );
+    }
+
+  const double physicalSize = numberOfPixels * sizePerPixel;
+  const double equivalentSphericalRadius = GeometryUtilities::HyperSphereRadiusFromVolume( ImageDimension, physicalSize );
+
+  labelObject->SetNumberOfPixels( numberOfPixels );
+  labelObject->SetPhysicalSize( physicalSize );
+  labelObject->SetCentroid( physicalCentroid );
+  labelObject->SetBoundingBox( boundingBox );
+  labelObject->SetNumberOfPixelsOnBorder( numberOfPixelsOnBorder );
+  labelObject->SetPerimeterOnBorder( perimeterOnBorder );
+  labelObject->SetEquivalentSphericalRadius( equivalentSphericalRadius );
+  labelObject->SetEquivalentSphericalPerimeter( GeometryUtilities::HyperSpherePerimeter( ImageDimension, equivalentSphericalRadius ) );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+LabelImageToSelectiveShapeLabelMapFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BackgroundValue: "
+     << static_cast<typename NumericTraits<OutputImagePixelType>::PrintType>( m_BackgroundValue ) << std::endl;
+  os << indent << "ComputeMoments: " << m_ComputeMoments << std::endl;
+  os << indent << "ComputeFeretDiameter: " << m_ComputeFeretDiameter << std::endl;
+  os << indent << "ComputePerimeter: " << m_ComputePerimeter << std::endl;
+  os << indent << "ComputeOrientedBoundingBox: " << m_ComputeOrientedBoundingBox << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkLabelImageToSelectiveShapeLabelMapFilter_hxx
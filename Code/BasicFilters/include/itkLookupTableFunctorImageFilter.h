@@ -0,0 +1,90 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkLookupTableFunctorImageFilter_h
+#define itkLookupTableFunctorImageFilter_h
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class LookupTableFunctorImageFilter
+ * \brief Apply the functor of a unary functor filter through a lookup
+ * table of all the input values.
+ *
+ * For the integer inputs of at most 16 bits, with more pixels than
+ * values, the functor of the superclass is evaluated once for each
+ * value after BeforeThreadedGenerateData has set it, and the pixels
+ * are mapped through the table. The output is the same as the output
+ * of the superclass, which is used for the other inputs.
+ *
+ * \sa UnaryFunctorImageFilter
+ */
+template < class TSuperclass >
+class LookupTableFunctorImageFilter:
+    public TSuperclass
+{
+public:
+  /** Standard Self type alias */
+  using Self = LookupTableFunctorImageFilter;
+  using Superclass = TSuperclass;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using InputPixelType = typename InputImageType::PixelType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using InputImageRegionType = typename InputImageType::RegionType;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(LookupTableFunctorImageFilter, UnaryFunctorImageFilter);
+
+protected:
+
+  LookupTableFunctorImageFilter() = default;
+
+  ~LookupTableFunctorImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The lookup table is computed after the functor is set.
+  void BeforeThreadedGenerateData() override;
+
+  void DynamicThreadedGenerateData( const OutputImageRegionType & outputRegionForThread ) override;
+
+  void AfterThreadedGenerateData() override;
+
+private:
+  LookupTableFunctorImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  std::vector<OutputPixelType> m_LookupTable;
+};
+
+
+} // end namespace itk
+
+
+#include "itkLookupTableFunctorImageFilter.hxx"
+
+#endif // itkLookupTableFunctorImageFilter_h
@@ -0,0 +1,116 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkLookupTableFunctorImageFilter_hxx
+#define itkLookupTableFunctorImageFilter_hxx
+
+#include "itkLookupTableFunctorImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <limits>
+#include <type_traits>
+
+namespace itk {
+
+//
+// BeforeThreadedGenerateData
+//
+template < class TSuperclass >
+void
+LookupTableFunctorImageFilter< TSuperclass >::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  m_LookupTable.clear();
+
+  constexpr bool UseLookupTable = std::is_integral<InputPixelType>::value && sizeof( InputPixelType ) <= 2;
+  if ( !UseLookupTable )
+    {
+    return;
+    }
+
+  const SizeValueType numberOfValues = static_cast<SizeValueType>( std::numeric_limits<InputPixelType>::max() )
+    - static_cast<SizeValueType>( std::numeric_limits<InputPixelType>::lowest() ) + 1;
+  if ( this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() <= numberOfValues )
+    {
+    return;
+    }
+
+  const auto &functor = this->GetFunctor();
+  m_LookupTable.resize( numberOfValues );
+  for ( SizeValueType v = 0; v < numberOfValues; ++v )
+    {
+    m_LookupTable[v] = functor( static_cast<InputPixelType>( std::numeric_limits<InputPixelType>::lowest() + static_cast<long>( v ) ) );
+    }
+}
+
+
+//
+// DynamicThreadedGenerateData
+//
+template < class TSuperclass >
+void
+LookupTableFunctorImageFilter< TSuperclass >
+::DynamicThreadedGenerateData( const OutputImageRegionType & outputRegionForThread )
+{
+  if ( m_LookupTable.empty() )
+    {
+    Superclass::DynamicThreadedGenerateData( outputRegionForThread );
+    return;
+    }
+
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+
+  InputImageRegionType inputRegionForThread;
+  this->CallCopyOutputRegionToInputRegion( inputRegionForThread, outputRegionForThread );
+
+  const long lowest = static_cast<long>( std::numeric_limits<InputPixelType>::lowest() );
+
+  ImageScanlineConstIterator<InputImageType> inIt( input, inputRegionForThread );
+  ImageScanlineIterator<OutputImageType> outIt( output, outputRegionForThread );
+  while ( !inIt.IsAtEnd() )
+    {
+    while ( !inIt.IsAtEndOfLine() )
+      {
+      outIt.Set( m_LookupTable[static_cast<long>( inIt.Get() ) - lowest] );
+      ++inIt;
+      ++outIt;
+      }
+    inIt.NextLine();
+    outIt.NextLine();
+    }
+}
+
+
+//
+// AfterThreadedGenerateData
+//
+template < class TSuperclass >
+void
+LookupTableFunctorImageFilter< TSuperclass >::AfterThreadedGenerateData()
+{
+  m_LookupTable.clear();
+  m_LookupTable.shrink_to_fit();
+  Superclass::AfterThreadedGenerateData();
+}
+
+
+} // end namespace itk
+
+#endif // itkLookupTableFunctorImageFilter_hxx
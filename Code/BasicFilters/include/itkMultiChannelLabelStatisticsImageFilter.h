@@ -0,0 +1,154 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkMultiChannelLabelStatisticsImageFilter_h
+#define itkMultiChannelLabelStatisticsImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class MultiChannelLabelStatisticsImageFilter
+ * \brief Compute the statistics of the pixels of each label, for each
+ * channel of one or more intensity images, in a single pass.
+ *
+ * The channels are the components of the intensity inputs, in the
+ * order of the inputs, so an itk::VectorImage with several components
+ * or several scalar images can be given. For each label of the
+ * LabelImage and each channel, the minimum, maximum, mean, sigma,
+ * variance and sum are computed, as with the LabelStatisticsImageFilter,
+ * with one traversal of the label image and of the intensities instead
+ * of one per channel.
+ *
+ * The labels present in the image are first collected, then each
+ * thread accumulates the statistics of its part of the image into
+ * flat arrays indexed by the position of the label, which are summed
+ * at the end.
+ *
+ * The results are stored in arrays indexed by the label position in
+ * GetLabels() times the number of channels plus the channel.
+ *
+ * The first intensity input is passed through to the output without a
+ * copy.
+ *
+ * \sa LabelStatisticsImageFilter
+ */
+template < class TIntensityImage, class TLabelImage >
+class MultiChannelLabelStatisticsImageFilter:
+    public ImageToImageFilter< TIntensityImage, TIntensityImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = MultiChannelLabelStatisticsImageFilter;
+  using Superclass = ImageToImageFilter< TIntensityImage, TIntensityImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using IntensityImageType = TIntensityImage;
+  using LabelImageType = TLabelImage;
+  using LabelPixelType = typename TLabelImage::PixelType;
+  using RegionType = typename TIntensityImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TIntensityImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(MultiChannelLabelStatisticsImageFilter, ImageToImageFilter);
+
+  /** Set/Get the label image. */
+  itkSetInputMacro(LabelImage, LabelImageType);
+  itkGetInputMacro(LabelImage, LabelImageType);
+
+  /** Set the intensity input of index idx, the channels of the inputs
+   * follow each other. */
+  using Superclass::SetInput;
+
+  /** The sorted labels of the last update. */
+  const std::vector<LabelPixelType> &GetLabels() const
+  { return m_Labels; }
+
+  /** The number of channels of the last update. */
+  itkGetConstMacro( NumberOfChannels, unsigned int );
+
+  /** The number of pixels of each label. */
+  const std::vector<SizeValueType> &GetCounts() const
+  { return m_Counts; }
+
+  /** The statistics of each label and channel, at the index label
+   * position times NumberOfChannels plus the channel.
+   * @{
+   */
+  const std::vector<double> &GetMinimums() const
+  { return m_Minimums; }
+  const std::vector<double> &GetMaximums() const
+  { return m_Maximums; }
+  const std::vector<double> &GetMeans() const
+  { return m_Means; }
+  const std::vector<double> &GetSigmas() const
+  { return m_Sigmas; }
+  const std::vector<double> &GetVariances() const
+  { return m_Variances; }
+  const std::vector<double> &GetSums() const
+  { return m_Sums; }
+  /** @} */
+
+protected:
+
+  MultiChannelLabelStatisticsImageFilter();
+
+  ~MultiChannelLabelStatisticsImageFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // The first input is passed through to the output, and the
+  // statistics are computed by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its inputs
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  MultiChannelLabelStatisticsImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  std::vector<LabelPixelType> m_Labels;
+  unsigned int                m_NumberOfChannels;
+  std::vector<SizeValueType>  m_Counts;
+  std::vector<double>         m_Minimums;
+  std::vector<double>         m_Maximums;
+  std::vector<double>         m_Means;
+  std::vector<double>         m_Sigmas;
+  std::vector<double>         m_Variances;
+  std::vector<double>         m_Sums;
+};
+
+
+} // end namespace itk
+
+
+#include "itkMultiChannelLabelStatisticsImageFilter.hxx"
+
+#endif // itkMultiChannelLabelStatisticsImageFilter_h
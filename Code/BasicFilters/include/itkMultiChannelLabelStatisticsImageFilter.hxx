@@ -0,0 +1,313 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkMultiChannelLabelStatisticsImageFilter_hxx
+#define itkMultiChannelLabelStatisticsImageFilter_hxx
+
+#include "itkMultiChannelLabelStatisticsImageFilter.h"
+
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineConstIterator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace itk {
+
+//
+// Constructor
+//
+template < class TIntensityImage, class TLabelImage >
+MultiChannelLabelStatisticsImageFilter< TIntensityImage, TLabelImage >::MultiChannelLabelStatisticsImageFilter()
+{
+  this->m_NumberOfChannels = 0;
+
+  this->AddRequiredInputName( "LabelImage" );
+}
+
+
+//
+// GenerateData
+//
+template < class TIntensityImage, class TLabelImage >
+void
+MultiChannelLabelStatisticsImageFilter< TIntensityImage, TLabelImage >::GenerateData()
+{
+  using InternalPixelType = typename IntensityImageType::InternalPixelType;
+  using IndexType = typename RegionType::IndexType;
+
+  const LabelImageType *labelImage = this->GetLabelImage();
+
+  // the output is the first input, as the statistics do not modify it
+  this->GetOutput()->Graft( const_cast<IntensityImageType *>( this->GetInput() ) );
+
+  std::vector<const IntensityImageType *> inputs;
+  std::vector<unsigned int> components;
+  unsigned int numberOfChannels = 0;
+  for ( unsigned int k = 0; k < this->GetNumberOfIndexedInputs(); ++k )
+    {
+    const IntensityImageType *input = this->GetInput( k );
+    if ( input )
+      {
+      inputs.push_back( input );
+      components.push_back( input->GetNumberOfComponentsPerPixel() );
+      numberOfChannels += components.back();
+      }
+    }
+  this->m_NumberOfChannels = numberOfChannels;
+
+  const RegionType region = this->GetOutput()->GetRequestedRegion();
+
+  // the parts of the image, each with its own accumulators
+  auto splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfWorkUnits(), 1u ) );
+  auto getPiece = [&]( SizeValueType piece )
+    {
+      RegionType pieceRegion = region;
+      splitter->GetSplit( static_cast<unsigned int>( piece ), numberOfPieces, pieceRegion );
+      return pieceRegion;
+    };
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // collect the labels, which change little along the lines
+  std::vector< std::vector<LabelPixelType> > pieceLabels( numberOfPieces );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        std::vector<LabelPixelType> &labels = pieceLabels[piece];
+        size_t compacted = 0;
+        auto compact = [&labels, &compacted]()
+          {
+            std::sort( labels.begin(), labels.end() );
+            labels.erase( std::unique( labels.begin(), labels.end() ), labels.end() );
+            compacted = labels.size();
+          };
+
+        ImageScanlineConstIterator<LabelImageType> it( labelImage, getPiece( piece ) );
+        while ( !it.IsAtEnd() )
+          {
+          LabelPixelType last = it.Get();
+          labels.push_back( last );
+          while ( !it.IsAtEndOfLine() )
+            {
+            const LabelPixelType label = it.Get();
+            if ( label != last )
+              {
+              labels.push_back( label );
+              last = label;
+              }
+            ++it;
+            }
+          if ( labels.size() > 2 * compacted + 4096 )
+            {
+            compact();
+            }
+          it.NextLine();
+          }
+        compact();
+      },
+    nullptr );
+
+  this->m_Labels.clear();
+  for ( const std::vector<LabelPixelType> &labels : pieceLabels )
+    {
+    this->m_Labels.insert( this->m_Labels.end(), labels.begin(), labels.end() );
+    }
+  std::sort( this->m_Labels.begin(), this->m_Labels.end() );
+  this->m_Labels.erase( std::unique( this->m_Labels.begin(), this->m_Labels.end() ), this->m_Labels.end() );
+
+  const SizeValueType numberOfLabels = this->m_Labels.size();
+  const SizeValueType numberOfValues = numberOfLabels * numberOfChannels;
+
+  // the position of a label, from a table when the labels are dense
+  // enough, or a binary search
+  std::vector<SizeValueType> table;
+  const LabelPixelType minimumLabel = numberOfLabels > 0 ? this->m_Labels.front() : LabelPixelType{};
+  if ( numberOfLabels > 0 )
+    {
+    const double range = static_cast<double>( this->m_Labels.back() ) - static_cast<double>( minimumLabel ) + 1.0;
+    if ( range <= 4.0 * numberOfLabels + 65536.0 )
+      {
+      table.resize( static_cast<SizeValueType>( range ) );
+      for ( SizeValueType i = 0; i < numberOfLabels; ++i )
+        {
+        table[static_cast<SizeValueType>( this->m_Labels[i] - minimumLabel )] = i;
+        }
+      }
+    }
+  auto position = [this, &table, minimumLabel]( LabelPixelType label ) -> SizeValueType
+    {
+      if ( !table.empty() )
+        {
+        return table[static_cast<SizeValueType>( label - minimumLabel )];
+        }
+      return std::lower_bound( this->m_Labels.begin(), this->m_Labels.end(), label ) - this->m_Labels.begin();
+    };
+
+  struct Accumulators
+  {
+    std::vector<SizeValueType> counts;
+    std::vector<double>        sums;
+    std::vector<double>        sumsOfSquares;
+    std::vector<double>        minimums;
+    std::vector<double>        maximums;
+  };
+  std::vector<Accumulators> pieceAccumulators( numberOfPieces );
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        Accumulators &accumulators = pieceAccumulators[piece];
+        accumulators.counts.assign( numberOfLabels, 0 );
+        accumulators.sums.assign( numberOfValues, 0.0 );
+        accumulators.sumsOfSquares.assign( numberOfValues, 0.0 );
+        accumulators.minimums.assign( numberOfValues, std::numeric_limits<double>::infinity() );
+        accumulators.maximums.assign( numberOfValues, -std::numeric_limits<double>::infinity() );
+
+        const RegionType pieceRegion = getPiece( piece );
+        const SizeValueType lineLength = pieceRegion.GetSize( 0 );
+        std::vector<const InternalPixelType *> lines( inputs.size() );
+
+        ImageScanlineConstIterator<LabelImageType> it( labelImage, pieceRegion );
+        while ( !it.IsAtEnd() )
+          {
+          const IndexType index = it.GetIndex();
+          const LabelPixelType *labelLine = labelImage->GetBufferPointer() + labelImage->ComputeOffset( index );
+          for ( size_t k = 0; k < inputs.size(); ++k )
+            {
+            lines[k] = inputs[k]->GetBufferPointer() + inputs[k]->ComputeOffset( index ) * components[k];
+            }
+
+          LabelPixelType last = labelLine[0];
+          SizeValueType p = position( last );
+          for ( SizeValueType x = 0; x < lineLength; ++x )
+            {
+            const LabelPixelType label = labelLine[x];
+            if ( label != last )
+              {
+              p = position( label );
+              last = label;
+              }
+            ++accumulators.counts[p];
+
+            double *sums = &accumulators.sums[p * numberOfChannels];
+            double *sumsOfSquares = &accumulators.sumsOfSquares[p * numberOfChannels];
+            double *minimums = &accumulators.minimums[p * numberOfChannels];
+            double *maximums = &accumulators.maximums[p * numberOfChannels];
+            unsigned int c = 0;
+            for ( size_t k = 0; k < inputs.size(); ++k )
+              {
+              const InternalPixelType *values = lines[k] + x * components[k];
+              for ( unsigned int j = 0; j < components[k]; ++j, ++c )
+                {
+                const double value = static_cast<double>( values[j] );
+                sums[c] += value;
+                sumsOfSquares[c] += value * value;
+                minimums[c] = std::min( minimums[c], value );
+                maximums[c] = std::max( maximums[c], value );
+                }
+              }
+            }
+          it.NextLine();
+          }
+      },
+    this );
+
+  // sum the accumulators of the pieces
+  Accumulators total;
+  total.counts.assign( numberOfLabels, 0 );
+  total.sums.assign( numberOfValues, 0.0 );
+  total.sumsOfSquares.assign( numberOfValues, 0.0 );
+  total.minimums.assign( numberOfValues, std::numeric_limits<double>::infinity() );
+  total.maximums.assign( numberOfValues, -std::numeric_limits<double>::infinity() );
+  for ( const Accumulators &accumulators : pieceAccumulators )
+    {
+    for ( SizeValueType i = 0; i < numberOfLabels; ++i )
+      {
+      total.counts[i] += accumulators.counts[i];
+      }
+    for ( SizeValueType i = 0; i < numberOfValues; ++i )
+      {
+      total.sums[i] += accumulators.sums[i];
+      total.sumsOfSquares[i] += accumulators.sumsOfSquares[i];
+      total.minimums[i] = std::min( total.minimums[i], accumulators.minimums[i] );
+      total.maximums[i] = std::max( total.maximums[i], accumulators.maximums[i] );
+      }
+    }
+
+  this->m_Counts = total.counts;
+  this->m_Sums = total.sums;
+  this->m_Minimums = total.minimums;
+  this->m_Maximums = total.maximums;
+  this->m_Means.assign( numberOfValues, 0.0 );
+  this->m_Variances.assign( numberOfValues, 0.0 );
+  this->m_Sigmas.assign( numberOfValues, 0.0 );
+  for ( SizeValueType i = 0; i < numberOfValues; ++i )
+    {
+    const double count = static_cast<double>( total.counts[i / numberOfChannels] );
+    const double sum = total.sums[i];
+    this->m_Means[i] = sum / count;
+
+    // unbiased estimate of the variance
+    if ( count > 1.0 )
+      {
+      const double variance = ( total.sumsOfSquares[i] - sum * sum / count ) / ( count - 1.0 );
+      this->m_Variances[i] = std::max( variance, 0.0 );
+      this->m_Sigmas[i] = std::sqrt( this->m_Variances[i] );
+      }
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TIntensityImage, class TLabelImage >
+void
+MultiChannelLabelStatisticsImageFilter< TIntensityImage, TLabelImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+
+  // set the output region to the largest and let the pipeline
+  // propagate the requested region to the inputs
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TIntensityImage, class TLabelImage >
+void
+MultiChannelLabelStatisticsImageFilter< TIntensityImage, TLabelImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfLabels: " << m_Labels.size() << std::endl;
+  os << indent << "NumberOfChannels: " << m_NumberOfChannels << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkMultiChannelLabelStatisticsImageFilter_hxx
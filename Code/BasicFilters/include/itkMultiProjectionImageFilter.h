@@ -0,0 +1,145 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkMultiProjectionImageFilter_h
+#define itkMultiProjectionImageFilter_h
+
+#include "itkMaximumProjectionImageFilter.h"
+#include "itkNumericTraits.h"
+
+
+namespace itk {
+
+/** \class MultiProjectionImageFilter
+ * \brief Compute the maximum, minimum, median, mean, sum and standard
+ * deviation projections of an image along an axis in a single pass.
+ *
+ * Each projection is an output of the filter, computed when its
+ * Compute flag is on, with the geometry of the output of the
+ * ProjectionImageFilter: the size of the projection dimension is 1.
+ * The maximum, minimum and median projections have the pixel type of
+ * the input, the mean, sum and standard deviation projections the
+ * real type of the input, and their values are those of the
+ * MaximumProjectionImageFilter, MinimumProjectionImageFilter,
+ * MedianProjectionImageFilter, MeanProjectionImageFilter,
+ * SumProjectionImageFilter and StandardDeviationProjectionImageFilter.
+ *
+ * The projected lines are processed in tiles of consecutive lines,
+ * split between the threads. When the projection dimension is not the
+ * first one, the values of a tile are read by rows of consecutive
+ * pixels along the first dimension instead of by lines, and are
+ * transposed into a buffer of lines only for the median.
+ *
+ * The whole input is requested.
+ *
+ * \sa ProjectionImageFilter
+ */
+template < class TInputImage >
+class MultiProjectionImageFilter:
+    public ProjectionImageFilter< TInputImage, TInputImage,
+                                  Functor::MaximumAccumulator< typename TInputImage::PixelType > >
+{
+public:
+  /** Standard Self type alias */
+  using Self = MultiProjectionImageFilter;
+  using Superclass = ProjectionImageFilter< TInputImage, TInputImage,
+                                            Functor::MaximumAccumulator< typename TInputImage::PixelType > >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using RegionType = typename TInputImage::RegionType;
+  using RealPixelType = typename NumericTraits< InputPixelType >::RealType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  using RealImageType = Image< RealPixelType, ImageDimension >;
+
+  using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(MultiProjectionImageFilter, ProjectionImageFilter);
+
+  /** Set/Get which projections are computed, all by default. */
+  itkSetMacro(ComputeMaximum, bool);
+  itkGetConstMacro(ComputeMaximum, bool);
+  itkBooleanMacro(ComputeMaximum);
+  itkSetMacro(ComputeMinimum, bool);
+  itkGetConstMacro(ComputeMinimum, bool);
+  itkBooleanMacro(ComputeMinimum);
+  itkSetMacro(ComputeMedian, bool);
+  itkGetConstMacro(ComputeMedian, bool);
+  itkBooleanMacro(ComputeMedian);
+  itkSetMacro(ComputeMean, bool);
+  itkGetConstMacro(ComputeMean, bool);
+  itkBooleanMacro(ComputeMean);
+  itkSetMacro(ComputeSum, bool);
+  itkGetConstMacro(ComputeSum, bool);
+  itkBooleanMacro(ComputeSum);
+  itkSetMacro(ComputeStandardDeviation, bool);
+  itkGetConstMacro(ComputeStandardDeviation, bool);
+  itkBooleanMacro(ComputeStandardDeviation);
+
+  /** The projections, which are not allocated when they are not
+   * computed. */
+  InputImageType * GetMaximumOutput() { return static_cast< InputImageType * >( this->ProcessObject::GetOutput( 0 ) ); }
+  InputImageType * GetMinimumOutput() { return static_cast< InputImageType * >( this->ProcessObject::GetOutput( 1 ) ); }
+  InputImageType * GetMedianOutput() { return static_cast< InputImageType * >( this->ProcessObject::GetOutput( 2 ) ); }
+  RealImageType * GetMeanOutput() { return static_cast< RealImageType * >( this->ProcessObject::GetOutput( 3 ) ); }
+  RealImageType * GetSumOutput() { return static_cast< RealImageType * >( this->ProcessObject::GetOutput( 4 ) ); }
+  RealImageType * GetStandardDeviationOutput() { return static_cast< RealImageType * >( this->ProcessObject::GetOutput( 5 ) ); }
+
+  using Superclass::MakeOutput;
+  DataObject::Pointer MakeOutput( DataObjectPointerArraySizeType idx ) override;
+
+protected:
+
+  MultiProjectionImageFilter();
+
+  ~MultiProjectionImageFilter() override = default;
+
+  void GenerateOutputInformation() override;
+
+  void EnlargeOutputRequestedRegion( DataObject *output ) override;
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  MultiProjectionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_ComputeMaximum{true};
+  bool m_ComputeMinimum{true};
+  bool m_ComputeMedian{true};
+  bool m_ComputeMean{true};
+  bool m_ComputeSum{true};
+  bool m_ComputeStandardDeviation{true};
+};
+
+
+} // end namespace itk
+
+
+#include "itkMultiProjectionImageFilter.hxx"
+
+#endif // itkMultiProjectionImageFilter_h
@@ -0,0 +1,254 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkMultiProjectionImageFilter_hxx
+#define itkMultiProjectionImageFilter_hxx
+
+#include "itkMultiProjectionImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace itk {
+
+template < class TInputImage >
+MultiProjectionImageFilter< TInputImage >::MultiProjectionImageFilter()
+{
+  this->SetNumberOfRequiredOutputs( 6 );
+  for ( DataObjectPointerArraySizeType i = 1; i < 6; ++i )
+    {
+    this->SetNthOutput( i, this->MakeOutput( i ) );
+    }
+}
+
+
+//
+// MakeOutput
+//
+template < class TInputImage >
+DataObject::Pointer
+MultiProjectionImageFilter< TInputImage >::MakeOutput( DataObjectPointerArraySizeType idx )
+{
+  // the mean, sum and standard deviation are real
+  if ( idx >= 3 )
+    {
+    return RealImageType::New().GetPointer();
+    }
+  return InputImageType::New().GetPointer();
+}
+
+
+//
+// GenerateOutputInformation
+//
+template < class TInputImage >
+void
+MultiProjectionImageFilter< TInputImage >::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  for ( DataObjectPointerArraySizeType i = 1; i < 6; ++i )
+    {
+    this->ProcessObject::GetOutput( i )->CopyInformation( this->GetOutput() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage >
+void
+MultiProjectionImageFilter< TInputImage >::EnlargeOutputRequestedRegion( DataObject *output )
+{
+  Superclass::EnlargeOutputRequestedRegion( output );
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage >
+void
+MultiProjectionImageFilter< TInputImage >::GenerateData()
+{
+  // the number of consecutive lines projected together
+  constexpr SizeValueType TileSize = 64;
+
+  const InputImageType *input = this->GetInput();
+
+  auto allocate = []( auto *image, bool compute )
+    {
+      using PixelType = typename std::remove_pointer< decltype( image->GetBufferPointer() ) >::type;
+      if ( !compute )
+        {
+        image->Initialize();
+        return static_cast< PixelType * >( nullptr );
+        }
+      image->SetBufferedRegion( image->GetRequestedRegion() );
+      image->Allocate();
+      return image->GetBufferPointer();
+    };
+  InputPixelType *maximum = allocate( this->GetMaximumOutput(), m_ComputeMaximum );
+  InputPixelType *minimum = allocate( this->GetMinimumOutput(), m_ComputeMinimum );
+  InputPixelType *median = allocate( this->GetMedianOutput(), m_ComputeMedian );
+  RealPixelType *mean = allocate( this->GetMeanOutput(), m_ComputeMean );
+  RealPixelType *sum = allocate( this->GetSumOutput(), m_ComputeSum );
+  RealPixelType *standardDeviation = allocate( this->GetStandardDeviationOutput(), m_ComputeStandardDeviation );
+
+  // the input is a sequence of blocks of length rows of inner pixels,
+  // and the output a sequence of blocks of inner pixels
+  const unsigned int projectionDimension = this->GetProjectionDimension();
+  const typename InputImageType::SizeType size = input->GetBufferedRegion().GetSize();
+  SizeValueType inner = 1;
+  SizeValueType outer = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    if ( d < projectionDimension )
+      {
+      inner *= size[d];
+      }
+    else if ( d > projectionDimension )
+      {
+      outer *= size[d];
+      }
+    }
+  const SizeValueType length = size[projectionDimension];
+  const SizeValueType tilesPerBlock = ( inner + TileSize - 1 ) / TileSize;
+  const SizeValueType numberOfTiles = outer * tilesPerBlock;
+  const InputPixelType *buffer = input->GetBufferPointer();
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  const SizeValueType numberOfChunks = std::min< SizeValueType >( numberOfTiles, this->GetMultiThreader()->GetNumberOfWorkUnits() );
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        std::vector< InputPixelType > tileMaximum( TileSize );
+        std::vector< InputPixelType > tileMinimum( TileSize );
+        std::vector< RealPixelType > tileSum( TileSize );
+        std::vector< RealPixelType > tileSquaredSum( TileSize );
+        std::vector< InputPixelType > lines( m_ComputeMedian ? TileSize * length : 0 );
+
+        for ( SizeValueType tile = chunk * numberOfTiles / numberOfChunks; tile < ( chunk + 1 ) * numberOfTiles / numberOfChunks; ++tile )
+          {
+          const SizeValueType block = tile / tilesPerBlock;
+          const SizeValueType first = ( tile % tilesPerBlock ) * TileSize;
+          const SizeValueType width = std::min( TileSize, inner - first );
+          const InputPixelType *in = buffer + block * length * inner + first;
+          const SizeValueType out = block * inner + first;
+
+          // the rows of the tile, in the order of the buffer
+          std::fill( tileSum.begin(), tileSum.end(), NumericTraits< RealPixelType >::ZeroValue() );
+          std::copy( in, in + width, tileMaximum.begin() );
+          std::copy( in, in + width, tileMinimum.begin() );
+          for ( SizeValueType k = 0; k < length; ++k )
+            {
+            const InputPixelType *row = in + k * inner;
+            for ( SizeValueType j = 0; j < width; ++j )
+              {
+              const InputPixelType value = row[j];
+              tileMaximum[j] = std::max( tileMaximum[j], value );
+              tileMinimum[j] = std::min( tileMinimum[j], value );
+              tileSum[j] = tileSum[j] + value;
+              }
+            if ( m_ComputeMedian )
+              {
+              for ( SizeValueType j = 0; j < width; ++j )
+                {
+                lines[j * length + k] = row[j];
+                }
+              }
+            }
+
+          // the squared differences to the mean, as the
+          // StandardDeviationProjectionImageFilter
+          if ( standardDeviation && length > 1 )
+            {
+            std::fill( tileSquaredSum.begin(), tileSquaredSum.end(), NumericTraits< RealPixelType >::ZeroValue() );
+            for ( SizeValueType k = 0; k < length; ++k )
+              {
+              const InputPixelType *row = in + k * inner;
+              for ( SizeValueType j = 0; j < width; ++j )
+                {
+                const RealPixelType difference = row[j] - static_cast< RealPixelType >( tileSum[j] ) / length;
+                tileSquaredSum[j] += difference * difference;
+                }
+              }
+            }
+
+          for ( SizeValueType j = 0; j < width; ++j )
+            {
+            if ( maximum )
+              {
+              maximum[out + j] = tileMaximum[j];
+              }
+            if ( minimum )
+              {
+              minimum[out + j] = tileMinimum[j];
+              }
+            if ( median )
+              {
+              const auto line = lines.begin() + j * length;
+              std::nth_element( line, line + length / 2, line + length );
+              median[out + j] = *( line + length / 2 );
+              }
+            if ( mean )
+              {
+              mean[out + j] = tileSum[j] / length;
+              }
+            if ( sum )
+              {
+              sum[out + j] = tileSum[j];
+              }
+            if ( standardDeviation )
+              {
+              standardDeviation[out + j] = ( length > 1 ) ? std::sqrt( tileSquaredSum[j] / ( length - 1 ) )
+                                                          : NumericTraits< RealPixelType >::ZeroValue();
+              }
+            }
+          }
+      },
+    this );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage >
+void
+MultiProjectionImageFilter< TInputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "ComputeMaximum: " << m_ComputeMaximum << std::endl;
+  os << indent << "ComputeMinimum: " << m_ComputeMinimum << std::endl;
+  os << indent << "ComputeMedian: " << m_ComputeMedian << std::endl;
+  os << indent << "ComputeMean: " << m_ComputeMean << std::endl;
+  os << indent << "ComputeSum: " << m_ComputeSum << std::endl;
+  os << indent << "ComputeStandardDeviation: " << m_ComputeStandardDeviation << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkMultiProjectionImageFilter_hxx
@@ -0,0 +1,148 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelConnectedComponentImageFilter_h
+#define itkParallelConnectedComponentImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+
+namespace itk {
+
+/** \class ParallelConnectedComponentImageFilter
+ * \brief Label the objects of a binary image with all the threads,
+ * optionally relabeling them by size.
+ *
+ * The non-zero pixels of the input, inside the optional MaskImage,
+ * are the objects. The output is the same as with the
+ * ConnectedComponentImageFilter: the objects are labeled from 1 in
+ * the raster order of their first pixel, with a background of 0.
+ *
+ * The image is split along the slowest dimension and each thread
+ * encodes the runs of its part along the first dimension. The runs of
+ * the neighboring lines which touch are then merged by all the threads
+ * in a lock-free union-find, whose roots are always the first run of
+ * their set, so the labels are numbered in raster order from the roots
+ * without a sequential pass.
+ *
+ * The relabeling of the RelabelComponentImageFilter is done in the
+ * same execution: when SortByObjectSize is on, the labels are ordered
+ * by decreasing number of pixels, the objects smaller than
+ * MinimumObjectSize are removed, and only the first
+ * NumberOfObjectsToKeep of the remaining objects are kept when it is
+ * not 0. ObjectCount is the number of labels of the output.
+ *
+ * \sa ConnectedComponentImageFilter, RelabelComponentImageFilter
+ */
+template < class TInputImage, class TOutputImage, class TMaskImage = TInputImage >
+class ParallelConnectedComponentImageFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelConnectedComponentImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using MaskImageType = TMaskImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using MaskPixelType = typename TMaskImage::PixelType;
+  using RegionType = typename TInputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelConnectedComponentImageFilter, ImageToImageFilter);
+
+  /** Set/Get the optional mask of the objects. */
+  itkSetInputMacro(MaskImage, MaskImageType);
+  itkGetInputMacro(MaskImage, MaskImageType);
+
+  /** Set/Get whether the pixels are connected by their faces only, or
+   * also by their edges and vertices. Defaults to false. */
+  itkSetMacro( FullyConnected, bool );
+  itkGetConstMacro( FullyConnected, bool );
+  itkBooleanMacro( FullyConnected );
+
+  /** Set/Get whether the labels are ordered by decreasing size
+   * instead of the raster order. Defaults to false. */
+  itkSetMacro( SortByObjectSize, bool );
+  itkGetConstMacro( SortByObjectSize, bool );
+  itkBooleanMacro( SortByObjectSize );
+
+  /** Set/Get the minimum number of pixels of the objects of the
+   * output. Defaults to 0. */
+  itkSetMacro( MinimumObjectSize, SizeValueType );
+  itkGetConstMacro( MinimumObjectSize, SizeValueType );
+
+  /** Set/Get the maximum number of objects of the output, 0 for all
+   * of them. Defaults to 0. */
+  itkSetMacro( NumberOfObjectsToKeep, SizeValueType );
+  itkGetConstMacro( NumberOfObjectsToKeep, SizeValueType );
+
+  /** The number of labels of the output of the last update. */
+  itkGetConstMacro( ObjectCount, SizeValueType );
+
+  /** The number of connected components of the last update, before
+   * the objects are removed. */
+  itkGetConstMacro( OriginalObjectCount, SizeValueType );
+
+protected:
+
+  ParallelConnectedComponentImageFilter();
+
+  ~ParallelConnectedComponentImageFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // The phases of the labeling are done by the threads of the
+  // multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  ParallelConnectedComponentImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool          m_FullyConnected;
+  bool          m_SortByObjectSize;
+  SizeValueType m_MinimumObjectSize;
+  SizeValueType m_NumberOfObjectsToKeep;
+  SizeValueType m_ObjectCount;
+  SizeValueType m_OriginalObjectCount;
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelConnectedComponentImageFilter.hxx"
+
+#endif // itkParallelConnectedComponentImageFilter_h
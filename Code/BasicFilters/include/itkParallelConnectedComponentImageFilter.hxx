@@ -0,0 +1,515 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelConnectedComponentImageFilter_hxx
+#define itkParallelConnectedComponentImageFilter_hxx
+
+#include "itkParallelConnectedComponentImageFilter.h"
+
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineConstIterator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace itk {
+
+// Lock-free union-find in which a root is only linked to a smaller
+// root, so the root of a set is always its smallest element.
+class ParallelConnectedComponentDisjointSets
+{
+public:
+  explicit ParallelConnectedComponentDisjointSets( SizeValueType size )
+    : m_Parents( new std::atomic<SizeValueType>[size] )
+    {
+      for ( SizeValueType i = 0; i < size; ++i )
+        {
+        m_Parents[i].store( i, std::memory_order_relaxed );
+        }
+    }
+
+  SizeValueType Find( SizeValueType x )
+    {
+      SizeValueType parent = m_Parents[x].load( std::memory_order_acquire );
+      while ( parent != x )
+        {
+        // path halving, which only moves the elements closer to their
+        // root
+        const SizeValueType grandParent = m_Parents[parent].load( std::memory_order_acquire );
+        if ( grandParent != parent )
+          {
+          m_Parents[x].compare_exchange_weak( parent, grandParent, std::memory_order_release, std::memory_order_relaxed );
+          }
+        x = grandParent;
+        parent = m_Parents[x].load( std::memory_order_acquire );
+        }
+      return x;
+    }
+
+  void Unite( SizeValueType a, SizeValueType b )
+    {
+      while ( true )
+        {
+        a = this->Find( a );
+        b = this->Find( b );
+        if ( a == b )
+          {
+          return;
+          }
+        if ( a < b )
+          {
+          std::swap( a, b );
+          }
+        // the larger root is linked if it is still a root
+        SizeValueType expected = a;
+        if ( m_Parents[a].compare_exchange_strong( expected, b, std::memory_order_acq_rel ) )
+          {
+          return;
+          }
+        }
+    }
+
+  bool IsRoot( SizeValueType x ) const
+    {
+      return m_Parents[x].load( std::memory_order_relaxed ) == x;
+    }
+
+private:
+  std::unique_ptr<std::atomic<SizeValueType>[]> m_Parents;
+};
+
+
+//
+// Constructor
+//
+template < class TInputImage, class TOutputImage, class TMaskImage >
+ParallelConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >::ParallelConnectedComponentImageFilter()
+{
+  this->m_FullyConnected = false;
+  this->m_SortByObjectSize = false;
+  this->m_MinimumObjectSize = 0;
+  this->m_NumberOfObjectsToKeep = 0;
+  this->m_ObjectCount = 0;
+  this->m_OriginalObjectCount = 0;
+
+  this->AddOptionalInputName( "MaskImage" );
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage, class TMaskImage >
+void
+ParallelConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >::GenerateData()
+{
+  using IndexType = typename RegionType::IndexType;
+  using OffsetType = typename IndexType::OffsetType;
+
+  // a run of object pixels along the first dimension, with the
+  // positions from the start of the line, end included
+  struct Run
+  {
+    IndexValueType start;
+    IndexValueType end;
+  };
+
+  const InputImageType *input = this->GetInput();
+  const MaskImageType *mask = this->GetMaskImage();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const RegionType region = output->GetRequestedRegion();
+  const IndexType regionIndex = region.GetIndex();
+  const SizeValueType lineLength = region.GetSize( 0 );
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    this->m_ObjectCount = 0;
+    this->m_OriginalObjectCount = 0;
+    return;
+    }
+
+  // the lines are numbered in raster order
+  OffsetValueType lineStrides[ImageDimension];
+  lineStrides[0] = 0;
+  SizeValueType numberOfLines = 1;
+  for ( unsigned int d = 1; d < ImageDimension; ++d )
+    {
+    lineStrides[d] = static_cast<OffsetValueType>( numberOfLines );
+    numberOfLines *= region.GetSize( d );
+    }
+  auto lineNumber = [&]( const IndexType &index )
+    {
+      OffsetValueType line = 0;
+      for ( unsigned int d = 1; d < ImageDimension; ++d )
+        {
+        line += ( index[d] - regionIndex[d] ) * lineStrides[d];
+        }
+      return static_cast<SizeValueType>( line );
+    };
+
+  // the offsets of the neighbor lines which come before in raster
+  // order, so each pair of lines is merged once
+  std::vector<OffsetType> neighbors;
+  {
+  OffsetType offset;
+  offset.Fill( -1 );
+  offset[0] = 0;
+  while ( true )
+    {
+    OffsetValueType linear = 0;
+    unsigned int nonZero = 0;
+    for ( unsigned int d = 1; d < ImageDimension; ++d )
+      {
+      linear += offset[d] * lineStrides[d];
+      nonZero += ( offset[d] != 0 );
+      }
+    if ( linear < 0 && ( this->m_FullyConnected || nonZero == 1 ) )
+      {
+      neighbors.push_back( offset );
+      }
+
+    unsigned int d = 1;
+    while ( d < ImageDimension && offset[d] == 1 )
+      {
+      offset[d] = -1;
+      ++d;
+      }
+    if ( d == ImageDimension )
+      {
+      break;
+      }
+    ++offset[d];
+    }
+  }
+
+  auto splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfWorkUnits(), 1u ) );
+
+  // the lines of each piece, with their runs
+  struct PieceLines
+  {
+    std::vector<IndexType> indices;
+    std::vector<Run>       runs;
+    std::vector<SizeValueType> numberOfRuns;
+  };
+  std::vector<PieceLines> pieceLines( numberOfPieces );
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // encode the runs of each piece
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        RegionType pieceRegion = region;
+        splitter->GetSplit( static_cast<unsigned int>( piece ), numberOfPieces, pieceRegion );
+
+        PieceLines &lines = pieceLines[piece];
+        ImageScanlineConstIterator<InputImageType> it( input, pieceRegion );
+        while ( !it.IsAtEnd() )
+          {
+          const IndexType index = it.GetIndex();
+          const InputPixelType *inputLine = input->GetBufferPointer() + input->ComputeOffset( index );
+          const MaskPixelType *maskLine = mask ? mask->GetBufferPointer() + mask->ComputeOffset( index ) : nullptr;
+          auto isObject = [inputLine, maskLine]( SizeValueType x )
+            {
+              return inputLine[x] != NumericTraits<InputPixelType>::ZeroValue()
+                && ( !maskLine || maskLine[x] != NumericTraits<MaskPixelType>::ZeroValue() );
+            };
+
+          const size_t firstRun = lines.runs.size();
+          SizeValueType x = 0;
+          while ( x < lineLength )
+            {
+            if ( !isObject( x ) )
+              {
+              ++x;
+              continue;
+              }
+            const SizeValueType start = x;
+            while ( x < lineLength && isObject( x ) )
+              {
+              ++x;
+              }
+            lines.runs.push_back( Run{ static_cast<IndexValueType>( start ), static_cast<IndexValueType>( x - 1 ) } );
+            }
+
+          lines.indices.push_back( index );
+          lines.numberOfRuns.push_back( lines.runs.size() - firstRun );
+          it.NextLine();
+          }
+      },
+    nullptr );
+
+  // the runs of all the lines, in raster order
+  std::vector<SizeValueType> lineFirstRun( numberOfLines + 1, 0 );
+  for ( const PieceLines &lines : pieceLines )
+    {
+    for ( size_t i = 0; i < lines.indices.size(); ++i )
+      {
+      lineFirstRun[lineNumber( lines.indices[i] ) + 1] = lines.numberOfRuns[i];
+      }
+    }
+  std::partial_sum( lineFirstRun.begin(), lineFirstRun.end(), lineFirstRun.begin() );
+  const SizeValueType numberOfRuns = lineFirstRun.back();
+
+  std::vector<Run> runs( numberOfRuns );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        PieceLines &lines = pieceLines[piece];
+        auto run = lines.runs.begin();
+        for ( size_t i = 0; i < lines.indices.size(); ++i )
+          {
+          std::copy( run, run + lines.numberOfRuns[i], runs.begin() + lineFirstRun[lineNumber( lines.indices[i] )] );
+          run += lines.numberOfRuns[i];
+          }
+        std::vector<Run>().swap( lines.runs );
+      },
+    nullptr );
+
+  // merge the touching runs of the neighbor lines
+  ParallelConnectedComponentDisjointSets sets( numberOfRuns );
+  const IndexValueType tolerance = this->m_FullyConnected ? 1 : 0;
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        const PieceLines &lines = pieceLines[piece];
+        for ( const IndexType &index : lines.indices )
+          {
+          const SizeValueType line = lineNumber( index );
+          if ( lineFirstRun[line] == lineFirstRun[line + 1] )
+            {
+            continue;
+            }
+          for ( const OffsetType &offset : neighbors )
+            {
+            if ( !region.IsInside( index + offset ) )
+              {
+              continue;
+              }
+            const SizeValueType neighbor = lineNumber( index + offset );
+
+            SizeValueType a = lineFirstRun[line];
+            SizeValueType b = lineFirstRun[neighbor];
+            const SizeValueType aEnd = lineFirstRun[line + 1];
+            const SizeValueType bEnd = lineFirstRun[neighbor + 1];
+            while ( a < aEnd && b < bEnd )
+              {
+              if ( runs[a].start <= runs[b].end + tolerance && runs[b].start <= runs[a].end + tolerance )
+                {
+                sets.Unite( a, b );
+                }
+              if ( runs[a].end < runs[b].end )
+                {
+                ++a;
+                }
+              else
+                {
+                ++b;
+                }
+              }
+            }
+          }
+      },
+    nullptr );
+
+  // number the roots in raster order, by chunks of the runs
+  const SizeValueType numberOfChunks = std::max<SizeValueType>( std::min<SizeValueType>( numberOfPieces, numberOfRuns ), 1 );
+  auto chunkBegin = [numberOfRuns, numberOfChunks]( SizeValueType chunk )
+    {
+      return chunk * numberOfRuns / numberOfChunks;
+    };
+
+  std::vector<SizeValueType> chunkFirstLabel( numberOfChunks + 1, 0 );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        SizeValueType roots = 0;
+        for ( SizeValueType r = chunkBegin( chunk ); r < chunkBegin( chunk + 1 ); ++r )
+          {
+          roots += sets.IsRoot( r );
+          }
+        chunkFirstLabel[chunk + 1] = roots;
+      },
+    nullptr );
+  std::partial_sum( chunkFirstLabel.begin(), chunkFirstLabel.end(), chunkFirstLabel.begin() );
+  const SizeValueType numberOfComponents = chunkFirstLabel.back();
+
+  std::vector<SizeValueType> runLabels( numberOfRuns );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        SizeValueType label = chunkFirstLabel[chunk];
+        for ( SizeValueType r = chunkBegin( chunk ); r < chunkBegin( chunk + 1 ); ++r )
+          {
+          if ( sets.IsRoot( r ) )
+            {
+            runLabels[r] = ++label;
+            }
+          }
+      },
+    nullptr );
+
+  const bool relabel = this->m_SortByObjectSize || this->m_MinimumObjectSize > 1
+    || ( this->m_NumberOfObjectsToKeep > 0 && this->m_NumberOfObjectsToKeep < numberOfComponents );
+
+  std::unique_ptr<std::atomic<SizeValueType>[]> sizes;
+  if ( relabel )
+    {
+    sizes.reset( new std::atomic<SizeValueType>[numberOfComponents + 1] );
+    for ( SizeValueType label = 0; label <= numberOfComponents; ++label )
+      {
+      sizes[label].store( 0, std::memory_order_relaxed );
+      }
+    }
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        for ( SizeValueType r = chunkBegin( chunk ); r < chunkBegin( chunk + 1 ); ++r )
+          {
+          if ( !sets.IsRoot( r ) )
+            {
+            runLabels[r] = runLabels[sets.Find( r )];
+            }
+          if ( relabel )
+            {
+            sizes[runLabels[r]].fetch_add( static_cast<SizeValueType>( runs[r].end - runs[r].start + 1 ), std::memory_order_relaxed );
+            }
+          }
+      },
+    nullptr );
+
+  // the label of each component in the output
+  std::vector<SizeValueType> outputLabels( numberOfComponents + 1 );
+  std::iota( outputLabels.begin(), outputLabels.end(), 0 );
+  SizeValueType numberOfObjects = numberOfComponents;
+  if ( relabel )
+    {
+    std::vector<SizeValueType> order( numberOfComponents );
+    std::iota( order.begin(), order.end(), 1 );
+    if ( this->m_SortByObjectSize )
+      {
+      // the ties keep their raster order
+      std::stable_sort( order.begin(),
+                        order.end(),
+                        [&sizes]( SizeValueType a, SizeValueType b )
+                          {
+                            return sizes[a].load( std::memory_order_relaxed ) > sizes[b].load( std::memory_order_relaxed );
+                          } );
+      }
+
+    numberOfObjects = 0;
+    outputLabels.assign( numberOfComponents + 1, 0 );
+    for ( const SizeValueType label : order )
+      {
+      if ( this->m_NumberOfObjectsToKeep > 0 && numberOfObjects == this->m_NumberOfObjectsToKeep )
+        {
+        break;
+        }
+      if ( sizes[label].load( std::memory_order_relaxed ) >= this->m_MinimumObjectSize )
+        {
+        outputLabels[label] = ++numberOfObjects;
+        }
+      }
+    }
+
+  if ( numberOfObjects > static_cast<SizeValueType>( NumericTraits<OutputPixelType>::max() ) )
+    {
+    itkExceptionMacro( "The number of objects, " << numberOfObjects
+                       << ", is greater than the maximum of the output pixel type." );
+    }
+
+  // write the labels of the runs
+  OutputPixelType *buffer = output->GetBufferPointer();
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        for ( const IndexType &index : pieceLines[piece].indices )
+          {
+          OutputPixelType *outputLine = buffer + output->ComputeOffset( index );
+          std::fill_n( outputLine, lineLength, NumericTraits<OutputPixelType>::ZeroValue() );
+
+          const SizeValueType line = lineNumber( index );
+          for ( SizeValueType r = lineFirstRun[line]; r < lineFirstRun[line + 1]; ++r )
+            {
+            const OutputPixelType label = static_cast<OutputPixelType>( outputLabels[runLabels[r]] );
+            std::fill( outputLine + runs[r].start, outputLine + runs[r].end + 1, label );
+            }
+          }
+      },
+    this );
+
+  this->m_ObjectCount = numberOfObjects;
+  this->m_OriginalObjectCount = numberOfComponents;
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage, class TMaskImage >
+void
+ParallelConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+
+  // the labels depend on the whole image
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage, class TMaskImage >
+void
+ParallelConnectedComponentImageFilter< TInputImage, TOutputImage, TMaskImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
+  os << indent << "SortByObjectSize: " << m_SortByObjectSize << std::endl;
+  os << indent << "MinimumObjectSize: " << m_MinimumObjectSize << std::endl;
+  os << indent << "NumberOfObjectsToKeep: " << m_NumberOfObjectsToKeep << std::endl;
+  os << indent << "ObjectCount: " << m_ObjectCount << std::endl;
+  os << indent << "OriginalObjectCount: " << m_OriginalObjectCount << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelConnectedComponentImageFilter_hxx
@@ -0,0 +1,110 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelFastMarchingImageFilter_h
+#define itkParallelFastMarchingImageFilter_h
+
+#include "itkFastMarchingImageFilter.h"
+
+
+namespace itk {
+
+/** \class ParallelFastMarchingImageFilter
+ * \brief Fast marching with the parallel fast iterative method.
+ *
+ * When UseFastIterativeMethod is on, the arrival times are computed
+ * with the fast iterative method of Jeong and Whitaker instead of the
+ * heap of the FastMarchingImageFilter: a list of active pixels is
+ * updated in parallel with the same first order upwind solution,
+ * until their values converge. The converged pixels are removed from
+ * the list, and activate their neighbors whose value decreases.
+ *
+ * The result converges to the solution of the fast marching, up to a
+ * relative tolerance of the updates. The trial points keep their
+ * values, and the front propagates from them as with the superclass.
+ * The pixels reached at more than the StoppingValue keep the large
+ * value, and the alive points are only used as fixed values. The
+ * measurement of the processed points is not supported.
+ *
+ * When UseFastIterativeMethod is off, the superclass algorithm is
+ * used.
+ *
+ * Reference: W.-K. Jeong and R. T. Whitaker, "A Fast Iterative Method
+ * for Eikonal Equations", SIAM Journal on Scientific Computing, 30(5):
+ * 2512-2534, 2008.
+ *
+ * \sa FastMarchingImageFilter
+ */
+template < class TLevelSet, class TSpeedImage >
+class ParallelFastMarchingImageFilter:
+    public FastMarchingImageFilter< TLevelSet, TSpeedImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelFastMarchingImageFilter;
+  using Superclass = FastMarchingImageFilter< TLevelSet, TSpeedImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using typename Superclass::LevelSetImageType;
+  using typename Superclass::SpeedImageType;
+  using typename Superclass::PixelType;
+  using typename Superclass::NodeType;
+  using typename Superclass::NodeContainer;
+  using IndexType = typename LevelSetImageType::IndexType;
+  using RegionType = typename LevelSetImageType::RegionType;
+
+  static constexpr unsigned int SetDimension = Superclass::SetDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelFastMarchingImageFilter, FastMarchingImageFilter);
+
+  /** Whether the fast iterative method is used. Off by default. */
+  itkSetMacro( UseFastIterativeMethod, bool );
+  itkGetConstMacro( UseFastIterativeMethod, bool );
+  itkBooleanMacro( UseFastIterativeMethod );
+
+protected:
+
+  ParallelFastMarchingImageFilter() = default;
+
+  ~ParallelFastMarchingImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The active pixels are updated by the threads of the multithreader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ParallelFastMarchingImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_UseFastIterativeMethod{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelFastMarchingImageFilter.hxx"
+
+#endif // itkParallelFastMarchingImageFilter_h
@@ -0,0 +1,322 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelFastMarchingImageFilter_hxx
+#define itkParallelFastMarchingImageFilter_hxx
+
+#include "itkParallelFastMarchingImageFilter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TLevelSet, class TSpeedImage >
+void
+ParallelFastMarchingImageFilter< TLevelSet, TSpeedImage >::GenerateData()
+{
+  if ( !m_UseFastIterativeMethod )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  if ( this->GetCollectPoints() )
+    {
+    itkExceptionMacro( "The processed points are not collected by the fast iterative method!" );
+    }
+
+  // the relative decrease of an active value below which it has
+  // converged
+  constexpr double RelativeTolerance = 1e-6;
+
+  // the states of the pixels
+  enum : uint8_t { FarPoint = 0, ActivePoint, FixedPoint };
+
+  LevelSetImageType *output = this->GetOutput();
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
+
+  const RegionType region = output->GetBufferedRegion();
+  const PixelType largeValue = static_cast<PixelType>( NumericTraits<PixelType>::max() / 2.0 );
+  output->FillBuffer( largeValue );
+  PixelType *values = output->GetBufferPointer();
+
+  const SpeedImageType *speedImage = this->GetInput();
+  if ( speedImage && !speedImage->GetBufferedRegion().IsInside( region ) )
+    {
+    itkExceptionMacro( "The speed image does not contain the region " << region << " of the output!" );
+    }
+
+  std::vector< std::atomic<uint8_t> > states( region.GetNumberOfPixels() );
+
+  const double stoppingValue = this->GetStoppingValue();
+  const double normalizationFactor = this->GetNormalizationFactor();
+  const double speedConstant = this->GetSpeedConstant();
+
+  double spaceFactors[SetDimension];
+  OffsetValueType strides[SetDimension];
+  for ( unsigned int d = 0; d < SetDimension; ++d )
+    {
+    spaceFactors[d] = 1.0 / ( output->GetSpacing()[d] * output->GetSpacing()[d] );
+    strides[d] = output->GetOffsetTable()[d];
+    }
+
+  auto isInside = [&region]( const IndexType &index, unsigned int d, IndexValueType step )
+    {
+      const IndexValueType i = index[d] + step;
+      return i >= region.GetIndex( d ) && i < region.GetIndex( d ) + static_cast<IndexValueType>( region.GetSize( d ) );
+    };
+
+  // the first order upwind solution of a pixel from the current values
+  // of its neighbors, as in FastMarchingImageFilter::UpdateValue
+  auto solve = [&]( OffsetValueType offset ) -> double
+    {
+      const IndexType index = output->ComputeIndex( offset );
+
+      double speed = speedConstant;
+      if ( speedImage )
+        {
+        speed = static_cast<double>( speedImage->GetPixel( index ) ) / normalizationFactor;
+        }
+      double cc = -1.0 / ( speed * speed );
+
+      // the smallest neighbor of each dimension, sorted, with the space
+      // factor of its dimension
+      std::pair<double, double> neighbors[SetDimension];
+      unsigned int numberOfNeighbors = 0;
+      for ( unsigned int d = 0; d < SetDimension; ++d )
+        {
+        PixelType neighbor = largeValue;
+        if ( isInside( index, d, -1 ) )
+          {
+          neighbor = values[offset - strides[d]];
+          }
+        if ( isInside( index, d, 1 ) )
+          {
+          neighbor = std::min( neighbor, values[offset + strides[d]] );
+          }
+        if ( neighbor < largeValue )
+          {
+          unsigned int i = numberOfNeighbors++;
+          for ( ; i > 0 && neighbors[i - 1].first > neighbor; --i )
+            {
+            neighbors[i] = neighbors[i - 1];
+            }
+          neighbors[i] = std::make_pair( static_cast<double>( neighbor ), spaceFactors[d] );
+          }
+        }
+
+      double solution = largeValue;
+      double aa = 0.0;
+      double bb = 0.0;
+      for ( unsigned int j = 0; j < numberOfNeighbors && solution >= neighbors[j].first; ++j )
+        {
+        const double value = neighbors[j].first;
+        const double spaceFactor = neighbors[j].second;
+        aa += spaceFactor;
+        bb += value * spaceFactor;
+        cc += value * value * spaceFactor;
+
+        const double discrim = bb * bb - aa * cc;
+        if ( discrim < 0.0 )
+          {
+          itkExceptionMacro( "Discriminant of quadratic equation is negative" );
+          }
+        solution = ( std::sqrt( discrim ) + bb ) / aa;
+        }
+      return solution;
+    };
+
+  using ActivatedType = std::vector< std::pair<OffsetValueType, PixelType> >;
+
+  // Activate the far neighbors of a converged pixel whose value
+  // decreases by more than the tolerance. The values of the activated pixels are written after all
+  // the pixels are processed.
+  auto activateNeighbors = [&]( OffsetValueType offset, ActivatedType &activated )
+    {
+      const IndexType index = output->ComputeIndex( offset );
+      for ( unsigned int d = 0; d < SetDimension; ++d )
+        {
+        for ( IndexValueType step = -1; step <= 1; step += 2 )
+          {
+          if ( !isInside( index, d, step ) )
+            {
+            continue;
+            }
+          const OffsetValueType neighbor = offset + step * strides[d];
+          if ( states[neighbor].load() != FarPoint )
+            {
+            continue;
+            }
+          const double solution = solve( neighbor );
+          const double previous = values[neighbor];
+          uint8_t expected = FarPoint;
+          if ( previous - solution > RelativeTolerance * previous && solution <= stoppingValue &&
+               states[neighbor].compare_exchange_strong( expected, ActivePoint ) )
+            {
+            activated.emplace_back( neighbor, static_cast<PixelType>( solution ) );
+            }
+          }
+        }
+    };
+
+  // the alive and the trial points keep their values
+  std::vector<OffsetValueType> trialOffsets;
+  auto fix = [&]( NodeContainer *nodes, bool trial )
+    {
+      if ( !nodes )
+        {
+        return;
+        }
+      for ( auto it = nodes->Begin(); it != nodes->End(); ++it )
+        {
+        const NodeType &node = it.Value();
+        if ( !region.IsInside( node.GetIndex() ) )
+          {
+          continue;
+          }
+        const OffsetValueType offset = output->ComputeOffset( node.GetIndex() );
+        values[offset] = node.GetValue();
+        states[offset] = FixedPoint;
+        if ( trial && node.GetValue() <= stoppingValue )
+          {
+          trialOffsets.push_back( offset );
+          }
+        }
+    };
+  fix( this->GetAlivePoints(), false );
+  fix( this->GetTrialPoints(), true );
+
+  // the neighbors of the trial points start the active list
+  std::vector<OffsetValueType> active;
+  {
+  ActivatedType activated;
+  for ( OffsetValueType offset : trialOffsets )
+    {
+    activateNeighbors( offset, activated );
+    }
+  for ( const auto &pixel : activated )
+    {
+    values[pixel.first] = pixel.second;
+    active.push_back( pixel.first );
+    }
+  }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  while ( !active.empty() )
+    {
+    const SizeValueType numberOfActive = active.size();
+    const SizeValueType numberOfChunks = std::min<SizeValueType>( numberOfActive, 4 * this->GetNumberOfWorkUnits() );
+    auto chunkBegin = [numberOfActive, numberOfChunks]( SizeValueType chunk )
+      {
+        return chunk * numberOfActive / numberOfChunks;
+      };
+
+    // update the active pixels from the values of the previous round
+    std::vector<PixelType> updated( numberOfActive );
+    std::vector<uint8_t> converged( numberOfActive );
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&]( SizeValueType chunk )
+        {
+          for ( SizeValueType i = chunkBegin( chunk ); i < chunkBegin( chunk + 1 ); ++i )
+            {
+            const double previous = values[active[i]];
+            const double solution = solve( active[i] );
+            updated[i] = static_cast<PixelType>( std::min( previous, solution ) );
+            converged[i] = ( previous - solution <= RelativeTolerance * previous );
+            }
+        },
+      nullptr );
+
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&]( SizeValueType chunk )
+        {
+          for ( SizeValueType i = chunkBegin( chunk ); i < chunkBegin( chunk + 1 ); ++i )
+            {
+            values[active[i]] = updated[i];
+            if ( converged[i] )
+              {
+              states[active[i]] = FarPoint;
+              }
+            }
+        },
+      nullptr );
+
+    // the converged pixels leave the list, and activate their neighbors
+    std::vector<ActivatedType> activated( numberOfChunks );
+    std::vector< std::vector<OffsetValueType> > kept( numberOfChunks );
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&]( SizeValueType chunk )
+        {
+          for ( SizeValueType i = chunkBegin( chunk ); i < chunkBegin( chunk + 1 ); ++i )
+            {
+            if ( converged[i] )
+              {
+              activateNeighbors( active[i], activated[chunk] );
+              }
+            else
+              {
+              kept[chunk].push_back( active[i] );
+              }
+            }
+        },
+      nullptr );
+
+    active.clear();
+    for ( SizeValueType chunk = 0; chunk < numberOfChunks; ++chunk )
+      {
+      active.insert( active.end(), kept[chunk].begin(), kept[chunk].end() );
+      for ( const auto &pixel : activated[chunk] )
+        {
+        values[pixel.first] = pixel.second;
+        active.push_back( pixel.first );
+        }
+      }
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TLevelSet, class TSpeedImage >
+void
+ParallelFastMarchingImageFilter< TLevelSet, TSpeedImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseFastIterativeMethod: " << m_UseFastIterativeMethod << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelFastMarchingImageFilter_hxx
@@ -0,0 +1,139 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelImageMomentsCalculator_h
+#define itkParallelImageMomentsCalculator_h
+
+#include "itkObject.h"
+#include "itkMatrix.h"
+#include "itkMultiThreaderBase.h"
+#include "itkVector.h"
+
+#include <limits>
+
+
+namespace itk {
+
+/** \class ParallelImageMomentsCalculator
+ * \brief Compute the total mass, the center of gravity, the central
+ * moments and the principal axes of an image with all the threads.
+ *
+ * The moments are those of the physical coordinates of the
+ * ImageMomentsCalculator, and are accumulated in double by the
+ * threads for consecutive rows of the image, which are summed in
+ * order.
+ *
+ * With a SamplingFactor larger than 1 only every SamplingFactor-th
+ * pixel along each dimension is included, centered in the image, for
+ * an approximation of the moments from fewer pixels. Only the pixels
+ * not below the LowerThreshold are included, which masks a background
+ * darker than the objects without a separate mask image, and skips
+ * the accumulation for its pixels.
+ *
+ * An exception is thrown when the total mass is zero.
+ *
+ * \sa ImageMomentsCalculator
+ */
+template < class TImage >
+class ParallelImageMomentsCalculator:
+    public Object
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelImageMomentsCalculator;
+  using Superclass = Object;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using ImageType = TImage;
+  using PixelType = typename TImage::PixelType;
+
+  static constexpr unsigned int ImageDimension = TImage::ImageDimension;
+
+  using VectorType = Vector< double, ImageDimension >;
+  using MatrixType = Matrix< double, ImageDimension, ImageDimension >;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelImageMomentsCalculator, Object);
+
+  itkSetConstObjectMacro(Image, ImageType);
+  itkGetConstObjectMacro(Image, ImageType);
+
+  /** Set/Get the step between the included pixels along each
+   * dimension, 1 by default. */
+  itkSetClampMacro(SamplingFactor, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(SamplingFactor, unsigned int);
+
+  /** Set/Get the value below which the pixels are not included, the
+   * lowest value by default. */
+  itkSetMacro(LowerThreshold, double);
+  itkGetConstMacro(LowerThreshold, double);
+
+  /** Set/Get the number of work units, all by default. */
+  itkSetMacro(NumberOfWorkUnits, unsigned int);
+  itkGetConstMacro(NumberOfWorkUnits, unsigned int);
+
+  /** Compute the moments of the image. */
+  void Compute();
+
+  /** The moments of the last Compute. @{ */
+  itkGetConstMacro(TotalMass, double);
+  itkGetConstReferenceMacro(CenterOfGravity, VectorType);
+  itkGetConstReferenceMacro(CentralMoments, MatrixType);
+  /** @} */
+
+  /** The principal axes of the CentralMoments in the rows, as the
+   * ImageMomentsCalculator, reflected to be a proper rotation. */
+  itkGetConstReferenceMacro(PrincipalAxes, MatrixType);
+
+  /** The number of pixels included by the last Compute. */
+  itkGetConstMacro(NumberOfSamples, SizeValueType);
+
+protected:
+
+  ParallelImageMomentsCalculator();
+
+  ~ParallelImageMomentsCalculator() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ParallelImageMomentsCalculator(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  typename ImageType::ConstPointer m_Image;
+  unsigned int m_SamplingFactor{1};
+  double m_LowerThreshold{std::numeric_limits< double >::lowest()};
+  unsigned int m_NumberOfWorkUnits{0};
+
+  double m_TotalMass{0.0};
+  VectorType m_CenterOfGravity;
+  MatrixType m_CentralMoments;
+  MatrixType m_PrincipalAxes;
+  SizeValueType m_NumberOfSamples{0};
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelImageMomentsCalculator.hxx"
+
+#endif // itkParallelImageMomentsCalculator_h
@@ -0,0 +1,218 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelImageMomentsCalculator_hxx
+#define itkParallelImageMomentsCalculator_hxx
+
+#include "itkParallelImageMomentsCalculator.h"
+
+#include "vnl/algo/vnl_determinant.h"
+#include "vnl/algo/vnl_symmetric_eigensystem.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk {
+
+template < class TImage >
+ParallelImageMomentsCalculator< TImage >::ParallelImageMomentsCalculator()
+{
+  m_CenterOfGravity.Fill( 0.0 );
+  m_CentralMoments.Fill( 0.0 );
+  m_PrincipalAxes.SetIdentity();
+}
+
+
+//
+// Compute
+//
+template < class TImage >
+void
+ParallelImageMomentsCalculator< TImage >::Compute()
+{
+  if ( !m_Image )
+    {
+    itkExceptionMacro( "The image is not set!" );
+    }
+
+  using IndexType = typename ImageType::IndexType;
+
+  const typename ImageType::RegionType region = m_Image->GetBufferedRegion();
+  const SizeValueType step = m_SamplingFactor;
+
+  // the sampled pixels along each dimension, centered in the image
+  IndexType first;
+  SizeValueType counts[ImageDimension];
+  SizeValueType numberOfRows = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const SizeValueType size = region.GetSize( d );
+    const SizeValueType offset = ( size > 0 ) ? ( ( size - 1 ) % step ) / 2 : 0;
+    first[d] = region.GetIndex( d ) + static_cast< IndexValueType >( offset );
+    counts[d] = ( size > 0 ) ? ( size - 1 - offset ) / step + 1 : 0;
+    if ( d > 0 )
+      {
+      numberOfRows *= counts[d];
+      }
+    }
+
+  // the physical step between the sampled pixels of a row
+  VectorType rowStep;
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    rowStep[i] = m_Image->GetDirection()[i][0] * m_Image->GetSpacing()[0] * static_cast< double >( step );
+    }
+
+  struct Moments
+  {
+    Moments()
+      {
+        first.Fill( 0.0 );
+        second.Fill( 0.0 );
+      }
+    double mass{ 0.0 };
+    VectorType first;
+    MatrixType second;
+    SizeValueType samples{ 0 };
+  };
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  if ( m_NumberOfWorkUnits > 0 )
+    {
+    threader->SetNumberOfWorkUnits( m_NumberOfWorkUnits );
+    }
+  const SizeValueType numberOfChunks = std::max< SizeValueType >(
+    std::min< SizeValueType >( numberOfRows, threader->GetNumberOfWorkUnits() ), 1 );
+  std::vector< Moments > chunks( numberOfChunks );
+
+  const PixelType *buffer = m_Image->GetBufferPointer();
+  const double lowerThreshold = m_LowerThreshold;
+  const SizeValueType rowLength = counts[0];
+
+  threader->ParallelizeArray(
+    0,
+    numberOfChunks,
+    [&]( SizeValueType chunk )
+      {
+        Moments &moments = chunks[chunk];
+        for ( SizeValueType row = chunk * numberOfRows / numberOfChunks; row < ( chunk + 1 ) * numberOfRows / numberOfChunks; ++row )
+          {
+          IndexType index = first;
+          SizeValueType position = row;
+          for ( unsigned int d = 1; d < ImageDimension; ++d )
+            {
+            index[d] += static_cast< IndexValueType >( ( position % counts[d] ) * step );
+            position /= counts[d];
+            }
+
+          typename ImageType::PointType start;
+          m_Image->TransformIndexToPhysicalPoint( index, start );
+          const PixelType *pixels = buffer + m_Image->ComputeOffset( index );
+
+          for ( SizeValueType x = 0; x < rowLength; ++x )
+            {
+            const double value = static_cast< double >( pixels[x * step] );
+            if ( value < lowerThreshold )
+              {
+              continue;
+              }
+
+            double point[ImageDimension];
+            for ( unsigned int i = 0; i < ImageDimension; ++i )
+              {
+              point[i] = start[i] + static_cast< double >( x ) * rowStep[i];
+              }
+
+            moments.mass += value;
+            for ( unsigned int i = 0; i < ImageDimension; ++i )
+              {
+              moments.first[i] += point[i] * value;
+              for ( unsigned int j = 0; j < ImageDimension; ++j )
+                {
+                moments.second[i][j] += value * point[i] * point[j];
+                }
+              }
+            ++moments.samples;
+            }
+          }
+      },
+    nullptr );
+
+  // the sums of the chunks, in order
+  Moments total;
+  for ( const Moments &moments : chunks )
+    {
+    total.mass += moments.mass;
+    total.first += moments.first;
+    total.second += moments.second;
+    total.samples += moments.samples;
+    }
+
+  m_NumberOfSamples = total.samples;
+  m_TotalMass = total.mass;
+  if ( total.mass == 0.0 )
+    {
+    itkExceptionMacro( "The total mass of the image is zero!" );
+    }
+
+  // normalize by the total mass, and center the second order moments
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_CenterOfGravity[i] = total.first[i] / total.mass;
+    }
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    for ( unsigned int j = 0; j < ImageDimension; ++j )
+      {
+      m_CentralMoments[i][j] = total.second[i][j] / total.mass - m_CenterOfGravity[i] * m_CenterOfGravity[j];
+      }
+    }
+
+  // the principal axes, with the last one reflected as the
+  // ImageMomentsCalculator for a proper rotation
+  const vnl_symmetric_eigensystem< double > eigen( m_CentralMoments.GetVnlMatrix().as_matrix() );
+  m_PrincipalAxes = eigen.V.transpose();
+  const double determinant = vnl_determinant( m_PrincipalAxes.GetVnlMatrix().as_matrix() );
+  for ( unsigned int i = 0; i < ImageDimension; ++i )
+    {
+    m_PrincipalAxes[ImageDimension - 1][i] *= determinant;
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TImage >
+void
+ParallelImageMomentsCalculator< TImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "SamplingFactor: " << m_SamplingFactor << std::endl;
+  os << indent << "LowerThreshold: " << m_LowerThreshold << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+  os << indent << "TotalMass: " << m_TotalMass << std::endl;
+  os << indent << "CenterOfGravity: " << m_CenterOfGravity << std::endl;
+  os << indent << "CentralMoments: " << std::endl << m_CentralMoments;
+  os << indent << "PrincipalAxes: " << std::endl << m_PrincipalAxes;
+  os << indent << "NumberOfSamples: " << m_NumberOfSamples << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelImageMomentsCalculator_hxx
@@ -0,0 +1,109 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelLabelImageToLabelMapFilter_h
+#define itkParallelLabelImageToLabelMapFilter_h
+
+#include "itkImageToImageFilter.h"
+
+
+namespace itk {
+
+/** \class ParallelLabelImageToLabelMapFilter
+ * \brief Convert a label image to a run-length LabelMap with all the
+ * threads.
+ *
+ * The output is the same as with the LabelImageToLabelMapFilter: each
+ * label other than the BackgroundValue is a label object made of the
+ * runs of its pixels along the first dimension.
+ *
+ * The image is split along the slowest dimension, and each thread
+ * collects the runs of its part in its own lists. The label objects
+ * are then created once, and the lists of each label are appended in
+ * parallel, in the order of the parts, so the lines of the objects
+ * stay sorted.
+ *
+ * \sa LabelImageToLabelMapFilter, ParallelLabelMapToLabelImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class ParallelLabelImageToLabelMapFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelLabelImageToLabelMapFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using RegionType = typename TInputImage::RegionType;
+  using LabelObjectType = typename TOutputImage::LabelObjectType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelLabelImageToLabelMapFilter, ImageToImageFilter);
+
+  /** Set/Get the value of the pixels which are not in a label
+   * object. Defaults to NumericTraits<OutputPixelType>::NonpositiveMin(). */
+  itkSetMacro( BackgroundValue, OutputPixelType );
+  itkGetConstMacro( BackgroundValue, OutputPixelType );
+
+protected:
+
+  ParallelLabelImageToLabelMapFilter();
+
+  ~ParallelLabelImageToLabelMapFilter() override = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  //
+  // The runs are collected by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  ParallelLabelImageToLabelMapFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  OutputPixelType m_BackgroundValue;
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelLabelImageToLabelMapFilter.hxx"
+
+#endif // itkParallelLabelImageToLabelMapFilter_h
@@ -0,0 +1,223 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelLabelImageToLabelMapFilter_hxx
+#define itkParallelLabelImageToLabelMapFilter_hxx
+
+#include "itkParallelLabelImageToLabelMapFilter.h"
+
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineConstIterator.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace itk {
+
+//
+// Constructor
+//
+template < class TInputImage, class TOutputImage >
+ParallelLabelImageToLabelMapFilter< TInputImage, TOutputImage >::ParallelLabelImageToLabelMapFilter()
+{
+  this->m_BackgroundValue = NumericTraits< OutputPixelType >::NonpositiveMin();
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelImageToLabelMapFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  using IndexType = typename RegionType::IndexType;
+  using LineType = typename LabelObjectType::LineType;
+  using LineContainerType = std::vector<LineType>;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  output->SetBackgroundValue( this->m_BackgroundValue );
+  output->ClearLabels();
+
+  const RegionType region = output->GetRequestedRegion();
+
+  auto splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfWorkUnits(), 1u ) );
+
+  // the runs of each label in a part of the image, sorted by label
+  // after the traversal
+  struct PieceRuns
+  {
+    std::vector< std::pair<OutputPixelType, size_t> > labels;
+    std::vector< LineContainerType >                  lines;
+  };
+  std::vector<PieceRuns> pieceRuns( numberOfPieces );
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        RegionType pieceRegion = region;
+        splitter->GetSplit( static_cast<unsigned int>( piece ), numberOfPieces, pieceRegion );
+
+        PieceRuns &runs = pieceRuns[piece];
+        std::unordered_map<OutputPixelType, size_t> positions;
+        const SizeValueType lineLength = pieceRegion.GetSize( 0 );
+
+        ImageScanlineConstIterator<InputImageType> it( input, pieceRegion );
+        while ( !it.IsAtEnd() )
+          {
+          IndexType index = it.GetIndex();
+          const InputPixelType *line = input->GetBufferPointer() + input->ComputeOffset( index );
+
+          // one lookup per run instead of one per pixel
+          SizeValueType x = 0;
+          while ( x < lineLength )
+            {
+            const InputPixelType value = line[x];
+            SizeValueType end = x + 1;
+            while ( end < lineLength && line[end] == value )
+              {
+              ++end;
+              }
+
+            const OutputPixelType label = static_cast<OutputPixelType>( value );
+            if ( label != this->m_BackgroundValue )
+              {
+              auto inserted = positions.emplace( label, runs.lines.size() );
+              if ( inserted.second )
+                {
+                runs.lines.emplace_back();
+                }
+              IndexType start = index;
+              start[0] += static_cast<IndexValueType>( x );
+              runs.lines[inserted.first->second].push_back( LineType( start, end - x ) );
+              }
+            x = end;
+            }
+          it.NextLine();
+          }
+
+        runs.labels.assign( positions.begin(), positions.end() );
+        std::sort( runs.labels.begin(), runs.labels.end() );
+      },
+    nullptr );
+
+  // create the label objects once, in the order of the labels
+  std::vector<OutputPixelType> labels;
+  for ( const PieceRuns &runs : pieceRuns )
+    {
+    for ( const auto &label : runs.labels )
+      {
+      labels.push_back( label.first );
+      }
+    }
+  std::sort( labels.begin(), labels.end() );
+  labels.erase( std::unique( labels.begin(), labels.end() ), labels.end() );
+
+  std::vector<LabelObjectType *> labelObjects;
+  labelObjects.reserve( labels.size() );
+  for ( const OutputPixelType label : labels )
+    {
+    typename LabelObjectType::Pointer labelObject = LabelObjectType::New();
+    labelObject->SetLabel( label );
+    output->AddLabelObject( labelObject );
+    labelObjects.push_back( labelObject.GetPointer() );
+    }
+
+  // each thread appends the lines of its labels
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    labels.size(),
+    [&]( SizeValueType i )
+      {
+        const OutputPixelType label = labels[i];
+        LabelObjectType *labelObject = labelObjects[i];
+        for ( const PieceRuns &runs : pieceRuns )
+          {
+          auto found = std::lower_bound( runs.labels.begin(),
+                                         runs.labels.end(),
+                                         label,
+                                         []( const std::pair<OutputPixelType, size_t> &a, OutputPixelType b )
+                                           { return a.first < b; } );
+          if ( found != runs.labels.end() && found->first == label )
+            {
+            for ( const LineType &line : runs.lines[found->second] )
+              {
+              labelObject->AddLine( line );
+              }
+            }
+          }
+      },
+    this );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelImageToLabelMapFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelImageToLabelMapFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelImageToLabelMapFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "BackgroundValue: "
+     << static_cast< typename NumericTraits< OutputPixelType >::PrintType >( m_BackgroundValue ) << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelLabelImageToLabelMapFilter_hxx
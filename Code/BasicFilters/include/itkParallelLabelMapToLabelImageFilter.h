@@ -0,0 +1,97 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelLabelMapToLabelImageFilter_h
+#define itkParallelLabelMapToLabelImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+
+namespace itk {
+
+/** \class ParallelLabelMapToLabelImageFilter
+ * \brief Convert a run-length LabelMap to a label image with all the
+ * threads.
+ *
+ * The output is the same as with the LabelMapToLabelImageFilter: the
+ * pixels of each label object have its label, and the others the
+ * background value of the LabelMap.
+ *
+ * The background is filled by the threads of the multithreader, then
+ * the lines of the label objects, which do not overlap, are written
+ * by the threads in parallel, one label object at a time.
+ *
+ * \sa LabelMapToLabelImageFilter, ParallelLabelImageToLabelMapFilter
+ */
+template < class TInputImage, class TOutputImage >
+class ParallelLabelMapToLabelImageFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelLabelMapToLabelImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using LabelObjectType = typename TInputImage::LabelObjectType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelLabelMapToLabelImageFilter, ImageToImageFilter);
+
+protected:
+
+  ParallelLabelMapToLabelImageFilter() = default;
+
+  ~ParallelLabelMapToLabelImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The output is written by the threads of the multithreader.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  ParallelLabelMapToLabelImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelLabelMapToLabelImageFilter.hxx"
+
+#endif // itkParallelLabelMapToLabelImageFilter_h
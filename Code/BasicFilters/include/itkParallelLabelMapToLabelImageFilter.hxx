@@ -0,0 +1,121 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelLabelMapToLabelImageFilter_hxx
+#define itkParallelLabelMapToLabelImageFilter_hxx
+
+#include "itkParallelLabelMapToLabelImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelMapToLabelImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const OutputPixelType background = static_cast<OutputPixelType>( input->GetBackgroundValue() );
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    output->GetRequestedRegion(),
+    [output, background]( const RegionType &region )
+      {
+        ImageScanlineIterator<OutputImageType> it( output, region );
+        while ( !it.IsAtEnd() )
+          {
+          while ( !it.IsAtEndOfLine() )
+            {
+            it.Set( background );
+            ++it;
+            }
+          it.NextLine();
+          }
+      },
+    nullptr );
+
+  std::vector<const LabelObjectType *> labelObjects;
+  labelObjects.reserve( input->GetNumberOfLabelObjects() );
+  for ( typename InputImageType::ConstIterator it( input ); !it.IsAtEnd(); ++it )
+    {
+    labelObjects.push_back( it.GetLabelObject() );
+    }
+
+  // the label objects do not overlap, so their lines are written
+  // concurrently
+  OutputPixelType *buffer = output->GetBufferPointer();
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    labelObjects.size(),
+    [&labelObjects, output, buffer]( SizeValueType i )
+      {
+        const LabelObjectType *labelObject = labelObjects[i];
+        const OutputPixelType label = static_cast<OutputPixelType>( labelObject->GetLabel() );
+        for ( typename LabelObjectType::ConstLineIterator lit( labelObject ); !lit.IsAtEnd(); ++lit )
+          {
+          const typename LabelObjectType::LineType &line = lit.GetLine();
+          std::fill_n( buffer + output->ComputeOffset( line.GetIndex() ), line.GetLength(), label );
+          }
+      },
+    this );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelMapToLabelImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelLabelMapToLabelImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelLabelMapToLabelImageFilter_hxx
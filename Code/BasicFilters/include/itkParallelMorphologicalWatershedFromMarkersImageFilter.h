@@ -0,0 +1,110 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelMorphologicalWatershedFromMarkersImageFilter_h
+#define itkParallelMorphologicalWatershedFromMarkersImageFilter_h
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class ParallelMorphologicalWatershedFromMarkersImageFilter
+ * \brief Watershed from markers flooded in parallel blocks with a
+ * hierarchical queue.
+ *
+ * With ParallelFlooding off, the default, the filter is the
+ * MorphologicalWatershedFromMarkersImageFilter. With ParallelFlooding
+ * on, the image is divided in slabs between the threads of the
+ * multithreader, and each slab is flooded from its markers with a
+ * hierarchical queue: a bucket for each distinct pixel value, which
+ * holds a bucket for each number of steps on the plateau of that
+ * value. The floods then cross the borders of the slabs, in rounds
+ * where each slab floods again from the borders of its neighbors,
+ * until no border changes.
+ *
+ * A pixel is flooded at the lowest flooding level over the paths
+ * from the markers, the largest pixel value on the path, then with
+ * the fewest steps on the plateau of that level, and takes the
+ * smallest label of the neighbors it is flooded from. The labels are
+ * set in the same rounds as the levels. They do not depend on the
+ * slabs, so not on the number of threads. The flooding matches the
+ * flooding of the superclass except on the plateaus, where the
+ * superclass floods in the order of its queue. A watershed line pixel
+ * is a pixel with a neighbor of another label flooded before it.
+ *
+ * \sa MorphologicalWatershedFromMarkersImageFilter
+ */
+template < class TInputImage, class TLabelImage >
+class ParallelMorphologicalWatershedFromMarkersImageFilter:
+    public MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelMorphologicalWatershedFromMarkersImageFilter;
+  using Superclass = MorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using LabelImageType = TLabelImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using LabelPixelType = typename TLabelImage::PixelType;
+  using RegionType = typename TLabelImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TLabelImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelMorphologicalWatershedFromMarkersImageFilter, MorphologicalWatershedFromMarkersImageFilter);
+
+  /** Flood the slabs of the image in parallel. Off by default. */
+  itkSetMacro( ParallelFlooding, bool );
+  itkGetConstMacro( ParallelFlooding, bool );
+  itkBooleanMacro( ParallelFlooding );
+
+protected:
+
+  ParallelMorphologicalWatershedFromMarkersImageFilter() = default;
+
+  ~ParallelMorphologicalWatershedFromMarkersImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The slabs are flooded by the threads of the multithreader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ParallelMorphologicalWatershedFromMarkersImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_ParallelFlooding{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelMorphologicalWatershedFromMarkersImageFilter.hxx"
+
+#endif // itkParallelMorphologicalWatershedFromMarkersImageFilter_h
@@ -0,0 +1,519 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelMorphologicalWatershedFromMarkersImageFilter_hxx
+#define itkParallelMorphologicalWatershedFromMarkersImageFilter_hxx
+
+#include "itkParallelMorphologicalWatershedFromMarkersImageFilter.h"
+
+#include "itkImageRegionSplitterSlowDimension.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <type_traits>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TLabelImage >
+void
+ParallelMorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >::GenerateData()
+{
+  if ( !m_ParallelFlooding )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  using IndexType = typename RegionType::IndexType;
+  using OffsetType = typename RegionType::OffsetType;
+
+  // the flooding level of a pixel is the rank of its value, and its
+  // step the number of steps on the plateau of the level
+  using CostType = uint32_t;
+  constexpr CostType Unreached = std::numeric_limits<CostType>::max();
+
+  // the buckets of the hierarchical queue, by level and then by step
+  using QueueType = std::map< CostType, std::vector< std::vector<OffsetValueType> > >;
+
+  const InputImageType *input = this->GetInput();
+  const LabelImageType *markerImage = this->GetMarkerImage();
+
+  this->AllocateOutputs();
+  LabelImageType *output = this->GetOutput();
+
+  const RegionType region = output->GetBufferedRegion();
+  if ( input->GetBufferedRegion() != region || markerImage->GetBufferedRegion() != region )
+    {
+    itkExceptionMacro( "The input and marker regions do not match the output region " << region << "!" );
+    }
+
+  const InputPixelType *values = input->GetBufferPointer();
+  const LabelPixelType *markers = markerImage->GetBufferPointer();
+  LabelPixelType *labels = output->GetBufferPointer();
+  const SizeValueType numberOfPixels = region.GetNumberOfPixels();
+
+  // the slabs of the image, which own contiguous ranges of offsets
+  auto splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfWorkUnits(), 1u ) );
+  std::vector<OffsetValueType> pieceBegin( numberOfPieces + 1, static_cast<OffsetValueType>( numberOfPixels ) );
+  for ( unsigned int piece = 0; piece < numberOfPieces; ++piece )
+    {
+    RegionType pieceRegion = region;
+    splitter->GetSplit( piece, numberOfPieces, pieceRegion );
+    pieceBegin[piece] = output->ComputeOffset( pieceRegion.GetIndex() );
+    }
+  const OffsetValueType planeSize = static_cast<OffsetValueType>( numberOfPixels / region.GetSize( ImageDimension - 1 ) );
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // the distinct values of the image, which change a little along the
+  // lines
+  std::vector< std::vector<InputPixelType> > pieceValues( numberOfPieces );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        std::vector<InputPixelType> &distinct = pieceValues[piece];
+        size_t compacted = 0;
+        auto compact = [&distinct, &compacted]()
+          {
+            std::sort( distinct.begin(), distinct.end() );
+            distinct.erase( std::unique( distinct.begin(), distinct.end() ), distinct.end() );
+            compacted = distinct.size();
+          };
+        InputPixelType last = values[pieceBegin[piece]];
+        distinct.push_back( last );
+        for ( OffsetValueType o = pieceBegin[piece]; o < pieceBegin[piece + 1]; ++o )
+          {
+          if ( values[o] != last )
+            {
+            last = values[o];
+            distinct.push_back( last );
+            if ( distinct.size() > 2 * compacted + 4096 )
+              {
+              compact();
+              }
+            }
+          }
+        compact();
+      },
+    nullptr );
+
+  std::vector<InputPixelType> levelValues;
+  for ( const std::vector<InputPixelType> &distinct : pieceValues )
+    {
+    levelValues.insert( levelValues.end(), distinct.begin(), distinct.end() );
+    }
+  pieceValues.clear();
+  std::sort( levelValues.begin(), levelValues.end() );
+  levelValues.erase( std::unique( levelValues.begin(), levelValues.end() ), levelValues.end() );
+
+  // the level of a value, from a table for the integer values of a
+  // small enough range, or a binary search
+  std::vector<CostType> table;
+  const InputPixelType minimumValue = levelValues.front();
+  if ( std::is_integral<InputPixelType>::value )
+    {
+    const double range = static_cast<double>( levelValues.back() ) - static_cast<double>( minimumValue ) + 1.0;
+    if ( range <= 4.0 * levelValues.size() + 65536.0 )
+      {
+      table.resize( static_cast<SizeValueType>( range ) );
+      for ( size_t i = 0; i < levelValues.size(); ++i )
+        {
+        table[static_cast<SizeValueType>( levelValues[i] - minimumValue )] = static_cast<CostType>( i );
+        }
+      }
+    }
+  auto level = [&levelValues, &table, minimumValue]( InputPixelType value ) -> CostType
+    {
+      if ( !table.empty() )
+        {
+        return table[static_cast<SizeValueType>( value - minimumValue )];
+        }
+      return static_cast<CostType>( std::lower_bound( levelValues.begin(), levelValues.end(), value ) - levelValues.begin() );
+    };
+
+  // the neighbors, of the faces or of the whole neighborhood
+  std::vector<OffsetType> neighbors;
+  std::vector<OffsetValueType> neighborOffsets;
+  unsigned int neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    neighborhoodSize *= 3;
+    }
+  for ( unsigned int n = 0; n < neighborhoodSize; ++n )
+    {
+    OffsetType offset;
+    unsigned int position = n;
+    unsigned int nonzero = 0;
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      offset[d] = static_cast<OffsetValueType>( position % 3 ) - 1;
+      nonzero += ( offset[d] != 0 );
+      position /= 3;
+      }
+    if ( nonzero == 0 || ( nonzero > 1 && !this->GetFullyConnected() ) )
+      {
+      continue;
+      }
+    neighbors.push_back( offset );
+    neighborOffsets.push_back( output->ComputeOffset( region.GetIndex() + offset ) );
+    }
+  const IndexType first = region.GetIndex();
+  const IndexType last = region.GetUpperIndex();
+  auto isInside = [&first, &last]( const IndexType &index, const OffsetType &offset )
+    {
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        if ( index[d] + offset[d] < first[d] || index[d] + offset[d] > last[d] )
+          {
+          return false;
+          }
+        }
+      return true;
+    };
+
+  std::vector<CostType> levels( numberOfPixels, Unreached );
+  std::vector<CostType> steps( numberOfPixels, Unreached );
+  std::vector<uint8_t> borderChanged( numberOfPieces, 0 );
+
+  // the level and step of the pixel q on a path from a neighbor
+  auto extend = [&]( OffsetValueType q, CostType fromLevel, CostType fromStep )
+    {
+      const CostType toLevel = level( values[q] );
+      if ( toLevel > fromLevel )
+        {
+        return std::make_pair( toLevel, CostType( 0 ) );
+        }
+      return std::make_pair( fromLevel, fromStep + 1 );
+    };
+  auto isBorder = [&]( OffsetValueType o, unsigned int piece )
+    {
+      return o < pieceBegin[piece] + planeSize || o >= pieceBegin[piece + 1] - planeSize;
+    };
+
+  // relax the pixel q of a piece from a neighbor of level and step
+  auto relax = [&]( OffsetValueType q, CostType fromLevel, CostType fromStep, unsigned int piece, QueueType &queue )
+    {
+      if ( markers[q] != NumericTraits<LabelPixelType>::ZeroValue() )
+        {
+        return;
+        }
+      const std::pair<CostType, CostType> cost = extend( q, fromLevel, fromStep );
+      if ( cost < std::make_pair( levels[q], steps[q] ) )
+        {
+        levels[q] = cost.first;
+        steps[q] = cost.second;
+        std::vector< std::vector<OffsetValueType> > &bucket = queue[cost.first];
+        if ( bucket.size() <= cost.second )
+          {
+          bucket.resize( cost.second + 1 );
+          }
+        bucket[cost.second].push_back( q );
+        if ( isBorder( q, piece ) )
+          {
+          borderChanged[piece] = 1;
+          }
+        }
+    };
+
+  // flood a piece from the pixels of its queue, in the order of their
+  // levels and steps
+  auto flood = [&]( unsigned int piece, QueueType &queue )
+    {
+      while ( !queue.empty() )
+        {
+        auto bucket = queue.begin();
+        const CostType lowest = bucket->first;
+        for ( CostType s = 0; s < bucket->second.size(); ++s )
+          {
+          std::vector<OffsetValueType> pixels;
+          pixels.swap( bucket->second[s] );
+          for ( OffsetValueType o : pixels )
+            {
+            if ( levels[o] != lowest || steps[o] != s )
+              {
+              continue;
+              }
+            const IndexType index = output->ComputeIndex( o );
+            for ( size_t n = 0; n < neighbors.size(); ++n )
+              {
+              const OffsetValueType q = o + neighborOffsets[n];
+              if ( q >= pieceBegin[piece] && q < pieceBegin[piece + 1] && isInside( index, neighbors[n] ) )
+                {
+                relax( q, lowest, s, piece, queue );
+                }
+              }
+            }
+          }
+        queue.erase( bucket );
+        }
+    };
+
+  // the borders of the pieces, as they were at the end of the previous
+  // round
+  struct Border
+  {
+    OffsetValueType             begin;
+    std::vector<CostType>       levels;
+    std::vector<CostType>       steps;
+    std::vector<LabelPixelType> labels;
+  };
+  std::vector<Border> borders( 2 * numberOfPieces );
+  auto snapshot = [&]( bool withLabels )
+    {
+      for ( unsigned int piece = 0; piece < numberOfPieces; ++piece )
+        {
+        for ( unsigned int side = 0; side < 2; ++side )
+          {
+          Border &border = borders[2 * piece + side];
+          border.begin = side == 0 ? pieceBegin[piece] : pieceBegin[piece + 1] - planeSize;
+          if ( withLabels )
+            {
+            border.labels.assign( labels + border.begin, labels + border.begin + planeSize );
+            }
+          else
+            {
+            border.levels.assign( levels.begin() + border.begin, levels.begin() + border.begin + planeSize );
+            border.steps.assign( steps.begin() + border.begin, steps.begin() + border.begin + planeSize );
+            }
+          }
+        borderChanged[piece] = 0;
+        }
+    };
+  // the border of the neighbor of a piece which holds the pixel q
+  auto neighborBorder = [&]( OffsetValueType q, unsigned int piece ) -> const Border &
+    {
+      return q < pieceBegin[piece] ? borders[2 * piece - 1] : borders[2 * piece + 2];
+    };
+
+  // The levels and steps are the lowest over the paths from all the
+  // markers, which the floods of the pieces reach from their markers
+  // and then from the borders of their neighbors, until the borders do
+  // not change.
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        QueueType queue;
+        for ( OffsetValueType o = pieceBegin[piece]; o < pieceBegin[piece + 1]; ++o )
+          {
+          if ( markers[o] != NumericTraits<LabelPixelType>::ZeroValue() )
+            {
+            levels[o] = level( values[o] );
+            steps[o] = 0;
+            auto &bucket = queue[levels[o]];
+            bucket.resize( 1 );
+            bucket[0].push_back( o );
+            }
+          }
+        flood( static_cast<unsigned int>( piece ), queue );
+      },
+    nullptr );
+
+  bool changed = numberOfPieces > 1;
+  while ( changed )
+    {
+    snapshot( false );
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfPieces,
+      [&]( SizeValueType piece )
+        {
+          QueueType queue;
+          for ( int neighborPiece : { static_cast<int>( piece ) - 1, static_cast<int>( piece ) + 1 } )
+            {
+            if ( neighborPiece < 0 || neighborPiece >= static_cast<int>( numberOfPieces ) )
+              {
+              continue;
+              }
+            const Border &border = borders[2 * neighborPiece + ( neighborPiece < static_cast<int>( piece ) ? 1 : 0 )];
+            for ( OffsetValueType i = 0; i < planeSize; ++i )
+              {
+              if ( border.levels[i] == Unreached )
+                {
+                continue;
+                }
+              const OffsetValueType o = border.begin + i;
+              const IndexType index = output->ComputeIndex( o );
+              for ( size_t n = 0; n < neighbors.size(); ++n )
+                {
+                const OffsetValueType q = o + neighborOffsets[n];
+                if ( q >= pieceBegin[piece] && q < pieceBegin[piece + 1] && isInside( index, neighbors[n] ) )
+                  {
+                  relax( q, border.levels[i], border.steps[i], static_cast<unsigned int>( piece ), queue );
+                  }
+                }
+              }
+            }
+          flood( static_cast<unsigned int>( piece ), queue );
+        },
+      nullptr );
+    changed = std::find( borderChanged.begin(), borderChanged.end(), 1 ) != borderChanged.end();
+    }
+
+  // A pixel takes the smallest label of the neighbors it is flooded
+  // from. The labels of the pieces are set in the order of the levels
+  // and steps, from the labels of the borders of their neighbors, until
+  // the borders do not change.
+  std::vector< std::vector<OffsetValueType> > order( numberOfPieces );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        for ( OffsetValueType o = pieceBegin[piece]; o < pieceBegin[piece + 1]; ++o )
+          {
+          if ( markers[o] != NumericTraits<LabelPixelType>::ZeroValue() )
+            {
+            labels[o] = markers[o];
+            }
+          else if ( levels[o] == Unreached )
+            {
+            labels[o] = NumericTraits<LabelPixelType>::ZeroValue();
+            }
+          else
+            {
+            labels[o] = NumericTraits<LabelPixelType>::max();
+            order[piece].push_back( o );
+            }
+          }
+        std::sort( order[piece].begin(), order[piece].end(), [&levels, &steps]( OffsetValueType a, OffsetValueType b )
+          {
+            return std::make_pair( levels[a], steps[a] ) < std::make_pair( levels[b], steps[b] );
+          } );
+      },
+    nullptr );
+
+  do
+    {
+    snapshot( true );
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfPieces,
+      [&]( SizeValueType piece )
+        {
+          for ( OffsetValueType o : order[piece] )
+            {
+            const std::pair<CostType, CostType> cost( levels[o], steps[o] );
+            LabelPixelType label = NumericTraits<LabelPixelType>::max();
+            const IndexType index = output->ComputeIndex( o );
+            for ( size_t n = 0; n < neighbors.size(); ++n )
+              {
+              const OffsetValueType q = o + neighborOffsets[n];
+              if ( !isInside( index, neighbors[n] ) || levels[q] == Unreached || extend( o, levels[q], steps[q] ) != cost )
+                {
+                continue;
+                }
+              if ( q >= pieceBegin[piece] && q < pieceBegin[piece + 1] )
+                {
+                label = std::min( label, labels[q] );
+                }
+              else
+                {
+                const Border &border = neighborBorder( q, static_cast<unsigned int>( piece ) );
+                label = std::min( label, border.labels[q - border.begin] );
+                }
+              }
+            if ( label != labels[o] )
+              {
+              labels[o] = label;
+              if ( isBorder( o, static_cast<unsigned int>( piece ) ) )
+                {
+                borderChanged[piece] = 1;
+                }
+              }
+            }
+        },
+      nullptr );
+    changed = numberOfPieces > 1 && std::find( borderChanged.begin(), borderChanged.end(), 1 ) != borderChanged.end();
+    }
+  while ( changed );
+  borders.clear();
+
+  if ( !this->GetMarkWatershedLine() )
+    {
+    return;
+    }
+
+  // the pixels with a neighbor of another label flooded before them
+  // are on the watershed lines
+  std::vector< std::vector<OffsetValueType> > pieceLines( numberOfPieces );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfPieces,
+    [&]( SizeValueType piece )
+      {
+        for ( OffsetValueType o = pieceBegin[piece]; o < pieceBegin[piece + 1]; ++o )
+          {
+          const LabelPixelType label = labels[o];
+          if ( markers[o] != NumericTraits<LabelPixelType>::ZeroValue() || label == NumericTraits<LabelPixelType>::ZeroValue() )
+            {
+            continue;
+            }
+          const IndexType index = output->ComputeIndex( o );
+          for ( size_t n = 0; n < neighbors.size(); ++n )
+            {
+            const OffsetValueType q = o + neighborOffsets[n];
+            if ( !isInside( index, neighbors[n] ) || labels[q] == label
+                 || labels[q] == NumericTraits<LabelPixelType>::ZeroValue() )
+              {
+              continue;
+              }
+            if ( levels[q] < levels[o]
+                 || ( levels[q] == levels[o] && ( steps[q] < steps[o] || ( steps[q] == steps[o] && labels[q] < label ) ) ) )
+              {
+              pieceLines[piece].push_back( o );
+              break;
+              }
+            }
+          }
+      },
+    this );
+
+  for ( const std::vector<OffsetValueType> &lines : pieceLines )
+    {
+    for ( OffsetValueType o : lines )
+      {
+      labels[o] = NumericTraits<LabelPixelType>::ZeroValue();
+      }
+    }
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TLabelImage >
+void
+ParallelMorphologicalWatershedFromMarkersImageFilter< TInputImage, TLabelImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "ParallelFlooding: " << m_ParallelFlooding << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelMorphologicalWatershedFromMarkersImageFilter_hxx
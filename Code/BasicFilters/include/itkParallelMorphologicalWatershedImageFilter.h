@@ -0,0 +1,93 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelMorphologicalWatershedImageFilter_h
+#define itkParallelMorphologicalWatershedImageFilter_h
+
+#include "itkMorphologicalWatershedImageFilter.h"
+
+
+namespace itk {
+
+/** \class ParallelMorphologicalWatershedImageFilter
+ * \brief Watershed of the regional minima flooded in parallel blocks.
+ *
+ * With ParallelFlooding off, the default, the filter is the
+ * MorphologicalWatershedImageFilter. With ParallelFlooding on, the
+ * labeled regional minima of the image, after the h-minima transform
+ * of height Level, are flooded by the
+ * ParallelMorphologicalWatershedFromMarkersImageFilter in parallel
+ * slabs.
+ *
+ * \sa ParallelMorphologicalWatershedFromMarkersImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class ParallelMorphologicalWatershedImageFilter:
+    public MorphologicalWatershedImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ParallelMorphologicalWatershedImageFilter;
+  using Superclass = MorphologicalWatershedImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ParallelMorphologicalWatershedImageFilter, MorphologicalWatershedImageFilter);
+
+  /** Flood the slabs of the image in parallel. Off by default. */
+  itkSetMacro( ParallelFlooding, bool );
+  itkGetConstMacro( ParallelFlooding, bool );
+  itkBooleanMacro( ParallelFlooding );
+
+protected:
+
+  ParallelMorphologicalWatershedImageFilter() = default;
+
+  ~ParallelMorphologicalWatershedImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The markers are flooded by the threads of the multithreader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ParallelMorphologicalWatershedImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_ParallelFlooding{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkParallelMorphologicalWatershedImageFilter.hxx"
+
+#endif // itkParallelMorphologicalWatershedImageFilter_h
@@ -0,0 +1,106 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkParallelMorphologicalWatershedImageFilter_hxx
+#define itkParallelMorphologicalWatershedImageFilter_hxx
+
+#include "itkParallelMorphologicalWatershedImageFilter.h"
+
+#include "itkConnectedComponentImageFilter.h"
+#include "itkHMinimaImageFilter.h"
+#include "itkParallelMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkProgressAccumulator.h"
+#include "itkRegionalMinimaImageFilter.h"
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelMorphologicalWatershedImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  if ( !m_ParallelFlooding )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  auto progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+
+  const InputImageType *input = this->GetInput();
+  const bool hasLevel = this->GetLevel() != NumericTraits<InputPixelType>::ZeroValue();
+
+  // the minima of the image, after the h-minima transform of height
+  // Level
+  auto hminima = HMinimaImageFilter< InputImageType, InputImageType >::New();
+  hminima->SetInput( input );
+  hminima->SetHeight( this->GetLevel() );
+  hminima->SetFullyConnected( this->GetFullyConnected() );
+  hminima->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  auto minima = RegionalMinimaImageFilter< InputImageType, OutputImageType >::New();
+  minima->SetInput( hasLevel ? hminima->GetOutput() : input );
+  minima->SetFullyConnected( this->GetFullyConnected() );
+  minima->SetBackgroundValue( NumericTraits<OutputPixelType>::ZeroValue() );
+  minima->SetForegroundValue( NumericTraits<OutputPixelType>::max() );
+  minima->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  auto labeler = ConnectedComponentImageFilter< OutputImageType, OutputImageType >::New();
+  labeler->SetInput( minima->GetOutput() );
+  labeler->SetFullyConnected( this->GetFullyConnected() );
+  labeler->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  auto watershed = ParallelMorphologicalWatershedFromMarkersImageFilter< InputImageType, OutputImageType >::New();
+  watershed->SetInput( input );
+  watershed->SetMarkerImage( labeler->GetOutput() );
+  watershed->SetFullyConnected( this->GetFullyConnected() );
+  watershed->SetMarkWatershedLine( this->GetMarkWatershedLine() );
+  watershed->SetParallelFlooding( true );
+  watershed->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  if ( hasLevel )
+    {
+    progress->RegisterInternalFilter( hminima, 0.4f );
+    }
+  progress->RegisterInternalFilter( minima, hasLevel ? 0.1f : 0.2f );
+  progress->RegisterInternalFilter( labeler, hasLevel ? 0.1f : 0.2f );
+  progress->RegisterInternalFilter( watershed, hasLevel ? 0.4f : 0.6f );
+
+  watershed->GraftOutput( this->GetOutput() );
+  watershed->Update();
+  this->GraftOutput( watershed->GetOutput() );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+ParallelMorphologicalWatershedImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "ParallelFlooding: " << m_ParallelFlooding << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkParallelMorphologicalWatershedImageFilter_hxx
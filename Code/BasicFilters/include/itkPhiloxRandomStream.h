@@ -0,0 +1,159 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkPhiloxRandomStream_h
+#define itkPhiloxRandomStream_h
+
+#include <cmath>
+#include <cstdint>
+
+namespace itk {
+
+/** \class PhiloxRandomStream
+ * \brief A stream of random variates of the Philox4x32-10 counter
+ * based generator.
+ *
+ * The words of the stream are the encryption of a counter by the key,
+ * so the stream of a key and a counter does not depend on the other
+ * streams, and a stream for each pixel, keyed by the seed and counted
+ * from the offset of the pixel, gives the same values for any split
+ * of the image between threads. The two high words of the counter
+ * number the blocks of four words of a stream.
+ *
+ * See J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw, "Parallel
+ * random numbers: as easy as 1, 2, 3", SC 2011.
+ */
+class PhiloxRandomStream
+{
+public:
+  PhiloxRandomStream( uint64_t key, uint64_t stream )
+    : m_Key{ static_cast<uint32_t>( key ), static_cast<uint32_t>( key >> 32 ) },
+      m_Counter{ static_cast<uint32_t>( stream ), static_cast<uint32_t>( stream >> 32 ), 0, 0 }
+  {
+  }
+
+  /** The four words of a counter encrypted by a key. */
+  static void Generate( const uint32_t counter[4], const uint32_t key[2], uint32_t words[4] )
+  {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for ( unsigned int round = 0; round < 10; ++round )
+      {
+      const uint64_t product0 = static_cast<uint64_t>( 0xD2511F53u ) * c0;
+      const uint64_t product1 = static_cast<uint64_t>( 0xCD9E8D57u ) * c2;
+      const uint32_t n0 = static_cast<uint32_t>( product1 >> 32 ) ^ c1 ^ k0;
+      const uint32_t n2 = static_cast<uint32_t>( product0 >> 32 ) ^ c3 ^ k1;
+      c1 = static_cast<uint32_t>( product1 );
+      c3 = static_cast<uint32_t>( product0 );
+      c0 = n0;
+      c2 = n2;
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+      }
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+  }
+
+  /** The next word of the stream. */
+  uint32_t GetWord()
+  {
+    if ( m_Next == 4 )
+      {
+      Generate( m_Counter, m_Key, m_Words );
+      if ( ++m_Counter[2] == 0 )
+        {
+        ++m_Counter[3];
+        }
+      m_Next = 0;
+      }
+    return m_Words[m_Next++];
+  }
+
+  /** A variate of the uniform distribution in [0,1), of 53 bits. */
+  double GetUniformVariate()
+  {
+    const uint64_t high = GetWord();
+    const uint64_t low = GetWord();
+    return static_cast<double>( ( ( high << 32 ) | low ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+  }
+
+  /** A variate of the uniform distribution in (0,1], for logarithms. */
+  double GetOpenUniformVariate()
+  {
+    return 1.0 - GetUniformVariate();
+  }
+
+  /** A variate of the standard normal distribution, by the Box-Muller
+   * transform of two uniform variates. */
+  double GetNormalVariate()
+  {
+    if ( m_HasNormal )
+      {
+      m_HasNormal = false;
+      return m_Normal;
+      }
+    const double radius = std::sqrt( -2.0 * std::log( GetOpenUniformVariate() ) );
+    const double angle = 6.283185307179586 * GetUniformVariate();
+    m_Normal = radius * std::sin( angle );
+    m_HasNormal = true;
+    return radius * std::cos( angle );
+  }
+
+  /** A variate of the gamma distribution of shape k and scale 1, by
+   * the method of Marsaglia and Tsang. */
+  double GetGammaVariate( double k )
+  {
+    if ( k < 1.0 )
+      {
+      // Gamma(k) is Gamma(k+1) U^(1/k)
+      const double u = GetOpenUniformVariate();
+      return GetGammaVariate( k + 1.0 ) * std::pow( u, 1.0 / k );
+      }
+    const double d = k - 1.0 / 3.0;
+    const double c = 1.0 / std::sqrt( 9.0 * d );
+    while ( true )
+      {
+      double x, v;
+      do
+        {
+        x = GetNormalVariate();
+        v = 1.0 + c * x;
+        }
+      while ( v <= 0.0 );
+      v = v * v * v;
+      const double u = GetOpenUniformVariate();
+      if ( u < 1.0 - 0.0331 * x * x * x * x || std::log( u ) < 0.5 * x * x + d * ( 1.0 - v + std::log( v ) ) )
+        {
+        return d * v;
+        }
+      }
+  }
+
+private:
+  uint32_t m_Key[2];
+  uint32_t m_Counter[4];
+  uint32_t m_Words[4]{};
+  unsigned int m_Next{ 4 };
+  double m_Normal{ 0.0 };
+  bool m_HasNormal{ false };
+};
+
+} // end namespace itk
+
+#endif // itkPhiloxRandomStream_h
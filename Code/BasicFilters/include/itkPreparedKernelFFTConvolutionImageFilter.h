@@ -0,0 +1,112 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkPreparedKernelFFTConvolutionImageFilter_h
+#define itkPreparedKernelFFTConvolutionImageFilter_h
+
+#include "itkFFTConvolutionImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class PreparedKernelFFTConvolutionImageFilter
+ * \brief FFT convolution which keeps the prepared kernel between
+ * updates.
+ *
+ * The kernel is padded to the padded size of the input, normalized,
+ * shifted and transformed as by the FFTConvolutionImageFilter, and the
+ * spectrum is kept with a copy of the kernel pixels. A following
+ * update with a kernel of the same size and pixels, the same padded
+ * size and the same Normalize flag reuses the spectrum, so only the
+ * input is transformed. The kernel does not need to be the same
+ * image. ReleasePreparedKernel frees the spectrum.
+ *
+ * \sa FFTConvolutionImageFilter
+ */
+template < class TInputImage, class TKernelImage = TInputImage, class TOutputImage = TInputImage, class TInternalPrecision = double >
+class PreparedKernelFFTConvolutionImageFilter:
+    public FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+{
+public:
+  /** Standard Self type alias */
+  using Self = PreparedKernelFFTConvolutionImageFilter;
+  using Superclass = FFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using KernelImageType = typename Superclass::KernelImageType;
+  using KernelPixelType = typename KernelImageType::PixelType;
+  using InternalComplexImageType = typename Superclass::InternalComplexImageType;
+  using InternalComplexImagePointerType = typename Superclass::InternalComplexImagePointerType;
+  using InputSizeType = typename Superclass::InputSizeType;
+  using KernelSizeType = typename KernelImageType::SizeType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PreparedKernelFFTConvolutionImageFilter, FFTConvolutionImageFilter);
+
+  /** Whether the spectrum of the kernel was reused by the last
+   * update. */
+  itkGetConstMacro( PreparedKernelReused, bool );
+
+  /** Free the spectrum of the kernel. */
+  void ReleasePreparedKernel()
+  {
+    m_PreparedKernel = nullptr;
+    m_PreparedKernelPixels.clear();
+    m_PreparedKernelPixels.shrink_to_fit();
+  }
+
+protected:
+
+  PreparedKernelFFTConvolutionImageFilter() = default;
+
+  ~PreparedKernelFFTConvolutionImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The kernel is prepared only when it changed.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  PreparedKernelFFTConvolutionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  // the kernel of the spectrum
+  InternalComplexImagePointerType m_PreparedKernel;
+  std::vector<KernelPixelType>    m_PreparedKernelPixels;
+  KernelSizeType                  m_PreparedKernelSize{};
+  InputSizeType                   m_PreparedPaddedSize{};
+  bool                            m_PreparedNormalize{false};
+
+  bool m_PreparedKernelReused{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkPreparedKernelFFTConvolutionImageFilter.hxx"
+
+#endif // itkPreparedKernelFFTConvolutionImageFilter_h
@@ -0,0 +1,116 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkPreparedKernelFFTConvolutionImageFilter_hxx
+#define itkPreparedKernelFFTConvolutionImageFilter_hxx
+
+#include "itkPreparedKernelFFTConvolutionImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkProgressAccumulator.h"
+
+#include <algorithm>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision >
+void
+PreparedKernelFFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::GenerateData()
+{
+  // Create a process accumulator for tracking the progress of this
+  // minipipeline
+  typename ProgressAccumulator::Pointer progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+
+  const InputImageType *localInput = this->GetInput();
+  const KernelImageType *kernelImage = this->GetKernelImage();
+
+  // the pixels of the kernel, compared to the pixels of the kept
+  // spectrum
+  const typename KernelImageType::RegionType kernelRegion = kernelImage->GetLargestPossibleRegion();
+  std::vector<KernelPixelType> kernelPixels;
+  kernelPixels.reserve( kernelRegion.GetNumberOfPixels() );
+  for ( ImageRegionConstIterator<KernelImageType> it( kernelImage, kernelRegion ); !it.IsAtEnd(); ++it )
+    {
+    kernelPixels.push_back( it.Get() );
+    }
+
+  m_PreparedKernelReused = m_PreparedKernel.IsNotNull()
+    && m_PreparedKernelSize == kernelRegion.GetSize()
+    && m_PreparedPaddedSize == this->GetPaddedSize()
+    && m_PreparedNormalize == this->GetNormalize()
+    && std::equal( kernelPixels.begin(), kernelPixels.end(), m_PreparedKernelPixels.begin(), m_PreparedKernelPixels.end() );
+
+  InternalComplexImagePointerType input = nullptr;
+  InternalComplexImagePointerType kernel = nullptr;
+  if ( m_PreparedKernelReused )
+    {
+    this->PrepareInput( localInput, input, progress, 0.7f );
+    kernel = m_PreparedKernel;
+    }
+  else
+    {
+    this->ReleasePreparedKernel();
+    this->PrepareInputs( localInput, kernelImage, input, kernel, progress, 0.7f );
+
+    // the spectrum is not released by the multiplication
+    kernel->DisconnectPipeline();
+    kernel->ReleaseDataFlagOff();
+    m_PreparedKernel = kernel;
+    m_PreparedKernelPixels.swap( kernelPixels );
+    m_PreparedKernelSize = kernelRegion.GetSize();
+    m_PreparedPaddedSize = this->GetPaddedSize();
+    m_PreparedNormalize = this->GetNormalize();
+    }
+
+  using MultiplyFilterType = MultiplyImageFilter< InternalComplexImageType, InternalComplexImageType, InternalComplexImageType >;
+  typename MultiplyFilterType::Pointer multiplyFilter = MultiplyFilterType::New();
+  multiplyFilter->SetInput1( input );
+  multiplyFilter->SetInput2( kernel );
+  multiplyFilter->ReleaseDataFlagOn();
+  progress->RegisterInternalFilter( multiplyFilter, 0.1f );
+
+  // Free up the memory for the prepared input
+  input = nullptr;
+  kernel = nullptr;
+
+  this->ProduceOutput( multiplyFilter->GetOutput(), progress, 0.2f );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TKernelImage, class TOutputImage, class TInternalPrecision >
+void
+PreparedKernelFFTConvolutionImageFilter< TInputImage, TKernelImage, TOutputImage, TInternalPrecision >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "PreparedKernel: " << m_PreparedKernel.GetPointer() << std::endl;
+  os << indent << "PreparedKernelReused: " << m_PreparedKernelReused << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkPreparedKernelFFTConvolutionImageFilter_hxx
@@ -0,0 +1,125 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkReferenceTableHistogramMatchingImageFilter_h
+#define itkReferenceTableHistogramMatchingImageFilter_h
+
+#include "itkHistogramMatchingImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class ReferenceTableHistogramMatchingImageFilter
+ * \brief Histogram matching with the quantiles of the reference
+ * computed once.
+ *
+ * The reference table holds the minimum of the reference image, its
+ * intensity threshold, the mean or the minimum as selected by
+ * ThresholdAtMeanIntensity, the NumberOfMatchPoints quantiles of its
+ * histogram and its maximum: the values of the reference used by the
+ * superclass, NumberOfMatchPoints + 3 values in all.
+ *
+ * The table of the reference image is computed by each update with a
+ * reference image, and is available from GetComputedReferenceTable.
+ * When a table is set with SetReferenceTable, the reference image is
+ * not needed: only the histogram of the source is computed, and the
+ * source is mapped to the reference table in parallel, through a
+ * lookup table of all the values for the integer inputs of at most 16
+ * bits. The output histogram of the superclass is not computed then.
+ *
+ * \sa HistogramMatchingImageFilter
+ */
+template < class TInputImage, class TOutputImage, class THistogramMeasurement = typename TInputImage::PixelType >
+class ReferenceTableHistogramMatchingImageFilter:
+    public HistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ReferenceTableHistogramMatchingImageFilter;
+  using Superclass = HistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+  using HistogramType = typename Superclass::HistogramType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ReferenceTableHistogramMatchingImageFilter, HistogramMatchingImageFilter);
+
+  /** Set the table of the reference, which is used instead of the
+   * reference image when not empty. Empty by default. */
+  void SetReferenceTable( const std::vector<double> &table )
+  {
+    if ( table != m_ReferenceTable )
+      {
+      m_ReferenceTable = table;
+      this->Modified();
+      }
+  }
+  const std::vector<double> & GetReferenceTable() const { return m_ReferenceTable; }
+
+  /** The table of the reference image of the last update. */
+  const std::vector<double> & GetComputedReferenceTable() const { return m_ComputedReferenceTable; }
+
+protected:
+
+  ReferenceTableHistogramMatchingImageFilter();
+
+  ~ReferenceTableHistogramMatchingImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The reference image is only required without a reference table.
+  void VerifyPreconditions() ITKv5_CONST override;
+
+  // See superclass for doxygen documentation
+  //
+  // The source is mapped to the reference table in parallel.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ReferenceTableHistogramMatchingImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  // the minimum, the threshold, the quantiles and the maximum of an
+  // image, as computed by the superclass
+  std::vector<double> ComputeTable( const InputImageType *image );
+
+  std::vector<double> m_ReferenceTable;
+  std::vector<double> m_ComputedReferenceTable;
+};
+
+
+} // end namespace itk
+
+
+#include "itkReferenceTableHistogramMatchingImageFilter.hxx"
+
+#endif // itkReferenceTableHistogramMatchingImageFilter_h
@@ -0,0 +1,301 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkReferenceTableHistogramMatchingImageFilter_hxx
+#define itkReferenceTableHistogramMatchingImageFilter_hxx
+
+#include "itkReferenceTableHistogramMatchingImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace itk {
+
+template < class TInputImage, class TOutputImage, class THistogramMeasurement >
+ReferenceTableHistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
+::ReferenceTableHistogramMatchingImageFilter()
+{
+  // the reference image may be replaced by a table
+  this->SetNumberOfRequiredInputs( 1 );
+  this->RemoveRequiredInputName( "ReferenceImage" );
+}
+
+
+//
+// VerifyPreconditions
+//
+template < class TInputImage, class TOutputImage, class THistogramMeasurement >
+void
+ReferenceTableHistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
+::VerifyPreconditions() ITKv5_CONST
+{
+  ImageToImageFilter< TInputImage, TOutputImage >::VerifyPreconditions();
+
+  if ( m_ReferenceTable.empty() && this->GetReferenceImage() == nullptr )
+    {
+    itkExceptionMacro( "A reference image or a reference table is required!" );
+    }
+  if ( !m_ReferenceTable.empty() && m_ReferenceTable.size() != this->GetNumberOfMatchPoints() + 3 )
+    {
+    itkExceptionMacro( "The reference table has " << m_ReferenceTable.size() << " values instead of "
+                       << this->GetNumberOfMatchPoints() + 3 << " for " << this->GetNumberOfMatchPoints()
+                       << " match points!" );
+    }
+}
+
+
+//
+// ComputeTable
+//
+template < class TInputImage, class TOutputImage, class THistogramMeasurement >
+std::vector<double>
+ReferenceTableHistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
+::ComputeTable( const InputImageType *image )
+{
+  constexpr SizeValueType BlockSize = 1 << 16;
+
+  const InputPixelType *buffer = image->GetBufferPointer();
+  const SizeValueType numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  const SizeValueType numberOfBlocks = ( numberOfPixels + BlockSize - 1 ) / BlockSize;
+  auto blockBegin = [numberOfPixels]( SizeValueType block )
+    {
+      return std::min( numberOfPixels, block * BlockSize );
+    };
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // the minimum, maximum and sum of the blocks, added in their order
+  std::vector<double> blockMinimum( numberOfBlocks, std::numeric_limits<double>::max() );
+  std::vector<double> blockMaximum( numberOfBlocks, std::numeric_limits<double>::lowest() );
+  std::vector<double> blockSum( numberOfBlocks, 0.0 );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&]( SizeValueType block )
+      {
+        for ( SizeValueType i = blockBegin( block ); i < blockBegin( block + 1 ); ++i )
+          {
+          const double value = static_cast<double>( buffer[i] );
+          blockMinimum[block] = std::min( blockMinimum[block], value );
+          blockMaximum[block] = std::max( blockMaximum[block], value );
+          blockSum[block] += value;
+          }
+      },
+    nullptr );
+  double minimum = std::numeric_limits<double>::max();
+  double maximum = std::numeric_limits<double>::lowest();
+  double sum = 0.0;
+  for ( SizeValueType block = 0; block < numberOfBlocks; ++block )
+    {
+    minimum = std::min( minimum, blockMinimum[block] );
+    maximum = std::max( maximum, blockMaximum[block] );
+    sum += blockSum[block];
+    }
+  const double threshold = this->GetThresholdAtMeanIntensity() ? sum / static_cast<double>( numberOfPixels ) : minimum;
+
+  // the histogram of the values from the threshold to the maximum, with
+  // the bins of the superclass
+  typename HistogramType::Pointer histogram = HistogramType::New();
+  typename HistogramType::SizeType size( 1 );
+  typename HistogramType::MeasurementVectorType lowerBound( 1 );
+  typename HistogramType::MeasurementVectorType upperBound( 1 );
+  size[0] = this->GetNumberOfHistogramLevels();
+  lowerBound.Fill( static_cast<THistogramMeasurement>( threshold ) );
+  upperBound.Fill( static_cast<THistogramMeasurement>( maximum ) );
+  histogram->SetMeasurementVectorSize( 1 );
+  histogram->Initialize( size, lowerBound, upperBound );
+  histogram->SetToZero();
+
+  const SizeValueType numberOfBins = histogram->GetSize( 0 );
+  std::vector<double> binMinimum( numberOfBins );
+  for ( SizeValueType bin = 0; bin < numberOfBins; ++bin )
+    {
+    binMinimum[bin] = histogram->GetBinMin( 0, bin );
+    }
+  const double lower = static_cast<double>( lowerBound[0] );
+  const double upper = static_cast<double>( upperBound[0] );
+
+  std::vector< std::vector<SizeValueType> > blockFrequencies( numberOfBlocks );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&]( SizeValueType block )
+      {
+        std::vector<SizeValueType> &frequencies = blockFrequencies[block];
+        frequencies.assign( numberOfBins, 0 );
+        for ( SizeValueType i = blockBegin( block ); i < blockBegin( block + 1 ); ++i )
+          {
+          const double value = static_cast<double>( static_cast<THistogramMeasurement>( buffer[i] ) );
+          if ( value >= lower && value <= upper )
+            {
+            const SizeValueType bin = std::upper_bound( binMinimum.begin(), binMinimum.end(), value ) - binMinimum.begin();
+            ++frequencies[bin > 0 ? bin - 1 : 0];
+            }
+          }
+      },
+    nullptr );
+  for ( SizeValueType bin = 0; bin < numberOfBins; ++bin )
+    {
+    SizeValueType frequency = 0;
+    for ( const std::vector<SizeValueType> &frequencies : blockFrequencies )
+      {
+      frequency += frequencies[bin];
+      }
+    histogram->SetFrequency( bin, frequency );
+    }
+
+  const unsigned int numberOfMatchPoints = this->GetNumberOfMatchPoints();
+  std::vector<double> table( numberOfMatchPoints + 3 );
+  table[0] = minimum;
+  table[1] = threshold;
+  const double delta = 1.0 / ( static_cast<double>( numberOfMatchPoints ) + 1.0 );
+  for ( unsigned int j = 1; j < numberOfMatchPoints + 1; ++j )
+    {
+    table[j + 1] = static_cast<double>( histogram->Quantile( 0, static_cast<double>( j ) * delta ) );
+    }
+  table[numberOfMatchPoints + 2] = maximum;
+  return table;
+}
+
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage, class THistogramMeasurement >
+void
+ReferenceTableHistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
+::GenerateData()
+{
+  if ( m_ReferenceTable.empty() )
+    {
+    m_ComputedReferenceTable = this->ComputeTable( this->GetReferenceImage() );
+    Superclass::GenerateData();
+    return;
+    }
+  m_ComputedReferenceTable = m_ReferenceTable;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  // the quantiles of the source and of the reference, and the slopes
+  // between them, as in the superclass
+  const std::vector<double> source = this->ComputeTable( input );
+  const std::vector<double> &reference = m_ReferenceTable;
+  const unsigned int numberOfPoints = this->GetNumberOfMatchPoints() + 2;
+
+  std::vector<double> gradients( numberOfPoints - 1, 0.0 );
+  for ( unsigned int j = 0; j + 1 < numberOfPoints; ++j )
+    {
+    const double denominator = source[j + 2] - source[j + 1];
+    if ( denominator != 0.0 )
+      {
+      gradients[j] = ( reference[j + 2] - reference[j + 1] ) / denominator;
+      }
+    }
+  const double lowerGradient = ( source[1] != source[0] ) ? ( reference[1] - reference[0] ) / ( source[1] - source[0] ) : 0.0;
+  const double upperGradient = 0.0;
+
+  auto map = [&]( double value )
+    {
+      unsigned int j = 0;
+      while ( j < numberOfPoints && !( value < source[j + 1] ) )
+        {
+        ++j;
+        }
+      double mapped;
+      if ( j == 0 )
+        {
+        mapped = reference[0] + ( value - source[0] ) * lowerGradient;
+        }
+      else if ( j == numberOfPoints )
+        {
+        mapped = reference[numberOfPoints] + ( value - source[numberOfPoints] ) * upperGradient;
+        }
+      else
+        {
+        mapped = reference[j] + ( value - source[j] ) * gradients[j - 1];
+        }
+      return static_cast<OutputPixelType>( mapped );
+    };
+
+  // the mapped values of all the values of the small integers
+  constexpr bool UseLookupTable = std::is_integral<InputPixelType>::value && sizeof( InputPixelType ) <= 2;
+  const double lowest = static_cast<double>( std::numeric_limits<InputPixelType>::lowest() );
+  std::vector<OutputPixelType> lookupTable;
+  if ( UseLookupTable )
+    {
+    const SizeValueType numberOfValues = static_cast<SizeValueType>( std::numeric_limits<InputPixelType>::max() - lowest ) + 1;
+    lookupTable.resize( numberOfValues );
+    for ( SizeValueType v = 0; v < numberOfValues; ++v )
+      {
+      lookupTable[v] = map( lowest + static_cast<double>( v ) );
+      }
+    }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    output->GetRequestedRegion(),
+    [&]( const RegionType &region )
+      {
+        ImageScanlineConstIterator<InputImageType> inIt( input, region );
+        ImageScanlineIterator<OutputImageType> outIt( output, region );
+        while ( !inIt.IsAtEnd() )
+          {
+          while ( !inIt.IsAtEndOfLine() )
+            {
+            const InputPixelType value = inIt.Get();
+            if ( UseLookupTable )
+              {
+              outIt.Set( lookupTable[static_cast<SizeValueType>( static_cast<double>( value ) - lowest )] );
+              }
+            else
+              {
+              outIt.Set( map( static_cast<double>( value ) ) );
+              }
+            ++inIt;
+            ++outIt;
+            }
+          inIt.NextLine();
+          outIt.NextLine();
+          }
+      },
+    this );
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage, class THistogramMeasurement >
+void
+ReferenceTableHistogramMatchingImageFilter< TInputImage, TOutputImage, THistogramMeasurement >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "ReferenceTable: " << m_ReferenceTable.size() << " values" << std::endl;
+  os << indent << "ComputedReferenceTable: " << m_ComputedReferenceTable.size() << " values" << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkReferenceTableHistogramMatchingImageFilter_hxx
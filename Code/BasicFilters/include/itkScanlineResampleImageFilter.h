@@ -0,0 +1,123 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkScanlineResampleImageFilter_h
+#define itkScanlineResampleImageFilter_h
+
+#include "itkResampleImageFilter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+
+#include <type_traits>
+
+
+namespace itk {
+
+/** \class ScanlineResampleImageFilter
+ * \brief Resample an image, with a fast path for linear transforms.
+ *
+ * When the transform is linear, the ResampleImageFilter steps the
+ * continuous index of the input along each scanline of the output,
+ * but still evaluates the interpolator through its virtual interface
+ * for every pixel. For scalar images interpolated with the linear or
+ * the nearest neighbor interpolators, and without an extrapolator,
+ * this filter evaluates the continuous index and the interpolation
+ * inline from the buffer of the input, so that the loop over the
+ * scanline has no virtual calls nor index conversions.
+ *
+ * The interpolation matches the LinearInterpolateImageFunction and
+ * the NearestNeighborInterpolateImageFunction, up to the rounding of
+ * the floating point operations. Otherwise, the filter executes the
+ * ResampleImageFilter.
+ */
+template < typename TInputImage, typename TOutputImage, typename TInterpolatorPrecisionType = double >
+class ScanlineResampleImageFilter:
+    public ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ScanlineResampleImageFilter;
+  using Superclass = ResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = typename Superclass::InputImageType;
+  using OutputImageType = typename Superclass::OutputImageType;
+  using OutputImageRegionType = typename Superclass::OutputImageRegionType;
+  using TransformType = typename Superclass::TransformType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+  static constexpr unsigned int InputImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ScanlineResampleImageFilter, ResampleImageFilter);
+
+  /** Get if the last execution used the scanline fast path. */
+  itkGetConstMacro( UsedScanlineFastPath, bool );
+
+protected:
+
+  ScanlineResampleImageFilter() = default;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+  // See superclass for doxygen documentation
+  void BeforeThreadedGenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Use the fast path when it applies, or the superclass.
+  void DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  ScanlineResampleImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  // the fast path only accesses the buffer of scalar itk::Images
+  static constexpr bool IsScalarImage =
+    std::is_arithmetic< typename TInputImage::PixelType >::value &&
+    std::is_arithmetic< typename TOutputImage::PixelType >::value &&
+    std::is_same< TInputImage, Image< typename TInputImage::PixelType, InputImageDimension > >::value &&
+    std::is_same< TOutputImage, Image< typename TOutputImage::PixelType, ImageDimension > >::value;
+
+  enum ScanlineInterpolationEnum { NoScanline, ScanlineLinear, ScanlineNearestNeighbor };
+
+  ScanlineInterpolationEnum SelectScanlineInterpolation( std::true_type ) const;
+  ScanlineInterpolationEnum SelectScanlineInterpolation( std::false_type ) const { return NoScanline; }
+
+  void ScanlineThreadedGenerateData( const OutputImageRegionType & outputRegionForThread, std::true_type );
+  void ScanlineThreadedGenerateData( const OutputImageRegionType &, std::false_type ) {}
+
+  ScanlineInterpolationEnum m_ScanlineInterpolation{ NoScanline };
+  bool m_UsedScanlineFastPath{ false };
+};
+
+
+} // end namespace itk
+
+
+#include "itkScanlineResampleImageFilter.hxx"
+
+#ifdef SITK_USE_EXPLICITITK
+#include "sitkExplicitITKResampleImageFilter.h"
+#include "sitkExplicitITKScanlineResampleImageFilter.h"
+#endif
+
+#endif // itkScanlineResampleImageFilter_h
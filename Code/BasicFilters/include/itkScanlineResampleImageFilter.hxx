@@ -0,0 +1,273 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkScanlineResampleImageFilter_hxx
+#define itkScanlineResampleImageFilter_hxx
+
+#include "itkScanlineResampleImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+#include "itkTotalProgressReporter.h"
+#include "itkMath.h"
+#include "sitkInstructionSet.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+namespace itk {
+
+
+template < typename TInputImage, typename TOutputImage, typename TInterpolatorPrecisionType >
+void
+ScanlineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  m_ScanlineInterpolation = this->SelectScanlineInterpolation( std::integral_constant< bool, IsScalarImage >() );
+  m_UsedScanlineFastPath = ( m_ScanlineInterpolation != NoScanline );
+}
+
+
+template < typename TInputImage, typename TOutputImage, typename TInterpolatorPrecisionType >
+typename ScanlineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >::ScanlineInterpolationEnum
+ScanlineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::SelectScanlineInterpolation( std::true_type ) const
+{
+  const TransformType *transform = this->GetTransform();
+  if ( transform == nullptr
+       || transform->GetTransformCategory() != TransformType::TransformCategoryEnum::Linear
+       || this->GetExtrapolator() != nullptr )
+    {
+    return NoScanline;
+    }
+
+  using LinearInterpolatorType = LinearInterpolateImageFunction< InputImageType, TInterpolatorPrecisionType >;
+  using NearestNeighborInterpolatorType = NearestNeighborInterpolateImageFunction< InputImageType, TInterpolatorPrecisionType >;
+
+  // derived interpolators may evaluate differently, so the type must
+  // match exactly
+  const auto *interpolator = this->GetInterpolator();
+  if ( interpolator != nullptr && typeid( *interpolator ) == typeid( LinearInterpolatorType ) )
+    {
+    return ScanlineLinear;
+    }
+  if ( interpolator != nullptr && typeid( *interpolator ) == typeid( NearestNeighborInterpolatorType ) )
+    {
+    return ScanlineNearestNeighbor;
+    }
+  return NoScanline;
+}
+
+
+template < typename TInputImage, typename TOutputImage, typename TInterpolatorPrecisionType >
+void
+ScanlineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  if ( m_ScanlineInterpolation == NoScanline )
+    {
+    Superclass::DynamicThreadedGenerateData( outputRegionForThread );
+    return;
+    }
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  this->ScanlineThreadedGenerateData( outputRegionForThread, std::integral_constant< bool, IsScalarImage >() );
+}
+
+
+template < typename TInputImage, typename TOutputImage, typename TInterpolatorPrecisionType >
+void
+ScanlineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::ScanlineThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, std::true_type)
+{
+  using InputPixelType = typename InputImageType::PixelType;
+  using OutputPixelType = typename OutputImageType::PixelType;
+  using IndexValueType = typename InputImageType::IndexValueType;
+  using OffsetValueType = typename InputImageType::OffsetValueType;
+  using ContinuousInputIndexType = ContinuousIndex< TInterpolatorPrecisionType, InputImageDimension >;
+  using RealType = double;
+
+  constexpr unsigned int NumberOfNeighbors = 1u << InputImageDimension;
+
+  const InputImageType *inputPtr = this->GetInput();
+  OutputImageType *outputPtr = this->GetOutput();
+  const TransformType *transformPtr = this->GetTransform();
+
+  TotalProgressReporter progress( this, outputPtr->GetRequestedRegion().GetNumberOfPixels() );
+
+  // The interpolation accesses the buffer directly, with the bounds
+  // of IsInsideBuffer of the interpolators.
+  const typename InputImageType::RegionType &bufferedRegion = inputPtr->GetBufferedRegion();
+  const InputPixelType *buffer = inputPtr->GetBufferPointer();
+  const OffsetValueType *offsetTable = inputPtr->GetOffsetTable();
+
+  IndexValueType startIndex[InputImageDimension];
+  IndexValueType endIndex[InputImageDimension];
+  TInterpolatorPrecisionType startContinuousIndex[InputImageDimension];
+  TInterpolatorPrecisionType endContinuousIndex[InputImageDimension];
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    startIndex[d] = bufferedRegion.GetIndex()[d];
+    endIndex[d] = startIndex[d] + static_cast< IndexValueType >( bufferedRegion.GetSize()[d] ) - 1;
+    startContinuousIndex[d] = startIndex[d] - 0.5;
+    endContinuousIndex[d] = endIndex[d] + 0.5;
+    }
+
+  const OutputPixelType defaultValue = this->GetDefaultPixelValue();
+  const RealType minOutputValue = static_cast< RealType >( NumericTraits< OutputPixelType >::NonpositiveMin() );
+  const RealType maxOutputValue = static_cast< RealType >( NumericTraits< OutputPixelType >::max() );
+
+  // same conversion as CastPixelWithBoundsChecking of the superclass
+  auto castPixel = [minOutputValue, maxOutputValue]( RealType value ) -> OutputPixelType
+    {
+      if ( value >= maxOutputValue )
+        {
+        return NumericTraits< OutputPixelType >::max();
+        }
+      if ( value <= minOutputValue )
+        {
+        return NumericTraits< OutputPixelType >::NonpositiveMin();
+        }
+      return static_cast< OutputPixelType >( value );
+    };
+
+  auto transformIndex = [inputPtr, outputPtr, transformPtr]( const typename OutputImageType::IndexType &index )
+    {
+      typename OutputImageType::PointType outputPoint;
+      outputPtr->TransformIndexToPhysicalPoint( index, outputPoint );
+      const typename TransformType::OutputPointType inputPoint = transformPtr->TransformPoint( outputPoint );
+      return inputPtr->template TransformPhysicalPointToContinuousIndex< TInterpolatorPrecisionType >( inputPoint );
+    };
+
+  // The transform is linear, so the continuous index changes by the
+  // same step along all the scanlines.
+  typename OutputImageType::IndexType nextIndex = outputRegionForThread.GetIndex();
+  const ContinuousInputIndexType firstContinuousIndex = transformIndex( nextIndex );
+  ++nextIndex[0];
+  const ContinuousInputIndexType nextContinuousIndex = transformIndex( nextIndex );
+
+  TInterpolatorPrecisionType delta[InputImageDimension];
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    delta[d] = nextContinuousIndex[d] - firstContinuousIndex[d];
+    }
+
+  const bool linear = ( m_ScanlineInterpolation == ScanlineLinear );
+
+  ImageScanlineIterator< OutputImageType > outIt( outputPtr, outputRegionForThread );
+  while ( !outIt.IsAtEnd() )
+    {
+    const ContinuousInputIndexType lineContinuousIndex = transformIndex( outIt.GetIndex() );
+
+    SizeValueType lineLength = 0;
+    // the inner loop is compiled for the instruction set of the processor
+    simple::detail::InvokeWithInstructionSet( [&]
+      {
+        while ( !outIt.IsAtEndOfLine() )
+          {
+          // multiplying by the position in the scanline, instead of
+          // accumulating the step, does not drift along long scanlines
+          TInterpolatorPrecisionType continuousIndex[InputImageDimension];
+          bool isInside = true;
+          for ( unsigned int d = 0; d < InputImageDimension; ++d )
+            {
+            continuousIndex[d] = lineContinuousIndex[d] + static_cast< TInterpolatorPrecisionType >( lineLength ) * delta[d];
+            isInside = isInside && continuousIndex[d] >= startContinuousIndex[d] && continuousIndex[d] < endContinuousIndex[d];
+            }
+
+          if ( !isInside )
+            {
+            outIt.Set( defaultValue );
+            }
+          else if ( linear )
+            {
+            // as LinearInterpolateImageFunction, the neighbors outside of
+            // the buffer are clamped to its border
+            IndexValueType baseIndex[InputImageDimension];
+            RealType distance[InputImageDimension];
+            for ( unsigned int d = 0; d < InputImageDimension; ++d )
+              {
+              baseIndex[d] = Math::Floor< IndexValueType >( continuousIndex[d] );
+              distance[d] = continuousIndex[d] - static_cast< TInterpolatorPrecisionType >( baseIndex[d] );
+              }
+
+            RealType value = 0.0;
+            for ( unsigned int counter = 0; counter < NumberOfNeighbors; ++counter )
+              {
+              RealType overlap = 1.0;
+              OffsetValueType offset = 0;
+              for ( unsigned int d = 0; d < InputImageDimension; ++d )
+                {
+                IndexValueType neighborIndex;
+                if ( counter & ( 1u << d ) )
+                  {
+                  neighborIndex = std::min( baseIndex[d] + 1, endIndex[d] );
+                  overlap *= distance[d];
+                  }
+                else
+                  {
+                  neighborIndex = std::max( baseIndex[d], startIndex[d] );
+                  overlap *= 1.0 - distance[d];
+                  }
+                offset += ( neighborIndex - startIndex[d] ) * offsetTable[d];
+                }
+              value += overlap * static_cast< RealType >( buffer[offset] );
+              }
+            outIt.Set( castPixel( value ) );
+            }
+          else
+            {
+            OffsetValueType offset = 0;
+            for ( unsigned int d = 0; d < InputImageDimension; ++d )
+              {
+              IndexValueType nearestIndex = Math::RoundHalfIntegerUp< IndexValueType >( continuousIndex[d] );
+              nearestIndex = std::min( std::max( nearestIndex, startIndex[d] ), endIndex[d] );
+              offset += ( nearestIndex - startIndex[d] ) * offsetTable[d];
+              }
+            outIt.Set( castPixel( static_cast< RealType >( buffer[offset] ) ) );
+            }
+
+          ++outIt;
+          ++lineLength;
+          }
+      } );
+
+    outIt.NextLine();
+    progress.Completed( lineLength );
+    }
+}
+
+
+template < typename TInputImage, typename TOutputImage, typename TInterpolatorPrecisionType >
+void
+ScanlineResampleImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "UsedScanlineFastPath: " << m_UsedScanlineFastPath << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkScanlineResampleImageFilter_hxx
@@ -0,0 +1,115 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkShrunkN4BiasFieldCorrectionImageFilter_h
+#define itkShrunkN4BiasFieldCorrectionImageFilter_h
+
+#include "itkN4BiasFieldCorrectionImageFilter.h"
+
+
+namespace itk {
+
+/** \class ShrunkN4BiasFieldCorrectionImageFilter
+ * \brief N4 bias field correction fitted on a shrunk image.
+ *
+ * With a ShrinkFactor of 1, the default, the filter is the
+ * N4BiasFieldCorrectionImageFilter. With a larger ShrinkFactor, the
+ * input, the mask and the confidence image are shrunk by it in each
+ * dimension, and the bias field is fitted on them by an internal
+ * N4BiasFieldCorrectionImageFilter with the same parameters.
+ *
+ * The log bias field is then reconstructed from the control point
+ * lattice at the full resolution in slabs of the slowest dimension,
+ * which are corrected in parallel, so no full size image of the bias
+ * field is kept besides the input and the output.
+ *
+ * The measurements of the fitting and the control point lattice are
+ * those of the internal filter, and its iterations are reported as
+ * the iterations of this filter.
+ *
+ * \sa N4BiasFieldCorrectionImageFilter
+ */
+template < class TInputImage, class TMaskImage, class TOutputImage >
+class ShrunkN4BiasFieldCorrectionImageFilter:
+    public N4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = ShrunkN4BiasFieldCorrectionImageFilter;
+  using Superclass = N4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using MaskImageType = TMaskImage;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+  using typename Superclass::RealType;
+  using typename Superclass::RealImageType;
+  using typename Superclass::BiasFieldControlPointLatticeType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ShrunkN4BiasFieldCorrectionImageFilter, N4BiasFieldCorrectionImageFilter);
+
+  /** The factor by which the images are shrunk in each dimension for
+   * the fitting, limited by the size of the image. 1 by default. */
+  itkSetClampMacro( ShrinkFactor, unsigned int, 1, NumericTraits<unsigned int>::max() );
+  itkGetConstMacro( ShrinkFactor, unsigned int );
+
+  /** The measurements of the last fitting. */
+  unsigned int GetCurrentLevel() const;
+  unsigned int GetElapsedIterations() const;
+  RealType GetCurrentConvergenceMeasurement() const;
+  const BiasFieldControlPointLatticeType * GetLogBiasFieldControlPointLattice() const;
+
+protected:
+
+  ShrunkN4BiasFieldCorrectionImageFilter() = default;
+
+  ~ShrunkN4BiasFieldCorrectionImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The fitting is done on the shrunk images by an internal filter.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  ShrunkN4BiasFieldCorrectionImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  void InvokeIterationEvent();
+
+  unsigned int m_ShrinkFactor{1};
+
+  typename Superclass::Pointer m_Fitter;
+};
+
+
+} // end namespace itk
+
+
+#include "itkShrunkN4BiasFieldCorrectionImageFilter.hxx"
+
+#endif // itkShrunkN4BiasFieldCorrectionImageFilter_h
@@ -0,0 +1,224 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkShrunkN4BiasFieldCorrectionImageFilter_hxx
+#define itkShrunkN4BiasFieldCorrectionImageFilter_hxx
+
+#include "itkShrunkN4BiasFieldCorrectionImageFilter.h"
+
+#include "itkBSplineControlPointImageFilter.h"
+#include "itkCommand.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressAccumulator.h"
+#include "itkShrinkImageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TMaskImage, class TOutputImage >
+void
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::GenerateData()
+{
+  m_Fitter = nullptr;
+  if ( m_ShrinkFactor <= 1 )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  const InputImageType *input = this->GetInput();
+
+  auto progress = ProgressAccumulator::New();
+  progress->SetMiniPipelineFilter( this );
+
+  typename ShrinkImageFilter< InputImageType, InputImageType >::ShrinkFactorsType shrinkFactors;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    const SizeValueType size = input->GetLargestPossibleRegion().GetSize( d );
+    shrinkFactors[d] = static_cast<unsigned int>( std::min<SizeValueType>( m_ShrinkFactor, size ) );
+    }
+
+  // the shrunk inputs of the fitting
+  auto shrink = [this, &shrinkFactors, &progress]( const auto *image )
+    {
+      using ImageType = typename std::remove_const< typename std::remove_pointer< decltype( image ) >::type >::type;
+      auto shrinker = ShrinkImageFilter< ImageType, ImageType >::New();
+      shrinker->SetInput( image );
+      shrinker->SetShrinkFactors( shrinkFactors );
+      shrinker->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+      progress->RegisterInternalFilter( shrinker, 0.05f );
+      shrinker->Update();
+      typename ImageType::Pointer shrunk = shrinker->GetOutput();
+      shrunk->DisconnectPipeline();
+      return shrunk;
+    };
+
+  m_Fitter = Superclass::New();
+  m_Fitter->SetInput( shrink( input ) );
+  if ( const MaskImageType *mask = this->GetMaskImage() )
+    {
+    m_Fitter->SetMaskImage( shrink( mask ) );
+    }
+  if ( const RealImageType *confidence = this->GetConfidenceImage() )
+    {
+    m_Fitter->SetConfidenceImage( shrink( confidence ) );
+    }
+
+  m_Fitter->SetMaskLabel( this->GetMaskLabel() );
+  m_Fitter->SetUseMaskLabel( this->GetUseMaskLabel() );
+  m_Fitter->SetNumberOfHistogramBins( this->GetNumberOfHistogramBins() );
+  m_Fitter->SetWienerFilterNoise( this->GetWienerFilterNoise() );
+  m_Fitter->SetBiasFieldFullWidthAtHalfMaximum( this->GetBiasFieldFullWidthAtHalfMaximum() );
+  m_Fitter->SetSplineOrder( this->GetSplineOrder() );
+  m_Fitter->SetNumberOfControlPoints( this->GetNumberOfControlPoints() );
+  m_Fitter->SetNumberOfFittingLevels( this->GetNumberOfFittingLevels() );
+  m_Fitter->SetMaximumNumberOfIterations( this->GetMaximumNumberOfIterations() );
+  m_Fitter->SetConvergenceThreshold( this->GetConvergenceThreshold() );
+  m_Fitter->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  auto iterationCommand = SimpleMemberCommand< Self >::New();
+  iterationCommand->SetCallbackFunction( this, &Self::InvokeIterationEvent );
+  m_Fitter->AddObserver( IterationEvent(), iterationCommand );
+
+  progress->RegisterInternalFilter( m_Fitter, 0.8f );
+  m_Fitter->Update();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+
+  // the log bias field of each slab of the output is reconstructed
+  // from the lattice on one thread, then applied, so that only the
+  // slabs being corrected are in memory
+  using LatticeType = BiasFieldControlPointLatticeType;
+  using BiasImageType = Image< typename LatticeType::PixelType, ImageDimension >;
+  using BSplinerType = BSplineControlPointImageFilter< LatticeType, BiasImageType >;
+
+  const LatticeType *lattice = m_Fitter->GetLogBiasFieldControlPointLattice();
+  const unsigned int splineOrder = this->GetSplineOrder();
+
+  constexpr unsigned int SlabDimension = ImageDimension - 1;
+  const SizeValueType length = region.GetSize( SlabDimension );
+  const SizeValueType numberOfSlabs = std::min<SizeValueType>( length, 4 * this->GetNumberOfWorkUnits() );
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [&]( SizeValueType slabIndex )
+      {
+        const SizeValueType begin = slabIndex * length / numberOfSlabs;
+        const SizeValueType end = ( slabIndex + 1 ) * length / numberOfSlabs;
+        RegionType slab = region;
+        slab.SetIndex( SlabDimension, region.GetIndex( SlabDimension ) + static_cast<IndexValueType>( begin ) );
+        slab.SetSize( SlabDimension, end - begin );
+
+        typename OutputImageType::PointType origin;
+        output->TransformIndexToPhysicalPoint( slab.GetIndex(), origin );
+
+        // the pipeline of each slab has its own lattice object, sharing
+        // the control points
+        typename LatticeType::Pointer slabLattice = LatticeType::New();
+        slabLattice->Graft( lattice );
+
+        auto bspliner = BSplinerType::New();
+        bspliner->SetInput( slabLattice );
+        bspliner->SetSplineOrder( splineOrder );
+        bspliner->SetSize( slab.GetSize() );
+        bspliner->SetOrigin( origin );
+        bspliner->SetSpacing( output->GetSpacing() );
+        bspliner->SetDirection( output->GetDirection() );
+        bspliner->SetNumberOfWorkUnits( 1 );
+        bspliner->Update();
+
+        ImageRegionConstIterator< InputImageType > inIt( input, slab );
+        ImageRegionIterator< OutputImageType > outIt( output, slab );
+        ImageRegionConstIterator< BiasImageType > biasIt( bspliner->GetOutput(), bspliner->GetOutput()->GetBufferedRegion() );
+        for ( ; !outIt.IsAtEnd(); ++inIt, ++outIt, ++biasIt )
+          {
+          outIt.Set( static_cast<OutputPixelType>( inIt.Get() / std::exp( biasIt.Get()[0] ) ) );
+          }
+      },
+    nullptr );
+}
+
+
+//
+// InvokeIterationEvent
+//
+template < class TInputImage, class TMaskImage, class TOutputImage >
+void
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::InvokeIterationEvent()
+{
+  this->InvokeEvent( IterationEvent() );
+}
+
+
+//
+// Measurements
+//
+template < class TInputImage, class TMaskImage, class TOutputImage >
+unsigned int
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::GetCurrentLevel() const
+{
+  return m_Fitter ? m_Fitter->GetCurrentLevel() : Superclass::GetCurrentLevel();
+}
+
+template < class TInputImage, class TMaskImage, class TOutputImage >
+unsigned int
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::GetElapsedIterations() const
+{
+  return m_Fitter ? m_Fitter->GetElapsedIterations() : Superclass::GetElapsedIterations();
+}
+
+template < class TInputImage, class TMaskImage, class TOutputImage >
+typename ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::RealType
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::GetCurrentConvergenceMeasurement() const
+{
+  return m_Fitter ? m_Fitter->GetCurrentConvergenceMeasurement() : Superclass::GetCurrentConvergenceMeasurement();
+}
+
+template < class TInputImage, class TMaskImage, class TOutputImage >
+const typename ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::BiasFieldControlPointLatticeType *
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::GetLogBiasFieldControlPointLattice() const
+{
+  return m_Fitter ? m_Fitter->GetLogBiasFieldControlPointLattice() : Superclass::GetLogBiasFieldControlPointLattice();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TMaskImage, class TOutputImage >
+void
+ShrunkN4BiasFieldCorrectionImageFilter< TInputImage, TMaskImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "ShrinkFactor: " << m_ShrinkFactor << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkShrunkN4BiasFieldCorrectionImageFilter_hxx
@@ -0,0 +1,144 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkStreamingMultiLabelSTAPLEImageFilter_h
+#define itkStreamingMultiLabelSTAPLEImageFilter_h
+
+#include "itkMultiLabelSTAPLEImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class StreamingMultiLabelSTAPLEImageFilter
+ * \brief Multi-label STAPLE with the expectation and maximization
+ * steps fused in parallel passes.
+ *
+ * With StreamingFusion off, the default, the filter is the
+ * MultiLabelSTAPLEImageFilter. With StreamingFusion on, the inputs
+ * are read in slabs divided between the threads of the
+ * multithreader, without any image besides the output:
+ *
+ * - the maximum label, the label frequencies of the prior
+ *   probabilities and the majority voting of the initial confusion
+ *   matrices are computed by two passes, the votes of a pixel being
+ *   counted in a histogram of the labels of the inputs only;
+ * - each iteration is a single pass, which computes the label
+ *   probabilities of a pixel from the confusion matrices, and
+ *   accumulates them at once in the next confusion matrices;
+ * - a last pass assigns the most probable labels to the output.
+ *
+ * Each work unit accumulates into its own confusion matrices, in
+ * double precision, which are added in order, so the results do not
+ * depend on the number of threads. The pixels undecided by the
+ * majority voting do not contribute to the initial confusion
+ * matrices.
+ *
+ * The measurements are those of the last execution.
+ *
+ * \sa MultiLabelSTAPLEImageFilter
+ */
+template < class TInputImage, class TOutputImage = TInputImage, class TWeights = float >
+class StreamingMultiLabelSTAPLEImageFilter:
+    public MultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >
+{
+public:
+  /** Standard Self type alias */
+  using Self = StreamingMultiLabelSTAPLEImageFilter;
+  using Superclass = MultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+  using WeightsType = TWeights;
+  using typename Superclass::ConfusionMatrixType;
+  using typename Superclass::PriorProbabilitiesType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(StreamingMultiLabelSTAPLEImageFilter, MultiLabelSTAPLEImageFilter);
+
+  /** Fuse the expectation and maximization steps of each iteration
+   * in a parallel pass over the inputs. Off by default. */
+  itkSetMacro( StreamingFusion, bool );
+  itkGetConstMacro( StreamingFusion, bool );
+  itkBooleanMacro( StreamingFusion );
+
+  /** The parameters of the superclass, which are also recorded for
+   * the streaming fusion.
+   * @{
+   */
+  void SetLabelForUndecidedPixels( OutputPixelType l );
+  OutputPixelType GetLabelForUndecidedPixels() const;
+  void UnsetLabelForUndecidedPixels();
+
+  void SetPriorProbabilities( const PriorProbabilitiesType &ppa );
+  PriorProbabilitiesType GetPriorProbabilities() const;
+  void UnsetPriorProbabilities();
+
+  void SetMaximumNumberOfIterations( unsigned int mit );
+  void UnsetMaximumNumberOfIterations();
+  /** @} */
+
+  /** The confusion matrix of an input of the last execution. */
+  const ConfusionMatrixType & GetConfusionMatrix( unsigned int i ) const;
+
+protected:
+
+  StreamingMultiLabelSTAPLEImageFilter() = default;
+
+  ~StreamingMultiLabelSTAPLEImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The passes over the inputs are computed in slabs by the threads
+  // of the multithreader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  StreamingMultiLabelSTAPLEImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_StreamingFusion{false};
+
+  bool m_HasLabelForUndecidedPixels{false};
+  OutputPixelType m_LabelForUndecidedPixels{};
+  bool m_HasPriorProbabilities{false};
+  PriorProbabilitiesType m_PriorProbabilities;
+  bool m_HasMaximumNumberOfIterations{false};
+
+  std::vector<ConfusionMatrixType> m_ConfusionMatrixArray;
+};
+
+
+} // end namespace itk
+
+
+#include "itkStreamingMultiLabelSTAPLEImageFilter.hxx"
+
+#endif // itkStreamingMultiLabelSTAPLEImageFilter_h
@@ -0,0 +1,443 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkStreamingMultiLabelSTAPLEImageFilter_hxx
+#define itkStreamingMultiLabelSTAPLEImageFilter_hxx
+
+#include "itkStreamingMultiLabelSTAPLEImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::GenerateData()
+{
+  if ( !m_StreamingFusion )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+
+  const unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
+  std::vector<const InputImageType *> inputs( numberOfInputs );
+  for ( unsigned int k = 0; k < numberOfInputs; ++k )
+    {
+    inputs[k] = this->GetInput( k );
+    }
+
+  constexpr unsigned int SlabDimension = ImageDimension - 1;
+  const SizeValueType length = region.GetSize( SlabDimension );
+  const SizeValueType numberOfSlabs = std::min<SizeValueType>( length, this->GetNumberOfWorkUnits() );
+  const SizeValueType lineLength = region.GetSize( 0 );
+
+  // call func with the lines of the inputs and the output iterator
+  // at the start of each line of a slab, for each slab in parallel
+  auto forEachLine = [&]( const auto &func )
+    {
+      this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        numberOfSlabs,
+        [&]( SizeValueType slabIndex )
+          {
+            const SizeValueType begin = slabIndex * length / numberOfSlabs;
+            const SizeValueType end = ( slabIndex + 1 ) * length / numberOfSlabs;
+            RegionType slab = region;
+            slab.SetIndex( SlabDimension, region.GetIndex( SlabDimension ) + static_cast<IndexValueType>( begin ) );
+            slab.SetSize( SlabDimension, end - begin );
+
+            std::vector<const InputPixelType *> lines( numberOfInputs );
+            ImageScanlineIterator<OutputImageType> outIt( output, slab );
+            while ( !outIt.IsAtEnd() )
+              {
+              for ( unsigned int k = 0; k < numberOfInputs; ++k )
+                {
+                lines[k] = inputs[k]->GetBufferPointer() + inputs[k]->ComputeOffset( outIt.GetIndex() );
+                }
+              func( slabIndex, lines, outIt );
+              outIt.NextLine();
+              }
+          },
+        nullptr );
+    };
+
+  // the maximum label of the inputs
+  std::vector<InputPixelType> slabMaximum( numberOfSlabs, NumericTraits<InputPixelType>::ZeroValue() );
+  forEachLine( [&]( SizeValueType slabIndex, const std::vector<const InputPixelType *> &lines, ImageScanlineIterator<OutputImageType> & )
+    {
+      for ( const InputPixelType *line : lines )
+        {
+        slabMaximum[slabIndex] = std::max( slabMaximum[slabIndex], *std::max_element( line, line + lineLength ) );
+        }
+    } );
+  const size_t totalLabelCount = static_cast<size_t>( *std::max_element( slabMaximum.begin(), slabMaximum.end() ) ) + 1;
+
+  if ( !m_HasLabelForUndecidedPixels )
+    {
+    if ( totalLabelCount > static_cast<size_t>( NumericTraits<OutputPixelType>::max() ) )
+      {
+      itkWarningMacro( "No new label for undecided pixels, using zero." );
+      }
+    m_LabelForUndecidedPixels = static_cast<OutputPixelType>( totalLabelCount );
+    }
+
+  if ( m_HasPriorProbabilities && m_PriorProbabilities.GetSize() < totalLabelCount )
+    {
+    itkExceptionMacro( "m_PriorProbabilities array has wrong size " << m_PriorProbabilities << "; should be at least "
+                       << totalLabelCount );
+    }
+
+  // the confusion matrices of the inputs are stored one after the
+  // other, the rows of the input labels, with the row of the reject
+  // label of the superclass, and the columns of the estimated labels
+  const size_t numberOfRows = totalLabelCount + 1;
+  const size_t matrixSize = numberOfRows * totalLabelCount;
+  const size_t confusionSize = numberOfInputs * matrixSize;
+  std::vector< std::vector<double> > slabConfusion( numberOfSlabs, std::vector<double>( confusionSize, 0.0 ) );
+
+  // add the confusion matrices of the slabs in order, normalize the
+  // columns of each matrix to a unit sum
+  auto accumulateSlabs = [&]()
+    {
+      std::vector<double> confusion( confusionSize, 0.0 );
+      for ( std::vector<double> &s : slabConfusion )
+        {
+        for ( size_t i = 0; i < confusionSize; ++i )
+          {
+          confusion[i] += s[i];
+          }
+        std::fill( s.begin(), s.end(), 0.0 );
+        }
+      for ( unsigned int k = 0; k < numberOfInputs; ++k )
+        {
+        double *matrix = confusion.data() + k * matrixSize;
+        for ( size_t c = 0; c < totalLabelCount; ++c )
+          {
+          double sum = 0.0;
+          for ( size_t j = 0; j < numberOfRows; ++j )
+            {
+            sum += matrix[j * totalLabelCount + c];
+            }
+          if ( sum > 0.0 )
+            {
+            for ( size_t j = 0; j < numberOfRows; ++j )
+              {
+              matrix[j * totalLabelCount + c] /= sum;
+              }
+            }
+          }
+        }
+      return confusion;
+    };
+
+  // the frequencies of the labels, and the majority voting of the
+  // initial confusion matrices
+  std::vector< std::vector<double> > slabFrequencies( numberOfSlabs, std::vector<double>( totalLabelCount, 0.0 ) );
+  forEachLine( [&]( SizeValueType slabIndex, const std::vector<const InputPixelType *> &lines, ImageScanlineIterator<OutputImageType> & )
+    {
+      std::vector<unsigned int> votes( totalLabelCount, 0 );
+      std::vector<double> &frequencies = slabFrequencies[slabIndex];
+      double *confusion = slabConfusion[slabIndex].data();
+
+      for ( SizeValueType x = 0; x < lineLength; ++x )
+        {
+        for ( const InputPixelType *line : lines )
+          {
+          ++votes[line[x]];
+          frequencies[line[x]] += 1.0;
+          }
+
+        // the unique label with the most votes
+        unsigned int mostVotes = 0;
+        size_t winner = 0;
+        bool unique = false;
+        for ( const InputPixelType *line : lines )
+          {
+          const size_t label = line[x];
+          if ( votes[label] > mostVotes )
+            {
+            mostVotes = votes[label];
+            winner = label;
+            unique = true;
+            }
+          else if ( votes[label] == mostVotes && label != winner )
+            {
+            unique = false;
+            }
+          }
+
+        for ( unsigned int k = 0; k < numberOfInputs; ++k )
+          {
+          votes[lines[k][x]] = 0;
+          if ( unique )
+            {
+            confusion[k * matrixSize + static_cast<size_t>( lines[k][x] ) * totalLabelCount + winner] += 1.0;
+            }
+          }
+        }
+    } );
+
+  if ( !m_HasPriorProbabilities )
+    {
+    std::vector<double> frequencies( totalLabelCount, 0.0 );
+    for ( const std::vector<double> &f : slabFrequencies )
+      {
+      for ( size_t c = 0; c < totalLabelCount; ++c )
+        {
+        frequencies[c] += f[c];
+        }
+      }
+    const double total = static_cast<double>( numberOfInputs ) * static_cast<double>( region.GetNumberOfPixels() );
+    m_PriorProbabilities.SetSize( totalLabelCount );
+    for ( size_t c = 0; c < totalLabelCount; ++c )
+      {
+      m_PriorProbabilities[c] = static_cast<WeightsType>( frequencies[c] / total );
+      }
+    }
+  slabFrequencies.clear();
+
+  std::vector<WeightsType> confusion( confusionSize );
+  {
+  const std::vector<double> initial = accumulateSlabs();
+  std::copy( initial.begin(), initial.end(), confusion.begin() );
+  }
+
+  // the label probabilities of the pixel x of the lines
+  auto estimate = [&]( const std::vector<const InputPixelType *> &lines, SizeValueType x, std::vector<WeightsType> &W )
+    {
+      for ( size_t c = 0; c < totalLabelCount; ++c )
+        {
+        W[c] = m_PriorProbabilities[c];
+        }
+      for ( unsigned int k = 0; k < numberOfInputs; ++k )
+        {
+        const WeightsType *row = confusion.data() + k * matrixSize + static_cast<size_t>( lines[k][x] ) * totalLabelCount;
+        for ( size_t c = 0; c < totalLabelCount; ++c )
+          {
+          W[c] *= row[c];
+          }
+        }
+    };
+
+  const WeightsType terminationUpdateThreshold = this->GetTerminationUpdateThreshold();
+  const unsigned int maximumNumberOfIterations = this->GetMaximumNumberOfIterations();
+
+  unsigned int elapsedIterations = 0;
+  bool converged = false;
+  while ( !converged )
+    {
+    ++elapsedIterations;
+
+    forEachLine( [&]( SizeValueType slabIndex, const std::vector<const InputPixelType *> &lines, ImageScanlineIterator<OutputImageType> & )
+      {
+        std::vector<WeightsType> W( totalLabelCount );
+        double *updated = slabConfusion[slabIndex].data();
+
+          for ( SizeValueType x = 0; x < lineLength; ++x )
+          {
+          estimate( lines, x, W );
+
+          WeightsType sumW = W[0];
+          for ( size_t c = 1; c < totalLabelCount; ++c )
+            {
+            sumW += W[c];
+            }
+          if ( sumW != 0 )
+            {
+            for ( size_t c = 0; c < totalLabelCount; ++c )
+              {
+              W[c] /= sumW;
+              }
+            }
+
+          for ( unsigned int k = 0; k < numberOfInputs; ++k )
+            {
+            double *row = updated + k * matrixSize + static_cast<size_t>( lines[k][x] ) * totalLabelCount;
+            for ( size_t c = 0; c < totalLabelCount; ++c )
+              {
+              row[c] += W[c];
+              }
+            }
+          }
+      } );
+
+    const std::vector<double> updated = accumulateSlabs();
+    double maximumUpdate = 0.0;
+    for ( size_t i = 0; i < confusionSize; ++i )
+      {
+      const auto value = static_cast<WeightsType>( updated[i] );
+      maximumUpdate = std::max( maximumUpdate, std::abs( static_cast<double>( value ) - static_cast<double>( confusion[i] ) ) );
+      confusion[i] = value;
+      }
+
+    this->InvokeEvent( IterationEvent() );
+    converged = this->GetAbortGenerateData() ||
+                maximumUpdate < static_cast<double>( terminationUpdateThreshold ) ||
+                ( m_HasMaximumNumberOfIterations && elapsedIterations >= maximumNumberOfIterations );
+    }
+  slabConfusion.clear();
+
+  // the most probable labels, or the undecided label when it is not
+  // unique
+  const OutputPixelType undecided = m_LabelForUndecidedPixels;
+  forEachLine( [&]( SizeValueType, const std::vector<const InputPixelType *> &lines, ImageScanlineIterator<OutputImageType> &outIt )
+    {
+      std::vector<WeightsType> W( totalLabelCount );
+
+      for ( SizeValueType x = 0; !outIt.IsAtEndOfLine(); ++x, ++outIt )
+        {
+        estimate( lines, x, W );
+
+        OutputPixelType winningLabel = undecided;
+        WeightsType winningLabelW = 0;
+        for ( size_t c = 0; c < totalLabelCount; ++c )
+          {
+          if ( W[c] > winningLabelW )
+            {
+            winningLabelW = W[c];
+            winningLabel = static_cast<OutputPixelType>( c );
+            }
+          else if ( !( W[c] < winningLabelW ) )
+            {
+            winningLabel = undecided;
+            }
+          }
+        outIt.Set( winningLabel );
+        }
+    } );
+
+  m_ConfusionMatrixArray.assign( numberOfInputs, ConfusionMatrixType( numberOfRows, totalLabelCount ) );
+  for ( unsigned int k = 0; k < numberOfInputs; ++k )
+    {
+    std::copy( confusion.begin() + k * matrixSize, confusion.begin() + ( k + 1 ) * matrixSize, m_ConfusionMatrixArray[k].data_block() );
+    }
+}
+
+
+//
+// Parameters
+//
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::SetLabelForUndecidedPixels( OutputPixelType l )
+{
+  Superclass::SetLabelForUndecidedPixels( l );
+  m_LabelForUndecidedPixels = l;
+  m_HasLabelForUndecidedPixels = true;
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+auto
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::GetLabelForUndecidedPixels() const
+  -> OutputPixelType
+{
+  return m_StreamingFusion ? m_LabelForUndecidedPixels : Superclass::GetLabelForUndecidedPixels();
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::UnsetLabelForUndecidedPixels()
+{
+  Superclass::UnsetLabelForUndecidedPixels();
+  m_HasLabelForUndecidedPixels = false;
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::SetPriorProbabilities( const PriorProbabilitiesType &ppa )
+{
+  Superclass::SetPriorProbabilities( ppa );
+  m_PriorProbabilities = ppa;
+  m_HasPriorProbabilities = true;
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+auto
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::GetPriorProbabilities() const
+  -> PriorProbabilitiesType
+{
+  return m_StreamingFusion ? m_PriorProbabilities : Superclass::GetPriorProbabilities();
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::UnsetPriorProbabilities()
+{
+  Superclass::UnsetPriorProbabilities();
+  m_HasPriorProbabilities = false;
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::SetMaximumNumberOfIterations( unsigned int mit )
+{
+  Superclass::SetMaximumNumberOfIterations( mit );
+  m_HasMaximumNumberOfIterations = true;
+}
+
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::UnsetMaximumNumberOfIterations()
+{
+  Superclass::UnsetMaximumNumberOfIterations();
+  m_HasMaximumNumberOfIterations = false;
+}
+
+
+//
+// Measurements
+//
+template < class TInputImage, class TOutputImage, class TWeights >
+auto
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::GetConfusionMatrix( unsigned int i ) const
+  -> const ConfusionMatrixType &
+{
+  if ( !m_StreamingFusion )
+    {
+    return const_cast<Superclass *>( static_cast<const Superclass *>( this ) )->GetConfusionMatrix( i );
+    }
+  return m_ConfusionMatrixArray[i];
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage, class TWeights >
+void
+StreamingMultiLabelSTAPLEImageFilter< TInputImage, TOutputImage, TWeights >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "StreamingFusion: " << m_StreamingFusion << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkStreamingMultiLabelSTAPLEImageFilter_hxx
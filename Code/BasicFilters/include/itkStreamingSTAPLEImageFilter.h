@@ -0,0 +1,117 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkStreamingSTAPLEImageFilter_h
+#define itkStreamingSTAPLEImageFilter_h
+
+#include "itkSTAPLEImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class StreamingSTAPLEImageFilter
+ * \brief STAPLE with the expectation and maximization steps fused in
+ * parallel passes.
+ *
+ * With StreamingFusion off, the default, the filter is the
+ * STAPLEImageFilter. With StreamingFusion on, each iteration is a
+ * single pass over the inputs, divided in slabs between the threads
+ * of the multithreader: the fuzzy ground truth of a pixel is
+ * estimated from the sensitivities and specificities of the previous
+ * iteration and written to the output, and is accumulated at once in
+ * the sums of the next sensitivities and specificities. The sums of
+ * the slabs are added in the order of the slabs, so the results do
+ * not depend on the number of threads. The superclass makes a pass
+ * over the output for each input and iteration on a single thread.
+ *
+ * The results are those of the superclass up to the rounding of the
+ * sums, and the measurements are those of the last execution.
+ *
+ * \sa STAPLEImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class StreamingSTAPLEImageFilter:
+    public STAPLEImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = StreamingSTAPLEImageFilter;
+  using Superclass = STAPLEImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(StreamingSTAPLEImageFilter, STAPLEImageFilter);
+
+  /** Fuse the expectation and maximization steps of each iteration
+   * in a parallel pass over the inputs. Off by default. */
+  itkSetMacro( StreamingFusion, bool );
+  itkGetConstMacro( StreamingFusion, bool );
+  itkBooleanMacro( StreamingFusion );
+
+  /** The measurements of the last execution. */
+  unsigned int GetElapsedIterations() const;
+  const std::vector<double> & GetSensitivity() const;
+  double GetSensitivity( unsigned int i ) const;
+  const std::vector<double> & GetSpecificity() const;
+  double GetSpecificity( unsigned int i ) const;
+
+protected:
+
+  StreamingSTAPLEImageFilter() = default;
+
+  ~StreamingSTAPLEImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The iterations are computed in slabs by the threads of the
+  // multithreader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  StreamingSTAPLEImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  bool m_StreamingFusion{false};
+
+  unsigned int m_StreamingElapsedIterations{0};
+  std::vector<double> m_StreamingSensitivity;
+  std::vector<double> m_StreamingSpecificity;
+};
+
+
+} // end namespace itk
+
+
+#include "itkStreamingSTAPLEImageFilter.hxx"
+
+#endif // itkStreamingSTAPLEImageFilter_h
@@ -0,0 +1,271 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkStreamingSTAPLEImageFilter_hxx
+#define itkStreamingSTAPLEImageFilter_hxx
+
+#include "itkStreamingSTAPLEImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  if ( !m_StreamingFusion )
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  // the precision of the convergence of the superclass
+  constexpr double MinimumChange = 1.0e-14;
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const RegionType region = output->GetRequestedRegion();
+
+  const unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
+  const InputPixelType foregroundValue = this->GetForegroundValue();
+
+  std::vector<const InputImageType *> inputs( numberOfInputs );
+  for ( unsigned int i = 0; i < numberOfInputs; ++i )
+    {
+    inputs[i] = this->GetInput( i );
+    if ( inputs[i]->GetRequestedRegion() != region )
+      {
+      itkExceptionMacro( << "One or more input images do not contain matching RequestedRegions" );
+      }
+    }
+
+  constexpr unsigned int SlabDimension = ImageDimension - 1;
+  const SizeValueType length = region.GetSize( SlabDimension );
+  const SizeValueType numberOfSlabs = std::min<SizeValueType>( length, 4 * this->GetNumberOfWorkUnits() );
+
+  // the sums of each slab, the numerators of the sensitivities and
+  // of the specificities of the inputs followed by their common
+  // denominators
+  const unsigned int numberOfSums = 2 * numberOfInputs + 2;
+  std::vector< std::vector<double> > slabSums( numberOfSlabs, std::vector<double>( numberOfSums ) );
+
+  std::vector<double> p( numberOfInputs, 0.0 );
+  std::vector<double> q( numberOfInputs, 0.0 );
+  double g_t = 0.0;
+
+  // estimate the fuzzy ground truth of the pixels, from the average
+  // of the inputs for the first pass, and accumulate the sums of the
+  // next estimates of the sensitivities and specificities
+  auto pass = [&]( bool first )
+    {
+      this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        numberOfSlabs,
+        [&]( SizeValueType slabIndex )
+          {
+            const SizeValueType begin = slabIndex * length / numberOfSlabs;
+            const SizeValueType end = ( slabIndex + 1 ) * length / numberOfSlabs;
+            RegionType slab = region;
+            slab.SetIndex( SlabDimension, region.GetIndex( SlabDimension ) + static_cast<IndexValueType>( begin ) );
+            slab.SetSize( SlabDimension, end - begin );
+
+            std::vector<double> &sums = slabSums[slabIndex];
+            std::fill( sums.begin(), sums.end(), 0.0 );
+            double *pNumerator = sums.data();
+            double *qNumerator = pNumerator + numberOfInputs;
+            double &pDenominator = sums[2 * numberOfInputs];
+            double &qDenominator = sums[2 * numberOfInputs + 1];
+
+            std::vector<const InputPixelType *> lines( numberOfInputs );
+            std::vector<char> foreground( numberOfInputs );
+
+            ImageScanlineIterator<OutputImageType> outIt( output, slab );
+            while ( !outIt.IsAtEnd() )
+              {
+              for ( unsigned int i = 0; i < numberOfInputs; ++i )
+                {
+                lines[i] = inputs[i]->GetBufferPointer() + inputs[i]->ComputeOffset( outIt.GetIndex() );
+                }
+
+              for ( SizeValueType x = 0; !outIt.IsAtEndOfLine(); ++x, ++outIt )
+                {
+                unsigned int count = 0;
+                for ( unsigned int i = 0; i < numberOfInputs; ++i )
+                  {
+                  foreground[i] = ( lines[i][x] == foregroundValue );
+                  count += foreground[i];
+                  }
+
+                double w;
+                if ( first )
+                  {
+                  w = static_cast<double>( count ) / static_cast<double>( numberOfInputs );
+                  }
+                else
+                  {
+                  double alpha = g_t;
+                  double beta = 1.0 - g_t;
+                  for ( unsigned int i = 0; i < numberOfInputs; ++i )
+                    {
+                    if ( foreground[i] )
+                      {
+                      alpha *= p[i];
+                      beta *= 1.0 - q[i];
+                      }
+                    else
+                      {
+                      alpha *= 1.0 - p[i];
+                      beta *= q[i];
+                      }
+                    }
+                  w = alpha / ( alpha + beta );
+                  }
+                outIt.Set( static_cast<OutputPixelType>( w ) );
+
+                for ( unsigned int i = 0; i < numberOfInputs; ++i )
+                  {
+                  if ( foreground[i] )
+                    {
+                    pNumerator[i] += w;
+                    }
+                  else
+                    {
+                    qNumerator[i] += 1.0 - w;
+                    }
+                  }
+                pDenominator += w;
+                qDenominator += 1.0 - w;
+                }
+              outIt.NextLine();
+              }
+          },
+        nullptr );
+
+      // the slabs are added in order, for results independent of the
+      // threads
+      std::vector<double> sums( numberOfSums, 0.0 );
+      for ( const std::vector<double> &s : slabSums )
+        {
+        for ( unsigned int j = 0; j < numberOfSums; ++j )
+          {
+          sums[j] += s[j];
+          }
+        }
+      return sums;
+    };
+
+  std::vector<double> sums = pass( true );
+  g_t = sums[2 * numberOfInputs] / static_cast<double>( region.GetNumberOfPixels() ) * this->GetConfidenceWeight();
+
+  std::vector<double> lastP( numberOfInputs, -10.0 );
+  std::vector<double> lastQ( numberOfInputs, -10.0 );
+
+  unsigned int iteration = 0;
+  while ( iteration < this->GetMaximumIterations() )
+    {
+    for ( unsigned int i = 0; i < numberOfInputs; ++i )
+      {
+      p[i] = sums[i] / sums[2 * numberOfInputs];
+      q[i] = sums[numberOfInputs + i] / sums[2 * numberOfInputs + 1];
+      }
+
+    ++iteration;
+    sums = pass( false );
+
+    bool changed = false;
+    for ( unsigned int i = 0; i < numberOfInputs; ++i )
+      {
+      changed = changed || std::abs( lastP[i] - p[i] ) >= MinimumChange || std::abs( lastQ[i] - q[i] ) >= MinimumChange;
+      }
+    lastP = p;
+    lastQ = q;
+
+    this->InvokeEvent( IterationEvent() );
+    if ( !changed || this->GetAbortGenerateData() )
+      {
+      break;
+      }
+    }
+
+  m_StreamingElapsedIterations = iteration;
+  m_StreamingSensitivity = p;
+  m_StreamingSpecificity = q;
+}
+
+
+//
+// Measurements
+//
+template < class TInputImage, class TOutputImage >
+unsigned int
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::GetElapsedIterations() const
+{
+  return m_StreamingFusion ? m_StreamingElapsedIterations : Superclass::GetElapsedIterations();
+}
+
+template < class TInputImage, class TOutputImage >
+const std::vector<double> &
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::GetSensitivity() const
+{
+  return m_StreamingFusion ? m_StreamingSensitivity : Superclass::GetSensitivity();
+}
+
+template < class TInputImage, class TOutputImage >
+double
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::GetSensitivity( unsigned int i ) const
+{
+  return this->GetSensitivity()[i];
+}
+
+template < class TInputImage, class TOutputImage >
+const std::vector<double> &
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::GetSpecificity() const
+{
+  return m_StreamingFusion ? m_StreamingSpecificity : Superclass::GetSpecificity();
+}
+
+template < class TInputImage, class TOutputImage >
+double
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::GetSpecificity( unsigned int i ) const
+{
+  return this->GetSpecificity()[i];
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+StreamingSTAPLEImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "StreamingFusion: " << m_StreamingFusion << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkStreamingSTAPLEImageFilter_hxx
@@ -0,0 +1,115 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledGradientMagnitudeRecursiveGaussianImageFilter_hxx
+#define itkTiledGradientMagnitudeRecursiveGaussianImageFilter_hxx
+
+#include "itkTiledGradientMagnitudeRecursiveGaussianImageFilter.h"
+
+#include "itkTiledRecursiveGaussianDerivatives.h"
+
+#include <cmath>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientMagnitudeRecursiveGaussianImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  const bool inputIsOverwritten = static_cast< const void * >( output->GetBufferPointer() ) == static_cast< const void * >( input->GetBufferPointer() );
+
+  FixedArray< double, ImageDimension > sigma;
+  sigma.Fill( this->GetSigma() );
+
+  constexpr unsigned int LastAxis = ( ImageDimension > 1 ) ? ImageDimension - 2 : 0;
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  TiledRecursiveGaussianDerivatives(
+    input,
+    sigma,
+    1,
+    this->GetNormalizeAcrossScale(),
+    inputIsOverwritten,
+    this->GetMultiThreader(),
+    [output]( unsigned int axis, const float *values, const RegionType &slab )
+      {
+        OutputPixelType *out = output->GetBufferPointer() + output->ComputeOffset( slab.GetIndex() );
+        const SizeValueType numberOfPixels = slab.GetNumberOfPixels();
+        if ( axis == ImageDimension - 1 )
+          {
+          for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+            {
+            out[p] = static_cast< OutputPixelType >( values[p] * values[p] );
+            }
+          }
+        else
+          {
+          for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+            {
+            out[p] += static_cast< OutputPixelType >( values[p] * values[p] );
+            }
+          }
+        if ( axis == LastAxis )
+          {
+          for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+            {
+            out[p] = static_cast< OutputPixelType >( std::sqrt( out[p] ) );
+            }
+          }
+      } );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientMagnitudeRecursiveGaussianImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientMagnitudeRecursiveGaussianImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+} // end namespace itk
+
+#endif // itkTiledGradientMagnitudeRecursiveGaussianImageFilter_hxx
@@ -0,0 +1,105 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledGradientRecursiveGaussianImageFilter_h
+#define itkTiledGradientRecursiveGaussianImageFilter_h
+
+#include "itkGradientRecursiveGaussianImageFilter.h"
+
+#include <type_traits>
+
+
+namespace itk {
+
+/** \class TiledGradientRecursiveGaussianImageFilter
+ * \brief Gradient of recursive Gaussian derivatives computed by slabs.
+ *
+ * For a scalar input, the derivatives along each axis are computed
+ * with the recursive Gaussian filters of the superclass, by slabs of
+ * the image, and stored in the components of the output, which are
+ * rotated by the direction of the input for UseImageDirection.
+ * Besides the input and the output, only the pass along the slowest
+ * axis needs a full-size float image. The whole input is required.
+ *
+ * The images of vectors are computed by the superclass.
+ *
+ * \sa GradientRecursiveGaussianImageFilter
+ * \sa TiledRecursiveGaussianDerivatives
+ */
+template < class TInputImage, class TOutputImage >
+class TiledGradientRecursiveGaussianImageFilter:
+    public GradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = TiledGradientRecursiveGaussianImageFilter;
+  using Superclass = GradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputComponentType = typename NumericTraits< typename TOutputImage::PixelType >::ValueType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(TiledGradientRecursiveGaussianImageFilter, GradientRecursiveGaussianImageFilter);
+
+protected:
+
+  TiledGradientRecursiveGaussianImageFilter() = default;
+
+  ~TiledGradientRecursiveGaussianImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The passes are computed by slabs.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the slabs need all of the input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the slabs produce all of the output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  /** Compute the derivatives by slabs for the scalar inputs, with the
+   * superclass otherwise. */
+  void GenerateTiledData( std::true_type );
+  void GenerateTiledData( std::false_type );
+
+private:
+  TiledGradientRecursiveGaussianImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+};
+
+
+} // end namespace itk
+
+
+#include "itkTiledGradientRecursiveGaussianImageFilter.hxx"
+
+#endif // itkTiledGradientRecursiveGaussianImageFilter_h
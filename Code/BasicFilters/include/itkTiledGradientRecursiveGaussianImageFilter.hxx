@@ -0,0 +1,139 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledGradientRecursiveGaussianImageFilter_hxx
+#define itkTiledGradientRecursiveGaussianImageFilter_hxx
+
+#include "itkTiledGradientRecursiveGaussianImageFilter.h"
+
+#include "itkTiledRecursiveGaussianDerivatives.h"
+
+#include <algorithm>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  this->GenerateTiledData( std::is_arithmetic< InputPixelType >() );
+}
+
+
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >::GenerateTiledData( std::false_type )
+{
+  Superclass::GenerateData();
+}
+
+
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >::GenerateTiledData( std::true_type )
+{
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  FixedArray< double, ImageDimension > sigma;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    sigma[d] = this->GetSigmaArray()[d];
+    }
+
+  constexpr unsigned int LastAxis = ( ImageDimension > 1 ) ? ImageDimension - 2 : 0;
+  const bool useImageDirection = this->GetUseImageDirection();
+  const typename InputImageType::DirectionType direction = input->GetDirection();
+
+  // the components of the pixels are contiguous
+  OutputComponentType *buffer = reinterpret_cast< OutputComponentType * >( output->GetBufferPointer() );
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  TiledRecursiveGaussianDerivatives(
+    input,
+    sigma,
+    1,
+    this->GetNormalizeAcrossScale(),
+    false,
+    this->GetMultiThreader(),
+    [&]( unsigned int axis, const float *values, const RegionType &slab )
+      {
+        OutputComponentType *out = buffer + ImageDimension * output->ComputeOffset( slab.GetIndex() );
+        const SizeValueType numberOfPixels = slab.GetNumberOfPixels();
+        for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+          {
+          out[ImageDimension * p + axis] = static_cast< OutputComponentType >( values[p] );
+          }
+        if ( axis == LastAxis && useImageDirection )
+          {
+          for ( SizeValueType p = 0; p < numberOfPixels; ++p )
+            {
+            OutputComponentType *pixel = out + ImageDimension * p;
+            double gradient[ImageDimension];
+            std::copy( pixel, pixel + ImageDimension, gradient );
+            for ( unsigned int i = 0; i < ImageDimension; ++i )
+              {
+              double value = 0.0;
+              for ( unsigned int j = 0; j < ImageDimension; ++j )
+                {
+                value += direction[i][j] * gradient[j];
+                }
+              pixel[i] = static_cast< OutputComponentType >( value );
+              }
+            }
+          }
+      } );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledGradientRecursiveGaussianImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+} // end namespace itk
+
+#endif // itkTiledGradientRecursiveGaussianImageFilter_hxx
@@ -0,0 +1,95 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledLaplacianRecursiveGaussianImageFilter_h
+#define itkTiledLaplacianRecursiveGaussianImageFilter_h
+
+#include "itkLaplacianRecursiveGaussianImageFilter.h"
+
+
+namespace itk {
+
+/** \class TiledLaplacianRecursiveGaussianImageFilter
+ * \brief Laplacian of recursive Gaussian derivatives computed by slabs.
+ *
+ * The second derivatives along each axis are computed with the
+ * recursive Gaussian filters of the superclass, by slabs of the image,
+ * and accumulated in the output. Besides the input and the output,
+ * only the pass along the slowest axis needs a full-size float image,
+ * instead of the intermediates of each axis. The whole input is
+ * required.
+ *
+ * \sa LaplacianRecursiveGaussianImageFilter
+ * \sa TiledRecursiveGaussianDerivatives
+ */
+template < class TInputImage, class TOutputImage >
+class TiledLaplacianRecursiveGaussianImageFilter:
+    public LaplacianRecursiveGaussianImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = TiledLaplacianRecursiveGaussianImageFilter;
+  using Superclass = LaplacianRecursiveGaussianImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(TiledLaplacianRecursiveGaussianImageFilter, LaplacianRecursiveGaussianImageFilter);
+
+protected:
+
+  TiledLaplacianRecursiveGaussianImageFilter() = default;
+
+  ~TiledLaplacianRecursiveGaussianImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The passes are computed by slabs.
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the slabs need all of the input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the slabs produce all of the output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+private:
+  TiledLaplacianRecursiveGaussianImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+};
+
+
+} // end namespace itk
+
+
+#include "itkTiledLaplacianRecursiveGaussianImageFilter.hxx"
+
+#endif // itkTiledLaplacianRecursiveGaussianImageFilter_h
@@ -0,0 +1,84 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledObjectnessMeasureImageFilter_h
+#define itkTiledObjectnessMeasureImageFilter_h
+
+#include "itkObjectnessMeasureImageFilter.h"
+
+
+namespace itk {
+
+/** \class TiledObjectnessMeasureImageFilter
+ * \brief Objectness measure computed by tiles.
+ *
+ * The output is divided into tiles of about 16K pixels, which are
+ * split between the threads of the multithreader. The objectness of
+ * each tile is computed by the superclass, with a single work unit,
+ * from a copy of the input of the tile padded by the pixels of the
+ * finite differences of the Hessian. The result is the same as the
+ * superclass, but the Hessian and its eigenvalues are only stored for
+ * a tile at a time in each thread, instead of for the whole image.
+ *
+ * \sa ObjectnessMeasureImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class TiledObjectnessMeasureImageFilter:
+    public ObjectnessMeasureImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = TiledObjectnessMeasureImageFilter;
+  using Superclass = ObjectnessMeasureImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(TiledObjectnessMeasureImageFilter, ObjectnessMeasureImageFilter);
+
+protected:
+
+  TiledObjectnessMeasureImageFilter() = default;
+
+  ~TiledObjectnessMeasureImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The tiles are computed by the threads of the multithreader.
+  void GenerateData() override;
+
+private:
+  TiledObjectnessMeasureImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+};
+
+
+} // end namespace itk
+
+
+#include "itkTiledObjectnessMeasureImageFilter.hxx"
+
+#endif // itkTiledObjectnessMeasureImageFilter_h
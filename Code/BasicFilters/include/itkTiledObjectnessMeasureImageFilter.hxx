@@ -0,0 +1,126 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledObjectnessMeasureImageFilter_hxx
+#define itkTiledObjectnessMeasureImageFilter_hxx
+
+#include "itkTiledObjectnessMeasureImageFilter.h"
+
+#include "itkImageAlgorithm.h"
+
+#include <algorithm>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+TiledObjectnessMeasureImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  constexpr SizeValueType TilePixels = 1 << 14;
+  // the finite differences of the Hessian use the adjacent pixels
+  constexpr SizeValueType Padding = 1;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  const RegionType region = output->GetRequestedRegion();
+  const RegionType inputRegion = input->GetBufferedRegion();
+
+  // halve the longest side of the tiles, the slowest on ties, until
+  // they are small enough
+  typename RegionType::SizeType tileSize = region.GetSize();
+  auto numberOfTilePixels = [&tileSize]()
+    {
+      SizeValueType n = 1;
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        n *= tileSize[d];
+        }
+      return n;
+    };
+  while ( numberOfTilePixels() > TilePixels )
+    {
+    unsigned int longest = ImageDimension - 1;
+    for ( unsigned int d = ImageDimension - 1; d-- > 0; )
+      {
+      if ( tileSize[d] > tileSize[longest] )
+        {
+        longest = d;
+        }
+      }
+    tileSize[longest] = ( tileSize[longest] + 1 ) / 2;
+    }
+
+  SizeValueType tilesPerDimension[ImageDimension];
+  SizeValueType numberOfTiles = 1;
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    tilesPerDimension[d] = ( region.GetSize( d ) + tileSize[d] - 1 ) / tileSize[d];
+    numberOfTiles *= tilesPerDimension[d];
+    }
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfTiles,
+    [&]( SizeValueType tileIndex )
+      {
+        RegionType tile;
+        SizeValueType position = tileIndex;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          const SizeValueType first = ( position % tilesPerDimension[d] ) * tileSize[d];
+          position /= tilesPerDimension[d];
+          tile.SetIndex( d, region.GetIndex( d ) + static_cast<IndexValueType>( first ) );
+          tile.SetSize( d, std::min( tileSize[d], region.GetSize( d ) - first ) );
+          }
+
+        RegionType padded = tile;
+        padded.PadByRadius( Padding );
+        padded.Crop( inputRegion );
+
+        typename InputImageType::Pointer tileInput = InputImageType::New();
+        tileInput->CopyInformation( input );
+        tileInput->SetRegions( padded );
+        tileInput->Allocate();
+        ImageAlgorithm::Copy( input, tileInput.GetPointer(), padded, padded );
+
+        typename Superclass::Pointer objectness = Superclass::New();
+        objectness->SetInput( tileInput );
+        objectness->SetAlpha( this->GetAlpha() );
+        objectness->SetBeta( this->GetBeta() );
+        objectness->SetGamma( this->GetGamma() );
+        objectness->SetScaleObjectnessMeasure( this->GetScaleObjectnessMeasure() );
+        objectness->SetBrightObject( this->GetBrightObject() );
+        objectness->SetObjectDimension( this->GetObjectDimension() );
+        objectness->SetNumberOfWorkUnits( 1 );
+        objectness->Update();
+
+        ImageAlgorithm::Copy( objectness->GetOutput(), output, tile, tile );
+      },
+    nullptr );
+}
+
+
+} // end namespace itk
+
+#endif // itkTiledObjectnessMeasureImageFilter_hxx
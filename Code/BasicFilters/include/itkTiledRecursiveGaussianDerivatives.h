@@ -0,0 +1,199 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkTiledRecursiveGaussianDerivatives_h
+#define itkTiledRecursiveGaussianDerivatives_h
+
+#include "itkImage.h"
+#include "itkMultiThreaderBase.h"
+#include "itkRecursiveGaussianImageFilter.h"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace itk {
+
+/** \brief Compute the recursive Gaussian derivatives of an image along
+ * each axis by slabs.
+ *
+ * For each axis d, the derivative of order along d of the input
+ * smoothed by recursive Gaussians of sigma[d] along the other axes is
+ * computed, as with the composite recursive Gaussian filters, without
+ * full-size intermediates for each axis.
+ *
+ * The passes along the slowest axis, for the derivative and for the
+ * smoothing, are computed over the whole image in turn. The passes
+ * along the other axes are then computed by slabs of slices of about
+ * 64K pixels, which remain in the cache, split between the threads of
+ * multiThreader, with a single work unit for each slab.
+ *
+ * accumulate( d, values, slab ) is called with the contiguous float
+ * values of the derivative of each axis d for each slab region: first
+ * for the slowest axis and all the slabs, then for the other axes in
+ * increasing order for each slab, so that the axis ImageDimension-2 is
+ * the last one of a slab, and the calls for different slabs may be
+ * concurrent.
+ *
+ * When inputIsOverwritten is true, both passes along the slowest axis
+ * are computed before the first call to accumulate, which may then
+ * write to the buffer of the input.
+ */
+template < typename TInputImage, typename TAccumulate >
+void
+TiledRecursiveGaussianDerivatives( const TInputImage *input,
+                                   const FixedArray< double, TInputImage::ImageDimension > &sigma,
+                                   unsigned int order,
+                                   bool normalizeAcrossScale,
+                                   bool inputIsOverwritten,
+                                   MultiThreaderBase *multiThreader,
+                                   TAccumulate &&accumulate )
+{
+  constexpr unsigned int ImageDimension = TInputImage::ImageDimension;
+  constexpr unsigned int SlabDimension = ImageDimension - 1;
+  constexpr SizeValueType SlabPixels = 1 << 16;
+
+  using RealImageType = Image< float, ImageDimension >;
+  using RegionType = typename TInputImage::RegionType;
+
+  const RegionType region = input->GetBufferedRegion();
+  const SizeValueType length = region.GetSize( SlabDimension );
+  const SizeValueType sliceSize = region.GetNumberOfPixels() / length;
+  const SizeValueType thickness = std::max< SizeValueType >( 1, SlabPixels / sliceSize );
+  const SizeValueType numberOfSlabs = ( length + thickness - 1 ) / thickness;
+
+  auto slabRegion = [&]( SizeValueType slab )
+    {
+      RegionType r = region;
+      r.SetIndex( SlabDimension, region.GetIndex( SlabDimension ) + static_cast< IndexValueType >( slab * thickness ) );
+      r.SetSize( SlabDimension, std::min( thickness, length - slab * thickness ) );
+      return r;
+    };
+
+  auto setOrder = []( auto *filter, unsigned int filterOrder )
+    {
+      switch ( filterOrder )
+        {
+        case 0:
+          filter->SetZeroOrder();
+          break;
+        case 1:
+          filter->SetFirstOrder();
+          break;
+        default:
+          filter->SetSecondOrder();
+          break;
+        }
+    };
+
+  // the input is grafted so that the passes do not update its pipeline
+  typename TInputImage::Pointer localInput = TInputImage::New();
+  localInput->Graft( input );
+
+  auto slowestPass = [&]( unsigned int filterOrder )
+    {
+      using FilterType = RecursiveGaussianImageFilter< TInputImage, RealImageType >;
+      auto filter = FilterType::New();
+      filter->SetInput( localInput );
+      filter->InPlaceOff();
+      filter->SetDirection( SlabDimension );
+      filter->SetSigma( sigma[SlabDimension] );
+      filter->SetNormalizeAcrossScale( normalizeAcrossScale );
+      setOrder( filter.GetPointer(), filterOrder );
+      filter->SetNumberOfWorkUnits( multiThreader->GetNumberOfWorkUnits() );
+      filter->Update();
+      typename RealImageType::Pointer output = filter->GetOutput();
+      output->DisconnectPipeline();
+      return output;
+    };
+
+  typename RealImageType::Pointer derivative = slowestPass( order );
+  typename RealImageType::Pointer smoothed;
+  if ( inputIsOverwritten && ImageDimension > 1 )
+    {
+    smoothed = slowestPass( 0 );
+    }
+
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [&]( SizeValueType slab )
+      {
+        const RegionType r = slabRegion( slab );
+        accumulate( SlabDimension, derivative->GetBufferPointer() + derivative->ComputeOffset( r.GetIndex() ), r );
+      },
+    nullptr );
+  derivative = nullptr;
+
+  if ( ImageDimension == 1 )
+    {
+    return;
+    }
+  if ( !smoothed )
+    {
+    smoothed = slowestPass( 0 );
+    }
+
+  using SlabFilterType = RecursiveGaussianImageFilter< RealImageType, RealImageType >;
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfSlabs,
+    [&]( SizeValueType slab )
+      {
+        const RegionType r = slabRegion( slab );
+
+        // the slab of the smoothed image, sharing its buffer
+        auto container = RealImageType::PixelContainer::New();
+        container->SetImportPointer( smoothed->GetBufferPointer() + smoothed->ComputeOffset( r.GetIndex() ), r.GetNumberOfPixels(), false );
+        auto slabImage = RealImageType::New();
+        slabImage->CopyInformation( smoothed );
+        slabImage->SetRegions( r );
+        slabImage->SetPixelContainer( container );
+
+        for ( unsigned int d = 0; d < SlabDimension; ++d )
+          {
+          std::vector< typename SlabFilterType::Pointer > filters;
+          for ( unsigned int e = 0; e < SlabDimension; ++e )
+            {
+            auto filter = SlabFilterType::New();
+            if ( filters.empty() )
+              {
+              filter->SetInput( slabImage );
+              filter->InPlaceOff();
+              }
+            else
+              {
+              filter->SetInput( filters.back()->GetOutput() );
+              filter->InPlaceOn();
+              }
+            filter->SetDirection( e );
+            filter->SetSigma( sigma[e] );
+            filter->SetNormalizeAcrossScale( normalizeAcrossScale );
+            setOrder( filter.GetPointer(), ( e == d ) ? order : 0 );
+            filter->SetNumberOfWorkUnits( 1 );
+            filters.push_back( filter );
+            }
+          filters.back()->Update();
+          accumulate( d, filters.back()->GetOutput()->GetBufferPointer(), r );
+          }
+      },
+    nullptr );
+}
+
+} // end namespace itk
+
+#endif // itkTiledRecursiveGaussianDerivatives_h
@@ -0,0 +1,137 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkVectorizedSLICImageFilter_h
+#define itkVectorizedSLICImageFilter_h
+
+#include "itkSLICImageFilter.h"
+
+#include <vector>
+
+
+namespace itk {
+
+/** \class VectorizedSLICImageFilter
+ * \brief SLIC superpixels with the cluster centers in a structure of
+ * arrays, and an optional stop on the shift of the centers.
+ *
+ * With VectorizedClustering off and no CenterShiftThreshold, the
+ * default, the filter is the SLICImageFilter. With VectorizedClustering
+ * on, the coordinates and the components of the cluster centers are
+ * stored in one array each, so that the distances of a line of the
+ * window of a cluster are computed by loops over contiguous values
+ * which the compiler vectorizes. The assignment is divided in slabs
+ * between the threads of the multithreader, each slab taking the
+ * windows of the clusters which cross it, and the centers are updated
+ * from accumulators of the slabs which are added in the order of the
+ * slabs, so the labels do not depend on the number of threads.
+ *
+ * The distance of a pixel to a cluster is the sum of the squared
+ * differences of their components and of their indices scaled by
+ * SpatialProximityWeight over SuperGridSize, as with the superclass.
+ * The centers start at the middle of the cells of the super grid,
+ * moved to the smallest gradient of their neighborhood of radius one with
+ * InitializationPerturbation, and a cluster without pixels keeps its
+ * center. With EnforceConnectivity, the connected components smaller
+ * than a quarter of a cell take the label of the previous neighbor
+ * in raster order, and the other components after the first of a
+ * label take new labels.
+ *
+ * The AverageResidual is the average over the clusters of the distance
+ * between the centers before and after an iteration. A positive
+ * CenterShiftThreshold stops the iterations, before
+ * MaximumNumberOfIterations, once the AverageResidual is at most the
+ * threshold, and implies the vectorized clustering.
+ *
+ * \sa SLICImageFilter
+ */
+template < class TInputImage, class TOutputImage >
+class VectorizedSLICImageFilter:
+    public SLICImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = VectorizedSLICImageFilter;
+  using Superclass = SLICImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(VectorizedSLICImageFilter, SLICImageFilter);
+
+  /** Cluster with the centers in a structure of arrays. Off by
+   * default. */
+  itkSetMacro( VectorizedClustering, bool );
+  itkGetConstMacro( VectorizedClustering, bool );
+  itkBooleanMacro( VectorizedClustering );
+
+  /** The AverageResidual at which the iterations stop. 0 by default,
+   * for MaximumNumberOfIterations iterations. */
+  itkSetMacro( CenterShiftThreshold, double );
+  itkGetConstMacro( CenterShiftThreshold, double );
+
+  /** The measurements of the last execution. */
+  double GetAverageResidual() const;
+  unsigned int GetNumberOfElapsedIterations() const
+  { return m_NumberOfElapsedIterations; }
+
+protected:
+
+  VectorizedSLICImageFilter() = default;
+
+  ~VectorizedSLICImageFilter() override = default;
+
+  // See superclass for doxygen documentation
+  //
+  // The clusters are computed in slabs by the threads of the
+  // multithreader.
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  VectorizedSLICImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  /** Relabel the connected components of the output. */
+  void EnforceLabelConnectivity( SizeValueType numberOfClusters, SizeValueType minimumSize );
+
+  bool m_VectorizedClustering{false};
+  double m_CenterShiftThreshold{0.0};
+
+  bool m_Vectorized{false};
+  double m_VectorizedAverageResidual{0.0};
+  unsigned int m_NumberOfElapsedIterations{0};
+};
+
+
+} // end namespace itk
+
+
+#include "itkVectorizedSLICImageFilter.hxx"
+
+#endif // itkVectorizedSLICImageFilter_h
@@ -0,0 +1,484 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkVectorizedSLICImageFilter_hxx
+#define itkVectorizedSLICImageFilter_hxx
+
+#include "itkVectorizedSLICImageFilter.h"
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+VectorizedSLICImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  m_Vectorized = m_VectorizedClustering || m_CenterShiftThreshold > 0.0;
+  if ( !m_Vectorized )
+    {
+    Superclass::GenerateData();
+    m_NumberOfElapsedIterations = this->GetMaximumNumberOfIterations();
+    return;
+    }
+
+  using ComponentType = typename NumericTraits<typename InputImageType::InternalPixelType>::ValueType;
+  using IndexType = typename RegionType::IndexType;
+
+  const InputImageType *input = this->GetInput();
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+  OutputPixelType *labels = output->GetBufferPointer();
+
+  const RegionType region = output->GetBufferedRegion();
+  if ( input->GetBufferedRegion() != region )
+    {
+    itkExceptionMacro( "The input region " << input->GetBufferedRegion()
+                       << " does not match the output region " << region << "!" );
+    }
+
+  const unsigned int numberOfComponents = input->GetNumberOfComponentsPerPixel();
+  const ComponentType *values = reinterpret_cast<const ComponentType *>( input->GetBufferPointer() );
+
+  // the grid of the clusters, and the scales of the index differences
+  SizeValueType gridSize[ImageDimension];
+  IndexValueType cellSize[ImageDimension];
+  double scales[ImageDimension];
+  SizeValueType numberOfClusters = 1;
+  SizeValueType cellVolume = 1;
+  bool perturbation = this->GetInitializationPerturbation();
+  for ( unsigned int d = 0; d < ImageDimension; ++d )
+    {
+    cellSize[d] = std::max<IndexValueType>( this->GetSuperGridSize()[d], 1 );
+    gridSize[d] = ( region.GetSize( d ) + cellSize[d] - 1 ) / cellSize[d];
+    scales[d] = this->GetSpatialProximityWeight() / static_cast<double>( cellSize[d] );
+    numberOfClusters *= gridSize[d];
+    cellVolume *= cellSize[d];
+    perturbation = perturbation && cellSize[d] >= 3;
+    }
+
+  // the centers, the coordinates and then the components of all the
+  // clusters in one array each
+  const unsigned int numberOfValues = ImageDimension + numberOfComponents;
+  std::vector<double> centers( numberOfValues * numberOfClusters );
+  auto centerValues = [&centers, numberOfClusters]( unsigned int v ) { return centers.data() + v * numberOfClusters; };
+
+  const IndexType first = region.GetIndex();
+  const IndexType last = region.GetUpperIndex();
+
+  // the squared gradient at an index, of the central differences
+  // clamped to the region
+  auto gradient = [&]( const IndexType &index )
+    {
+      double sum = 0.0;
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        IndexType before = index;
+        IndexType after = index;
+        before[d] = std::max( index[d] - 1, first[d] );
+        after[d] = std::min( index[d] + 1, last[d] );
+        const ComponentType *beforeValues = values + input->ComputeOffset( before ) * numberOfComponents;
+        const ComponentType *afterValues = values + input->ComputeOffset( after ) * numberOfComponents;
+        for ( unsigned int c = 0; c < numberOfComponents; ++c )
+          {
+          const double difference = static_cast<double>( afterValues[c] ) - static_cast<double>( beforeValues[c] );
+          sum += difference * difference;
+          }
+        }
+      return sum;
+    };
+
+  this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+
+  // the centers start in the middle of their cell, or at the smallest
+  // gradient of its neighborhood
+  this->GetMultiThreader()->ParallelizeArray(
+    0,
+    numberOfClusters,
+    [&]( SizeValueType k )
+      {
+        IndexType index;
+        SizeValueType cell = k;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          const IndexValueType lower = static_cast<IndexValueType>( cell % gridSize[d] ) * cellSize[d];
+          const IndexValueType upper = std::min( lower + cellSize[d], static_cast<IndexValueType>( region.GetSize( d ) ) );
+          index[d] = first[d] + lower + ( upper - 1 - lower ) / 2;
+          cell /= gridSize[d];
+          }
+
+        if ( perturbation )
+          {
+          const IndexType middle = index;
+          double smallest = gradient( middle );
+          unsigned int neighborhoodSize = 1;
+          for ( unsigned int d = 0; d < ImageDimension; ++d )
+            {
+            neighborhoodSize *= 3;
+            }
+          for ( unsigned int n = 0; n < neighborhoodSize; ++n )
+            {
+            IndexType neighbor = middle;
+            unsigned int position = n;
+            for ( unsigned int d = 0; d < ImageDimension; ++d )
+              {
+              neighbor[d] = std::min( std::max( middle[d] + static_cast<IndexValueType>( position % 3 ) - 1, first[d] ), last[d] );
+              position /= 3;
+              }
+            const double value = gradient( neighbor );
+            if ( value < smallest )
+              {
+              smallest = value;
+              index = neighbor;
+              }
+            }
+          }
+
+        const ComponentType *pixel = values + input->ComputeOffset( index ) * numberOfComponents;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          centerValues( d )[k] = static_cast<double>( index[d] );
+          }
+        for ( unsigned int c = 0; c < numberOfComponents; ++c )
+          {
+          centerValues( ImageDimension + c )[k] = static_cast<double>( pixel[c] );
+          }
+      },
+    nullptr );
+
+  // the slabs of the image, each with its own accumulators
+  auto splitter = ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits( region, std::max( this->GetNumberOfWorkUnits(), 1u ) );
+  auto getPiece = [&]( SizeValueType piece )
+    {
+      RegionType pieceRegion = region;
+      splitter->GetSplit( static_cast<unsigned int>( piece ), numberOfPieces, pieceRegion );
+      return pieceRegion;
+    };
+
+  struct Accumulators
+  {
+    std::vector<double>        sums;
+    std::vector<SizeValueType> counts;
+  };
+  std::vector<Accumulators> pieceAccumulators( numberOfPieces );
+
+  std::vector<float> distances( region.GetNumberOfPixels() );
+  std::fill( labels, labels + region.GetNumberOfPixels(), OutputPixelType{} );
+
+  const unsigned int maximumNumberOfIterations = this->GetMaximumNumberOfIterations();
+  m_VectorizedAverageResidual = 0.0;
+  m_NumberOfElapsedIterations = 0;
+  while ( m_NumberOfElapsedIterations < maximumNumberOfIterations )
+    {
+    // each slab assigns its pixels to the nearest of the clusters whose
+    // window crosses it, then sums the pixels of the clusters
+    this->GetMultiThreader()->ParallelizeArray(
+      0,
+      numberOfPieces,
+      [&]( SizeValueType piece )
+        {
+          const RegionType pieceRegion = getPiece( piece );
+          const IndexType pieceFirst = pieceRegion.GetIndex();
+          const IndexType pieceLast = pieceRegion.GetUpperIndex();
+          const SizeValueType lineLength = pieceRegion.GetSize( 0 );
+
+          ImageScanlineIterator<OutputImageType> lineIt( output, pieceRegion );
+          while ( !lineIt.IsAtEnd() )
+            {
+            float *lineDistances = distances.data() + output->ComputeOffset( lineIt.GetIndex() );
+            std::fill( lineDistances, lineDistances + lineLength, std::numeric_limits<float>::infinity() );
+            lineIt.NextLine();
+            }
+
+          std::vector<double> windowDistances( 2 * cellSize[0] + 1 );
+          for ( SizeValueType k = 0; k < numberOfClusters; ++k )
+            {
+            IndexType windowFirst;
+            IndexType windowLast;
+            bool empty = false;
+            for ( unsigned int d = 0; d < ImageDimension; ++d )
+              {
+              const double coordinate = centerValues( d )[k];
+              windowFirst[d] = std::max( static_cast<IndexValueType>( std::ceil( coordinate - cellSize[d] ) ), pieceFirst[d] );
+              windowLast[d] = std::min( static_cast<IndexValueType>( std::floor( coordinate + cellSize[d] ) ), pieceLast[d] );
+              empty = empty || windowFirst[d] > windowLast[d];
+              }
+            if ( empty )
+              {
+              continue;
+              }
+
+            RegionType lines;
+            lines.SetIndex( windowFirst );
+            lines.SetUpperIndex( windowLast );
+            const SizeValueType windowLength = lines.GetSize( 0 );
+            lines.SetSize( 0, 1 );
+
+            ImageRegionConstIteratorWithIndex<OutputImageType> it( output, lines );
+            for ( ; !it.IsAtEnd(); ++it )
+              {
+              const IndexType index = it.GetIndex();
+              double spatial = 0.0;
+              for ( unsigned int d = 1; d < ImageDimension; ++d )
+                {
+                const double difference = ( static_cast<double>( index[d] ) - centerValues( d )[k] ) * scales[d];
+                spatial += difference * difference;
+                }
+
+              // the distances of the line, component after component
+              const double x0 = static_cast<double>( index[0] ) - centerValues( 0 )[k];
+              for ( SizeValueType x = 0; x < windowLength; ++x )
+                {
+                const double difference = ( x0 + static_cast<double>( x ) ) * scales[0];
+                windowDistances[x] = spatial + difference * difference;
+                }
+              const OffsetValueType offset = output->ComputeOffset( index );
+              const ComponentType *line = values + offset * numberOfComponents;
+              for ( unsigned int c = 0; c < numberOfComponents; ++c )
+                {
+                const double center = centerValues( ImageDimension + c )[k];
+                const ComponentType *component = line + c;
+                for ( SizeValueType x = 0; x < windowLength; ++x )
+                  {
+                  const double difference = static_cast<double>( component[x * numberOfComponents] ) - center;
+                  windowDistances[x] += difference * difference;
+                  }
+                }
+
+              float *lineDistances = distances.data() + offset;
+              OutputPixelType *lineLabels = labels + offset;
+              for ( SizeValueType x = 0; x < windowLength; ++x )
+                {
+                const float distance = static_cast<float>( windowDistances[x] );
+                if ( distance < lineDistances[x] )
+                  {
+                  lineDistances[x] = distance;
+                  lineLabels[x] = static_cast<OutputPixelType>( k );
+                  }
+                }
+              }
+            }
+
+          // the sums of the coordinates and components of the clusters
+          Accumulators &accumulators = pieceAccumulators[piece];
+          accumulators.sums.assign( numberOfValues * numberOfClusters, 0.0 );
+          accumulators.counts.assign( numberOfClusters, 0 );
+          double *sums = accumulators.sums.data();
+
+          lineIt.GoToBegin();
+          while ( !lineIt.IsAtEnd() )
+            {
+            IndexType index = lineIt.GetIndex();
+            const OffsetValueType offset = output->ComputeOffset( index );
+            const OutputPixelType *lineLabels = labels + offset;
+            const ComponentType *line = values + offset * numberOfComponents;
+            for ( SizeValueType x = 0; x < lineLength; ++x )
+              {
+              const SizeValueType k = lineLabels[x];
+              ++accumulators.counts[k];
+              sums[k] += static_cast<double>( index[0] + static_cast<IndexValueType>( x ) );
+              for ( unsigned int d = 1; d < ImageDimension; ++d )
+                {
+                sums[d * numberOfClusters + k] += static_cast<double>( index[d] );
+                }
+              for ( unsigned int c = 0; c < numberOfComponents; ++c )
+                {
+                sums[( ImageDimension + c ) * numberOfClusters + k] += static_cast<double>( line[x * numberOfComponents + c] );
+                }
+              }
+            lineIt.NextLine();
+            }
+        },
+      this );
+
+    // the new centers, from the sums of the slabs in their order
+    std::vector<double> sums( numberOfValues * numberOfClusters, 0.0 );
+    std::vector<SizeValueType> counts( numberOfClusters, 0 );
+    for ( const Accumulators &accumulators : pieceAccumulators )
+      {
+      for ( SizeValueType i = 0; i < sums.size(); ++i )
+        {
+        sums[i] += accumulators.sums[i];
+        }
+      for ( SizeValueType k = 0; k < numberOfClusters; ++k )
+        {
+        counts[k] += accumulators.counts[k];
+        }
+      }
+
+    double residual = 0.0;
+    for ( SizeValueType k = 0; k < numberOfClusters; ++k )
+      {
+      if ( counts[k] == 0 )
+        {
+        continue;
+        }
+      double shift = 0.0;
+      for ( unsigned int v = 0; v < numberOfValues; ++v )
+        {
+        const double value = sums[v * numberOfClusters + k] / static_cast<double>( counts[k] );
+        const double scale = ( v < ImageDimension ) ? scales[v] : 1.0;
+        const double difference = ( value - centerValues( v )[k] ) * scale;
+        shift += difference * difference;
+        centerValues( v )[k] = value;
+        }
+      residual += std::sqrt( shift );
+      }
+    m_VectorizedAverageResidual = residual / static_cast<double>( numberOfClusters );
+    ++m_NumberOfElapsedIterations;
+
+    if ( m_CenterShiftThreshold > 0.0 && m_VectorizedAverageResidual <= m_CenterShiftThreshold )
+      {
+      break;
+      }
+    }
+
+  if ( this->GetEnforceConnectivity() )
+    {
+    this->EnforceLabelConnectivity( numberOfClusters, std::max<SizeValueType>( cellVolume / 4, 1 ) );
+    }
+}
+
+
+//
+// EnforceLabelConnectivity
+//
+template < class TInputImage, class TOutputImage >
+void
+VectorizedSLICImageFilter< TInputImage, TOutputImage >::EnforceLabelConnectivity( SizeValueType numberOfClusters,
+                                                                                  SizeValueType minimumSize )
+{
+  using IndexType = typename RegionType::IndexType;
+
+  OutputImageType *output = this->GetOutput();
+  OutputPixelType *labels = output->GetBufferPointer();
+  const RegionType region = output->GetBufferedRegion();
+  const IndexType first = region.GetIndex();
+  const IndexType last = region.GetUpperIndex();
+  const OffsetValueType *strides = output->GetOffsetTable();
+  const SizeValueType numberOfPixels = region.GetNumberOfPixels();
+
+  std::vector<OutputPixelType> relabeled( numberOfPixels );
+  std::vector<bool> visited( numberOfPixels, false );
+  std::vector<bool> used( numberOfClusters, false );
+  OutputPixelType nextLabel = static_cast<OutputPixelType>( numberOfClusters );
+
+  // the face connected components in raster order
+  std::vector<OffsetValueType> component;
+  for ( SizeValueType start = 0; start < numberOfPixels; ++start )
+    {
+    if ( visited[start] )
+      {
+      continue;
+      }
+    const OutputPixelType label = labels[start];
+    component.assign( 1, static_cast<OffsetValueType>( start ) );
+    visited[start] = true;
+    for ( size_t i = 0; i < component.size(); ++i )
+      {
+      const OffsetValueType offset = component[i];
+      const IndexType index = output->ComputeIndex( offset );
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        if ( index[d] > first[d] && !visited[offset - strides[d]] && labels[offset - strides[d]] == label )
+          {
+          visited[offset - strides[d]] = true;
+          component.push_back( offset - strides[d] );
+          }
+        if ( index[d] < last[d] && !visited[offset + strides[d]] && labels[offset + strides[d]] == label )
+          {
+          visited[offset + strides[d]] = true;
+          component.push_back( offset + strides[d] );
+          }
+        }
+      }
+
+    // a small component takes the label of the neighbor before its
+    // first pixel, which is already relabeled
+    OffsetValueType previous = -1;
+    const IndexType index = output->ComputeIndex( static_cast<OffsetValueType>( start ) );
+    for ( unsigned int d = 0; d < ImageDimension && previous < 0; ++d )
+      {
+      if ( index[d] > first[d] )
+        {
+        previous = static_cast<OffsetValueType>( start ) - strides[d];
+        }
+      }
+
+    OutputPixelType newLabel;
+    if ( component.size() < minimumSize && previous >= 0 )
+      {
+      newLabel = relabeled[previous];
+      }
+    else if ( !used[label] )
+      {
+      used[label] = true;
+      newLabel = label;
+      }
+    else
+      {
+      newLabel = nextLabel++;
+      }
+    for ( OffsetValueType offset : component )
+      {
+      relabeled[offset] = newLabel;
+      }
+    }
+
+  std::copy( relabeled.begin(), relabeled.end(), labels );
+}
+
+
+//
+// GetAverageResidual
+//
+template < class TInputImage, class TOutputImage >
+double
+VectorizedSLICImageFilter< TInputImage, TOutputImage >::GetAverageResidual() const
+{
+  return m_Vectorized ? m_VectorizedAverageResidual : Superclass::GetAverageResidual();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+VectorizedSLICImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "VectorizedClustering: " << m_VectorizedClustering << std::endl;
+  os << indent << "CenterShiftThreshold: " << m_CenterShiftThreshold << std::endl;
+  os << indent << "NumberOfElapsedIterations: " << m_NumberOfElapsedIterations << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkVectorizedSLICImageFilter_hxx
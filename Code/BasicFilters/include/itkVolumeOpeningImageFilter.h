@@ -0,0 +1,127 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkVolumeOpeningImageFilter_h
+#define itkVolumeOpeningImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+
+namespace itk {
+
+/** \class VolumeOpeningImageFilter
+ * \brief Morphological attribute opening by the volume of the peaks,
+ * on the component tree of the image.
+ *
+ * The volume of a component of an upper level set of the image is
+ * the sum, over its pixels, of their heights above the level of the
+ * component it is merged into, times the area of a pixel with
+ * UseImageSpacing. It is the volume of the peak which is removed by
+ * lowering the component to that level. The volume of the components
+ * decreases from the roots to the leaves of the component tree, and
+ * the opening keeps the components of a volume of at least Lambda:
+ * the pixels of the other ones are lowered to the level of the
+ * highest component which is kept. Unlike an area opening, a wide
+ * and flat peak can be removed while a narrow and high one is kept.
+ *
+ * The ComponentTree of the image is built with the threads of the
+ * filter, in slabs merged by pairs, and the volumes are accumulated
+ * from the leaves to the roots in one pass, with a double per pixel.
+ * The pixels which are not comparable, as NaN, are unchanged.
+ *
+ * Reference: C. Vachier and F. Meyer, "Extinction value: a new
+ * measurement of persistence", IEEE Workshop on Nonlinear Signal and
+ * Image Processing, 1995.
+ *
+ * \sa AreaOpeningImageFilter, ComponentTree
+ */
+template < class TInputImage, class TOutputImage = TInputImage >
+class VolumeOpeningImageFilter:
+    public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard Self type alias */
+  using Self = VolumeOpeningImageFilter;
+  using Superclass = ImageToImageFilter< TInputImage, TOutputImage >;
+  using Pointer = SmartPointer< Self >;
+  using ConstPointer = SmartPointer< const Self >;
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using InputPixelType = typename TInputImage::PixelType;
+  using OutputPixelType = typename TOutputImage::PixelType;
+  using RegionType = typename TOutputImage::RegionType;
+
+  static constexpr unsigned int ImageDimension = TOutputImage::ImageDimension;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(VolumeOpeningImageFilter, ImageToImageFilter);
+
+  /** The smallest volume of the peaks which are kept. 0 by default. */
+  itkSetMacro( Lambda, double );
+  itkGetConstMacro( Lambda, double );
+
+  /** Whether the volumes are in physical units. On by default. */
+  itkSetMacro( UseImageSpacing, bool );
+  itkGetConstMacro( UseImageSpacing, bool );
+  itkBooleanMacro( UseImageSpacing );
+
+  /** Whether the components are connected by the faces only, the
+   * default, or by the edges and the vertices too. */
+  itkSetMacro( FullyConnected, bool );
+  itkGetConstMacro( FullyConnected, bool );
+  itkBooleanMacro( FullyConnected );
+
+protected:
+
+  VolumeOpeningImageFilter() = default;
+
+  ~VolumeOpeningImageFilter() override = default;
+
+  void GenerateData() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter needs all of its input
+  void GenerateInputRequestedRegion() override;
+
+  // See superclass for doxygen documentation
+  //
+  // Override since the filter produces all of its output
+  void EnlargeOutputRequestedRegion(DataObject *data) override;
+
+  void PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  VolumeOpeningImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  double m_Lambda{0.0};
+  bool   m_UseImageSpacing{true};
+  bool   m_FullyConnected{false};
+};
+
+
+} // end namespace itk
+
+
+#include "itkVolumeOpeningImageFilter.hxx"
+
+#endif // itkVolumeOpeningImageFilter_h
@@ -0,0 +1,137 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef itkVolumeOpeningImageFilter_hxx
+#define itkVolumeOpeningImageFilter_hxx
+
+#include "itkVolumeOpeningImageFilter.h"
+
+#include "itkComponentTree.h"
+
+#include <vector>
+
+namespace itk {
+
+//
+// GenerateData
+//
+template < class TInputImage, class TOutputImage >
+void
+VolumeOpeningImageFilter< TInputImage, TOutputImage >::GenerateData()
+{
+  using TreeType = ComponentTree< InputPixelType, ImageDimension >;
+  using PixelIndexType = typename TreeType::PixelIndexType;
+
+  const InputImageType *input = this->GetInput();
+  const typename InputImageType::SizeType size = input->GetBufferedRegion().GetSize();
+  if ( !TreeType::CanIndex( size ) )
+    {
+    itkExceptionMacro( "The image of size " << size << " has too many pixels for the component tree." );
+    }
+
+  this->AllocateOutputs();
+  OutputImageType *output = this->GetOutput();
+
+  double pixelArea = 1.0;
+  if ( m_UseImageSpacing )
+    {
+    for ( unsigned int d = 0; d < ImageDimension; ++d )
+      {
+      pixelArea *= input->GetSpacing()[d];
+      }
+    }
+
+  const InputPixelType *values = input->GetBufferPointer();
+  TreeType tree;
+  tree.Build( values, size, m_FullyConnected, TreeType::GetBoundaryOfAllValues(),
+              this->GetMultiThreader(), this->GetNumberOfWorkUnits() );
+
+  // the sums of the values of the components, from the leaves to the
+  // roots
+  const SizeValueType numberOfPixels = input->GetBufferedRegion().GetNumberOfPixels();
+  std::vector< double > sums( numberOfPixels, 0.0 );
+  tree.ForEachFromLeaves(
+    [&]( PixelIndexType p )
+      {
+        sums[p] += static_cast<double>( values[p] );
+        const PixelIndexType parent = tree.GetParent( p );
+        if ( parent != p )
+          {
+          sums[parent] += sums[p];
+          }
+      } );
+
+  // the components of a volume of at least Lambda above the level of
+  // their parent are kept
+  const double lambda = m_Lambda;
+  tree.FilterNodes(
+    [&]( PixelIndexType node )
+      {
+        const double height = static_cast<double>( tree.GetArea( node ) ) * static_cast<double>( values[tree.GetParent( node )] );
+        return ( sums[node] - height ) * pixelArea >= lambda;
+      },
+    output->GetBufferPointer() );
+}
+
+
+//
+// GenerateInputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+VolumeOpeningImageFilter< TInputImage, TOutputImage >::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType *input = const_cast< InputImageType * >( this->GetInput() );
+  if ( input )
+    {
+    input->SetRequestedRegion( input->GetLargestPossibleRegion() );
+    }
+}
+
+
+//
+// EnlargeOutputRequestedRegion
+//
+template < class TInputImage, class TOutputImage >
+void
+VolumeOpeningImageFilter< TInputImage, TOutputImage >::EnlargeOutputRequestedRegion(DataObject *data)
+{
+  Superclass::EnlargeOutputRequestedRegion(data);
+  data->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+//
+// PrintSelf
+//
+template < class TInputImage, class TOutputImage >
+void
+VolumeOpeningImageFilter< TInputImage, TOutputImage >::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Lambda: " << m_Lambda << std::endl;
+  os << indent << "UseImageSpacing: " << m_UseImageSpacing << std::endl;
+  os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif // itkVolumeOpeningImageFilter_hxx
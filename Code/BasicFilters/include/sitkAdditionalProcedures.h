@@ -24,6 +24,7 @@
 #include "sitkTransform.h"
 #include "sitkInterpolator.h"
 #include "sitkPatchBasedDenoisingImageFilter.h"
+#include "sitkDiscreteGaussianImageFilter.h"
 
 namespace itk {
 namespace simple {
@@ -108,6 +109,10 @@ SITKBasicFilters_EXPORT Image PatchBasedDenoising (const Image& image1,
      * separable convolution of an image and a discrete Gaussian
      * operator (kernel).
      *
+     * With the Automatic algorithm, the fastest of the FIR, IIR,
+     * BoxCascade and FFT algorithms whose error is within maximumError
+     * is selected for the variance and the size of the image.
+     *
      * This function directly calls the execute method of DiscreteGaussianImageFilter
      * in order to support a procedural API
      *
@@ -117,7 +122,8 @@ SITKBasicFilters_EXPORT Image PatchBasedDenoising (const Image& image1,
                                                       double variance,
                                                       unsigned int maximumKernelWidth = 32u,
                                                       double maximumError =  0.01,
-                                                      bool useImageSpacing = true );
+                                                      bool useImageSpacing = true,
+                                                      DiscreteGaussianImageFilter::AlgorithmType algorithm = DiscreteGaussianImageFilter::FIR );
 
 
     /**
@@ -36,6 +36,20 @@ namespace simple
  * Several different ITK classes are implemented under the hood, to
  * convert between different image types.
  *
+ * When the input already has the output pixel type, no ITK filter is
+ * executed and the output shares the input's buffer, with the
+ * Image's copy-on-write semantics.
+ *
+ * The conversions between the integer and floating point scalar and
+ * vector pixel types, and from a scalar to a vector pixel type, are
+ * computed directly on the buffers by multiple threads, with loops
+ * which the compiler vectorizes. As with the ITK filters, these
+ * conversions and the shared buffer outputs invoke the events of the
+ * commands, are measured and may be cancelled, and the output has the
+ * meta-data of the input when the global meta-data propagation is
+ * enabled.
+ * The other conversions use the ITK filters.
+ *
  * \sa itk::simple::Cast for the procedural interface
  */
 class SITKBasicFilters_EXPORT CastImageFilter
@@ -48,6 +62,25 @@ public:
   SITK_RETURN_SELF_TYPE_HEADER SetOutputPixelType( PixelIDValueEnum pixelID );
   PixelIDValueEnum GetOutputPixelType( ) const;
 
+  /** Set/Get whether the conversions to an integer pixel type
+   * saturate.
+   *
+   * When enabled, the values out of the range of the output
+   * component type are clamped to its lowest or maximum value, and the
+   * floating point NaN values are converted to 0. Otherwise the
+   * values are converted with a C++ static_cast, as the ITK
+   * CastImageFilter, which wraps the integers and is undefined for
+   * the floating point values out of range.
+   *
+   * By default this is off.
+   * @{
+   */
+  SITK_RETURN_SELF_TYPE_HEADER SetSaturate( bool saturate );
+  bool GetSaturate() const;
+  void SaturateOn() { this->SetSaturate(true); }
+  void SaturateOff() { this->SetSaturate(false); }
+  /** @} */
+
   ~CastImageFilter() override;
 
   /**
@@ -69,6 +102,16 @@ private:
 
   PixelIDValueEnum m_OutputPixelType;
 
+  bool m_Saturate{false};
+
+  /** Return an image sharing the buffer of the input, through the
+   * execution hooks of a conversion. */
+  Image ExecuteShare( const Image & inImage );
+
+  /** Convert the components of the numeric scalar and vector pixel
+   * types in the buffers, or return false if not supported. */
+  bool ExecuteConvert( const Image & inImage, Image & outImage );
+
   /** Methods to actually implement conversion from one image type
    * to another.
    *
@@ -24,6 +24,7 @@
  * Please look at sitkImageFilterTemplate.h.in to make changes.
  */
 
+#include <algorithm>
 #include <memory>
 
 #include "sitkBasicFilters.h"
@@ -85,6 +86,20 @@ assumption will probably not hold in multi-modality registration.
       /**
        */
         OperationModeType GetOperationMode() const { return this->m_OperationMode; }
+
+      /** The step between the pixels included in the moments along
+       * each dimension, 1 by default for all the pixels. A larger
+       * factor approximates the moments from fewer pixels.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMomentsSamplingFactor ( unsigned int MomentsSamplingFactor ) { this->m_MomentsSamplingFactor = std::max( MomentsSamplingFactor, 1u ); return *this; }
+      unsigned int GetMomentsSamplingFactor() const { return this->m_MomentsSamplingFactor; }
+
+      /** The pixels below the threshold are not included in the
+       * moments, as a thresholded mask of the objects. All the pixels
+       * are included by default.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMomentsLowerThreshold ( double MomentsLowerThreshold ) { this->m_MomentsLowerThreshold = MomentsLowerThreshold; return *this; }
+      double GetMomentsLowerThreshold() const { return this->m_MomentsLowerThreshold; }
       /** Name of this class */
       std::string GetName() const override { return std::string ("CenteredTransformInitializerFilter"); }
 
@@ -116,6 +131,8 @@ assumption will probably not hold in multi-modality registration.
 
 
       OperationModeType  m_OperationMode;
+      unsigned int  m_MomentsSamplingFactor;
+      double  m_MomentsLowerThreshold;
     };
 
     /**
@@ -24,6 +24,7 @@
  * Please look at sitkImageFilterTemplate.h.in to make changes.
  */
 
+#include <algorithm>
 #include <memory>
 
 #include "sitkBasicFilters.h"
@@ -74,6 +75,20 @@ Versor representing rotation.
        * Enable the use of the principal axes of each image to compute an initial rotation that will align them.
        */
         bool GetComputeRotation() const { return this->m_ComputeRotation; }
+
+      /** The step between the pixels included in the moments along
+       * each dimension, 1 by default for all the pixels. A larger
+       * factor approximates the moments from fewer pixels.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMomentsSamplingFactor ( unsigned int MomentsSamplingFactor ) { this->m_MomentsSamplingFactor = std::max( MomentsSamplingFactor, 1u ); return *this; }
+      unsigned int GetMomentsSamplingFactor() const { return this->m_MomentsSamplingFactor; }
+
+      /** The pixels below the threshold are not included in the
+       * moments, as a thresholded mask of the objects. All the pixels
+       * are included by default.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMomentsLowerThreshold ( double MomentsLowerThreshold ) { this->m_MomentsLowerThreshold = MomentsLowerThreshold; return *this; }
+      double GetMomentsLowerThreshold() const { return this->m_MomentsLowerThreshold; }
       /** Name of this class */
       std::string GetName() const override { return std::string ("CenteredVersorTransformInitializerFilter"); }
 
@@ -99,6 +114,8 @@ Versor representing rotation.
 
 
       bool  m_ComputeRotation;
+      unsigned int  m_MomentsSamplingFactor;
+      double  m_MomentsLowerThreshold;
     };
 
 
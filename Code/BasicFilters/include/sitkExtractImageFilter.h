@@ -141,6 +141,9 @@ namespace itk {
       /** Name of this class */
       std::string GetName() const { return "ExtractImageFilter"; }
 
+      /** This filter can reuse the buffer of a moved input image */
+      bool CanRunInPlace() const override { return true; }
+
       /** Print ourselves out */
       std::string ToString() const;
 
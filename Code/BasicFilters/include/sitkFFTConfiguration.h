@@ -0,0 +1,92 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkFFTConfiguration_h
+#define sitkFFTConfiguration_h
+
+#include "sitkBasicFilters.h"
+
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \brief Report if ITK uses FFTW for the FFT based filters.
+ *
+ * When false, the FFT filters use the VNL implementation, and the
+ * other FFT configuration methods have no effect.
+ */
+SITKBasicFilters_EXPORT bool HasFFTW();
+
+/** \brief Set the rigor used by FFTW to plan the transforms.
+ *
+ * The rigor is one of "FFTW_ESTIMATE", "FFTW_MEASURE",
+ * "FFTW_PATIENT" or "FFTW_EXHAUSTIVE". A higher rigor measures more
+ * algorithms to find a faster plan, which is worthwhile when many
+ * transforms of the same size are computed. The plans found are
+ * remembered by FFTW as wisdom, so following executions of the same
+ * size and rigor do not measure again.
+ *
+ * Returns false when the rigor is not recognized or FFTW is not used.
+ * The initial value is from the ITK_FFTW_PLAN_RIGOR environment
+ * variable, or "FFTW_ESTIMATE".
+ * @{
+ */
+SITKBasicFilters_EXPORT bool SetGlobalDefaultFFTPlanRigor( const std::string &rigor );
+SITKBasicFilters_EXPORT std::string GetGlobalDefaultFFTPlanRigor();
+/**@}*/
+
+/** \brief The directory of the files persisting FFTW wisdom between
+ * processes.
+ *
+ * When reading the wisdom cache is enabled, the wisdom files in the
+ * directory are imported when FFTW is first used, and when writing
+ * is enabled, new wisdom is exported when the process exits. The
+ * initial values are from the ITK_FFTW_WISDOM_CACHE_BASE,
+ * ITK_FFTW_READ_WISDOM_CACHE and ITK_FFTW_WRITE_WISDOM_CACHE
+ * environment variables, so the cache may be loaded before any
+ * filter executes.
+ * @{
+ */
+SITKBasicFilters_EXPORT void SetGlobalFFTWisdomCacheDirectory( const std::string &directory );
+SITKBasicFilters_EXPORT std::string GetGlobalFFTWisdomCacheDirectory();
+
+SITKBasicFilters_EXPORT void SetGlobalFFTReadWisdomCache( bool read );
+SITKBasicFilters_EXPORT bool GetGlobalFFTReadWisdomCache();
+
+SITKBasicFilters_EXPORT void SetGlobalFFTWriteWisdomCache( bool write );
+SITKBasicFilters_EXPORT bool GetGlobalFFTWriteWisdomCache();
+/**@}*/
+
+/** \brief Import or export the FFTW wisdom of the cache directory
+ * now.
+ *
+ * Used to load a cache directory set after FFTW was first used, or to
+ * save the wisdom without waiting for the process to exit. Returns
+ * false if a file could not be read or written, or FFTW is not used.
+ * @{
+ */
+SITKBasicFilters_EXPORT bool ImportFFTWisdom();
+SITKBasicFilters_EXPORT bool ExportFFTWisdom();
+/**@}*/
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // sitkFFTConfiguration_h
@@ -0,0 +1,201 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkFusedStatisticsImageFilter_h
+#define sitkFusedStatisticsImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+    /** \class FusedStatisticsImageFilter
+     * \brief Compute the statistics, the histogram and the quantiles of
+     * an image in a single multithreaded pass.
+     *
+     * The minimum, maximum, mean, variance, sigma, sum and number of
+     * the pixels, their histogram and approximate quantiles are
+     * computed together, so the image is read once instead of once by
+     * each of the StatisticsImageFilter, the MinimumMaximumImageFilter
+     * and the histogram based threshold filters. When a mask is given,
+     * only the pixels whose mask is not 0 are included.
+     *
+     * By default the histogram spans the minimum and the maximum of
+     * the pixels, and is approximated from histograms whose range grows
+     * while the threads read the image. With AutoMinimumMaximum off, it
+     * spans HistogramMinimum to HistogramMaximum and the pixels outside
+     * are not binned.
+     *
+     * ComputeThreshold applies the histogram threshold calculators of
+     * the threshold filters, such as OtsuThresholdImageFilter, to the
+     * computed histogram without reading the image again.
+     *
+     * \sa itk::FusedStatisticsImageFilter for the Doxygen on the original ITK class.
+     */
+    class SITKBasicFilters_EXPORT FusedStatisticsImageFilter
+      : public ProcessObject {
+    public:
+      using Self = FusedStatisticsImageFilter;
+
+      // function pointer type
+      typedef void (Self::*MemberFunctionType)( const Image&, const Image* );
+
+      // this filter works with the scalar image types
+      using PixelIDTypeList = BasicPixelIDTypeList;
+
+      ~FusedStatisticsImageFilter() override;
+
+      FusedStatisticsImageFilter();
+
+      /** The number of bins of the histogram, 256 by default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetNumberOfHistogramBins ( uint32_t numberOfHistogramBins );
+      uint32_t GetNumberOfHistogramBins () const;
+
+      /** The number of finer bins per histogram bin, used to merge the
+       * histograms of the threads and to interpolate the quantiles, 16
+       * by default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetHistogramOversampling ( uint32_t histogramOversampling );
+      uint32_t GetHistogramOversampling () const;
+
+      /** Set/Get whether the histogram spans the minimum and the
+       * maximum of the pixels, on by default, or HistogramMinimum to
+       * HistogramMaximum.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetAutoMinimumMaximum ( bool autoMinimumMaximum );
+      bool GetAutoMinimumMaximum () const;
+      SITK_RETURN_SELF_TYPE_HEADER AutoMinimumMaximumOn () { return this->SetAutoMinimumMaximum( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER AutoMinimumMaximumOff () { return this->SetAutoMinimumMaximum( false ); }
+      /** @} */
+
+      SITK_RETURN_SELF_TYPE_HEADER SetHistogramMinimum ( double histogramMinimum );
+      double GetHistogramMinimum () const;
+      SITK_RETURN_SELF_TYPE_HEADER SetHistogramMaximum ( double histogramMaximum );
+      double GetHistogramMaximum () const;
+
+      /** The probabilities, between 0 and 1, of the quantiles to
+       * compute, none by default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetQuantiles ( const std::vector<double> &quantiles );
+      std::vector<double> GetQuantiles () const;
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "FusedStatistics"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      void Execute ( const Image &image );
+
+      /** Compute the statistics of the pixels whose mask is not 0. The
+       * mask must be of pixel type sitkUInt8, and of the size of the
+       * image. */
+      void Execute ( const Image &image, const Image &mask );
+
+      /**
+       * This is a measurement. Its value is updated in the Execute
+       * methods, so the value will only be valid after an execution.
+       * @{
+       */
+      double GetMinimum () const { return this->m_Minimum; }
+      double GetMaximum () const { return this->m_Maximum; }
+      double GetMean () const { return this->m_Mean; }
+      double GetVariance () const { return this->m_Variance; }
+      double GetSigma () const { return this->m_Sigma; }
+      double GetSum () const { return this->m_Sum; }
+      uint64_t GetCount () const { return this->m_Count; }
+      /** @} */
+
+      /** The frequencies of the histogram bins, and the
+       * NumberOfHistogramBins + 1 edges of the bins.
+       *
+       * This is a measurement. Its value is updated in the Execute
+       * methods, so the value will only be valid after an execution.
+       * @{
+       */
+      std::vector<uint64_t> GetHistogramFrequencies () const { return this->m_HistogramFrequencies; }
+      std::vector<double> GetHistogramBinEdges () const { return this->m_HistogramBinEdges; }
+      /** @} */
+
+      /** The values of the Quantiles, NaN when no pixel is binned.
+       *
+       * This is a measurement. Its value is updated in the Execute
+       * methods, so the value will only be valid after an execution.
+       */
+      std::vector<double> GetQuantileValues () const { return this->m_QuantileValues; }
+
+      /** The histogram threshold calculators of the threshold image
+       * filters of the same names. */
+      enum ThresholdMethod {
+        Huang,
+        Intermodes,
+        IsoData,
+        KittlerIllingworth,
+        Li,
+        MaximumEntropy,
+        Moments,
+        Otsu,
+        RenyiEntropy,
+        Shanbhag,
+        Triangle,
+        Yen
+      };
+
+      /** \brief Compute a threshold from the histogram of the last
+       * execution.
+       *
+       * The threshold is the one of the threshold image filter of the
+       * method, computed from the histogram instead of the image, so
+       * it depends on NumberOfHistogramBins, and is approximate when
+       * AutoMinimumMaximum is on.
+       */
+      double ComputeThreshold ( ThresholdMethod method ) const;
+
+    private:
+      uint32_t m_NumberOfHistogramBins;
+      uint32_t m_HistogramOversampling;
+      bool m_AutoMinimumMaximum;
+      double m_HistogramMinimum;
+      double m_HistogramMaximum;
+      std::vector<double> m_Quantiles;
+
+      double m_Minimum;
+      double m_Maximum;
+      double m_Mean;
+      double m_Variance;
+      double m_Sigma;
+      double m_Sum;
+      uint64_t m_Count;
+      std::vector<uint64_t> m_HistogramFrequencies;
+      std::vector<double> m_HistogramBinEdges;
+      std::vector<double> m_QuantileValues;
+
+      template <class TImageType> void ExecuteInternal ( const Image &image, const Image *mask );
+
+      // friend to get access to executeInternal member
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+    };
+  }
+}
+#endif
@@ -29,7 +29,11 @@ namespace itk {
   namespace simple {
 
     /** \class HashImageFilter
-     * \brief Compute the sha1 or md5 hash of an image
+     * \brief Compute the sha1, md5 or xxh64 hash of an image
+     *
+     * The XXH64 hash function is a fast non-cryptographic hash, for
+     * comparing and keying images rather than for integrity against
+     * tampering.
      *
      * \sa itk::simple::Hash for the procedural interface
      */
@@ -48,10 +52,35 @@ namespace itk {
 
       HashImageFilter();
 
-      enum HashFunction { SHA1, MD5 };
+      enum HashFunction { SHA1, MD5, XXH64 };
       SITK_RETURN_SELF_TYPE_HEADER SetHashFunction ( HashFunction hashFunction );
       HashFunction GetHashFunction () const;
 
+      /** \brief Hash the image as a tree of chunks, in parallel.
+       *
+       * When the chunk size is not 0, the bytes of the image are
+       * divided into chunks of chunkSize bytes, which are hashed in
+       * parallel, and the hash is the hash of their concatenated
+       * binary digests. The hash depends on the chunk size, but not on
+       * the number of threads, and it differs from the sequential hash
+       * of the image. By default the chunk size is 0, and the image is
+       * hashed sequentially.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetTreeHashChunkSize ( uint64_t chunkSize );
+      uint64_t GetTreeHashChunkSize () const;
+
+      /** \brief Hash only a region of the image.
+       *
+       * Only the pixels of the region are read, and the hash is the
+       * hash of the image extracted from the region, so a hash of a
+       * part of a large image does not read the whole image. The region
+       * must be inside the image. By default the whole image is hashed.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetHashRegion ( const std::vector<int> &index, const std::vector<unsigned int> &size );
+      std::vector<int> GetHashRegionIndex () const;
+      std::vector<unsigned int> GetHashRegionSize () const;
+      SITK_RETURN_SELF_TYPE_HEADER RemoveHashRegion ();
+
       /** Name of this class */
       std::string GetName() const override { return std::string ( "Hash"); }
 
@@ -63,6 +92,9 @@ namespace itk {
 
     private:
       HashFunction m_HashFunction;
+      uint64_t m_TreeHashChunkSize;
+      std::vector<int> m_HashRegionIndex;
+      std::vector<unsigned int> m_HashRegionSize;
 
       template <class TImageType> std::string ExecuteInternal ( const Image& image );
       template <class TImageType> std::string ExecuteInternalLabelImage ( const Image& image );
@@ -22,6 +22,13 @@
 #include "sitkMemberFunctionFactory.h"
 #include "sitkBasicFilters.h"
 #include "sitkProcessObject.h"
+#include "sitkTemplateFunctions.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace itk {
 
@@ -58,8 +65,144 @@ namespace itk {
        */
       virtual ~ImageFilter() = 0;
 
+      /** \brief The number of pieces in which the output is computed.
+       *
+       * When greater than one, filters which support streaming
+       * execute the ITK pipeline for each piece of the output in
+       * turn. This limits the temporary memory used internally by the
+       * filter, while the input and output images are still held in
+       * memory. Filters which do not support streaming ignore this
+       * value. The default is 1.
+       * @{
+       */
+      virtual void SetNumberOfStreamDivisions(unsigned int n);
+      virtual unsigned int GetNumberOfStreamDivisions() const;
+      /**@}*/
+
+      /** \brief Provide an image whose pixel buffer is reused for the
+       * output of the next execution.
+       *
+       * The filter takes ownership of the image. When the next
+       * Execute runs, the image's buffer becomes the output buffer if
+       * the image is not shared with another Image object, its ITK
+       * type matches the filter's output type, and it is large
+       * enough. Otherwise a new buffer is allocated as usual. The
+       * provided image is released after the next execution in
+       * either case, so it must not be used afterwards.
+       *
+       * In C++ pass the image with std::move. In Python drop all
+       * other references to the image so that it is unique.
+       * @{
+       */
+      void SetOutputImage( Image image );
+      bool HasOutputImage() const;
+      void RemoveOutputImage();
+      /**@}*/
+
+      /** \brief Keep the ITK filter between executions.
+       *
+       * When enabled, the ITK filter constructed by Execute is kept
+       * and reused by following executions with the same image
+       * types, so internal state such as FFT plans and intermediate
+       * buffers is not reconstructed for each call. The output is
+       * disconnected from the kept filter and its input images are
+       * released after each execution. Filters with measurements
+       * already keep their ITK filter until the next execution and
+       * ignore this option. The default is off.
+       * @{
+       */
+      virtual void SetReuseITKFilter( bool reuse );
+      virtual bool GetReuseITKFilter() const;
+      void ReuseITKFilterOn() { this->SetReuseITKFilter( true ); }
+      void ReuseITKFilterOff() { this->SetReuseITKFilter( false ); }
+      /**@}*/
+
+      /** Release the ITK filter kept by ReuseITKFilter. */
+      void ReleaseITKFilter();
+
     protected:
 
+      /** Invoke func in a new thread, the returned future holds the
+       * result or the exception thrown. Used to implement the
+       * ExecuteAsync methods.
+       */
+      template< typename TFunction >
+      static auto LaunchAsync( TFunction && func ) -> std::future<decltype(func())>
+      {
+        return std::async( std::launch::async, std::forward<TFunction>(func) );
+      }
+
+      /** Return a new ITK filter, or the filter kept from the
+       * previous execution when ReuseITKFilter is enabled and the
+       * type matches.
+       */
+      template< class TFilterType >
+      typename TFilterType::Pointer CreateITKFilter()
+      {
+        if ( !this->m_ReuseITKFilter )
+          {
+          return TFilterType::New();
+          }
+
+        typename TFilterType::Pointer filter = dynamic_cast<TFilterType *>( this->m_ITKFilter );
+        if ( filter.IsNull() )
+          {
+          filter = TFilterType::New();
+          this->SetITKFilter( filter.GetPointer() );
+          }
+        this->ResetITKFilter();
+        return filter;
+      }
+
+      /** Called when the execution of filter completes or fails. If
+       * it is the kept ITK filter, its output is disconnected, its
+       * input images are released and the observers added for the
+       * execution are removed.
+       */
+      void FinishITKFilterExecution( const itk::ProcessObject *filter );
+
+      /** Signature of the function which executes one image of a
+       * batch with a worker filter.
+       */
+      using BatchFunctionType = std::function<Image(const Image &)>;
+
+      /** Execute a batch of images in parallel, used to implement
+       * ExecuteBatch.
+       *
+       * Up to GetNumberOfThreads() threads, or the number of threads
+       * granted by the Executor, each call createWorker once to
+       * obtain a function bound to a filter of their own, then
+       * execute images from the batch until it is exhausted. The
+       * outputs are in the order of the inputs. The first exception
+       * thrown stops the remaining executions and is rethrown.
+       */
+      std::vector<Image> ExecuteBatchInParallel( const std::vector<Image> &images,
+                                                 const std::function<BatchFunctionType()> &createWorker );
+
+      /** Execute the slices of an image in parallel, used to
+       * implement ExecuteSliceBySlice.
+       *
+       * The image is divided into the slices perpendicular to axis,
+       * which have one dimension less than the image. The slices are
+       * executed by workers created as by ExecuteBatchInParallel,
+       * and each result is copied into its slice of the output
+       * buffer as soon as it is computed. The output has the
+       * geometry of the image, and the pixel type of the results,
+       * which must have the size of the slices.
+       */
+      Image ExecuteSliceBySliceInParallel( const Image &image,
+                                           unsigned int axis,
+                                           const std::function<BatchFunctionType()> &createWorker );
+
+      /** Copy the execution settings of this filter to a worker
+       * filter of a batch. The worker executes on a single thread
+       * without an executor, as the threads of the batch are acquired
+       * by this filter. It has the stream divisions of this filter,
+       * shares the cancellation token and keeps its ITK filter when
+       * this filter does, commands are not copied.
+       */
+      void InitializeBatchWorker( ImageFilter &worker ) const;
+
       // Simple ITK must use a zero based index
       template< class TImageType>
       static void FixNonZeroIndex( TImageType * img )
@@ -91,6 +234,98 @@ namespace itk {
 
       }
 
+      /** Give the output of an ITK filter the meta-data dictionary
+       * of the first input, unless the filter has set one. The ITK
+       * inputs only carry the dictionaries of the SimpleITK images
+       * when the global meta-data propagation is enabled.
+       */
+      template< class TImageType >
+      static void PropagateMetaData( itk::ProcessObject *filter, TImageType *output )
+      {
+        const itk::ProcessObject::DataObjectPointerArray inputs = filter->GetIndexedInputs();
+        if ( !inputs.empty() && inputs[0] && output->GetMetaDataDictionary().GetKeys().empty() )
+          {
+          output->SetMetaDataDictionary( inputs[0]->GetMetaDataDictionary() );
+          }
+      }
+
+      /** The output of an ITK filter which keeps the order of the
+       * pixels in the buffer, as an image referring to the buffer of
+       * the input with the output information of the filter. The
+       * output information of the filter must be updated.
+       */
+      template< class TFilterType >
+      static Image ExecuteInformationOnly( const Image &input, TFilterType *filter )
+      {
+        const auto *output = filter->GetOutput();
+        const auto &region = output->GetLargestPossibleRegion();
+
+        // the origin of a zero based index, as FixNonZeroIndex
+        typename TFilterType::OutputImageType::PointType origin;
+        output->TransformIndexToPhysicalPoint( region.GetIndex(), origin );
+
+        Image view = input.GetReshapedView( sitkITKVectorToSTL<uint32_t>( region.GetSize() ),
+                                            sitkITKVectorToSTL<double>( origin ),
+                                            sitkITKVectorToSTL<double>( output->GetSpacing() ),
+                                            sitkITKDirectionToSTL( output->GetDirection() ) );
+        if ( GetGlobalMetaDataPropagation() )
+          {
+          view.CopyMetaData( input );
+          }
+        return view;
+      }
+
+      /** Returns true when the permutation keeps the order of the
+       * axes with more than one pixel, so the pixels keep their order
+       * in the buffer. The output axis i is the input axis order[i].
+       */
+      template< class TOrder, class TSize >
+      static bool IsBufferOrderPermutation( const TOrder &order, const TSize &inputSize )
+      {
+        int previous = -1;
+        for ( unsigned int i = 0; i < TSize::Dimension; ++i )
+          {
+          if ( inputSize[order[i]] > 1 )
+            {
+            if ( static_cast<int>( order[i] ) < previous )
+              {
+              return false;
+              }
+            previous = static_cast<int>( order[i] );
+            }
+          }
+        return true;
+      }
+
+      /** Returns true when only the axes of one pixel are flipped. */
+      template< class TFlipAxes, class TSize >
+      static bool IsUnitAxesFlip( const TFlipAxes &flipAxes, const TSize &size )
+      {
+        for ( unsigned int i = 0; i < TSize::Dimension; ++i )
+          {
+          if ( flipAxes[i] && size[i] > 1 )
+            {
+            return false;
+            }
+          }
+        return true;
+      }
+
+      /** Returns true when the cyclic shift is a multiple of the size
+       * of all axes. */
+      template< class TShift, class TSize >
+      static bool IsNullCyclicShift( const TShift &shift, const TSize &size )
+      {
+        for ( unsigned int i = 0; i < TSize::Dimension; ++i )
+          {
+          if ( size[i] != 0 && shift[i] % static_cast<itk::OffsetValueType>( size[i] ) != 0 )
+            {
+            return false;
+            }
+          }
+        return true;
+      }
+
       /** Verify the dimension of image1 matches the dimension of
        * image2, and if not then an exception is thrown.
        */
@@ -105,7 +340,76 @@ namespace itk {
        * image2, and if different then an exception is thrown.
        */
       void CheckImageMatchingSize(const Image &image1, const Image& image2, const std::string &image2Name );
+
+      /** Arrange for the pixel container of the image provided with
+       * SetOutputImage to be used by output when filter runs. The
+       * container is attached when the ITK filter starts, after the
+       * pipeline has initialized the output and before it is
+       * allocated, so the allocation reuses the existing memory.
+       */
+      template< class TImageType >
+      typename std::enable_if<!IsLabel<TImageType>::Value>::type
+      ReuseOutputImageBuffer( itk::ProcessObject *filter, TImageType *output )
+      {
+        std::unique_ptr<Image> image = std::move( this->m_OutputImage );
+        if ( !image || !image->IsUnique() )
+          {
+          return;
+          }
+
+        auto *itkImage = dynamic_cast<TImageType *>( image->GetITKBase() );
+        if ( itkImage == nullptr )
+          {
+          return;
+          }
+
+        typename TImageType::PixelContainerPointer container = itkImage->GetPixelContainer();
+        image.reset();
+
+        this->OnITKStartEvent( filter, [output, container]() { output->SetPixelContainer( container ); } );
+      }
+
+      template< class TImageType >
+      typename std::enable_if<IsLabel<TImageType>::Value>::type
+      ReuseOutputImageBuffer( itk::ProcessObject *, TImageType * )
+      {
+        this->m_OutputImage.reset();
+      }
+
+    private:
+
+      /** Run numberOfItems items on up to GetNumberOfThreads()
+       * threads, each calling createWorker once for the function
+       * which executes the items given to it.
+       */
+      void ExecuteItemsInParallel( size_t numberOfItems,
+                                   const std::function<std::function<void(size_t)>()> &createWorker );
+
+      void OnITKStartEvent( itk::ProcessObject *filter, std::function<void()> func );
+
+      void SetITKFilter( itk::ProcessObject *filter );
+      void ResetITKFilter();
+
+      unsigned int m_NumberOfStreamDivisions;
+
+      std::unique_ptr<Image> m_OutputImage;
+
+      bool m_ReuseITKFilter{false};
+      itk::ProcessObject *m_ITKFilter{nullptr};
   };
+
+  /** \brief Execute a filter on each slice of an image.
+   *
+   * The slices perpendicular to axis are executed in parallel by
+   * the filter's ExecuteSliceBySlice method, so any filter with one
+   * input image and an image output may be applied to the 2D slices
+   * of a volume.
+   */
+  template< class TFilterType >
+  Image SliceBySlice( TFilterType &filter, const Image &image, unsigned int axis = 2 )
+  {
+    return filter.ExecuteSliceBySlice( image, axis );
+  }
   }
 }
 #endif
@@ -39,13 +39,22 @@ namespace simple {
 * basis, and implemented with the corresponding image filters. These
 * operators generally don't work with label images, and the logical
 * operators don't work with images of real components or vector images.
+*
+* When an operand is a temporary image, its buffer is reused for the
+* result. For the commutative operators the operands may be swapped
+* to reuse a temporary right-hand operand, then the result has the
+* meta-data of the right-hand image. An expression such as
+* a*b + c*d - e allocates two images, one of which holds the result.
 * @{
 */
 inline Image operator+( const Image &img1, const Image &img2 ) { return Add(img1, img2 ); }
 inline Image operator+( Image &&img1, const Image &img2 ) { return Add(std::move(img1), img2 ); }
+inline Image operator+( const Image &img1, Image &&img2 ) { return Add(std::move(img2), img1 ); }
+inline Image operator+( Image &&img1, Image &&img2 ) { return Add(std::move(img1), img2 ); }
 inline Image operator+( const Image &img, double s ) { return  Add(img, s ); }
 inline Image operator+( Image &&img, double s ) { return  Add(std::move(img), s ); }
 inline Image operator+( double s,  const Image &img ) { return  Add(s, img ); }
+inline Image operator+( double s,  Image &&img ) { return  Add(std::move(img), s ); }
 inline Image operator-( const Image &img1, const Image &img2 ) { return Subtract(img1, img2 ); }
 inline Image operator-( Image &&img1, const Image &img2 ) { return Subtract(std::move(img1), img2 ); }
 inline Image operator-( const Image &img, double s ) { return  Subtract(img, s ); }
@@ -53,9 +62,12 @@ inline Image operator-( Image &&img, double s ) { return  Subtract(std::move(img
 inline Image operator-( double s, const Image &img ) { return  Subtract(s, img ); }
 inline Image operator*( const Image &img1, const Image &img2 ) { return Multiply(img1, img2 ); }
 inline Image operator*( Image &&img1, const Image &img2 ) { return Multiply(std::move(img1), img2 ); }
+inline Image operator*( const Image &img1, Image &&img2 ) { return Multiply(std::move(img2), img1 ); }
+inline Image operator*( Image &&img1, Image &&img2 ) { return Multiply(std::move(img1), img2 ); }
 inline Image operator*( const Image &img, double s  ) { return Multiply(img, s ); }
 inline Image operator*( Image &&img, double s  ) { return Multiply(std::move(img), s ); }
 inline Image operator*( double s,  const Image &img ) { return Multiply(s, img ); }
+inline Image operator*( double s,  Image &&img ) { return Multiply(std::move(img), s ); }
 inline Image operator/( const Image &img1, const Image &img2 ) { return Divide(img1, img2 ); }
 inline Image operator/( Image &&img1, const Image &img2 ) { return Divide(std::move(img1), img2 ); }
 inline Image operator/( const Image &img, double s  ) { return Divide(img, s ); }
@@ -76,21 +88,30 @@ inline Image operator~( Image &&img ) { return BitwiseNot( std::move(img) ); }
 
 inline Image operator&( const Image &img1, const Image &img2 ) { return And(img1, img2 ); }
 inline Image operator&( Image &&img1, const Image &img2 ) { return And(std::move(img1), img2 ); }
+inline Image operator&( const Image &img1, Image &&img2 ) { return And(std::move(img2), img1 ); }
+inline Image operator&( Image &&img1, Image &&img2 ) { return And(std::move(img1), img2 ); }
 inline Image operator&( const Image &img,  int s ) { return And(img, s ); }
 inline Image operator&( Image &&img,  int s ) { return And(std::move(img), s ); }
 inline Image operator&( int s, const Image &img ) { return And(s, img ); }
+inline Image operator&( int s, Image &&img ) { return And(std::move(img), s ); }
 
 inline Image operator|( const Image &img1, const Image &img2 ) { return Or(img1, img2 ); }
 inline Image operator|( Image &&img1, const Image &img2 ) { return Or(std::move(img1), img2 ); }
+inline Image operator|( const Image &img1, Image &&img2 ) { return Or(std::move(img2), img1 ); }
+inline Image operator|( Image &&img1, Image &&img2 ) { return Or(std::move(img1), img2 ); }
 inline Image operator|( const Image &img, int s ) { return Or(img, s ); }
 inline Image operator|( Image &&img, int s ) { return Or(std::move(img), s ); }
 inline Image operator|( int s, const Image &img ) { return Or(s, img ); }
+inline Image operator|( int s, Image &&img ) { return Or(std::move(img), s ); }
 
 inline Image operator^( const Image &img1, const Image &img2 ) { return Xor(img1, img2 ); }
 inline Image operator^( Image &&img1, const Image &img2 ) { return Xor(std::move(img1), img2 ); }
+inline Image operator^( const Image &img1, Image &&img2 ) { return Xor(std::move(img2), img1 ); }
+inline Image operator^( Image &&img1, Image &&img2 ) { return Xor(std::move(img1), img2 ); }
 inline Image operator^( const Image &img, int s ) { return Xor(img, s ); }
 inline Image operator^( Image &&img, int s ) { return Xor(std::move(img), s ); }
 inline Image operator^( int s, const Image &img ) { return Xor(s, img ); }
+inline Image operator^( int s, Image &&img ) { return Xor(std::move(img), s ); }
 
 
 inline Image &operator+=( Image &img1, const Image &img2 ) { return img1 = Add(std::move(img1), img2 ); }
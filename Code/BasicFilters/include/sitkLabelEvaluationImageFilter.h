@@ -0,0 +1,145 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkLabelEvaluationImageFilter_h
+#define sitkLabelEvaluationImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+    /** \class LabelEvaluationImageFilter
+     * \brief Compute the overlap and surface distance measures of each
+     * label of a prediction against a reference, in a single
+     * evaluation.
+     *
+     * For each label of either image other than BackgroundValue, the
+     * Dice and Jaccard coefficients, the volume similarity, the
+     * Hausdorff distance, its 95th percentile and the average symmetric
+     * surface distance are computed together, instead of running the
+     * LabelOverlapMeasuresImageFilter, the HausdorffDistanceImageFilter
+     * and distance maps of the label contours for each label.
+     *
+     * The distances are between the surfaces of the labels, the pixels
+     * with a face neighbor of another label, and are computed by
+     * distance maps restricted to the neighborhood of the surfaces.
+     * The distances larger than MaximumDistance are MaximumDistance,
+     * which bounds the cost of the distance maps. A label missing from
+     * one of the images has infinite distances.
+     *
+     * The volume similarity is one minus the absolute difference of the
+     * volumes over their sum, which is one for equal volumes, unlike the
+     * signed VolumeSimilarity of the LabelOverlapMeasuresImageFilter.
+     *
+     * \sa itk::simple::LabelOverlapMeasuresImageFilter
+     * \sa itk::simple::HausdorffDistanceImageFilter
+     * \sa itk::LabelEvaluationImageFilter for the Doxygen on the original ITK class.
+     */
+    class SITKBasicFilters_EXPORT LabelEvaluationImageFilter
+      : public ProcessObject {
+    public:
+      using Self = LabelEvaluationImageFilter;
+
+      // function pointer type
+      typedef void (Self::*MemberFunctionType)( const Image&, const Image& );
+
+      // this filter works with the integer image types
+      using PixelIDTypeList = IntegerPixelIDTypeList;
+
+      ~LabelEvaluationImageFilter() override;
+
+      LabelEvaluationImageFilter();
+
+      /** The label which is not evaluated, 0 by default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetBackgroundValue ( double backgroundValue );
+      double GetBackgroundValue () const;
+
+      /** Set/Get whether the distances are in physical units, on by
+       * default, or in pixels.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetUseImageSpacing ( bool useImageSpacing );
+      bool GetUseImageSpacing () const;
+      SITK_RETURN_SELF_TYPE_HEADER UseImageSpacingOn () { return this->SetUseImageSpacing( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER UseImageSpacingOff () { return this->SetUseImageSpacing( false ); }
+      /** @} */
+
+      /** The largest distance which is computed, not bounded by
+       * default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetMaximumDistance ( double maximumDistance );
+      double GetMaximumDistance () const;
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "LabelEvaluation"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      /** Compare the labels of the prediction to the labels of the
+       * reference, which must have the same size and pixel type. */
+      void Execute ( const Image &referenceImage, const Image &predictionImage );
+
+      /**
+       * This is a measurement. Its value is updated in the Execute
+       * methods, so the value will only be valid after an execution.
+       * @{
+       */
+      std::vector<int64_t> GetLabels () const { return this->m_Labels; }
+      uint64_t GetNumberOfLabels () const { return this->m_Labels.size(); }
+      bool HasLabel ( int64_t label ) const;
+
+      double GetDiceCoefficient ( int64_t label ) const;
+      double GetJaccardCoefficient ( int64_t label ) const;
+      double GetVolumeSimilarity ( int64_t label ) const;
+      double GetHausdorffDistance ( int64_t label ) const;
+      double GetHausdorffDistance95 ( int64_t label ) const;
+      double GetAverageSymmetricSurfaceDistance ( int64_t label ) const;
+      /** @} */
+
+    private:
+      size_t GetLabelPosition ( int64_t label ) const;
+
+      double m_BackgroundValue;
+      bool m_UseImageSpacing;
+      double m_MaximumDistance;
+
+      std::vector<int64_t> m_Labels;
+      std::vector<double> m_DiceCoefficients;
+      std::vector<double> m_JaccardCoefficients;
+      std::vector<double> m_VolumeSimilarities;
+      std::vector<double> m_HausdorffDistances;
+      std::vector<double> m_HausdorffDistances95;
+      std::vector<double> m_AverageSymmetricSurfaceDistances;
+
+      template <class TImageType>
+      void ExecuteInternal ( const Image &referenceImage, const Image &predictionImage );
+
+      // friend to get access to executeInternal member
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+    };
+  }
+}
+#endif
@@ -53,6 +53,15 @@ number of landmarks and can be specified using SetLandmarkWeight()
 . By defaults are weights are set to one. Call InitializeTransform()
 to initialize the transform.
 
+When the landmarks contain outliers, a robust fit with RANSAC is
+enabled by setting RANSACNumberOfIterations. Each iteration fits the
+transform to a minimal random subset of the landmarks, and the
+landmark pairs mapped closer than RANSACInlierThreshold are its
+inliers. The transform is then fit to the inliers of the best subset,
+and refit to the inliers of that transform. The iterations run in
+parallel on the threads of the filter, and the result only depends on
+the seed. RANSAC is not supported for the BSplineTransform.
+
 The class is based in part on Hybrid/vtkLandmarkTransform originally implemented in python by David G. Gobbi.
 
 The solution is based on Berthold K. P. Horn (1987), "Closed-form solution of absolute orientation
@@ -133,6 +142,33 @@ in ITK" by Kim E.Y., Johnson H., Williams N. available at https://www.midasjourn
        * Set/Get the number of control points
        */
         unsigned int GetBSplineNumberOfControlPoints() const { return this->m_BSplineNumberOfControlPoints; }
+
+      /**
+       * Set/Get the number of RANSAC iterations. When 0, the
+       * default, the transform is fit to all the landmarks.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetRANSACNumberOfIterations ( unsigned int RANSACNumberOfIterations ) { this->m_RANSACNumberOfIterations = RANSACNumberOfIterations; return *this; }
+      unsigned int GetRANSACNumberOfIterations() const { return this->m_RANSACNumberOfIterations; }
+
+      /**
+       * Set/Get the largest distance, in physical units, between a
+       * transformed fixed landmark and its moving landmark for the
+       * pair to be an inlier.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetRANSACInlierThreshold ( double RANSACInlierThreshold ) { this->m_RANSACInlierThreshold = RANSACInlierThreshold; return *this; }
+      double GetRANSACInlierThreshold() const { return this->m_RANSACInlierThreshold; }
+
+      /**
+       * Set/Get the seed of the random subsets. The default,
+       * sitkWallClock, uses the time of the execution.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetRANSACSeed ( uint32_t RANSACSeed ) { this->m_RANSACSeed = RANSACSeed; return *this; }
+      uint32_t GetRANSACSeed() const { return this->m_RANSACSeed; }
+
+      /** The indices of the landmark pairs which are inliers of the
+       * transform fit with RANSAC, or empty without RANSAC. */
+      std::vector<uint32_t> GetRANSACInliers() const { return this->m_RANSACInliers; }
+
       /** Name of this class */
       std::string GetName() const override { return std::string ("LandmarkBasedTransformInitializerFilter"); }
 
@@ -166,6 +202,12 @@ in ITK" by Kim E.Y., Johnson H., Williams N. available at https://www.midasjourn
 
       Image         m_ReferenceImage;
       unsigned int  m_BSplineNumberOfControlPoints;
+
+      unsigned int  m_RANSACNumberOfIterations;
+      double        m_RANSACInlierThreshold;
+      uint32_t      m_RANSACSeed;
+
+      std::vector<uint32_t> m_RANSACInliers;
     };
 
 
@@ -0,0 +1,123 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMultiChannelLabelStatisticsImageFilter_h
+#define sitkMultiChannelLabelStatisticsImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkDualMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+    /** \class MultiChannelLabelStatisticsImageFilter
+     * \brief Compute the statistics of each label for each channel of
+     * the intensity images, in a single pass.
+     *
+     * The channels are the components of a vector image, or of a list
+     * of scalar and vector images of the same component type. For each
+     * label and each channel the minimum, maximum, mean, sigma,
+     * variance and sum are computed, as the LabelStatisticsImageFilter
+     * computes them for one channel, but the label image is not read
+     * again for each channel.
+     *
+     * The statistics of a label are returned with one value per
+     * channel.
+     *
+     * \sa itk::simple::LabelStatisticsImageFilter
+     * \sa itk::MultiChannelLabelStatisticsImageFilter for the Doxygen on the original ITK class.
+     */
+    class SITKBasicFilters_EXPORT MultiChannelLabelStatisticsImageFilter
+      : public ProcessObject {
+    public:
+      using Self = MultiChannelLabelStatisticsImageFilter;
+
+      // function pointer type
+      typedef void (Self::*MemberFunctionType)( const std::vector<Image>&, const Image& );
+
+      // the channels are of the scalar and vector image types, and the
+      // labels of the integer types
+      using PixelIDTypeList = typelist2::append<BasicPixelIDTypeList, VectorPixelIDTypeList>::type;
+      using PixelIDTypeList2 = IntegerPixelIDTypeList;
+
+      ~MultiChannelLabelStatisticsImageFilter() override;
+
+      MultiChannelLabelStatisticsImageFilter();
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "MultiChannelLabelStatistics"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      /** Compute the statistics of the channels of image, a scalar or
+       * a vector image. */
+      void Execute ( const Image &image, const Image &labelImage );
+
+      /** Compute the statistics of the channels of the images, which
+       * must have the same component type. */
+      void Execute ( const std::vector<Image> &images, const Image &labelImage );
+
+      /**
+       * This is a measurement. Its value is updated in the Execute
+       * methods, so the value will only be valid after an execution.
+       * @{
+       */
+      std::vector<int64_t> GetLabels () const { return this->m_Labels; }
+      uint64_t GetNumberOfLabels () const { return this->m_Labels.size(); }
+      unsigned int GetNumberOfChannels () const { return this->m_NumberOfChannels; }
+      bool HasLabel ( int64_t label ) const;
+
+      uint64_t GetCount ( int64_t label ) const;
+      std::vector<double> GetMinimum ( int64_t label ) const;
+      std::vector<double> GetMaximum ( int64_t label ) const;
+      std::vector<double> GetMean ( int64_t label ) const;
+      std::vector<double> GetSigma ( int64_t label ) const;
+      std::vector<double> GetVariance ( int64_t label ) const;
+      std::vector<double> GetSum ( int64_t label ) const;
+      /** @} */
+
+    private:
+      size_t GetLabelPosition ( int64_t label ) const;
+      std::vector<double> GetChannelValues ( const std::vector<double> &values, int64_t label ) const;
+
+      std::vector<int64_t> m_Labels;
+      unsigned int m_NumberOfChannels;
+      std::vector<uint64_t> m_Counts;
+      std::vector<double> m_Minimum;
+      std::vector<double> m_Maximum;
+      std::vector<double> m_Mean;
+      std::vector<double> m_Sigma;
+      std::vector<double> m_Variance;
+      std::vector<double> m_Sum;
+
+      template <class TImageType, class TLabelImageType>
+      void DualExecuteInternal ( const std::vector<Image> &images, const Image &labelImage );
+
+      // friend to get access to executeInternal member
+      friend struct detail::DualExecuteInternalAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::DualMemberFunctionFactory<MemberFunctionType> > m_DualMemberFactory;
+    };
+  }
+}
+#endif
@@ -0,0 +1,151 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMultiProjectionImageFilter_h
+#define sitkMultiProjectionImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+    /** \class MultiProjectionImageFilter
+     * \brief Compute several projections of an image along an axis in
+     * a single pass.
+     *
+     * The maximum, minimum, median, mean, sum and standard deviation
+     * projections selected by the Compute flags are computed by one
+     * traversal of the image, instead of one traversal for each of the
+     * MaximumProjectionImageFilter, MinimumProjectionImageFilter,
+     * MedianProjectionImageFilter, MeanProjectionImageFilter,
+     * SumProjectionImageFilter and
+     * StandardDeviationProjectionImageFilter, and give the same
+     * images. When ProjectionDimension is not the first dimension, the
+     * image is read by rows along the first dimension rather than by
+     * projected lines.
+     *
+     * The maximum, minimum and median projections have the pixel type
+     * of the image, and the other projections a real pixel type.
+     *
+     * \sa itk::simple::MaximumProjectionImageFilter
+     * \sa itk::simple::MeanProjectionImageFilter
+     * \sa itk::MultiProjectionImageFilter for the Doxygen on the original ITK class.
+     */
+    class SITKBasicFilters_EXPORT MultiProjectionImageFilter
+      : public ProcessObject {
+    public:
+      using Self = MultiProjectionImageFilter;
+
+      // function pointer type
+      typedef void (Self::*MemberFunctionType)( const Image& );
+
+      // this filter works with the scalar image types
+      using PixelIDTypeList = BasicPixelIDTypeList;
+
+      ~MultiProjectionImageFilter() override;
+
+      MultiProjectionImageFilter();
+
+      /** The dimension along which the image is projected, 0 by
+       * default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetProjectionDimension ( unsigned int projectionDimension );
+      unsigned int GetProjectionDimension () const;
+
+      /** Set/Get which projections are computed, all by default.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetComputeMaximum ( bool computeMaximum );
+      bool GetComputeMaximum () const;
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMaximumOn () { return this->SetComputeMaximum( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMaximumOff () { return this->SetComputeMaximum( false ); }
+
+      SITK_RETURN_SELF_TYPE_HEADER SetComputeMinimum ( bool computeMinimum );
+      bool GetComputeMinimum () const;
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMinimumOn () { return this->SetComputeMinimum( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMinimumOff () { return this->SetComputeMinimum( false ); }
+
+      SITK_RETURN_SELF_TYPE_HEADER SetComputeMedian ( bool computeMedian );
+      bool GetComputeMedian () const;
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMedianOn () { return this->SetComputeMedian( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMedianOff () { return this->SetComputeMedian( false ); }
+
+      SITK_RETURN_SELF_TYPE_HEADER SetComputeMean ( bool computeMean );
+      bool GetComputeMean () const;
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMeanOn () { return this->SetComputeMean( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER ComputeMeanOff () { return this->SetComputeMean( false ); }
+
+      SITK_RETURN_SELF_TYPE_HEADER SetComputeSum ( bool computeSum );
+      bool GetComputeSum () const;
+      SITK_RETURN_SELF_TYPE_HEADER ComputeSumOn () { return this->SetComputeSum( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER ComputeSumOff () { return this->SetComputeSum( false ); }
+
+      SITK_RETURN_SELF_TYPE_HEADER SetComputeStandardDeviation ( bool computeStandardDeviation );
+      bool GetComputeStandardDeviation () const;
+      SITK_RETURN_SELF_TYPE_HEADER ComputeStandardDeviationOn () { return this->SetComputeStandardDeviation( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER ComputeStandardDeviationOff () { return this->SetComputeStandardDeviation( false ); }
+      /** @} */
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "MultiProjection"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      /** Compute the selected projections of the image. */
+      void Execute ( const Image &image );
+
+      /**
+       * The projections of the last execution. An exception is thrown
+       * for a projection which was not computed.
+       * @{
+       */
+      Image GetMaximumProjection () const;
+      Image GetMinimumProjection () const;
+      Image GetMedianProjection () const;
+      Image GetMeanProjection () const;
+      Image GetSumProjection () const;
+      Image GetStandardDeviationProjection () const;
+      /** @} */
+
+    private:
+      enum ProjectionType { Maximum, Minimum, Median, Mean, Sum, StandardDeviation, NumberOfProjections };
+
+      Image GetProjection ( ProjectionType projection, const char *name ) const;
+
+      unsigned int m_ProjectionDimension;
+      std::vector<bool> m_Compute;
+
+      std::vector<Image> m_Projections;
+      std::vector<bool> m_Computed;
+
+      template <class TImageType>
+      void ExecuteInternal ( const Image &image );
+
+      // friend to get access to executeInternal member
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+    };
+  }
+}
+#endif
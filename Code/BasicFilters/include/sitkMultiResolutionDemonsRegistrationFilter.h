@@ -0,0 +1,186 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMultiResolutionDemonsRegistrationFilter_h
+#define sitkMultiResolutionDemonsRegistrationFilter_h
+
+#include <memory>
+
+#include "sitkBasicFilters.h"
+#include "sitkImageFilter.h"
+
+namespace itk {
+  namespace simple {
+
+    /**\class MultiResolutionDemonsRegistrationFilter
+\brief Deformably register two images with a demons algorithm on a
+multi-resolution pyramid.
+
+The fixed and moving images are smoothed and shrunk for each level of
+the pyramid, from the coarsest to the finest. On each level the demons
+registration filter runs for the number of iterations of the level,
+or until the RMS change of the displacement field is below
+MaximumRMSError, and the resulting field is expanded to initialize the
+next level. The output is the displacement field at the resolution of
+the fixed image, of sitkVectorFloat64 pixel type.
+
+The number of levels is the number of elements of NumberOfIterations.
+By default the shrink factors are powers of two, halving the
+resolution between successive levels.
+
+The iteration event is invoked after each level.
+
+\sa itk::MultiResolutionPDEDeformableRegistration for the Doxygen on the original ITK class.
+\sa itk::simple::DemonsRegistrationFilter
+\sa itk::simple::DiffeomorphicDemonsRegistrationFilter
+\sa itk::simple::FastSymmetricForcesDemonsRegistrationFilter
+\sa itk::simple::SymmetricForcesDemonsRegistrationFilter
+     */
+    class SITKBasicFilters_EXPORT MultiResolutionDemonsRegistrationFilter : public ImageFilter {
+    public:
+      using Self = MultiResolutionDemonsRegistrationFilter;
+
+      /** Destructor */
+      ~MultiResolutionDemonsRegistrationFilter() override;
+
+      /** Default Constructor that takes no arguments and initializes
+       * default parameters */
+      MultiResolutionDemonsRegistrationFilter();
+
+      /** Define the pixels types supported by this filter */
+      using PixelIDTypeList = BasicPixelIDTypeList;
+
+      /** The demons algorithm run on each level. */
+      typedef enum {
+        Demons,
+        SymmetricForces,
+        FastSymmetricForces,
+        Diffeomorphic
+      } DemonsRegistrationType;
+
+      SITK_RETURN_SELF_TYPE_HEADER SetDemonsRegistrationType ( DemonsRegistrationType type ) { this->m_DemonsRegistrationType = type; return *this; }
+      DemonsRegistrationType GetDemonsRegistrationType() const { return this->m_DemonsRegistrationType; }
+
+      /**
+       * The maximum number of iterations of each level, from the
+       * coarsest to the finest, which also defines the number of
+       * levels.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetNumberOfIterations ( const std::vector<uint32_t> & NumberOfIterations ) { this->m_NumberOfIterations = NumberOfIterations; return *this; }
+      std::vector<uint32_t> GetNumberOfIterations() const { return this->m_NumberOfIterations; }
+
+      /**
+       * The shrink factor of each level, from the coarsest to the
+       * finest. When empty, the default, the factors are powers of
+       * two ending with 1.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetShrinkFactorsPerLevel ( const std::vector<uint32_t> & ShrinkFactorsPerLevel ) { this->m_ShrinkFactorsPerLevel = ShrinkFactorsPerLevel; return *this; }
+      std::vector<uint32_t> GetShrinkFactorsPerLevel() const { return this->m_ShrinkFactorsPerLevel; }
+
+      /**
+       * Set/Get the Gaussian smoothing standard deviations for the
+       * displacement field. The values are set with respect to pixel
+       * coordinates of each level.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetStandardDeviations ( const std::vector<double> & StandardDeviations ) { this->m_StandardDeviations = StandardDeviations; return *this; }
+      SITK_RETURN_SELF_TYPE_HEADER SetStandardDeviations( double value ) { this->m_StandardDeviations = std::vector<double>(3, value); return *this; }
+      std::vector<double> GetStandardDeviations() const { return this->m_StandardDeviations; }
+
+      /**
+       * Value of RMS change below which the registration of a level
+       * stops and proceeds to the next level.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMaximumRMSError ( double MaximumRMSError ) { this->m_MaximumRMSError = MaximumRMSError; return *this; }
+      double GetMaximumRMSError() const { return this->m_MaximumRMSError; }
+
+      /**
+       * The maximum length of an update vector, used by the
+       * FastSymmetricForces and Diffeomorphic algorithms.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMaximumUpdateStepLength ( double MaximumUpdateStepLength ) { this->m_MaximumUpdateStepLength = MaximumUpdateStepLength; return *this; }
+      double GetMaximumUpdateStepLength() const { return this->m_MaximumUpdateStepLength; }
+
+      /**
+       * Set/Get the threshold below which the absolute difference of
+       * intensity yields a match.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetIntensityDifferenceThreshold ( double IntensityDifferenceThreshold ) { this->m_IntensityDifferenceThreshold = IntensityDifferenceThreshold; return *this; }
+      double GetIntensityDifferenceThreshold() const { return this->m_IntensityDifferenceThreshold; }
+
+      SITK_RETURN_SELF_TYPE_HEADER SetUseImageSpacing ( bool UseImageSpacing ) { this->m_UseImageSpacing = UseImageSpacing; return *this; }
+      SITK_RETURN_SELF_TYPE_HEADER UseImageSpacingOn() { return this->SetUseImageSpacing(true); }
+      SITK_RETURN_SELF_TYPE_HEADER UseImageSpacingOff() { return this->SetUseImageSpacing(false); }
+      bool GetUseImageSpacing() const { return this->m_UseImageSpacing; }
+
+      /** The number of iterations run, over all the levels. This is an
+       * active measurement. */
+      uint32_t GetElapsedIterations() const { return this->m_ElapsedIterations; }
+
+      /** The RMS change of the displacement field at the last
+       * iteration. */
+      double GetRMSChange() const { return this->m_RMSChange; }
+
+      /** The metric value at the last iteration, the mean square
+       * difference of intensity on the finest level. */
+      double GetMetric() const { return this->m_Metric; }
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ("MultiResolutionDemonsRegistrationFilter"); }
+
+      /** Print ourselves out */
+      std::string ToString() const override;
+
+
+      /** Execute the filter on the input images */
+      Image Execute ( const Image & fixedImage, const Image & movingImage );
+
+      /** Execute the filter with an initial displacement field of
+       * any resolution, which is smoothed and resampled to the
+       * coarsest level. */
+      Image Execute ( const Image & fixedImage, const Image & movingImage, const Image & initialDisplacementField );
+
+    private:
+
+      /** Setup for member function dispatching */
+
+      using MemberFunctionType = Image (Self::*)( const Image * fixedImage, const Image * movingImage, const Image * initialDisplacementField );
+      template <class TImageType> Image ExecuteInternal ( const Image * fixedImage, const Image * movingImage, const Image * initialDisplacementField );
+      template <class TImageType, class TRegistrationFilter>
+        Image ExecuteInternalWithRegistration ( const Image * fixedImage, const Image * movingImage, const Image * initialDisplacementField );
+
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+
+
+      DemonsRegistrationType m_DemonsRegistrationType;
+      std::vector<uint32_t>  m_NumberOfIterations;
+      std::vector<uint32_t>  m_ShrinkFactorsPerLevel;
+      std::vector<double>    m_StandardDeviations;
+      double                 m_MaximumRMSError;
+      double                 m_MaximumUpdateStepLength;
+      double                 m_IntensityDifferenceThreshold;
+      bool                   m_UseImageSpacing;
+
+      uint32_t               m_ElapsedIterations;
+      double                 m_RMSChange;
+      double                 m_Metric;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,120 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMultiResolutionPyramidImageFilter_h
+#define sitkMultiResolutionPyramidImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+    /** \class MultiResolutionPyramidImageFilter
+     * \brief Compute the smoothed and shrunk levels of an image
+     * pyramid in a single pass.
+     *
+     * Each level is shrunk by its factor of ShrinkFactorsPerLevel
+     * along all the dimensions, and smoothed by the Gaussian of its
+     * sigma of SmoothingSigmasPerLevel, in physical units by
+     * default. The levels are computed together from one traversal of
+     * the image, and the smoothing is only evaluated at the shrunk
+     * pixels, instead of a SmoothingRecursiveGaussianImageFilter of
+     * the size of the image followed by a ShrinkImageFilter for each
+     * level.
+     *
+     * The levels have the size and the geometry of the
+     * BinShrinkImageFilter, and a sigma of 0 averages the pixels as
+     * the BinShrinkImageFilter. The levels are of the sitkFloat32
+     * pixel type, or sitkFloat64 for a sitkFloat64 image.
+     *
+     * \sa itk::simple::BinShrinkImageFilter
+     * \sa itk::simple::SmoothingRecursiveGaussianImageFilter
+     * \sa itk::FusedMultiResolutionPyramidImageFilter for the Doxygen on the original ITK class.
+     */
+    class SITKBasicFilters_EXPORT MultiResolutionPyramidImageFilter
+      : public ProcessObject {
+    public:
+      using Self = MultiResolutionPyramidImageFilter;
+
+      // function pointer type
+      typedef std::vector<Image> (Self::*MemberFunctionType)( const Image& );
+
+      // this filter works with the scalar image types
+      using PixelIDTypeList = BasicPixelIDTypeList;
+
+      ~MultiResolutionPyramidImageFilter() override;
+
+      MultiResolutionPyramidImageFilter();
+
+      /** The shrink factor of each level, {4, 2, 1} by default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetShrinkFactorsPerLevel ( const std::vector<unsigned int> &shrinkFactors );
+      std::vector<unsigned int> GetShrinkFactorsPerLevel () const;
+
+      /** The smoothing sigma of each level, {2.0, 1.0, 0.0} by
+       * default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetSmoothingSigmasPerLevel ( const std::vector<double> &smoothingSigmas );
+      std::vector<double> GetSmoothingSigmasPerLevel () const;
+
+      /** Whether the smoothing sigmas are in physical units, or in
+       * pixels, true by default. */
+      SITK_RETURN_SELF_TYPE_HEADER SetSmoothingSigmasAreSpecifiedInPhysicalUnits ( bool physicalUnits );
+      bool GetSmoothingSigmasAreSpecifiedInPhysicalUnits () const;
+      SITK_RETURN_SELF_TYPE_HEADER SmoothingSigmasAreSpecifiedInPhysicalUnitsOn () { return this->SetSmoothingSigmasAreSpecifiedInPhysicalUnits( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER SmoothingSigmasAreSpecifiedInPhysicalUnitsOff () { return this->SetSmoothingSigmasAreSpecifiedInPhysicalUnits( false ); }
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "MultiResolutionPyramid"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      /** Compute the levels of the pyramid of the image, in the order
+       * of ShrinkFactorsPerLevel. */
+      std::vector<Image> Execute ( const Image &image );
+
+    private:
+      std::vector<unsigned int> m_ShrinkFactorsPerLevel;
+      std::vector<double> m_SmoothingSigmasPerLevel;
+      bool m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
+
+      template <class TImageType>
+      std::vector<Image> ExecuteInternal ( const Image &image );
+
+      // friend to get access to executeInternal member
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+    };
+
+    /** \brief Compute the smoothed and shrunk levels of an image
+     * pyramid in a single pass.
+     *
+     * \sa itk::simple::MultiResolutionPyramidImageFilter for the object oriented interface
+     */
+    SITKBasicFilters_EXPORT std::vector<Image> MultiResolutionPyramid ( const Image &image,
+                                                                        const std::vector<unsigned int> &shrinkFactors,
+                                                                        const std::vector<double> &smoothingSigmas,
+                                                                        bool smoothingSigmasAreSpecifiedInPhysicalUnits = true );
+  }
+}
+#endif
@@ -119,6 +119,9 @@ namespace itk {
       /** Name of this class */
       std::string GetName() const { return std::string ("PasteImageFilter"); }
 
+      /** This filter can reuse the buffer of a moved destination image */
+      bool CanRunInPlace() const override { return true; }
+
       /** Print ourselves out */
       std::string ToString() const;
 
@@ -131,6 +134,28 @@ namespace itk {
       Image Execute ( const Image & destinationImage, const Image & sourceImage );
       Image Execute ( const Image & destinationImage, double constant);
 
+      /** Paste each of the sourceImages at the destination index of
+       * the same position, in one call.
+       *
+       * The whole of each source image is pasted, clipped to the
+       * destination image, and the SourceSize and SourceIndex are not
+       * used. A source image of a lower dimension is pasted along the
+       * axes which are not skipped by the DestinationSkipAxes. The
+       * pixels are copied as contiguous blocks by multiple threads, and
+       * where source images overlap the last one is pasted over the
+       * previous ones.
+       * @{
+       */
+#ifndef SWIG
+      Image Execute ( Image && destinationImage,
+                      const std::vector<Image> & sourceImages,
+                      const std::vector< std::vector<int> > & destinationIndices );
+#endif
+      Image Execute ( const Image & destinationImage,
+                      const std::vector<Image> & sourceImages,
+                      const std::vector< std::vector<int> > & destinationIndices );
+      /** @} */
+
 
     private:
 
@@ -154,6 +179,10 @@ namespace itk {
       friend struct detail::MemberFunctionAddressor<MemberFunction2Type>;
       std::unique_ptr<detail::MemberFunctionFactory<MemberFunction2Type> > m_MemberFactory2;
 
+      void PasteInternal ( Image & destinationImage,
+                           const std::vector<Image> & sourceImages,
+                           const std::vector< std::vector<int> > & destinationIndices );
+
 
       std::vector<unsigned int>  m_SourceSize{std::vector<unsigned int>(SITK_MAX_DIMENSION, 1)};
 
@@ -180,6 +209,11 @@ namespace itk {
 #endif
      SITKBasicFilters_EXPORT Image Paste ( const Image & destinationImage, const Image & sourceImage, std::vector<unsigned int> sourceSize = std::vector<unsigned int>(SITK_MAX_DIMENSION, 1), std::vector<int> sourceIndex = std::vector<int>(SITK_MAX_DIMENSION, 0), std::vector<int> destinationIndex = std::vector<int>(SITK_MAX_DIMENSION, 0), std::vector<bool> DestinationSkipAxes = std::vector<bool>() );
 
+#ifndef SWIG
+     SITKBasicFilters_EXPORT Image Paste ( Image && destinationImage, const std::vector<Image> & sourceImages, const std::vector< std::vector<int> > & destinationIndices );
+#endif
+     SITKBasicFilters_EXPORT Image Paste ( const Image & destinationImage, const std::vector<Image> & sourceImages, const std::vector< std::vector<int> > & destinationIndices );
+
      /** @} */
   }
 }
@@ -0,0 +1,89 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkPlanarToVectorImageFilter_h
+#define sitkPlanarToVectorImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+namespace itk {
+  namespace simple {
+
+    /** \class PlanarToVectorImageFilter
+     * \brief Copy the planes of a scalar image along its last
+     * dimension to the components of a vector image of one less
+     * dimension.
+     *
+     * This filter is the inverse of the VectorToPlanarImageFilter: the
+     * planes of the last and slowest dimension are the components of
+     * the output, which has the geometry of the first dimensions of
+     * the input. An image from a NumPy array in channel first order,
+     * (C,Y,X) or (C,Z,Y,X), is converted to a vector image in one
+     * parallel pass, instead of one ExtractImageFilter for each
+     * component followed by the ComposeImageFilter.
+     *
+     * \sa itk::simple::VectorToPlanarImageFilter
+     * \sa itk::simple::PlanarToVector for the procedural interface
+     */
+    class SITKBasicFilters_EXPORT PlanarToVectorImageFilter
+      : public ProcessObject {
+    public:
+      using Self = PlanarToVectorImageFilter;
+
+      // function pointer type
+      typedef Image (Self::*MemberFunctionType)( const Image& );
+
+      // this filter works with the scalar image types
+      using PixelIDTypeList = BasicPixelIDTypeList;
+
+      ~PlanarToVectorImageFilter() override;
+
+      PlanarToVectorImageFilter();
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "PlanarToVector"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      Image Execute ( const Image &image );
+
+    private:
+
+      template <class TImageType> Image ExecuteInternal ( const Image &image );
+
+      // friend to get access to executeInternal member
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+    };
+
+    /**
+     * \brief Copy the planes of a scalar image along its last
+     * dimension to the components of a vector image of one less
+     * dimension.
+     *
+     * \sa itk::simple::PlanarToVectorImageFilter for the object oriented interface
+     */
+    SITKBasicFilters_EXPORT Image PlanarToVector ( const Image &image );
+  }
+}
+#endif
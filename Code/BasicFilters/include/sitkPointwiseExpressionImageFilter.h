@@ -0,0 +1,147 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkPointwiseExpressionImageFilter_h
+#define sitkPointwiseExpressionImageFilter_h
+
+#include "sitkImageFilter.h"
+
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class PointwiseExpressionImageFilter
+ * \brief Apply a chain of pointwise operations in a single pass over
+ * the image.
+ *
+ * The operations are recorded in order by the methods Add, Multiply,
+ * Clamp, etc. and evaluated when the filter is executed. A chain such
+ * as Multiply(2.0).Add(5.0) produces the same result as the
+ * MultiplyImageFilter followed by the AddImageFilter with constants,
+ * but without allocating the intermediate image, and with each pixel
+ * read and written once.
+ *
+ * The operations are computed in double precision on each component
+ * of the pixels. The result is converted to the output pixel type
+ * once, values outside the range of an integer output type are
+ * clamped. When the OutputPixelType is sitkUnknown, the default, the
+ * output has the pixel type of the input. Complex and label pixel
+ * types are not supported.
+ *
+ * No ITK filter is executed, so commands and progress are not
+ * reported.
+ *
+ * \sa itk::simple::MultiplyImageFilter itk::simple::AddImageFilter
+ */
+class SITKBasicFilters_EXPORT PointwiseExpressionImageFilter
+  : public ImageFilter
+{
+public:
+  using Self = PointwiseExpressionImageFilter;
+
+  ~PointwiseExpressionImageFilter() override;
+
+  /**
+   * Default Constructor that takes no arguments and initializes
+   * default parameters
+   */
+  PointwiseExpressionImageFilter();
+
+  /** Append an operation to the expression.
+   *
+   * ShiftScale computes ( value + shift ) * scale.
+   * @{
+   */
+  SITK_RETURN_SELF_TYPE_HEADER Add( double constant );
+  SITK_RETURN_SELF_TYPE_HEADER Subtract( double constant );
+  SITK_RETURN_SELF_TYPE_HEADER Multiply( double constant );
+  SITK_RETURN_SELF_TYPE_HEADER Divide( double constant );
+  SITK_RETURN_SELF_TYPE_HEADER ShiftScale( double shift, double scale );
+  SITK_RETURN_SELF_TYPE_HEADER Clamp( double lowerBound, double upperBound );
+  SITK_RETURN_SELF_TYPE_HEADER Abs();
+  SITK_RETURN_SELF_TYPE_HEADER Square();
+  SITK_RETURN_SELF_TYPE_HEADER Sqrt();
+  SITK_RETURN_SELF_TYPE_HEADER Exp();
+  SITK_RETURN_SELF_TYPE_HEADER Log();
+  /** @} */
+
+  /** Remove all the operations. */
+  SITK_RETURN_SELF_TYPE_HEADER ClearOperations();
+
+  /** The number of operations in the expression. */
+  unsigned int GetNumberOfOperations() const;
+
+  /** Set/Get the output pixel type
+   *
+   * The output must be a vector pixel type when the input is a
+   * vector, and a scalar type otherwise.
+   * @{
+   */
+  SITK_RETURN_SELF_TYPE_HEADER SetOutputPixelType( PixelIDValueEnum pixelID );
+  PixelIDValueEnum GetOutputPixelType( ) const;
+  /** @} */
+
+  /** Name of this class */
+  std::string GetName() const override { return std::string ("PointwiseExpressionImageFilter"); }
+
+  // See super class for doxygen
+  std::string ToString() const override;
+
+  /** Evaluate the expression for each pixel of the input image. */
+  Image Execute ( const Image & );
+
+private:
+
+  enum OperationEnum
+  {
+    OperationAdd,
+    OperationMultiply,
+    OperationDivide,
+    OperationShiftScale,
+    OperationClamp,
+    OperationAbs,
+    OperationSquare,
+    OperationSqrt,
+    OperationExp,
+    OperationLog
+  };
+
+  struct Operation
+  {
+    OperationEnum m_Operation;
+    double        m_A;
+    double        m_B;
+  };
+
+  Self & AddOperation( OperationEnum op, double a = 0.0, double b = 0.0 );
+
+  /** Evaluate the operations for a contiguous range of the buffer
+   * elements. */
+  template <typename TInput, typename TOutput>
+  static void ApplyOperations( const TInput *input, TOutput *output, size_t n, const std::vector<Operation> &operations );
+
+  std::vector<Operation> m_Operations;
+
+  PixelIDValueEnum m_OutputPixelType;
+};
+
+}
+}
+#endif
@@ -0,0 +1,238 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkResampler_h
+#define sitkResampler_h
+
+#include "sitkBasicFilters.h"
+#include "sitkImage.h"
+#include "sitkTransform.h"
+#include "sitkInterpolator.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class Resampler
+ * \brief Resample or interpolate one image repeatedly, with the
+ * interpolator state computed once.
+ *
+ * The BSpline interpolators (sitkBSpline1 to sitkBSpline5) compute
+ * the BSpline coefficients of the whole image each time
+ * ResampleImageFilter is executed. The Resampler computes the
+ * coefficient image, of each component for vector images, when it is
+ * constructed, then each Execute only evaluates the coefficients on
+ * the output grid with the BSplineResampler interpolator of the same
+ * order. The results are the same as the ResampleImageFilter with the
+ * BSpline interpolator, up to rounding.
+ *
+ * The other interpolators have no precomputed state, and the
+ * Resampler uses them with the image directly.
+ *
+ * EvaluateAtPhysicalPoint and EvaluateAtPhysicalPoints interpolate
+ * from the same state, and return the same values as the methods of
+ * Image with the interpolator.
+ *
+ * The coefficients are computed from the image when the Resampler is
+ * constructed, later modifications of the image are not seen.
+ *
+ * \sa itk::simple::ResampleImageFilter
+ * \sa itk::simple::BSplineDecompositionImageFilter
+ */
+class SITKBasicFilters_EXPORT Resampler
+{
+public:
+  using Self = Resampler;
+
+  explicit Resampler( const Image &image, InterpolatorEnum interpolator = sitkLinear );
+
+  virtual ~Resampler();
+
+  /** Name of this class */
+  std::string GetName() const { return std::string ("Resampler"); }
+
+  std::string ToString() const;
+
+  /** The image and the interpolator this object was constructed with. */
+  const Image &GetImage() const;
+  InterpolatorEnum GetInterpolator() const;
+
+  /** Set/Get the value of the output pixels which map outside of the
+   * image. The default is 0.
+   * @{
+   */
+  SITK_RETURN_SELF_TYPE_HEADER SetDefaultPixelValue( double value );
+  double GetDefaultPixelValue() const;
+  /** @} */
+
+  /** Set/Get the pixel type of the resampled images. With sitkUnknown,
+   * the default, the output has the pixel type of the image.
+   * @{
+   */
+  SITK_RETURN_SELF_TYPE_HEADER SetOutputPixelType( PixelIDValueEnum pixelID );
+  PixelIDValueEnum GetOutputPixelType() const;
+  /** @} */
+
+  /** Resample the image onto the grid of referenceImage, or onto the
+   * specified grid, with the transform mapping the points of the
+   * output to the image.
+   * @{
+   */
+  Image Execute( const Transform &transform, const Image &referenceImage ) const;
+  Image Execute( const Transform &transform,
+                 const std::vector<uint32_t> &size,
+                 const std::vector<double> &outputOrigin,
+                 const std::vector<double> &outputSpacing,
+                 const std::vector<double> &outputDirection = std::vector<double>() ) const;
+  /** @} */
+
+  /** Interpolate the image at one physical point, or a flat array of
+   * physical points, as Image::EvaluateAtPhysicalPoint and
+   * Image::EvaluateAtPhysicalPoints. An exception is thrown if a
+   * point is out of the image.
+   * @{
+   */
+  std::vector<double> EvaluateAtPhysicalPoint( const std::vector<double> &point ) const;
+  std::vector<double> EvaluateAtPhysicalPoints( const std::vector<double> &points ) const;
+  /** @} */
+
+private:
+
+  Image m_Image;
+  InterpolatorEnum m_Interpolator;
+
+  // The images which are interpolated with m_ComponentInterpolator:
+  // the BSpline coefficients of each component of the image, or the
+  // image itself.
+  std::vector<Image> m_ComponentImages;
+  InterpolatorEnum m_ComponentInterpolator;
+
+  double m_DefaultPixelValue;
+  PixelIDValueEnum m_OutputPixelType;
+};
+
+/** \class JointResampler
+ * \brief Resample several images with the same transform in one pass.
+ *
+ * Each image is added with its own interpolator, default pixel value
+ * and output pixel type, for example linear for intensities and
+ * sitkNearestNeighbor or sitkLabelGaussian for labels. Execute maps
+ * the points of the output grid with the transform once, then each
+ * image is interpolated at the mapped points, the continuous indices
+ * being shared by the images with the same geometry. The pixels of a
+ * vector image are interpolated together, with their components
+ * contiguous.
+ *
+ * The output pixel values are the same as ResampleImageFilter, up to
+ * rounding, except that interpolators are not evaluated outside of
+ * the buffer of an image, so no extrapolator is used. The output is
+ * computed in blocks of pixels, so the temporary memory is bounded.
+ *
+ * Label, complex and vector images interpolated with other than
+ * sitkNearestNeighbor or sitkLinear are not supported.
+ *
+ * When UseMappingCache is enabled, the continuous indices of the
+ * output pixels in each image geometry, and which of them are inside
+ * of the images, are kept after Execute. A following Execute with the
+ * same transform and output grid then only interpolates the images,
+ * without evaluating the transform. The transform is the same while
+ * it is not modified, a modified copy of a Transform has its own ITK
+ * transform. The cache holds the dimension of the images doubles per
+ * output pixel, for each image geometry.
+ *
+ * \sa itk::simple::ResampleImageFilter
+ */
+class SITKBasicFilters_EXPORT JointResampler
+{
+public:
+  using Self = JointResampler;
+
+  JointResampler();
+
+  virtual ~JointResampler();
+
+  /** Name of this class */
+  std::string GetName() const { return std::string ("JointResampler"); }
+
+  std::string ToString() const;
+
+  /** Add an image resampled by Execute, with its interpolator, the
+   * value of the pixels mapped outside of it, and the pixel type of
+   * its output, sitkUnknown for the pixel type of the image. */
+  SITK_RETURN_SELF_TYPE_HEADER AddImage( const Image &image,
+                                         InterpolatorEnum interpolator = sitkLinear,
+                                         double defaultPixelValue = 0.0,
+                                         PixelIDValueEnum outputPixelType = sitkUnknown );
+
+  /** Remove all the images. */
+  SITK_RETURN_SELF_TYPE_HEADER ClearImages();
+
+  unsigned int GetNumberOfImages() const;
+
+  /** Set/Get keeping the mapping of the output grid by the transform
+   * for the following executions. The default is false.
+   * @{
+   */
+  SITK_RETURN_SELF_TYPE_HEADER SetUseMappingCache( bool useMappingCache );
+  bool GetUseMappingCache() const;
+  SITK_RETURN_SELF_TYPE_HEADER UseMappingCacheOn() { return this->SetUseMappingCache( true ); }
+  SITK_RETURN_SELF_TYPE_HEADER UseMappingCacheOff() { return this->SetUseMappingCache( false ); }
+  /** @} */
+
+  /** Release the cached mapping. */
+  SITK_RETURN_SELF_TYPE_HEADER ClearMappingCache();
+
+  /** Resample the images onto the grid of referenceImage, or onto the
+   * specified grid, with the transform mapping the points of the
+   * output to the images. The outputs are in the order the images were
+   * added.
+   * @{
+   */
+  std::vector<Image> Execute( const Transform &transform, const Image &referenceImage ) const;
+  std::vector<Image> Execute( const Transform &transform,
+                              const std::vector<uint32_t> &size,
+                              const std::vector<double> &outputOrigin,
+                              const std::vector<double> &outputSpacing,
+                              const std::vector<double> &outputDirection = std::vector<double>() ) const;
+  /** @} */
+
+private:
+
+  struct Entry
+  {
+    Image m_Image;
+    InterpolatorEnum m_Interpolator;
+    double m_DefaultPixelValue;
+    PixelIDValueEnum m_OutputPixelType;
+  };
+
+  std::vector<Entry> m_Entries;
+
+  struct Mapping;
+
+  bool m_UseMappingCache{false};
+  mutable std::shared_ptr<const Mapping> m_Mapping;
+};
+
+}
+}
+#endif
@@ -0,0 +1,139 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkResamplingOperator_h
+#define sitkResamplingOperator_h
+
+#include "sitkBasicFilters.h"
+#include "sitkImage.h"
+#include "sitkTransform.h"
+#include "sitkInterpolator.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class ResamplingOperator
+ * \brief The resampling of an image geometry onto a reference grid,
+ * as a sparse matrix of interpolation weights.
+ *
+ * The operator is computed once from a transform, the geometry of
+ * the images to resample, the grid of a reference image and an
+ * interpolator. Each output pixel is a row of the matrix, with the
+ * linear indices of the input pixels it is interpolated from and
+ * their weights. Execute then resamples any image with the input
+ * geometry as a weighted gather, on all the threads, without
+ * evaluating the transform or the interpolator. This suits pipelines
+ * with a fixed geometry, as the propagation of many labels or
+ * channels of an atlas.
+ *
+ * Only sitkNearestNeighbor and sitkLinear are supported, with the
+ * same results as the ResampleImageFilter, up to rounding. The output
+ * pixels mapped outside of the input have no weights, and are set to
+ * the default pixel value.
+ *
+ * The operator is written to and read from a binary file. The numbers
+ * are stored in the byte order of the host.
+ *
+ * \sa itk::simple::ResampleImageFilter
+ * \sa itk::simple::JointResampler
+ */
+class SITKBasicFilters_EXPORT ResamplingOperator
+{
+public:
+  using Self = ResamplingOperator;
+
+  /** An empty operator, of no pixels. */
+  ResamplingOperator();
+
+  /** Compute the operator resampling images with the geometry of
+   * inputImage onto the grid of referenceImage, with the transform
+   * mapping the points of the output to the input. Only the geometry
+   * of the images is used. */
+  ResamplingOperator( const Transform &transform,
+                      const Image &inputImage,
+                      const Image &referenceImage,
+                      InterpolatorEnum interpolator = sitkLinear );
+
+  virtual ~ResamplingOperator();
+
+  /** Name of this class */
+  std::string GetName() const { return std::string ("ResamplingOperator"); }
+
+  std::string ToString() const;
+
+  InterpolatorEnum GetInterpolator() const;
+
+  /** The geometry of the images resampled by the operator. */
+  std::vector<unsigned int> GetInputSize() const;
+  std::vector<double> GetInputOrigin() const;
+  std::vector<double> GetInputSpacing() const;
+  std::vector<double> GetInputDirection() const;
+
+  /** The grid of the resampled images. */
+  std::vector<unsigned int> GetOutputSize() const;
+  std::vector<double> GetOutputOrigin() const;
+  std::vector<double> GetOutputSpacing() const;
+  std::vector<double> GetOutputDirection() const;
+
+  /** The number of weights of the sparse matrix. */
+  uint64_t GetNumberOfWeights() const;
+
+  /** Resample an image with the input geometry of the operator. The
+   * output has the pixel type of the image when outputPixelType is
+   * sitkUnknown. The components of vector images are resampled
+   * independently. */
+  Image Execute( const Image &image,
+                 double defaultPixelValue = 0.0,
+                 PixelIDValueEnum outputPixelType = sitkUnknown ) const;
+
+  /** Write the operator to a file, or replace this operator with the
+   * one of a file written by WriteToFile.
+   * @{
+   */
+  void WriteToFile( const std::string &fileName ) const;
+  SITK_RETURN_SELF_TYPE_HEADER ReadFromFile( const std::string &fileName );
+  /** @} */
+
+private:
+
+  InterpolatorEnum m_Interpolator;
+
+  std::vector<unsigned int> m_InputSize;
+  std::vector<double> m_InputOrigin;
+  std::vector<double> m_InputSpacing;
+  std::vector<double> m_InputDirection;
+
+  std::vector<unsigned int> m_OutputSize;
+  std::vector<double> m_OutputOrigin;
+  std::vector<double> m_OutputSpacing;
+  std::vector<double> m_OutputDirection;
+
+  // the sparse matrix, in the compressed row format
+  std::vector<uint64_t> m_RowOffsets;
+  std::vector<uint64_t> m_Columns;
+  std::vector<double> m_Weights;
+};
+
+}
+}
+#endif
@@ -0,0 +1,95 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkVectorToPlanarImageFilter_h
+#define sitkVectorToPlanarImageFilter_h
+
+#include "sitkMacro.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkImage.h"
+#include "sitkBasicFilters.h"
+#include "sitkProcessObject.h"
+
+namespace itk {
+  namespace simple {
+
+    /** \class VectorToPlanarImageFilter
+     * \brief Copy the components of a vector image to the planes of a
+     * scalar image of one more dimension.
+     *
+     * A vector image stores the components of each pixel together. The
+     * output of this filter stores each component as a contiguous
+     * plane, with the component index as the last and slowest
+     * dimension, so that the NumPy array view of the output is in
+     * channel first order, (C,Y,X) for a 2D image and (C,Z,Y,X) for a
+     * 3D image. The buffer is copied in one parallel pass, instead of
+     * one pass for each component by the
+     * VectorIndexSelectionCastImageFilter followed by the
+     * JoinSeriesImageFilter.
+     *
+     * The first dimensions of the output have the geometry of the
+     * input, and the last dimension has an origin of 0 and a spacing
+     * of 1. Filters which process each plane on its own, like the
+     * slice by slice filters along the last dimension, can be used on
+     * the planar image, and PlanarToVectorImageFilter converts it back.
+     *
+     * \sa itk::simple::PlanarToVectorImageFilter
+     * \sa itk::simple::VectorToPlanar for the procedural interface
+     */
+    class SITKBasicFilters_EXPORT VectorToPlanarImageFilter
+      : public ProcessObject {
+    public:
+      using Self = VectorToPlanarImageFilter;
+
+      // function pointer type
+      typedef Image (Self::*MemberFunctionType)( const Image& );
+
+      // this filter works with the vector image types
+      using PixelIDTypeList = VectorPixelIDTypeList;
+
+      ~VectorToPlanarImageFilter() override;
+
+      VectorToPlanarImageFilter();
+
+      /** Name of this class */
+      std::string GetName() const override { return std::string ( "VectorToPlanar"); }
+
+      // Print ourselves out
+      std::string ToString() const override;
+
+      Image Execute ( const Image &image );
+
+    private:
+
+      template <class TImageType> Image ExecuteInternal ( const Image &image );
+
+      // friend to get access to executeInternal member
+      friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
+
+      std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+    };
+
+    /**
+     * \brief Copy the components of a vector image to the planes of a
+     * scalar image of one more dimension.
+     *
+     * \sa itk::simple::VectorToPlanarImageFilter for the object oriented interface
+     */
+    SITKBasicFilters_EXPORT Image VectorToPlanar ( const Image &image );
+  }
+}
+#endif
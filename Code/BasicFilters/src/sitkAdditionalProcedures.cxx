@@ -153,13 +153,19 @@ SITKBasicFilters_EXPORT Image PatchBasedDenoising (const Image& image1,
 //
 // Function to run the Execute method of this filter
 //
-Image DiscreteGaussian ( const Image& image1, double variance, unsigned int maximumKernelWidth, double maximumError, bool useImageSpacing )
+Image DiscreteGaussian ( const Image& image1,
+                         double variance,
+                         unsigned int maximumKernelWidth,
+                         double maximumError,
+                         bool useImageSpacing,
+                         DiscreteGaussianImageFilter::AlgorithmType algorithm )
 {
   DiscreteGaussianImageFilter filter;
   filter.SetVariance(variance);
   filter.SetMaximumKernelWidth(maximumKernelWidth);
   filter.SetMaximumError(maximumError);
   filter.SetUseImageSpacing(useImageSpacing);
+  filter.SetAlgorithm(algorithm);
   return filter.Execute ( image1 );
 }
 
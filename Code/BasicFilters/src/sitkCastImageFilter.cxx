@@ -16,13 +16,153 @@
 *
 *=========================================================================*/
 #include "sitkCastImageFilter.h"
+#include "sitkComponentPixelType.h"
+#include "sitkInstructionSet.h"
+#include "sitkTemplateFunctions.h"
 
+#include "itkMultiThreaderBase.h"
+#include "itkProcessObject.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
 
 namespace itk
 {
 namespace simple
 {
 
+namespace
+{
+
+// The number of components converted by a work unit.
+constexpr size_t BlockSize = 64 * 1024;
+
+// The lowest and the maximum values of TInput which are in the range
+// of the integer TOutput.
+template <typename TInput, typename TOutput>
+typename std::enable_if<std::is_integral<TInput>::value, TInput>::type
+SaturationLowest()
+{
+  if ( !std::is_signed<TInput>::value || !std::is_signed<TOutput>::value )
+    {
+    return 0;
+    }
+  return ( static_cast<intmax_t>( std::numeric_limits<TOutput>::lowest() ) > static_cast<intmax_t>( std::numeric_limits<TInput>::lowest() ) )
+    ? static_cast<TInput>( std::numeric_limits<TOutput>::lowest() ) : std::numeric_limits<TInput>::lowest();
+}
+
+template <typename TInput, typename TOutput>
+typename std::enable_if<std::is_integral<TInput>::value, TInput>::type
+SaturationMaximum()
+{
+  return ( static_cast<uintmax_t>( std::numeric_limits<TOutput>::max() ) < static_cast<uintmax_t>( std::numeric_limits<TInput>::max() ) )
+    ? static_cast<TInput>( std::numeric_limits<TOutput>::max() ) : std::numeric_limits<TInput>::max();
+}
+
+// The lowest integer and the maximum plus one are powers of 2 which
+// are exactly represented, and the maximum is rounded down to a
+// represented value.
+template <typename TInput, typename TOutput>
+typename std::enable_if<std::is_floating_point<TInput>::value, TInput>::type
+SaturationLowest()
+{
+  return static_cast<TInput>( std::numeric_limits<TOutput>::lowest() );
+}
+
+template <typename TInput, typename TOutput>
+typename std::enable_if<std::is_floating_point<TInput>::value, TInput>::type
+SaturationMaximum()
+{
+  const TInput limit = static_cast<TInput>( std::numeric_limits<TOutput>::max() / 2 + 1 ) * TInput( 2 );
+  TInput maximum = static_cast<TInput>( std::numeric_limits<TOutput>::max() );
+  while ( maximum >= limit )
+    {
+    maximum = std::nextafter( maximum, TInput( 0 ) );
+    }
+  return maximum;
+}
+
+template <typename TInput, typename TOutput>
+void Convert( const TInput * input, TOutput * output, size_t n, std::false_type )
+{
+  for ( size_t i = 0; i < n; ++i )
+    {
+    output[i] = static_cast<TOutput>( input[i] );
+    }
+}
+
+template <typename TInput, typename TOutput>
+void Convert( const TInput * input, TOutput * output, size_t n, std::true_type )
+{
+  const TInput lowest = SaturationLowest<TInput, TOutput>();
+  const TInput maximum = SaturationMaximum<TInput, TOutput>();
+  for ( size_t i = 0; i < n; ++i )
+    {
+    const TInput v = input[i];
+    // NaN is the only value which is not equal to itself
+    const TInput clamped = ( v < lowest ) ? lowest : ( ( v > maximum ) ? maximum : ( v == v ? v : TInput( 0 ) ) );
+    output[i] = static_cast<TOutput>( clamped );
+    }
+}
+
+// An ITK process object converting the blocks of the buffers, so the
+// conversion invokes the events of the commands, and is measured and
+// cancelled as the ITK filters are.
+class ConvertBufferProcess
+  : public itk::ProcessObject
+{
+public:
+  using Self = ConvertBufferProcess;
+  using Superclass = itk::ProcessObject;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ConvertBufferProcess, ProcessObject);
+
+  void Convert( const itk::DataObject *input, itk::DataObject *output,
+                size_t numberOfBlocks, const std::function<void(size_t)> &convertBlock )
+  {
+    // the images are referenced for the measurements and the log
+    this->SetNthInput( 0, const_cast<itk::DataObject *>( input ) );
+    this->SetNthOutput( 0, output );
+
+    this->InvokeEvent( itk::StartEvent() );
+    this->UpdateProgress( 0.0f );
+    try
+      {
+      this->GetMultiThreader()->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+      this->GetMultiThreader()->ParallelizeArray( 0, numberOfBlocks,
+                                                  [this, &convertBlock]( itk::SizeValueType block ) {
+                                                    if ( !this->GetAbortGenerateData() )
+                                                      {
+                                                      convertBlock( block );
+                                                      }
+                                                  },
+                                                  this );
+      if ( this->GetAbortGenerateData() )
+        {
+        throw itk::ProcessAborted( __FILE__, __LINE__ );
+        }
+      }
+    catch ( itk::ProcessAborted & )
+      {
+      this->InvokeEvent( itk::AbortEvent() );
+      throw;
+      }
+    this->UpdateProgress( 1.0f );
+    this->InvokeEvent( itk::EndEvent() );
+  }
+
+protected:
+  ConvertBufferProcess() = default;
+  ~ConvertBufferProcess() override = default;
+};
+
+}
+
 
 //----------------------------------------------------------------------------
 
@@ -56,7 +196,8 @@ std::string CastImageFilter::ToString() const
 {
   std::ostringstream out;
   out << "itk::simple::CastImageFilter\n"
-      << "\tOutputPixelType: " << this->m_OutputPixelType << std::endl;
+      << "\tOutputPixelType: " << this->m_OutputPixelType << std::endl
+      << "\tSaturate: " << this->m_Saturate << std::endl;
   out << ProcessObject::ToString();
   return out.str();
 }
@@ -76,6 +217,17 @@ PixelIDValueEnum CastImageFilter::GetOutputPixelType( ) const
   return this->m_OutputPixelType;
 }
 
+CastImageFilter::Self& CastImageFilter::SetSaturate( bool saturate )
+{
+  this->m_Saturate = saturate;
+  return *this;
+}
+
+bool CastImageFilter::GetSaturate( ) const
+{
+  return this->m_Saturate;
+}
+
 
 //
 // Execute
@@ -87,6 +239,18 @@ Image CastImageFilter::Execute ( const Image& image )
   const PixelIDValueEnum outputType = this->m_OutputPixelType;
   const unsigned int dimension = image.GetDimension();
 
+  // the conversion is the identity, so the buffer is shared instead of copied
+  if ( inputType == outputType )
+    {
+    return this->ExecuteShare( image );
+    }
+
+  Image output;
+  if ( this->ExecuteConvert( image, output ) )
+    {
+    return output;
+    }
+
   if (this->m_DualMemberFactory->HasMemberFunction( inputType, outputType,  dimension ) )
     {
     return this->m_DualMemberFactory->GetMemberFunction( inputType, outputType, dimension )( image );
@@ -98,6 +262,96 @@ Image CastImageFilter::Execute ( const Image& image )
 }
 
 
+Image CastImageFilter::ExecuteShare( const Image & image )
+{
+  Image output = image;
+  if ( !ProcessObject::GetGlobalMetaDataPropagation() )
+    {
+    for ( const std::string & key : output.GetMetaDataKeys() )
+      {
+      output.EraseMetaData( key );
+      }
+    }
+
+  // the commands, the cancellation and the measurements apply as to
+  // a conversion of no blocks
+  ConvertBufferProcess::Pointer process = ConvertBufferProcess::New();
+  this->PreUpdate( process.GetPointer() );
+  const itk::DataObject *outputData = static_cast<const Image &>( output ).GetITKBase();
+  process->Convert( image.GetITKBase(), const_cast<itk::DataObject *>( outputData ), 0, []( size_t ) {} );
+  return output;
+}
+
+
+bool CastImageFilter::ExecuteConvert( const Image & image, Image & output )
+{
+  bool inputIsVector = false;
+  bool outputIsVector = false;
+  const PixelIDValueEnum inputComponentID = GetComponentPixelID( image.GetPixelID(), inputIsVector );
+  const PixelIDValueEnum outputComponentID = GetComponentPixelID( this->m_OutputPixelType, outputIsVector );
+
+  // a vector image is not converted to a scalar image
+  if ( inputComponentID == sitkUnknown || outputComponentID == sitkUnknown || ( inputIsVector && !outputIsVector ) )
+    {
+    return false;
+    }
+
+  // a scalar is converted to a vector of one component
+  const unsigned int numberOfComponents = image.GetNumberOfComponentsPerPixel();
+  output = Image( image.GetSize(), this->m_OutputPixelType, outputIsVector ? numberOfComponents : 0 );
+  output.CopyInformation( image );
+  if ( ProcessObject::GetGlobalMetaDataPropagation() )
+    {
+    output.CopyMetaData( image );
+    }
+
+  const size_t n = static_cast<size_t>( image.GetNumberOfPixels() ) * numberOfComponents;
+  const size_t numberOfBlocks = ( n + BlockSize - 1 ) / BlockSize;
+  itk::DataObject *outputData = output.GetITKBase();
+  const void *inputBuffer = image.GetBufferAsVoid();
+  void *outputBuffer = output.GetBufferAsVoid();
+
+  // the threads, the executor and the commands are set as for an ITK filter
+  ConvertBufferProcess::Pointer process = ConvertBufferProcess::New();
+  this->PreUpdate( process.GetPointer() );
+
+  sitkDebugMacro( "Converting " << n << " components from " << GetPixelIDValueAsString( inputComponentID )
+                  << " to " << GetPixelIDValueAsString( outputComponentID ) << " with "
+                  << process->GetMultiThreader()->GetMaximumNumberOfThreads() << " threads." );
+
+  InvokeWithComponentType( inputComponentID, [&]( auto inputTag ) {
+    using InputType = decltype( inputTag );
+    InvokeWithComponentType( outputComponentID, [&]( auto outputTag ) {
+      using OutputType = decltype( outputTag );
+
+      const auto *input = static_cast<const InputType *>( inputBuffer );
+      auto *output = static_cast<OutputType *>( outputBuffer );
+
+      // the floating point outputs are not saturated
+      const bool saturate = this->m_Saturate;
+      auto convertBlock = [=]( size_t block ) {
+        const size_t start = block * BlockSize;
+        const size_t count = std::min( BlockSize, n - start );
+        detail::InvokeWithInstructionSet( [=] {
+          if ( saturate )
+            {
+            Convert( input + start, output + start, count, std::integral_constant<bool, std::is_integral<OutputType>::value>() );
+            }
+          else
+            {
+            Convert( input + start, output + start, count, std::false_type() );
+            }
+        } );
+      };
+
+      process->Convert( image.GetITKBase(), outputData, numberOfBlocks, convertBlock );
+      } );
+    } );
+
+  return true;
+}
+
+
 //----------------------------------------------------------------------------
 
 
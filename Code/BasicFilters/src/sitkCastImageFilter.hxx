@@ -24,8 +24,8 @@
 #include "sitkCastImageFilter.h"
 
 #include <itkComposeImageFilter.h>
-#include <itkLabelImageToLabelMapFilter.h>
-#include <itkLabelMapToLabelImageFilter.h>
+#include "itkParallelLabelImageToLabelMapFilter.h"
+#include "itkParallelLabelMapToLabelImageFilter.h"
 
 namespace itk
 {
@@ -97,7 +97,7 @@ Image CastImageFilter::ExecuteInternalToLabel( const Image& inImage )
 
   typename InputImageType::ConstPointer image = this->CastImageToITK<InputImageType>( inImage );
 
-  using FilterType = itk::LabelImageToLabelMapFilter<InputImageType, OutputImageType>;
+  using FilterType = itk::ParallelLabelImageToLabelMapFilter<InputImageType, OutputImageType>;
   typename FilterType::Pointer filter = FilterType::New();
   filter->SetInput ( image );
 
@@ -118,7 +118,7 @@ Image CastImageFilter::ExecuteInternalLabelToImage( const Image& inImage )
   typename InputImageType::ConstPointer image = this->CastImageToITK<InputImageType>( inImage );
 
 
-  using FilterType = itk::LabelMapToLabelImageFilter<InputImageType, OutputImageType>;
+  using FilterType = itk::ParallelLabelMapToLabelImageFilter<InputImageType, OutputImageType>;
   typename FilterType::Pointer filter = FilterType::New();
   filter->SetInput ( image );
 
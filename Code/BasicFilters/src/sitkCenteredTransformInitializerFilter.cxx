@@ -27,9 +27,11 @@
 
 #include "sitkCenteredTransformInitializerFilter.h"
 #include "itkCenteredTransformInitializer.h"
+#include "itkParallelImageMomentsCalculator.h"
 
 // Additional include files
 #include "sitkTransform.h"
+#include <limits>
 // Done with additional include files
 
 namespace itk {
@@ -44,6 +46,8 @@ CenteredTransformInitializerFilter::CenteredTransformInitializerFilter ()
 {
 
     this->m_OperationMode = itk::simple::CenteredTransformInitializerFilter::MOMENTS;
+    this->m_MomentsSamplingFactor = 1u;
+    this->m_MomentsLowerThreshold = std::numeric_limits<double>::lowest();
 
   this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
 
@@ -67,6 +71,8 @@ std::string CenteredTransformInitializerFilter::ToString() const
   out << "  OperationMode: ";
   this->ToStringHelper(out, this->m_OperationMode);
   out << std::endl;
+  out << "  MomentsSamplingFactor: " << this->m_MomentsSamplingFactor << std::endl;
+  out << "  MomentsLowerThreshold: " << this->m_MomentsLowerThreshold << std::endl;
 
   out << ProcessObject::ToString();
   return out.str();
@@ -137,15 +143,39 @@ Transform CenteredTransformInitializerFilter::ExecuteInternal ( const Image * in
 
   if (m_OperationMode == MOMENTS)
     {
-    filter->MomentsOn();
+    // the centers of mass with all the threads, as the
+    // ImageMomentsCalculator of the ITK initializer
+    using CalculatorType = itk::ParallelImageMomentsCalculator<TImageType>;
+    auto centerOfGravity = [this]( const TImageType *image )
+      {
+        typename CalculatorType::Pointer calculator = CalculatorType::New();
+        calculator->SetImage( image );
+        calculator->SetSamplingFactor( this->m_MomentsSamplingFactor );
+        calculator->SetLowerThreshold( this->m_MomentsLowerThreshold );
+        calculator->SetNumberOfWorkUnits( this->GetNumberOfThreads() );
+        calculator->Compute();
+        return calculator->GetCenterOfGravity();
+      };
+    const typename CalculatorType::VectorType fixedCenter = centerOfGravity( filter->GetFixedImage() );
+    const typename CalculatorType::VectorType movingCenter = centerOfGravity( image2.GetPointer() );
+
+    typename TransformType::InputPointType rotationCenter;
+    typename TransformType::OutputVectorType translationVector;
+    for ( unsigned int i = 0; i < TImageType::ImageDimension; ++i )
+      {
+      rotationCenter[i] = fixedCenter[i];
+      translationVector[i] = movingCenter[i] - fixedCenter[i];
+      }
+    auto *transform = const_cast<typename FilterType::TransformType*>(itkTx);
+    transform->SetCenter( rotationCenter );
+    transform->SetTranslation( translationVector );
     }
   else
     {
     filter->GeometryOn();
+    filter->InitializeTransform();
     }
 
-  filter->InitializeTransform();
-
   return copyTransform;
 }
 
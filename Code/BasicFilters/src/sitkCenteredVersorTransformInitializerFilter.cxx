@@ -28,9 +28,11 @@
 #include "itkVersorRigid3DTransform.h"
 #include "sitkCenteredVersorTransformInitializerFilter.h"
 #include "itkCenteredVersorTransformInitializer.h"
+#include "itkParallelImageMomentsCalculator.h"
 
 // Additional include files
 #include "sitkTransform.h"
+#include <limits>
 // Done with additional include files
 
 namespace itk {
@@ -45,6 +47,8 @@ CenteredVersorTransformInitializerFilter::CenteredVersorTransformInitializerFilt
 {
 
   this->m_ComputeRotation = false;
+  this->m_MomentsSamplingFactor = 1u;
+  this->m_MomentsLowerThreshold = std::numeric_limits<double>::lowest();
 
   this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
 
@@ -68,6 +72,8 @@ std::string CenteredVersorTransformInitializerFilter::ToString() const
   out << "  ComputeRotation: ";
   this->ToStringHelper(out, this->m_ComputeRotation);
   out << std::endl;
+  out << "  MomentsSamplingFactor: " << this->m_MomentsSamplingFactor << std::endl;
+  out << "  MomentsLowerThreshold: " << this->m_MomentsLowerThreshold << std::endl;
 
   out << ProcessObject::ToString();
   return out.str();
@@ -134,9 +140,43 @@ Transform CenteredVersorTransformInitializerFilter::ExecuteInternal ( const Imag
   else { filter->SetTransform( const_cast<typename FilterType::TransformType*>(itkTx) ); }
 
 
-  filter->SetComputeRotation ( this->m_ComputeRotation );
+  // the moments with all the threads, as the ImageMomentsCalculator
+  // of the ITK initializer
+  using CalculatorType = itk::ParallelImageMomentsCalculator<TImageType>;
+  auto computeMoments = [this]( const TImageType *image )
+    {
+      typename CalculatorType::Pointer calculator = CalculatorType::New();
+      calculator->SetImage( image );
+      calculator->SetSamplingFactor( this->m_MomentsSamplingFactor );
+      calculator->SetLowerThreshold( this->m_MomentsLowerThreshold );
+      calculator->SetNumberOfWorkUnits( this->GetNumberOfThreads() );
+      calculator->Compute();
+      return calculator;
+    };
+  const typename CalculatorType::Pointer fixedMoments = computeMoments( filter->GetFixedImage() );
+  const typename CalculatorType::Pointer movingMoments = computeMoments( image2.GetPointer() );
+
+  typename FilterType::TransformType::InputPointType rotationCenter;
+  typename FilterType::TransformType::OutputVectorType translationVector;
+  for ( unsigned int i = 0; i < TImageType::ImageDimension; ++i )
+    {
+    rotationCenter[i] = fixedMoments->GetCenterOfGravity()[i];
+    translationVector[i] = movingMoments->GetCenterOfGravity()[i] - fixedMoments->GetCenterOfGravity()[i];
+    }
+  auto *transform = const_cast<typename FilterType::TransformType*>(itkTx);
+  transform->SetCenter( rotationCenter );
+  transform->SetTranslation( translationVector );
 
-  filter->InitializeTransform();
+  if ( this->m_ComputeRotation )
+    {
+    // the rotation of the principal axes of the fixed image to those of
+    // the moving image
+    using AxesMatrixType = typename CalculatorType::MatrixType;
+    const AxesMatrixType fixedPrincipalAxes = fixedMoments->GetPrincipalAxes().GetTranspose();
+    const AxesMatrixType movingPrincipalAxes = movingMoments->GetPrincipalAxes().GetTranspose();
+    const AxesMatrixType rotationMatrix = movingPrincipalAxes * fixedPrincipalAxes.GetInverse();
+    transform->SetMatrix( rotationMatrix );
+    }
 
   return copyTransform;
 }
@@ -0,0 +1,82 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkComponentPixelType_h
+#define sitkComponentPixelType_h
+
+#include "sitkPixelIDValues.h"
+#include "sitkMacro.h"
+
+#include <cstdint>
+
+namespace itk
+{
+
+namespace simple
+{
+
+// Get the pixel ID of the components of a scalar or vector pixel
+// type, or sitkUnknown if not supported.
+inline PixelIDValueEnum GetComponentPixelID( PixelIDValueEnum pixelID, bool &isVector )
+{
+  const PixelIDValueEnum scalars[] = { sitkUInt8, sitkInt8, sitkUInt16, sitkInt16, sitkUInt32, sitkInt32,
+                                       sitkUInt64, sitkInt64, sitkFloat32, sitkFloat64 };
+  const PixelIDValueEnum vectors[] = { sitkVectorUInt8, sitkVectorInt8, sitkVectorUInt16, sitkVectorInt16,
+                                       sitkVectorUInt32, sitkVectorInt32, sitkVectorUInt64, sitkVectorInt64,
+                                       sitkVectorFloat32, sitkVectorFloat64 };
+  for ( unsigned int i = 0; i < sizeof(scalars)/sizeof(scalars[0]); ++i )
+    {
+    if ( scalars[i] != sitkUnknown && pixelID == scalars[i] )
+      {
+      isVector = false;
+      return scalars[i];
+      }
+    if ( vectors[i] != sitkUnknown && pixelID == vectors[i] )
+      {
+      isVector = true;
+      return scalars[i];
+      }
+    }
+  isVector = false;
+  return sitkUnknown;
+}
+
+// Invoke f with a value of the C++ type of a scalar pixel ID.
+template <typename TFunction>
+void InvokeWithComponentType( PixelIDValueEnum componentID, TFunction && f )
+{
+  switch ( componentID )
+    {
+    case sitkUInt8: f( uint8_t() ); break;
+    case sitkInt8: f( int8_t() ); break;
+    case sitkUInt16: f( uint16_t() ); break;
+    case sitkInt16: f( int16_t() ); break;
+    case sitkUInt32: f( uint32_t() ); break;
+    case sitkInt32: f( int32_t() ); break;
+    case sitkUInt64: f( uint64_t() ); break;
+    case sitkInt64: f( int64_t() ); break;
+    case sitkFloat32: f( float() ); break;
+    case sitkFloat64: f( double() ); break;
+    default:
+      sitkExceptionMacro( "Unsupported component pixel type: " << GetPixelIDValueAsString( componentID ) );
+    }
+}
+
+}
+}
+
+#endif // sitkComponentPixelType_h
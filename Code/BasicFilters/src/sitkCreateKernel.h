@@ -66,6 +66,74 @@ CreateKernel( KernelEnum kernelType, const std::vector<uint32_t> &size )
 }
 
 
+/** Set the algorithm of a grayscale morphology filter, unless it is
+ * automatic, so the filter keeps the one it selected for its kernel:
+ * the anchor algorithm for the decomposable boxes and polygons, and
+ * the histogram or basic algorithm for the others.
+ */
+template< typename TFilter, typename TAlgorithm >
+void
+SetMorphologyAlgorithm( TFilter *filter, TAlgorithm algorithm )
+{
+  using AlgorithmEnum = typename TFilter::AlgorithmEnum;
+
+  switch ( algorithm )
+    {
+    case TAlgorithm::Automatic:
+      return;
+    case TAlgorithm::Basic:
+      filter->SetAlgorithm( AlgorithmEnum::BASIC );
+      return;
+    case TAlgorithm::Histogram:
+      filter->SetAlgorithm( AlgorithmEnum::HISTO );
+      return;
+    case TAlgorithm::Anchor:
+      filter->SetAlgorithm( AlgorithmEnum::ANCHOR );
+      return;
+    case TAlgorithm::VanHerkGilWerman:
+      filter->SetAlgorithm( AlgorithmEnum::VHGW );
+      return;
+    default:
+      sitkExceptionMacro( "Logic Error: Unknown Morphology Algorithm" );
+    }
+}
+
+
+/** The smallest radius of a ball for which the automatic algorithm of
+ * the binary morphology is the distance map. */
+constexpr uint32_t BinaryMorphologyDistanceMapMinimumRadius = 5;
+
+/** Whether the binary morphology uses the distance map of the image
+ * instead of the structuring element, which requires a ball with the
+ * same radius in all the dimensions.
+ */
+template< unsigned int VImageDimension, typename TAlgorithm >
+bool
+UseBinaryMorphologyDistanceMap( TAlgorithm algorithm, KernelEnum kernelType, const std::vector<uint32_t> &radius )
+{
+  if ( algorithm == TAlgorithm::StructuringElement )
+    {
+    return false;
+    }
+
+  bool isotropicBall = ( kernelType == sitkBall && radius.size() >= VImageDimension );
+  for ( unsigned int d = 1; isotropicBall && d < VImageDimension; ++d )
+    {
+    isotropicBall = ( radius[d] == radius[0] );
+    }
+
+  if ( algorithm == TAlgorithm::DistanceMap )
+    {
+    if ( !isotropicBall )
+      {
+      sitkExceptionMacro( "The distance map algorithm requires a ball kernel with the same radius in all the dimensions." );
+      }
+    return true;
+    }
+  return isotropicBall && radius[0] >= BinaryMorphologyDistanceMapMinimumRadius;
+}
+
+
 } // end namespace simple
 } // end namespace itk
 
@@ -0,0 +1,153 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkFFTConfiguration.h"
+
+#include "itkConfigure.h"
+
+#if defined( ITK_USE_FFTWF ) || defined( ITK_USE_FFTWD )
+#include "itkFFTWGlobalConfiguration.h"
+#endif
+
+#include <set>
+
+namespace itk
+{
+namespace simple
+{
+
+#if defined( ITK_USE_FFTWF ) || defined( ITK_USE_FFTWD )
+
+bool HasFFTW()
+{
+  return true;
+}
+
+bool SetGlobalDefaultFFTPlanRigor( const std::string &rigor )
+{
+  static const std::set<std::string> names = { "FFTW_ESTIMATE", "FFTW_MEASURE", "FFTW_PATIENT", "FFTW_EXHAUSTIVE" };
+  if ( names.count( rigor ) == 0 )
+    {
+    return false;
+    }
+  itk::FFTWGlobalConfiguration::SetPlanRigor( itk::FFTWGlobalConfiguration::GetPlanRigorValue( rigor ) );
+  return true;
+}
+
+std::string GetGlobalDefaultFFTPlanRigor()
+{
+  return itk::FFTWGlobalConfiguration::GetPlanRigorName( itk::FFTWGlobalConfiguration::GetPlanRigor() );
+}
+
+void SetGlobalFFTWisdomCacheDirectory( const std::string &directory )
+{
+  itk::FFTWGlobalConfiguration::SetWisdomCacheBase( directory );
+}
+
+std::string GetGlobalFFTWisdomCacheDirectory()
+{
+  return itk::FFTWGlobalConfiguration::GetWisdomCacheBase();
+}
+
+void SetGlobalFFTReadWisdomCache( bool read )
+{
+  itk::FFTWGlobalConfiguration::SetReadWisdomCache( read );
+}
+
+bool GetGlobalFFTReadWisdomCache()
+{
+  return itk::FFTWGlobalConfiguration::GetReadWisdomCache();
+}
+
+void SetGlobalFFTWriteWisdomCache( bool write )
+{
+  itk::FFTWGlobalConfiguration::SetWriteWisdomCache( write );
+}
+
+bool GetGlobalFFTWriteWisdomCache()
+{
+  return itk::FFTWGlobalConfiguration::GetWriteWisdomCache();
+}
+
+bool ImportFFTWisdom()
+{
+  return itk::FFTWGlobalConfiguration::ImportDefaultWisdomFile();
+}
+
+bool ExportFFTWisdom()
+{
+  return itk::FFTWGlobalConfiguration::ExportDefaultWisdomFile();
+}
+
+#else
+
+bool HasFFTW()
+{
+  return false;
+}
+
+bool SetGlobalDefaultFFTPlanRigor( const std::string & )
+{
+  return false;
+}
+
+std::string GetGlobalDefaultFFTPlanRigor()
+{
+  return std::string();
+}
+
+void SetGlobalFFTWisdomCacheDirectory( const std::string & )
+{
+}
+
+std::string GetGlobalFFTWisdomCacheDirectory()
+{
+  return std::string();
+}
+
+void SetGlobalFFTReadWisdomCache( bool )
+{
+}
+
+bool GetGlobalFFTReadWisdomCache()
+{
+  return false;
+}
+
+void SetGlobalFFTWriteWisdomCache( bool )
+{
+}
+
+bool GetGlobalFFTWriteWisdomCache()
+{
+  return false;
+}
+
+bool ImportFFTWisdom()
+{
+  return false;
+}
+
+bool ExportFFTWisdom()
+{
+  return false;
+}
+
+#endif
+
+} // end namespace simple
+} // end namespace itk
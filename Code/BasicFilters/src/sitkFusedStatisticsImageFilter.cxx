@@ -0,0 +1,319 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+
+#include "sitkFusedStatisticsImageFilter.h"
+#include "sitkTemplateFunctions.h"
+#include "itkFusedStatisticsImageFilter.h"
+
+#include "itkHuangThresholdCalculator.h"
+#include "itkIntermodesThresholdCalculator.h"
+#include "itkIsoDataThresholdCalculator.h"
+#include "itkKittlerIllingworthThresholdCalculator.h"
+#include "itkLiThresholdCalculator.h"
+#include "itkMaximumEntropyThresholdCalculator.h"
+#include "itkMomentsThresholdCalculator.h"
+#include "itkOtsuThresholdCalculator.h"
+#include "itkRenyiEntropyThresholdCalculator.h"
+#include "itkShanbhagThresholdCalculator.h"
+#include "itkTriangleThresholdCalculator.h"
+#include "itkYenThresholdCalculator.h"
+
+#include <limits>
+
+namespace itk {
+  namespace simple {
+
+    namespace
+    {
+    using HistogramType = itk::Statistics::Histogram<double>;
+
+    template <template <typename, typename> class TCalculator>
+    double ComputeHistogramThreshold ( const HistogramType *histogram )
+    {
+      using CalculatorType = TCalculator<HistogramType, double>;
+      typename CalculatorType::Pointer calculator = CalculatorType::New();
+      calculator->SetInput( histogram );
+      calculator->Update();
+      return calculator->GetThreshold();
+    }
+    }
+
+    FusedStatisticsImageFilter::~FusedStatisticsImageFilter ()
+    = default;
+
+    FusedStatisticsImageFilter::FusedStatisticsImageFilter ()
+      : m_NumberOfHistogramBins( 256 ),
+        m_HistogramOversampling( 16 ),
+        m_AutoMinimumMaximum( true ),
+        m_HistogramMinimum( 0.0 ),
+        m_HistogramMaximum( 0.0 ),
+        m_Minimum( std::numeric_limits<double>::quiet_NaN() ),
+        m_Maximum( std::numeric_limits<double>::quiet_NaN() ),
+        m_Mean( std::numeric_limits<double>::quiet_NaN() ),
+        m_Variance( std::numeric_limits<double>::quiet_NaN() ),
+        m_Sigma( std::numeric_limits<double>::quiet_NaN() ),
+        m_Sum( 0.0 ),
+        m_Count( 0 )
+    {
+      this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2, SITK_MAX_DIMENSION > ();
+    }
+
+    std::string FusedStatisticsImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::FusedStatisticsImageFilter" << std::endl;
+      out << "  NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+      out << "  HistogramOversampling: " << this->m_HistogramOversampling << std::endl;
+      out << "  AutoMinimumMaximum: " << this->m_AutoMinimumMaximum << std::endl;
+      out << "  HistogramMinimum: " << this->m_HistogramMinimum << std::endl;
+      out << "  HistogramMaximum: " << this->m_HistogramMaximum << std::endl;
+      out << "  Quantiles: " << this->m_Quantiles << std::endl;
+      out << "  Minimum: " << this->m_Minimum << std::endl;
+      out << "  Maximum: " << this->m_Maximum << std::endl;
+      out << "  Mean: " << this->m_Mean << std::endl;
+      out << "  Variance: " << this->m_Variance << std::endl;
+      out << "  Sigma: " << this->m_Sigma << std::endl;
+      out << "  Sum: " << this->m_Sum << std::endl;
+      out << "  Count: " << this->m_Count << std::endl;
+      out << "  QuantileValues: " << this->m_QuantileValues << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    FusedStatisticsImageFilter& FusedStatisticsImageFilter::SetNumberOfHistogramBins ( uint32_t numberOfHistogramBins )
+      {
+      this->m_NumberOfHistogramBins = numberOfHistogramBins;
+      return *this;
+      }
+
+    uint32_t FusedStatisticsImageFilter::GetNumberOfHistogramBins () const
+    {
+      return this->m_NumberOfHistogramBins;
+    }
+
+    FusedStatisticsImageFilter& FusedStatisticsImageFilter::SetHistogramOversampling ( uint32_t histogramOversampling )
+      {
+      this->m_HistogramOversampling = histogramOversampling;
+      return *this;
+      }
+
+    uint32_t FusedStatisticsImageFilter::GetHistogramOversampling () const
+    {
+      return this->m_HistogramOversampling;
+    }
+
+    FusedStatisticsImageFilter& FusedStatisticsImageFilter::SetAutoMinimumMaximum ( bool autoMinimumMaximum )
+      {
+      this->m_AutoMinimumMaximum = autoMinimumMaximum;
+      return *this;
+      }
+
+    bool FusedStatisticsImageFilter::GetAutoMinimumMaximum () const
+    {
+      return this->m_AutoMinimumMaximum;
+    }
+
+    FusedStatisticsImageFilter& FusedStatisticsImageFilter::SetHistogramMinimum ( double histogramMinimum )
+      {
+      this->m_HistogramMinimum = histogramMinimum;
+      return *this;
+      }
+
+    double FusedStatisticsImageFilter::GetHistogramMinimum () const
+    {
+      return this->m_HistogramMinimum;
+    }
+
+    FusedStatisticsImageFilter& FusedStatisticsImageFilter::SetHistogramMaximum ( double histogramMaximum )
+      {
+      this->m_HistogramMaximum = histogramMaximum;
+      return *this;
+      }
+
+    double FusedStatisticsImageFilter::GetHistogramMaximum () const
+    {
+      return this->m_HistogramMaximum;
+    }
+
+    FusedStatisticsImageFilter& FusedStatisticsImageFilter::SetQuantiles ( const std::vector<double> &quantiles )
+      {
+      for ( double p : quantiles )
+        {
+        if ( !( p >= 0.0 && p <= 1.0 ) )
+          {
+          sitkExceptionMacro( "The quantile " << p << " is not between 0 and 1!" );
+          }
+        }
+      this->m_Quantiles = quantiles;
+      return *this;
+      }
+
+    std::vector<double> FusedStatisticsImageFilter::GetQuantiles () const
+    {
+      return this->m_Quantiles;
+    }
+
+    void FusedStatisticsImageFilter::Execute ( const Image& image )
+    {
+      PixelIDValueEnum type = image.GetPixelID();
+      unsigned int dimension = image.GetDimension();
+
+      this->m_MemberFactory->GetMemberFunction( type, dimension )( image, nullptr );
+    }
+
+    void FusedStatisticsImageFilter::Execute ( const Image& image, const Image& mask )
+    {
+      if ( mask.GetPixelID() != sitkUInt8 )
+        {
+        sitkExceptionMacro( "The mask must be of pixel type sitkUInt8 but it is of pixel type "
+                            << mask.GetPixelIDTypeAsString() << "!" );
+        }
+      if ( mask.GetSize() != image.GetSize() )
+        {
+        sitkExceptionMacro( "The mask of size " << mask.GetSize()
+                            << " does not match the image of size " << image.GetSize() << "!" );
+        }
+
+      PixelIDValueEnum type = image.GetPixelID();
+      unsigned int dimension = image.GetDimension();
+
+      this->m_MemberFactory->GetMemberFunction( type, dimension )( image, &mask );
+    }
+
+    template <class TImageType>
+    void FusedStatisticsImageFilter::ExecuteInternal ( const Image& inImage, const Image *inMask )
+    {
+      using InputImageType = TImageType;
+      using MaskImageType = itk::Image<uint8_t, InputImageType::ImageDimension>;
+
+      typename InputImageType::ConstPointer image =
+        dynamic_cast <const InputImageType*> ( inImage.GetITKBase() );
+
+      using FilterType = itk::FusedStatisticsImageFilter<InputImageType, MaskImageType>;
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( image );
+
+      if ( inMask )
+        {
+        typename MaskImageType::ConstPointer mask =
+          dynamic_cast <const MaskImageType*> ( inMask->GetITKBase() );
+        filter->SetMaskImage( mask );
+        }
+
+      filter->SetNumberOfHistogramBins( this->m_NumberOfHistogramBins );
+      filter->SetHistogramOversampling( this->m_HistogramOversampling );
+      filter->SetAutoMinimumMaximum( this->m_AutoMinimumMaximum );
+      filter->SetHistogramMinimum( this->m_HistogramMinimum );
+      filter->SetHistogramMaximum( this->m_HistogramMaximum );
+      filter->SetQuantiles( this->m_Quantiles );
+
+      this->PreUpdate( filter.GetPointer() );
+
+      filter->Update();
+
+      this->m_Minimum = filter->GetMinimum();
+      this->m_Maximum = filter->GetMaximum();
+      this->m_Mean = filter->GetMean();
+      this->m_Variance = filter->GetVariance();
+      this->m_Sigma = filter->GetSigma();
+      this->m_Sum = filter->GetSum();
+      this->m_Count = filter->GetCount();
+      this->m_QuantileValues = filter->GetQuantileValues();
+
+      const HistogramType *histogram = filter->GetHistogram();
+      const unsigned int numberOfBins = histogram->GetSize( 0 );
+      this->m_HistogramFrequencies.resize( numberOfBins );
+      this->m_HistogramBinEdges.resize( numberOfBins + 1 );
+      for ( unsigned int i = 0; i < numberOfBins; ++i )
+        {
+        this->m_HistogramFrequencies[i] = histogram->GetFrequency( i );
+        this->m_HistogramBinEdges[i] = histogram->GetBinMin( 0, i );
+        }
+      this->m_HistogramBinEdges[numberOfBins] = histogram->GetBinMax( 0, numberOfBins - 1 );
+    }
+
+    double FusedStatisticsImageFilter::ComputeThreshold ( ThresholdMethod method ) const
+    {
+      if ( this->m_HistogramFrequencies.empty() )
+        {
+        sitkExceptionMacro( "The histogram is not computed, the filter must be executed first!" );
+        }
+
+      uint64_t total = 0;
+      for ( uint64_t frequency : this->m_HistogramFrequencies )
+        {
+        total += frequency;
+        }
+      if ( total == 0 )
+        {
+        sitkExceptionMacro( "The histogram is empty, no pixel was binned!" );
+        }
+
+      // all the binned pixels have the same value
+      if ( this->m_HistogramBinEdges.front() == this->m_HistogramBinEdges.back() )
+        {
+        return this->m_HistogramBinEdges.front();
+        }
+
+      const unsigned int numberOfBins = static_cast<unsigned int>( this->m_HistogramFrequencies.size() );
+      HistogramType::Pointer histogram = HistogramType::New();
+      histogram->SetMeasurementVectorSize( 1 );
+      HistogramType::SizeType size( 1 );
+      size[0] = numberOfBins;
+      HistogramType::MeasurementVectorType lowerBound( 1 );
+      HistogramType::MeasurementVectorType upperBound( 1 );
+      lowerBound[0] = this->m_HistogramBinEdges.front();
+      upperBound[0] = this->m_HistogramBinEdges.back();
+      histogram->Initialize( size, lowerBound, upperBound );
+      for ( unsigned int i = 0; i < numberOfBins; ++i )
+        {
+        histogram->SetFrequency( i, this->m_HistogramFrequencies[i] );
+        }
+
+      switch ( method )
+        {
+        case Huang:
+          return ComputeHistogramThreshold<itk::HuangThresholdCalculator>( histogram );
+        case Intermodes:
+          return ComputeHistogramThreshold<itk::IntermodesThresholdCalculator>( histogram );
+        case IsoData:
+          return ComputeHistogramThreshold<itk::IsoDataThresholdCalculator>( histogram );
+        case KittlerIllingworth:
+          return ComputeHistogramThreshold<itk::KittlerIllingworthThresholdCalculator>( histogram );
+        case Li:
+          return ComputeHistogramThreshold<itk::LiThresholdCalculator>( histogram );
+        case MaximumEntropy:
+          return ComputeHistogramThreshold<itk::MaximumEntropyThresholdCalculator>( histogram );
+        case Moments:
+          return ComputeHistogramThreshold<itk::MomentsThresholdCalculator>( histogram );
+        case Otsu:
+          return ComputeHistogramThreshold<itk::OtsuThresholdCalculator>( histogram );
+        case RenyiEntropy:
+          return ComputeHistogramThreshold<itk::RenyiEntropyThresholdCalculator>( histogram );
+        case Shanbhag:
+          return ComputeHistogramThreshold<itk::ShanbhagThresholdCalculator>( histogram );
+        case Triangle:
+          return ComputeHistogramThreshold<itk::TriangleThresholdCalculator>( histogram );
+        case Yen:
+          return ComputeHistogramThreshold<itk::YenThresholdCalculator>( histogram );
+        }
+      sitkExceptionMacro( "Unknown threshold method: " << method );
+    }
+  }
+}
@@ -18,6 +18,7 @@
 
 #include "sitkHashImageFilter.h"
 #include "sitkCastImageFilter.h"
+#include "sitkTemplateFunctions.h"
 #include "itkHashImageFilter.h"
 #include "itkVectorImage.h"
 #include "itkLabelMap.h"
@@ -34,6 +35,7 @@ namespace itk {
 
     HashImageFilter::HashImageFilter () {
       this->m_HashFunction = SHA1;
+      this->m_TreeHashChunkSize = 0;
 
       this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
 
@@ -53,8 +55,14 @@ namespace itk {
         case MD5:
           out << "MD5";
           break;
+        case XXH64:
+          out << "XXH64";
+          break;
         }
       out << std::endl;
+      out << "TreeHashChunkSize: " << this->m_TreeHashChunkSize << std::endl;
+      out << "HashRegionIndex: " << this->m_HashRegionIndex << std::endl;
+      out << "HashRegionSize: " << this->m_HashRegionSize << std::endl;
       out << ProcessObject::ToString();
       return out.str();
     }
@@ -70,6 +78,45 @@ namespace itk {
       return *this;
       }
 
+    HashImageFilter& HashImageFilter::SetTreeHashChunkSize ( uint64_t chunkSize )
+      {
+      this->m_TreeHashChunkSize = chunkSize;
+      return *this;
+      }
+
+    uint64_t HashImageFilter::GetTreeHashChunkSize () const
+    {
+      return this->m_TreeHashChunkSize;
+    }
+
+    HashImageFilter& HashImageFilter::SetHashRegion ( const std::vector<int> &index, const std::vector<unsigned int> &size )
+      {
+      if ( index.size() != size.size() )
+        {
+        sitkExceptionMacro( "The index and the size of the hash region must have the same dimension!" );
+        }
+      this->m_HashRegionIndex = index;
+      this->m_HashRegionSize = size;
+      return *this;
+      }
+
+    std::vector<int> HashImageFilter::GetHashRegionIndex () const
+    {
+      return this->m_HashRegionIndex;
+    }
+
+    std::vector<unsigned int> HashImageFilter::GetHashRegionSize () const
+    {
+      return this->m_HashRegionSize;
+    }
+
+    HashImageFilter& HashImageFilter::RemoveHashRegion ()
+      {
+      this->m_HashRegionIndex.clear();
+      this->m_HashRegionSize.clear();
+      return *this;
+      }
+
     std::string HashImageFilter::Execute ( const Image& image ) {
 
       PixelIDValueEnum type = image.GetPixelID();
@@ -105,7 +152,6 @@ namespace itk {
       using HashFilterType = itk::HashImageFilter<InputImageType>;
       typename HashFilterType::Pointer hasher = HashFilterType::New();
       hasher->SetInput( image );
-      hasher->InPlaceOff(); // pointless copy of data needed
 
       switch ( this->GetHashFunction() )
         {
@@ -115,6 +161,27 @@ namespace itk {
         case MD5:
           hasher->SetHashFunction( HashFilterType::MD5 );
           break;
+        case XXH64:
+          hasher->SetHashFunction( HashFilterType::XXH64 );
+          break;
+        }
+      hasher->SetTreeHashChunkSize( this->m_TreeHashChunkSize );
+
+      if ( !this->m_HashRegionSize.empty() )
+        {
+        if ( this->m_HashRegionSize.size() != InputImageType::ImageDimension )
+          {
+          sitkExceptionMacro( "The hash region is of dimension " << this->m_HashRegionSize.size()
+                              << " but the image is of dimension " << InputImageType::ImageDimension << "!" );
+          }
+        typename InputImageType::RegionType region;
+        for ( unsigned int d = 0; d < InputImageType::ImageDimension; ++d )
+          {
+          region.SetIndex( d, this->m_HashRegionIndex[d] );
+          region.SetSize( d, this->m_HashRegionSize[d] );
+          }
+        hasher->SetHashRegion( region );
+        hasher->UseHashRegionOn();
         }
 
       this->PreUpdate( hasher.GetPointer() );
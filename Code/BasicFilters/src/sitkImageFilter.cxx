@@ -18,8 +18,16 @@
 #include "sitkImageFilter.h"
 
 #include "itkProcessObject.h"
+#include "itkEventObject.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 
 namespace itk {
@@ -28,6 +36,43 @@ namespace simple {
 namespace
 {
 
+      // The determinant of a row major square matrix, by Gaussian
+      // elimination with partial pivoting.
+      double Determinant( std::vector<double> matrix, unsigned int n )
+      {
+        double determinant = 1.0;
+        for ( unsigned int c = 0; c < n; ++c )
+          {
+          unsigned int pivot = c;
+          for ( unsigned int r = c + 1; r < n; ++r )
+            {
+            if ( std::abs( matrix[r * n + c] ) > std::abs( matrix[pivot * n + c] ) )
+              {
+              pivot = r;
+              }
+            }
+          if ( matrix[pivot * n + c] == 0.0 )
+            {
+            return 0.0;
+            }
+          if ( pivot != c )
+            {
+            std::swap_ranges( matrix.begin() + pivot * n, matrix.begin() + ( pivot + 1 ) * n, matrix.begin() + c * n );
+            determinant = -determinant;
+            }
+          determinant *= matrix[c * n + c];
+          for ( unsigned int r = c + 1; r < n; ++r )
+            {
+            const double factor = matrix[r * n + c] / matrix[c * n + c];
+            for ( unsigned int k = c; k < n; ++k )
+              {
+              matrix[r * n + k] -= factor * matrix[c * n + k];
+              }
+            }
+          }
+        return determinant;
+      }
+
       void CheckImageMatchingDimension(const Image &image1, const Image& image2,
                                        const std::string &image2Name, const std::string &filterName  )
       {
@@ -69,9 +114,353 @@ namespace
 
 //----------------------------------------------------------------------------
 
-ImageFilter::ImageFilter () = default;
+ImageFilter::ImageFilter ()
+  : m_NumberOfStreamDivisions(1)
+{
+}
+
+ImageFilter::~ImageFilter ()
+{
+  this->SetITKFilter( nullptr );
+}
+
+
+void ImageFilter::SetNumberOfStreamDivisions(unsigned int n)
+{
+  this->m_NumberOfStreamDivisions = std::max(n, 1u);
+}
+
+unsigned int ImageFilter::GetNumberOfStreamDivisions() const
+{
+  return this->m_NumberOfStreamDivisions;
+}
+
+
+void ImageFilter::SetOutputImage( Image image )
+{
+  this->m_OutputImage.reset( new Image( std::move( image ) ) );
+}
+
+bool ImageFilter::HasOutputImage() const
+{
+  return this->m_OutputImage != nullptr;
+}
+
+void ImageFilter::RemoveOutputImage()
+{
+  this->m_OutputImage.reset();
+}
+
+void ImageFilter::ExecuteItemsInParallel( size_t numberOfItems,
+                                          const std::function<std::function<void(size_t)>()> &createWorker )
+{
+  if ( numberOfItems == 0 )
+    {
+    return;
+    }
+
+  unsigned int numberOfThreads = std::max( this->GetNumberOfThreads(), 1u );
+  numberOfThreads = static_cast<unsigned int>( std::min<size_t>( numberOfThreads, numberOfItems ) );
+
+  std::unique_ptr<Executor> executor;
+  if ( this->HasExecutor() )
+    {
+    executor.reset( new Executor( this->GetExecutor() ) );
+    numberOfThreads = executor->AcquireThreads( numberOfThreads );
+    }
+  auto releaseThreads = make_scope_exit( [&executor, numberOfThreads] {
+      if ( executor )
+        {
+        executor->ReleaseThreads( numberOfThreads );
+        }
+    } );
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool>   failed{false};
+  std::exception_ptr  firstException;
+  std::mutex          exceptionMutex;
+
+  auto work = [&]()
+    {
+      try
+        {
+        std::function<void(size_t)> execute = createWorker();
+        for ( size_t i = next++; i < numberOfItems && !failed; i = next++ )
+          {
+          execute( i );
+          }
+        }
+      catch (...)
+        {
+        std::lock_guard<std::mutex> lock( exceptionMutex );
+        if ( !firstException )
+          {
+          firstException = std::current_exception();
+          }
+        failed = true;
+        }
+    };
+
+  std::vector<std::thread> threads;
+  threads.reserve( numberOfThreads - 1 );
+  for ( unsigned int t = 1; t < numberOfThreads; ++t )
+    {
+    threads.emplace_back( work );
+    }
+  work();
+  for ( std::thread &thread : threads )
+    {
+    thread.join();
+    }
 
-ImageFilter::~ImageFilter () = default;
+  if ( firstException )
+    {
+    std::rethrow_exception( firstException );
+    }
+}
+
+std::vector<Image> ImageFilter::ExecuteBatchInParallel( const std::vector<Image> &images,
+                                                     const std::function<BatchFunctionType()> &createWorker )
+{
+  std::vector<Image> outputs( images.size() );
+  this->ExecuteItemsInParallel( images.size(), [&images, &outputs, &createWorker]()
+    {
+      BatchFunctionType execute = createWorker();
+      return std::function<void(size_t)>( [execute, &images, &outputs]( size_t i ) { outputs[i] = execute( images[i] ); } );
+    } );
+  return outputs;
+}
+
+Image ImageFilter::ExecuteSliceBySliceInParallel( const Image &image,
+                                                  unsigned int axis,
+                                                  const std::function<BatchFunctionType()> &createWorker )
+{
+  const unsigned int dimension = image.GetDimension();
+  if ( dimension < 3 )
+    {
+    sitkExceptionMacro( "Slice by slice execution requires an image of dimension 3 or more, the image has dimension "
+                        << dimension << "." );
+    }
+  if ( axis >= dimension )
+    {
+    sitkExceptionMacro( "The slice axis " << axis << " is not less than the image dimension " << dimension << "." );
+    }
+
+  const size_t pixelSize = static_cast<size_t>( image.GetNumberOfComponentsPerPixel() ) * image.GetSizeOfPixelComponent();
+  if ( pixelSize == 0 )
+    {
+    sitkExceptionMacro( "Slice by slice execution does not support the pixel type "
+                        << image.GetPixelIDTypeAsString() << "." );
+    }
+
+  // a slice is numberOfLines contiguous lines of lineLength pixels
+  const std::vector<unsigned int> size = image.GetSize();
+  const std::vector<double> spacing = image.GetSpacing();
+  const std::vector<double> origin = image.GetOrigin();
+  const std::vector<double> direction = image.GetDirection();
+
+  std::vector<unsigned int> sliceSize;
+  std::vector<double> sliceSpacing;
+  std::vector<double> sliceDirection;
+  size_t lineLength = 1;
+  size_t numberOfLines = 1;
+  for ( unsigned int d = 0; d < dimension; ++d )
+    {
+    if ( d != axis )
+      {
+      sliceSize.push_back( size[d] );
+      sliceSpacing.push_back( spacing[d] );
+      for ( unsigned int c = 0; c < dimension; ++c )
+        {
+        if ( c != axis )
+          {
+          sliceDirection.push_back( direction[d * dimension + c] );
+          }
+        }
+      }
+    if ( d < axis )
+      {
+      lineLength *= size[d];
+      }
+    else if ( d > axis )
+      {
+      numberOfLines *= size[d];
+      }
+    }
+  if ( std::abs( Determinant( sliceDirection, dimension - 1 ) ) < 1e-6 )
+    {
+    // the slice directions are degenerate, use the identity as the
+    // guess of ExtractImageFilter does
+    std::fill( sliceDirection.begin(), sliceDirection.end(), 0.0 );
+    for ( unsigned int d = 0; d + 1 < dimension; ++d )
+      {
+      sliceDirection[d * dimension] = 1.0;
+      }
+    }
+
+  const auto *inputBuffer = static_cast<const uint8_t *>( image.GetBufferAsVoid() );
+  const size_t lineBytes = lineLength * pixelSize;
+
+  Image output;
+  uint8_t *outputBuffer = nullptr;
+  std::mutex outputMutex;
+
+  this->ExecuteItemsInParallel( size[axis], [&]()
+    {
+      BatchFunctionType execute = createWorker();
+      return std::function<void(size_t)>( [&, execute]( size_t k )
+        {
+          Image slice( sliceSize, image.GetPixelID(), image.GetNumberOfComponentsPerPixel() );
+          std::vector<int64_t> sliceIndex( dimension, 0 );
+          sliceIndex[axis] = static_cast<int64_t>( k );
+          std::vector<double> sliceOrigin = image.TransformIndexToPhysicalPoint( sliceIndex );
+          sliceOrigin.erase( sliceOrigin.begin() + axis );
+          slice.SetOrigin( sliceOrigin );
+          slice.SetSpacing( sliceSpacing );
+          slice.SetDirection( sliceDirection );
+
+          auto *sliceBuffer = static_cast<uint8_t *>( slice.GetBufferAsVoid() );
+          for ( size_t j = 0; j < numberOfLines; ++j )
+            {
+            std::memcpy( sliceBuffer + j * lineBytes, inputBuffer + ( j * size[axis] + k ) * lineBytes, lineBytes );
+            }
+
+          const Image result = execute( slice );
+          if ( result.GetSize() != sliceSize )
+            {
+            sitkExceptionMacro( "The result of slice " << k << " has size " << result.GetSize()
+                                << " which does not match the slice size of " << sliceSize << "." );
+            }
+
+          size_t resultBytes = 0;
+          {
+          std::lock_guard<std::mutex> lock( outputMutex );
+          if ( outputBuffer == nullptr )
+            {
+            output = Image( size, result.GetPixelID(), result.GetNumberOfComponentsPerPixel() );
+            output.SetOrigin( origin );
+            output.SetSpacing( spacing );
+            output.SetDirection( direction );
+            outputBuffer = static_cast<uint8_t *>( output.GetBufferAsVoid() );
+            }
+          else if ( result.GetPixelID() != output.GetPixelID() ||
+                    result.GetNumberOfComponentsPerPixel() != output.GetNumberOfComponentsPerPixel() )
+            {
+            sitkExceptionMacro( "The result of slice " << k << " has pixel type " << result.GetPixelIDTypeAsString()
+                                << " which does not match the pixel type " << output.GetPixelIDTypeAsString()
+                                << " of the other slices." );
+            }
+          resultBytes = lineLength * result.GetNumberOfComponentsPerPixel() * result.GetSizeOfPixelComponent();
+          }
+
+          const auto *resultBuffer = static_cast<const uint8_t *>( result.GetBufferAsVoid() );
+          for ( size_t j = 0; j < numberOfLines; ++j )
+            {
+            std::memcpy( outputBuffer + ( j * size[axis] + k ) * resultBytes, resultBuffer + j * resultBytes, resultBytes );
+            }
+        } );
+    } );
+
+  return output;
+}
+
+void ImageFilter::InitializeBatchWorker( ImageFilter &worker ) const
+{
+  // the threads of the workers were acquired from the executor by
+  // the batch
+  worker.RemoveExecutor();
+  worker.SetNumberOfThreads( 1 );
+  worker.SetNumberOfWorkUnits( 1 );
+  worker.SetNumberOfStreamDivisions( this->GetNumberOfStreamDivisions() );
+  worker.SetDebug( this->GetDebug() );
+  worker.SetReuseITKFilter( this->GetReuseITKFilter() );
+  if ( this->HasCancellationToken() )
+    {
+    worker.SetCancellationToken( this->GetCancellationToken() );
+    }
+}
+
+void ImageFilter::SetReuseITKFilter( bool reuse )
+{
+  this->m_ReuseITKFilter = reuse;
+  if ( !reuse )
+    {
+    this->SetITKFilter( nullptr );
+    }
+}
+
+bool ImageFilter::GetReuseITKFilter() const
+{
+  return this->m_ReuseITKFilter;
+}
+
+void ImageFilter::ReleaseITKFilter()
+{
+  this->SetITKFilter( nullptr );
+}
+
+void ImageFilter::SetITKFilter( itk::ProcessObject *filter )
+{
+  if ( this->m_ITKFilter == filter )
+    {
+    return;
+    }
+  if ( filter != nullptr )
+    {
+    filter->Register();
+    }
+  if ( this->m_ITKFilter != nullptr )
+    {
+    // observers of a failed execution reference this object
+    this->m_ITKFilter->RemoveAllObservers();
+    this->m_ITKFilter->UnRegister();
+    }
+  this->m_ITKFilter = filter;
+}
+
+void ImageFilter::ResetITKFilter()
+{
+  assert( this->m_ITKFilter );
+  this->m_ITKFilter->RemoveAllObservers();
+  this->m_ITKFilter->AbortGenerateDataOff();
+}
+
+void ImageFilter::FinishITKFilterExecution( const itk::ProcessObject *filter )
+{
+  if ( filter == nullptr || filter != this->m_ITKFilter )
+    {
+    return;
+    }
+
+  // the returned image is the output, give the filter a new one
+  for ( itk::DataObject *output : this->m_ITKFilter->GetOutputs() )
+    {
+    if ( output != nullptr )
+      {
+      output->DisconnectPipeline();
+      }
+    }
+
+  // The input images share the buffers of the SimpleITK
+  // images. Label maps are the SimpleITK image itself, and are
+  // left as is.
+  for ( itk::DataObject *input : this->m_ITKFilter->GetInputs() )
+    {
+    if ( input != nullptr && ( std::strcmp( input->GetNameOfClass(), "Image" ) == 0 ||
+                               std::strcmp( input->GetNameOfClass(), "VectorImage" ) == 0 ) )
+      {
+      input->ReleaseData();
+      }
+    }
+
+  this->ResetITKFilter();
+  this->OnActiveProcessDelete();
+}
+
+void ImageFilter::OnITKStartEvent( itk::ProcessObject *filter, std::function<void()> func )
+{
+  filter->AddObserver( itk::StartEvent(), [func]( const itk::EventObject & ) { func(); } );
+}
 
 
 
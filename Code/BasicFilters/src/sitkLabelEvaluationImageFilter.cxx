@@ -0,0 +1,188 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkLabelEvaluationImageFilter.h"
+#include "itkLabelEvaluationImageFilter.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace itk {
+  namespace simple {
+
+    LabelEvaluationImageFilter::~LabelEvaluationImageFilter ()
+    = default;
+
+    LabelEvaluationImageFilter::LabelEvaluationImageFilter ()
+      : m_BackgroundValue( 0.0 ),
+        m_UseImageSpacing( true ),
+        m_MaximumDistance( std::numeric_limits<double>::infinity() )
+    {
+      this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 3 > ();
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2 > ();
+    }
+
+    std::string LabelEvaluationImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::LabelEvaluationImageFilter" << std::endl;
+      out << "  BackgroundValue: " << this->m_BackgroundValue << std::endl;
+      out << "  UseImageSpacing: " << this->m_UseImageSpacing << std::endl;
+      out << "  MaximumDistance: " << this->m_MaximumDistance << std::endl;
+      out << "  NumberOfLabels: " << this->m_Labels.size() << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    LabelEvaluationImageFilter& LabelEvaluationImageFilter::SetBackgroundValue ( double backgroundValue )
+      {
+      this->m_BackgroundValue = backgroundValue;
+      return *this;
+      }
+
+    double LabelEvaluationImageFilter::GetBackgroundValue () const
+    {
+      return this->m_BackgroundValue;
+    }
+
+    LabelEvaluationImageFilter& LabelEvaluationImageFilter::SetUseImageSpacing ( bool useImageSpacing )
+      {
+      this->m_UseImageSpacing = useImageSpacing;
+      return *this;
+      }
+
+    bool LabelEvaluationImageFilter::GetUseImageSpacing () const
+    {
+      return this->m_UseImageSpacing;
+    }
+
+    LabelEvaluationImageFilter& LabelEvaluationImageFilter::SetMaximumDistance ( double maximumDistance )
+      {
+      if ( !( maximumDistance >= 0.0 ) )
+        {
+        sitkExceptionMacro( "The MaximumDistance " << maximumDistance << " is negative!" );
+        }
+      this->m_MaximumDistance = maximumDistance;
+      return *this;
+      }
+
+    double LabelEvaluationImageFilter::GetMaximumDistance () const
+    {
+      return this->m_MaximumDistance;
+    }
+
+    void LabelEvaluationImageFilter::Execute ( const Image &referenceImage, const Image &predictionImage )
+    {
+      if ( referenceImage.GetDimension() != predictionImage.GetDimension()
+           || referenceImage.GetSize() != predictionImage.GetSize() )
+        {
+        sitkExceptionMacro( "The prediction image of size " << predictionImage.GetSize()
+                            << " does not match the reference image of size " << referenceImage.GetSize() << "!" );
+        }
+      if ( referenceImage.GetPixelID() != predictionImage.GetPixelID() )
+        {
+        sitkExceptionMacro( "The prediction image of pixel type " << predictionImage.GetPixelIDTypeAsString()
+                            << " does not match the reference image of pixel type "
+                            << referenceImage.GetPixelIDTypeAsString() << "!" );
+        }
+
+      PixelIDValueEnum type = referenceImage.GetPixelID();
+      unsigned int dimension = referenceImage.GetDimension();
+
+      this->m_MemberFactory->GetMemberFunction( type, dimension )( referenceImage, predictionImage );
+    }
+
+    template <class TImageType>
+    void LabelEvaluationImageFilter::ExecuteInternal ( const Image &inReferenceImage, const Image &inPredictionImage )
+    {
+      using LabelImageType = TImageType;
+      using LabelPixelType = typename LabelImageType::PixelType;
+
+      typename LabelImageType::ConstPointer referenceImage =
+        dynamic_cast <const LabelImageType*> ( inReferenceImage.GetITKBase() );
+      typename LabelImageType::ConstPointer predictionImage =
+        dynamic_cast <const LabelImageType*> ( inPredictionImage.GetITKBase() );
+
+      using FilterType = itk::LabelEvaluationImageFilter<LabelImageType>;
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetReferenceImage( referenceImage );
+      filter->SetPredictionImage( predictionImage );
+      filter->SetBackgroundValue( static_cast<LabelPixelType>( this->m_BackgroundValue ) );
+      filter->SetUseImageSpacing( this->m_UseImageSpacing );
+      filter->SetMaximumDistance( this->m_MaximumDistance );
+
+      this->PreUpdate( filter.GetPointer() );
+
+      filter->Update();
+
+      const auto &labels = filter->GetLabels();
+      this->m_Labels.assign( labels.begin(), labels.end() );
+      this->m_DiceCoefficients = filter->GetDiceCoefficients();
+      this->m_JaccardCoefficients = filter->GetJaccardCoefficients();
+      this->m_VolumeSimilarities = filter->GetVolumeSimilarities();
+      this->m_HausdorffDistances = filter->GetHausdorffDistances();
+      this->m_HausdorffDistances95 = filter->GetHausdorffDistances95();
+      this->m_AverageSymmetricSurfaceDistances = filter->GetAverageSymmetricSurfaceDistances();
+    }
+
+    size_t LabelEvaluationImageFilter::GetLabelPosition ( int64_t label ) const
+    {
+      auto it = std::lower_bound( this->m_Labels.begin(), this->m_Labels.end(), label );
+      if ( it == this->m_Labels.end() || *it != label )
+        {
+        sitkExceptionMacro( "The label " << label << " does not exist!" );
+        }
+      return it - this->m_Labels.begin();
+    }
+
+    bool LabelEvaluationImageFilter::HasLabel ( int64_t label ) const
+    {
+      return std::binary_search( this->m_Labels.begin(), this->m_Labels.end(), label );
+    }
+
+    double LabelEvaluationImageFilter::GetDiceCoefficient ( int64_t label ) const
+    {
+      return this->m_DiceCoefficients[this->GetLabelPosition( label )];
+    }
+
+    double LabelEvaluationImageFilter::GetJaccardCoefficient ( int64_t label ) const
+    {
+      return this->m_JaccardCoefficients[this->GetLabelPosition( label )];
+    }
+
+    double LabelEvaluationImageFilter::GetVolumeSimilarity ( int64_t label ) const
+    {
+      return this->m_VolumeSimilarities[this->GetLabelPosition( label )];
+    }
+
+    double LabelEvaluationImageFilter::GetHausdorffDistance ( int64_t label ) const
+    {
+      return this->m_HausdorffDistances[this->GetLabelPosition( label )];
+    }
+
+    double LabelEvaluationImageFilter::GetHausdorffDistance95 ( int64_t label ) const
+    {
+      return this->m_HausdorffDistances95[this->GetLabelPosition( label )];
+    }
+
+    double LabelEvaluationImageFilter::GetAverageSymmetricSurfaceDistance ( int64_t label ) const
+    {
+      return this->m_AverageSymmetricSurfaceDistances[this->GetLabelPosition( label )];
+    }
+  }
+}
@@ -31,6 +31,10 @@
 // Additional include files
 #include "sitkTransform.h"
 #include "sitkBSplineTransform.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
 // Done with additional include files
 
 namespace itk {
@@ -49,6 +53,9 @@ LandmarkBasedTransformInitializerFilter::LandmarkBasedTransformInitializerFilter
     this->m_LandmarkWeight = std::vector<double>();
     this->m_ReferenceImage = Image();
     this->m_BSplineNumberOfControlPoints = 4u;
+    this->m_RANSACNumberOfIterations = 0u;
+    this->m_RANSACInlierThreshold = 1.0;
+    this->m_RANSACSeed = sitkWallClock;
 
   this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
 
@@ -84,6 +91,15 @@ std::string LandmarkBasedTransformInitializerFilter::ToString() const
   out << "  BSplineNumberOfControlPoints: ";
   this->ToStringHelper(out, this->m_BSplineNumberOfControlPoints);
   out << std::endl;
+  out << "  RANSACNumberOfIterations: ";
+  this->ToStringHelper(out, this->m_RANSACNumberOfIterations);
+  out << std::endl;
+  out << "  RANSACInlierThreshold: ";
+  this->ToStringHelper(out, this->m_RANSACInlierThreshold);
+  out << std::endl;
+  out << "  RANSACSeed: ";
+  this->ToStringHelper(out, this->m_RANSACSeed);
+  out << std::endl;
 
   out << ProcessObject::ToString();
   return out.str();
@@ -115,6 +131,190 @@ Transform LandmarkBasedTransformInitializerFilter::Execute ( const Transform & t
 //
 namespace {
 
+template <class TPointContainer>
+TPointContainer SelectPoints( const TPointContainer &points, const std::vector<uint32_t> &indices )
+{
+  TPointContainer selected;
+  selected.reserve( indices.size() );
+  for ( uint32_t i : indices )
+    {
+    selected.push_back( points[i] );
+    }
+  return selected;
+}
+
+/** The indices of the landmark pairs mapped within threshold by the
+ * transform. The counting stops when fewer than minimumNumberOfInliers
+ * pairs can be found. */
+template <class TTransform, class TPointContainer>
+std::vector<uint32_t> FindInliers( const TTransform *transform,
+                                   const TPointContainer &fixedPoints,
+                                   const TPointContainer &movingPoints,
+                                   double threshold,
+                                   size_t minimumNumberOfInliers = 0 )
+{
+  const double squaredThreshold = threshold * threshold;
+  const size_t numberOfPoints = fixedPoints.size();
+
+  std::vector<uint32_t> inliers;
+  for ( size_t i = 0; i < numberOfPoints; ++i )
+    {
+    if ( inliers.size() + ( numberOfPoints - i ) < minimumNumberOfInliers )
+      {
+      break;
+      }
+    if ( transform->TransformPoint( fixedPoints[i] ).SquaredEuclideanDistanceTo( movingPoints[i] ) <= squaredThreshold )
+      {
+      inliers.push_back( static_cast<uint32_t>( i ) );
+      }
+    }
+  return inliers;
+}
+
+/** Fit the transform to the pairs of a minimal random subset on each
+ * iteration, and return the inliers of the best fit. The subset of an
+ * iteration is drawn from a generator seeded with the iteration, so
+ * the result does not depend on the number of threads. */
+template <class TFilter>
+std::vector<uint32_t> RANSACInliers( const Transform &transform,
+                                     const typename TFilter::LandmarkPointContainer &fixedPoints,
+                                     const typename TFilter::LandmarkPointContainer &movingPoints,
+                                     unsigned int numberOfIterations,
+                                     double threshold,
+                                     uint32_t seed,
+                                     unsigned int numberOfThreads )
+{
+  using TransformType = typename TFilter::TransformType;
+  using PointContainer = typename TFilter::LandmarkPointContainer;
+
+  const unsigned int dimension = transform.GetDimension();
+  const unsigned int numberOfParameters = transform.GetNumberOfParameters();
+
+  // the number of pairs determining the transform, a rotation needs
+  // as many pairs as the dimension
+  const size_t sampleSize = std::max<size_t>( dimension, ( numberOfParameters + dimension - 1 ) / dimension );
+  if ( fixedPoints.size() < sampleSize )
+    {
+    sitkExceptionMacro( "At least " << sampleSize << " landmarks are required for RANSAC, but " << fixedPoints.size() << " are given!" );
+    }
+
+  const uint32_t iterationSeed = ( seed == sitkWallClock ) ? static_cast<uint32_t>( std::chrono::system_clock::now().time_since_epoch().count() ) : seed;
+
+  struct BestFit
+  {
+    size_t numberOfInliers = 0;
+    unsigned int iteration = 0;
+  };
+
+  auto drawSample = [&]( unsigned int iteration )
+    {
+      std::mt19937 generator( iterationSeed + iteration );
+      std::uniform_int_distribution<uint32_t> distribution( 0, static_cast<uint32_t>( fixedPoints.size() - 1 ) );
+      std::vector<uint32_t> sample;
+      while ( sample.size() < sampleSize )
+        {
+        const uint32_t i = distribution( generator );
+        if ( std::find( sample.begin(), sample.end(), i ) == sample.end() )
+          {
+          sample.push_back( i );
+          }
+        }
+      return sample;
+    };
+
+  // fit a transform to the pairs of indices, returning false for a
+  // degenerate sample
+  auto fit = [&fixedPoints, &movingPoints]( TFilter *filter, const std::vector<uint32_t> &indices )
+    {
+      filter->SetFixedLandmarks( SelectPoints<PointContainer>( fixedPoints, indices ) );
+      filter->SetMovingLandmarks( SelectPoints<PointContainer>( movingPoints, indices ) );
+      try
+        {
+        filter->InitializeTransform();
+        }
+      catch ( itk::ExceptionObject & )
+        {
+        return false;
+        }
+      return true;
+    };
+
+  // each thread fits its own copy of the transform
+  std::vector<Transform> transforms( std::max( std::min( numberOfThreads, numberOfIterations ), 1u ), transform );
+  for ( Transform &t : transforms )
+    {
+    t.SetFixedParameters( t.GetFixedParameters() );
+    }
+  std::vector<BestFit> bestFits( transforms.size() );
+
+  auto work = [&]( unsigned int t )
+    {
+      TransformType *itkTx = dynamic_cast<TransformType *>( transforms[t].GetITKBase() );
+      typename TFilter::Pointer filter = TFilter::New();
+      filter->SetTransform( itkTx );
+
+      for ( unsigned int iteration = t; iteration < numberOfIterations; iteration += static_cast<unsigned int>( transforms.size() ) )
+        {
+        if ( !fit( filter.GetPointer(), drawSample( iteration ) ) )
+          {
+          continue;
+          }
+        const size_t numberOfInliers = FindInliers( itkTx, fixedPoints, movingPoints, threshold, bestFits[t].numberOfInliers + 1 ).size();
+        if ( numberOfInliers > bestFits[t].numberOfInliers )
+          {
+          bestFits[t].numberOfInliers = numberOfInliers;
+          bestFits[t].iteration = iteration;
+          }
+        }
+    };
+
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 1; t < transforms.size(); ++t )
+    {
+    threads.emplace_back( work, t );
+    }
+  work( 0 );
+  for ( std::thread &thread : threads )
+    {
+    thread.join();
+    }
+
+  // the earliest iteration with the most inliers
+  const BestFit *best = &bestFits[0];
+  for ( const BestFit &bestFit : bestFits )
+    {
+    if ( bestFit.numberOfInliers > best->numberOfInliers ||
+         ( bestFit.numberOfInliers == best->numberOfInliers && bestFit.iteration < best->iteration ) )
+      {
+      best = &bestFit;
+      }
+    }
+  if ( best->numberOfInliers < sampleSize )
+    {
+    sitkExceptionMacro( "RANSAC did not find a transform with enough inliers!" );
+    }
+
+  // refit the best sample, then the transforms of the inliers
+  Transform bestTransform( transform );
+  bestTransform.SetFixedParameters( bestTransform.GetFixedParameters() );
+  TransformType *itkTx = dynamic_cast<TransformType *>( bestTransform.GetITKBase() );
+  typename TFilter::Pointer filter = TFilter::New();
+  filter->SetTransform( itkTx );
+
+  std::vector<uint32_t> inliers = drawSample( best->iteration );
+  fit( filter.GetPointer(), inliers );
+  inliers = FindInliers( itkTx, fixedPoints, movingPoints, threshold );
+  if ( fit( filter.GetPointer(), inliers ) )
+    {
+    std::vector<uint32_t> refinedInliers = FindInliers( itkTx, fixedPoints, movingPoints, threshold );
+    if ( refinedInliers.size() >= sampleSize )
+      {
+      inliers.swap( refinedInliers );
+      }
+    }
+  return inliers;
+}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -162,6 +362,40 @@ Transform LandmarkBasedTransformInitializerFilter::ExecuteInternal ( const Trans
   filter->SetLandmarkWeight ( this->m_LandmarkWeight );
 
   using TransformCategoryEnum = typename FilterType::TransformType::TransformCategoryEnum;
+
+  this->m_RANSACInliers.clear();
+  if ( this->m_RANSACNumberOfIterations > 0 )
+    {
+    if( itkTx->GetTransformCategory() == TransformCategoryEnum::BSpline )
+      {
+      sitkExceptionMacro( "RANSAC is not supported for the BSplineTransform." );
+      }
+    if ( fixedITKPoints.size() != movingITKPoints.size() )
+      {
+      sitkExceptionMacro( "The number of fixed and moving landmarks must be equal!" );
+      }
+
+    this->m_RANSACInliers = RANSACInliers<FilterType>( *inTransform,
+                                                       fixedITKPoints,
+                                                       movingITKPoints,
+                                                       this->m_RANSACNumberOfIterations,
+                                                       this->m_RANSACInlierThreshold,
+                                                       this->m_RANSACSeed,
+                                                       this->GetNumberOfThreads() );
+
+    // the transform is fit to the inliers only
+    filter->SetFixedLandmarks( SelectPoints( fixedITKPoints, this->m_RANSACInliers ) );
+    filter->SetMovingLandmarks( SelectPoints( movingITKPoints, this->m_RANSACInliers ) );
+    if ( !this->m_LandmarkWeight.empty() )
+      {
+      std::vector<double> weights;
+      for ( uint32_t i : this->m_RANSACInliers )
+        {
+        weights.push_back( this->m_LandmarkWeight.at( i ) );
+        }
+      filter->SetLandmarkWeight( weights );
+      }
+    }
   // BSpline specific setup
   if( itkTx->GetTransformCategory() == TransformCategoryEnum::BSpline )
     {
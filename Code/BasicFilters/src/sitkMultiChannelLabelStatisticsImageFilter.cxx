@@ -0,0 +1,194 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+
+#include "sitkMultiChannelLabelStatisticsImageFilter.h"
+#include "sitkTemplateFunctions.h"
+#include "itkMultiChannelLabelStatisticsImageFilter.h"
+#include "itkVectorImage.h"
+
+#include <algorithm>
+
+namespace itk {
+  namespace simple {
+
+    MultiChannelLabelStatisticsImageFilter::~MultiChannelLabelStatisticsImageFilter ()
+    = default;
+
+    MultiChannelLabelStatisticsImageFilter::MultiChannelLabelStatisticsImageFilter ()
+      : m_NumberOfChannels( 0 )
+    {
+      this->m_DualMemberFactory.reset( new detail::DualMemberFunctionFactory<MemberFunctionType>( this ) );
+
+      this->m_DualMemberFactory->RegisterMemberFunctions< PixelIDTypeList, PixelIDTypeList2, 3 > ();
+      this->m_DualMemberFactory->RegisterMemberFunctions< PixelIDTypeList, PixelIDTypeList2, 2 > ();
+    }
+
+    std::string MultiChannelLabelStatisticsImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::MultiChannelLabelStatisticsImageFilter" << std::endl;
+      out << "  NumberOfLabels: " << this->m_Labels.size() << std::endl;
+      out << "  NumberOfChannels: " << this->m_NumberOfChannels << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    void MultiChannelLabelStatisticsImageFilter::Execute ( const Image &image, const Image &labelImage )
+    {
+      this->Execute( std::vector<Image>( 1, image ), labelImage );
+    }
+
+    void MultiChannelLabelStatisticsImageFilter::Execute ( const std::vector<Image> &images, const Image &labelImage )
+    {
+      if ( images.empty() )
+        {
+        sitkExceptionMacro( "At least one intensity image is required!" );
+        }
+      for ( const Image &image : images )
+        {
+        if ( image.GetDimension() != labelImage.GetDimension() || image.GetSize() != labelImage.GetSize() )
+          {
+          sitkExceptionMacro( "The intensity image of size " << image.GetSize()
+                              << " does not match the label image of size " << labelImage.GetSize() << "!" );
+          }
+        }
+
+      PixelIDValueEnum type = images.front().GetPixelID();
+      PixelIDValueEnum labelType = labelImage.GetPixelID();
+      unsigned int dimension = labelImage.GetDimension();
+
+      this->m_DualMemberFactory->GetMemberFunction( type, labelType, dimension )( images, labelImage );
+    }
+
+    template <class TImageType, class TLabelImageType>
+    void MultiChannelLabelStatisticsImageFilter::DualExecuteInternal ( const std::vector<Image> &images, const Image &inLabelImage )
+    {
+      constexpr unsigned int Dimension = TImageType::ImageDimension;
+      using ComponentType = typename TImageType::InternalPixelType;
+      using ScalarImageType = itk::Image<ComponentType, Dimension>;
+      using VectorImageType = itk::VectorImage<ComponentType, Dimension>;
+
+      // the scalar channels share their buffer with a vector image of
+      // one component
+      std::vector<typename VectorImageType::ConstPointer> channels;
+      for ( const Image &image : images )
+        {
+        if ( const VectorImageType *vectorImage = dynamic_cast<const VectorImageType *>( image.GetITKBase() ) )
+          {
+          channels.push_back( vectorImage );
+          }
+        else if ( const ScalarImageType *scalarImage = dynamic_cast<const ScalarImageType *>( image.GetITKBase() ) )
+          {
+          typename VectorImageType::Pointer channel = VectorImageType::New();
+          channel->CopyInformation( scalarImage );
+          channel->SetRegions( scalarImage->GetBufferedRegion() );
+          channel->SetNumberOfComponentsPerPixel( 1 );
+          channel->SetPixelContainer( const_cast<typename ScalarImageType::PixelContainer *>( scalarImage->GetPixelContainer() ) );
+          channels.push_back( channel.GetPointer() );
+          }
+        else
+          {
+          sitkExceptionMacro( "The intensity images must have the same component type, but an image of pixel type "
+                              << image.GetPixelIDTypeAsString() << " follows one of pixel type "
+                              << images.front().GetPixelIDTypeAsString() << "!" );
+          }
+        }
+
+      typename TLabelImageType::ConstPointer labelImage =
+        dynamic_cast <const TLabelImageType*> ( inLabelImage.GetITKBase() );
+
+      using FilterType = itk::MultiChannelLabelStatisticsImageFilter<VectorImageType, TLabelImageType>;
+      typename FilterType::Pointer filter = FilterType::New();
+      for ( unsigned int k = 0; k < channels.size(); ++k )
+        {
+        filter->SetInput( k, channels[k] );
+        }
+      filter->SetLabelImage( labelImage );
+
+      this->PreUpdate( filter.GetPointer() );
+
+      filter->Update();
+
+      const auto &labels = filter->GetLabels();
+      this->m_Labels.assign( labels.begin(), labels.end() );
+      this->m_NumberOfChannels = filter->GetNumberOfChannels();
+      this->m_Counts.assign( filter->GetCounts().begin(), filter->GetCounts().end() );
+      this->m_Minimum = filter->GetMinimums();
+      this->m_Maximum = filter->GetMaximums();
+      this->m_Mean = filter->GetMeans();
+      this->m_Sigma = filter->GetSigmas();
+      this->m_Variance = filter->GetVariances();
+      this->m_Sum = filter->GetSums();
+    }
+
+    size_t MultiChannelLabelStatisticsImageFilter::GetLabelPosition ( int64_t label ) const
+    {
+      auto it = std::lower_bound( this->m_Labels.begin(), this->m_Labels.end(), label );
+      if ( it == this->m_Labels.end() || *it != label )
+        {
+        sitkExceptionMacro( "The label " << label << " does not exist!" );
+        }
+      return it - this->m_Labels.begin();
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetChannelValues ( const std::vector<double> &values, int64_t label ) const
+    {
+      const size_t first = this->GetLabelPosition( label ) * this->m_NumberOfChannels;
+      return std::vector<double>( values.begin() + first, values.begin() + first + this->m_NumberOfChannels );
+    }
+
+    bool MultiChannelLabelStatisticsImageFilter::HasLabel ( int64_t label ) const
+    {
+      return std::binary_search( this->m_Labels.begin(), this->m_Labels.end(), label );
+    }
+
+    uint64_t MultiChannelLabelStatisticsImageFilter::GetCount ( int64_t label ) const
+    {
+      return this->m_Counts[this->GetLabelPosition( label )];
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetMinimum ( int64_t label ) const
+    {
+      return this->GetChannelValues( this->m_Minimum, label );
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetMaximum ( int64_t label ) const
+    {
+      return this->GetChannelValues( this->m_Maximum, label );
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetMean ( int64_t label ) const
+    {
+      return this->GetChannelValues( this->m_Mean, label );
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetSigma ( int64_t label ) const
+    {
+      return this->GetChannelValues( this->m_Sigma, label );
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetVariance ( int64_t label ) const
+    {
+      return this->GetChannelValues( this->m_Variance, label );
+    }
+
+    std::vector<double> MultiChannelLabelStatisticsImageFilter::GetSum ( int64_t label ) const
+    {
+      return this->GetChannelValues( this->m_Sum, label );
+    }
+  }
+}
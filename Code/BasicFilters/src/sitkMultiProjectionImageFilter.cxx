@@ -0,0 +1,233 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkMultiProjectionImageFilter.h"
+#include "itkMultiProjectionImageFilter.h"
+
+namespace itk {
+  namespace simple {
+
+    MultiProjectionImageFilter::~MultiProjectionImageFilter ()
+    = default;
+
+    MultiProjectionImageFilter::MultiProjectionImageFilter ()
+      : m_ProjectionDimension( 0u ),
+        m_Compute( NumberOfProjections, true ),
+        m_Projections( NumberOfProjections ),
+        m_Computed( NumberOfProjections, false )
+    {
+      this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2, SITK_MAX_DIMENSION > ();
+    }
+
+    std::string MultiProjectionImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::MultiProjectionImageFilter" << std::endl;
+      out << "  ProjectionDimension: " << this->m_ProjectionDimension << std::endl;
+      out << "  ComputeMaximum: " << this->m_Compute[Maximum] << std::endl;
+      out << "  ComputeMinimum: " << this->m_Compute[Minimum] << std::endl;
+      out << "  ComputeMedian: " << this->m_Compute[Median] << std::endl;
+      out << "  ComputeMean: " << this->m_Compute[Mean] << std::endl;
+      out << "  ComputeSum: " << this->m_Compute[Sum] << std::endl;
+      out << "  ComputeStandardDeviation: " << this->m_Compute[StandardDeviation] << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetProjectionDimension ( unsigned int projectionDimension )
+      {
+      this->m_ProjectionDimension = projectionDimension;
+      return *this;
+      }
+
+    unsigned int MultiProjectionImageFilter::GetProjectionDimension () const
+    {
+      return this->m_ProjectionDimension;
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetComputeMaximum ( bool computeMaximum )
+      {
+      this->m_Compute[Maximum] = computeMaximum;
+      return *this;
+      }
+
+    bool MultiProjectionImageFilter::GetComputeMaximum () const
+    {
+      return this->m_Compute[Maximum];
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetComputeMinimum ( bool computeMinimum )
+      {
+      this->m_Compute[Minimum] = computeMinimum;
+      return *this;
+      }
+
+    bool MultiProjectionImageFilter::GetComputeMinimum () const
+    {
+      return this->m_Compute[Minimum];
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetComputeMedian ( bool computeMedian )
+      {
+      this->m_Compute[Median] = computeMedian;
+      return *this;
+      }
+
+    bool MultiProjectionImageFilter::GetComputeMedian () const
+    {
+      return this->m_Compute[Median];
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetComputeMean ( bool computeMean )
+      {
+      this->m_Compute[Mean] = computeMean;
+      return *this;
+      }
+
+    bool MultiProjectionImageFilter::GetComputeMean () const
+    {
+      return this->m_Compute[Mean];
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetComputeSum ( bool computeSum )
+      {
+      this->m_Compute[Sum] = computeSum;
+      return *this;
+      }
+
+    bool MultiProjectionImageFilter::GetComputeSum () const
+    {
+      return this->m_Compute[Sum];
+    }
+
+    MultiProjectionImageFilter& MultiProjectionImageFilter::SetComputeStandardDeviation ( bool computeStandardDeviation )
+      {
+      this->m_Compute[StandardDeviation] = computeStandardDeviation;
+      return *this;
+      }
+
+    bool MultiProjectionImageFilter::GetComputeStandardDeviation () const
+    {
+      return this->m_Compute[StandardDeviation];
+    }
+
+    void MultiProjectionImageFilter::Execute ( const Image &image )
+    {
+      if ( this->m_ProjectionDimension >= image.GetDimension() )
+        {
+        sitkExceptionMacro( "The ProjectionDimension " << this->m_ProjectionDimension
+                            << " is not a dimension of the image of dimension " << image.GetDimension() << "!" );
+        }
+
+      PixelIDValueEnum type = image.GetPixelID();
+      unsigned int dimension = image.GetDimension();
+
+      this->m_MemberFactory->GetMemberFunction( type, dimension )( image );
+    }
+
+    template <class TImageType>
+    void MultiProjectionImageFilter::ExecuteInternal ( const Image &inImage )
+    {
+      using InputImageType = TImageType;
+
+      typename InputImageType::ConstPointer image =
+        dynamic_cast <const InputImageType*> ( inImage.GetITKBase() );
+
+      using FilterType = itk::MultiProjectionImageFilter<InputImageType>;
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( image );
+      filter->SetProjectionDimension( this->m_ProjectionDimension );
+      filter->SetComputeMaximum( this->m_Compute[Maximum] );
+      filter->SetComputeMinimum( this->m_Compute[Minimum] );
+      filter->SetComputeMedian( this->m_Compute[Median] );
+      filter->SetComputeMean( this->m_Compute[Mean] );
+      filter->SetComputeSum( this->m_Compute[Sum] );
+      filter->SetComputeStandardDeviation( this->m_Compute[StandardDeviation] );
+
+      this->PreUpdate( filter.GetPointer() );
+
+      filter->Update();
+
+      this->m_Projections.assign( NumberOfProjections, Image() );
+      this->m_Computed = this->m_Compute;
+      if ( this->m_Computed[Maximum] )
+        {
+        this->m_Projections[Maximum] = this->CastITKToImage( filter->GetMaximumOutput() );
+        }
+      if ( this->m_Computed[Minimum] )
+        {
+        this->m_Projections[Minimum] = this->CastITKToImage( filter->GetMinimumOutput() );
+        }
+      if ( this->m_Computed[Median] )
+        {
+        this->m_Projections[Median] = this->CastITKToImage( filter->GetMedianOutput() );
+        }
+      if ( this->m_Computed[Mean] )
+        {
+        this->m_Projections[Mean] = this->CastITKToImage( filter->GetMeanOutput() );
+        }
+      if ( this->m_Computed[Sum] )
+        {
+        this->m_Projections[Sum] = this->CastITKToImage( filter->GetSumOutput() );
+        }
+      if ( this->m_Computed[StandardDeviation] )
+        {
+        this->m_Projections[StandardDeviation] = this->CastITKToImage( filter->GetStandardDeviationOutput() );
+        }
+    }
+
+    Image MultiProjectionImageFilter::GetProjection ( ProjectionType projection, const char *name ) const
+    {
+      if ( !this->m_Computed[projection] )
+        {
+        sitkExceptionMacro( "The " << name << " projection was not computed by the last execution!" );
+        }
+      return this->m_Projections[projection];
+    }
+
+    Image MultiProjectionImageFilter::GetMaximumProjection () const
+    {
+      return this->GetProjection( Maximum, "Maximum" );
+    }
+
+    Image MultiProjectionImageFilter::GetMinimumProjection () const
+    {
+      return this->GetProjection( Minimum, "Minimum" );
+    }
+
+    Image MultiProjectionImageFilter::GetMedianProjection () const
+    {
+      return this->GetProjection( Median, "Median" );
+    }
+
+    Image MultiProjectionImageFilter::GetMeanProjection () const
+    {
+      return this->GetProjection( Mean, "Mean" );
+    }
+
+    Image MultiProjectionImageFilter::GetSumProjection () const
+    {
+      return this->GetProjection( Sum, "Sum" );
+    }
+
+    Image MultiProjectionImageFilter::GetStandardDeviationProjection () const
+    {
+      return this->GetProjection( StandardDeviation, "StandardDeviation" );
+    }
+  }
+}
@@ -0,0 +1,269 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkMultiResolutionDemonsRegistrationFilter.h"
+#include "sitkImageConvert.hxx"
+
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkMultiResolutionPDEDeformableRegistration.h"
+#include "itkDemonsRegistrationFilter.h"
+#include "itkSymmetricForcesDemonsRegistrationFilter.h"
+#include "itkFastSymmetricForcesDemonsRegistrationFilter.h"
+#include "itkDiffeomorphicDemonsRegistrationFilter.h"
+
+namespace itk {
+namespace simple {
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+// Set the maximum update step length of the filters which have one.
+template <class TRegistrationFilter>
+void SetMaximumUpdateStepLength( TRegistrationFilter *, double )
+{
+}
+
+template <class TFixed, class TMoving, class TField>
+void SetMaximumUpdateStepLength( itk::FastSymmetricForcesDemonsRegistrationFilter<TFixed, TMoving, TField> *filter, double length )
+{
+  filter->SetMaximumUpdateStepLength( length );
+}
+
+template <class TFixed, class TMoving, class TField>
+void SetMaximumUpdateStepLength( itk::DiffeomorphicDemonsRegistrationFilter<TFixed, TMoving, TField> *filter, double length )
+{
+  filter->SetMaximumUpdateStepLength( length );
+}
+
+}
+
+//
+// Default constructor that initializes parameters
+//
+MultiResolutionDemonsRegistrationFilter::MultiResolutionDemonsRegistrationFilter ()
+  : m_DemonsRegistrationType( Demons ),
+    m_NumberOfIterations{ 32u, 16u, 8u },
+    m_StandardDeviations( 3, 1.0 ),
+    m_MaximumRMSError( 0.02 ),
+    m_MaximumUpdateStepLength( 0.5 ),
+    m_IntensityDifferenceThreshold( 0.001 ),
+    m_UseImageSpacing( true ),
+    m_ElapsedIterations( 0 ),
+    m_RMSChange( 0.0 ),
+    m_Metric( 0.0 )
+{
+  this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+  this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 3 > ();
+  this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2 > ();
+}
+
+//
+// Destructor
+//
+MultiResolutionDemonsRegistrationFilter::~MultiResolutionDemonsRegistrationFilter () = default;
+
+
+//
+// ToString
+//
+std::string MultiResolutionDemonsRegistrationFilter::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::MultiResolutionDemonsRegistrationFilter\n";
+  out << "  DemonsRegistrationType: ";
+  this->ToStringHelper(out, this->m_DemonsRegistrationType);
+  out << std::endl;
+  out << "  NumberOfIterations: ";
+  this->ToStringHelper(out, this->m_NumberOfIterations);
+  out << std::endl;
+  out << "  ShrinkFactorsPerLevel: ";
+  this->ToStringHelper(out, this->m_ShrinkFactorsPerLevel);
+  out << std::endl;
+  out << "  StandardDeviations: ";
+  this->ToStringHelper(out, this->m_StandardDeviations);
+  out << std::endl;
+  out << "  MaximumRMSError: ";
+  this->ToStringHelper(out, this->m_MaximumRMSError);
+  out << std::endl;
+  out << "  MaximumUpdateStepLength: ";
+  this->ToStringHelper(out, this->m_MaximumUpdateStepLength);
+  out << std::endl;
+  out << "  IntensityDifferenceThreshold: ";
+  this->ToStringHelper(out, this->m_IntensityDifferenceThreshold);
+  out << std::endl;
+  out << "  UseImageSpacing: ";
+  this->ToStringHelper(out, this->m_UseImageSpacing);
+  out << std::endl;
+  out << "  ElapsedIterations: ";
+  this->ToStringHelper(out, this->m_ElapsedIterations);
+  out << std::endl;
+  out << "  RMSChange: ";
+  this->ToStringHelper(out, this->m_RMSChange);
+  out << std::endl;
+  out << "  Metric: ";
+  this->ToStringHelper(out, this->m_Metric);
+  out << std::endl;
+
+  out << ProcessObject::ToString();
+  return out.str();
+}
+
+//
+// Execute
+//
+Image MultiResolutionDemonsRegistrationFilter::Execute ( const Image & fixedImage, const Image & movingImage )
+{
+  this->CheckImageMatchingDimension( fixedImage, movingImage, "MovingImage" );
+  this->CheckImageMatchingPixelType( fixedImage, movingImage, "MovingImage" );
+
+  return this->m_MemberFactory->GetMemberFunction( fixedImage.GetPixelID(), fixedImage.GetDimension() )( &fixedImage, &movingImage, nullptr );
+}
+
+Image MultiResolutionDemonsRegistrationFilter::Execute ( const Image & fixedImage, const Image & movingImage, const Image & initialDisplacementField )
+{
+  this->CheckImageMatchingDimension( fixedImage, movingImage, "MovingImage" );
+  this->CheckImageMatchingPixelType( fixedImage, movingImage, "MovingImage" );
+  this->CheckImageMatchingDimension( fixedImage, initialDisplacementField, "InitialDisplacementField" );
+
+  if ( initialDisplacementField.GetPixelID() != sitkVectorFloat64 )
+    {
+    sitkExceptionMacro( "Expected the initial displacement field to be of pixel type " << sitkVectorFloat64 << "!" );
+    }
+
+  return this->m_MemberFactory->GetMemberFunction( fixedImage.GetPixelID(), fixedImage.GetDimension() )( &fixedImage, &movingImage, &initialDisplacementField );
+}
+
+
+//-----------------------------------------------------------------------------
+
+//
+// ExecuteInternal
+//
+template <class TImageType>
+Image MultiResolutionDemonsRegistrationFilter::ExecuteInternal ( const Image * inFixedImage,
+                                                                  const Image * inMovingImage,
+                                                                  const Image * inInitialDisplacementField )
+{
+  constexpr unsigned int Dimension = TImageType::ImageDimension;
+
+  // the registration of each level is on the float images of the pyramid
+  using FloatImageType = itk::Image<float, Dimension>;
+  using DisplacementFieldType = itk::Image< itk::Vector<double, Dimension>, Dimension >;
+
+  switch ( this->m_DemonsRegistrationType )
+    {
+    case Demons:
+      return this->ExecuteInternalWithRegistration<TImageType,
+        itk::DemonsRegistrationFilter<FloatImageType, FloatImageType, DisplacementFieldType> >( inFixedImage, inMovingImage, inInitialDisplacementField );
+    case SymmetricForces:
+      return this->ExecuteInternalWithRegistration<TImageType,
+        itk::SymmetricForcesDemonsRegistrationFilter<FloatImageType, FloatImageType, DisplacementFieldType> >( inFixedImage, inMovingImage, inInitialDisplacementField );
+    case FastSymmetricForces:
+      return this->ExecuteInternalWithRegistration<TImageType,
+        itk::FastSymmetricForcesDemonsRegistrationFilter<FloatImageType, FloatImageType, DisplacementFieldType> >( inFixedImage, inMovingImage, inInitialDisplacementField );
+    case Diffeomorphic:
+      return this->ExecuteInternalWithRegistration<TImageType,
+        itk::DiffeomorphicDemonsRegistrationFilter<FloatImageType, FloatImageType, DisplacementFieldType> >( inFixedImage, inMovingImage, inInitialDisplacementField );
+    default:
+      sitkExceptionMacro( "Unexpected demons registration type: " << this->m_DemonsRegistrationType );
+    }
+}
+
+
+template <class TImageType, class TRegistrationFilter>
+Image MultiResolutionDemonsRegistrationFilter::ExecuteInternalWithRegistration ( const Image * inFixedImage,
+                                                                                  const Image * inMovingImage,
+                                                                                  const Image * inInitialDisplacementField )
+{
+  constexpr unsigned int Dimension = TImageType::ImageDimension;
+
+  using DisplacementFieldType = typename TRegistrationFilter::DisplacementFieldType;
+  using FilterType = itk::MultiResolutionPDEDeformableRegistration<TImageType, TImageType, DisplacementFieldType>;
+
+  const unsigned int numberOfLevels = static_cast<unsigned int>( this->m_NumberOfIterations.size() );
+  if ( numberOfLevels == 0 )
+    {
+    sitkExceptionMacro( "At least one level of NumberOfIterations is required!" );
+    }
+  if ( !this->m_ShrinkFactorsPerLevel.empty() && this->m_ShrinkFactorsPerLevel.size() != numberOfLevels )
+    {
+    sitkExceptionMacro( "The number of ShrinkFactorsPerLevel ( " << this->m_ShrinkFactorsPerLevel.size()
+                        << " ) does not match the number of levels of NumberOfIterations ( " << numberOfLevels << " )!" );
+    }
+  if ( this->m_StandardDeviations.size() < Dimension )
+    {
+    sitkExceptionMacro( "Expected at least " << Dimension << " StandardDeviations!" );
+    }
+
+  typename TRegistrationFilter::Pointer registration = TRegistrationFilter::New();
+  double standardDeviations[Dimension];
+  std::copy_n( this->m_StandardDeviations.begin(), Dimension, standardDeviations );
+  registration->SetStandardDeviations( standardDeviations );
+  registration->SetMaximumRMSError( this->m_MaximumRMSError );
+  registration->SetIntensityDifferenceThreshold( this->m_IntensityDifferenceThreshold );
+  registration->SetUseImageSpacing( this->m_UseImageSpacing );
+  SetMaximumUpdateStepLength( registration.GetPointer(), this->m_MaximumUpdateStepLength );
+
+  typename FilterType::Pointer filter = FilterType::New();
+
+  filter->SetFixedImage( this->CastImageToITK<TImageType>( *inFixedImage ) );
+  filter->SetMovingImage( this->CastImageToITK<TImageType>( *inMovingImage ) );
+  if ( inInitialDisplacementField )
+    {
+    using VectorImageType = itk::VectorImage<double, Dimension>;
+    filter->SetArbitraryInitialDisplacementField( GetImageFromVectorImage( const_cast<VectorImageType*>( this->CastImageToITK<VectorImageType>( *inInitialDisplacementField ).GetPointer() ) ) );
+    }
+
+  filter->SetRegistrationFilter( registration );
+  filter->SetNumberOfLevels( numberOfLevels );
+  filter->SetNumberOfIterations( typename FilterType::NumberOfIterationsType( this->m_NumberOfIterations.begin(), this->m_NumberOfIterations.end() ) );
+
+  if ( !this->m_ShrinkFactorsPerLevel.empty() )
+    {
+    typename FilterType::FixedImagePyramidType::ScheduleType schedule( numberOfLevels, Dimension );
+    for ( unsigned int level = 0; level < numberOfLevels; ++level )
+      {
+      schedule.fill_row( level, this->m_ShrinkFactorsPerLevel[level] );
+      }
+    filter->GetModifiableFixedImagePyramid()->SetSchedule( schedule );
+    filter->GetModifiableMovingImagePyramid()->SetSchedule( schedule );
+    }
+
+  // the iterations of all the levels are counted as they run
+  this->m_ElapsedIterations = 0;
+  this->m_RMSChange = 0.0;
+  this->m_Metric = 0.0;
+  registration->AddObserver( itk::IterationEvent(), [this]( const itk::EventObject & ) { ++this->m_ElapsedIterations; } );
+
+  this->PreUpdate( filter.GetPointer() );
+
+  filter->Update();
+
+  this->m_RMSChange = registration->GetRMSChange();
+  this->m_Metric = registration->GetMetric();
+
+  typename DisplacementFieldType::Pointer itkOutImage{ filter->GetOutput() };
+  filter = nullptr;
+  this->FixNonZeroIndex( itkOutImage.GetPointer() );
+  return Image{ this->CastITKToImage( itkOutImage.GetPointer() ) };
+}
+
+} // end namespace simple
+} // end namespace itk
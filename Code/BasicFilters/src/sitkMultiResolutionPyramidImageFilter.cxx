@@ -0,0 +1,143 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkMultiResolutionPyramidImageFilter.h"
+#include "itkFusedMultiResolutionPyramidImageFilter.h"
+
+#include <type_traits>
+
+namespace itk {
+  namespace simple {
+
+    MultiResolutionPyramidImageFilter::~MultiResolutionPyramidImageFilter ()
+    = default;
+
+    MultiResolutionPyramidImageFilter::MultiResolutionPyramidImageFilter ()
+      : m_ShrinkFactorsPerLevel( {4u, 2u, 1u} ),
+        m_SmoothingSigmasPerLevel( {2.0, 1.0, 0.0} ),
+        m_SmoothingSigmasAreSpecifiedInPhysicalUnits( true )
+    {
+      this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2, SITK_MAX_DIMENSION > ();
+    }
+
+    std::string MultiResolutionPyramidImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::MultiResolutionPyramidImageFilter" << std::endl;
+      out << "  ShrinkFactorsPerLevel: " << this->m_ShrinkFactorsPerLevel << std::endl;
+      out << "  SmoothingSigmasPerLevel: " << this->m_SmoothingSigmasPerLevel << std::endl;
+      out << "  SmoothingSigmasAreSpecifiedInPhysicalUnits: " << this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    MultiResolutionPyramidImageFilter& MultiResolutionPyramidImageFilter::SetShrinkFactorsPerLevel ( const std::vector<unsigned int> &shrinkFactors )
+      {
+      this->m_ShrinkFactorsPerLevel = shrinkFactors;
+      return *this;
+      }
+
+    std::vector<unsigned int> MultiResolutionPyramidImageFilter::GetShrinkFactorsPerLevel () const
+    {
+      return this->m_ShrinkFactorsPerLevel;
+    }
+
+    MultiResolutionPyramidImageFilter& MultiResolutionPyramidImageFilter::SetSmoothingSigmasPerLevel ( const std::vector<double> &smoothingSigmas )
+      {
+      this->m_SmoothingSigmasPerLevel = smoothingSigmas;
+      return *this;
+      }
+
+    std::vector<double> MultiResolutionPyramidImageFilter::GetSmoothingSigmasPerLevel () const
+    {
+      return this->m_SmoothingSigmasPerLevel;
+    }
+
+    MultiResolutionPyramidImageFilter& MultiResolutionPyramidImageFilter::SetSmoothingSigmasAreSpecifiedInPhysicalUnits ( bool physicalUnits )
+      {
+      this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits = physicalUnits;
+      return *this;
+      }
+
+    bool MultiResolutionPyramidImageFilter::GetSmoothingSigmasAreSpecifiedInPhysicalUnits () const
+    {
+      return this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
+    }
+
+    std::vector<Image> MultiResolutionPyramidImageFilter::Execute ( const Image &image )
+    {
+      if ( this->m_ShrinkFactorsPerLevel.empty() )
+        {
+        sitkExceptionMacro( "The ShrinkFactorsPerLevel are empty!" );
+        }
+      if ( this->m_ShrinkFactorsPerLevel.size() != this->m_SmoothingSigmasPerLevel.size() )
+        {
+        sitkExceptionMacro( "The " << this->m_ShrinkFactorsPerLevel.size() << " ShrinkFactorsPerLevel do not match the "
+                            << this->m_SmoothingSigmasPerLevel.size() << " SmoothingSigmasPerLevel!" );
+        }
+
+      PixelIDValueEnum type = image.GetPixelID();
+      unsigned int dimension = image.GetDimension();
+
+      return this->m_MemberFactory->GetMemberFunction( type, dimension )( image );
+    }
+
+    template <class TImageType>
+    std::vector<Image> MultiResolutionPyramidImageFilter::ExecuteInternal ( const Image &inImage )
+    {
+      using InputImageType = TImageType;
+      using OutputPixelType = typename std::conditional<std::is_same<typename InputImageType::PixelType, double>::value,
+                                                        double, float>::type;
+      using OutputImageType = itk::Image<OutputPixelType, InputImageType::ImageDimension>;
+
+      typename InputImageType::ConstPointer image =
+        dynamic_cast <const InputImageType*> ( inImage.GetITKBase() );
+
+      using FilterType = itk::FusedMultiResolutionPyramidImageFilter<InputImageType, OutputImageType>;
+      typename FilterType::Pointer filter = FilterType::New();
+      filter->SetInput( image );
+      filter->SetShrinkFactorsPerLevel( this->m_ShrinkFactorsPerLevel );
+      filter->SetSmoothingSigmasPerLevel( this->m_SmoothingSigmasPerLevel );
+      filter->SetSmoothingSigmasAreSpecifiedInPhysicalUnits( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits );
+
+      this->PreUpdate( filter.GetPointer() );
+
+      filter->Update();
+
+      std::vector<Image> levels;
+      levels.reserve( filter->GetNumberOfLevels() );
+      for ( unsigned int level = 0; level < filter->GetNumberOfLevels(); ++level )
+        {
+        levels.push_back( this->CastITKToImage( filter->GetLevelOutput( level ) ) );
+        }
+      return levels;
+    }
+
+    std::vector<Image> MultiResolutionPyramid ( const Image &image,
+                                                const std::vector<unsigned int> &shrinkFactors,
+                                                const std::vector<double> &smoothingSigmas,
+                                                bool smoothingSigmasAreSpecifiedInPhysicalUnits )
+    {
+      MultiResolutionPyramidImageFilter filter;
+      filter.SetShrinkFactorsPerLevel( shrinkFactors );
+      filter.SetSmoothingSigmasPerLevel( smoothingSigmas );
+      filter.SetSmoothingSigmasAreSpecifiedInPhysicalUnits( smoothingSigmasAreSpecifiedInPhysicalUnits );
+      return filter.Execute( image );
+    }
+  }
+}
@@ -35,6 +35,11 @@
 
 #include "sitkToPixelType.hxx"
 
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 
 
 namespace itk {
@@ -127,6 +132,272 @@ Image PasteImageFilter::Execute ( Image && destinationImage, double constant )
   return this->Execute( destinationImage, constant );
 }
 
+Image PasteImageFilter::Execute ( const Image & destinationImage,
+                                  const std::vector<Image> & sourceImages,
+                                  const std::vector< std::vector<int> > & destinationIndices )
+{
+  Image output = destinationImage;
+  this->PasteInternal( output, sourceImages, destinationIndices );
+  return output;
+}
+Image PasteImageFilter::Execute ( Image && destinationImage,
+                                  const std::vector<Image> & sourceImages,
+                                  const std::vector< std::vector<int> > & destinationIndices )
+{
+  // the buffer of a unique destination is reused
+  Image output( std::move( destinationImage ) );
+  this->PasteInternal( output, sourceImages, destinationIndices );
+  return output;
+}
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+// The copies of the pixels of a source image into the destination,
+// as blocks of contiguous bytes in both buffers.
+struct PasteCopies
+{
+  const char *source;
+  std::vector<size_t> sourceStrides;
+  size_t destinationOffset;
+  std::vector<size_t> destinationStrides;
+  // the number of blocks along the axes after the block
+  std::vector<size_t> counts;
+  size_t blockSize;
+  size_t numberOfBlocks;
+  std::vector<int64_t> first;
+  std::vector<int64_t> last;
+};
+
+bool Overlap( const PasteCopies &a, const PasteCopies &b )
+{
+  for ( size_t d = 0; d < a.first.size(); ++d )
+    {
+    if ( a.last[d] < b.first[d] || b.last[d] < a.first[d] )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+void PasteImageFilter::PasteInternal ( Image & destinationImage,
+                                       const std::vector<Image> & sourceImages,
+                                       const std::vector< std::vector<int> > & destinationIndices )
+{
+  if ( sourceImages.size() != destinationIndices.size() )
+    {
+    sitkExceptionMacro( "The number of source images " << sourceImages.size()
+                        << " differs from the number of destination indices " << destinationIndices.size() << "." );
+    }
+
+  const unsigned int dimension = destinationImage.GetDimension();
+  const std::vector<unsigned int> destinationSize = destinationImage.GetSize();
+  const size_t pixelSize = size_t( destinationImage.GetSizeOfPixelComponent() ) * destinationImage.GetNumberOfComponentsPerPixel();
+
+  std::vector<size_t> destinationStrides( dimension, pixelSize );
+  for ( unsigned int d = 1; d < dimension; ++d )
+    {
+    destinationStrides[d] = destinationStrides[d - 1] * destinationSize[d - 1];
+    }
+
+  std::vector<PasteCopies> copies;
+  for ( size_t i = 0; i < sourceImages.size(); ++i )
+    {
+    const Image &source = sourceImages[i];
+    std::ostringstream name;
+    name << "sourceImages[" << i << "]";
+    CheckImageMatchingPixelType( destinationImage, source, name.str() );
+    if ( source.GetNumberOfComponentsPerPixel() != destinationImage.GetNumberOfComponentsPerPixel() )
+      {
+      sitkExceptionMacro( "The " << name.str() << " has " << source.GetNumberOfComponentsPerPixel()
+                          << " components while the destination image has " << destinationImage.GetNumberOfComponentsPerPixel() << "." );
+      }
+    if ( source.GetDimension() > dimension )
+      {
+      sitkExceptionMacro( "Unable to use the " << name.str() << " of dimension " << source.GetDimension()
+                          << " with destination dimension of " << dimension << "." );
+      }
+    if ( destinationIndices[i].size() != dimension )
+      {
+      sitkExceptionMacro( "The destination index " << i << " has " << destinationIndices[i].size()
+                          << " elements while the destination image has dimension " << dimension << "." );
+      }
+
+    // the destination axes of the source axes, as in DestinationSkipAxes
+    std::vector<bool> skipAxes = m_DestinationSkipAxes;
+    if ( skipAxes.empty() )
+      {
+      skipAxes.resize( dimension, true );
+      std::fill( skipAxes.begin(), skipAxes.begin() + source.GetDimension(), false );
+      }
+    if ( skipAxes.size() != dimension ||
+         std::count( skipAxes.begin(), skipAxes.end(), false ) != static_cast<std::ptrdiff_t>( source.GetDimension() ) )
+      {
+      sitkExceptionMacro( "The DestinationSkipAxes must have " << dimension << " elements, with "
+                          << source.GetDimension() << " false values for the " << name.str() << "." );
+      }
+
+    const std::vector<unsigned int> sourceSize = source.GetSize();
+    std::vector<size_t> size( dimension, 1 );
+    std::vector<size_t> sourceStrides( dimension, 0 );
+    size_t sourceStride = pixelSize;
+    for ( unsigned int d = 0, s = 0; d < dimension; ++d )
+      {
+      if ( !skipAxes[d] )
+        {
+        size[d] = sourceSize[s++];
+        sourceStrides[d] = sourceStride;
+        sourceStride *= size[d];
+        }
+      }
+
+    // the part of the source inside the destination
+    PasteCopies copy;
+    copy.source = static_cast<const char *>( source.GetBufferAsVoid() );
+    copy.sourceStrides = sourceStrides;
+    copy.destinationOffset = 0;
+    copy.destinationStrides = destinationStrides;
+    copy.first.resize( dimension );
+    copy.last.resize( dimension );
+    bool empty = false;
+    for ( unsigned int d = 0; d < dimension; ++d )
+      {
+      const int64_t index = destinationIndices[i][d];
+      copy.first[d] = std::max<int64_t>( index, 0 );
+      copy.last[d] = std::min<int64_t>( index + static_cast<int64_t>( size[d] ), destinationSize[d] ) - 1;
+      empty = empty || copy.first[d] > copy.last[d];
+      copy.source += ( copy.first[d] - index ) * sourceStrides[d];
+      copy.destinationOffset += copy.first[d] * destinationStrides[d];
+      }
+    if ( empty )
+      {
+      continue;
+      }
+
+    // the contiguous block, which extends along the following axes
+    // while the previous axes are complete in both images
+    unsigned int blockAxes = 0;
+    copy.blockSize = pixelSize;
+    while ( blockAxes < dimension )
+      {
+      const size_t extent = copy.last[blockAxes] - copy.first[blockAxes] + 1;
+      const bool complete = ( extent == destinationSize[blockAxes] && extent == size[blockAxes] );
+      copy.blockSize *= extent;
+      ++blockAxes;
+      if ( !complete )
+        {
+        break;
+        }
+      }
+    copy.numberOfBlocks = 1;
+    for ( unsigned int d = blockAxes; d < dimension; ++d )
+      {
+      copy.counts.push_back( copy.last[d] - copy.first[d] + 1 );
+      copy.numberOfBlocks *= copy.counts.back();
+      }
+    copy.sourceStrides.erase( copy.sourceStrides.begin(), copy.sourceStrides.begin() + blockAxes );
+    copy.destinationStrides.erase( copy.destinationStrides.begin(), copy.destinationStrides.begin() + blockAxes );
+
+    copies.push_back( std::move( copy ) );
+    }
+
+  // the destination is made unique before the copies
+  char *destination = static_cast<char *>( destinationImage.GetBufferAsVoid() );
+
+  unsigned int numberOfThreads = this->GetNumberOfThreads();
+  std::unique_ptr<Executor> executor;
+  if ( this->HasExecutor() )
+    {
+    executor.reset( new Executor( this->GetExecutor() ) );
+    numberOfThreads = executor->AcquireThreads( numberOfThreads );
+    }
+  auto releaseThreads = make_scope_exit( [&executor, numberOfThreads] {
+      if ( executor )
+        {
+        executor->ReleaseThreads( numberOfThreads );
+        } } );
+
+  auto threader = itk::MultiThreaderBase::New();
+  threader->SetMaximumNumberOfThreads( numberOfThreads );
+  threader->SetNumberOfWorkUnits( numberOfThreads );
+
+  // the copies are run in parallel in batches of consecutive sources
+  // which do not overlap, so that the last source is pasted over the
+  // previous ones
+  size_t batchBegin = 0;
+  while ( batchBegin < copies.size() )
+    {
+    size_t batchEnd = batchBegin + 1;
+    while ( batchEnd < copies.size() &&
+            std::none_of( copies.begin() + batchBegin, copies.begin() + batchEnd,
+                          [&]( const PasteCopies &copy ) { return Overlap( copy, copies[batchEnd] ); } ) )
+      {
+      ++batchEnd;
+      }
+
+    // the blocks of the batch, split in work units of about the same
+    // number of bytes
+    std::vector<size_t> firstBlocks( 1, 0 );
+    for ( size_t c = batchBegin; c < batchEnd; ++c )
+      {
+      firstBlocks.push_back( firstBlocks.back() + copies[c].numberOfBlocks );
+      }
+    const size_t numberOfBlocks = firstBlocks.back();
+    size_t bytes = 0;
+    for ( size_t c = batchBegin; c < batchEnd; ++c )
+      {
+      bytes += copies[c].numberOfBlocks * copies[c].blockSize;
+      }
+    sitkDebugMacro( "Pasting " << batchEnd - batchBegin << " images in " << numberOfBlocks << " blocks of "
+                    << bytes << " bytes with " << numberOfThreads << " threads." );
+
+    auto copyBlocks = [&]( size_t begin, size_t end )
+      {
+        size_t c = std::upper_bound( firstBlocks.begin(), firstBlocks.end(), begin ) - firstBlocks.begin() - 1;
+        for ( size_t block = begin; block < end; ++block )
+          {
+          while ( block >= firstBlocks[c + 1] )
+            {
+            ++c;
+            }
+          const PasteCopies &copy = copies[batchBegin + c];
+          size_t remainder = block - firstBlocks[c];
+          const char *source = copy.source;
+          char *target = destination + copy.destinationOffset;
+          for ( size_t d = 0; d < copy.counts.size(); ++d )
+            {
+            const size_t i = remainder % copy.counts[d];
+            remainder /= copy.counts[d];
+            source += i * copy.sourceStrides[d];
+            target += i * copy.destinationStrides[d];
+            }
+          std::memcpy( target, source, copy.blockSize );
+          }
+      };
+
+    const size_t numberOfWorkUnits = std::min<size_t>( numberOfBlocks, std::max<size_t>( 1, std::min<size_t>( 4 * numberOfThreads, bytes / ( 64 * 1024 ) ) ) );
+    if ( numberOfThreads <= 1 || numberOfWorkUnits <= 1 )
+      {
+      copyBlocks( 0, numberOfBlocks );
+      }
+    else
+      {
+      threader->ParallelizeArray( 0, numberOfWorkUnits,
+                                  [&]( itk::SizeValueType unit ) {
+                                    copyBlocks( unit * numberOfBlocks / numberOfWorkUnits,
+                                                ( unit + 1 ) * numberOfBlocks / numberOfWorkUnits );
+                                  },
+                                  nullptr );
+      }
+
+    batchBegin = batchEnd;
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 //
@@ -317,5 +588,22 @@ Image Paste ( Image && destinationImage, const Image & sourceImage, std::vector<
   return filter.Execute ( std::move(destinationImage), sourceImage );
 }
 
+//
+// Function to run the batched Execute method of this filter
+//
+Image Paste ( const Image & destinationImage, const std::vector<Image> & sourceImages, const std::vector< std::vector<int> > & destinationIndices )
+{
+  PasteImageFilter filter;
+  return filter.Execute ( destinationImage, sourceImages, destinationIndices );
+}
+//
+// Function to run the batched Execute method of this filter
+//
+Image Paste ( Image && destinationImage, const std::vector<Image> & sourceImages, const std::vector< std::vector<int> > & destinationIndices )
+{
+  PasteImageFilter filter;
+  return filter.Execute ( std::move(destinationImage), sourceImages, destinationIndices );
+}
+
 } // end namespace simple
 } // end namespace itk
@@ -0,0 +1,115 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkPlanarToVectorImageFilter.h"
+#include "sitkVectorImageComponents.hxx"
+
+namespace itk {
+  namespace simple {
+
+    PlanarToVectorImageFilter::~PlanarToVectorImageFilter ()
+    = default;
+
+    PlanarToVectorImageFilter::PlanarToVectorImageFilter ()
+    {
+      this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+      // the output has one less dimension than the input
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 3, SITK_MAX_DIMENSION > ();
+    }
+
+    std::string PlanarToVectorImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::PlanarToVectorImageFilter" << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    Image PlanarToVectorImageFilter::Execute ( const Image &image )
+    {
+      PixelIDValueEnum type = image.GetPixelID();
+      unsigned int dimension = image.GetDimension();
+
+      if ( dimension < 3 )
+        {
+        sitkExceptionMacro( "The planar image of dimension " << dimension
+                            << " must have at least 3 dimensions, for a vector image of at least 2 dimensions!" );
+        }
+
+      return this->m_MemberFactory->GetMemberFunction( type, dimension )( image );
+    }
+
+    template <class TImageType>
+    Image PlanarToVectorImageFilter::ExecuteInternal ( const Image &inImage )
+    {
+      using InputImageType = TImageType;
+      constexpr unsigned int Dimension = InputImageType::ImageDimension - 1;
+      using ComponentType = typename InputImageType::PixelType;
+      using OutputImageType = itk::VectorImage<ComponentType, Dimension>;
+
+      typename InputImageType::ConstPointer image =
+        dynamic_cast <const InputImageType*> ( inImage.GetITKBase() );
+
+      const typename InputImageType::RegionType region = image->GetBufferedRegion();
+      const unsigned int numberOfComponents = static_cast<unsigned int>( region.GetSize( Dimension ) );
+
+      // the geometry of the first dimensions of the input
+      typename OutputImageType::RegionType outputRegion;
+      typename OutputImageType::PointType origin;
+      typename OutputImageType::SpacingType spacing;
+      typename OutputImageType::DirectionType direction;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        outputRegion.SetIndex( d, region.GetIndex( d ) );
+        outputRegion.SetSize( d, region.GetSize( d ) );
+        origin[d] = image->GetOrigin()[d];
+        spacing[d] = image->GetSpacing()[d];
+        for ( unsigned int e = 0; e < Dimension; ++e )
+          {
+          direction[d][e] = image->GetDirection()[d][e];
+          }
+        }
+
+      typename OutputImageType::Pointer output = OutputImageType::New();
+      output->SetRegions( outputRegion );
+      output->SetOrigin( origin );
+      output->SetSpacing( spacing );
+      output->SetDirection( direction );
+      output->SetNumberOfComponentsPerPixel( numberOfComponents );
+      output->Allocate();
+
+      // each plane of the last dimension is a component of the output
+      const SizeValueType numberOfPixels = outputRegion.GetNumberOfPixels();
+      std::vector< const ComponentType * > planes( numberOfComponents );
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        planes[c] = image->GetBufferPointer() + c * numberOfPixels;
+        }
+
+      InterleaveComponentBuffers( planes, output->GetBufferPointer(), numberOfPixels, this->GetNumberOfThreads() );
+
+      return this->CastITKToImage( output.GetPointer() );
+    }
+
+    Image PlanarToVector ( const Image &image )
+    {
+      PlanarToVectorImageFilter filter;
+      return filter.Execute( image );
+    }
+
+  } // end namespace simple
+} // end namespace itk
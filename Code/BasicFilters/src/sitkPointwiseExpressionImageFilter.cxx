@@ -0,0 +1,346 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkPointwiseExpressionImageFilter.h"
+#include "sitkTemplateFunctions.h"
+#include "sitkComponentPixelType.h"
+#include "sitkInstructionSet.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+// The number of elements evaluated together, so that the
+// intermediate values remain in the cache between operations.
+constexpr size_t ChunkSize = 1024;
+
+// The number of elements processed by a work unit.
+constexpr size_t BlockSize = 64 * ChunkSize;
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, T>::type
+ConvertValue( double v )
+{
+  if ( !( v > static_cast<double>( std::numeric_limits<T>::lowest() ) ) )
+    {
+    // includes NaN
+    return v != v ? T(0) : std::numeric_limits<T>::lowest();
+    }
+  if ( !( v < static_cast<double>( std::numeric_limits<T>::max() ) ) )
+    {
+    return std::numeric_limits<T>::max();
+    }
+  return static_cast<T>( v );
+}
+
+template <typename T>
+typename std::enable_if<!std::is_integral<T>::value, T>::type
+ConvertValue( double v )
+{
+  return static_cast<T>( v );
+}
+
+}
+
+
+PointwiseExpressionImageFilter::~PointwiseExpressionImageFilter() = default;
+
+PointwiseExpressionImageFilter::PointwiseExpressionImageFilter()
+  : m_OutputPixelType( sitkUnknown )
+{
+}
+
+
+std::string PointwiseExpressionImageFilter::ToString() const
+{
+  const char * names[] = { "Add", "Multiply", "Divide", "ShiftScale", "Clamp", "Abs", "Square", "Sqrt", "Exp", "Log" };
+
+  std::ostringstream out;
+  out << "itk::simple::PointwiseExpressionImageFilter\n"
+      << "\tOutputPixelType: " << this->m_OutputPixelType << std::endl
+      << "\tOperations:";
+  for ( const auto & op : this->m_Operations )
+    {
+    out << " " << names[op.m_Operation];
+    switch ( op.m_Operation )
+      {
+      case OperationShiftScale:
+      case OperationClamp:
+        out << "(" << op.m_A << ", " << op.m_B << ")";
+        break;
+      case OperationAdd:
+      case OperationMultiply:
+      case OperationDivide:
+        out << "(" << op.m_A << ")";
+        break;
+      default:
+        out << "()";
+      }
+    }
+  out << std::endl;
+  out << ProcessObject::ToString();
+  return out.str();
+}
+
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::AddOperation( OperationEnum op, double a, double b )
+{
+  this->m_Operations.push_back( Operation{ op, a, b } );
+  return *this;
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Add( double constant )
+{
+  return this->AddOperation( OperationAdd, constant );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Subtract( double constant )
+{
+  return this->AddOperation( OperationAdd, -constant );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Multiply( double constant )
+{
+  return this->AddOperation( OperationMultiply, constant );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Divide( double constant )
+{
+  return this->AddOperation( OperationDivide, constant );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::ShiftScale( double shift, double scale )
+{
+  return this->AddOperation( OperationShiftScale, shift, scale );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Clamp( double lowerBound, double upperBound )
+{
+  if ( lowerBound > upperBound )
+    {
+    sitkExceptionMacro( "The lower bound " << lowerBound << " is greater than the upper bound " << upperBound << "." );
+    }
+  return this->AddOperation( OperationClamp, lowerBound, upperBound );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Abs()
+{
+  return this->AddOperation( OperationAbs );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Square()
+{
+  return this->AddOperation( OperationSquare );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Sqrt()
+{
+  return this->AddOperation( OperationSqrt );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Exp()
+{
+  return this->AddOperation( OperationExp );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::Log()
+{
+  return this->AddOperation( OperationLog );
+}
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::ClearOperations()
+{
+  this->m_Operations.clear();
+  return *this;
+}
+
+unsigned int PointwiseExpressionImageFilter::GetNumberOfOperations() const
+{
+  return static_cast<unsigned int>( this->m_Operations.size() );
+}
+
+
+PointwiseExpressionImageFilter::Self & PointwiseExpressionImageFilter::SetOutputPixelType( PixelIDValueEnum pixelID )
+{
+  this->m_OutputPixelType = pixelID;
+  return *this;
+}
+
+PixelIDValueEnum PointwiseExpressionImageFilter::GetOutputPixelType( ) const
+{
+  return this->m_OutputPixelType;
+}
+
+
+template <typename TInput, typename TOutput>
+void PointwiseExpressionImageFilter::ApplyOperations( const TInput *input,
+                                                      TOutput *output,
+                                                      size_t n,
+                                                      const std::vector<Operation> &operations )
+{
+  double values[ChunkSize];
+
+  for ( size_t start = 0; start < n; start += ChunkSize )
+    {
+    const size_t count = std::min( ChunkSize, n - start );
+
+    for ( size_t i = 0; i < count; ++i )
+      {
+      values[i] = static_cast<double>( input[start + i] );
+      }
+
+    // each operation is a simple loop over the chunk
+    for ( const auto & op : operations )
+      {
+      const double a = op.m_A;
+      const double b = op.m_B;
+      switch ( op.m_Operation )
+        {
+        case OperationAdd:
+          for ( size_t i = 0; i < count; ++i ) { values[i] += a; }
+          break;
+        case OperationMultiply:
+          for ( size_t i = 0; i < count; ++i ) { values[i] *= a; }
+          break;
+        case OperationDivide:
+          for ( size_t i = 0; i < count; ++i ) { values[i] /= a; }
+          break;
+        case OperationShiftScale:
+          for ( size_t i = 0; i < count; ++i ) { values[i] = ( values[i] + a ) * b; }
+          break;
+        case OperationClamp:
+          for ( size_t i = 0; i < count; ++i ) { values[i] = std::min( std::max( values[i], a ), b ); }
+          break;
+        case OperationAbs:
+          for ( size_t i = 0; i < count; ++i ) { values[i] = std::abs( values[i] ); }
+          break;
+        case OperationSquare:
+          for ( size_t i = 0; i < count; ++i ) { values[i] *= values[i]; }
+          break;
+        case OperationSqrt:
+          for ( size_t i = 0; i < count; ++i ) { values[i] = std::sqrt( values[i] ); }
+          break;
+        case OperationExp:
+          for ( size_t i = 0; i < count; ++i ) { values[i] = std::exp( values[i] ); }
+          break;
+        case OperationLog:
+          for ( size_t i = 0; i < count; ++i ) { values[i] = std::log( values[i] ); }
+          break;
+        }
+      }
+
+    for ( size_t i = 0; i < count; ++i )
+      {
+      output[start + i] = ConvertValue<TOutput>( values[i] );
+      }
+    }
+}
+
+
+Image PointwiseExpressionImageFilter::Execute ( const Image& image )
+{
+  const PixelIDValueEnum outputPixelType =
+    ( this->m_OutputPixelType == sitkUnknown ) ? image.GetPixelID() : this->m_OutputPixelType;
+
+  bool inputIsVector = false;
+  bool outputIsVector = false;
+  const PixelIDValueEnum inputComponentID = GetComponentPixelID( image.GetPixelID(), inputIsVector );
+  const PixelIDValueEnum outputComponentID = GetComponentPixelID( outputPixelType, outputIsVector );
+
+  if ( inputComponentID == sitkUnknown )
+    {
+    sitkExceptionMacro( "Input image of " << image.GetPixelIDTypeAsString() << " is not supported by " << this->GetName() << "." );
+    }
+  if ( outputComponentID == sitkUnknown || inputIsVector != outputIsVector )
+    {
+    sitkExceptionMacro( "Output pixel type " << GetPixelIDValueAsString( outputPixelType )
+                        << " is not supported for an input of " << image.GetPixelIDTypeAsString() << "." );
+    }
+
+  const unsigned int numberOfComponents = image.GetNumberOfComponentsPerPixel();
+  Image output( image.GetSize(), outputPixelType, outputIsVector ? numberOfComponents : 0 );
+  output.CopyInformation( image );
+
+  const size_t n = static_cast<size_t>( image.GetNumberOfPixels() ) * numberOfComponents;
+  const void *inputBuffer = image.GetBufferAsVoid();
+  void *outputBuffer = output.GetBufferAsVoid();
+
+  unsigned int numberOfThreads = this->GetNumberOfThreads();
+  std::unique_ptr<Executor> executor;
+  if ( this->HasExecutor() )
+    {
+    executor.reset( new Executor( this->GetExecutor() ) );
+    numberOfThreads = executor->AcquireThreads( numberOfThreads );
+    }
+  auto releaseThreads = make_scope_exit( [&executor, numberOfThreads] {
+      if ( executor )
+        {
+        executor->ReleaseThreads( numberOfThreads );
+        } } );
+
+  sitkDebugMacro( "Evaluating " << this->m_Operations.size() << " operations for " << n << " elements with "
+                  << numberOfThreads << " threads." );
+
+  const std::vector<Operation> &operations = this->m_Operations;
+  InvokeWithComponentType( inputComponentID, [&]( auto inputTag ) {
+    using InputType = decltype( inputTag );
+    InvokeWithComponentType( outputComponentID, [&]( auto outputTag ) {
+      using OutputType = decltype( outputTag );
+
+      const auto *input = static_cast<const InputType *>( inputBuffer );
+      auto *output = static_cast<OutputType *>( outputBuffer );
+
+      const size_t numberOfBlocks = ( n + BlockSize - 1 ) / BlockSize;
+      if ( numberOfThreads <= 1 || numberOfBlocks <= 1 )
+        {
+        detail::InvokeWithInstructionSet( [&] { Self::ApplyOperations( input, output, n, operations ); } );
+        return;
+        }
+
+      auto threader = itk::MultiThreaderBase::New();
+      threader->SetMaximumNumberOfThreads( numberOfThreads );
+      threader->SetNumberOfWorkUnits( numberOfThreads );
+      threader->ParallelizeArray( 0, numberOfBlocks,
+                                  [&]( itk::SizeValueType block ) {
+                                    const size_t start = block * BlockSize;
+                                    detail::InvokeWithInstructionSet( [&] {
+                                        Self::ApplyOperations( input + start, output + start,
+                                                               std::min( BlockSize, n - start ), operations );
+                                      } );
+                                  },
+                                  nullptr );
+      } );
+    } );
+
+  return output;
+}
+
+}
+}
@@ -0,0 +1,674 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkResampler.h"
+#include "sitkResampleImageFilter.h"
+#include "sitkBSplineDecompositionImageFilter.h"
+#include "sitkVectorIndexSelectionCastImageFilter.h"
+#include "sitkComposeImageFilter.h"
+#include "sitkCastImageFilter.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+// The order of a BSpline interpolator, or 0 for the other
+// interpolators.
+unsigned int GetBSplineOrder( InterpolatorEnum interpolator )
+{
+  switch ( interpolator )
+    {
+    case sitkBSpline1: return 1;
+    case sitkBSpline2: return 2;
+    case sitkBSpline3: return 3;
+    case sitkBSpline4: return 4;
+    case sitkBSpline5: return 5;
+    default: return 0;
+    }
+}
+
+// The interpolator of a BSpline coefficient image of the order.
+InterpolatorEnum GetBSplineResampler( unsigned int order )
+{
+  switch ( order )
+    {
+    case 1: return sitkBSplineResamplerOrder1;
+    case 2: return sitkBSplineResamplerOrder2;
+    case 4: return sitkBSplineResamplerOrder4;
+    case 5: return sitkBSplineResamplerOrder5;
+    default: return sitkBSplineResamplerOrder3;
+    }
+}
+
+// Get the pixel ID of the components of a vector pixel type, or the
+// pixel ID of a scalar type.
+PixelIDValueEnum GetComponentPixelID( PixelIDValueEnum pixelID )
+{
+  const PixelIDValueEnum scalars[] = { sitkUInt8, sitkInt8, sitkUInt16, sitkInt16, sitkUInt32, sitkInt32,
+                                       sitkUInt64, sitkInt64, sitkFloat32, sitkFloat64 };
+  const PixelIDValueEnum vectors[] = { sitkVectorUInt8, sitkVectorInt8, sitkVectorUInt16, sitkVectorInt16,
+                                       sitkVectorUInt32, sitkVectorInt32, sitkVectorUInt64, sitkVectorInt64,
+                                       sitkVectorFloat32, sitkVectorFloat64 };
+  for ( unsigned int i = 0; i < sizeof(vectors)/sizeof(vectors[0]); ++i )
+    {
+    if ( vectors[i] != sitkUnknown && pixelID == vectors[i] )
+      {
+      return scalars[i];
+      }
+    }
+  return pixelID;
+}
+
+// If the pixel ID is of a scalar or vector type supported by the
+// JointResampler.
+bool IsBasicComponentPixelID( PixelIDValueEnum componentID )
+{
+  const PixelIDValueEnum scalars[] = { sitkUInt8, sitkInt8, sitkUInt16, sitkInt16, sitkUInt32, sitkInt32,
+                                       sitkUInt64, sitkInt64, sitkFloat32, sitkFloat64 };
+  return componentID != sitkUnknown && std::find( std::begin( scalars ), std::end( scalars ), componentID ) != std::end( scalars );
+}
+
+// Convert an interpolated value to the output pixel type, as
+// CastPixelWithBoundsChecking of the itk::ResampleImageFilter.
+template <typename T>
+T CastWithBoundsChecking( double value )
+{
+  if ( value >= static_cast<double>( std::numeric_limits<T>::max() ) )
+    {
+    return std::numeric_limits<T>::max();
+    }
+  if ( value <= static_cast<double>( std::numeric_limits<T>::lowest() ) )
+    {
+    return std::numeric_limits<T>::lowest();
+    }
+  return static_cast<T>( value );
+}
+
+// Write the values of the pixels of a block inside of the input, and
+// the default value to the others.
+template <typename T>
+void FillBlock( T *buffer,
+                size_t numberOfPixels,
+                unsigned int numberOfComponents,
+                double defaultPixelValue,
+                const std::vector<double> &values,
+                const std::vector<size_t> &insidePixels )
+{
+  std::fill( buffer, buffer + numberOfPixels * numberOfComponents, static_cast<T>( defaultPixelValue ) );
+  for ( size_t i = 0; i < insidePixels.size(); ++i )
+    {
+    T *pixel = buffer + insidePixels[i] * numberOfComponents;
+    const double *value = &values[i * numberOfComponents];
+    for ( unsigned int c = 0; c < numberOfComponents; ++c )
+      {
+      pixel[c] = CastWithBoundsChecking<T>( value[c] );
+      }
+    }
+}
+
+// The number of output pixels mapped and interpolated together by
+// the JointResampler.
+constexpr size_t JointResamplerBlockSize = 1u << 16;
+
+}
+
+
+Resampler::~Resampler() = default;
+
+Resampler::Resampler( const Image &image, InterpolatorEnum interpolator )
+  : m_Image( image ),
+    m_Interpolator( interpolator ),
+    m_ComponentInterpolator( interpolator ),
+    m_DefaultPixelValue( 0.0 ),
+    m_OutputPixelType( sitkUnknown )
+{
+  const unsigned int order = GetBSplineOrder( interpolator );
+  if ( order == 0 )
+    {
+    m_ComponentImages.push_back( image );
+    return;
+    }
+
+  BSplineDecompositionImageFilter decomposition;
+  decomposition.SetSplineOrder( order );
+
+  const bool isVector = ( GetComponentPixelID( image.GetPixelID() ) != image.GetPixelID() );
+  const unsigned int numberOfComponents = isVector ? image.GetNumberOfComponentsPerPixel() : 1u;
+  for ( unsigned int i = 0; i < numberOfComponents; ++i )
+    {
+    const Image component = isVector ? VectorIndexSelectionCast( image, i, sitkFloat64 ) : Cast( image, sitkFloat64 );
+    m_ComponentImages.push_back( decomposition.Execute( component ) );
+    }
+  m_ComponentInterpolator = GetBSplineResampler( order );
+}
+
+
+std::string Resampler::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::Resampler\n"
+      << "\tInterpolator: " << this->m_Interpolator << std::endl
+      << "\tComponentInterpolator: " << this->m_ComponentInterpolator << std::endl
+      << "\tNumberOfComponentImages: " << this->m_ComponentImages.size() << std::endl
+      << "\tDefaultPixelValue: " << this->m_DefaultPixelValue << std::endl
+      << "\tOutputPixelType: " << this->m_OutputPixelType << std::endl;
+  return out.str();
+}
+
+
+const Image &Resampler::GetImage() const
+{
+  return this->m_Image;
+}
+
+InterpolatorEnum Resampler::GetInterpolator() const
+{
+  return this->m_Interpolator;
+}
+
+Resampler::Self &Resampler::SetDefaultPixelValue( double value )
+{
+  this->m_DefaultPixelValue = value;
+  return *this;
+}
+
+double Resampler::GetDefaultPixelValue() const
+{
+  return this->m_DefaultPixelValue;
+}
+
+Resampler::Self &Resampler::SetOutputPixelType( PixelIDValueEnum pixelID )
+{
+  this->m_OutputPixelType = pixelID;
+  return *this;
+}
+
+PixelIDValueEnum Resampler::GetOutputPixelType() const
+{
+  return this->m_OutputPixelType;
+}
+
+
+Image Resampler::Execute( const Transform &transform, const Image &referenceImage ) const
+{
+  return this->Execute( transform,
+                        referenceImage.GetSize(),
+                        referenceImage.GetOrigin(),
+                        referenceImage.GetSpacing(),
+                        referenceImage.GetDirection() );
+}
+
+Image Resampler::Execute( const Transform &transform,
+                          const std::vector<uint32_t> &size,
+                          const std::vector<double> &outputOrigin,
+                          const std::vector<double> &outputSpacing,
+                          const std::vector<double> &outputDirection ) const
+{
+  const PixelIDValueEnum outputPixelType =
+    ( this->m_OutputPixelType != sitkUnknown ) ? this->m_OutputPixelType : this->m_Image.GetPixelID();
+
+  ResampleImageFilter filter;
+  filter.SetSize( size );
+  filter.SetTransform( transform );
+  filter.SetInterpolator( this->m_ComponentInterpolator );
+  filter.SetOutputOrigin( outputOrigin );
+  filter.SetOutputSpacing( outputSpacing );
+  filter.SetOutputDirection( outputDirection );
+  filter.SetDefaultPixelValue( this->m_DefaultPixelValue );
+
+  if ( this->m_ComponentInterpolator == this->m_Interpolator )
+    {
+    filter.SetOutputPixelType( outputPixelType );
+    return filter.Execute( this->m_Image );
+    }
+
+  const PixelIDValueEnum componentPixelType = GetComponentPixelID( outputPixelType );
+  const bool isVector = ( GetComponentPixelID( this->m_Image.GetPixelID() ) != this->m_Image.GetPixelID() );
+  if ( isVector == ( componentPixelType == outputPixelType ) )
+    {
+    sitkExceptionMacro( "The output pixel type " << GetPixelIDValueAsString( outputPixelType )
+                        << " does not match the pixel type of the image " << this->m_Image.GetPixelIDTypeAsString() );
+    }
+
+  filter.SetOutputPixelType( componentPixelType );
+
+  std::vector<Image> components;
+  for ( const Image &coefficients : this->m_ComponentImages )
+    {
+    components.push_back( filter.Execute( coefficients ) );
+    }
+  return isVector ? Compose( components ) : components.front();
+}
+
+
+std::vector<double> Resampler::EvaluateAtPhysicalPoint( const std::vector<double> &point ) const
+{
+  std::vector<double> values;
+  for ( const Image &image : this->m_ComponentImages )
+    {
+    const std::vector<double> componentValues = image.EvaluateAtPhysicalPoint( point, this->m_ComponentInterpolator );
+    values.insert( values.end(), componentValues.begin(), componentValues.end() );
+    }
+  return values;
+}
+
+std::vector<double> Resampler::EvaluateAtPhysicalPoints( const std::vector<double> &points ) const
+{
+  if ( this->m_ComponentImages.size() == 1 )
+    {
+    return this->m_ComponentImages.front().EvaluateAtPhysicalPoints( points, this->m_ComponentInterpolator );
+    }
+
+  // interleave the values of the components for each point
+  const size_t numberOfComponents = this->m_ComponentImages.size();
+  std::vector<double> values;
+  for ( size_t c = 0; c < numberOfComponents; ++c )
+    {
+    const std::vector<double> componentValues =
+      this->m_ComponentImages[c].EvaluateAtPhysicalPoints( points, this->m_ComponentInterpolator );
+    values.resize( componentValues.size() * numberOfComponents );
+    for ( size_t i = 0; i < componentValues.size(); ++i )
+      {
+      values[i * numberOfComponents + c] = componentValues[i];
+      }
+    }
+  return values;
+}
+
+
+namespace
+{
+
+// The continuous indices of the pixels of a block of the output
+// inside of an image, and the offsets of the pixels in the block.
+struct MappedBlock
+{
+  std::vector<double> m_Indices;
+  std::vector<size_t> m_Pixels;
+};
+
+struct ImageGeometry
+{
+  std::vector<unsigned int> m_Size;
+  std::vector<double> m_Origin;
+  std::vector<double> m_Spacing;
+  std::vector<double> m_Direction;
+
+  bool operator==( const ImageGeometry &other ) const
+    {
+      return m_Size == other.m_Size && m_Origin == other.m_Origin
+        && m_Spacing == other.m_Spacing && m_Direction == other.m_Direction;
+    }
+};
+
+ImageGeometry GetImageGeometry( const Image &image )
+{
+  return ImageGeometry{ image.GetSize(), image.GetOrigin(), image.GetSpacing(), image.GetDirection() };
+}
+
+// Compute the continuous indices in the image of the mapped points of
+// a block, and keep the ones inside of the buffer.
+void MapBlock( const Image &image, const std::vector<double> &points, MappedBlock &block )
+{
+  const unsigned int dimension = image.GetDimension();
+  const std::vector<double> continuousIndices = image.TransformPhysicalPointsToContinuousIndices( points );
+
+  // the bounds of IsInsideBuffer of the ITK interpolators
+  const std::vector<unsigned int> imageSize = image.GetSize();
+  block.m_Indices.clear();
+  block.m_Pixels.clear();
+  for ( size_t p = 0; p < points.size() / dimension; ++p )
+    {
+    const double *index = &continuousIndices[p * dimension];
+    bool isInside = true;
+    for ( unsigned int d = 0; d < dimension && isInside; ++d )
+      {
+      isInside = index[d] >= -0.5 && index[d] < imageSize[d] - 0.5;
+      }
+    if ( isInside )
+      {
+      block.m_Indices.insert( block.m_Indices.end(), index, index + dimension );
+      block.m_Pixels.push_back( p );
+      }
+    }
+}
+
+}
+
+
+// The mapped blocks of the output grid by a transform, for each image
+// geometry.
+struct JointResampler::Mapping
+{
+  // keeps the ITK transform, so it is not modified in place or freed
+  // while it is the key of the mapping
+  Transform m_Transform;
+  std::vector<uint32_t> m_Size;
+  std::vector<double> m_Origin;
+  std::vector<double> m_Spacing;
+  std::vector<double> m_Direction;
+
+  std::vector<ImageGeometry> m_Geometries;
+  std::vector<std::shared_ptr<const std::vector<MappedBlock> > > m_Blocks;
+};
+
+
+JointResampler::JointResampler() = default;
+
+JointResampler::~JointResampler() = default;
+
+
+std::string JointResampler::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::JointResampler\n"
+      << "\tNumberOfImages: " << this->m_Entries.size() << std::endl
+      << "\tUseMappingCache: " << this->m_UseMappingCache << std::endl;
+  for ( const Entry &entry : this->m_Entries )
+    {
+    out << "\t\t" << entry.m_Image.GetPixelIDTypeAsString()
+        << " Interpolator: " << entry.m_Interpolator
+        << " DefaultPixelValue: " << entry.m_DefaultPixelValue
+        << " OutputPixelType: " << entry.m_OutputPixelType << std::endl;
+    }
+  return out.str();
+}
+
+
+JointResampler::Self &JointResampler::AddImage( const Image &image,
+                                                InterpolatorEnum interpolator,
+                                                double defaultPixelValue,
+                                                PixelIDValueEnum outputPixelType )
+{
+  if ( !IsBasicComponentPixelID( GetComponentPixelID( image.GetPixelID() ) ) )
+    {
+    sitkExceptionMacro( "The pixel type " << image.GetPixelIDTypeAsString() << " is not supported!" );
+    }
+
+  const PixelIDValueEnum pixelType = ( outputPixelType != sitkUnknown ) ? outputPixelType : image.GetPixelID();
+  const bool isVector = ( GetComponentPixelID( image.GetPixelID() ) != image.GetPixelID() );
+  const PixelIDValueEnum componentPixelType = GetComponentPixelID( pixelType );
+  if ( !IsBasicComponentPixelID( componentPixelType ) || isVector == ( componentPixelType == pixelType ) )
+    {
+    sitkExceptionMacro( "The output pixel type " << GetPixelIDValueAsString( pixelType )
+                        << " does not match the pixel type of the image " << image.GetPixelIDTypeAsString() );
+    }
+
+  this->m_Entries.push_back( Entry{ image, interpolator, defaultPixelValue, pixelType } );
+  return *this;
+}
+
+
+JointResampler::Self &JointResampler::ClearImages()
+{
+  this->m_Entries.clear();
+  return *this;
+}
+
+
+unsigned int JointResampler::GetNumberOfImages() const
+{
+  return static_cast<unsigned int>( this->m_Entries.size() );
+}
+
+
+JointResampler::Self &JointResampler::SetUseMappingCache( bool useMappingCache )
+{
+  this->m_UseMappingCache = useMappingCache;
+  if ( !useMappingCache )
+    {
+    this->m_Mapping.reset();
+    }
+  return *this;
+}
+
+
+bool JointResampler::GetUseMappingCache() const
+{
+  return this->m_UseMappingCache;
+}
+
+
+JointResampler::Self &JointResampler::ClearMappingCache()
+{
+  this->m_Mapping.reset();
+  return *this;
+}
+
+
+std::vector<Image> JointResampler::Execute( const Transform &transform, const Image &referenceImage ) const
+{
+  return this->Execute( transform,
+                        referenceImage.GetSize(),
+                        referenceImage.GetOrigin(),
+                        referenceImage.GetSpacing(),
+                        referenceImage.GetDirection() );
+}
+
+
+std::vector<Image> JointResampler::Execute( const Transform &transform,
+                                            const std::vector<uint32_t> &size,
+                                            const std::vector<double> &outputOrigin,
+                                            const std::vector<double> &outputSpacing,
+                                            const std::vector<double> &outputDirection ) const
+{
+  const unsigned int dimension = static_cast<unsigned int>( size.size() );
+  if ( outputOrigin.size() < dimension || outputSpacing.size() < dimension )
+    {
+    sitkExceptionMacro( "The output origin and spacing must have at least " << dimension << " elements!" );
+    }
+  if ( transform.GetDimension() != dimension )
+    {
+    sitkExceptionMacro( "The transform has dimension " << transform.GetDimension()
+                        << ", but the output size has " << dimension << " elements!" );
+    }
+
+  // an image of one pixel with the geometry of the output, for the
+  // conversion of the output indices to points
+  Image outputGeometry( std::vector<unsigned int>( dimension, 1u ), sitkUInt8 );
+  outputGeometry.SetOrigin( std::vector<double>( outputOrigin.begin(), outputOrigin.begin() + dimension ) );
+  outputGeometry.SetSpacing( std::vector<double>( outputSpacing.begin(), outputSpacing.begin() + dimension ) );
+  if ( !outputDirection.empty() )
+    {
+    outputGeometry.SetDirection( outputDirection );
+    }
+
+  std::vector<Image> outputs;
+  for ( const Entry &entry : this->m_Entries )
+    {
+    if ( entry.m_Image.GetDimension() != dimension )
+      {
+      sitkExceptionMacro( "The image has dimension " << entry.m_Image.GetDimension()
+                          << ", but the output size has " << dimension << " elements!" );
+      }
+    const bool isVector = ( GetComponentPixelID( entry.m_OutputPixelType ) != entry.m_OutputPixelType );
+    outputs.emplace_back( std::vector<unsigned int>( size.begin(), size.end() ),
+                          entry.m_OutputPixelType,
+                          isVector ? entry.m_Image.GetNumberOfComponentsPerPixel() : 0u );
+    outputs.back().SetOrigin( outputGeometry.GetOrigin() );
+    outputs.back().SetSpacing( outputGeometry.GetSpacing() );
+    outputs.back().SetDirection( outputGeometry.GetDirection() );
+    }
+
+  // the cached mapping is used when it is of the same transform and
+  // output grid
+  std::shared_ptr<const Mapping> cached;
+  if ( this->m_UseMappingCache && this->m_Mapping
+       && this->m_Mapping->m_Transform.GetITKBase() == transform.GetITKBase()
+       && this->m_Mapping->m_Size == size
+       && this->m_Mapping->m_Origin == outputGeometry.GetOrigin()
+       && this->m_Mapping->m_Spacing == outputGeometry.GetSpacing()
+       && this->m_Mapping->m_Direction == outputGeometry.GetDirection() )
+    {
+    cached = this->m_Mapping;
+    }
+
+  // The geometries of the images, the cached ones first. The
+  // continuous indices are computed once for the images with the
+  // same geometry.
+  std::vector<ImageGeometry> geometries;
+  if ( cached )
+    {
+    geometries = cached->m_Geometries;
+    }
+  const size_t numberOfCachedGeometries = geometries.size();
+  std::vector<const Image *> geometryImages;
+  std::vector<size_t> entryGeometries;
+  for ( const Entry &entry : this->m_Entries )
+    {
+    const ImageGeometry geometry = GetImageGeometry( entry.m_Image );
+    const size_t g = std::find( geometries.begin(), geometries.end(), geometry ) - geometries.begin();
+    if ( g == geometries.size() )
+      {
+      geometries.push_back( geometry );
+      geometryImages.push_back( &entry.m_Image );
+      }
+    entryGeometries.push_back( g );
+    }
+  const size_t numberOfNewGeometries = geometries.size() - numberOfCachedGeometries;
+
+  const bool updateCache = this->m_UseMappingCache && numberOfNewGeometries > 0;
+  std::vector<std::shared_ptr<std::vector<MappedBlock> > > newBlocks;
+  for ( size_t g = 0; g < numberOfNewGeometries; ++g )
+    {
+    newBlocks.push_back( std::make_shared<std::vector<MappedBlock> >() );
+    }
+
+  size_t numberOfPixels = 1;
+  for ( uint32_t s : size )
+    {
+    numberOfPixels *= s;
+    }
+
+  std::vector<double> outputIndices;
+  std::vector<MappedBlock> scratch( numberOfNewGeometries );
+  size_t blockNumber = 0;
+  for ( size_t blockStart = 0; blockStart < numberOfPixels; blockStart += JointResamplerBlockSize, ++blockNumber )
+    {
+    const size_t blockSize = std::min( JointResamplerBlockSize, numberOfPixels - blockStart );
+
+    if ( numberOfNewGeometries > 0 )
+      {
+      outputIndices.resize( blockSize * dimension );
+      for ( size_t p = 0; p < blockSize; ++p )
+        {
+        size_t linear = blockStart + p;
+        for ( unsigned int d = 0; d < dimension; ++d )
+          {
+          outputIndices[p * dimension + d] = static_cast<double>( linear % size[d] );
+          linear /= size[d];
+          }
+        }
+
+      // the transform is evaluated once for all the images
+      const std::vector<double> points =
+        transform.TransformPoints( outputGeometry.TransformContinuousIndicesToPhysicalPoints( outputIndices ) );
+
+      for ( size_t g = 0; g < numberOfNewGeometries; ++g )
+        {
+        MapBlock( *geometryImages[g], points, scratch[g] );
+        if ( updateCache )
+          {
+          newBlocks[g]->push_back( std::move( scratch[g] ) );
+          }
+        }
+      }
+
+    for ( size_t i = 0; i < this->m_Entries.size(); ++i )
+      {
+      const Entry &entry = this->m_Entries[i];
+      const size_t g = entryGeometries[i];
+      const MappedBlock &block = ( g < numberOfCachedGeometries )
+        ? ( *cached->m_Blocks[g] )[blockNumber]
+        : ( updateCache ? newBlocks[g - numberOfCachedGeometries]->back() : scratch[g - numberOfCachedGeometries] );
+
+      const std::vector<double> values = block.m_Pixels.empty()
+        ? std::vector<double>()
+        : entry.m_Image.EvaluateAtContinuousIndices( block.m_Indices, entry.m_Interpolator );
+
+      Image &output = outputs[i];
+      const unsigned int numberOfComponents = output.GetNumberOfComponentsPerPixel();
+      const size_t offset = blockStart * numberOfComponents;
+      switch ( GetComponentPixelID( output.GetPixelID() ) )
+        {
+        case sitkUInt8:
+          FillBlock( output.GetBufferAsUInt8() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkInt8:
+          FillBlock( output.GetBufferAsInt8() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkUInt16:
+          FillBlock( output.GetBufferAsUInt16() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkInt16:
+          FillBlock( output.GetBufferAsInt16() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkUInt32:
+          FillBlock( output.GetBufferAsUInt32() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkInt32:
+          FillBlock( output.GetBufferAsInt32() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkUInt64:
+          FillBlock( output.GetBufferAsUInt64() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkInt64:
+          FillBlock( output.GetBufferAsInt64() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkFloat32:
+          FillBlock( output.GetBufferAsFloat() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        case sitkFloat64:
+          FillBlock( output.GetBufferAsDouble() + offset, blockSize, numberOfComponents, entry.m_DefaultPixelValue, values, block.m_Pixels );
+          break;
+        default:
+          sitkExceptionMacro( "Unsupported output pixel type: " << output.GetPixelIDTypeAsString() );
+        }
+      }
+    }
+
+  if ( updateCache )
+    {
+    // The cached blocks are shared with the previous mapping, which is
+    // replaced only once the new one is complete.
+    auto mapping = cached ? std::make_shared<Mapping>( *cached ) : std::make_shared<Mapping>();
+    if ( !cached )
+      {
+      mapping->m_Transform = transform;
+      mapping->m_Size = size;
+      mapping->m_Origin = outputGeometry.GetOrigin();
+      mapping->m_Spacing = outputGeometry.GetSpacing();
+      mapping->m_Direction = outputGeometry.GetDirection();
+      }
+    mapping->m_Geometries = geometries;
+    mapping->m_Blocks.insert( mapping->m_Blocks.end(), newBlocks.begin(), newBlocks.end() );
+    this->m_Mapping = mapping;
+    }
+
+  return outputs;
+}
+
+}
+}
@@ -0,0 +1,514 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkResamplingOperator.h"
+#include "sitkCastImageFilter.h"
+#include "sitkTemplateFunctions.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+constexpr size_t ResamplingOperatorBlockSize = 1u << 16;
+
+const char ResamplingOperatorFileMagic[] = "SimpleITK ResamplingOperator";
+constexpr uint32_t ResamplingOperatorFileVersion = 1;
+
+// If the pixel ID is of a vector type of basic components, or throw
+// when it is not of a scalar or vector type of basic components.
+bool IsVectorPixelID( PixelIDValueEnum pixelID )
+{
+  const PixelIDValueEnum scalars[] = { sitkUInt8, sitkInt8, sitkUInt16, sitkInt16, sitkUInt32, sitkInt32,
+                                       sitkUInt64, sitkInt64, sitkFloat32, sitkFloat64 };
+  const PixelIDValueEnum vectors[] = { sitkVectorUInt8, sitkVectorInt8, sitkVectorUInt16, sitkVectorInt16,
+                                       sitkVectorUInt32, sitkVectorInt32, sitkVectorUInt64, sitkVectorInt64,
+                                       sitkVectorFloat32, sitkVectorFloat64 };
+  if ( pixelID != sitkUnknown && std::find( std::begin( vectors ), std::end( vectors ), pixelID ) != std::end( vectors ) )
+    {
+    return true;
+    }
+  if ( pixelID == sitkUnknown || std::find( std::begin( scalars ), std::end( scalars ), pixelID ) == std::end( scalars ) )
+    {
+    sitkExceptionMacro( "The pixel type " << GetPixelIDValueAsString( pixelID ) << " is not supported!" );
+    }
+  return false;
+}
+
+bool IsClose( const std::vector<double> &a, const std::vector<double> &b, double tolerance )
+{
+  if ( a.size() != b.size() )
+    {
+    return false;
+    }
+  for ( size_t i = 0; i < a.size(); ++i )
+    {
+    if ( std::abs( a[i] - b[i] ) > tolerance )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// The weights of the input pixels of a continuous index inside of the
+// buffer, as the ITK NearestNeighbor and Linear interpolators.
+void AppendWeights( const double *index,
+                    const std::vector<unsigned int> &size,
+                    InterpolatorEnum interpolator,
+                    std::vector<uint64_t> &columns,
+                    std::vector<double> &weights )
+{
+  const unsigned int dimension = static_cast<unsigned int>( size.size() );
+
+  if ( interpolator == sitkNearestNeighbor )
+    {
+    uint64_t column = 0;
+    uint64_t stride = 1;
+    for ( unsigned int d = 0; d < dimension; ++d )
+      {
+      // RoundHalfIntegerUp, in the buffer for the indices inside of it
+      column += static_cast<uint64_t>( std::floor( index[d] + 0.5 ) ) * stride;
+      stride *= size[d];
+      }
+    columns.push_back( column );
+    weights.push_back( 1.0 );
+    return;
+    }
+
+  // the neighbors out of the buffer are clamped to it, and their
+  // weights merged
+  const size_t rowBegin = columns.size();
+  for ( unsigned int corner = 0; corner < ( 1u << dimension ); ++corner )
+    {
+    double weight = 1.0;
+    uint64_t column = 0;
+    uint64_t stride = 1;
+    for ( unsigned int d = 0; d < dimension; ++d )
+      {
+      const double base = std::floor( index[d] );
+      const double distance = index[d] - base;
+      const bool upper = ( corner >> d ) & 1u;
+      weight *= upper ? distance : 1.0 - distance;
+
+      const int64_t i = static_cast<int64_t>( base ) + ( upper ? 1 : 0 );
+      column += static_cast<uint64_t>( std::max<int64_t>( std::min<int64_t>( i, size[d] - 1 ), 0 ) ) * stride;
+      stride *= size[d];
+      }
+    if ( weight == 0.0 )
+      {
+      continue;
+      }
+
+    auto existing = std::find( columns.begin() + rowBegin, columns.end(), column );
+    if ( existing != columns.end() )
+      {
+      weights[existing - columns.begin()] += weight;
+      }
+    else
+      {
+      columns.push_back( column );
+      weights.push_back( weight );
+      }
+    }
+}
+
+
+template <typename T>
+void WriteValues( std::ostream &stream, const std::vector<T> &values )
+{
+  stream.write( reinterpret_cast<const char *>( values.data() ), static_cast<std::streamsize>( values.size() * sizeof(T) ) );
+}
+
+template <typename T>
+void WriteValue( std::ostream &stream, const T &value )
+{
+  stream.write( reinterpret_cast<const char *>( &value ), sizeof(T) );
+}
+
+template <typename T>
+void ReadValues( std::istream &stream, std::vector<T> &values, uint64_t numberOfValues )
+{
+  values.resize( numberOfValues );
+  stream.read( reinterpret_cast<char *>( values.data() ), static_cast<std::streamsize>( numberOfValues * sizeof(T) ) );
+}
+
+template <typename T>
+T ReadValue( std::istream &stream )
+{
+  T value = T();
+  stream.read( reinterpret_cast<char *>( &value ), sizeof(T) );
+  return value;
+}
+
+uint64_t GetNumberOfPixels( const std::vector<unsigned int> &size )
+{
+  uint64_t numberOfPixels = 1;
+  for ( unsigned int s : size )
+    {
+    numberOfPixels *= s;
+    }
+  return numberOfPixels;
+}
+
+}
+
+
+ResamplingOperator::ResamplingOperator()
+  : m_Interpolator( sitkLinear ),
+    m_RowOffsets( 1, 0u )
+{
+}
+
+
+ResamplingOperator::ResamplingOperator( const Transform &transform,
+                                        const Image &inputImage,
+                                        const Image &referenceImage,
+                                        InterpolatorEnum interpolator )
+  : m_Interpolator( interpolator ),
+    m_InputSize( inputImage.GetSize() ),
+    m_InputOrigin( inputImage.GetOrigin() ),
+    m_InputSpacing( inputImage.GetSpacing() ),
+    m_InputDirection( inputImage.GetDirection() ),
+    m_OutputSize( referenceImage.GetSize() ),
+    m_OutputOrigin( referenceImage.GetOrigin() ),
+    m_OutputSpacing( referenceImage.GetSpacing() ),
+    m_OutputDirection( referenceImage.GetDirection() )
+{
+  if ( interpolator != sitkNearestNeighbor && interpolator != sitkLinear )
+    {
+    sitkExceptionMacro( "The interpolator " << interpolator << " is not supported, only "
+                        << sitkNearestNeighbor << " and " << sitkLinear << " are!" );
+    }
+
+  const unsigned int dimension = referenceImage.GetDimension();
+  if ( inputImage.GetDimension() != dimension || transform.GetDimension() != dimension )
+    {
+    sitkExceptionMacro( "The input image has dimension " << inputImage.GetDimension()
+                        << ", the transform " << transform.GetDimension()
+                        << " and the reference image " << dimension << "!" );
+    }
+
+  const uint64_t numberOfPixels = GetNumberOfPixels( m_OutputSize );
+  this->m_RowOffsets.reserve( numberOfPixels + 1 );
+  this->m_RowOffsets.push_back( 0u );
+
+  std::vector<double> outputIndices;
+  for ( uint64_t blockStart = 0; blockStart < numberOfPixels; blockStart += ResamplingOperatorBlockSize )
+    {
+    const uint64_t blockSize = std::min<uint64_t>( ResamplingOperatorBlockSize, numberOfPixels - blockStart );
+
+    outputIndices.resize( blockSize * dimension );
+    for ( uint64_t p = 0; p < blockSize; ++p )
+      {
+      uint64_t linear = blockStart + p;
+      for ( unsigned int d = 0; d < dimension; ++d )
+        {
+        outputIndices[p * dimension + d] = static_cast<double>( linear % m_OutputSize[d] );
+        linear /= m_OutputSize[d];
+        }
+      }
+
+    const std::vector<double> continuousIndices = inputImage.TransformPhysicalPointsToContinuousIndices(
+      transform.TransformPoints( referenceImage.TransformContinuousIndicesToPhysicalPoints( outputIndices ) ) );
+
+    for ( uint64_t p = 0; p < blockSize; ++p )
+      {
+      // the bounds of IsInsideBuffer of the ITK interpolators
+      const double *index = &continuousIndices[p * dimension];
+      bool isInside = true;
+      for ( unsigned int d = 0; d < dimension && isInside; ++d )
+        {
+        isInside = index[d] >= -0.5 && index[d] < m_InputSize[d] - 0.5;
+        }
+      if ( isInside )
+        {
+        AppendWeights( index, m_InputSize, interpolator, this->m_Columns, this->m_Weights );
+        }
+      this->m_RowOffsets.push_back( this->m_Columns.size() );
+      }
+    }
+}
+
+
+ResamplingOperator::~ResamplingOperator() = default;
+
+
+std::string ResamplingOperator::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::ResamplingOperator\n"
+      << "\tInterpolator: " << this->m_Interpolator << std::endl
+      << "\tInputSize: " << this->m_InputSize << std::endl
+      << "\tInputOrigin: " << this->m_InputOrigin << std::endl
+      << "\tInputSpacing: " << this->m_InputSpacing << std::endl
+      << "\tInputDirection: " << this->m_InputDirection << std::endl
+      << "\tOutputSize: " << this->m_OutputSize << std::endl
+      << "\tOutputOrigin: " << this->m_OutputOrigin << std::endl
+      << "\tOutputSpacing: " << this->m_OutputSpacing << std::endl
+      << "\tOutputDirection: " << this->m_OutputDirection << std::endl
+      << "\tNumberOfWeights: " << this->m_Weights.size() << std::endl;
+  return out.str();
+}
+
+
+InterpolatorEnum ResamplingOperator::GetInterpolator() const
+{
+  return this->m_Interpolator;
+}
+
+std::vector<unsigned int> ResamplingOperator::GetInputSize() const
+{
+  return this->m_InputSize;
+}
+
+std::vector<double> ResamplingOperator::GetInputOrigin() const
+{
+  return this->m_InputOrigin;
+}
+
+std::vector<double> ResamplingOperator::GetInputSpacing() const
+{
+  return this->m_InputSpacing;
+}
+
+std::vector<double> ResamplingOperator::GetInputDirection() const
+{
+  return this->m_InputDirection;
+}
+
+std::vector<unsigned int> ResamplingOperator::GetOutputSize() const
+{
+  return this->m_OutputSize;
+}
+
+std::vector<double> ResamplingOperator::GetOutputOrigin() const
+{
+  return this->m_OutputOrigin;
+}
+
+std::vector<double> ResamplingOperator::GetOutputSpacing() const
+{
+  return this->m_OutputSpacing;
+}
+
+std::vector<double> ResamplingOperator::GetOutputDirection() const
+{
+  return this->m_OutputDirection;
+}
+
+uint64_t ResamplingOperator::GetNumberOfWeights() const
+{
+  return this->m_Weights.size();
+}
+
+
+Image ResamplingOperator::Execute( const Image &image,
+                                   double defaultPixelValue,
+                                   PixelIDValueEnum outputPixelType ) const
+{
+  // the geometry is compared with the tolerance of the pixel spacing
+  const double tolerance = 1e-6 * ( m_InputSpacing.empty() ? 1.0 : *std::min_element( m_InputSpacing.begin(), m_InputSpacing.end() ) );
+  if ( image.GetSize() != this->m_InputSize
+       || !IsClose( image.GetOrigin(), this->m_InputOrigin, tolerance )
+       || !IsClose( image.GetSpacing(), this->m_InputSpacing, tolerance )
+       || !IsClose( image.GetDirection(), this->m_InputDirection, 1e-6 ) )
+    {
+    sitkExceptionMacro( "The image does not have the input geometry of the operator!\n"
+                        << "Image size: " << image.GetSize() << " origin: " << image.GetOrigin()
+                        << " spacing: " << image.GetSpacing() << " direction: " << image.GetDirection() << "\n"
+                        << this->ToString() );
+    }
+
+  const PixelIDValueEnum pixelType = ( outputPixelType != sitkUnknown ) ? outputPixelType : image.GetPixelID();
+  const bool isVector = IsVectorPixelID( image.GetPixelID() );
+  if ( IsVectorPixelID( pixelType ) != isVector )
+    {
+    sitkExceptionMacro( "The output pixel type " << GetPixelIDValueAsString( pixelType )
+                        << " does not match the pixel type of the image " << image.GetPixelIDTypeAsString() );
+    }
+
+  const PixelIDValueEnum computationType = isVector ? sitkVectorFloat64 : sitkFloat64;
+  const Image input = Cast( image, computationType );
+  const unsigned int numberOfComponents = input.GetNumberOfComponentsPerPixel();
+
+  Image output( m_OutputSize, computationType, isVector ? numberOfComponents : 0u );
+  output.SetOrigin( this->m_OutputOrigin );
+  output.SetSpacing( this->m_OutputSpacing );
+  output.SetDirection( this->m_OutputDirection );
+
+  const double *inputBuffer = input.GetBufferAsDouble();
+  double *outputBuffer = output.GetBufferAsDouble();
+  const uint64_t numberOfRows = this->m_RowOffsets.size() - 1;
+
+  auto gather = [this, inputBuffer, outputBuffer, numberOfComponents, defaultPixelValue]( uint64_t begin, uint64_t end )
+    {
+      for ( uint64_t row = begin; row < end; ++row )
+        {
+        double *pixel = outputBuffer + row * numberOfComponents;
+        const uint64_t first = this->m_RowOffsets[row];
+        const uint64_t last = this->m_RowOffsets[row + 1];
+        if ( first == last )
+          {
+          std::fill( pixel, pixel + numberOfComponents, defaultPixelValue );
+          continue;
+          }
+        std::fill( pixel, pixel + numberOfComponents, 0.0 );
+        for ( uint64_t k = first; k < last; ++k )
+          {
+          const double *value = inputBuffer + this->m_Columns[k] * numberOfComponents;
+          const double weight = this->m_Weights[k];
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            pixel[c] += weight * value[c];
+            }
+          }
+        }
+    };
+
+  const uint64_t numberOfBlocks = ( numberOfRows + ResamplingOperatorBlockSize - 1 ) / ResamplingOperatorBlockSize;
+  if ( numberOfBlocks <= 1 )
+    {
+    gather( 0, numberOfRows );
+    }
+  else
+    {
+    auto threader = itk::MultiThreaderBase::New();
+    threader->ParallelizeArray( 0, numberOfBlocks,
+                                [&gather, numberOfRows]( itk::SizeValueType block ) {
+                                  const uint64_t begin = block * ResamplingOperatorBlockSize;
+                                  gather( begin, std::min<uint64_t>( begin + ResamplingOperatorBlockSize, numberOfRows ) );
+                                },
+                                nullptr );
+    }
+
+  if ( pixelType != computationType )
+    {
+    return Cast( output, pixelType );
+    }
+  return output;
+}
+
+
+void ResamplingOperator::WriteToFile( const std::string &fileName ) const
+{
+  std::ofstream stream( fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+  if ( !stream )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for writing!" );
+    }
+
+  stream.write( ResamplingOperatorFileMagic, sizeof(ResamplingOperatorFileMagic) );
+  WriteValue( stream, ResamplingOperatorFileVersion );
+  WriteValue( stream, static_cast<int32_t>( this->m_Interpolator ) );
+  WriteValue( stream, static_cast<uint32_t>( this->m_InputSize.size() ) );
+
+  WriteValues( stream, this->m_InputSize );
+  WriteValues( stream, this->m_InputOrigin );
+  WriteValues( stream, this->m_InputSpacing );
+  WriteValues( stream, this->m_InputDirection );
+  WriteValues( stream, this->m_OutputSize );
+  WriteValues( stream, this->m_OutputOrigin );
+  WriteValues( stream, this->m_OutputSpacing );
+  WriteValues( stream, this->m_OutputDirection );
+
+  WriteValue( stream, static_cast<uint64_t>( this->m_Weights.size() ) );
+  WriteValues( stream, this->m_RowOffsets );
+  WriteValues( stream, this->m_Columns );
+  WriteValues( stream, this->m_Weights );
+
+  if ( !stream )
+    {
+    sitkExceptionMacro( "Error writing \"" << fileName << "\"!" );
+    }
+}
+
+
+ResamplingOperator::Self &ResamplingOperator::ReadFromFile( const std::string &fileName )
+{
+  std::ifstream stream( fileName.c_str(), std::ios::in | std::ios::binary );
+  if ( !stream )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for reading!" );
+    }
+
+  char magic[sizeof(ResamplingOperatorFileMagic)] = {};
+  stream.read( magic, sizeof(magic) );
+  if ( !stream || std::memcmp( magic, ResamplingOperatorFileMagic, sizeof(magic) ) != 0 )
+    {
+    sitkExceptionMacro( "The file \"" << fileName << "\" is not a ResamplingOperator!" );
+    }
+  const uint32_t version = ReadValue<uint32_t>( stream );
+  if ( version != ResamplingOperatorFileVersion )
+    {
+    sitkExceptionMacro( "The ResamplingOperator file \"" << fileName << "\" has the unsupported version " << version << "!" );
+    }
+
+  ResamplingOperator result;
+  result.m_Interpolator = static_cast<InterpolatorEnum>( ReadValue<int32_t>( stream ) );
+  const uint32_t dimension = ReadValue<uint32_t>( stream );
+  if ( !stream || dimension < 2 || dimension > SITK_MAX_DIMENSION )
+    {
+    sitkExceptionMacro( "The ResamplingOperator file \"" << fileName << "\" has an invalid dimension!" );
+    }
+
+  ReadValues( stream, result.m_InputSize, dimension );
+  ReadValues( stream, result.m_InputOrigin, dimension );
+  ReadValues( stream, result.m_InputSpacing, dimension );
+  ReadValues( stream, result.m_InputDirection, dimension * dimension );
+  ReadValues( stream, result.m_OutputSize, dimension );
+  ReadValues( stream, result.m_OutputOrigin, dimension );
+  ReadValues( stream, result.m_OutputSpacing, dimension );
+  ReadValues( stream, result.m_OutputDirection, dimension * dimension );
+
+  const uint64_t numberOfWeights = ReadValue<uint64_t>( stream );
+  if ( !stream )
+    {
+    sitkExceptionMacro( "Error reading \"" << fileName << "\"!" );
+    }
+  ReadValues( stream, result.m_RowOffsets, GetNumberOfPixels( result.m_OutputSize ) + 1 );
+  ReadValues( stream, result.m_Columns, numberOfWeights );
+  ReadValues( stream, result.m_Weights, numberOfWeights );
+
+  const uint64_t numberOfInputPixels = GetNumberOfPixels( result.m_InputSize );
+  if ( !stream
+       || result.m_RowOffsets.front() != 0u
+       || result.m_RowOffsets.back() != numberOfWeights
+       || !std::is_sorted( result.m_RowOffsets.begin(), result.m_RowOffsets.end() )
+       || std::any_of( result.m_Columns.begin(), result.m_Columns.end(),
+                       [numberOfInputPixels]( uint64_t column ) { return column >= numberOfInputPixels; } ) )
+    {
+    sitkExceptionMacro( "Error reading \"" << fileName << "\", the ResamplingOperator is invalid!" );
+    }
+
+  *this = std::move( result );
+  return *this;
+}
+
+}
+}
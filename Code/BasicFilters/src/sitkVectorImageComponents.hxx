@@ -0,0 +1,183 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkVectorImageComponents_hxx
+#define sitkVectorImageComponents_hxx
+
+#include <algorithm>
+#include <vector>
+#include <itkImage.h>
+#include <itkVectorImage.h>
+#include <itkMultiThreaderBase.h>
+
+namespace itk {
+namespace simple {
+namespace {
+
+// the number of pixels copied together by a work unit
+constexpr SizeValueType VectorImageComponentsBlockSize = 1 << 14;
+
+/** \brief Copy an interleaved buffer of pixels to one buffer for
+ * each component.
+ *
+ * The interleaved buffer is read once, by blocks of pixels split
+ * between numberOfThreads work units.
+ */
+template<typename TComponentType>
+void
+DeinterleaveComponentBuffers( const TComponentType * input,
+                              const std::vector< TComponentType * > & buffers,
+                              SizeValueType numberOfPixels,
+                              unsigned int numberOfThreads )
+{
+  const unsigned int numberOfComponents = static_cast< unsigned int >( buffers.size() );
+  const SizeValueType numberOfBlocks = ( numberOfPixels + VectorImageComponentsBlockSize - 1 ) / VectorImageComponentsBlockSize;
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->SetNumberOfWorkUnits( numberOfThreads );
+  threader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&]( SizeValueType block )
+      {
+        const SizeValueType end = std::min( numberOfPixels, ( block + 1 ) * VectorImageComponentsBlockSize );
+        for ( SizeValueType p = block * VectorImageComponentsBlockSize; p < end; ++p )
+          {
+          const TComponentType *pixel = input + p * numberOfComponents;
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            buffers[c][p] = pixel[c];
+            }
+          }
+      },
+    nullptr );
+}
+
+
+/** \brief Interleave one buffer for each component into a buffer of
+ * pixels, written once by blocks of pixels split between
+ * numberOfThreads work units.
+ */
+template<typename TComponentType>
+void
+InterleaveComponentBuffers( const std::vector< const TComponentType * > & buffers,
+                            TComponentType * output,
+                            SizeValueType numberOfPixels,
+                            unsigned int numberOfThreads )
+{
+  const unsigned int numberOfComponents = static_cast< unsigned int >( buffers.size() );
+  const SizeValueType numberOfBlocks = ( numberOfPixels + VectorImageComponentsBlockSize - 1 ) / VectorImageComponentsBlockSize;
+
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->SetNumberOfWorkUnits( numberOfThreads );
+  threader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&]( SizeValueType block )
+      {
+        const SizeValueType end = std::min( numberOfPixels, ( block + 1 ) * VectorImageComponentsBlockSize );
+        for ( SizeValueType p = block * VectorImageComponentsBlockSize; p < end; ++p )
+          {
+          TComponentType *pixel = output + p * numberOfComponents;
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            pixel[c] = buffers[c][p];
+            }
+          }
+      },
+    nullptr );
+}
+
+
+/** \brief Copy the components of a VectorImage to scalar images.
+ *
+ * The interleaved buffer is read once, by blocks of pixels split
+ * between numberOfThreads work units, instead of once for each
+ * component by the VectorIndexSelectionCastImageFilter.
+ */
+template<typename TVectorImageType>
+std::vector< typename itk::Image< typename TVectorImageType::InternalPixelType, TVectorImageType::ImageDimension >::Pointer >
+SplitVectorImageComponents( const TVectorImageType * image, unsigned int numberOfThreads )
+{
+  using ComponentType = typename TVectorImageType::InternalPixelType;
+  using ComponentImageType = itk::Image< ComponentType, TVectorImageType::ImageDimension >;
+
+  const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  const SizeValueType numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  std::vector< typename ComponentImageType::Pointer > components( numberOfComponents );
+  std::vector< ComponentType * > buffers( numberOfComponents );
+  for ( unsigned int c = 0; c < numberOfComponents; ++c )
+    {
+    components[c] = ComponentImageType::New();
+    components[c]->CopyInformation( image );
+    components[c]->SetRegions( image->GetBufferedRegion() );
+    components[c]->Allocate();
+    buffers[c] = components[c]->GetBufferPointer();
+    }
+
+  DeinterleaveComponentBuffers( image->GetBufferPointer(), buffers, numberOfPixels, numberOfThreads );
+
+  return components;
+}
+
+
+/** \brief Interleave scalar images of the same region into a
+ * VectorImage.
+ *
+ * The output has the geometry of the first image, as the output of
+ * the ComposeImageFilter, and is written once by blocks of pixels
+ * split between numberOfThreads work units.
+ */
+template<typename TImageType>
+typename itk::VectorImage< typename TImageType::PixelType, TImageType::ImageDimension >::Pointer
+JoinVectorImageComponents( const std::vector< typename TImageType::ConstPointer > & components, unsigned int numberOfThreads )
+{
+  using PixelType = typename TImageType::PixelType;
+  using VectorImageType = itk::VectorImage< PixelType, TImageType::ImageDimension >;
+
+  const unsigned int numberOfComponents = static_cast< unsigned int >( components.size() );
+  const typename TImageType::RegionType region = components[0]->GetBufferedRegion();
+  const SizeValueType numberOfPixels = region.GetNumberOfPixels();
+
+  std::vector< const PixelType * > buffers( numberOfComponents );
+  for ( unsigned int c = 0; c < numberOfComponents; ++c )
+    {
+    if ( components[c]->GetBufferedRegion().GetSize() != region.GetSize() )
+      {
+      itkGenericExceptionMacro( "The component " << c << " of size " << components[c]->GetBufferedRegion().GetSize()
+                                << " does not match the size " << region.GetSize() << " of the first component!" );
+      }
+    buffers[c] = components[c]->GetBufferPointer();
+    }
+
+  typename VectorImageType::Pointer output = VectorImageType::New();
+  output->CopyInformation( components[0] );
+  output->SetRegions( region );
+  output->SetNumberOfComponentsPerPixel( numberOfComponents );
+  output->Allocate();
+
+  InterleaveComponentBuffers( buffers, output->GetBufferPointer(), numberOfPixels, numberOfThreads );
+
+  return output;
+}
+
+}
+} // end namespace simple
+} // end namespace itk
+
+#endif
@@ -0,0 +1,120 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkVectorToPlanarImageFilter.h"
+#include "sitkVectorImageComponents.hxx"
+
+namespace itk {
+  namespace simple {
+
+    VectorToPlanarImageFilter::~VectorToPlanarImageFilter ()
+    = default;
+
+    VectorToPlanarImageFilter::VectorToPlanarImageFilter ()
+    {
+      this->m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+      // the output has one more dimension than the input
+      this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2, SITK_MAX_DIMENSION-1 > ();
+    }
+
+    std::string VectorToPlanarImageFilter::ToString() const {
+      std::ostringstream out;
+      out << "itk::simple::VectorToPlanarImageFilter" << std::endl;
+      out << ProcessObject::ToString();
+      return out.str();
+    }
+
+    Image VectorToPlanarImageFilter::Execute ( const Image &image )
+    {
+      PixelIDValueEnum type = image.GetPixelID();
+      unsigned int dimension = image.GetDimension();
+
+      if ( dimension >= SITK_MAX_DIMENSION )
+        {
+        sitkExceptionMacro( "The planar image of an image of dimension " << dimension
+                            << " would have more than the " << SITK_MAX_DIMENSION << " supported dimensions!" );
+        }
+
+      return this->m_MemberFactory->GetMemberFunction( type, dimension )( image );
+    }
+
+    template <class TImageType>
+    Image VectorToPlanarImageFilter::ExecuteInternal ( const Image &inImage )
+    {
+      using InputImageType = TImageType;
+      constexpr unsigned int Dimension = InputImageType::ImageDimension;
+      using ComponentType = typename InputImageType::InternalPixelType;
+      using OutputImageType = itk::Image<ComponentType, Dimension + 1>;
+
+      typename InputImageType::ConstPointer image =
+        dynamic_cast <const InputImageType*> ( inImage.GetITKBase() );
+
+      const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+      const typename InputImageType::RegionType region = image->GetBufferedRegion();
+
+      // the geometry of the input, and the component index along the
+      // last dimension
+      typename OutputImageType::RegionType outputRegion;
+      typename OutputImageType::PointType origin;
+      typename OutputImageType::SpacingType spacing;
+      typename OutputImageType::DirectionType direction;
+      direction.SetIdentity();
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        outputRegion.SetIndex( d, region.GetIndex( d ) );
+        outputRegion.SetSize( d, region.GetSize( d ) );
+        origin[d] = image->GetOrigin()[d];
+        spacing[d] = image->GetSpacing()[d];
+        for ( unsigned int e = 0; e < Dimension; ++e )
+          {
+          direction[d][e] = image->GetDirection()[d][e];
+          }
+        }
+      outputRegion.SetIndex( Dimension, 0 );
+      outputRegion.SetSize( Dimension, numberOfComponents );
+      origin[Dimension] = 0.0;
+      spacing[Dimension] = 1.0;
+
+      typename OutputImageType::Pointer output = OutputImageType::New();
+      output->SetRegions( outputRegion );
+      output->SetOrigin( origin );
+      output->SetSpacing( spacing );
+      output->SetDirection( direction );
+      output->Allocate();
+
+      // each component is a contiguous plane of the output
+      const SizeValueType numberOfPixels = region.GetNumberOfPixels();
+      std::vector< ComponentType * > planes( numberOfComponents );
+      for ( unsigned int c = 0; c < numberOfComponents; ++c )
+        {
+        planes[c] = output->GetBufferPointer() + c * numberOfPixels;
+        }
+
+      DeinterleaveComponentBuffers( image->GetBufferPointer(), planes, numberOfPixels, this->GetNumberOfThreads() );
+
+      return this->CastITKToImage( output.GetPointer() );
+    }
+
+    Image VectorToPlanar ( const Image &image )
+    {
+      VectorToPlanarImageFilter filter;
+      return filter.Execute( image );
+    }
+
+  } // end namespace simple
+} // end namespace itk
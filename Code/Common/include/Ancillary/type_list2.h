@@ -159,6 +159,36 @@ struct has_type<typelist<T0, Ts...>, T> : has_type<typelist<Ts...>, T>
 {};
 #endif
 
+/**\class intersect
+ * \brief Keeps the types of a typelist which are also in a second typelist
+ *
+ * Example:
+ * \code
+ * using MyTypeList = typelist2::typelist<int, char, short>;
+ * using IntList = typelist2::intersect<MyTypeList, typelist2::typelist<int, short>>::type;
+ * \endcode
+ *
+ * The order of the types in the first typelist is preserved.
+ */
+template <typename Typelist, typename FilterTypelist>
+struct intersect;
+template <typename FilterTypelist>
+struct intersect<typelist<>, FilterTypelist>
+{
+  using type = typelist<>;
+};
+template <typename T, typename... Ts, typename FilterTypelist>
+struct intersect<typelist<T, Ts...>, FilterTypelist>
+{
+private:
+  using tail = typename intersect<typelist<Ts...>, FilterTypelist>::type;
+
+public:
+  using type = typename std::conditional<has_type<FilterTypelist, T>::value,
+                                         typename append<typelist<T>, tail>::type,
+                                         tail>::type;
+};
+
 /**\class visit
  * \brief Runs a templated predicate on each type in the typelist
  *
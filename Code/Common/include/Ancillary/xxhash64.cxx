@@ -0,0 +1,178 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "xxhash64.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t Prime3 = 0x165667B19E3779F9ULL;
+const uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t RotateLeft( uint64_t x, int r )
+{
+  return ( x << r ) | ( x >> ( 64 - r ) );
+}
+
+// the input is read as little endian on every system
+inline uint64_t Read64( const unsigned char *p )
+{
+  uint64_t value = 0;
+  for ( int i = 7; i >= 0; --i )
+    {
+    value = ( value << 8 ) | p[i];
+    }
+  return value;
+}
+
+inline uint32_t Read32( const unsigned char *p )
+{
+  return static_cast<uint32_t>( p[0] ) | ( static_cast<uint32_t>( p[1] ) << 8 )
+    | ( static_cast<uint32_t>( p[2] ) << 16 ) | ( static_cast<uint32_t>( p[3] ) << 24 );
+}
+
+inline uint64_t Round( uint64_t accumulator, uint64_t input )
+{
+  accumulator += input * Prime2;
+  accumulator = RotateLeft( accumulator, 31 );
+  return accumulator * Prime1;
+}
+
+inline uint64_t MergeRound( uint64_t accumulator, uint64_t value )
+{
+  accumulator ^= Round( 0, value );
+  return accumulator * Prime1 + Prime4;
+}
+
+inline void ProcessStripe( uint64_t accumulators[4], const unsigned char *stripe )
+{
+  accumulators[0] = Round( accumulators[0], Read64( stripe ) );
+  accumulators[1] = Round( accumulators[1], Read64( stripe + 8 ) );
+  accumulators[2] = Round( accumulators[2], Read64( stripe + 16 ) );
+  accumulators[3] = Round( accumulators[3], Read64( stripe + 24 ) );
+}
+}
+
+
+XXH64::XXH64( uint64_t seed )
+{
+  this->Reset( seed );
+}
+
+
+void XXH64::Reset( uint64_t seed )
+{
+  m_Seed = seed;
+  m_Accumulators[0] = seed + Prime1 + Prime2;
+  m_Accumulators[1] = seed + Prime2;
+  m_Accumulators[2] = seed;
+  m_Accumulators[3] = seed - Prime1;
+  m_TotalLength = 0;
+  m_BufferSize = 0;
+}
+
+
+void XXH64::Update( const void *input, size_t length )
+{
+  const unsigned char *p = static_cast<const unsigned char *>( input );
+  m_TotalLength += length;
+
+  // complete a stripe buffered by the previous update
+  if ( m_BufferSize > 0 )
+    {
+    const size_t n = std::min( length, sizeof( m_Buffer ) - m_BufferSize );
+    std::memcpy( m_Buffer + m_BufferSize, p, n );
+    m_BufferSize += n;
+    p += n;
+    length -= n;
+    if ( m_BufferSize < sizeof( m_Buffer ) )
+      {
+      return;
+      }
+    ProcessStripe( m_Accumulators, m_Buffer );
+    m_BufferSize = 0;
+    }
+
+  for ( ; length >= 32; p += 32, length -= 32 )
+    {
+    ProcessStripe( m_Accumulators, p );
+    }
+
+  std::memcpy( m_Buffer, p, length );
+  m_BufferSize = length;
+}
+
+
+uint64_t XXH64::Digest() const
+{
+  uint64_t h;
+  if ( m_TotalLength >= 32 )
+    {
+    h = RotateLeft( m_Accumulators[0], 1 ) + RotateLeft( m_Accumulators[1], 7 )
+      + RotateLeft( m_Accumulators[2], 12 ) + RotateLeft( m_Accumulators[3], 18 );
+    for ( uint64_t accumulator : m_Accumulators )
+      {
+      h = MergeRound( h, accumulator );
+      }
+    }
+  else
+    {
+    h = m_Seed + Prime5;
+    }
+
+  h += m_TotalLength;
+
+  const unsigned char *p = m_Buffer;
+  size_t length = m_BufferSize;
+  for ( ; length >= 8; p += 8, length -= 8 )
+    {
+    h ^= Round( 0, Read64( p ) );
+    h = RotateLeft( h, 27 ) * Prime1 + Prime4;
+    }
+  if ( length >= 4 )
+    {
+    h ^= static_cast<uint64_t>( Read32( p ) ) * Prime1;
+    h = RotateLeft( h, 23 ) * Prime2 + Prime3;
+    p += 4;
+    length -= 4;
+    }
+  for ( ; length > 0; ++p, --length )
+    {
+    h ^= static_cast<uint64_t>( *p ) * Prime5;
+    h = RotateLeft( h, 11 ) * Prime1;
+    }
+
+  h ^= h >> 33;
+  h *= Prime2;
+  h ^= h >> 29;
+  h *= Prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+
+uint64_t XXH64::Hash( const void *input, size_t length, uint64_t seed )
+{
+  XXH64 hash( seed );
+  hash.Update( input, length );
+  return hash.Digest();
+}
@@ -0,0 +1,57 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef xxhash64_h
+#define xxhash64_h
+
+// included for import export macros
+#include "sitkCommon.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/** \brief The XXH64 non-cryptographic hash function.
+ *
+ * This is an implementation of the 64-bit hash of the xxHash
+ * algorithm by Yann Collet, which is much faster than MD5 and SHA1
+ * and produces the same digests as the reference implementation. The
+ * input is appended in pieces of any size, then the digest is
+ * returned by Digest, which does not modify the state.
+ */
+class SITKCommon_EXPORT XXH64
+{
+public:
+  explicit XXH64( uint64_t seed = 0 );
+
+  void Reset( uint64_t seed = 0 );
+
+  void Update( const void *input, size_t length );
+
+  uint64_t Digest() const;
+
+  /** The digest of an input at once. */
+  static uint64_t Hash( const void *input, size_t length, uint64_t seed = 0 );
+
+private:
+  uint64_t m_Accumulators[4];
+  uint64_t m_Seed;
+  uint64_t m_TotalLength;
+  unsigned char m_Buffer[32];
+  size_t m_BufferSize;
+};
+
+#endif // xxhash64_h
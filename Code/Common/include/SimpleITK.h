@@ -57,7 +57,10 @@
 #include "sitkInterpolator.h"
 #include "sitkEvent.h"
 #include "sitkRandomSeed.h"
+#include "sitkMemoryStatistics.h"
 
+#include "sitkExecutor.h"
+#include "sitkCancellationToken.h"
 #include "sitkProcessObject.h"
 #include "sitkImageFilter.h"
 #include "sitkObjectOwnedBase.h"
@@ -67,14 +70,25 @@
 
 // IO classes
 #include "sitkImageFileReader.h"
+#include "sitkImageFilePrefetchReader.h"
 #include "sitkImageSeriesReader.h"
+#include "sitkDICOMSeriesIndex.h"
+#include "sitkDICOMSeriesConverter.h"
 #include "sitkImageFileWriter.h"
 #include "sitkImageSeriesWriter.h"
+#include "sitkStreamingResample.h"
 #include "sitkImportImageFilter.h"
 #include "sitkImageViewer.h"
 
 
 #include "sitkHashImageFilter.h"
+#include "sitkFusedStatisticsImageFilter.h"
+#include "sitkLabelEvaluationImageFilter.h"
+#include "sitkMultiChannelLabelStatisticsImageFilter.h"
+#include "sitkMultiProjectionImageFilter.h"
+#include "sitkMultiResolutionPyramidImageFilter.h"
+#include "sitkPlanarToVectorImageFilter.h"
+#include "sitkVectorToPlanarImageFilter.h"
 #include "sitkJoinSeriesImageFilter.h"
 #include "sitkComposeImageFilter.h"
 #include "sitkPixelIDTypeLists.h"
@@ -86,8 +100,12 @@
 #include "sitkCastImageFilter.h"
 #include "sitkExtractImageFilter.h"
 #include "sitkPasteImageFilter.h"
+#include "sitkPointwiseExpressionImageFilter.h"
+#include "sitkFFTConfiguration.h"
 
 #include "sitkAdditionalProcedures.h"
+#include "sitkResampler.h"
+#include "sitkResamplingOperator.h"
 
 #ifdef SITK_USE_ELASTIX
 #  include "sitkElastixImageFilter.h"
@@ -95,6 +113,7 @@
 #endif
 
 #include "sitkImageRegistrationMethod.h"
+#include "sitkIterationRecorderCommand.h"
 
 // These headers are auto-generated
 #include "SimpleITKBasicFiltersGeneratedHeaders.h"
@@ -0,0 +1,97 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkCancellationToken_h
+#define sitkCancellationToken_h
+
+#include "sitkCommon.h"
+
+#include <memory>
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class CancellationToken
+ * \brief A request to stop executions before they complete.
+ *
+ * A token is cancelled by calling Cancel, or when its deadline has
+ * passed. Process objects with a cancelled token do not start their
+ * execution, and executing ITK filters are aborted at their next
+ * progress or iteration event. Filters which do not report progress
+ * run to completion. The ImageRegistrationMethod stops its optimizer
+ * at the next iteration.
+ *
+ * An execution which was cancelled throws an exception.
+ *
+ * Copies of a CancellationToken refer to the same state, and it is
+ * safe to cancel a token from another thread than the executing one.
+ *
+ * \sa ProcessObject::SetCancellationToken
+ */
+class SITKCommon_EXPORT CancellationToken
+{
+public:
+  CancellationToken();
+
+  ~CancellationToken();
+
+  CancellationToken( const CancellationToken & );
+  CancellationToken &operator=( const CancellationToken & );
+
+  /** Request the executions using this token to stop. */
+  void Cancel();
+
+  /** True after Cancel was called or the deadline has passed. */
+  bool IsCancelled() const;
+
+  /** \brief Cancel the token when seconds have elapsed from now.
+   *
+   * A non-positive value cancels the token immediately.
+   * @{
+   */
+  void SetDeadline( double seconds );
+  bool HasDeadline() const;
+  void RemoveDeadline();
+  /**@}*/
+
+  /** The seconds until the deadline, which is negative after it has
+   * passed. Zero is returned when no deadline is set. */
+  double GetRemainingTime() const;
+
+  /** Clear the cancellation and the deadline, so the token may be
+   * reused. */
+  void Reset();
+
+  /** Two tokens are equal when they share the same state. @{ */
+  bool operator==( const CancellationToken & other ) const;
+  bool operator!=( const CancellationToken & other ) const;
+  /**@}*/
+
+  std::string ToString() const;
+
+private:
+  struct CancellationTokenState;
+  std::shared_ptr<CancellationTokenState> m_State;
+};
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // sitkCancellationToken_h
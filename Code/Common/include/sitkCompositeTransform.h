@@ -114,6 +114,41 @@ public:
    */
   SITK_RETURN_SELF_TYPE_HEADER FlattenTransform();
 
+  /** \brief Merge the adjacent linear transforms and remove the
+   * identities.
+   *
+   * The nested composite transforms are first flattened. Then each
+   * run of adjacent linear transforms of the stack, the matrix offset
+   * transforms such as the Euler, Similarity, Versor and Affine
+   * transforms, and the translation transforms, is replaced by one
+   * AffineTransform of the composition. The identity transforms, and
+   * the linear transforms composing to the identity, are removed. The
+   * points are then transformed by one transform per run instead of
+   * one per transform, e.g. when resampling.
+   *
+   * A run of one transform is kept as is. The transform at the back
+   * of the stack has the optimizable parameters.
+   */
+  SITK_RETURN_SELF_TYPE_HEADER CollapseTransform();
+
+  /** \brief Collapse the transform, then replace the non-linear
+   * tail by one displacement field.
+   *
+   * After CollapseTransform, the transforms from the first non-linear
+   * transform of the stack to the back are replaced by a
+   * DisplacementFieldTransform sampling their composition on the
+   * grid, which is in the input space of the back transform, e.g.
+   * the grid of the resampled image. The displacement field is
+   * linearly interpolated between the grid points and is zero outside
+   * of the grid.
+   *
+   * An empty direction is the identity.
+   */
+  SITK_RETURN_SELF_TYPE_HEADER CollapseTransform( const std::vector<uint32_t> &size,
+                                                  const std::vector<double> &origin,
+                                                  const std::vector<double> &spacing,
+                                                  const std::vector<double> &direction = std::vector<double>() );
+
   /** \brief Add a transform to the back of the stack.
    *
    * A deep-copy of the transform is performed. The added transform will have
@@ -180,6 +215,11 @@ private:
   void InternalInitialization(itk::Transform<double, NDimensions, NDimensions> *);
 
   std::function<void ()> m_pfFlattenTransform;
+  std::function<void ()> m_pfCollapseTransform;
+  std::function<void ( const std::vector<uint32_t> &,
+                       const std::vector<double> &,
+                       const std::vector<double> &,
+                       const std::vector<double> & )> m_pfCollapseTransformToDisplacementField;
   std::function<void ( Transform & )> m_pfAddTransform;
   std::function<void ()> m_pfRemoveTransform;
   std::function<Transform ()> m_pfBackTransform;
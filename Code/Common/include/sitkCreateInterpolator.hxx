@@ -28,6 +28,12 @@
 #include <itkWindowedSincInterpolateImageFunction.h>
 #include <itkBSplineResampleImageFunction.h>
 
+#ifdef SITK_USE_EXPLICITITK
+#include "sitkExplicitITKNearestNeighborInterpolateImageFunction.h"
+#include "sitkExplicitITKLinearInterpolateImageFunction.h"
+#include "sitkExplicitITKBSplineInterpolateImageFunction.h"
+#endif
+
 namespace itk
 {
 
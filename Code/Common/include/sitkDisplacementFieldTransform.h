@@ -50,8 +50,14 @@ public:
    * constructed transform object. The input image is modified to be a
    * default constructed Image object.
    *
-   * Image must be of sitkVectorFloat64 pixel type with the number of
-   * components equal to the image dimension.
+   * Image must be of sitkVectorFloat64 or sitkVectorFloat32 pixel
+   * type with the number of components equal to the image dimension.
+   *
+   * The buffer of a sitkVectorFloat64 image is used without a copy,
+   * unless it is shared with other Image objects. A sitkVectorFloat32
+   * image, as computed by TransformToDisplacementFieldFilter with a
+   * float output, is converted directly to the sitkVectorFloat64
+   * field of the transform, and its buffer is released.
    *
    */
   explicit DisplacementFieldTransform( Image &);
@@ -73,8 +79,14 @@ public:
    * transferred to the constructed transform object. The input image
    * is modified to be a default constructed Image object.
    *
-   * Image must be of sitkVectorFloat64 pixel type with the number of
-   * components equal to the image dimension.
+   * Image must be of sitkVectorFloat64 or sitkVectorFloat32 pixel
+   * type with the number of components equal to the image dimension.
+   *
+   * The buffer of a sitkVectorFloat64 image is used without a copy,
+   * unless it is shared with other Image objects. A sitkVectorFloat32
+   * image, as computed by TransformToDisplacementFieldFilter with a
+   * float output, is converted directly to the sitkVectorFloat64
+   * field of the transform, and its buffer is released.
    *
    */
   SITK_RETURN_SELF_TYPE_HEADER SetDisplacementField(Image &);
@@ -105,6 +117,46 @@ public:
                                      bool enforceStationaryBoundary=true,
                                      unsigned int order=3 );
 
+  /** \brief Compose a transform after this transform, in place
+   *
+   * The displacement field u is replaced, on its grid, by the
+   * displacement of the composition, transform( x + u(x) ) - x. It is
+   * equivalent to a CompositeTransform which applies this transform
+   * first, with a single field lookup when evaluated. The pixels are
+   * computed on all the threads, in the buffer of the field unless it
+   * is shared with another transform. The inverse displacement field
+   * is removed, since it no longer matches the field.
+   *
+   * Composing two DisplacementFieldTransforms results in a field on
+   * the grid of this transform.
+   */
+  SITK_RETURN_SELF_TYPE_HEADER ComposeTransform( const Transform &transform );
+
+  /** \brief Compute the inverse displacement field by fixed point
+   * iteration
+   *
+   * The inverse v, on the grid of the displacement field u, is the
+   * solution of v(y) = -u( y + v(y) ). Each iteration updates all the
+   * pixels of v, on all the threads, and the iterations stop when the
+   * largest residual | v(y) + u( y + v(y) ) |, in physical units, is
+   * below maximumResidualTolerance, or after
+   * maximumNumberOfIterations. The iteration converges for smooth
+   * invertible fields, with displacement gradients of norm less than
+   * one.
+   *
+   * When the current inverse displacement field has the geometry of
+   * the displacement field, it is the initial estimate and its buffer
+   * is updated in place. So repeated inversions of a slowly changing
+   * field, as in diffeomorphic registration, only need a few
+   * iterations. Otherwise the iterations start from a zero field. The
+   * result is set as the inverse displacement field, used by
+   * GetInverse.
+   *
+   * Returns the largest residual of the computed inverse.
+   */
+  double ComputeInverseDisplacementField( unsigned int maximumNumberOfIterations = 50,
+                                          double maximumResidualTolerance = 1e-3 );
+
 
 protected:
 
@@ -166,6 +218,9 @@ private:
   std::function<void (double, double)> m_pfSetSmoothingGaussianOnUpdate;
   std::function<void (const std::vector<unsigned int> &,const std::vector<unsigned int>&, bool, unsigned int)> m_pfSetSmoothingBSplineOnUpdate;
 
+  std::function<void (const itk::TransformBase *)> m_pfComposeTransform;
+  std::function<double (unsigned int, double)> m_pfComputeInverseDisplacementField;
+
 };
 
 }
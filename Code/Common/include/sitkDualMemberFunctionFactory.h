@@ -50,7 +50,9 @@ namespace detail
  *  member functions by taking the address in the
  *  RegisterMethods. Later they can be retrieve with the
  *  GetMemberFunction method, which returns a function object with the
- *  same arguments as the templated member function pointer.
+ *  same arguments as the templated member function pointer. As with
+ *  the MemberFunctionFactory the registration is deferred until the
+ *  combination of pixel ids and dimension is requested.
  *
  *  An instance of a MemberFunctionFactory is bound to a specific
  *  instance of an object, so that the returned function object does
@@ -180,8 +182,25 @@ public:
 
 protected:
 
+  using KeyType = typename Superclass::KeyType;
+
+  // a deferred registration, a null key registers all member functions
+  using RegistrarType = void (*)( Self &, const KeyType * );
+
+  template < typename TPixelIDTypeList1, typename TPixelIDTypeList2, unsigned int VImageDimension, typename TAddressor >
+  static void RegisterDualMemberFunctionsForKey( Self &factory, const KeyType *key );
+
+  template < typename TPixelIDTypeList, unsigned int VImageDimension, typename TAddressor >
+  static void RegisterMemberFunctionsForKey( Self &factory, const KeyType *key );
+
+  /** Runs the deferred registrations for the key once, and returns
+   * the function object or nullptr if none is registered. */
+  const FunctionObjectType *ResolveMemberFunction( const KeyType &key );
+
   ObjectType *m_ObjectPointer;
 
+  std::vector<RegistrarType> m_Registrars;
+
 };
 
 } // end namespace detail
@@ -42,8 +42,13 @@ namespace detail
 template < typename TMemberFunctionFactory, unsigned int VImageDimension, typename TAddressor >
 struct DualMemberFunctionInstantiater
 {
-  DualMemberFunctionInstantiater( TMemberFunctionFactory &factory )
-    : m_Factory( factory )
+  // only the pixel ids are registered, unless they are sitkUnknown
+  DualMemberFunctionInstantiater( TMemberFunctionFactory &factory,
+                                  PixelIDValueType pixelID1 = sitkUnknown,
+                                  PixelIDValueType pixelID2 = sitkUnknown )
+    : m_Factory( factory ),
+      m_PixelID1( pixelID1 ),
+      m_PixelID2( pixelID2 )
     {}
 
   template <class TPixelIDType1, class TPixelIDType2 = TPixelIDType1>
@@ -57,6 +62,13 @@ struct DualMemberFunctionInstantiater
       using ImageType2 = typename PixelIDToImageType<TPixelIDType2, VImageDimension>::ImageType;
       using AddressorType = TAddressor;
 
+      if ( m_PixelID1 != sitkUnknown &&
+           ( m_PixelID1 != ImageTypeToPixelIDValue<ImageType1>::value ||
+             m_PixelID2 != ImageTypeToPixelIDValue<ImageType2>::value ) )
+        {
+        return;
+        }
+
       AddressorType addressor;
       m_Factory.Register(addressor.CLANG_TEMPLATE operator()<ImageType1, ImageType2>(), (ImageType1*)(nullptr), (ImageType2*)(nullptr) );
 
@@ -75,6 +87,8 @@ struct DualMemberFunctionInstantiater
 private:
 
   TMemberFunctionFactory &m_Factory;
+  PixelIDValueType        m_PixelID1;
+  PixelIDValueType        m_PixelID2;
 };
 
 template <typename TMemberFunctionPointer>
@@ -112,7 +126,9 @@ DualMemberFunctionFactory< TMemberFunctionPointer >
   typename Superclass::KeyType key(TImageType1::GetImageDimension(), pixelID1,
                                    TImageType2::GetImageDimension(), pixelID2);
 
-  Superclass::m_PFunction[ key ] = Superclass::BindObject( pfunc, m_ObjectPointer );
+  // complete the deferred registrations so this registration takes precedence
+  this->ResolveMemberFunction( key );
+  Superclass::m_PFunction.Insert( key, Superclass::BindObject( pfunc, m_ObjectPointer ) );
 
 }
 
@@ -121,12 +137,54 @@ template < typename TPixelIDTypeList1, typename TPixelIDTypeList2, unsigned int
 void
 DualMemberFunctionFactory< TMemberFunctionPointer >
 ::RegisterMemberFunctions( )
+{
+  RegistrarType registrar =
+    &Self::template RegisterDualMemberFunctionsForKey<TPixelIDTypeList1, TPixelIDTypeList2, VImageDimension, TAddressor>;
+
+  // keys which have already been resolved see the registration immediately
+  if ( Superclass::m_PFunction.AnyResolved() )
+    {
+    registrar( *this, nullptr );
+    }
+  m_Registrars.push_back( registrar );
+}
+
+
+template <typename TMemberFunctionPointer>
+template < typename TPixelIDTypeList, unsigned int VImageDimension, typename TAddressor >
+void
+DualMemberFunctionFactory< TMemberFunctionPointer >
+::RegisterMemberFunctions( )
+{
+  RegistrarType registrar =
+    &Self::template RegisterMemberFunctionsForKey<TPixelIDTypeList, VImageDimension, TAddressor>;
+
+  // keys which have already been resolved see the registration immediately
+  if ( Superclass::m_PFunction.AnyResolved() )
+    {
+    registrar( *this, nullptr );
+    }
+  m_Registrars.push_back( registrar );
+}
+
+
+template <typename TMemberFunctionPointer>
+template < typename TPixelIDTypeList1, typename TPixelIDTypeList2, unsigned int VImageDimension, typename TAddressor >
+void
+DualMemberFunctionFactory< TMemberFunctionPointer >
+::RegisterDualMemberFunctionsForKey( Self &factory, const KeyType *key )
 {
   using InstantiaterType = DualMemberFunctionInstantiater< Self, VImageDimension, TAddressor >;
 
+  if ( key && std::get<0>( *key ) != VImageDimension )
+    {
+    return;
+    }
+
   // initialize function array with pointer
   typelist2::dual_visit<TPixelIDTypeList1, TPixelIDTypeList2> visitEachComboInLists;
-  visitEachComboInLists( InstantiaterType( *this ) );
+  visitEachComboInLists( key ? InstantiaterType( factory, std::get<1>( *key ), std::get<3>( *key ) )
+                             : InstantiaterType( factory ) );
 }
 
 
@@ -134,14 +192,37 @@ template <typename TMemberFunctionPointer>
 template < typename TPixelIDTypeList, unsigned int VImageDimension, typename TAddressor >
 void
 DualMemberFunctionFactory< TMemberFunctionPointer >
-::RegisterMemberFunctions( )
+::RegisterMemberFunctionsForKey( Self &factory, const KeyType *key )
 {
-
   using InstantiaterType = DualMemberFunctionInstantiater< Self, VImageDimension, TAddressor >;
 
+  if ( key && std::get<0>( *key ) != VImageDimension )
+    {
+    return;
+    }
+
   // initialize function array with pointer
   typelist2::visit<TPixelIDTypeList> visitEachComboInLists;
-  visitEachComboInLists( InstantiaterType( *this ) );
+  visitEachComboInLists( key ? InstantiaterType( factory, std::get<1>( *key ), std::get<3>( *key ) )
+                             : InstantiaterType( factory ) );
+}
+
+
+template <typename TMemberFunctionPointer>
+const typename DualMemberFunctionFactory< TMemberFunctionPointer >::FunctionObjectType *
+DualMemberFunctionFactory< TMemberFunctionPointer >
+::ResolveMemberFunction( const KeyType &key )
+{
+  if ( !Superclass::m_PFunction.IsResolved( key ) )
+    {
+    // mark first, the registrars register through Register
+    Superclass::m_PFunction.SetResolved( key );
+    for ( auto registrar : m_Registrars )
+      {
+      registrar( *this, &key );
+      }
+    }
+  return Superclass::m_PFunction.Find( key );
 }
 
 
@@ -153,8 +234,8 @@ DualMemberFunctionFactory< TMemberFunctionPointer >
   typename Superclass::KeyType key(imageDimension, pixelID1, imageDimension, pixelID2);
   try
     {
-    // check if tr1::function has been set in map
-    return Superclass::m_PFunction.find( key ) != Superclass::m_PFunction.end();
+    // resolving the deferred registration only caches the function object
+    return const_cast<Self *>( this )->ResolveMemberFunction( key ) != nullptr;
     }
   // we do not throw exceptions
   catch(...)
@@ -181,10 +262,10 @@ DualMemberFunctionFactory< TMemberFunctionPointer >
   typename Superclass::KeyType key(imageDimension, pixelID1, imageDimension, pixelID2);
 
   // check if tr1::function has been set
-  auto ret_pair = Superclass::m_PFunction.find( key ) ;
-  if ( ret_pair != Superclass::m_PFunction.end() )
+  const auto *function = this->ResolveMemberFunction( key );
+  if ( function != nullptr )
     {
-    return ret_pair->second;
+    return *function;
     }
   // todo updated exceptions here
   sitkExceptionMacro ( << "Pixel type: "
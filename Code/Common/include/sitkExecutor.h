@@ -0,0 +1,111 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkExecutor_h
+#define sitkExecutor_h
+
+#include "sitkCommon.h"
+
+#include <memory>
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class Executor
+ * \brief A budget of threads shared by the process objects it is
+ * attached to.
+ *
+ * Before a process object executes its ITK filter, it acquires
+ * threads from its Executor, and the threads are released when the
+ * execution completes. Each execution is granted its requested
+ * number of threads, limited by the per execution quota and the
+ * threads not in use by other executions. An execution is always
+ * granted at least one thread, so nested and concurrent executions
+ * sharing an Executor make progress without oversubscribing the
+ * processors.
+ *
+ * Copies of an Executor refer to the same budget, and it is safe to
+ * use an Executor from multiple threads.
+ *
+ * \sa ProcessObject::SetExecutor ProcessObject::SetGlobalDefaultExecutor
+ */
+class SITKCommon_EXPORT Executor
+{
+public:
+  /** \brief Construct with a budget of maximumNumberOfThreads.
+   *
+   * When zero, the budget is the global default number of threads.
+   */
+  explicit Executor( unsigned int maximumNumberOfThreads = 0 );
+
+  ~Executor();
+
+  Executor( const Executor & );
+  Executor &operator=( const Executor & );
+
+  /** The number of threads shared by all executions.
+   * @{
+   */
+  void SetMaximumNumberOfThreads( unsigned int n );
+  unsigned int GetMaximumNumberOfThreads() const;
+  /**@}*/
+
+  /** The maximum number of threads granted to one execution. When
+   * zero, a single execution may use the whole budget.
+   * @{
+   */
+  void SetMaximumNumberOfThreadsPerExecution( unsigned int n );
+  unsigned int GetMaximumNumberOfThreadsPerExecution() const;
+  /**@}*/
+
+  /** The number of threads currently granted to executions. */
+  unsigned int GetNumberOfActiveThreads() const;
+
+  /** The number of executions which currently hold threads. */
+  unsigned int GetNumberOfActiveExecutions() const;
+
+  /** \brief Acquire threads for an execution.
+   *
+   * Returns the number of threads granted, which is at least one,
+   * and must be returned with ReleaseThreads. The process objects
+   * call these methods, they are public to share the budget with
+   * other multi-threaded work.
+   * @{
+   */
+  unsigned int AcquireThreads( unsigned int requested );
+  void ReleaseThreads( unsigned int granted );
+  /**@}*/
+
+  /** Two executors are equal when they share the same budget. @{ */
+  bool operator==( const Executor & other ) const;
+  bool operator!=( const Executor & other ) const;
+  /**@}*/
+
+  std::string ToString() const;
+
+private:
+  struct ExecutorState;
+  std::shared_ptr<ExecutorState> m_State;
+};
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // sitkExecutor_h
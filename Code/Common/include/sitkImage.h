@@ -71,6 +71,14 @@ namespace simple
    * Image class, as copying and returning by value do not
    * unnecessarily duplicate the data.
    *
+   * Concurrent const access to an image, including copying it, is
+   * thread safe. The reference counting is atomic so one input image
+   * may be shared by filters executing on several threads without
+   * serialization or deep copies, each filter uses a private ITK image
+   * sharing the pixel buffer. A single Image object must not be
+   * modified while it is accessed by another thread, and an image
+   * which shares its buffer is not unique, so modifying it makes a copy.
+   *
    * /sa itk::Image itk::VectorImage itk::LabelMap itk::ImageBase
    */
   class SITKCommon_EXPORT Image
@@ -259,6 +267,22 @@ namespace simple
     /** Transform continuous index to physical point */
     std::vector< double > TransformContinuousIndexToPhysicalPoint( const std::vector< double > &index) const;
 
+    /** \brief Transform many points or indices in one call.
+     *
+     * The input is a flat array of N points or indices, each with a
+     * number of elements equal to the image dimension, ordered as x0,
+     * y0, z0, x1, y1, z1... The output is a flat array in the same
+     * order. The transformation matrix is computed once for all of
+     * the points, and the results are the same as the corresponding
+     * single point methods.
+     * @{
+     */
+    std::vector< double > TransformIndicesToPhysicalPoints( const std::vector< int64_t > &indices ) const;
+    std::vector< int64_t > TransformPhysicalPointsToIndices( const std::vector< double > &points ) const;
+    std::vector< double > TransformPhysicalPointsToContinuousIndices( const std::vector< double > &points ) const;
+    std::vector< double > TransformContinuousIndicesToPhysicalPoints( const std::vector< double > &indices ) const;
+    /** @} */
+
     /** \brief Interpolate pixel value at a continuous index.
      *
      * This method is not supported for Label pixel types.
@@ -285,6 +309,31 @@ namespace simple
      */
     std::vector<double> EvaluateAtPhysicalPoint( const std::vector<double> &point, InterpolatorEnum interp = sitkLinear) const;
 
+    /** \brief Interpolate pixel values at many continuous indices or
+     * physical points.
+     *
+     * The input is a flat array of N indices or points, each with a
+     * number of elements equal to the image dimension. The output is
+     * a flat array with the values for each point in order, with the
+     * same number of values per point as EvaluateAtContinuousIndex.
+     * An exception is thrown if any point is out of bounds.
+     *
+     * The interpolator is constructed once and kept with the image
+     * for subsequent calls with the same interpolator type, which
+     * avoids recomputing the coefficients of the BSpline
+     * interpolators. The cached interpolator is released when the
+     * image is modified through the Image interface, but not when the
+     * image is modified through a previously obtained buffer
+     * pointer. The points are evaluated in parallel with the global
+     * default number of threads.
+     *
+     * This method is not supported for Label pixel types.
+     * @{
+     */
+    std::vector<double> EvaluateAtContinuousIndices( const std::vector<double> &indices, InterpolatorEnum interp = sitkLinear) const;
+    std::vector<double> EvaluateAtPhysicalPoints( const std::vector<double> &points, InterpolatorEnum interp = sitkLinear) const;
+    /** @} */
+
     /** Get the number of pixels the Image is in each dimension as a
       * std::vector. The size of the vector is equal to the number of dimensions
       * for the image. */
@@ -313,6 +362,15 @@ namespace simple
      */
     void CopyInformation( const Image &srcImage );
 
+    /** \brief Copy the meta-data dictionary of the source image.
+     *
+     * Replaces the meta-data dictionary of this image with the one of
+     * srcImage, such as to give a filter output the meta-data of its
+     * input. The entries are not copied, the dictionary is shared by
+     * the images until one of them modifies it.
+     */
+    void CopyMetaData( const Image &srcImage );
+
     /** \brief get a vector of keys in from the meta-data dictionary
      *
      * Returns a vector of keys to the key/value entries in the
@@ -485,6 +543,99 @@ namespace simple
     const void     *GetBufferAsVoid() const;
     /** @} */
 
+    /** \brief Copy a region of the image's buffer to or from a
+     * contiguous array.
+     *
+     * These methods copy a rectangular block of pixels between the
+     * image and a caller provided array with a single dispatch. The
+     * block is copied scanline by scanline, which is dramatically
+     * faster than accessing each pixel with the GetPixelAs* or
+     * SetPixelAs* methods.
+     *
+     * The array is ordered the same as the image's buffer, that is
+     * the components of a pixel are contiguous followed by the first
+     * dimension then the subsequent dimensions. The array must have
+     * room for NumberOfComponentsPerPixel times the number of pixels
+     * in the region values. Complex pixels are accessed with the
+     * Float or Double methods, with the real part followed by the
+     * imaginary part.
+     *
+     * The correct method for the image's pixel component type must be
+     * called, following the same rules as the GetBufferAs* methods,
+     * otherwise an exception will be generated. This includes label
+     * images which do not support buffer access.
+     *
+     * \param index the zero based starting index of the region. It's
+     * length must be at least the value of GetDimension().
+     * \param size the number of pixels in each dimension of the
+     * region. It's length must be at least the value of
+     * GetDimension(). If the region is not completely inside the
+     * image an exception is thrown.
+     * \param buffer pointer to the contiguous array.
+     *
+     * \sa Image::GetBufferAsVoid
+     * @{
+     */
+    void GetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int8_t *buffer ) const;
+    void GetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint8_t *buffer ) const;
+    void GetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int16_t *buffer ) const;
+    void GetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint16_t *buffer ) const;
+    void GetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int32_t *buffer ) const;
+    void GetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint32_t *buffer ) const;
+    void GetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int64_t *buffer ) const;
+    void GetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint64_t *buffer ) const;
+    void GetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, float *buffer ) const;
+    void GetRegionAsDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, double *buffer ) const;
+
+    void SetRegionFromInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int8_t *buffer );
+    void SetRegionFromUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint8_t *buffer );
+    void SetRegionFromInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int16_t *buffer );
+    void SetRegionFromUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint16_t *buffer );
+    void SetRegionFromInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int32_t *buffer );
+    void SetRegionFromUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint32_t *buffer );
+    void SetRegionFromInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int64_t *buffer );
+    void SetRegionFromUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint64_t *buffer );
+    void SetRegionFromFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const float *buffer );
+    void SetRegionFromDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const double *buffer );
+    /** @} */
+
+
+
+    /** \brief Get an image of a region of this image.
+     *
+     * The output has the size of the region, with the origin at the
+     * physical location of the region's index, and the spacing and
+     * direction of this image. The meta-data dictionary is copied.
+     *
+     * When the region is contiguous in memory, that is the region
+     * spans the full extent of the image up to one dimension and has
+     * a size of one in the remaining dimensions, the output refers to
+     * this image's buffer without a copy. The buffer is then shared
+     * with the copy-on-write semantics of the Image, so that
+     * modifying either image does not modify the other. Otherwise the
+     * region is copied.
+     *
+     * This method is not supported for Label pixel types.
+     */
+    Image GetSubImage( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const;
+
+    /** \brief Get an image which refers to this image's buffer, with
+     * another size and physical information.
+     *
+     * The pixels keep their order in the buffer, so the size must
+     * have the number of pixels of this image. This represents the
+     * operations which only move or flip the axes of one pixel, such
+     * as permuting the axes (x, y, 1) to (x, 1, y), without a copy. The
+     * buffer is shared with the copy-on-write semantics of the Image,
+     * as for GetSubImage. The meta-data dictionary of the output is
+     * empty.
+     *
+     * This method is not supported for Label pixel types.
+     */
+    Image GetReshapedView( const std::vector<uint32_t> &size,
+                           const std::vector<double> &origin,
+                           const std::vector<double> &spacing,
+                           const std::vector<double> &direction ) const;
 
     /** \brief Performs actually coping if needed to make object unique.
      *
@@ -549,6 +700,24 @@ namespace simple
     friend struct AllocateMemberFunctionAddressor;
 
 
+    /** Make the image unique before the region described by index
+     * and size is overwritten.
+     *
+     * When the region covers the whole image the current pixel values
+     * are not needed, so a shared image is replaced by a newly
+     * allocated one with the same meta-data instead of a deep copy.
+     */
+    void MakeUniqueForRegionWrite( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size );
+
+    /** Make the image unique before its meta-data or geometry is
+     * modified.
+     *
+     * The pixel values are not modified, so a shared image is
+     * replaced by a copy of the header which shares the pixel
+     * container, and the pixels are copied on the next write.
+     */
+    void MakeUniqueForInformationWrite( );
+
     std::unique_ptr<PimpleImageBase> m_PimpleImage;
   };
 
@@ -0,0 +1,117 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkInstructionSet_h
+#define sitkInstructionSet_h
+
+#include "sitkCommon.h"
+
+#include <string>
+
+// The kernels are compiled for the extensions of x86 with the target
+// attribute of GCC and Clang, other compilers and architectures only
+// have the baseline kernels of the compiler flags. On AArch64 the
+// baseline includes NEON.
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define SITK_MULTIVERSION_X86 1
+#endif
+
+namespace itk
+{
+namespace simple
+{
+
+// this namespace is internal classes not part of the external simple ITK interface
+namespace detail
+{
+
+enum class InstructionSetEnum : int
+{
+  Baseline,
+  AVX2,
+  AVX512
+};
+
+/** The instruction set of the dispatched kernels. It is the best
+ * supported by the processor, unless selected with the
+ * SITK_INSTRUCTION_SET environment variable or with
+ * SetInstructionSet. */
+SITKCommon_EXPORT InstructionSetEnum GetInstructionSet();
+
+/** Select the instruction set by name, "BASELINE", "AVX2", "AVX512"
+ * or "AUTO" for the best supported. Returns false when the name is
+ * not valid or the instruction set is not supported by the processor.
+ */
+SITKCommon_EXPORT bool SetInstructionSet( const std::string &name );
+SITKCommon_EXPORT std::string GetInstructionSetName();
+
+
+#if defined( SITK_MULTIVERSION_X86 )
+/** The function object is inlined, with the functions it calls, into
+ * a function compiled for the instruction set. Only the inner loops
+ * of a kernel are to be dispatched, the calls which cannot be inlined
+ * remain baseline code.
+ * @{
+ */
+template <typename TFunction>
+__attribute__(( target( "avx2" ), flatten ))
+void InvokeAVX2( TFunction &f )
+{
+  f();
+}
+
+template <typename TFunction>
+__attribute__(( target( "avx512f,avx512bw,avx512dq,avx512vl" ), flatten ))
+void InvokeAVX512( TFunction &f )
+{
+  f();
+}
+/**@}*/
+#endif
+
+
+/** Invoke the function object compiled for the selected instruction
+ * set.
+ *
+ * The floating point operations are not contracted into FMA, so the
+ * results are identical for all instruction sets.
+ */
+template <typename TFunction>
+void InvokeWithInstructionSet( TFunction &&f )
+{
+#if defined( SITK_MULTIVERSION_X86 )
+  switch ( GetInstructionSet() )
+    {
+    case InstructionSetEnum::AVX512:
+      InvokeAVX512( f );
+      return;
+    case InstructionSetEnum::AVX2:
+      InvokeAVX2( f );
+      return;
+    case InstructionSetEnum::Baseline:
+    default:
+      break;
+    }
+#endif
+  f();
+}
+
+}
+}
+}
+
+#endif // sitkInstructionSet_h
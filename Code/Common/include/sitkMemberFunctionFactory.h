@@ -47,6 +47,10 @@ namespace detail {
  *  with the GetMemberFunction methods, which return a function object
  *  with the same arguments as the templated member function pointer.
  *
+ *  The registration of RegisterMemberFunctions is deferred, only the
+ *  member function of a requested pixel id and dimension is bound
+ *  the first time it is queried, so constructing a factory is cheap.
+ *
  *  An instance of a MemberFunctionFactory is bound to a specific
  *  instance of an object, so that the returned function object does
  *  not need to have the calling object specified.
@@ -185,8 +189,22 @@ public:
 
 protected:
 
+  using KeyType = typename Superclass::KeyType;
+
+  // a deferred registration, a null key registers all member functions
+  using RegistrarType = void (*)( Self &, const KeyType * );
+
+  template < typename TPixelIDTypeList, unsigned int VImageDimension, typename TAddressor >
+  static void RegisterMemberFunctionsForKey( Self &factory, const KeyType *key );
+
+  /** Runs the deferred registrations for the key once, and returns
+   * the function object or nullptr if none is registered. */
+  const FunctionObjectType *ResolveMemberFunction( const KeyType &key );
+
   ObjectType *m_ObjectPointer;
 
+  std::vector<RegistrarType> m_Registrars;
+
 };
 
 } // end namespace detail
@@ -42,8 +42,10 @@ namespace detail {
 template < typename TMemberFunctionFactory, unsigned int VImageDimension, typename TAddressor >
 struct MemberFunctionInstantiater
 {
-  MemberFunctionInstantiater( TMemberFunctionFactory &factory )
-    : m_Factory( factory )
+  // only the pixelID is registered, unless it is sitkUnknown
+  MemberFunctionInstantiater( TMemberFunctionFactory &factory, PixelIDValueType pixelID = sitkUnknown )
+    : m_Factory( factory ),
+      m_PixelID( pixelID )
     {}
 
   template <class TPixelIDType>
@@ -54,6 +56,11 @@ struct MemberFunctionInstantiater
       using ImageType = typename PixelIDToImageType<TPixelIDType, VImageDimension>::ImageType;
       using AddressorType = TAddressor;
 
+      if ( m_PixelID != sitkUnknown && m_PixelID != ImageTypeToPixelIDValue<ImageType>::value )
+        {
+        return;
+        }
+
       AddressorType addressor;
       m_Factory.Register(addressor.CLANG_TEMPLATE operator()<ImageType>(), (ImageType*)(nullptr));
 
@@ -70,6 +77,7 @@ struct MemberFunctionInstantiater
 private:
 
   TMemberFunctionFactory &m_Factory;
+  PixelIDValueType        m_PixelID;
 };
 
 template <typename TMemberFunctionPointer>
@@ -96,7 +104,9 @@ void MemberFunctionFactory<TMemberFunctionPointer>
 
   auto key = std::pair<unsigned int, int>(TImageType::GetImageDimension(), pixelID);
 
-  Superclass::m_PFunction[key] = Superclass::BindObject( pfunc, m_ObjectPointer );
+  // complete the deferred registrations so this registration takes precedence
+  this->ResolveMemberFunction( key );
+  Superclass::m_PFunction.Insert( key, Superclass::BindObject( pfunc, m_ObjectPointer ) );
 }
 
 template <typename TMemberFunctionPointer>
@@ -105,12 +115,53 @@ template <typename TPixelIDTypeList,
           typename TAddressor>
 void MemberFunctionFactory<TMemberFunctionPointer>
 ::RegisterMemberFunctions( )
+{
+  RegistrarType registrar = &Self::template RegisterMemberFunctionsForKey<TPixelIDTypeList, VImageDimension, TAddressor>;
+
+  // keys which have already been resolved see the registration immediately
+  if ( Superclass::m_PFunction.AnyResolved() )
+    {
+    registrar( *this, nullptr );
+    }
+  m_Registrars.push_back( registrar );
+}
+
+
+template <typename TMemberFunctionPointer>
+template <typename TPixelIDTypeList,
+          unsigned int VImageDimension,
+          typename TAddressor>
+void MemberFunctionFactory<TMemberFunctionPointer>
+::RegisterMemberFunctionsForKey( Self &factory, const KeyType *key )
 {
   using InstantiaterType = MemberFunctionInstantiater< MemberFunctionFactory, VImageDimension,TAddressor >;
 
+  if ( key && key->first != VImageDimension )
+    {
+    return;
+    }
+
   // visit each type in the list, and register if instantiated
   typelist2::visit<TPixelIDTypeList> visitEachType;
-  visitEachType( InstantiaterType( *this ) );
+  visitEachType( InstantiaterType( factory, key ? key->second : sitkUnknown ) );
+}
+
+
+template <typename TMemberFunctionPointer>
+const typename MemberFunctionFactory<TMemberFunctionPointer>::FunctionObjectType *
+MemberFunctionFactory<TMemberFunctionPointer>
+::ResolveMemberFunction( const KeyType &key )
+{
+  if ( !Superclass::m_PFunction.IsResolved( key ) )
+    {
+    // mark first, the registrars register through Register
+    Superclass::m_PFunction.SetResolved( key );
+    for ( auto registrar : m_Registrars )
+      {
+      registrar( *this, &key );
+      }
+    }
+  return Superclass::m_PFunction.Find( key );
 }
 
 
@@ -122,8 +173,8 @@ MemberFunctionFactory< TMemberFunctionPointer >
   auto key = typename Superclass::KeyType( imageDimension, pixelID);
   try
     {
-    // check if tr1::function has been set in map
-    return Superclass::m_PFunction.find( key ) != Superclass::m_PFunction.end();
+    // resolving the deferred registration only caches the function object
+    return const_cast<Self *>( this )->ResolveMemberFunction( key ) != nullptr;
     }
   // we do not throw exceptions
   catch(...)
@@ -146,10 +197,10 @@ MemberFunctionFactory<TMemberFunctionPointer>
   auto key = typename Superclass::KeyType(imageDimension, pixelID);
 
   // check if tr1::function has been set
-  auto ret_pair = Superclass::m_PFunction.find( key ) ;
-  if ( ret_pair != Superclass::m_PFunction.end() )
+  const auto *function = this->ResolveMemberFunction( key );
+  if ( function != nullptr )
     {
-    return ret_pair->second;
+    return *function;
     }
 
   sitkExceptionMacro ( << "Pixel type: "
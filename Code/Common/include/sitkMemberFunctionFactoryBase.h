@@ -27,9 +27,13 @@
 #include "Ancillary/type_list2.h"
 #include "Ancillary/FunctionTraits.h"
 
-#include <unordered_map>
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <tuple>
+#include <vector>
 
 namespace itk
 {
@@ -39,60 +43,146 @@ namespace simple
 // this namespace is internal and not part of the external simple ITK interface
 namespace detail {
 
-// make hash function available in current name space to take priority
-
-template <typename T> struct hash : public std::hash<T>{};
+/** \class MemberFunctionTableKey
+ * \brief Maps the keys of the member function factories to a dense index
+ *
+ * The keys are the image dimension and pixel id of each argument, only
+ * the instantiated dimensions [2, SITK_MAX_DIMENSION] and pixel ids are
+ * valid, and all the arguments must have the same dimension.
+ */
+template <typename TKey>
+struct MemberFunctionTableKey;
 
-/** A utility function to chain hashes */
-template<typename T>
-inline void hash_combine(std::size_t& seed, const T& val)
+template <>
+struct MemberFunctionTableKey< std::pair<unsigned int, int> >
 {
-  // Code from boost
-  // Reciprocal of the golden ratio helps spread entropy
-  //     and handles duplicates.
-  std::hash<T> hasher;
-  seed ^= hasher(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-}
-
-template<typename S, typename T>
-struct hash<std::pair<S, T>>
+  static constexpr unsigned int NumberOfPixelIDs = typelist2::length<InstantiatedPixelIDTypeList>::value;
+  static constexpr unsigned int NumberOfDimensions = SITK_MAX_DIMENSION - 1;
+  static constexpr size_t Size = NumberOfDimensions * NumberOfPixelIDs;
+
+  /** Returns the index of the key or Size if the key is not valid */
+  static size_t Index( const std::pair<unsigned int, int> & key ) noexcept
+    {
+      const unsigned int dimension = key.first;
+      const int pixelID = key.second;
+      if ( dimension < 2 || dimension > SITK_MAX_DIMENSION
+           || pixelID < 0 || pixelID >= static_cast<int>(NumberOfPixelIDs) )
+        {
+        return Size;
+        }
+      return ( dimension - 2 ) * NumberOfPixelIDs + pixelID;
+    }
+};
+
+template <>
+struct MemberFunctionTableKey< std::tuple<unsigned int, int, unsigned int, int> >
 {
-  inline size_t operator()(const std::pair<S, T>& val) const
+  static constexpr unsigned int NumberOfPixelIDs = typelist2::length<InstantiatedPixelIDTypeList>::value;
+  static constexpr unsigned int NumberOfDimensions = SITK_MAX_DIMENSION - 1;
+  static constexpr size_t Size = NumberOfDimensions * NumberOfPixelIDs * NumberOfPixelIDs;
+
+  /** Returns the index of the key or Size if the key is not valid */
+  static size_t Index( const std::tuple<unsigned int, int, unsigned int, int> & key ) noexcept
     {
-      size_t seed = 0;
-      hash_combine(seed, val.first);
-      hash_combine(seed, val.second);
-      return seed;
+      const unsigned int dimension = std::get<0>(key);
+      const int pixelID1 = std::get<1>(key);
+      const int pixelID2 = std::get<3>(key);
+      if ( dimension < 2 || dimension > SITK_MAX_DIMENSION || dimension != std::get<2>(key)
+           || pixelID1 < 0 || pixelID1 >= static_cast<int>(NumberOfPixelIDs)
+           || pixelID2 < 0 || pixelID2 >= static_cast<int>(NumberOfPixelIDs) )
+        {
+        return Size;
+        }
+      return ( ( dimension - 2 ) * NumberOfPixelIDs + pixelID1 ) * NumberOfPixelIDs + pixelID2;
     }
 };
 
-template<class... TupleArgs>
-struct hash<std::tuple<TupleArgs...>>
+
+/** \class MemberFunctionTable
+ * \brief A dense dispatch table of function objects
+ *
+ * The size of the table is fixed at compile time by the number of
+ * instantiated pixel ids and dimensions. The key is mapped to an
+ * index in a compact array of slots, so a look up is a bounds check
+ * and two array accesses without hashing. The function objects are
+ * stored contiguously in the order they are registered.
+ *
+ * Each key is also marked when its deferred registrations have been
+ * resolved, so the factories may register lazily.
+ */
+template <typename TKey, typename TFunctionObject>
+class MemberFunctionTable
 {
-private:
-  // recursive hashing of std::tuple from Sarang Baheti's blog
-  // https://www.variadic.xyz/2018/01/15/hashing-stdpair-and-stdtuple/
-  template<size_t Idx, typename... TupleTypes>
-  inline typename std::enable_if<Idx == sizeof...(TupleTypes), void>::type
-  hash_combine_tup(size_t&, const std::tuple<TupleTypes...>&) const {}
-
-  template<size_t Idx, typename... TupleTypes>
-  inline typename std::enable_if<Idx < sizeof...(TupleTypes), void>::type
-  hash_combine_tup(size_t& seed, const std::tuple<TupleTypes...>& tup) const
+public:
+  using KeyType = TKey;
+  using FunctionObjectType = TFunctionObject;
+  using TableKeyType = MemberFunctionTableKey<TKey>;
+
+  MemberFunctionTable()
     {
-      hash_combine(seed, std::get<Idx>(tup));
+      m_Slots.fill( 0 );
+    }
 
-      //  on to next element
-      hash_combine_tup<Idx+1>(seed, tup);
+  /** Set the function object of a key, replacing any previous function object */
+  void Insert( const KeyType & key, FunctionObjectType function )
+    {
+      const size_t index = TableKeyType::Index( key );
+      if ( index >= TableKeyType::Size )
+        {
+        return;
+        }
+      if ( m_Slots[index] != 0 )
+        {
+        m_Functions[m_Slots[index] - 1] = std::move( function );
+        return;
+        }
+      m_Functions.push_back( std::move( function ) );
+      m_Slots[index] = static_cast<SlotType>( m_Functions.size() );
     }
 
-public:
-  size_t operator()(std::tuple<TupleArgs...> tupleValue) const
+  /** Returns a pointer to the function object of a key, or nullptr
+   * if there is none */
+  const FunctionObjectType * Find( const KeyType & key ) const noexcept
+    {
+      const size_t index = TableKeyType::Index( key );
+      if ( index >= TableKeyType::Size || m_Slots[index] == 0 )
+        {
+        return nullptr;
+        }
+      return &m_Functions[m_Slots[index] - 1];
+    }
+
+  /** Returns true if the deferred registrations of the key have been
+   * resolved, an invalid key has nothing to resolve */
+  bool IsResolved( const KeyType & key ) const noexcept
+    {
+      const size_t index = TableKeyType::Index( key );
+      return index >= TableKeyType::Size || m_Resolved[index];
+    }
+
+  void SetResolved( const KeyType & key ) noexcept
+    {
+      const size_t index = TableKeyType::Index( key );
+      if ( index < TableKeyType::Size )
+        {
+        m_Resolved[index] = true;
+        }
+    }
+
+  /** Returns true if any key has been resolved */
+  bool AnyResolved( ) const noexcept
     {
-      size_t seed = 0;
-      hash_combine_tup<0>(seed, tupleValue);
-      return seed;
+      return m_Resolved.any();
     }
+
+private:
+  // one based index into m_Functions, zero is an empty slot
+  using SlotType = uint16_t;
+  static_assert( TableKeyType::Size < std::numeric_limits<SlotType>::max(), "Slot type too small for table" );
+
+  std::array<SlotType, TableKeyType::Size> m_Slots;
+  std::bitset<TableKeyType::Size>          m_Resolved;
+  std::vector<FunctionObjectType>          m_Functions;
 };
 
 
@@ -119,9 +209,7 @@ protected:
   using MemberFunctionResultType = typename ::detail::FunctionTraits<MemberFunctionType>::ResultType;
 
 
-  MemberFunctionFactoryBase( )
-    :  m_PFunction( 3*typelist2::length<InstantiatedPixelIDTypeList>::value )
-    { }
+  MemberFunctionFactoryBase( ) = default;
 
 public:
 
@@ -147,9 +235,9 @@ protected:
       return std::bind( pfunc,objectPointer );
     }
 
-  using FunctionMapType = std::unordered_map< TKey, FunctionObjectType, hash<TKey> >;
+  using FunctionMapType = MemberFunctionTable< TKey, FunctionObjectType >;
 
-  // maps of Keys to pointers to member functions
+  // dispatch table of Keys to pointers to member functions
   FunctionMapType m_PFunction;
 
 
@@ -174,9 +262,7 @@ protected:
   using MemberFunctionArgumentType = typename ::detail::FunctionTraits<MemberFunctionType>::Argument0Type;
 
 
-  MemberFunctionFactoryBase( )
-    :  m_PFunction( 3 * typelist2::length<InstantiatedPixelIDTypeList>::value )
-    { }
+  MemberFunctionFactoryBase( ) = default;
 
 public:
 
@@ -205,9 +291,9 @@ protected:
     }
 
 
-  using FunctionMapType = std::unordered_map< TKey, FunctionObjectType, hash<TKey> >;
+  using FunctionMapType = MemberFunctionTable< TKey, FunctionObjectType >;
 
-  // maps of Keys to pointers to member functions
+  // dispatch table of Keys to pointers to member functions
   FunctionMapType m_PFunction;
 
 };
@@ -226,9 +312,7 @@ protected:
   using ObjectType = typename ::detail::FunctionTraits<MemberFunctionType>::ClassType;
 
 
-  MemberFunctionFactoryBase( )
-    :  m_PFunction( 3 * typelist2::length<InstantiatedPixelIDTypeList>::value )
-    { }
+  MemberFunctionFactoryBase( ) = default;
 
 public:
 
@@ -257,9 +341,9 @@ protected:
       return std::bind( pfunc, objectPointer, _1, _2 );
     }
 
-  using FunctionMapType = std::unordered_map< TKey, FunctionObjectType, hash<TKey> >;
+  using FunctionMapType = MemberFunctionTable< TKey, FunctionObjectType >;
 
-  // maps of Keys to pointers to member functions
+  // dispatch table of Keys to pointers to member functions
   FunctionMapType m_PFunction;
 
 };
@@ -279,9 +363,7 @@ protected:
   using ObjectType = typename ::detail::FunctionTraits<MemberFunctionType>::ClassType;
 
 
-  MemberFunctionFactoryBase( )
-    :  m_PFunction( 3 * typelist2::length<InstantiatedPixelIDTypeList>::value )
-    { }
+  MemberFunctionFactoryBase( ) = default;
 
 public:
 
@@ -309,9 +391,9 @@ protected:
       return std::bind( pfunc, objectPointer, _1, _2, _3 );
     }
 
-  using FunctionMapType = std::unordered_map< TKey, FunctionObjectType, hash<TKey> >;
+  using FunctionMapType = MemberFunctionTable< TKey, FunctionObjectType >;
 
-  // maps of Keys to pointers to member functions
+  // dispatch table of Keys to pointers to member functions
   FunctionMapType m_PFunction;
 
 };
@@ -332,9 +414,7 @@ protected:
   using ObjectType = typename ::detail::FunctionTraits<MemberFunctionType>::ClassType;
 
 
-  MemberFunctionFactoryBase( )
-    :  m_PFunction( 3 * typelist2::length<InstantiatedPixelIDTypeList>::value )
-    { }
+  MemberFunctionFactoryBase( ) = default;
 
 public:
 
@@ -362,9 +442,9 @@ protected:
       return std::bind( pfunc, objectPointer, _1, _2, _3, _4 );
     }
 
-  using FunctionMapType = std::unordered_map< TKey, FunctionObjectType, hash<TKey> >;
+  using FunctionMapType = MemberFunctionTable< TKey, FunctionObjectType >;
 
-  // maps of Keys to pointers to member functions
+  // dispatch table of Keys to pointers to member functions
   FunctionMapType m_PFunction;
 
 };
@@ -385,9 +465,7 @@ protected:
   using ObjectType = typename ::detail::FunctionTraits<MemberFunctionType>::ClassType;
 
 
-  MemberFunctionFactoryBase( )
-    :  m_PFunction( 3 * typelist2::length<InstantiatedPixelIDTypeList>::value )
-    { }
+  MemberFunctionFactoryBase( ) = default;
 
 public:
 
@@ -422,9 +500,9 @@ protected:
     }
 
 
-  using FunctionMapType = std::unordered_map< TKey, FunctionObjectType, hash<TKey> >;
+  using FunctionMapType = MemberFunctionTable< TKey, FunctionObjectType >;
 
-  // maps of Keys to pointers to member functions
+  // dispatch table of Keys to pointers to member functions
   FunctionMapType m_PFunction;
 
 
@@ -0,0 +1,72 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMemoryStatistics_h
+#define sitkMemoryStatistics_h
+
+#include "sitkCommon.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \brief A snapshot of the pixel memory held by SimpleITK images.
+ *
+ * A pixel buffer is counted once while it is referred to by at least
+ * one Image, regardless of the number of Images sharing it. An Image
+ * which is a view of another image's buffer refers to the whole
+ * buffer. Buffers only referred to by ITK objects, such as the
+ * internal images of executing filters, are not counted.
+ *
+ * \sa GetMemoryStatistics
+ */
+struct SITKCommon_EXPORT MemoryStatistics
+{
+  /** The number of live pixel buffers. */
+  uint64_t NumberOfBuffers{ 0 };
+  /** The bytes of the live pixel buffers. */
+  uint64_t Bytes{ 0 };
+  /** The maximum of Bytes since the process started. */
+  uint64_t PeakBytes{ 0 };
+  /** The number of copies made to make a shared image unique before
+   * it is modified ( copy-on-write ). */
+  uint64_t NumberOfDeepCopies{ 0 };
+
+  std::string ToString() const;
+};
+
+/** \brief Get the process wide counters of the pixel memory held by
+ * SimpleITK images.
+ *
+ * The counters are also reported in the debug output of filters, when
+ * the ProcessObject's debug flag is enabled.
+ */
+SITKCommon_EXPORT MemoryStatistics GetMemoryStatistics();
+
+#ifndef SWIG
+SITKCommon_EXPORT std::ostream & operator<<(std::ostream & os, const MemoryStatistics & stats);
+#endif
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // sitkMemoryStatistics_h
@@ -206,6 +206,40 @@ using AllPixelIDTypeList =
  */
 using InstantiatedPixelIDTypeList = AllPixelIDTypeList;
 
+
+/** List of pixel ids which the generated image filters are
+ *  instantiated for.
+ *
+ *  With the "Minimal" SimpleITK_PIXEL_TYPE_PROFILE only the uint8,
+ *  int16, uint16 and float32 pixel types are included, otherwise all
+ *  instantiated pixel ids are included. The images of the other types
+ *  are still supported, but the filters report them as unsupported.
+ *
+ * \sa ProfilePixelIDTypeList
+ */
+#ifdef SITK_PIXEL_TYPE_PROFILE_MINIMAL
+using FilterProfilePixelIDTypeList = typelist2::typelist<BasicPixelID<uint8_t>,
+                                                         BasicPixelID<int16_t>,
+                                                         BasicPixelID<uint16_t>,
+                                                         BasicPixelID<float>,
+                                                         VectorPixelID<uint8_t>,
+                                                         VectorPixelID<int16_t>,
+                                                         VectorPixelID<uint16_t>,
+                                                         VectorPixelID<float>,
+                                                         LabelPixelID<uint8_t>,
+                                                         LabelPixelID<uint16_t>>;
+#else
+using FilterProfilePixelIDTypeList = InstantiatedPixelIDTypeList;
+#endif
+
+/** Trims a pixel id type list to the pixel types of the
+ *  FilterProfilePixelIDTypeList, preserving the order.
+ *
+ * \sa FilterProfilePixelIDTypeList
+ */
+template <typename TPixelIDTypeList>
+using ProfilePixelIDTypeList = typename typelist2::intersect<TPixelIDTypeList, FilterProfilePixelIDTypeList>::type;
+
 }
 }
 #endif // _sitkPixelIDTypeLists_h
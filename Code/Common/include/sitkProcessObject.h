@@ -22,11 +22,18 @@
 #include "sitkNonCopyable.h"
 #include "sitkTemplateFunctions.h"
 #include "sitkEvent.h"
+#include "sitkExecutor.h"
+#include "sitkCancellationToken.h"
 #include "sitkImage.h"
 #include "sitkImageConvert.h"
 
+#include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <vector>
 
 namespace itk {
 
@@ -71,6 +78,17 @@ namespace itk {
       /** return user readable name for the filter */
       virtual std::string GetName() const = 0;
 
+      /** \brief Query if the filter can run in place.
+       *
+       * A filter which can run in place provides Execute methods
+       * taking an rvalue reference to the first input image. When the
+       * moved image does not share its buffer, the buffer is reused
+       * for the output if the output pixel type matches the input, so
+       * a pipeline may move intermediate images into these methods to
+       * avoid allocating new buffers.
+       */
+      virtual bool CanRunInPlace() const;
+
       /** Turn debugging output on/off.
        *
        * Enabling debugging prints additional information to stdout
@@ -116,6 +134,24 @@ namespace itk {
       static bool GetGlobalWarningDisplay();
       /**@}*/
 
+      /** Pass the meta-data dictionaries of the input images to ITK.
+       *
+       * Enabled by default, the ITK images given to the filters share
+       * the meta-data dictionary of the SimpleITK images, which is
+       * only copied when modified, and the output images carry the
+       * dictionary of the first input. When disabled, the inputs are
+       * given to the filters without their dictionaries, and the
+       * outputs do not receive them. The meta-data of the input
+       * SimpleITK images is unchanged, and is still written by the
+       * ImageFileWriter.
+       * @{
+       */
+      static void GlobalMetaDataPropagationOn();
+      static void GlobalMetaDataPropagationOff();
+      static void SetGlobalMetaDataPropagation(bool flag);
+      static bool GetGlobalMetaDataPropagation();
+      /**@}*/
+
       /** \brief Access the global tolerance to determine congruent spaces.
        *
        * The default tolerance is governed by the
@@ -180,6 +216,89 @@ namespace itk {
       static unsigned int GetGlobalDefaultNumberOfThreads();
       /**@}*/
 
+      /** \brief Set the allocator of pixel buffers for images
+       * constructed by SimpleITK.
+       *
+       * Valid values are "DEFAULT", "ALIGNED" for 64 byte aligned
+       * buffers, "POOL" to recycle released buffers of similar size,
+       * and "HUGEPAGES" to request transparent huge pages for large
+       * buffers where supported. Images produced internally by ITK
+       * filters are allocated by ITK.
+       *
+       * The set method returns true when the allocator string is
+       * valid, otherwise false is returned. The allocator argument
+       * is not case sensitive.
+       * @{
+       */
+      static bool SetGlobalDefaultImageBufferAllocator(const std::string &allocator);
+      static std::string GetGlobalDefaultImageBufferAllocator();
+      /**@}*/
+
+      /** \brief Counters of the bytes allocated from the system for
+       * image buffers, and the bytes reused from the buffer pool.
+       * @{
+       */
+      static uint64_t GetGlobalImageBufferBytesAllocated();
+      static uint64_t GetGlobalImageBufferBytesReused();
+      /**@}*/
+
+      /** \brief Set the placement of the pages of image buffers
+       * allocated by SimpleITK on the nodes of a NUMA system.
+       *
+       * Valid values are:
+       *  - "NONE" the default, the allocating thread initializes the
+       *  buffer, so the pages are on its node.
+       *  - "FIRST_TOUCH" large buffers are initialized in parallel by
+       *  the threads of the default multi-threader, distributing the
+       *  pages over the nodes of the threads.
+       *  - "INTERLEAVE" the pages of large buffers are interleaved
+       *  over all nodes on Linux, and initialized in parallel.
+       *
+       * Threads are not pinned to nodes by SimpleITK, the ITK
+       * multi-threaders own their threads. The affinity of the process
+       * can be set with tools such as numactl.
+       *
+       * The set method returns true when the policy string is valid,
+       * otherwise false is returned. The policy argument is not case
+       * sensitive.
+       * @{
+       */
+      static bool SetGlobalDefaultNUMAPolicy(const std::string &policy);
+      static std::string GetGlobalDefaultNUMAPolicy();
+      /**@}*/
+
+      /** \brief The NUMA nodes of the system and the indices of their
+       * logical CPUs.
+       *
+       * Without NUMA information, a single node with all the logical
+       * CPUs is reported.
+       * @{
+       */
+      static unsigned int GetNumberOfNUMANodes();
+      static std::vector<unsigned int> GetNUMANodeCPUs(unsigned int node);
+      /**@}*/
+
+      /** \brief Set the instruction set of the kernels dispatched at
+       * run-time, such as the fused pointwise expressions, the cast,
+       * the scanline resampling and the fused statistics.
+       *
+       * Valid values are "BASELINE", "AVX2", "AVX512" and "AUTO". The
+       * default is the best instruction set supported by the
+       * processor, or the one of the SITK_INSTRUCTION_SET environment
+       * variable. The extensions are only available on x86 with GCC
+       * and Clang, otherwise the kernels are compiled for the
+       * baseline of the compiler flags, which includes NEON on
+       * AArch64. The results do not depend on the instruction set.
+       *
+       * The set method returns true when the instruction set is valid
+       * and supported by the processor, otherwise false is
+       * returned. The argument is not case sensitive.
+       * @{
+       */
+      static bool SetGlobalDefaultInstructionSet(const std::string &instructionSet);
+      static std::string GetGlobalDefaultInstructionSet();
+      /**@}*/
+
       /** The number of threads used when executing a filter if the
        * filter is multi-threaded.
        *
@@ -212,6 +331,130 @@ namespace itk {
       virtual unsigned int GetNumberOfWorkUnits() const;
       /**@}*/
 
+      /** \brief Share a budget of threads with other process objects.
+       *
+       * When an Executor is set, the number of threads used by an
+       * execution is the number granted by the Executor for the
+       * requested NumberOfThreads. Concurrent executions of process
+       * objects sharing an Executor then divide its threads instead of
+       * each using all the processors.
+       *
+       * New process objects are initialized with the global default
+       * executor, if one is set.
+       *
+       * GetExecutor throws an exception when no executor is set.
+       *
+       * \sa Executor
+       * @{
+       */
+      virtual void SetExecutor(const Executor &executor);
+      virtual Executor GetExecutor() const;
+      virtual bool HasExecutor() const;
+      virtual void RemoveExecutor();
+      /**@}*/
+
+      /** \brief Set the executor with which new process objects are
+       * initialized.
+       *
+       * GetGlobalDefaultExecutor throws an exception when no default
+       * executor is set.
+       * @{
+       */
+      static void SetGlobalDefaultExecutor(const Executor &executor);
+      static Executor GetGlobalDefaultExecutor();
+      static bool HasGlobalDefaultExecutor();
+      static void RemoveGlobalDefaultExecutor();
+      /**@}*/
+
+      /** \brief Stop the execution when the token is cancelled.
+       *
+       * When the token is already cancelled, Execute throws an
+       * exception without running the ITK filter. During the execution,
+       * the token is checked at each progress and iteration event,
+       * and the ITK filter is aborted when cancelled, which throws an
+       * exception out of Execute.
+       *
+       * GetCancellationToken throws an exception when no token is set.
+       *
+       * \sa CancellationToken
+       * @{
+       */
+      virtual void SetCancellationToken(const CancellationToken &token);
+      virtual CancellationToken GetCancellationToken() const;
+      virtual bool HasCancellationToken() const;
+      virtual void RemoveCancellationToken();
+      /**@}*/
+
+      /** \brief Measurements of the last execution.
+       *
+       * The times span from the start of the first to the end of the
+       * last update of the ITK filter during the last Execute, in
+       * seconds. The CPU time is of the whole process, so it includes
+       * the work of all threads and other concurrent executions. The
+       * number of threads is the maximum the ITK filter was permitted
+       * to use. The bytes allocated are of the output images of the
+       * ITK filter, which were not reused from an input.
+       *
+       * The values are zero before an execution.
+       * @{
+       */
+      double GetLastExecutionWallTime() const;
+      double GetLastExecutionCPUTime() const;
+      unsigned int GetLastExecutionNumberOfThreads() const;
+      uint64_t GetLastExecutionBytesAllocated() const;
+      /**@}*/
+
+      /** \brief Record every execution of all process objects to a
+       * trace file.
+       *
+       * The file is written in the Chrome trace event JSON format,
+       * which can be loaded by the Perfetto UI or chrome://tracing. An
+       * event is written when each update of an ITK filter completes,
+       * with the measurements of the execution as arguments.
+       *
+       * Setting an empty file name completes and closes the current
+       * trace file. An exception is thrown if the file can not be
+       * opened.
+       * @{
+       */
+      static void SetGlobalTraceFileName(const std::string &fileName);
+      static std::string GetGlobalTraceFileName();
+      /**@}*/
+
+      /** \brief Record the most recent executions of all process
+       * objects in memory, as a flight recorder.
+       *
+       * An entry is recorded when each update of an ITK filter
+       * completes, with the name, the parameters from ToString, the
+       * sizes of the first input and output, the wall and CPU times
+       * and the number of threads. The entries are kept in a ring
+       * buffer of the capacity, where the oldest entries are
+       * replaced. A capacity of zero, the default, disables the
+       * recording.
+       *
+       * GetGlobalExecutionLog returns the entries as JSON lines, from
+       * the oldest. The text of the parameters is truncated.
+       * @{
+       */
+      static void SetGlobalExecutionLogCapacity(unsigned int capacity);
+      static unsigned int GetGlobalExecutionLogCapacity();
+      static std::string GetGlobalExecutionLog();
+      static void ClearGlobalExecutionLog();
+      /**@}*/
+
+      /** \brief Write the execution log to a file when the process
+       * crashes.
+       *
+       * The file is written on the SIGSEGV, SIGABRT, SIGFPE, SIGILL
+       * and SIGBUS signals, and by std::terminate, before the
+       * previous handlers are called. An empty file name, the
+       * default, restores the previous handlers.
+       * @{
+       */
+      static void SetGlobalExecutionLogCrashFileName(const std::string &fileName);
+      static std::string GetGlobalExecutionLogCrashFileName();
+      /**@}*/
+
 
       /** \brief Add a Command Object to observer the event.
        *
@@ -241,13 +484,34 @@ namespace itk {
        */
       virtual int AddCommand(itk::simple::EventEnum event, itk::simple::Command &cmd);
 
+      /** \brief Add a Command Object with a limited rate of progress
+       * events.
+       *
+       * For the sitkProgressEvent, the command is only invoked when at
+       * least minimumInterval seconds have elapsed and the progress has
+       * increased by at least minimumProgressDelta since the command
+       * was last invoked. The first event, and the event reporting the
+       * execution has completed are always delivered. The skipped
+       * events are discarded on the invoking thread, so an expensive
+       * command, such as one acquiring the Python GIL, is only
+       * called a limited number of times.
+       *
+       * Other events are not affected.
+       */
+      virtual int AddCommand(itk::simple::EventEnum event, itk::simple::Command &cmd,
+                             double minimumInterval, float minimumProgressDelta = 0.0f);
+
       #ifndef SWIG
       /** \brief Directly add a callback to observe an event.
        *
        * This overloaded method can take a C++ lambda function as a
        * second argument.
+       * @{
        */
       virtual int AddCommand(itk::simple::EventEnum event, const std::function<void()> &func);
+      virtual int AddCommand(itk::simple::EventEnum event, const std::function<void()> &func,
+                             double minimumInterval, float minimumProgressDelta = 0.0f);
+      /**@}*/
       #endif
 
       /** \brief Remove all registered commands.
@@ -295,8 +559,9 @@ namespace itk {
 
       struct EventCommand
       {
-        EventCommand(EventEnum e, Command *c)
-          : m_Event(e), m_Command(c), m_ITKTag(std::numeric_limits<unsigned long>::max())
+        EventCommand(EventEnum e, Command *c, double minimumInterval = 0.0, float minimumProgressDelta = 0.0f)
+          : m_Event(e), m_Command(c), m_ITKTag(std::numeric_limits<unsigned long>::max()),
+            m_MinimumInterval(minimumInterval), m_MinimumProgressDelta(minimumProgressDelta)
           {}
         EventEnum     m_Event;
         Command *     m_Command;
@@ -304,6 +569,10 @@ namespace itk {
         // set to max if currently not registered
         unsigned long m_ITKTag;
 
+        // limits on the rate of progress events
+        double        m_MinimumInterval;
+        float         m_MinimumProgressDelta;
+
         inline bool operator==(const EventCommand &o) const
           { return m_Command == o.m_Command; }
         inline bool operator<(const EventCommand &o) const
@@ -331,6 +600,12 @@ namespace itk {
       // overridable callback when the active process has completed
       virtual void OnActiveProcessDelete( );
 
+      // returns true if a cancellation token is set and cancelled
+      bool IsCancelled( ) const;
+
+      // throws an exception if the cancellation token is cancelled
+      void ThrowIfCancelled( ) const;
+
       friend class itk::simple::Command;
       // method call by command when it's deleted, maintains internal
       // references between command and process objects.
@@ -338,6 +613,14 @@ namespace itk {
       #endif
 
 
+      /** Get the ITK image of a SimpleITK image, to be the input of
+       * an ITK filter.
+       *
+       * Except for label maps, the returned ITK image is a new object
+       * sharing the pixel buffer of img. The ITK pipeline modifies
+       * its input images, such as the requested region, so this
+       * enables concurrent executions to share the input image.
+       */
       template< class TImageType >
         static typename TImageType::ConstPointer CastImageToITK( const Image &img )
       {
@@ -353,7 +636,27 @@ namespace itk {
                              << GetPixelIDValueAsString(ImageTypeToPixelIDValue<TImageType>::Result)
                              << "\"!" )
           }
-        return itkImage;
+        return ShareImageBuffer( itkImage.GetPointer() );
+      }
+
+      template< class TImageType >
+      static typename std::enable_if<!IsLabel<TImageType>::Value, typename TImageType::ConstPointer>::type
+        ShareImageBuffer( const TImageType *image )
+      {
+        typename TImageType::Pointer shared = TImageType::New();
+        shared->Graft( image );
+        if ( GetGlobalMetaDataPropagation() )
+          {
+          shared->SetMetaDataDictionary( image->GetMetaDataDictionary() );
+          }
+        return shared.GetPointer();
+      }
+
+      template< class TImageType >
+      static typename std::enable_if<IsLabel<TImageType>::Value, typename TImageType::ConstPointer>::type
+        ShareImageBuffer( const TImageType *image )
+      {
+        return image;
       }
 
       template< class TImageType >
@@ -419,11 +722,45 @@ namespace itk {
       // is removed.
       void RemoveObserverFromActiveProcessObject( EventCommand &e );
 
+      // Return the threads granted by the executor for the active
+      // process, if any.
+      void ReleaseExecutorThreads() noexcept;
+
+      // Update the measurements of the last execution on the start
+      // and end events of the active process.
+      void OnActiveProcessStart( itk::ProcessObject *p );
+      void OnActiveProcessEnd( itk::ProcessObject *p );
+
+      // End the trace range of the update of the active process, if
+      // one was begun.
+      void EndActiveProcessTraceRange();
+
       bool m_Debug;
 
       unsigned int m_NumberOfThreads;
       unsigned int m_NumberOfWorkUnits;
 
+      std::unique_ptr<Executor> m_Executor;
+
+      std::unique_ptr<CancellationToken> m_CancellationToken;
+
+      // the executor and number of threads granted for the active process
+      std::unique_ptr<Executor> m_ActiveExecutor;
+      unsigned int m_ActiveExecutorThreads;
+
+      // measurements of the last execution
+      bool m_ExecutionStarted;
+      std::chrono::steady_clock::time_point m_ExecutionStartTime;
+      std::chrono::steady_clock::time_point m_UpdateStartTime;
+      std::clock_t m_ExecutionStartCPUTime;
+      std::clock_t m_UpdateStartCPUTime;
+      double m_LastExecutionWallTime;
+      double m_LastExecutionCPUTime;
+      unsigned int m_LastExecutionNumberOfThreads;
+      uint64_t m_LastExecutionBytesAllocated;
+
+      bool m_ActiveProcessTraceRange;
+
       std::list<EventCommand> m_Commands;
 
       itk::ProcessObject *m_ActiveProcess;
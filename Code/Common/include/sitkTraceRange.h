@@ -0,0 +1,121 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkTraceRange_h
+#define sitkTraceRange_h
+
+#include "sitkCommon.h"
+
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+
+class Image;
+class ProcessObject;
+
+// this namespace is internal classes not part of the external simple ITK interface
+namespace detail
+{
+
+#if defined( SITK_TRACE_RANGES )
+/** Returns true when the SITK_TRACE_RANGES environment variable is
+ * set, and not "0", "OFF", "FALSE" or "NO". */
+SITKCommon_EXPORT bool GetTraceRangeEnabledFromEnvironment();
+
+/** The environment is read once, on the first range of the module. */
+inline bool IsTraceRangeEnabled()
+{
+  static const bool enabled = GetTraceRangeEnabledFromEnvironment();
+  return enabled;
+}
+#else
+constexpr bool IsTraceRangeEnabled()
+{
+  return false;
+}
+#endif
+
+
+/** \brief A scoped range annotated for the profiler selected with
+ * SimpleITK_TRACE_RANGE_BACKEND.
+ *
+ * The range begins on construction and ends on destruction on the
+ * same thread, and ranges nest. The name and the details of the
+ * range are only formatted when the ranges are enabled, otherwise the
+ * construction is a test of a static flag, which is compiled out
+ * without a backend.
+ */
+class SITKCommon_EXPORT TraceRange
+{
+public:
+  /** A range named by the process object, with the pixel type and
+   * the size of the image as details. */
+  explicit TraceRange( const ProcessObject &process, const Image *image = nullptr )
+  {
+    if ( IsTraceRangeEnabled() )
+      {
+      Begin( process, image );
+      m_Active = true;
+      }
+  }
+
+  /** A range named by the process object, with the file name as
+   * details. */
+  TraceRange( const ProcessObject &process, const std::string &fileName )
+  {
+    if ( IsTraceRangeEnabled() )
+      {
+      Begin( process, fileName );
+      m_Active = true;
+      }
+  }
+
+  ~TraceRange()
+  {
+    if ( m_Active )
+      {
+      End();
+      }
+  }
+
+  TraceRange( const TraceRange & ) = delete;
+  TraceRange &operator=( const TraceRange & ) = delete;
+
+  /** Begin and end a range which does not follow a scope, such as
+   * the update of an ITK filter between its start and end events. The
+   * calls must be balanced on the thread.
+   * @{
+   */
+  static void Begin( const std::string &name, const std::string &details );
+  static void End();
+  /**@}*/
+
+private:
+  static void Begin( const ProcessObject &process, const Image *image );
+  static void Begin( const ProcessObject &process, const std::string &fileName );
+
+  bool m_Active{ false };
+};
+
+}
+}
+}
+
+#endif // sitkTraceRange_h
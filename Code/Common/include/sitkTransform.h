@@ -197,6 +197,37 @@ public:
    */
   std::vector< double > TransformVector( const std::vector< double > &vector, const std::vector< double > &point) const;
 
+  /** \brief Apply transform to many points.
+   *
+   * The points are stored contiguously, the coordinates of the first
+   * point followed by the coordinates of the second, so the number of
+   * coordinates must be a multiple of the dimension of the
+   * transform. The points are transformed concurrently, and the
+   * matrix and offset of the linear transforms are only looked up
+   * once instead of for each point.
+   *
+   * The pointer version transforms numberOfPoints points of
+   * caller managed memory, outputPoints may be the same as points.
+   * @{
+   */
+  std::vector< double > TransformPoints( const std::vector< double > &points ) const;
+  void TransformPoints( const double *points, double *outputPoints, size_t numberOfPoints ) const;
+  /**@}*/
+
+  /** \brief Apply transform to many vectors, each at a point.
+   *
+   * The vectors and the points are stored contiguously as with
+   * TransformPoints, there must be as many points as vectors.
+   *
+   * The pointer version transforms numberOfVectors vectors of
+   * caller managed memory, outputVectors may be the same as
+   * vectors.
+   * @{
+   */
+  std::vector< double > TransformVectors( const std::vector< double > &vectors, const std::vector< double > &points ) const;
+  void TransformVectors( const double *vectors, const double *points, double *outputVectors, size_t numberOfVectors ) const;
+  /**@}*/
+
   // write
   void WriteTransform( const std::string &filename ) const;
 
@@ -310,11 +341,23 @@ private:
 };
 
 
+/** \brief Read and write transforms with the ITK transform IOs
+ *
+ * A file name with the ".sitktx" extension is read and written in a
+ * compact binary format of SimpleITK, which stores the parameters as
+ * raw doubles aligned for memory mapping. It is much faster than the
+ * text ".tfm" and HDF5 formats for displacement field and large
+ * BSpline transforms, and supports composite transforms. The
+ * displacement field is read directly into the buffer of the field
+ * shared with DisplacementFieldTransform::GetDisplacementField.
+ * @{
+ */
 // read
 SITKCommon_EXPORT Transform ReadTransform( const std::string &filename );
 
 // write
 SITKCommon_EXPORT void WriteTransform( const Transform &transform, const std::string &filename);
+/** @} */
 
 }
 }
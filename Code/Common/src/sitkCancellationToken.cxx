@@ -0,0 +1,135 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkCancellationToken.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+using ClockType = std::chrono::steady_clock;
+
+int64_t Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( ClockType::now().time_since_epoch() ).count();
+}
+}
+
+struct CancellationToken::CancellationTokenState
+{
+  std::atomic<bool> Cancelled{ false };
+  std::atomic<bool> HasDeadline{ false };
+  // nanoseconds of the steady clock
+  std::atomic<int64_t> Deadline{ 0 };
+};
+
+
+CancellationToken::CancellationToken()
+  : m_State( std::make_shared<CancellationTokenState>() )
+{
+}
+
+CancellationToken::~CancellationToken() = default;
+
+CancellationToken::CancellationToken( const CancellationToken & ) = default;
+
+CancellationToken &CancellationToken::operator=( const CancellationToken & ) = default;
+
+
+void CancellationToken::Cancel()
+{
+  m_State->Cancelled = true;
+}
+
+bool CancellationToken::IsCancelled() const
+{
+  if ( m_State->Cancelled )
+    {
+    return true;
+    }
+  return m_State->HasDeadline && Now() >= m_State->Deadline;
+}
+
+
+void CancellationToken::SetDeadline( double seconds )
+{
+  m_State->Deadline = Now() + static_cast<int64_t>( seconds * 1e9 );
+  m_State->HasDeadline = true;
+}
+
+bool CancellationToken::HasDeadline() const
+{
+  return m_State->HasDeadline;
+}
+
+void CancellationToken::RemoveDeadline()
+{
+  m_State->HasDeadline = false;
+}
+
+
+double CancellationToken::GetRemainingTime() const
+{
+  if ( !m_State->HasDeadline )
+    {
+    return 0.0;
+    }
+  return ( m_State->Deadline - Now() ) * 1e-9;
+}
+
+
+void CancellationToken::Reset()
+{
+  m_State->HasDeadline = false;
+  m_State->Cancelled = false;
+}
+
+
+bool CancellationToken::operator==( const CancellationToken & other ) const
+{
+  return m_State == other.m_State;
+}
+
+bool CancellationToken::operator!=( const CancellationToken & other ) const
+{
+  return !( *this == other );
+}
+
+
+std::string CancellationToken::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::CancellationToken" << std::endl
+      << "  Cancelled: " << this->IsCancelled() << std::endl
+      << "  HasDeadline: " << this->HasDeadline() << std::endl;
+  if ( this->HasDeadline() )
+    {
+    out << "  RemainingTime: " << this->GetRemainingTime() << std::endl;
+    }
+  return out.str();
+}
+
+}
+}
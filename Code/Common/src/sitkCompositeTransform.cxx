@@ -20,12 +20,205 @@
 #include "sitkPimpleTransform.hxx"
 
 #include "itkCompositeTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
 
 namespace itk
 {
 namespace simple
 {
 
+namespace
+{
+
+// Get the matrix and offset of a linear transform, returns false for
+// the other transforms.
+template <unsigned int NDimension>
+bool GetMatrixOffset( const itk::Transform<double, NDimension, NDimension> *transform,
+                      itk::Matrix<double, NDimension, NDimension> &matrix,
+                      itk::Vector<double, NDimension> &offset )
+{
+  using MatrixOffsetTransformType = itk::MatrixOffsetTransformBase<double, NDimension, NDimension>;
+  using TranslationTransformType = itk::TranslationTransform<double, NDimension>;
+  using IdentityTransformType = itk::IdentityTransform<double, NDimension>;
+
+  if ( const auto *matrixOffset = dynamic_cast<const MatrixOffsetTransformType *>( transform ) )
+    {
+    matrix = matrixOffset->GetMatrix();
+    offset = matrixOffset->GetOffset();
+    return true;
+    }
+  if ( const auto *translation = dynamic_cast<const TranslationTransformType *>( transform ) )
+    {
+    matrix.SetIdentity();
+    offset = translation->GetOffset();
+    return true;
+    }
+  if ( dynamic_cast<const IdentityTransformType *>( transform ) )
+    {
+    matrix.SetIdentity();
+    offset.Fill( 0.0 );
+    return true;
+    }
+  return false;
+}
+
+template <unsigned int NDimension>
+void SetTransformQueue( itk::CompositeTransform<double, NDimension> *composite,
+                        const std::vector<typename itk::Transform<double, NDimension, NDimension>::Pointer> &transforms )
+{
+  composite->ClearTransformQueue();
+  for ( const auto &transform : transforms )
+    {
+    composite->AddTransform( transform );
+    }
+  composite->SetAllTransformsToOptimizeOff();
+  composite->SetOnlyMostRecentTransformToOptimizeOn();
+}
+
+template <unsigned int NDimension>
+void CollapseTransformQueue( itk::CompositeTransform<double, NDimension> *composite )
+{
+  using TransformType = itk::Transform<double, NDimension, NDimension>;
+  using MatrixType = itk::Matrix<double, NDimension, NDimension>;
+  using VectorType = itk::Vector<double, NDimension>;
+
+  composite->FlattenTransformQueue();
+
+  std::vector<typename TransformType::Pointer> collapsed;
+
+  // the composition of the current run of linear transforms
+  std::vector<typename TransformType::Pointer> run;
+  MatrixType runMatrix;
+  VectorType runOffset;
+
+  auto endRun = [&]() {
+      MatrixType identity;
+      identity.SetIdentity();
+      const bool isIdentity = ( runMatrix == identity && runOffset == VectorType( 0.0 ) );
+      if ( run.size() == 1 && !isIdentity )
+        {
+        collapsed.push_back( run.front() );
+        }
+      else if ( run.size() > 1 && !isIdentity )
+        {
+        auto affine = itk::AffineTransform<double, NDimension>::New();
+        affine->SetMatrix( runMatrix );
+        affine->SetOffset( runOffset );
+        collapsed.push_back( affine.GetPointer() );
+        }
+      run.clear();
+    };
+
+  MatrixType matrix;
+  VectorType offset;
+  for ( unsigned int i = 0; i < composite->GetNumberOfTransforms(); ++i )
+    {
+    TransformType *transform = composite->GetNthTransformModifiablePointer( i );
+    if ( !GetMatrixOffset<NDimension>( transform, matrix, offset ) )
+      {
+      if ( !run.empty() )
+        {
+        endRun();
+        }
+      collapsed.push_back( transform );
+      continue;
+      }
+
+    // T_run o T ( x ) = M_run ( M x + o ) + o_run
+    if ( run.empty() )
+      {
+      runMatrix = matrix;
+      runOffset = offset;
+      }
+    else
+      {
+      runOffset = runMatrix * offset + runOffset;
+      runMatrix = runMatrix * matrix;
+      }
+    run.push_back( transform );
+    }
+  if ( !run.empty() )
+    {
+    endRun();
+    }
+
+  SetTransformQueue<NDimension>( composite, collapsed );
+}
+
+template <unsigned int NDimension>
+void CollapseTransformQueueToDisplacementField( itk::CompositeTransform<double, NDimension> *composite,
+                                                const std::vector<uint32_t> &size,
+                                                const std::vector<double> &origin,
+                                                const std::vector<double> &spacing,
+                                                const std::vector<double> &direction )
+{
+  using TransformType = itk::Transform<double, NDimension, NDimension>;
+  using CompositeTransformType = itk::CompositeTransform<double, NDimension>;
+  using DisplacementFieldTransformType = itk::DisplacementFieldTransform<double, NDimension>;
+  using DisplacementFieldType = typename DisplacementFieldTransformType::DisplacementFieldType;
+
+  if ( size.size() != NDimension || origin.size() != NDimension || spacing.size() != NDimension )
+    {
+    sitkExceptionMacro( "Expected the size, origin and spacing of the grid to be of length " << NDimension << "!" );
+    }
+
+  CollapseTransformQueue<NDimension>( composite );
+
+  std::vector<typename TransformType::Pointer> collapsed;
+  auto tail = CompositeTransformType::New();
+  for ( unsigned int i = 0; i < composite->GetNumberOfTransforms(); ++i )
+    {
+    TransformType *transform = composite->GetNthTransformModifiablePointer( i );
+    if ( tail->GetNumberOfTransforms() == 0
+         && transform->GetTransformCategory() == itk::TransformBase::TransformCategoryEnum::Linear )
+      {
+      collapsed.push_back( transform );
+      }
+    else
+      {
+      tail->AddTransform( transform );
+      }
+    }
+  if ( tail->GetNumberOfTransforms() == 0 )
+    {
+    return;
+    }
+
+  typename DisplacementFieldType::RegionType region;
+  region.SetSize( sitkSTLVectorToITK<typename DisplacementFieldType::SizeType>( size ) );
+
+  auto displacementField = DisplacementFieldType::New();
+  displacementField->SetRegions( region );
+  displacementField->SetOrigin( sitkSTLVectorToITK<typename DisplacementFieldType::PointType>( origin ) );
+  displacementField->SetSpacing( sitkSTLVectorToITK<typename DisplacementFieldType::SpacingType>( spacing ) );
+  displacementField->SetDirection( sitkSTLToITKDirection<typename DisplacementFieldType::DirectionType>( direction ) );
+  displacementField->Allocate();
+
+  const CompositeTransformType *tailTransform = tail.GetPointer();
+  DisplacementFieldType *field = displacementField.GetPointer();
+  auto threader = itk::MultiThreaderBase::New();
+  threader->ParallelizeImageRegion<NDimension>(
+    region,
+    [tailTransform, field]( const typename DisplacementFieldType::RegionType &outputRegion ) {
+      typename DisplacementFieldType::PointType point;
+      for ( itk::ImageRegionIteratorWithIndex<DisplacementFieldType> it( field, outputRegion ); !it.IsAtEnd(); ++it )
+        {
+        field->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+        it.Set( tailTransform->TransformPoint( point ) - point );
+        }
+    },
+    nullptr );
+
+  auto displacementTransform = DisplacementFieldTransformType::New();
+  displacementTransform->SetDisplacementField( displacementField );
+  collapsed.push_back( displacementTransform.GetPointer() );
+
+  SetTransformQueue<NDimension>( composite, collapsed );
+}
+
+}
+
+
 CompositeTransform::~CompositeTransform() = default;
 
 CompositeTransform::CompositeTransform(unsigned int dimensions )
@@ -91,6 +284,8 @@ void CompositeTransform::InternalInitialization(itk::TransformBase *transform)
 
   // explicitly remove all function pointer with reference to prior transform
   this->m_pfFlattenTransform = nullptr;
+  this->m_pfCollapseTransform = nullptr;
+  this->m_pfCollapseTransformToDisplacementField = nullptr;
   this->m_pfAddTransform = nullptr;
   this->m_pfGetNumberOfTransforms = nullptr;
   this->m_pfClearTransformQueue = nullptr;
@@ -121,6 +316,23 @@ CompositeTransform &CompositeTransform::FlattenTransform()
   return *this;
 }
 
+CompositeTransform &CompositeTransform::CollapseTransform()
+{
+  this->MakeUnique();
+  this->m_pfCollapseTransform();
+  return *this;
+}
+
+CompositeTransform &CompositeTransform::CollapseTransform( const std::vector<uint32_t> &size,
+                                                           const std::vector<double> &origin,
+                                                           const std::vector<double> &spacing,
+                                                           const std::vector<double> &direction )
+{
+  this->MakeUnique();
+  this->m_pfCollapseTransformToDisplacementField( size, origin, spacing, direction );
+  return *this;
+}
+
 unsigned int CompositeTransform::GetNumberOfTransforms() const
 {
   return this->m_pfGetNumberOfTransforms();
@@ -180,6 +392,13 @@ void CompositeTransform::InternalInitialization(itk::CompositeTransform< double,
 {
   using TransformType = itk::CompositeTransform< double, NDimension >;
   m_pfFlattenTransform = [t]() { return t->FlattenTransformQueue(); };
+  m_pfCollapseTransform = [t]() { CollapseTransformQueue<NDimension>( t ); };
+  m_pfCollapseTransformToDisplacementField = [t]( const std::vector<uint32_t> &size,
+                                                  const std::vector<double> &origin,
+                                                  const std::vector<double> &spacing,
+                                                  const std::vector<double> &direction ) {
+    CollapseTransformQueueToDisplacementField<NDimension>( t, size, origin, spacing, direction );
+  };
   m_pfGetNumberOfTransforms = [t]() {return t->GetNumberOfTransforms();};
   m_pfClearTransformQueue = [t]() {return t->ClearTransformQueue();};
   m_pfRemoveTransform = [t]() {return t->RemoveTransform();};
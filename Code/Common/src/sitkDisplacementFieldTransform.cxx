@@ -40,6 +40,11 @@
 #include "itkVectorImage.h"
 #include "itkImage.h"
 #include "itkVectorNearestNeighborInterpolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <mutex>
 
 namespace itk
 {
@@ -49,6 +54,52 @@ namespace simple
 namespace
 {
 
+// Convert a sitkVectorFloat32 displacement field to the double field
+// of the transform, on all the threads, without an intermediate
+// image.
+template<unsigned int NDimension>
+typename itk::Image<itk::Vector<double,NDimension>,NDimension>::Pointer
+ GetITKImageFromSITKFloatVectorImage(Image &inImage)
+{
+  using FloatVectorImageType = itk::VectorImage<float,NDimension>;
+  using ImageVectorType = typename itk::Image<itk::Vector<double,NDimension>,NDimension>;
+
+  const FloatVectorImageType *image = dynamic_cast < const FloatVectorImageType* > ( inImage.GetITKBase() );
+  if ( image == nullptr )
+    {
+    sitkExceptionMacro( "Unexpected casting error!")
+    }
+  if ( image->GetNumberOfComponentsPerPixel() != NDimension )
+    {
+    sitkExceptionMacro("Expected number of components of the displacement field to be "
+                       << NDimension << " not " << image->GetNumberOfComponentsPerPixel() << "!" );
+    }
+
+  typename ImageVectorType::Pointer out = ImageVectorType::New();
+  out->CopyInformation( image );
+  out->SetRegions( image->GetBufferedRegion() );
+  out->Allocate();
+
+  const float *inBuffer = image->GetBufferPointer();
+  double *outBuffer = out->GetBufferPointer()->GetDataPointer();
+  const size_t numberOfValues = image->GetBufferedRegion().GetNumberOfPixels() * NDimension;
+
+  constexpr size_t BlockSize = 1u << 16;
+  auto threader = itk::MultiThreaderBase::New();
+  threader->ParallelizeArray( 0, ( numberOfValues + BlockSize - 1 ) / BlockSize,
+                              [inBuffer, outBuffer, numberOfValues]( itk::SizeValueType block ) {
+                                const size_t begin = block * BlockSize;
+                                std::copy( inBuffer + begin, inBuffer + std::min( begin + BlockSize, numberOfValues ), outBuffer + begin );
+                              },
+                              nullptr );
+
+  // the field is consumed as for a sitkVectorFloat64 image
+  inImage = Image();
+
+  return out;
+}
+
+
 template<unsigned int NDimension>
 typename itk::Image<itk::Vector<double,NDimension>,NDimension>::Pointer
  GetITKImageFromSITKVectorImage(Image &inImage)
@@ -61,9 +112,15 @@ typename itk::Image<itk::Vector<double,NDimension>,NDimension>::Pointer
                        << NDimension << " not " << inImage.GetDimension() << "!" );
     }
 
+  if (inImage.GetPixelID() == sitkVectorFloat32)
+    {
+    return GetITKImageFromSITKFloatVectorImage<NDimension>(inImage);
+    }
+
   if (inImage.GetPixelID() != sitkVectorFloat64)
     {
-    sitkExceptionMacro("Expected input displacement field image must be of pixel type: " << sitkVectorFloat64);
+    sitkExceptionMacro("Expected input displacement field image must be of pixel type: " << sitkVectorFloat64
+                       << " or " << sitkVectorFloat32);
     }
 
   typename VectorImageType::Pointer image = dynamic_cast < VectorImageType* > ( inImage.GetITKBase() );
@@ -73,7 +130,10 @@ typename itk::Image<itk::Vector<double,NDimension>,NDimension>::Pointer
     sitkExceptionMacro( "Unexpected casting error!")
     }
 
-  // TODO: the input image needs to be made unique before we take the buffer
+  // The buffer is taken without a copy, unless it is shared with
+  // another image which must not lose it.
+  inImage.MakeUnique();
+  image = dynamic_cast < VectorImageType* > ( inImage.GetITKBase() );
 
   using ImageVectorType = typename itk::Image<itk::Vector<double,NDimension>,NDimension>;
   typename ImageVectorType::Pointer out = GetImageFromVectorImage(image.GetPointer(), true );
@@ -132,6 +192,126 @@ void InternalSetInterpolator( TDisplacementFieldTransform *itkDisplacementTx, In
 }
 
 
+template< typename TDisplacementFieldTransform >
+void InternalComposeTransform( TDisplacementFieldTransform *itkDisplacementTx, const itk::TransformBase *itkTransform )
+{
+  constexpr unsigned int Dimension = TDisplacementFieldTransform::Dimension;
+  using DisplacementFieldType = typename TDisplacementFieldTransform::DisplacementFieldType;
+  using TransformType = itk::Transform<double, Dimension, Dimension>;
+
+  const TransformType *transform = dynamic_cast<const TransformType *>( itkTransform );
+  if ( transform == nullptr )
+    {
+    sitkExceptionMacro( "The transform must be of dimension " << Dimension << "!" );
+    }
+
+  DisplacementFieldType *field = itkDisplacementTx->GetModifiableDisplacementField();
+  if ( field == nullptr )
+    {
+    sitkExceptionMacro( "The transform has no displacement field!" );
+    }
+
+  // Each pixel only reads its own displacement, so the field is
+  // updated in place.
+  auto threader = itk::MultiThreaderBase::New();
+  threader->ParallelizeImageRegion<Dimension>(
+    field->GetBufferedRegion(),
+    [transform, field]( const typename DisplacementFieldType::RegionType &region ) {
+      typename DisplacementFieldType::PointType point;
+      for ( itk::ImageRegionIteratorWithIndex<DisplacementFieldType> it( field, region ); !it.IsAtEnd(); ++it )
+        {
+        field->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+        it.Set( transform->TransformPoint( point + it.Get() ) - point );
+        }
+    },
+    nullptr );
+  field->Modified();
+
+  itkDisplacementTx->SetInverseDisplacementField( nullptr );
+}
+
+
+template< typename TDisplacementFieldTransform >
+double InternalComputeInverseDisplacementField( TDisplacementFieldTransform *itkDisplacementTx,
+                                                unsigned int maximumNumberOfIterations,
+                                                double maximumResidualTolerance )
+{
+  constexpr unsigned int Dimension = TDisplacementFieldTransform::Dimension;
+  using DisplacementFieldType = typename TDisplacementFieldTransform::DisplacementFieldType;
+
+  const DisplacementFieldType *field = itkDisplacementTx->GetDisplacementField();
+  if ( field == nullptr )
+    {
+    sitkExceptionMacro( "The transform has no displacement field!" );
+    }
+
+  // the current inverse is the initial estimate when it is on the
+  // grid of the field
+  typename DisplacementFieldType::Pointer inverse = itkDisplacementTx->GetModifiableInverseDisplacementField();
+  if ( inverse.IsNull()
+       || inverse->GetLargestPossibleRegion() != field->GetLargestPossibleRegion()
+       || inverse->GetBufferedRegion() != field->GetBufferedRegion()
+       || inverse->GetOrigin() != field->GetOrigin()
+       || inverse->GetSpacing() != field->GetSpacing()
+       || inverse->GetDirection() != field->GetDirection() )
+    {
+    inverse = DisplacementFieldType::New();
+    inverse->CopyInformation( field );
+    inverse->SetRegions( field->GetBufferedRegion() );
+    inverse->Allocate();
+    inverse->FillBuffer( typename DisplacementFieldType::PixelType( 0.0 ) );
+    }
+
+  const TDisplacementFieldTransform *transform = itkDisplacementTx;
+  DisplacementFieldType *inverseField = inverse.GetPointer();
+
+  auto threader = itk::MultiThreaderBase::New();
+  double maximumResidual = 0.0;
+  for ( unsigned int iteration = 0; ; ++iteration )
+    {
+    // the last pass only measures the residual of the estimate
+    const bool update = ( iteration < maximumNumberOfIterations );
+
+    std::mutex residualMutex;
+    maximumResidual = 0.0;
+    threader->ParallelizeImageRegion<Dimension>(
+      inverseField->GetBufferedRegion(),
+      [transform, inverseField, update, &residualMutex, &maximumResidual]( const typename DisplacementFieldType::RegionType &region ) {
+        typename DisplacementFieldType::PointType point;
+        double regionResidual = 0.0;
+        for ( itk::ImageRegionIteratorWithIndex<DisplacementFieldType> it( inverseField, region ); !it.IsAtEnd(); ++it )
+          {
+          inverseField->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+          const typename DisplacementFieldType::PixelType estimate = it.Get();
+          const typename DisplacementFieldType::PointType mapped = point + estimate;
+
+          // v(y) = -u( y + v(y) ), the transform has no displacement
+          // outside of its field
+          const typename DisplacementFieldType::PixelType next = mapped - transform->TransformPoint( mapped );
+
+          regionResidual = std::max( regionResidual, ( next - estimate ).GetNorm() );
+          if ( update )
+            {
+            it.Set( next );
+            }
+          }
+        std::lock_guard<std::mutex> lock( residualMutex );
+        maximumResidual = std::max( maximumResidual, regionResidual );
+      },
+      nullptr );
+
+    if ( !update || maximumResidual < maximumResidualTolerance )
+      {
+      break;
+      }
+    }
+
+  inverse->Modified();
+  itkDisplacementTx->SetInverseDisplacementField( inverse );
+  return maximumResidual;
+}
+
+
 }
 
 DisplacementFieldTransform::~DisplacementFieldTransform() = default;
@@ -236,6 +416,21 @@ DisplacementFieldTransform::SetSmoothingBSplineOnUpdate( const std::vector<unsig
 }
 
 
+DisplacementFieldTransform::Self &DisplacementFieldTransform::ComposeTransform( const Transform &transform )
+{
+  this->MakeUnique();
+  this->m_pfComposeTransform( transform.GetITKBase() );
+  return *this;
+}
+
+double DisplacementFieldTransform::ComputeInverseDisplacementField( unsigned int maximumNumberOfIterations,
+                                                                    double maximumResidualTolerance )
+{
+  this->MakeUnique();
+  return this->m_pfComputeInverseDisplacementField( maximumNumberOfIterations, maximumResidualTolerance );
+}
+
+
 void DisplacementFieldTransform::SetPimpleTransform( PimpleTransformBase *pimpleTransform )
 {
   Superclass::SetPimpleTransform(pimpleTransform);
@@ -267,6 +462,8 @@ void DisplacementFieldTransform::InternalInitialization(itk::TransformBase *tran
   m_pfSetSmoothingOff = nullptr;
   m_pfSetSmoothingGaussianOnUpdate = nullptr;
   m_pfSetSmoothingBSplineOnUpdate = nullptr;
+  m_pfComposeTransform = nullptr;
+  m_pfComputeInverseDisplacementField = nullptr;
 
   callInternalInitialization(visitor);
 
@@ -301,6 +498,12 @@ void DisplacementFieldTransform::InternalInitialization(TransformType *t)
                                                 std::placeholders::_2,
                                                 std::placeholders::_3,
                                                 std::placeholders::_4 );
+
+  this->m_pfComposeTransform = std::bind(&InternalComposeTransform<TransformType>, t, std::placeholders::_1);
+  this->m_pfComputeInverseDisplacementField = std::bind(&InternalComputeInverseDisplacementField<TransformType>,
+                                                        t,
+                                                        std::placeholders::_1,
+                                                        std::placeholders::_2 );
 }
 
 PimpleTransformBase *DisplacementFieldTransform::CreateDisplacementFieldPimpleTransform(unsigned int dimension)
@@ -0,0 +1,480 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkExecutionLog.h"
+#include "sitkExceptionObject.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+
+// Bytes of a formatted entry, with every character of the text fields
+// escaped.
+constexpr size_t FormattedEntrySize = 2 * ( 2 * ExecutionLogEntry::NameSize + ExecutionLogEntry::ParametersSize )
+  + 64 * ( 2 * SITK_MAX_DIMENSION + 16 );
+
+// A writer retries a slot being read or written before the entry is
+// dropped.
+constexpr unsigned int MaximumSlotRetries = 64;
+
+
+struct Slot
+{
+  std::atomic<bool> busy{ false };
+  ExecutionLogEntry entry;
+};
+
+struct Ring
+{
+  explicit Ring( unsigned int c )
+    : slots( new Slot[c] ),
+      capacity( c )
+    {}
+
+  std::unique_ptr<Slot[]> slots;
+  const unsigned int capacity;
+};
+
+std::atomic<Ring *> g_Ring{ nullptr };
+std::atomic<uint64_t> g_Sequence{ 0 };
+
+// The rings replaced by a change of the capacity are retained, since
+// a writer may still refer to them.
+std::mutex g_RingsMutex;
+std::vector<std::unique_ptr<Ring>> g_Rings;
+
+
+bool TryAcquire( Slot &slot )
+{
+  bool expected = false;
+  return slot.busy.compare_exchange_strong( expected, true, std::memory_order_acquire );
+}
+
+void Release( Slot &slot )
+{
+  slot.busy.store( false, std::memory_order_release );
+}
+
+
+// Allocation free formatting, also used by the signal handlers.
+class Formatter
+{
+public:
+  Formatter( char *buffer, size_t size )
+    : m_Buffer( buffer ),
+      m_Size( size )
+    {}
+
+  size_t GetLength() const
+    {
+      return m_Length;
+    }
+
+  Formatter &operator<<( char c )
+    {
+      if ( m_Length < m_Size )
+        {
+        m_Buffer[m_Length++] = c;
+        }
+      return *this;
+    }
+
+  Formatter &operator<<( const char *s )
+    {
+      while ( *s )
+        {
+        *this << *s++;
+        }
+      return *this;
+    }
+
+  Formatter &operator<<( uint64_t value )
+    {
+      char digits[24];
+      unsigned int n = 0;
+      do
+        {
+        digits[n++] = static_cast<char>( '0' + value % 10 );
+        value /= 10;
+        }
+      while ( value );
+      while ( n )
+        {
+        *this << digits[--n];
+        }
+      return *this;
+    }
+
+  Formatter &operator<<( int64_t value )
+    {
+      if ( value < 0 )
+        {
+        *this << '-';
+        return *this << static_cast<uint64_t>( -( value + 1 ) ) + 1u;
+        }
+      return *this << static_cast<uint64_t>( value );
+    }
+
+  Formatter &Escaped( const char *s, size_t size )
+    {
+      *this << '"';
+      for ( size_t i = 0; i < size && s[i]; ++i )
+        {
+        const char c = s[i];
+        if ( c == '"' || c == '\\' )
+          {
+          *this << '\\' << c;
+          }
+        else if ( c == '\n' )
+          {
+          *this << "\\n";
+          }
+        else if ( static_cast<unsigned char>( c ) < 0x20 )
+          {
+          *this << ' ';
+          }
+        else
+          {
+          *this << c;
+          }
+        }
+      return *this << '"';
+    }
+
+  Formatter &Size( const uint32_t *size, uint32_t dimension )
+    {
+      *this << '[';
+      for ( uint32_t d = 0; d < dimension; ++d )
+        {
+        *this << ( d ? "," : "" ) << static_cast<uint64_t>( size[d] );
+        }
+      return *this << ']';
+    }
+
+private:
+  char *m_Buffer;
+  size_t m_Size;
+  size_t m_Length{ 0 };
+};
+
+
+size_t FormatEntry( const ExecutionLogEntry &e, char *buffer, size_t size )
+{
+  Formatter f( buffer, size );
+  f << "{\"sequence\":" << e.sequence;
+  f << ",\"name\":";
+  f.Escaped( e.name, sizeof( e.name ) );
+  f << ",\"itk_name\":";
+  f.Escaped( e.itkName, sizeof( e.itkName ) );
+  f << ",\"end_time_us\":" << e.endTime
+    << ",\"wall_time_us\":" << e.wallTime
+    << ",\"cpu_time_us\":" << e.cpuTime
+    << ",\"thread\":" << e.threadId
+    << ",\"threads\":" << static_cast<uint64_t>( e.numberOfThreads )
+    << ",\"bytes_allocated\":" << e.bytesAllocated;
+  f << ",\"input_size\":";
+  f.Size( e.inputSize, e.inputDimension );
+  f << ",\"output_size\":";
+  f.Size( e.outputSize, e.outputDimension );
+  f << ",\"parameters\":";
+  f.Escaped( e.parameters, sizeof( e.parameters ) );
+  f << "}\n";
+  return f.GetLength();
+}
+
+
+// Visit the formatted entries of the ring, from the oldest. Slots
+// being written are skipped.
+template <typename TFunction>
+void VisitEntries( Ring *ring, char *buffer, size_t size, TFunction f )
+{
+  if ( !ring )
+    {
+    return;
+    }
+  const uint64_t last = g_Sequence.load();
+  const uint64_t first = last > ring->capacity ? last - ring->capacity + 1 : 1;
+  for ( uint64_t s = first; s <= last && s != 0; ++s )
+    {
+    Slot &slot = ring->slots[s % ring->capacity];
+    if ( !TryAcquire( slot ) )
+      {
+      continue;
+      }
+    size_t length = 0;
+    if ( slot.entry.sequence == s )
+      {
+      length = FormatEntry( slot.entry, buffer, size );
+      }
+    Release( slot );
+    if ( length )
+      {
+      f( buffer, length );
+      }
+    }
+}
+
+
+//
+// Crash handlers
+//
+
+constexpr size_t CrashFileNameSize = 4096;
+
+std::mutex g_CrashMutex;
+char g_CrashFileName[CrashFileNameSize] = { 0 };
+std::atomic_flag g_CrashWritten = ATOMIC_FLAG_INIT;
+char g_CrashBuffer[FormattedEntrySize];
+
+const int FatalSignals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL
+#if defined(SIGBUS)
+                             , SIGBUS
+#endif
+};
+constexpr size_t NumberOfFatalSignals = sizeof( FatalSignals ) / sizeof( FatalSignals[0] );
+
+using SignalHandlerType = void ( * )( int );
+SignalHandlerType g_PreviousSignalHandlers[NumberOfFatalSignals];
+std::terminate_handler g_PreviousTerminateHandler = nullptr;
+bool g_CrashHandlersInstalled = false;
+
+
+void WriteCrashLog()
+{
+  if ( g_CrashWritten.test_and_set() || !g_CrashFileName[0] )
+    {
+    return;
+    }
+
+#if defined(_WIN32)
+  const int fd = _open( g_CrashFileName, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE );
+#else
+  const int fd = open( g_CrashFileName, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+#endif
+  if ( fd < 0 )
+    {
+    return;
+    }
+
+  VisitEntries( g_Ring.load(), g_CrashBuffer, sizeof( g_CrashBuffer ), [fd]( const char *text, size_t length ) {
+#if defined(_WIN32)
+    (void)_write( fd, text, static_cast<unsigned int>( length ) );
+#else
+    (void)!write( fd, text, length );
+#endif
+  } );
+
+#if defined(_WIN32)
+  _close( fd );
+#else
+  close( fd );
+#endif
+}
+
+
+void OnFatalSignal( int signal )
+{
+  WriteCrashLog();
+
+  // continue with the previous handler, which is the default
+  // termination unless one was installed
+  for ( size_t i = 0; i < NumberOfFatalSignals; ++i )
+    {
+    if ( FatalSignals[i] == signal )
+      {
+      std::signal( signal, g_PreviousSignalHandlers[i] == SIG_ERR ? SIG_DFL : g_PreviousSignalHandlers[i] );
+      }
+    }
+  std::raise( signal );
+}
+
+
+void OnTerminate()
+{
+  WriteCrashLog();
+  if ( g_PreviousTerminateHandler )
+    {
+    g_PreviousTerminateHandler();
+    }
+  std::abort();
+}
+
+} // end anonymous namespace
+
+
+void SetExecutionLogCapacity( unsigned int capacity )
+{
+  std::lock_guard<std::mutex> lock( g_RingsMutex );
+
+  Ring *current = g_Ring.load();
+  if ( ( current ? current->capacity : 0u ) == capacity )
+    {
+    return;
+    }
+
+  Ring *ring = nullptr;
+  if ( capacity )
+    {
+    g_Rings.emplace_back( new Ring( capacity ) );
+    ring = g_Rings.back().get();
+    }
+  g_Ring.store( ring );
+}
+
+
+unsigned int GetExecutionLogCapacity()
+{
+  Ring *ring = g_Ring.load();
+  return ring ? ring->capacity : 0u;
+}
+
+
+bool IsExecutionLogEnabled()
+{
+  return g_Ring.load( std::memory_order_relaxed ) != nullptr;
+}
+
+
+void RecordExecution( const ExecutionLogEntry &entry )
+{
+  Ring *ring = g_Ring.load();
+  if ( !ring )
+    {
+    return;
+    }
+
+  const uint64_t sequence = ++g_Sequence;
+  Slot &slot = ring->slots[sequence % ring->capacity];
+  for ( unsigned int retry = 0; !TryAcquire( slot ); ++retry )
+    {
+    if ( retry == MaximumSlotRetries )
+      {
+      return;
+      }
+    std::this_thread::yield();
+    }
+
+  // a slower writer of an older entry does not replace a newer entry
+  if ( slot.entry.sequence < sequence )
+    {
+    slot.entry = entry;
+    slot.entry.sequence = sequence;
+    }
+  Release( slot );
+}
+
+
+std::string GetExecutionLog()
+{
+  std::string log;
+  std::vector<char> buffer( FormattedEntrySize );
+  VisitEntries( g_Ring.load(), buffer.data(), buffer.size(), [&log]( const char *text, size_t length ) {
+    log.append( text, length );
+  } );
+  return log;
+}
+
+
+void ClearExecutionLog()
+{
+  Ring *ring = g_Ring.load();
+  if ( !ring )
+    {
+    return;
+    }
+  for ( unsigned int i = 0; i < ring->capacity; ++i )
+    {
+    Slot &slot = ring->slots[i];
+    while ( !TryAcquire( slot ) )
+      {
+      std::this_thread::yield();
+      }
+    slot.entry.sequence = 0;
+    Release( slot );
+    }
+}
+
+
+void SetExecutionLogCrashFileName( const std::string &fileName )
+{
+  if ( fileName.size() >= CrashFileNameSize )
+    {
+    sitkExceptionMacro( "The execution log crash file name is longer than " << CrashFileNameSize - 1 << " characters!" );
+    }
+
+  std::lock_guard<std::mutex> lock( g_CrashMutex );
+  std::memset( g_CrashFileName, 0, CrashFileNameSize );
+  std::copy( fileName.begin(), fileName.end(), g_CrashFileName );
+
+  if ( !fileName.empty() && !g_CrashHandlersInstalled )
+    {
+    for ( size_t i = 0; i < NumberOfFatalSignals; ++i )
+      {
+      g_PreviousSignalHandlers[i] = std::signal( FatalSignals[i], OnFatalSignal );
+      }
+    g_PreviousTerminateHandler = std::set_terminate( OnTerminate );
+    g_CrashHandlersInstalled = true;
+    }
+  else if ( fileName.empty() && g_CrashHandlersInstalled )
+    {
+    for ( size_t i = 0; i < NumberOfFatalSignals; ++i )
+      {
+      if ( g_PreviousSignalHandlers[i] != SIG_ERR )
+        {
+        std::signal( FatalSignals[i], g_PreviousSignalHandlers[i] );
+        }
+      }
+    std::set_terminate( g_PreviousTerminateHandler );
+    g_CrashHandlersInstalled = false;
+    }
+}
+
+
+std::string GetExecutionLogCrashFileName()
+{
+  std::lock_guard<std::mutex> lock( g_CrashMutex );
+  return std::string( g_CrashFileName );
+}
+
+}
+}
+}
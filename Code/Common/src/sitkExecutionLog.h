@@ -0,0 +1,97 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkExecutionLog_h
+#define sitkExecutionLog_h
+
+#include "sitkCommon.h"
+
+#include <cstdint>
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \brief An entry of the execution log, with the fixed size fields
+ * needed to be recorded and formatted without allocation.
+ *
+ * The text fields are truncated to their size.
+ */
+struct ExecutionLogEntry
+{
+  static constexpr unsigned int NameSize = 96;
+  static constexpr unsigned int ParametersSize = 1536;
+
+  uint64_t sequence{ 0 };
+  // microseconds since the epoch of the system clock, at the end
+  int64_t endTime{ 0 };
+  int64_t wallTime{ 0 };
+  int64_t cpuTime{ 0 };
+  uint64_t threadId{ 0 };
+  uint32_t numberOfThreads{ 0 };
+  uint64_t bytesAllocated{ 0 };
+  uint32_t inputDimension{ 0 };
+  uint32_t inputSize[SITK_MAX_DIMENSION]{};
+  uint32_t outputDimension{ 0 };
+  uint32_t outputSize[SITK_MAX_DIMENSION]{};
+  char name[NameSize]{};
+  char itkName[NameSize]{};
+  char parameters[ParametersSize]{};
+};
+
+
+/** \brief A process wide, fixed capacity ring buffer of the most
+ * recent executions.
+ *
+ * An entry is written into its slot after an atomic increment of the
+ * sequence, without a lock shared by the writers. A slot is skipped
+ * by the readers while it is written. A capacity of zero disables the
+ * recording.
+ */
+SITKCommon_HIDDEN void SetExecutionLogCapacity( unsigned int capacity );
+SITKCommon_HIDDEN unsigned int GetExecutionLogCapacity();
+
+/** Returns true when entries are recorded, to avoid gathering the
+ * fields of an entry otherwise. */
+SITKCommon_HIDDEN bool IsExecutionLogEnabled();
+
+/** Record the entry, its sequence is assigned. */
+SITKCommon_HIDDEN void RecordExecution( const ExecutionLogEntry &entry );
+
+/** The recorded entries as JSON lines, from the oldest. */
+SITKCommon_HIDDEN std::string GetExecutionLog();
+
+SITKCommon_HIDDEN void ClearExecutionLog();
+
+/** Write the log to the file when the process is terminated by a
+ * fatal signal or std::terminate. An empty file name removes the
+ * handlers.
+ * @{
+ */
+SITKCommon_HIDDEN void SetExecutionLogCrashFileName( const std::string &fileName );
+SITKCommon_HIDDEN std::string GetExecutionLogCrashFileName();
+/**@}*/
+
+}
+}
+}
+
+#endif // sitkExecutionLog_h
@@ -0,0 +1,152 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkExecutor.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+
+namespace itk
+{
+namespace simple
+{
+
+struct Executor::ExecutorState
+{
+  mutable std::mutex Mutex;
+  unsigned int MaximumNumberOfThreads{ 1 };
+  unsigned int MaximumNumberOfThreadsPerExecution{ 0 };
+  unsigned int NumberOfActiveThreads{ 0 };
+  unsigned int NumberOfActiveExecutions{ 0 };
+};
+
+
+Executor::Executor( unsigned int maximumNumberOfThreads )
+  : m_State( std::make_shared<ExecutorState>() )
+{
+  this->SetMaximumNumberOfThreads( maximumNumberOfThreads );
+}
+
+Executor::~Executor() = default;
+
+Executor::Executor( const Executor & ) = default;
+
+Executor &Executor::operator=( const Executor & ) = default;
+
+
+void Executor::SetMaximumNumberOfThreads( unsigned int n )
+{
+  if ( n == 0 )
+    {
+    n = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+    }
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  m_State->MaximumNumberOfThreads = std::max( n, 1u );
+}
+
+unsigned int Executor::GetMaximumNumberOfThreads() const
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  return m_State->MaximumNumberOfThreads;
+}
+
+
+void Executor::SetMaximumNumberOfThreadsPerExecution( unsigned int n )
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  m_State->MaximumNumberOfThreadsPerExecution = n;
+}
+
+unsigned int Executor::GetMaximumNumberOfThreadsPerExecution() const
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  return m_State->MaximumNumberOfThreadsPerExecution;
+}
+
+
+unsigned int Executor::GetNumberOfActiveThreads() const
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  return m_State->NumberOfActiveThreads;
+}
+
+unsigned int Executor::GetNumberOfActiveExecutions() const
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  return m_State->NumberOfActiveExecutions;
+}
+
+
+unsigned int Executor::AcquireThreads( unsigned int requested )
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+
+  unsigned int granted = std::max( requested, 1u );
+  if ( m_State->MaximumNumberOfThreadsPerExecution != 0 )
+    {
+    granted = std::min( granted, m_State->MaximumNumberOfThreadsPerExecution );
+    }
+
+  // the threads in use may exceed the budget, when it has been reduced
+  const unsigned int available = m_State->MaximumNumberOfThreads
+    - std::min( m_State->NumberOfActiveThreads, m_State->MaximumNumberOfThreads );
+  granted = std::max( std::min( granted, available ), 1u );
+
+  m_State->NumberOfActiveThreads += granted;
+  ++m_State->NumberOfActiveExecutions;
+  return granted;
+}
+
+void Executor::ReleaseThreads( unsigned int granted )
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  m_State->NumberOfActiveThreads -= std::min( granted, m_State->NumberOfActiveThreads );
+  if ( m_State->NumberOfActiveExecutions > 0 )
+    {
+    --m_State->NumberOfActiveExecutions;
+    }
+}
+
+
+bool Executor::operator==( const Executor & other ) const
+{
+  return m_State == other.m_State;
+}
+
+bool Executor::operator!=( const Executor & other ) const
+{
+  return !( *this == other );
+}
+
+
+std::string Executor::ToString() const
+{
+  std::lock_guard<std::mutex> lock( m_State->Mutex );
+  std::ostringstream out;
+  out << "itk::simple::Executor" << std::endl
+      << "  MaximumNumberOfThreads: " << m_State->MaximumNumberOfThreads << std::endl
+      << "  MaximumNumberOfThreadsPerExecution: " << m_State->MaximumNumberOfThreadsPerExecution << std::endl
+      << "  NumberOfActiveThreads: " << m_State->NumberOfActiveThreads << std::endl
+      << "  NumberOfActiveExecutions: " << m_State->NumberOfActiveExecutions << std::endl;
+  return out.str();
+}
+
+}
+}
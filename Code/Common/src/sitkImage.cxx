@@ -22,6 +22,7 @@
 
 #include "sitkExceptionObject.h"
 #include "sitkPimpleImageBase.h"
+#include "sitkMemoryStatisticsInternal.h"
 #include "sitkPixelIDTypeLists.h"
 #include "sitkConditional.h"
 
@@ -236,7 +237,7 @@ namespace itk
     void Image::SetOrigin( const std::vector<double> &orgn )
     {
        assert( m_PimpleImage );
-      this->MakeUnique();
+      this->MakeUniqueForInformationWrite();
       this->m_PimpleImage->SetOrigin(orgn);
     }
 
@@ -251,7 +252,7 @@ namespace itk
     void Image::SetSpacing( const std::vector<double> &spc )
     {
       assert( m_PimpleImage );
-      this->MakeUnique();
+      this->MakeUniqueForInformationWrite();
       this->m_PimpleImage->SetSpacing(spc);
     }
 
@@ -266,7 +267,7 @@ namespace itk
     void Image::SetDirection( const std::vector< double > &direction )
     {
       assert( m_PimpleImage );
-      this->MakeUnique();
+      this->MakeUniqueForInformationWrite();
       this->m_PimpleImage->SetDirection( direction );
     }
 
@@ -286,9 +287,21 @@ namespace itk
                             << " does not match this image's size of " << this->GetSize() << "!" );
         }
 
-      this->SetOrigin( srcImage.GetOrigin() );
-      this->SetSpacing( srcImage.GetSpacing() );
-      this->SetDirection( srcImage.GetDirection() );
+      this->MakeUniqueForInformationWrite();
+      this->m_PimpleImage->SetOrigin( srcImage.GetOrigin() );
+      this->m_PimpleImage->SetSpacing( srcImage.GetSpacing() );
+      this->m_PimpleImage->SetDirection( srcImage.GetDirection() );
+    }
+
+    void Image::CopyMetaData( const Image & srcImage )
+    {
+      assert( m_PimpleImage && srcImage.m_PimpleImage );
+
+      // the copy shares the entries of the source dictionary, which
+      // are copied on write
+      const itk::MetaDataDictionary mdd = srcImage.m_PimpleImage->GetDataBase()->GetMetaDataDictionary();
+      this->MakeUniqueForInformationWrite();
+      this->m_PimpleImage->GetDataBase()->SetMetaDataDictionary( mdd );
     }
 
     std::vector<std::string> Image::GetMetaDataKeys( ) const
@@ -323,7 +336,7 @@ namespace itk
     void Image::SetMetaData( const std::string &key, const std::string &value)
     {
       assert( m_PimpleImage );
-      this->MakeUnique();
+      this->MakeUniqueForInformationWrite();
       itk::MetaDataDictionary &mdd = this->m_PimpleImage->GetDataBase()->GetMetaDataDictionary();
       itk::EncapsulateMetaData<std::string>(mdd, key, value);
     }
@@ -331,8 +344,8 @@ namespace itk
     bool Image::EraseMetaData( const std::string &key )
     {
       assert( m_PimpleImage );
+      this->MakeUniqueForInformationWrite();
       itk::MetaDataDictionary &mdd = this->m_PimpleImage->GetDataBase()->GetMetaDataDictionary();
-      this->MakeUnique();
       return mdd.Erase(key);
     }
 
@@ -363,11 +376,48 @@ namespace itk
       return this->m_PimpleImage->TransformContinuousIndexToPhysicalPoint( idx );
     }
 
+    std::vector< double > Image::TransformIndicesToPhysicalPoints( const std::vector< int64_t > &indices ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->TransformIndicesToPhysicalPoints( indices );
+    }
+
+    std::vector< int64_t > Image::TransformPhysicalPointsToIndices( const std::vector< double > &points ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->TransformPhysicalPointsToIndices( points );
+    }
+
+    std::vector< double > Image::TransformPhysicalPointsToContinuousIndices( const std::vector< double > &points ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->TransformPhysicalPointsToContinuousIndices( points );
+    }
+
+    std::vector< double > Image::TransformContinuousIndicesToPhysicalPoints( const std::vector< double > &indices ) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->TransformContinuousIndicesToPhysicalPoints( indices );
+    }
+
     std::vector<double> Image::EvaluateAtContinuousIndex( const std::vector<double> &index, InterpolatorEnum interp) const
     {
       assert( m_PimpleImage );
       return this->m_PimpleImage->EvaluateAtContinuousIndex(index, interp);
     }
+    std::vector<double> Image::EvaluateAtContinuousIndices( const std::vector<double> &indices, InterpolatorEnum interp) const
+    {
+      assert( m_PimpleImage );
+      return this->m_PimpleImage->EvaluateAtContinuousIndices(indices, interp);
+    }
+
+    std::vector<double> Image::EvaluateAtPhysicalPoints( const std::vector<double> &points, InterpolatorEnum interp) const
+    {
+      assert( m_PimpleImage );
+      const std::vector<double> indices = this->TransformPhysicalPointsToContinuousIndices(points);
+      return this->EvaluateAtContinuousIndices(indices, interp);
+    }
+
     std::vector<double> Image::EvaluateAtPhysicalPoint( const std::vector<double> &point, InterpolatorEnum interp) const
     {
       assert( m_PimpleImage );
@@ -650,6 +700,136 @@ namespace itk
       return this->m_PimpleImage->GetBufferAsVoid( );
     }
 
+    void Image::GetRegionAsInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int8_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsInt8( index, size, buffer );
+    }
+
+    void Image::GetRegionAsUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint8_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsUInt8( index, size, buffer );
+    }
+
+    void Image::GetRegionAsInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int16_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsInt16( index, size, buffer );
+    }
+
+    void Image::GetRegionAsUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint16_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsUInt16( index, size, buffer );
+    }
+
+    void Image::GetRegionAsInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int32_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsInt32( index, size, buffer );
+    }
+
+    void Image::GetRegionAsUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint32_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsUInt32( index, size, buffer );
+    }
+
+    void Image::GetRegionAsInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, int64_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsInt64( index, size, buffer );
+    }
+
+    void Image::GetRegionAsUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, uint64_t *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsUInt64( index, size, buffer );
+    }
+
+    void Image::GetRegionAsFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, float *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsFloat( index, size, buffer );
+    }
+
+    void Image::GetRegionAsDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, double *buffer ) const
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->GetRegionAsDouble( index, size, buffer );
+    }
+
+    void Image::SetRegionFromInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int8_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromInt8( index, size, buffer );
+    }
+
+    void Image::SetRegionFromUInt8( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint8_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromUInt8( index, size, buffer );
+    }
+
+    void Image::SetRegionFromInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int16_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromInt16( index, size, buffer );
+    }
+
+    void Image::SetRegionFromUInt16( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint16_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromUInt16( index, size, buffer );
+    }
+
+    void Image::SetRegionFromInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int32_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromInt32( index, size, buffer );
+    }
+
+    void Image::SetRegionFromUInt32( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint32_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromUInt32( index, size, buffer );
+    }
+
+    void Image::SetRegionFromInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const int64_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromInt64( index, size, buffer );
+    }
+
+    void Image::SetRegionFromUInt64( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const uint64_t *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromUInt64( index, size, buffer );
+    }
+
+    void Image::SetRegionFromFloat( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const float *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromFloat( index, size, buffer );
+    }
+
+    void Image::SetRegionFromDouble( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size, const double *buffer )
+    {
+      assert( m_PimpleImage );
+      this->MakeUniqueForRegionWrite( index, size );
+      this->m_PimpleImage->SetRegionFromDouble( index, size, buffer );
+    }
+
     void Image::SetPixelAsInt8( const std::vector<uint32_t> &idx, int8_t v )
     {
       assert( m_PimpleImage );
@@ -805,19 +985,82 @@ namespace itk
     }
 
 
+    Image Image::GetSubImage( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const
+    {
+      assert( m_PimpleImage );
+      Image subImage;
+      subImage.m_PimpleImage.reset( this->m_PimpleImage->GetSubImage( index, size ) );
+      return subImage;
+    }
+
+    Image Image::GetReshapedView( const std::vector<uint32_t> &size,
+                                  const std::vector<double> &origin,
+                                  const std::vector<double> &spacing,
+                                  const std::vector<double> &direction ) const
+    {
+      assert( m_PimpleImage );
+      Image view;
+      view.m_PimpleImage.reset( this->m_PimpleImage->GetReshapedView( size, origin, spacing, direction ) );
+      return view;
+    }
+
     void Image::MakeUnique( )
     {
       assert( m_PimpleImage );
+      // the image is about to be modified, and the cached
+      // interpolator refers to it
+      this->m_PimpleImage->ReleaseCachedInterpolator();
       if ( this->m_PimpleImage->GetReferenceCountOfImage() > 1 )
         {
         this->m_PimpleImage.reset( this->m_PimpleImage->DeepCopy() );
+        detail::RecordImageDeepCopy();
         }
+    }
 
+    void Image::MakeUniqueForRegionWrite( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size )
+    {
+      assert( m_PimpleImage );
+      this->m_PimpleImage->ReleaseCachedInterpolator();
+      if ( this->m_PimpleImage->GetReferenceCountOfImage() <= 1 )
+        {
+        return;
+        }
+
+      const unsigned int dimension = this->m_PimpleImage->GetDimension();
+      bool wholeImage = index.size() >= dimension && size.size() >= dimension;
+      for ( unsigned int d = 0; wholeImage && d < dimension; ++d )
+        {
+        wholeImage = index[d] == 0 && size[d] == this->m_PimpleImage->GetSize(d);
+        }
+
+      if ( wholeImage )
+        {
+        this->m_PimpleImage.reset( this->m_PimpleImage->AllocateCopy() );
+        detail::RecordImageDeepCopy();
+        }
+      else
+        {
+        this->m_PimpleImage.reset( this->m_PimpleImage->DeepCopy() );
+        detail::RecordImageDeepCopy();
+        }
+    }
+
+    void Image::MakeUniqueForInformationWrite( )
+    {
+      assert( m_PimpleImage );
+      // the interpolator refers to the geometry of the image
+      this->m_PimpleImage->ReleaseCachedInterpolator();
+      if ( this->m_PimpleImage->GetReferenceCountOfImage() > 1 )
+        {
+        this->m_PimpleImage.reset( this->m_PimpleImage->HeaderCopy() );
+        }
     }
 
     bool Image::IsUnique( ) const
     {
       assert( m_PimpleImage );
+      // the reference of the cached interpolator is not a user of the image
+      this->m_PimpleImage->ReleaseCachedInterpolator();
       return this->m_PimpleImage->GetReferenceCountOfImage() == 1;
     }
   } // end namespace simple
@@ -28,6 +28,8 @@
 #include "sitkExceptionObject.h"
 #include "sitkPimpleImageBase.hxx"
 #include "sitkPixelIDTypeLists.h"
+#include "sitkImageBufferAllocator.h"
+#include "sitkNUMA.h"
 
 
 namespace itk
@@ -61,10 +63,18 @@ namespace itk
 
     typename TImageType::RegionType region{index, size};
 
+    using ContainerType = detail::ImageBufferContainer<typename TImageType::PixelContainer::Element>;
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->AllocateBuffer( region.GetNumberOfPixels() );
+
     typename TImageType::Pointer image = TImageType::New();
     image->SetRegions ( region );
+    image->SetPixelContainer( container );
     image->Allocate();
-    image->FillBuffer ( itk::NumericTraits<typename TImageType::PixelType>::ZeroValue() );
+    if ( !detail::ZeroImageBuffer( image->GetBufferPointer(), region.GetNumberOfPixels() * sizeof(typename TImageType::PixelType) ) )
+      {
+      image->FillBuffer ( itk::NumericTraits<typename TImageType::PixelType>::ZeroValue() );
+      }
     m_PimpleImage.reset(  new PimpleImage<TImageType>( image ) );
   }
 
@@ -88,11 +98,20 @@ namespace itk
     zero.SetSize( numberOfComponents );
     zero.Fill ( itk::NumericTraits<typename TImageType::PixelType::ValueType>::Zero );
 
+    using ContainerType = detail::ImageBufferContainer<typename TImageType::PixelContainer::Element>;
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->AllocateBuffer( region.GetNumberOfPixels() * numberOfComponents );
+
     typename TImageType::Pointer image = TImageType::New();
     image->SetRegions ( region );
     image->SetVectorLength( numberOfComponents );
+    image->SetPixelContainer( container );
     image->Allocate();
-    image->FillBuffer ( zero );
+    if ( !detail::ZeroImageBuffer( image->GetBufferPointer(),
+                                   region.GetNumberOfPixels() * numberOfComponents * sizeof(typename TImageType::InternalPixelType) ) )
+      {
+      image->FillBuffer ( zero );
+      }
 
     m_PimpleImage.reset( new PimpleImage<TImageType>( image ) );
   }
@@ -0,0 +1,293 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkImageBufferAllocator.h"
+#include "sitkNUMA.h"
+
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+
+enum class AllocatorEnum : int
+{
+  Default,
+  Aligned,
+  Pool,
+  HugePages
+};
+
+constexpr size_t CacheLineAlignment = 64;
+constexpr size_t HugePageSize = size_t(2) << 20;
+
+// Maximum number of bytes held by the pool of released buffers.
+constexpr size_t PoolCapacity = size_t(512) << 20;
+
+
+// Stored immediately before each aligned buffer.
+struct BufferHeader
+{
+  void   *raw;
+  size_t  bytes;
+  size_t  alignment;
+  bool    pooled;
+};
+
+
+std::atomic<int> g_Allocator{ static_cast<int>(AllocatorEnum::Default) };
+std::atomic<uint64_t> g_BytesAllocated{ 0 };
+std::atomic<uint64_t> g_BytesReused{ 0 };
+
+std::mutex g_PoolMutex;
+std::map<size_t, std::vector<void *> > g_Pool;
+size_t g_PoolBytes = 0;
+
+
+BufferHeader *GetHeader( void *buffer )
+{
+  return reinterpret_cast<BufferHeader *>( static_cast<char *>(buffer) - sizeof(BufferHeader) );
+}
+
+
+// Round up to quarter steps between powers of two, so that buffers
+// of similar size can be shared in the pool.
+size_t PoolSizeClass( size_t bytes )
+{
+  constexpr size_t minimumSize = 4096;
+  if ( bytes <= minimumSize )
+    {
+    return minimumSize;
+    }
+  size_t p = minimumSize;
+  while ( p <= bytes / 2 )
+    {
+    p *= 2;
+    }
+  const size_t step = p / 4;
+  return ( bytes + step - 1 ) / step * step;
+}
+
+
+void *AllocateAligned( size_t bytes, size_t alignment, bool pooled )
+{
+  alignment = std::max( alignment, alignof(std::max_align_t) );
+
+  const size_t total = bytes + alignment + sizeof(BufferHeader);
+  void *raw = std::malloc( total );
+  if ( raw == nullptr )
+    {
+    throw std::bad_alloc();
+    }
+
+  uintptr_t address = reinterpret_cast<uintptr_t>(raw) + sizeof(BufferHeader);
+  address = ( address + alignment - 1 ) / alignment * alignment;
+
+  void *buffer = reinterpret_cast<void *>(address);
+  BufferHeader *header = GetHeader( buffer );
+  header->raw = raw;
+  header->bytes = bytes;
+  header->alignment = alignment;
+  header->pooled = pooled;
+
+  PlaceImageBuffer( buffer, bytes );
+
+  g_BytesAllocated += bytes;
+  return buffer;
+}
+
+
+void ReleasePool()
+{
+  std::lock_guard<std::mutex> lock( g_PoolMutex );
+  for ( auto &sizeClass : g_Pool )
+    {
+    for ( void * buffer : sizeClass.second )
+      {
+      std::free( GetHeader( buffer )->raw );
+      }
+    }
+  g_Pool.clear();
+  g_PoolBytes = 0;
+}
+
+
+std::string ToUpper( std::string s )
+{
+  std::transform( s.begin(), s.end(), s.begin(), [] ( char c ) { return static_cast<char>( std::toupper( c ) ); } );
+  return s;
+}
+
+}
+
+
+bool SetImageBufferAllocator( const std::string &allocator )
+{
+  const std::string name = ToUpper( allocator );
+
+  AllocatorEnum allocatorEnum;
+  if ( name == "DEFAULT" )
+    {
+    allocatorEnum = AllocatorEnum::Default;
+    }
+  else if ( name == "ALIGNED" )
+    {
+    allocatorEnum = AllocatorEnum::Aligned;
+    }
+  else if ( name == "POOL" )
+    {
+    allocatorEnum = AllocatorEnum::Pool;
+    }
+  else if ( name == "HUGEPAGES" )
+    {
+    allocatorEnum = AllocatorEnum::HugePages;
+    }
+  else
+    {
+    return false;
+    }
+
+  const int previous = g_Allocator.exchange( static_cast<int>(allocatorEnum) );
+  if ( previous == static_cast<int>(AllocatorEnum::Pool) && allocatorEnum != AllocatorEnum::Pool )
+    {
+    ReleasePool();
+    }
+  return true;
+}
+
+
+std::string GetImageBufferAllocator()
+{
+  switch ( static_cast<AllocatorEnum>( g_Allocator.load() ) )
+    {
+    case AllocatorEnum::Aligned:
+      return "ALIGNED";
+    case AllocatorEnum::Pool:
+      return "POOL";
+    case AllocatorEnum::HugePages:
+      return "HUGEPAGES";
+    case AllocatorEnum::Default:
+    default:
+      return "DEFAULT";
+    }
+}
+
+
+void *AllocateImageBuffer( size_t bytes )
+{
+  switch ( static_cast<AllocatorEnum>( g_Allocator.load() ) )
+    {
+    case AllocatorEnum::Aligned:
+      return AllocateAligned( bytes, CacheLineAlignment, false );
+    case AllocatorEnum::Pool:
+      {
+      const size_t sizeClass = PoolSizeClass( bytes );
+        {
+        std::lock_guard<std::mutex> lock( g_PoolMutex );
+        auto iter = g_Pool.find( sizeClass );
+        if ( iter != g_Pool.end() && !iter->second.empty() )
+          {
+          void *buffer = iter->second.back();
+          iter->second.pop_back();
+          g_PoolBytes -= sizeClass;
+          g_BytesReused += sizeClass;
+          return buffer;
+          }
+        }
+      return AllocateAligned( sizeClass, CacheLineAlignment, true );
+      }
+    case AllocatorEnum::HugePages:
+      {
+      if ( bytes < HugePageSize )
+        {
+        return AllocateAligned( bytes, CacheLineAlignment, false );
+        }
+      void *buffer = AllocateAligned( bytes, HugePageSize, false );
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      // only advisory, failure leaves regular pages
+      madvise( buffer, bytes / HugePageSize * HugePageSize, MADV_HUGEPAGE );
+#endif
+      return buffer;
+      }
+    case AllocatorEnum::Default:
+    default:
+      return AllocateAligned( bytes, alignof(std::max_align_t), false );
+    }
+}
+
+
+void DeallocateImageBuffer( void *buffer ) noexcept
+{
+  if ( buffer == nullptr )
+    {
+    return;
+    }
+
+  BufferHeader *header = GetHeader( buffer );
+  if ( header->pooled && g_Allocator.load() == static_cast<int>(AllocatorEnum::Pool) )
+    {
+    std::lock_guard<std::mutex> lock( g_PoolMutex );
+    if ( g_PoolBytes + header->bytes <= PoolCapacity )
+      {
+      try
+        {
+        g_Pool[header->bytes].push_back( buffer );
+        g_PoolBytes += header->bytes;
+        return;
+        }
+      catch ( ... )
+        {
+        // unable to cache the buffer so it is freed
+        }
+      }
+    }
+  std::free( header->raw );
+}
+
+
+uint64_t GetImageBufferBytesAllocated()
+{
+  return g_BytesAllocated.load();
+}
+
+
+uint64_t GetImageBufferBytesReused()
+{
+  return g_BytesReused.load();
+}
+
+}
+}
+}
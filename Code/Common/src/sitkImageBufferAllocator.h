@@ -0,0 +1,118 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageBufferAllocator_h
+#define sitkImageBufferAllocator_h
+
+#include "sitkCommon.h"
+#include "itkImportImageContainer.h"
+
+#include <string>
+#include <cstdint>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \brief Process wide allocation of pixel buffers for images
+ * constructed by SimpleITK.
+ *
+ * The allocation strategy is selected by name with
+ * SetImageBufferAllocator:
+ *  - "DEFAULT" uses the heap with the platform's default alignment.
+ *  - "ALIGNED" aligns buffers to 64 bytes ( the cache line size ).
+ *  - "POOL" aligns to 64 bytes and keeps released buffers in size
+ *  classes to be reused by later allocations.
+ *  - "HUGEPAGES" aligns large buffers to 2MB and advises the kernel
+ *  to back them with transparent huge pages, where supported.
+ *
+ * Buffers record how they were allocated, so the strategy may be
+ * changed while buffers are in use.
+ */
+SITKCommon_HIDDEN bool SetImageBufferAllocator( const std::string &allocator );
+SITKCommon_HIDDEN std::string GetImageBufferAllocator();
+
+SITKCommon_HIDDEN void *AllocateImageBuffer( size_t bytes );
+SITKCommon_HIDDEN void DeallocateImageBuffer( void *buffer ) noexcept;
+
+/** Number of bytes obtained from the system for image buffers. */
+SITKCommon_HIDDEN uint64_t GetImageBufferBytesAllocated();
+/** Number of bytes of image buffers served from the pool. */
+SITKCommon_HIDDEN uint64_t GetImageBufferBytesReused();
+
+
+/** \brief A pixel container with memory from AllocateImageBuffer.
+ *
+ * The container can still be manipulated with the
+ * itk::ImportImageContainer interface, in which case the memory is
+ * managed by ITK as usual.
+ */
+template <typename TElement>
+class SITKCommon_HIDDEN ImageBufferContainer
+  : public itk::ImportImageContainer<itk::SizeValueType, TElement>
+{
+public:
+  using Self = ImageBufferContainer;
+  using Superclass = itk::ImportImageContainer<itk::SizeValueType, TElement>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ElementIdentifier = typename Superclass::ElementIdentifier;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ImageBufferContainer, ImportImageContainer);
+
+  /** Allocate the container's buffer with size elements, the
+   * elements are not initialized. */
+  void AllocateBuffer( ElementIdentifier size )
+    {
+      auto buffer = static_cast<TElement *>( AllocateImageBuffer( size * sizeof(TElement) ) );
+      this->SetImportPointer( buffer, size, true );
+      m_Buffer = buffer;
+    }
+
+protected:
+  ImageBufferContainer() = default;
+
+  ~ImageBufferContainer() override
+    {
+      // the base destructor would only use its own deallocation
+      this->DeallocateManagedMemory();
+    }
+
+  void DeallocateManagedMemory() override
+    {
+      if ( m_Buffer != nullptr && this->GetImportPointer() == m_Buffer && this->GetContainerManageMemory() )
+        {
+        DeallocateImageBuffer( m_Buffer );
+        m_Buffer = nullptr;
+        // reset the state without deleting
+        this->SetContainerManageMemory( false );
+        }
+      Superclass::DeallocateManagedMemory();
+    }
+
+private:
+  TElement *m_Buffer{ nullptr };
+};
+
+}
+}
+}
+
+#endif // sitkImageBufferAllocator_h
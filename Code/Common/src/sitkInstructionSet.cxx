@@ -0,0 +1,166 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkInstructionSet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+
+// The instruction set is selected on the first use.
+constexpr int Unselected = -1;
+
+std::atomic<int> g_InstructionSet{ Unselected };
+
+
+std::string ToUpper( std::string s )
+{
+  std::transform( s.begin(), s.end(), s.begin(),
+                  []( unsigned char c ) { return static_cast<char>( std::toupper( c ) ); } );
+  return s;
+}
+
+
+bool IsSupported( InstructionSetEnum instructionSet )
+{
+  switch ( instructionSet )
+    {
+    case InstructionSetEnum::Baseline:
+      return true;
+#if defined( SITK_MULTIVERSION_X86 )
+    case InstructionSetEnum::AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports( "avx2" );
+    case InstructionSetEnum::AVX512:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" )
+        && __builtin_cpu_supports( "avx512dq" ) && __builtin_cpu_supports( "avx512vl" );
+#endif
+    default:
+      return false;
+    }
+}
+
+
+InstructionSetEnum GetBestSupported()
+{
+  for ( InstructionSetEnum instructionSet : { InstructionSetEnum::AVX512, InstructionSetEnum::AVX2 } )
+    {
+    if ( IsSupported( instructionSet ) )
+      {
+      return instructionSet;
+      }
+    }
+  return InstructionSetEnum::Baseline;
+}
+
+
+bool FromName( const std::string &name, InstructionSetEnum &instructionSet )
+{
+  const std::string upper = ToUpper( name );
+  if ( upper == "AUTO" )
+    {
+    instructionSet = GetBestSupported();
+    }
+  else if ( upper == "BASELINE" )
+    {
+    instructionSet = InstructionSetEnum::Baseline;
+    }
+  else if ( upper == "AVX2" )
+    {
+    instructionSet = InstructionSetEnum::AVX2;
+    }
+  else if ( upper == "AVX512" )
+    {
+    instructionSet = InstructionSetEnum::AVX512;
+    }
+  else
+    {
+    return false;
+    }
+  return IsSupported( instructionSet );
+}
+
+
+InstructionSetEnum SelectFromEnvironment()
+{
+  InstructionSetEnum instructionSet = GetBestSupported();
+  const char *env = std::getenv( "SITK_INSTRUCTION_SET" );
+  if ( env != nullptr && !FromName( env, instructionSet ) )
+    {
+    // not valid or not supported, the best is used
+    instructionSet = GetBestSupported();
+    }
+  return instructionSet;
+}
+
+} // end anonymous namespace
+
+
+InstructionSetEnum GetInstructionSet()
+{
+  int value = g_InstructionSet.load( std::memory_order_relaxed );
+  if ( value == Unselected )
+    {
+    int expected = Unselected;
+    g_InstructionSet.compare_exchange_strong( expected, static_cast<int>( SelectFromEnvironment() ) );
+    value = g_InstructionSet.load();
+    }
+  return static_cast<InstructionSetEnum>( value );
+}
+
+
+bool SetInstructionSet( const std::string &name )
+{
+  InstructionSetEnum instructionSet;
+  if ( !FromName( name, instructionSet ) )
+    {
+    return false;
+    }
+  g_InstructionSet = static_cast<int>( instructionSet );
+  return true;
+}
+
+
+std::string GetInstructionSetName()
+{
+  switch ( GetInstructionSet() )
+    {
+    case InstructionSetEnum::AVX512:
+      return "AVX512";
+    case InstructionSetEnum::AVX2:
+      return "AVX2";
+    case InstructionSetEnum::Baseline:
+    default:
+      return "BASELINE";
+    }
+}
+
+}
+}
+}
@@ -0,0 +1,150 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkMemoryStatisticsInternal.h"
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+struct BufferRecord
+{
+  uint64_t References;
+  uint64_t Bytes;
+};
+
+struct MemoryRegistry
+{
+  std::mutex Mutex;
+  std::unordered_map<const void *, BufferRecord> Buffers;
+  uint64_t Bytes{ 0 };
+  uint64_t PeakBytes{ 0 };
+};
+
+// constructed on first use, to be available during static
+// initialization and destruction of images
+MemoryRegistry &GetMemoryRegistry()
+{
+  static auto *registry = new MemoryRegistry;
+  return *registry;
+}
+
+std::atomic<uint64_t> NumberOfDeepCopies{ 0 };
+
+}
+
+namespace detail
+{
+
+void RegisterImageBuffer( const void *container, uint64_t bytes )
+{
+  if ( container == nullptr )
+    {
+    return;
+    }
+
+  MemoryRegistry &registry = GetMemoryRegistry();
+  std::lock_guard<std::mutex> lock( registry.Mutex );
+
+  auto iter = registry.Buffers.find( container );
+  if ( iter != registry.Buffers.end() )
+    {
+    ++iter->second.References;
+    return;
+    }
+
+  registry.Buffers.emplace( container, BufferRecord{ 1, bytes } );
+  registry.Bytes += bytes;
+  registry.PeakBytes = std::max( registry.PeakBytes, registry.Bytes );
+}
+
+void UnregisterImageBuffer( const void *container ) noexcept
+{
+  if ( container == nullptr )
+    {
+    return;
+    }
+
+  MemoryRegistry &registry = GetMemoryRegistry();
+  std::lock_guard<std::mutex> lock( registry.Mutex );
+
+  auto iter = registry.Buffers.find( container );
+  if ( iter == registry.Buffers.end() )
+    {
+    return;
+    }
+
+  if ( --iter->second.References == 0 )
+    {
+    registry.Bytes -= iter->second.Bytes;
+    registry.Buffers.erase( iter );
+    }
+}
+
+void RecordImageDeepCopy() noexcept
+{
+  ++NumberOfDeepCopies;
+}
+
+}
+
+
+std::string MemoryStatistics::ToString() const
+{
+  std::ostringstream out;
+  out << *this;
+  return out.str();
+}
+
+
+MemoryStatistics GetMemoryStatistics()
+{
+  MemoryStatistics stats;
+
+  MemoryRegistry &registry = GetMemoryRegistry();
+  {
+  std::lock_guard<std::mutex> lock( registry.Mutex );
+  stats.NumberOfBuffers = registry.Buffers.size();
+  stats.Bytes = registry.Bytes;
+  stats.PeakBytes = registry.PeakBytes;
+  }
+  stats.NumberOfDeepCopies = NumberOfDeepCopies;
+
+  return stats;
+}
+
+
+std::ostream & operator<<(std::ostream & os, const MemoryStatistics & stats)
+{
+  return os << "NumberOfBuffers: " << stats.NumberOfBuffers
+            << " Bytes: " << stats.Bytes
+            << " PeakBytes: " << stats.PeakBytes
+            << " NumberOfDeepCopies: " << stats.NumberOfDeepCopies;
+}
+
+}
+}
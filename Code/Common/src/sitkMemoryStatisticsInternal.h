@@ -0,0 +1,46 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMemoryStatisticsInternal_h
+#define sitkMemoryStatisticsInternal_h
+
+#include "sitkMemoryStatistics.h"
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** Add a reference from an Image to a pixel buffer, identified by
+ * its pixel container. The buffer is counted by the memory
+ * statistics while it has references. */
+SITKCommon_HIDDEN void RegisterImageBuffer( const void *container, uint64_t bytes );
+
+/** Remove a reference added with RegisterImageBuffer, a nullptr is
+ * ignored. */
+SITKCommon_HIDDEN void UnregisterImageBuffer( const void *container ) noexcept;
+
+/** Count a copy made by copy-on-write. */
+SITKCommon_HIDDEN void RecordImageDeepCopy() noexcept;
+
+}
+}
+}
+
+#endif // sitkMemoryStatisticsInternal_h
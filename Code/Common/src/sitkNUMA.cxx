@@ -0,0 +1,274 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkNUMA.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+
+enum class NUMAPolicyEnum : int
+{
+  None,
+  FirstTouch,
+  Interleave
+};
+
+// Smaller buffers are initialized by the allocating thread.
+constexpr size_t MinimumParallelBytes = size_t(4) << 20;
+
+// Bytes initialized by one work unit.
+constexpr size_t ChunkBytes = size_t(1) << 20;
+
+std::atomic<int> g_Policy{ static_cast<int>(NUMAPolicyEnum::None) };
+
+
+struct Topology
+{
+  std::vector< std::vector<unsigned int> > NodeCPUs;
+};
+
+
+// Parse a list of the form "0-3,8,10-11".
+std::vector<unsigned int> ParseCPUList( const std::string &list )
+{
+  std::vector<unsigned int> cpus;
+  std::istringstream in( list );
+  std::string range;
+  while ( std::getline( in, range, ',' ) )
+    {
+    if ( range.empty() || !std::isdigit( static_cast<unsigned char>(range[0]) ) )
+      {
+      continue;
+      }
+    const size_t dash = range.find( '-' );
+    const unsigned long first = std::stoul( range.substr( 0, dash ) );
+    const unsigned long last = ( dash == std::string::npos ) ? first : std::stoul( range.substr( dash + 1 ) );
+    for ( unsigned long cpu = first; cpu <= last; ++cpu )
+      {
+      cpus.push_back( static_cast<unsigned int>(cpu) );
+      }
+    }
+  return cpus;
+}
+
+
+Topology DetectTopology()
+{
+  Topology topology;
+
+#if defined(__linux__)
+  std::ifstream online( "/sys/devices/system/node/online" );
+  std::string nodeList;
+  if ( online && std::getline( online, nodeList ) )
+    {
+    try
+      {
+      for ( unsigned int node : ParseCPUList( nodeList ) )
+        {
+        std::ifstream cpuList( "/sys/devices/system/node/node" + std::to_string( node ) + "/cpulist" );
+        std::string cpus;
+        std::getline( cpuList, cpus );
+        if ( topology.NodeCPUs.size() <= node )
+          {
+          topology.NodeCPUs.resize( node + 1 );
+          }
+        topology.NodeCPUs[node] = ParseCPUList( cpus );
+        }
+      }
+    catch ( std::exception & )
+      {
+      topology.NodeCPUs.clear();
+      }
+    }
+#endif
+
+  if ( topology.NodeCPUs.empty() )
+    {
+    std::vector<unsigned int> cpus( std::max( std::thread::hardware_concurrency(), 1u ) );
+    for ( unsigned int i = 0; i < cpus.size(); ++i )
+      {
+      cpus[i] = i;
+      }
+    topology.NodeCPUs.push_back( cpus );
+    }
+
+  return topology;
+}
+
+
+const Topology &GetTopology()
+{
+  static const Topology topology = DetectTopology();
+  return topology;
+}
+
+
+std::string ToUpper( std::string s )
+{
+  std::transform( s.begin(), s.end(), s.begin(), [] ( char c ) { return static_cast<char>( std::toupper( c ) ); } );
+  return s;
+}
+
+}
+
+
+bool SetNUMAPolicy( const std::string &policy )
+{
+  const std::string name = ToUpper( policy );
+
+  NUMAPolicyEnum policyEnum;
+  if ( name == "NONE" )
+    {
+    policyEnum = NUMAPolicyEnum::None;
+    }
+  else if ( name == "FIRST_TOUCH" )
+    {
+    policyEnum = NUMAPolicyEnum::FirstTouch;
+    }
+  else if ( name == "INTERLEAVE" )
+    {
+    policyEnum = NUMAPolicyEnum::Interleave;
+    }
+  else
+    {
+    return false;
+    }
+
+  g_Policy = static_cast<int>(policyEnum);
+  return true;
+}
+
+
+std::string GetNUMAPolicy()
+{
+  switch ( static_cast<NUMAPolicyEnum>( g_Policy.load() ) )
+    {
+    case NUMAPolicyEnum::FirstTouch:
+      return "FIRST_TOUCH";
+    case NUMAPolicyEnum::Interleave:
+      return "INTERLEAVE";
+    case NUMAPolicyEnum::None:
+    default:
+      return "NONE";
+    }
+}
+
+
+void PlaceImageBuffer( void *buffer, size_t bytes ) noexcept
+{
+  if ( static_cast<NUMAPolicyEnum>( g_Policy.load() ) != NUMAPolicyEnum::Interleave
+       || bytes < MinimumParallelBytes )
+    {
+    return;
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+  const auto & nodes = GetTopology().NodeCPUs;
+  if ( nodes.size() < 2 || nodes.size() > 8 * sizeof(unsigned long) )
+    {
+    return;
+    }
+
+  unsigned long nodeMask = 0;
+  for ( size_t node = 0; node < nodes.size(); ++node )
+    {
+    if ( !nodes[node].empty() )
+      {
+      nodeMask |= 1ul << node;
+      }
+    }
+
+  // only the whole pages in the buffer
+  const uintptr_t pageSize = static_cast<uintptr_t>( sysconf( _SC_PAGESIZE ) );
+  const uintptr_t begin = ( reinterpret_cast<uintptr_t>(buffer) + pageSize - 1 ) / pageSize * pageSize;
+  const uintptr_t end = ( reinterpret_cast<uintptr_t>(buffer) + bytes ) / pageSize * pageSize;
+  if ( end > begin )
+    {
+    // MPOL_INTERLEAVE, failure leaves the default placement
+    constexpr int mpolInterleave = 3;
+    syscall( SYS_mbind, begin, end - begin, mpolInterleave, &nodeMask, 8 * sizeof(unsigned long), 0 );
+    }
+#else
+  (void)buffer;
+#endif
+}
+
+
+bool ZeroImageBuffer( void *buffer, size_t bytes )
+{
+  if ( static_cast<NUMAPolicyEnum>( g_Policy.load() ) == NUMAPolicyEnum::None
+       || bytes < MinimumParallelBytes )
+    {
+    return false;
+    }
+
+  char *bufferBytes = static_cast<char *>(buffer);
+  const size_t numberOfChunks = ( bytes + ChunkBytes - 1 ) / ChunkBytes;
+
+  itk::MultiThreaderBase::Pointer mt = itk::MultiThreaderBase::New();
+  mt->ParallelizeArray( 0, numberOfChunks,
+                        [bufferBytes, bytes]( itk::SizeValueType chunk ) {
+                          const size_t offset = chunk * ChunkBytes;
+                          std::memset( bufferBytes + offset, 0, std::min( ChunkBytes, bytes - offset ) );
+                        },
+                        nullptr );
+  return true;
+}
+
+
+unsigned int GetNumberOfNUMANodes()
+{
+  return static_cast<unsigned int>( GetTopology().NodeCPUs.size() );
+}
+
+
+std::vector<unsigned int> GetNUMANodeCPUs( unsigned int node )
+{
+  const auto & nodes = GetTopology().NodeCPUs;
+  if ( node >= nodes.size() )
+    {
+    return std::vector<unsigned int>();
+    }
+  return nodes[node];
+}
+
+}
+}
+}
@@ -0,0 +1,70 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkNUMA_h
+#define sitkNUMA_h
+
+#include "sitkCommon.h"
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \brief Process wide placement of the pages of image buffers
+ * allocated by SimpleITK on the nodes of a NUMA system.
+ *
+ * The policy is selected by name with SetNUMAPolicy:
+ *  - "NONE" the buffer is initialized by the allocating thread, so
+ *  its pages are placed on that thread's node.
+ *  - "FIRST_TOUCH" large buffers are initialized in parallel by the
+ *  threads of the default multi-threader, to distribute the pages
+ *  over the nodes of the threads which process them.
+ *  - "INTERLEAVE" large buffers are interleaved over all nodes, where
+ *  supported, and initialized in parallel.
+ */
+SITKCommon_HIDDEN bool SetNUMAPolicy( const std::string &policy );
+SITKCommon_HIDDEN std::string GetNUMAPolicy();
+
+/** Apply the placement policy to a newly allocated buffer, before
+ * its pages are touched. */
+SITKCommon_HIDDEN void PlaceImageBuffer( void *buffer, size_t bytes ) noexcept;
+
+/** Initialize the buffer to zero according to the policy. Returns
+ * false when the buffer was not initialized, and is to be
+ * initialized by the caller. */
+SITKCommon_HIDDEN bool ZeroImageBuffer( void *buffer, size_t bytes );
+
+/** The NUMA nodes of the system and their logical CPUs. A system
+ * without NUMA information reports a single node with all CPUs.
+ * @{
+ */
+SITKCommon_HIDDEN unsigned int GetNumberOfNUMANodes();
+SITKCommon_HIDDEN std::vector<unsigned int> GetNUMANodeCPUs( unsigned int node );
+/**@}*/
+
+}
+}
+}
+
+#endif // sitkNUMA_h
@@ -50,6 +50,22 @@ namespace itk
 
     virtual PimpleImageBase *ShallowCopy() const = 0;
     virtual PimpleImageBase *DeepCopy() const = 0;
+    /** Allocate a new image with the same meta-data and geometry,
+     * without copying the pixel values. */
+    virtual PimpleImageBase *AllocateCopy() const = 0;
+    /** Create an image with a copy of the meta-data and geometry of
+     * this image, which shares the pixel container. */
+    virtual PimpleImageBase *HeaderCopy() const = 0;
+    /** Create an image of a region of this image, which refers to
+     * this image's buffer when the region is contiguous in memory. */
+    virtual PimpleImageBase *GetSubImage( const std::vector<uint32_t> &index, const std::vector<uint32_t> &size ) const = 0;
+    /** Create an image with the buffer of this image, in the same
+     * order, with another size of as many pixels and other physical
+     * information. */
+    virtual PimpleImageBase *GetReshapedView( const std::vector<uint32_t> &size,
+                                              const std::vector<double> &origin,
+                                              const std::vector<double> &spacing,
+                                              const std::vector<double> &direction ) const = 0;
     virtual itk::DataObject* GetDataBase( ) = 0;
     virtual const itk::DataObject* GetDataBase( ) const = 0;
 
@@ -73,8 +89,16 @@ namespace itk
     virtual std::vector<double> TransformIndexToPhysicalPoint( const std::vector<int64_t> &idx) const = 0;
     virtual std::vector<double> TransformPhysicalPointToContinuousIndex( const std::vector<double> &pt) const = 0;
     virtual std::vector<double> TransformContinuousIndexToPhysicalPoint( const std::vector<double> &idx) const = 0;
+    virtual std::vector<double> TransformIndicesToPhysicalPoints( const std::vector<int64_t> &indices) const = 0;
+    virtual std::vector<int64_t> TransformPhysicalPointsToIndices( const std::vector<double> &points) const = 0;
+    virtual std::vector<double> TransformPhysicalPointsToContinuousIndices( const std::vector<double> &points) const = 0;
+    virtual std::vector<double> TransformContinuousIndicesToPhysicalPoints( const std::vector<double> &indices) const = 0;
 
     virtual std::vector<double> EvaluateAtContinuousIndex( const std::vector<double> &index, InterpolatorEnum interp) const = 0;
+    virtual std::vector<double> EvaluateAtContinuousIndices( const std::vector<double> &indices, InterpolatorEnum interp) const = 0;
+    /** Release cached objects which depend on the pixel values, and
+     * refer to the image */
+    virtual void ReleaseCachedInterpolator() const = 0;
 
     virtual std::string ToString() const = 0;
 
@@ -154,6 +178,28 @@ namespace itk
     virtual const float    *GetBufferAsFloat( ) const = 0;
     virtual const double   *GetBufferAsDouble( ) const = 0;
     virtual const void     *GetBufferAsVoid( ) const = 0;
+
+    virtual void GetRegionAsInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int8_t *buffer ) const = 0;
+    virtual void GetRegionAsUInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint8_t *buffer ) const = 0;
+    virtual void GetRegionAsInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int16_t *buffer ) const = 0;
+    virtual void GetRegionAsUInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint16_t *buffer ) const = 0;
+    virtual void GetRegionAsInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int32_t *buffer ) const = 0;
+    virtual void GetRegionAsUInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint32_t *buffer ) const = 0;
+    virtual void GetRegionAsInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int64_t *buffer ) const = 0;
+    virtual void GetRegionAsUInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint64_t *buffer ) const = 0;
+    virtual void GetRegionAsFloat( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, float *buffer ) const = 0;
+    virtual void GetRegionAsDouble( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, double *buffer ) const = 0;
+
+    virtual void SetRegionFromInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int8_t *buffer ) = 0;
+    virtual void SetRegionFromUInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint8_t *buffer ) = 0;
+    virtual void SetRegionFromInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int16_t *buffer ) = 0;
+    virtual void SetRegionFromUInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint16_t *buffer ) = 0;
+    virtual void SetRegionFromInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int32_t *buffer ) = 0;
+    virtual void SetRegionFromUInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint32_t *buffer ) = 0;
+    virtual void SetRegionFromInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int64_t *buffer ) = 0;
+    virtual void SetRegionFromUInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint64_t *buffer ) = 0;
+    virtual void SetRegionFromFloat( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const float *buffer ) = 0;
+    virtual void SetRegionFromDouble( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const double *buffer ) = 0;
   };
 
   } // end namespace simple
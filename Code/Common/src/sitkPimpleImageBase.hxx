@@ -22,15 +22,21 @@
 #include "sitkMemberFunctionFactory.h"
 #include "sitkConditional.h"
 #include "sitkCreateInterpolator.hxx"
+#include "sitkMemoryStatisticsInternal.h"
 
 #include "itkImage.h"
 #include "itkVectorImage.h"
 #include "itkLabelMap.h"
 #include "itkImageDuplicator.h"
+#include "itkMath.h"
+#include "itkMultiThreaderBase.h"
 #include "itkConvertLabelMapFilter.h"
 
 
 #include <type_traits>
+#include <algorithm>
+#include <mutex>
+#include <memory>
 
 namespace itk
 {
@@ -48,6 +54,41 @@ namespace itk
   struct MakeDependentOn
     : public U {};
 
+  // A pixel container which refers to a part of the buffer of a
+  // parent image. The reference to the parent keeps the memory alive
+  // and makes the parent's buffer shared for copy on write.
+  template <typename TElement>
+  class ImageViewContainer
+    : public itk::ImportImageContainer<itk::SizeValueType, TElement>
+  {
+  public:
+    using Self = ImageViewContainer;
+    using Superclass = itk::ImportImageContainer<itk::SizeValueType, TElement>;
+    using Pointer = itk::SmartPointer<Self>;
+
+    itkNewMacro(Self);
+    itkTypeMacro(ImageViewContainer, ImportImageContainer);
+
+    void SetParent( const itk::DataObject *parent, const itk::Object *parentBuffer, uint64_t parentBufferBytes )
+      {
+        m_Parent = parent;
+        m_ParentBuffer = parentBuffer;
+        m_ParentBufferBytes = parentBufferBytes;
+      }
+    int GetParentReferenceCount() const { return m_Parent ? m_Parent->GetReferenceCount() : 0; }
+    const itk::Object *GetParentBuffer() const { return m_ParentBuffer; }
+    uint64_t GetParentBufferBytes() const { return m_ParentBufferBytes; }
+
+  protected:
+    ImageViewContainer() = default;
+    ~ImageViewContainer() override = default;
+
+  private:
+    itk::DataObject::ConstPointer m_Parent;
+    const itk::Object *m_ParentBuffer{ nullptr };
+    uint64_t m_ParentBufferBytes{ 0 };
+  };
+
   template <class TImageType>
   class PimpleImage
     : public PimpleImageBase
@@ -90,9 +131,15 @@ namespace itk
                                 << "SimpleITK only supports images with a zero starting index!" );
             }
           }
+
+        this->InternalRegisterBuffer(image);
       }
 
-    PimpleImageBase *ShallowCopy( ) const override { return new Self(this->m_Image.GetPointer()); }
+    ~PimpleImage() override = default;
+
+    // Shallow copies share the image and its registration without
+    // locking, the reference counts are atomic.
+    PimpleImageBase *ShallowCopy( ) const override { return new Self(this->m_Image.GetPointer(), this->m_Registration); }
     PimpleImageBase *DeepCopy( ) const override { return this->DeepCopy<TImageType>(); }
 
     template <typename UImageType>
@@ -121,6 +168,54 @@ namespace itk
         return new Self( output.GetPointer() );
       }
 
+    PimpleImageBase *AllocateCopy( ) const override { return this->AllocateCopy<TImageType>(); }
+
+    template <typename UImageType>
+    typename std::enable_if<!IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    AllocateCopy( void ) const
+      {
+        ImagePointer output = ImageType::New();
+
+        output->CopyInformation( this->m_Image );
+        output->SetRegions( this->m_Image->GetLargestPossibleRegion() );
+        output->SetMetaDataDictionary( this->m_Image->GetMetaDataDictionary() );
+        output->Allocate( false );
+
+        return new Self( output.GetPointer() );
+      }
+    template <typename UImageType>
+    typename std::enable_if<IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    AllocateCopy( void ) const
+      {
+        // the label objects are the data, so they must be copied
+        return this->DeepCopy<UImageType>();
+      }
+
+    PimpleImageBase *HeaderCopy( ) const override { return this->HeaderCopy<TImageType>(); }
+
+    template <typename UImageType>
+    typename std::enable_if<!IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    HeaderCopy( void ) const
+      {
+        ImagePointer output = ImageType::New();
+
+        output->CopyInformation( this->m_Image );
+        output->SetRegions( this->m_Image->GetLargestPossibleRegion() );
+        output->SetMetaDataDictionary( this->m_Image->GetMetaDataDictionary() );
+        output->SetNumberOfComponentsPerPixel( this->m_Image->GetNumberOfComponentsPerPixel() );
+        // the shared container is counted by both images for copy on write
+        output->SetPixelContainer( const_cast<typename ImageType::PixelContainer *>( this->m_Image->GetPixelContainer() ) );
+
+        return new Self( output.GetPointer() );
+      }
+    template <typename UImageType>
+    typename std::enable_if<IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    HeaderCopy( void ) const
+      {
+        // the label objects are the data, so they must be copied
+        return this->DeepCopy<UImageType>();
+      }
+
     itk::DataObject* GetDataBase( ) override { return this->m_Image.GetPointer(); }
     const itk::DataObject* GetDataBase( ) const override { return this->m_Image.GetPointer(); }
 
@@ -265,11 +360,55 @@ namespace itk
       return sitkITKVectorToSTL<double>( point );
       }
 
+    std::vector<double> TransformIndicesToPhysicalPoints( const std::vector<int64_t> &indices ) const override
+      {
+        std::vector<double> points( indices.size() );
+        this->InternalTransformIndicesToPhysicalPoints( indices, points );
+        return points;
+      }
+
+    std::vector<int64_t> TransformPhysicalPointsToIndices( const std::vector<double> &points ) const override
+      {
+        std::vector<double> cindices( points.size() );
+        this->InternalTransformPhysicalPointsToContinuousIndices( points, cindices );
+
+        // same rounding as itk::ImageBase::TransformPhysicalPointToIndex
+        std::vector<int64_t> indices( points.size() );
+        std::transform( cindices.begin(), cindices.end(), indices.begin(),
+                        []( double v ) { return Math::RoundHalfIntegerUp<int64_t>( v ); } );
+        return indices;
+      }
+
+    std::vector<double> TransformPhysicalPointsToContinuousIndices( const std::vector<double> &points ) const override
+      {
+        std::vector<double> cindices( points.size() );
+        this->InternalTransformPhysicalPointsToContinuousIndices( points, cindices );
+        return cindices;
+      }
+
+    std::vector<double> TransformContinuousIndicesToPhysicalPoints( const std::vector<double> &indices ) const override
+      {
+        std::vector<double> points( indices.size() );
+        this->InternalTransformIndicesToPhysicalPoints( indices, points );
+        return points;
+      }
+
       std::vector<double> EvaluateAtContinuousIndex( const std::vector<double> &index, InterpolatorEnum interp) const override
           {
           return InternalEvaluateAtContinuousIndex<typename ImageTypeToPixelID<ImageType>::PixelIDType> (index, interp);
           }
 
+      std::vector<double> EvaluateAtContinuousIndices( const std::vector<double> &indices, InterpolatorEnum interp) const override
+          {
+          return InternalEvaluateAtContinuousIndices<typename ImageTypeToPixelID<ImageType>::PixelIDType> (indices, interp);
+          }
+
+      void ReleaseCachedInterpolator() const override
+          {
+          std::lock_guard<std::mutex> lock( m_InterpolatorMutex );
+          m_Interpolator = nullptr;
+          }
+
       unsigned int GetSize( unsigned int dimension ) const override
       {
         if ( dimension > ImageType::ImageDimension - 1 )
@@ -303,7 +442,24 @@ namespace itk
 
     int GetReferenceCountOfImage() const override
       {
-        return this->m_Image->GetReferenceCount();
+        // a view is only unique when the parent is only referred to by the view, and
+        // the buffer may be shared with other ITK images, e.g. the inputs of filters
+        return this->m_Image->GetReferenceCount()
+          + this->InternalGetViewParentReferenceCount( this->m_Image.GetPointer() )
+          + this->InternalGetSharedBufferReferenceCount( this->m_Image.GetPointer() );
+      }
+
+    PimpleImageBase *GetSubImage( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz ) const override
+      {
+        return this->InternalGetSubImage<TImageType>( idx, sz );
+      }
+
+    PimpleImageBase *GetReshapedView( const std::vector<uint32_t> &sz,
+                                      const std::vector<double> &origin,
+                                      const std::vector<double> &spacing,
+                                      const std::vector<double> &direction ) const override
+      {
+        return this->InternalGetReshapedView<TImageType>( sz, origin, spacing, direction );
       }
 
     int8_t  GetPixelAsInt8( const std::vector<uint32_t> &idx) const override
@@ -667,9 +823,270 @@ namespace itk
         this->InternalSetPixel<BasicPixelID<std::complex<double> > >( idx, v );
       }
 
+    void GetRegionAsInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int8_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt8(), buffer, true );
+      }
+    void GetRegionAsUInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint8_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt8(), buffer, true );
+      }
+    void GetRegionAsInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int16_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt16(), buffer, true );
+      }
+    void GetRegionAsUInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint16_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt16(), buffer, true );
+      }
+    void GetRegionAsInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int32_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt32(), buffer, true );
+      }
+    void GetRegionAsUInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint32_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt32(), buffer, true );
+      }
+    void GetRegionAsInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, int64_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt64(), buffer, true );
+      }
+    void GetRegionAsUInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, uint64_t *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt64(), buffer, true );
+      }
+    void GetRegionAsFloat( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, float *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsFloat(), buffer, true );
+      }
+    void GetRegionAsDouble( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, double *buffer ) const override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsDouble(), buffer, true );
+      }
+    void SetRegionFromInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int8_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt8(), const_cast<int8_t *>(buffer), false );
+      }
+    void SetRegionFromUInt8( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint8_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt8(), const_cast<uint8_t *>(buffer), false );
+      }
+    void SetRegionFromInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int16_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt16(), const_cast<int16_t *>(buffer), false );
+      }
+    void SetRegionFromUInt16( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint16_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt16(), const_cast<uint16_t *>(buffer), false );
+      }
+    void SetRegionFromInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int32_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt32(), const_cast<int32_t *>(buffer), false );
+      }
+    void SetRegionFromUInt32( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint32_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt32(), const_cast<uint32_t *>(buffer), false );
+      }
+    void SetRegionFromInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const int64_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsInt64(), const_cast<int64_t *>(buffer), false );
+      }
+    void SetRegionFromUInt64( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const uint64_t *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsUInt64(), const_cast<uint64_t *>(buffer), false );
+      }
+    void SetRegionFromFloat( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const float *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsFloat(), const_cast<float *>(buffer), false );
+      }
+    void SetRegionFromDouble( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz, const double *buffer ) override
+      {
+        this->InternalCopyRegion( idx, sz, this->GetBufferAsDouble(), const_cast<double *>(buffer), false );
+      }
+
 
   protected:
 
+    // The number of buffer elements of the component type for each
+    // pixel, complex pixels are two elements.
+    unsigned int GetNumberOfBufferElementsPerPixel( ) const
+      {
+        using PixelIDType = typename ImageTypeToPixelID<ImageType>::PixelIDType;
+        if ( typelist2::has_type<ComplexPixelIDTypeList, PixelIDType>::value )
+          {
+          return 2;
+          }
+        return this->GetNumberOfComponentsPerPixel();
+      }
+
+    // Apply the index to physical point matrix to a flat array of indices
+    template <typename TIndexValueType>
+    void InternalTransformIndicesToPhysicalPoints( const std::vector<TIndexValueType> &indices,
+                                                   std::vector<double> &points ) const
+      {
+        constexpr unsigned int Dimension = ImageType::ImageDimension;
+
+        if ( indices.size() % Dimension != 0 )
+          {
+          sitkExceptionMacro( "The length of the array, " << indices.size()
+                              << ", is not a multiple of the image dimension " << Dimension << "." );
+          }
+
+        double matrix[Dimension][Dimension];
+        double origin[Dimension];
+        for ( unsigned int i = 0; i < Dimension; ++i )
+          {
+          origin[i] = this->m_Image->GetOrigin()[i];
+          for ( unsigned int j = 0; j < Dimension; ++j )
+            {
+            matrix[i][j] = this->m_Image->GetIndexToPhysicalPoint()[i][j];
+            }
+          }
+
+        const size_t numberOfPoints = indices.size() / Dimension;
+        const TIndexValueType *in = indices.data();
+        double *out = points.data();
+        for ( size_t p = 0; p < numberOfPoints; ++p, in += Dimension, out += Dimension )
+          {
+          for ( unsigned int i = 0; i < Dimension; ++i )
+            {
+            double sum = 0.0;
+            for ( unsigned int j = 0; j < Dimension; ++j )
+              {
+              sum += matrix[i][j] * in[j];
+              }
+            out[i] = origin[i] + sum;
+            }
+          }
+      }
+
+    // Apply the physical point to index matrix to a flat array of points
+    void InternalTransformPhysicalPointsToContinuousIndices( const std::vector<double> &points,
+                                                             std::vector<double> &cindices ) const
+      {
+        constexpr unsigned int Dimension = ImageType::ImageDimension;
+
+        if ( points.size() % Dimension != 0 )
+          {
+          sitkExceptionMacro( "The length of the array, " << points.size()
+                              << ", is not a multiple of the image dimension " << Dimension << "." );
+          }
+
+        double matrix[Dimension][Dimension];
+        double origin[Dimension];
+        for ( unsigned int i = 0; i < Dimension; ++i )
+          {
+          origin[i] = this->m_Image->GetOrigin()[i];
+          for ( unsigned int j = 0; j < Dimension; ++j )
+            {
+            matrix[i][j] = this->m_Image->GetPhysicalPointToIndex()[i][j];
+            }
+          }
+
+        const size_t numberOfPoints = points.size() / Dimension;
+        const double *in = points.data();
+        double *out = cindices.data();
+        for ( size_t p = 0; p < numberOfPoints; ++p, in += Dimension, out += Dimension )
+          {
+          double v[Dimension];
+          for ( unsigned int j = 0; j < Dimension; ++j )
+            {
+            v[j] = in[j] - origin[j];
+            }
+          for ( unsigned int i = 0; i < Dimension; ++i )
+            {
+            double sum = 0.0;
+            for ( unsigned int j = 0; j < Dimension; ++j )
+              {
+              sum += matrix[i][j] * v[j];
+              }
+            out[i] = sum;
+            }
+          }
+      }
+
+    // Copy a region between the image buffer and a contiguous
+    // buffer, scanline by scanline. When toBuffer is true the image
+    // is the source, otherwise the buffer is copied into the image.
+    template <typename TBufferType>
+    void InternalCopyRegion( const std::vector<uint32_t> &idx,
+                             const std::vector<uint32_t> &sz,
+                             const TBufferType *imageBuffer,
+                             TBufferType *buffer,
+                             bool toBuffer ) const
+      {
+        constexpr unsigned int Dimension = ImageType::ImageDimension;
+
+        if ( idx.size() < Dimension || sz.size() < Dimension )
+          {
+          sitkExceptionMacro( "The region index and size must have at least " << Dimension << " elements." );
+          }
+
+        const typename ImageType::SizeType imageSize = this->m_Image->GetLargestPossibleRegion().GetSize();
+
+        uint64_t numberOfLines = 1;
+        for ( unsigned int d = 0; d < Dimension; ++d )
+          {
+          if ( static_cast<uint64_t>(idx[d]) + sz[d] > imageSize[d] )
+            {
+            sitkExceptionMacro( "The region with index " << idx << " and size " << sz
+                                << " is outside the image of size " << imageSize << "!" );
+            }
+          if ( d > 0 )
+            {
+            numberOfLines *= sz[d];
+            }
+          }
+
+        if ( sz[0] == 0 || numberOfLines == 0 )
+          {
+          return;
+          }
+
+        const uint64_t elementsPerPixel = this->GetNumberOfBufferElementsPerPixel();
+        const uint64_t lineLength = sz[0] * elementsPerPixel;
+
+        // the offset of each dimension in the image buffer
+        uint64_t stride[Dimension];
+        stride[0] = elementsPerPixel;
+        for ( unsigned int d = 1; d < Dimension; ++d )
+          {
+          stride[d] = stride[d-1] * imageSize[d-1];
+          }
+
+        TBufferType *image = const_cast<TBufferType *>(imageBuffer);
+        uint32_t lineIndex[Dimension] = {0};
+
+        for ( uint64_t line = 0; line < numberOfLines; ++line )
+          {
+          uint64_t imageOffset = idx[0] * stride[0];
+          for ( unsigned int d = 1; d < Dimension; ++d )
+            {
+            imageOffset += ( idx[d] + lineIndex[d] ) * stride[d];
+            }
+
+          TBufferType *imageLine = image + imageOffset;
+          TBufferType *bufferLine = buffer + line * lineLength;
+          if ( toBuffer )
+            {
+            std::copy( imageLine, imageLine + lineLength, bufferLine );
+            }
+          else
+            {
+            std::copy( bufferLine, bufferLine + lineLength, imageLine );
+            }
+
+          for ( unsigned int d = 1; d < Dimension; ++d )
+            {
+            if ( ++lineIndex[d] < sz[d] )
+              {
+              break;
+              }
+            lineIndex[d] = 0;
+            }
+          }
+      }
+
     template <typename TPixelIDType>
     typename std::enable_if<!IsLabel<TPixelIDType>::Value
                                 && !typelist2::has_type<ComplexPixelIDTypeList, TPixelIDType>::value
@@ -740,6 +1157,121 @@ namespace itk
       sitkExceptionMacro("Interpolation is not supported for label pixel types.")
     }
 
+    // Convert an interpolated value to the flat array of doubles
+    static double *InternalCopyInterpolatedValue( double v, double *out )
+    {
+      *out = v;
+      return out + 1;
+    }
+
+    template <typename T>
+    static double *InternalCopyInterpolatedValue( const std::complex<T> &v, double *out )
+    {
+      out[0] = double(v.real());
+      out[1] = double(v.imag());
+      return out + 2;
+    }
+
+    template <typename T>
+    static double *InternalCopyInterpolatedValue( const itk::VariableLengthVector<T> &v, double *out )
+    {
+      return std::copy( v.GetDataPointer(), v.GetDataPointer() + v.Size(), out );
+    }
+
+    template <typename TPixelIDType>
+    typename std::enable_if<!IsLabel<TPixelIDType>::Value,
+                            std::vector<double> >::type
+    InternalEvaluateAtContinuousIndices( const std::vector<double> &indices, InterpolatorEnum interp ) const
+    {
+      constexpr unsigned int Dimension = ImageType::ImageDimension;
+      using ContinuousIndexType = itk::ContinuousIndex<double, Dimension>;
+      using InterpolatorType = itk::InterpolateImageFunction<ImageType, double>;
+
+      if ( indices.size() % Dimension != 0 )
+        {
+        sitkExceptionMacro( "The length of the array, " << indices.size()
+                            << ", is not a multiple of the image dimension " << Dimension << "." );
+        }
+
+      const size_t numberOfPoints = indices.size() / Dimension;
+      const typename ImageType::RegionType region = this->m_Image->GetLargestPossibleRegion();
+      for ( size_t p = 0; p < numberOfPoints; ++p )
+        {
+        ContinuousIndexType cidx;
+        std::copy( &indices[p*Dimension], &indices[p*Dimension] + Dimension, cidx.Begin() );
+        if ( ! region.IsInside( cidx ) )
+          {
+          sitkExceptionMacro("index " << cidx << " out of bounds");
+          }
+        }
+
+      typename InterpolatorType::Pointer itkInterpolator;
+        {
+        std::lock_guard<std::mutex> lock( m_InterpolatorMutex );
+        itkInterpolator = dynamic_cast<InterpolatorType *>( m_Interpolator.GetPointer() );
+        if ( itkInterpolator.IsNull()
+             || m_InterpolatorEnum != interp
+             || m_InterpolatorMTime < this->m_Image->GetMTime() )
+          {
+          itkInterpolator = CreateInterpolator(this->m_Image.GetPointer(), interp);
+          if (itkInterpolator == nullptr)
+            {
+            sitkExceptionMacro("Interpolator type \"" << interp << "\" does not support the pixel type "
+                               << GetPixelIDValueAsString( this->GetPixelID() ) << ".")
+            }
+          itkInterpolator->SetInputImage(this->m_Image.GetPointer());
+          m_Interpolator = itkInterpolator.GetPointer();
+          m_InterpolatorEnum = interp;
+          m_InterpolatorMTime = this->m_Image->GetMTime();
+          }
+        }
+
+      const unsigned int valuesPerPoint = this->GetNumberOfBufferElementsPerPixel();
+      std::vector<double> values( numberOfPoints * valuesPerPoint );
+
+      const InterpolatorType *constInterpolator = itkInterpolator.GetPointer();
+      auto evaluateRange = [&]( size_t begin, size_t end )
+        {
+          ContinuousIndexType cidx;
+          for ( size_t p = begin; p < end; ++p )
+            {
+            std::copy( &indices[p*Dimension], &indices[p*Dimension] + Dimension, cidx.Begin() );
+            InternalCopyInterpolatedValue( constInterpolator->EvaluateAtContinuousIndex( cidx ),
+                                           &values[p*valuesPerPoint] );
+            }
+        };
+
+      // split into chunks of points to amortize the threading overhead
+      constexpr size_t pointsPerChunk = 256;
+      const size_t numberOfChunks = ( numberOfPoints + pointsPerChunk - 1 ) / pointsPerChunk;
+      if ( numberOfChunks <= 1 )
+        {
+        evaluateRange( 0, numberOfPoints );
+        }
+      else
+        {
+        auto threader = itk::MultiThreaderBase::New();
+        threader->ParallelizeArray( 0, numberOfChunks,
+                                    [&]( itk::SizeValueType chunk )
+                                      {
+                                        const size_t begin = chunk * pointsPerChunk;
+                                        evaluateRange( begin, std::min( begin + pointsPerChunk, numberOfPoints ) );
+                                      },
+                                    nullptr );
+        }
+      return values;
+    }
+
+    template <typename TPixelIDType>
+    typename std::enable_if<IsLabel<TPixelIDType>::Value,
+                            std::vector<double> >::type
+    InternalEvaluateAtContinuousIndices( const std::vector<double> &indices, InterpolatorEnum interp ) const
+    {
+      Unused(indices);
+      Unused(interp);
+      sitkExceptionMacro("Interpolation is not supported for label pixel types.")
+    }
+
 
     template < typename TPixelIDType >
     typename std::enable_if<std::is_same<TPixelIDType, typename ImageTypeToPixelID<ImageType>::PixelIDType>::value
@@ -833,6 +1365,217 @@ namespace itk
         return true;
       }
 
+    // A view refers to the buffer of its parent, which is counted instead.
+    template< typename UImageType >
+    void
+    InternalRegisterBuffer(const UImageType *image)
+      {
+        using ViewContainerType = ImageViewContainer<typename UImageType::PixelContainer::Element>;
+        const itk::Object *buffer = image->GetPixelContainer();
+        uint64_t bytes = uint64_t(image->GetPixelContainer()->Size()) * sizeof(typename UImageType::PixelContainer::Element);
+        if ( auto view = dynamic_cast<const ViewContainerType *>( image->GetPixelContainer() ) )
+          {
+          buffer = view->GetParentBuffer();
+          bytes = view->GetParentBufferBytes();
+          }
+        if ( buffer != nullptr && bytes != 0 )
+          {
+          detail::RegisterImageBuffer( buffer, bytes );
+          this->m_Registration.reset( static_cast<const void *>(buffer),
+                                      [](const void *b) { detail::UnregisterImageBuffer( b ); } );
+          }
+      }
+
+    template< typename TLabelObject >
+    void
+    InternalRegisterBuffer(const itk::LabelMap<TLabelObject> *)
+      {
+      }
+
+    template< typename UImageType >
+    int
+    InternalGetViewParentReferenceCount(const UImageType *image) const
+      {
+        using ViewContainerType = ImageViewContainer<typename UImageType::PixelContainer::Element>;
+        auto view = dynamic_cast<const ViewContainerType *>( image->GetPixelContainer() );
+        return view ? view->GetParentReferenceCount() - 1 : 0;
+      }
+
+    template< typename TLabelObject >
+    int
+    InternalGetViewParentReferenceCount(const itk::LabelMap<TLabelObject> *) const
+      {
+        return 0;
+      }
+
+    template< typename UImageType >
+    int
+    InternalGetSharedBufferReferenceCount(const UImageType *image) const
+      {
+        const auto *container = image->GetPixelContainer();
+        return container ? container->GetReferenceCount() - 1 : 0;
+      }
+
+    template< typename TLabelObject >
+    int
+    InternalGetSharedBufferReferenceCount(const itk::LabelMap<TLabelObject> *) const
+      {
+        return 0;
+      }
+
+    template <typename UImageType>
+    typename std::enable_if<!IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    InternalGetSubImage( const std::vector<uint32_t> &idx, const std::vector<uint32_t> &sz ) const
+      {
+        constexpr unsigned int Dimension = ImageType::ImageDimension;
+        using ValueType = typename NumericTraits<typename ImageType::InternalPixelType>::ValueType;
+
+        if ( idx.size() < Dimension || sz.size() < Dimension )
+          {
+          sitkExceptionMacro( "The region index and size must have at least " << Dimension << " elements." );
+          }
+
+        const typename ImageType::SizeType imageSize = this->m_Image->GetLargestPossibleRegion().GetSize();
+        typename ImageType::IndexType index;
+        typename ImageType::SizeType size;
+        for ( unsigned int d = 0; d < Dimension; ++d )
+          {
+          if ( static_cast<uint64_t>(idx[d]) + sz[d] > imageSize[d] )
+            {
+            sitkExceptionMacro( "The region with index " << idx << " and size " << sz
+                                << " is outside the image of size " << imageSize << "!" );
+            }
+          index[d] = idx[d];
+          size[d] = sz[d];
+          }
+
+        typename ImageType::PointType origin;
+        this->m_Image->TransformIndexToPhysicalPoint( index, origin );
+
+        ImagePointer output = ImageType::New();
+        output->SetRegions( size );
+        output->SetOrigin( origin );
+        output->SetSpacing( this->m_Image->GetSpacing() );
+        output->SetDirection( this->m_Image->GetDirection() );
+        output->SetNumberOfComponentsPerPixel( this->m_Image->GetNumberOfComponentsPerPixel() );
+        output->SetMetaDataDictionary( this->m_Image->GetMetaDataDictionary() );
+
+        // The region is contiguous in the buffer when it spans the
+        // full extent of the dimensions before the first partial
+        // dimension, and has a size of one after it.
+        bool contiguous = true;
+        unsigned int d = 0;
+        while ( d < Dimension && size[d] == imageSize[d] )
+          {
+          ++d;
+          }
+        for ( ++d; d < Dimension; ++d )
+          {
+          contiguous = contiguous && size[d] == 1;
+          }
+
+        const size_t numberOfElements = output->GetLargestPossibleRegion().GetNumberOfPixels() * this->GetNumberOfBufferElementsPerPixel();
+        if ( contiguous && numberOfElements != 0 )
+          {
+          this->InternalSetViewContainer( output.GetPointer(), this->m_Image->ComputeOffset( index ) );
+          }
+        else
+          {
+          output->Allocate();
+          auto outputBuffer = reinterpret_cast<ValueType *>( output->GetPixelContainer()->GetBufferPointer() );
+          auto inputBuffer = reinterpret_cast<const ValueType *>( this->m_Image->GetPixelContainer()->GetBufferPointer() );
+          this->InternalCopyRegion( idx, sz, inputBuffer, outputBuffer, true );
+          }
+
+        return new Self( output.GetPointer() );
+      }
+
+    template <typename UImageType>
+    typename std::enable_if<IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    InternalGetSubImage( const std::vector<uint32_t> &, const std::vector<uint32_t> & ) const
+      {
+        sitkExceptionMacro( "This method is not supported for LabelMaps." )
+      }
+
+    // The output refers to this image's buffer from the offset of a
+    // pixel, and holds a reference to this image.
+    void InternalSetViewContainer( ImageType *output, size_t pixelOffset ) const
+      {
+        using ContainerType = ImageViewContainer<typename ImageType::PixelContainer::Element>;
+
+        // the container elements are complex for complex images, so
+        // only the vectors of a VectorImage span several elements
+        const size_t elementsPerPixel = this->GetNumberOfComponentsPerPixel();
+        const size_t offset = pixelOffset * elementsPerPixel;
+        auto *buffer = const_cast<typename ImageType::PixelContainer::Element *>( this->m_Image->GetPixelContainer()->GetBufferPointer() );
+
+        typename ContainerType::Pointer container = ContainerType::New();
+        const auto *parentBuffer = this->m_Image->GetPixelContainer();
+        container->SetParent( this->m_Image.GetPointer(),
+                              parentBuffer,
+                              uint64_t(parentBuffer->Size()) * sizeof(typename ImageType::PixelContainer::Element) );
+        container->SetImportPointer( buffer + offset,
+                                     output->GetLargestPossibleRegion().GetNumberOfPixels() * elementsPerPixel,
+                                     false );
+        output->SetPixelContainer( container );
+      }
+
+    template <typename UImageType>
+    typename std::enable_if<!IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    InternalGetReshapedView( const std::vector<uint32_t> &sz,
+                             const std::vector<double> &origin,
+                             const std::vector<double> &spacing,
+                             const std::vector<double> &direction ) const
+      {
+        constexpr unsigned int Dimension = ImageType::ImageDimension;
+
+        if ( sz.size() < Dimension )
+          {
+          sitkExceptionMacro( "The size must have at least " << Dimension << " elements." );
+          }
+
+        typename ImageType::SizeType size;
+        uint64_t numberOfPixels = 1;
+        for ( unsigned int d = 0; d < Dimension; ++d )
+          {
+          size[d] = sz[d];
+          numberOfPixels *= sz[d];
+          }
+        if ( numberOfPixels != this->m_Image->GetLargestPossibleRegion().GetNumberOfPixels() )
+          {
+          sitkExceptionMacro( "The size " << sz << " does not have the number of pixels of the image of size "
+                              << this->m_Image->GetLargestPossibleRegion().GetSize() << "!" );
+          }
+
+        ImagePointer output = ImageType::New();
+        output->SetRegions( size );
+        output->SetOrigin( sitkSTLVectorToITK<typename ImageType::PointType>( origin ) );
+        output->SetSpacing( sitkSTLVectorToITK<typename ImageType::SpacingType>( spacing ) );
+        output->SetDirection( sitkSTLToITKDirection<typename ImageType::DirectionType>( direction ) );
+        output->SetNumberOfComponentsPerPixel( this->m_Image->GetNumberOfComponentsPerPixel() );
+
+        if ( numberOfPixels != 0 )
+          {
+          this->InternalSetViewContainer( output.GetPointer(), 0 );
+          }
+        else
+          {
+          output->Allocate();
+          }
+
+        return new Self( output.GetPointer() );
+      }
+
+    template <typename UImageType>
+    typename std::enable_if<IsLabel<UImageType>::Value, PimpleImageBase*>::type
+    InternalGetReshapedView( const std::vector<uint32_t> &,
+                             const std::vector<double> &,
+                             const std::vector<double> &,
+                             const std::vector<double> & ) const
+      {
+        sitkExceptionMacro( "This method is not supported for LabelMaps." )
+      }
+
     template < typename TPixelIDType >
     typename std::enable_if<std::is_same<TPixelIDType, typename ImageTypeToPixelID<ImageType>::PixelIDType>::value
                       && !IsLabel<TPixelIDType>::Value
@@ -941,7 +1684,24 @@ namespace itk
       }
 
   private:
+    // construct a shallow copy of a validated image
+    PimpleImage ( ImageType* image, std::shared_ptr<const void> registration )
+      : m_Image( image ),
+        m_Registration( std::move(registration) )
+      {
+      }
+
     ImagePointer m_Image;
+
+    // the pixel container counted by the memory statistics, shared by
+    // the shallow copies
+    std::shared_ptr<const void> m_Registration;
+
+    // interpolator cached by the batch evaluation methods
+    mutable std::mutex m_InterpolatorMutex;
+    mutable itk::LightObject::Pointer m_Interpolator;
+    mutable InterpolatorEnum m_InterpolatorEnum{sitkNearestNeighbor};
+    mutable itk::ModifiedTimeType m_InterpolatorMTime{0};
   };
 
   }
@@ -44,7 +44,9 @@
 #include "itkBSplineSmoothingOnUpdateDisplacementFieldTransform.h"
 #include "itkGaussianSmoothingOnUpdateDisplacementFieldTransform.h"
 #include "itkBSplineTransform.h"
+#include "itkMultiThreaderBase.h"
 
+#include <algorithm>
 #include <type_traits>
 
 namespace itk
@@ -52,6 +54,27 @@ namespace itk
 namespace simple
 {
 
+// Call function( begin, end ) concurrently for blocks of the points.
+template <typename TFunction>
+void ParallelizeTransformPoints( size_t numberOfPoints, TFunction &&function )
+{
+  constexpr size_t BlockSize = 4096;
+  const size_t numberOfBlocks = ( numberOfPoints + BlockSize - 1 ) / BlockSize;
+  if ( numberOfBlocks <= 1 )
+    {
+    function( size_t(0), numberOfPoints );
+    return;
+    }
+
+  auto threader = itk::MultiThreaderBase::New();
+  threader->ParallelizeArray( 0, numberOfBlocks,
+                              [&]( itk::SizeValueType block ) {
+                                const size_t begin = block * BlockSize;
+                                function( begin, std::min( begin + BlockSize, numberOfPoints ) );
+                              },
+                              nullptr );
+}
+
 // This is a base class of the private implementation of the transform
 // class.
 //
@@ -167,6 +190,12 @@ public:
   virtual std::vector< double > TransformVector( const std::vector< double > &v,
                                                  const std::vector< double > &p) const = 0;
 
+  virtual void TransformPoints( const double *points, double *outputPoints, size_t numberOfPoints ) const = 0;
+  virtual void TransformVectors( const double *vectors,
+                                 const double *points,
+                                 double *outputVectors,
+                                 size_t numberOfVectors ) const = 0;
+
   virtual TransformEnum GetTransformEnum() const = 0;
 
 protected:
@@ -306,6 +335,95 @@ public:
       return sitkITKVectorToSTL<double>( this->m_Transform->TransformVector( itk_vec, itk_pt ) );
     }
 
+
+  void TransformPoints( const double *points, double *outputPoints, size_t numberOfPoints ) const override
+    {
+      using MatrixOffsetTransformType = itk::MatrixOffsetTransformBase<double, InputDimension, OutputDimension>;
+
+      if ( const auto *linear = dynamic_cast<const MatrixOffsetTransformType *>( this->m_Transform.GetPointer() ) )
+        {
+        // the matrix and the offset are looked up once, the loops over
+        // the dimensions are then unrolled and vectorized
+        const typename MatrixOffsetTransformType::MatrixType matrix = linear->GetMatrix();
+        const typename MatrixOffsetTransformType::OutputVectorType offset = linear->GetOffset();
+        ParallelizeTransformPoints( numberOfPoints, [&]( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i )
+              {
+              const double *pt = points + i * InputDimension;
+              double opt[OutputDimension];
+              for ( unsigned int r = 0; r < OutputDimension; ++r )
+                {
+                double value = offset[r];
+                for ( unsigned int c = 0; c < InputDimension; ++c )
+                  {
+                  value += matrix[r][c] * pt[c];
+                  }
+                opt[r] = value;
+                }
+              std::copy( opt, opt + OutputDimension, outputPoints + i * OutputDimension );
+              }
+          } );
+        return;
+        }
+
+      const TransformType *transform = this->m_Transform.GetPointer();
+      ParallelizeTransformPoints( numberOfPoints, [&]( size_t begin, size_t end ) {
+          typename TransformType::InputPointType pt;
+          for ( size_t i = begin; i < end; ++i )
+            {
+            std::copy( points + i * InputDimension, points + ( i + 1 ) * InputDimension, pt.Begin() );
+            const typename TransformType::OutputPointType opt = transform->TransformPoint( pt );
+            std::copy( opt.Begin(), opt.End(), outputPoints + i * OutputDimension );
+            }
+        } );
+    }
+
+
+  void TransformVectors( const double *vectors,
+                         const double *points,
+                         double *outputVectors,
+                         size_t numberOfVectors ) const override
+    {
+      using MatrixOffsetTransformType = itk::MatrixOffsetTransformBase<double, InputDimension, OutputDimension>;
+
+      if ( const auto *linear = dynamic_cast<const MatrixOffsetTransformType *>( this->m_Transform.GetPointer() ) )
+        {
+        // the vectors of a linear transform do not depend on the points
+        const typename MatrixOffsetTransformType::MatrixType matrix = linear->GetMatrix();
+        ParallelizeTransformPoints( numberOfVectors, [&]( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i )
+              {
+              const double *vec = vectors + i * InputDimension;
+              double ovec[OutputDimension];
+              for ( unsigned int r = 0; r < OutputDimension; ++r )
+                {
+                double value = 0.0;
+                for ( unsigned int c = 0; c < InputDimension; ++c )
+                  {
+                  value += matrix[r][c] * vec[c];
+                  }
+                ovec[r] = value;
+                }
+              std::copy( ovec, ovec + OutputDimension, outputVectors + i * OutputDimension );
+              }
+          } );
+        return;
+        }
+
+      const TransformType *transform = this->m_Transform.GetPointer();
+      ParallelizeTransformPoints( numberOfVectors, [&]( size_t begin, size_t end ) {
+          typename TransformType::InputVectorType vec;
+          typename TransformType::InputPointType pt;
+          for ( size_t i = begin; i < end; ++i )
+            {
+            std::copy( vectors + i * InputDimension, vectors + ( i + 1 ) * InputDimension, vec.Begin() );
+            std::copy( points + i * InputDimension, points + ( i + 1 ) * InputDimension, pt.Begin() );
+            const typename TransformType::OutputVectorType ovec = transform->TransformVector( vec, pt );
+            std::copy( ovec.Begin(), ovec.End(), outputVectors + i * OutputDimension );
+            }
+        } );
+    }
+
   TransformEnum GetTransformEnum() const override { return GetTransformEnum(this->m_Transform.GetPointer());}
 
   template <typename VScalar, unsigned int VDimension>
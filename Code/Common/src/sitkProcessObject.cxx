@@ -21,13 +21,26 @@
 #include "itkProcessObject.h"
 #include "itkCommand.h"
 #include "sitkFunctionCommand.h"
+#include "sitkImageBufferAllocator.h"
+#include "sitkNUMA.h"
+#include "sitkInstructionSet.h"
+#include "sitkExecutionLog.h"
+#include "sitkMemoryStatistics.h"
+#include "sitkTraceRange.h"
 #include "itkImageToImageFilter.h"
+#include "itkVectorImage.h"
 #include "itkTextOutput.h"
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <complex>
 #include <cstring>
+#include <fstream>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace itk {
 namespace simple {
@@ -35,6 +48,10 @@ namespace simple {
 namespace
 {
 static bool GlobalDefaultDebug = false;
+static std::atomic<bool> GlobalMetaDataPropagation( true );
+
+static std::mutex GlobalDefaultExecutorMutex;
+static std::unique_ptr<Executor> GlobalDefaultExecutor;
 
 static itk::AnyEvent eventAnyEvent;
 static itk::AbortEvent eventAbortEvent;
@@ -67,19 +84,26 @@ public:
       m_That=cmd;
     }
 
+  /** Only invoke the command for progress events which are at least
+   * the interval in seconds and the progress delta after the last
+   * invoked event. */
+  void SetProgressLimits( double minimumInterval, float minimumProgressDelta )
+    {
+      m_MinimumInterval = std::chrono::duration<double>(minimumInterval);
+      m_MinimumProgressDelta = minimumProgressDelta;
+      m_Limited = minimumInterval > 0.0 || minimumProgressDelta > 0.0f;
+    }
+
   /**  Invoke the member function. */
-  void Execute(Object *, const EventObject & ) override
+  void Execute(Object *caller, const EventObject & event) override
   {
-    if (m_That)
-      {
-      m_That->Execute();
-      }
+    this->Execute(const_cast<const Object *>(caller), event);
   }
 
   /**  Invoke the member function with a const object */
-  void Execute(const Object *, const EventObject & ) override
+  void Execute(const Object *caller, const EventObject & event) override
   {
-    if ( m_That )
+    if ( m_That && ( !m_Limited || this->IsDelivered(caller, event) ) )
       {
       m_That->Execute();
       }
@@ -89,11 +113,208 @@ public:
   void operator=(const Self &) = delete;
 
 protected:
+
+  bool IsDelivered(const Object *caller, const EventObject & event)
+  {
+    const auto *process = dynamic_cast<const itk::ProcessObject *>(caller);
+    if ( process == nullptr || !eventProgressEvent.CheckEvent(&event) )
+      {
+      return true;
+      }
+
+    const float progress = process->GetProgress();
+    const auto now = std::chrono::steady_clock::now();
+    if ( m_Delivered
+         && progress < 1.0f
+         && progress >= m_LastProgress
+         && ( progress - m_LastProgress < m_MinimumProgressDelta
+              || now - m_LastTime < m_MinimumInterval ) )
+      {
+      return false;
+      }
+    m_Delivered = true;
+    m_LastProgress = progress;
+    m_LastTime = now;
+    return true;
+  }
+
   itk::simple::Command *                    m_That{nullptr};
+
+  bool                                      m_Limited{false};
+  std::chrono::duration<double>             m_MinimumInterval{0.0};
+  float                                     m_MinimumProgressDelta{0.0f};
+  bool                                      m_Delivered{false};
+  float                                     m_LastProgress{0.0f};
+  std::chrono::steady_clock::time_point     m_LastTime;
+
   SimpleAdaptorCommand() = default;
   ~SimpleAdaptorCommand() override = default;
 };
 
+
+// Writes complete events in the Chrome trace event format.
+class TraceSink
+{
+public:
+  explicit TraceSink(const std::string &fileName)
+    : m_FileName(fileName),
+      m_Stream(fileName.c_str(), std::ios::out | std::ios::trunc),
+      m_Epoch(std::chrono::steady_clock::now())
+    {
+      if ( !m_Stream )
+        {
+        sitkExceptionMacro("Unable to open trace file \"" << fileName << "\"!");
+        }
+      m_Stream << "[";
+    }
+
+  ~TraceSink()
+    {
+      m_Stream << "\n]\n";
+    }
+
+  const std::string &GetFileName() const
+    {
+      return m_FileName;
+    }
+
+  void WriteEvent( const std::string &name,
+                   std::chrono::steady_clock::time_point start,
+                   std::chrono::steady_clock::time_point end,
+                   double cpuTime,
+                   unsigned int numberOfThreads,
+                   uint64_t bytesAllocated )
+    {
+      using std::chrono::duration_cast;
+      using std::chrono::microseconds;
+
+      auto tid = m_ThreadIds.insert(std::make_pair(std::this_thread::get_id(), m_ThreadIds.size()+1)).first->second;
+
+      m_Stream << (m_NumberOfEvents++ ? ",\n" : "\n")
+               << "{\"name\":\"" << name << "\",\"cat\":\"SimpleITK\",\"ph\":\"X\""
+               << ",\"ts\":" << duration_cast<microseconds>(start - m_Epoch).count()
+               << ",\"dur\":" << duration_cast<microseconds>(end - start).count()
+               << ",\"pid\":1,\"tid\":" << tid
+               << ",\"args\":{\"cpu_time_us\":" << static_cast<int64_t>(cpuTime*1e6)
+               << ",\"threads\":" << numberOfThreads
+               << ",\"bytes_allocated\":" << bytesAllocated << "}}";
+      // keep the file usable if the process terminates
+      m_Stream.flush();
+    }
+
+private:
+  std::string m_FileName;
+  std::ofstream m_Stream;
+  std::chrono::steady_clock::time_point m_Epoch;
+  std::map<std::thread::id, size_t> m_ThreadIds;
+  uint64_t m_NumberOfEvents{0};
+};
+
+static std::mutex GlobalTraceMutex;
+static std::unique_ptr<TraceSink> GlobalTrace;
+
+
+// Get the pixel buffer and its size for the image types of SimpleITK.
+template <unsigned int VDimension, typename TPixel>
+bool GetImageBufferHelper( const itk::DataObject *obj, const void *&buffer, uint64_t &bytes )
+{
+  if ( auto img = dynamic_cast<const itk::Image<TPixel, VDimension> *>(obj) )
+    {
+    buffer = img->GetBufferPointer();
+    bytes = img->GetPixelContainer()->Size() * sizeof(TPixel);
+    return true;
+    }
+  if ( auto img = dynamic_cast<const itk::VectorImage<TPixel, VDimension> *>(obj) )
+    {
+    buffer = img->GetBufferPointer();
+    bytes = img->GetPixelContainer()->Size() * sizeof(TPixel);
+    return true;
+    }
+  return false;
+}
+
+template <unsigned int VDimension, typename... TPixels>
+bool GetImageBufferOfDimension( const itk::DataObject *obj, const void *&buffer, uint64_t &bytes )
+{
+  bool found = false;
+  (void)std::initializer_list<int>{ ( found = found || GetImageBufferHelper<VDimension, TPixels>(obj, buffer, bytes), 0 )... };
+  return found;
+}
+
+template <unsigned int VDimension>
+bool GetImageBuffer( const itk::DataObject *obj, const void *&buffer, uint64_t &bytes )
+{
+  return GetImageBufferOfDimension<VDimension, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
+                                   int64_t, uint64_t, float, double,
+                                   std::complex<float>, std::complex<double> >(obj, buffer, bytes)
+    || GetImageBuffer<VDimension+1>(obj, buffer, bytes);
+}
+
+template <>
+bool GetImageBuffer<SITK_MAX_DIMENSION+1>( const itk::DataObject *, const void *&, uint64_t & )
+{
+  return false;
+}
+
+// Get the size of the buffered region of an image of SimpleITK's dimensions.
+template <unsigned int VDimension>
+bool GetImageSize( const itk::DataObject *obj, uint32_t *size, uint32_t &dimension )
+{
+  if ( auto img = dynamic_cast<const itk::ImageBase<VDimension> *>(obj) )
+    {
+    const auto &regionSize = img->GetBufferedRegion().GetSize();
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      size[d] = static_cast<uint32_t>(regionSize[d]);
+      }
+    dimension = VDimension;
+    return true;
+    }
+  return GetImageSize<VDimension+1>(obj, size, dimension);
+}
+
+template <>
+bool GetImageSize<SITK_MAX_DIMENSION+1>( const itk::DataObject *, uint32_t *, uint32_t & )
+{
+  return false;
+}
+
+void CopyTruncated( const std::string &text, char *destination, size_t size )
+{
+  const size_t length = std::min( text.size(), size - 1 );
+  std::copy( text.begin(), text.begin() + length, destination );
+  destination[length] = '\0';
+}
+
+
+// The bytes of the output images buffers which are not an input's buffer.
+uint64_t GetOutputBytesAllocated( itk::ProcessObject *p )
+{
+  std::vector<const void *> inputBuffers;
+  for ( const auto & input : p->GetInputs() )
+    {
+    const void *buffer = nullptr;
+    uint64_t bytes = 0;
+    if ( input && GetImageBuffer<2>(input, buffer, bytes) )
+      {
+      inputBuffers.push_back(buffer);
+      }
+    }
+
+  uint64_t total = 0;
+  for ( const auto & output : p->GetOutputs() )
+    {
+    const void *buffer = nullptr;
+    uint64_t bytes = 0;
+    if ( output && GetImageBuffer<2>(output, buffer, bytes)
+         && std::find(inputBuffers.begin(), inputBuffers.end(), buffer) == inputBuffers.end() )
+      {
+      total += bytes;
+      }
+    }
+  return total;
+}
+
 } // end anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -105,6 +326,15 @@ ProcessObject::ProcessObject ()
   : m_Debug(ProcessObject::GetGlobalDefaultDebug()),
     m_NumberOfThreads(itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads()),
     m_NumberOfWorkUnits(0),
+    m_ActiveExecutorThreads(0),
+    m_ExecutionStarted(false),
+    m_ExecutionStartCPUTime(0),
+    m_UpdateStartCPUTime(0),
+    m_LastExecutionWallTime(0.0),
+    m_LastExecutionCPUTime(0.0),
+    m_LastExecutionNumberOfThreads(0),
+    m_LastExecutionBytesAllocated(0),
+    m_ActiveProcessTraceRange(false),
     m_ActiveProcess(nullptr),
     m_ProgressMeasurement(0.0)
 {
@@ -117,6 +347,12 @@ ProcessObject::ProcessObject ()
       }
     firstTime = false;
     }
+
+  std::lock_guard<std::mutex> lock(GlobalDefaultExecutorMutex);
+  if (GlobalDefaultExecutor)
+    {
+    m_Executor.reset(new Executor(*GlobalDefaultExecutor));
+    }
 }
 
 
@@ -127,6 +363,12 @@ ProcessObject::~ProcessObject ()
 {
   // ensure to remove reference between sitk commands and process object
   Self::RemoveAllCommands();
+  this->ReleaseExecutorThreads();
+}
+
+bool ProcessObject::CanRunInPlace() const
+{
+  return false;
 }
 
 std::string ProcessObject::ToString() const
@@ -256,6 +498,30 @@ void ProcessObject::SetGlobalWarningDisplay(bool flag)
 }
 
 
+void ProcessObject::GlobalMetaDataPropagationOn()
+{
+  GlobalMetaDataPropagation = true;
+}
+
+
+void ProcessObject::GlobalMetaDataPropagationOff()
+{
+  GlobalMetaDataPropagation = false;
+}
+
+
+void ProcessObject::SetGlobalMetaDataPropagation(bool flag)
+{
+  GlobalMetaDataPropagation = flag;
+}
+
+
+bool ProcessObject::GetGlobalMetaDataPropagation()
+{
+  return GlobalMetaDataPropagation;
+}
+
+
 double ProcessObject::GetGlobalDefaultCoordinateTolerance()
 {
   return itk::ImageToImageFilterCommon::GetGlobalDefaultCoordinateTolerance();
@@ -308,6 +574,56 @@ std::string ProcessObject::GetGlobalDefaultThreader()
   return itk::MultiThreaderBase::ThreaderTypeToString(threaderEnum);
 }
 
+bool ProcessObject::SetGlobalDefaultImageBufferAllocator(const std::string &allocator)
+{
+  return detail::SetImageBufferAllocator(allocator);
+}
+
+std::string ProcessObject::GetGlobalDefaultImageBufferAllocator()
+{
+  return detail::GetImageBufferAllocator();
+}
+
+uint64_t ProcessObject::GetGlobalImageBufferBytesAllocated()
+{
+  return detail::GetImageBufferBytesAllocated();
+}
+
+uint64_t ProcessObject::GetGlobalImageBufferBytesReused()
+{
+  return detail::GetImageBufferBytesReused();
+}
+
+bool ProcessObject::SetGlobalDefaultNUMAPolicy(const std::string &policy)
+{
+  return detail::SetNUMAPolicy(policy);
+}
+
+std::string ProcessObject::GetGlobalDefaultNUMAPolicy()
+{
+  return detail::GetNUMAPolicy();
+}
+
+unsigned int ProcessObject::GetNumberOfNUMANodes()
+{
+  return detail::GetNumberOfNUMANodes();
+}
+
+std::vector<unsigned int> ProcessObject::GetNUMANodeCPUs(unsigned int node)
+{
+  return detail::GetNUMANodeCPUs(node);
+}
+
+bool ProcessObject::SetGlobalDefaultInstructionSet(const std::string &instructionSet)
+{
+  return detail::SetInstructionSet(instructionSet);
+}
+
+std::string ProcessObject::GetGlobalDefaultInstructionSet()
+{
+  return detail::GetInstructionSetName();
+}
+
 
 void ProcessObject::SetNumberOfThreads(unsigned int n)
 {
@@ -333,10 +649,177 @@ unsigned int ProcessObject::GetNumberOfWorkUnits() const
 }
 
 
+void ProcessObject::SetExecutor(const Executor &executor)
+{
+  m_Executor.reset(new Executor(executor));
+}
+
+
+Executor ProcessObject::GetExecutor() const
+{
+  if (!m_Executor)
+    {
+    sitkExceptionMacro("No executor is set.");
+    }
+  return *m_Executor;
+}
+
+
+bool ProcessObject::HasExecutor() const
+{
+  return bool(m_Executor);
+}
+
+
+void ProcessObject::RemoveExecutor()
+{
+  m_Executor.reset();
+}
+
+
+void ProcessObject::SetCancellationToken(const CancellationToken &token)
+{
+  m_CancellationToken.reset(new CancellationToken(token));
+}
+
+
+CancellationToken ProcessObject::GetCancellationToken() const
+{
+  if (!m_CancellationToken)
+    {
+    sitkExceptionMacro("No cancellation token is set.");
+    }
+  return *m_CancellationToken;
+}
+
+
+bool ProcessObject::HasCancellationToken() const
+{
+  return bool(m_CancellationToken);
+}
+
+
+void ProcessObject::RemoveCancellationToken()
+{
+  m_CancellationToken.reset();
+}
+
+
+void ProcessObject::SetGlobalDefaultExecutor(const Executor &executor)
+{
+  std::lock_guard<std::mutex> lock(GlobalDefaultExecutorMutex);
+  GlobalDefaultExecutor.reset(new Executor(executor));
+}
+
+
+Executor ProcessObject::GetGlobalDefaultExecutor()
+{
+  std::lock_guard<std::mutex> lock(GlobalDefaultExecutorMutex);
+  if (!GlobalDefaultExecutor)
+    {
+    sitkExceptionMacro("No global default executor is set.");
+    }
+  return *GlobalDefaultExecutor;
+}
+
+
+bool ProcessObject::HasGlobalDefaultExecutor()
+{
+  std::lock_guard<std::mutex> lock(GlobalDefaultExecutorMutex);
+  return bool(GlobalDefaultExecutor);
+}
+
+
+void ProcessObject::RemoveGlobalDefaultExecutor()
+{
+  std::lock_guard<std::mutex> lock(GlobalDefaultExecutorMutex);
+  GlobalDefaultExecutor.reset();
+}
+
+
+double ProcessObject::GetLastExecutionWallTime() const
+{
+  return this->m_LastExecutionWallTime;
+}
+
+double ProcessObject::GetLastExecutionCPUTime() const
+{
+  return this->m_LastExecutionCPUTime;
+}
+
+unsigned int ProcessObject::GetLastExecutionNumberOfThreads() const
+{
+  return this->m_LastExecutionNumberOfThreads;
+}
+
+uint64_t ProcessObject::GetLastExecutionBytesAllocated() const
+{
+  return this->m_LastExecutionBytesAllocated;
+}
+
+
+void ProcessObject::SetGlobalTraceFileName(const std::string &fileName)
+{
+  std::lock_guard<std::mutex> lock(GlobalTraceMutex);
+  // complete the current file before a new one is opened
+  GlobalTrace.reset();
+  if ( !fileName.empty() )
+    {
+    GlobalTrace.reset(new TraceSink(fileName));
+    }
+}
+
+std::string ProcessObject::GetGlobalTraceFileName()
+{
+  std::lock_guard<std::mutex> lock(GlobalTraceMutex);
+  if ( GlobalTrace )
+    {
+    return GlobalTrace->GetFileName();
+    }
+  return std::string();
+}
+
+
+void ProcessObject::SetGlobalExecutionLogCapacity(unsigned int capacity)
+{
+  detail::SetExecutionLogCapacity(capacity);
+}
+
+unsigned int ProcessObject::GetGlobalExecutionLogCapacity()
+{
+  return detail::GetExecutionLogCapacity();
+}
+
+std::string ProcessObject::GetGlobalExecutionLog()
+{
+  return detail::GetExecutionLog();
+}
+
+void ProcessObject::ClearGlobalExecutionLog()
+{
+  detail::ClearExecutionLog();
+}
+
+void ProcessObject::SetGlobalExecutionLogCrashFileName(const std::string &fileName)
+{
+  detail::SetExecutionLogCrashFileName(fileName);
+}
+
+std::string ProcessObject::GetGlobalExecutionLogCrashFileName()
+{
+  return detail::GetExecutionLogCrashFileName();
+}
+
+
 int ProcessObject::AddCommand(EventEnum event, Command &cmd)
+{
+  return this->AddCommand(event, cmd, 0.0, 0.0f);
+}
+
+int ProcessObject::AddCommand(EventEnum event, Command &cmd, double minimumInterval, float minimumProgressDelta)
 {
   // add to our list of event, command pairs
-  m_Commands.emplace_back(event,&cmd);
+  m_Commands.emplace_back(event, &cmd, minimumInterval, minimumProgressDelta);
 
   // register ourselves with the command
   cmd.AddProcessObject(this);
@@ -354,11 +837,17 @@ int ProcessObject::AddCommand(EventEnum event, Command &cmd)
 }
 
 int ProcessObject::AddCommand(itk::simple::EventEnum event, const std::function<void()> &func)
+{
+  return this->AddCommand(event, func, 0.0, 0.0f);
+}
+
+int ProcessObject::AddCommand(itk::simple::EventEnum event, const std::function<void()> &func,
+                              double minimumInterval, float minimumProgressDelta)
 {
   std::unique_ptr<FunctionCommand> cmd(new FunctionCommand());
   cmd->SetCallbackFunction(func);
 
-  int id = this->AddCommand(event, *cmd.get());
+  int id = this->AddCommand(event, *cmd.get(), minimumInterval, minimumProgressDelta);
   cmd->OwnedByObjectsOn();
   cmd.release();
   return id;
@@ -441,9 +930,41 @@ void ProcessObject::PreUpdate(itk::ProcessObject *p)
     {
     this->m_ActiveProcess = p;
 
+    this->ReleaseExecutorThreads();
+    if ( this->m_Executor )
+      {
+      this->m_ActiveExecutorThreads = this->m_Executor->AcquireThreads(this->GetNumberOfThreads());
+      this->m_ActiveExecutor.reset(new Executor(*this->m_Executor));
+      p->GetMultiThreader()->SetMaximumNumberOfThreads(this->m_ActiveExecutorThreads);
+      }
+
     // add command on active process deletion
     p->AddObserver(eventDeleteEvent, [this](const itk::EventObject &) {this->OnActiveProcessDelete();});
 
+    this->ThrowIfCancelled();
+
+    // measure the updates of the active process
+    this->m_ExecutionStarted = false;
+    this->m_LastExecutionWallTime = 0.0;
+    this->m_LastExecutionCPUTime = 0.0;
+    this->m_LastExecutionNumberOfThreads = 0;
+    this->m_LastExecutionBytesAllocated = 0;
+    p->AddObserver(eventStartEvent, [this, p](const itk::EventObject &) {this->OnActiveProcessStart(p);});
+    p->AddObserver(eventEndEvent, [this, p](const itk::EventObject &) {this->OnActiveProcessEnd(p);});
+
+    // abort the active process when cancelled
+    if ( this->m_CancellationToken )
+      {
+      auto abortIfCancelled = [this, p](const itk::EventObject &) {
+        if ( this->IsCancelled() )
+          {
+          p->AbortGenerateDataOn();
+          }
+      };
+      p->AddObserver(eventProgressEvent, abortIfCancelled);
+      p->AddObserver(eventIterationEvent, abortIfCancelled);
+      }
+
     // register commands
     for (auto &eventCommand: m_Commands )
       {
@@ -454,10 +975,17 @@ void ProcessObject::PreUpdate(itk::ProcessObject *p)
   catch (...)
     {
     this->m_ActiveProcess = nullptr;
+    this->ReleaseExecutorThreads();
     throw;
     }
 
+  if ( this->m_ActiveExecutor )
+    {
+    sitkDebugMacro( "Executor granted " << this->m_ActiveExecutorThreads << " of "
+                    << this->GetNumberOfThreads() << " requested threads." );
+    }
   sitkDebugMacro( "Executing ITK filter:\n" << *p );
+  sitkDebugMacro( "Image memory statistics: " << GetMemoryStatistics() );
 
 }
 
@@ -535,6 +1063,129 @@ void ProcessObject::OnActiveProcessDelete( )
       }
 
   this->m_ActiveProcess = nullptr;
+  this->ReleaseExecutorThreads();
+
+  // the end event is not invoked when the update throws
+  this->EndActiveProcessTraceRange();
+}
+
+
+bool ProcessObject::IsCancelled( ) const
+{
+  return this->m_CancellationToken && this->m_CancellationToken->IsCancelled();
+}
+
+
+void ProcessObject::ThrowIfCancelled( ) const
+{
+  if ( this->IsCancelled() )
+    {
+    sitkExceptionMacro("The execution of \"" << this->GetName() << "\" was cancelled.");
+    }
+}
+
+
+void ProcessObject::OnActiveProcessStart( itk::ProcessObject *p )
+{
+  this->m_UpdateStartTime = std::chrono::steady_clock::now();
+  this->m_UpdateStartCPUTime = std::clock();
+  if ( !this->m_ExecutionStarted )
+    {
+    this->m_ExecutionStarted = true;
+    this->m_ExecutionStartTime = this->m_UpdateStartTime;
+    this->m_ExecutionStartCPUTime = this->m_UpdateStartCPUTime;
+    }
+  this->m_LastExecutionNumberOfThreads = std::max( this->m_LastExecutionNumberOfThreads,
+                                                   p->GetMultiThreader()->GetMaximumNumberOfThreads() );
+
+  if ( detail::IsTraceRangeEnabled() )
+    {
+    this->EndActiveProcessTraceRange();
+    detail::TraceRange::Begin( this->GetName() + "::Update", p->GetNameOfClass() );
+    this->m_ActiveProcessTraceRange = true;
+    }
+}
+
+
+void ProcessObject::EndActiveProcessTraceRange()
+{
+  if ( this->m_ActiveProcessTraceRange )
+    {
+    detail::TraceRange::End();
+    this->m_ActiveProcessTraceRange = false;
+    }
+}
+
+
+void ProcessObject::OnActiveProcessEnd( itk::ProcessObject *p )
+{
+  this->EndActiveProcessTraceRange();
+
+  if ( !this->m_ExecutionStarted )
+    {
+    return;
+    }
+
+  const auto endTime = std::chrono::steady_clock::now();
+  const std::clock_t endCPUTime = std::clock();
+  const uint64_t bytesAllocated = GetOutputBytesAllocated(p);
+
+  this->m_LastExecutionWallTime = std::chrono::duration<double>(endTime - this->m_ExecutionStartTime).count();
+  this->m_LastExecutionCPUTime = double(endCPUTime - this->m_ExecutionStartCPUTime) / CLOCKS_PER_SEC;
+  this->m_LastExecutionBytesAllocated += bytesAllocated;
+
+  sitkDebugMacro( "Execution wall time: " << this->m_LastExecutionWallTime
+                  << "s CPU time: " << this->m_LastExecutionCPUTime
+                  << "s threads: " << this->m_LastExecutionNumberOfThreads
+                  << " bytes allocated: " << this->m_LastExecutionBytesAllocated );
+
+  if ( detail::IsExecutionLogEnabled() )
+    {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    detail::ExecutionLogEntry entry;
+    entry.endTime = duration_cast<microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    entry.wallTime = duration_cast<microseconds>(endTime - this->m_UpdateStartTime).count();
+    entry.cpuTime = static_cast<int64_t>(double(endCPUTime - this->m_UpdateStartCPUTime) / CLOCKS_PER_SEC * 1e6);
+    entry.threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    entry.numberOfThreads = p->GetMultiThreader()->GetMaximumNumberOfThreads();
+    entry.bytesAllocated = bytesAllocated;
+    if ( p->GetNumberOfInputs() > 0 )
+      {
+      GetImageSize<2>(p->GetInputs()[0], entry.inputSize, entry.inputDimension);
+      }
+    if ( p->GetNumberOfOutputs() > 0 )
+      {
+      GetImageSize<2>(p->GetOutputs()[0], entry.outputSize, entry.outputDimension);
+      }
+    CopyTruncated(this->GetName(), entry.name, sizeof(entry.name));
+    CopyTruncated(p->GetNameOfClass(), entry.itkName, sizeof(entry.itkName));
+    CopyTruncated(this->ToString(), entry.parameters, sizeof(entry.parameters));
+    detail::RecordExecution(entry);
+    }
+
+  std::lock_guard<std::mutex> lock(GlobalTraceMutex);
+  if ( GlobalTrace )
+    {
+    GlobalTrace->WriteEvent( this->GetName(),
+                             this->m_UpdateStartTime,
+                             endTime,
+                             double(endCPUTime - this->m_UpdateStartCPUTime) / CLOCKS_PER_SEC,
+                             p->GetMultiThreader()->GetMaximumNumberOfThreads(),
+                             bytesAllocated );
+    }
+}
+
+
+void ProcessObject::ReleaseExecutorThreads() noexcept
+{
+  if ( this->m_ActiveExecutor )
+    {
+    this->m_ActiveExecutor->ReleaseThreads(this->m_ActiveExecutorThreads);
+    this->m_ActiveExecutor.reset();
+    this->m_ActiveExecutorThreads = 0;
+    }
 }
 
 
@@ -575,6 +1226,7 @@ unsigned long ProcessObject::AddObserverToActiveProcessObject( EventCommand &eve
   // adapt sitk command to itk command
   SimpleAdaptorCommand::Pointer itkCommand = SimpleAdaptorCommand::New();
   itkCommand->SetSimpleCommand(eventCommand.m_Command);
+  itkCommand->SetProgressLimits(eventCommand.m_MinimumInterval, eventCommand.m_MinimumProgressDelta);
   itkCommand->SetObjectName(eventCommand.m_Command->GetName()+" "+itkEvent.GetEventName());
 
   return eventCommand.m_ITKTag = this->AddITKObserver( itkEvent, itkCommand );
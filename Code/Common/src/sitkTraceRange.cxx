@@ -0,0 +1,209 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkTraceRange.h"
+#include "sitkImage.h"
+#include "sitkProcessObject.h"
+
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <vector>
+
+#if defined( SITK_TRACE_RANGE_ITT )
+#include <ittnotify.h>
+#include <map>
+#include <mutex>
+#elif defined( SITK_TRACE_RANGE_NVTX )
+#include <nvtx3/nvToolsExt.h>
+#elif defined( SITK_TRACE_RANGE_TRACY )
+#include <tracy/TracyC.h>
+#include <vector>
+#endif
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+
+#if defined( SITK_TRACE_RANGE_ITT )
+
+__itt_domain *GetDomain()
+{
+  static __itt_domain *domain = __itt_domain_create( "SimpleITK" );
+  return domain;
+}
+
+// The API expects a handle to be created once for each name.
+__itt_string_handle *GetStringHandle( const std::string &name )
+{
+  static std::mutex mutex;
+  static std::map<std::string, __itt_string_handle *> handles;
+
+  std::lock_guard<std::mutex> lock( mutex );
+  auto iter = handles.find( name );
+  if ( iter == handles.end() )
+    {
+    iter = handles.emplace( name, __itt_string_handle_create( name.c_str() ) ).first;
+    }
+  return iter->second;
+}
+
+void BeginBackend( const std::string &name, const std::string &details )
+{
+  __itt_domain *domain = GetDomain();
+  __itt_task_begin( domain, __itt_null, __itt_null, GetStringHandle( name ) );
+  if ( !details.empty() )
+    {
+    static __itt_string_handle *detailsKey = __itt_string_handle_create( "details" );
+    __itt_metadata_str_add( domain, __itt_null, detailsKey, details.c_str(), details.size() );
+    }
+}
+
+void EndBackend()
+{
+  __itt_task_end( GetDomain() );
+}
+
+#elif defined( SITK_TRACE_RANGE_NVTX )
+
+nvtxDomainHandle_t GetDomain()
+{
+  static nvtxDomainHandle_t domain = nvtxDomainCreateA( "SimpleITK" );
+  return domain;
+}
+
+void BeginBackend( const std::string &name, const std::string &details )
+{
+  const std::string message = details.empty() ? name : name + " " + details;
+
+  nvtxEventAttributes_t attributes = {};
+  attributes.version = NVTX_VERSION;
+  attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+  attributes.messageType = NVTX_MESSAGE_TYPE_ASCII;
+  attributes.message.ascii = message.c_str();
+  nvtxDomainRangePushEx( GetDomain(), &attributes );
+}
+
+void EndBackend()
+{
+  nvtxDomainRangePop( GetDomain() );
+}
+
+#elif defined( SITK_TRACE_RANGE_TRACY )
+
+// The zones of the thread, the C API ends a zone by its context.
+thread_local std::vector<TracyCZoneCtx> Zones;
+
+void BeginBackend( const std::string &name, const std::string &details )
+{
+  static const struct ___tracy_source_location_data location = { "SimpleITK", __func__, __FILE__, static_cast<uint32_t>( __LINE__ ), 0 };
+
+  TracyCZoneCtx ctx = ___tracy_emit_zone_begin( &location, 1 );
+  ___tracy_emit_zone_name( ctx, name.c_str(), name.size() );
+  if ( !details.empty() )
+    {
+    ___tracy_emit_zone_text( ctx, details.c_str(), details.size() );
+    }
+  Zones.push_back( ctx );
+}
+
+void EndBackend()
+{
+  if ( !Zones.empty() )
+    {
+    ___tracy_emit_zone_end( Zones.back() );
+    Zones.pop_back();
+    }
+}
+
+#else
+
+void BeginBackend( const std::string &, const std::string & )
+{
+}
+
+void EndBackend()
+{
+}
+
+#endif
+
+
+std::string GetImageDetails( const Image &image )
+{
+  std::ostringstream details;
+  details << image.GetPixelIDTypeAsString() << " ";
+
+  const std::vector<unsigned int> size = image.GetSize();
+  for ( size_t i = 0; i < size.size(); ++i )
+    {
+    details << ( i ? "x" : "" ) << size[i];
+    }
+  return details.str();
+}
+
+}
+
+
+#if defined( SITK_TRACE_RANGES )
+bool GetTraceRangeEnabledFromEnvironment()
+{
+  std::string value;
+  if ( !itksys::SystemTools::GetEnv( "SITK_TRACE_RANGES", value ) )
+    {
+    return false;
+    }
+  std::transform( value.begin(), value.end(), value.begin(), []( unsigned char c ) { return std::toupper( c ); } );
+  return !( value.empty() || value == "0" || value == "OFF" || value == "FALSE" || value == "NO" );
+}
+#endif
+
+
+void TraceRange::Begin( const std::string &name, const std::string &details )
+{
+  BeginBackend( name, details );
+}
+
+
+void TraceRange::End()
+{
+  EndBackend();
+}
+
+
+void TraceRange::Begin( const ProcessObject &process, const Image *image )
+{
+  BeginBackend( process.GetName(), image ? GetImageDetails( *image ) : std::string() );
+}
+
+
+void TraceRange::Begin( const ProcessObject &process, const std::string &fileName )
+{
+  BeginBackend( process.GetName(), fileName );
+}
+
+}
+}
+}
@@ -20,6 +20,7 @@
 #include "sitkPimpleTransform.hxx"
 
 #include "sitkTransform.h"
+#include "sitkTransformBinaryIO.h"
 #include "sitkTemplateFunctions.h"
 #include "sitkMemberFunctionFactory.h"
 #include "sitkImageConvert.hxx"
@@ -501,6 +502,54 @@ std::vector< double > Transform::TransformVector( const std::vector< double > &v
   }
 
 
+  std::vector< double > Transform::TransformPoints( const std::vector< double > &points ) const
+  {
+    assert( m_PimpleTransform );
+    const unsigned int dimension = this->GetDimension();
+    if ( points.size() % dimension != 0 )
+      {
+      sitkExceptionMacro( "The number of coordinates " << points.size()
+                          << " is not a multiple of the dimension " << dimension << "!" );
+      }
+    std::vector< double > outputPoints( points.size() );
+    this->m_PimpleTransform->TransformPoints( points.data(), outputPoints.data(), points.size() / dimension );
+    return outputPoints;
+  }
+
+  void Transform::TransformPoints( const double *points, double *outputPoints, size_t numberOfPoints ) const
+  {
+    assert( m_PimpleTransform );
+    this->m_PimpleTransform->TransformPoints( points, outputPoints, numberOfPoints );
+  }
+
+
+  std::vector< double > Transform::TransformVectors( const std::vector< double > &vectors,
+                                                     const std::vector< double > &points ) const
+  {
+    assert( m_PimpleTransform );
+    const unsigned int dimension = this->GetDimension();
+    if ( vectors.size() % dimension != 0 )
+      {
+      sitkExceptionMacro( "The number of coordinates " << vectors.size()
+                          << " is not a multiple of the dimension " << dimension << "!" );
+      }
+    if ( points.size() != vectors.size() )
+      {
+      sitkExceptionMacro( "The number of point coordinates " << points.size()
+                          << " does not match the number of vector coordinates " << vectors.size() << "!" );
+      }
+    std::vector< double > outputVectors( vectors.size() );
+    this->m_PimpleTransform->TransformVectors( vectors.data(), points.data(), outputVectors.data(), vectors.size() / dimension );
+    return outputVectors;
+  }
+
+  void Transform::TransformVectors( const double *vectors, const double *points, double *outputVectors, size_t numberOfVectors ) const
+  {
+    assert( m_PimpleTransform );
+    this->m_PimpleTransform->TransformVectors( vectors, points, outputVectors, numberOfVectors );
+  }
+
+
   bool Transform::IsLinear() const
   {
     assert( m_PimpleTransform );
@@ -657,6 +706,25 @@ void Transform::InternalInitialization(TransformType *t)
 
   Transform ReadTransform( const std::string &filename )
   {
+    if ( detail::IsBinaryTransformFileName( filename ) )
+      {
+      itk::TransformBase::Pointer transform = detail::ReadBinaryTransform( filename );
+
+      using TransformType2D = itk::Transform<double, 2, 2>;
+      using TransformType3D = itk::Transform<double, 3, 3>;
+      if ( auto *itktx3d = dynamic_cast<TransformType3D*>( transform.GetPointer() ) )
+        {
+        return Transform( itktx3d );
+        }
+      if ( auto *itktx2d = dynamic_cast<TransformType2D*>( transform.GetPointer() ) )
+        {
+        return Transform( itktx2d );
+        }
+      sitkExceptionMacro( "Unable to transform with InputSpaceDimension: " <<  transform->GetInputSpaceDimension()
+                          << " and OutputSpaceDimension: " << transform->GetOutputSpaceDimension() << ". "
+                          << "Transform of type " << transform->GetNameOfClass() << "is not supported." );
+      }
+
     TransformFileReader::Pointer reader = TransformFileReader::New();
     reader->SetFileName(filename.c_str() );
     reader->Update();
@@ -724,6 +792,12 @@ void Transform::InternalInitialization(TransformType *t)
   // write
   void WriteTransform( const Transform &transform, const std::string &filename)
   {
+    if ( detail::IsBinaryTransformFileName( filename ) )
+      {
+      detail::WriteBinaryTransform( transform.GetITKBase(), filename );
+      return;
+      }
+
     itk::TransformFileWriter::Pointer writer = itk::TransformFileWriter::New();
     writer->SetFileName(filename.c_str());
     writer->SetInput( transform.GetITKBase() );
@@ -0,0 +1,391 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+
+#include "sitkTransformBinaryIO.h"
+#include "sitkExceptionObject.h"
+#include "sitkMacro.h"
+
+#include "itkByteSwapper.h"
+#include "itkCompositeTransform.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkTransformFactoryBase.h"
+#include "itkObjectFactoryBase.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+
+constexpr char     magic[8] = { 'S', 'I', 'T', 'K', 'T', 'X', '0', '1' };
+constexpr uint32_t formatVersion = 1;
+constexpr uint64_t alignment = 64;
+
+class BinaryWriter
+{
+public:
+  explicit BinaryWriter( const std::string &fileName )
+    : m_FileName( fileName ),
+      m_Stream( fileName.c_str(), std::ios::binary | std::ios::trunc )
+  {
+    if ( !m_Stream )
+      {
+      sitkExceptionMacro( "Unable to open \"" << fileName << "\" for writing." );
+      }
+  }
+
+  void Write( const void *data, uint64_t length )
+  {
+    m_Stream.write( static_cast<const char *>( data ), static_cast<std::streamsize>( length ) );
+    m_Position += length;
+  }
+
+  void WriteUInt64( uint64_t value )
+  {
+    itk::ByteSwapper<uint64_t>::SwapFromSystemToLittleEndian( &value );
+    this->Write( &value, sizeof( value ) );
+  }
+
+  void WriteDoubles( const double *values, uint64_t count )
+  {
+    if ( itk::ByteSwapper<double>::SystemIsBigEndian() )
+      {
+      std::vector<double> swapped( values, values + count );
+      itk::ByteSwapper<double>::SwapRangeFromSystemToLittleEndian( swapped.data(), count );
+      this->Write( swapped.data(), count * sizeof( double ) );
+      }
+    else
+      {
+      this->Write( values, count * sizeof( double ) );
+      }
+  }
+
+  void Align()
+  {
+    static const char zeros[alignment] = {};
+    this->Write( zeros, ( alignment - m_Position % alignment ) % alignment );
+  }
+
+  void Close()
+  {
+    m_Stream.close();
+    if ( !m_Stream )
+      {
+      sitkExceptionMacro( "Error writing the transform to \"" << m_FileName << "\"." );
+      }
+  }
+
+private:
+  std::string   m_FileName;
+  std::ofstream m_Stream;
+  uint64_t      m_Position{ 0 };
+};
+
+
+class BinaryReader
+{
+public:
+  explicit BinaryReader( const std::string &fileName )
+    : m_FileName( fileName ),
+      m_Stream( fileName.c_str(), std::ios::binary )
+  {
+    if ( !m_Stream )
+      {
+      sitkExceptionMacro( "Unable to open \"" << fileName << "\" for reading." );
+      }
+    m_Stream.seekg( 0, std::ios::end );
+    m_Length = static_cast<uint64_t>( m_Stream.tellg() );
+    m_Stream.seekg( 0 );
+  }
+
+  void Read( void *data, uint64_t length )
+  {
+    if ( length > m_Length - m_Position )
+      {
+      sitkExceptionMacro( "The transform file \"" << m_FileName << "\" is truncated." );
+      }
+    m_Stream.read( static_cast<char *>( data ), static_cast<std::streamsize>( length ) );
+    if ( !m_Stream )
+      {
+      sitkExceptionMacro( "Error reading the transform file \"" << m_FileName << "\"." );
+      }
+    m_Position += length;
+  }
+
+  uint64_t ReadUInt64()
+  {
+    uint64_t value;
+    this->Read( &value, sizeof( value ) );
+    itk::ByteSwapper<uint64_t>::SwapFromSystemToLittleEndian( &value );
+    return value;
+  }
+
+  // check the count before allocating the destination
+  void CheckDoubles( uint64_t count )
+  {
+    if ( count > ( m_Length - m_Position ) / sizeof( double ) )
+      {
+      sitkExceptionMacro( "The transform file \"" << m_FileName << "\" is truncated." );
+      }
+  }
+
+  void ReadDoubles( double *values, uint64_t count )
+  {
+    this->CheckDoubles( count );
+    this->Read( values, count * sizeof( double ) );
+    itk::ByteSwapper<double>::SwapRangeFromSystemToLittleEndian( values, count );
+  }
+
+  void Align()
+  {
+    const uint64_t padding = ( alignment - m_Position % alignment ) % alignment;
+    m_Position = std::min( m_Length, m_Position + padding );
+    m_Stream.seekg( static_cast<std::streamoff>( m_Position ) );
+  }
+
+  const std::string &GetFileName() const { return m_FileName; }
+
+private:
+  std::string   m_FileName;
+  std::ifstream m_Stream;
+  uint64_t      m_Length{ 0 };
+  uint64_t      m_Position{ 0 };
+};
+
+
+// The transforms of a composite, or an empty list for other transforms.
+template <unsigned int VDimension>
+bool GetCompositeChildren( const itk::TransformBase *transform, std::vector<const itk::TransformBase *> &children )
+{
+  using CompositeType = itk::CompositeTransform<double, VDimension>;
+  const auto *composite = dynamic_cast<const CompositeType *>( transform );
+  if ( composite == nullptr )
+    {
+    return false;
+    }
+  for ( unsigned int i = 0; i < composite->GetNumberOfTransforms(); ++i )
+    {
+    children.push_back( composite->GetNthTransformConstPointer( i ) );
+    }
+  return true;
+}
+
+void WriteRecord( BinaryWriter &writer, const itk::TransformBase *transform )
+{
+  std::vector<const itk::TransformBase *> children;
+  const bool isComposite = GetCompositeChildren<2>( transform, children ) || GetCompositeChildren<3>( transform, children );
+
+  const std::string name = transform->GetTransformTypeAsString();
+  const itk::TransformBase::FixedParametersType &fixedParameters = transform->GetFixedParameters();
+  // the parameters of a composite are those of its children
+  const uint64_t numberOfParameters = isComposite ? 0 : transform->GetNumberOfParameters();
+
+  writer.Align();
+  writer.WriteUInt64( name.size() );
+  writer.WriteUInt64( isComposite ? 0 : fixedParameters.size() );
+  writer.WriteUInt64( numberOfParameters );
+  writer.WriteUInt64( children.size() );
+  writer.Write( name.data(), name.size() );
+  writer.Align();
+  if ( !isComposite )
+    {
+    writer.WriteDoubles( fixedParameters.data_block(), fixedParameters.size() );
+    writer.Align();
+    writer.WriteDoubles( transform->GetParameters().data_block(), numberOfParameters );
+    }
+
+  for ( const itk::TransformBase *child : children )
+    {
+    WriteRecord( writer, child );
+    }
+}
+
+
+itk::TransformBase::Pointer CreateTransform( const std::string &name )
+{
+  itk::TransformFactoryBase::RegisterDefaultTransforms();
+
+  itk::LightObject::Pointer object = itk::ObjectFactoryBase::CreateInstance( name.c_str() );
+  itk::TransformBase::Pointer transform = dynamic_cast<itk::TransformBase *>( object.GetPointer() );
+  if ( transform.IsNull() )
+    {
+    sitkExceptionMacro( "Unable to create a transform of type \"" << name << "\"." );
+    }
+  return transform;
+}
+
+// Read the parameters into the buffer of the displacement field,
+// allocated by SetFixedParameters.
+template <unsigned int VDimension>
+bool ReadDisplacementField( BinaryReader &reader, itk::TransformBase *transform, uint64_t numberOfParameters )
+{
+  using DisplacementFieldTransformType = itk::DisplacementFieldTransform<double, VDimension>;
+  auto *displacementTransform = dynamic_cast<DisplacementFieldTransformType *>( transform );
+  if ( displacementTransform == nullptr || displacementTransform->GetDisplacementField() == nullptr )
+    {
+    return false;
+    }
+
+  auto *field = displacementTransform->GetModifiableDisplacementField();
+  if ( uint64_t( field->GetPixelContainer()->Size() ) * VDimension != numberOfParameters )
+    {
+    sitkExceptionMacro( "The number of parameters " << numberOfParameters << " in \"" << reader.GetFileName()
+                        << "\" does not match the displacement field." );
+    }
+  reader.ReadDoubles( field->GetBufferPointer()->GetDataPointer(), numberOfParameters );
+  field->Modified();
+  return true;
+}
+
+template <unsigned int VDimension>
+bool AddToComposite( itk::TransformBase *composite, itk::TransformBase *child )
+{
+  auto *compositeTransform = dynamic_cast<itk::CompositeTransform<double, VDimension> *>( composite );
+  if ( compositeTransform == nullptr )
+    {
+    return false;
+    }
+  auto *childTransform = dynamic_cast<itk::Transform<double, VDimension, VDimension> *>( child );
+  if ( childTransform == nullptr )
+    {
+    sitkExceptionMacro( "A " << child->GetNameOfClass() << " can not be added to a composite transform of dimension "
+                        << VDimension << "." );
+    }
+  compositeTransform->AddTransform( childTransform );
+  return true;
+}
+
+itk::TransformBase::Pointer ReadRecord( BinaryReader &reader, unsigned int depth )
+{
+  // composites of composites are allowed, but not without bound
+  if ( depth > 64 )
+    {
+    sitkExceptionMacro( "The transforms in \"" << reader.GetFileName() << "\" are nested too deeply." );
+    }
+
+  reader.Align();
+  const uint64_t nameLength = reader.ReadUInt64();
+  const uint64_t numberOfFixedParameters = reader.ReadUInt64();
+  const uint64_t numberOfParameters = reader.ReadUInt64();
+  const uint64_t numberOfChildren = reader.ReadUInt64();
+
+  if ( nameLength == 0 || nameLength > 1024 )
+    {
+    sitkExceptionMacro( "The transform file \"" << reader.GetFileName() << "\" is not valid." );
+    }
+  std::string name( nameLength, '\0' );
+  reader.Read( &name[0], nameLength );
+  reader.Align();
+
+  itk::TransformBase::Pointer transform = CreateTransform( name );
+
+  if ( numberOfChildren == 0 )
+    {
+    reader.CheckDoubles( numberOfFixedParameters );
+    itk::TransformBase::FixedParametersType fixedParameters( numberOfFixedParameters );
+    reader.ReadDoubles( fixedParameters.data_block(), numberOfFixedParameters );
+    transform->SetFixedParameters( fixedParameters );
+    reader.Align();
+
+    if ( !ReadDisplacementField<2>( reader, transform, numberOfParameters ) &&
+         !ReadDisplacementField<3>( reader, transform, numberOfParameters ) )
+      {
+      if ( numberOfParameters != transform->GetNumberOfParameters() )
+        {
+        sitkExceptionMacro( "The transform \"" << name << "\" in \"" << reader.GetFileName() << "\" has "
+                            << numberOfParameters << " parameters, but " << transform->GetNumberOfParameters()
+                            << " are expected." );
+        }
+      reader.CheckDoubles( numberOfParameters );
+      itk::TransformBase::ParametersType parameters( numberOfParameters );
+      reader.ReadDoubles( parameters.data_block(), numberOfParameters );
+      transform->SetParametersByValue( parameters );
+      }
+    }
+
+  for ( uint64_t i = 0; i < numberOfChildren; ++i )
+    {
+    itk::TransformBase::Pointer child = ReadRecord( reader, depth + 1 );
+    if ( !AddToComposite<2>( transform, child ) && !AddToComposite<3>( transform, child ) )
+      {
+      sitkExceptionMacro( "The transform \"" << name << "\" in \"" << reader.GetFileName()
+                          << "\" is not a composite transform." );
+      }
+    }
+
+  return transform;
+}
+
+}
+
+
+bool IsBinaryTransformFileName( const std::string &fileName )
+{
+  return itksys::SystemTools::LowerCase( itksys::SystemTools::GetFilenameLastExtension( fileName ) ) == ".sitktx";
+}
+
+
+void WriteBinaryTransform( const itk::TransformBase *transform, const std::string &fileName )
+{
+  BinaryWriter writer( fileName );
+
+  uint32_t version = formatVersion;
+  itk::ByteSwapper<uint32_t>::SwapFromSystemToLittleEndian( &version );
+  writer.Write( magic, sizeof( magic ) );
+  writer.Write( &version, sizeof( version ) );
+
+  WriteRecord( writer, transform );
+  writer.Close();
+}
+
+
+itk::TransformBase::Pointer ReadBinaryTransform( const std::string &fileName )
+{
+  BinaryReader reader( fileName );
+
+  char fileMagic[sizeof( magic )];
+  uint32_t version;
+  reader.Read( fileMagic, sizeof( fileMagic ) );
+  reader.Read( &version, sizeof( version ) );
+  itk::ByteSwapper<uint32_t>::SwapFromSystemToLittleEndian( &version );
+  if ( std::memcmp( fileMagic, magic, sizeof( magic ) ) != 0 )
+    {
+    sitkExceptionMacro( "The file \"" << fileName << "\" is not a SimpleITK binary transform file." );
+    }
+  if ( version != formatVersion )
+    {
+    sitkExceptionMacro( "The binary transform file \"" << fileName << "\" has the unsupported version " << version << "." );
+    }
+
+  return ReadRecord( reader, 0 );
+}
+
+}
+}
+}
@@ -0,0 +1,62 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkTransformBinaryIO_h
+#define sitkTransformBinaryIO_h
+
+#include "sitkCommon.h"
+
+#include "itkTransformBase.h"
+
+#include <string>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \brief A compact binary serialization of transforms.
+ *
+ * Files with the ".sitktx" extension hold one transform, which may be
+ * a composite of transforms, as little endian binary data. The file
+ * starts with a 64 byte header of the 8 byte magic "SITKTX01" and the
+ * uint32 format version. Each transform is then a record of:
+ *  - four uint64: the length of the ITK transform type name, e.g.
+ *  "AffineTransform_double_3_3", the number of fixed parameters, the
+ *  number of parameters and the number of child transforms.
+ *  - the name, the fixed parameters and the parameters as doubles,
+ *  each starting at a multiple of 64 bytes from the start of the file
+ *  so the arrays may be memory mapped.
+ *  - the records of the child transforms of a composite transform, in
+ *  the order they were added.
+ *
+ * The parameters of a displacement field transform are read directly
+ * into the buffer of the displacement field.
+ */
+SITKCommon_HIDDEN bool IsBinaryTransformFileName( const std::string &fileName );
+
+SITKCommon_HIDDEN void WriteBinaryTransform( const itk::TransformBase *transform, const std::string &fileName );
+
+SITKCommon_HIDDEN itk::TransformBase::Pointer ReadBinaryTransform( const std::string &fileName );
+
+}
+}
+}
+
+#endif // sitkTransformBinaryIO_h
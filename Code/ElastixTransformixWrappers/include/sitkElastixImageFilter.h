@@ -21,7 +21,12 @@
 #include "sitkElastixTransformixWrappers.h"
 #include "sitkCommon.h"
 #include "sitkImage.h"
+#include "sitkTransform.h"
+#include "sitkCancellationToken.h"
+#include "sitkCommand.h"
+#include "sitkEvent.h"
 
+#include <functional>
 #include <map>
 #include <memory> // For unique_ptr.
 #include <string>
@@ -214,24 +219,123 @@ public:
   /** \brief Switches logging to console off */
   SITK_RETURN_SELF_TYPE_HEADER LogToConsoleOff();
 
+  /** \brief Switches the in-memory mode on (`true`) or off (`false`), as specified by its function argument.
+  *
+  * In the in-memory mode no file is written: the output directory, the log file and LogToFile are ignored, and the
+  * Write parameters of the parameter maps, such as WriteIterationInfo and WriteResultImageAfterEachResolution, are
+  * set to false, so no "elastix.log" nor "TransformParameters.*.txt" is written. The result image and the transform
+  * parameter maps are only in memory. When logging to console is on, the console log of elastix is sent line by line
+  * to the ITK output window, and so to the SimpleITK logger set with LoggerBase::SetAsGlobalITKLogger. The default is
+  * off. */
+  SITK_RETURN_SELF_TYPE_HEADER SetInMemory( bool );
+
+  /** \brief Returns whether the in-memory mode is switched on. */
+  bool GetInMemory();
+
+  /** \brief Switches the in-memory mode on */
+  SITK_RETURN_SELF_TYPE_HEADER InMemoryOn();
+
+  /** \brief Switches the in-memory mode off */
+  SITK_RETURN_SELF_TYPE_HEADER InMemoryOff();
+
   /** \brief Sets the maximum number of threads to the specified number \p n.
-  * \note As a side effect, it may modify the *global* maximum number of threads, as it internally calls ITK's `MultiThreaderBase.SetGlobalMaximumNumberOfThreads`. */
+  * The number of threads is used by elastix and by the SimpleITK filters of the execution, such as the casts of the
+  * inputs to float. When \p n is 0, the default, ProcessObject::GetGlobalDefaultNumberOfThreads is used. The jobs
+  * of ExecuteBatch divide the threads between them.
+  * \note elastix sets the *global* maximum number of threads with ITK's `MultiThreaderBase.SetGlobalMaximumNumberOfThreads`
+  * during the execution, and it is restored after. */
   SITK_RETURN_SELF_TYPE_HEADER SetNumberOfThreads( int n );
 
   /** \brief Returns the current maximum number of threads. */
   int GetNumberOfThreads();
 
+  /** \brief Sets a token to cancel the registration.
+  * Execute throws an exception when the token is cancelled before the registration starts, and the registration is
+  * aborted at the next progress or iteration event reported by elastix. */
+  SITK_RETURN_SELF_TYPE_HEADER SetCancellationToken( const CancellationToken & token );
+
+  /** \brief Returns the cancellation token, an exception is thrown if none is set. */
+  CancellationToken GetCancellationToken() const;
+
+  /** \brief Returns true if a cancellation token is set. */
+  bool HasCancellationToken() const;
+
+  /** \brief Removes the cancellation token. */
+  SITK_RETURN_SELF_TYPE_HEADER RemoveCancellationToken();
+
+  /** \brief Reuse the smoothed fixed images between the registrations.
+  *
+  * elastix smooths the fixed images for each resolution of its fixed image pyramid on every registration. When
+  * enabled, the smoothed fixed images are kept and reused by the following executions with the same fixed images,
+  * geometry and smoothing parameters, which is useful to register one fixed image, such as an atlas, to many moving
+  * images by Execute or ExecuteBatch. The jobs of ExecuteBatch share the cache. Only the smoothed images of the
+  * fixed images of the last execution are kept.
+  *
+  * The cache keeps a reference to the fixed images. Modifying a fixed image in place after an execution makes a
+  * copy of its buffer, which is then smoothed again.
+  *
+  * By default the cache is disabled. Disabling it releases the cached images.
+  * @{
+  */
+  SITK_RETURN_SELF_TYPE_HEADER SetUseFixedImagePyramidCache( bool useFixedImagePyramidCache );
+  bool GetUseFixedImagePyramidCache() const;
+  SITK_RETURN_SELF_TYPE_HEADER UseFixedImagePyramidCacheOn() { return this->SetUseFixedImagePyramidCache( true ); }
+  SITK_RETURN_SELF_TYPE_HEADER UseFixedImagePyramidCacheOff() { return this->SetUseFixedImagePyramidCache( false ); }
+  /** @} */
+
+  /** \brief Releases the smoothed fixed images in the pyramid cache. */
+  SITK_RETURN_SELF_TYPE_HEADER ClearFixedImagePyramidCache();
+
+  /** \brief Adds a command for an event of the registration.
+  *
+  * elastix reports its resolutions and the iterations of its optimizer only in its console log, which Execute
+  * follows: an sitkMultiResolutionIterationEvent is invoked at the start of each resolution, and an
+  * sitkIterationEvent and an sitkProgressEvent after each iteration. The sitkStartEvent, sitkEndEvent,
+  * sitkAbortEvent and sitkDeleteEvent are invoked as for the other filters. The jobs of ExecuteBatch do not
+  * invoke the commands.
+  *
+  * The command is removed from the filter when it is deleted. */
+  int AddCommand( itk::simple::EventEnum event, itk::simple::Command & cmd );
+
+  /** \brief Adds a function as a command for an event of the registration, see AddCommand. */
+  int AddCommand( itk::simple::EventEnum event, const std::function< void() > & func );
+
+  /** \brief Removes all the commands. */
+  SITK_RETURN_SELF_TYPE_HEADER RemoveAllCommands();
+
+  /** \brief Returns true if a command is added for the event. */
+  bool HasCommand( itk::simple::EventEnum event ) const;
+
+  /** \brief Returns the progress of the registration, in the range 0 to 1.
+  * The progress is estimated from the iterations of the parameter maps, relative to their
+  * MaximumNumberOfIterations. */
+  float GetProgress() const;
+
+  /** \brief Aborts the registration, which throws an exception from Execute.
+  * The registration is aborted at the next iteration reported by elastix. It may be called from a command, or from
+  * another thread. */
+  void Abort();
+
+  /** \brief Returns the last iteration of the optimizer reported by elastix, starting from 0 at each resolution. */
+  unsigned int GetOptimizerIteration() const;
+
+  /** \brief Returns the metric value of the last iteration reported by elastix. */
+  double GetMetricValue() const;
+
+  /** \brief Returns the resolution of the last iteration reported by elastix. */
+  unsigned int GetCurrentLevel() const;
+
   /** \brief Specifies the parameter map by a \p transformName ("translation", "rigid" , "affine", "nonrigid", or "bspline"), and optionally \p numberOfResolutions and \p finalGridSpacingInPhysicalUnits. */
   SITK_RETURN_SELF_TYPE_HEADER SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4u, const double finalGridSpacingInPhysicalUnits = 10.0 );
 
   /** \brief Specifies multiple parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
+  SITK_RETURN_SELF_TYPE_HEADER SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > & parameterMapVector );
 
   /** \brief Specifies a single parameter map. */
-  SITK_RETURN_SELF_TYPE_HEADER SetParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
+  SITK_RETURN_SELF_TYPE_HEADER SetParameterMap( const std::map< std::string, std::vector< std::string > > & parameterMap );
 
   /** \brief Adds a parameter map to the container of parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER AddParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
+  SITK_RETURN_SELF_TYPE_HEADER AddParameterMap( const std::map< std::string, std::vector< std::string > > & parameterMap );
 
   /** \brief Returns a copy of the parameter maps. */
   std::vector< std::map< std::string, std::vector< std::string > > > GetParameterMap();
@@ -243,40 +347,57 @@ public:
   unsigned int GetNumberOfParameterMaps();
 
   /** \brief Sets the value of the parameter specified by \p key, in all parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const std::string key, const std::string value );
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const std::string & key, const std::string & value );
 
   /** \brief Sets the values of the parameter specified by \p key, in all parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const std::string key, const std::vector< std::string > value );
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const std::string & key, const std::vector< std::string > & value );
 
   /** \brief Sets the value of the parameter specified by \p key, in the parameter map at the specified (zero-based) \p index. */
-  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const unsigned int index, const std::string key, const std::string value );
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const unsigned int index, const std::string & key, const std::string & value );
 
   /** \brief Sets the values of the parameter specified by \p key, in the parameter map at the specified (zero-based) \p index. */
-  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const unsigned int index, const std::string key, const std::vector< std::string > value );
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const unsigned int index, const std::string & key, const std::vector< std::string > & value );
+
+  /** \brief Sets the number value of the parameter specified by \p key, in all parameter maps.
+   *
+   * The numbers are written with the precision which reads them back
+   * exactly, in the classic locale elastix reads, so that they need not be
+   * formatted as strings by the caller.
+   */
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const std::string & key, const double value );
+
+  /** \brief Sets the number values of the parameter specified by \p key, in all parameter maps. */
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const std::string & key, const std::vector< double > & value );
+
+  /** \brief Sets the number value of the parameter specified by \p key, in the parameter map at the specified (zero-based) \p index. */
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const unsigned int index, const std::string & key, const double value );
+
+  /** \brief Sets the number values of the parameter specified by \p key, in the parameter map at the specified (zero-based) \p index. */
+  SITK_RETURN_SELF_TYPE_HEADER SetParameter( const unsigned int index, const std::string & key, const std::vector< double > & value );
 
   /** \brief Adds a parameter specified by \p key, with the specified value to all parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const std::string key, const std::string value );
+  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const std::string & key, const std::string & value );
 
   /** \brief Adds a parameter specified by \p key, with the specified value to the parameter map at the specified (zero-based) \p index. */
-  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const unsigned int index, const std::string key, const std::string value );
+  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const unsigned int index, const std::string & key, const std::string & value );
 
   /** \brief Adds a parameter specified by \p key, with the specified values to all parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const std::string key, const std::vector< std::string > value );
+  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const std::string & key, const std::vector< std::string > & value );
 
   /** \brief Adds a parameter specified by \p key, with the specified values to the parameter map at the specified (zero-based) \p index. */
-  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const unsigned int index, const std::string key, const std::vector< std::string > value );
+  SITK_RETURN_SELF_TYPE_HEADER AddParameter( const unsigned int index, const std::string & key, const std::vector< std::string > & value );
 
   /** \brief Retrieves the values of the parameter specified by \p key, when there is only one parameter map. */
-  std::vector< std::string > GetParameter( const std::string key );
+  std::vector< std::string > GetParameter( const std::string & key );
 
   /** \brief Retrieves the values of the parameter specified by \p key, from the parameter map at the specified (zero-based) \p index. */
-  std::vector< std::string > GetParameter( const unsigned int index, const std::string key );
+  std::vector< std::string > GetParameter( const unsigned int index, const std::string & key );
 
   /** \brief Removes the parameter specified by \p key from all parameter maps. */
-  SITK_RETURN_SELF_TYPE_HEADER RemoveParameter( const std::string key );
+  SITK_RETURN_SELF_TYPE_HEADER RemoveParameter( const std::string & key );
 
   /** \brief Removes the parameter specified by \p key from the parameter map at the specified (zero-based) \p index. */
-  SITK_RETURN_SELF_TYPE_HEADER RemoveParameter( const unsigned int index, const std::string key );
+  SITK_RETURN_SELF_TYPE_HEADER RemoveParameter( const unsigned int index, const std::string & key );
 
   /** \brief Specifies the initial transformation by the specified transform parameter file name. */
   SITK_RETURN_SELF_TYPE_HEADER SetInitialTransformParameterFileName( const std::string initialTransformParmaterFileName );
@@ -309,6 +430,29 @@ public:
   /** \brief Returns the result image. */
   Image GetResultImage();
 
+  /** \brief Executes many registrations in parallel, and returns their result images.
+   *
+   * Job i registers the moving image at index i to the fixed image at
+   * index i, or to the only fixed image, with the parameter maps at
+   * index i, or the only parameter maps, or when parameterMapVectors is
+   * empty, the parameter maps of the filter. The masks, point sets,
+   * initial transform and logging settings of the filter are shared by
+   * the jobs.
+   *
+   * The jobs run on a pool of threads, and the number of threads set with
+   * SetNumberOfThreads, or all the threads when it is zero, is divided
+   * between the concurrent registrations instead of each using all of
+   * them. The jobs are executed in memory, as with InMemoryOn, and their
+   * transform parameter maps are returned by GetBatchTransformParameterMap.
+   * An exception of a job stops the remaining jobs and is thrown.
+   */
+  std::vector< Image > ExecuteBatch( const std::vector< Image > &fixedImages,
+                                     const std::vector< Image > &movingImages,
+                                     const std::vector< ParameterMapVectorType > &parameterMapVectors = std::vector< ParameterMapVectorType >() );
+
+  /** \brief Returns the transform parameter maps of the jobs of the last ExecuteBatch. */
+  std::vector< ParameterMapVectorType > GetBatchTransformParameterMap();
+
   /** \brief Prints all parameter maps to standard output. */
   SITK_RETURN_SELF_TYPE_HEADER PrintParameterMap();
 
@@ -331,6 +475,22 @@ SITKElastix_EXPORT std::map< std::string, std::vector< std::string > > ReadParam
 SITKElastix_EXPORT void WriteParameterFile( const std::map< std::string, std::vector< std::string > > parameterMap, const std::string filename );
 SITKElastix_EXPORT void PrintParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
 SITKElastix_EXPORT void PrintParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
+
+/** \brief Convert elastix transform parameter maps to a SimpleITK transform.
+ *
+ * A TranslationTransform, EulerTransform, SimilarityTransform,
+ * AffineTransform, BSplineTransform or RecursiveBSplineTransform map is
+ * converted to the SimpleITK transform of the same parameters, without
+ * computing a deformation field. The maps are composed in order, the
+ * first being applied first to the points, into a CompositeTransform,
+ * after the transforms of the InitialTransformParametersFileName of the
+ * first map when it is not "NoInitialTransform".
+ *
+ * An exception is thrown for other transforms, and for transforms
+ * combined with HowToCombineTransforms "Add".
+ */
+SITKElastix_EXPORT Transform TransformParameterMapToTransform( const std::map< std::string, std::vector< std::string > > parameterMap );
+SITKElastix_EXPORT Transform TransformParameterMapToTransform( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
 SITKElastix_EXPORT Image Elastix( const Image& fixedImage, const Image& movingImage, const bool logToConsole = false, const bool logToFile = false, const std::string outputDirectory = "." );
 SITKElastix_EXPORT Image Elastix( const Image& fixedImage, const Image& movingImage, const Image& fixedMask, const Image& movingMask, const bool logToConsole = false, const bool logToFile = false, const std::string outputDirectory = "." );
 SITKElastix_EXPORT Image Elastix( const Image& fixedImage, const Image& movingImage, const std::string defaultParameterMapName, const bool logToConsole = false, const bool logToFile = false, const std::string outputDirectory = "." );
@@ -21,6 +21,7 @@
 #include "sitkElastixTransformixWrappers.h"
 #include "sitkCommon.h"
 #include "sitkImage.h"
+#include "sitkInterpolator.h"
 
 #include <map>
 #include <memory> // For unique_ptr.
@@ -68,6 +69,18 @@ public:
   SITK_RETURN_SELF_TYPE_HEADER ComputeDeterminantOfSpatialJacobianOn();
   SITK_RETURN_SELF_TYPE_HEADER ComputeDeterminantOfSpatialJacobianOff();
 
+  /** \brief The pixel type of the spatial Jacobian outputs, sitkFloat64
+   * by default or sitkFloat32. */
+  SITK_RETURN_SELF_TYPE_HEADER SetSpatialJacobianOutputPixelType( PixelIDValueEnum pixelID );
+  PixelIDValueEnum GetSpatialJacobianOutputPixelType();
+
+  /** \brief Restrict the spatial Jacobian outputs to the region of
+   * index and size of the output grid, instead of the whole grid. */
+  SITK_RETURN_SELF_TYPE_HEADER SetSpatialJacobianRegion( const std::vector< unsigned int > & index, const std::vector< unsigned int > & size );
+  std::vector< unsigned int > GetSpatialJacobianRegionIndex();
+  std::vector< unsigned int > GetSpatialJacobianRegionSize();
+  SITK_RETURN_SELF_TYPE_HEADER RemoveSpatialJacobianRegion();
+
   SITK_RETURN_SELF_TYPE_HEADER SetComputeDeformationField( bool );
   bool GetComputeDeformationField();
   SITK_RETURN_SELF_TYPE_HEADER ComputeDeformationFieldOn();
@@ -120,6 +133,48 @@ public:
   Image GetResultImage();
   Image GetDeformationField();
 
+  /** \brief Returns the spatial Jacobian of the transform, as an image of
+   * the row-major matrix components.
+   *
+   * The spatial Jacobian and its determinant are computed in memory from
+   * the deformation field on the output grid, with central differences,
+   * instead of transformix writing them to the output directory.
+   */
+  Image GetSpatialJacobian();
+
+  /** \brief Returns the determinant of the spatial Jacobian of the transform. */
+  Image GetDeterminantOfSpatialJacobian();
+
+  /** \brief Compute the transform of the transform parameter maps once,
+   * for ExecuteBatch.
+   *
+   * Transformix is executed once to compute the deformation field of
+   * the parameter maps, on the output grid of the last map, which is
+   * kept as a DisplacementFieldTransform. ExecuteBatch prepares the
+   * transform when it is missing or the parameter maps have changed,
+   * so calling this method is only needed to prepare it ahead of time.
+   */
+  SITK_RETURN_SELF_TYPE_HEADER PrepareTransform();
+
+  /** \brief Resample many images with the prepared transform.
+   *
+   * The images are resampled together onto the output grid of the
+   * parameter maps, with JointResampler, the transform being evaluated
+   * once for all of them. Each image is interpolated with the
+   * interpolator of the same index, or when interpolators is empty,
+   * with the ResampleInterpolator of the last parameter map. The
+   * DefaultPixelValue of the last parameter map is used outside of the
+   * images.
+   *
+   * Images interpolated with sitkNearestNeighbor or sitkLabelGaussian,
+   * as label images, are resampled with their own pixel type, without
+   * a conversion to float. The other outputs are of the float type of
+   * the images of Execute. The results are those of Execute up to the
+   * float precision of the deformation field.
+   */
+  std::vector< Image > ExecuteBatch( const std::vector< Image > &movingImages,
+                                     const std::vector< InterpolatorEnum > &interpolators = std::vector< InterpolatorEnum >() );
+
 private:
 
   class TransformixImageFilterImpl;
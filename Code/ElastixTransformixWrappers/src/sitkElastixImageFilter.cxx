@@ -417,6 +417,37 @@ ElastixImageFilter
   return *this;
 }
 
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetInMemory( bool inMemory )
+{
+  this->m_Pimple->SetInMemory( inMemory );
+  return *this;
+}
+
+bool
+ElastixImageFilter
+::GetInMemory()
+{
+  return this->m_Pimple->GetInMemory();
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::InMemoryOn()
+{
+  this->m_Pimple->InMemoryOn();
+  return *this;
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::InMemoryOff()
+{
+  this->m_Pimple->InMemoryOff();
+  return *this;
+}
+
 ElastixImageFilter::Self&
 ElastixImageFilter
 ::SetNumberOfThreads( int n )
@@ -432,6 +463,123 @@ ElastixImageFilter
   return this->m_Pimple->GetNumberOfThreads();
 }
 
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetCancellationToken( const CancellationToken & token )
+{
+  this->m_Pimple->SetCancellationToken( token );
+  return *this;
+}
+
+CancellationToken
+ElastixImageFilter
+::GetCancellationToken() const
+{
+  return this->m_Pimple->GetCancellationToken();
+}
+
+bool
+ElastixImageFilter
+::HasCancellationToken() const
+{
+  return this->m_Pimple->HasCancellationToken();
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::RemoveCancellationToken()
+{
+  this->m_Pimple->RemoveCancellationToken();
+  return *this;
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetUseFixedImagePyramidCache( bool useFixedImagePyramidCache )
+{
+  this->m_Pimple->SetUseFixedImagePyramidCache( useFixedImagePyramidCache );
+  return *this;
+}
+
+bool
+ElastixImageFilter
+::GetUseFixedImagePyramidCache() const
+{
+  return this->m_Pimple->GetUseFixedImagePyramidCache();
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::ClearFixedImagePyramidCache()
+{
+  this->m_Pimple->ClearFixedImagePyramidCache();
+  return *this;
+}
+
+int
+ElastixImageFilter
+::AddCommand( itk::simple::EventEnum event, itk::simple::Command & cmd )
+{
+  return this->m_Pimple->AddCommand( event, cmd );
+}
+
+int
+ElastixImageFilter
+::AddCommand( itk::simple::EventEnum event, const std::function< void() > & func )
+{
+  return this->m_Pimple->AddCommand( event, func );
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::RemoveAllCommands()
+{
+  this->m_Pimple->RemoveAllCommands();
+  return *this;
+}
+
+bool
+ElastixImageFilter
+::HasCommand( itk::simple::EventEnum event ) const
+{
+  return this->m_Pimple->HasCommand( event );
+}
+
+float
+ElastixImageFilter
+::GetProgress() const
+{
+  return this->m_Pimple->GetProgress();
+}
+
+void
+ElastixImageFilter
+::Abort()
+{
+  this->m_Pimple->Abort();
+}
+
+unsigned int
+ElastixImageFilter
+::GetOptimizerIteration() const
+{
+  return this->m_Pimple->GetOptimizerIteration();
+}
+
+double
+ElastixImageFilter
+::GetMetricValue() const
+{
+  return this->m_Pimple->GetMetricValue();
+}
+
+unsigned int
+ElastixImageFilter
+::GetCurrentLevel() const
+{
+  return this->m_Pimple->GetCurrentLevel();
+}
+
 ElastixImageFilter::Self&
 ElastixImageFilter
 ::SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
@@ -442,7 +590,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::SetParameterMap( const ParameterMapType parameterMap )
+::SetParameterMap( const ParameterMapType & parameterMap )
 {
   this->m_Pimple->SetParameterMap( parameterMap );
   return *this;
@@ -450,7 +598,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::SetParameterMap( const ParameterMapVectorType parameterMapVector )
+::SetParameterMap( const ParameterMapVectorType & parameterMapVector )
 {
   this->m_Pimple->SetParameterMap( parameterMapVector );
   return *this;
@@ -458,7 +606,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::AddParameterMap( const ParameterMapType parameterMap )
+::AddParameterMap( const ParameterMapType & parameterMap )
 {
   this->m_Pimple->AddParameterMap( parameterMap );
   return *this;
@@ -503,7 +651,15 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::SetParameter( const ParameterKeyType key, const ParameterValueType value )
+::SetParameter( const ParameterKeyType & key, const ParameterValueType & value )
+{
+  this->m_Pimple->SetParameter( key, value );
+  return *this;
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetParameter( const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
   this->m_Pimple->SetParameter( key, value );
   return *this;
@@ -511,7 +667,31 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::SetParameter( const ParameterKeyType key, const ParameterValueVectorType value )
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value )
+{
+  this->m_Pimple->SetParameter( index, key, value );
+  return *this;
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueVectorType & value )
+{
+  this->m_Pimple->SetParameter( index, key, value );
+  return *this;
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetParameter( const ParameterKeyType & key, const double value )
+{
+  this->m_Pimple->SetParameter( key, value );
+  return *this;
+}
+
+ElastixImageFilter::Self&
+ElastixImageFilter
+::SetParameter( const ParameterKeyType & key, const std::vector< double > & value )
 {
   this->m_Pimple->SetParameter( key, value );
   return *this;
@@ -519,7 +699,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const double value )
 {
   this->m_Pimple->SetParameter( index, key, value );
   return *this;
@@ -527,7 +707,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const std::vector< double > & value )
 {
   this->m_Pimple->SetParameter( index, key, value );
   return *this;
@@ -535,7 +715,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::AddParameter( const ParameterKeyType key, const ParameterValueType value )
+::AddParameter( const ParameterKeyType & key, const ParameterValueType & value )
 {
   this->m_Pimple->AddParameter( key, value );
   return *this;
@@ -543,7 +723,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::AddParameter( const ParameterKeyType key, const ParameterValueVectorType value )
+::AddParameter( const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
   this->m_Pimple->AddParameter( key, value );
   return *this;
@@ -551,7 +731,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
+::AddParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value )
 {
   this->m_Pimple->AddParameter( index, key, value );
   return *this;
@@ -559,7 +739,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
+::AddParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
   this->m_Pimple->AddParameter( index, key, value );
   return *this;
@@ -567,21 +747,21 @@ ElastixImageFilter
 
 ElastixImageFilter::ParameterValueVectorType
 ElastixImageFilter
-::GetParameter( const ParameterKeyType key )
+::GetParameter( const ParameterKeyType & key )
 {
   return this->m_Pimple->GetParameter( key );
 }
 
 ElastixImageFilter::ParameterValueVectorType
 ElastixImageFilter
-::GetParameter( const unsigned int index, const ParameterKeyType key )
+::GetParameter( const unsigned int index, const ParameterKeyType & key )
 {
   return this->m_Pimple->GetParameter( index, key );
 }
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::RemoveParameter( const ParameterKeyType key )
+::RemoveParameter( const ParameterKeyType & key )
 {
   this->m_Pimple->RemoveParameter( key );
   return *this;
@@ -589,7 +769,7 @@ ElastixImageFilter
 
 ElastixImageFilter::Self&
 ElastixImageFilter
-::RemoveParameter( const unsigned int index, const ParameterKeyType key )
+::RemoveParameter( const unsigned int index, const ParameterKeyType & key )
 {
   this->m_Pimple->RemoveParameter( index, key );
   return *this;
@@ -645,6 +825,22 @@ ElastixImageFilter
   return this->m_Pimple->GetResultImage();
 }
 
+std::vector< Image >
+ElastixImageFilter
+::ExecuteBatch( const std::vector< Image > &fixedImages,
+                const std::vector< Image > &movingImages,
+                const std::vector< ParameterMapVectorType > &parameterMapVectors )
+{
+  return this->m_Pimple->ExecuteBatch( fixedImages, movingImages, parameterMapVectors );
+}
+
+std::vector< ElastixImageFilter::ParameterMapVectorType >
+ElastixImageFilter
+::GetBatchTransformParameterMap()
+{
+  return this->m_Pimple->GetBatchTransformParameterMap();
+}
+
 ElastixImageFilter::Self&
 ElastixImageFilter
 ::PrintParameterMap()
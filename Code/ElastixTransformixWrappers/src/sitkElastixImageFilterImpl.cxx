@@ -2,10 +2,209 @@
 #include "sitkElastixImageFilterImpl.h"
 #include "sitkCastImageFilter.h"
 #include "sitkInternalUtilities.h"
+#include "sitkTemplateFunctions.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <tuple>
 
 namespace itk {
   namespace simple {
 
+namespace {
+
+// The default parameter maps are created once, and shared by the filters
+std::shared_ptr< const ElastixImageFilter::ParameterMapType >
+GetSharedDefaultParameterMap( const std::string & transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
+{
+  typedef std::tuple< std::string, unsigned int, double > KeyType;
+  static std::mutex mutex;
+  static std::map< KeyType, std::shared_ptr< const ElastixImageFilter::ParameterMapType > > defaultParameterMaps;
+
+  const KeyType key( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
+  std::lock_guard< std::mutex > lock( mutex );
+  auto iter = defaultParameterMaps.find( key );
+  if( iter == defaultParameterMaps.end() )
+  {
+    iter = defaultParameterMaps.emplace( key, std::make_shared< ElastixImageFilter::ParameterMapType >(
+      elastix::ParameterObject::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits ) ) ).first;
+  }
+  return iter->second;
+}
+
+// Format a number as elastix reads it, with the shortest precision which
+// is read back as the same number
+std::string
+FormatParameterValue( const double value )
+{
+  std::ostringstream stream;
+  stream.imbue( std::locale::classic() );
+  stream.precision( std::numeric_limits< double >::digits10 );
+  stream << value;
+
+  std::istringstream check( stream.str() );
+  check.imbue( std::locale::classic() );
+  double readValue = 0.0;
+  if( !( check >> readValue ) || readValue != value )
+  {
+    stream.str( "" );
+    stream.precision( std::numeric_limits< double >::max_digits10 );
+    stream << value;
+  }
+  return stream.str();
+}
+
+ElastixImageFilter::ParameterValueVectorType
+FormatParameterValues( const std::vector< double > & values )
+{
+  ElastixImageFilter::ParameterValueVectorType formatted;
+  formatted.reserve( values.size() );
+  for( double value : values )
+  {
+    formatted.push_back( FormatParameterValue( value ) );
+  }
+  return formatted;
+}
+
+// Follows a registration in the console log of elastix, which reports the
+// start of its resolutions and the iterations of its optimizer only there:
+//
+//   Resolution: 0
+//   1:ItNr  2:Metric  3a:Time  3b:StepSize  4:||Gradient||  Time[ms]
+//   0       -0.8837   0.0000   ...
+class ElastixLogParser
+{
+public:
+  enum LineType { OtherLine, ResolutionLine, IterationLine };
+
+  explicit ElastixLogParser( const ElastixImageFilter::ParameterMapVectorType & parameterMapVector )
+    : m_ParameterMapVector( parameterMapVector ),
+      m_ParameterMapIndex( -1 ),
+      m_Level( 0 ),
+      m_Iteration( 0 ),
+      m_MetricValue( 0.0 ),
+      m_MetricColumn( std::string::npos )
+  {
+  }
+
+  LineType Parse( const std::string & line )
+  {
+    std::vector< std::string > columns;
+    std::istringstream stream( line );
+    stream.imbue( std::locale::classic() );
+    std::string column;
+    while( std::getline( stream, column, '\t' ) )
+    {
+      const size_t first = column.find_first_not_of( " \r\n" );
+      const size_t last = column.find_last_not_of( " \r\n" );
+      columns.push_back( first == std::string::npos ? std::string() : column.substr( first, last - first + 1 ) );
+    }
+    if( columns.empty() )
+    {
+      return OtherLine;
+    }
+
+    const std::string resolution = "Resolution: ";
+    if( columns.size() == 1 && columns[ 0 ].compare( 0, resolution.size(), resolution ) == 0 )
+    {
+      unsigned int level = 0;
+      if( !ParseNumber( columns[ 0 ].substr( resolution.size() ), level ) )
+      {
+        return OtherLine;
+      }
+      if( level == 0 )
+      {
+        ++m_ParameterMapIndex;
+      }
+      m_Level = level;
+      m_Iteration = 0;
+      m_MetricColumn = std::string::npos;
+      return ResolutionLine;
+    }
+
+    if( columns[ 0 ] == "1:ItNr" )
+    {
+      const auto metric = std::find( columns.begin(), columns.end(), "2:Metric" );
+      m_MetricColumn = metric == columns.end() ? std::string::npos : static_cast< size_t >( metric - columns.begin() );
+      return OtherLine;
+    }
+
+    unsigned int iteration = 0;
+    double metricValue = 0.0;
+    if( m_MetricColumn >= columns.size()
+        || !ParseNumber( columns[ 0 ], iteration )
+        || !ParseNumber( columns[ m_MetricColumn ], metricValue ) )
+    {
+      return OtherLine;
+    }
+    m_Iteration = iteration;
+    m_MetricValue = metricValue;
+    return IterationLine;
+  }
+
+  unsigned int GetLevel() const { return m_Level; }
+  unsigned int GetIteration() const { return m_Iteration; }
+  double GetMetricValue() const { return m_MetricValue; }
+
+  // The progress of the iterations, relative to the maximum number of
+  // iterations of each resolution of each parameter map.
+  float GetProgress() const
+  {
+    if( m_ParameterMapVector.empty() )
+    {
+      return 0.0f;
+    }
+    const size_t index = static_cast< size_t >( std::min< long >( std::max< long >( m_ParameterMapIndex, 0 ),
+                                                                  static_cast< long >( m_ParameterMapVector.size() ) - 1 ) );
+    const ElastixImageFilter::ParameterMapType & parameterMap = m_ParameterMapVector[ index ];
+
+    const double numberOfResolutions = std::max( GetParameterNumber( parameterMap, "NumberOfResolutions", 0, 3.0 ), 1.0 );
+    const double maximumNumberOfIterations = std::max( GetParameterNumber( parameterMap, "MaximumNumberOfIterations", m_Level, 500.0 ), 1.0 );
+    const double level = std::min( m_Level + std::min( ( m_Iteration + 1 ) / maximumNumberOfIterations, 1.0 ), numberOfResolutions );
+    return static_cast< float >( ( index + level / numberOfResolutions ) / m_ParameterMapVector.size() );
+  }
+
+private:
+  template< typename T >
+  static bool ParseNumber( const std::string & text, T & value )
+  {
+    std::istringstream stream( text );
+    stream.imbue( std::locale::classic() );
+    return ( stream >> value ) && ( stream >> std::ws ).eof();
+  }
+
+  // The value at index, or the last value when there are less, of a parameter
+  static double GetParameterNumber( const ElastixImageFilter::ParameterMapType & parameterMap,
+                                    const std::string & key, const unsigned int index, const double defaultValue )
+  {
+    const auto parameter = parameterMap.find( key );
+    double value = defaultValue;
+    if( parameter == parameterMap.end() || parameter->second.empty()
+        || !ParseNumber( parameter->second[ std::min< size_t >( index, parameter->second.size() - 1 ) ], value ) )
+    {
+      return defaultValue;
+    }
+    return value;
+  }
+
+  const ElastixImageFilter::ParameterMapVectorType m_ParameterMapVector;
+  long         m_ParameterMapIndex;
+  unsigned int m_Level;
+  unsigned int m_Iteration;
+  double       m_MetricValue;
+  size_t       m_MetricColumn;
+};
+
+} // end anonymous namespace
+
 ElastixImageFilter::ElastixImageFilterImpl
 ::ElastixImageFilterImpl( void )
 {
@@ -24,7 +223,7 @@ ElastixImageFilter::ElastixImageFilterImpl
   this->m_MovingMasks                 = VectorOfImage();
   this->m_ResultImage                 = Image();
 
-  this->m_ParameterMapVector          = ParameterMapVectorType();
+  this->m_ParameterMapVector          = SharedParameterMapVectorType();
   this->m_TransformParameterMapVector = ParameterMapVectorType();
 
   this->m_FixedPointSetFileName       = "";
@@ -35,15 +234,20 @@ ElastixImageFilter::ElastixImageFilterImpl
 
   this->m_LogToFile = false;
   this->m_LogToConsole = true;
+  this->m_InMemory = false;
+  this->m_BatchJob = false;
+
+  this->m_CommandProcessObject.reset( new ElastixCommandProcessObject() );
+  this->m_OptimizerIteration = 0;
+  this->m_MetricValue = 0.0;
+  this->m_CurrentLevel = 0;
 
   // Use all available threads by default
   this->m_NumberOfThreads = 0;
 
-  ParameterMapVectorType defaultParameterMap;
-  defaultParameterMap.push_back( ParameterObjectType::GetDefaultParameterMap( "translation" ) );
-  defaultParameterMap.push_back( ParameterObjectType::GetDefaultParameterMap( "affine" ) );
-  defaultParameterMap.push_back( ParameterObjectType::GetDefaultParameterMap( "bspline" ) );
-  this->SetParameterMap( defaultParameterMap );
+  this->m_ParameterMapVector.push_back( GetSharedDefaultParameterMap( "translation", 4u, 10.0 ) );
+  this->m_ParameterMapVector.push_back( GetSharedDefaultParameterMap( "affine", 4u, 10.0 ) );
+  this->m_ParameterMapVector.push_back( GetSharedDefaultParameterMap( "bspline", 4u, 10.0 ) );
 }
 
 ElastixImageFilter::ElastixImageFilterImpl
@@ -66,6 +270,11 @@ ElastixImageFilter::ElastixImageFilterImpl
     sitkExceptionMacro( "Moving image not set." );
   }
 
+  if( this->IsCancelled() )
+  {
+    sitkExceptionMacro( "The execution of \"" << this->GetName() << "\" was cancelled." );
+  }
+
   const PixelIDValueEnum FixedImagePixelID = this->GetFixedImage( 0 ).GetPixelID();
   const unsigned int FixedImageDimension = this->GetFixedImage( 0 ).GetDimension();
   const PixelIDValueEnum MovingImagePixelID = this->GetMovingImage( 0 ).GetPixelID();
@@ -177,6 +386,11 @@ ElastixImageFilter::ElastixImageFilterImpl
     }
   }
 
+  if( this->m_FixedImagePyramidCache && !this->m_BatchJob )
+  {
+    this->m_FixedImagePyramidCache->Retain( this->GetFixedImage() );
+  }
+
   if( this->m_DualMemberFactory->HasMemberFunction( sitkFloat32, sitkFloat32, FixedImageDimension ) )
   {
     return this->m_DualMemberFactory->GetMemberFunction( sitkFloat32, sitkFloat32, FixedImageDimension )();
@@ -203,43 +417,68 @@ ElastixImageFilter::ElastixImageFilterImpl
   {
     ElastixRegistrationMethodPointer elastixFilter = ElastixRegistrationMethodType::New();
 
+    // the number of threads of the filter is used by elastix and by the
+    // casts of its inputs
+    const unsigned int numberOfThreads = GetElastixNumberOfThreads( this->GetNumberOfThreads() );
+
+    // the smoothed fixed images are found in the cache by the buffer of the
+    // fixed images, so these are cast once by the cache
+    std::vector< Image > fixedImages;
     for( unsigned int i = 0; i < this->GetNumberOfFixedImages(); ++i )
     {
-      elastixFilter->AddFixedImage( itkDynamicCastInDebugMode< TFixedImage* >( Cast( this->GetFixedImage( i ), sitkFloat32 ).GetITKBase() ) );
+      fixedImages.push_back( this->m_FixedImagePyramidCache
+                             ? this->m_FixedImagePyramidCache->GetInputImage( this->GetFixedImage( i ), sitkFloat32, numberOfThreads )
+                             : this->GetFixedImage( i ) );
+      elastixFilter->AddFixedImage( GetElastixInputImage< TFixedImage >( fixedImages.back(), sitkFloat32, numberOfThreads ) );
     }
 
     for( unsigned int i = 0; i < this->GetNumberOfMovingImages(); ++i )
     {
-      elastixFilter->AddMovingImage( itkDynamicCastInDebugMode< TMovingImage* >( Cast( this->GetMovingImage( i ), sitkFloat32 ).GetITKBase() ) );
+      elastixFilter->AddMovingImage( GetElastixInputImage< TMovingImage >( this->GetMovingImage( i ), sitkFloat32, numberOfThreads ) );
     }
 
     for( unsigned int i = 0; i < this->GetNumberOfFixedMasks(); ++i )
     {
-      elastixFilter->AddFixedMask( itkDynamicCastInDebugMode< FixedMaskType* >( this->GetFixedMask( i ).GetITKBase() ) );
+      elastixFilter->AddFixedMask( GetElastixInputImage< FixedMaskType >( this->GetFixedMask( i ), sitkUInt8, numberOfThreads ) );
     }
 
     for( unsigned int i = 0; i < this->GetNumberOfMovingMasks(); ++i )
     {
-      elastixFilter->AddMovingMask( itkDynamicCastInDebugMode< MovingMaskType* >( this->GetMovingMask( i ).GetITKBase() ) );
+      elastixFilter->AddMovingMask( GetElastixInputImage< MovingMaskType >( this->GetMovingMask( i ), sitkUInt8, numberOfThreads ) );
     }
 
     elastixFilter->SetInitialTransformParameterFileName( this->GetInitialTransformParameterFileName() );
     elastixFilter->SetFixedPointSetFileName( this->GetFixedPointSetFileName() );
     elastixFilter->SetMovingPointSetFileName( this->GetMovingPointSetFileName() );
 
-    elastixFilter->SetOutputDirectory( this->GetOutputDirectory() );
-    elastixFilter->SetLogFileName( this->GetLogFileName() );
-    elastixFilter->SetLogToFile( this->GetLogToFile() );
+    // elastix writes no file without an output directory
+    const bool inMemory = this->GetInMemory();
+    elastixFilter->SetOutputDirectory( inMemory ? std::string() : this->GetOutputDirectory() );
+    elastixFilter->SetLogFileName( inMemory ? std::string() : this->GetLogFileName() );
+    elastixFilter->SetLogToFile( !inMemory && this->GetLogToFile() );
     elastixFilter->SetLogToConsole( this->GetLogToConsole() );
     elastixFilter->SetNumberOfThreads( this->GetNumberOfThreads() );
 
-    ParameterMapVectorType parameterMapVector = this->m_ParameterMapVector;
+    ParameterMapVectorType parameterMapVector = this->GetParameterMap();
     for( unsigned int i = 0; i < parameterMapVector.size(); i++ )
     {
       parameterMapVector[ i ][ "FixedInternalImagePixelType" ]
         = ParameterValueVectorType( 1, "float" );
       parameterMapVector[ i ][ "MovingInternalImagePixelType" ]
         = ParameterValueVectorType( 1, "float" );
+
+      if( inMemory )
+      {
+        for( const char * writeParameter : { "WriteIterationInfo",
+                                             "WriteTransformParametersEachIteration",
+                                             "WriteTransformParametersEachResolution",
+                                             "WriteResultImageAfterEachResolution",
+                                             "WritePyramidImagesAfterEachResolution",
+                                             "WriteSamplesEveryIteration" } )
+        {
+          parameterMapVector[ i ][ writeParameter ] = ParameterValueVectorType( 1, "false" );
+        }
+      }
     }
 
     // Always set WriteResultImage to true. If WriteResultImage is false, elastixFilter will not produce an output image,
@@ -251,7 +490,125 @@ ElastixImageFilter::ElastixImageFilterImpl
     parameterObject->SetParameterMap( parameterMapVector );
     elastixFilter->SetParameterObject( parameterObject );
 
-    elastixFilter->Update();
+    // abort the registration when cancelled
+    if( this->m_CancellationToken )
+    {
+      ElastixRegistrationMethodType * cancelledProcess = elastixFilter.GetPointer();
+      auto abortIfCancelled = [this, cancelledProcess]( const itk::EventObject & ) {
+        if( this->IsCancelled() )
+        {
+          cancelledProcess->AbortGenerateDataOn();
+        }
+      };
+      elastixFilter->AddObserver( itk::ProgressEvent(), abortIfCancelled );
+      elastixFilter->AddObserver( itk::IterationEvent(), abortIfCancelled );
+    }
+
+    // connect the commands
+    this->m_OptimizerIteration = 0;
+    this->m_MetricValue = 0.0;
+    this->m_CurrentLevel = 0;
+    ElastixRegistrationMethodType * elastixProcess = elastixFilter.GetPointer();
+    this->m_CommandProcessObject->SetNumberOfThreads( numberOfThreads );
+    this->m_CommandProcessObject->PreUpdate( elastixProcess );
+
+    // The iterations are followed in the console log, which is then always
+    // written by elastix, and passed on only when it is logged to the
+    // console. In the in-memory mode it is sent to the SimpleITK logger.
+    std::unique_ptr< StreamLineRedirect > redirectConsole;
+    bool aborted = false;
+    if( !this->m_BatchJob )
+    {
+      const bool logToConsole = this->GetLogToConsole();
+      std::shared_ptr< ElastixLogParser > logParser = std::make_shared< ElastixLogParser >( parameterMapVector );
+      auto handleLine = [this, elastixProcess, logParser, logToConsole, inMemory, &aborted]( const std::string & line, std::streambuf * previous ) {
+        if( logToConsole )
+        {
+          if( inMemory )
+          {
+            itk::OutputWindow::GetInstance()->DisplayText( line.c_str() );
+          }
+          else
+          {
+            previous->sputn( line.data(), static_cast< std::streamsize >( line.size() ) );
+          }
+        }
+
+        // elastix logs the abort exception as well
+        if( aborted )
+        {
+          return;
+        }
+
+        switch( logParser->Parse( line ) )
+        {
+          case ElastixLogParser::ResolutionLine:
+            this->m_CurrentLevel = logParser->GetLevel();
+            elastixProcess->InvokeEvent( itk::MultiResolutionIterationEvent() );
+            break;
+          case ElastixLogParser::IterationLine:
+            this->m_OptimizerIteration = logParser->GetIteration();
+            this->m_MetricValue = logParser->GetMetricValue();
+            elastixProcess->InvokeEvent( itk::IterationEvent() );
+            elastixProcess->UpdateProgress( logParser->GetProgress() );
+            break;
+          default:
+            return;
+        }
+
+        if( elastixProcess->GetAbortGenerateData() )
+        {
+          aborted = true;
+          elastixProcess->InvokeEvent( itk::AbortEvent() );
+          throw itk::ProcessAborted( __FILE__, __LINE__ );
+        }
+      };
+      elastixFilter->SetLogToConsole( true );
+      redirectConsole.reset( new StreamLineRedirect( std::cout, handleLine, true ) );
+    }
+
+    // elastix sets the global maximum number of threads to its number of
+    // threads, which is restored after the registration, or after the batch
+    const itk::ThreadIdType globalMaximumNumberOfThreads = itk::MultiThreaderBase::GetGlobalMaximumNumberOfThreads();
+    const bool restoreGlobalMaximumNumberOfThreads = !this->m_BatchJob && this->GetNumberOfThreads() > 0;
+    auto restoreThreads = make_scope_exit( [globalMaximumNumberOfThreads, restoreGlobalMaximumNumberOfThreads] {
+        if( restoreGlobalMaximumNumberOfThreads )
+        {
+          itk::MultiThreaderBase::SetGlobalMaximumNumberOfThreads( globalMaximumNumberOfThreads );
+        }
+      } );
+
+    std::unique_ptr< ElastixPyramidCache::ScopedActivation > activatePyramidCache;
+    if( this->m_FixedImagePyramidCache )
+    {
+      ElastixPyramidCache::RegisterImageType< TFixedImage >();
+      activatePyramidCache.reset( new ElastixPyramidCache::ScopedActivation( this->m_FixedImagePyramidCache.get(), fixedImages ) );
+    }
+
+    try
+    {
+      elastixFilter->Update();
+    }
+    catch( itk::ExceptionObject & )
+    {
+      redirectConsole.reset();
+      if( this->IsCancelled() )
+      {
+        sitkExceptionMacro( "The execution of \"" << this->GetName() << "\" was cancelled." );
+      }
+      if( aborted || elastixFilter->GetAbortGenerateData() )
+      {
+        sitkExceptionMacro( "The execution of \"" << this->GetName() << "\" was aborted." );
+      }
+      throw;
+    }
+    redirectConsole.reset();
+    elastixFilter->UpdateProgress( 1.0f );
+
+    if( this->IsCancelled() )
+    {
+      sitkExceptionMacro( "The execution of \"" << this->GetName() << "\" was cancelled." );
+    }
 
     this->m_ResultImage = Image( itkDynamicCastInDebugMode< TFixedImage* >( elastixFilter->GetOutput() ) );
     this->m_ResultImage.MakeUnique();
@@ -265,6 +622,151 @@ ElastixImageFilter::ElastixImageFilterImpl
   return this->m_ResultImage;
 }
 
+std::vector< Image >
+ElastixImageFilter::ElastixImageFilterImpl
+::ExecuteBatch( const std::vector< Image > &fixedImages,
+                const std::vector< Image > &movingImages,
+                const std::vector< ParameterMapVectorType > &parameterMapVectors )
+{
+  const size_t numberOfJobs = movingImages.size();
+
+  if( fixedImages.size() != 1 && fixedImages.size() != numberOfJobs )
+  {
+    sitkExceptionMacro( "Number of fixed images must be 1 or " << numberOfJobs << " (the number of moving images)." );
+  }
+
+  if( parameterMapVectors.size() > 1 && parameterMapVectors.size() != numberOfJobs )
+  {
+    sitkExceptionMacro( "Number of parameter map vectors must be 0, 1 or " << numberOfJobs << " (the number of moving images)." );
+  }
+
+  if( this->IsCancelled() )
+  {
+    sitkExceptionMacro( "The execution of \"" << this->GetName() << "\" was cancelled." );
+  }
+
+  this->m_BatchTransformParameterMapVectors.clear();
+  std::vector< Image > resultImages( numberOfJobs );
+  std::vector< ParameterMapVectorType > transformParameterMapVectors( numberOfJobs );
+  if( numberOfJobs == 0 )
+  {
+    return resultImages;
+  }
+
+  // the jobs share the smoothed fixed images of the batch
+  if( this->m_FixedImagePyramidCache )
+  {
+    this->m_FixedImagePyramidCache->Retain( fixedImages );
+  }
+
+  // the threads are divided between the concurrent registrations,
+  // instead of each registration using all of them
+  const unsigned int numberOfThreads = GetElastixNumberOfThreads( this->GetNumberOfThreads() );
+  const unsigned int numberOfWorkers = static_cast< unsigned int >( std::min< size_t >( numberOfThreads, numberOfJobs ) );
+  const unsigned int threadsPerRegistration = std::max( numberOfThreads / numberOfWorkers, 1u );
+
+  // The workers are configured on this thread, so the settings of the
+  // filter are copied before the registrations start.
+  std::vector< std::unique_ptr< ElastixImageFilterImpl > > workers;
+  for( unsigned int w = 0; w < numberOfWorkers; ++w )
+  {
+    workers.emplace_back( new ElastixImageFilterImpl() );
+    ElastixImageFilterImpl & worker = *workers.back();
+    worker.m_FixedMasks = this->m_FixedMasks;
+    worker.m_MovingMasks = this->m_MovingMasks;
+    worker.m_InitialTransformParameterMapFileName = this->m_InitialTransformParameterMapFileName;
+    worker.m_FixedPointSetFileName = this->m_FixedPointSetFileName;
+    worker.m_MovingPointSetFileName = this->m_MovingPointSetFileName;
+    worker.m_ParameterMapVector = this->m_ParameterMapVector;
+    worker.m_LogToConsole = this->m_LogToConsole;
+    worker.m_InMemory = true;
+    worker.m_BatchJob = true;
+    worker.m_FixedImagePyramidCache = this->m_FixedImagePyramidCache;
+    worker.m_NumberOfThreads = static_cast< int >( threadsPerRegistration );
+    if( this->m_CancellationToken )
+    {
+      worker.SetCancellationToken( *this->m_CancellationToken );
+    }
+  }
+
+  // elastix sets the global maximum number of threads to the number of
+  // threads of a registration, which is restored after the batch
+  const itk::ThreadIdType globalMaximumNumberOfThreads = itk::MultiThreaderBase::GetGlobalMaximumNumberOfThreads();
+
+  std::unique_ptr< OutputWindowStreamRedirect > redirectConsole;
+  if( this->GetLogToConsole() )
+  {
+    redirectConsole.reset( new OutputWindowStreamRedirect( std::cout ) );
+  }
+
+  std::atomic< size_t > next{ 0 };
+  std::atomic< bool >   failed{ false };
+  std::exception_ptr    firstException;
+  std::mutex            exceptionMutex;
+
+  auto work = [&]( unsigned int w ) {
+    ElastixImageFilterImpl & worker = *workers[ w ];
+    try
+    {
+      for( size_t i = next++; i < numberOfJobs && !failed; i = next++ )
+      {
+        worker.m_FixedImages = VectorOfImage( 1, fixedImages.size() == 1 ? fixedImages[ 0 ] : fixedImages[ i ] );
+        worker.m_MovingImages = VectorOfImage( 1, movingImages[ i ] );
+        if( !parameterMapVectors.empty() )
+        {
+          worker.SetParameterMap( parameterMapVectors.size() == 1 ? parameterMapVectors[ 0 ] : parameterMapVectors[ i ] );
+        }
+        resultImages[ i ] = worker.Execute();
+        transformParameterMapVectors[ i ] = worker.m_TransformParameterMapVector;
+      }
+    }
+    catch( ... )
+    {
+      std::lock_guard< std::mutex > lock( exceptionMutex );
+      if( !firstException )
+      {
+        firstException = std::current_exception();
+      }
+      failed = true;
+    }
+  };
+
+  std::vector< std::thread > threads;
+  threads.reserve( numberOfWorkers - 1 );
+  for( unsigned int w = 1; w < numberOfWorkers; ++w )
+  {
+    threads.emplace_back( work, w );
+  }
+  work( 0 );
+  for( std::thread & thread : threads )
+  {
+    thread.join();
+  }
+
+  redirectConsole.reset();
+  itk::MultiThreaderBase::SetGlobalMaximumNumberOfThreads( globalMaximumNumberOfThreads );
+
+  if( firstException )
+  {
+    std::rethrow_exception( firstException );
+  }
+
+  this->m_BatchTransformParameterMapVectors = transformParameterMapVectors;
+  return resultImages;
+}
+
+std::vector< ElastixImageFilter::ParameterMapVectorType >
+ElastixImageFilter::ElastixImageFilterImpl
+::GetBatchTransformParameterMap( void )
+{
+  if( this->m_BatchTransformParameterMapVectors.empty() )
+  {
+    sitkExceptionMacro( "No batch transform parameter maps found. Run registrations with ExecuteBatch()." )
+  }
+
+  return this->m_BatchTransformParameterMapVectors;
+}
+
 std::string
 ElastixImageFilter::ElastixImageFilterImpl
 ::GetName( void ) const
@@ -745,6 +1247,34 @@ ElastixImageFilter::ElastixImageFilterImpl
   this->SetLogToConsole( false );
 }
 
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::SetInMemory( bool inMemory )
+{
+  this->m_InMemory = inMemory;
+}
+
+bool
+ElastixImageFilter::ElastixImageFilterImpl
+::GetInMemory( void )
+{
+  return this->m_InMemory;
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::InMemoryOn()
+{
+  this->SetInMemory( true );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::InMemoryOff()
+{
+  this->SetInMemory( false );
+}
+
 void
 ElastixImageFilter::ElastixImageFilterImpl
 ::SetNumberOfThreads( int n )
@@ -761,39 +1291,180 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
+::SetCancellationToken( const CancellationToken & token )
 {
-  ParameterMapType parameterMap = ParameterObjectType::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
-  this->SetParameterMap( parameterMap );
+  this->m_CancellationToken.reset( new CancellationToken( token ) );
+}
+
+CancellationToken
+ElastixImageFilter::ElastixImageFilterImpl
+::GetCancellationToken( void ) const
+{
+  if( !this->m_CancellationToken )
+  {
+    sitkExceptionMacro( "No cancellation token is set." );
+  }
+  return *this->m_CancellationToken;
+}
+
+bool
+ElastixImageFilter::ElastixImageFilterImpl
+::HasCancellationToken( void ) const
+{
+  return bool( this->m_CancellationToken );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::RemoveCancellationToken( void )
+{
+  this->m_CancellationToken.reset();
+}
+
+bool
+ElastixImageFilter::ElastixImageFilterImpl
+::IsCancelled( void ) const
+{
+  return this->m_CancellationToken && this->m_CancellationToken->IsCancelled();
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::SetUseFixedImagePyramidCache( bool useFixedImagePyramidCache )
+{
+  if( !useFixedImagePyramidCache )
+  {
+    this->m_FixedImagePyramidCache.reset();
+  }
+  else if( !this->m_FixedImagePyramidCache )
+  {
+    this->m_FixedImagePyramidCache = std::make_shared< ElastixPyramidCache >();
+  }
+}
+
+bool
+ElastixImageFilter::ElastixImageFilterImpl
+::GetUseFixedImagePyramidCache( void ) const
+{
+  return static_cast< bool >( this->m_FixedImagePyramidCache );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::ClearFixedImagePyramidCache( void )
+{
+  if( this->m_FixedImagePyramidCache )
+  {
+    this->m_FixedImagePyramidCache->Clear();
+  }
+}
+
+int
+ElastixImageFilter::ElastixImageFilterImpl
+::AddCommand( itk::simple::EventEnum event, itk::simple::Command & cmd )
+{
+  return this->m_CommandProcessObject->AddCommand( event, cmd );
+}
+
+int
+ElastixImageFilter::ElastixImageFilterImpl
+::AddCommand( itk::simple::EventEnum event, const std::function< void() > & func )
+{
+  return this->m_CommandProcessObject->AddCommand( event, func );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::RemoveAllCommands( void )
+{
+  this->m_CommandProcessObject->RemoveAllCommands();
+}
+
+bool
+ElastixImageFilter::ElastixImageFilterImpl
+::HasCommand( itk::simple::EventEnum event ) const
+{
+  return this->m_CommandProcessObject->HasCommand( event );
+}
+
+float
+ElastixImageFilter::ElastixImageFilterImpl
+::GetProgress( void ) const
+{
+  return this->m_CommandProcessObject->GetProgress();
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::Abort( void )
+{
+  this->m_CommandProcessObject->Abort();
+}
+
+unsigned int
+ElastixImageFilter::ElastixImageFilterImpl
+::GetOptimizerIteration( void ) const
+{
+  return this->m_OptimizerIteration;
+}
+
+double
+ElastixImageFilter::ElastixImageFilterImpl
+::GetMetricValue( void ) const
+{
+  return this->m_MetricValue;
+}
+
+unsigned int
+ElastixImageFilter::ElastixImageFilterImpl
+::GetCurrentLevel( void ) const
+{
+  return this->m_CurrentLevel;
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameterMap( const ParameterMapType parameterMap )
+::SetParameterMap( const std::string & transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
 {
-  ParameterMapVectorType parameterMapVector = ParameterMapVectorType( 1, parameterMap );
-  this->SetParameterMap( parameterMapVector );
+  this->m_ParameterMapVector = SharedParameterMapVectorType( 1, GetSharedDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits ) );
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameterMap( const ParameterMapVectorType parameterMapVector )
+::SetParameterMap( const ParameterMapType & parameterMap )
 {
-  this->m_ParameterMapVector = parameterMapVector;
+  this->m_ParameterMapVector = SharedParameterMapVectorType( 1, std::make_shared< ParameterMapType >( parameterMap ) );
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::AddParameterMap( const ParameterMapType parameterMap )
+::SetParameterMap( const ParameterMapVectorType & parameterMapVector )
 {
-  this->m_ParameterMapVector.push_back( parameterMap );
+  this->m_ParameterMapVector.clear();
+  for( const ParameterMapType & parameterMap : parameterMapVector )
+  {
+    this->AddParameterMap( parameterMap );
+  }
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::AddParameterMap( const ParameterMapType & parameterMap )
+{
+  this->m_ParameterMapVector.push_back( std::make_shared< ParameterMapType >( parameterMap ) );
 }
 
 ElastixImageFilter::ElastixImageFilterImpl::ParameterMapVectorType
 ElastixImageFilter::ElastixImageFilterImpl
 ::GetParameterMap( void )
 {
-  return this->m_ParameterMapVector;
+  ParameterMapVectorType parameterMapVector;
+  parameterMapVector.reserve( this->m_ParameterMapVector.size() );
+  for( const std::shared_ptr< const ParameterMapType > & parameterMap : this->m_ParameterMapVector )
+  {
+    parameterMapVector.push_back( *parameterMap );
+  }
+  return parameterMapVector;
 }
 
 unsigned int
@@ -803,6 +1474,24 @@ ElastixImageFilter::ElastixImageFilterImpl
   return this->m_ParameterMapVector.size();
 }
 
+ElastixImageFilter::ElastixImageFilterImpl::ParameterMapType &
+ElastixImageFilter::ElastixImageFilterImpl
+::GetParameterMapForEdit( const unsigned int index )
+{
+  if( index >= this->m_ParameterMapVector.size() )
+  {
+    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
+  }
+
+  // copy the map on the first edit when it is shared
+  std::shared_ptr< const ParameterMapType > & parameterMap = this->m_ParameterMapVector[ index ];
+  if( parameterMap.use_count() > 1 )
+  {
+    parameterMap = std::make_shared< ParameterMapType >( *parameterMap );
+  }
+  return const_cast< ParameterMapType & >( *parameterMap );
+}
+
 void
 ElastixImageFilter::ElastixImageFilterImpl
 ::SetInitialTransformParameterFileName( const std::string initialTransformParameterFileName )
@@ -826,7 +1515,7 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameter( const ParameterKeyType key, const ParameterValueType value )
+::SetParameter( const ParameterKeyType & key, const ParameterValueType & value )
 {
   for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
   {
@@ -836,7 +1525,7 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameter( const ParameterKeyType key, const ParameterValueVectorType value )
+::SetParameter( const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
   for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
   {
@@ -846,31 +1535,62 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value )
 {
-  if( index >= this->m_ParameterMapVector.size() )
-  {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << "; number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
-  }
-
-  this->m_ParameterMapVector[ index ][ key ] = ParameterValueVectorType( 1, value );
+  this->SetParameter( index, key, ParameterValueVectorType( 1, value ) );
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::SetParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
   if( index >= this->m_ParameterMapVector.size() )
   {
     sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
   }
 
-  this->m_ParameterMapVector[ index ][ key ] = value;
+  // a map already holding the value is not copied
+  const ParameterMapType & parameterMap = *this->m_ParameterMapVector[ index ];
+  ParameterMapConstIterator iter = parameterMap.find( key );
+  if( iter != parameterMap.end() && iter->second == value )
+  {
+    return;
+  }
+
+  this->GetParameterMapForEdit( index )[ key ] = value;
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::SetParameter( const ParameterKeyType & key, const double value )
+{
+  this->SetParameter( key, FormatParameterValue( value ) );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::SetParameter( const ParameterKeyType & key, const std::vector< double > & value )
+{
+  this->SetParameter( key, FormatParameterValues( value ) );
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::AddParameter( const ParameterKeyType key, const ParameterValueType value )
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const double value )
+{
+  this->SetParameter( index, key, FormatParameterValue( value ) );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::SetParameter( const unsigned int index, const ParameterKeyType & key, const std::vector< double > & value )
+{
+  this->SetParameter( index, key, FormatParameterValues( value ) );
+}
+
+void
+ElastixImageFilter::ElastixImageFilterImpl
+::AddParameter( const ParameterKeyType & key, const ParameterValueType & value )
 {
   for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
   {
@@ -880,7 +1600,7 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::AddParameter( const ParameterKeyType key, const ParameterValueVectorType value )
+::AddParameter( const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
   for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
   {
@@ -890,48 +1610,22 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueType value )
+::AddParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value )
 {
-  if( index >= this->m_ParameterMapVector.size() )
-  {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
-  }
-
-  if( this->m_ParameterMapVector[ index ].find( key ) == this->m_ParameterMapVector[ index ].end() )
-  {
-    this->SetParameter( index, key, value );
-  }
-  else
-  {
-    this->m_ParameterMapVector[ index ][ key ].push_back( value );
-  }
+  this->AddParameter( index, key, ParameterValueVectorType( 1, value ) );
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::AddParameter( const unsigned int index, const ParameterKeyType key, const ParameterValueVectorType value )
+::AddParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueVectorType & value )
 {
-  if( index >= this->m_ParameterMapVector.size() )
-  {
-    sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
-  }
-
-  if( this->m_ParameterMapVector[ index ].find( key ) == this->m_ParameterMapVector[ index ].end() )
-  {
-    this->SetParameter( index, key, value );
-  }
-  else
-  {
-    for( unsigned int i = 0; i < value.size(); i++ )
-    {
-      this->m_ParameterMapVector[ index ][ key ].push_back( value[ i ] );
-    }
-  }
+  ParameterValueVectorType & values = this->GetParameterMapForEdit( index )[ key ];
+  values.insert( values.end(), value.begin(), value.end() );
 }
 
 ElastixImageFilter::ElastixImageFilterImpl::ParameterValueVectorType
 ElastixImageFilter::ElastixImageFilterImpl
-::GetParameter( const ParameterKeyType key )
+::GetParameter( const ParameterKeyType & key )
 {
   if( this->m_ParameterMapVector.size() > 1 )
   {
@@ -943,19 +1637,21 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 ElastixImageFilter::ElastixImageFilterImpl::ParameterValueVectorType
 ElastixImageFilter::ElastixImageFilterImpl
-::GetParameter( const unsigned int index, const ParameterKeyType key )
+::GetParameter( const unsigned int index, const ParameterKeyType & key )
 {
   if( index >= this->m_ParameterMapVector.size() )
   {
     sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
   }
 
-  return this->m_ParameterMapVector[ index ][ key ];
+  const ParameterMapType & parameterMap = *this->m_ParameterMapVector[ index ];
+  ParameterMapConstIterator iter = parameterMap.find( key );
+  return iter != parameterMap.end() ? iter->second : ParameterValueVectorType();
 }
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::RemoveParameter( const ParameterKeyType key )
+::RemoveParameter( const ParameterKeyType & key )
 {
   for( unsigned int i = 0; i < this->m_ParameterMapVector.size(); i++ )
   {
@@ -965,14 +1661,17 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 void
 ElastixImageFilter::ElastixImageFilterImpl
-::RemoveParameter( const unsigned int index, const ParameterKeyType key )
+::RemoveParameter( const unsigned int index, const ParameterKeyType & key )
 {
   if( index >= this->m_ParameterMapVector.size() )
   {
     sitkExceptionMacro( "Parameter map index is out of range (index: " << index << ", number of parameters maps: " << this->m_ParameterMapVector.size() << "). Note that indexes are zero-based." );
   }
 
-  this->m_ParameterMapVector[ index ].erase( key );
+  if( this->m_ParameterMapVector[ index ]->count( key ) )
+  {
+    this->GetParameterMapForEdit( index ).erase( key );
+  }
 }
 
 ElastixImageFilter::ElastixImageFilterImpl::ParameterMapType
@@ -994,9 +1693,9 @@ ElastixImageFilter::ElastixImageFilterImpl
 
 ElastixImageFilter::ElastixImageFilterImpl::ParameterMapType
 ElastixImageFilter::ElastixImageFilterImpl
-::GetDefaultParameterMap( const std::string transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
+::GetDefaultParameterMap( const std::string & transformName, const unsigned int numberOfResolutions, const double finalGridSpacingInPhysicalUnits )
 {
-  return ParameterObjectType::GetDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
+  return *GetSharedDefaultParameterMap( transformName, numberOfResolutions, finalGridSpacingInPhysicalUnits );
 }
 
 ElastixImageFilter::ElastixImageFilterImpl::ParameterMapVectorType
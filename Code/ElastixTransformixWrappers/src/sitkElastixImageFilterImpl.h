@@ -5,6 +5,8 @@
 #include "sitkElastixImageFilter.h"
 #include "sitkMemberFunctionFactory.h"
 #include "sitkDualMemberFunctionFactory.h"
+#include "sitkProcessObject.h"
+#include "sitkElastixPyramidCache.h"
 
 // Elastix
 #include "itkElastixRegistrationMethod.h"
@@ -13,6 +15,15 @@
 namespace itk {
   namespace simple {
 
+// The process object of the commands of the filter, which connects them to
+// the elastix process while it executes.
+class SITKElastix_HIDDEN ElastixCommandProcessObject : public ProcessObject
+{
+public:
+  std::string GetName( void ) const override { return "ElastixImageFilter"; }
+  using ProcessObject::PreUpdate;
+};
+
 class SITKElastix_HIDDEN ElastixImageFilter::ElastixImageFilterImpl
 {
 public:
@@ -99,29 +110,58 @@ public:
   void LogToConsoleOn();
   void LogToConsoleOff();
 
+  void SetInMemory( bool );
+  bool GetInMemory( void );
+  void InMemoryOn();
+  void InMemoryOff();
+
   void SetNumberOfThreads( int n );
   int GetNumberOfThreads( void );
 
-  void SetParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4u, const double finalGridSpacingInPhysicalUnits = 10.0 );
-  void SetParameterMap( const std::vector< std::map< std::string, std::vector< std::string > > > parameterMapVector );
-  void SetParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
-  void AddParameterMap( const std::map< std::string, std::vector< std::string > > parameterMap );
-  std::vector< std::map< std::string, std::vector< std::string > > > GetParameterMap( void );
-  std::map< std::string, std::vector< std::string > > GetDefaultParameterMap( const std::string transformName, const unsigned int numberOfResolutions = 4, const double finalGridSpacingInPhysicalUnits = 10.0 );
+  void SetCancellationToken( const CancellationToken & token );
+  CancellationToken GetCancellationToken( void ) const;
+  bool HasCancellationToken( void ) const;
+  void RemoveCancellationToken( void );
+  bool IsCancelled( void ) const;
+
+  void SetUseFixedImagePyramidCache( bool useFixedImagePyramidCache );
+  bool GetUseFixedImagePyramidCache( void ) const;
+  void ClearFixedImagePyramidCache( void );
+
+  int AddCommand( itk::simple::EventEnum event, itk::simple::Command & cmd );
+  int AddCommand( itk::simple::EventEnum event, const std::function< void() > & func );
+  void RemoveAllCommands( void );
+  bool HasCommand( itk::simple::EventEnum event ) const;
+  float GetProgress( void ) const;
+  void Abort( void );
+  unsigned int GetOptimizerIteration( void ) const;
+  double GetMetricValue( void ) const;
+  unsigned int GetCurrentLevel( void ) const;
+
+  void SetParameterMap( const std::string & transformName, const unsigned int numberOfResolutions = 4u, const double finalGridSpacingInPhysicalUnits = 10.0 );
+  void SetParameterMap( const ParameterMapVectorType & parameterMapVector );
+  void SetParameterMap( const ParameterMapType & parameterMap );
+  void AddParameterMap( const ParameterMapType & parameterMap );
+  ParameterMapVectorType GetParameterMap( void );
+  ParameterMapType GetDefaultParameterMap( const std::string & transformName, const unsigned int numberOfResolutions = 4, const double finalGridSpacingInPhysicalUnits = 10.0 );
   unsigned int GetNumberOfParameterMaps( void );
 
-  void SetParameter( const std::string key, const std::string value );
-  void SetParameter( const std::string key, const std::vector< std::string > value );
-  void SetParameter( const unsigned int index, const std::string key, const std::string value );
-  void SetParameter( const unsigned int index, const std::string key, const std::vector< std::string > value );
-  void AddParameter( const std::string key, const std::string value );
-  void AddParameter( const unsigned int index, const std::string key, const std::string value );
-  void AddParameter( const std::string key, const std::vector< std::string > value );
-  void AddParameter( const unsigned int index, const std::string key, const std::vector< std::string > value );
-  std::vector< std::string > GetParameter( const std::string key );
-  std::vector< std::string > GetParameter( const unsigned int index, const std::string key );
-  void RemoveParameter( const std::string key );
-  void RemoveParameter( const unsigned int index, const std::string key );
+  void SetParameter( const ParameterKeyType & key, const ParameterValueType & value );
+  void SetParameter( const ParameterKeyType & key, const ParameterValueVectorType & value );
+  void SetParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value );
+  void SetParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueVectorType & value );
+  void SetParameter( const ParameterKeyType & key, const double value );
+  void SetParameter( const ParameterKeyType & key, const std::vector< double > & value );
+  void SetParameter( const unsigned int index, const ParameterKeyType & key, const double value );
+  void SetParameter( const unsigned int index, const ParameterKeyType & key, const std::vector< double > & value );
+  void AddParameter( const ParameterKeyType & key, const ParameterValueType & value );
+  void AddParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueType & value );
+  void AddParameter( const ParameterKeyType & key, const ParameterValueVectorType & value );
+  void AddParameter( const unsigned int index, const ParameterKeyType & key, const ParameterValueVectorType & value );
+  ParameterValueVectorType GetParameter( const ParameterKeyType & key );
+  ParameterValueVectorType GetParameter( const unsigned int index, const ParameterKeyType & key );
+  void RemoveParameter( const ParameterKeyType & key );
+  void RemoveParameter( const unsigned int index, const ParameterKeyType & key );
 
   void SetInitialTransformParameterFileName( const std::string initialTransformParmaterFileName );
   std::string GetInitialTransformParameterFileName( void );
@@ -135,12 +175,20 @@ public:
   std::map< std::string, std::vector< std::string > > GetTransformParameterMap( const unsigned int index );
   Image GetResultImage( void );
 
+  std::vector< Image > ExecuteBatch( const std::vector< Image > &fixedImages,
+                                     const std::vector< Image > &movingImages,
+                                     const std::vector< ParameterMapVectorType > &parameterMapVectors );
+  std::vector< ParameterMapVectorType > GetBatchTransformParameterMap( void );
+
   void PrintParameterMap( void );
   void PrintParameterMap( const ParameterMapType parameterMapVector );
   void PrintParameterMap( const ParameterMapVectorType parameterMapVector );
 
   bool IsEmpty( const Image& image );
 
+  // The parameter map at index, copied first when it is shared.
+  ParameterMapType & GetParameterMapForEdit( const unsigned int index );
+
   // Definitions for SimpleITK member factory
   typedef Image ( Self::*MemberFunctionType )( void );
   template< class TFixedImage, class TMovingImage > Image DualExecuteInternal( void );
@@ -157,7 +205,10 @@ public:
   std::string             m_FixedPointSetFileName;
   std::string             m_MovingPointSetFileName;
 
-  ParameterMapVectorType  m_ParameterMapVector;
+  // The parameter maps are shared, between the filters and with the
+  // default parameter maps, until they are edited.
+  typedef std::vector< std::shared_ptr< const ParameterMapType > > SharedParameterMapVectorType;
+  SharedParameterMapVectorType m_ParameterMapVector;
   ParameterMapVectorType  m_TransformParameterMapVector;
 
   std::string             m_OutputDirectory;
@@ -165,9 +216,28 @@ public:
 
   bool                    m_LogToFile;
   bool                    m_LogToConsole;
+  bool                    m_InMemory;
 
   int                     m_NumberOfThreads;
 
+  std::unique_ptr< CancellationToken > m_CancellationToken;
+
+  std::vector< ParameterMapVectorType > m_BatchTransformParameterMapVectors;
+
+  // The batch jobs do not redirect the global console stream, which is
+  // redirected once for all of them, and share the pyramid cache retained
+  // by the batch.
+  bool                    m_BatchJob;
+
+  std::shared_ptr< ElastixPyramidCache > m_FixedImagePyramidCache;
+
+  std::unique_ptr< ElastixCommandProcessObject > m_CommandProcessObject;
+
+  // the last iteration reported in the console log of elastix
+  unsigned int            m_OptimizerIteration;
+  double                  m_MetricValue;
+  unsigned int            m_CurrentLevel;
+
 };
 
 } // end namespace simple
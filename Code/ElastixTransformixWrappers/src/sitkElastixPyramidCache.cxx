@@ -0,0 +1,186 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkElastixPyramidCache.h"
+#include "sitkInternalUtilities.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace itk {
+  namespace simple {
+
+namespace {
+thread_local ElastixPyramidCache::ScopedActivation * ActiveCache = nullptr;
+}
+
+bool
+ElastixPyramidCache::KeyType
+::operator<( const KeyType & other ) const
+{
+  return std::tie( buffer, type, parameters ) < std::tie( other.buffer, other.type, other.parameters );
+}
+
+
+ElastixPyramidCache::ScopedActivation
+::ScopedActivation( ElastixPyramidCache * cache, const std::vector< Image > & sources )
+  : m_Cache( cache ),
+    m_Sources( sources ),
+    m_Previous( ActiveCache )
+{
+  ActiveCache = this;
+}
+
+ElastixPyramidCache::ScopedActivation
+::~ScopedActivation()
+{
+  ActiveCache = m_Previous;
+}
+
+
+ElastixPyramidCache *
+ElastixPyramidCache
+::GetActive( const void * buffer, Image & source )
+{
+  if( !ActiveCache || !ActiveCache->m_Cache )
+  {
+    return nullptr;
+  }
+  for( const Image & image : ActiveCache->m_Sources )
+  {
+    if( image.GetBufferAsVoid() == buffer )
+    {
+      source = image;
+      return ActiveCache->m_Cache;
+    }
+  }
+  return nullptr;
+}
+
+
+Image
+ElastixPyramidCache
+::GetInputImage( const Image & image, PixelIDValueEnum pixelID, unsigned int numberOfThreads )
+{
+  if( image.GetPixelID() == pixelID )
+  {
+    return image;
+  }
+
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  for( const auto & inputImage : m_InputImages )
+  {
+    if( inputImage.first.GetBufferAsVoid() == image.GetBufferAsVoid() && inputImage.second.GetPixelID() == pixelID )
+    {
+      return inputImage.second;
+    }
+  }
+  m_InputImages.emplace_back( image, CastElastixImage( image, pixelID, numberOfThreads ) );
+  return m_InputImages.back().second;
+}
+
+
+itk::DataObject::Pointer
+ElastixPyramidCache
+::FindOrReserve( const KeyType & key )
+{
+  std::unique_lock< std::mutex > lock( m_Mutex );
+  m_Reserved.wait( lock, [this, &key] { return m_Reservations.count( key ) == 0; } );
+
+  auto iter = m_Entries.find( key );
+  if( iter == m_Entries.end() )
+  {
+    m_Reservations.insert( key );
+    return nullptr;
+  }
+  return iter->second.output;
+}
+
+
+void
+ElastixPyramidCache
+::Insert( const KeyType & key, const Image & source, itk::DataObject * output )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    m_Entries.emplace( key, EntryType{ source, output } );
+    m_Reservations.erase( key );
+  }
+  m_Reserved.notify_all();
+}
+
+
+void
+ElastixPyramidCache
+::Cancel( const KeyType & key )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    m_Reservations.erase( key );
+  }
+  m_Reserved.notify_all();
+}
+
+
+void
+ElastixPyramidCache
+::Retain( const std::vector< Image > & images )
+{
+  std::vector< const void * > buffers;
+  for( const Image & image : images )
+  {
+    buffers.push_back( image.GetBufferAsVoid() );
+  }
+  auto isRetained = [&buffers]( const Image & image ) {
+    return std::find( buffers.begin(), buffers.end(), image.GetBufferAsVoid() ) != buffers.end();
+  };
+
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  m_InputImages.erase( std::remove_if( m_InputImages.begin(), m_InputImages.end(),
+                                       [&isRetained]( const std::pair< Image, Image > & inputImage ) { return !isRetained( inputImage.first ); } ),
+                       m_InputImages.end() );
+
+  // the entries are of the images which are registered
+  for( const auto & inputImage : m_InputImages )
+  {
+    buffers.push_back( inputImage.second.GetBufferAsVoid() );
+  }
+  for( auto iter = m_Entries.begin(); iter != m_Entries.end(); )
+  {
+    if( !isRetained( iter->second.source ) )
+    {
+      iter = m_Entries.erase( iter );
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+
+void
+ElastixPyramidCache
+::Clear()
+{
+  std::lock_guard< std::mutex > lock( m_Mutex );
+  m_Entries.clear();
+  m_InputImages.clear();
+}
+
+} // end namespace simple
+} // end namespace itk
@@ -0,0 +1,310 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkElastixPyramidCache_h
+#define sitkElastixPyramidCache_h
+
+#include "sitkElastixTransformixWrappers.h"
+#include "sitkImage.h"
+#include "sitkNonCopyable.h"
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkObjectFactoryBase.h"
+#include "itkVersion.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <typeindex>
+#include <vector>
+
+namespace itk {
+  namespace simple {
+
+/** \class ElastixPyramidCache
+* \brief Store the smoothed fixed images of the resolutions of elastix.
+*
+* elastix smooths the fixed images for each resolution in the fixed image
+* pyramid on every registration. When a cache is activated on a thread, the
+* smoothing filters of the pyramids look up their output in the cache, keyed
+* by the buffer and geometry of the input and the smoothing parameters, and only
+* execute when it is missing. Only the fixed images are cached, as they are
+* the ones shared by the registrations of an atlas to many images.
+*
+* The cache keeps a reference to the SimpleITK images of the cached inputs,
+* so that modifying one of them makes a copy of its buffer which no longer
+* matches the cached entries.
+*/
+class SITKElastix_HIDDEN ElastixPyramidCache
+  : protected NonCopyable
+{
+public:
+  struct KeyType
+  {
+    const void * buffer;
+    std::type_index type;
+    std::vector< double > parameters;
+
+    bool operator<( const KeyType & other ) const;
+  };
+
+  /** Activate a cache on the current thread for the smoothing of the
+  * sources, while the object exists. */
+  class ScopedActivation
+  {
+  public:
+    ScopedActivation( ElastixPyramidCache * cache, const std::vector< Image > & sources );
+    ~ScopedActivation();
+  private:
+    ElastixPyramidCache * m_Cache;
+    std::vector< Image > m_Sources;
+    ScopedActivation * m_Previous;
+
+    friend class ElastixPyramidCache;
+  };
+
+  /** Get the active cache of the current thread if buffer belongs to one of
+  * its sources, which is returned in source. */
+  static ElastixPyramidCache * GetActive( const void * buffer, Image & source );
+
+  /** Get the image of pixel type pixelID to register instead of image. An
+  * image of another pixel type is cast once with numberOfThreads, and the cast image is kept
+  * while image is one of the retained images, so that its smoothed images
+  * are found by the following registrations. */
+  Image GetInputImage( const Image & image, PixelIDValueEnum pixelID, unsigned int numberOfThreads );
+
+  /** Get the cached output of key. When it is missing, the key is reserved
+  * for the caller, which must then call Insert or Cancel, and other threads
+  * wait for it instead of smoothing the same image. */
+  itk::DataObject::Pointer FindOrReserve( const KeyType & key );
+
+  void Insert( const KeyType & key, const Image & source, itk::DataObject * output );
+
+  void Cancel( const KeyType & key );
+
+  /** Remove the entries and the cast images which are not of one of the
+  * images. */
+  void Retain( const std::vector< Image > & images );
+
+  void Clear();
+
+  /** Graft the cached output of key to the filter, or execute generateData
+  * and cache the output of the filter. */
+  template< typename TFilter, typename TGenerateData >
+  void GenerateData( const KeyType & key, const Image & source, TFilter * filter, TGenerateData && generateData );
+
+  /** Override the smoothing filters of the elastix pyramids of TImageType
+  * with the caching filters, once. */
+  template< typename TImageType >
+  static void RegisterImageType();
+
+private:
+  struct EntryType
+  {
+    Image source;
+    itk::DataObject::Pointer output;
+  };
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Reserved;
+  std::map< KeyType, EntryType > m_Entries;
+  std::set< KeyType > m_Reservations;
+  std::vector< std::pair< Image, Image > > m_InputImages;
+};
+
+
+/** The key of the output of a smoothing filter, from the geometry of its
+* input and its smoothing parameters. */
+template< typename TFilter >
+std::vector< double > GetElastixPyramidGeometry( const TFilter * filter )
+{
+  typedef typename TFilter::InputImageType InputImageType;
+  constexpr unsigned int Dimension = InputImageType::ImageDimension;
+
+  const InputImageType * input = filter->GetInput();
+  std::vector< double > parameters;
+  const typename InputImageType::RegionType & region = input->GetLargestPossibleRegion();
+  for( unsigned int d = 0; d < Dimension; ++d )
+  {
+    parameters.push_back( region.GetIndex()[ d ] );
+    parameters.push_back( region.GetSize()[ d ] );
+    parameters.push_back( input->GetOrigin()[ d ] );
+    parameters.push_back( input->GetSpacing()[ d ] );
+    for( unsigned int e = 0; e < Dimension; ++e )
+    {
+      parameters.push_back( input->GetDirection()[ d ][ e ] );
+    }
+  }
+  return parameters;
+}
+
+template< typename TImageType >
+std::vector< double > GetElastixPyramidParameters( const itk::DiscreteGaussianImageFilter< TImageType, TImageType > * filter )
+{
+  std::vector< double > parameters = GetElastixPyramidGeometry( filter );
+  for( unsigned int d = 0; d < TImageType::ImageDimension; ++d )
+  {
+    parameters.push_back( filter->GetVariance()[ d ] );
+    parameters.push_back( filter->GetMaximumError()[ d ] );
+  }
+  parameters.push_back( filter->GetMaximumKernelWidth() );
+  parameters.push_back( filter->GetFilterDimensionality() );
+  parameters.push_back( filter->GetUseImageSpacing() );
+  return parameters;
+}
+
+template< typename TImageType >
+std::vector< double > GetElastixPyramidParameters( const itk::SmoothingRecursiveGaussianImageFilter< TImageType, TImageType > * filter )
+{
+  std::vector< double > parameters = GetElastixPyramidGeometry( filter );
+  for( unsigned int d = 0; d < TImageType::ImageDimension; ++d )
+  {
+    parameters.push_back( filter->GetSigmaArray()[ d ] );
+  }
+  parameters.push_back( filter->GetNormalizeAcrossScale() );
+  return parameters;
+}
+
+
+/** A smoothing filter of the elastix pyramids using the active
+* ElastixPyramidCache. */
+template< typename TSuperclass >
+class ElastixPyramidCacheFilter
+  : public TSuperclass
+{
+public:
+  typedef ElastixPyramidCacheFilter       Self;
+  typedef TSuperclass                     Superclass;
+  typedef itk::SmartPointer< Self >       Pointer;
+  typedef itk::SmartPointer< const Self > ConstPointer;
+
+  itkFactorylessNewMacro( Self );
+  itkTypeMacro( ElastixPyramidCacheFilter, TSuperclass );
+
+protected:
+  ElastixPyramidCacheFilter() = default;
+
+  void GenerateData() override
+  {
+    typedef typename Superclass::InputImageType InputImageType;
+    const InputImageType * input = this->GetInput();
+
+    Image source;
+    ElastixPyramidCache * cache = ElastixPyramidCache::GetActive( input->GetBufferPointer(), source );
+    if( !cache )
+    {
+      Superclass::GenerateData();
+      return;
+    }
+
+    const ElastixPyramidCache::KeyType key{ input->GetBufferPointer(),
+                                            std::type_index( typeid( Superclass ) ),
+                                            GetElastixPyramidParameters( static_cast< const Superclass * >( this ) ) };
+    cache->GenerateData( key, source, this, [this] { this->Superclass::GenerateData(); } );
+  }
+};
+
+
+template< typename TImageType >
+class ElastixPyramidCacheFactory
+  : public itk::ObjectFactoryBase
+{
+public:
+  typedef ElastixPyramidCacheFactory Self;
+  typedef itk::ObjectFactoryBase     Superclass;
+  typedef itk::SmartPointer< Self >  Pointer;
+
+  itkFactorylessNewMacro( Self );
+  itkTypeMacro( ElastixPyramidCacheFactory, ObjectFactoryBase );
+
+  const char * GetITKSourceVersion() const override { return ITK_SOURCE_VERSION; }
+  const char * GetDescription() const override { return "SimpleITK elastix fixed image pyramid cache"; }
+
+protected:
+  ElastixPyramidCacheFactory()
+  {
+    this->template RegisterOverrideOf< itk::DiscreteGaussianImageFilter< TImageType, TImageType > >();
+    this->template RegisterOverrideOf< itk::SmoothingRecursiveGaussianImageFilter< TImageType, TImageType > >();
+  }
+
+  template< typename TBase >
+  void RegisterOverrideOf()
+  {
+    typedef ElastixPyramidCacheFilter< TBase > OverrideType;
+    this->RegisterOverride( typeid( TBase ).name(),
+                            typeid( OverrideType ).name(),
+                            "Smoothing filter using the SimpleITK elastix pyramid cache",
+                            true,
+                            itk::CreateObjectFunction< OverrideType >::New() );
+  }
+};
+
+
+template< typename TFilter, typename TGenerateData >
+void ElastixPyramidCache::GenerateData( const KeyType & key, const Image & source, TFilter * filter, TGenerateData && generateData )
+{
+  typedef typename TFilter::OutputImageType OutputImageType;
+
+  itk::DataObject::Pointer cached = this->FindOrReserve( key );
+  if( OutputImageType * cachedImage = dynamic_cast< OutputImageType * >( cached.GetPointer() ) )
+  {
+    filter->GraftOutput( cachedImage );
+    return;
+  }
+
+  try
+  {
+    generateData();
+  }
+  catch( ... )
+  {
+    this->Cancel( key );
+    throw;
+  }
+
+  // an output computed in place, or of part of the image, is not cached
+  OutputImageType * output = filter->GetOutput();
+  if( output->GetBufferedRegion() == output->GetLargestPossibleRegion()
+      && static_cast< const void * >( output->GetBufferPointer() ) != key.buffer )
+  {
+    typename OutputImageType::Pointer stored = OutputImageType::New();
+    stored->Graft( output );
+    this->Insert( key, source, stored.GetPointer() );
+  }
+  else
+  {
+    this->Cancel( key );
+  }
+}
+
+
+template< typename TImageType >
+void ElastixPyramidCache::RegisterImageType()
+{
+  static std::once_flag registered;
+  std::call_once( registered, []
+    {
+      itk::ObjectFactoryBase::RegisterFactory( ElastixPyramidCacheFactory< TImageType >::New() );
+    } );
+}
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // sitkElastixPyramidCache_h
@@ -0,0 +1,272 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkElastixImageFilter.h"
+#include "sitkAffineTransform.h"
+#include "sitkBSplineTransform.h"
+#include "sitkCompositeTransform.h"
+#include "sitkEuler2DTransform.h"
+#include "sitkEuler3DTransform.h"
+#include "sitkSimilarity2DTransform.h"
+#include "sitkSimilarity3DTransform.h"
+#include "sitkTranslationTransform.h"
+
+#include <algorithm>
+#include <locale>
+#include <sstream>
+
+namespace itk {
+  namespace simple {
+
+namespace {
+
+typedef ElastixImageFilter::ParameterMapType       ParameterMapType;
+typedef ElastixImageFilter::ParameterMapVectorType ParameterMapVectorType;
+
+const std::vector< std::string > &
+GetParameterValues( const ParameterMapType & parameterMap, const std::string & key )
+{
+  ParameterMapType::const_iterator iter = parameterMap.find( key );
+  if( iter == parameterMap.end() || iter->second.empty() )
+  {
+    sitkExceptionMacro( "The transform parameter map has no \"" << key << "\" parameter." );
+  }
+  return iter->second;
+}
+
+std::string
+GetParameterValue( const ParameterMapType & parameterMap, const std::string & key, const std::string & defaultValue )
+{
+  ParameterMapType::const_iterator iter = parameterMap.find( key );
+  return ( iter == parameterMap.end() || iter->second.empty() ) ? defaultValue : iter->second[ 0 ];
+}
+
+std::vector< double >
+GetParameterNumbers( const ParameterMapType & parameterMap, const std::string & key, size_t numberOfValues )
+{
+  const std::vector< std::string > & values = GetParameterValues( parameterMap, key );
+  if( numberOfValues != 0 && values.size() != numberOfValues )
+  {
+    sitkExceptionMacro( "The \"" << key << "\" parameter has " << values.size() << " values instead of " << numberOfValues << "." );
+  }
+
+  // elastix writes the numbers in the classic locale
+  std::vector< double > numbers;
+  numbers.reserve( values.size() );
+  for( const std::string & value : values )
+  {
+    std::istringstream stream( value );
+    stream.imbue( std::locale::classic() );
+    double number;
+    if( !( stream >> number ) )
+    {
+      sitkExceptionMacro( "The \"" << key << "\" parameter has the value \"" << value << "\" which is not a number." );
+    }
+    numbers.push_back( number );
+  }
+  return numbers;
+}
+
+Transform
+ConvertBSplineTransform( const ParameterMapType & parameterMap, unsigned int dimension, const std::vector< double > & parameters )
+{
+  if( GetParameterValue( parameterMap, "UseCyclicTransform", "false" ) == "true" )
+  {
+    sitkExceptionMacro( "The conversion of a cyclic BSplineTransform is not supported." );
+  }
+
+  const unsigned int order = parameterMap.count( "BSplineTransformSplineOrder" )
+                           ? static_cast< unsigned int >( GetParameterNumbers( parameterMap, "BSplineTransformSplineOrder", 1 )[ 0 ] )
+                           : 3u;
+  const std::vector< double > size = GetParameterNumbers( parameterMap, "GridSize", dimension );
+  const std::vector< double > index = GetParameterNumbers( parameterMap, "GridIndex", dimension );
+  const std::vector< double > spacing = GetParameterNumbers( parameterMap, "GridSpacing", dimension );
+  std::vector< double > origin = GetParameterNumbers( parameterMap, "GridOrigin", dimension );
+
+  // elastix writes the grid direction in column-major order
+  std::vector< double > direction( dimension * dimension, 0.0 );
+  if( parameterMap.count( "GridDirection" ) )
+  {
+    const std::vector< double > columns = GetParameterNumbers( parameterMap, "GridDirection", dimension * dimension );
+    for( unsigned int i = 0; i < dimension; ++i )
+    {
+      for( unsigned int j = 0; j < dimension; ++j )
+      {
+        direction[ i * dimension + j ] = columns[ j * dimension + i ];
+      }
+    }
+  }
+  else
+  {
+    for( unsigned int i = 0; i < dimension; ++i )
+    {
+      direction[ i * dimension + i ] = 1.0;
+    }
+  }
+
+  // the coefficient grid of ITK starts at index zero
+  for( unsigned int i = 0; i < dimension; ++i )
+  {
+    for( unsigned int j = 0; j < dimension; ++j )
+    {
+      origin[ i ] += direction[ i * dimension + j ] * spacing[ j ] * index[ j ];
+    }
+  }
+
+  std::vector< double > fixedParameters( size );
+  fixedParameters.insert( fixedParameters.end(), origin.begin(), origin.end() );
+  fixedParameters.insert( fixedParameters.end(), spacing.begin(), spacing.end() );
+  fixedParameters.insert( fixedParameters.end(), direction.begin(), direction.end() );
+
+  BSplineTransform transform( dimension, order );
+  transform.SetFixedParameters( fixedParameters );
+  if( parameters.size() != transform.GetNumberOfParameters() )
+  {
+    sitkExceptionMacro( "The BSplineTransform has " << parameters.size() << " parameters instead of "
+                        << transform.GetNumberOfParameters() << " for a grid of size " << size << "." );
+  }
+  transform.SetParameters( parameters );
+  return transform;
+}
+
+Transform
+ConvertTransform( const ParameterMapType & parameterMap )
+{
+  const std::string name = GetParameterValues( parameterMap, "Transform" )[ 0 ];
+  const unsigned int dimension = static_cast< unsigned int >( GetParameterNumbers( parameterMap, "FixedImageDimension", 1 )[ 0 ] );
+  const std::vector< double > parameters = GetParameterNumbers( parameterMap, "TransformParameters", 0 );
+
+  if( dimension != 2 && dimension != 3 )
+  {
+    sitkExceptionMacro( "The conversion of a " << dimension << "-dimensional " << name << " is not supported." );
+  }
+
+  if( name == "TranslationTransform" )
+  {
+    TranslationTransform transform( dimension );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  if( name == "BSplineTransform" || name == "RecursiveBSplineTransform" )
+  {
+    return ConvertBSplineTransform( parameterMap, dimension, parameters );
+  }
+
+  const std::vector< double > center = GetParameterNumbers( parameterMap, "CenterOfRotationPoint", dimension );
+
+  if( name == "EulerTransform" && dimension == 2 )
+  {
+    Euler2DTransform transform;
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  if( name == "EulerTransform" && dimension == 3 )
+  {
+    Euler3DTransform transform;
+    transform.SetCenter( center );
+    transform.SetComputeZYX( GetParameterValue( parameterMap, "ComputeZYX", "false" ) == "true" );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  if( name == "SimilarityTransform" && dimension == 2 )
+  {
+    Similarity2DTransform transform;
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  if( name == "SimilarityTransform" && dimension == 3 )
+  {
+    Similarity3DTransform transform;
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  if( name == "AffineTransform" )
+  {
+    AffineTransform transform( dimension );
+    transform.SetCenter( center );
+    transform.SetParameters( parameters );
+    return transform;
+  }
+
+  sitkExceptionMacro( "The conversion of an elastix " << name << " is not supported." );
+}
+
+// Append the transforms of the maps, in the order in which they are applied
+void
+AppendTransforms( const ParameterMapVectorType & parameterMapVector, std::vector< Transform > & transforms )
+{
+  for( unsigned int i = 0; i < parameterMapVector.size(); ++i )
+  {
+    const ParameterMapType & parameterMap = parameterMapVector[ i ];
+
+    if( i == 0 )
+    {
+      const std::string initialTransform = GetParameterValue( parameterMap, "InitialTransformParametersFileName", "NoInitialTransform" );
+      if( initialTransform != "NoInitialTransform" )
+      {
+        AppendTransforms( ParameterMapVectorType( 1, ReadParameterFile( initialTransform ) ), transforms );
+      }
+    }
+
+    if( !transforms.empty() && GetParameterValue( parameterMap, "HowToCombineTransforms", "Compose" ) != "Compose" )
+    {
+      sitkExceptionMacro( "The conversion of transforms combined with HowToCombineTransforms \""
+                          << GetParameterValue( parameterMap, "HowToCombineTransforms", "" ) << "\" is not supported." );
+    }
+
+    transforms.push_back( ConvertTransform( parameterMap ) );
+  }
+}
+
+} // end anonymous namespace
+
+Transform
+TransformParameterMapToTransform( const ElastixImageFilter::ParameterMapType parameterMap )
+{
+  return TransformParameterMapToTransform( ElastixImageFilter::ParameterMapVectorType( 1, parameterMap ) );
+}
+
+Transform
+TransformParameterMapToTransform( const ElastixImageFilter::ParameterMapVectorType parameterMapVector )
+{
+  if( parameterMapVector.empty() )
+  {
+    sitkExceptionMacro( "No transform parameter map to convert." );
+  }
+
+  std::vector< Transform > transforms;
+  AppendTransforms( parameterMapVector, transforms );
+  if( transforms.size() == 1 )
+  {
+    return transforms[ 0 ];
+  }
+
+  // the back of a CompositeTransform is applied first
+  std::reverse( transforms.begin(), transforms.end() );
+  return CompositeTransform( transforms );
+}
+
+} // end namespace simple
+} // end namespace itk
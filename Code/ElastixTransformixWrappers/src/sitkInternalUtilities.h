@@ -2,6 +2,17 @@
 #define sitkInternalUtilities_h
 
 #include "Ancillary/type_list2.h"
+#include "sitkImage.h"
+#include "sitkCastImageFilter.h"
+
+#include "itkOutputWindow.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
 
 namespace itk {
   namespace simple {
@@ -12,6 +23,167 @@ namespace itk {
 */
 using FloatPixelIDTypeList = typelist2::typelist<BasicPixelID<float>>;
 
+
+/** The number of threads of a wrapper setting, where 0 is the global default
+* number of threads of the SimpleITK filters.
+*/
+inline unsigned int GetElastixNumberOfThreads( int numberOfThreads )
+{
+  return numberOfThreads > 0 ? static_cast< unsigned int >( numberOfThreads )
+                             : std::max( ProcessObject::GetGlobalDefaultNumberOfThreads(), 1u );
+}
+
+
+/** Cast an image with numberOfThreads threads, instead of the global default
+* number of threads.
+*/
+inline Image CastElastixImage( const Image & image, PixelIDValueEnum pixelID, unsigned int numberOfThreads )
+{
+  CastImageFilter filter;
+  filter.SetOutputPixelType( pixelID );
+  filter.SetNumberOfThreads( numberOfThreads );
+  return filter.Execute( image );
+}
+
+
+/** Get the ITK image of an input image for elastix or transformix, of the pixel
+* type pixelID. An image of another pixel type is cast with numberOfThreads
+* threads, but an image of the pixel type is shared with the caller without a
+* copy: the const ITK image is used, since the non const accessor makes the
+* buffer unique, and elastix does not modify its inputs.
+*/
+template< typename TImage >
+typename TImage::Pointer GetElastixInputImage( const Image & image, PixelIDValueEnum pixelID, unsigned int numberOfThreads = 0 )
+{
+  const Image input = ( image.GetPixelID() == pixelID ) ? image : CastElastixImage( image, pixelID, GetElastixNumberOfThreads( static_cast< int >( numberOfThreads ) ) );
+  return const_cast< TImage * >( itkDynamicCastInDebugMode< const TImage * >( input.GetITKBase() ) );
+}
+
+
+/** Send the text written to a standard stream, such as the console log
+* of elastix to std::cout, line by line to a handler while the object
+* exists. The handler is also given the previous buffer of the stream, to
+* which it may write the line. The stream is global, so the text written
+* to it by other threads meanwhile is redirected as well.
+*
+* When rethrow is true, an exception of the handler is thrown to the
+* writer of the text, instead of only setting the bad state of the
+* stream.
+*/
+class StreamLineRedirect : private std::streambuf
+{
+public:
+  typedef std::function< void( const std::string &, std::streambuf * ) > LineHandlerType;
+
+  StreamLineRedirect( std::ostream & stream, LineHandlerType lineHandler, bool rethrow = false )
+    : m_Stream( stream ),
+      m_Previous( stream.rdbuf( this ) ),
+      m_PreviousExceptions( stream.exceptions() ),
+      m_LineHandler( std::move( lineHandler ) )
+  {
+    if( rethrow )
+    {
+      m_Stream.clear();
+      m_Stream.exceptions( m_PreviousExceptions | std::ios::badbit );
+    }
+  }
+
+  ~StreamLineRedirect() override
+  {
+    try
+    {
+      this->sync();
+    }
+    catch( ... )
+    {
+    }
+    m_Stream.rdbuf( m_Previous );
+    m_Stream.clear();
+    m_Stream.exceptions( m_PreviousExceptions );
+  }
+
+  StreamLineRedirect( const StreamLineRedirect & ) = delete;
+  StreamLineRedirect & operator=( const StreamLineRedirect & ) = delete;
+
+private:
+  int_type overflow( int_type c ) override
+  {
+    if( traits_type::eq_int_type( c, traits_type::eof() ) )
+    {
+      return traits_type::not_eof( c );
+    }
+    const char character = traits_type::to_char_type( c );
+    this->xsputn( &character, 1 );
+    return c;
+  }
+
+  std::streamsize xsputn( const char * s, std::streamsize n ) override
+  {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    for( std::streamsize i = 0; i < n; ++i )
+    {
+      m_Line.push_back( s[ i ] );
+      if( s[ i ] == '\n' )
+      {
+        this->HandleLine();
+      }
+    }
+    return n;
+  }
+
+  int sync() override
+  {
+    std::lock_guard< std::mutex > lock( m_Mutex );
+    if( !m_Line.empty() )
+    {
+      this->HandleLine();
+    }
+    return 0;
+  }
+
+  void HandleLine()
+  {
+    // A logger writing to the stream goes to the previous buffer,
+    // instead of back to this one.
+    std::string line;
+    line.swap( m_Line );
+    m_Stream.rdbuf( m_Previous );
+    try
+    {
+      m_LineHandler( line, m_Previous );
+    }
+    catch( ... )
+    {
+      m_Stream.rdbuf( this );
+      throw;
+    }
+    m_Stream.rdbuf( this );
+  }
+
+  std::ostream &         m_Stream;
+  std::streambuf *       m_Previous;
+  std::ios::iostate      m_PreviousExceptions;
+  LineHandlerType        m_LineHandler;
+  std::mutex             m_Mutex;
+  std::string            m_Line;
+};
+
+
+/** Send the text written to a standard stream line by line to the ITK
+* output window while the object exists. A SimpleITK logger set with
+* LoggerBase::SetAsGlobalITKLogger then receives it.
+*/
+class OutputWindowStreamRedirect : public StreamLineRedirect
+{
+public:
+  explicit OutputWindowStreamRedirect( std::ostream & stream )
+    : StreamLineRedirect( stream, []( const std::string & line, std::streambuf * ) {
+        itk::OutputWindow::GetInstance()->DisplayText( line.c_str() );
+      } )
+  {
+  }
+};
+
 } // end namespace simple
 } // end namespace itk
 
@@ -158,6 +158,51 @@ TransformixImageFilter
   return *this;
 }
 
+TransformixImageFilter::Self&
+TransformixImageFilter
+::SetSpatialJacobianOutputPixelType( PixelIDValueEnum pixelID )
+{
+  this->m_Pimple->SetSpatialJacobianOutputPixelType( pixelID );
+  return *this;
+}
+
+PixelIDValueEnum
+TransformixImageFilter
+::GetSpatialJacobianOutputPixelType()
+{
+  return this->m_Pimple->GetSpatialJacobianOutputPixelType();
+}
+
+TransformixImageFilter::Self&
+TransformixImageFilter
+::SetSpatialJacobianRegion( const std::vector< unsigned int > & index, const std::vector< unsigned int > & size )
+{
+  this->m_Pimple->SetSpatialJacobianRegion( index, size );
+  return *this;
+}
+
+std::vector< unsigned int >
+TransformixImageFilter
+::GetSpatialJacobianRegionIndex()
+{
+  return this->m_Pimple->GetSpatialJacobianRegionIndex();
+}
+
+std::vector< unsigned int >
+TransformixImageFilter
+::GetSpatialJacobianRegionSize()
+{
+  return this->m_Pimple->GetSpatialJacobianRegionSize();
+}
+
+TransformixImageFilter::Self&
+TransformixImageFilter
+::RemoveSpatialJacobianRegion()
+{
+  this->m_Pimple->RemoveSpatialJacobianRegion();
+  return *this;
+}
+
 TransformixImageFilter::Self&
 TransformixImageFilter
 ::SetOutputDirectory( const std::string outputDirectory )
@@ -442,6 +487,35 @@ TransformixImageFilter
   return this->m_Pimple->GetDeformationField();
 }
 
+Image
+TransformixImageFilter
+::GetSpatialJacobian()
+{
+  return this->m_Pimple->GetSpatialJacobian();
+}
+
+Image
+TransformixImageFilter
+::GetDeterminantOfSpatialJacobian()
+{
+  return this->m_Pimple->GetDeterminantOfSpatialJacobian();
+}
+
+TransformixImageFilter::Self&
+TransformixImageFilter
+::PrepareTransform()
+{
+  this->m_Pimple->PrepareTransform();
+  return *this;
+}
+
+std::vector< Image >
+TransformixImageFilter
+::ExecuteBatch( const std::vector< Image > &movingImages, const std::vector< InterpolatorEnum > &interpolators )
+{
+  return this->m_Pimple->ExecuteBatch( movingImages, interpolators );
+}
+
 /**
  * Procedural interface
  */
@@ -3,6 +3,14 @@
 #include "sitkCastImageFilter.h"
 #include "sitkImageConvert.h"
 #include "sitkInternalUtilities.h"
+#include "sitkDisplacementFieldTransform.h"
+#include "sitkResampler.h"
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMultiThreaderBase.h"
+#include "vnl/vnl_det.h"
+
+#include <algorithm>
 
 namespace itk {
   namespace simple {
@@ -111,6 +119,190 @@ namespace itk {
               }
           }
 
+
+          // The interpolator of the ResampleInterpolator of a transform
+          // parameter map.
+          InterpolatorEnum GetResampleInterpolatorFromParameterMap( const TransformixImageFilter::ParameterMapType& parameterMap )
+          {
+              auto interpolator = parameterMap.find( "ResampleInterpolator" );
+              const std::string name = ( interpolator != parameterMap.end() && !interpolator->second.empty() )
+                ? interpolator->second[ 0 ] : "FinalBSplineInterpolator";
+
+              if (name == "FinalNearestNeighborInterpolator")
+              {
+                  return sitkNearestNeighbor;
+              }
+              else if (name == "FinalLinearInterpolator")
+              {
+                  return sitkLinear;
+              }
+              else if (name == "FinalBSplineInterpolator" || name == "FinalBSplineInterpolatorFloat")
+              {
+                  auto order = parameterMap.find( "FinalBSplineInterpolationOrder" );
+                  switch ( ( order != parameterMap.end() && !order->second.empty() ) ? std::stoi( order->second[ 0 ] ) : 3 )
+                  {
+                      case 0: return sitkNearestNeighbor;
+                      case 1: return sitkBSpline1;
+                      case 2: return sitkBSpline2;
+                      case 3: return sitkBSpline3;
+                      case 4: return sitkBSpline4;
+                      case 5: return sitkBSpline5;
+                      default: break;
+                  }
+              }
+
+              sitkExceptionMacro( << "The ResampleInterpolator \"" << name << "\" is not supported by ExecuteBatch." );
+          }
+
+
+          bool IsVectorPixelID( PixelIDValueEnum pixelID )
+          {
+              const PixelIDValueEnum vectors[] = { sitkVectorUInt8, sitkVectorInt8, sitkVectorUInt16, sitkVectorInt16,
+                                                   sitkVectorUInt32, sitkVectorInt32, sitkVectorUInt64, sitkVectorInt64,
+                                                   sitkVectorFloat32, sitkVectorFloat64 };
+              return pixelID != sitkUnknown && std::find( std::begin( vectors ), std::end( vectors ), pixelID ) != std::end( vectors );
+          }
+
+
+          // Compute the spatial Jacobian of the transform, I + du/dx, and
+          // its determinant, from the deformation field u on a region of
+          // its grid, with central differences.
+          template< typename TDeformationField >
+          void ComputeSpatialJacobianImages( const TDeformationField * field,
+                                             const std::vector< unsigned int > & regionIndex,
+                                             const std::vector< unsigned int > & regionSize,
+                                             bool computeSpatialJacobian,
+                                             bool computeDeterminant,
+                                             PixelIDValueEnum outputPixelType,
+                                             Image & spatialJacobian,
+                                             Image & determinant )
+          {
+              constexpr unsigned int Dimension = TDeformationField::ImageDimension;
+              typedef typename TDeformationField::RegionType RegionType;
+              typedef typename TDeformationField::IndexType  IndexType;
+              typedef itk::Matrix< double, Dimension, Dimension > MatrixType;
+
+              const RegionType largestRegion = field->GetLargestPossibleRegion();
+              RegionType region = largestRegion;
+              if( !regionSize.empty() )
+              {
+                  if( regionIndex.size() != Dimension || regionSize.size() != Dimension )
+                  {
+                      sitkExceptionMacro( "The spatial Jacobian region must be of dimension " << Dimension << "." );
+                  }
+                  for( unsigned int d = 0; d < Dimension; ++d )
+                  {
+                      region.SetIndex( d, largestRegion.GetIndex( d ) + regionIndex[ d ] );
+                      region.SetSize( d, regionSize[ d ] );
+                  }
+                  if( !largestRegion.IsInside( region ) )
+                  {
+                      sitkExceptionMacro( "The spatial Jacobian region of index " << regionIndex << " and size " << regionSize
+                                          << " is not inside the output grid of size " << std::vector< unsigned int >( largestRegion.GetSize().begin(), largestRegion.GetSize().end() ) << "." );
+                  }
+              }
+
+              // the derivative of the index with respect to the physical point
+              MatrixType indexGradient;
+              for( unsigned int k = 0; k < Dimension; ++k )
+              {
+                  for( unsigned int j = 0; j < Dimension; ++j )
+                  {
+                      indexGradient( k, j ) = field->GetDirection()( j, k ) / field->GetSpacing()[ k ];
+                  }
+              }
+
+              typename TDeformationField::PointType origin;
+              field->TransformIndexToPhysicalPoint( region.GetIndex(), origin );
+              const std::vector< unsigned int > size( region.GetSize().begin(), region.GetSize().end() );
+
+              auto makeOutputImage = [&]( PixelIDValueEnum pixelID, unsigned int numberOfComponents )
+              {
+                  Image image( size, pixelID, numberOfComponents );
+                  image.SetOrigin( std::vector< double >( origin.Begin(), origin.End() ) );
+                  image.SetSpacing( std::vector< double >( field->GetSpacing().Begin(), field->GetSpacing().End() ) );
+                  image.SetDirection( std::vector< double >( field->GetDirection().GetVnlMatrix().begin(), field->GetDirection().GetVnlMatrix().end() ) );
+                  return image;
+              };
+
+              Image jacobianImage;
+              Image determinantImage;
+              double * jacobianBuffer = nullptr;
+              double * determinantBuffer = nullptr;
+              if( computeSpatialJacobian )
+              {
+                  jacobianImage = makeOutputImage( sitkVectorFloat64, Dimension * Dimension );
+                  jacobianBuffer = jacobianImage.GetBufferAsDouble();
+              }
+              if( computeDeterminant )
+              {
+                  determinantImage = makeOutputImage( sitkFloat64, 0 );
+                  determinantBuffer = determinantImage.GetBufferAsDouble();
+              }
+
+              itk::MultiThreaderBase::New()->template ParallelizeImageRegion< Dimension >(
+                  region,
+                  [&]( const RegionType & subregion )
+                  {
+                      for( itk::ImageRegionConstIteratorWithIndex< TDeformationField > it( field, subregion ); !it.IsAtEnd(); ++it )
+                      {
+                          const IndexType index = it.GetIndex();
+
+                          // the derivative of the displacement with respect to the index,
+                          // one sided at the border of the field
+                          MatrixType displacementGradient;
+                          for( unsigned int k = 0; k < Dimension; ++k )
+                          {
+                              IndexType previous = index;
+                              IndexType next = index;
+                              if( index[ k ] > largestRegion.GetIndex( k ) )
+                              {
+                                  --previous[ k ];
+                              }
+                              if( index[ k ] < largestRegion.GetUpperIndex()[ k ] )
+                              {
+                                  ++next[ k ];
+                              }
+                              const double step = static_cast< double >( next[ k ] - previous[ k ] );
+                              const typename TDeformationField::PixelType & u0 = field->GetPixel( previous );
+                              const typename TDeformationField::PixelType & u1 = field->GetPixel( next );
+                              for( unsigned int c = 0; c < Dimension; ++c )
+                              {
+                                  displacementGradient( c, k ) = step > 0.0 ? ( u1[ c ] - u0[ c ] ) / step : 0.0;
+                              }
+                          }
+
+                          MatrixType jacobian = displacementGradient * indexGradient;
+                          for( unsigned int d = 0; d < Dimension; ++d )
+                          {
+                              jacobian( d, d ) += 1.0;
+                          }
+
+                          size_t offset = 0;
+                          size_t stride = 1;
+                          for( unsigned int d = 0; d < Dimension; ++d )
+                          {
+                              offset += static_cast< size_t >( index[ d ] - region.GetIndex( d ) ) * stride;
+                              stride *= region.GetSize( d );
+                          }
+
+                          if( jacobianBuffer )
+                          {
+                              std::copy( jacobian.GetVnlMatrix().begin(), jacobian.GetVnlMatrix().end(), jacobianBuffer + offset * Dimension * Dimension );
+                          }
+                          if( determinantBuffer )
+                          {
+                              determinantBuffer[ offset ] = vnl_det( jacobian.GetVnlMatrix() );
+                          }
+                      }
+                  },
+                  nullptr );
+
+              const bool isFloat32 = ( outputPixelType == sitkFloat32 );
+              spatialJacobian = ( computeSpatialJacobian && isFloat32 ) ? Cast( jacobianImage, sitkVectorFloat32 ) : jacobianImage;
+              determinant = ( computeDeterminant && isFloat32 ) ? Cast( determinantImage, sitkFloat32 ) : determinantImage;
+          }
+
       }
 
 TransformixImageFilter::TransformixImageFilterImpl
@@ -134,6 +326,7 @@ TransformixImageFilter::TransformixImageFilterImpl
   this->m_ComputeSpatialJacobian = false;
   this->m_ComputeDeterminantOfSpatialJacobian = false;
   this->m_ComputeDeformationField = false;
+  this->m_SpatialJacobianOutputPixelType = sitkFloat64;
   this->m_MovingPointSetFileName = "";
 
   this->m_OutputDirectory = ".";
@@ -179,13 +372,16 @@ TransformixImageFilter::TransformixImageFilterImpl
     TransforimxFilterPointer transformixFilter = TransformixFilterType::New();
 
     if( !this->IsEmpty( this->m_MovingImage ) ) {
-      transformixFilter->SetMovingImage( itkDynamicCastInDebugMode< TMovingImage* >( Cast( this->GetMovingImage(), static_cast< PixelIDValueEnum >( GetPixelIDValueFromElastixString( "float" ) ) ).GetITKBase() ) );
+      transformixFilter->SetMovingImage( GetElastixInputImage< TMovingImage >( this->GetMovingImage(), static_cast< PixelIDValueEnum >( GetPixelIDValueFromElastixString( "float" ) ) ) );
     }
 
     transformixFilter->SetFixedPointSetFileName( this->GetFixedPointSetFileName() );
-    transformixFilter->SetComputeSpatialJacobian( this->GetComputeSpatialJacobian() );
-    transformixFilter->SetComputeDeterminantOfSpatialJacobian( this->GetComputeDeterminantOfSpatialJacobian() );
-    transformixFilter->SetComputeDeformationField( this->GetComputeDeformationField() );
+    // the spatial Jacobian is computed here from the deformation field,
+    // instead of transformix writing it to the output directory
+    const bool computeJacobian = this->GetComputeSpatialJacobian() || this->GetComputeDeterminantOfSpatialJacobian();
+    transformixFilter->SetComputeSpatialJacobian( false );
+    transformixFilter->SetComputeDeterminantOfSpatialJacobian( false );
+    transformixFilter->SetComputeDeformationField( this->GetComputeDeformationField() || computeJacobian );
 
     transformixFilter->SetOutputDirectory( this->GetOutputDirectory() );
     transformixFilter->SetLogFileName( this->GetLogFileName() );
@@ -210,6 +406,19 @@ TransformixImageFilter::TransformixImageFilterImpl
       this->m_ResultImage.MakeUnique();
     }
 
+    this->m_SpatialJacobian = Image();
+    this->m_DeterminantOfSpatialJacobian = Image();
+    if( computeJacobian ) {
+      ComputeSpatialJacobianImages( transformixFilter->GetOutputDeformationField(),
+                                    this->m_SpatialJacobianRegionIndex,
+                                    this->m_SpatialJacobianRegionSize,
+                                    this->GetComputeSpatialJacobian(),
+                                    this->GetComputeDeterminantOfSpatialJacobian(),
+                                    this->GetSpatialJacobianOutputPixelType(),
+                                    this->m_SpatialJacobian,
+                                    this->m_DeterminantOfSpatialJacobian );
+    }
+
     if( this->GetComputeDeformationField() ) {
       this->m_DeformationField = Image( itk::simple::GetVectorImageFromImage( transformixFilter->GetOutputDeformationField(), true ) );
       this->m_DeformationField.MakeUnique();
@@ -331,6 +540,59 @@ TransformixImageFilter::TransformixImageFilterImpl
 
 }
 
+void
+TransformixImageFilter::TransformixImageFilterImpl
+::SetSpatialJacobianOutputPixelType( PixelIDValueEnum pixelID )
+{
+  if( pixelID != sitkFloat32 && pixelID != sitkFloat64 )
+  {
+    sitkExceptionMacro( "The spatial Jacobian output pixel type must be sitkFloat32 or sitkFloat64, not "
+                        << GetPixelIDValueAsString( pixelID ) << "." );
+  }
+  this->m_SpatialJacobianOutputPixelType = pixelID;
+}
+
+PixelIDValueEnum
+TransformixImageFilter::TransformixImageFilterImpl
+::GetSpatialJacobianOutputPixelType()
+{
+  return this->m_SpatialJacobianOutputPixelType;
+}
+
+void
+TransformixImageFilter::TransformixImageFilterImpl
+::SetSpatialJacobianRegion( const std::vector< unsigned int > & index, const std::vector< unsigned int > & size )
+{
+  if( index.size() != size.size() )
+  {
+    sitkExceptionMacro( "The index and the size of the spatial Jacobian region must be of the same dimension." );
+  }
+  this->m_SpatialJacobianRegionIndex = index;
+  this->m_SpatialJacobianRegionSize = size;
+}
+
+std::vector< unsigned int >
+TransformixImageFilter::TransformixImageFilterImpl
+::GetSpatialJacobianRegionIndex()
+{
+  return this->m_SpatialJacobianRegionIndex;
+}
+
+std::vector< unsigned int >
+TransformixImageFilter::TransformixImageFilterImpl
+::GetSpatialJacobianRegionSize()
+{
+  return this->m_SpatialJacobianRegionSize;
+}
+
+void
+TransformixImageFilter::TransformixImageFilterImpl
+::RemoveSpatialJacobianRegion()
+{
+  this->m_SpatialJacobianRegionIndex.clear();
+  this->m_SpatialJacobianRegionSize.clear();
+}
+
 void
 TransformixImageFilter::TransformixImageFilterImpl
 ::SetComputeDeformationField( const bool computeDeformationField )
@@ -692,6 +954,175 @@ TransformixImageFilter::TransformixImageFilterImpl
   return this->m_DeformationField;
 }
 
+Image
+TransformixImageFilter::TransformixImageFilterImpl
+::GetSpatialJacobian()
+{
+  if( this->IsEmpty( this->m_SpatialJacobian ) )
+  {
+    sitkExceptionMacro( "No spatial Jacobian found. Has transformix run yet? Have you called ComputeSpatialJacobianOn()?" )
+  }
+
+  return this->m_SpatialJacobian;
+}
+
+Image
+TransformixImageFilter::TransformixImageFilterImpl
+::GetDeterminantOfSpatialJacobian()
+{
+  if( this->IsEmpty( this->m_DeterminantOfSpatialJacobian ) )
+  {
+    sitkExceptionMacro( "No determinant of spatial Jacobian found. Has transformix run yet? Have you called ComputeDeterminantOfSpatialJacobianOn()?" )
+  }
+
+  return this->m_DeterminantOfSpatialJacobian;
+}
+
+void
+TransformixImageFilter::TransformixImageFilterImpl
+::PrepareTransform()
+{
+  if( this->m_TransformParameterMapVector.empty() )
+  {
+    sitkExceptionMacro( "No transform parameter map found. Set the transform parameter maps before preparing the transform." );
+  }
+
+  const ParameterMapType& parameterMap = this->m_TransformParameterMapVector.back();
+  auto dimension = parameterMap.find( "FixedImageDimension" );
+  if( dimension == parameterMap.end() || dimension->second.empty() )
+  {
+    sitkExceptionMacro( "The transform parameter map has no FixedImageDimension." );
+  }
+
+  switch( std::stoi( dimension->second[ 0 ] ) )
+  {
+    case 2:
+      this->PrepareTransformInternal< 2 >();
+      break;
+    case 3:
+      this->PrepareTransformInternal< 3 >();
+      break;
+#if SITK_MAX_DIMENSIONS >= 4
+    case 4:
+      this->PrepareTransformInternal< 4 >();
+      break;
+#endif
+    default:
+      sitkExceptionMacro( << "TransformixImageFilter does not support the dimension " << dimension->second[ 0 ] << "." );
+  }
+
+  this->m_PreparedTransformParameterMapVector = this->m_TransformParameterMapVector;
+}
+
+template< unsigned int VDimension >
+void
+TransformixImageFilter::TransformixImageFilterImpl
+::PrepareTransformInternal()
+{
+  typedef itk::Image< float, VDimension > ImageType;
+  typedef itk::TransformixFilter< ImageType > TransformixFilterType;
+  typedef typename TransformixFilterType::Pointer TransforimxFilterPointer;
+
+  try
+  {
+    // Only the deformation field is needed, but itk::TransformixFilter
+    // requires a moving image, so an image of one pixel is resampled
+    // with the nearest neighbor interpolator.
+    typename ImageType::Pointer movingImage = ImageType::New();
+    typename ImageType::SizeType movingSize;
+    movingSize.Fill( 1 );
+    movingImage->SetRegions( movingSize );
+    movingImage->Allocate();
+    movingImage->FillBuffer( 0.0f );
+
+    TransforimxFilterPointer transformixFilter = TransformixFilterType::New();
+    transformixFilter->SetMovingImage( movingImage );
+    transformixFilter->SetComputeDeformationField( true );
+
+    transformixFilter->SetOutputDirectory( this->GetOutputDirectory() );
+    transformixFilter->SetLogFileName( this->GetLogFileName() );
+    transformixFilter->SetLogToFile( this->GetLogToFile() );
+    transformixFilter->SetLogToConsole( this->GetLogToConsole() );
+
+    ParameterMapVectorType transformParameterMapVector = this->m_TransformParameterMapVector;
+    for( unsigned int i = 0; i < transformParameterMapVector.size(); i++ )
+    {
+      transformParameterMapVector[ i ][ "FixedInternalImagePixelType" ] = ParameterValueVectorType( 1, "float" );
+      transformParameterMapVector[ i ][ "MovingInternalImagePixelType" ] = ParameterValueVectorType( 1, "float" );
+    }
+    transformParameterMapVector.back()[ "ResampleInterpolator" ] = ParameterValueVectorType( 1, "FinalNearestNeighborInterpolator" );
+
+    ParameterObjectPointer parameterObject = ParameterObjectType::New();
+    parameterObject->SetParameterMap( transformParameterMapVector );
+    transformixFilter->SetTransformParameterObject( parameterObject );
+    transformixFilter->Update();
+
+    Image deformationField( itk::simple::GetVectorImageFromImage( transformixFilter->GetOutputDeformationField(), true ) );
+    deformationField.MakeUnique();
+
+    const std::vector< unsigned int > size = deformationField.GetSize();
+    this->m_PreparedSize = std::vector< uint32_t >( size.begin(), size.end() );
+    this->m_PreparedOrigin = deformationField.GetOrigin();
+    this->m_PreparedSpacing = deformationField.GetSpacing();
+    this->m_PreparedDirection = deformationField.GetDirection();
+
+    // the float field is converted to the transform without an
+    // intermediate image
+    this->m_PreparedTransform = DisplacementFieldTransform( deformationField );
+  }
+  catch( itk::ExceptionObject &e )
+  {
+    sitkExceptionMacro( << e );
+  }
+}
+
+std::vector< Image >
+TransformixImageFilter::TransformixImageFilterImpl
+::ExecuteBatch( const std::vector< Image > &movingImages, const std::vector< InterpolatorEnum > &interpolators )
+{
+  if( !interpolators.empty() && interpolators.size() != movingImages.size() )
+  {
+    sitkExceptionMacro( << "The number of interpolators ( " << interpolators.size()
+                        << " ) does not match the number of moving images ( " << movingImages.size() << " )." );
+  }
+
+  if( this->m_PreparedSize.empty() || this->m_PreparedTransformParameterMapVector != this->m_TransformParameterMapVector )
+  {
+    this->PrepareTransform();
+  }
+
+  const ParameterMapType& parameterMap = this->m_TransformParameterMapVector.back();
+  std::vector< InterpolatorEnum > imageInterpolators = interpolators;
+  if( imageInterpolators.empty() )
+  {
+    imageInterpolators.assign( movingImages.size(), GetResampleInterpolatorFromParameterMap( parameterMap ) );
+  }
+  auto defaultPixelValueParameter = parameterMap.find( "DefaultPixelValue" );
+  const double defaultPixelValue = ( defaultPixelValueParameter != parameterMap.end() && !defaultPixelValueParameter->second.empty() )
+    ? std::stod( defaultPixelValueParameter->second[ 0 ] ) : 0.0;
+
+  JointResampler resampler;
+  for( unsigned int i = 0; i < movingImages.size(); i++ )
+  {
+    const Image& movingImage = movingImages[ i ];
+    const InterpolatorEnum interpolator = imageInterpolators[ i ];
+
+    // the labels keep their pixel type
+    PixelIDValueEnum outputPixelType = sitkUnknown;
+    if( interpolator != sitkNearestNeighbor && interpolator != sitkLabelGaussian )
+    {
+      outputPixelType = IsVectorPixelID( movingImage.GetPixelID() ) ? sitkVectorFloat32 : sitkFloat32;
+    }
+    resampler.AddImage( movingImage, interpolator, defaultPixelValue, outputPixelType );
+  }
+
+  return resampler.Execute( this->m_PreparedTransform,
+                            this->m_PreparedSize,
+                            this->m_PreparedOrigin,
+                            this->m_PreparedSpacing,
+                            this->m_PreparedDirection );
+}
+
 bool
 TransformixImageFilter::TransformixImageFilterImpl
 ::IsEmpty( const Image& image )
@@ -4,6 +4,7 @@
 // SimpleITK
 #include "sitkTransformixImageFilter.h"
 #include "sitkMemberFunctionFactory.h"
+#include "sitkTransform.h"
 
 // Transformix
 #include "itkTransformixFilter.h"
@@ -52,6 +53,14 @@ public:
   void ComputeDeterminantOfSpatialJacobianOn();
   void ComputeDeterminantOfSpatialJacobianOff();
 
+  void SetSpatialJacobianOutputPixelType( PixelIDValueEnum pixelID );
+  PixelIDValueEnum GetSpatialJacobianOutputPixelType();
+
+  void SetSpatialJacobianRegion( const std::vector< unsigned int > & index, const std::vector< unsigned int > & size );
+  std::vector< unsigned int > GetSpatialJacobianRegionIndex();
+  std::vector< unsigned int > GetSpatialJacobianRegionSize();
+  void RemoveSpatialJacobianRegion();
+
   void SetComputeDeformationField( bool );
   bool GetComputeDeformationField();
   void ComputeDeformationFieldOn();
@@ -103,9 +112,16 @@ public:
 
   Image GetResultImage();
   Image GetDeformationField();
+  Image GetSpatialJacobian();
+  Image GetDeterminantOfSpatialJacobian();
+
+  void PrepareTransform();
+  std::vector< Image > ExecuteBatch( const std::vector< Image > &movingImages, const std::vector< InterpolatorEnum > &interpolators );
 
   bool IsEmpty( const Image& image );
 
+  template< unsigned int VDimension > void PrepareTransformInternal();
+
   // Definitions for SimpleITK member factory
   typedef Image ( Self::*MemberFunctionType )();
   template< class TMovingImage > Image ExecuteInternal();
@@ -115,12 +131,17 @@ public:
   Image                   m_MovingImage;
   Image                   m_ResultImage;
   Image                   m_DeformationField;
+  Image                   m_SpatialJacobian;
+  Image                   m_DeterminantOfSpatialJacobian;
 
   ParameterMapVectorType  m_TransformParameterMapVector;
 
   bool                    m_ComputeSpatialJacobian;
   bool                    m_ComputeDeterminantOfSpatialJacobian;
   bool                    m_ComputeDeformationField;
+  PixelIDValueEnum        m_SpatialJacobianOutputPixelType;
+  std::vector< unsigned int > m_SpatialJacobianRegionIndex;
+  std::vector< unsigned int > m_SpatialJacobianRegionSize;
   std::string             m_MovingPointSetFileName;
 
   std::string             m_OutputDirectory;
@@ -128,6 +149,15 @@ public:
 
   bool                    m_LogToConsole;
   bool                    m_LogToFile;
+
+  // The transform of the parameter maps, and its output grid, for
+  // ExecuteBatch
+  ParameterMapVectorType  m_PreparedTransformParameterMapVector;
+  Transform               m_PreparedTransform;
+  std::vector< uint32_t > m_PreparedSize;
+  std::vector< double >   m_PreparedOrigin;
+  std::vector< double >   m_PreparedSpacing;
+  std::vector< double >   m_PreparedDirection;
 };
 
 } // end namespace simple
@@ -40,6 +40,8 @@
 #include "sitkExplicitITKImageRegionConstIterator.h"
 #include "sitkExplicitITKImageScanlineConstIterator.h"
 #include "sitkExplicitITKImageScanlineIterator.h"
+#include "sitkExplicitITKConstNeighborhoodIterator.h"
+#include "sitkExplicitITKNeighborhoodIterator.h"
 
 #include "sitkExplicitITKImageSource.h"
 #include "sitkExplicitITKImageToImageFilter.h"
@@ -0,0 +1,49 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkExplicitITKNeighborhoodIterator_h__
+#define sitkExplicitITKNeighborhoodIterator_h__
+#include "sitkExplicit.h"
+#include "itkNeighborhoodIterator.h"
+
+#ifndef SITK_TEMPLATE_EXPLICIT_EXPLICITITK
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<double, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<double, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<float, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<float, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<int, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<int, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<long, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<long, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<long long, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<long long, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<short, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<short, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<signed char, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<signed char, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned char, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned char, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned int, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned int, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned long, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned long, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned long long, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned long long, 3u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned short, 2u> >;
+extern template class SITKExplicit_EXPORT_EXPLICIT itk::NeighborhoodIterator<itk::Image<unsigned short, 3u> >;
+#endif // SITK_TEMPLATE_EXPLICIT_EXPLICITITK
+#endif // sitkExplicitITKNeighborhoodIterator_h__
@@ -0,0 +1,261 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkDICOMSeriesConverter_h
+#define sitkDICOMSeriesConverter_h
+
+#include "sitkIO.h"
+#include "sitkImage.h"
+#include "sitkMemberFunctionFactory.h"
+#include "sitkPixelIDValues.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class DICOMSeriesConverter
+ * \brief Convert all the DICOM series of a directory to image files
+ *
+ * The series of the input directory are found with a
+ * DICOMSeriesIndex, and each series is converted by a pipeline of
+ * three stages connected by bounded queues:
+ *
+ * - NumberOfReaders threads read and decode the series with an
+ *   ImageSeriesReader, cast to the OutputPixelType when set.
+ * - One thread resamples the images to the OutputSpacing when set.
+ *   The resampling is itself multi-threaded.
+ * - NumberOfWriters threads encode and write the images with an
+ *   ImageFileWriter.
+ *
+ * Each queue holds at most QueueSize images, which bounds the memory
+ * used while a stage is slower than the others, and the stages run
+ * concurrently so the reading of a series overlaps the encoding of
+ * the previous ones.
+ *
+ * The output file of a series is its SeriesInstanceUID followed by
+ * the OutputExtension in the OutputDirectory. A series which fails to
+ * be converted does not stop the conversion of the others, it is
+ * reported by GetFailedSeriesIDs.
+ *
+ * \sa DICOMSeriesIndex
+ * \sa ImageSeriesReader
+ * \sa ImageFileWriter
+ */
+class SITKIO_EXPORT DICOMSeriesConverter
+{
+public:
+  using Self = DICOMSeriesConverter;
+
+  DICOMSeriesConverter();
+  DICOMSeriesConverter( const std::string &inputDirectory, const std::string &outputDirectory );
+
+  /** Return the user readable name of the class */
+  virtual std::string GetName() const { return std::string("DICOMSeriesConverter"); }
+
+  virtual ~DICOMSeriesConverter();
+
+  /** Print ourselves out */
+  std::string ToString() const;
+
+  /** \brief Set/Get the directory containing the DICOM files
+   * @{
+   */
+  void SetInputDirectory( const std::string &directory );
+  const std::string &GetInputDirectory() const;
+  /**@}*/
+
+  /** \brief Set/Get if the sub-directories of the input directory are
+   * scanned
+   * @{
+   */
+  void SetRecursive( bool recursive );
+  bool GetRecursive() const;
+  void RecursiveOn() { this->SetRecursive(true); }
+  void RecursiveOff() { this->SetRecursive(false); }
+  /**@}*/
+
+  /** \brief Set/Get the file used to persist the DICOMSeriesIndex
+   *
+   * When set, the headers are only parsed for the files which are
+   * new or modified since the previous conversion.
+   *
+   * \sa DICOMSeriesIndex::SetIndexFileName
+   * @{
+   */
+  void SetIndexFileName( const std::string &fileName );
+  const std::string &GetIndexFileName() const;
+  /**@}*/
+
+  /** \brief Set/Get the directory the image files are written to
+   *
+   * The directory must exist.
+   * @{
+   */
+  void SetOutputDirectory( const std::string &directory );
+  const std::string &GetOutputDirectory() const;
+  /**@}*/
+
+  /** \brief Set/Get the extension of the output files
+   *
+   * The extension selects the output file format. The default is
+   * ".nrrd".
+   * @{
+   */
+  void SetOutputExtension( const std::string &extension );
+  const std::string &GetOutputExtension() const;
+  /**@}*/
+
+  /** \brief Set/Get the pixel type of the output images
+   *
+   * The default, sitkUnknown, keeps the pixel type of the series.
+   *
+   * \sa ImageReaderBase::SetOutputPixelType
+   * @{
+   */
+  void SetOutputPixelType( PixelIDValueEnum pixelID );
+  PixelIDValueEnum GetOutputPixelType() const;
+  /**@}*/
+
+  /** \brief Set/Get the spacing the images are resampled to
+   *
+   * The images are resampled with a linear interpolator over the
+   * same physical extent. The default, an empty vector, does not
+   * resample. Otherwise the number of elements must match the
+   * dimension of the series, or the series fails to be converted.
+   * @{
+   */
+  void SetOutputSpacing( const std::vector<double> &spacing );
+  const std::vector<double> &GetOutputSpacing() const;
+  /**@}*/
+
+  /** \brief Set/Get if the output files are compressed
+   *
+   * \sa ImageFileWriter::SetUseCompression
+   * @{
+   */
+  void SetUseCompression( bool useCompression );
+  bool GetUseCompression() const;
+  void UseCompressionOn() { this->SetUseCompression(true); }
+  void UseCompressionOff() { this->SetUseCompression(false); }
+  /**@}*/
+
+  /** \brief Set/Get the number of threads reading the series
+   *
+   * A value of zero, the default, uses the number of hardware
+   * threads.
+   * @{
+   */
+  void SetNumberOfReaders( unsigned int n );
+  unsigned int GetNumberOfReaders() const;
+  /**@}*/
+
+  /** \brief Set/Get the number of threads writing the images
+   *
+   * A value of zero, the default, uses the number of hardware
+   * threads.
+   * @{
+   */
+  void SetNumberOfWriters( unsigned int n );
+  unsigned int GetNumberOfWriters() const;
+  /**@}*/
+
+  /** \brief Set/Get the number of images held between two stages
+   *
+   * The default is 2 and the minimum is 1.
+   * @{
+   */
+  void SetQueueSize( unsigned int n );
+  unsigned int GetQueueSize() const;
+  /**@}*/
+
+  /** \brief Convert all the series of the input directory
+   *
+   * Returns when all the series have been written or have failed,
+   * and returns the number of series written. An exception is
+   * thrown when the input directory can not be scanned or the output
+   * directory is not set.
+   */
+  unsigned int Execute();
+
+  /** \brief The series written by the last Execute, and the
+   * corresponding output files
+   * @{
+   */
+  const std::vector<std::string> &GetConvertedSeriesIDs() const;
+  const std::vector<std::string> &GetOutputFileNames() const;
+  /**@}*/
+
+  /** \brief The series which failed to be converted by the last
+   * Execute, and the corresponding error messages
+   * @{
+   */
+  const std::vector<std::string> &GetFailedSeriesIDs() const;
+  const std::vector<std::string> &GetErrorMessages() const;
+  /**@}*/
+
+private:
+
+  struct Series;
+
+  void Read( Series &series ) const;
+  void Resample( Series &series );
+  void Write( Series &series ) const;
+
+  template <class TImageType> Image ResampleInternal( const Image &image );
+
+  // function pointer type
+  typedef Image (Self::*MemberFunctionType)( const Image & );
+
+  template <class TMemberFunctionPointer>
+  struct ResampleAddressor
+  {
+    template <typename TImageType>
+    TMemberFunctionPointer operator() ( ) const
+      {
+        return &Self::template ResampleInternal< TImageType >;
+      }
+  };
+
+  std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
+
+  std::string m_InputDirectory;
+  bool m_Recursive{false};
+  std::string m_IndexFileName;
+  std::string m_OutputDirectory;
+  std::string m_OutputExtension{".nrrd"};
+  PixelIDValueEnum m_OutputPixelType{sitkUnknown};
+  std::vector<double> m_OutputSpacing;
+  bool m_UseCompression{false};
+  unsigned int m_NumberOfReaders{0};
+  unsigned int m_NumberOfWriters{0};
+  unsigned int m_QueueSize{2};
+
+  std::vector<std::string> m_ConvertedSeriesIDs;
+  std::vector<std::string> m_OutputFileNames;
+  std::vector<std::string> m_FailedSeriesIDs;
+  std::vector<std::string> m_ErrorMessages;
+};
+
+}
+}
+
+#endif // sitkDICOMSeriesConverter_h
@@ -0,0 +1,167 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkDICOMSeriesIndex_h
+#define sitkDICOMSeriesIndex_h
+
+#include "sitkIO.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class DICOMSeriesIndex
+ * \brief A persistent index of the DICOM series found in a directory
+ *
+ * For each file in the directory only the header tags needed to
+ * group and order a series are parsed: SeriesInstanceUID,
+ * ImagePositionPatient, ImageOrientationPatient and
+ * InstanceNumber. Parsing stops before the pixel data and the files
+ * are scanned concurrently.
+ *
+ * When an index file name is set, the index is loaded from and
+ * saved to that file. A subsequent Update only parses the files
+ * which are new or whose modification time or size has changed, so
+ * repeated queries of a large directory are nearly instant.
+ *
+ * The series are identified by the SeriesInstanceUID only, which
+ * corresponds to the useSeriesDetails=false behavior of
+ * ImageSeriesReader::GetGDCMSeriesIDs.
+ *
+ * \sa ImageSeriesReader::GetGDCMSeriesIDs
+ * \sa ImageSeriesReader::GetGDCMSeriesFileNames
+ */
+class SITKIO_EXPORT DICOMSeriesIndex
+{
+public:
+  using Self = DICOMSeriesIndex;
+
+  DICOMSeriesIndex();
+  explicit DICOMSeriesIndex( const std::string &directory, bool recursive = false );
+
+  /** Return the user readable name of the class */
+  virtual std::string GetName() const { return std::string("DICOMSeriesIndex"); }
+
+  virtual ~DICOMSeriesIndex();
+
+  /** Print ourselves out */
+  std::string ToString() const;
+
+  /** \brief Set/Get the directory containing the DICOM files
+   *
+   * Changing the directory clears the entries of the index.
+   * @{
+   */
+  void SetDirectory( const std::string &directory );
+  const std::string &GetDirectory() const;
+  /**@}*/
+
+  /** \brief Set/Get if the sub-directories are scanned
+   * @{
+   */
+  void SetRecursive( bool recursive );
+  bool GetRecursive() const;
+  void RecursiveOn() { this->SetRecursive(true); }
+  void RecursiveOff() { this->SetRecursive(false); }
+  /**@}*/
+
+  /** \brief Set/Get the file used to persist the index
+   *
+   * When empty, the default, the index is only kept in memory.
+   * @{
+   */
+  void SetIndexFileName( const std::string &fileName );
+  const std::string &GetIndexFileName() const;
+  /**@}*/
+
+  /** \brief Set/Get the number of threads used to parse the files
+   *
+   * A value of zero, the default, uses the number of hardware
+   * threads.
+   * @{
+   */
+  void SetNumberOfThreads( unsigned int n );
+  unsigned int GetNumberOfThreads() const;
+  /**@}*/
+
+  /** \brief Synchronize the index with the directory
+   *
+   * Loads the index file if it has not been loaded, parses the new
+   * and modified files, drops the removed files and saves the index
+   * file when it has changed.
+   */
+  void Update();
+
+  /** \brief The number of files parsed during the last Update */
+  unsigned int GetNumberOfFilesParsed() const;
+
+  /** \brief Get the SeriesInstanceUIDs found in the directory */
+  std::vector<std::string> GetSeriesIDs() const;
+
+  /** \brief Get the ordered file names of a series
+   *
+   * The files are ordered by the position along the slice normal
+   * when all files have a distinct ImagePositionPatient, otherwise
+   * by InstanceNumber and finally by file name. An empty seriesID
+   * returns the files of the first series.
+   */
+  std::vector<std::string> GetFileNames( const std::string &seriesID = "" ) const;
+
+private:
+
+  struct Entry
+  {
+    long int modifiedTime{0};
+    unsigned long fileSize{0};
+    std::string seriesID;
+    bool hasPosition{false};
+    double position[3]{0.0, 0.0, 0.0};
+    bool hasOrientation{false};
+    double orientation[6]{1.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+    bool hasInstanceNumber{false};
+    int instanceNumber{0};
+  };
+
+  static bool ParseFile( const std::string &fileName, Entry &entry );
+
+  void ListFiles( const std::string &directory, std::vector<std::string> &fileNames ) const;
+
+  bool IsIndexFile( const std::string &path ) const;
+
+  bool LoadIndexFile();
+  void SaveIndexFile() const;
+
+  std::string m_Directory;
+  bool m_Recursive{false};
+  std::string m_IndexFileName;
+  unsigned int m_NumberOfThreads{0};
+
+  bool m_IndexFileLoaded{false};
+  unsigned int m_NumberOfFilesParsed{0};
+
+  std::map<std::string, Entry> m_Entries;
+};
+
+}
+}
+
+#endif // sitkDICOMSeriesIndex_h
@@ -0,0 +1,178 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageFilePrefetchReader_h
+#define sitkImageFilePrefetchReader_h
+
+#include "sitkImage.h"
+#include "sitkIO.h"
+#include "sitkPixelIDValues.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \class ImageFilePrefetchReader
+ * \brief Read a list of image files in order while the next files
+ * are decoded in the background
+ *
+ * When iterating over many cases, each ReadImage call blocks while
+ * the file is read and decoded. This class reads up to
+ * NumberOfPrefetchedImages of the following files concurrently on
+ * background threads, and the images are handed out by Next in the
+ * order of the file names.
+ *
+ * The memory held by the images read ahead is bounded by
+ * MaximumPrefetchedBytes. A file is only started when the images
+ * which are ready but not yet returned are below the bound, and the
+ * next image in order is always read.
+ *
+ * Each file is read with an ImageFileReader configured with the
+ * OutputPixelType, ImageIO and LoadPrivateTags of this object. An
+ * exception raised while reading a file is rethrown by the Next
+ * call returning that file, and the following files can still be
+ * read.
+ *
+ * In Python the object is iterable, and the GIL is released while
+ * waiting for an image.
+ *
+ * \sa ImageFileReader
+ */
+class SITKIO_EXPORT ImageFilePrefetchReader
+{
+public:
+  using Self = ImageFilePrefetchReader;
+
+  ImageFilePrefetchReader();
+  explicit ImageFilePrefetchReader( const std::vector<std::string> &fileNames,
+                                    unsigned int numberOfPrefetchedImages = 2 );
+
+  /** Stops the background reading and waits for the threads. */
+  virtual ~ImageFilePrefetchReader();
+
+  /** Return the user readable name of the class */
+  virtual std::string GetName() const { return std::string("ImageFilePrefetchReader"); }
+
+  /** Print ourselves out */
+  std::string ToString() const;
+
+  /** \brief Set/Get the files to read
+   *
+   * Setting the file names resets the reader.
+   * @{
+   */
+  void SetFileNames( const std::vector<std::string> &fileNames );
+  const std::vector<std::string> &GetFileNames() const;
+  /**@}*/
+
+  /** \brief Set/Get the number of images read ahead of the
+   * consumer
+   *
+   * This is the number of files decoded concurrently. The default is
+   * 2 and the minimum is 1. Changing the value resets the reader.
+   * @{
+   */
+  void SetNumberOfPrefetchedImages( unsigned int n );
+  unsigned int GetNumberOfPrefetchedImages() const;
+  /**@}*/
+
+  /** \brief Set/Get the bound on the bytes of the images read ahead
+   *
+   * The pixel buffers of the images which are ready but not yet
+   * returned by Next are counted. A value of zero, the default, does
+   * not bound the memory.
+   * @{
+   */
+  void SetMaximumPrefetchedBytes( uint64_t bytes );
+  uint64_t GetMaximumPrefetchedBytes() const;
+  /**@}*/
+
+  /** \brief Set/Get the options of the ImageFileReader used for each
+   * file
+   *
+   * Changing an option resets the reader.
+   *
+   * \sa ImageReaderBase::SetOutputPixelType
+   * \sa ImageReaderBase::SetImageIO
+   * \sa ImageReaderBase::SetLoadPrivateTags
+   * @{
+   */
+  void SetOutputPixelType( PixelIDValueEnum pixelID );
+  PixelIDValueEnum GetOutputPixelType() const;
+
+  void SetImageIO( const std::string &imageio );
+  const std::string &GetImageIO() const;
+
+  void SetLoadPrivateTags( bool loadPrivateTags );
+  bool GetLoadPrivateTags() const;
+  void LoadPrivateTagsOn() { this->SetLoadPrivateTags(true); }
+  void LoadPrivateTagsOff() { this->SetLoadPrivateTags(false); }
+  /**@}*/
+
+  /** \brief Start reading the files in the background
+   *
+   * Next starts the reading if it has not been started.
+   */
+  void Start();
+
+  /** \brief Return true if an image remains to be returned by Next */
+  bool HasNext() const;
+
+  /** \brief Return the next image in the order of the file names
+   *
+   * Waits until the image has been read. If reading the file failed
+   * the exception is rethrown.
+   */
+  Image Next();
+
+  /** \brief The index in the file names of the next image returned */
+  unsigned int GetNextIndex() const;
+
+  /** \brief Stop the background reading and restart from the first
+   * file
+   */
+  void Reset();
+
+private:
+
+  struct Internals;
+
+  void Stop();
+
+  void Worker();
+
+  std::vector<std::string> m_FileNames;
+  unsigned int m_NumberOfPrefetchedImages{2};
+  uint64_t m_MaximumPrefetchedBytes{0};
+
+  PixelIDValueEnum m_OutputPixelType{sitkUnknown};
+  std::string m_ImageIO;
+  bool m_LoadPrivateTags{false};
+
+  std::unique_ptr<Internals> m_Internals;
+};
+
+}
+}
+
+#endif // sitkImageFilePrefetchReader_h
@@ -30,6 +30,8 @@ namespace itk {
 
   namespace simple {
 
+    namespace ioutils { class MemoryFile; }
+
     /** \class ImageFileReader
      * \brief Read an image file and return a SimpleITK Image.
      *
@@ -76,6 +78,23 @@ namespace itk {
       SITK_RETURN_SELF_TYPE_HEADER SetFileName ( const std::string &fn );
       std::string GetFileName() const;
 
+      /** \brief Read an image encoded in memory
+       *
+       * The buffer holds the content of an image file, such as PNG,
+       * JPEG, NRRD, MetaImage, NIfTI or DICOM data received over the
+       * network. The content is copied when this is called, so the
+       * buffer may be released afterwards. The name of the ImageIO
+       * which decodes it is set with SetImageIO; when empty the
+       * ImageIO is determined from the content, which does not work
+       * for formats recognized by their extension.
+       *
+       * The ImageIOs only read files, so the content is held in a
+       * file on a memory backed file system, "/dev/shm" on Linux,
+       * which is removed when another file name or buffer is set.
+       * GetFileName returns the name of that file.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetBuffer ( const void *buffer, size_t bufferSize, const std::string &imageIO );
+
       Image Execute() override;
 
       // Interface methods to access image file's meta-data and image
@@ -141,6 +160,41 @@ namespace itk {
        **/
       std::string GetMetaData( const std::string &key ) const;
 
+      /** \brief Defer loading the meta-data dictionary until it is first used
+       *
+       * When enabled, ReadImageInformation and Execute do not copy
+       * the meta-data dictionary from the ImageIO. The dictionary is
+       * loaded on the first call to GetMetaDataKeys, HasMetaDataKey or
+       * GetMetaData.
+       *
+       * For DICOM files ReadImageInformation also skips the private
+       * tags, and if LoadPrivateTags is enabled the header is read
+       * again when the meta-data is first accessed. This makes
+       * scanning the size, spacing and pixel type of many files
+       * faster when the meta-data is rarely needed.
+       *
+       * By default this is off.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetLazyMetaDataLoading( bool lazy );
+      bool GetLazyMetaDataLoading() const;
+      void LazyMetaDataLoadingOn() { this->SetLazyMetaDataLoading(true); }
+      void LazyMetaDataLoadingOff() { this->SetLazyMetaDataLoading(false); }
+      /** @} */
+
+      /** \brief Set/Get the meta-data keys which are loaded
+       *
+       * When not empty, only these keys are kept in the meta-data
+       * dictionary of the reader, for example "0010|0010" for the
+       * DICOM patient name. The default is empty, which keeps all
+       * the keys. The meta-data of the image returned by Execute is
+       * not affected.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMetaDataKeysToLoad( const std::vector<std::string> &keys );
+      const std::vector<std::string> &GetMetaDataKeysToLoad() const;
+      /** @} */
+
 
       /** \brief size of image to extract from file.
        *
@@ -181,6 +235,160 @@ namespace itk {
       SITK_RETURN_SELF_TYPE_HEADER SetExtractIndex( const std::vector<int> &index );
       const std::vector<int> &GetExtractIndex(  ) const;
 
+      /** \brief The number of multiscale levels of the file
+       *
+       * Counts the full resolution and the consecutive levels written
+       * beside the file by ImageFileWriter::SetNumberOfMultiscaleLevels,
+       * which are selected with SetMultiscaleLevel. Reading a coarse
+       * level avoids reading the full resolution data. The levels
+       * stored inside a file by an ImageIO, such as OME-Zarr, are not
+       * counted.
+       */
+      unsigned int GetNumberOfMultiscaleLevels() const;
+
+      /** \brief Open the file for reading many regions
+       *
+       * The image information is read and the ImageIO and ITK reader
+       * are kept between calls to ReadRegion and ReadTile, so the
+       * ImageIO is not created again for each region. When the
+       * ImageIO supports streaming, such as for MetaImage files, only
+       * the requested region is read from the file. Otherwise the
+       * whole image is read by the first region read and kept
+       * in memory until the file is closed.
+       *
+       * The file is closed when the file name changes or the reader
+       * is destroyed. After changing the ImageIO, output pixel type
+       * or other reader settings, Open should be called again.
+       * @{
+       */
+      void Open();
+      void Close();
+      bool IsOpen() const;
+      /** @} */
+
+      /** \brief Read a region of the open file
+       *
+       * The index and size have the same meaning as ExtractIndex and
+       * ExtractSize, a size of zero along an axis reduces the
+       * dimension of the region. An empty size reads the whole
+       * image. If the file is not open, Open is called.
+       */
+      Image ReadRegion( const std::vector<int> &index, const std::vector<unsigned int> &size );
+
+      /** \brief Read the image as aligned tiles
+       *
+       * The image is divided into tiles of tileSize, the first axis
+       * varying fastest and the last tiles are truncated at the image
+       * boundary. A missing or zero tile size along an axis uses the
+       * whole extent of that axis, so {0,0,1} reads slices. Each tile
+       * has the dimension of the image. Iterating over the tiles
+       * with ReadTile streams the image through a bounded amount of
+       * memory when the ImageIO supports streaming.
+       *
+       * GetNumberOfTiles is valid once the image information has
+       * been read.
+       * @{
+       */
+      uint64_t GetNumberOfTiles( const std::vector<unsigned int> &tileSize ) const;
+      Image ReadTile( const std::vector<unsigned int> &tileSize, uint64_t tileNumber );
+      /** @} */
+
+      /** \brief Map the intensities to an output range while decoding
+       *
+       * When set, the intensities of the file, after any rescale
+       * applied by the ImageIO such as the DICOM rescale slope and
+       * intercept, are clamped to [windowMinimum, windowMaximum],
+       * linearly mapped to [outputMinimum, outputMaximum] and
+       * converted to the OutputPixelType. The mapping and conversion
+       * is one pass from the buffer decoded by the ImageIO into the
+       * output, so unlike reading followed by
+       * IntensityWindowingImageFilter no intermediate image is
+       * allocated.
+       *
+       * The window is supported when the whole image is read by
+       * Execute or ReadInto, for pixels which are not complex and
+       * when the output has the same number of components as the
+       * file. Otherwise an exception is thrown. GetIntensityWindow
+       * returns the four values, or an empty vector when no window
+       * is set.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetIntensityWindow( double windowMinimum, double windowMaximum,
+                                                       double outputMinimum, double outputMaximum );
+      std::vector<double> GetIntensityWindow( ) const;
+      void RemoveIntensityWindow( );
+      /** @} */
+
+      /** \brief Read the raw pixel data without the page cache
+       *
+       * When enabled, the data of an uncompressed MetaImage or NRRD
+       * file is read with direct IO, O_DIRECT on Linux and F_NOCACHE
+       * on macOS, so large files read once are neither copied through
+       * nor evict the page cache. The data is read with several
+       * large positioned reads in flight, into the image buffer when
+       * its alignment allows it.
+       *
+       * The direct path is only taken when the whole image is read by
+       * Execute or ReadInto and no pixel conversion or byte swapping
+       * is needed, otherwise the file is read by the ImageIO. When the
+       * file system does not support direct IO the data is read
+       * buffered. On Windows direct IO is not supported and the
+       * option only selects the positioned reads. By default this is
+       * off.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetUseDirectIO( bool useDirectIO );
+      bool GetUseDirectIO() const;
+      void UseDirectIOOn() { this->SetUseDirectIO(true); }
+      void UseDirectIOOff() { this->SetUseDirectIO(false); }
+      /** @} */
+
+      /** \brief Advise the operating system that the file is read
+       * sequentially
+       *
+       * When enabled, posix_fadvise with POSIX_FADV_SEQUENTIAL and
+       * POSIX_FADV_WILLNEED is applied to the file before it is read,
+       * which enlarges the read-ahead of the kernel. For the
+       * uncompressed MetaImage and NRRD files described by
+       * SetUseDirectIO the raw data is also read with the positioned
+       * reads. By default this is off.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetSequentialReadAhead( bool sequentialReadAhead );
+      bool GetSequentialReadAhead() const;
+      void SequentialReadAheadOn() { this->SetSequentialReadAhead(true); }
+      void SequentialReadAheadOff() { this->SetSequentialReadAhead(false); }
+      /** @} */
+
+      /** \brief Read the image directly into the buffer of an existing
+       * image
+       *
+       * The pixels of the file, or of the extraction region, are
+       * decoded into the region of destination starting at index,
+       * without allocating an intermediate image. The pixels are
+       * converted to the pixel type of destination, which must have
+       * the same number of components as the file. The image read
+       * may have a lower dimension than destination, so slices or
+       * volumes can be read into a larger image one after another. A
+       * missing index is zero.
+       *
+       * The region must be contiguous in the buffer of destination:
+       * along each axis after the first one where the region is
+       * smaller than destination, the size of the region must be
+       * one. The origin, spacing, direction and meta-data of
+       * destination are not changed.
+       */
+      void ReadInto( Image &destination, const std::vector<unsigned int> &index = std::vector<unsigned int>() );
+
+      /** \brief Read the image directly into a memory buffer
+       *
+       * The pixels are decoded into buffer with the OutputPixelType,
+       * or the pixel type of the file if unknown, with the components
+       * of a pixel interleaved. An exception is thrown if bufferSize,
+       * in bytes, is less than the size of the image read.
+       */
+      void ReadInto( void *buffer, uint64_t bufferSize );
+
     protected:
 
       template <class TImageType> Image ExecuteInternal ( itk::ImageIOBase * );
@@ -196,6 +404,17 @@ namespace itk {
       template <class TImageType, class TInternalImageType>
         Image ExecuteExtract( TInternalImageType * itkImage );
 
+      // Internal method used to read the whole image with the
+      // intensity window applied
+      template <class TImageType, class TReader>
+        Image ExecuteIntensityWindow( TReader *reader, itk::ImageIOBase *imageio );
+
+      // Internal method used to read the raw data of the whole image
+      // with positioned reads, returns a null pointer when the file is
+      // not supported
+      template <class TImageType, class TReader>
+        typename TImageType::Pointer ExecuteRawData( TReader *reader, itk::ImageIOBase *imageio );
+
       // function pointer type
       typedef Image (Self::*MemberFunctionType)( itk::ImageIOBase * );
 
@@ -204,6 +423,34 @@ namespace itk {
       std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
 
 
+      // The ImageIO for the MultiscaleLevel, either of the file or
+      // the level written beside it.
+      itk::SmartPointer<ImageIOBase> GetMultiscaleImageIOBase();
+
+      // Dispatch on the pixel type and dimension of the output.
+      Image ExecuteImageIO( itk::ImageIOBase *imageio );
+
+      // The ImageIO and ITK reader kept by Open.
+      struct OpenFile;
+      std::unique_ptr<OpenFile> m_OpenFile;
+
+      // Set the meta-data dictionary of the reader, keeping only the
+      // MetaDataKeysToLoad.
+      void SetMetaDataDictionary( const MetaDataDictionary &dictionary );
+
+      // Call the deferred loading of the meta-data dictionary, if any.
+      void LoadDeferredMetaData();
+
+      std::function<void()> m_pfLoadMetaData;
+
+      // The content of SetBuffer, the FileName while it is set.
+      std::shared_ptr<ioutils::MemoryFile> m_BufferFile;
+
+      // The destination of ReadInto, used instead of allocating the
+      // output image.
+      void *   m_ReadIntoBuffer{nullptr};
+      uint64_t m_ReadIntoBufferSize{0};
+
       std::function<std::vector<std::string>()> m_pfGetMetaDataKeys;
       std::function<bool(const std::string &)> m_pfHasMetaDataKey;
       std::function<std::string(const std::string &)> m_pfGetMetaData;
@@ -223,6 +470,14 @@ namespace itk {
 
       std::vector<unsigned int> m_ExtractSize;
       std::vector<int>          m_ExtractIndex;
+
+      std::vector<double>       m_IntensityWindow;
+
+      bool                      m_LazyMetaDataLoading{false};
+
+      bool                      m_UseDirectIO{false};
+      bool                      m_SequentialReadAhead{false};
+      std::vector<std::string>  m_MetaDataKeysToLoad;
     };
 
   /**
@@ -74,6 +74,14 @@ class SmartPointer;
        * These methods Set/Get/Toggle the UseCompression flag which
        * gets passed to image file's itk::ImageIO object. This is
        * only a request as not all file formats support compression.
+       *
+       * When writing a compressed MetaImage (.mha or .mhd) and the
+       * NumberOfThreads is greater than one, the data is divided into
+       * NumberOfWorkUnits blocks (NumberOfThreads when zero) which are
+       * compressed concurrently into a standard zlib stream. The
+       * commands of the writer are not invoked for this fast path,
+       * and it is not used when the image has meta-data entries which
+       * are not strings.
        * @{ */
       SITK_RETURN_SELF_TYPE_HEADER SetUseCompression( bool UseCompression );
       bool GetUseCompression( ) const;
@@ -135,18 +143,81 @@ class SmartPointer;
       SITK_RETURN_SELF_TYPE_HEADER KeepOriginalImageUIDOff( ) { return this->SetKeepOriginalImageUID(false); }
       /** @} */
 
+      /** \brief Set/Get the number of multiscale levels written
+       *
+       * When greater than one, after the image is written each
+       * coarser level is computed by BinShrink, averaging by 2 along
+       * the axes of more than one pixel, and written with the same
+       * settings beside the file. Level k of "image.mha" is written to
+       * "image.level<k>.mha", and is read with
+       * ImageReaderBase::SetMultiscaleLevel, so viewers and coarse
+       * registration levels do not read the full resolution data.
+       * Fewer levels are written when the image can not be shrunk
+       * further, and the levels of a previous write which were not
+       * written again are removed.
+       *
+       * The default is 1, which writes only the image. The levels
+       * are not written by WriteRegion.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetNumberOfMultiscaleLevels( unsigned int n );
+      unsigned int GetNumberOfMultiscaleLevels() const;
+      /** @} */
+
       SITK_RETURN_SELF_TYPE_HEADER SetFileName ( const std::string &fileName );
       std::string GetFileName() const;
 
       SITK_RETURN_SELF_TYPE_HEADER Execute ( const Image& );
       SITK_RETURN_SELF_TYPE_HEADER Execute ( const Image& , const std::string &inFileName, bool useCompression, int compressionLevel );
 
+      /** \brief Encode an image in memory
+       *
+       * Returns the content of the file the ImageIO, such as
+       * "PNGImageIO" or "NrrdImageIO", writes for the image, with the
+       * compression settings of the writer. FileName is not
+       * changed and multiscale levels are not written.
+       *
+       * The ImageIOs only write files, so the file is written on a
+       * memory backed file system, "/dev/shm" on Linux, and removed
+       * after it is read back.
+       */
+      std::vector<uint8_t> ExecuteToBuffer ( const Image &image, const std::string &imageIO );
+
+      /** \brief Write an image of size region by region
+       *
+       * Open starts writing FileName as an image of the given size,
+       * an existing file is replaced. Each call to WriteRegion then
+       * pastes an image into the file at index, so a large image can
+       * be written without being in memory. The file and its header
+       * are created by the first WriteRegion, using its pixel type
+       * and the spacing, direction and the origin of index zero
+       * computed from the region. All regions must have the same
+       * pixel type.
+       *
+       * After the first region has been written, WriteRegion may be
+       * called concurrently from several threads for regions that
+       * do not overlap. The commands of the writer are not invoked
+       * for region writes.
+       *
+       * The ImageIO must support streamed writing, for example
+       * uncompressed MetaImage files, otherwise an exception is
+       * thrown by WriteRegion.
+       * @{
+       */
+      void Open( const std::vector<unsigned int> &size );
+      void WriteRegion( const Image &region, const std::vector<unsigned int> &index );
+      void Close();
+      bool IsOpen() const;
+      /** @} */
+
     private:
 
       itk::SmartPointer<ImageIOBase> GetImageIOBase(const std::string &fileName);
 
       template <class T> Self& ExecuteInternal ( const Image& );
 
+      template <class TImageType> void WriteMultiscaleLevels ( const TImageType *image );
+
       bool        m_UseCompression;
       int         m_CompressionLevel;
       std::string m_Compressor;
@@ -154,6 +225,7 @@ class SmartPointer;
       std::string m_FileName;
       bool        m_KeepOriginalImageUID;
       std::string m_ImageIOName;
+      unsigned int m_NumberOfMultiscaleLevels{1};
 
       // function pointer type
       typedef Self& (Self::*MemberFunctionType)( const Image& );
@@ -163,6 +235,26 @@ class SmartPointer;
 
       std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
 
+      template <class T> void WriteRegionInternal ( const Image&, const std::vector<unsigned int> & );
+
+      typedef void (Self::*WriteRegionMemberFunctionType)( const Image&, const std::vector<unsigned int> & );
+
+      template <class TMemberFunctionPointer>
+      struct WriteRegionAddressor
+      {
+        template <typename TImageType>
+        TMemberFunctionPointer operator() ( ) const
+          {
+            return &Self::template WriteRegionInternal< TImageType >;
+          }
+      };
+
+      std::unique_ptr<detail::MemberFunctionFactory<WriteRegionMemberFunctionType> > m_WriteRegionMemberFactory;
+
+      // The state of the file written by regions
+      struct OpenFile;
+      std::shared_ptr<OpenFile> m_OpenFile;
+
     };
 
   /**
@@ -78,6 +78,25 @@ class SmartPointer;
       virtual void LoadPrivateTagsOff();
       /* @} */
 
+      /** \brief Set/Get the resolution level of a multiscale image
+       *
+       * Chunked multiscale formats such as OME-Zarr store a pyramid
+       * of resolutions. Level 0, the default, is the full
+       * resolution. This is supported when ITK is built with
+       * the IOOMEZarrNGFF module, whose ImageIO reads only the
+       * chunks of a requested region (see ImageFileReader::ReadRegion)
+       * and fetches and decompresses them concurrently.
+       *
+       * For other formats, ImageFileReader reads the levels written
+       * by ImageFileWriter::SetNumberOfMultiscaleLevels, and throws an
+       * exception if the level does not exist. ImageSeriesReader
+       * ignores this setting for other ImageIOs.
+       * @{
+       */
+      virtual SITK_RETURN_SELF_TYPE_HEADER SetMultiscaleLevel(unsigned int level);
+      virtual unsigned int GetMultiscaleLevel() const;
+      /* @} */
+
 
       /** \brief Set/Get name of ImageIO to use
        *
@@ -88,8 +107,12 @@ class SmartPointer;
        * can not read the file an exception will be generated.
        *
        * The  default value is an empty string (""). This indicates
-       * that the ImageIO will be automatically determined by the ITK
-       * ImageIO factory mechanism.
+       * that the ImageIO will be automatically determined. The
+       * ImageIOs which list the file's extension are tried first,
+       * then all registered ImageIOs by the ITK ImageIO factory
+       * mechanism. The ImageIO determined for a file is remembered by
+       * the process until the file's length or modification time
+       * changes.
        * @{
        */
       virtual SITK_RETURN_SELF_TYPE_HEADER SetImageIO(const std::string &imageio);
@@ -109,6 +132,10 @@ class SmartPointer;
     protected:
 
       itk::SmartPointer<ImageIOBase> GetImageIOBase(const std::string &fileName);
+      itk::SmartPointer<ImageIOBase> GetImageIOBase(const std::string &fileName, unsigned int multiscaleLevel);
+
+      // Return true if the ImageIO reads the MultiscaleLevel itself
+      static bool IsMultiscaleImageIO(const ImageIOBase *iobase);
 
       void GetPixelIDFromImageIO( const std::string &fileName,
                                   PixelIDValueType &outPixelType,
@@ -132,6 +159,7 @@ class SmartPointer;
 
       PixelIDValueEnum m_OutputPixelType;
       bool             m_LoadPrivateTags;
+      unsigned int     m_MultiscaleLevel;
 
       std::string      m_ImageIOName;
 
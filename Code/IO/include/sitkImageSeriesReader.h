@@ -23,9 +23,13 @@
 #include "sitkImageReaderBase.h"
 #include "sitkMemberFunctionFactory.h"
 
+#include <memory>
+
 namespace itk {
   namespace simple {
 
+    namespace ioutils { class SharedMetaDataDictionaryArray; }
+
     /** \class ImageSeriesReader
      * \brief Read series of image files into a SimpleITK image.
      *
@@ -74,6 +78,11 @@ namespace itk {
        * Set/Get whether the meta-data dictionaries for the slices
        * should be read. Default value is false, because of the
        * additional computation time.
+       *
+       * The dictionaries are stored compactly: the values are
+       * converted to strings, each distinct string is stored once,
+       * and the entries with the same value in all the slices are
+       * shared so each slice only keeps the entries which differ.
        */
       SITK_RETURN_SELF_TYPE_HEADER SetMetaDataDictionaryArrayUpdate ( bool metaDataDictionaryArrayUpdate )
       { this->m_MetaDataDictionaryArrayUpdate = metaDataDictionaryArrayUpdate; return *this; }
@@ -85,6 +94,36 @@ namespace itk {
       SITK_RETURN_SELF_TYPE_HEADER MetaDataDictionaryArrayUpdateOff() { return this->SetMetaDataDictionaryArrayUpdate(false); }
 
 
+      /** \brief The number of files read and decoded concurrently.
+       *
+       * When greater than one, the files are read by that many
+       * threads, each slice decoded directly into its part of the
+       * output buffer, and the meta-data dictionaries are gathered by
+       * the same threads. This reduces the time to read a series
+       * from storage with a high latency, such as network file
+       * systems. Progress events are not reported for the slices read
+       * concurrently. The default is 1, reading one file after
+       * another.
+       *
+       * A series of 3D volumes, such as an fMRI or 4D CT time series,
+       * is read into a 4D image with each volume decoded into its
+       * time point of the buffer, without joining the volumes
+       * afterwards.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetNumberOfParallelReads ( unsigned int n );
+      unsigned int GetNumberOfParallelReads() const;
+
+      /** \brief The spacing of the axis the files are stacked along.
+       *
+       * By default, 0, the spacing is the distance between the
+       * origins of the first two files. The volumes of a time series
+       * usually share the same origin, the time step between them is
+       * set with this instead. A negative value throws an exception.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetSeriesSpacing ( double spacing );
+      double GetSeriesSpacing() const;
+
+
       /** \brief Generate a sequence of filenames from a directory with a DICOM data set and a series ID.
        *
        * This method generates a sequence of filenames whose filenames
@@ -110,6 +149,7 @@ namespace itk {
        * \param loadSequences     Parse any sequences in the DICOM data set. Loading DICOM files is faster when sequences are not needed.
        *
        * \sa itk::GDCMSeriesFileNames
+       * \sa DICOMSeriesIndex
        **/
       static std::vector<std::string> GetGDCMSeriesFileNames( const std::string &directory,
                                                               const std::string &seriesID = "",
@@ -126,6 +166,7 @@ namespace itk {
        * perfusion and DTI imaging. The parameter value must match the
        * value used in the call to GDCMSeriesFileNames.
        * \sa itk::GDCMSeriesFileNames
+       * \sa DICOMSeriesIndex
        **/
       static std::vector<std::string> GetGDCMSeriesIDs( const std::string &directory,
                                                         bool useSeriesDetails = false );
@@ -170,6 +211,8 @@ namespace itk {
 
       template <class TImageType> Image ExecuteInternal ( itk::ImageIOBase * );
 
+      template <class TImageType> Image ExecuteInternalParallel ( itk::ImageIOBase *, const TImageType *information );
+
     private:
 
       // function pointer type
@@ -180,17 +223,20 @@ namespace itk {
       std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
 
 
+      // Set the meta-data accessors to the dictionaries of the slices.
+      void SetMetaDataDictionaryArray( std::shared_ptr<ioutils::SharedMetaDataDictionaryArray> dictionaries );
+
       std::function<std::vector<std::string>(int)> m_pfGetMetaDataKeys;
       std::function<bool(int, const std::string &)> m_pfHasMetaDataKey;
       std::function<std::string(int, const std::string &)> m_pfGetMetaData;
 
-      // Holder of process object for active measurements
-      itk::ProcessObject *m_Filter;
-
-
       std::vector<std::string> m_FileNames;
 
       bool m_MetaDataDictionaryArrayUpdate;
+
+      unsigned int m_NumberOfParallelReads;
+
+      double m_SeriesSpacing;
     };
 
   /**
@@ -125,6 +125,22 @@ class ImageIOBase;
       /** @} */
 
 
+      /** \brief The number of slices encoded and written concurrently.
+       *
+       * When greater than one, each slice is written to its file by a
+       * pool of that many threads. A slice which fails to be written
+       * does not stop the other slices, and after all the slices have
+       * been attempted a single exception reporting every failed file
+       * is thrown. The progress events report the fraction of the
+       * slices which have been written, and occur in the thread which
+       * called Execute. The default is 1, writing one file after
+       * another.
+       * @{ */
+      SITK_RETURN_SELF_TYPE_HEADER SetNumberOfParallelWrites ( unsigned int n );
+      unsigned int GetNumberOfParallelWrites() const;
+      /** @} */
+
+
       SITK_RETURN_SELF_TYPE_HEADER Execute( const Image& );
       SITK_RETURN_SELF_TYPE_HEADER Execute( const Image &image, const std::vector<std::string> &inFileNames, bool useCompression, int compressionLevel );
 
@@ -132,6 +148,9 @@ class ImageIOBase;
 
       template <class TImageType> Self &ExecuteInternal ( const Image& inImage );
 
+      template <class TImageType, class TWriter>
+        void ExecuteInternalParallel ( const TImageType *image, TWriter *writer, itk::ImageIOBase *imageio );
+
     private:
 
       itk::SmartPointer<ImageIOBase> GetImageIOBase(const std::string &fileName);
@@ -150,6 +169,8 @@ class ImageIOBase;
       std::vector<std::string> m_FileNames;
 
       std::string m_ImageIOName;
+
+      unsigned int m_NumberOfParallelWrites;
     };
 
 
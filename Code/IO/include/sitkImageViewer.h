@@ -45,6 +45,8 @@ namespace simple
   * SITK_SHOW_COMMAND:  The user can specify an application other than Fiji
   * to view images.
   *
+  * SITK_SHOW_TEMP_DIRECTORY:  The directory of the temporary image files.
+  *
   * The environment variables are not checked for subsequent ImageViewer
   * objects.
   *
@@ -83,6 +85,21 @@ public:
   static const std::string & GetGlobalDefaultFileExtension();
   /**@}*/
 
+  /** \brief Set/Get the directory of the temporary image files
+   *
+   * By default, or when set to an empty string, on Linux the files
+   * are written into the memory backed "/dev/shm" when it has room
+   * for the image, so the image is handed to the viewer without
+   * writing to a disk. Otherwise the files are written into the
+   * system's temporary directory. The temporary files are not
+   * removed, and in "/dev/shm" they use memory until removed or the
+   * system is restarted.
+   * @{
+   */
+  static void SetGlobalDefaultTempDirectory( const std::string & dir );
+  static const std::string & GetGlobalDefaultTempDirectory();
+  /**@}*/
+
   /** \brief Set/Get the default application used in the command string.
    * @{
    */
@@ -221,6 +238,7 @@ private:
   static std::string m_GlobalDefaultViewCommand;
   static std::string m_GlobalDefaultFileExtension;
   static std::string m_GlobalDefaultApplication;
+  static std::string m_GlobalDefaultTempDirectory;
 
 
   static bool m_GlobalDefaultDebug;
@@ -23,6 +23,9 @@
 #include "sitkImageReaderBase.h"
 #include "sitkMemberFunctionFactory.h"
 
+#include <functional>
+#include <memory>
+
 namespace itk {
   namespace simple {
 
@@ -82,6 +85,54 @@ namespace itk {
       SITK_RETURN_SELF_TYPE_HEADER SetBufferAsFloat( float * buffer, unsigned int numberOfComponents = 1 );
       SITK_RETURN_SELF_TYPE_HEADER SetBufferAsDouble( double * buffer, unsigned int numberOfComponents = 1 );
 
+      /** \brief Set the buffer and transfer its ownership to the output images.
+       *
+       * The deleter is called with the buffer once the filter and
+       * all images created from the buffer have released it, so the
+       * buffer is not copied and need not outlive the caller.
+       * @{
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsInt8( int8_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsUInt8( uint8_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsInt16( int16_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsUInt16( uint16_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsInt32( int32_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsUInt32( uint32_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsInt64( int64_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsUInt64( uint64_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsFloat( float * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      SITK_RETURN_SELF_TYPE_HEADER SetBufferAsDouble( double * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents = 1 );
+      /**@}*/
+
+      /** \brief Use a memory mapped region of a raw file as the image buffer.
+       *
+       * The region starts at offset bytes into the file, and its
+       * length is determined by the size, pixel type and number of
+       * components when executed. The file is mapped privately, so
+       * the page cache holds the only copy of the data and
+       * modifications to the image are not written to the file. The
+       * mapping is owned by the output image and released with it.
+       *
+       * Setting a buffer replaces the file, and vice versa.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetMemoryMappedFile( const std::string &fileName,
+                                                        PixelIDValueEnum pixelID,
+                                                        unsigned int numberOfComponents = 1,
+                                                        uint64_t offset = 0 );
+      const std::string &GetMemoryMappedFile( ) const;
+
+      /** \brief Copy the buffer before the output images modify it.
+       *
+       * When on, the buffer is shared with its owner, so an output
+       * image is copied before it is modified through SimpleITK or
+       * executed in place, and the buffer is only read. Off by
+       * default, and the output images write to the buffer.
+       */
+      SITK_RETURN_SELF_TYPE_HEADER SetCopyOnWrite( bool copyOnWrite );
+      bool GetCopyOnWrite( ) const;
+      SITK_RETURN_SELF_TYPE_HEADER CopyOnWriteOn( ) { return this->SetCopyOnWrite( true ); }
+      SITK_RETURN_SELF_TYPE_HEADER CopyOnWriteOff( ) { return this->SetCopyOnWrite( false ); }
+
       Image Execute() override;
 
     protected:
@@ -118,8 +169,35 @@ namespace itk {
 
       void        * m_Buffer;
 
+      std::string   m_MemoryMappedFileName;
+      uint64_t      m_MemoryMappedFileOffset;
+
+      std::shared_ptr<void> m_BufferOwner;
+      bool m_CopyOnWrite;
+
+      // The deleter is checked before the buffer is set, so a
+      // failed call leaves the filter unchanged.
+      static void CheckBufferDeleter( const std::function<void(void*)> & deleter );
+      void SetBufferOwner( void * buffer, std::function<void(void*)> deleter );
+
     };
 
+  /** \brief Create an image backed by a memory mapped region of a
+   * raw file, without reading the file into memory.
+   *
+   * \sa ImportImageFilter::SetMemoryMappedFile
+   */
+  Image SITKIO_EXPORT ImportFromMemoryMappedFile(
+    const std::string &fileName,
+    PixelIDValueEnum pixelID,
+    const std::vector< unsigned int > &size,
+    const std::vector< double > &spacing = std::vector< double >( 3, 1.0 ),
+    const std::vector< double > &origin = std::vector< double >( 3, 0.0 ),
+    const std::vector< double > &direction = std::vector< double >(),
+    unsigned int numberOfComponents = 1,
+    uint64_t offset = 0
+    );
+
   Image SITKIO_EXPORT ImportAsInt8(
     int8_t * buffer,
     const std::vector< unsigned int > &size,
@@ -0,0 +1,74 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkStreamingResample_h
+#define sitkStreamingResample_h
+
+#include "sitkIO.h"
+#include "sitkImageFileReader.h"
+#include "sitkImageFileWriter.h"
+#include "sitkTransform.h"
+#include "sitkInterpolator.h"
+
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+/** \brief Resample an image file into another file in slabs
+ *
+ * The output grid, of the given size, origin, spacing and direction,
+ * is computed in slabs of slabThickness along its last axis. For
+ * each slab, the bounding box of the slab mapped by the transform is
+ * read from the file of the reader with ImageFileReader::ReadRegion,
+ * resampled as ResampleImageFilter does, and written to the file of
+ * the writer with ImageFileWriter::WriteRegion. So the memory used is
+ * proportional to the slab and its pre-image, not to the images.
+ *
+ * The reader and the writer provide the file names and the IO
+ * settings. The ImageIO of the reader should support streaming and the
+ * ImageIO of the writer must support streamed writing, as uncompressed
+ * MetaImage files do. The reader is opened, and the writer is opened
+ * and closed, by this function.
+ *
+ * For linear transforms the pre-image of a slab is the bounding box of
+ * its corners. For other transforms it is estimated from a lattice of
+ * points of the slab. The region read is enlarged by a margin for the
+ * support of the interpolator. With the BSpline interpolators, which
+ * depend on the whole image, the result differs slightly from
+ * resampling the whole image near the boundaries of the regions.
+ *
+ * \sa itk::simple::ResampleImageFilter
+ */
+SITKIO_EXPORT void StreamingResample( ImageFileReader &reader,
+                                      ImageFileWriter &writer,
+                                      const std::vector<uint32_t> &size,
+                                      const Transform &transform = itk::simple::Transform(),
+                                      InterpolatorEnum interpolator = itk::simple::sitkLinear,
+                                      const std::vector<double> &outputOrigin = std::vector<double>(3, 0.0),
+                                      const std::vector<double> &outputSpacing = std::vector<double>(3, 1.0),
+                                      const std::vector<double> &outputDirection = std::vector<double>(),
+                                      double defaultPixelValue = 0.0,
+                                      PixelIDValueEnum outputPixelType = sitkUnknown,
+                                      unsigned int slabThickness = 16u );
+
+}
+}
+
+#endif
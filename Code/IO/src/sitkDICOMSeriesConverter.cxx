@@ -0,0 +1,524 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkDICOMSeriesConverter.h"
+#include "sitkDICOMSeriesIndex.h"
+#include "sitkImageFileWriter.h"
+#include "sitkImageSeriesReader.h"
+#include "sitkMacro.h"
+
+#include <itkIdentityTransform.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkResampleImageFilter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+// A queue holding at most a fixed number of elements between two
+// stages. Push blocks while the queue is full, Pop blocks while it is
+// empty and returns false once the queue is closed and drained.
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue( size_t capacity )
+    : m_Capacity( std::max<size_t>(capacity, 1) )
+    {}
+
+  void Push( T value )
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_NotFull.wait( lock, [this]{ return m_Queue.size() < m_Capacity; } );
+      m_Queue.push_back( std::move(value) );
+      lock.unlock();
+      m_NotEmpty.notify_one();
+    }
+
+  bool Pop( T &value )
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_NotEmpty.wait( lock, [this]{ return !m_Queue.empty() || m_Closed; } );
+      if ( m_Queue.empty() )
+        {
+        return false;
+        }
+      value = std::move( m_Queue.front() );
+      m_Queue.pop_front();
+      lock.unlock();
+      m_NotFull.notify_one();
+      return true;
+    }
+
+  void Close()
+    {
+      {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Closed = true;
+      }
+      m_NotEmpty.notify_all();
+    }
+
+private:
+  const size_t m_Capacity;
+  bool m_Closed{false};
+  std::deque<T> m_Queue;
+  std::mutex m_Mutex;
+  std::condition_variable m_NotEmpty;
+  std::condition_variable m_NotFull;
+};
+
+
+unsigned int NumberOfThreads( unsigned int requested, size_t numberOfSeries )
+{
+  unsigned int n = requested;
+  if ( n == 0 )
+    {
+    n = std::max( std::thread::hardware_concurrency(), 1u );
+    }
+  return static_cast<unsigned int>( std::max<size_t>( std::min<size_t>( n, numberOfSeries ), 1 ) );
+}
+
+}
+
+
+struct DICOMSeriesConverter::Series
+{
+  std::string seriesID;
+  std::vector<std::string> fileNames;
+  std::string outputFileName;
+  Image image;
+  std::string error;
+};
+
+
+DICOMSeriesConverter::DICOMSeriesConverter()
+{
+  m_MemberFactory.reset( new detail::MemberFunctionFactory<MemberFunctionType>( this ) );
+
+  using PixelIDTypeList = typelist2::append<BasicPixelIDTypeList, VectorPixelIDTypeList>::type;
+  m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2, 3, ResampleAddressor<MemberFunctionType> > ();
+}
+
+
+DICOMSeriesConverter::DICOMSeriesConverter( const std::string &inputDirectory, const std::string &outputDirectory )
+  : DICOMSeriesConverter()
+{
+  m_InputDirectory = inputDirectory;
+  m_OutputDirectory = outputDirectory;
+}
+
+
+DICOMSeriesConverter::~DICOMSeriesConverter() = default;
+
+
+std::string DICOMSeriesConverter::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::" << this->GetName() << std::endl;
+  out << "  InputDirectory: \"" << m_InputDirectory << "\"" << std::endl;
+  out << "  Recursive: " << m_Recursive << std::endl;
+  out << "  IndexFileName: \"" << m_IndexFileName << "\"" << std::endl;
+  out << "  OutputDirectory: \"" << m_OutputDirectory << "\"" << std::endl;
+  out << "  OutputExtension: \"" << m_OutputExtension << "\"" << std::endl;
+  out << "  OutputPixelType: " << m_OutputPixelType << std::endl;
+  out << "  OutputSpacing: [";
+  for ( size_t i = 0; i < m_OutputSpacing.size(); ++i )
+    {
+    out << ( i ? ", " : "" ) << m_OutputSpacing[i];
+    }
+  out << "]" << std::endl;
+  out << "  UseCompression: " << m_UseCompression << std::endl;
+  out << "  NumberOfReaders: " << m_NumberOfReaders << std::endl;
+  out << "  NumberOfWriters: " << m_NumberOfWriters << std::endl;
+  out << "  QueueSize: " << m_QueueSize << std::endl;
+  out << "  ConvertedSeries: " << m_ConvertedSeriesIDs.size() << std::endl;
+  out << "  FailedSeries: " << m_FailedSeriesIDs.size() << std::endl;
+  return out.str();
+}
+
+
+void DICOMSeriesConverter::SetInputDirectory( const std::string &directory )
+{
+  m_InputDirectory = directory;
+}
+
+const std::string &DICOMSeriesConverter::GetInputDirectory() const
+{
+  return m_InputDirectory;
+}
+
+
+void DICOMSeriesConverter::SetRecursive( bool recursive )
+{
+  m_Recursive = recursive;
+}
+
+bool DICOMSeriesConverter::GetRecursive() const
+{
+  return m_Recursive;
+}
+
+
+void DICOMSeriesConverter::SetIndexFileName( const std::string &fileName )
+{
+  m_IndexFileName = fileName;
+}
+
+const std::string &DICOMSeriesConverter::GetIndexFileName() const
+{
+  return m_IndexFileName;
+}
+
+
+void DICOMSeriesConverter::SetOutputDirectory( const std::string &directory )
+{
+  m_OutputDirectory = directory;
+}
+
+const std::string &DICOMSeriesConverter::GetOutputDirectory() const
+{
+  return m_OutputDirectory;
+}
+
+
+void DICOMSeriesConverter::SetOutputExtension( const std::string &extension )
+{
+  m_OutputExtension = extension;
+}
+
+const std::string &DICOMSeriesConverter::GetOutputExtension() const
+{
+  return m_OutputExtension;
+}
+
+
+void DICOMSeriesConverter::SetOutputPixelType( PixelIDValueEnum pixelID )
+{
+  m_OutputPixelType = pixelID;
+}
+
+PixelIDValueEnum DICOMSeriesConverter::GetOutputPixelType() const
+{
+  return m_OutputPixelType;
+}
+
+
+void DICOMSeriesConverter::SetOutputSpacing( const std::vector<double> &spacing )
+{
+  for ( double s : spacing )
+    {
+    if ( !( s > 0.0 ) )
+      {
+      sitkExceptionMacro( "The output spacing must be positive, " << s << " was given." );
+      }
+    }
+  m_OutputSpacing = spacing;
+}
+
+const std::vector<double> &DICOMSeriesConverter::GetOutputSpacing() const
+{
+  return m_OutputSpacing;
+}
+
+
+void DICOMSeriesConverter::SetUseCompression( bool useCompression )
+{
+  m_UseCompression = useCompression;
+}
+
+bool DICOMSeriesConverter::GetUseCompression() const
+{
+  return m_UseCompression;
+}
+
+
+void DICOMSeriesConverter::SetNumberOfReaders( unsigned int n )
+{
+  m_NumberOfReaders = n;
+}
+
+unsigned int DICOMSeriesConverter::GetNumberOfReaders() const
+{
+  return m_NumberOfReaders;
+}
+
+
+void DICOMSeriesConverter::SetNumberOfWriters( unsigned int n )
+{
+  m_NumberOfWriters = n;
+}
+
+unsigned int DICOMSeriesConverter::GetNumberOfWriters() const
+{
+  return m_NumberOfWriters;
+}
+
+
+void DICOMSeriesConverter::SetQueueSize( unsigned int n )
+{
+  m_QueueSize = std::max( n, 1u );
+}
+
+unsigned int DICOMSeriesConverter::GetQueueSize() const
+{
+  return m_QueueSize;
+}
+
+
+unsigned int DICOMSeriesConverter::Execute()
+{
+  if ( m_OutputDirectory.empty() )
+    {
+    sitkExceptionMacro( "The output directory is not set." );
+    }
+
+  m_ConvertedSeriesIDs.clear();
+  m_OutputFileNames.clear();
+  m_FailedSeriesIDs.clear();
+  m_ErrorMessages.clear();
+
+  DICOMSeriesIndex index( m_InputDirectory, m_Recursive );
+  index.SetIndexFileName( m_IndexFileName );
+  index.Update();
+
+  const std::vector<std::string> seriesIDs = index.GetSeriesIDs();
+  std::vector<Series> series( seriesIDs.size() );
+  for ( size_t i = 0; i < seriesIDs.size(); ++i )
+    {
+    series[i].seriesID = seriesIDs[i];
+    series[i].fileNames = index.GetFileNames( seriesIDs[i] );
+    series[i].outputFileName = m_OutputDirectory + "/" + seriesIDs[i] + m_OutputExtension;
+    }
+
+  // The stages exchange the indices of the series, the images are
+  // held in the series.
+  BoundedQueue<size_t> decoded( m_QueueSize );
+  BoundedQueue<size_t> resampled( m_QueueSize );
+
+  const unsigned int numberOfReaders = NumberOfThreads( m_NumberOfReaders, series.size() );
+  const unsigned int numberOfWriters = NumberOfThreads( m_NumberOfWriters, series.size() );
+
+  std::atomic<size_t> nextSeries{0};
+  std::atomic<unsigned int> activeReaders{numberOfReaders};
+
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 0; t < numberOfReaders; ++t )
+    {
+    threads.emplace_back( [&]()
+      {
+        size_t i;
+        while ( ( i = nextSeries++ ) < series.size() )
+          {
+          this->Read( series[i] );
+          if ( series[i].error.empty() )
+            {
+            decoded.Push( i );
+            }
+          }
+        if ( --activeReaders == 0 )
+          {
+          decoded.Close();
+          }
+      } );
+    }
+
+  threads.emplace_back( [&]()
+    {
+      size_t i;
+      while ( decoded.Pop( i ) )
+        {
+        this->Resample( series[i] );
+        if ( series[i].error.empty() )
+          {
+          resampled.Push( i );
+          }
+        }
+      resampled.Close();
+    } );
+
+  for ( unsigned int t = 0; t < numberOfWriters; ++t )
+    {
+    threads.emplace_back( [&]()
+      {
+        size_t i;
+        while ( resampled.Pop( i ) )
+          {
+          this->Write( series[i] );
+          }
+      } );
+    }
+
+  for ( auto &t : threads )
+    {
+    t.join();
+    }
+
+  for ( const Series &s : series )
+    {
+    if ( s.error.empty() )
+      {
+      m_ConvertedSeriesIDs.push_back( s.seriesID );
+      m_OutputFileNames.push_back( s.outputFileName );
+      }
+    else
+      {
+      m_FailedSeriesIDs.push_back( s.seriesID );
+      m_ErrorMessages.push_back( s.error );
+      }
+    }
+
+  return static_cast<unsigned int>( m_ConvertedSeriesIDs.size() );
+}
+
+
+const std::vector<std::string> &DICOMSeriesConverter::GetConvertedSeriesIDs() const
+{
+  return m_ConvertedSeriesIDs;
+}
+
+const std::vector<std::string> &DICOMSeriesConverter::GetOutputFileNames() const
+{
+  return m_OutputFileNames;
+}
+
+const std::vector<std::string> &DICOMSeriesConverter::GetFailedSeriesIDs() const
+{
+  return m_FailedSeriesIDs;
+}
+
+const std::vector<std::string> &DICOMSeriesConverter::GetErrorMessages() const
+{
+  return m_ErrorMessages;
+}
+
+
+void DICOMSeriesConverter::Read( Series &series ) const
+{
+  try
+    {
+    ImageSeriesReader reader;
+    reader.SetImageIO( "GDCMImageIO" );
+    reader.SetOutputPixelType( m_OutputPixelType );
+    reader.SetFileNames( series.fileNames );
+    series.image = reader.Execute();
+    }
+  catch ( std::exception &e )
+    {
+    series.error = e.what();
+    }
+}
+
+
+void DICOMSeriesConverter::Resample( Series &series )
+{
+  if ( m_OutputSpacing.empty() )
+    {
+    return;
+    }
+  try
+    {
+    const Image &image = series.image;
+    if ( m_OutputSpacing.size() != image.GetDimension() )
+      {
+      sitkExceptionMacro( "The output spacing has " << m_OutputSpacing.size()
+                          << " elements but the series has dimension " << image.GetDimension() << "." );
+      }
+    series.image = m_MemberFactory->GetMemberFunction( image.GetPixelID(), image.GetDimension() )( image );
+    }
+  catch ( std::exception &e )
+    {
+    series.error = e.what();
+    series.image = Image();
+    }
+}
+
+
+void DICOMSeriesConverter::Write( Series &series ) const
+{
+  try
+    {
+    ImageFileWriter writer;
+    writer.SetUseCompression( m_UseCompression );
+    writer.SetFileName( series.outputFileName );
+    writer.Execute( series.image );
+    }
+  catch ( std::exception &e )
+    {
+    series.error = e.what();
+    }
+  // release the image as soon as it is written
+  series.image = Image();
+}
+
+
+template <class TImageType>
+Image DICOMSeriesConverter::ResampleInternal( const Image &image )
+{
+  constexpr unsigned int Dimension = TImageType::ImageDimension;
+
+  using ResampleType = itk::ResampleImageFilter<TImageType, TImageType>;
+  using TransformType = itk::IdentityTransform<double, Dimension>;
+  using InterpolatorType = itk::LinearInterpolateImageFunction<TImageType, double>;
+
+  const TImageType *input = dynamic_cast<const TImageType *>( image.GetITKBase() );
+  if ( input == nullptr )
+    {
+    sitkExceptionMacro( "Unexpected template dispatch error!" );
+    }
+
+  const typename TImageType::SizeType inputSize = input->GetLargestPossibleRegion().GetSize();
+  const typename TImageType::SpacingType inputSpacing = input->GetSpacing();
+
+  // the same physical extent, with at least one pixel
+  typename TImageType::SizeType size;
+  typename TImageType::SpacingType spacing;
+  for ( unsigned int d = 0; d < Dimension; ++d )
+    {
+    spacing[d] = m_OutputSpacing[d];
+    const double extent = inputSize[d] * inputSpacing[d];
+    size[d] = std::max<itk::SizeValueType>( static_cast<itk::SizeValueType>( std::llround( extent / spacing[d] ) ), 1 );
+    }
+
+  typename ResampleType::Pointer resample = ResampleType::New();
+  resample->SetInput( input );
+  resample->SetTransform( TransformType::New() );
+  resample->SetInterpolator( InterpolatorType::New() );
+  resample->SetSize( size );
+  resample->SetOutputSpacing( spacing );
+  resample->SetOutputOrigin( input->GetOrigin() );
+  resample->SetOutputDirection( input->GetDirection() );
+  resample->Update();
+
+  return Image( resample->GetOutput() );
+}
+
+}
+}
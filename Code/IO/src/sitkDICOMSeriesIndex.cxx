@@ -0,0 +1,592 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkDICOMSeriesIndex.h"
+#include "sitkMacro.h"
+
+#include <itksys/Directory.hxx>
+#include <itksys/SystemTools.hxx>
+
+#include "gdcmReader.h"
+#include "gdcmDataSet.h"
+#include "gdcmTag.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+const char * const IndexFileHeader = "# SimpleITK DICOMSeriesIndex 1";
+
+const gdcm::Tag SeriesInstanceUIDTag(0x0020, 0x000e);
+const gdcm::Tag InstanceNumberTag(0x0020, 0x0013);
+const gdcm::Tag ImagePositionPatientTag(0x0020, 0x0032);
+const gdcm::Tag ImageOrientationPatientTag(0x0020, 0x0037);
+
+// Return the value of a string element without the padding
+bool GetStringValue( const gdcm::DataSet &ds, const gdcm::Tag &tag, std::string &value )
+{
+  if ( !ds.FindDataElement(tag) )
+    {
+    return false;
+    }
+  const gdcm::ByteValue *bv = ds.GetDataElement(tag).GetByteValue();
+  if ( !bv )
+    {
+    return false;
+    }
+  value.assign( bv->GetPointer(), bv->GetLength() );
+  const std::string::size_type first = value.find_first_not_of(" \0", 0, 2);
+  const std::string::size_type last = value.find_last_not_of(" \0", std::string::npos, 2);
+  if ( first == std::string::npos )
+    {
+    value.clear();
+    return false;
+    }
+  value = value.substr(first, last - first + 1);
+  return true;
+}
+
+// Parse exactly n backslash separated decimal values
+bool ParseDecimalStrings( const std::string &value, double *out, unsigned int n )
+{
+  std::istringstream iss(value);
+  std::string token;
+  unsigned int i = 0;
+  while ( std::getline(iss, token, '\\') )
+    {
+    if ( i == n )
+      {
+      return false;
+      }
+    char *end = nullptr;
+    out[i] = std::strtod(token.c_str(), &end);
+    if ( end == token.c_str() )
+      {
+      return false;
+      }
+    ++i;
+    }
+  return i == n;
+}
+
+template <class T>
+void WriteValues( std::ostream &os, bool has, const T *values, unsigned int n )
+{
+  if ( has )
+    {
+    for ( unsigned int i = 0; i < n; ++i )
+      {
+      os << ( i ? " " : "" ) << values[i];
+      }
+    }
+}
+
+template <class T>
+bool ReadValues( const std::string &field, T *values, unsigned int n )
+{
+  if ( field.empty() )
+    {
+    return false;
+    }
+  std::istringstream iss(field);
+  for ( unsigned int i = 0; i < n; ++i )
+    {
+    if ( !(iss >> values[i]) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+
+DICOMSeriesIndex::DICOMSeriesIndex() = default;
+
+
+DICOMSeriesIndex::DICOMSeriesIndex( const std::string &directory, bool recursive )
+  : m_Directory(directory),
+    m_Recursive(recursive)
+{
+}
+
+
+DICOMSeriesIndex::~DICOMSeriesIndex() = default;
+
+
+std::string DICOMSeriesIndex::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::" << this->GetName() << std::endl;
+  out << "  Directory: \"" << m_Directory << "\"" << std::endl;
+  out << "  Recursive: " << m_Recursive << std::endl;
+  out << "  IndexFileName: \"" << m_IndexFileName << "\"" << std::endl;
+  out << "  NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  out << "  NumberOfFiles: " << m_Entries.size() << std::endl;
+  out << "  NumberOfSeries: " << this->GetSeriesIDs().size() << std::endl;
+  out << "  NumberOfFilesParsed: " << m_NumberOfFilesParsed << std::endl;
+  return out.str();
+}
+
+
+void DICOMSeriesIndex::SetDirectory( const std::string &directory )
+{
+  if ( directory != m_Directory )
+    {
+    m_Directory = directory;
+    m_Entries.clear();
+    m_IndexFileLoaded = false;
+    }
+}
+
+
+const std::string &DICOMSeriesIndex::GetDirectory() const
+{
+  return m_Directory;
+}
+
+
+void DICOMSeriesIndex::SetRecursive( bool recursive )
+{
+  m_Recursive = recursive;
+}
+
+
+bool DICOMSeriesIndex::GetRecursive() const
+{
+  return m_Recursive;
+}
+
+
+void DICOMSeriesIndex::SetIndexFileName( const std::string &fileName )
+{
+  if ( fileName != m_IndexFileName )
+    {
+    m_IndexFileName = fileName;
+    m_IndexFileLoaded = false;
+    }
+}
+
+
+const std::string &DICOMSeriesIndex::GetIndexFileName() const
+{
+  return m_IndexFileName;
+}
+
+
+void DICOMSeriesIndex::SetNumberOfThreads( unsigned int n )
+{
+  m_NumberOfThreads = n;
+}
+
+
+unsigned int DICOMSeriesIndex::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+
+unsigned int DICOMSeriesIndex::GetNumberOfFilesParsed() const
+{
+  return m_NumberOfFilesParsed;
+}
+
+
+void DICOMSeriesIndex::Update()
+{
+  if ( !itksys::SystemTools::FileIsDirectory(m_Directory) )
+    {
+    sitkExceptionMacro( "The directory \"" << m_Directory << "\" does not exist." );
+    }
+
+  bool modified = false;
+  if ( !m_IndexFileLoaded && !m_IndexFileName.empty() )
+    {
+    modified = !this->LoadIndexFile();
+    m_IndexFileLoaded = true;
+    }
+
+  std::vector<std::string> fileNames;
+  this->ListFiles( m_Directory, fileNames );
+  const std::set<std::string> current( fileNames.begin(), fileNames.end() );
+
+  for ( auto it = m_Entries.begin(); it != m_Entries.end(); )
+    {
+    if ( current.count(it->first) == 0 )
+      {
+      it = m_Entries.erase(it);
+      modified = true;
+      }
+    else
+      {
+      ++it;
+      }
+    }
+
+  // Only the new and changed files are parsed
+  std::vector<std::string> toParse;
+  std::vector<Entry>       parsed;
+  for ( const auto &fileName : fileNames )
+    {
+    Entry e;
+    e.modifiedTime = itksys::SystemTools::ModifiedTime( fileName );
+    e.fileSize = itksys::SystemTools::FileLength( fileName );
+
+    auto it = m_Entries.find(fileName);
+    if ( it == m_Entries.end()
+         || it->second.modifiedTime != e.modifiedTime
+         || it->second.fileSize != e.fileSize )
+      {
+      toParse.push_back(fileName);
+      parsed.push_back(e);
+      }
+    }
+
+  unsigned int numberOfThreads = m_NumberOfThreads;
+  if ( numberOfThreads == 0 )
+    {
+    numberOfThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+  numberOfThreads = static_cast<unsigned int>( std::min<size_t>( numberOfThreads, toParse.size() ) );
+
+  std::atomic<size_t> next{0};
+
+  auto worker = [&]()
+    {
+      size_t i;
+      while ( (i = next++) < toParse.size() )
+        {
+        // Files which are not DICOM are kept with an empty series
+        // so that they are not parsed again.
+        try
+          {
+          if ( !ParseFile( toParse[i], parsed[i] ) )
+            {
+            parsed[i].seriesID.clear();
+            }
+          }
+        catch (...)
+          {
+          parsed[i].seriesID.clear();
+          }
+        }
+    };
+
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 1; t < numberOfThreads; ++t )
+    {
+    threads.emplace_back(worker);
+    }
+  if ( numberOfThreads > 0 )
+    {
+    worker();
+    }
+  for ( auto &thread : threads )
+    {
+    thread.join();
+    }
+
+  for ( size_t i = 0; i < toParse.size(); ++i )
+    {
+    m_Entries[toParse[i]] = parsed[i];
+    }
+  m_NumberOfFilesParsed = static_cast<unsigned int>( toParse.size() );
+  modified = modified || !toParse.empty();
+
+  if ( modified && !m_IndexFileName.empty() )
+    {
+    this->SaveIndexFile();
+    }
+}
+
+
+std::vector<std::string> DICOMSeriesIndex::GetSeriesIDs() const
+{
+  std::set<std::string> ids;
+  for ( const auto &e : m_Entries )
+    {
+    if ( !e.second.seriesID.empty() )
+      {
+      ids.insert(e.second.seriesID);
+      }
+    }
+  return std::vector<std::string>( ids.begin(), ids.end() );
+}
+
+
+std::vector<std::string> DICOMSeriesIndex::GetFileNames( const std::string &seriesID ) const
+{
+  std::string id = seriesID;
+  if ( id.empty() )
+    {
+    const std::vector<std::string> ids = this->GetSeriesIDs();
+    if ( ids.empty() )
+      {
+      return std::vector<std::string>();
+      }
+    id = ids.front();
+    }
+
+  std::vector<std::pair<std::string, const Entry *> > series;
+  for ( const auto &e : m_Entries )
+    {
+    if ( e.second.seriesID == id )
+      {
+      series.emplace_back( e.first, &e.second );
+      }
+    }
+
+  bool hasGeometry = !series.empty();
+  bool hasInstanceNumbers = !series.empty();
+  for ( const auto &s : series )
+    {
+    hasGeometry = hasGeometry && s.second->hasPosition && s.second->hasOrientation;
+    hasInstanceNumbers = hasInstanceNumbers && s.second->hasInstanceNumber;
+    }
+
+  // m_Entries is ordered by file name, so a stable sort keeps the
+  // file name as the last criteria.
+  if ( hasGeometry )
+    {
+    const double *o = series.front().second->orientation;
+    const double normal[3] = { o[1]*o[5] - o[2]*o[4],
+                               o[2]*o[3] - o[0]*o[5],
+                               o[0]*o[4] - o[1]*o[3] };
+
+    std::vector<std::pair<double, size_t> > distances;
+    for ( size_t i = 0; i < series.size(); ++i )
+      {
+      const double *p = series[i].second->position;
+      distances.emplace_back( normal[0]*p[0] + normal[1]*p[1] + normal[2]*p[2], i );
+      }
+    std::stable_sort( distances.begin(), distances.end(),
+                      []( const std::pair<double, size_t> &a, const std::pair<double, size_t> &b )
+                        { return a.first < b.first; } );
+
+    bool distinct = true;
+    for ( size_t i = 1; i < distances.size(); ++i )
+      {
+      distinct = distinct && distances[i-1].first != distances[i].first;
+      }
+
+    if ( distinct )
+      {
+      std::vector<std::string> fileNames;
+      for ( const auto &d : distances )
+        {
+        fileNames.push_back( series[d.second].first );
+        }
+      return fileNames;
+      }
+    }
+
+  if ( hasInstanceNumbers )
+    {
+    std::stable_sort( series.begin(), series.end(),
+                      []( const std::pair<std::string, const Entry *> &a,
+                          const std::pair<std::string, const Entry *> &b )
+                        { return a.second->instanceNumber < b.second->instanceNumber; } );
+    }
+
+  std::vector<std::string> fileNames;
+  for ( const auto &s : series )
+    {
+    fileNames.push_back( s.first );
+    }
+  return fileNames;
+}
+
+
+bool DICOMSeriesIndex::ParseFile( const std::string &fileName, Entry &entry )
+{
+  std::set<gdcm::Tag> tags;
+  tags.insert(SeriesInstanceUIDTag);
+  tags.insert(InstanceNumberTag);
+  tags.insert(ImagePositionPatientTag);
+  tags.insert(ImageOrientationPatientTag);
+
+  gdcm::Reader reader;
+  reader.SetFileName( fileName.c_str() );
+  if ( !reader.ReadSelectedTags(tags) )
+    {
+    return false;
+    }
+  const gdcm::DataSet &ds = reader.GetFile().GetDataSet();
+
+  std::string value;
+  if ( !GetStringValue(ds, SeriesInstanceUIDTag, entry.seriesID) )
+    {
+    return false;
+    }
+  if ( GetStringValue(ds, ImagePositionPatientTag, value) )
+    {
+    entry.hasPosition = ParseDecimalStrings(value, entry.position, 3);
+    }
+  if ( GetStringValue(ds, ImageOrientationPatientTag, value) )
+    {
+    entry.hasOrientation = ParseDecimalStrings(value, entry.orientation, 6);
+    }
+  if ( GetStringValue(ds, InstanceNumberTag, value) )
+    {
+    char *end = nullptr;
+    entry.instanceNumber = static_cast<int>( std::strtol(value.c_str(), &end, 10) );
+    entry.hasInstanceNumber = ( end != value.c_str() );
+    }
+  return true;
+}
+
+
+void DICOMSeriesIndex::ListFiles( const std::string &directory, std::vector<std::string> &fileNames ) const
+{
+  itksys::Directory dir;
+  if ( !dir.Load(directory) )
+    {
+    return;
+    }
+
+  for ( unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i )
+    {
+    const std::string name = dir.GetFile(i);
+    if ( name == "." || name == ".." )
+      {
+      continue;
+      }
+    const std::string path = directory + "/" + name;
+    if ( itksys::SystemTools::FileIsDirectory(path) )
+      {
+      if ( m_Recursive && !itksys::SystemTools::FileIsSymlink(path) )
+        {
+        this->ListFiles( path, fileNames );
+        }
+      }
+    else if ( !this->IsIndexFile(path) )
+      {
+      fileNames.push_back( path );
+      }
+    }
+}
+
+
+bool DICOMSeriesIndex::IsIndexFile( const std::string &path ) const
+{
+  if ( m_IndexFileName.empty() )
+    {
+    return false;
+    }
+  const std::string fullPath = itksys::SystemTools::CollapseFullPath( path );
+  const std::string indexPath = itksys::SystemTools::CollapseFullPath( m_IndexFileName );
+  return fullPath == indexPath || fullPath == indexPath + ".tmp";
+}
+
+
+bool DICOMSeriesIndex::LoadIndexFile()
+{
+  std::ifstream in( m_IndexFileName.c_str() );
+  if ( !in )
+    {
+    return false;
+    }
+
+  std::string line;
+  if ( !std::getline(in, line) || line != IndexFileHeader )
+    {
+    return false;
+    }
+
+  std::map<std::string, Entry> entries;
+  while ( std::getline(in, line) )
+    {
+    std::vector<std::string> fields;
+    std::istringstream iss(line);
+    std::string field;
+    while ( std::getline(iss, field, '\t') )
+      {
+      fields.push_back(field);
+      }
+    fields.resize( 7 );
+
+    Entry e;
+    if ( fields[0].empty()
+         || !ReadValues(fields[1], &e.modifiedTime, 1)
+         || !ReadValues(fields[2], &e.fileSize, 1) )
+      {
+      return false;
+      }
+    e.seriesID = fields[3];
+    e.hasPosition = ReadValues(fields[4], e.position, 3);
+    e.hasOrientation = ReadValues(fields[5], e.orientation, 6);
+    e.hasInstanceNumber = ReadValues(fields[6], &e.instanceNumber, 1);
+    entries[fields[0]] = e;
+    }
+
+  m_Entries = std::move(entries);
+  return true;
+}
+
+
+void DICOMSeriesIndex::SaveIndexFile() const
+{
+  // Write to a temporary file and rename it so that a reader never
+  // sees a partially written index.
+  const std::string tmpFileName = m_IndexFileName + ".tmp";
+  {
+  std::ofstream out( tmpFileName.c_str() );
+  if ( !out )
+    {
+    sitkExceptionMacro( "Unable to write the DICOM series index file \"" << tmpFileName << "\"." );
+    }
+
+  out << IndexFileHeader << "\n" << std::setprecision(17);
+  for ( const auto &e : m_Entries )
+    {
+    out << e.first << "\t" << e.second.modifiedTime << "\t" << e.second.fileSize << "\t" << e.second.seriesID << "\t";
+    WriteValues( out, e.second.hasPosition, e.second.position, 3 );
+    out << "\t";
+    WriteValues( out, e.second.hasOrientation, e.second.orientation, 6 );
+    out << "\t";
+    WriteValues( out, e.second.hasInstanceNumber, &e.second.instanceNumber, 1 );
+    out << "\n";
+    }
+  if ( !out )
+    {
+    sitkExceptionMacro( "Error writing the DICOM series index file \"" << tmpFileName << "\"." );
+    }
+  }
+
+  itksys::SystemTools::RemoveFile( m_IndexFileName );
+  if ( !itksys::SystemTools::RenameFile( tmpFileName, m_IndexFileName ) )
+    {
+    sitkExceptionMacro( "Unable to rename \"" << tmpFileName << "\" to \"" << m_IndexFileName << "\"." );
+    }
+}
+
+}
+}
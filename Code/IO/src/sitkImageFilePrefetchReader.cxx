@@ -0,0 +1,326 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkImageFilePrefetchReader.h"
+#include "sitkImageFileReader.h"
+#include "sitkMacro.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace itk
+{
+namespace simple
+{
+
+struct ImageFilePrefetchReader::Internals
+{
+  struct Result
+  {
+    Image image;
+    std::exception_ptr error;
+    uint64_t bytes{0};
+  };
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::thread> threads;
+
+  bool started{false};
+  bool stop{false};
+
+  // index of the next file to be read by a worker
+  unsigned int dispatched{0};
+  // index of the next image returned by Next
+  unsigned int consumed{0};
+
+  std::map<unsigned int, Result> ready;
+  uint64_t readyBytes{0};
+};
+
+
+ImageFilePrefetchReader::ImageFilePrefetchReader()
+  : m_Internals(new Internals)
+{
+}
+
+
+ImageFilePrefetchReader::ImageFilePrefetchReader( const std::vector<std::string> &fileNames,
+                                                  unsigned int numberOfPrefetchedImages )
+  : m_FileNames(fileNames),
+    m_NumberOfPrefetchedImages(std::max(numberOfPrefetchedImages, 1u)),
+    m_Internals(new Internals)
+{
+}
+
+
+ImageFilePrefetchReader::~ImageFilePrefetchReader()
+{
+  this->Stop();
+}
+
+
+std::string ImageFilePrefetchReader::ToString() const
+{
+  std::ostringstream out;
+  out << "itk::simple::" << this->GetName() << std::endl;
+  out << "  FileNames: " << m_FileNames.size() << " files" << std::endl;
+  out << "  NumberOfPrefetchedImages: " << m_NumberOfPrefetchedImages << std::endl;
+  out << "  MaximumPrefetchedBytes: " << m_MaximumPrefetchedBytes << std::endl;
+  out << "  OutputPixelType: " << m_OutputPixelType << std::endl;
+  out << "  ImageIO: \"" << m_ImageIO << "\"" << std::endl;
+  out << "  LoadPrivateTags: " << m_LoadPrivateTags << std::endl;
+  out << "  NextIndex: " << this->GetNextIndex() << std::endl;
+  return out.str();
+}
+
+
+void ImageFilePrefetchReader::SetFileNames( const std::vector<std::string> &fileNames )
+{
+  this->Stop();
+  m_FileNames = fileNames;
+}
+
+const std::vector<std::string> &ImageFilePrefetchReader::GetFileNames() const
+{
+  return m_FileNames;
+}
+
+
+void ImageFilePrefetchReader::SetNumberOfPrefetchedImages( unsigned int n )
+{
+  this->Stop();
+  m_NumberOfPrefetchedImages = std::max(n, 1u);
+}
+
+unsigned int ImageFilePrefetchReader::GetNumberOfPrefetchedImages() const
+{
+  return m_NumberOfPrefetchedImages;
+}
+
+
+void ImageFilePrefetchReader::SetMaximumPrefetchedBytes( uint64_t bytes )
+{
+  this->Stop();
+  m_MaximumPrefetchedBytes = bytes;
+}
+
+uint64_t ImageFilePrefetchReader::GetMaximumPrefetchedBytes() const
+{
+  return m_MaximumPrefetchedBytes;
+}
+
+
+void ImageFilePrefetchReader::SetOutputPixelType( PixelIDValueEnum pixelID )
+{
+  this->Stop();
+  m_OutputPixelType = pixelID;
+}
+
+PixelIDValueEnum ImageFilePrefetchReader::GetOutputPixelType() const
+{
+  return m_OutputPixelType;
+}
+
+
+void ImageFilePrefetchReader::SetImageIO( const std::string &imageio )
+{
+  this->Stop();
+  m_ImageIO = imageio;
+}
+
+const std::string &ImageFilePrefetchReader::GetImageIO() const
+{
+  return m_ImageIO;
+}
+
+
+void ImageFilePrefetchReader::SetLoadPrivateTags( bool loadPrivateTags )
+{
+  this->Stop();
+  m_LoadPrivateTags = loadPrivateTags;
+}
+
+bool ImageFilePrefetchReader::GetLoadPrivateTags() const
+{
+  return m_LoadPrivateTags;
+}
+
+
+void ImageFilePrefetchReader::Start()
+{
+  std::lock_guard<std::mutex> lock(m_Internals->mutex);
+  if ( m_Internals->started )
+    {
+    return;
+    }
+  m_Internals->started = true;
+  m_Internals->stop = false;
+
+  const unsigned int remaining = static_cast<unsigned int>(m_FileNames.size()) - m_Internals->consumed;
+  const unsigned int numberOfThreads = std::min(m_NumberOfPrefetchedImages, remaining);
+  for ( unsigned int i = 0; i < numberOfThreads; ++i )
+    {
+    m_Internals->threads.emplace_back(&Self::Worker, this);
+    }
+}
+
+
+bool ImageFilePrefetchReader::HasNext() const
+{
+  return this->GetNextIndex() < m_FileNames.size();
+}
+
+
+Image ImageFilePrefetchReader::Next()
+{
+  if ( !this->HasNext() )
+    {
+    sitkExceptionMacro( "No image remains to be read, the " << m_FileNames.size() << " files have been returned." );
+    }
+
+  this->Start();
+
+  Internals::Result result;
+  {
+  std::unique_lock<std::mutex> lock(m_Internals->mutex);
+  const unsigned int index = m_Internals->consumed;
+  m_Internals->condition.wait( lock, [this, index]{ return m_Internals->ready.count(index) != 0; } );
+
+  auto iter = m_Internals->ready.find(index);
+  result = std::move(iter->second);
+  m_Internals->ready.erase(iter);
+  m_Internals->readyBytes -= result.bytes;
+  ++m_Internals->consumed;
+  }
+  m_Internals->condition.notify_all();
+
+  if ( result.error )
+    {
+    std::rethrow_exception( result.error );
+    }
+  return result.image;
+}
+
+
+unsigned int ImageFilePrefetchReader::GetNextIndex() const
+{
+  std::lock_guard<std::mutex> lock(m_Internals->mutex);
+  return m_Internals->consumed;
+}
+
+
+void ImageFilePrefetchReader::Reset()
+{
+  this->Stop();
+}
+
+
+void ImageFilePrefetchReader::Stop()
+{
+  {
+  std::lock_guard<std::mutex> lock(m_Internals->mutex);
+  m_Internals->stop = true;
+  }
+  m_Internals->condition.notify_all();
+
+  for ( auto &t : m_Internals->threads )
+    {
+    t.join();
+    }
+
+  m_Internals->threads.clear();
+  m_Internals->started = false;
+  m_Internals->stop = false;
+  m_Internals->dispatched = 0;
+  m_Internals->consumed = 0;
+  m_Internals->ready.clear();
+  m_Internals->readyBytes = 0;
+}
+
+
+void ImageFilePrefetchReader::Worker()
+{
+  const unsigned int numberOfFiles = static_cast<unsigned int>(m_FileNames.size());
+
+  while ( true )
+    {
+    unsigned int index;
+    {
+    std::unique_lock<std::mutex> lock(m_Internals->mutex);
+
+    // A file is started when it is within the number of prefetched
+    // images of the consumer and the images waiting to be consumed
+    // are within the memory bound. The next image consumed is always
+    // started so the consumer can not be blocked.
+    auto canStart = [this, numberOfFiles]()
+      {
+        const Internals &s = *m_Internals;
+        if ( s.stop || s.dispatched >= numberOfFiles )
+          {
+          return true;
+          }
+        if ( s.dispatched == s.consumed )
+          {
+          return true;
+          }
+        return s.dispatched < s.consumed + m_NumberOfPrefetchedImages &&
+          ( m_MaximumPrefetchedBytes == 0 || s.readyBytes < m_MaximumPrefetchedBytes );
+      };
+    m_Internals->condition.wait( lock, canStart );
+
+    if ( m_Internals->stop || m_Internals->dispatched >= numberOfFiles )
+      {
+      return;
+      }
+    index = m_Internals->dispatched++;
+    }
+
+    Internals::Result result;
+    try
+      {
+      ImageFileReader reader;
+      reader.SetFileName( m_FileNames[index] );
+      reader.SetOutputPixelType( m_OutputPixelType );
+      reader.SetImageIO( m_ImageIO );
+      reader.SetLoadPrivateTags( m_LoadPrivateTags );
+      result.image = reader.Execute();
+      result.bytes = result.image.GetNumberOfPixels() *
+        result.image.GetNumberOfComponentsPerPixel() *
+        result.image.GetSizeOfPixelComponent();
+      }
+    catch ( ... )
+      {
+      result.error = std::current_exception();
+      }
+
+    {
+    std::lock_guard<std::mutex> lock(m_Internals->mutex);
+    m_Internals->readyBytes += result.bytes;
+    m_Internals->ready.emplace( index, std::move(result) );
+    }
+    m_Internals->condition.notify_all();
+    }
+}
+
+}
+}
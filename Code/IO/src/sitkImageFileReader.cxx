@@ -20,12 +20,25 @@
 #endif
 
 #include "sitkImageFileReader.h"
+#include "sitkImageIOUtilities.h"
+#include "sitkRawFileIO.h"
+#include "sitkTraceRange.h"
 
 #include <itkImageFileReader.h>
+#include <itkByteSwapper.h>
 #include <itkExtractImageFilter.h>
+#include <itkGDCMImageIO.h>
+#include <itksys/SystemTools.hxx>
+
+#include "sitkTemplateFunctions.h"
 
 #include "sitkMetaDataDictionaryCustomCast.hxx"
 
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <type_traits>
+
 namespace itk {
   namespace simple {
 
@@ -61,6 +74,110 @@ namespace itk {
             }
           }
       }
+
+      // A pixel container for output which uses buffer.
+      template< class TImageType>
+      typename TImageType::PixelContainer::Pointer
+      MakeImportContainer( const TImageType *output, void *buffer, uint64_t bufferSize )
+      {
+        using PixelContainerType = typename TImageType::PixelContainer;
+        using ElementType = typename PixelContainerType::Element;
+
+        const uint64_t length = output->GetLargestPossibleRegion().GetNumberOfPixels() * output->GetNumberOfComponentsPerPixel();
+        if ( length * sizeof(ElementType) > bufferSize )
+          {
+          sitkExceptionMacro( "The buffer of " << bufferSize << " bytes is smaller than the "
+                              << length * sizeof(ElementType) << " bytes of the image read." );
+          }
+
+        typename PixelContainerType::Pointer container = PixelContainerType::New();
+        container->SetImportPointer( static_cast<ElementType *>( buffer ), length, false );
+        return container;
+      }
+
+      // Use buffer as the pixel container of output, instead of
+      // allocating one. The output information must be up to date.
+      template< class TImageType>
+      void ImportOutputBuffer( TImageType *output, itk::ProcessObject *source, void *buffer, uint64_t bufferSize )
+      {
+        auto container = MakeImportContainer( output, buffer, bufferSize );
+
+        // Set the buffer after the pipeline initializes the output, so
+        // the allocation of the output reuses it.
+        source->AddObserver( itk::StartEvent(), [output, container]( const itk::EventObject & ) { output->SetPixelContainer( container ); } );
+      }
+
+      // Copy the output into buffer if the pipeline did not decode
+      // into it.
+      template< class TImageType>
+      void CopyOutputToBuffer( const TImageType *output, void *buffer )
+      {
+        using ElementType = typename TImageType::PixelContainer::Element;
+
+        if ( output->GetBufferPointer() != buffer )
+          {
+          std::copy_n( output->GetBufferPointer(), output->GetPixelContainer()->Size(), static_cast<ElementType *>( buffer ) );
+          }
+      }
+
+      // Clamp the components to the window and map them linearly to
+      // the output, in one loop without branches so it vectorizes.
+      template< typename TInput, typename TOutput>
+      typename std::enable_if<std::is_arithmetic<TOutput>::value>::type
+      WindowComponents( const TInput *in, TOutput *out, size_t n, const std::vector<double> &window )
+      {
+        const double windowMinimum = window[0];
+        const double windowMaximum = window[1];
+        const double scale = ( window[3] - window[2] ) / ( windowMaximum - windowMinimum );
+        const double shift = window[2] - windowMinimum * scale;
+        for ( size_t i = 0; i < n; ++i )
+          {
+          const double v = std::min( std::max( static_cast<double>( in[i] ), windowMinimum ), windowMaximum );
+          out[i] = static_cast<TOutput>( v * scale + shift );
+          }
+      }
+
+      template< typename TInput, typename TOutput>
+      typename std::enable_if<!std::is_arithmetic<TOutput>::value>::type
+      WindowComponents( const TInput *, TOutput *, size_t, const std::vector<double> & )
+      {
+        sitkExceptionMacro( "The intensity window is not supported for complex pixel types." );
+      }
+
+      template< typename TOutput>
+      void WindowBuffer( itk::IOComponentEnum componentType, const void *in, TOutput *out, size_t n, const std::vector<double> &window )
+      {
+        switch ( componentType )
+          {
+          case itk::IOComponentEnum::CHAR:
+            return WindowComponents( static_cast<const char *>( in ), out, n, window );
+          case itk::IOComponentEnum::UCHAR:
+            return WindowComponents( static_cast<const unsigned char *>( in ), out, n, window );
+          case itk::IOComponentEnum::SHORT:
+            return WindowComponents( static_cast<const short *>( in ), out, n, window );
+          case itk::IOComponentEnum::USHORT:
+            return WindowComponents( static_cast<const unsigned short *>( in ), out, n, window );
+          case itk::IOComponentEnum::INT:
+            return WindowComponents( static_cast<const int *>( in ), out, n, window );
+          case itk::IOComponentEnum::UINT:
+            return WindowComponents( static_cast<const unsigned int *>( in ), out, n, window );
+          case itk::IOComponentEnum::LONG:
+            return WindowComponents( static_cast<const long *>( in ), out, n, window );
+          case itk::IOComponentEnum::ULONG:
+            return WindowComponents( static_cast<const unsigned long *>( in ), out, n, window );
+          case itk::IOComponentEnum::LONGLONG:
+            return WindowComponents( static_cast<const long long *>( in ), out, n, window );
+          case itk::IOComponentEnum::ULONGLONG:
+            return WindowComponents( static_cast<const unsigned long long *>( in ), out, n, window );
+          case itk::IOComponentEnum::FLOAT:
+            return WindowComponents( static_cast<const float *>( in ), out, n, window );
+          case itk::IOComponentEnum::DOUBLE:
+            return WindowComponents( static_cast<const double *>( in ), out, n, window );
+          default:
+            sitkExceptionMacro( "Unsupported component type "
+                                << itk::ImageIOBase::GetComponentTypeAsString( componentType ) << "." );
+          }
+      }
   }
 
   Image ReadImage ( const std::string &filename,
@@ -75,6 +192,14 @@ namespace itk {
     }
 
 
+  struct ImageFileReader::OpenFile
+  {
+    itk::ImageIOBase::Pointer imageIO;
+
+    // the ITK reader with the internal image type of the last region read
+    itk::ProcessObject::Pointer reader;
+  };
+
   ImageFileReader::~ImageFileReader()
   = default;
 
@@ -100,6 +225,12 @@ namespace itk {
       this->ToStringHelper(out, this->m_FileName) << "\"" << std::endl;
       out << "  ExtractSize: " << this->m_ExtractSize << std::endl;
       out << "  ExtractIndex: " << this->m_ExtractIndex << std::endl;
+      out << "  Open: " << this->IsOpen() << std::endl;
+      out << "  IntensityWindow: " << this->m_IntensityWindow << std::endl;
+      out << "  LazyMetaDataLoading: " << this->m_LazyMetaDataLoading << std::endl;
+      out << "  UseDirectIO: " << this->m_UseDirectIO << std::endl;
+      out << "  SequentialReadAhead: " << this->m_SequentialReadAhead << std::endl;
+      out << "  MetaDataKeysToLoad: " << this->m_MetaDataKeysToLoad << std::endl;
 
       out << "  Image Information:" << std::endl
           << "    PixelType: ";
@@ -116,10 +247,29 @@ namespace itk {
     }
 
     ImageFileReader& ImageFileReader::SetFileName ( const std::string &fn ) {
+      if ( fn != this->m_FileName )
+        {
+        this->Close();
+        this->m_BufferFile.reset();
+        }
       this->m_FileName = fn;
       return *this;
     }
 
+    ImageFileReader& ImageFileReader::SetBuffer ( const void *buffer, size_t bufferSize, const std::string &imageIO ) {
+      if ( buffer == nullptr && bufferSize != 0 )
+        {
+        sitkExceptionMacro( "The buffer is null." );
+        }
+      const std::string extension = imageIO.empty() ? std::string() : ioutils::GetImageIOExtension( imageIO, false );
+      auto bufferFile = std::make_shared<ioutils::MemoryFile>( buffer, bufferSize, extension );
+
+      this->SetFileName( bufferFile->GetFileName() );
+      this->SetImageIO( imageIO );
+      this->m_BufferFile = bufferFile;
+      return *this;
+    }
+
     std::string ImageFileReader::GetFileName() const {
       return this->m_FileName;
     }
@@ -149,14 +299,23 @@ namespace itk {
         }
 
       // release functions bound to old meta data dictionary
-      if (m_MetaDataDictionary.get())
+      this->m_pfLoadMetaData = nullptr;
+      this->m_pfGetMetaDataKeys = nullptr;
+      this->m_pfHasMetaDataKey = nullptr;
+      this->m_pfGetMetaData =  nullptr;
+
+      this->m_MetaDataDictionary.reset(new MetaDataDictionary);
+
+      if (this->m_LazyMetaDataLoading)
         {
-        this->m_pfGetMetaDataKeys = nullptr;
-        this->m_pfHasMetaDataKey = nullptr;
-        this->m_pfGetMetaData =  nullptr;
+        // keep the ImageIO until the meta-data is needed
+        itk::ImageIOBase::ConstPointer io = iobase;
+        this->m_pfLoadMetaData = [this, io]() { this->SetMetaDataDictionary(io->GetMetaDataDictionary()); };
+        }
+      else
+        {
+        this->SetMetaDataDictionary(iobase->GetMetaDataDictionary());
         }
-
-      this->m_MetaDataDictionary.reset(new MetaDataDictionary(iobase->GetMetaDataDictionary()));
 
       m_PixelType = static_cast<PixelIDValueEnum>(pixelType);
 
@@ -169,9 +328,54 @@ namespace itk {
       swap(spacing, m_Spacing);
       swap(size, m_Size);
 
-      this->m_pfGetMetaDataKeys = std::bind(&MetaDataDictionary::GetKeys, this->m_MetaDataDictionary.get());
-      this->m_pfHasMetaDataKey = std::bind(&MetaDataDictionary::HasKey, this->m_MetaDataDictionary.get(), std::placeholders::_1);
-      this->m_pfGetMetaData = std::bind(&GetMetaDataDictionaryCustomCast::CustomCast, this->m_MetaDataDictionary.get(), std::placeholders::_1);
+      this->m_pfGetMetaDataKeys = [this]()
+        {
+          this->LoadDeferredMetaData();
+          return this->m_MetaDataDictionary->GetKeys();
+        };
+      this->m_pfHasMetaDataKey = [this](const std::string &key)
+        {
+          this->LoadDeferredMetaData();
+          return this->m_MetaDataDictionary->HasKey(key);
+        };
+      this->m_pfGetMetaData = [this](const std::string &key)
+        {
+          this->LoadDeferredMetaData();
+          return GetMetaDataDictionaryCustomCast::CustomCast(this->m_MetaDataDictionary.get(), key);
+        };
+    }
+
+    void
+    ImageFileReader
+    ::SetMetaDataDictionary(const MetaDataDictionary &dictionary)
+    {
+      this->m_MetaDataDictionary.reset(new MetaDataDictionary(dictionary));
+
+      if (this->m_MetaDataKeysToLoad.empty())
+        {
+        return;
+        }
+
+      const std::set<std::string> keysToLoad(this->m_MetaDataKeysToLoad.begin(), this->m_MetaDataKeysToLoad.end());
+      for (const auto &key : dictionary.GetKeys())
+        {
+        if (keysToLoad.count(key) == 0)
+          {
+          this->m_MetaDataDictionary->Erase(key);
+          }
+        }
+    }
+
+    void
+    ImageFileReader
+    ::LoadDeferredMetaData()
+    {
+      if (this->m_pfLoadMetaData)
+        {
+        std::function<void()> load;
+        std::swap(load, this->m_pfLoadMetaData);
+        load();
+        }
     }
 
     PixelIDValueEnum
@@ -234,8 +438,35 @@ namespace itk {
     ImageFileReader
     ::ReadImageInformation( )
     {
-      itk::ImageIOBase::Pointer imageio = this->GetImageIOBase( this->m_FileName );
+      const detail::TraceRange traceRange( *this, this->GetFileName() );
+      const bool deferPrivateTags = this->m_LazyMetaDataLoading && this->GetLoadPrivateTags();
+
+      itk::ImageIOBase::Pointer imageio;
+      if (deferPrivateTags)
+        {
+        // The private DICOM tags are not needed for the image information
+        this->SetLoadPrivateTags(false);
+        auto restorePrivateTags = make_scope_exit([this]() { this->SetLoadPrivateTags(true); });
+        imageio = this->GetMultiscaleImageIOBase();
+        }
+      else
+        {
+        imageio = this->GetMultiscaleImageIOBase();
+        }
       this->UpdateImageInformationFromImageIO(imageio);
+
+      if (deferPrivateTags && dynamic_cast<const itk::GDCMImageIO *>(imageio.GetPointer()))
+        {
+        // read the header again, with the private tags, on first use
+        const std::string fileName = imageio->GetFileName();
+        // keep the content of SetBuffer until the header is read again
+        std::shared_ptr<ioutils::MemoryFile> bufferFile = this->m_BufferFile;
+        this->m_pfLoadMetaData = [this, fileName, bufferFile]()
+          {
+            itk::ImageIOBase::Pointer fullImageIO = this->GetImageIOBase( fileName );
+            this->SetMetaDataDictionary(fullImageIO->GetMetaDataDictionary());
+          };
+        }
       sitkDebugMacro("ImageIO: " << imageio);
     }
 
@@ -261,6 +492,303 @@ namespace itk {
       return this->m_pfGetMetaData(key);
     }
 
+  unsigned int ImageFileReader::GetNumberOfMultiscaleLevels() const
+  {
+    unsigned int numberOfLevels = 1;
+    while ( itksys::SystemTools::FileExists( ioutils::GetMultiscaleLevelFileName( this->m_FileName, numberOfLevels ), true ) )
+      {
+      ++numberOfLevels;
+      }
+    return numberOfLevels;
+  }
+
+  itk::SmartPointer<ImageIOBase> ImageFileReader::GetMultiscaleImageIOBase()
+  {
+    const unsigned int level = this->GetMultiscaleLevel();
+    if ( level == 0 )
+      {
+      return this->GetImageIOBase( this->m_FileName );
+      }
+
+    // a level written by ImageFileWriter is a file of its own
+    const std::string levelFileName = ioutils::GetMultiscaleLevelFileName( this->m_FileName, level );
+    if ( itksys::SystemTools::FileExists( levelFileName, true ) )
+      {
+      return this->GetImageIOBase( levelFileName, 0 );
+      }
+
+    itk::ImageIOBase::Pointer imageio = this->GetImageIOBase( this->m_FileName );
+    if ( !IsMultiscaleImageIO( imageio ) )
+      {
+      sitkExceptionMacro( "The multiscale level " << level << " of \"" << this->m_FileName << "\" does not exist. The "
+                          << imageio->GetNameOfClass() << " does not read multiscale levels and there is no file \""
+                          << levelFileName << "\"." );
+      }
+    return imageio;
+  }
+
+  void ImageFileReader::Open()
+  {
+    this->Close();
+
+    itk::ImageIOBase::Pointer imageio = this->GetMultiscaleImageIOBase();
+    this->UpdateImageInformationFromImageIO(imageio);
+
+    this->m_OpenFile.reset( new OpenFile );
+    this->m_OpenFile->imageIO = imageio;
+  }
+
+  void ImageFileReader::Close()
+  {
+    this->m_OpenFile.reset();
+  }
+
+  bool ImageFileReader::IsOpen() const
+  {
+    return bool(this->m_OpenFile);
+  }
+
+  Image ImageFileReader::ReadRegion( const std::vector<int> &index, const std::vector<unsigned int> &size )
+  {
+    if ( !this->IsOpen() )
+      {
+      this->Open();
+      }
+
+    std::vector<unsigned int> extractSize = size;
+    if ( extractSize.empty() )
+      {
+      extractSize.assign( this->m_Size.begin(), this->m_Size.end() );
+      }
+    std::vector<int> extractIndex = index;
+
+    // use the extraction code path with the region, then restore the
+    // user's extraction settings
+    using std::swap;
+    swap( extractSize, this->m_ExtractSize );
+    swap( extractIndex, this->m_ExtractIndex );
+    auto restoreExtraction = make_scope_exit([this, &extractSize, &extractIndex]()
+      {
+        swap( extractSize, this->m_ExtractSize );
+        swap( extractIndex, this->m_ExtractIndex );
+      });
+
+    return this->ExecuteImageIO( this->m_OpenFile->imageIO.GetPointer() );
+  }
+
+  uint64_t ImageFileReader::GetNumberOfTiles( const std::vector<unsigned int> &tileSize ) const
+  {
+    if ( this->m_Size.empty() )
+      {
+      sitkExceptionMacro( "The image information has not been read." );
+      }
+
+    if ( tileSize.size() > this->m_Size.size() )
+      {
+      sitkExceptionMacro( "The tile size has " << tileSize.size()
+                          << " elements but the image dimension is " << this->m_Size.size() << "." );
+      }
+
+    uint64_t numberOfTiles = 1;
+    for ( unsigned int i = 0; i < tileSize.size(); ++i )
+      {
+      if ( tileSize[i] != 0 )
+        {
+        numberOfTiles *= ( this->m_Size[i] + tileSize[i] - 1 ) / tileSize[i];
+        }
+      }
+    return numberOfTiles;
+  }
+
+  Image ImageFileReader::ReadTile( const std::vector<unsigned int> &tileSize, uint64_t tileNumber )
+  {
+    if ( !this->IsOpen() )
+      {
+      this->Open();
+      }
+
+    if ( tileNumber >= this->GetNumberOfTiles( tileSize ) )
+      {
+      sitkExceptionMacro( "The tile number " << tileNumber << " is not less than the number of tiles "
+                          << this->GetNumberOfTiles( tileSize ) << "." );
+      }
+
+    std::vector<int> index( this->m_Size.size(), 0 );
+    std::vector<unsigned int> size( this->m_Size.begin(), this->m_Size.end() );
+    for ( unsigned int i = 0; i < tileSize.size(); ++i )
+      {
+      if ( tileSize[i] == 0 )
+        {
+        continue;
+        }
+      const uint64_t tilesAlongAxis = ( this->m_Size[i] + tileSize[i] - 1 ) / tileSize[i];
+      const uint64_t start = ( tileNumber % tilesAlongAxis ) * tileSize[i];
+      tileNumber /= tilesAlongAxis;
+
+      index[i] = static_cast<int>( start );
+      size[i] = static_cast<unsigned int>( std::min<uint64_t>( tileSize[i], this->m_Size[i] - start ) );
+      }
+
+    return this->ReadRegion( index, size );
+  }
+
+  void ImageFileReader::ReadInto( Image &destination, const std::vector<unsigned int> &index )
+  {
+    itk::ImageIOBase::Pointer imageio = this->GetMultiscaleImageIOBase();
+    this->UpdateImageInformationFromImageIO(imageio);
+
+    // the size of the image read, without the collapsed axes
+    std::vector<unsigned int> size;
+    if ( this->m_ExtractSize.empty() )
+      {
+      size.assign( this->m_Size.begin(), this->m_Size.end() );
+      }
+    else
+      {
+      std::copy_if( this->m_ExtractSize.begin(), this->m_ExtractSize.end(), std::back_inserter( size ),
+                    []( unsigned int s ) { return s != 0; } );
+      }
+
+    const unsigned int dimension = destination.GetDimension();
+    if ( size.size() > dimension || index.size() > dimension )
+      {
+      sitkExceptionMacro( "The image read of dimension " << size.size() << " and index of length " << index.size()
+                          << " do not fit the destination image of dimension " << dimension << "." );
+      }
+
+    if ( this->m_NumberOfComponents != destination.GetNumberOfComponentsPerPixel() )
+      {
+      sitkExceptionMacro( "The file has " << this->m_NumberOfComponents << " components per pixel but the destination image has "
+                          << destination.GetNumberOfComponentsPerPixel() << "." );
+      }
+
+    // the offset of the region in pixels, the region must be a
+    // contiguous part of the buffer
+    const std::vector<unsigned int> destinationSize = destination.GetSize();
+    uint64_t offset = 0;
+    uint64_t stride = 1;
+    bool     partial = false;
+    for ( unsigned int d = 0; d < dimension; ++d )
+      {
+      const uint64_t s = d < size.size() ? size[d] : 1u;
+      const uint64_t i = d < index.size() ? index[d] : 0u;
+      if ( i + s > destinationSize[d] )
+        {
+        sitkExceptionMacro( "The image read does not fit in the destination image at the index along axis " << d << "." );
+        }
+      if ( partial && s != 1 )
+        {
+        sitkExceptionMacro( "The region of the destination image is not contiguous in memory." );
+        }
+      partial = partial || s != destinationSize[d];
+      offset += i * stride;
+      stride *= destinationSize[d];
+      }
+
+    const uint64_t pixelSize = uint64_t( destination.GetNumberOfComponentsPerPixel() ) * destination.GetSizeOfPixelComponent();
+    char *buffer = static_cast<char *>( destination.GetBufferAsVoid() );
+
+    const PixelIDValueEnum outputPixelType = this->GetOutputPixelType();
+    this->SetOutputPixelType( destination.GetPixelID() );
+    this->m_ReadIntoBuffer = buffer + offset * pixelSize;
+    this->m_ReadIntoBufferSize = ( destination.GetNumberOfPixels() - offset ) * pixelSize;
+    auto restore = make_scope_exit([this, outputPixelType]()
+      {
+        this->SetOutputPixelType( outputPixelType );
+        this->m_ReadIntoBuffer = nullptr;
+        this->m_ReadIntoBufferSize = 0;
+      });
+
+    this->ExecuteImageIO( imageio.GetPointer() );
+  }
+
+  void ImageFileReader::ReadInto( void *buffer, uint64_t bufferSize )
+  {
+    if ( buffer == nullptr )
+      {
+      sitkExceptionMacro( "The buffer is null." );
+      }
+
+    itk::ImageIOBase::Pointer imageio = this->GetMultiscaleImageIOBase();
+    this->UpdateImageInformationFromImageIO(imageio);
+
+    this->m_ReadIntoBuffer = buffer;
+    this->m_ReadIntoBufferSize = bufferSize;
+    auto restore = make_scope_exit([this]()
+      {
+        this->m_ReadIntoBuffer = nullptr;
+        this->m_ReadIntoBufferSize = 0;
+      });
+
+    this->ExecuteImageIO( imageio.GetPointer() );
+  }
+
+  ImageFileReader &ImageFileReader::SetIntensityWindow( double windowMinimum, double windowMaximum,
+                                                        double outputMinimum, double outputMaximum )
+  {
+    if ( !( windowMinimum < windowMaximum ) )
+      {
+      sitkExceptionMacro( "The window minimum " << windowMinimum << " is not less than the window maximum "
+                          << windowMaximum << "." );
+      }
+    this->m_IntensityWindow = { windowMinimum, windowMaximum, outputMinimum, outputMaximum };
+    return *this;
+  }
+
+  std::vector<double> ImageFileReader::GetIntensityWindow( ) const
+  {
+    return this->m_IntensityWindow;
+  }
+
+  void ImageFileReader::RemoveIntensityWindow( )
+  {
+    this->m_IntensityWindow.clear();
+  }
+
+  ImageFileReader &ImageFileReader::SetLazyMetaDataLoading( bool lazy )
+  {
+    this->m_LazyMetaDataLoading = lazy;
+    return *this;
+  }
+
+  bool ImageFileReader::GetLazyMetaDataLoading( ) const
+  {
+    return this->m_LazyMetaDataLoading;
+  }
+
+  ImageFileReader &ImageFileReader::SetUseDirectIO( bool useDirectIO )
+  {
+    this->m_UseDirectIO = useDirectIO;
+    return *this;
+  }
+
+  bool ImageFileReader::GetUseDirectIO( ) const
+  {
+    return this->m_UseDirectIO;
+  }
+
+  ImageFileReader &ImageFileReader::SetSequentialReadAhead( bool sequentialReadAhead )
+  {
+    this->m_SequentialReadAhead = sequentialReadAhead;
+    return *this;
+  }
+
+  bool ImageFileReader::GetSequentialReadAhead( ) const
+  {
+    return this->m_SequentialReadAhead;
+  }
+
+  ImageFileReader &ImageFileReader::SetMetaDataKeysToLoad( const std::vector<std::string> &keys )
+  {
+    this->m_MetaDataKeysToLoad = keys;
+    return *this;
+  }
+
+  const std::vector<std::string> &ImageFileReader::GetMetaDataKeysToLoad( ) const
+  {
+    return this->m_MetaDataKeysToLoad;
+  }
+
   ImageFileReader &ImageFileReader::SetExtractSize( const std::vector<unsigned int> &size)
   {
     this->m_ExtractSize = size;
@@ -286,15 +814,19 @@ namespace itk {
 
     Image ImageFileReader::Execute ()
     {
+      const detail::TraceRange traceRange( *this, this->GetFileName() );
 
-      PixelIDValueType type = this->GetOutputPixelType();
-
-
-      itk::ImageIOBase::Pointer imageio = this->GetImageIOBase( this->m_FileName );
+      itk::ImageIOBase::Pointer imageio = this->GetMultiscaleImageIOBase();
       this->UpdateImageInformationFromImageIO(imageio);
 
       sitkDebugMacro( "ImageIO: " << imageio->GetNameOfClass() );
 
+      return this->ExecuteImageIO( imageio.GetPointer() );
+    }
+
+    Image ImageFileReader::ExecuteImageIO ( itk::ImageIOBase *imageio )
+    {
+      PixelIDValueType type = this->GetOutputPixelType();
 
       unsigned int dimension = this->GetDimension();
 
@@ -337,7 +869,7 @@ namespace itk {
                             << "Refusing to load! " << std::endl );
         }
 
-      return this->m_MemberFactory->GetMemberFunction( type, dimension )(imageio.GetPointer());
+      return this->m_MemberFactory->GetMemberFunction( type, dimension )(imageio);
     }
 
   template <class TImageType>
@@ -356,19 +888,76 @@ namespace itk {
     assert( ImageTypeToPixelIDValue<ImageType>::Result != (int)sitkUnknown );
     assert( imageio != nullptr );
 
+    if ( !this->m_IntensityWindow.empty() &&
+         ( !m_ExtractSize.empty() || ( this->m_OpenFile && this->m_OpenFile->imageIO.GetPointer() == imageio ) ) )
+      {
+      sitkExceptionMacro( "The intensity window is only supported when the whole image is read." );
+      }
+
+    if ( this->m_OpenFile && this->m_OpenFile->imageIO.GetPointer() == imageio )
+      {
+      // Reuse the reader of the open file. The reader is not modified,
+      // so its output information is only generated once, and a
+      // region already buffered is not read again.
+      auto *reader = dynamic_cast<InternalReader *>( this->m_OpenFile->reader.GetPointer() );
+      if ( reader == nullptr )
+        {
+        typename InternalReader::Pointer newReader = InternalReader::New();
+        newReader->SetImageIO( imageio );
+        newReader->SetFileName( imageio->GetFileName() );
+        this->m_OpenFile->reader = newReader;
+        reader = newReader.GetPointer();
+        }
+
+      // remove the observers added by PreUpdate, the reader outlives
+      // this execution
+      auto finishExecution = make_scope_exit([this, reader]()
+        {
+          reader->RemoveAllObservers();
+          reader->AbortGenerateDataOff();
+          this->OnActiveProcessDelete();
+        });
+
+      return this->ExecuteExtract<ImageType>( reader->GetOutput() );
+      }
+
 
     if ( m_ExtractSize.empty() || m_ExtractSize.size() == ImageType::ImageDimension)
       {
 
       typename Reader::Pointer reader = Reader::New();
       reader->SetImageIO( imageio );
-      reader->SetFileName( this->m_FileName.c_str() );
+      reader->SetFileName( imageio->GetFileName() );
+
+      if ( !this->m_IntensityWindow.empty() )
+        {
+        return this->ExecuteIntensityWindow<ImageType>( reader.GetPointer(), imageio );
+        }
 
       if ( m_ExtractSize.empty() )
         {
+        if ( this->m_UseDirectIO || this->m_SequentialReadAhead )
+          {
+          typename ImageType::Pointer output = this->ExecuteRawData<ImageType>( reader.GetPointer(), imageio );
+          if ( output )
+            {
+            return Image( output.GetPointer() );
+            }
+          }
+
+        if ( this->m_ReadIntoBuffer )
+          {
+          reader->UpdateOutputInformation();
+          ImportOutputBuffer( reader->GetOutput(), reader.GetPointer(), this->m_ReadIntoBuffer, this->m_ReadIntoBufferSize );
+          }
 
         this->PreUpdate( reader.GetPointer() );
         reader->Update();
+
+        if ( this->m_ReadIntoBuffer )
+          {
+          CopyOutputToBuffer( reader->GetOutput(), this->m_ReadIntoBuffer );
+          }
         return Image( reader->GetOutput() );
         }
 
@@ -382,12 +971,132 @@ namespace itk {
       // do streamed ImageIO
       typename InternalReader::Pointer reader = InternalReader::New();
       reader->SetImageIO( imageio );
-      reader->SetFileName( this->m_FileName.c_str() );
+      reader->SetFileName( imageio->GetFileName() );
 
       return this->ExecuteExtract<ImageType>(reader->GetOutput());
       }
   }
 
+  template <class TImageType, class TReader>
+  Image
+  ImageFileReader::ExecuteIntensityWindow( TReader *reader, itk::ImageIOBase *imageio )
+  {
+    using ImageType = TImageType;
+
+    if ( imageio->GetPixelType() == itk::IOPixelEnum::COMPLEX )
+      {
+      sitkExceptionMacro( "The intensity window is not supported for complex pixel types." );
+      }
+
+    reader->UpdateOutputInformation();
+    const ImageType *information = reader->GetOutput();
+
+    typename ImageType::Pointer output = ImageType::New();
+    output->CopyInformation( information );
+    output->SetMetaDataDictionary( information->GetMetaDataDictionary() );
+    output->SetNumberOfComponentsPerPixel( information->GetNumberOfComponentsPerPixel() );
+    output->SetRegions( information->GetLargestPossibleRegion() );
+
+    if ( output->GetNumberOfComponentsPerPixel() != imageio->GetNumberOfComponents() )
+      {
+      sitkExceptionMacro( "The intensity window requires the output pixel type to have the "
+                          << imageio->GetNumberOfComponents() << " components of the file." );
+      }
+
+    if ( this->m_ReadIntoBuffer )
+      {
+      output->SetPixelContainer( MakeImportContainer( output.GetPointer(), this->m_ReadIntoBuffer, this->m_ReadIntoBufferSize ) );
+      }
+    output->Allocate();
+
+    const size_t length = output->GetLargestPossibleRegion().GetNumberOfPixels() * output->GetNumberOfComponentsPerPixel();
+    if ( imageio->GetImageSizeInComponents() != length )
+      {
+      sitkExceptionMacro( "The size of the image in the file does not match the size of the output." );
+      }
+
+    this->PreUpdate( reader );
+    reader->InvokeEvent( itk::StartEvent() );
+
+    // decode the whole image at the component type of the ImageIO,
+    // then convert it with the window applied directly into the output
+    itk::ImageIORegion ioRegion( imageio->GetNumberOfDimensions() );
+    for ( unsigned int d = 0; d < imageio->GetNumberOfDimensions(); ++d )
+      {
+      ioRegion.SetIndex( d, 0 );
+      ioRegion.SetSize( d, imageio->GetDimensions( d ) );
+      }
+    imageio->SetIORegion( ioRegion );
+
+    std::unique_ptr<char[]> decoded( new char[ imageio->GetImageSizeInBytes() ] );
+    imageio->Read( decoded.get() );
+
+    WindowBuffer( imageio->GetComponentType(), decoded.get(), output->GetBufferPointer(), length, this->m_IntensityWindow );
+
+    reader->UpdateProgress( 1.0f );
+    reader->InvokeEvent( itk::EndEvent() );
+
+    return Image( output.GetPointer() );
+  }
+
+  template <class TImageType, class TReader>
+  typename TImageType::Pointer
+  ImageFileReader::ExecuteRawData( TReader *reader, itk::ImageIOBase *imageio )
+  {
+    using ImageType = TImageType;
+    using ComponentType = typename itk::NumericTraits<typename ImageType::PixelType>::ValueType;
+
+    reader->UpdateOutputInformation();
+    const ImageType *information = reader->GetOutput();
+
+    const uint64_t length = static_cast<uint64_t>( information->GetLargestPossibleRegion().GetNumberOfPixels() ) *
+      information->GetNumberOfComponentsPerPixel() * sizeof( ComponentType );
+
+    // The pixels of the file must be the pixels of the output, without
+    // conversion or byte swapping.
+    const bool swap = sizeof( ComponentType ) > 1 &&
+      imageio->GetByteOrder() == ( itk::ByteSwapper<uint16_t>::SystemIsBigEndian() ?
+                                   itk::IOByteOrderEnum::LittleEndian : itk::IOByteOrderEnum::BigEndian );
+
+    std::string dataFileName;
+    uint64_t offset = 0;
+    if ( imageio->GetComponentType() != itk::ImageIOBase::MapPixelType<ComponentType>::CType ||
+         imageio->GetNumberOfComponents() != information->GetNumberOfComponentsPerPixel() ||
+         imageio->GetImageSizeInBytes() != length ||
+         swap ||
+         !ioutils::FindRawData( imageio->GetFileName(), imageio->GetNameOfClass(), length, dataFileName, offset ) )
+      {
+      if ( this->m_SequentialReadAhead )
+        {
+        ioutils::AdviseSequentialRead( imageio->GetFileName() );
+        }
+      return nullptr;
+      }
+
+    typename ImageType::Pointer output = ImageType::New();
+    output->CopyInformation( information );
+    output->SetMetaDataDictionary( information->GetMetaDataDictionary() );
+    output->SetNumberOfComponentsPerPixel( information->GetNumberOfComponentsPerPixel() );
+    output->SetRegions( information->GetLargestPossibleRegion() );
+    if ( this->m_ReadIntoBuffer )
+      {
+      output->SetPixelContainer( MakeImportContainer( output.GetPointer(), this->m_ReadIntoBuffer, this->m_ReadIntoBufferSize ) );
+      }
+    output->Allocate();
+
+    this->PreUpdate( reader );
+    reader->InvokeEvent( itk::StartEvent() );
+
+    ioutils::ReadFileData( dataFileName, offset, length, output->GetBufferPointer(),
+                           this->m_UseDirectIO, this->m_SequentialReadAhead );
+
+    reader->UpdateProgress( 1.0f );
+    reader->InvokeEvent( itk::EndEvent() );
+
+    FixNonZeroIndex( output.GetPointer() );
+    return output;
+  }
+
   template <class TImageType, class TInternalImageType>
   Image
   ImageFileReader::ExecuteExtract( TInternalImageType * itkImage )
@@ -398,7 +1107,9 @@ namespace itk {
     using ExtractType = itk::ExtractImageFilter<InternalImageType, ImageType>;
     typename ExtractType::Pointer extractor = ExtractType::New();
 
-    extractor->InPlaceOn();
+    // the buffer of an open file's reader is kept for later regions
+    const bool isOpenReader = this->m_OpenFile && this->m_OpenFile->reader.GetPointer() == itkImage->GetSource().GetPointer();
+    extractor->SetInPlace( !isOpenReader && this->m_ReadIntoBuffer == nullptr );
     extractor->SetDirectionCollapseToSubmatrix();
 
     extractor->SetInput(itkImage);
@@ -445,12 +1156,22 @@ namespace itk {
                           << itkImage->GetLargestPossibleRegion() );
       }
 
+    if ( this->m_ReadIntoBuffer )
+      {
+      extractor->UpdateOutputInformation();
+      ImportOutputBuffer( extractor->GetOutput(), extractor.GetPointer(), this->m_ReadIntoBuffer, this->m_ReadIntoBufferSize );
+      }
+
     assert(itkImage->GetSource() != nullptr);
     this->PreUpdate( itkImage->GetSource().GetPointer() );
 
     extractor->Update();
 
     ImageType *itkOutImage = extractor->GetOutput();
+    if ( this->m_ReadIntoBuffer )
+      {
+      CopyOutputToBuffer( itkOutImage, this->m_ReadIntoBuffer );
+      }
     // copy meta-data dictionary
     itkOutImage->SetMetaDataDictionary( itkImage->GetMetaDataDictionary() );
     FixNonZeroIndex( itkOutImage );
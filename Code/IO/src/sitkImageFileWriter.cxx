@@ -18,15 +18,232 @@
 
 #include "sitkImageFileWriter.h"
 #include "sitkImageIOUtilities.h"
+#include "sitkTemplateFunctions.h"
+#include "sitkTraceRange.h"
 
 #include <itkImageIOBase.h>
 #include <itkImageFileWriter.h>
+#include <itkBinShrinkImageFilter.h>
 #include <itkImageRegionIterator.h>
 #include <itkGDCMImageIO.h>
+#include <itkImageSource.h>
+#include <itkByteSwapper.h>
+#include <itkMetaDataObject.h>
+#include <itkNumericTraits.h>
+#include <itksys/SystemTools.hxx>
+
+#include <fstream>
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <type_traits>
 
 namespace itk {
 namespace simple {
 
+namespace
+{
+
+// An image source whose output has the largest possible region of the
+// whole file, and buffers only one region to be pasted into the file.
+template <class TImageType>
+class PasteRegionSource
+  : public itk::ImageSource<TImageType>
+{
+public:
+  using Self = PasteRegionSource;
+  using Superclass = itk::ImageSource<TImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using RegionType = typename TImageType::RegionType;
+  using PointType = typename TImageType::PointType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PasteRegionSource, ImageSource);
+
+  void SetRegionImage( const TImageType *image, const RegionType &region, const RegionType &largestRegion, const PointType &origin )
+    {
+      m_RegionImage = image;
+      m_Region = region;
+      m_LargestRegion = largestRegion;
+      m_Origin = origin;
+      this->Modified();
+    }
+
+protected:
+  PasteRegionSource() = default;
+
+  void GenerateOutputInformation() override
+    {
+      TImageType *output = this->GetOutput();
+      output->SetLargestPossibleRegion( m_LargestRegion );
+      output->SetSpacing( m_RegionImage->GetSpacing() );
+      output->SetDirection( m_RegionImage->GetDirection() );
+      output->SetOrigin( m_Origin );
+      output->SetNumberOfComponentsPerPixel( m_RegionImage->GetNumberOfComponentsPerPixel() );
+    }
+
+  void GenerateData() override
+    {
+      // share the buffer of the region's image
+      TImageType *output = this->GetOutput();
+      output->SetBufferedRegion( m_Region );
+      output->SetPixelContainer( const_cast<typename TImageType::PixelContainer *>( m_RegionImage->GetPixelContainer() ) );
+      output->SetMetaDataDictionary( m_RegionImage->GetMetaDataDictionary() );
+    }
+
+private:
+  typename TImageType::ConstPointer m_RegionImage;
+  RegionType m_Region;
+  RegionType m_LargestRegion;
+  PointType  m_Origin;
+};
+
+template <typename TComponent>
+std::string MetaImageElementType()
+{
+  if ( std::is_floating_point<TComponent>::value )
+    {
+    return sizeof(TComponent) == 4 ? "MET_FLOAT" : "MET_DOUBLE";
+    }
+  const std::string prefix = std::is_signed<TComponent>::value ? "MET_" : "MET_U";
+  switch ( sizeof(TComponent) )
+    {
+    case 1:
+      return prefix + "CHAR";
+    case 2:
+      return prefix + "SHORT";
+    case 4:
+      return prefix + "INT";
+    default:
+      return prefix + "LONG_LONG";
+    }
+}
+
+// Write a MetaImage with the data compressed as a zlib stream by
+// several threads. Returns false, without writing, when the image
+// has meta-data which can not be written as a MetaImage header field.
+template <class TImageType>
+bool WriteParallelCompressedMetaImage( const TImageType *image,
+                                       const std::string &fileName,
+                                       int compressionLevel,
+                                       unsigned int numberOfThreads,
+                                       unsigned int numberOfBlocks )
+{
+  using ComponentType = typename itk::NumericTraits<typename TImageType::PixelType>::ValueType;
+  constexpr unsigned int dimension = TImageType::ImageDimension;
+
+  const itk::MetaDataDictionary &dictionary = image->GetMetaDataDictionary();
+  std::ostringstream fields;
+  for ( const auto &key : dictionary.GetKeys() )
+    {
+    std::string value;
+    if ( key.empty()
+         || key.find_first_of( "= \t\r\n" ) != std::string::npos
+         || !itk::ExposeMetaData<std::string>( dictionary, key, value )
+         || value.find_first_of( "\r\n" ) != std::string::npos )
+      {
+      return false;
+      }
+    fields << key << " = " << value << "\n";
+    }
+
+  const std::string extension = itksys::SystemTools::LowerCase( itksys::SystemTools::GetFilenameLastExtension( fileName ) );
+  const bool local = ( extension == ".mha" );
+  const std::string dataFileName = itksys::SystemTools::GetFilenameWithoutLastExtension( fileName ) + ".zraw";
+
+  const size_t length = image->GetBufferedRegion().GetNumberOfPixels()
+    * image->GetNumberOfComponentsPerPixel() * sizeof(ComponentType);
+  const std::string data = ioutils::ParallelDeflate( image->GetBufferPointer(), length, compressionLevel,
+                                                     numberOfThreads, numberOfBlocks );
+
+  std::ostringstream header;
+  header << std::setprecision(17);
+  header << "ObjectType = Image\n";
+  header << "NDims = " << dimension << "\n";
+  header << "BinaryData = True\n";
+  header << "BinaryDataByteOrderMSB = " << ( itk::ByteSwapper<int>::SystemIsBigEndian() ? "True" : "False" ) << "\n";
+  header << "CompressedData = True\n";
+  header << "CompressedDataSize = " << data.size() << "\n";
+  header << "TransformMatrix =";
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    for ( unsigned int j = 0; j < dimension; ++j )
+      {
+      // each row is the direction of an axis
+      header << " " << image->GetDirection()[j][i];
+      }
+    }
+  header << "\nOffset =";
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    header << " " << image->GetOrigin()[i];
+    }
+  header << "\nCenterOfRotation =";
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    header << " 0";
+    }
+  header << "\nElementSpacing =";
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    header << " " << image->GetSpacing()[i];
+    }
+  header << "\nDimSize =";
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    header << " " << image->GetBufferedRegion().GetSize(i);
+    }
+  header << "\n";
+  if ( image->GetNumberOfComponentsPerPixel() > 1 )
+    {
+    header << "ElementNumberOfChannels = " << image->GetNumberOfComponentsPerPixel() << "\n";
+    }
+  header << "ElementType = " << MetaImageElementType<ComponentType>() << "\n";
+  header << fields.str();
+  header << "ElementDataFile = " << ( local ? std::string("LOCAL") : dataFileName ) << "\n";
+
+  std::ofstream out( fileName.c_str(), std::ios::out | std::ios::binary );
+  if ( !out )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for writing." );
+    }
+  out << header.str();
+
+  if ( !local )
+    {
+    out.close();
+    const std::string path = itksys::SystemTools::GetFilenamePath( fileName );
+    const std::string dataPath = path.empty() ? dataFileName : path + "/" + dataFileName;
+    out.open( dataPath.c_str(), std::ios::out | std::ios::binary );
+    if ( !out )
+      {
+      sitkExceptionMacro( "Unable to open \"" << dataPath << "\" for writing." );
+      }
+    }
+  out.write( data.data(), static_cast<std::streamsize>( data.size() ) );
+  if ( !out )
+    {
+    sitkExceptionMacro( "Error writing \"" << fileName << "\"." );
+    }
+  return true;
+}
+
+}
+
+struct ImageFileWriter::OpenFile
+{
+  std::string               fileName;
+  std::vector<unsigned int> size;
+
+  std::mutex                mutex;
+  bool                      created{false};
+
+  // set by the first region written
+  PixelIDValueType          pixelID{sitkUnknown};
+  std::vector<double>       origin;
+  std::function<void(const Image &, const std::vector<unsigned int> &)> writeRegion;
+};
+
 void WriteImage ( const Image& image, const std::string &inFileName, bool useCompression, int compressionLevel )
 {
   ImageFileWriter writer;
@@ -46,6 +263,10 @@ ImageFileWriter::ImageFileWriter()
 
   this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 1, SITK_MAX_DIMENSION > ();
 
+  this->m_WriteRegionMemberFactory.reset( new detail::MemberFunctionFactory<WriteRegionMemberFunctionType>( this ) );
+
+  this->m_WriteRegionMemberFactory->RegisterMemberFunctions< PixelIDTypeList, 1, SITK_MAX_DIMENSION, WriteRegionAddressor<WriteRegionMemberFunctionType> > ();
+
 }
 
 
@@ -77,6 +298,10 @@ std::string ImageFileWriter::ToString() const
   out << "  ImageIOName: ";
   this->ToStringHelper(out, this->m_ImageIOName) << std::endl;
 
+  out << "  NumberOfMultiscaleLevels: " << this->m_NumberOfMultiscaleLevels << std::endl;
+
+  out << "  Open: " << this->IsOpen() << std::endl;
+
   out << "  Registered ImageIO:" << std::endl;
   ioutils::PrintRegisteredImageIOs(out);
   out << "\"" << std::endl;
@@ -142,6 +367,17 @@ bool ImageFileWriter::GetKeepOriginalImageUID( ) const
   return this->m_KeepOriginalImageUID;
 }
 
+ImageFileWriter& ImageFileWriter::SetNumberOfMultiscaleLevels ( unsigned int n )
+{
+  this->m_NumberOfMultiscaleLevels = std::max( n, 1u );
+  return *this;
+}
+
+unsigned int ImageFileWriter::GetNumberOfMultiscaleLevels() const
+{
+  return this->m_NumberOfMultiscaleLevels;
+}
+
 ImageFileWriter& ImageFileWriter::SetFileName ( const std::string &fn )
 {
   this->m_FileName = fn;
@@ -165,11 +401,138 @@ ImageFileWriter& ImageFileWriter::Execute ( const Image& image )
 {
   PixelIDValueType type = image.GetPixelIDValue();
   unsigned int dimension = image.GetDimension();
+  const detail::TraceRange traceRange( *this, this->GetFileName() );
 
   return this->m_MemberFactory->GetMemberFunction( type, dimension )( image );
 }
 
 
+std::vector<uint8_t> ImageFileWriter::ExecuteToBuffer ( const Image& image, const std::string &imageIO )
+{
+  if ( imageIO.empty() )
+    {
+    sitkExceptionMacro( "The ImageIO to encode the image is not set." );
+    }
+
+  ioutils::MemoryFile bufferFile( ioutils::GetImageIOExtension( imageIO, true ) );
+
+  std::string fileName = bufferFile.GetFileName();
+  std::string imageIOName = imageIO;
+  unsigned int numberOfMultiscaleLevels = 1;
+  using std::swap;
+  swap( fileName, this->m_FileName );
+  swap( imageIOName, this->m_ImageIOName );
+  swap( numberOfMultiscaleLevels, this->m_NumberOfMultiscaleLevels );
+  auto restore = make_scope_exit([&]()
+    {
+      swap( fileName, this->m_FileName );
+      swap( imageIOName, this->m_ImageIOName );
+      swap( numberOfMultiscaleLevels, this->m_NumberOfMultiscaleLevels );
+    });
+
+  this->Execute( image );
+  return bufferFile.Read();
+}
+
+
+void ImageFileWriter::Open( const std::vector<unsigned int> &size )
+{
+  if (this->m_FileName.empty())
+    {
+    sitkExceptionMacro( "The FileName is not set." );
+    }
+  if (size.empty() || size.size() > SITK_MAX_DIMENSION)
+    {
+    sitkExceptionMacro( "The image size has an unsupported dimension of " << size.size() << "." );
+    }
+
+  this->Close();
+
+  // the file is created by the first region
+  if ( itksys::SystemTools::FileExists( this->m_FileName ) )
+    {
+    itksys::SystemTools::RemoveFile( this->m_FileName );
+    }
+
+  std::shared_ptr<OpenFile> openFile = std::make_shared<OpenFile>();
+  openFile->fileName = this->m_FileName;
+  openFile->size = size;
+  this->m_OpenFile = openFile;
+}
+
+
+void ImageFileWriter::WriteRegion( const Image &region, const std::vector<unsigned int> &index )
+{
+  std::shared_ptr<OpenFile> openFile = this->m_OpenFile;
+  if ( !openFile )
+    {
+    sitkExceptionMacro( "The writer is not open." );
+    }
+
+  const unsigned int dimension = openFile->size.size();
+  if ( region.GetDimension() != dimension || index.size() != dimension )
+    {
+    sitkExceptionMacro( "The region and index must have the dimension of the image, " << dimension << "." );
+    }
+
+  const std::vector<unsigned int> regionSize = region.GetSize();
+  for ( unsigned int i = 0; i < dimension; ++i )
+    {
+    if ( uint64_t(index[i]) + regionSize[i] > openFile->size[i] )
+      {
+      sitkExceptionMacro( "The region at " << index << " of size " << regionSize
+                          << " is not inside the image size " << openFile->size << "." );
+      }
+    }
+
+  {
+  std::lock_guard<std::mutex> lock( openFile->mutex );
+  if ( !openFile->created )
+    {
+    // origin at index zero: origin - direction * spacing * index
+    const std::vector<double> &spacing = region.GetSpacing();
+    const std::vector<double> &direction = region.GetDirection();
+    openFile->origin = region.GetOrigin();
+    for ( unsigned int r = 0; r < dimension; ++r )
+      {
+      for ( unsigned int c = 0; c < dimension; ++c )
+        {
+        openFile->origin[r] -= direction[r*dimension+c] * spacing[c] * index[c];
+        }
+      }
+
+    openFile->pixelID = region.GetPixelIDValue();
+    openFile->writeRegion = this->m_WriteRegionMemberFactory->GetMemberFunction( region.GetPixelIDValue(), dimension );
+
+    // the first region creates the file and header
+    openFile->writeRegion( region, index );
+    openFile->created = true;
+    return;
+    }
+  }
+
+  if ( region.GetPixelIDValue() != openFile->pixelID )
+    {
+    sitkExceptionMacro( "The region's pixel type " << region.GetPixelIDTypeAsString()
+                        << " differs from the file's pixel type " << GetPixelIDValueAsString( openFile->pixelID ) << "." );
+    }
+
+  openFile->writeRegion( region, index );
+}
+
+
+void ImageFileWriter::Close()
+{
+  this->m_OpenFile.reset();
+}
+
+
+bool ImageFileWriter::IsOpen() const
+{
+  return bool(this->m_OpenFile);
+}
+
+
 ImageFileWriter::Self&
 ImageFileWriter
 ::SetImageIO(const std::string &imageio)
@@ -238,14 +601,145 @@ ImageFileWriter& ImageFileWriter::ExecuteInternal( const Image& inImage )
 
   sitkDebugMacro( "ImageIO: " << imageio->GetNameOfClass() );
 
+  // MetaImage's zlib compression is done on one thread by ITK, the
+  // blocks of the data are compressed by several threads here.
+  const std::string extension = itksys::SystemTools::LowerCase( itksys::SystemTools::GetFilenameLastExtension( this->m_FileName ) );
+  if ( this->m_UseCompression
+       && this->GetNumberOfThreads() > 1
+       && ( this->m_Compressor.empty() || itksys::SystemTools::UpperCase( this->m_Compressor ) == "ZLIB" )
+       && std::string( imageio->GetNameOfClass() ) == "MetaImageIO"
+       && ( extension == ".mha" || extension == ".mhd" ) )
+    {
+    const unsigned int numberOfBlocks = this->GetNumberOfWorkUnits() ? this->GetNumberOfWorkUnits() : this->GetNumberOfThreads();
+    if ( WriteParallelCompressedMetaImage( image.GetPointer(), this->m_FileName, this->m_CompressionLevel,
+                                           this->GetNumberOfThreads(), numberOfBlocks ) )
+      {
+      this->WriteMultiscaleLevels( image.GetPointer() );
+      return *this;
+      }
+    }
+
   writer->SetImageIO( imageio );
 
   this->PreUpdate( writer.GetPointer() );
 
   writer->Update();
 
+  this->WriteMultiscaleLevels( image.GetPointer() );
+
   return *this;
 }
 
+
+template <class TImageType>
+void ImageFileWriter::WriteMultiscaleLevels( const TImageType *image )
+{
+  using ShrinkType = itk::BinShrinkImageFilter<TImageType, TImageType>;
+  using Writer = itk::ImageFileWriter<TImageType>;
+
+  typename TImageType::ConstPointer input = image;
+  unsigned int level = 1;
+  for ( ; level < this->m_NumberOfMultiscaleLevels; ++level )
+    {
+    typename ShrinkType::ShrinkFactorsType factors;
+    bool shrinks = false;
+    for ( unsigned int d = 0; d < TImageType::ImageDimension; ++d )
+      {
+      factors[d] = input->GetLargestPossibleRegion().GetSize( d ) > 1 ? 2 : 1;
+      shrinks = shrinks || factors[d] > 1;
+      }
+    if ( !shrinks )
+      {
+      break;
+      }
+
+    // each level is shrunk from the previous one
+    typename ShrinkType::Pointer shrink = ShrinkType::New();
+    shrink->SetInput( input );
+    shrink->SetShrinkFactors( factors );
+    shrink->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() ? this->GetNumberOfWorkUnits() : shrink->GetNumberOfWorkUnits() );
+    shrink->GetMultiThreader()->SetMaximumNumberOfThreads( this->GetNumberOfThreads() );
+    shrink->Update();
+
+    typename TImageType::Pointer output = shrink->GetOutput();
+    output->DisconnectPipeline();
+    output->SetMetaDataDictionary( image->GetMetaDataDictionary() );
+    input = output;
+
+    const std::string levelFileName = ioutils::GetMultiscaleLevelFileName( this->m_FileName, level );
+
+    typename Writer::Pointer writer = Writer::New();
+    writer->SetUseCompression( this->m_UseCompression );
+    writer->SetCompressionLevel( this->m_CompressionLevel );
+    writer->SetFileName( levelFileName );
+    writer->SetInput( input );
+
+    itk::ImageIOBase::Pointer imageio = this->GetImageIOBase( levelFileName );
+    if (!this->m_Compressor.empty())
+      {
+      imageio->SetCompressor(this->m_Compressor);
+      }
+    writer->SetImageIO( imageio );
+    writer->Update();
+    }
+
+  // remove the levels of a previous write which are no longer valid
+  for ( ; ; ++level )
+    {
+    const std::string levelFileName = ioutils::GetMultiscaleLevelFileName( this->m_FileName, level );
+    if ( !itksys::SystemTools::FileExists( levelFileName, true ) )
+      {
+      break;
+      }
+    itksys::SystemTools::RemoveFile( levelFileName );
+    }
+}
+
+
+template <class InputImageType>
+void ImageFileWriter::WriteRegionInternal( const Image& inImage, const std::vector<unsigned int> &index )
+{
+  const InputImageType *image = dynamic_cast <const InputImageType*> ( inImage.GetITKBase() );
+
+  // The open file is held by WriteRegion
+  const OpenFile &openFile = *this->m_OpenFile;
+
+  typename InputImageType::RegionType largestRegion;
+  typename InputImageType::RegionType region = image->GetBufferedRegion();
+  typename InputImageType::PointType origin;
+  itk::ImageIORegion ioRegion( InputImageType::ImageDimension );
+  for ( unsigned int i = 0; i < InputImageType::ImageDimension; ++i )
+    {
+    largestRegion.SetSize( i, openFile.size[i] );
+    region.SetIndex( i, index[i] );
+    origin[i] = openFile.origin[i];
+    ioRegion.SetIndex( i, index[i] );
+    ioRegion.SetSize( i, region.GetSize( i ) );
+    }
+
+  using SourceType = PasteRegionSource<InputImageType>;
+  typename SourceType::Pointer source = SourceType::New();
+  source->SetRegionImage( image, region, largestRegion, origin );
+
+  using Writer = itk::ImageFileWriter<InputImageType>;
+  typename Writer::Pointer writer = Writer::New();
+  writer->SetUseCompression( this->m_UseCompression );
+  writer->SetCompressionLevel( this->m_CompressionLevel );
+  writer->SetFileName ( openFile.fileName.c_str() );
+  writer->SetInput ( source->GetOutput() );
+  writer->SetIORegion( ioRegion );
+
+  itk::ImageIOBase::Pointer imageio = this->GetImageIOBase( openFile.fileName );
+
+  if (!this->m_Compressor.empty())
+  {
+  imageio->SetCompressor(this->m_Compressor);
+  }
+
+  writer->SetImageIO( imageio );
+
+  writer->Update();
+}
+
 } // end namespace simple
 } // end namespace itk
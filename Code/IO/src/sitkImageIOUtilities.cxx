@@ -19,8 +19,23 @@
 #include "sitkMacro.h"
 #include "sitkExceptionObject.h"
 #include "itkImageIOBase.h"
+#include "itkImageIOFactory.h"
+#include "itk_zlib.h"
+#include <itksys/SystemTools.hxx>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <random>
 #include <sstream>
 #include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace itk {
 namespace simple {
@@ -97,6 +112,421 @@ itk::SmartPointer<ImageIOBase> CreateImageIOByName(const std::string & ioname)
   return iobase;
 }
 
+
+namespace
+{
+
+struct ImageIOPrototype
+{
+  itk::ImageIOBase::ConstPointer prototype;
+  std::vector<std::string>       extensions;
+};
+
+struct ImageIOProbeCacheEntry
+{
+  unsigned long length;
+  long          modifiedTime;
+  std::string   imageIOName;
+};
+
+// The registered ImageIOs and the results of probing files for an
+// ImageIO, shared by all readers in the process.
+struct ImageIOProbeCache
+{
+  std::mutex                                              mutex;
+  size_t                                                  numberOfFactories{0};
+  std::vector<ImageIOPrototype>                           prototypes;
+  std::unordered_map<std::string, ImageIOProbeCacheEntry> entries;
+
+  static constexpr size_t MaximumNumberOfEntries = 1024;
+
+  // must be called with the mutex held
+  void UpdatePrototypes()
+  {
+    const size_t numberOfFactories = itk::ObjectFactoryBase::GetRegisteredFactories().size();
+    if ( !prototypes.empty() && numberOfFactories == this->numberOfFactories )
+      {
+      return;
+      }
+
+    // the registered ImageIOs changed, the probed results may be stale
+    this->numberOfFactories = numberOfFactories;
+    prototypes.clear();
+    entries.clear();
+
+    for ( const auto &object : itk::ObjectFactoryBase::CreateAllInstance("itkImageIOBase") )
+      {
+      const auto *io = dynamic_cast<const itk::ImageIOBase*>( object.GetPointer() );
+      if ( io )
+        {
+        ImageIOPrototype p;
+        p.prototype = io;
+        for ( std::string extension : io->GetSupportedReadExtensions() )
+          {
+          std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+          p.extensions.push_back( extension );
+          }
+        prototypes.push_back( p );
+        }
+      }
+  }
+};
+
+ImageIOProbeCache &GetImageIOProbeCache()
+{
+  static ImageIOProbeCache cache;
+  return cache;
+}
+
+itk::ImageIOBase::Pointer CreateFromPrototype( const itk::ImageIOBase *prototype )
+{
+  itk::LightObject::Pointer another = prototype->CreateAnother();
+  return dynamic_cast<itk::ImageIOBase*>( another.GetPointer() );
+}
+
+}
+
+
+itk::SmartPointer<ImageIOBase> CreateImageIOForReading(const std::string & fileName)
+{
+  // Only regular files have a signature to cache, directories and
+  // missing files take ITK's path.
+  if ( !itksys::SystemTools::FileExists( fileName, true ) )
+    {
+    return itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::IOFileModeEnum::ReadMode );
+    }
+
+  const std::string key = itksys::SystemTools::CollapseFullPath( fileName );
+  const unsigned long length = itksys::SystemTools::FileLength( fileName );
+  const long modifiedTime = itksys::SystemTools::ModifiedTime( fileName );
+
+  std::string lowerFileName = fileName;
+  std::transform( lowerFileName.begin(), lowerFileName.end(), lowerFileName.begin(), ::tolower );
+
+  ImageIOProbeCache &cache = GetImageIOProbeCache();
+
+  itk::ImageIOBase::ConstPointer cached;
+  std::vector<std::pair<size_t, itk::ImageIOBase::ConstPointer>> candidates;
+  {
+  std::lock_guard<std::mutex> lock( cache.mutex );
+  cache.UpdatePrototypes();
+
+  auto entry = cache.entries.find( key );
+  if ( entry != cache.entries.end() )
+    {
+    if ( entry->second.length == length && entry->second.modifiedTime == modifiedTime )
+      {
+      for ( const auto &p : cache.prototypes )
+        {
+        if ( entry->second.imageIOName == p.prototype->GetNameOfClass() )
+          {
+          cached = p.prototype;
+          break;
+          }
+        }
+      }
+    cache.entries.erase( entry );
+    }
+
+  // the ImageIOs which list the file's extension, the longest
+  // matching extension first
+  for ( const auto &p : cache.prototypes )
+    {
+    size_t matchLength = 0;
+    for ( const auto &extension : p.extensions )
+      {
+      if ( extension.size() > matchLength && extension.size() < lowerFileName.size()
+           && lowerFileName.compare( lowerFileName.size() - extension.size(), extension.size(), extension ) == 0 )
+        {
+        matchLength = extension.size();
+        }
+      }
+    if ( matchLength )
+      {
+      candidates.emplace_back( matchLength, p.prototype );
+      }
+    }
+  }
+  std::stable_sort( candidates.begin(), candidates.end(),
+                    []( const std::pair<size_t, itk::ImageIOBase::ConstPointer> &a,
+                        const std::pair<size_t, itk::ImageIOBase::ConstPointer> &b ) { return a.first > b.first; } );
+
+  // Probe outside of the lock, the cached ImageIO is checked again in
+  // case the file was replaced by one with the same signature.
+  itk::ImageIOBase::Pointer iobase;
+  if ( cached )
+    {
+    iobase = CreateFromPrototype( cached );
+    if ( iobase && !iobase->CanReadFile( fileName.c_str() ) )
+      {
+      iobase = nullptr;
+      }
+    }
+
+  for ( auto c = candidates.begin(); !iobase && c != candidates.end(); ++c )
+    {
+    if ( c->second == cached )
+      {
+      continue;
+      }
+    iobase = CreateFromPrototype( c->second );
+    if ( iobase && !iobase->CanReadFile( fileName.c_str() ) )
+      {
+      iobase = nullptr;
+      }
+    }
+
+  if ( !iobase )
+    {
+    iobase = itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::IOFileModeEnum::ReadMode );
+    }
+
+  if ( iobase )
+    {
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    if ( cache.entries.size() >= ImageIOProbeCache::MaximumNumberOfEntries )
+      {
+      cache.entries.clear();
+      }
+    cache.entries[key] = ImageIOProbeCacheEntry{ length, modifiedTime, iobase->GetNameOfClass() };
+    }
+
+  return iobase;
+}
+
+
+std::string ParallelDeflate(const void *buffer,
+                            size_t length,
+                            int compressionLevel,
+                            unsigned int numberOfThreads,
+                            unsigned int numberOfBlocks)
+{
+  if ( compressionLevel < 0 || compressionLevel > 9 )
+    {
+    compressionLevel = Z_DEFAULT_COMPRESSION;
+    }
+
+  // small blocks lose compression ratio, and each block is limited
+  // to the uInt range of the z_stream
+  constexpr size_t minimumBlockSize = 128*1024;
+  constexpr size_t maximumBlockSize = 1024*1024*1024;
+  size_t blockSize = ( length + std::max( 1u, numberOfBlocks ) - 1 ) / std::max( 1u, numberOfBlocks );
+  blockSize = std::min( std::max( blockSize, minimumBlockSize ), maximumBlockSize );
+  const size_t blocks = std::max<size_t>( 1, ( length + blockSize - 1 ) / blockSize );
+
+  const auto *data = static_cast<const Bytef *>( buffer );
+  std::vector<std::string> compressed( blocks );
+  std::vector<uLong> checksums( blocks );
+  std::vector<std::string> errors( blocks );
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]()
+    {
+      size_t b;
+      while ( ( b = next++ ) < blocks )
+        {
+        const size_t offset = b * blockSize;
+        const size_t blockLength = std::min( blockSize, length - std::min( length, offset ) );
+        const bool last = ( b + 1 == blocks );
+
+        checksums[b] = adler32( adler32( 0L, Z_NULL, 0 ), data + offset, static_cast<uInt>( blockLength ) );
+
+        z_stream strm{};
+        // a raw deflate stream, the zlib header and trailer are added below
+        if ( deflateInit2( &strm, compressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+          {
+          errors[b] = "deflateInit2 failed";
+          continue;
+          }
+
+        std::string &out = compressed[b];
+        // room for the sync flush marker
+        out.resize( deflateBound( &strm, static_cast<uLong>( blockLength ) ) + 16 );
+
+        strm.next_in = const_cast<Bytef *>( data + offset );
+        strm.avail_in = static_cast<uInt>( blockLength );
+        strm.next_out = reinterpret_cast<Bytef *>( &out[0] );
+        strm.avail_out = static_cast<uInt>( out.size() );
+
+        const int ret = deflate( &strm, last ? Z_FINISH : Z_SYNC_FLUSH );
+        if ( ( last && ret != Z_STREAM_END ) || ( !last && ( ret != Z_OK || strm.avail_in != 0 ) ) )
+          {
+          errors[b] = strm.msg ? strm.msg : "deflate failed";
+          }
+        out.resize( out.size() - strm.avail_out );
+        deflateEnd( &strm );
+        }
+    };
+
+  const unsigned int threads = static_cast<unsigned int>( std::min<size_t>( std::max( 1u, numberOfThreads ), blocks ) );
+  std::vector<std::thread> pool;
+  for ( unsigned int t = 1; t < threads; ++t )
+    {
+    pool.emplace_back( worker );
+    }
+  worker();
+  for ( auto &thread : pool )
+    {
+    thread.join();
+    }
+
+  size_t totalSize = 6;
+  for ( size_t b = 0; b < blocks; ++b )
+    {
+    if ( !errors[b].empty() )
+      {
+      sitkExceptionMacro( "Error compressing with zlib: " << errors[b] );
+      }
+    totalSize += compressed[b].size();
+    }
+
+  std::string stream;
+  stream.reserve( totalSize );
+
+  // zlib header: deflate with a 32K window, (0x78 * 256 + 0x9c) % 31 == 0
+  stream.push_back( static_cast<char>( 0x78 ) );
+  stream.push_back( static_cast<char>( 0x9c ) );
+
+  uLong checksum = checksums[0];
+  stream += compressed[0];
+  for ( size_t b = 1; b < blocks; ++b )
+    {
+    const size_t blockLength = std::min( blockSize, length - b * blockSize );
+    checksum = adler32_combine( checksum, checksums[b], static_cast<z_off_t>( blockLength ) );
+    stream += compressed[b];
+    }
+
+  // Adler-32 trailer, most significant byte first
+  for ( int shift = 24; shift >= 0; shift -= 8 )
+    {
+    stream.push_back( static_cast<char>( ( checksum >> shift ) & 0xff ) );
+    }
+
+  return stream;
+}
+
+
+std::string GetMultiscaleLevelFileName(const std::string &fileName, unsigned int level)
+{
+  if ( level == 0 )
+    {
+    return fileName;
+    }
+
+  // insert the level before the extension, a compression suffix such
+  // as ".nii.gz" is kept with the extension
+  const std::string::size_type slash = fileName.find_last_of( "/\\" );
+  const std::string::size_type start = ( slash == std::string::npos ) ? 0 : slash + 1;
+
+  std::string::size_type dot = fileName.find_last_of( '.' );
+  if ( dot == std::string::npos || dot <= start )
+    {
+    dot = fileName.size();
+    }
+  else
+    {
+    std::string extension = fileName.substr( dot );
+    std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+    const std::string::size_type previous = fileName.find_last_of( '.', dot - 1 );
+    if ( extension == ".gz" && previous != std::string::npos && previous > start )
+      {
+      dot = previous;
+      }
+    }
+
+  return fileName.substr( 0, dot ) + ".level" + std::to_string( level ) + fileName.substr( dot );
+}
+
+
+
+namespace
+{
+std::string GetMemoryFileDirectory()
+{
+#ifdef __linux__
+  // a tmpfs mount, the content stays in memory
+  if ( itksys::SystemTools::FileIsDirectory( "/dev/shm" ) && itksys::SystemTools::TestFileAccess( "/dev/shm", itksys::TEST_FILE_WRITE ) )
+    {
+    return "/dev/shm";
+    }
+#endif
+  for ( const char *variable : { "TMPDIR", "TEMP", "TMP" } )
+    {
+    std::string directory;
+    if ( itksys::SystemTools::GetEnv( variable, directory ) && itksys::SystemTools::FileIsDirectory( directory ) )
+      {
+      return directory;
+      }
+    }
+#ifdef _WIN32
+  return ".";
+#else
+  return "/tmp";
+#endif
+}
+
+std::string GetUniqueMemoryFileName( const std::string &extension )
+{
+  static std::atomic<uint64_t> counter{0};
+  static const uint64_t seed = std::random_device{}() ^ ( uint64_t( std::random_device{}() ) << 32 );
+
+  std::ostringstream name;
+  name << GetMemoryFileDirectory() << "/sitk-" << std::hex << std::setfill('0') << std::setw(16) << seed
+       << "-" << counter++ << extension;
+  return name.str();
+}
+}
+
+
+MemoryFile::MemoryFile(const std::string &extension)
+  : m_FileName( GetUniqueMemoryFileName( extension ) )
+{
+}
+
+MemoryFile::MemoryFile(const void *buffer, size_t length, const std::string &extension)
+  : m_FileName( GetUniqueMemoryFileName( extension ) )
+{
+  std::ofstream out( m_FileName.c_str(), std::ios::binary | std::ios::trunc );
+  out.write( static_cast<const char *>( buffer ), static_cast<std::streamsize>( length ) );
+  out.close();
+  if ( !out )
+    {
+    itksys::SystemTools::RemoveFile( m_FileName );
+    sitkExceptionMacro( "Unable to write the buffer to \"" << m_FileName << "\"." );
+    }
+}
+
+MemoryFile::~MemoryFile()
+{
+  itksys::SystemTools::RemoveFile( m_FileName );
+}
+
+std::vector<uint8_t> MemoryFile::Read() const
+{
+  std::ifstream in( m_FileName.c_str(), std::ios::binary | std::ios::ate );
+  if ( !in )
+    {
+    sitkExceptionMacro( "Unable to open \"" << m_FileName << "\" for reading." );
+    }
+  std::vector<uint8_t> content( static_cast<size_t>( in.tellg() ) );
+  in.seekg( 0 );
+  in.read( reinterpret_cast<char *>( content.data() ), static_cast<std::streamsize>( content.size() ) );
+  if ( !in )
+    {
+    sitkExceptionMacro( "Unable to read \"" << m_FileName << "\"." );
+    }
+  return content;
+}
+
+
+std::string GetImageIOExtension(const std::string &ioname, bool forWriting)
+{
+  itk::ImageIOBase::Pointer iobase = CreateImageIOByName( ioname );
+  const itk::ImageIOBase::ArrayOfExtensionsType &extensions =
+    forWriting ? iobase->GetSupportedWriteExtensions() : iobase->GetSupportedReadExtensions();
+  return extensions.empty() ? std::string() : extensions.front();
+}
+
 }
 }
 }
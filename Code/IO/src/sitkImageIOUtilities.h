@@ -19,6 +19,7 @@
 #ifndef sitkImageIOUtilities_h
 #define sitkImageIOUtilities_h
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <ostream>
@@ -49,6 +50,73 @@ SITKIO_HIDDEN std::vector<std::string> GetRegisteredImageIOs();
 
 SITKIO_HIDDEN itk::SmartPointer<ImageIOBase> CreateImageIOByName(const std::string & ioname);
 
+
+/* Internal method which creates the ImageIO to read a file, or
+ * returns a null pointer when no ImageIO can read it. The ImageIOs
+ * which list the file's extension are probed first, before all the
+ * registered ImageIOs are tried by the ImageIOFactory. The ImageIO
+ * found is cached for the process, keyed by the file's path, length
+ * and modification time, and tried first when the file is read again.
+ */
+SITKIO_HIDDEN itk::SmartPointer<ImageIOBase> CreateImageIOForReading(const std::string & fileName);
+
+
+/* Internal method which compresses a buffer into a single zlib stream
+ * (RFC 1950) using several threads. The buffer is divided into
+ * numberOfBlocks blocks which are deflated independently, byte
+ * aligned with a sync flush, and concatenated, the Adler-32 checksums
+ * of the blocks are combined for the stream trailer.
+ */
+SITKIO_HIDDEN std::string ParallelDeflate(const void *buffer,
+                                          size_t length,
+                                          int compressionLevel,
+                                          unsigned int numberOfThreads,
+                                          unsigned int numberOfBlocks);
+
+
+/* Internal method which returns the name of the file storing a
+ * multiscale level written by ImageFileWriter. The level is inserted
+ * before the extension, "image.mha" has level 1 in
+ * "image.level1.mha". Level 0 is the file itself.
+ */
+SITKIO_HIDDEN std::string GetMultiscaleLevelFileName(const std::string &fileName, unsigned int level);
+
+
+/* Internal class of a file on a memory backed file system, used to
+ * pass an in-memory encoded image to the ImageIOs which only read and
+ * write file names. On Linux the file is in "/dev/shm", elsewhere in
+ * the temporary directory. The file is removed on destruction.
+ */
+class SITKIO_HIDDEN MemoryFile
+{
+public:
+  /* Create an empty file name with the extension, e.g. ".png". */
+  explicit MemoryFile(const std::string &extension);
+
+  /* Create the file with the content of the buffer. */
+  MemoryFile(const void *buffer, size_t length, const std::string &extension);
+
+  ~MemoryFile();
+
+  MemoryFile(const MemoryFile &) = delete;
+  MemoryFile &operator=(const MemoryFile &) = delete;
+
+  const std::string &GetFileName() const { return m_FileName; }
+
+  /* Read the content of the file. */
+  std::vector<uint8_t> Read() const;
+
+private:
+  std::string m_FileName;
+};
+
+
+/* Internal method which returns the file extension for an ImageIO,
+ * the first of the supported read or write extensions, or an empty
+ * string if it lists none.
+ */
+SITKIO_HIDDEN std::string GetImageIOExtension(const std::string &ioname, bool forWriting);
+
 }
 }
 }
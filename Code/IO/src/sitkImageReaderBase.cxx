@@ -34,6 +34,9 @@
 #include <itkImageIOBase.h>
 #include <itkImageIOFactory.h>
 #include <itkGDCMImageIO.h>
+#ifdef SITK_HAS_OME_ZARR
+#include <itkOMEZarrNGFFImageIO.h>
+#endif
 
 
 namespace itk {
@@ -46,6 +49,7 @@ ImageReaderBase
 ::ImageReaderBase()
   : m_OutputPixelType(sitkUnknown),
     m_LoadPrivateTags(false),
+    m_MultiscaleLevel(0),
     m_ImageIOName("")
 {
 }
@@ -59,6 +63,8 @@ ImageReaderBase
   this->ToStringHelper(out, this->m_OutputPixelType) << std::endl;
   out << "  LoadPrivateTags: ";
   this->ToStringHelper(out, this->m_LoadPrivateTags) << std::endl;
+  out << "  MultiscaleLevel: ";
+  this->ToStringHelper(out, this->m_MultiscaleLevel) << std::endl;
   out << "  ImageIOName: ";
   this->ToStringHelper(out, this->m_ImageIOName) << std::endl;
   out << "  Registered ImageIO:" << std::endl;
@@ -78,11 +84,18 @@ ImageReaderBase
 itk::SmartPointer<ImageIOBase>
 ImageReaderBase
 ::GetImageIOBase(const std::string &fileName)
+{
+  return this->GetImageIOBase(fileName, this->m_MultiscaleLevel);
+}
+
+itk::SmartPointer<ImageIOBase>
+ImageReaderBase
+::GetImageIOBase(const std::string &fileName, unsigned int multiscaleLevel)
 {
   itk::ImageIOBase::Pointer iobase;
   if (this->m_ImageIOName.empty())
     {
-    iobase = itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::IOFileModeEnum::ReadMode);
+    iobase = ioutils::CreateImageIOForReading( fileName );
     }
   else
     {
@@ -112,6 +125,16 @@ ImageReaderBase
     ioGDCMImage->SetLoadPrivateTags(this->m_LoadPrivateTags);
     }
 
+#ifdef SITK_HAS_OME_ZARR
+  OMEZarrNGFFImageIO *ioOMEZarr = dynamic_cast<OMEZarrNGFFImageIO*>(iobase.GetPointer());
+  if (ioOMEZarr)
+    {
+    ioOMEZarr->SetDatasetIndex(static_cast<int>(multiscaleLevel));
+    }
+#else
+  (void)multiscaleLevel;
+#endif
+
   // Read the image information
   iobase->SetFileName( fileName );
   iobase->ReadImageInformation();
@@ -120,6 +143,18 @@ ImageReaderBase
   return iobase;
 }
 
+bool
+ImageReaderBase
+::IsMultiscaleImageIO(const ImageIOBase *iobase)
+{
+#ifdef SITK_HAS_OME_ZARR
+  return dynamic_cast<const OMEZarrNGFFImageIO*>(iobase) != nullptr;
+#else
+  (void)iobase;
+  return false;
+#endif
+}
+
 ImageReaderBase::Self&
 ImageReaderBase
 ::SetOutputPixelType( PixelIDValueEnum pixelID )
@@ -165,6 +200,21 @@ ImageReaderBase
   this->SetLoadPrivateTags(false);
 }
 
+ImageReaderBase::Self&
+ImageReaderBase
+::SetMultiscaleLevel(unsigned int level)
+{
+  this->m_MultiscaleLevel = level;
+  return *this;
+}
+
+unsigned int
+ImageReaderBase
+::GetMultiscaleLevel() const
+{
+  return this->m_MultiscaleLevel;
+}
+
 ImageReaderBase::Self&
 ImageReaderBase
 ::SetImageIO(const std::string &imageio)
@@ -188,7 +238,7 @@ ImageReaderBase
   itk::ImageIOBase::Pointer iobase;
   try
     {
-    iobase = itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::IOFileModeEnum::ReadMode);
+    iobase = ioutils::CreateImageIOForReading( fileName );
     }
   catch(...)
     {
@@ -23,13 +23,55 @@
 
 #include <itkImageIOBase.h>
 #include <itkImageSeriesReader.h>
+#include <itkImageFileReader.h>
 
+#include "itkGDCMImageIO.h"
 #include "itkGDCMSeriesFileNames.h"
-#include "sitkMetaDataDictionaryCustomCast.hxx"
+#include "sitkSharedMetaDataDictionaryArray.h"
+#include "sitkTraceRange.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace itk {
   namespace simple {
 
+  namespace
+  {
+  // The image type of one file of a series.
+  template <class TImageType>
+  struct SeriesSliceImage;
+
+  template <class TPixelType, unsigned int VImageDimension>
+  struct SeriesSliceImage< itk::Image<TPixelType, VImageDimension> >
+  {
+    using Type = itk::Image<TPixelType, VImageDimension - 1>;
+  };
+
+  template <class TPixelType, unsigned int VImageDimension>
+  struct SeriesSliceImage< itk::VectorImage<TPixelType, VImageDimension> >
+  {
+    using Type = itk::VectorImage<TPixelType, VImageDimension - 1>;
+  };
+
+  // Set the spacing of the axis the files are stacked along, when
+  // it is not computed from the origins of the files.
+  template <class TImageType>
+  void SetSeriesSpacing( TImageType *image, double seriesSpacing )
+  {
+    if ( seriesSpacing > 0.0 )
+      {
+      typename TImageType::SpacingType spacing = image->GetSpacing();
+      spacing[TImageType::ImageDimension - 1] = seriesSpacing;
+      image->SetSpacing( spacing );
+      }
+  }
+  }
+
   Image ReadImage ( const std::vector<std::string> &filenames,
                     PixelIDValueEnum outputPixelType,
                     const std::string &imageIO )
@@ -75,8 +117,9 @@ namespace itk {
 
   ImageSeriesReader::ImageSeriesReader()
     :
-    m_Filter(nullptr),
-    m_MetaDataDictionaryArrayUpdate(false)
+    m_MetaDataDictionaryArrayUpdate(false),
+    m_NumberOfParallelReads(1),
+    m_SeriesSpacing(0.0)
     {
 
     // list of pixel types supported
@@ -87,13 +130,7 @@ namespace itk {
     this->m_MemberFactory->RegisterMemberFunctions< PixelIDTypeList, 2, SITK_MAX_DIMENSION > ();
     }
 
-  ImageSeriesReader::~ImageSeriesReader()
-  {
-  if (this->m_Filter != nullptr)
-    {
-      m_Filter->UnRegister();
-    }
-  }
+  ImageSeriesReader::~ImageSeriesReader() = default;
 
   std::string ImageSeriesReader::ToString() const {
 
@@ -109,6 +146,9 @@ namespace itk {
         ++iter;
         }
 
+      out << "  NumberOfParallelReads: " << this->m_NumberOfParallelReads << std::endl;
+      out << "  SeriesSpacing: " << this->m_SeriesSpacing << std::endl;
+
       out << ImageReaderBase::ToString();
       return out.str();
     }
@@ -124,12 +164,39 @@ namespace itk {
     return this->m_FileNames;
     }
 
+  ImageSeriesReader& ImageSeriesReader::SetNumberOfParallelReads ( unsigned int n )
+    {
+    this->m_NumberOfParallelReads = std::max( n, 1u );
+    return *this;
+    }
+
+  unsigned int ImageSeriesReader::GetNumberOfParallelReads() const
+    {
+    return this->m_NumberOfParallelReads;
+    }
+
+  ImageSeriesReader& ImageSeriesReader::SetSeriesSpacing ( double spacing )
+    {
+    if ( spacing < 0.0 )
+      {
+      sitkExceptionMacro( "The series spacing must not be negative: " << spacing );
+      }
+    this->m_SeriesSpacing = spacing;
+    return *this;
+    }
+
+  double ImageSeriesReader::GetSeriesSpacing() const
+    {
+    return this->m_SeriesSpacing;
+    }
+
   Image ImageSeriesReader::Execute ()
     {
     if( this->m_FileNames.empty() )
       {
       sitkExceptionMacro( "File names information is empty. Cannot read series." );
       }
+    const detail::TraceRange traceRange( *this, this->m_FileNames.front() );
 
 
     PixelIDValueType type =  this->GetOutputPixelType();
@@ -193,32 +260,175 @@ namespace itk {
     // save some computation by not updating this unneeded data-structure
     reader->SetMetaDataDictionaryArrayUpdate(m_MetaDataDictionaryArrayUpdate);
 
-    // release the old filter ( and output data )
-    if ( this->m_Filter != nullptr)
-      {
-      this->m_pfGetMetaDataKeys = nullptr;
-      this->m_pfHasMetaDataKey = nullptr;
-      this->m_pfGetMetaData =  nullptr;
-      this->m_Filter->UnRegister();
-      this->m_Filter = nullptr;
-      }
+    // release the dictionaries of the previous execution
+    this->m_pfGetMetaDataKeys = nullptr;
+    this->m_pfHasMetaDataKey = nullptr;
+    this->m_pfGetMetaData =  nullptr;
 
 
     this->PreUpdate( reader.GetPointer() );
 
-    if (m_MetaDataDictionaryArrayUpdate)
+    if ( this->m_NumberOfParallelReads > 1 && this->m_FileNames.size() > 1 )
       {
-      this->m_Filter = reader;
-      this->m_Filter->Register();
-      this->m_pfGetMetaDataKeys = std::bind(&GetMetaDataKeysCustomCast<Reader>::CustomCast, reader.GetPointer(), std::placeholders::_1 );
-      this->m_pfHasMetaDataKey = std::bind(&HasMetaDataKeyCustomCast<Reader>::CustomCast, reader.GetPointer(), std::placeholders::_1, std::placeholders::_2 );
-      this->m_pfGetMetaData = std::bind(&GetMetaDataCustomCast<Reader>::CustomCast, reader.GetPointer(), std::placeholders::_1, std::placeholders::_2 );
+      // the series reader computes the geometry of the volume from the files
+      reader->UpdateOutputInformation();
+      const ImageType *information = reader->GetOutput();
+      if ( information->GetLargestPossibleRegion().GetSize( ImageType::ImageDimension - 1 ) == this->m_FileNames.size() )
+        {
+        return this->ExecuteInternalParallel<ImageType>( imageio, information );
+        }
       }
 
     reader->Update();
 
+    if (m_MetaDataDictionaryArrayUpdate)
+      {
+      // copy the dictionaries of the reader into the shared storage,
+      // the reader and its dictionaries are released on return
+      const typename Reader::DictionaryArrayType &mda = *reader->GetMetaDataDictionaryArray();
+      auto dictionaries = std::make_shared<ioutils::SharedMetaDataDictionaryArray>( mda.size() );
+      for ( size_t i = 0; i < mda.size(); ++i )
+        {
+        dictionaries->SetDictionary( i, *mda[i] );
+        }
+      dictionaries->Finalize();
+      this->SetMetaDataDictionaryArray( dictionaries );
+      }
+
+    SetSeriesSpacing( reader->GetOutput(), this->m_SeriesSpacing );
+
     return Image( reader->GetOutput() );
     }
 
+
+  template <class TImageType> Image
+  ImageSeriesReader::ExecuteInternalParallel( itk::ImageIOBase* imageio, const TImageType *information )
+    {
+
+    using ImageType = TImageType;
+    using SliceImageType = typename SeriesSliceImage<ImageType>::Type;
+    using SliceReaderType = itk::ImageFileReader<SliceImageType>;
+    using PixelContainerType = typename SliceImageType::PixelContainer;
+
+    typename ImageType::Pointer output = ImageType::New();
+    output->CopyInformation( information );
+    SetSeriesSpacing( output.GetPointer(), this->m_SeriesSpacing );
+    output->SetNumberOfComponentsPerPixel( information->GetNumberOfComponentsPerPixel() );
+    output->SetRegions( information->GetLargestPossibleRegion() );
+    output->Allocate();
+
+    const size_t numberOfSlices = this->m_FileNames.size();
+    const size_t sliceLength = output->GetPixelContainer()->Size() / numberOfSlices;
+
+    typename SliceImageType::SizeType sliceSize;
+    for ( unsigned int d = 0; d < SliceImageType::ImageDimension; ++d )
+      {
+      sliceSize[d] = output->GetLargestPossibleRegion().GetSize( d );
+      }
+
+    std::shared_ptr<ioutils::SharedMetaDataDictionaryArray> dictionaries;
+    if ( this->m_MetaDataDictionaryArrayUpdate )
+      {
+      dictionaries = std::make_shared<ioutils::SharedMetaDataDictionaryArray>( numberOfSlices );
+      }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool>   failed{false};
+    std::exception_ptr  firstException;
+    std::mutex          exceptionMutex;
+
+    auto readSlices = [&]()
+      {
+        try
+          {
+          for ( size_t i = next++; i < numberOfSlices && !failed; i = next++ )
+            {
+            this->ThrowIfCancelled();
+
+            const std::string &fileName = this->m_FileNames[i];
+
+            itk::ImageIOBase::Pointer io = dynamic_cast<itk::ImageIOBase *>( imageio->CreateAnother().GetPointer() );
+            GDCMImageIO *ioGDCMImage = dynamic_cast<GDCMImageIO*>( io.GetPointer() );
+            if ( ioGDCMImage )
+              {
+              ioGDCMImage->SetLoadPrivateTags( this->GetLoadPrivateTags() );
+              }
+
+            // the part of the output buffer for this file
+            typename PixelContainerType::Pointer slab = PixelContainerType::New();
+            slab->SetImportPointer( output->GetPixelContainer()->GetBufferPointer() + i * sliceLength, sliceLength, false );
+
+            typename SliceReaderType::Pointer sliceReader = SliceReaderType::New();
+            sliceReader->SetImageIO( io );
+            sliceReader->SetFileName( fileName );
+
+            // Set the buffer after the pipeline initializes the
+            // output, so the allocation for the file reuses it.
+            SliceImageType *slice = sliceReader->GetOutput();
+            sliceReader->AddObserver( itk::StartEvent(), [slice, slab]( const itk::EventObject & ) { slice->SetPixelContainer( slab ); } );
+            sliceReader->Update();
+
+            if ( slice->GetLargestPossibleRegion().GetSize() != sliceSize )
+              {
+              sitkExceptionMacro( "The size of \"" << fileName << "\" does not match the size of the first file in the series." );
+              }
+            if ( slice->GetPixelContainer()->GetBufferPointer() != slab->GetBufferPointer() )
+              {
+              std::copy_n( slice->GetPixelContainer()->GetBufferPointer(), sliceLength, slab->GetBufferPointer() );
+              }
+
+            if ( dictionaries )
+              {
+              dictionaries->SetDictionary( i, io->GetMetaDataDictionary() );
+              }
+            }
+          }
+        catch (...)
+          {
+          std::lock_guard<std::mutex> lock( exceptionMutex );
+          if ( !firstException )
+            {
+            firstException = std::current_exception();
+            }
+          failed = true;
+          }
+      };
+
+    const unsigned int numberOfThreads = static_cast<unsigned int>( std::min<size_t>( this->m_NumberOfParallelReads, numberOfSlices ) );
+    std::vector<std::thread> threads;
+    threads.reserve( numberOfThreads - 1 );
+    for ( unsigned int t = 1; t < numberOfThreads; ++t )
+      {
+      threads.emplace_back( readSlices );
+      }
+    readSlices();
+    for ( std::thread &thread : threads )
+      {
+      thread.join();
+      }
+
+    if ( firstException )
+      {
+      std::rethrow_exception( firstException );
+      }
+
+    if ( dictionaries )
+      {
+      dictionaries->Finalize();
+      this->SetMetaDataDictionaryArray( dictionaries );
+      }
+
+    return Image( output.GetPointer() );
+    }
+
+
+  void ImageSeriesReader::SetMetaDataDictionaryArray( std::shared_ptr<ioutils::SharedMetaDataDictionaryArray> dictionaries )
+    {
+    // a negative slice is converted to an out of range index
+    this->m_pfGetMetaDataKeys = [dictionaries]( int i ) { return dictionaries->GetKeys( static_cast<size_t>( i ) ); };
+    this->m_pfHasMetaDataKey = [dictionaries]( int i, const std::string &k ) { return dictionaries->HasKey( static_cast<size_t>( i ), k ); };
+    this->m_pfGetMetaData = [dictionaries]( int i, const std::string &k ) { return dictionaries->Get( static_cast<size_t>( i ), k ); };
+    }
+
   }
 }
@@ -23,15 +23,75 @@
 
 #include "sitkImageSeriesWriter.h"
 #include "sitkImageIOUtilities.h"
+#include "sitkTraceRange.h"
 
 #include <itkImageIOBase.h>
 #include <itkImageSeriesWriter.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace itk {
   namespace simple {
 
+  namespace
+  {
+
+  // Copy a slice along the last axis into an image of one less
+  // dimension, with the same geometry as itk::ImageSeriesWriter.
+  template <class TSliceImageType, class TImageType>
+  typename TSliceImageType::Pointer ExtractSlice( const TImageType *image, itk::SizeValueType sliceNumber )
+  {
+    constexpr unsigned int SliceDimension = TSliceImageType::ImageDimension;
+
+    typename TImageType::RegionType inRegion = image->GetLargestPossibleRegion();
+    inRegion.SetIndex( SliceDimension, inRegion.GetIndex( SliceDimension ) + sliceNumber );
+    inRegion.SetSize( SliceDimension, 1 );
+
+    typename TImageType::PointType inOrigin;
+    image->TransformIndexToPhysicalPoint( inRegion.GetIndex(), inOrigin );
+
+    typename TSliceImageType::RegionType outRegion;
+    typename TSliceImageType::SpacingType spacing;
+    typename TSliceImageType::PointType origin;
+    typename TSliceImageType::DirectionType direction;
+    for ( unsigned int d = 0; d < SliceDimension; ++d )
+      {
+      outRegion.SetSize( d, inRegion.GetSize( d ) );
+      spacing[d] = image->GetSpacing()[d];
+      origin[d] = inOrigin[d];
+      for ( unsigned int c = 0; c < SliceDimension; ++c )
+        {
+        direction[d][c] = image->GetDirection()[d][c];
+        }
+      }
+
+    typename TSliceImageType::Pointer slice = TSliceImageType::New();
+    slice->SetRegions( outRegion );
+    slice->SetSpacing( spacing );
+    slice->SetOrigin( origin );
+    slice->SetDirection( direction );
+    slice->SetNumberOfComponentsPerPixel( image->GetNumberOfComponentsPerPixel() );
+    slice->Allocate();
+
+    itk::ImageRegionConstIterator<TImageType> in( image, inRegion );
+    itk::ImageRegionIterator<TSliceImageType> out( slice, outRegion );
+    for ( ; !in.IsAtEnd(); ++in, ++out )
+      {
+      out.Set( in.Get() );
+      }
+    return slice;
+  }
+
+  }
+
   void WriteImage ( const Image& inImage, const std::vector<std::string> &filenames, bool useCompression, int compressionLevel )
   {
     ImageSeriesWriter writer;
@@ -46,6 +106,7 @@ namespace itk {
 
     this->m_UseCompression = false;
     this->m_CompressionLevel = -1;
+    this->m_NumberOfParallelWrites = 1;
 
     // list of pixel types supported
     using PixelIDTypeList = NonLabelPixelIDTypeList;
@@ -86,6 +147,8 @@ namespace itk {
     out << "  ImageIOName: ";
     this->ToStringHelper(out, this->m_ImageIOName) << std::endl;
 
+    out << "  NumberOfParallelWrites: " << this->m_NumberOfParallelWrites << std::endl;
+
     out << "  Registered ImageIO:" << std::endl;
     ioutils::PrintRegisteredImageIOs(out);
 
@@ -189,6 +252,18 @@ namespace itk {
   }
 
 
+  ImageSeriesWriter& ImageSeriesWriter::SetNumberOfParallelWrites ( unsigned int n )
+  {
+    this->m_NumberOfParallelWrites = std::max( n, 1u );
+    return *this;
+  }
+
+  unsigned int ImageSeriesWriter::GetNumberOfParallelWrites() const
+  {
+    return this->m_NumberOfParallelWrites;
+  }
+
+
   ImageSeriesWriter& ImageSeriesWriter::Execute ( const Image& image, const std::vector<std::string> &inFileNames, bool useCompression, int compressionLevel )
   {
     this->SetFileNames( inFileNames );
@@ -203,6 +278,7 @@ namespace itk {
     // check that the number of file names match the slice size
     PixelIDValueType type = image.GetPixelIDValue();
     unsigned int dimension = image.GetDimension();
+    const detail::TraceRange traceRange( *this, &image );
 
     return this->m_MemberFactory->GetMemberFunction( type, dimension )( image );
   }
@@ -262,10 +338,141 @@ namespace itk {
 
     this->PreUpdate( writer.GetPointer() );
 
+    if ( this->m_NumberOfParallelWrites > 1 && this->m_FileNames.size() > 1 )
+      {
+      this->ExecuteInternalParallel<InputImageType>( image.GetPointer(), writer.GetPointer(), imageio );
+      return *this;
+      }
+
     writer->Update();
 
     return *this;
   }
 
+
+  template <class TImageType, class TWriter>
+  void
+  ImageSeriesWriter::ExecuteInternalParallel( const TImageType *image, TWriter *writer, itk::ImageIOBase *imageio )
+  {
+    using SliceImageType = typename TWriter::OutputImageType;
+    using SliceWriterType = itk::ImageFileWriter<SliceImageType>;
+
+    const size_t numberOfSlices = image->GetLargestPossibleRegion().GetSize( SliceImageType::ImageDimension );
+    if ( numberOfSlices != this->m_FileNames.size() )
+      {
+      sitkExceptionMacro( "The number of file names (" << this->m_FileNames.size()
+                          << ") does not match the number of slices (" << numberOfSlices << ")." );
+      }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool>   stop{false};
+    std::mutex          mutex;
+    std::condition_variable finishedCondition;
+    size_t              numberOfFinished = 0;
+    std::vector< std::pair<size_t, std::string> > failures;
+
+    auto writeSlices = [&]()
+      {
+        for ( size_t i = next++; i < numberOfSlices && !stop; i = next++ )
+          {
+          std::string error;
+          try
+            {
+            itk::ImageIOBase::Pointer io = dynamic_cast<itk::ImageIOBase *>( imageio->CreateAnother().GetPointer() );
+            if ( !this->m_Compressor.empty() )
+              {
+              io->SetCompressor( this->m_Compressor );
+              }
+            if ( this->m_CompressionLevel != -1 )
+              {
+              io->SetCompressionLevel( this->m_CompressionLevel );
+              }
+
+            typename SliceWriterType::Pointer sliceWriter = SliceWriterType::New();
+            sliceWriter->SetImageIO( io );
+            sliceWriter->SetUseCompression( this->m_UseCompression );
+            sliceWriter->SetFileName( this->m_FileNames[i] );
+            sliceWriter->SetInput( ExtractSlice<SliceImageType>( image, i ) );
+            sliceWriter->Update();
+            }
+          catch ( std::exception &e )
+            {
+            error = e.what();
+            }
+          catch (...)
+            {
+            error = "Unknown error.";
+            }
+
+          {
+          std::lock_guard<std::mutex> lock( mutex );
+          ++numberOfFinished;
+          if ( !error.empty() )
+            {
+            failures.emplace_back( i, error );
+            }
+          }
+          finishedCondition.notify_one();
+          }
+      };
+
+    writer->InvokeEvent( itk::StartEvent() );
+    writer->UpdateProgress( 0.0f );
+
+    const unsigned int numberOfThreads = static_cast<unsigned int>( std::min<size_t>( this->m_NumberOfParallelWrites, numberOfSlices ) );
+    std::vector<std::thread> threads;
+    threads.reserve( numberOfThreads );
+    for ( unsigned int t = 0; t < numberOfThreads; ++t )
+      {
+      threads.emplace_back( writeSlices );
+      }
+
+    // The events are invoked from this thread as the slices finish.
+    {
+    std::unique_lock<std::mutex> lock( mutex );
+    size_t numberReported = 0;
+    while ( numberReported < numberOfSlices && !stop )
+      {
+      finishedCondition.wait( lock, [&]{ return numberOfFinished != numberReported; } );
+      numberReported = numberOfFinished;
+
+      lock.unlock();
+      writer->UpdateProgress( static_cast<float>( numberReported ) / numberOfSlices );
+      if ( writer->GetAbortGenerateData() || this->IsCancelled() )
+        {
+        stop = true;
+        }
+      lock.lock();
+      }
+    }
+
+    for ( std::thread &thread : threads )
+      {
+      thread.join();
+      }
+
+    if ( stop )
+      {
+      writer->InvokeEvent( itk::AbortEvent() );
+      this->ThrowIfCancelled();
+      sitkExceptionMacro( "Writing the series was aborted after " << numberOfFinished
+                          << " of " << numberOfSlices << " slices." );
+      }
+
+    if ( !failures.empty() )
+      {
+      std::sort( failures.begin(), failures.end() );
+      std::ostringstream msg;
+      msg << "Failed to write " << failures.size() << " of " << numberOfSlices << " slices:";
+      for ( const auto &failure : failures )
+        {
+        msg << "\n  \"" << this->m_FileNames[failure.first] << "\": " << failure.second;
+        }
+      sitkExceptionMacro( << msg.str() );
+      }
+
+    writer->InvokeEvent( itk::EndEvent() );
+  }
+
   }
 }
@@ -35,6 +35,10 @@
 #include <unistd.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/statvfs.h>
+#endif
+
 
 //
 //  Dave's mental notes about ImageJ/Fiji and file formats
@@ -78,7 +82,8 @@ namespace
                                            const std::string & filename, const std::string & title="" );
   std::string FormatFileName ( const std::string & TempDirectory, const std::string & name,
                                const std::string & extension, const int tagID );
-  std::string BuildFullFileName( const std::string & name, const std::string & extension, const int tagID );
+  std::string BuildFullFileName( const std::string & TempDirectory, const std::string & name,
+                                 const std::string & extension, const int tagID, const uint64_t imageBytes );
 #ifdef _WIN32
   std::string DoubleBackslashes( const std::string & word );
 #endif
@@ -98,6 +103,7 @@ std::string ImageViewer::m_GlobalDefaultViewCommand;
 
 std::string ImageViewer::m_GlobalDefaultApplication;
 std::string ImageViewer::m_GlobalDefaultFileExtension;
+std::string ImageViewer::m_GlobalDefaultTempDirectory;
 
 bool ImageViewer::m_GlobalDefaultDebug=false;
 
@@ -125,6 +131,9 @@ void ImageViewer::initializeDefaults()
     m_GlobalDefaultFileExtension = ".mha";
     }
 
+  // Temporary directory, automatic when empty
+  itksys::SystemTools::GetEnv ( "SITK_SHOW_TEMP_DIRECTORY", m_GlobalDefaultTempDirectory );
+
   // Show command
   itksys::SystemTools::GetEnv ( "SITK_SHOW_COMMAND", cmd );
   if (cmd.length()>0)
@@ -327,6 +336,16 @@ const std::string & ImageViewer::GetGlobalDefaultApplication()
   return ImageViewer::m_GlobalDefaultApplication;
   }
 
+void ImageViewer::SetGlobalDefaultTempDirectory( const std::string & dir )
+  {
+  ImageViewer::m_GlobalDefaultTempDirectory = dir;
+  }
+
+const std::string & ImageViewer::GetGlobalDefaultTempDirectory()
+  {
+  return ImageViewer::m_GlobalDefaultTempDirectory;
+  }
+
 
 //
 // A bunch of Set/Get methods for the class member variables
@@ -428,6 +447,7 @@ std::string ImageViewer::ToString() const
   out << "  Default Application: " << ImageViewer::GetGlobalDefaultApplication() << std::endl;
   out << "  File Extension: " << this->GetFileExtension() << std::endl;
   out << "  Default File Extension: " << ImageViewer::GetGlobalDefaultFileExtension() << std::endl;
+  out << "  Default Temp Directory: " << ImageViewer::GetGlobalDefaultTempDirectory() << std::endl;
   out << "  Search Path: " << ImageViewer::GetGlobalDefaultSearchPath() << std::endl;
   out << "  Executable Names: " << ImageViewer::GetGlobalDefaultExecutableNames() << std::endl;
   out << "  Debug Flag: " << ImageViewer::GetGlobalDefaultDebug() << std::endl;
@@ -457,7 +477,9 @@ void ImageViewer::Execute( const Image & image )
     ext = m_GlobalDefaultFileExtension;
     }
 
-  TempFile = BuildFullFileName(m_Title, ext, m_GlobalViewerImageCount++);
+  const uint64_t imageBytes = image.GetNumberOfPixels() * image.GetNumberOfComponentsPerPixel()
+    * image.GetSizeOfPixelComponent();
+  TempFile = BuildFullFileName(m_GlobalDefaultTempDirectory, m_Title, ext, m_GlobalViewerImageCount++, imageBytes);
 
   // write out the image
   WriteImage ( image, TempFile );
@@ -854,27 +876,73 @@ std::string FormatFileName ( const std::string & TempDirectory, const std::strin
 #endif
 
 //
+// Returns true when the memory backed directory has room for the
+// image, with some margin for the header and the other files.
 //
-std::string BuildFullFileName(const std::string & name, const std::string & extension, const int tagID )
+#if defined(__linux__)
+bool HasRoomInMemoryDirectory( const std::string & directory, const uint64_t imageBytes )
   {
-  std::string TempDirectory;
+  if ( !itksys::SystemTools::FileIsDirectory( directory ) || access( directory.c_str(), W_OK ) != 0 )
+    {
+    return false;
+    }
+  struct statvfs fs;
+  if ( statvfs( directory.c_str(), &fs ) != 0 )
+    {
+    return false;
+    }
+  const uint64_t available = static_cast<uint64_t>( fs.f_bavail ) * static_cast<uint64_t>( fs.f_frsize );
+  return imageBytes < available / 2;
+  }
+#endif
 
+//
+//
+std::string BuildFullFileName(const std::string & TempDirectory, const std::string & name, const std::string & extension,
+                              const int tagID, const uint64_t imageBytes )
+  {
+  std::string directory = TempDirectory;
+
+  if ( !directory.empty() )
+    {
+    const char last = directory.back();
+    if ( last != '/' && last != '\\' )
+      {
+#ifdef _WIN32
+      directory += "\\";
+#else
+      directory += "/";
+#endif
+      }
 #ifdef _WIN32
-  if ( !itksys::SystemTools::GetEnv ( "TMP", TempDirectory )
-    && !itksys::SystemTools::GetEnv ( "TEMP", TempDirectory )
-    && !itksys::SystemTools::GetEnv ( "USERPROFILE", TempDirectory )
-    && !itksys::SystemTools::GetEnv ( "WINDIR", TempDirectory ) )
+    directory = DoubleBackslashes(directory);
+#endif
+    return FormatFileName ( directory, name, extension, tagID );
+    }
+
+#ifdef _WIN32
+  if ( !itksys::SystemTools::GetEnv ( "TMP", directory )
+    && !itksys::SystemTools::GetEnv ( "TEMP", directory )
+    && !itksys::SystemTools::GetEnv ( "USERPROFILE", directory )
+    && !itksys::SystemTools::GetEnv ( "WINDIR", directory ) )
     {
     sitkExceptionMacro ( << "Can not find temporary directory.  Tried TMP, TEMP, USERPROFILE, and WINDIR environment variables" );
     }
-  TempDirectory = TempDirectory + "\\";
-  TempDirectory = DoubleBackslashes(TempDirectory);
+  directory = directory + "\\";
+  directory = DoubleBackslashes(directory);
 #else
-  TempDirectory = "/tmp/";
+  directory = "/tmp/";
+#if defined(__linux__)
+  // the image is handed to the viewer in memory, without disk writes
+  if ( HasRoomInMemoryDirectory( "/dev/shm", imageBytes ) )
+    {
+    directory = "/dev/shm/";
+    }
 #endif
-  return FormatFileName ( TempDirectory, name, extension, tagID );
+#endif
+  (void)imageBytes;
+  return FormatFileName ( directory, name, extension, tagID );
   }
-
 }
 
   } // namespace simple
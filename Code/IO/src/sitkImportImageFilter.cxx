@@ -21,11 +21,15 @@
 
 #include "sitkImportImageFilter.h"
 #include "sitkExceptionObject.h"
+#include "sitkMemoryMappedFile.h"
 
 #include <itkImage.h>
 #include <itkVectorImage.h>
+#include <itkImportImageContainer.h>
 
 #include <iterator>
+#include <memory>
+#include <cstdint>
 
 namespace itk {
 namespace simple {
@@ -34,6 +38,56 @@ namespace simple {
 namespace
 {
 const unsigned int UnusedDimension = 2;
+
+// A pixel container which keeps the owner of the imported memory
+// alive for the lifetime of the container.
+template <typename TElement>
+class OwnerImportImageContainer
+  : public itk::ImportImageContainer<itk::SizeValueType, TElement>
+{
+public:
+  using Self = OwnerImportImageContainer;
+  using Superclass = itk::ImportImageContainer<itk::SizeValueType, TElement>;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(OwnerImportImageContainer, ImportImageContainer);
+
+  void SetOwner( std::shared_ptr<void> owner ) { m_Owner = std::move(owner); }
+
+  // With copy on write, the owner counts as a reference to the
+  // buffer, so the images sharing the container are not unique.
+  void SetCopyOnWrite( bool copyOnWrite ) { m_CopyOnWrite = copyOnWrite; }
+  int GetReferenceCount() const override { return Superclass::GetReferenceCount() + ( m_CopyOnWrite ? 1 : 0 ); }
+
+protected:
+  OwnerImportImageContainer() = default;
+  ~OwnerImportImageContainer() override = default;
+
+private:
+  std::shared_ptr<void> m_Owner;
+  bool m_CopyOnWrite{ false };
+};
+}
+
+
+Image ImportFromMemoryMappedFile(
+    const std::string &fileName,
+    PixelIDValueEnum pixelID,
+    const std::vector< unsigned int > &size,
+    const std::vector< double > &spacing,
+    const std::vector< double > &origin,
+    const std::vector< double > &direction,
+    unsigned int numberOfComponents,
+    uint64_t offset
+) {
+    ImportImageFilter import;
+    import.SetSize( size );
+    import.SetSpacing( spacing );
+    import.SetOrigin( origin );
+    import.SetDirection( direction );
+    import.SetMemoryMappedFile( fileName, pixelID, numberOfComponents, offset );
+    return import.Execute();
 }
 
 
@@ -216,6 +270,8 @@ ImportImageFilter::ImportImageFilter()
   m_Origin = std::vector<double>( 3, 0.0 );
   m_Spacing = std::vector<double>( 3, 1.0 );
   this->m_Buffer = NULL;
+  this->m_MemoryMappedFileOffset = 0;
+  this->m_CopyOnWrite = false;
 
   // list of pixel types supported
   using PixelIDTypeList = NonLabelPixelIDTypeList;
@@ -275,6 +331,8 @@ const std::vector< double > &ImportImageFilter::GetDirection( ) const
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt8( int8_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -289,6 +347,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt8( int8_t * buffer, un
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt8( uint8_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -303,6 +363,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt8( uint8_t * buffer,
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt16( int16_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -317,6 +379,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt16( int16_t * buffer,
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt16( uint16_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -331,6 +395,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt16( uint16_t * buffer
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt32( int32_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -345,6 +411,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt32( int32_t * buffer,
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt32( uint32_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -359,6 +427,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt32( uint32_t * buffer
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt64( int64_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -373,6 +443,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt64( int64_t * buffer,
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt64( uint64_t * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -388,6 +460,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt64( uint64_t * buffer
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsFloat( float * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -402,6 +476,8 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsFloat( float * buffer, un
 ImportImageFilter::Self& ImportImageFilter::SetBufferAsDouble( double * buffer, unsigned int numberOfComponents )
 {
   this->m_Buffer = buffer;
+  this->m_MemoryMappedFileName.clear();
+  this->m_BufferOwner.reset();
   this->m_NumberOfComponentsPerPixel = numberOfComponents;
   if ( this->m_NumberOfComponentsPerPixel == 1 )
     {
@@ -414,6 +490,129 @@ ImportImageFilter::Self& ImportImageFilter::SetBufferAsDouble( double * buffer,
   return *this;
 }
 
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt8( int8_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsInt8( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt8( uint8_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsUInt8( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt16( int16_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsInt16( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt16( uint16_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsUInt16( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt32( int32_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsInt32( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt32( uint32_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsUInt32( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsInt64( int64_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsInt64( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsUInt64( uint64_t * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsUInt64( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsFloat( float * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsFloat( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetBufferAsDouble( double * buffer, std::function<void(void*)> deleter, unsigned int numberOfComponents )
+{
+  CheckBufferDeleter( deleter );
+  this->SetBufferAsDouble( buffer, numberOfComponents );
+  this->SetBufferOwner( buffer, std::move( deleter ) );
+  return *this;
+}
+
+void ImportImageFilter::CheckBufferDeleter( const std::function<void(void*)> & deleter )
+{
+  if ( !deleter )
+    {
+    sitkExceptionMacro( << "The deleter of the buffer is empty!" );
+    }
+}
+
+void ImportImageFilter::SetBufferOwner( void * buffer, std::function<void(void*)> deleter )
+{
+  this->m_BufferOwner.reset( buffer, std::move( deleter ) );
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetMemoryMappedFile( const std::string &fileName,
+                                                                 PixelIDValueEnum pixelID,
+                                                                 unsigned int numberOfComponents,
+                                                                 uint64_t offset )
+{
+  this->m_Buffer = NULL;
+  this->m_BufferOwner.reset();
+  this->m_MemoryMappedFileName = fileName;
+  this->m_MemoryMappedFileOffset = offset;
+  this->m_NumberOfComponentsPerPixel = numberOfComponents;
+  this->m_PixelIDValue = pixelID;
+  return *this;
+}
+
+const std::string &ImportImageFilter::GetMemoryMappedFile( ) const
+{
+  return this->m_MemoryMappedFileName;
+}
+
+ImportImageFilter::Self& ImportImageFilter::SetCopyOnWrite( bool copyOnWrite )
+{
+  this->m_CopyOnWrite = copyOnWrite;
+  return *this;
+}
+
+bool ImportImageFilter::GetCopyOnWrite( ) const
+{
+  return this->m_CopyOnWrite;
+}
+
 
 #define PRINT_IVAR_MACRO( VAR ) "\t" << #VAR << ": " << VAR << std::endl
 
@@ -428,7 +627,11 @@ std::string ImportImageFilter::ToString() const
       << PRINT_IVAR_MACRO( m_Spacing )
       << PRINT_IVAR_MACRO( m_Size )
       << PRINT_IVAR_MACRO( m_Direction )
-      << PRINT_IVAR_MACRO( m_Buffer );
+      << PRINT_IVAR_MACRO( m_Buffer )
+      << "\tm_BufferOwner: " << ( m_BufferOwner ? "true" : "false" ) << std::endl
+      << PRINT_IVAR_MACRO( m_MemoryMappedFileName )
+      << PRINT_IVAR_MACRO( m_MemoryMappedFileOffset )
+      << PRINT_IVAR_MACRO( m_CopyOnWrite );
   return out.str();
 }
 
@@ -512,10 +715,52 @@ Image ImportImageFilter::ExecuteInternal( )
     numberOfElements *= size[si];
     }
 
+  void *buffer = m_Buffer;
+
+  if ( !this->m_MemoryMappedFileName.empty() )
+    {
+    if ( !IsVector<ImageType>::Value && m_NumberOfComponentsPerPixel != 1 )
+      {
+      sitkExceptionMacro( << "A number of components of " << m_NumberOfComponentsPerPixel
+                          << " requires a vector pixel type!" );
+      }
+    if ( numberOfElements == 0 )
+      {
+      sitkExceptionMacro( << "Unable to memory map an empty image of size " << size
+                          << " with " << m_NumberOfComponentsPerPixel << " components!" );
+      }
+
+    auto mappedFile = std::make_shared<ioutils::MemoryMappedFile>( this->m_MemoryMappedFileName,
+                                                                    this->m_MemoryMappedFileOffset,
+                                                                    numberOfElements * sizeof(typename ImageType::InternalPixelType) );
+    buffer = mappedFile->GetBuffer();
+    if ( reinterpret_cast<uintptr_t>(buffer) % alignof(typename ImageType::InternalPixelType) != 0 )
+      {
+      sitkExceptionMacro( << "The file offset " << this->m_MemoryMappedFileOffset
+                          << " is not aligned to the pixel component type." );
+      }
+
+    // the container owns the mapping
+    using ContainerType = OwnerImportImageContainer<typename ImageType::InternalPixelType>;
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->SetOwner( mappedFile );
+    container->SetCopyOnWrite( this->m_CopyOnWrite );
+    image->SetPixelContainer( container );
+    }
+  else if ( this->m_BufferOwner || this->m_CopyOnWrite )
+    {
+    // the container shares the ownership of the buffer
+    using ContainerType = OwnerImportImageContainer<typename ImageType::InternalPixelType>;
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->SetOwner( this->m_BufferOwner );
+    container->SetCopyOnWrite( this->m_CopyOnWrite );
+    image->SetPixelContainer( container );
+    }
+
   const bool TheContainerWillTakeCareOfDeletingTheMemoryBuffer = false;
 
   // Set the image's pixel container to import the pointer provided.
-  image->GetPixelContainer()->SetImportPointer(static_cast<typename ImageType::InternalPixelType*>(m_Buffer), numberOfElements,
+  image->GetPixelContainer()->SetImportPointer(static_cast<typename ImageType::InternalPixelType*>(buffer), numberOfElements,
                                                TheContainerWillTakeCareOfDeletingTheMemoryBuffer);
 
 
@@ -0,0 +1,150 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkMemoryMappedFile.h"
+#include "sitkExceptionObject.h"
+#include "sitkMacro.h"
+
+#include <cstring>
+#include <cerrno>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace itk {
+namespace simple {
+namespace ioutils {
+
+#if defined(_WIN32)
+
+MemoryMappedFile::MemoryMappedFile( const std::string &fileName, uint64_t offset, size_t length )
+{
+  if ( length == 0 )
+    {
+    sitkExceptionMacro( "Unable to memory map zero bytes of \"" << fileName << "\"." );
+    }
+  HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for memory mapping." );
+    }
+
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx( file, &fileSize ) || static_cast<uint64_t>(fileSize.QuadPart) < offset + length )
+    {
+    CloseHandle( file );
+    sitkExceptionMacro( "The file \"" << fileName << "\" is smaller than the requested offset of "
+                        << offset << " plus " << length << " bytes." );
+    }
+
+  HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+  CloseHandle( file );
+  if ( mapping == nullptr )
+    {
+    sitkExceptionMacro( "Unable to create a file mapping of \"" << fileName << "\"." );
+    }
+
+  SYSTEM_INFO info;
+  GetSystemInfo( &info );
+  const uint64_t alignedOffset = offset - offset % info.dwAllocationGranularity;
+
+  m_MappingLength = static_cast<size_t>( offset - alignedOffset ) + length;
+  m_Mapping = MapViewOfFile( mapping, FILE_MAP_COPY,
+                             static_cast<DWORD>( alignedOffset >> 32 ),
+                             static_cast<DWORD>( alignedOffset & 0xFFFFFFFF ),
+                             m_MappingLength );
+  // the view holds a reference to the mapping object
+  CloseHandle( mapping );
+  if ( m_Mapping == nullptr )
+    {
+    sitkExceptionMacro( "Unable to map " << length << " bytes of \"" << fileName << "\" into memory." );
+    }
+
+  m_Buffer = static_cast<char *>(m_Mapping) + ( offset - alignedOffset );
+  m_Length = length;
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  if ( m_Mapping != nullptr )
+    {
+    UnmapViewOfFile( m_Mapping );
+    }
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile( const std::string &fileName, uint64_t offset, size_t length )
+{
+  if ( length == 0 )
+    {
+    sitkExceptionMacro( "Unable to memory map zero bytes of \"" << fileName << "\"." );
+    }
+  const int fd = open( fileName.c_str(), O_RDONLY );
+  if ( fd == -1 )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for memory mapping: " << std::strerror( errno ) );
+    }
+
+  struct stat fileStat;
+  if ( fstat( fd, &fileStat ) != 0 || static_cast<uint64_t>(fileStat.st_size) < offset + length )
+    {
+    close( fd );
+    sitkExceptionMacro( "The file \"" << fileName << "\" is smaller than the requested offset of "
+                        << offset << " plus " << length << " bytes." );
+    }
+
+  const uint64_t pageSize = static_cast<uint64_t>( sysconf( _SC_PAGESIZE ) );
+  const uint64_t alignedOffset = offset - offset % pageSize;
+
+  m_MappingLength = static_cast<size_t>( offset - alignedOffset ) + length;
+  // a private mapping is writable in memory without modifying the file
+  void * mapping = mmap( nullptr, m_MappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                         fd, static_cast<off_t>( alignedOffset ) );
+  // the mapping holds a reference to the file
+  close( fd );
+  if ( mapping == MAP_FAILED )
+    {
+    sitkExceptionMacro( "Unable to map " << length << " bytes of \"" << fileName << "\" into memory: "
+                        << std::strerror( errno ) );
+    }
+
+  m_Mapping = mapping;
+  m_Buffer = static_cast<char *>(m_Mapping) + ( offset - alignedOffset );
+  m_Length = length;
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  if ( m_Mapping != nullptr )
+    {
+    munmap( m_Mapping, m_MappingLength );
+    }
+}
+
+#endif
+
+}
+}
+}
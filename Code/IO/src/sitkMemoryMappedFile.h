@@ -0,0 +1,59 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkMemoryMappedFile_h
+#define sitkMemoryMappedFile_h
+
+#include "sitkIO.h"
+#include "sitkNonCopyable.h"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace itk {
+namespace simple {
+namespace ioutils {
+
+/* Internal class which maps a region of a file into memory.
+ *
+ * The mapping is private to the process, pages are read from the
+ * page cache on demand and modifications are never written back to
+ * the file. The region is unmapped when the object is destroyed.
+ */
+class SITKIO_HIDDEN MemoryMappedFile
+  : protected NonCopyable
+{
+public:
+  MemoryMappedFile( const std::string &fileName, uint64_t offset, size_t length );
+  ~MemoryMappedFile();
+
+  void *GetBuffer() const { return m_Buffer; }
+  size_t GetLength() const { return m_Length; }
+
+private:
+  void  *m_Mapping{nullptr};
+  size_t m_MappingLength{0};
+  void  *m_Buffer{nullptr};
+  size_t m_Length{0};
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,643 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkRawFileIO.h"
+#include "sitkExceptionObject.h"
+#include "sitkMacro.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace itk {
+namespace simple {
+namespace ioutils {
+
+namespace
+{
+
+// The size of a positioned read, and the number of reads in flight,
+// to reach the sequential bandwidth of solid state storage.
+constexpr uint64_t ChunkSize = 8u << 20;
+constexpr unsigned int MaximumNumberOfReaders = 4;
+
+// The alignment of the buffer, offset and length of a direct read.
+constexpr uint64_t DirectIOAlignment = 4096;
+
+
+std::string Trim( const std::string &s )
+{
+  const auto first = s.find_first_not_of( " \t\r\n" );
+  if ( first == std::string::npos )
+    {
+    return std::string();
+    }
+  const auto last = s.find_last_not_of( " \t\r\n" );
+  return s.substr( first, last - first + 1 );
+}
+
+
+std::string ToLower( std::string s )
+{
+  std::transform( s.begin(), s.end(), s.begin(), [](unsigned char c){ return static_cast<char>( std::tolower(c) ); } );
+  return s;
+}
+
+
+uint64_t FileLength( const std::string &fileName )
+{
+  return itksys::SystemTools::FileExists( fileName, true ) ? itksys::SystemTools::FileLength( fileName ) : 0;
+}
+
+
+bool SystemIsBigEndian()
+{
+  const uint16_t one = 1;
+  return *reinterpret_cast<const unsigned char *>( &one ) == 0;
+}
+
+
+std::string DataFilePath( const std::string &headerFileName, const std::string &dataFile )
+{
+  if ( itksys::SystemTools::FileIsFullPath( dataFile ) )
+    {
+    return dataFile;
+    }
+  return itksys::SystemTools::CollapseFullPath( dataFile, itksys::SystemTools::GetFilenamePath( headerFileName ) );
+}
+
+
+// Read the beginning of the file, where the header is.
+std::string ReadHeader( const std::string &fileName )
+{
+  constexpr size_t MaximumHeaderSize = 1u << 20;
+  std::ifstream in( fileName.c_str(), std::ios::binary );
+  std::string header( MaximumHeaderSize, '\0' );
+  in.read( &header[0], static_cast<std::streamsize>( header.size() ) );
+  header.resize( static_cast<size_t>( in.gcount() ) );
+  return header;
+}
+
+
+bool FindMetaImageData( const std::string &fileName, uint64_t length, std::string &dataFileName, uint64_t &offset )
+{
+  const std::string header = ReadHeader( fileName );
+
+  long long headerSize = 0;
+  size_t pos = 0;
+  while ( pos < header.size() )
+    {
+    size_t end = header.find( '\n', pos );
+    if ( end == std::string::npos )
+      {
+      return false;
+      }
+    const std::string line = header.substr( pos, end - pos );
+    pos = end + 1;
+
+    const size_t equal = line.find( '=' );
+    if ( equal == std::string::npos )
+      {
+      continue;
+      }
+    const std::string key = Trim( line.substr( 0, equal ) );
+    const std::string value = Trim( line.substr( equal + 1 ) );
+
+    if ( key == "CompressedData" && ToLower( value ) == "true" )
+      {
+      return false;
+      }
+    else if ( ( key == "BinaryDataByteOrderMSB" || key == "ElementByteOrderMSB" ) &&
+              ( ToLower( value ) == "true" ) != SystemIsBigEndian() )
+      {
+      return false;
+      }
+    else if ( key == "HeaderSize" )
+      {
+      headerSize = std::atoll( value.c_str() );
+      }
+    else if ( key == "ElementDataFile" )
+      {
+      // ElementDataFile is the last field of the header
+      if ( value == "LOCAL" )
+        {
+        if ( headerSize != 0 )
+          {
+          return false;
+          }
+        dataFileName = fileName;
+        offset = pos;
+        }
+      else if ( value.empty() || value == "LIST" || value.find( '%' ) != std::string::npos )
+        {
+        return false;
+        }
+      else
+        {
+        dataFileName = DataFilePath( fileName, value );
+        const uint64_t dataLength = FileLength( dataFileName );
+        if ( headerSize == -1 )
+          {
+          // the data is at the end of the file
+          if ( dataLength < length )
+            {
+            return false;
+            }
+          offset = dataLength - length;
+          }
+        else if ( headerSize >= 0 )
+          {
+          offset = static_cast<uint64_t>( headerSize );
+          }
+        else
+          {
+          return false;
+          }
+        }
+      return FileLength( dataFileName ) >= offset + length;
+      }
+    }
+  return false;
+}
+
+
+bool FindNrrdData( const std::string &fileName, uint64_t length, std::string &dataFileName, uint64_t &offset )
+{
+  const std::string header = ReadHeader( fileName );
+  if ( header.compare( 0, 4, "NRRD" ) != 0 )
+    {
+    return false;
+    }
+
+  std::string dataFile;
+  bool raw = false;
+  long long byteSkip = 0;
+  size_t pos = 0;
+  bool ended = false;
+  while ( pos < header.size() )
+    {
+    size_t end = header.find( '\n', pos );
+    if ( end == std::string::npos )
+      {
+      end = header.size();
+      }
+    const std::string line = header.substr( pos, end - pos );
+    pos = std::min( end + 1, header.size() );
+
+    if ( Trim( line ).empty() )
+      {
+      ended = true;
+      break;
+      }
+    if ( line[0] == '#' || line.find( ":=" ) != std::string::npos )
+      {
+      continue;
+      }
+    const size_t colon = line.find( ':' );
+    if ( colon == std::string::npos )
+      {
+      continue;
+      }
+    const std::string field = ToLower( Trim( line.substr( 0, colon ) ) );
+    const std::string value = Trim( line.substr( colon + 1 ) );
+
+    if ( field == "encoding" )
+      {
+      raw = ( ToLower( value ) == "raw" );
+      }
+    else if ( field == "endian" && ( ToLower( value ) == "big" ) != SystemIsBigEndian() )
+      {
+      return false;
+      }
+    else if ( field == "data file" || field == "datafile" )
+      {
+      dataFile = value;
+      }
+    else if ( field == "byte skip" || field == "byteskip" )
+      {
+      byteSkip = std::atoll( value.c_str() );
+      }
+    else if ( field == "line skip" || field == "lineskip" )
+      {
+      if ( std::atoll( value.c_str() ) != 0 )
+        {
+        return false;
+        }
+      }
+    }
+
+  if ( !raw )
+    {
+    return false;
+    }
+
+  if ( dataFile.empty() )
+    {
+    // the data is attached after the blank line ending the header
+    if ( !ended || byteSkip < 0 )
+      {
+      return false;
+      }
+    dataFileName = fileName;
+    offset = pos + static_cast<uint64_t>( byteSkip );
+    }
+  else
+    {
+    // a list or a pattern of data files is not a single range
+    if ( dataFile.find( ' ' ) != std::string::npos || dataFile == "LIST" )
+      {
+      return false;
+      }
+    dataFileName = DataFilePath( fileName, dataFile );
+    if ( byteSkip == -1 )
+      {
+      const uint64_t dataLength = FileLength( dataFileName );
+      if ( dataLength < length )
+        {
+        return false;
+        }
+      offset = dataLength - length;
+      }
+    else if ( byteSkip >= 0 )
+      {
+      offset = static_cast<uint64_t>( byteSkip );
+      }
+    else
+      {
+      return false;
+      }
+    }
+  return FileLength( dataFileName ) >= offset + length;
+}
+
+
+struct FreeDeleter
+{
+  void operator()( void *p ) const
+    {
+#if defined(_WIN32)
+      _aligned_free( p );
+#else
+      std::free( p );
+#endif
+    }
+};
+
+
+std::unique_ptr<char, FreeDeleter> AlignedAllocate( size_t size )
+{
+  void *p = nullptr;
+#if defined(_WIN32)
+  p = _aligned_malloc( size, DirectIOAlignment );
+#else
+  if ( posix_memalign( &p, DirectIOAlignment, size ) != 0 )
+    {
+    p = nullptr;
+    }
+#endif
+  if ( p == nullptr )
+    {
+    throw std::bad_alloc();
+    }
+  return std::unique_ptr<char, FreeDeleter>( static_cast<char *>( p ) );
+}
+
+
+#if defined(_WIN32)
+using FileHandle = HANDLE;
+
+// Read up to length bytes at offset until at least required bytes are
+// read, returns the number of bytes read, or -1 with the error code.
+int64_t PositionedRead( FileHandle file, char *buffer, uint64_t length, uint64_t required, uint64_t offset, int &error )
+{
+  uint64_t total = 0;
+  while ( total < required )
+    {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>( ( offset + total ) & 0xFFFFFFFF );
+    overlapped.OffsetHigh = static_cast<DWORD>( ( offset + total ) >> 32 );
+    const DWORD request = static_cast<DWORD>( std::min<uint64_t>( length - total, 1u << 30 ) );
+    DWORD n = 0;
+    if ( !ReadFile( file, buffer + total, request, &n, &overlapped ) )
+      {
+      if ( GetLastError() == ERROR_HANDLE_EOF )
+        {
+        break;
+        }
+      error = static_cast<int>( GetLastError() );
+      return -1;
+      }
+    if ( n == 0 )
+      {
+      break;
+      }
+    total += n;
+    }
+  return static_cast<int64_t>( total );
+}
+#else
+using FileHandle = int;
+
+int64_t PositionedRead( FileHandle fd, char *buffer, uint64_t length, uint64_t required, uint64_t offset, int &error )
+{
+  uint64_t total = 0;
+  while ( total < required )
+    {
+    const size_t request = static_cast<size_t>( std::min<uint64_t>( length - total, 1u << 30 ) );
+    const ssize_t n = pread( fd, buffer + total, request, static_cast<off_t>( offset + total ) );
+    if ( n < 0 )
+      {
+      if ( errno == EINTR )
+        {
+        continue;
+        }
+      error = errno;
+      return -1;
+      }
+    if ( n == 0 )
+      {
+      break;
+      }
+    total += static_cast<uint64_t>( n );
+    }
+  return static_cast<int64_t>( total );
+}
+#endif
+
+
+// Read [offset, offset+length) of an open file into buffer on several
+// threads. Returns zero, or the error code of the first failed read.
+int ReadChunks( FileHandle file, uint64_t offset, uint64_t length, char *buffer, bool directIO )
+{
+  // With direct IO the reads cover the aligned blocks around the range.
+  const uint64_t alignment = directIO ? DirectIOAlignment : 1;
+  const uint64_t begin = offset - offset % alignment;
+  const uint64_t end = offset + length;
+  const uint64_t numberOfChunks = ( end - begin + ChunkSize - 1 ) / ChunkSize;
+
+  // A chunk inside the range is read directly into the buffer when
+  // the buffer has the alignment of the file, otherwise through an
+  // aligned bounce buffer.
+  const bool bufferAligned = !directIO ||
+    ( reinterpret_cast<uintptr_t>( buffer ) - ( offset - begin ) ) % DirectIOAlignment == 0;
+
+  const unsigned int numberOfThreads =
+    static_cast<unsigned int>( std::min<uint64_t>( numberOfChunks, MaximumNumberOfReaders ) );
+
+  std::atomic<uint64_t> nextChunk{0};
+  std::atomic<int> firstError{0};
+
+  auto worker = [&]()
+    {
+      std::unique_ptr<char, FreeDeleter> bounce;
+      uint64_t chunk;
+      while ( firstError == 0 && ( chunk = nextChunk++ ) < numberOfChunks )
+        {
+        const uint64_t chunkBegin = begin + chunk * ChunkSize;
+        const uint64_t chunkEnd = std::min( chunkBegin + ChunkSize, end );
+        const uint64_t required = chunkEnd - chunkBegin;
+
+        int error = 0;
+        int64_t n;
+        if ( bufferAligned && chunkBegin >= offset && required % alignment == 0 )
+          {
+          n = PositionedRead( file, buffer + ( chunkBegin - offset ), required, required, chunkBegin, error );
+          }
+        else
+          {
+          // the read length is rounded up to the alignment, past the
+          // end of the range
+          const uint64_t readLength = ( required + alignment - 1 ) / alignment * alignment;
+          if ( !bounce )
+            {
+            try
+              {
+              bounce = AlignedAllocate( static_cast<size_t>( ChunkSize ) );
+              }
+            catch ( std::bad_alloc & )
+              {
+              int expected = 0;
+              firstError.compare_exchange_strong( expected, ENOMEM );
+              return;
+              }
+            }
+          n = PositionedRead( file, bounce.get(), readLength, required, chunkBegin, error );
+          if ( n >= 0 && static_cast<uint64_t>( n ) >= required )
+            {
+            const uint64_t copyBegin = std::max( chunkBegin, offset );
+            std::memcpy( buffer + ( copyBegin - offset ), bounce.get() + ( copyBegin - chunkBegin ), chunkEnd - copyBegin );
+            }
+          }
+
+        if ( n < 0 )
+          {
+          int expected = 0;
+          firstError.compare_exchange_strong( expected, error );
+          }
+        else if ( static_cast<uint64_t>( n ) < required )
+          {
+          int expected = 0;
+          firstError.compare_exchange_strong( expected, EIO );
+          }
+        }
+    };
+
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 1; t < numberOfThreads; ++t )
+    {
+    threads.emplace_back( worker );
+    }
+  worker();
+  for ( auto &t : threads )
+    {
+    t.join();
+    }
+  return firstError;
+}
+
+}
+
+
+bool FindRawData( const std::string &fileName,
+                  const std::string &imageIOName,
+                  uint64_t length,
+                  std::string &dataFileName,
+                  uint64_t &offset )
+{
+  if ( imageIOName == "MetaImageIO" )
+    {
+    return FindMetaImageData( fileName, length, dataFileName, offset );
+    }
+  if ( imageIOName == "NrrdImageIO" )
+    {
+    return FindNrrdData( fileName, length, dataFileName, offset );
+    }
+  return false;
+}
+
+
+#if defined(_WIN32)
+
+void ReadFileData( const std::string &fileName,
+                   uint64_t offset,
+                   uint64_t length,
+                   void *buffer,
+                   bool,
+                   bool sequentialReadAhead )
+{
+  const DWORD flags = FILE_ATTRIBUTE_NORMAL | ( sequentialReadAhead ? FILE_FLAG_SEQUENTIAL_SCAN : 0 );
+  HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, flags, nullptr );
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for reading." );
+    }
+  const int error = ReadChunks( file, offset, length, static_cast<char *>( buffer ), false );
+  CloseHandle( file );
+  if ( error != 0 )
+    {
+    sitkExceptionMacro( "Unable to read " << length << " bytes at offset " << offset
+                        << " of \"" << fileName << "\", error " << error << "." );
+    }
+}
+
+
+void AdviseSequentialRead( const std::string & )
+{
+}
+
+#else
+
+void ReadFileData( const std::string &fileName,
+                   uint64_t offset,
+                   uint64_t length,
+                   void *buffer,
+                   bool directIO,
+                   bool sequentialReadAhead )
+{
+  int flags = O_RDONLY;
+#if defined(O_DIRECT)
+  if ( directIO )
+    {
+    flags |= O_DIRECT;
+    }
+#endif
+
+  int fd = open( fileName.c_str(), flags );
+  if ( fd == -1 && directIO )
+    {
+    // the file system does not support direct IO
+    directIO = false;
+    fd = open( fileName.c_str(), O_RDONLY );
+    }
+  if ( fd == -1 )
+    {
+    sitkExceptionMacro( "Unable to open \"" << fileName << "\" for reading: " << std::strerror( errno ) );
+    }
+
+#if defined(__APPLE__)
+  if ( directIO && fcntl( fd, F_NOCACHE, 1 ) == -1 )
+    {
+    directIO = false;
+    }
+#endif
+#if !defined(O_DIRECT) && !defined(__APPLE__)
+  directIO = false;
+#endif
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+  if ( sequentialReadAhead )
+    {
+    posix_fadvise( fd, static_cast<off_t>( offset ), static_cast<off_t>( length ), POSIX_FADV_SEQUENTIAL );
+    if ( !directIO )
+      {
+      posix_fadvise( fd, static_cast<off_t>( offset ), static_cast<off_t>( length ), POSIX_FADV_WILLNEED );
+      }
+    }
+#elif defined(__APPLE__)
+  if ( sequentialReadAhead )
+    {
+    fcntl( fd, F_RDAHEAD, 1 );
+    }
+#endif
+
+#if defined(__APPLE__)
+  // F_NOCACHE has no alignment requirement
+  int error = ReadChunks( fd, offset, length, static_cast<char *>( buffer ), false );
+#else
+  int error = ReadChunks( fd, offset, length, static_cast<char *>( buffer ), directIO );
+  if ( error == EINVAL && directIO )
+    {
+    // the alignment of direct IO is larger than expected, or the
+    // file system rejects it, so read buffered
+    close( fd );
+    fd = open( fileName.c_str(), O_RDONLY );
+    if ( fd == -1 )
+      {
+      sitkExceptionMacro( "Unable to open \"" << fileName << "\" for reading: " << std::strerror( errno ) );
+      }
+    error = ReadChunks( fd, offset, length, static_cast<char *>( buffer ), false );
+    }
+#endif
+  close( fd );
+
+  if ( error != 0 )
+    {
+    sitkExceptionMacro( "Unable to read " << length << " bytes at offset " << offset
+                        << " of \"" << fileName << "\": " << std::strerror( error ) );
+    }
+}
+
+
+void AdviseSequentialRead( const std::string &fileName )
+{
+#if defined(POSIX_FADV_SEQUENTIAL)
+  const int fd = open( fileName.c_str(), O_RDONLY );
+  if ( fd != -1 )
+    {
+    posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+    posix_fadvise( fd, 0, 0, POSIX_FADV_WILLNEED );
+    close( fd );
+    }
+#else
+  (void)fileName;
+#endif
+}
+
+#endif
+
+}
+}
+}
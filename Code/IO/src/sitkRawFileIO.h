@@ -0,0 +1,73 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkRawFileIO_h
+#define sitkRawFileIO_h
+
+#include "sitkIO.h"
+
+#include <string>
+#include <cstdint>
+
+namespace itk {
+namespace simple {
+namespace ioutils {
+
+/* Internal method which locates the uncompressed pixel data of a
+ * MetaImage or NRRD file, as named by imageIOName. The header of
+ * fileName is parsed for the file holding the data and the offset of
+ * the data in it, which may be the header file itself. Returns false
+ * when the data is compressed, split over several files, is not at a
+ * fixed offset, or the data file is smaller than length bytes.
+ */
+SITKIO_HIDDEN bool FindRawData( const std::string &fileName,
+                                const std::string &imageIOName,
+                                uint64_t length,
+                                std::string &dataFileName,
+                                uint64_t &offset );
+
+/* Internal method which reads length bytes at offset of a file into
+ * buffer with positioned reads on several threads, large enough to
+ * keep the storage device busy.
+ *
+ * With directIO the page cache is bypassed, with O_DIRECT on Linux
+ * and F_NOCACHE on macOS. The aligned blocks are read directly into
+ * buffer when its alignment matches the offset, otherwise through an
+ * aligned bounce buffer. When the file system does not support
+ * direct IO the file is read buffered. With sequentialReadAhead the
+ * kernel is advised that the range is read sequentially and will be
+ * needed, enlarging the read-ahead. On Windows directIO is not
+ * supported and the file is opened for sequential scan.
+ */
+SITKIO_HIDDEN void ReadFileData( const std::string &fileName,
+                                 uint64_t offset,
+                                 uint64_t length,
+                                 void *buffer,
+                                 bool directIO,
+                                 bool sequentialReadAhead );
+
+/* Internal method which advises the kernel that a whole file is read
+ * sequentially and soon, so it is read ahead into the page cache.
+ * Failures are ignored.
+ */
+SITKIO_HIDDEN void AdviseSequentialRead( const std::string &fileName );
+
+}
+}
+}
+
+#endif
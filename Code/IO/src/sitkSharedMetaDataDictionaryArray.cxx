@@ -0,0 +1,213 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkSharedMetaDataDictionaryArray.h"
+#include "sitkMacro.h"
+
+#include "sitkMetaDataDictionaryCustomCast.hxx"
+
+#include <algorithm>
+
+namespace itk {
+namespace simple {
+namespace ioutils {
+
+namespace
+{
+bool KeyLess( const std::string *a, const std::string *b )
+{
+  return *a < *b;
+}
+}
+
+
+SharedMetaDataDictionaryArray::SharedMetaDataDictionaryArray( size_t numberOfSlices )
+  : m_Slices( numberOfSlices )
+{
+}
+
+
+const std::string *SharedMetaDataDictionaryArray::Intern( std::string s )
+{
+  // the elements of an unordered_set are not moved by a rehash
+  return &*m_Strings.insert( std::move(s) ).first;
+}
+
+
+void SharedMetaDataDictionaryArray::SetDictionary( size_t slice, const MetaDataDictionary &dictionary )
+{
+  // convert the values outside of the lock
+  const std::vector<std::string> keys = dictionary.GetKeys();
+  std::vector<std::string> values;
+  values.reserve( keys.size() );
+  for ( const std::string &key : keys )
+    {
+    values.push_back( GetMetaDataDictionaryCustomCast::CustomCast( &dictionary, key ) );
+    }
+
+  EntryArray entries;
+  entries.reserve( keys.size() );
+  {
+  std::lock_guard<std::mutex> lock( m_Mutex );
+  for ( size_t i = 0; i < keys.size(); ++i )
+    {
+    entries.push_back( Entry{ this->Intern( keys[i] ), this->Intern( std::move( values[i] ) ) } );
+    }
+  }
+
+  // GetKeys of the dictionary's map is sorted, which is kept
+  std::sort( entries.begin(), entries.end(),
+             []( const Entry &a, const Entry &b ) { return KeyLess( a.key, b.key ); } );
+  m_Slices.at( slice ) = std::move( entries );
+}
+
+
+void SharedMetaDataDictionaryArray::Finalize()
+{
+  if ( m_Slices.size() < 2 )
+    {
+    return;
+    }
+
+  // The entries of the first slice which, with interned strings,
+  // are the same key and value pointers in all the other slices.
+  EntryArray common = m_Slices[0];
+  for ( size_t s = 1; s < m_Slices.size() && !common.empty(); ++s )
+    {
+    const EntryArray &entries = m_Slices[s];
+    EntryArray intersection;
+    auto a = common.cbegin();
+    auto b = entries.cbegin();
+    while ( a != common.cend() && b != entries.cend() )
+      {
+      if ( KeyLess( a->key, b->key ) )
+        {
+        ++a;
+        }
+      else if ( KeyLess( b->key, a->key ) )
+        {
+        ++b;
+        }
+      else
+        {
+        if ( a->value == b->value )
+          {
+          intersection.push_back( *a );
+          }
+        ++a;
+        ++b;
+        }
+      }
+    common.swap( intersection );
+    }
+
+  for ( EntryArray &entries : m_Slices )
+    {
+    EntryArray delta;
+    auto c = common.cbegin();
+    for ( const Entry &e : entries )
+      {
+      while ( c != common.cend() && KeyLess( c->key, e.key ) )
+        {
+        ++c;
+        }
+      if ( c == common.cend() || c->key != e.key )
+        {
+        delta.push_back( e );
+        }
+      }
+    delta.shrink_to_fit();
+    entries.swap( delta );
+    }
+
+  common.shrink_to_fit();
+  m_Common.swap( common );
+}
+
+
+const SharedMetaDataDictionaryArray::EntryArray &SharedMetaDataDictionaryArray::GetSlice( size_t slice ) const
+{
+  if ( slice >= m_Slices.size() )
+    {
+    sitkExceptionMacro( "The slice " << slice << " is out of range, the series has "
+                        << m_Slices.size() << " slices." );
+    }
+  return m_Slices[slice];
+}
+
+
+const SharedMetaDataDictionaryArray::Entry *
+SharedMetaDataDictionaryArray::Find( const EntryArray &entries, const std::string &key )
+{
+  auto iter = std::lower_bound( entries.cbegin(), entries.cend(), key,
+                                []( const Entry &e, const std::string &k ) { return *e.key < k; } );
+  if ( iter != entries.cend() && *iter->key == key )
+    {
+    return &*iter;
+    }
+  return nullptr;
+}
+
+
+std::vector<std::string> SharedMetaDataDictionaryArray::GetKeys( size_t slice ) const
+{
+  const EntryArray &entries = this->GetSlice( slice );
+
+  std::vector<std::string> keys;
+  keys.reserve( m_Common.size() + entries.size() );
+  auto a = m_Common.cbegin();
+  auto b = entries.cbegin();
+  while ( a != m_Common.cend() || b != entries.cend() )
+    {
+    if ( b == entries.cend() || ( a != m_Common.cend() && KeyLess( a->key, b->key ) ) )
+      {
+      keys.push_back( *(a++)->key );
+      }
+    else
+      {
+      keys.push_back( *(b++)->key );
+      }
+    }
+  return keys;
+}
+
+
+bool SharedMetaDataDictionaryArray::HasKey( size_t slice, const std::string &key ) const
+{
+  const EntryArray &entries = this->GetSlice( slice );
+  return Find( entries, key ) != nullptr || Find( m_Common, key ) != nullptr;
+}
+
+
+std::string SharedMetaDataDictionaryArray::Get( size_t slice, const std::string &key ) const
+{
+  const EntryArray &entries = this->GetSlice( slice );
+  const Entry *e = Find( entries, key );
+  if ( e == nullptr )
+    {
+    e = Find( m_Common, key );
+    }
+  if ( e == nullptr )
+    {
+    sitkExceptionMacro( "The meta-data key \"" << key << "\" is not in the dictionary of slice " << slice << "." );
+    }
+  return *e->value;
+}
+
+}
+}
+}
@@ -0,0 +1,96 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkSharedMetaDataDictionaryArray_h
+#define sitkSharedMetaDataDictionaryArray_h
+
+#include "sitkIO.h"
+#include "sitkNonCopyable.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace itk {
+
+class MetaDataDictionary;
+
+namespace simple {
+namespace ioutils {
+
+/* Internal class which stores the meta-data dictionaries of the
+ * slices of a series compactly.
+ *
+ * The values are kept as the strings returned by
+ * ImageSeriesReader::GetMetaData, and the keys and values are
+ * interned so a string repeated across the slices is stored once.
+ * After Finalize, the entries with the same value in all the slices
+ * are stored once and each slice only keeps the entries which
+ * differ, such as the instance number and position.
+ *
+ * SetDictionary may be called concurrently for different slices.
+ * The query methods are valid after Finalize.
+ */
+class SITKIO_HIDDEN SharedMetaDataDictionaryArray
+  : protected NonCopyable
+{
+public:
+  explicit SharedMetaDataDictionaryArray( size_t numberOfSlices );
+
+  void SetDictionary( size_t slice, const MetaDataDictionary &dictionary );
+
+  void Finalize();
+
+  size_t GetNumberOfSlices() const { return m_Slices.size(); }
+
+  /* The number of entries stored once for all the slices. */
+  size_t GetNumberOfCommonEntries() const { return m_Common.size(); }
+
+  std::vector<std::string> GetKeys( size_t slice ) const;
+  bool HasKey( size_t slice, const std::string &key ) const;
+  std::string Get( size_t slice, const std::string &key ) const;
+
+private:
+
+  struct Entry
+  {
+    const std::string *key;
+    const std::string *value;
+  };
+
+  using EntryArray = std::vector<Entry>;
+
+  const std::string *Intern( std::string s );
+
+  const EntryArray &GetSlice( size_t slice ) const;
+
+  static const Entry *Find( const EntryArray &entries, const std::string &key );
+
+  std::mutex m_Mutex;
+  std::unordered_set<std::string> m_Strings;
+
+  // both sorted by key
+  EntryArray m_Common;
+  std::vector<EntryArray> m_Slices;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkStreamingResample.h"
+#include "sitkResampleImageFilter.h"
+#include "sitkTemplateFunctions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace
+{
+
+// The number of pixels around the pre-image of a slab read for the
+// support of the interpolator.
+int GetInterpolatorMargin( InterpolatorEnum interpolator )
+{
+  switch ( interpolator )
+    {
+    case sitkNearestNeighbor:
+    case sitkLinear:
+      return 1;
+    case sitkGaussian:
+    case sitkLabelGaussian:
+      return 4;
+    case sitkHammingWindowedSinc:
+    case sitkCosineWindowedSinc:
+    case sitkWelchWindowedSinc:
+    case sitkLanczosWindowedSinc:
+    case sitkBlackmanWindowedSinc:
+      return 6;
+    default:
+      // the BSpline interpolators depend on the whole image, the
+      // margin limits the error near the boundary of the region
+      return 8;
+    }
+}
+
+// The number of points per axis sampled to estimate the pre-image of
+// a slab for transforms which are not linear.
+constexpr unsigned int NumberOfSamplesPerAxis = 17;
+
+}
+
+
+void StreamingResample( ImageFileReader &reader,
+                        ImageFileWriter &writer,
+                        const std::vector<uint32_t> &size,
+                        const Transform &transform,
+                        InterpolatorEnum interpolator,
+                        const std::vector<double> &outputOrigin,
+                        const std::vector<double> &outputSpacing,
+                        const std::vector<double> &outputDirection,
+                        double defaultPixelValue,
+                        PixelIDValueEnum outputPixelType,
+                        unsigned int slabThickness )
+{
+  if ( slabThickness == 0 )
+    {
+    sitkExceptionMacro( "The slab thickness must be greater than zero!" );
+    }
+
+  reader.Open();
+
+  const unsigned int dimension = reader.GetDimension();
+  if ( size.size() != dimension )
+    {
+    sitkExceptionMacro( "The output size has " << size.size() << " elements, but the image has dimension "
+                        << dimension << "!" );
+    }
+  if ( outputOrigin.size() < dimension || outputSpacing.size() < dimension )
+    {
+    sitkExceptionMacro( "The output origin and spacing must have at least " << dimension << " elements!" );
+    }
+
+  // Images of one pixel with the geometry of the input and the output,
+  // for the conversions between the indices and the points.
+  Image inputGeometry( std::vector<unsigned int>( dimension, 1u ), sitkUInt8 );
+  inputGeometry.SetOrigin( reader.GetOrigin() );
+  inputGeometry.SetSpacing( reader.GetSpacing() );
+  inputGeometry.SetDirection( reader.GetDirection() );
+
+  Image outputGeometry( std::vector<unsigned int>( dimension, 1u ), sitkUInt8 );
+  outputGeometry.SetOrigin( std::vector<double>( outputOrigin.begin(), outputOrigin.begin() + dimension ) );
+  outputGeometry.SetSpacing( std::vector<double>( outputSpacing.begin(), outputSpacing.begin() + dimension ) );
+  if ( !outputDirection.empty() )
+    {
+    outputGeometry.SetDirection( outputDirection );
+    }
+
+  const std::vector<uint64_t> inputSize = reader.GetSize();
+  const unsigned int samplesPerAxis = transform.IsLinear() ? 2 : NumberOfSamplesPerAxis;
+  const int margin = GetInterpolatorMargin( interpolator );
+
+  ResampleImageFilter resampler;
+  resampler.SetTransform( transform );
+  resampler.SetInterpolator( interpolator );
+  resampler.SetOutputSpacing( outputGeometry.GetSpacing() );
+  resampler.SetOutputDirection( outputGeometry.GetDirection() );
+  resampler.SetDefaultPixelValue( defaultPixelValue );
+  resampler.SetOutputPixelType( outputPixelType );
+
+  writer.Open( size );
+  auto closeWriter = make_scope_exit( [&writer] { writer.Close(); } );
+
+  const unsigned int lastAxis = dimension - 1;
+  for ( uint32_t start = 0; start < size[lastAxis]; start += slabThickness )
+    {
+    std::vector<uint32_t> slabSize( size );
+    slabSize[lastAxis] = std::min( slabThickness, size[lastAxis] - start );
+    std::vector<unsigned int> slabIndex( dimension, 0u );
+    slabIndex[lastAxis] = start;
+
+    // the bounding box of the transformed points of a lattice of the
+    // slab, in continuous indices of the input
+    std::vector<double> lower( dimension, std::numeric_limits<double>::infinity() );
+    std::vector<double> upper( dimension, -std::numeric_limits<double>::infinity() );
+
+    std::vector<unsigned int> sample( dimension, 0u );
+    std::vector<double> outputIndex( dimension );
+    bool done = false;
+    while ( !done )
+      {
+      for ( unsigned int d = 0; d < dimension; ++d )
+        {
+        const unsigned int n = std::min<unsigned int>( samplesPerAxis, slabSize[d] );
+        const double step = ( n > 1 ) ? double( slabSize[d] - 1 ) / double( n - 1 ) : 0.0;
+        outputIndex[d] = slabIndex[d] + sample[d] * step;
+        }
+      const std::vector<double> point = transform.TransformPoint( outputGeometry.TransformContinuousIndexToPhysicalPoint( outputIndex ) );
+      const std::vector<double> inputIndex = inputGeometry.TransformPhysicalPointToContinuousIndex( point );
+      for ( unsigned int d = 0; d < dimension; ++d )
+        {
+        if ( std::isfinite( inputIndex[d] ) )
+          {
+          lower[d] = std::min( lower[d], inputIndex[d] );
+          upper[d] = std::max( upper[d], inputIndex[d] );
+          }
+        else
+          {
+          lower[d] = -std::numeric_limits<double>::infinity();
+          upper[d] = std::numeric_limits<double>::infinity();
+          }
+        }
+
+      done = true;
+      for ( unsigned int d = 0; d < dimension; ++d )
+        {
+        if ( ++sample[d] < std::min<unsigned int>( samplesPerAxis, slabSize[d] ) )
+          {
+          done = false;
+          break;
+          }
+        sample[d] = 0;
+        }
+      }
+
+    // The region read is clipped to the image, a slab mapped outside
+    // of the image reads a minimal region and has the default value.
+    std::vector<int> regionIndex( dimension );
+    std::vector<unsigned int> regionSize( dimension );
+    for ( unsigned int d = 0; d < dimension; ++d )
+      {
+      const double maximumIndex = double( inputSize[d] ) - 1.0;
+      const double first = std::max( std::floor( lower[d] ) - margin, 0.0 );
+      const double last = std::min( std::ceil( upper[d] ) + margin, maximumIndex );
+      if ( first <= last )
+        {
+        regionIndex[d] = static_cast<int>( first );
+        regionSize[d] = static_cast<unsigned int>( last - first ) + 1u;
+        }
+      else
+        {
+        regionIndex[d] = 0;
+        regionSize[d] = static_cast<unsigned int>( std::min( inputSize[d], uint64_t( 2 ) ) );
+        }
+      }
+
+    const Image region = reader.ReadRegion( regionIndex, regionSize );
+
+    resampler.SetSize( slabSize );
+    resampler.SetOutputOrigin( outputGeometry.TransformIndexToPhysicalPoint( std::vector<int64_t>( slabIndex.begin(), slabIndex.end() ) ) );
+    writer.WriteRegion( resampler.Execute( region ), slabIndex );
+    }
+}
+
+}
+}
@@ -0,0 +1,99 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageRegistrationLevelProfile_h
+#define sitkImageRegistrationLevelProfile_h
+
+#include "sitkRegistration.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+  namespace detail { class RegistrationProfiler; }
+
+  /** \brief The time spent in one level of a registration.
+   *
+   * The profile of each level of an execution of
+   * ImageRegistrationMethod with profiling enabled. The times are
+   * wall clock times in seconds.
+   *
+   * \sa ImageRegistrationMethod::GetProfile
+   */
+  class SITKRegistration_EXPORT ImageRegistrationLevelProfile
+  {
+  public:
+    ImageRegistrationLevelProfile();
+
+    /** The level of the multi-resolution registration. */
+    unsigned int GetLevel() const;
+
+    /** The time to initialize the level: smoothing the fixed and
+     * moving images, sampling the metric, and initializing the
+     * metric, including the computation of the gradient images. */
+    double GetInitializationTime() const;
+
+    /** The time to select the sample points of the metric, included
+     * in the initialization time. */
+    double GetSamplingTime() const;
+
+    /** The time of the optimizer before its first iteration, which is
+     * mostly the estimation of the scales and of the learning
+     * rate. It is zero for the optimizers not reporting the start of
+     * the iterations. */
+    double GetScalesEstimationTime() const;
+
+    /** The total time of the optimizer for the level. */
+    double GetOptimizationTime() const;
+
+    /** The number of iterations of the optimizer. */
+    unsigned int GetNumberOfIterations() const;
+
+    /** The time of each iteration, the evaluation of the metric value
+     * and derivative and the step of the optimizer. */
+    std::vector<double> GetIterationTimes() const;
+
+    /** The metric value at each iteration. */
+    std::vector<double> GetMetricValues() const;
+
+    /** The number of valid points of the metric at the last
+     * iteration. */
+    uint64_t GetMetricNumberOfValidPoints() const;
+
+    std::string ToString() const;
+
+  private:
+    friend class detail::RegistrationProfiler;
+
+    unsigned int m_Level;
+    double m_InitializationTime;
+    double m_SamplingTime;
+    double m_ScalesEstimationTime;
+    double m_OptimizationTime;
+    std::vector<double> m_IterationTimes;
+    std::vector<double> m_MetricValues;
+    uint64_t m_MetricNumberOfValidPoints;
+  };
+
+}
+}
+
+#endif // sitkImageRegistrationLevelProfile_h
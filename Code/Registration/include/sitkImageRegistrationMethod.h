@@ -29,6 +29,9 @@
 #include "sitkRandomSeed.h"
 #include "sitkInterpolator.h"
 #include "sitkTransform.h"
+#include "sitkImageRegistrationMetricEvaluator.h"
+#include "sitkImageRegistrationLevelProfile.h"
+#include "sitkImageRegistrationState.h"
 
 
 namespace itk
@@ -52,6 +55,8 @@ class DefaultImageToImageMetricTraitsv4;
 template<typename TMetric> class RegistrationParameterScalesEstimator;
 
 template<unsigned int VDimension> class SpatialObject;
+template<unsigned int VDimension> class ImageBase;
+template<unsigned int VDimension> class ImageRegion;
 
 class Command;
 class EventObject;
@@ -63,6 +68,8 @@ namespace simple
 {
   class BSplineTransform;
 
+  namespace detail { class PyramidCache; }
+
   /** \brief An interface method to the modular ITKv4 registration framework.
    *
    * This interface method class encapsulates typical registration
@@ -131,6 +138,11 @@ namespace simple
      * will be the same object used during registration, and will have
      * a modified value upon completion.
      *
+     * When not in place, the result of Execute is a composite of the
+     * optimized transform, except for a DisplacementFieldTransform
+     * which is returned without a composite, its field shared instead
+     * of copied.
+     *
      * \sa itk::ImageRegistrationMethodv4::SetInitialTransform
      * @{
      */
@@ -247,6 +259,12 @@ namespace simple
     /** \brief Use the mutual information between two images to be
      * registered using the method of Mattes et al.
      *
+     * The derivatives of the joint PDF are computed explicitly for the
+     * linear transforms and the transforms with few parameters,
+     * otherwise they are accumulated per sample, which is faster and
+     * uses less memory for the BSpline and displacement field
+     * transforms.
+     *
      * \sa itk::MattesMutualInformationImageToImageMetricv4
      */
     SITK_RETURN_SELF_TYPE_HEADER SetMetricAsMattesMutualInformation( unsigned int numberOfHistogramBins = 50 );
@@ -392,6 +410,33 @@ namespace simple
     std::vector<double> GetOptimizerWeights( ) const;
     /**@}*/
 
+    /** \brief Set a stopping policy used in addition to the
+     * convergence criteria of the optimizer.
+     *
+     * The policy is independent of the optimizer type. It is
+     * evaluated at each iteration and stops the optimization of the
+     * current level when:
+     *
+     * - the relative range of the metric values of the last
+     *   windowSize iterations of the level, ( max - min ) / |mean|,
+     *   is not greater than relativeMetricTolerance;
+     * - the optimization of the level has taken longer than
+     *   maximumSecondsPerLevel seconds;
+     * - the total number of iterations of all the levels has reached
+     *   maximumNumberOfIterations, then the following levels are
+     *   stopped after their first iteration.
+     *
+     * A value of zero disables a criterion, all are disabled by
+     * default. The reason of the stop is reported by
+     * GetOptimizerStopConditionDescription. The policy is not applied
+     * to the optimizers which do not support user stopping, see
+     * StopRegistration.
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetOptimizerStoppingPolicy( double relativeMetricTolerance,
+                                                             unsigned int windowSize = 10,
+                                                             double maximumSecondsPerLevel = 0.0,
+                                                             unsigned int maximumNumberOfIterations = 0 );
+
     /** \brief Powell optimization using Brent line search.
      *
      * \sa itk::PowellOptimizerv4
@@ -447,6 +492,40 @@ namespace simple
     SITK_RETURN_SELF_TYPE_HEADER SetOptimizerScalesFromPhysicalShift( unsigned int centralRegionRadius = 5,
                                               double smallParameterVariation =  0.01 );
 
+    /** \brief Compute the scales of the transform parameters from the
+     * extent of the fixed image.
+     *
+     * The scale of each parameter is the mean squared norm of the
+     * Jacobian of the transform with respect to the parameter, at the
+     * corners of the physical domain of the fixed image. It is computed
+     * once before the registration without sampling the metric, and
+     * is a cheaper alternative to SetOptimizerScalesFromJacobian for
+     * the linear transforms such as the Euler, Similarity, Versor and
+     * Affine transforms. An exception is thrown on execution with a
+     * transform of another category.
+     *
+     * As with manual scales, the learning rate of the optimizer is not
+     * estimated.
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetOptimizerScalesFromImageExtent();
+
+    /** \brief Estimate the scales of the transform parameters only once,
+     * on the first level.
+     *
+     * By default the scales estimator is run at the start of the
+     * optimization of each level, which with BSpline and displacement
+     * field transforms can cost as much as several iterations. When
+     * enabled, the scales estimated on a level are reused by the
+     * following levels, unless the number of local parameters of the
+     * transform changes between them.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetOptimizerScalesReuseAcrossLevels( bool reuse );
+    bool GetOptimizerScalesReuseAcrossLevels() const;
+    SITK_RETURN_SELF_TYPE_HEADER OptimizerScalesReuseAcrossLevelsOn() { return this->SetOptimizerScalesReuseAcrossLevels(true); }
+    SITK_RETURN_SELF_TYPE_HEADER OptimizerScalesReuseAcrossLevelsOff() { return this->SetOptimizerScalesReuseAcrossLevels(false); }
+    /** @} */
+
 
     /** \brief Set an image mask in order to restrict the sampled points
      * for the metric.
@@ -470,6 +549,60 @@ namespace simple
      */
     SITK_RETURN_SELF_TYPE_HEADER SetMetricMovingMask( const Image &binaryMask );
 
+    /** \brief Restrict the metric to the bounding box of the fixed
+     * mask.
+     *
+     * When enabled and a fixed mask is set, the virtual domain, the
+     * fixed image or the domain set with SetVirtualDomain, is cropped
+     * to the bounding box of the non-zero pixels of the mask, and is
+     * shrunk from there for each level. Without sampling, the sampled
+     * points of each level are then the points of the cropped domain
+     * inside the mask, computed once per level, so that the time of
+     * an iteration depends on the size of the mask instead of the
+     * size of the image. The sampling percentages are of the cropped
+     * domain.
+     *
+     * The domain is only cropped when the transform to optimize is
+     * linear, as the domain of a transform with local support, such
+     * as a displacement field or a BSpline, must match the virtual
+     * domain, and it is not cropped when a fixed initial transform is
+     * set.
+     *
+     * By default this is off, the domain is not cropped.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetMetricUseFixedMaskBoundingBox( bool useFixedMaskBoundingBox );
+    bool GetMetricUseFixedMaskBoundingBox() const;
+    SITK_RETURN_SELF_TYPE_HEADER MetricUseFixedMaskBoundingBoxOn() { return this->SetMetricUseFixedMaskBoundingBox(true); }
+    SITK_RETURN_SELF_TYPE_HEADER MetricUseFixedMaskBoundingBoxOff() { return this->SetMetricUseFixedMaskBoundingBox(false); }
+    /** @} */
+
+    /** \brief Make the metric values independent of the number of threads.
+     *
+     * The ITKv4 metrics split the sampled points into work units, and
+     * sum the partial values and derivatives of the work units in
+     * their order. The number of work units follows the number of
+     * threads by default, so that the rounding of the sums, and from
+     * there the result of the registration, changes with
+     * SetNumberOfThreads.
+     *
+     * When enabled, the points are split into a fixed number of work
+     * units, the one set with SetNumberOfWorkUnits or else 64, however
+     * many threads execute them. The registration, with a fixed
+     * sampling seed, and the metric evaluations are then bit for bit
+     * reproducible between executions with a different number of
+     * threads, including the concurrent registrations of ExecuteBatch
+     * and ExecuteMultiStart.
+     *
+     * By default the number of work units follows the threads.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetMetricUseDeterministicReduction( bool useDeterministicReduction );
+    bool GetMetricUseDeterministicReduction() const;
+    SITK_RETURN_SELF_TYPE_HEADER MetricUseDeterministicReductionOn() { return this->SetMetricUseDeterministicReduction(true); }
+    SITK_RETURN_SELF_TYPE_HEADER MetricUseDeterministicReductionOff() { return this->SetMetricUseDeterministicReduction(false); }
+    /** @} */
+
     /** \brief Set percentage of pixels sampled for metric evaluation.
      *
      * The percentage is of the number of pixels in the virtual domain
@@ -504,11 +637,28 @@ namespace simple
      * - RANDOM: sample image voxels with replacement using a uniform
      *           distribution, then within each voxel randomly perturb
      *           from center.
+     * - STRATIFIED: divide the image into cells of about 1/percentage
+     *           voxels, then uniformly sample a point in each cell.
+     * - HALTON: the points of a Halton sequence over the image,
+     *           randomly shifted.
+     * - SOBOL: the points of a Sobol sequence over the image, randomly
+     *           shifted.
+     * - GRADIENT_WEIGHTED: sample voxels without replacement with a
+     *           probability proportional to the gradient magnitude of
+     *           the fixed image at the scale of the level, then within
+     *           each voxel randomly perturb from center.
+     *
+     * The points of the random strategies are reproducible for a seed
+     * other than sitkWallClock.
      */
     enum MetricSamplingStrategyType {
       NONE,
       REGULAR,
-      RANDOM
+      RANDOM,
+      STRATIFIED,
+      HALTON,
+      SOBOL,
+      GRADIENT_WEIGHTED
     };
 
     /** \brief Set sampling strategy for sample generation.
@@ -578,10 +728,216 @@ namespace simple
     SITK_RETURN_SELF_TYPE_HEADER SmoothingSigmasAreSpecifiedInPhysicalUnitsOff()  { this->SetSmoothingSigmasAreSpecifiedInPhysicalUnits(false); return *this;}
     /** @} */
 
+    /** \brief Enable caching of the smoothed images of the levels
+     * between executions.
+     *
+     * The fixed and the moving images are smoothed for each level on
+     * every execution. When enabled, the smoothed images are kept
+     * and reused by the following executions with the same input
+     * images, geometry and smoothing sigmas, which is useful for
+     * parameter sweeps and for multiple starts from different
+     * initial transforms. Only the smoothed images of the inputs of
+     * the last execution are kept.
+     *
+     * The cache keeps a reference to the input images. Modifying an
+     * input image in place after an execution makes a copy of its
+     * buffer, which is then smoothed again.
+     *
+     * By default the cache is disabled. Disabling it releases the
+     * cached images.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetUsePyramidCache( bool usePyramidCache );
+    bool GetUsePyramidCache() const;
+    SITK_RETURN_SELF_TYPE_HEADER UsePyramidCacheOn() { return this->SetUsePyramidCache(true); }
+    SITK_RETURN_SELF_TYPE_HEADER UsePyramidCacheOff() { return this->SetUsePyramidCache(false); }
+    /** @} */
+
+    /** \brief Also cache the gradient images of the levels in the
+     * pyramid cache.
+     *
+     * When the metric uses the gradient filters, see
+     * SetMetricUseFixedImageGradientFilter and
+     * SetMetricUseMovingImageGradientFilter, the gradient images of
+     * the smoothed fixed and moving images are computed on each level
+     * of every execution. When enabled with the pyramid cache, they
+     * are computed once and shared by the following executions, by
+     * the registrations of ExecuteBatch and by the starts of
+     * ExecuteMultiStart. This trades memory, a vector of doubles per
+     * pixel of each level, for speed.
+     *
+     * By default the gradients are not cached.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetPyramidCacheImageGradients( bool pyramidCacheImageGradients );
+    bool GetPyramidCacheImageGradients() const;
+    SITK_RETURN_SELF_TYPE_HEADER PyramidCacheImageGradientsOn() { return this->SetPyramidCacheImageGradients(true); }
+    SITK_RETURN_SELF_TYPE_HEADER PyramidCacheImageGradientsOff() { return this->SetPyramidCacheImageGradients(false); }
+    /** @} */
+
+    /** \brief Release the smoothed images and gradients in the
+     * pyramid cache. */
+    void ClearPyramidCache();
+
+    /** \brief Enable the profiling of Execute.
+     *
+     * When enabled, each execution records the time spent in each
+     * level of the registration, see GetProfile. The overhead is a
+     * few clock readings per iteration.
+     *
+     * By default the registration is not profiled.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetProfiling( bool profiling );
+    bool GetProfiling() const;
+    SITK_RETURN_SELF_TYPE_HEADER ProfilingOn() { return this->SetProfiling(true); }
+    SITK_RETURN_SELF_TYPE_HEADER ProfilingOff() { return this->SetProfiling(false); }
+    /** @} */
+
+    /** \brief Register sitkFloat64 images as sitkFloat32 images.
+     *
+     * When enabled, the fixed and moving images of pixel type
+     * sitkFloat64 are cast to sitkFloat32 before the registration, so
+     * that the pyramid, the virtual domain and the interpolation of
+     * the moving image use half of the memory and of the memory
+     * bandwidth. The metric value, the derivative and the transform
+     * parameters are still computed with doubles.
+     *
+     * The images are cast by each execution, so the pyramid cache is
+     * only shared by the registrations of one ExecuteBatch or
+     * ExecuteMultiStart. Images of sitkFloat32 pixel type are not
+     * copied, and may be passed directly instead.
+     *
+     * By default the images are registered with their pixel type.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetUseSinglePrecision( bool useSinglePrecision );
+    bool GetUseSinglePrecision() const;
+    SITK_RETURN_SELF_TYPE_HEADER UseSinglePrecisionOn() { return this->SetUseSinglePrecision(true); }
+    SITK_RETURN_SELF_TYPE_HEADER UseSinglePrecisionOff() { return this->SetUseSinglePrecision(false); }
+    /** @} */
+
+
+    /** \brief Start Execute from the state of a previous execution.
+     *
+     * For the registration of the consecutive images of a series,
+     * the optimization starts from the transform parameters of the
+     * state, GetRegistrationState of the previous Execute, instead of
+     * the parameters of the initial transform, which must be of the
+     * same type. The scales of the state are used as manual scales
+     * without running the scales estimator, and the learning rate of
+     * the state is used without estimation.
+     *
+     * When the metric at the parameters of the state, as computed by
+     * MetricEvaluate, is within relativeMetricTolerance of the metric
+     * value of the state, the images barely moved: the levels
+     * coarser than the level of the state are skipped. The
+     * comparison is meaningful when the last level is at full
+     * resolution. The levels are never skipped with the BSpline
+     * scale factors of SetInitialTransformAsBSpline.
+     *
+     * The configuration of this object is not modified, an in place
+     * initial transform is optimized from the parameters of the
+     * state. The warm start is only used by Execute.
+     * @{
+     */
+    SITK_RETURN_SELF_TYPE_HEADER SetWarmStart( const ImageRegistrationState &state, double relativeMetricTolerance = 0.1 );
+    SITK_RETURN_SELF_TYPE_HEADER ClearWarmStart();
+    bool HasWarmStart() const;
+    /** @} */
 
     /** \brief Optimize the configured registration problem. */
     Transform Execute ( const Image &fixed, const Image & moving );
 
+    /** \brief Optimize the configured registration problem for many
+     * image pairs.
+     *
+     * Each moving image is registered to the fixed image, or each
+     * fixed image to the moving image at the same index, with the
+     * configuration of this object. The registrations are executed
+     * concurrently: up to GetNumberOfThreads() threads, or the
+     * number granted by the Executor, are divided between the
+     * registrations so the ITK filters of each registration do not
+     * oversubscribe the processors. The image buffers and the masks
+     * are shared between the registrations, not copied.
+     *
+     * The returned transforms are in the order of the inputs. Every
+     * registration starts from its own copy of the initial transform,
+     * so the InitialTransform of this object is not modified when
+     * optimizing in place. Commands are not invoked, and the
+     * measurements of this object are not updated. The first
+     * exception thrown stops the remaining registrations and is
+     * rethrown; the CancellationToken stops all the registrations.
+     * @{
+     */
+    std::vector<Transform> ExecuteBatch ( const Image &fixed, const std::vector<Image> &moving );
+    std::vector<Transform> ExecuteBatch ( const std::vector<Image> &fixed, const std::vector<Image> &moving );
+    /** @} */
+
+    /** \brief Optimize the configured registration problem from many
+     * initial transforms, and return the best result.
+     *
+     * A registration is executed from each of the initial transforms,
+     * instead of the InitialTransform, to avoid local minima. The
+     * registrations are executed concurrently as with ExecuteBatch,
+     * and share the smoothed images of the levels. The transform with
+     * the lowest final metric value is returned, and the measurements
+     * of this object are those of its registration.
+     *
+     * If numberOfBestStarts is not zero and there are multiple levels,
+     * all the starts are first optimized on the first level only, then
+     * only the numberOfBestStarts starts with the lowest metric values
+     * are optimized on all the levels. A registration which fails is
+     * skipped, unless they all fail.
+     *
+     * \sa GetMultiStartMetricValues, GetMultiStartBestIndex
+     */
+    Transform ExecuteMultiStart ( const Image &fixed,
+                                  const Image &moving,
+                                  const std::vector<Transform> &initialTransforms,
+                                  unsigned int numberOfBestStarts = 0 );
+
+    /** \brief The final metric value of each start of the last
+     * ExecuteMultiStart.
+     *
+     * The value is NaN for the starts which were pruned after the
+     * first level or which failed.
+     *
+     * This is a measurement updated by ExecuteMultiStart.
+     */
+    std::vector<double> GetMultiStartMetricValues() const;
+
+    /** \brief The index of the initial transform of the best result of
+     * the last ExecuteMultiStart.
+     *
+     * This is a measurement updated by ExecuteMultiStart.
+     */
+    unsigned int GetMultiStartBestIndex() const;
+
+    /** \brief Search the grid of the exhaustive optimizer from coarse
+     * to fine, and return the best transform.
+     *
+     * The parameters of the grid set with SetOptimizerAsExhaustive,
+     * scaled by the OptimizerScales set with SetOptimizerScales, are
+     * evaluated concurrently with a metric evaluator, see
+     * CreateMetricEvaluator. Then numberOfRefinements times the step
+     * is halved, and the neighbours of the numberOfCandidates best
+     * parameters found so far are evaluated. The search stops early
+     * when maximumSeconds is positive and is exceeded.
+     *
+     * The returned transform is a copy of the initial transform with
+     * the best parameters, the initial transform is not modified. The
+     * metric value and the number of evaluations are available from
+     * GetMetricValue and GetOptimizerIteration. As with
+     * MetricEvaluate, the sampling strategy, the smoothing sigmas and
+     * the shrink factors are not used.
+     */
+    Transform ExecuteExhaustiveSearch ( const Image &fixed,
+                                        const Image &moving,
+                                        unsigned int numberOfCandidates = 4,
+                                        unsigned int numberOfRefinements = 3,
+                                        double maximumSeconds = 0.0 );
+
 
     /** \brief Get the value of the metric given the state of the method
      *
@@ -594,6 +950,19 @@ namespace simple
      */
     double MetricEvaluate( const Image &fixed, const Image & moving );
 
+    /** \brief Create an evaluator of the metric for many parameters
+     * of the initial transform.
+     *
+     * The metric is configured like MetricEvaluate, once, from the
+     * current state of the method with a copy of the transforms. It
+     * is then evaluated for each parameters passed to the evaluator,
+     * which avoids the set up of the metric, interpolator and masks
+     * of repeated calls to MetricEvaluate in parameter sweeps.
+     *
+     * \sa ImageRegistrationMetricEvaluator
+     */
+    ImageRegistrationMetricEvaluator CreateMetricEvaluator( const Image &fixed, const Image &moving );
+
 
     /**
       * Active measurements which can be obtained during call backs.
@@ -633,6 +1002,20 @@ namespace simple
       */
     std::string GetOptimizerStopConditionDescription() const;
 
+    /** \brief The profile of each level of the last execution.
+     *
+     * Measurement updated at the end of Execute, also when it fails,
+     * when profiling is enabled. It is empty otherwise.
+     */
+    std::vector<ImageRegistrationLevelProfile> GetProfile() const;
+
+    /** \brief The state of the last execution.
+     *
+     * Measurement updated at the end of Execute, to be passed to
+     * SetWarmStart. It is empty before the first execution.
+     */
+    ImageRegistrationState GetRegistrationState() const;
+
 
     /** Stop Registration if actively running.
      *
@@ -641,23 +1024,44 @@ namespace simple
      * support user stopping.
      *
      * If user stopping is not supported or the optimizer is available ( not executed ), then false will be returned.
+     *
+     * When the CancellationToken of this object is cancelled, the registration is stopped this way at the next
+     * iteration, and then Execute throws an exception.
      */
     bool StopRegistration();
 
   protected:
 
+    /** Execute from the warm start state. */
+    Transform ExecuteWarmStart ( const Image &fixed, const Image &moving );
+
     template<class TImage>
     Transform ExecuteInternal ( const Image &fixed, const Image &moving );
 
     template<class TImage>
     double EvaluateInternal ( const Image &fixed, const Image &moving );
 
+    template<class TImage>
+    ImageRegistrationMetricEvaluator CreateMetricEvaluatorInternal ( const Image &fixed, const Image &moving );
+
 
     itk::ObjectToObjectOptimizerBaseTemplate<double> *CreateOptimizer( unsigned int numberOfTransformParameters );
 
     template<unsigned int VDimension>
       itk::SpatialObject<VDimension> *CreateSpatialObjectMask(const Image &mask);
 
+    /** The fixed number of work units of the metrics, or 0 when they
+     * follow the threads. */
+    unsigned int DeterministicNumberOfWorkUnits() const;
+
+    /** Whether the virtual domain is cropped to the fixed mask. */
+    bool UseFixedMaskBoundingBox() const;
+
+    /** The region of the virtual domain covering the non-zero pixels
+     * of the fixed mask, with a margin of one pixel. */
+    template<unsigned int VDimension>
+      itk::ImageRegion<VDimension> FixedMaskBoundingRegion( const itk::ImageBase<VDimension> *virtualDomain ) const;
+
     template <class TImageType>
       itk::ImageToImageMetricv4<TImageType,
       TImageType,
@@ -675,6 +1079,17 @@ namespace simple
       itk::DefaultImageToImageMetricTraitsv4< TImageType, TImageType, TImageType, double >
       >*, const TImageType*, const TImageType* );
 
+    /** Create and initialize the metric of the images with the
+     * initial transforms, optimizing the parameters of
+     * initialTransform. */
+    template <class TImageType>
+      itk::ImageToImageMetricv4<TImageType,
+      TImageType,
+      TImageType,
+      double,
+      itk::DefaultImageToImageMetricTraitsv4< TImageType, TImageType, TImageType, double >
+      >* CreateInitializedMetric( const TImageType *fixed, const TImageType *moving, Transform &initialTransform );
+
     template <typename TMetric>
       itk::RegistrationParameterScalesEstimator< TMetric >*CreateScalesEstimator();
 
@@ -705,6 +1120,46 @@ namespace simple
 
     std::function<void (itk::TransformBase *outTransform)> m_pfUpdateWithBestValue;
 
+    /** Add the iteration observer applying the stopping policy to
+     * the optimizer, when enabled. */
+    void AddOptimizerStoppingPolicyObserver( itk::ObjectToObjectOptimizerBaseTemplate<double> *optimizer );
+
+    /** Cast the images to the pixel type of the registration, keeping
+     * the images sharing a buffer shared. */
+    std::vector<Image> CastToRegistrationPixelType( const std::vector<Image> &images ) const;
+
+    /** Validate the images and execute the registration, without
+     * updating the images retained by the pyramid cache. */
+    Transform DispatchExecute ( const Image &fixed, const Image &moving );
+
+    struct BatchResult
+    {
+      Transform transform;
+      bool succeeded = false;
+      double metricValue = 0.0;
+      unsigned int iteration = 0;
+      uint64_t numberOfValidPoints = 0;
+      std::string stopConditionDescription;
+    };
+
+    /** Execute the registrations of the pairs of fixed and moving
+     * images from the initial transforms concurrently. When
+     * numberOfLevels is not zero, only the first levels are
+     * optimized. With continueOnFailure, the failure of a
+     * registration is recorded in its result instead of being
+     * rethrown. */
+    std::vector<BatchResult> ExecuteInParallel ( const std::vector<Image> &fixed,
+                                                 const std::vector<Image> &moving,
+                                                 std::vector<Transform> initialTransforms,
+                                                 unsigned int numberOfLevels,
+                                                 const std::shared_ptr<detail::PyramidCache> &pyramidCache,
+                                                 bool continueOnFailure );
+
+    /** Copy the configuration of this method to a worker of a batch,
+     * which executes on numberOfThreads threads without commands.
+     */
+    void InitializeBatchWorker( ImageRegistrationMethod &worker, unsigned int numberOfThreads ) const;
+
     template < class TMemberFunctionPointer >
       struct EvaluateMemberFunctionAddressor
     {
@@ -717,11 +1172,25 @@ namespace simple
         }
     };
 
+    template < class TMemberFunctionPointer >
+      struct MetricEvaluatorMemberFunctionAddressor
+    {
+      using ObjectType = typename ::detail::FunctionTraits<TMemberFunctionPointer>::ClassType;
+
+      template< typename TImageType >
+      TMemberFunctionPointer operator() ( ) const
+        {
+          return &ObjectType::template CreateMetricEvaluatorInternal< TImageType >;
+        }
+    };
+
     typedef Transform (ImageRegistrationMethod::*MemberFunctionType)( const Image &fixed, const Image &moving );
     typedef double (ImageRegistrationMethod::*EvaluateMemberFunctionType)( const Image &fixed, const Image &moving );
+    typedef ImageRegistrationMetricEvaluator (ImageRegistrationMethod::*MetricEvaluatorMemberFunctionType)( const Image &fixed, const Image &moving );
     friend struct detail::MemberFunctionAddressor<MemberFunctionType>;
     std::unique_ptr<detail::MemberFunctionFactory<MemberFunctionType> > m_MemberFactory;
     std::unique_ptr<detail::MemberFunctionFactory<EvaluateMemberFunctionType> > m_EvaluateMemberFactory;
+    std::unique_ptr<detail::MemberFunctionFactory<MetricEvaluatorMemberFunctionType> > m_MetricEvaluatorMemberFactory;
 
     InterpolatorEnum  m_Interpolator;
     Transform  m_InitialTransform;
@@ -795,16 +1264,24 @@ namespace simple
 
     std::vector<double> m_OptimizerWeights;
 
+    double m_OptimizerStoppingRelativeMetricTolerance;
+    unsigned int m_OptimizerStoppingWindowSize;
+    double m_OptimizerStoppingMaximumSecondsPerLevel;
+    unsigned int m_OptimizerStoppingMaximumNumberOfIterations;
+    std::string m_OptimizerStoppingCondition;
+
     enum OptimizerScalesType {
       Manual,
       Jacobian,
       IndexShift,
-      PhysicalShift
+      PhysicalShift,
+      ImageExtent
     };
     OptimizerScalesType m_OptimizerScalesType;
     std::vector<double> m_OptimizerScales;
     unsigned int m_OptimizerScalesCentralRegionRadius;
     double m_OptimizerScalesSmallParameterVariation;
+    bool m_OptimizerScalesReuseAcrossLevels;
 
     // metric
     enum MetricType { ANTSNeighborhoodCorrelation,
@@ -829,16 +1306,34 @@ namespace simple
 
     bool m_MetricUseFixedImageGradientFilter;
     bool m_MetricUseMovingImageGradientFilter;
+    bool m_MetricUseFixedMaskBoundingBox;
+    bool m_MetricUseDeterministicReduction;
 
     std::vector<unsigned int> m_ShrinkFactorsPerLevel;
     std::vector<double> m_SmoothingSigmasPerLevel;
     bool m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
 
+    std::shared_ptr<detail::PyramidCache> m_PyramidCache;
+    bool m_PyramidCacheImageGradients;
+
+    bool m_Profiling;
+    std::vector<ImageRegistrationLevelProfile> m_Profile;
+
+    bool m_UseSinglePrecision;
+
+    ImageRegistrationState m_WarmStart;
+    double m_WarmStartRelativeMetricTolerance;
+    unsigned int m_WarmStartLevelOffset;
+    ImageRegistrationState m_RegistrationState;
+
     std::string m_StopConditionDescription;
     double m_MetricValue;
     unsigned int m_Iteration;
     uint64_t m_NumberOfValidPoints;
 
+    std::vector<double> m_MultiStartMetricValues;
+    unsigned int m_MultiStartBestIndex;
+
     itk::ObjectToObjectOptimizerBaseTemplate<double> *m_ActiveOptimizer;
   };
 
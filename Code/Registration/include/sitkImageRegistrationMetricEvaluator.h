@@ -0,0 +1,97 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageRegistrationMetricEvaluator_h
+#define sitkImageRegistrationMetricEvaluator_h
+
+#include "sitkRegistration.h"
+
+#include <memory>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+  class ImageRegistrationMethod;
+
+  namespace detail { class MetricEvaluatorImpl; }
+
+  /** \brief Evaluate the metric of a registration for many transform
+   * parameters.
+   *
+   * The evaluator is created by
+   * ImageRegistrationMethod::CreateMetricEvaluator from a fixed and a
+   * moving image. The metric, the interpolators, the masks and the
+   * transforms are configured once from the state of the
+   * registration method at the time of its creation, then the metric
+   * value is computed for the parameters of the initial transform
+   * passed to the Evaluate methods. Later changes to the registration
+   * method or to its transforms do not affect the evaluator.
+   *
+   * Copies of an evaluator share the same metric objects.
+   *
+   * \sa ImageRegistrationMethod::MetricEvaluate
+   */
+  class SITKRegistration_EXPORT ImageRegistrationMetricEvaluator
+  {
+  public:
+    using Self = ImageRegistrationMetricEvaluator;
+
+    ~ImageRegistrationMetricEvaluator();
+
+    ImageRegistrationMetricEvaluator( const ImageRegistrationMetricEvaluator & );
+    ImageRegistrationMetricEvaluator &operator=( const ImageRegistrationMetricEvaluator & );
+
+    /** The number of parameters of the initial transform, which is
+     * the required size of the evaluated parameters. */
+    unsigned int GetNumberOfParameters() const;
+
+    /** \brief Get the value of the metric with the initial transform
+     * set to parameters. */
+    double Evaluate( const std::vector<double> &parameters );
+
+    /** \brief Get the value and the derivative of the metric with the
+     * initial transform set to parameters.
+     *
+     * The derivative follows the convention of the ITKv4 metrics, it
+     * is the direction of decrease of the metric with respect to the
+     * parameters, which is the negative of the gradient.
+     */
+    double EvaluateWithDerivative( const std::vector<double> &parameters, std::vector<double> &derivative );
+
+    /** \brief Get the value of the metric for each of the parameters.
+     *
+     * The parameters are evaluated concurrently, on the threads of the
+     * Executor of the registration method when it has one. Each thread
+     * uses its own copy of the metric, which is created at the first
+     * batch evaluation needing it.
+     */
+    std::vector<double> Evaluate( const std::vector< std::vector<double> > &parameters );
+
+  private:
+    friend class ImageRegistrationMethod;
+
+    explicit ImageRegistrationMetricEvaluator( std::shared_ptr<detail::MetricEvaluatorImpl> impl );
+
+    std::shared_ptr<detail::MetricEvaluatorImpl> m_Impl;
+  };
+
+}
+}
+
+#endif // sitkImageRegistrationMetricEvaluator_h
@@ -0,0 +1,86 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageRegistrationState_h
+#define sitkImageRegistrationState_h
+
+#include "sitkRegistration.h"
+#include "sitkTransform.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+  class ImageRegistrationMethod;
+
+  /** \brief The final state of an execution of a registration.
+   *
+   * The state of the last Execute of ImageRegistrationMethod, which
+   * can be passed to ImageRegistrationMethod::SetWarmStart to start
+   * the registration of the next image of a series from it.
+   *
+   * \sa ImageRegistrationMethod::GetRegistrationState
+   */
+  class SITKRegistration_EXPORT ImageRegistrationState
+  {
+  public:
+    ImageRegistrationState();
+
+    /** The parameters of the optimized transform. */
+    std::vector<double> GetTransformParameters() const;
+
+    /** The fixed parameters of the optimized transform. */
+    std::vector<double> GetTransformFixedParameters() const;
+
+    /** The scales of the optimizer on the last level, set or
+     * estimated. Empty when no scales were used. */
+    std::vector<double> GetOptimizerScales() const;
+
+    /** The learning rate of the optimizer at the end of the last
+     * level. It is zero for the optimizers without learning rate. */
+    double GetOptimizerLearningRate() const;
+
+    /** The last level optimized, counting the levels skipped by a
+     * warm start. */
+    unsigned int GetLevel() const;
+
+    /** The value of the metric at the end of the last level. */
+    double GetMetricValue() const;
+
+    /** Whether the state is of an execution. */
+    bool IsEmpty() const;
+
+    std::string ToString() const;
+
+  private:
+    friend class ImageRegistrationMethod;
+
+    std::vector<double> m_TransformParameters;
+    std::vector<double> m_TransformFixedParameters;
+    std::vector<double> m_OptimizerScales;
+    double m_OptimizerLearningRate;
+    unsigned int m_Level;
+    double m_MetricValue;
+  };
+
+}
+}
+
+#endif // sitkImageRegistrationState_h
@@ -0,0 +1,105 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkIterationRecorderCommand_h
+#define sitkIterationRecorderCommand_h
+
+#include "sitkRegistration.h"
+#include "sitkCommand.h"
+
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+
+class ImageRegistrationMethod;
+
+/** \class IterationRecorderCommand
+ * \brief A Command which records the iterations of an
+ * ImageRegistrationMethod.
+ *
+ * When added to the sitkIterationEvent of the registration method,
+ * each execution appends the level, the optimizer iteration, the
+ * metric value, the learning rate, the convergence value and the
+ * optimizer position to the records. The command is C++, so the
+ * iterations are recorded without calling into a wrapped language,
+ * and the records are read after the registration, for example to
+ * plot its convergence.
+ *
+ * The registration method must outlive the command. The records
+ * are kept between executions of the registration method until
+ * Clear is called.
+ */
+class SITKRegistration_EXPORT IterationRecorderCommand : public Command
+{
+public:
+  using Self = IterationRecorderCommand;
+
+  /** The storage of the records is reserved for
+   * numberOfIterations, so that as many iterations are recorded
+   * without a reallocation. */
+  explicit IterationRecorderCommand( const ImageRegistrationMethod &method, unsigned int numberOfIterations = 0 );
+
+  ~IterationRecorderCommand() override;
+
+  void Execute() override;
+
+  /** Remove the records. */
+  void Clear();
+
+  /** The number of recorded iterations. */
+  unsigned int GetNumberOfRecords() const;
+
+  /** The number of optimizer parameters of each record, or zero when
+   * nothing is recorded. When it changes between the records, such
+   * as for the levels of a BSplineTransform with a changing mesh, it
+   * is the number of the first record. */
+  unsigned int GetNumberOfParameters() const;
+
+  /** The values of each recorded iteration.
+   * @{
+   */
+  const std::vector<unsigned int> &GetLevels() const;
+  const std::vector<unsigned int> &GetIterations() const;
+  const std::vector<double> &GetMetricValues() const;
+  const std::vector<double> &GetLearningRates() const;
+  const std::vector<double> &GetConvergenceValues() const;
+  /** @} */
+
+  /** The optimizer positions of the records, concatenated. When the
+   * number of parameters changes between the records, the offset of
+   * each position is the sum of the sizes of the previous ones. */
+  const std::vector<double> &GetPositions() const;
+
+private:
+  const ImageRegistrationMethod &m_Method;
+
+  std::vector<unsigned int> m_Levels;
+  std::vector<unsigned int> m_Iterations;
+  std::vector<double> m_MetricValues;
+  std::vector<double> m_LearningRates;
+  std::vector<double> m_ConvergenceValues;
+  std::vector<double> m_Positions;
+  unsigned int m_NumberOfParameters{ 0 };
+};
+
+} // end namespace simple
+} // end namespace itk
+
+#endif // sitkIterationRecorderCommand_h
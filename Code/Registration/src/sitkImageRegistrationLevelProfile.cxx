@@ -0,0 +1,180 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkImageRegistrationLevelProfile.h"
+#include "sitkRegistrationProfiler.h"
+
+#include <numeric>
+#include <sstream>
+
+namespace itk
+{
+namespace simple
+{
+
+ImageRegistrationLevelProfile::ImageRegistrationLevelProfile()
+  : m_Level( 0 ),
+    m_InitializationTime( 0.0 ),
+    m_SamplingTime( 0.0 ),
+    m_ScalesEstimationTime( 0.0 ),
+    m_OptimizationTime( 0.0 ),
+    m_MetricNumberOfValidPoints( 0 )
+{
+}
+
+unsigned int ImageRegistrationLevelProfile::GetLevel() const
+{
+  return m_Level;
+}
+
+double ImageRegistrationLevelProfile::GetInitializationTime() const
+{
+  return m_InitializationTime;
+}
+
+double ImageRegistrationLevelProfile::GetSamplingTime() const
+{
+  return m_SamplingTime;
+}
+
+double ImageRegistrationLevelProfile::GetScalesEstimationTime() const
+{
+  return m_ScalesEstimationTime;
+}
+
+double ImageRegistrationLevelProfile::GetOptimizationTime() const
+{
+  return m_OptimizationTime;
+}
+
+unsigned int ImageRegistrationLevelProfile::GetNumberOfIterations() const
+{
+  return static_cast<unsigned int>( m_IterationTimes.size() );
+}
+
+std::vector<double> ImageRegistrationLevelProfile::GetIterationTimes() const
+{
+  return m_IterationTimes;
+}
+
+std::vector<double> ImageRegistrationLevelProfile::GetMetricValues() const
+{
+  return m_MetricValues;
+}
+
+uint64_t ImageRegistrationLevelProfile::GetMetricNumberOfValidPoints() const
+{
+  return m_MetricNumberOfValidPoints;
+}
+
+std::string ImageRegistrationLevelProfile::ToString() const
+{
+  const double iterationTime = std::accumulate( m_IterationTimes.begin(), m_IterationTimes.end(), 0.0 );
+
+  std::ostringstream out;
+  out << "Level " << m_Level << ":" << std::endl
+      << "  InitializationTime: " << m_InitializationTime << std::endl
+      << "  SamplingTime: " << m_SamplingTime << std::endl
+      << "  ScalesEstimationTime: " << m_ScalesEstimationTime << std::endl
+      << "  OptimizationTime: " << m_OptimizationTime << std::endl
+      << "  NumberOfIterations: " << m_IterationTimes.size() << std::endl
+      << "  MeanIterationTime: " << ( m_IterationTimes.empty() ? 0.0 : iterationTime / m_IterationTimes.size() ) << std::endl
+      << "  MetricNumberOfValidPoints: " << m_MetricNumberOfValidPoints << std::endl;
+  if ( !m_MetricValues.empty() )
+    {
+    out << "  FinalMetricValue: " << m_MetricValues.back() << std::endl;
+    }
+  return out.str();
+}
+
+
+namespace detail
+{
+
+double RegistrationProfiler::Seconds( ClockType::time_point start, ClockType::time_point end )
+{
+  return std::chrono::duration<double>( end - start ).count();
+}
+
+void RegistrationProfiler::BeginLevel( unsigned int level )
+{
+  this->EndLevel();
+
+  m_Levels.emplace_back();
+  m_Levels.back().m_Level = level;
+  m_LevelStart = ClockType::now();
+}
+
+void RegistrationProfiler::EndLevelInitialization( double samplingTime )
+{
+  if ( m_Levels.empty() )
+    {
+    return;
+    }
+  const ClockType::time_point now = ClockType::now();
+  ImageRegistrationLevelProfile &profile = m_Levels.back();
+  profile.m_InitializationTime = Seconds( m_LevelStart, now );
+  profile.m_SamplingTime = samplingTime;
+
+  m_Optimizing = true;
+  m_OptimizationStart = now;
+  m_IterationStart = now;
+}
+
+void RegistrationProfiler::OptimizerStarted()
+{
+  if ( !m_Optimizing )
+    {
+    return;
+    }
+  m_IterationStart = ClockType::now();
+  m_Levels.back().m_ScalesEstimationTime = Seconds( m_OptimizationStart, m_IterationStart );
+}
+
+void RegistrationProfiler::Iteration( double metricValue, uint64_t numberOfValidPoints )
+{
+  if ( !m_Optimizing )
+    {
+    return;
+    }
+  const ClockType::time_point now = ClockType::now();
+  ImageRegistrationLevelProfile &profile = m_Levels.back();
+  profile.m_IterationTimes.push_back( Seconds( m_IterationStart, now ) );
+  profile.m_MetricValues.push_back( metricValue );
+  profile.m_MetricNumberOfValidPoints = numberOfValidPoints;
+  m_IterationStart = now;
+}
+
+void RegistrationProfiler::EndLevel()
+{
+  if ( !m_Optimizing )
+    {
+    return;
+    }
+  m_Levels.back().m_OptimizationTime = Seconds( m_OptimizationStart, ClockType::now() );
+  m_Optimizing = false;
+}
+
+std::vector<ImageRegistrationLevelProfile> RegistrationProfiler::Finish()
+{
+  this->EndLevel();
+  return m_Levels;
+}
+
+}
+}
+}
@@ -21,6 +21,7 @@
 #include "sitkCastImageFilter.h"
 
 #include "itkImageMaskSpatialObject.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImage.h"
 #include "itkImageRegistrationMethodv4.h"
 
@@ -29,10 +30,27 @@
 #include "itkRegistrationParameterScalesFromPhysicalShift.h"
 
 #include "sitkImageRegistrationMethod_CreateParametersAdaptor.hxx"
+#include "sitkImageRegistrationMethod_MetricSampling.hxx"
+#include "sitkPyramidCache.h"
+#include "sitkRegistrationProfiler.h"
+#include "sitkTraceRange.h"
+#include "sitkImageRegistrationMetricEvaluatorImpl.h"
 
 
 #include "sitkBSplineTransform.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <thread>
+
 template< typename TValue, typename TType>
 itk::Array<TValue> sitkSTLVectorToITKArray( const std::vector< TType > & in )
 {
@@ -61,20 +79,97 @@ struct CurrentLevelCustomCast
       return static_cast<unsigned int>(ret);
     }
 };
+
+// The mean squared norm of the Jacobian columns over the corners of
+// the physical domain of image, as RegistrationParameterScalesFromJacobian
+// does with corner sampling.
+template<unsigned int VDimension>
+itk::OptimizerParameters<double>
+ComputeScalesFromImageExtent( const itk::Transform<double, VDimension, VDimension> *transform,
+                              const itk::ImageBase<VDimension> *image )
+{
+  const unsigned int numberOfParameters = transform->GetNumberOfParameters();
+  const typename itk::ImageBase<VDimension>::RegionType &region = image->GetLargestPossibleRegion();
+
+  itk::OptimizerParameters<double> scales( numberOfParameters );
+  scales.Fill( 0.0 );
+
+  const unsigned int numberOfCorners = 1u << VDimension;
+  typename itk::Transform<double, VDimension, VDimension>::JacobianType jacobian( VDimension, numberOfParameters );
+  for ( unsigned int c = 0; c < numberOfCorners; ++c )
+    {
+    itk::ContinuousIndex<double, VDimension> index;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      index[d] = region.GetIndex()[d] - 0.5;
+      if ( c & ( 1u << d ) )
+        {
+        index[d] += region.GetSize()[d];
+        }
+      }
+    typename itk::Transform<double, VDimension, VDimension>::InputPointType point;
+    image->TransformContinuousIndexToPhysicalPoint( index, point );
+
+    transform->ComputeJacobianWithRespectToParameters( point, jacobian );
+    for ( unsigned int p = 0; p < numberOfParameters; ++p )
+      {
+      for ( unsigned int d = 0; d < VDimension; ++d )
+        {
+        scales[p] += jacobian( d, p ) * jacobian( d, p ) / numberOfCorners;
+        }
+      }
+    }
+
+  // parameters not moving the corners are not scaled
+  for ( unsigned int p = 0; p < numberOfParameters; ++p )
+    {
+    if ( scales[p] <= std::numeric_limits<double>::epsilon() )
+      {
+      scales[p] = 1.0;
+      }
+    }
+  return scales;
+}
+
+// Create an ITK image sharing the buffer of the input image, so the
+// pipeline state of the image, such as the requested region, is not
+// shared with concurrent executions using the same input.
+template<typename TImageType>
+typename TImageType::ConstPointer ShareImageBuffer( const TImageType *image )
+{
+  typename TImageType::Pointer shared = TImageType::New();
+  shared->CopyInformation( image );
+  shared->SetRegions( image->GetLargestPossibleRegion() );
+  shared->SetPixelContainer( const_cast<typename TImageType::PixelContainer *>( image->GetPixelContainer() ) );
+  return shared.GetPointer();
+}
 }
 
 ImageRegistrationMethod::ImageRegistrationMethod()
   : m_Interpolator(sitkLinear),
     m_InitialTransformInPlace(true),
+    m_OptimizerStoppingRelativeMetricTolerance(0.0),
+    m_OptimizerStoppingWindowSize(10),
+    m_OptimizerStoppingMaximumSecondsPerLevel(0.0),
+    m_OptimizerStoppingMaximumNumberOfIterations(0),
     m_OptimizerScalesType(Manual),
+    m_OptimizerScalesReuseAcrossLevels(false),
     m_MetricSamplingPercentage(1,1.0),
     m_MetricSamplingStrategy(NONE),
     m_MetricSamplingSeed(0u),
     m_MetricUseFixedImageGradientFilter(true),
     m_MetricUseMovingImageGradientFilter(true),
+    m_MetricUseFixedMaskBoundingBox(false),
+    m_MetricUseDeterministicReduction(false),
     m_ShrinkFactorsPerLevel(1, 1),
     m_SmoothingSigmasPerLevel(1,0.0),
     m_SmoothingSigmasAreSpecifiedInPhysicalUnits(true),
+    m_PyramidCacheImageGradients(false),
+    m_Profiling(false),
+    m_UseSinglePrecision(false),
+    m_WarmStartRelativeMetricTolerance(0.1),
+    m_WarmStartLevelOffset(0),
+    m_MultiStartBestIndex(0),
     m_ActiveOptimizer(NULL)
 {
   m_MemberFactory.reset( new  detail::MemberFunctionFactory<MemberFunctionType>( this ) );
@@ -91,6 +186,12 @@ ImageRegistrationMethod::ImageRegistrationMethod()
   m_EvaluateMemberFactory->RegisterMemberFunctions< RealPixelIDTypeList, 3, EvaluateMemberFunctionAddressorType > ();
   m_EvaluateMemberFactory->RegisterMemberFunctions< RealPixelIDTypeList, 2, EvaluateMemberFunctionAddressorType > ();
 
+  m_MetricEvaluatorMemberFactory.reset( new detail::MemberFunctionFactory<MetricEvaluatorMemberFunctionType>(this) );
+
+  using MetricEvaluatorMemberFunctionAddressorType = MetricEvaluatorMemberFunctionAddressor<MetricEvaluatorMemberFunctionType>;
+  m_MetricEvaluatorMemberFactory->RegisterMemberFunctions< RealPixelIDTypeList, 3, MetricEvaluatorMemberFunctionAddressorType > ();
+  m_MetricEvaluatorMemberFactory->RegisterMemberFunctions< RealPixelIDTypeList, 2, MetricEvaluatorMemberFunctionAddressorType > ();
+
   this->SetMetricAsMattesMutualInformation();
 
 }
@@ -119,6 +220,26 @@ std::string  ImageRegistrationMethod::ToString() const
   this->ToStringHelper(out, this->m_InitialTransform.ToString());
   out << std::endl;
 
+  out << "  UsePyramidCache: ";
+  this->ToStringHelper(out, this->GetUsePyramidCache());
+  out << std::endl;
+
+  out << "  PyramidCacheImageGradients: ";
+  this->ToStringHelper(out, this->m_PyramidCacheImageGradients);
+  out << std::endl;
+
+  out << "  Profiling: ";
+  this->ToStringHelper(out, this->m_Profiling);
+  out << std::endl;
+
+  out << "  UseSinglePrecision: ";
+  this->ToStringHelper(out, this->m_UseSinglePrecision);
+  out << std::endl;
+
+  out << "  MetricUseDeterministicReduction: ";
+  this->ToStringHelper(out, this->m_MetricUseDeterministicReduction);
+  out << std::endl;
+
   return out.str();
 }
 
@@ -412,6 +533,27 @@ ImageRegistrationMethod::GetOptimizerWeights( ) const
   return this->m_OptimizerWeights;
 }
 
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetOptimizerStoppingPolicy( double relativeMetricTolerance,
+                                                     unsigned int windowSize,
+                                                     double maximumSecondsPerLevel,
+                                                     unsigned int maximumNumberOfIterations )
+{
+  if ( relativeMetricTolerance < 0.0 || maximumSecondsPerLevel < 0.0 )
+    {
+    sitkExceptionMacro( "The tolerance and the time of the stopping policy must not be negative!" );
+    }
+  if ( relativeMetricTolerance > 0.0 && windowSize < 2 )
+    {
+    sitkExceptionMacro( "The window of the stopping policy must contain at least 2 iterations!" );
+    }
+  this->m_OptimizerStoppingRelativeMetricTolerance = relativeMetricTolerance;
+  this->m_OptimizerStoppingWindowSize = windowSize;
+  this->m_OptimizerStoppingMaximumSecondsPerLevel = maximumSecondsPerLevel;
+  this->m_OptimizerStoppingMaximumNumberOfIterations = maximumNumberOfIterations;
+  return *this;
+}
+
 ImageRegistrationMethod::Self&
 ImageRegistrationMethod::SetOptimizerAsExhaustive(const std::vector<unsigned int> &numberOfSteps,
                                                   double stepLength )
@@ -530,6 +672,26 @@ ImageRegistrationMethod::SetOptimizerScalesFromPhysicalShift( unsigned int centr
   return *this;
 }
 
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetOptimizerScalesFromImageExtent()
+{
+  this->m_OptimizerScalesType = ImageExtent;
+  this->m_OptimizerScales = std::vector<double>();
+  return *this;
+}
+
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetOptimizerScalesReuseAcrossLevels( bool reuse )
+{
+  this->m_OptimizerScalesReuseAcrossLevels = reuse;
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetOptimizerScalesReuseAcrossLevels() const
+{
+  return this->m_OptimizerScalesReuseAcrossLevels;
+}
+
 ImageRegistrationMethod::Self&
 ImageRegistrationMethod::SetMetricSamplingPercentage(double percentage, unsigned int seed)
 {
@@ -573,6 +735,28 @@ ImageRegistrationMethod::Self& ImageRegistrationMethod::SetMetricUseMovingImageG
   return *this;
 }
 
+ImageRegistrationMethod::Self& ImageRegistrationMethod::SetMetricUseFixedMaskBoundingBox( bool useFixedMaskBoundingBox )
+{
+  m_MetricUseFixedMaskBoundingBox = useFixedMaskBoundingBox;
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetMetricUseFixedMaskBoundingBox() const
+{
+  return m_MetricUseFixedMaskBoundingBox;
+}
+
+ImageRegistrationMethod::Self& ImageRegistrationMethod::SetMetricUseDeterministicReduction( bool useDeterministicReduction )
+{
+  m_MetricUseDeterministicReduction = useDeterministicReduction;
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetMetricUseDeterministicReduction() const
+{
+  return m_MetricUseDeterministicReduction;
+}
+
 
 ImageRegistrationMethod::Self&
 ImageRegistrationMethod::SetShrinkFactorsPerLevel( const std::vector<unsigned int> &shrinkFactors )
@@ -595,6 +779,132 @@ ImageRegistrationMethod::SetSmoothingSigmasAreSpecifiedInPhysicalUnits(bool arg)
   return *this;
 }
 
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetUsePyramidCache( bool usePyramidCache )
+{
+  if ( !usePyramidCache )
+    {
+    m_PyramidCache.reset();
+    }
+  else if ( !m_PyramidCache )
+    {
+    m_PyramidCache = std::make_shared<detail::PyramidCache>();
+    }
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetUsePyramidCache() const
+{
+  return bool(m_PyramidCache);
+}
+
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetPyramidCacheImageGradients( bool pyramidCacheImageGradients )
+{
+  this->m_PyramidCacheImageGradients = pyramidCacheImageGradients;
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetPyramidCacheImageGradients() const
+{
+  return this->m_PyramidCacheImageGradients;
+}
+
+void ImageRegistrationMethod::ClearPyramidCache()
+{
+  if ( m_PyramidCache )
+    {
+    m_PyramidCache->Clear();
+    }
+}
+
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetProfiling( bool profiling )
+{
+  this->m_Profiling = profiling;
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetProfiling() const
+{
+  return this->m_Profiling;
+}
+
+std::vector<ImageRegistrationLevelProfile> ImageRegistrationMethod::GetProfile() const
+{
+  return this->m_Profile;
+}
+
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetUseSinglePrecision( bool useSinglePrecision )
+{
+  this->m_UseSinglePrecision = useSinglePrecision;
+  return *this;
+}
+
+bool ImageRegistrationMethod::GetUseSinglePrecision() const
+{
+  return this->m_UseSinglePrecision;
+}
+
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::SetWarmStart( const ImageRegistrationState &state, double relativeMetricTolerance )
+{
+  if ( state.IsEmpty() )
+    {
+    sitkExceptionMacro( "The warm start state is empty!" );
+    }
+  this->m_WarmStart = state;
+  this->m_WarmStartRelativeMetricTolerance = relativeMetricTolerance;
+  return *this;
+}
+
+ImageRegistrationMethod::Self&
+ImageRegistrationMethod::ClearWarmStart()
+{
+  this->m_WarmStart = ImageRegistrationState();
+  return *this;
+}
+
+bool ImageRegistrationMethod::HasWarmStart() const
+{
+  return !this->m_WarmStart.IsEmpty();
+}
+
+ImageRegistrationState ImageRegistrationMethod::GetRegistrationState() const
+{
+  return this->m_RegistrationState;
+}
+
+std::vector<Image> ImageRegistrationMethod::CastToRegistrationPixelType( const std::vector<Image> &images ) const
+{
+  if ( !m_UseSinglePrecision )
+    {
+    return images;
+    }
+
+  // the same fixed image is usually given for all the registrations
+  // of a batch, and is only cast once
+  std::map<const void *, Image> castImages;
+  std::vector<Image> outputs;
+  outputs.reserve( images.size() );
+  for ( const Image &image : images )
+    {
+    if ( image.GetPixelID() != sitkFloat64 )
+      {
+      outputs.push_back( image );
+      continue;
+      }
+    auto iter = castImages.find( image.GetBufferAsVoid() );
+    if ( iter == castImages.end() )
+      {
+      iter = castImages.emplace( image.GetBufferAsVoid(), Cast( image, sitkFloat32 ) ).first;
+      }
+    outputs.push_back( iter->second );
+    }
+  return outputs;
+}
+
 std::string ImageRegistrationMethod::GetOptimizerStopConditionDescription() const
 {
   if (bool(this->m_pfGetOptimizerStopConditionDescription))
@@ -729,6 +1039,7 @@ ImageRegistrationMethod::CreateScalesEstimator()
       return scalesEstimator;
     }
     case Manual:
+    case ImageExtent:
       return NULL;
     default:
       break; // fall through to exception
@@ -767,7 +1078,108 @@ ImageRegistrationMethod::CreateSpatialObjectMask(const Image &imageMask)
 }
 
 
-Transform ImageRegistrationMethod::Execute ( const Image &fixed, const Image & moving )
+Transform ImageRegistrationMethod::Execute ( const Image &inFixed, const Image & inMoving )
+{
+  const detail::TraceRange traceRange( *this, &inFixed );
+  const std::vector<Image> images = this->CastToRegistrationPixelType( { inFixed, inMoving } );
+  const Image &fixed = images[0];
+  const Image &moving = images[1];
+
+  if ( m_PyramidCache )
+    {
+    m_PyramidCache->Retain( images );
+    }
+
+  Transform result = this->HasWarmStart() ? this->ExecuteWarmStart( fixed, moving ) : this->DispatchExecute( fixed, moving );
+
+  m_RegistrationState.m_TransformParameters = result.GetParameters();
+  m_RegistrationState.m_TransformFixedParameters = result.GetFixedParameters();
+  return result;
+}
+
+Transform ImageRegistrationMethod::ExecuteWarmStart ( const Image &fixed, const Image & moving )
+{
+  const ImageRegistrationState &state = m_WarmStart;
+
+  if ( state.m_TransformParameters.size() != m_InitialTransform.GetNumberOfParameters() )
+    {
+    sitkExceptionMacro( << "The number of parameters of the warm start state ( " << state.m_TransformParameters.size()
+                        << " ) does not match the number of parameters of the initial transform ( "
+                        << m_InitialTransform.GetNumberOfParameters() << " )!" );
+    }
+
+  // the configuration changed for the warm start is restored after
+  // the execution
+  const Transform initialTransform = m_InitialTransform;
+  const OptimizerScalesType optimizerScalesType = m_OptimizerScalesType;
+  const std::vector<double> optimizerScales = m_OptimizerScales;
+  const double optimizerLearningRate = m_OptimizerLearningRate;
+  const EstimateLearningRateType optimizerEstimateLearningRate = m_OptimizerEstimateLearningRate;
+  const std::vector<unsigned int> shrinkFactorsPerLevel = m_ShrinkFactorsPerLevel;
+  const std::vector<double> smoothingSigmasPerLevel = m_SmoothingSigmasPerLevel;
+  const std::vector<double> metricSamplingPercentage = m_MetricSamplingPercentage;
+  auto restore = make_scope_exit( [&, this] {
+      m_InitialTransform = initialTransform;
+      m_OptimizerScalesType = optimizerScalesType;
+      m_OptimizerScales = optimizerScales;
+      m_OptimizerLearningRate = optimizerLearningRate;
+      m_OptimizerEstimateLearningRate = optimizerEstimateLearningRate;
+      m_ShrinkFactorsPerLevel = shrinkFactorsPerLevel;
+      m_SmoothingSigmasPerLevel = smoothingSigmasPerLevel;
+      m_MetricSamplingPercentage = metricSamplingPercentage;
+      m_WarmStartLevelOffset = 0;
+    } );
+
+  // An in place transform is updated through the ITK transform it
+  // shares with the caller, otherwise a copy is optimized.
+  if ( !m_InitialTransformInPlace )
+    {
+    m_InitialTransform.MakeUnique();
+    }
+  itk::TransformBase *itkTx = m_InitialTransform.GetITKBase();
+  itk::TransformBase::FixedParametersType fixedParameters( static_cast<unsigned int>( state.m_TransformFixedParameters.size() ) );
+  std::copy( state.m_TransformFixedParameters.begin(), state.m_TransformFixedParameters.end(), fixedParameters.begin() );
+  itkTx->SetFixedParameters( fixedParameters );
+  itk::TransformBase::ParametersType parameters( static_cast<unsigned int>( state.m_TransformParameters.size() ) );
+  std::copy( state.m_TransformParameters.begin(), state.m_TransformParameters.end(), parameters.begin() );
+  itkTx->SetParameters( parameters );
+
+  if ( state.m_OptimizerScales.size() == parameters.size() )
+    {
+    m_OptimizerScalesType = Manual;
+    m_OptimizerScales = state.m_OptimizerScales;
+    }
+  if ( state.m_OptimizerLearningRate > 0.0 )
+    {
+    m_OptimizerLearningRate = state.m_OptimizerLearningRate;
+    m_OptimizerEstimateLearningRate = Never;
+    }
+
+  const unsigned int numberOfLevels = static_cast<unsigned int>( m_ShrinkFactorsPerLevel.size() );
+  const unsigned int skippedLevels = std::min( state.m_Level, numberOfLevels - 1 );
+  if ( skippedLevels > 0 && m_TransformBSplineScaleFactors.empty() && std::isfinite( state.m_MetricValue ) )
+    {
+    const double metricValue = this->MetricEvaluate( fixed, moving );
+    if ( std::abs( metricValue - state.m_MetricValue ) <= m_WarmStartRelativeMetricTolerance * std::abs( state.m_MetricValue ) )
+      {
+      m_ShrinkFactorsPerLevel.erase( m_ShrinkFactorsPerLevel.begin(), m_ShrinkFactorsPerLevel.begin() + skippedLevels );
+      if ( m_SmoothingSigmasPerLevel.size() == numberOfLevels )
+        {
+        m_SmoothingSigmasPerLevel.erase( m_SmoothingSigmasPerLevel.begin(), m_SmoothingSigmasPerLevel.begin() + skippedLevels );
+        }
+      if ( m_MetricSamplingPercentage.size() == numberOfLevels )
+        {
+        m_MetricSamplingPercentage.erase( m_MetricSamplingPercentage.begin(), m_MetricSamplingPercentage.begin() + skippedLevels );
+        }
+      m_WarmStartLevelOffset = skippedLevels;
+      sitkDebugMacro( << "Warm start skipping the first " << skippedLevels << " levels." );
+      }
+    }
+
+  return this->DispatchExecute( fixed, moving );
+}
+
+Transform ImageRegistrationMethod::DispatchExecute ( const Image &fixed, const Image & moving )
 {
   const PixelIDValueType fixedType = fixed.GetPixelIDValue();
   const unsigned int fixedDim = fixed.GetDimension();
@@ -792,6 +1204,617 @@ Transform ImageRegistrationMethod::Execute ( const Image &fixed, const Image & m
 
 }
 
+std::vector<Transform> ImageRegistrationMethod::ExecuteBatch ( const Image &fixed, const std::vector<Image> &moving )
+{
+  return this->ExecuteBatch( std::vector<Image>( moving.size(), fixed ), moving );
+}
+
+std::vector<Transform> ImageRegistrationMethod::ExecuteBatch ( const std::vector<Image> &inFixed, const std::vector<Image> &inMoving )
+{
+  if ( inFixed.size() != inMoving.size() )
+    {
+    sitkExceptionMacro( << "The number of fixed images ( " << inFixed.size()
+                        << " ) does not match the number of moving images ( " << inMoving.size() << " )!" );
+    }
+
+  std::vector<Image> images( inFixed );
+  images.insert( images.end(), inMoving.begin(), inMoving.end() );
+  images = this->CastToRegistrationPixelType( images );
+  const std::vector<Image> fixed( images.begin(), images.begin() + inFixed.size() );
+  const std::vector<Image> moving( images.begin() + inFixed.size(), images.end() );
+
+  if ( m_PyramidCache )
+    {
+    m_PyramidCache->Retain( images );
+    }
+
+  std::vector<BatchResult> results = this->ExecuteInParallel( fixed,
+                                                              moving,
+                                                              std::vector<Transform>( moving.size(), m_InitialTransform ),
+                                                              0,
+                                                              m_PyramidCache,
+                                                              false );
+  std::vector<Transform> outputs;
+  outputs.reserve( results.size() );
+  for ( BatchResult &result : results )
+    {
+    outputs.push_back( std::move( result.transform ) );
+    }
+  return outputs;
+}
+
+Transform ImageRegistrationMethod::ExecuteMultiStart ( const Image &inFixed,
+                                                       const Image &inMoving,
+                                                       const std::vector<Transform> &initialTransforms,
+                                                       unsigned int numberOfBestStarts )
+{
+  if ( initialTransforms.empty() )
+    {
+    sitkExceptionMacro( "At least one initial transform is required!" );
+    }
+
+  const std::vector<Image> images = this->CastToRegistrationPixelType( { inFixed, inMoving } );
+  const Image &fixed = images[0];
+  const Image &moving = images[1];
+
+  // the starts share the smoothed images, even when the cache is not
+  // kept between executions
+  std::shared_ptr<detail::PyramidCache> cache = m_PyramidCache;
+  if ( cache )
+    {
+    cache->Retain( images );
+    }
+  else
+    {
+    cache = std::make_shared<detail::PyramidCache>();
+    }
+
+  const size_t numberOfStarts = initialTransforms.size();
+  m_MultiStartMetricValues.assign( numberOfStarts, std::numeric_limits<double>::quiet_NaN() );
+  m_MultiStartBestIndex = 0;
+
+  std::vector<size_t> starts( numberOfStarts );
+  std::iota( starts.begin(), starts.end(), 0 );
+
+  if ( numberOfBestStarts > 0 && numberOfBestStarts < numberOfStarts && m_ShrinkFactorsPerLevel.size() > 1 )
+    {
+    // optimize all the starts on the first level, then keep the best
+    std::vector<BatchResult> coarse = this->ExecuteInParallel( std::vector<Image>( numberOfStarts, fixed ),
+                                                               std::vector<Image>( numberOfStarts, moving ),
+                                                               initialTransforms,
+                                                               1,
+                                                               cache,
+                                                               true );
+    auto metricValue = [&coarse]( size_t i )
+      {
+        return coarse[i].succeeded ? coarse[i].metricValue : std::numeric_limits<double>::infinity();
+      };
+    std::stable_sort( starts.begin(), starts.end(), [&metricValue]( size_t a, size_t b ) { return metricValue(a) < metricValue(b); } );
+    starts.resize( numberOfBestStarts );
+    std::sort( starts.begin(), starts.end() );
+    }
+
+  std::vector<Transform> selectedTransforms;
+  for ( size_t i : starts )
+    {
+    selectedTransforms.push_back( initialTransforms[i] );
+    }
+
+  std::vector<BatchResult> results = this->ExecuteInParallel( std::vector<Image>( starts.size(), fixed ),
+                                                              std::vector<Image>( starts.size(), moving ),
+                                                              selectedTransforms,
+                                                              0,
+                                                              cache,
+                                                              true );
+
+  const BatchResult *best = nullptr;
+  for ( size_t j = 0; j < results.size(); ++j )
+    {
+    if ( !results[j].succeeded )
+      {
+      continue;
+      }
+    m_MultiStartMetricValues[starts[j]] = results[j].metricValue;
+    if ( !best || results[j].metricValue < best->metricValue )
+      {
+      best = &results[j];
+      m_MultiStartBestIndex = static_cast<unsigned int>( starts[j] );
+      }
+    }
+
+  if ( !best )
+    {
+    sitkExceptionMacro( << "All the registrations from the initial transforms failed: "
+                        << results.front().stopConditionDescription );
+    }
+
+  m_StopConditionDescription = best->stopConditionDescription;
+  m_MetricValue = best->metricValue;
+  m_Iteration = best->iteration;
+  m_NumberOfValidPoints = best->numberOfValidPoints;
+
+  return best->transform;
+}
+
+std::vector<double> ImageRegistrationMethod::GetMultiStartMetricValues() const
+{
+  return m_MultiStartMetricValues;
+}
+
+unsigned int ImageRegistrationMethod::GetMultiStartBestIndex() const
+{
+  return m_MultiStartBestIndex;
+}
+
+Transform ImageRegistrationMethod::ExecuteExhaustiveSearch ( const Image &fixed,
+                                                             const Image &moving,
+                                                             unsigned int numberOfCandidates,
+                                                             unsigned int numberOfRefinements,
+                                                             double maximumSeconds )
+{
+  if ( m_OptimizerType != Exhaustive )
+    {
+    sitkExceptionMacro( "The optimizer must be set with SetOptimizerAsExhaustive!" );
+    }
+  if ( numberOfRefinements > 30 )
+    {
+    sitkExceptionMacro( "The number of refinements must not exceed 30!" );
+    }
+
+  const auto startTime = std::chrono::steady_clock::now();
+  auto timeExceeded = [startTime, maximumSeconds]
+    {
+      return maximumSeconds > 0.0 &&
+        std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count() > maximumSeconds;
+    };
+
+  ImageRegistrationMetricEvaluator evaluator = this->CreateMetricEvaluator( fixed, moving );
+
+  const unsigned int numberOfParameters = evaluator.GetNumberOfParameters();
+  if ( m_OptimizerNumberOfSteps.size() != numberOfParameters )
+    {
+    sitkExceptionMacro( << "The number of steps of the exhaustive optimizer ( " << m_OptimizerNumberOfSteps.size()
+                        << " ) does not match the number of parameters ( " << numberOfParameters << " )!" );
+    }
+
+  std::vector<double> scales( numberOfParameters, 1.0 );
+  if ( m_OptimizerScalesType == Manual && !m_OptimizerScales.empty() )
+    {
+    if ( m_OptimizerScales.size() != numberOfParameters )
+      {
+      sitkExceptionMacro( << "The number of optimizer scales ( " << m_OptimizerScales.size()
+                          << " ) does not match the number of parameters ( " << numberOfParameters << " )!" );
+      }
+    scales = m_OptimizerScales;
+    }
+
+  // The positions are integer offsets in units of the finest step,
+  // so that the neighbours of different candidates are only
+  // evaluated once.
+  using PositionType = std::vector<int64_t>;
+  const std::vector<double> center = m_InitialTransform.GetParameters();
+  const int64_t finestSteps = int64_t(1) << numberOfRefinements;
+  const double finestStepLength = m_OptimizerStepLength / finestSteps;
+
+  auto parametersOf = [&]( const PositionType &position )
+    {
+      std::vector<double> parameters( center );
+      for ( unsigned int i = 0; i < numberOfParameters; ++i )
+        {
+        parameters[i] += position[i] * finestStepLength * scales[i];
+        }
+      return parameters;
+    };
+
+  std::map<PositionType, double> values;
+  std::string stopCondition = "ExhaustiveSearch: Completed sampling of the grid and of its refinements.";
+  bool stopped = false;
+
+  // evaluate the new positions in chunks, checking the time and the
+  // cancellation between them
+  auto evaluate = [&]( const std::vector<PositionType> &positions )
+    {
+      const size_t chunkSize = std::max<size_t>( 64u, 16u * this->GetNumberOfThreads() );
+      for ( size_t begin = 0; begin < positions.size() && !stopped; begin += chunkSize )
+        {
+        this->ThrowIfCancelled();
+
+        const size_t end = std::min( positions.size(), begin + chunkSize );
+        std::vector< std::vector<double> > parameters;
+        parameters.reserve( end - begin );
+        for ( size_t i = begin; i < end; ++i )
+          {
+          parameters.push_back( parametersOf( positions[i] ) );
+          }
+        const std::vector<double> chunkValues = evaluator.Evaluate( parameters );
+        for ( size_t i = begin; i < end; ++i )
+          {
+          values[positions[i]] = chunkValues[i - begin];
+          }
+
+        if ( timeExceeded() )
+          {
+          stopCondition = "ExhaustiveSearch: The maximum time was exceeded.";
+          stopped = true;
+          }
+        }
+    };
+
+  // the grid of the exhaustive optimizer
+  std::vector<PositionType> positions;
+  PositionType index( numberOfParameters );
+  for ( unsigned int i = 0; i < numberOfParameters; ++i )
+    {
+    index[i] = -int64_t( m_OptimizerNumberOfSteps[i] );
+    }
+  for ( bool done = false; !done; )
+    {
+    PositionType position( numberOfParameters );
+    for ( unsigned int i = 0; i < numberOfParameters; ++i )
+      {
+      position[i] = index[i] * finestSteps;
+      }
+    positions.push_back( position );
+
+    done = true;
+    for ( unsigned int i = 0; i < numberOfParameters; ++i )
+      {
+      if ( index[i] < int64_t( m_OptimizerNumberOfSteps[i] ) )
+        {
+        ++index[i];
+        done = false;
+        break;
+        }
+      index[i] = -int64_t( m_OptimizerNumberOfSteps[i] );
+      }
+    }
+  evaluate( positions );
+
+  auto bestPositions = [&values, numberOfCandidates]
+    {
+      std::vector<std::pair<double, PositionType> > sorted;
+      sorted.reserve( values.size() );
+      for ( const auto &value : values )
+        {
+        sorted.emplace_back( value.second, value.first );
+        }
+      const size_t n = std::min<size_t>( std::max( numberOfCandidates, 1u ), sorted.size() );
+      std::partial_sort( sorted.begin(), sorted.begin() + n, sorted.end() );
+      std::vector<PositionType> best;
+      for ( size_t i = 0; i < n; ++i )
+        {
+        best.push_back( sorted[i].second );
+        }
+      return best;
+    };
+
+  // the searched parameters are those with steps on the grid
+  std::vector<unsigned int> searched;
+  for ( unsigned int i = 0; i < numberOfParameters; ++i )
+    {
+    if ( m_OptimizerNumberOfSteps[i] > 0 )
+      {
+      searched.push_back( i );
+      }
+    }
+
+  for ( unsigned int refinement = 1; refinement <= numberOfRefinements && !stopped && !searched.empty(); ++refinement )
+    {
+    const int64_t step = finestSteps >> refinement;
+
+    positions.clear();
+    std::set<PositionType> queued;
+    for ( const PositionType &candidate : bestPositions() )
+      {
+      // the neighbours at offsets of -1, 0 and 1 step on each searched
+      // parameter
+      std::vector<int> offset( searched.size(), -1 );
+      for ( bool done = false; !done; )
+        {
+        PositionType position( candidate );
+        for ( size_t j = 0; j < searched.size(); ++j )
+          {
+          position[searched[j]] += offset[j] * step;
+          }
+        if ( !values.count( position ) && queued.insert( position ).second )
+          {
+          positions.push_back( position );
+          }
+
+        done = true;
+        for ( size_t j = 0; j < searched.size(); ++j )
+          {
+          if ( offset[j] < 1 )
+            {
+            ++offset[j];
+            done = false;
+            break;
+            }
+          offset[j] = -1;
+          }
+        }
+      }
+    evaluate( positions );
+    }
+
+  if ( values.empty() )
+    {
+    sitkExceptionMacro( "The exhaustive search did not evaluate any parameters!" );
+    }
+
+  const PositionType best = bestPositions().front();
+
+  Transform outputTransform( m_InitialTransform );
+  outputTransform.SetParameters( parametersOf( best ) );
+
+  m_MetricValue = values[best];
+  m_Iteration = static_cast<unsigned int>( values.size() );
+  m_StopConditionDescription = stopCondition;
+
+  return outputTransform;
+}
+
+std::vector<ImageRegistrationMethod::BatchResult>
+ImageRegistrationMethod::ExecuteInParallel ( const std::vector<Image> &fixed,
+                                             const std::vector<Image> &moving,
+                                             std::vector<Transform> initialTransforms,
+                                             unsigned int numberOfLevels,
+                                             const std::shared_ptr<detail::PyramidCache> &pyramidCache,
+                                             bool continueOnFailure )
+{
+  assert( fixed.size() == moving.size() && moving.size() == initialTransforms.size() );
+
+  std::vector<BatchResult> results( moving.size() );
+  if ( moving.empty() )
+    {
+    return results;
+    }
+
+  this->ThrowIfCancelled();
+
+  // each registration optimizes its own copy of the initial transform
+  for ( Transform &transform : initialTransforms )
+    {
+    transform.MakeUnique();
+    }
+
+  unsigned int numberOfThreads = std::max( this->GetNumberOfThreads(), 1u );
+
+  std::unique_ptr<Executor> executor;
+  if ( this->HasExecutor() )
+    {
+    executor.reset( new Executor( this->GetExecutor() ) );
+    numberOfThreads = executor->AcquireThreads( numberOfThreads );
+    }
+  auto releaseThreads = make_scope_exit( [&executor, numberOfThreads] {
+      if ( executor )
+        {
+        executor->ReleaseThreads( numberOfThreads );
+        }
+    } );
+
+  // the threads are divided between the concurrent registrations,
+  // instead of each registration using all of them
+  const unsigned int numberOfWorkers = static_cast<unsigned int>( std::min<size_t>( numberOfThreads, moving.size() ) );
+  const unsigned int threadsPerRegistration = std::max( numberOfThreads / numberOfWorkers, 1u );
+
+  // The workers are configured on this thread, so the transforms and
+  // the masks are copied before the registrations start.
+  std::vector<std::unique_ptr<ImageRegistrationMethod> > workers;
+  for ( unsigned int w = 0; w < numberOfWorkers; ++w )
+    {
+    workers.emplace_back( new ImageRegistrationMethod() );
+    ImageRegistrationMethod &worker = *workers.back();
+    this->InitializeBatchWorker( worker, threadsPerRegistration );
+    worker.m_PyramidCache = pyramidCache;
+    if ( numberOfLevels > 0 )
+      {
+      worker.m_ShrinkFactorsPerLevel.resize( std::min<size_t>( numberOfLevels, worker.m_ShrinkFactorsPerLevel.size() ) );
+      worker.m_SmoothingSigmasPerLevel.resize( std::min<size_t>( numberOfLevels, worker.m_SmoothingSigmasPerLevel.size() ) );
+      if ( worker.m_MetricSamplingPercentage.size() > 1 )
+        {
+        worker.m_MetricSamplingPercentage.resize( std::min<size_t>( numberOfLevels, worker.m_MetricSamplingPercentage.size() ) );
+        }
+      if ( worker.m_TransformBSplineScaleFactors.size() > numberOfLevels )
+        {
+        worker.m_TransformBSplineScaleFactors.resize( numberOfLevels );
+        }
+      }
+    }
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool>   failed{false};
+  std::exception_ptr  firstException;
+  std::mutex          exceptionMutex;
+
+  auto work = [&]( unsigned int w )
+    {
+      ImageRegistrationMethod &worker = *workers[w];
+      try
+        {
+        for ( size_t i = next++; i < moving.size() && !failed; i = next++ )
+          {
+          BatchResult &result = results[i];
+          worker.m_InitialTransform = initialTransforms[i];
+          try
+            {
+            result.transform = worker.DispatchExecute( fixed[i], moving[i] );
+            result.succeeded = true;
+            result.metricValue = worker.m_MetricValue;
+            result.iteration = worker.m_Iteration;
+            result.numberOfValidPoints = worker.m_NumberOfValidPoints;
+            result.stopConditionDescription = worker.m_StopConditionDescription;
+            }
+          catch ( std::exception &e )
+            {
+            // a failed start does not stop the others, unless cancelled
+            if ( !continueOnFailure || ( worker.HasCancellationToken() && worker.GetCancellationToken().IsCancelled() ) )
+              {
+              throw;
+              }
+            result.stopConditionDescription = e.what();
+            }
+          }
+        }
+      catch (...)
+        {
+        std::lock_guard<std::mutex> lock( exceptionMutex );
+        if ( !firstException )
+          {
+          firstException = std::current_exception();
+          }
+        failed = true;
+        }
+    };
+
+  std::vector<std::thread> threads;
+  threads.reserve( numberOfWorkers - 1 );
+  for ( unsigned int w = 1; w < numberOfWorkers; ++w )
+    {
+    threads.emplace_back( work, w );
+    }
+  work( 0 );
+  for ( std::thread &thread : threads )
+    {
+    thread.join();
+    }
+
+  if ( firstException )
+    {
+    std::rethrow_exception( firstException );
+    }
+  return results;
+}
+
+void ImageRegistrationMethod::InitializeBatchWorker( ImageRegistrationMethod &worker, unsigned int numberOfThreads ) const
+{
+  worker.RemoveExecutor();
+  worker.SetNumberOfThreads( numberOfThreads );
+  if ( this->GetNumberOfWorkUnits() > 0 )
+    {
+    // the work units of the metric do not follow the threads of the
+    // worker with a deterministic reduction
+    worker.SetNumberOfWorkUnits( m_MetricUseDeterministicReduction ? this->GetNumberOfWorkUnits()
+                                 : std::min( this->GetNumberOfWorkUnits(), numberOfThreads ) );
+    }
+  worker.SetDebug( this->GetDebug() );
+  if ( this->HasCancellationToken() )
+    {
+    worker.SetCancellationToken( this->GetCancellationToken() );
+    }
+
+  worker.m_Interpolator = m_Interpolator;
+
+  // the transforms are deep copied so the workers do not share ITK
+  // transforms
+  worker.m_InitialTransform = m_InitialTransform;
+  worker.m_InitialTransform.MakeUnique();
+  worker.m_InitialTransformInPlace = m_InitialTransformInPlace;
+  worker.m_MovingInitialTransform = m_MovingInitialTransform;
+  worker.m_MovingInitialTransform.MakeUnique();
+  worker.m_FixedInitialTransform = m_FixedInitialTransform;
+  worker.m_FixedInitialTransform.MakeUnique();
+
+  worker.m_VirtualDomainSize = m_VirtualDomainSize;
+  worker.m_VirtualDomainOrigin = m_VirtualDomainOrigin;
+  worker.m_VirtualDomainSpacing = m_VirtualDomainSpacing;
+  worker.m_VirtualDomainDirection = m_VirtualDomainDirection;
+
+  worker.m_OptimizerType = m_OptimizerType;
+  worker.m_OptimizerLearningRate = m_OptimizerLearningRate;
+  worker.m_OptimizerMinimumStepLength = m_OptimizerMinimumStepLength;
+  worker.m_OptimizerNumberOfIterations = m_OptimizerNumberOfIterations;
+  worker.m_OptimizerLineSearchLowerLimit = m_OptimizerLineSearchLowerLimit;
+  worker.m_OptimizerLineSearchUpperLimit = m_OptimizerLineSearchUpperLimit;
+  worker.m_OptimizerLineSearchEpsilon = m_OptimizerLineSearchEpsilon;
+  worker.m_OptimizerLineSearchMaximumIterations = m_OptimizerLineSearchMaximumIterations;
+  worker.m_OptimizerEstimateLearningRate = m_OptimizerEstimateLearningRate;
+  worker.m_OptimizerMaximumStepSizeInPhysicalUnits = m_OptimizerMaximumStepSizeInPhysicalUnits;
+  worker.m_OptimizerRelaxationFactor = m_OptimizerRelaxationFactor;
+  worker.m_OptimizerGradientMagnitudeTolerance = m_OptimizerGradientMagnitudeTolerance;
+  worker.m_OptimizerConvergenceMinimumValue = m_OptimizerConvergenceMinimumValue;
+  worker.m_OptimizerConvergenceWindowSize = m_OptimizerConvergenceWindowSize;
+  worker.m_OptimizerGradientConvergenceTolerance = m_OptimizerGradientConvergenceTolerance;
+  worker.m_OptimizerMaximumNumberOfCorrections = m_OptimizerMaximumNumberOfCorrections;
+  worker.m_OptimizerMaximumNumberOfFunctionEvaluations = m_OptimizerMaximumNumberOfFunctionEvaluations;
+  worker.m_OptimizerCostFunctionConvergenceFactor = m_OptimizerCostFunctionConvergenceFactor;
+  worker.m_OptimizerLowerBound = m_OptimizerLowerBound;
+  worker.m_OptimizerUpperBound = m_OptimizerUpperBound;
+  worker.m_OptimizerTrace = m_OptimizerTrace;
+  worker.m_OptimizerNumberOfSteps = m_OptimizerNumberOfSteps;
+  worker.m_OptimizerStepLength = m_OptimizerStepLength;
+  worker.m_OptimizerSimplexDelta = m_OptimizerSimplexDelta;
+  worker.m_OptimizerParametersConvergenceTolerance = m_OptimizerParametersConvergenceTolerance;
+  worker.m_OptimizerFunctionConvergenceTolerance = m_OptimizerFunctionConvergenceTolerance;
+  worker.m_OptimizerWithRestarts = m_OptimizerWithRestarts;
+  worker.m_OptimizerMaximumLineIterations = m_OptimizerMaximumLineIterations;
+  worker.m_OptimizerStepTolerance = m_OptimizerStepTolerance;
+  worker.m_OptimizerValueTolerance = m_OptimizerValueTolerance;
+  worker.m_OptimizerEpsilon = m_OptimizerEpsilon;
+  worker.m_OptimizerInitialRadius = m_OptimizerInitialRadius;
+  worker.m_OptimizerGrowthFactor = m_OptimizerGrowthFactor;
+  worker.m_OptimizerShrinkFactor = m_OptimizerShrinkFactor;
+  worker.m_OptimizerSeed = m_OptimizerSeed;
+  worker.m_OptimizerSolutionAccuracy = m_OptimizerSolutionAccuracy;
+  worker.m_OptimizerHessianApproximationAccuracy = m_OptimizerHessianApproximationAccuracy;
+  worker.m_OptimizerDeltaConvergenceDistance = m_OptimizerDeltaConvergenceDistance;
+  worker.m_OptimizerDeltaConvergenceTolerance = m_OptimizerDeltaConvergenceTolerance;
+  worker.m_OptimizerLineSearchMaximumEvaluations = m_OptimizerLineSearchMaximumEvaluations;
+  worker.m_OptimizerLineSearchMinimumStep = m_OptimizerLineSearchMinimumStep;
+  worker.m_OptimizerLineSearchMaximumStep = m_OptimizerLineSearchMaximumStep;
+  worker.m_OptimizerLineSearchAccuracy = m_OptimizerLineSearchAccuracy;
+
+  worker.m_TransformBSplineScaleFactors = m_TransformBSplineScaleFactors;
+
+  worker.m_OptimizerWeights = m_OptimizerWeights;
+  worker.m_OptimizerStoppingRelativeMetricTolerance = m_OptimizerStoppingRelativeMetricTolerance;
+  worker.m_OptimizerStoppingWindowSize = m_OptimizerStoppingWindowSize;
+  worker.m_OptimizerStoppingMaximumSecondsPerLevel = m_OptimizerStoppingMaximumSecondsPerLevel;
+  worker.m_OptimizerStoppingMaximumNumberOfIterations = m_OptimizerStoppingMaximumNumberOfIterations;
+
+  worker.m_OptimizerScalesType = m_OptimizerScalesType;
+  worker.m_OptimizerScales = m_OptimizerScales;
+  worker.m_OptimizerScalesCentralRegionRadius = m_OptimizerScalesCentralRegionRadius;
+  worker.m_OptimizerScalesSmallParameterVariation = m_OptimizerScalesSmallParameterVariation;
+  worker.m_OptimizerScalesReuseAcrossLevels = m_OptimizerScalesReuseAcrossLevels;
+
+  worker.m_MetricType = m_MetricType;
+  worker.m_MetricRadius = m_MetricRadius;
+  worker.m_MetricIntensityDifferenceThreshold = m_MetricIntensityDifferenceThreshold;
+  worker.m_MetricNumberOfHistogramBins = m_MetricNumberOfHistogramBins;
+  worker.m_MetricVarianceForJointPDFSmoothing = m_MetricVarianceForJointPDFSmoothing;
+
+  // the masks are converted once, and shared by all the registrations
+  worker.m_MetricFixedMaskImage = m_MetricFixedMaskImage;
+  if ( m_MetricFixedMaskImage.GetSize() != std::vector<unsigned int>(m_MetricFixedMaskImage.GetDimension(), 0u)
+       && m_MetricFixedMaskImage.GetPixelID() != sitkUInt8 )
+    {
+    worker.m_MetricFixedMaskImage = Cast( m_MetricFixedMaskImage, sitkUInt8 );
+    }
+  worker.m_MetricMovingMaskImage = m_MetricMovingMaskImage;
+  if ( m_MetricMovingMaskImage.GetSize() != std::vector<unsigned int>(m_MetricMovingMaskImage.GetDimension(), 0u)
+       && m_MetricMovingMaskImage.GetPixelID() != sitkUInt8 )
+    {
+    worker.m_MetricMovingMaskImage = Cast( m_MetricMovingMaskImage, sitkUInt8 );
+    }
+
+  worker.m_MetricSamplingPercentage = m_MetricSamplingPercentage;
+  worker.m_MetricSamplingStrategy = m_MetricSamplingStrategy;
+  worker.m_MetricSamplingSeed = m_MetricSamplingSeed;
+
+  worker.m_MetricUseFixedImageGradientFilter = m_MetricUseFixedImageGradientFilter;
+  worker.m_MetricUseMovingImageGradientFilter = m_MetricUseMovingImageGradientFilter;
+  worker.m_MetricUseFixedMaskBoundingBox = m_MetricUseFixedMaskBoundingBox;
+  worker.m_MetricUseDeterministicReduction = m_MetricUseDeterministicReduction;
+
+  worker.m_ShrinkFactorsPerLevel = m_ShrinkFactorsPerLevel;
+  worker.m_SmoothingSigmasPerLevel = m_SmoothingSigmasPerLevel;
+  worker.m_SmoothingSigmasAreSpecifiedInPhysicalUnits = m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
+  worker.m_PyramidCacheImageGradients = m_PyramidCacheImageGradients;
+  worker.m_Profiling = m_Profiling;
+  worker.m_UseSinglePrecision = m_UseSinglePrecision;
+}
+
 template<class TImageType>
 Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const Image &inMoving )
 {
@@ -801,7 +1824,7 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
   //using SpatialObjectMaskType = itk::SpatialObject<ImageDimension>;
 
 
-  using RegistrationType = itk::ImageRegistrationMethodv4<FixedImageType, MovingImageType>;
+  using RegistrationType = SampledImageRegistrationMethod<FixedImageType>;
   typename RegistrationType::Pointer   registration  = RegistrationType::New();
 
   // this variable will hold the initial moving then fixed, then the
@@ -849,13 +1872,16 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
   this->m_ActiveOptimizer = optimizer;
   const bool stashedDebug = this->GetDebug();
   this->DebugOff();
+  {
+  // restore the debug flag when PreUpdate throws, e.g. when cancelled
+  auto restoreDebug = make_scope_exit([this, stashedDebug]{this->SetDebug(stashedDebug);});
   this->PreUpdate( registration.GetPointer() );
-  this->SetDebug(stashedDebug);
+  }
 
 
   // Get the pointer to the ITK image contained in image1
-  typename FixedImageType::ConstPointer fixed = this->CastImageToITK<FixedImageType>( inFixed );
-  typename MovingImageType::ConstPointer moving = this->CastImageToITK<MovingImageType>( inMoving );
+  typename FixedImageType::ConstPointer fixed = ShareImageBuffer( this->CastImageToITK<FixedImageType>( inFixed ).GetPointer() );
+  typename MovingImageType::ConstPointer moving = ShareImageBuffer( this->CastImageToITK<MovingImageType>( inMoving ).GetPointer() );
 
   typedef itk::ImageToImageMetricv4<FixedImageType, MovingImageType> _MetricType;
   typename _MetricType::Pointer metric = this->CreateMetric<FixedImageType>();
@@ -879,6 +1905,18 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
 
   // todo test enum match
   typename RegistrationType::MetricSamplingStrategyEnum itkSamplingStrategy = static_cast<typename RegistrationType::MetricSamplingStrategyEnum>(int(m_MetricSamplingStrategy));
+  if ( RegistrationType::IsAdditionalStrategy( m_MetricSamplingStrategy ) )
+    {
+    // the sampled points are generated by SampledImageRegistrationMethod
+    itkSamplingStrategy = RegistrationType::MetricSamplingStrategyEnum::RANDOM;
+    registration->SetSampling( m_MetricSamplingStrategy, m_MetricSamplingPercentage, m_MetricSamplingSeed );
+    }
+  else if ( m_MetricSamplingStrategy == NONE && this->UseFixedMaskBoundingBox() )
+    {
+    // the points inside the mask are generated by SampledImageRegistrationMethod
+    itkSamplingStrategy = RegistrationType::MetricSamplingStrategyEnum::RANDOM;
+    registration->SetDenseFixedMaskSampling( true );
+    }
   registration->SetMetricSamplingStrategy(itkSamplingStrategy);
 
   if (m_MetricSamplingPercentage.size()==1)
@@ -943,6 +1981,16 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
     scalesEstimator->SetMetric( metric );
     scalesEstimator->SetTransformForward( true );
     optimizer->SetScalesEstimator( scalesEstimator );
+    registration->SetReuseOptimizerScales( m_OptimizerScalesReuseAcrossLevels );
+    }
+  else if ( m_OptimizerScalesType == ImageExtent )
+    {
+    if ( itkTx->GetTransformCategory() != itk::TransformBase::TransformCategoryEnum::Linear )
+      {
+      sitkExceptionMacro( "The optimizer scales from the image extent require a linear transform, not a "
+                          << itkTx->GetNameOfClass() << "!" );
+      }
+    optimizer->SetScales( ComputeScalesFromImageExtent<ImageDimension>( itkTx, fixed.GetPointer() ) );
     }
   else if ( !m_OptimizerScales.empty() )
     {
@@ -959,6 +2007,38 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
 
   m_pfGetCurrentLevel = std::bind(&CurrentLevelCustomCast::CustomCast<RegistrationType>,registration.GetPointer());
 
+  this->AddOptimizerStoppingPolicyObserver( optimizer.GetPointer() );
+
+  m_Profile.clear();
+  std::shared_ptr<detail::RegistrationProfiler> profiler;
+  if ( m_Profiling )
+    {
+    profiler = std::make_shared<detail::RegistrationProfiler>();
+    registration->SetProfiler( profiler.get() );
+
+    // the optimizer starts iterating after estimating the scales
+    optimizer->AddObserver( itk::StartEvent(), [profiler]( const itk::EventObject & ) {
+        profiler->OptimizerStarted();
+      } );
+    optimizer->AddObserver( itk::IterationEvent(), [this, profiler]( const itk::EventObject & ) {
+        profiler->Iteration( this->GetMetricValue(), this->GetMetricNumberOfValidPoints() );
+      } );
+    }
+  auto finishProfile = make_scope_exit( [this, &profiler] {
+      if ( profiler )
+        {
+        m_Profile = profiler->Finish();
+        }
+    } );
+
+
+  if ( m_PyramidCache )
+    {
+    detail::PyramidCache::RegisterImageType<FixedImageType>();
+    }
+  detail::PyramidCache::ScopedActivation activePyramidCache( m_PyramidCache.get(),
+                                                             { inFixed, inMoving },
+                                                             m_PyramidCacheImageGradients );
 
   try
     {
@@ -978,11 +2058,24 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
 
   // update measurements
   m_StopConditionDescription = registration->GetOptimizer()->GetStopConditionDescription();
+  if ( !m_OptimizerStoppingCondition.empty() )
+    {
+    m_StopConditionDescription = m_OptimizerStoppingCondition + " " + m_StopConditionDescription;
+    }
 
   m_MetricValue = this->GetMetricValue();
   m_Iteration = this->GetOptimizerIteration();
   m_NumberOfValidPoints = this->GetMetricNumberOfValidPoints();
 
+  m_RegistrationState = ImageRegistrationState();
+  m_RegistrationState.m_OptimizerScales = this->GetOptimizerScales();
+  m_RegistrationState.m_OptimizerLearningRate = this->GetOptimizerLearningRate();
+  m_RegistrationState.m_Level = std::min( this->GetCurrentLevel(), static_cast<unsigned int>( m_ShrinkFactorsPerLevel.size() ) - 1 )
+    + m_WarmStartLevelOffset;
+  m_RegistrationState.m_MetricValue = m_MetricValue;
+
+  this->ThrowIfCancelled();
+
   if (this->m_InitialTransformInPlace)
     {
     if (m_pfUpdateWithBestValue)
@@ -999,6 +2092,18 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
     // which accepts an arbitrary ITK transform.
     typename RegistrationType::OutputTransformType* itkOutTx = registration->GetModifiableTransform();
 
+    // The optimized displacement field is returned as is, so that it
+    // is shared with the DisplacementFieldTransform of the result
+    // instead of being copied out of a composite.
+    if ( itkOutTx->GetTransformCategory() == itk::TransformBase::TransformCategoryEnum::DisplacementField )
+      {
+      if (m_pfUpdateWithBestValue)
+        {
+        m_pfUpdateWithBestValue(itkOutTx);
+        }
+      return Transform(itkOutTx);
+      }
+
     using CompositeTransformType = itk::CompositeTransform<double, ImageDimension>;
 
     typename CompositeTransformType::Pointer comp = CompositeTransformType::New();
@@ -1015,8 +2120,12 @@ Transform ImageRegistrationMethod::ExecuteInternal ( const Image &inFixed, const
 }
 
 
-double ImageRegistrationMethod::MetricEvaluate ( const Image &fixed, const Image & moving )
+double ImageRegistrationMethod::MetricEvaluate ( const Image &inFixed, const Image & inMoving )
 {
+  const std::vector<Image> images = this->CastToRegistrationPixelType( { inFixed, inMoving } );
+  const Image &fixed = images[0];
+  const Image &moving = images[1];
+
   const PixelIDValueType fixedType = fixed.GetPixelIDValue();
   const unsigned int fixedDim = fixed.GetDimension();
   if ( fixed.GetPixelIDValue() != moving.GetPixelIDValue() )
@@ -1042,13 +2151,120 @@ double ImageRegistrationMethod::MetricEvaluate ( const Image &fixed, const Image
 
 
 
+ImageRegistrationMetricEvaluator ImageRegistrationMethod::CreateMetricEvaluator ( const Image &inFixed, const Image &inMoving )
+{
+  const std::vector<Image> images = this->CastToRegistrationPixelType( { inFixed, inMoving } );
+  const Image &fixed = images[0];
+  const Image &moving = images[1];
+
+  const PixelIDValueType fixedType = fixed.GetPixelIDValue();
+  const unsigned int fixedDim = fixed.GetDimension();
+  if ( fixed.GetPixelIDValue() != moving.GetPixelIDValue() )
+    {
+    sitkExceptionMacro ( << "Fixed and moving images must be the same datatype! Got "
+                         << fixed.GetPixelIDValue() << " and " << moving.GetPixelIDValue() );
+    }
+
+  if ( fixed.GetDimension() != moving.GetDimension() )
+    {
+    sitkExceptionMacro ( << "Fixed and moving images must be the same dimensionality! Got "
+                         << fixed.GetDimension() << " and " << moving.GetDimension() );
+    }
+
+  if (this->m_MetricEvaluatorMemberFactory->HasMemberFunction( fixedType, fixedDim ) )
+    {
+    return this->m_MetricEvaluatorMemberFactory->GetMemberFunction( fixedType, fixedDim )( fixed, moving );
+    }
+
+  sitkExceptionMacro( << "Filter does not support fixed image type: " << itk::simple::GetPixelIDValueAsString (fixedType) );
+}
+
+
 template<class TImageType>
 double ImageRegistrationMethod::EvaluateInternal ( const Image &inFixed, const Image &inMoving )
+{
+  using FixedImageType = TImageType;
+  using MovingImageType = TImageType;
+
+  // Get the pointer to the ITK image contained in image1
+  typename FixedImageType::ConstPointer fixed = this->CastImageToITK<FixedImageType>( inFixed );
+  typename MovingImageType::ConstPointer moving = this->CastImageToITK<MovingImageType>( inMoving );
+
+  typedef itk::ImageToImageMetricv4<FixedImageType, MovingImageType> _MetricType;
+  typename _MetricType::Pointer metric = this->CreateInitializedMetric<FixedImageType>( fixed.GetPointer(),
+                                                                                        moving.GetPointer(),
+                                                                                        this->m_InitialTransform );
+  metric->UnRegister();
+
+  return metric->GetValue();
+}
+
+
+template<class TImageType>
+ImageRegistrationMetricEvaluator ImageRegistrationMethod::CreateMetricEvaluatorInternal ( const Image &inFixed, const Image &inMoving )
+{
+  typedef itk::ImageToImageMetricv4<TImageType, TImageType> _MetricType;
+
+  // The metrics are created from a copy of the configuration and of
+  // the transforms, so the evaluator does not depend on this object.
+  std::shared_ptr<ImageRegistrationMethod> method = std::make_shared<ImageRegistrationMethod>();
+  this->InitializeBatchWorker( *method, this->GetNumberOfThreads() );
+
+  // keeping the images makes a later modification of them copy their
+  // buffer
+  const Image fixedImage = inFixed;
+  const Image movingImage = inMoving;
+
+  auto createInstance = [method, fixedImage, movingImage]()
+    {
+      typename TImageType::ConstPointer fixed = ImageRegistrationMethod::CastImageToITK<TImageType>( fixedImage );
+      typename TImageType::ConstPointer moving = ImageRegistrationMethod::CastImageToITK<TImageType>( movingImage );
+
+      // each instance optimizes its own initial transform
+      Transform initialTransform = method->m_InitialTransform;
+      initialTransform.MakeUnique();
+
+      typename _MetricType::Pointer metric = method->CreateInitializedMetric<TImageType>( fixed.GetPointer(),
+                                                                                          moving.GetPointer(),
+                                                                                          initialTransform );
+      metric->UnRegister();
+
+      detail::MetricEvaluatorImpl::InstanceType instance;
+      instance.metric = metric.GetPointer();
+      _MetricType *m = metric.GetPointer();
+      const unsigned int deterministicWorkUnits = method->DeterministicNumberOfWorkUnits();
+      instance.setMaximumNumberOfWorkUnits = [m, deterministicWorkUnits]( unsigned int numberOfWorkUnits ) {
+        m->SetMaximumNumberOfWorkUnits( deterministicWorkUnits > 0 ? deterministicWorkUnits : numberOfWorkUnits );
+      };
+      return instance;
+    };
+
+  std::unique_ptr<Executor> executor;
+  if ( this->HasExecutor() )
+    {
+    executor.reset( new Executor( this->GetExecutor() ) );
+    }
+
+  const unsigned int numberOfThreads = ( this->GetNumberOfWorkUnits() > 0 ) ? std::min( this->GetNumberOfWorkUnits(), this->GetNumberOfThreads() ) : this->GetNumberOfThreads();
+
+  return ImageRegistrationMetricEvaluator( std::make_shared<detail::MetricEvaluatorImpl>( createInstance,
+                                                                                          numberOfThreads,
+                                                                                          std::move( executor ) ) );
+}
+
+
+template <class TImageType>
+itk::ImageToImageMetricv4<TImageType,
+                          TImageType,
+                          TImageType,
+                          double,
+                          itk::DefaultImageToImageMetricTraitsv4< TImageType, TImageType, TImageType, double >
+                          >*
+ImageRegistrationMethod::CreateInitializedMetric( const TImageType *fixed, const TImageType *moving, Transform &initialTransform )
 {
   using FixedImageType = TImageType;
   using MovingImageType = TImageType;
   const unsigned int ImageDimension = FixedImageType::ImageDimension;
-  //using SpatialObjectMaskType = itk::SpatialObject<ImageDimension>;
 
  using RegistrationType = itk::ImageRegistrationMethodv4<FixedImageType, MovingImageType>;
 
@@ -1056,15 +2272,11 @@ double ImageRegistrationMethod::EvaluateInternal ( const Image &inFixed, const I
   // initial to optimize.
   const std::string strIdentityTransform = "IdentityTransform";
 
-  // Get the pointer to the ITK image contained in image1
-  typename FixedImageType::ConstPointer fixed = this->CastImageToITK<FixedImageType>( inFixed );
-  typename MovingImageType::ConstPointer moving = this->CastImageToITK<MovingImageType>( inMoving );
-
   typedef itk::ImageToImageMetricv4<FixedImageType, MovingImageType> _MetricType;
   typename _MetricType::Pointer metric = this->CreateMetric<FixedImageType>();
   metric->UnRegister();
 
-  this->SetupMetric(metric.GetPointer(), fixed.GetPointer(), moving.GetPointer());
+  this->SetupMetric(metric.GetPointer(), fixed, moving);
 
   metric->SetFixedImage(fixed);
   metric->SetMovingImage(moving);
@@ -1094,16 +2306,121 @@ double ImageRegistrationMethod::EvaluateInternal ( const Image &inFixed, const I
     }
 
   typename RegistrationType::InitialTransformType *itkTx;
-  if ( !(itkTx = dynamic_cast<typename RegistrationType::InitialTransformType *>(this->m_InitialTransform.GetITKBase())) )
+  if ( !(itkTx = dynamic_cast<typename RegistrationType::InitialTransformType *>(initialTransform.GetITKBase())) )
     {
     sitkExceptionMacro( "Unexpected error converting initial transform! Possible miss matching dimensions!" );
     }
   movingInitialCompositeTransform->AddTransform(itkTx);
+  movingInitialCompositeTransform->SetOnlyMostRecentTransformToOptimizeOn();
   metric->SetMovingTransform(movingInitialCompositeTransform);
 
   metric->Initialize();
 
-  return metric->GetValue();
+  metric->Register();
+  return metric.GetPointer();
+}
+
+
+unsigned int ImageRegistrationMethod::DeterministicNumberOfWorkUnits() const
+{
+  if ( !m_MetricUseDeterministicReduction )
+    {
+    return 0;
+    }
+  return ( this->GetNumberOfWorkUnits() > 0 ) ? this->GetNumberOfWorkUnits() : 64u;
+}
+
+bool ImageRegistrationMethod::UseFixedMaskBoundingBox() const
+{
+  // the domain of a transform with local support, such as a
+  // displacement field, must match the virtual domain
+  return m_MetricUseFixedMaskBoundingBox &&
+    m_MetricFixedMaskImage.GetSize() != std::vector<unsigned int>(m_MetricFixedMaskImage.GetDimension(), 0u) &&
+    std::string("IdentityTransform") == m_FixedInitialTransform.GetITKBase()->GetNameOfClass() &&
+    m_InitialTransform.GetITKBase()->GetTransformCategory() == itk::TransformBase::TransformCategoryEnum::Linear;
+}
+
+
+template<unsigned int VDimension>
+itk::ImageRegion<VDimension>
+ImageRegistrationMethod::FixedMaskBoundingRegion( const itk::ImageBase<VDimension> *virtualDomain ) const
+{
+  using MaskImageType = itk::Image<uint8_t, VDimension>;
+
+  if ( m_MetricFixedMaskImage.GetDimension() != VDimension )
+    {
+    sitkExceptionMacro("FixedMaskImage does not match dimension of then fixed image!");
+    }
+
+  Image mask = m_MetricFixedMaskImage;
+  if ( mask.GetPixelID() != sitkUInt8 )
+    {
+    mask = Cast( mask, sitkUInt8 );
+    }
+  typename MaskImageType::ConstPointer itkMask = this->CastImageToITK<MaskImageType>( mask );
+
+  // the bounding box of the non-zero pixels in the mask
+  const typename MaskImageType::RegionType maskRegion = itkMask->GetLargestPossibleRegion();
+  typename MaskImageType::IndexType lower = maskRegion.GetUpperIndex();
+  typename MaskImageType::IndexType upper = maskRegion.GetIndex();
+  bool empty = true;
+  for ( itk::ImageRegionConstIteratorWithIndex<MaskImageType> it( itkMask, maskRegion ); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() )
+      {
+      const typename MaskImageType::IndexType index = it.GetIndex();
+      empty = false;
+      for ( unsigned int d = 0; d < VDimension; ++d )
+        {
+        lower[d] = std::min( lower[d], index[d] );
+        upper[d] = std::max( upper[d], index[d] );
+        }
+      }
+    }
+
+  const itk::ImageRegion<VDimension> virtualRegion = virtualDomain->GetLargestPossibleRegion();
+  if ( empty )
+    {
+    return virtualRegion;
+    }
+
+  // the virtual pixels overlapping the corners of the mask pixels,
+  // with a pixel of margin for the interpolation
+  itk::ContinuousIndex<double, VDimension> virtualLower;
+  itk::ContinuousIndex<double, VDimension> virtualUpper;
+  virtualLower.Fill( std::numeric_limits<double>::max() );
+  virtualUpper.Fill( std::numeric_limits<double>::lowest() );
+  for ( unsigned int corner = 0; corner < ( 1u << VDimension ); ++corner )
+    {
+    itk::ContinuousIndex<double, VDimension> maskIndex;
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      maskIndex[d] = ( corner & ( 1u << d ) ) ? upper[d] + 0.5 : lower[d] - 0.5;
+      }
+    typename MaskImageType::PointType point;
+    itkMask->TransformContinuousIndexToPhysicalPoint( maskIndex, point );
+    itk::ContinuousIndex<double, VDimension> virtualIndex;
+    virtualDomain->TransformPhysicalPointToContinuousIndex( point, virtualIndex );
+    for ( unsigned int d = 0; d < VDimension; ++d )
+      {
+      virtualLower[d] = std::min( virtualLower[d], virtualIndex[d] );
+      virtualUpper[d] = std::max( virtualUpper[d], virtualIndex[d] );
+      }
+    }
+
+  itk::ImageRegion<VDimension> region;
+  for ( unsigned int d = 0; d < VDimension; ++d )
+    {
+    const itk::IndexValueType begin = static_cast<itk::IndexValueType>( std::floor( virtualLower[d] + 0.5 ) ) - 1;
+    const itk::IndexValueType end = static_cast<itk::IndexValueType>( std::ceil( virtualUpper[d] - 0.5 ) ) + 1;
+    region.SetIndex( d, begin );
+    region.SetSize( d, static_cast<itk::SizeValueType>( std::max<itk::IndexValueType>( end - begin + 1, 1 ) ) );
+    }
+  if ( !region.Crop( virtualRegion ) )
+    {
+    return virtualRegion;
+    }
+  return region;
 }
 
 
@@ -1123,7 +2440,11 @@ ImageRegistrationMethod::SetupMetric(
   const unsigned int ImageDimension = FixedImageType::ImageDimension;
   using SpatialObjectMaskType = itk::SpatialObject<ImageDimension>;
 
-  if (this->GetNumberOfWorkUnits() > 0)
+  if ( this->DeterministicNumberOfWorkUnits() > 0 )
+    {
+    metric->SetMaximumNumberOfWorkUnits( this->DeterministicNumberOfWorkUnits() );
+    }
+  else if (this->GetNumberOfWorkUnits() > 0)
     {
     metric->SetMaximumNumberOfWorkUnits(this->GetNumberOfWorkUnits());
     }
@@ -1131,16 +2452,36 @@ ImageRegistrationMethod::SetupMetric(
   metric->SetUseFixedImageGradientFilter( m_MetricUseFixedImageGradientFilter );
   metric->SetUseMovingImageGradientFilter( m_MetricUseMovingImageGradientFilter );
 
-  if ( !this->m_VirtualDomainSize.empty() )
+  if ( !this->m_VirtualDomainSize.empty() || this->UseFixedMaskBoundingBox() )
     {
-    typename FixedImageType::SpacingType itkSpacing = sitkSTLVectorToITK<typename FixedImageType::SpacingType>(this->m_VirtualDomainSpacing);
-    typename FixedImageType::PointType itkOrigin = sitkSTLVectorToITK<typename FixedImageType::PointType>(this->m_VirtualDomainOrigin);
-    typename FixedImageType::DirectionType itkDirection = sitkSTLToITKDirection<typename FixedImageType::DirectionType>(this->m_VirtualDomainDirection);
+    typename FixedImageType::Pointer virtualDomain = FixedImageType::New();
+    if ( !this->m_VirtualDomainSize.empty() )
+      {
+      typename FixedImageType::RegionType itkRegion;
+      itkRegion.SetSize( sitkSTLVectorToITK<typename FixedImageType::SizeType>( this->m_VirtualDomainSize ) );
 
-    typename FixedImageType::RegionType itkRegion;
-    itkRegion.SetSize( sitkSTLVectorToITK<typename FixedImageType::SizeType>( this->m_VirtualDomainSize ) );
+      virtualDomain->SetSpacing( sitkSTLVectorToITK<typename FixedImageType::SpacingType>(this->m_VirtualDomainSpacing) );
+      virtualDomain->SetOrigin( sitkSTLVectorToITK<typename FixedImageType::PointType>(this->m_VirtualDomainOrigin) );
+      virtualDomain->SetDirection( sitkSTLToITKDirection<typename FixedImageType::DirectionType>(this->m_VirtualDomainDirection) );
+      virtualDomain->SetRegions( itkRegion );
+      }
+    else
+      {
+      virtualDomain->CopyInformation( fixed );
+      virtualDomain->SetRegions( fixed->GetLargestPossibleRegion() );
+      }
 
-    metric->SetVirtualDomain( itkSpacing, itkOrigin, itkDirection, itkRegion );
+    typename FixedImageType::RegionType itkRegion = virtualDomain->GetLargestPossibleRegion();
+    typename FixedImageType::PointType itkOrigin = virtualDomain->GetOrigin();
+    if ( this->UseFixedMaskBoundingBox() )
+      {
+      // the region starts at the origin of the cropped domain
+      itkRegion = this->FixedMaskBoundingRegion<ImageDimension>( virtualDomain.GetPointer() );
+      virtualDomain->TransformIndexToPhysicalPoint( itkRegion.GetIndex(), itkOrigin );
+      itkRegion.SetIndex( typename FixedImageType::IndexType() );
+      }
+
+    metric->SetVirtualDomain( virtualDomain->GetSpacing(), itkOrigin, virtualDomain->GetDirection(), itkRegion );
     }
 
   using FixedInterpolatorType = itk::InterpolateImageFunction< FixedImageType, double >;
@@ -1179,6 +2520,18 @@ ImageRegistrationMethod::SetupMetric(
 void ImageRegistrationMethod::PreUpdate( itk::ProcessObject *p )
 {
   Superclass::PreUpdate(p);
+
+  // stop the optimizer when cancelled
+  if ( this->HasCancellationToken() )
+    {
+    assert(this->m_ActiveOptimizer);
+    this->m_ActiveOptimizer->AddObserver(GetITKEventObject(sitkIterationEvent), [this](const itk::EventObject &) {
+      if ( this->IsCancelled() )
+        {
+        this->StopRegistration();
+        }
+    });
+    }
 }
 
 
@@ -26,6 +26,7 @@
 #include "itkJointHistogramMutualInformationImageToImageMetricv4.h"
 #include "itkMeanSquaresImageToImageMetricv4.h"
 #include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "sitkSparseBSplineMeanSquaresMetric.h"
 
 namespace itk
 {
@@ -34,6 +35,10 @@ namespace simple
 
 namespace
 {
+  // number of parameters of the transforms which are not linear, up
+  // to which the Mattes metric uses explicit PDF derivatives
+  constexpr unsigned int MattesMutualInformationMaximumNumberOfExplicitPDFDerivatives = 32;
+
   struct NumberOfValidPointsCustomCast
   {
     template<typename TMetric>
@@ -101,6 +106,15 @@ ImageRegistrationMethod::CreateMetric( )
     }
     case MeanSquares:
     {
+      if ( m_InitialTransform.GetITKBase()->GetTransformCategory() == itk::TransformBase::TransformCategoryEnum::BSpline )
+        {
+        // only visit the local support of the BSpline for the derivative
+        typedef detail::SparseBSplineMeanSquaresMetric< FixedImageType > _MetricType;
+        typename _MetricType::Pointer metric = _MetricType::New();
+        this->m_pfGetMetricNumberOfValidPoints = std::bind(&NumberOfValidPointsCustomCast::CustomCast<_MetricType>,metric.GetPointer());
+        metric->Register();
+        return metric.GetPointer();
+        }
       typedef itk::MeanSquaresImageToImageMetricv4< FixedImageType, MovingImageType > _MetricType;
       typename _MetricType::Pointer metric = _MetricType::New();
       this->m_pfGetMetricNumberOfValidPoints = std::bind(&NumberOfValidPointsCustomCast::CustomCast<_MetricType>,metric.GetPointer());
@@ -113,6 +127,17 @@ ImageRegistrationMethod::CreateMetric( )
       typename _MetricType::Pointer metric = _MetricType::New();
       this->m_pfGetMetricNumberOfValidPoints = std::bind(&NumberOfValidPointsCustomCast::CustomCast<_MetricType>,metric.GetPointer());
       metric->SetNumberOfHistogramBins(m_MetricNumberOfHistogramBins);
+
+      // The explicit derivatives of the joint PDF, a histogram per
+      // parameter, are fastest for a few parameters with a dense
+      // Jacobian. With the local support of the BSpline and field
+      // transforms, or many parameters, the derivative is accumulated
+      // per sample instead.
+      const bool useExplicitPDFDerivatives =
+        m_InitialTransform.IsLinear()
+        || m_InitialTransform.GetNumberOfParameters() <= MattesMutualInformationMaximumNumberOfExplicitPDFDerivatives;
+      metric->SetUseExplicitPDFDerivatives( useExplicitPDFDerivatives );
+
       metric->Register();
       return metric.GetPointer();
     }
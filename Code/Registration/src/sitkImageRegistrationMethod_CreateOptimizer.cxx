@@ -29,6 +29,13 @@
 #include "itkPowellOptimizerv4.h"
 
 #include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <sstream>
 
 
 namespace {
@@ -406,5 +413,88 @@ namespace simple
       }
   }
 
+
+  void ImageRegistrationMethod::AddOptimizerStoppingPolicyObserver( itk::ObjectToObjectOptimizerBaseTemplate<double> *optimizer )
+  {
+    m_OptimizerStoppingCondition.clear();
+
+    if ( m_OptimizerStoppingRelativeMetricTolerance <= 0.0 &&
+         m_OptimizerStoppingMaximumSecondsPerLevel <= 0.0 &&
+         m_OptimizerStoppingMaximumNumberOfIterations == 0 )
+      {
+      return;
+      }
+
+    if ( !m_pfOptimizerStopRegistration )
+      {
+      sitkWarningMacro( "The optimizer does not support user stopping, the stopping policy is ignored." );
+      return;
+      }
+
+    using ClockType = std::chrono::steady_clock;
+
+    struct StateType
+    {
+      unsigned int level = std::numeric_limits<unsigned int>::max();
+      ClockType::time_point levelStart;
+      std::deque<double> values;
+      unsigned int numberOfIterations = 0;
+    };
+    auto state = std::make_shared<StateType>();
+
+    optimizer->AddObserver( itk::IterationEvent(), [this, state]( const itk::EventObject & ) {
+        const unsigned int level = this->m_pfGetCurrentLevel ? this->m_pfGetCurrentLevel() : 0;
+        if ( level != state->level )
+          {
+          state->level = level;
+          state->levelStart = ClockType::now();
+          state->values.clear();
+          }
+
+        std::ostringstream reason;
+        ++state->numberOfIterations;
+
+        if ( m_OptimizerStoppingMaximumNumberOfIterations > 0 &&
+             state->numberOfIterations >= m_OptimizerStoppingMaximumNumberOfIterations )
+          {
+          reason << "Maximum number of iterations (" << m_OptimizerStoppingMaximumNumberOfIterations << ") reached.";
+          }
+        else if ( m_OptimizerStoppingMaximumSecondsPerLevel > 0.0 &&
+                  std::chrono::duration<double>( ClockType::now() - state->levelStart ).count() >= m_OptimizerStoppingMaximumSecondsPerLevel )
+          {
+          reason << "Maximum time of " << m_OptimizerStoppingMaximumSecondsPerLevel << " seconds reached at level " << level << ".";
+          }
+        else if ( m_OptimizerStoppingRelativeMetricTolerance > 0.0 )
+          {
+          state->values.push_back( this->m_pfGetMetricValue() );
+          if ( state->values.size() > m_OptimizerStoppingWindowSize )
+            {
+            state->values.pop_front();
+            }
+          if ( state->values.size() == m_OptimizerStoppingWindowSize )
+            {
+            const auto minmax = std::minmax_element( state->values.begin(), state->values.end() );
+            double mean = 0.0;
+            for ( double v : state->values )
+              {
+              mean += v;
+              }
+            mean /= state->values.size();
+            const double range = *minmax.second - *minmax.first;
+            if ( range <= m_OptimizerStoppingRelativeMetricTolerance * std::max( std::abs( mean ), std::numeric_limits<double>::epsilon() ) )
+              {
+              reason << "Metric plateau over " << m_OptimizerStoppingWindowSize << " iterations at level " << level << ".";
+              }
+            }
+          }
+
+        if ( reason.tellp() > 0 )
+          {
+          m_OptimizerStoppingCondition = reason.str();
+          this->m_pfOptimizerStopRegistration();
+          }
+      } );
+  }
+
 }
 }
@@ -0,0 +1,514 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageRegistrationMethod_MetricSampling_hxx
+#define sitkImageRegistrationMethod_MetricSampling_hxx
+
+#include "sitkImageRegistrationMethod.h"
+#include "sitkRegistrationProfiler.h"
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkGradientMagnitudeRecursiveGaussianImageFilter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkImageRegionIndexRange.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <random>
+
+namespace itk
+{
+namespace simple
+{
+namespace
+{
+
+// Radical inverse of index in base, the Halton sequence of a dimension.
+inline double HaltonValue( uint64_t index, unsigned int base )
+{
+  double value = 0.0;
+  double factor = 1.0 / base;
+  while ( index > 0 )
+    {
+    value += factor * ( index % base );
+    index /= base;
+    factor /= base;
+    }
+  return value;
+}
+
+/** Sobol sequence of up to 4 dimensions, with the direction numbers of
+ * Joe and Kuo, generated in Gray code order. */
+class SobolSequence
+{
+public:
+  static constexpr unsigned int MaximumDimension = 4;
+
+  explicit SobolSequence( unsigned int dimension )
+    : m_Dimension( dimension ),
+      m_Index( 0 ),
+      m_State( dimension, 0u )
+    {
+      // primitive polynomial degree, coefficients and initial numbers
+      // of the dimensions after the first
+      const unsigned int degree[] = { 1, 2, 3 };
+      const unsigned int coefficients[] = { 0, 1, 1 };
+      const unsigned int initial[][3] = { { 1, 0, 0 }, { 1, 3, 0 }, { 1, 3, 1 } };
+
+      m_Directions.assign( dimension, std::vector<uint32_t>( 32 ) );
+      for ( unsigned int i = 0; i < 32; ++i )
+        {
+        m_Directions[0][i] = 1u << ( 31 - i );
+        }
+      for ( unsigned int d = 1; d < dimension; ++d )
+        {
+        const unsigned int s = degree[d-1];
+        const unsigned int a = coefficients[d-1];
+        std::vector<uint32_t> &v = m_Directions[d];
+        for ( unsigned int i = 0; i < s; ++i )
+          {
+          v[i] = initial[d-1][i] << ( 31 - i );
+          }
+        for ( unsigned int i = s; i < 32; ++i )
+          {
+          v[i] = v[i-s] ^ ( v[i-s] >> s );
+          for ( unsigned int k = 1; k < s; ++k )
+            {
+            v[i] ^= ( ( a >> ( s - 1 - k ) ) & 1u ) * v[i-k];
+            }
+          }
+        }
+    }
+
+  /** The next point, the first point being the origin. */
+  void Next( std::vector<uint32_t> &point )
+    {
+      point = m_State;
+      // the position of the lowest zero bit of the index
+      unsigned int c = 0;
+      for ( uint64_t i = m_Index; i & 1u; i >>= 1 )
+        {
+        ++c;
+        }
+      for ( unsigned int d = 0; d < m_Dimension; ++d )
+        {
+        m_State[d] ^= m_Directions[d][std::min( c, 31u )];
+        }
+      ++m_Index;
+    }
+
+private:
+  unsigned int m_Dimension;
+  uint64_t m_Index;
+  std::vector<uint32_t> m_State;
+  std::vector<std::vector<uint32_t> > m_Directions;
+};
+
+}
+
+
+/** ImageRegistrationMethodv4 generating the sampled points of the
+ * metric with the additional strategies of ImageRegistrationMethod.
+ *
+ * The other strategies are those of ImageRegistrationMethodv4, which
+ * must be set to a strategy other than NONE for the sampled points to
+ * be generated.
+ */
+template <typename TImageType>
+class SampledImageRegistrationMethod
+  : public itk::ImageRegistrationMethodv4<TImageType, TImageType>
+{
+public:
+  using Self = SampledImageRegistrationMethod;
+  using Superclass = itk::ImageRegistrationMethodv4<TImageType, TImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SampledImageRegistrationMethod, ImageRegistrationMethodv4);
+
+  using SamplingStrategyType = ImageRegistrationMethod::MetricSamplingStrategyType;
+  using MetricType = itk::ImageToImageMetricv4<TImageType, TImageType, TImageType, double>;
+  using PointSetType = typename MetricType::FixedSampledPointSetType;
+  using PointType = typename PointSetType::PointType;
+
+  static constexpr unsigned int ImageDimension = TImageType::ImageDimension;
+
+  void SetSampling( SamplingStrategyType strategy, const std::vector<double> &percentages, unsigned int seed )
+    {
+      m_SamplingStrategy = strategy;
+      m_SamplingPercentages = percentages;
+      m_SamplingSeed = seed;
+    }
+
+  /** Without sampling, use the points of the virtual domain inside
+   * the fixed mask as the sampled points, instead of the metric
+   * rejecting the points outside of the mask on each iteration. The
+   * strategy of ImageRegistrationMethodv4 must be set to other than
+   * NONE for the points to be generated. */
+  void SetDenseFixedMaskSampling( bool dense )
+    {
+      m_DenseFixedMaskSampling = dense;
+    }
+
+  /** Estimate the scales of the optimizer only on the levels where
+   * the number of local parameters changes. */
+  void SetReuseOptimizerScales( bool reuse )
+    {
+      m_ReuseOptimizerScales = reuse;
+    }
+
+  /** Report the initialization of the levels to profiler, which must
+   * exist during the execution. */
+  void SetProfiler( detail::RegistrationProfiler *profiler )
+    {
+      m_Profiler = profiler;
+    }
+
+  static bool IsAdditionalStrategy( SamplingStrategyType strategy )
+    {
+      return strategy != ImageRegistrationMethod::NONE &&
+        strategy != ImageRegistrationMethod::REGULAR &&
+        strategy != ImageRegistrationMethod::RANDOM;
+    }
+
+protected:
+  SampledImageRegistrationMethod() = default;
+
+  void InitializeRegistrationAtEachLevel( const itk::SizeValueType level ) override
+    {
+      if ( !m_Profiler )
+        {
+        this->InitializeLevel( level );
+        return;
+        }
+
+      m_Profiler->BeginLevel( static_cast<unsigned int>( level ) );
+      m_SamplingTime = 0.0;
+      this->InitializeLevel( level );
+      m_Profiler->EndLevelInitialization( m_SamplingTime );
+    }
+
+  void SetMetricSamplePoints() override
+    {
+      if ( !m_Profiler )
+        {
+        this->SampleMetricPoints();
+        return;
+        }
+
+      const auto start = std::chrono::steady_clock::now();
+      this->SampleMetricPoints();
+      m_SamplingTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+private:
+  using ContinuousIndexType = itk::ContinuousIndex<double, ImageDimension>;
+  using RegionType = typename TImageType::RegionType;
+
+  void InitializeLevel( const itk::SizeValueType level )
+    {
+      Superclass::InitializeRegistrationAtEachLevel( level );
+
+      if ( m_ReuseOptimizerScales )
+        {
+        // the scales of the previous level are kept by the optimizer
+        typename Superclass::OptimizerType *optimizer = this->GetModifiableOptimizer();
+        const bool sameParameters = optimizer->GetScales().Size() == optimizer->GetMetric()->GetNumberOfLocalParameters();
+        optimizer->SetDoEstimateScales( level == 0 || !sameParameters );
+        }
+    }
+
+  void SampleMetricPoints()
+    {
+      MetricType *metric = dynamic_cast<MetricType *>( this->GetModifiableMetric() );
+      if ( m_DenseFixedMaskSampling && metric && metric->GetVirtualImage() && metric->GetFixedImageMask() )
+        {
+        this->FixedMaskPoints( metric );
+        return;
+        }
+      if ( !IsAdditionalStrategy( m_SamplingStrategy ) || !metric || !metric->GetVirtualImage() )
+        {
+        Superclass::SetMetricSamplePoints();
+        return;
+        }
+
+      const unsigned int level = this->GetCurrentLevel();
+      double percentage = 1.0;
+      if ( !m_SamplingPercentages.empty() )
+        {
+        percentage = m_SamplingPercentages[ std::min<size_t>( level, m_SamplingPercentages.size() - 1 ) ];
+        }
+
+      const TImageType *virtualImage = metric->GetVirtualImage();
+      const typename TImageType::RegionType region = metric->GetVirtualRegion();
+      const uint64_t numberOfPixels = region.GetNumberOfPixels();
+      const uint64_t numberOfSamples = std::max<uint64_t>( 1, static_cast<uint64_t>( std::llround( numberOfPixels * percentage ) ) );
+
+      // each level is sampled differently, reproducibly for a seed
+      const unsigned int seed = ( m_SamplingSeed == sitkWallClock ) ? static_cast<unsigned int>( std::time( nullptr ) ) : m_SamplingSeed;
+      std::seed_seq sequence{ seed, level };
+      std::mt19937 generator( sequence );
+
+      std::vector<itk::ContinuousIndex<double, ImageDimension> > indexes;
+      switch ( m_SamplingStrategy )
+        {
+        case ImageRegistrationMethod::STRATIFIED:
+          this->StratifiedIndexes( region, percentage, generator, indexes );
+          break;
+        case ImageRegistrationMethod::HALTON:
+        case ImageRegistrationMethod::SOBOL:
+          this->LowDiscrepancyIndexes( region, numberOfSamples, generator, indexes );
+          break;
+        case ImageRegistrationMethod::GRADIENT_WEIGHTED:
+          this->GradientWeightedIndexes( metric, region, numberOfSamples, generator, indexes );
+          break;
+        default:
+          break;
+        }
+
+      const auto *fixedMask = metric->GetFixedImageMask();
+      const auto *fixedTransform = metric->GetFixedTransform();
+
+      typename PointSetType::Pointer points = PointSetType::New();
+      points->Initialize();
+      typename PointSetType::PointIdentifier id = 0;
+      for ( const auto &index : indexes )
+        {
+        PointType point;
+        virtualImage->TransformContinuousIndexToPhysicalPoint( index, point );
+        if ( fixedMask && !fixedMask->IsInsideInWorldSpace( fixedTransform->TransformPoint( point ) ) )
+          {
+          continue;
+          }
+        points->SetPoint( id++, point );
+        }
+
+      metric->SetFixedSampledPointSet( points );
+      metric->SetUseSampledPointSet( true );
+    }
+
+  // All the points of the virtual domain inside the fixed mask.
+  void FixedMaskPoints( MetricType *metric )
+    {
+      const TImageType *virtualImage = metric->GetVirtualImage();
+      const auto *fixedMask = metric->GetFixedImageMask();
+      const auto *fixedTransform = metric->GetFixedTransform();
+
+      typename PointSetType::Pointer points = PointSetType::New();
+      points->Initialize();
+      typename PointSetType::PointIdentifier id = 0;
+      for ( const itk::Index<ImageDimension> &index : itk::ImageRegionIndexRange<ImageDimension>( metric->GetVirtualRegion() ) )
+        {
+        PointType point;
+        virtualImage->TransformIndexToPhysicalPoint( index, point );
+        if ( fixedMask->IsInsideInWorldSpace( fixedTransform->TransformPoint( point ) ) )
+          {
+          points->SetPoint( id++, point );
+          }
+        }
+
+      metric->SetFixedSampledPointSet( points );
+      metric->SetUseSampledPointSet( true );
+    }
+
+  // The region is divided into cells of about 1/percentage pixels,
+  // and a point is uniformly drawn in each cell.
+  void StratifiedIndexes( const RegionType &region,
+                          double percentage,
+                          std::mt19937 &generator,
+                          std::vector<ContinuousIndexType> &indexes ) const
+    {
+      const double cellPixels = 1.0 / std::max( percentage, 1e-12 );
+      const unsigned int cellWidth = std::max( 1u, static_cast<unsigned int>( std::round( std::pow( cellPixels, 1.0 / ImageDimension ) ) ) );
+
+      itk::Size<ImageDimension> cells;
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        cells[d] = ( region.GetSize()[d] + cellWidth - 1 ) / cellWidth;
+        }
+
+      std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+      itk::ImageRegion<ImageDimension> cellRegion;
+      cellRegion.SetSize( cells );
+      for ( const itk::Index<ImageDimension> &cell : itk::ImageRegionIndexRange<ImageDimension>( cellRegion ) )
+        {
+        ContinuousIndexType index;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          const double begin = cell[d] * static_cast<double>( cellWidth );
+          const double width = std::min<double>( cellWidth, region.GetSize()[d] - begin );
+          index[d] = region.GetIndex()[d] - 0.5 + begin + uniform( generator ) * width;
+          }
+        indexes.push_back( index );
+        }
+    }
+
+  // The points of a Halton or Sobol sequence, randomly shifted.
+  void LowDiscrepancyIndexes( const RegionType &region,
+                              uint64_t numberOfSamples,
+                              std::mt19937 &generator,
+                              std::vector<ContinuousIndexType> &indexes ) const
+    {
+      static_assert( ImageDimension <= SobolSequence::MaximumDimension, "Unsupported dimension for the Sobol sequence" );
+      const unsigned int primes[] = { 2, 3, 5, 7 };
+
+      double shift[ImageDimension];
+      uint32_t digitalShift[ImageDimension];
+      std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        shift[d] = uniform( generator );
+        digitalShift[d] = static_cast<uint32_t>( generator() );
+        }
+
+      SobolSequence sobol( ImageDimension );
+      std::vector<uint32_t> sobolPoint;
+
+      indexes.reserve( numberOfSamples );
+      for ( uint64_t i = 0; i < numberOfSamples; ++i )
+        {
+        if ( m_SamplingStrategy == ImageRegistrationMethod::SOBOL )
+          {
+          sobol.Next( sobolPoint );
+          }
+
+        ContinuousIndexType index;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          double u;
+          if ( m_SamplingStrategy == ImageRegistrationMethod::SOBOL )
+            {
+            u = ( sobolPoint[d] ^ digitalShift[d] ) / 4294967296.0;
+            }
+          else
+            {
+            u = HaltonValue( i + 1, primes[d] ) + shift[d];
+            u -= std::floor( u );
+            }
+          index[d] = region.GetIndex()[d] - 0.5 + u * region.GetSize()[d];
+          }
+        indexes.push_back( index );
+        }
+    }
+
+  // Pixels drawn without replacement with a probability proportional
+  // to the gradient magnitude of the fixed image, at the scale of the
+  // level, then perturbed within the pixel.
+  void GradientWeightedIndexes( const MetricType *metric,
+                                const RegionType &region,
+                                uint64_t numberOfSamples,
+                                std::mt19937 &generator,
+                                std::vector<ContinuousIndexType> &indexes ) const
+    {
+      const TImageType *virtualImage = metric->GetVirtualImage();
+      const auto *fixedTransform = metric->GetFixedTransform();
+      const auto *fixedMask = metric->GetFixedImageMask();
+
+      using GradientFilterType = itk::GradientMagnitudeRecursiveGaussianImageFilter<TImageType, TImageType>;
+      typename GradientFilterType::Pointer gradient = GradientFilterType::New();
+      gradient->SetInput( this->GetFixedImage() );
+      double sigma = 0.0;
+      for ( unsigned int d = 0; d < ImageDimension; ++d )
+        {
+        sigma = std::max( sigma, virtualImage->GetSpacing()[d] );
+        }
+      gradient->SetSigma( 0.5 * sigma );
+      gradient->SetNumberOfWorkUnits( this->GetNumberOfWorkUnits() );
+      gradient->Update();
+
+      using InterpolatorType = itk::LinearInterpolateImageFunction<TImageType, double>;
+      typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+      interpolator->SetInputImage( gradient->GetOutput() );
+
+      std::vector<double> weights;
+      std::vector<typename TImageType::IndexType> pixels;
+      weights.reserve( region.GetNumberOfPixels() );
+      pixels.reserve( region.GetNumberOfPixels() );
+      double sum = 0.0;
+      for ( const typename TImageType::IndexType &pixel : itk::ImageRegionIndexRange<ImageDimension>( region ) )
+        {
+        PointType point;
+        virtualImage->TransformIndexToPhysicalPoint( pixel, point );
+        point = fixedTransform->TransformPoint( point );
+
+        double weight = 0.0;
+        if ( interpolator->IsInsideBuffer( point ) &&
+             ( !fixedMask || fixedMask->IsInsideInWorldSpace( point ) ) )
+          {
+          weight = interpolator->Evaluate( point );
+          sum += weight;
+          }
+        weights.push_back( weight );
+        pixels.push_back( pixel );
+        }
+
+      // a floor of the weight so the uniform regions are also sampled
+      const double floor = 0.01 * sum / std::max<size_t>( weights.size(), 1 );
+
+      // weighted sampling without replacement, keeping the largest
+      // keys log(u)/w
+      std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+      std::vector<std::pair<double, size_t> > keys;
+      keys.reserve( weights.size() );
+      for ( size_t i = 0; i < weights.size(); ++i )
+        {
+        if ( weights[i] == 0.0 && floor == 0.0 )
+          {
+          continue;
+          }
+        const double u = std::max( uniform( generator ), std::numeric_limits<double>::min() );
+        keys.emplace_back( std::log( u ) / ( weights[i] + floor ), i );
+        }
+
+      const size_t count = std::min<size_t>( numberOfSamples, keys.size() );
+      std::nth_element( keys.begin(), keys.begin() + count, keys.end(),
+                        []( const std::pair<double, size_t> &a, const std::pair<double, size_t> &b ) { return a.first > b.first; } );
+      keys.resize( count );
+      std::sort( keys.begin(), keys.end(),
+                 []( const std::pair<double, size_t> &a, const std::pair<double, size_t> &b ) { return a.second < b.second; } );
+
+      std::uniform_real_distribution<double> perturbation( -0.5, 0.5 );
+      indexes.reserve( count );
+      for ( const auto &key : keys )
+        {
+        ContinuousIndexType index;
+        for ( unsigned int d = 0; d < ImageDimension; ++d )
+          {
+          index[d] = pixels[key.second][d] + perturbation( generator );
+          }
+        indexes.push_back( index );
+        }
+    }
+
+  SamplingStrategyType m_SamplingStrategy{ ImageRegistrationMethod::NONE };
+  std::vector<double> m_SamplingPercentages;
+  unsigned int m_SamplingSeed{ 0 };
+  bool m_ReuseOptimizerScales{ false };
+  bool m_DenseFixedMaskSampling{ false };
+  detail::RegistrationProfiler *m_Profiler{ nullptr };
+  double m_SamplingTime{ 0.0 };
+};
+
+}
+}
+
+#endif // sitkImageRegistrationMethod_MetricSampling_hxx
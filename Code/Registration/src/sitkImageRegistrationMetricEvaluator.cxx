@@ -0,0 +1,207 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkImageRegistrationMetricEvaluator.h"
+#include "sitkImageRegistrationMetricEvaluatorImpl.h"
+#include "sitkTemplateFunctions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace itk
+{
+namespace simple
+{
+
+namespace detail
+{
+
+MetricEvaluatorImpl::MetricEvaluatorImpl( CreateInstanceFunctionType createInstance,
+                                          unsigned int numberOfThreads,
+                                          std::unique_ptr<Executor> executor )
+  : m_CreateInstance( std::move( createInstance ) ),
+    m_NumberOfThreads( std::max( numberOfThreads, 1u ) ),
+    m_Executor( std::move( executor ) )
+{
+  // errors in the configuration are reported on creation
+  m_Instances.push_back( m_CreateInstance() );
+}
+
+
+unsigned int MetricEvaluatorImpl::GetNumberOfParameters() const
+{
+  return static_cast<unsigned int>( m_Instances.front().metric->GetNumberOfParameters() );
+}
+
+
+void MetricEvaluatorImpl::SetParameters( InstanceType &instance, const std::vector<double> &parameters ) const
+{
+  if ( parameters.size() != instance.metric->GetNumberOfParameters() )
+    {
+    sitkExceptionMacro( << "Expected " << instance.metric->GetNumberOfParameters()
+                        << " parameters but got " << parameters.size() << "!" );
+    }
+
+  MetricType::ParametersType itkParameters( static_cast<unsigned int>( parameters.size() ) );
+  std::copy( parameters.begin(), parameters.end(), itkParameters.begin() );
+  instance.metric->SetParameters( itkParameters );
+}
+
+
+double MetricEvaluatorImpl::Evaluate( const std::vector<double> &parameters, std::vector<double> *derivative )
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+
+  InstanceType &instance = m_Instances.front();
+  instance.setMaximumNumberOfWorkUnits( m_NumberOfThreads );
+  this->SetParameters( instance, parameters );
+
+  if ( !derivative )
+    {
+    return instance.metric->GetValue();
+    }
+
+  MetricType::MeasureType value;
+  MetricType::DerivativeType itkDerivative;
+  instance.metric->GetValueAndDerivative( value, itkDerivative );
+  derivative->assign( itkDerivative.begin(), itkDerivative.end() );
+  return value;
+}
+
+
+std::vector<double> MetricEvaluatorImpl::Evaluate( const std::vector< std::vector<double> > &parameters )
+{
+  std::vector<double> values( parameters.size() );
+  if ( parameters.empty() )
+    {
+    return values;
+    }
+
+  std::lock_guard<std::mutex> lock( m_Mutex );
+
+  unsigned int numberOfThreads = m_NumberOfThreads;
+  if ( m_Executor )
+    {
+    numberOfThreads = m_Executor->AcquireThreads( numberOfThreads );
+    }
+  auto releaseThreads = make_scope_exit( [this, numberOfThreads] {
+      if ( m_Executor )
+        {
+        m_Executor->ReleaseThreads( numberOfThreads );
+        }
+    } );
+
+  // the parameters are evaluated concurrently, instead of the points
+  // of each evaluation
+  const unsigned int numberOfWorkers = static_cast<unsigned int>( std::min<size_t>( numberOfThreads, parameters.size() ) );
+  const unsigned int workUnitsPerInstance = std::max( numberOfThreads / numberOfWorkers, 1u );
+  while ( m_Instances.size() < numberOfWorkers )
+    {
+    m_Instances.push_back( m_CreateInstance() );
+    }
+  for ( unsigned int w = 0; w < numberOfWorkers; ++w )
+    {
+    m_Instances[w].setMaximumNumberOfWorkUnits( workUnitsPerInstance );
+    }
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool>   failed{false};
+  std::exception_ptr  firstException;
+  std::mutex          exceptionMutex;
+
+  auto work = [&]( unsigned int w )
+    {
+      InstanceType &instance = m_Instances[w];
+      try
+        {
+        for ( size_t i = next++; i < parameters.size() && !failed; i = next++ )
+          {
+          this->SetParameters( instance, parameters[i] );
+          values[i] = instance.metric->GetValue();
+          }
+        }
+      catch (...)
+        {
+        std::lock_guard<std::mutex> exceptionLock( exceptionMutex );
+        if ( !firstException )
+          {
+          firstException = std::current_exception();
+          }
+        failed = true;
+        }
+    };
+
+  std::vector<std::thread> threads;
+  threads.reserve( numberOfWorkers - 1 );
+  for ( unsigned int w = 1; w < numberOfWorkers; ++w )
+    {
+    threads.emplace_back( work, w );
+    }
+  work( 0 );
+  for ( std::thread &thread : threads )
+    {
+    thread.join();
+    }
+
+  if ( firstException )
+    {
+    std::rethrow_exception( firstException );
+    }
+  return values;
+}
+
+}
+
+
+ImageRegistrationMetricEvaluator::ImageRegistrationMetricEvaluator( std::shared_ptr<detail::MetricEvaluatorImpl> impl )
+  : m_Impl( std::move( impl ) )
+{
+}
+
+ImageRegistrationMetricEvaluator::~ImageRegistrationMetricEvaluator() = default;
+
+ImageRegistrationMetricEvaluator::ImageRegistrationMetricEvaluator( const ImageRegistrationMetricEvaluator & ) = default;
+
+ImageRegistrationMetricEvaluator &
+ImageRegistrationMetricEvaluator::operator=( const ImageRegistrationMetricEvaluator & ) = default;
+
+
+unsigned int ImageRegistrationMetricEvaluator::GetNumberOfParameters() const
+{
+  return m_Impl->GetNumberOfParameters();
+}
+
+double ImageRegistrationMetricEvaluator::Evaluate( const std::vector<double> &parameters )
+{
+  return m_Impl->Evaluate( parameters, nullptr );
+}
+
+double ImageRegistrationMetricEvaluator::EvaluateWithDerivative( const std::vector<double> &parameters,
+                                                                 std::vector<double> &derivative )
+{
+  return m_Impl->Evaluate( parameters, &derivative );
+}
+
+std::vector<double> ImageRegistrationMetricEvaluator::Evaluate( const std::vector< std::vector<double> > &parameters )
+{
+  return m_Impl->Evaluate( parameters );
+}
+
+}
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkImageRegistrationMetricEvaluatorImpl_h
+#define sitkImageRegistrationMetricEvaluatorImpl_h
+
+#include "sitkRegistration.h"
+#include "sitkExecutor.h"
+#include "sitkNonCopyable.h"
+
+#include "itkObjectToObjectMetricBase.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \class MetricEvaluatorImpl
+ * \brief The state of an ImageRegistrationMetricEvaluator.
+ *
+ * An instance is an initialized metric with its own copy of the
+ * initial transform. The first instance is used for single
+ * evaluations, and each thread of a batch evaluation uses one
+ * instance, created on demand with the creation function.
+ */
+class SITKRegistration_HIDDEN MetricEvaluatorImpl
+  : protected NonCopyable
+{
+public:
+  using MetricType = itk::ObjectToObjectMetricBaseTemplate<double>;
+
+  struct InstanceType
+  {
+    MetricType::Pointer metric;
+    std::function<void( unsigned int )> setMaximumNumberOfWorkUnits;
+  };
+
+  using CreateInstanceFunctionType = std::function<InstanceType()>;
+
+  MetricEvaluatorImpl( CreateInstanceFunctionType createInstance,
+                       unsigned int numberOfThreads,
+                       std::unique_ptr<Executor> executor );
+
+  unsigned int GetNumberOfParameters() const;
+
+  /** Evaluate the metric of the first instance, and its derivative
+   * when derivative is not null. */
+  double Evaluate( const std::vector<double> &parameters, std::vector<double> *derivative );
+
+  std::vector<double> Evaluate( const std::vector< std::vector<double> > &parameters );
+
+private:
+  void SetParameters( InstanceType &instance, const std::vector<double> &parameters ) const;
+
+  CreateInstanceFunctionType m_CreateInstance;
+  unsigned int m_NumberOfThreads;
+  std::unique_ptr<Executor> m_Executor;
+
+  std::mutex m_Mutex;
+  std::vector<InstanceType> m_Instances;
+};
+
+}
+}
+}
+
+#endif // sitkImageRegistrationMetricEvaluatorImpl_h
@@ -0,0 +1,83 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkImageRegistrationState.h"
+
+#include <limits>
+#include <sstream>
+
+namespace itk
+{
+namespace simple
+{
+
+ImageRegistrationState::ImageRegistrationState()
+  : m_OptimizerLearningRate( 0.0 ),
+    m_Level( 0 ),
+    m_MetricValue( std::numeric_limits<double>::quiet_NaN() )
+{
+}
+
+std::vector<double> ImageRegistrationState::GetTransformParameters() const
+{
+  return m_TransformParameters;
+}
+
+std::vector<double> ImageRegistrationState::GetTransformFixedParameters() const
+{
+  return m_TransformFixedParameters;
+}
+
+std::vector<double> ImageRegistrationState::GetOptimizerScales() const
+{
+  return m_OptimizerScales;
+}
+
+double ImageRegistrationState::GetOptimizerLearningRate() const
+{
+  return m_OptimizerLearningRate;
+}
+
+unsigned int ImageRegistrationState::GetLevel() const
+{
+  return m_Level;
+}
+
+double ImageRegistrationState::GetMetricValue() const
+{
+  return m_MetricValue;
+}
+
+bool ImageRegistrationState::IsEmpty() const
+{
+  return m_TransformParameters.empty();
+}
+
+std::string ImageRegistrationState::ToString() const
+{
+  std::ostringstream out;
+  out << "ImageRegistrationState:" << std::endl
+      << "  NumberOfTransformParameters: " << m_TransformParameters.size() << std::endl
+      << "  NumberOfOptimizerScales: " << m_OptimizerScales.size() << std::endl
+      << "  OptimizerLearningRate: " << m_OptimizerLearningRate << std::endl
+      << "  Level: " << m_Level << std::endl
+      << "  MetricValue: " << m_MetricValue << std::endl;
+  return out.str();
+}
+
+}
+}
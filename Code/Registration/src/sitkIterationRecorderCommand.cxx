@@ -0,0 +1,110 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkIterationRecorderCommand.h"
+#include "sitkImageRegistrationMethod.h"
+
+namespace itk
+{
+namespace simple
+{
+
+IterationRecorderCommand::IterationRecorderCommand( const ImageRegistrationMethod &method, unsigned int numberOfIterations )
+  : m_Method( method )
+{
+  Command::SetName( "IterationRecorderCommand" );
+
+  m_Levels.reserve( numberOfIterations );
+  m_Iterations.reserve( numberOfIterations );
+  m_MetricValues.reserve( numberOfIterations );
+  m_LearningRates.reserve( numberOfIterations );
+  m_ConvergenceValues.reserve( numberOfIterations );
+}
+
+IterationRecorderCommand::~IterationRecorderCommand() = default;
+
+void IterationRecorderCommand::Execute()
+{
+  const std::vector<double> position = m_Method.GetOptimizerPosition();
+
+  if ( m_Iterations.empty() )
+    {
+    m_NumberOfParameters = static_cast<unsigned int>( position.size() );
+    m_Positions.reserve( m_Iterations.capacity() * position.size() );
+    }
+
+  m_Levels.push_back( m_Method.GetCurrentLevel() );
+  m_Iterations.push_back( m_Method.GetOptimizerIteration() );
+  m_MetricValues.push_back( m_Method.GetMetricValue() );
+  m_LearningRates.push_back( m_Method.GetOptimizerLearningRate() );
+  m_ConvergenceValues.push_back( m_Method.GetOptimizerConvergenceValue() );
+  m_Positions.insert( m_Positions.end(), position.begin(), position.end() );
+}
+
+void IterationRecorderCommand::Clear()
+{
+  m_Levels.clear();
+  m_Iterations.clear();
+  m_MetricValues.clear();
+  m_LearningRates.clear();
+  m_ConvergenceValues.clear();
+  m_Positions.clear();
+  m_NumberOfParameters = 0;
+}
+
+unsigned int IterationRecorderCommand::GetNumberOfRecords() const
+{
+  return static_cast<unsigned int>( m_Iterations.size() );
+}
+
+unsigned int IterationRecorderCommand::GetNumberOfParameters() const
+{
+  return m_NumberOfParameters;
+}
+
+const std::vector<unsigned int> &IterationRecorderCommand::GetLevels() const
+{
+  return m_Levels;
+}
+
+const std::vector<unsigned int> &IterationRecorderCommand::GetIterations() const
+{
+  return m_Iterations;
+}
+
+const std::vector<double> &IterationRecorderCommand::GetMetricValues() const
+{
+  return m_MetricValues;
+}
+
+const std::vector<double> &IterationRecorderCommand::GetLearningRates() const
+{
+  return m_LearningRates;
+}
+
+const std::vector<double> &IterationRecorderCommand::GetConvergenceValues() const
+{
+  return m_ConvergenceValues;
+}
+
+const std::vector<double> &IterationRecorderCommand::GetPositions() const
+{
+  return m_Positions;
+}
+
+} // end namespace simple
+} // end namespace itk
@@ -0,0 +1,180 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkPyramidCache.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+namespace
+{
+thread_local PyramidCache::ScopedActivation *ActiveCache = nullptr;
+}
+
+bool PyramidCache::KeyType::operator<( const KeyType &other ) const
+{
+  return std::tie( buffer, type, parameters ) < std::tie( other.buffer, other.type, other.parameters );
+}
+
+
+PyramidCache::ScopedActivation::ScopedActivation( PyramidCache *cache, const std::vector<Image> &sources, bool cacheGradients )
+  : m_Cache( cache ),
+    m_Sources( sources ),
+    m_CacheGradients( cacheGradients ),
+    m_Previous( ActiveCache )
+{
+  ActiveCache = this;
+}
+
+PyramidCache::ScopedActivation::~ScopedActivation()
+{
+  ActiveCache = m_Previous;
+}
+
+
+PyramidCache *PyramidCache::GetActive( const void *buffer, Image &source )
+{
+  if ( !ActiveCache || !ActiveCache->m_Cache )
+    {
+    return nullptr;
+    }
+  for ( const Image &image : ActiveCache->m_Sources )
+    {
+    if ( image.GetBufferAsVoid() == buffer )
+      {
+      source = image;
+      return ActiveCache->m_Cache;
+      }
+    }
+  return nullptr;
+}
+
+
+PyramidCache *PyramidCache::GetActiveForGradient( const void *buffer, Image &source )
+{
+  if ( !ActiveCache || !ActiveCache->m_CacheGradients )
+    {
+    return nullptr;
+    }
+  if ( PyramidCache *cache = GetActive( buffer, source ) )
+    {
+    return cache;
+    }
+  if ( ActiveCache->m_Cache && ActiveCache->m_Cache->FindSourceOfOutput( buffer, source ) )
+    {
+    return ActiveCache->m_Cache;
+    }
+  return nullptr;
+}
+
+
+bool PyramidCache::FindSourceOfOutput( const void *buffer, Image &source )
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+  for ( const auto &entry : m_Entries )
+    {
+    if ( entry.second.outputBuffer == buffer )
+      {
+      source = entry.second.source;
+      return true;
+      }
+    }
+  return false;
+}
+
+
+itk::DataObject::Pointer PyramidCache::FindOrReserve( const KeyType &key )
+{
+  std::unique_lock<std::mutex> lock( m_Mutex );
+  m_Reserved.wait( lock, [this, &key] { return m_Reservations.count( key ) == 0; } );
+
+  auto iter = m_Entries.find( key );
+  if ( iter == m_Entries.end() )
+    {
+    m_Reservations.insert( key );
+    return nullptr;
+    }
+  return iter->second.output;
+}
+
+
+void PyramidCache::Insert( const KeyType &key,
+                           const Image &source,
+                           const itk::DataObject *input,
+                           itk::DataObject *output,
+                           const void *outputBuffer )
+{
+  {
+  std::lock_guard<std::mutex> lock( m_Mutex );
+  m_Entries.emplace( key, EntryType{ source, input, output, outputBuffer } );
+  m_Reservations.erase( key );
+  }
+  m_Reserved.notify_all();
+}
+
+
+void PyramidCache::Cancel( const KeyType &key )
+{
+  {
+  std::lock_guard<std::mutex> lock( m_Mutex );
+  m_Reservations.erase( key );
+  }
+  m_Reserved.notify_all();
+}
+
+
+void PyramidCache::Retain( const std::vector<Image> &images )
+{
+  std::vector<const void *> buffers;
+  for ( const Image &image : images )
+    {
+    buffers.push_back( image.GetBufferAsVoid() );
+    }
+
+  std::lock_guard<std::mutex> lock( m_Mutex );
+  for ( auto iter = m_Entries.begin(); iter != m_Entries.end(); )
+    {
+    // the gradients of the smoothed images are keyed by their buffer
+    const Image &source = iter->second.source;
+    if ( std::find( buffers.begin(), buffers.end(), source.GetBufferAsVoid() ) == buffers.end() )
+      {
+      iter = m_Entries.erase( iter );
+      }
+    else
+      {
+      ++iter;
+      }
+    }
+}
+
+
+void PyramidCache::Clear()
+{
+  std::lock_guard<std::mutex> lock( m_Mutex );
+  m_Entries.clear();
+}
+
+}
+}
+}
@@ -0,0 +1,360 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkPyramidCache_h
+#define sitkPyramidCache_h
+
+#include "sitkRegistration.h"
+#include "sitkImage.h"
+#include "sitkNonCopyable.h"
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkGradientRecursiveGaussianImageFilter.h"
+#include "itkObjectFactoryBase.h"
+#include "itkVersion.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <typeindex>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \class PyramidCache
+ * \brief Store the smoothed images of the registration levels.
+ *
+ * The ITK registration method smooths the fixed and the moving
+ * images for each level with a DiscreteGaussianImageFilter. When a
+ * cache is activated on a thread, the smoothing filter of the
+ * registered image types looks up its output in the cache, keyed by
+ * the buffer and geometry of the input and the smoothing parameters,
+ * and only executes when it is missing.
+ *
+ * When enabled on activation, the gradient images of the source images
+ * and of their cached smoothed images, computed by the
+ * GradientRecursiveGaussianImageFilter of the metrics, are cached the
+ * same way.
+ *
+ * The cache keeps a reference to the SimpleITK image of the cached
+ * inputs, so that modifying one of them makes a copy of its buffer
+ * which no longer matches the cached entries.
+ */
+class SITKRegistration_HIDDEN PyramidCache
+  : protected NonCopyable
+{
+public:
+  struct KeyType
+  {
+    const void *buffer;
+    std::type_index type;
+    std::vector<double> parameters;
+
+    bool operator<( const KeyType &other ) const;
+  };
+
+  /** Activate a cache on the current thread for the smoothing of the
+   * sources, while the object exists. */
+  class ScopedActivation
+  {
+  public:
+    ScopedActivation( PyramidCache *cache, const std::vector<Image> &sources, bool cacheGradients = false );
+    ~ScopedActivation();
+  private:
+    PyramidCache *m_Cache;
+    std::vector<Image> m_Sources;
+    bool m_CacheGradients;
+    ScopedActivation *m_Previous;
+
+    friend class PyramidCache;
+  };
+
+  /** Get the active cache of the current thread if buffer belongs to
+   * one of its sources, which is returned in source. */
+  static PyramidCache *GetActive( const void *buffer, Image &source );
+
+  /** Get the active cache of the current thread if it caches the
+   * gradients, and buffer belongs to one of its sources or to one of
+   * their cached outputs. */
+  static PyramidCache *GetActiveForGradient( const void *buffer, Image &source );
+
+  /** Get the cached output of key. When it is missing, the key is
+   * reserved for the caller, which must then call Insert or Cancel,
+   * and other threads wait for it instead of smoothing the same
+   * image. */
+  itk::DataObject::Pointer FindOrReserve( const KeyType &key );
+
+  void Insert( const KeyType &key,
+               const Image &source,
+               const itk::DataObject *input,
+               itk::DataObject *output,
+               const void *outputBuffer );
+
+  void Cancel( const KeyType &key );
+
+  /** Remove the entries which are not of one of the images. */
+  void Retain( const std::vector<Image> &images );
+
+  void Clear();
+
+  /** Graft the cached output of key to the filter, or execute
+   * generateData and cache the output of the filter. */
+  template <typename TFilter, typename TGenerateData>
+  void GenerateData( const KeyType &key, const Image &source, TFilter *filter, TGenerateData &&generateData );
+
+  /** Override the DiscreteGaussianImageFilter of TImageType and the
+   * GradientRecursiveGaussianImageFilter of the metrics with the
+   * caching filters, once. */
+  template <typename TImageType>
+  static void RegisterImageType();
+
+private:
+  bool FindSourceOfOutput( const void *buffer, Image &source );
+
+  struct EntryType
+  {
+    Image source;
+    // the input is kept so that its buffer is not reused while the
+    // entry exists
+    itk::DataObject::ConstPointer input;
+    itk::DataObject::Pointer output;
+    const void *outputBuffer;
+  };
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Reserved;
+  std::map<KeyType, EntryType> m_Entries;
+  std::set<KeyType> m_Reservations;
+};
+
+
+/** DiscreteGaussianImageFilter using the active PyramidCache. */
+template <typename TImageType>
+class PyramidCacheSmoothingFilter
+  : public itk::DiscreteGaussianImageFilter<TImageType, TImageType>
+{
+public:
+  using Self = PyramidCacheSmoothingFilter;
+  using Superclass = itk::DiscreteGaussianImageFilter<TImageType, TImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkFactorylessNewMacro(Self);
+  itkTypeMacro(PyramidCacheSmoothingFilter, DiscreteGaussianImageFilter);
+
+protected:
+  PyramidCacheSmoothingFilter() = default;
+
+  void GenerateData() override
+    {
+      const TImageType *input = this->GetInput();
+
+      Image source;
+      PyramidCache *cache = PyramidCache::GetActive( input->GetBufferPointer(), source );
+      if ( !cache )
+        {
+        Superclass::GenerateData();
+        return;
+        }
+
+      cache->GenerateData( this->MakeKey( input ), source, this, [this] { this->Superclass::GenerateData(); } );
+    }
+
+  PyramidCache::KeyType MakeKey( const TImageType *input ) const
+    {
+      constexpr unsigned int Dimension = TImageType::ImageDimension;
+
+      std::vector<double> parameters;
+      const typename TImageType::RegionType &region = input->GetLargestPossibleRegion();
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        parameters.push_back( region.GetIndex()[d] );
+        parameters.push_back( region.GetSize()[d] );
+        parameters.push_back( input->GetOrigin()[d] );
+        parameters.push_back( input->GetSpacing()[d] );
+        for ( unsigned int e = 0; e < Dimension; ++e )
+          {
+          parameters.push_back( input->GetDirection()[d][e] );
+          }
+        parameters.push_back( this->GetVariance()[d] );
+        parameters.push_back( this->GetMaximumError()[d] );
+        }
+      parameters.push_back( this->GetMaximumKernelWidth() );
+      parameters.push_back( this->GetFilterDimensionality() );
+      parameters.push_back( this->GetUseImageSpacing() );
+
+      return PyramidCache::KeyType{ input->GetBufferPointer(), std::type_index( typeid( TImageType ) ), parameters };
+    }
+};
+
+
+/** GradientRecursiveGaussianImageFilter using the active
+ * PyramidCache, when it caches the gradients. */
+template <typename TImageType, typename TGradientImageType>
+class PyramidCacheGradientFilter
+  : public itk::GradientRecursiveGaussianImageFilter<TImageType, TGradientImageType>
+{
+public:
+  using Self = PyramidCacheGradientFilter;
+  using Superclass = itk::GradientRecursiveGaussianImageFilter<TImageType, TGradientImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkFactorylessNewMacro(Self);
+  itkTypeMacro(PyramidCacheGradientFilter, GradientRecursiveGaussianImageFilter);
+
+protected:
+  PyramidCacheGradientFilter() = default;
+
+  void GenerateData() override
+    {
+      const TImageType *input = this->GetInput();
+
+      Image source;
+      PyramidCache *cache = PyramidCache::GetActiveForGradient( input->GetBufferPointer(), source );
+      if ( !cache )
+        {
+        Superclass::GenerateData();
+        return;
+        }
+
+      cache->GenerateData( this->MakeKey( input ), source, this, [this] { this->Superclass::GenerateData(); } );
+    }
+
+  PyramidCache::KeyType MakeKey( const TImageType *input ) const
+    {
+      constexpr unsigned int Dimension = TImageType::ImageDimension;
+
+      std::vector<double> parameters;
+      const typename TImageType::RegionType &region = input->GetLargestPossibleRegion();
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        parameters.push_back( region.GetIndex()[d] );
+        parameters.push_back( region.GetSize()[d] );
+        parameters.push_back( input->GetOrigin()[d] );
+        parameters.push_back( input->GetSpacing()[d] );
+        for ( unsigned int e = 0; e < Dimension; ++e )
+          {
+          parameters.push_back( input->GetDirection()[d][e] );
+          }
+        parameters.push_back( this->GetSigmaArray()[d] );
+        }
+      parameters.push_back( this->GetNormalizeAcrossScale() );
+      parameters.push_back( this->GetUseImageDirection() );
+
+      return PyramidCache::KeyType{ input->GetBufferPointer(), std::type_index( typeid( TGradientImageType ) ), parameters };
+    }
+};
+
+
+template <typename TImageType>
+class PyramidCacheFactory
+  : public itk::ObjectFactoryBase
+{
+public:
+  using Self = PyramidCacheFactory;
+  using Superclass = itk::ObjectFactoryBase;
+  using Pointer = itk::SmartPointer<Self>;
+
+  itkFactorylessNewMacro(Self);
+  itkTypeMacro(PyramidCacheFactory, ObjectFactoryBase);
+
+  const char *GetITKSourceVersion() const override { return ITK_SOURCE_VERSION; }
+  const char *GetDescription() const override { return "SimpleITK registration pyramid cache"; }
+
+protected:
+  PyramidCacheFactory()
+    {
+      using BaseType = itk::DiscreteGaussianImageFilter<TImageType, TImageType>;
+      using OverrideType = PyramidCacheSmoothingFilter<TImageType>;
+      this->RegisterOverride( typeid(BaseType).name(),
+                              typeid(OverrideType).name(),
+                              "DiscreteGaussianImageFilter using the SimpleITK pyramid cache",
+                              true,
+                              itk::CreateObjectFunction<OverrideType>::New() );
+
+      // the gradient filter of the ITKv4 metrics
+      constexpr unsigned int Dimension = TImageType::ImageDimension;
+      using GradientImageType = itk::Image<itk::CovariantVector<double, Dimension>, Dimension>;
+      using GradientBaseType = itk::GradientRecursiveGaussianImageFilter<TImageType, GradientImageType>;
+      using GradientOverrideType = PyramidCacheGradientFilter<TImageType, GradientImageType>;
+      this->RegisterOverride( typeid(GradientBaseType).name(),
+                              typeid(GradientOverrideType).name(),
+                              "GradientRecursiveGaussianImageFilter using the SimpleITK pyramid cache",
+                              true,
+                              itk::CreateObjectFunction<GradientOverrideType>::New() );
+    }
+};
+
+
+template <typename TFilter, typename TGenerateData>
+void PyramidCache::GenerateData( const KeyType &key, const Image &source, TFilter *filter, TGenerateData &&generateData )
+{
+  using OutputImageType = typename TFilter::OutputImageType;
+
+  itk::DataObject::Pointer cached = this->FindOrReserve( key );
+  if ( OutputImageType *cachedImage = dynamic_cast<OutputImageType *>( cached.GetPointer() ) )
+    {
+    filter->GraftOutput( cachedImage );
+    return;
+    }
+
+  try
+    {
+    generateData();
+    }
+  catch (...)
+    {
+    this->Cancel( key );
+    throw;
+    }
+
+  OutputImageType *output = filter->GetOutput();
+  if ( output->GetBufferedRegion() == output->GetLargestPossibleRegion() )
+    {
+    typename OutputImageType::Pointer stored = OutputImageType::New();
+    stored->Graft( output );
+    this->Insert( key, source, filter->GetInput(), stored.GetPointer(), stored->GetBufferPointer() );
+    }
+  else
+    {
+    this->Cancel( key );
+    }
+}
+
+
+template <typename TImageType>
+void PyramidCache::RegisterImageType()
+{
+  static std::once_flag registered;
+  std::call_once( registered, []
+    {
+      itk::ObjectFactoryBase::RegisterFactory( PyramidCacheFactory<TImageType>::New() );
+    } );
+}
+
+}
+}
+}
+
+#endif // sitkPyramidCache_h
@@ -0,0 +1,78 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkRegistrationProfiler_h
+#define sitkRegistrationProfiler_h
+
+#include "sitkRegistration.h"
+#include "sitkImageRegistrationLevelProfile.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+/** \class RegistrationProfiler
+ * \brief Record the ImageRegistrationLevelProfile of the levels of an
+ * execution.
+ *
+ * The registration method reports the initialization of the levels,
+ * and the observers of the optimizer the start of the optimization
+ * and the iterations.
+ */
+class SITKRegistration_HIDDEN RegistrationProfiler
+{
+public:
+  using ClockType = std::chrono::steady_clock;
+
+  /** Called before the initialization of level. */
+  void BeginLevel( unsigned int level );
+
+  /** Called after the initialization of the current level. */
+  void EndLevelInitialization( double samplingTime );
+
+  /** Called when the optimizer starts its iterations. */
+  void OptimizerStarted();
+
+  void Iteration( double metricValue, uint64_t numberOfValidPoints );
+
+  /** End the current level, and get the profiles of all the levels. */
+  std::vector<ImageRegistrationLevelProfile> Finish();
+
+private:
+  void EndLevel();
+
+  static double Seconds( ClockType::time_point start, ClockType::time_point end );
+
+  std::vector<ImageRegistrationLevelProfile> m_Levels;
+  bool m_Optimizing{ false };
+  ClockType::time_point m_LevelStart;
+  ClockType::time_point m_OptimizationStart;
+  ClockType::time_point m_IterationStart;
+};
+
+}
+}
+}
+
+#endif // sitkRegistrationProfiler_h
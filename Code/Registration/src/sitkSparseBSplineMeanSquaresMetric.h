@@ -0,0 +1,356 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkSparseBSplineMeanSquaresMetric_h
+#define sitkSparseBSplineMeanSquaresMetric_h
+
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+
+#include <array>
+
+namespace itk
+{
+namespace simple
+{
+namespace detail
+{
+
+// the support arrays of the BSpline are fixed or sized on allocation
+template <typename T>
+void AllocateSupportArray( itk::Array<T> &a, unsigned int n ) { a.SetSize( n ); }
+
+template <typename T, unsigned int VLength>
+void AllocateSupportArray( itk::FixedArray<T, VLength> &, unsigned int ) {}
+
+template <typename TImageType> class SparseBSplineMeanSquaresMetric;
+
+
+/** \class SparseBSplineMeanSquaresGetValueAndDerivativeThreader
+ * \brief Mean squares value and derivative using only the local
+ * support of a BSpline transform.
+ *
+ * The ITK threaders compute the Jacobian of the transform with
+ * respect to all of its parameters, and accumulate a derivative of
+ * the size of the parameters for each sample. A sample only depends
+ * on the (order+1)^D control points of its support, so this threader
+ * directly adds their contributions to the derivative of the thread,
+ * and the reduction of the threads is left to the superclass.
+ */
+template <typename TDomainPartitioner, typename TImageType>
+class SparseBSplineMeanSquaresGetValueAndDerivativeThreader
+  : public itk::ImageToImageMetricv4GetValueAndDerivativeThreader<
+      TDomainPartitioner,
+      typename itk::MeanSquaresImageToImageMetricv4<TImageType, TImageType>::Superclass>
+{
+public:
+  using MetricType = SparseBSplineMeanSquaresMetric<TImageType>;
+  using ImageToImageMetricType = typename itk::MeanSquaresImageToImageMetricv4<TImageType, TImageType>::Superclass;
+
+  using Self = SparseBSplineMeanSquaresGetValueAndDerivativeThreader;
+  using Superclass = itk::ImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner, ImageToImageMetricType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SparseBSplineMeanSquaresGetValueAndDerivativeThreader, ImageToImageMetricv4GetValueAndDerivativeThreader);
+
+  using VirtualIndexType = typename ImageToImageMetricType::VirtualIndexType;
+  using VirtualPointType = typename ImageToImageMetricType::VirtualPointType;
+  using FixedImagePointType = typename ImageToImageMetricType::FixedImagePointType;
+  using FixedImagePixelType = typename ImageToImageMetricType::FixedImagePixelType;
+  using FixedImageGradientType = typename ImageToImageMetricType::FixedImageGradientType;
+  using MovingImagePointType = typename ImageToImageMetricType::MovingImagePointType;
+  using MovingImagePixelType = typename ImageToImageMetricType::MovingImagePixelType;
+  using MovingImageGradientType = typename ImageToImageMetricType::MovingImageGradientType;
+  using MeasureType = typename ImageToImageMetricType::MeasureType;
+  using DerivativeType = typename ImageToImageMetricType::DerivativeType;
+  using JacobianType = typename ImageToImageMetricType::JacobianType;
+
+protected:
+  SparseBSplineMeanSquaresGetValueAndDerivativeThreader() = default;
+
+  bool ProcessVirtualPoint( const VirtualIndexType &,
+                            const VirtualPointType &virtualPoint,
+                            const ThreadIdType threadId ) override
+    {
+      const MetricType *metric = static_cast<const MetricType *>( this->m_Associate );
+
+      FixedImagePointType  mappedFixedPoint;
+      FixedImagePixelType  mappedFixedPixelValue;
+      if ( !metric->EvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue ) )
+        {
+        return false;
+        }
+
+      MovingImagePointType mappedMovingPoint;
+      MovingImagePixelType mappedMovingPixelValue;
+      if ( !metric->EvaluateMovingPoint( virtualPoint, mappedMovingPoint, mappedMovingPixelValue ) )
+        {
+        return false;
+        }
+
+      const double diff = static_cast<double>( mappedFixedPixelValue ) - static_cast<double>( mappedMovingPixelValue );
+
+      auto &threadVariables = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+      ++threadVariables.NumberOfValidPoints;
+      threadVariables.Measure += diff * diff;
+
+      if ( !metric->IsComputingDerivative() )
+        {
+        return true;
+        }
+
+      MovingImageGradientType mappedMovingImageGradient;
+      metric->EvaluateMovingImageGradient( mappedMovingPoint, mappedMovingImageGradient );
+
+      std::array<double, MetricType::MaximumNumberOfWeights> weights;
+      std::array<itk::SizeValueType, MetricType::MaximumNumberOfWeights> indices;
+      const unsigned int numberOfWeights = metric->ComputeSupport( virtualPoint, weights.data(), indices.data() );
+
+      const itk::SizeValueType parametersPerDimension = metric->GetNumberOfParametersPerDimension();
+      for ( unsigned int d = 0; d < ImageToImageMetricType::VirtualImageDimension; ++d )
+        {
+        const double factor = 2.0 * diff * mappedMovingImageGradient[d];
+        const itk::SizeValueType offset = d * parametersPerDimension;
+        for ( unsigned int k = 0; k < numberOfWeights; ++k )
+          {
+          threadVariables.CompensatedDerivatives[offset + indices[k]] += factor * weights[k];
+          }
+        }
+      return true;
+    }
+
+  // not used, ProcessVirtualPoint does not compute the Jacobian
+  bool ProcessPoint( const VirtualIndexType &,
+                     const VirtualPointType &virtualPoint,
+                     const FixedImagePointType &,
+                     const FixedImagePixelType &mappedFixedPixelValue,
+                     const FixedImageGradientType &,
+                     const MovingImagePointType &,
+                     const MovingImagePixelType &mappedMovingPixelValue,
+                     const MovingImageGradientType &mappedMovingImageGradient,
+                     MeasureType &metricValueReturn,
+                     DerivativeType &localDerivativeReturn,
+                     const ThreadIdType ) const override
+    {
+      const double diff = static_cast<double>( mappedFixedPixelValue ) - static_cast<double>( mappedMovingPixelValue );
+      metricValueReturn = diff * diff;
+
+      JacobianType jacobian;
+      this->m_Associate->GetMovingTransform()->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian );
+      for ( unsigned int par = 0; par < localDerivativeReturn.Size(); ++par )
+        {
+        localDerivativeReturn[par] = 0.0;
+        for ( unsigned int d = 0; d < ImageToImageMetricType::VirtualImageDimension; ++d )
+          {
+          localDerivativeReturn[par] += 2.0 * diff * jacobian( d, par ) * mappedMovingImageGradient[d];
+          }
+        }
+      return true;
+    }
+};
+
+
+/** \class SparseBSplineMeanSquaresMetric
+ * \brief MeanSquaresImageToImageMetricv4 with a sparse Jacobian for
+ * BSpline transforms.
+ *
+ * When the moving transform is a BSplineTransform, alone or as the
+ * only transform of a CompositeTransform, the value and derivative are
+ * computed by SparseBSplineMeanSquaresGetValueAndDerivativeThreader.
+ * Otherwise the metric is the ITK one.
+ */
+template <typename TImageType>
+class SparseBSplineMeanSquaresMetric
+  : public itk::MeanSquaresImageToImageMetricv4<TImageType, TImageType>
+{
+public:
+  using Self = SparseBSplineMeanSquaresMetric;
+  using Superclass = itk::MeanSquaresImageToImageMetricv4<TImageType, TImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SparseBSplineMeanSquaresMetric, MeanSquaresImageToImageMetricv4);
+
+  static constexpr unsigned int Dimension = TImageType::ImageDimension;
+  static constexpr unsigned int MaximumNumberOfWeights = 4 * 4 * ( Dimension > 2 ? 4 : 1 );
+
+  using VirtualPointType = typename Superclass::VirtualPointType;
+  using FixedImagePointType = typename Superclass::FixedImagePointType;
+  using FixedImagePixelType = typename Superclass::FixedImagePixelType;
+  using MovingImagePointType = typename Superclass::MovingImagePointType;
+  using MovingImagePixelType = typename Superclass::MovingImagePixelType;
+  using MovingImageGradientType = typename Superclass::MovingImageGradientType;
+
+  void Initialize() override
+    {
+      Superclass::Initialize();
+
+      const ThreadIdType numberOfWorkUnits = this->m_DenseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads();
+
+      m_BSplineTransform = nullptr;
+      m_ComputeSupport = nullptr;
+
+      const itk::TransformBase *transform = this->GetMovingTransform();
+      using CompositeTransformType = itk::CompositeTransform<double, Dimension>;
+      if ( const auto *composite = dynamic_cast<const CompositeTransformType *>( transform ) )
+        {
+        transform = ( composite->GetNumberOfTransforms() == 1 && composite->GetNthTransformToOptimize( 0 ) )
+          ? composite->GetNthTransformConstPointer( 0 )
+          : nullptr;
+        }
+
+      if ( transform && ( this->TrySplineOrder<3>( transform ) ||
+                          this->TrySplineOrder<2>( transform ) ||
+                          this->TrySplineOrder<1>( transform ) ||
+                          this->TrySplineOrder<0>( transform ) ) )
+        {
+        this->m_DenseGetValueAndDerivativeThreader = m_SparseJacobianDenseThreader;
+        this->m_SparseGetValueAndDerivativeThreader = m_SparseJacobianSparseThreader;
+        }
+      else
+        {
+        this->m_DenseGetValueAndDerivativeThreader = m_DefaultDenseThreader;
+        this->m_SparseGetValueAndDerivativeThreader = m_DefaultSparseThreader;
+        }
+      this->m_DenseGetValueAndDerivativeThreader->SetMaximumNumberOfThreads( numberOfWorkUnits );
+      this->m_SparseGetValueAndDerivativeThreader->SetMaximumNumberOfThreads( numberOfWorkUnits );
+    }
+
+  bool EvaluateFixedPoint( const VirtualPointType &virtualPoint,
+                           FixedImagePointType &mappedFixedPoint,
+                           FixedImagePixelType &mappedFixedPixelValue ) const
+    {
+      return this->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
+    }
+
+  bool EvaluateMovingPoint( const VirtualPointType &virtualPoint,
+                            MovingImagePointType &mappedMovingPoint,
+                            MovingImagePixelType &mappedMovingPixelValue ) const
+    {
+      return this->TransformAndEvaluateMovingPoint( virtualPoint, mappedMovingPoint, mappedMovingPixelValue );
+    }
+
+  void EvaluateMovingImageGradient( const MovingImagePointType &mappedMovingPoint,
+                                    MovingImageGradientType &gradient ) const
+    {
+      this->ComputeMovingImageGradientAtPoint( mappedMovingPoint, gradient );
+    }
+
+  bool IsComputingDerivative() const
+    {
+      return this->m_ComputeDerivative;
+    }
+
+  /** The weights and the indices in the parameters of a dimension of
+   * the control points supporting point, none outside of the grid. */
+  unsigned int ComputeSupport( const VirtualPointType &point, double *weights, itk::SizeValueType *indices ) const
+    {
+      return ( *m_ComputeSupport )( m_BSplineTransform, point, weights, indices );
+    }
+
+  itk::SizeValueType GetNumberOfParametersPerDimension() const
+    {
+      return m_NumberOfParametersPerDimension;
+    }
+
+protected:
+  SparseBSplineMeanSquaresMetric()
+    {
+      m_DefaultDenseThreader = this->m_DenseGetValueAndDerivativeThreader;
+      m_DefaultSparseThreader = this->m_SparseGetValueAndDerivativeThreader;
+      m_SparseJacobianDenseThreader =
+        SparseBSplineMeanSquaresGetValueAndDerivativeThreader<itk::ThreadedImageRegionPartitioner<Dimension>, TImageType>::New();
+      m_SparseJacobianSparseThreader =
+        SparseBSplineMeanSquaresGetValueAndDerivativeThreader<itk::ThreadedIndexedContainerPartitioner, TImageType>::New();
+    }
+
+private:
+  using ComputeSupportFunctionType = unsigned int (*)( const itk::TransformBase *,
+                                                       const VirtualPointType &,
+                                                       double *,
+                                                       itk::SizeValueType * );
+
+  template <unsigned int VSplineOrder>
+  static unsigned int ComputeSupportOfOrder( const itk::TransformBase *transform,
+                                             const VirtualPointType &point,
+                                             double *weights,
+                                             itk::SizeValueType *indices )
+    {
+      using BSplineTransformType = itk::BSplineTransform<double, Dimension, VSplineOrder>;
+      const auto *bspline = static_cast<const BSplineTransformType *>( transform );
+
+      unsigned int numberOfWeights = 1;
+      for ( unsigned int d = 0; d < Dimension; ++d )
+        {
+        numberOfWeights *= VSplineOrder + 1;
+        }
+
+      typename BSplineTransformType::WeightsType supportWeights;
+      typename BSplineTransformType::ParameterIndexArrayType supportIndices;
+      AllocateSupportArray( supportWeights, numberOfWeights );
+      AllocateSupportArray( supportIndices, numberOfWeights );
+
+      typename BSplineTransformType::OutputPointType outputPoint;
+      bool inside = false;
+      bspline->TransformPoint( point, outputPoint, supportWeights, supportIndices, inside );
+      if ( !inside )
+        {
+        return 0;
+        }
+      for ( unsigned int k = 0; k < numberOfWeights; ++k )
+        {
+        weights[k] = supportWeights[k];
+        indices[k] = supportIndices[k];
+        }
+      return numberOfWeights;
+    }
+
+  template <unsigned int VSplineOrder>
+  bool TrySplineOrder( const itk::TransformBase *transform )
+    {
+      using BSplineTransformType = itk::BSplineTransform<double, Dimension, VSplineOrder>;
+      const auto *bspline = dynamic_cast<const BSplineTransformType *>( transform );
+      if ( !bspline )
+        {
+        return false;
+        }
+      m_BSplineTransform = bspline;
+      m_ComputeSupport = &ComputeSupportOfOrder<VSplineOrder>;
+      m_NumberOfParametersPerDimension = bspline->GetNumberOfParametersPerDimension();
+      return true;
+    }
+
+  typename Superclass::DenseGetValueAndDerivativeThreaderType::Pointer m_DefaultDenseThreader;
+  typename Superclass::SparseGetValueAndDerivativeThreaderType::Pointer m_DefaultSparseThreader;
+  typename Superclass::DenseGetValueAndDerivativeThreaderType::Pointer m_SparseJacobianDenseThreader;
+  typename Superclass::SparseGetValueAndDerivativeThreaderType::Pointer m_SparseJacobianSparseThreader;
+
+  const itk::TransformBase *m_BSplineTransform{ nullptr };
+  ComputeSupportFunctionType m_ComputeSupport{ nullptr };
+  itk::SizeValueType m_NumberOfParametersPerDimension{ 0 };
+};
+
+}
+}
+}
+
+#endif // sitkSparseBSplineMeanSquaresMetric_h
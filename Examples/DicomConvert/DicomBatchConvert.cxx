@@ -0,0 +1,149 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+
+// Convert every DICOM series found in a directory tree to an image
+// file, reading, resampling and writing the series concurrently.
+
+#include <SimpleITK.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace sitk = itk::simple;
+
+namespace
+{
+
+void usage( const char *name )
+{
+  std::cerr << "Usage: " << name << " [options] <input_directory> <output_directory>\n"
+            << "Options:\n"
+            << "  --extension <ext>      output file extension (default .nrrd)\n"
+            << "  --spacing <s> [<s>...] resample to this spacing, one value per dimension\n"
+            << "  --float                cast the images to 32-bit float\n"
+            << "  --compress             compress the output files\n"
+            << "  --readers <n>          number of reading threads (default all cores)\n"
+            << "  --writers <n>          number of writing threads (default all cores)\n"
+            << "  --queue <n>            images held between the stages (default 2)\n"
+            << "  --index <file>         persist the series index to this file\n"
+            << "  --no-recursive         only scan the input directory itself\n";
+}
+
+}
+
+int main ( int argc, char* argv[] ) {
+
+  sitk::DICOMSeriesConverter converter;
+  converter.RecursiveOn();
+
+  std::vector<std::string> positional;
+  std::vector<double> spacing;
+  for ( int i = 1; i < argc; ++i )
+    {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if ( arg == "--extension" && hasValue )
+      {
+      converter.SetOutputExtension( argv[++i] );
+      }
+    else if ( arg == "--spacing" && hasValue )
+      {
+      while ( i + 1 < argc && std::strncmp( argv[i+1], "--", 2 ) != 0 && spacing.size() < 3 )
+        {
+        spacing.push_back( std::atof( argv[++i] ) );
+        }
+      }
+    else if ( arg == "--float" )
+      {
+      converter.SetOutputPixelType( sitk::sitkFloat32 );
+      }
+    else if ( arg == "--compress" )
+      {
+      converter.UseCompressionOn();
+      }
+    else if ( arg == "--readers" && hasValue )
+      {
+      converter.SetNumberOfReaders( std::atoi( argv[++i] ) );
+      }
+    else if ( arg == "--writers" && hasValue )
+      {
+      converter.SetNumberOfWriters( std::atoi( argv[++i] ) );
+      }
+    else if ( arg == "--queue" && hasValue )
+      {
+      converter.SetQueueSize( std::atoi( argv[++i] ) );
+      }
+    else if ( arg == "--index" && hasValue )
+      {
+      converter.SetIndexFileName( argv[++i] );
+      }
+    else if ( arg == "--no-recursive" )
+      {
+      converter.RecursiveOff();
+      }
+    else if ( arg.compare( 0, 2, "--" ) == 0 )
+      {
+      usage( argv[0] );
+      return 1;
+      }
+    else
+      {
+      positional.push_back( arg );
+      }
+    }
+
+  if ( positional.size() != 2 )
+    {
+    usage( argv[0] );
+    return 1;
+    }
+
+  converter.SetInputDirectory( positional[0] );
+  converter.SetOutputDirectory( positional[1] );
+
+  try
+    {
+    converter.SetOutputSpacing( spacing );
+    converter.Execute();
+    }
+  catch ( std::exception &e )
+    {
+    std::cerr << e.what() << std::endl;
+    return 1;
+    }
+
+  const std::vector<std::string> &converted = converter.GetConvertedSeriesIDs();
+  const std::vector<std::string> &outputs = converter.GetOutputFileNames();
+  for ( size_t i = 0; i < converted.size(); ++i )
+    {
+    std::cout << converted[i] << " -> " << outputs[i] << std::endl;
+    }
+
+  const std::vector<std::string> &failed = converter.GetFailedSeriesIDs();
+  const std::vector<std::string> &errors = converter.GetErrorMessages();
+  for ( size_t i = 0; i < failed.size(); ++i )
+    {
+    std::cerr << failed[i] << " failed: " << errors[i] << std::endl;
+    }
+
+  std::cout << converted.size() << " series converted, " << failed.size() << " failed." << std::endl;
+
+  return failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+
+// Compares the time and the quality of the patch-based denoising
+// algorithms. Gaussian noise is added to the image, which is then
+// denoised by each algorithm, and the mean absolute error and the peak
+// signal to noise ratio to the original image are reported.
+
+#include <SimpleITK.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <exception>
+#include <string>
+#include <utility>
+
+namespace sitk = itk::simple;
+
+namespace
+{
+
+template <typename TFunction>
+double
+TimePerIteration( TFunction f, unsigned int iterations )
+{
+  const auto start = std::chrono::steady_clock::now();
+  for ( unsigned int i = 0; i < iterations; ++i )
+    {
+    f();
+    }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+}
+
+int main ( int argc, char* argv[] )
+  {
+
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " image_file_name [noise_sigma] [iterations]\n";
+    return 1;
+    }
+
+  const double noiseSigma = ( argc > 2 ) ? std::atof( argv[2] ) : 20.0;
+  const unsigned int iterations = ( argc > 3 ) ? std::max( 1, std::atoi( argv[3] ) ) : 1;
+
+  try
+    {
+    const sitk::Image image = sitk::Cast( sitk::ReadImage( argv[1] ), sitk::sitkFloat32 );
+    const sitk::Image noisy = sitk::AdditiveGaussianNoise( image, noiseSigma, 0.0, 1u );
+
+    sitk::MinimumMaximumImageFilter minimumMaximum;
+    minimumMaximum.Execute( image );
+    const double range = minimumMaximum.GetMaximum() - minimumMaximum.GetMinimum();
+
+    auto report = [&image, range]( const std::string &name, const sitk::Image &denoised, double seconds )
+      {
+        sitk::StatisticsImageFilter stats;
+        const sitk::Image difference = sitk::Subtract( denoised, image );
+        stats.Execute( sitk::Abs( difference ) );
+        const double meanAbsoluteError = stats.GetMean();
+        stats.Execute( sitk::Square( difference ) );
+        const double psnr = 10.0 * std::log10( range * range / stats.GetMean() );
+
+        std::cout << "\t" << std::setw( 24 ) << std::left << name << std::right
+                  << std::setw( 10 ) << seconds << " s"
+                  << std::setw( 10 ) << meanAbsoluteError << " MAE"
+                  << std::setw( 10 ) << psnr << " dB" << std::endl;
+      };
+
+    std::cout << std::fixed << std::setprecision( 3 );
+    std::cout << "Noise sigma: " << noiseSigma << std::endl;
+    report( "Noisy", noisy, 0.0 );
+
+    sitk::PatchBasedDenoisingImageFilter filter;
+    // the kernel bandwidth of the Gaussian noise over the patches of
+    // the non-local means
+    const double patchPixels = std::pow( 2.0 * filter.GetPatchRadius() + 1.0, image.GetDimension() );
+    const double bandwidth = noiseSigma * std::sqrt( 2.0 * patchPixels );
+
+    const std::pair<sitk::PatchBasedDenoisingImageFilter::AlgorithmType, std::string> algorithms[] = {
+      { sitk::PatchBasedDenoisingImageFilter::Sampling, "Sampling" },
+      { sitk::PatchBasedDenoisingImageFilter::NonLocalMeans, "NonLocalMeans" },
+      { sitk::PatchBasedDenoisingImageFilter::BlockwiseNonLocalMeans, "BlockwiseNonLocalMeans" } };
+
+    for ( const auto &algorithmAndName : algorithms )
+      {
+      const sitk::PatchBasedDenoisingImageFilter::AlgorithmType algorithm = algorithmAndName.first;
+      filter.SetAlgorithm( algorithm );
+      if ( algorithm == sitk::PatchBasedDenoisingImageFilter::Sampling )
+        {
+        filter.KernelBandwidthEstimationOn();
+        }
+      else
+        {
+        filter.KernelBandwidthEstimationOff();
+        filter.SetKernelBandwidthSigma( bandwidth );
+        }
+
+      sitk::Image denoised;
+      const double seconds = TimePerIteration( [&]() { denoised = filter.Execute( noisy ); }, iterations );
+      report( algorithmAndName.second, denoised, seconds );
+      }
+    }
+  catch (std::exception& e)
+    {
+    std::cerr << "Benchmark failed: " << e.what() << std::endl;
+    return 1;
+    }
+
+  return 0;
+  }
@@ -144,6 +144,7 @@ option(BUILD_SHARED_LIBS "Build SimpleITK ITK with shared libraries. This does n
 # as this option does not robustly work across platforms it will be marked as advanced
 mark_as_advanced( FORCE BUILD_SHARED_LIBS )
 
+include(sitkPixelTypeProfileOption)
 include(sitkMaxDimensionOption)
 
 
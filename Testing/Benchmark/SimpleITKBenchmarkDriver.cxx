@@ -0,0 +1,455 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include "sitkBenchmark.h"
+
+#include <sitkAdditionalProcedures.h>
+#include <sitkImageFileReader.h>
+#include <sitkVersion.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+#ifndef SITK_BENCHMARK_DATA_DIRECTORY
+#define SITK_BENCHMARK_DATA_DIRECTORY "."
+#endif
+
+namespace sitk = itk::simple;
+
+namespace itk
+{
+namespace simple
+{
+namespace benchmark
+{
+
+std::vector<BenchmarkCase> &GetBenchmarkCases()
+{
+  static std::vector<BenchmarkCase> cases;
+  return cases;
+}
+
+}
+}
+}
+
+namespace
+{
+
+struct Options
+{
+  std::string dataDirectory = SITK_BENCHMARK_DATA_DIRECTORY;
+  std::string outputFileName;
+  std::regex filter{ ".*" };
+  std::vector<uint64_t> numberOfPixels{ 1u << 18, 1u << 21, 1u << 24 };
+  std::vector<unsigned int> numberOfThreads;
+  unsigned int repetitions = 5;
+  bool list = false;
+};
+
+
+struct Result
+{
+  const sitk::benchmark::BenchmarkCase *benchmarkCase;
+  std::vector<unsigned int> size;
+  uint64_t numberOfPixels = 0;
+  unsigned int numberOfThreads = 0;
+  std::vector<double> seconds;
+  std::string error;
+};
+
+
+template <typename T>
+std::vector<T> ParseList( const std::string &value )
+{
+  std::vector<T> values;
+  std::istringstream iss( value );
+  std::string item;
+  while ( std::getline( iss, item, ',' ) )
+    {
+    values.push_back( static_cast<T>( std::stoull( item ) ) );
+    }
+  return values;
+}
+
+
+void PrintUsage( const char *program )
+{
+  std::cout << "Usage: " << program << " [options]\n"
+            << "Times the filters with the settings and the inputs of the tests of their JSON descriptions.\n\n"
+            << "\t--data DIRECTORY   Directory of the input files of the tests\n"
+            << "\t--output FILE      JSON file of the results, the standard output by default\n"
+            << "\t--filter REGEX     Only the benchmarks with a Filter.tag name matching the regular expression\n"
+            << "\t--pixels N[,N...]  Number of pixels the first input of a benchmark is scaled to\n"
+            << "\t--threads N[,N...] Number of threads of the filters, powers of two up to the number of cores by default\n"
+            << "\t--repetitions N    Number of timed executions for each size and number of threads\n"
+            << "\t--list             List the benchmarks" << std::endl;
+}
+
+
+std::string Escape( const std::string &s )
+{
+  std::ostringstream oss;
+  for ( char c : s )
+    {
+    switch ( c )
+      {
+      case '"':  oss << "\\\""; break;
+      case '\\': oss << "\\\\"; break;
+      case '\n': oss << "\\n"; break;
+      case '\t': oss << "\\t"; break;
+      default:
+        if ( static_cast<unsigned char>( c ) < 0x20 )
+          {
+          oss << ' ';
+          }
+        else
+          {
+          oss << c;
+          }
+      }
+    }
+  return oss.str();
+}
+
+
+uint64_t GetNumberOfPixels( const std::vector<unsigned int> &size )
+{
+  uint64_t n = 1;
+  for ( unsigned int s : size )
+    {
+    n *= s;
+    }
+  return n;
+}
+
+
+// Resample an image with the nearest neighbor, so the values of
+// labels are kept, to about the number of pixels with the same
+// physical extent.
+sitk::Image ScaleToNumberOfPixels( const sitk::Image &image, uint64_t numberOfPixels )
+{
+  const std::vector<unsigned int> size = image.GetSize();
+  const double factor = std::pow( static_cast<double>( numberOfPixels ) / GetNumberOfPixels( size ), 1.0 / size.size() );
+
+  std::vector<uint32_t> outputSize( size.size() );
+  std::vector<double> outputSpacing = image.GetSpacing();
+  for ( unsigned int d = 0; d < size.size(); ++d )
+    {
+    outputSize[d] = std::max( 1u, static_cast<uint32_t>( std::lround( size[d] * factor ) ) );
+    outputSpacing[d] *= static_cast<double>( size[d] ) / outputSize[d];
+    }
+
+  return sitk::Resample( image,
+                         outputSize,
+                         sitk::Transform(),
+                         sitk::sitkNearestNeighbor,
+                         image.GetOrigin(),
+                         outputSpacing,
+                         image.GetDirection() );
+}
+
+
+// Scale the first input, and the other inputs of the same size onto
+// its grid. The other inputs, such as kernels, are not changed.
+std::vector<sitk::Image> ScaleInputs( const std::vector<sitk::Image> &inputs, uint64_t numberOfPixels )
+{
+  std::vector<sitk::Image> scaled;
+  for ( const sitk::Image &input : inputs )
+    {
+    if ( scaled.empty() )
+      {
+      scaled.push_back( ScaleToNumberOfPixels( input, numberOfPixels ) );
+      }
+    else if ( input.GetSize() == inputs[0].GetSize() )
+      {
+      scaled.push_back( sitk::Resample( input, scaled[0], sitk::Transform(), sitk::sitkNearestNeighbor ) );
+      }
+    else
+      {
+      scaled.push_back( input );
+      }
+    }
+  return scaled;
+}
+
+
+void RunBenchmark( const sitk::benchmark::BenchmarkCase &benchmarkCase,
+                   const Options &options,
+                   std::vector<Result> &results )
+{
+  std::vector<sitk::Image> inputs;
+  try
+    {
+    sitk::ImageFileReader reader;
+    for ( const std::string &fileName : benchmarkCase.inputFileNames )
+      {
+      inputs.push_back( reader.SetFileName( options.dataDirectory + "/" + fileName ).Execute() );
+      }
+    benchmarkCase.prepare( inputs );
+    }
+  catch ( std::exception &e )
+    {
+    results.push_back( Result{ &benchmarkCase, {}, 0, 0, {}, e.what() } );
+    return;
+    }
+
+  // sources are only benchmarked with the size of their settings
+  std::vector<uint64_t> numberOfPixels = options.numberOfPixels;
+  if ( inputs.empty() )
+    {
+    numberOfPixels.assign( 1, 0 );
+    }
+
+  for ( uint64_t n : numberOfPixels )
+    {
+    std::vector<sitk::Image> scaled;
+    Result sizeResult{ &benchmarkCase, {}, 0, 0, {}, "" };
+    try
+      {
+      if ( !inputs.empty() )
+        {
+        scaled = ScaleInputs( inputs, n );
+        sizeResult.size = scaled[0].GetSize();
+        sizeResult.numberOfPixels = GetNumberOfPixels( sizeResult.size );
+        }
+      }
+    catch ( std::exception &e )
+      {
+      sizeResult.error = e.what();
+      results.push_back( sizeResult );
+      continue;
+      }
+
+    for ( unsigned int numberOfThreads : options.numberOfThreads )
+      {
+      Result result = sizeResult;
+      result.numberOfThreads = numberOfThreads;
+      try
+        {
+        sitk::benchmark::ExecuteFunctionType execute = benchmarkCase.create( numberOfThreads );
+
+        // the first execution is not timed
+        execute( scaled );
+        for ( unsigned int i = 0; i < options.repetitions; ++i )
+          {
+          const auto start = std::chrono::steady_clock::now();
+          execute( scaled );
+          const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+          result.seconds.push_back( elapsed.count() );
+          }
+        }
+      catch ( std::exception &e )
+        {
+        result.error = e.what();
+        }
+      results.push_back( result );
+      }
+    }
+}
+
+
+void WriteResults( std::ostream &os, const std::vector<Result> &results )
+{
+  os << "{\n"
+     << "  \"context\": {\n"
+     << "    \"simpleitk_version\": \"" << Escape( sitk::Version::VersionString() ) << "\",\n"
+     << "    \"itk_version\": \"" << Escape( sitk::Version::ITKVersionString() ) << "\",\n"
+     << "    \"build_date\": \"" << Escape( sitk::Version::BuildDate() ) << "\",\n"
+     << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << "\n"
+     << "  },\n"
+     << "  \"benchmarks\": [";
+
+  os.precision( 9 );
+  for ( size_t r = 0; r < results.size(); ++r )
+    {
+    const Result &result = results[r];
+    os << ( r ? ",\n" : "\n" )
+       << "    {\"filter\": \"" << result.benchmarkCase->filterName << "\", "
+       << "\"tag\": \"" << result.benchmarkCase->tag << "\", "
+       << "\"size\": [";
+    for ( size_t d = 0; d < result.size.size(); ++d )
+      {
+      os << ( d ? ", " : "" ) << result.size[d];
+      }
+    os << "], \"pixels\": " << result.numberOfPixels
+       << ", \"threads\": " << result.numberOfThreads;
+
+    if ( !result.error.empty() )
+      {
+      os << ", \"error\": \"" << Escape( result.error ) << "\"}";
+      continue;
+      }
+
+    std::vector<double> seconds = result.seconds;
+    std::sort( seconds.begin(), seconds.end() );
+    double sum = 0.0;
+    for ( double s : seconds )
+      {
+      sum += s;
+      }
+    os << ", \"repetitions\": " << seconds.size()
+       << ", \"seconds\": [";
+    for ( size_t i = 0; i < result.seconds.size(); ++i )
+      {
+      os << ( i ? ", " : "" ) << result.seconds[i];
+      }
+    os << "]";
+    if ( !seconds.empty() )
+      {
+      os << ", \"min_seconds\": " << seconds.front()
+         << ", \"median_seconds\": " << seconds[seconds.size() / 2]
+         << ", \"mean_seconds\": " << sum / seconds.size();
+      if ( result.numberOfPixels && seconds.front() > 0.0 )
+        {
+        os << ", \"pixels_per_second\": " << result.numberOfPixels / seconds.front();
+        }
+      }
+    os << "}";
+    }
+  os << "\n  ]\n}" << std::endl;
+}
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  Options options;
+
+  try
+    {
+    for ( int i = 1; i < argc; ++i )
+      {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if ( arg == "--help" )
+        {
+        PrintUsage( argv[0] );
+        return 0;
+        }
+      else if ( arg == "--list" )
+        {
+        options.list = true;
+        }
+      else if ( arg == "--data" && hasValue )
+        {
+        options.dataDirectory = argv[++i];
+        }
+      else if ( arg == "--output" && hasValue )
+        {
+        options.outputFileName = argv[++i];
+        }
+      else if ( arg == "--filter" && hasValue )
+        {
+        options.filter = std::regex( argv[++i] );
+        }
+      else if ( arg == "--pixels" && hasValue )
+        {
+        options.numberOfPixels = ParseList<uint64_t>( argv[++i] );
+        }
+      else if ( arg == "--threads" && hasValue )
+        {
+        options.numberOfThreads = ParseList<unsigned int>( argv[++i] );
+        }
+      else if ( arg == "--repetitions" && hasValue )
+        {
+        options.repetitions = static_cast<unsigned int>( std::stoul( argv[++i] ) );
+        }
+      else
+        {
+        std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+        PrintUsage( argv[0] );
+        return 1;
+        }
+      }
+    }
+  catch ( std::exception &e )
+    {
+    std::cerr << "Invalid argument: " << e.what() << std::endl;
+    return 1;
+    }
+
+  if ( options.numberOfThreads.empty() )
+    {
+    const unsigned int cores = std::max( 1u, std::thread::hardware_concurrency() );
+    for ( unsigned int n = 1; n < cores; n *= 2 )
+      {
+      options.numberOfThreads.push_back( n );
+      }
+    options.numberOfThreads.push_back( cores );
+    }
+
+  std::vector<const sitk::benchmark::BenchmarkCase *> selected;
+  for ( const sitk::benchmark::BenchmarkCase &benchmarkCase : sitk::benchmark::GetBenchmarkCases() )
+    {
+    if ( std::regex_search( benchmarkCase.filterName + "." + benchmarkCase.tag, options.filter ) )
+      {
+      selected.push_back( &benchmarkCase );
+      }
+    }
+  std::sort( selected.begin(), selected.end(), []( const sitk::benchmark::BenchmarkCase *a, const sitk::benchmark::BenchmarkCase *b )
+    {
+      return std::tie( a->filterName, a->tag ) < std::tie( b->filterName, b->tag );
+    } );
+
+  if ( options.list )
+    {
+    for ( const sitk::benchmark::BenchmarkCase *benchmarkCase : selected )
+      {
+      std::cout << benchmarkCase->filterName << "." << benchmarkCase->tag << std::endl;
+      }
+    return 0;
+    }
+
+  std::vector<Result> results;
+  for ( const sitk::benchmark::BenchmarkCase *benchmarkCase : selected )
+    {
+    std::cerr << "Benchmarking " << benchmarkCase->filterName << "." << benchmarkCase->tag << std::endl;
+    RunBenchmark( *benchmarkCase, options, results );
+    }
+
+  if ( options.outputFileName.empty() )
+    {
+    WriteResults( std::cout, results );
+    }
+  else
+    {
+    std::ofstream ofs( options.outputFileName );
+    if ( !ofs )
+      {
+      std::cerr << "Failed to open " << options.outputFileName << " for writing." << std::endl;
+      return 1;
+      }
+    WriteResults( ofs, results );
+    }
+
+  bool failed = false;
+  for ( const Result &result : results )
+    {
+    failed = failed || !result.error.empty();
+    }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,580 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include <sitkAdditiveGaussianNoiseImageFilter.h>
+#include <sitkCastImageFilter.h>
+#include <sitkGaussianImageSource.h>
+#include <sitkImageFileReader.h>
+#include <sitkImageFileWriter.h>
+#include <sitkImageSeriesReader.h>
+#include <sitkImageSeriesWriter.h>
+#include <sitkVersion.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef SITK_BENCHMARK_TEMP_DIRECTORY
+#define SITK_BENCHMARK_TEMP_DIRECTORY "."
+#endif
+
+namespace sitk = itk::simple;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+struct Compressor
+{
+  /** The name given to SetCompressor, empty for the default of the ImageIO. */
+  std::string name;
+  /** The compression levels, -1 for the default of the ImageIO. */
+  std::vector<int> levels;
+};
+
+struct Format
+{
+  std::string name;
+  std::string extension;
+  sitk::PixelIDValueEnum pixelType;
+  bool is2D;
+  bool series;
+  bool uncompressed;
+  std::vector<Compressor> compressors;
+};
+
+/** A format, and its compression settings. */
+struct Configuration
+{
+  const Format *format;
+  bool useCompression;
+  std::string compressor;
+  int level;
+
+  std::string Name() const
+    {
+      std::string name = format->name;
+      if ( !useCompression )
+        {
+        return name + ".none";
+        }
+      name += "." + ( compressor.empty() ? std::string( "default" ) : compressor );
+      return level < 0 ? name : name + "." + std::to_string( level );
+    }
+};
+
+struct Timings
+{
+  std::vector<double> seconds;
+
+  double Minimum() const { return seconds.empty() ? 0.0 : *std::min_element( seconds.begin(), seconds.end() ); }
+  double Median() const
+    {
+      std::vector<double> sorted = seconds;
+      std::sort( sorted.begin(), sorted.end() );
+      return sorted.empty() ? 0.0 : sorted[sorted.size() / 2];
+    }
+};
+
+struct Result
+{
+  std::string configuration;
+  std::vector<unsigned int> size;
+  uint64_t imageBytes = 0;
+  uint64_t fileBytes = 0;
+  Timings write;
+  Timings header;
+  Timings warmRead;
+  Timings coldRead;
+  std::string error;
+};
+
+struct Options
+{
+  std::string temporaryDirectory = SITK_BENCHMARK_TEMP_DIRECTORY;
+  std::string outputFileName;
+  std::regex filter{ ".*" };
+  std::vector<unsigned int> sizes{ 64, 128, 256 };
+  unsigned int repetitions = 3;
+  bool cold = true;
+};
+
+
+std::vector<Format> CreateFormats()
+{
+  const std::vector<int> zlibLevels{ 1, 6, 9 };
+  return {
+    { "MHA", ".mha", sitk::sitkInt16, false, false, true, { { "", zlibLevels } } },
+    { "NRRD", ".nrrd", sitk::sitkInt16, false, false, true, { { "", zlibLevels } } },
+    { "NIfTI", ".nii", sitk::sitkInt16, false, false, true, {} },
+    { "NIfTI-gz", ".nii.gz", sitk::sitkInt16, false, false, false, { { "", zlibLevels } } },
+    { "TIFF", ".tiff", sitk::sitkInt16, false, false, true,
+      { { "PackBits", { -1 } }, { "LZW", { -1 } }, { "Deflate", zlibLevels } } },
+    { "PNG", ".png", sitk::sitkUInt16, true, false, true, { { "", zlibLevels } } },
+    { "DICOM", ".dcm", sitk::sitkInt16, false, true, true,
+      { { "RLE", { -1 } }, { "JPEGLS", { -1 } }, { "JPEG2000", { -1 } } } } };
+}
+
+
+std::vector<Configuration> CreateConfigurations( const std::vector<Format> &formats )
+{
+  std::vector<Configuration> configurations;
+  for ( const Format &format : formats )
+    {
+    if ( format.uncompressed )
+      {
+      configurations.push_back( Configuration{ &format, false, "", -1 } );
+      }
+    for ( const Compressor &compressor : format.compressors )
+      {
+      for ( int level : compressor.levels )
+        {
+        configurations.push_back( Configuration{ &format, true, compressor.name, level } );
+        }
+      }
+    }
+  return configurations;
+}
+
+
+void PrintUsage( const char *program )
+{
+  std::cout << "Usage: " << program << " [options]\n"
+            << "Measures the write and read throughput and latency of image file formats and compression settings.\n\n"
+            << "\t--sizes N[,N...]  Length of the sides of the volumes, 2D formats have as many pixels, 64,128,256 by default\n"
+            << "\t--repetitions N   Number of timed writes and reads of each configuration\n"
+            << "\t--filter REGEX    Only the configurations with a Format.compressor.level name matching the regular expression\n"
+            << "\t--no-cold         Do not drop the files from the system's cache for the cold reads\n"
+            << "\t--temp DIRECTORY  Directory of the files written\n"
+            << "\t--output FILE     JSON file of the results" << std::endl;
+}
+
+
+std::vector<unsigned int> ParseList( const std::string &value )
+{
+  std::vector<unsigned int> values;
+  std::istringstream iss( value );
+  std::string item;
+  while ( std::getline( iss, item, ',' ) )
+    {
+    values.push_back( static_cast<unsigned int>( std::stoul( item ) ) );
+    }
+  return values;
+}
+
+
+// Remove a file from the page cache, so the next read is from the
+// disk. This is only supported where posix_fadvise is available.
+bool DropFromCache( const std::string &fileName )
+{
+#if ( defined( __unix__ ) || defined( __APPLE__ ) ) && defined( POSIX_FADV_DONTNEED )
+  const int fd = open( fileName.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    {
+    return false;
+    }
+  // the dirty pages of the written file must be on disk to be dropped
+  fsync( fd );
+  const int status = posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+  close( fd );
+  return status == 0;
+#else
+  (void)fileName;
+  return false;
+#endif
+}
+
+
+uint64_t FileSize( const std::string &fileName )
+{
+  std::ifstream ifs( fileName, std::ios::binary | std::ios::ate );
+  return ifs ? static_cast<uint64_t>( ifs.tellg() ) : 0;
+}
+
+
+sitk::Image CreateImage( const Format &format, unsigned int side )
+{
+  std::vector<unsigned int> size( 3, side );
+  if ( format.is2D )
+    {
+    const unsigned int side2D = static_cast<unsigned int>( std::lround( std::pow( side, 1.5 ) ) );
+    size.assign( 2, side2D );
+    }
+
+  // a smooth blob with noise, about as compressible as medical images
+  std::vector<double> sigma, mean;
+  for ( unsigned int s : size )
+    {
+    sigma.push_back( 0.3 * s );
+    mean.push_back( 0.5 * s );
+    }
+  sitk::Image image = sitk::GaussianSource( sitk::sitkFloat32, size, sigma, mean, 2000.0 );
+  image = sitk::AdditiveGaussianNoise( image, 20.0, 100.0, 1u );
+  return sitk::Cast( image, format.pixelType );
+}
+
+
+template <typename TFunction>
+double Time( TFunction &&f )
+{
+  const Clock::time_point start = Clock::now();
+  f();
+  return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+
+Result RunConfiguration( const Configuration &configuration, const sitk::Image &image, const Options &options )
+{
+  const Format &format = *configuration.format;
+
+  Result result;
+  result.configuration = configuration.Name();
+  result.size = image.GetSize();
+  result.imageBytes = image.GetNumberOfPixels() * image.GetSizeOfPixelComponent() * image.GetNumberOfComponentsPerPixel();
+
+  const std::string baseName = options.temporaryDirectory + "/SimpleITKIOBenchmark_" + result.configuration;
+  std::vector<std::string> fileNames;
+  if ( format.series )
+    {
+    for ( unsigned int z = 0; z < image.GetSize()[2]; ++z )
+      {
+      std::ostringstream oss;
+      oss << baseName << "_" << std::setw( 4 ) << std::setfill( '0' ) << z << format.extension;
+      fileNames.push_back( oss.str() );
+      }
+    }
+  else
+    {
+    fileNames.push_back( baseName + format.extension );
+    }
+
+  try
+    {
+    std::function<void()> write;
+    std::function<void()> read;
+    std::function<void()> header;
+    if ( format.series )
+      {
+      write = [&]
+        {
+          sitk::ImageSeriesWriter writer;
+          writer.SetFileNames( fileNames );
+          writer.SetUseCompression( configuration.useCompression );
+          writer.SetCompressor( configuration.compressor );
+          writer.SetCompressionLevel( configuration.level );
+          writer.Execute( image );
+        };
+      read = [&]
+        {
+          sitk::ImageSeriesReader reader;
+          reader.SetFileNames( fileNames );
+          reader.Execute();
+        };
+      }
+    else
+      {
+      write = [&]
+        {
+          sitk::ImageFileWriter writer;
+          writer.SetFileName( fileNames[0] );
+          writer.SetUseCompression( configuration.useCompression );
+          writer.SetCompressor( configuration.compressor );
+          writer.SetCompressionLevel( configuration.level );
+          writer.Execute( image );
+        };
+      read = [&]
+        {
+          sitk::ImageFileReader reader;
+          reader.SetFileName( fileNames[0] );
+          reader.Execute();
+        };
+      }
+    header = [&]
+      {
+        sitk::ImageFileReader reader;
+        reader.SetFileName( fileNames[0] );
+        reader.ReadImageInformation();
+      };
+
+    for ( unsigned int i = 0; i < options.repetitions; ++i )
+      {
+      result.write.seconds.push_back( Time( write ) );
+      }
+    for ( const std::string &fileName : fileNames )
+      {
+      result.fileBytes += FileSize( fileName );
+      }
+
+    // the first read is not timed, it loads the files into the cache
+    read();
+    for ( unsigned int i = 0; i < options.repetitions; ++i )
+      {
+      result.header.seconds.push_back( Time( header ) );
+      result.warmRead.seconds.push_back( Time( read ) );
+      }
+
+    if ( options.cold )
+      {
+      for ( unsigned int i = 0; i < options.repetitions; ++i )
+        {
+        bool dropped = true;
+        for ( const std::string &fileName : fileNames )
+          {
+          dropped = DropFromCache( fileName ) && dropped;
+          }
+        if ( !dropped )
+          {
+          result.coldRead.seconds.clear();
+          break;
+          }
+        result.coldRead.seconds.push_back( Time( read ) );
+        }
+      }
+    }
+  catch ( std::exception &e )
+    {
+    result.error = e.what();
+    }
+
+  for ( const std::string &fileName : fileNames )
+    {
+    std::remove( fileName.c_str() );
+    }
+  return result;
+}
+
+
+std::string Escape( const std::string &s )
+{
+  std::string escaped;
+  for ( char c : s )
+    {
+    if ( c == '"' || c == '\\' )
+      {
+      escaped += '\\';
+      }
+    escaped += ( static_cast<unsigned char>( c ) < 0x20 ) ? ' ' : c;
+    }
+  return escaped;
+}
+
+
+void WriteTimings( std::ostream &os, const char *name, const Timings &timings, uint64_t bytes )
+{
+  if ( timings.seconds.empty() )
+    {
+    return;
+    }
+  const double MB = 1024.0 * 1024.0;
+  os << ", \"" << name << "\": {\"min_seconds\": " << timings.Minimum()
+     << ", \"median_seconds\": " << timings.Median();
+  if ( bytes && timings.Minimum() > 0.0 )
+    {
+    os << ", \"MB_per_second\": " << bytes / MB / timings.Minimum();
+    }
+  os << "}";
+}
+
+
+void WriteResults( std::ostream &os, const Options &options, const std::vector<Result> &results )
+{
+  os.precision( 9 );
+  os << "{\n"
+     << "  \"context\": {\n"
+     << "    \"simpleitk_version\": \"" << Escape( sitk::Version::VersionString() ) << "\",\n"
+     << "    \"itk_version\": \"" << Escape( sitk::Version::ITKVersionString() ) << "\",\n"
+     << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+     << "    \"repetitions\": " << options.repetitions << ",\n"
+     << "    \"directory\": \"" << Escape( options.temporaryDirectory ) << "\"\n"
+     << "  },\n"
+     << "  \"benchmarks\": [";
+  for ( size_t r = 0; r < results.size(); ++r )
+    {
+    const Result &result = results[r];
+    os << ( r ? "," : "" ) << "\n    {\"configuration\": \"" << Escape( result.configuration ) << "\", \"size\": [";
+    for ( size_t d = 0; d < result.size.size(); ++d )
+      {
+      os << ( d ? ", " : "" ) << result.size[d];
+      }
+    os << "], \"image_bytes\": " << result.imageBytes;
+    if ( !result.error.empty() )
+      {
+      os << ", \"error\": \"" << Escape( result.error ) << "\"}";
+      continue;
+      }
+    os << ", \"file_bytes\": " << result.fileBytes
+       << ", \"compression_ratio\": " << ( result.fileBytes ? static_cast<double>( result.imageBytes ) / result.fileBytes : 0.0 );
+    WriteTimings( os, "write", result.write, result.imageBytes );
+    WriteTimings( os, "header", result.header, 0 );
+    WriteTimings( os, "warm_read", result.warmRead, result.imageBytes );
+    WriteTimings( os, "cold_read", result.coldRead, result.imageBytes );
+    os << "}";
+    }
+  os << "\n  ]\n}" << std::endl;
+}
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  Options options;
+
+  try
+    {
+    for ( int i = 1; i < argc; ++i )
+      {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if ( arg == "--help" )
+        {
+        PrintUsage( argv[0] );
+        return 0;
+        }
+      else if ( arg == "--no-cold" )
+        {
+        options.cold = false;
+        }
+      else if ( arg == "--sizes" && hasValue )
+        {
+        options.sizes = ParseList( argv[++i] );
+        }
+      else if ( arg == "--repetitions" && hasValue )
+        {
+        options.repetitions = std::max( 1u, static_cast<unsigned int>( std::stoul( argv[++i] ) ) );
+        }
+      else if ( arg == "--filter" && hasValue )
+        {
+        options.filter = std::regex( argv[++i] );
+        }
+      else if ( arg == "--temp" && hasValue )
+        {
+        options.temporaryDirectory = argv[++i];
+        }
+      else if ( arg == "--output" && hasValue )
+        {
+        options.outputFileName = argv[++i];
+        }
+      else
+        {
+        std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+        PrintUsage( argv[0] );
+        return 1;
+        }
+      }
+    }
+  catch ( std::exception &e )
+    {
+    std::cerr << "Invalid argument: " << e.what() << std::endl;
+    return 1;
+    }
+
+  const std::vector<Format> formats = CreateFormats();
+  const std::vector<Configuration> configurations = CreateConfigurations( formats );
+
+  std::vector<Result> results;
+  bool failed = false;
+
+  std::cout << std::left << std::setw( 28 ) << "Configuration" << std::setw( 18 ) << "Size" << std::right
+            << std::setw( 10 ) << "Ratio" << std::setw( 12 ) << "Write MB/s" << std::setw( 12 ) << "Warm MB/s"
+            << std::setw( 12 ) << "Cold MB/s" << std::setw( 12 ) << "Header ms" << std::endl;
+
+  for ( unsigned int side : options.sizes )
+    {
+    const Format *imageFormat = nullptr;
+    sitk::Image image;
+    for ( const Configuration &configuration : configurations )
+      {
+      if ( !std::regex_search( configuration.Name(), options.filter ) )
+        {
+        continue;
+        }
+
+      try
+        {
+        // the image is shared by the configurations of a format
+        if ( configuration.format != imageFormat )
+          {
+          image = CreateImage( *configuration.format, side );
+          imageFormat = configuration.format;
+          }
+        }
+      catch ( std::exception &e )
+        {
+        std::cerr << "Failed to create the image of " << configuration.Name() << ": " << e.what() << std::endl;
+        return 1;
+        }
+
+      results.push_back( RunConfiguration( configuration, image, options ) );
+      const Result &result = results.back();
+
+      std::ostringstream size;
+      for ( size_t d = 0; d < result.size.size(); ++d )
+        {
+        size << ( d ? "x" : "" ) << result.size[d];
+        }
+      if ( !result.error.empty() )
+        {
+        std::cerr << configuration.Name() << " " << size.str() << " failed: " << result.error << std::endl;
+        failed = true;
+        continue;
+        }
+
+      const double MB = 1024.0 * 1024.0;
+      auto rate = [&]( const Timings &timings )
+        {
+          return timings.Minimum() > 0.0 ? result.imageBytes / MB / timings.Minimum() : 0.0;
+        };
+      std::cout << std::left << std::setw( 28 ) << configuration.Name() << std::setw( 18 ) << size.str() << std::right
+                << std::fixed << std::setprecision( 2 )
+                << std::setw( 10 ) << ( result.fileBytes ? static_cast<double>( result.imageBytes ) / result.fileBytes : 0.0 )
+                << std::setw( 12 ) << rate( result.write ) << std::setw( 12 ) << rate( result.warmRead )
+                << std::setw( 12 ) << rate( result.coldRead ) << std::setw( 12 ) << 1000.0 * result.header.Minimum()
+                << std::endl;
+      }
+    }
+
+  if ( !options.outputFileName.empty() )
+    {
+    std::ofstream ofs( options.outputFileName );
+    if ( !ofs )
+      {
+      std::cerr << "Failed to open " << options.outputFileName << " for writing." << std::endl;
+      return 1;
+      }
+    WriteResults( ofs, options, results );
+    }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,559 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include <sitkAdditionalProcedures.h>
+#include <sitkAdditiveGaussianNoiseImageFilter.h>
+#include <sitkAffineTransform.h>
+#include <sitkCastImageFilter.h>
+#include <sitkEuler2DTransform.h>
+#include <sitkEuler3DTransform.h>
+#include <sitkGaussianImageSource.h>
+#include <sitkImageFileReader.h>
+#include <sitkImageRegistrationMethod.h>
+#include <sitkProcessObject.h>
+#include <sitkTranslationTransform.h>
+#include <sitkVersion.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef SITK_BENCHMARK_DATA_DIRECTORY
+#define SITK_BENCHMARK_DATA_DIRECTORY "."
+#endif
+
+namespace sitk = itk::simple;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/** A fixed image, the moving image is created from it with a known transform. */
+struct Dataset
+{
+  std::string name;
+  sitk::Image fixed;
+};
+
+/** A combination of metric, optimizer and transform. */
+struct Method
+{
+  std::string name;
+  bool rigid;
+  std::function<sitk::Transform( const sitk::Image &fixed )> createTransform;
+  std::function<void( sitk::ImageRegistrationMethod & )> configure;
+};
+
+struct Result
+{
+  std::string dataset;
+  std::string method;
+  double seconds = 0.0;
+  unsigned int iterations = 0;
+  uint64_t metricPoints = 0;
+  double initialError = 0.0;
+  double finalError = 0.0;
+  double targetError = 0.0;
+  double secondsToTarget = -1.0;
+  unsigned int iterationsToTarget = 0;
+  std::string stopCondition;
+  std::string error;
+};
+
+struct Options
+{
+  std::string dataDirectory = SITK_BENCHMARK_DATA_DIRECTORY;
+  std::string outputFileName;
+  std::regex filter{ ".*" };
+  unsigned int syntheticSize = 192;
+  unsigned int numberOfIterations = 100;
+  double samplingPercentage = 0.1;
+  double targetError = 0.5;
+  unsigned int numberOfThreads = 0;
+};
+
+
+void PrintUsage( const char *program )
+{
+  std::cout << "Usage: " << program << " [options]\n"
+            << "Registers images with a known transform using combinations of metric, optimizer and transform,\n"
+            << "and reports the time and iterations until the error to the known transform is below a target.\n\n"
+            << "\t--data DIRECTORY      Directory of the Input files of the tests\n"
+            << "\t--filter REGEX        Only the benchmarks with a dataset.method name matching the regular expression\n"
+            << "\t--synthetic-size N    Length of the sides of the synthetic volume, 192 by default, 0 to skip it\n"
+            << "\t--iterations N        Maximum number of iterations of the optimizers\n"
+            << "\t--sampling P          Metric sampling percentage, 1 for all the pixels\n"
+            << "\t--target-error E      Target error in pixels of the smallest spacing, 0.5 by default\n"
+            << "\t--threads N           Global default number of threads\n"
+            << "\t--output FILE         JSON file of the results" << std::endl;
+}
+
+
+std::vector<double> ImageCenter( const sitk::Image &image )
+{
+  std::vector<double> index( image.GetDimension() );
+  for ( unsigned int d = 0; d < index.size(); ++d )
+    {
+    index[d] = 0.5 * ( image.GetSize()[d] - 1 );
+    }
+  return image.TransformContinuousIndexToPhysicalPoint( index );
+}
+
+
+// The corners of the central half of the image, where the error of a
+// transform is measured.
+std::vector<std::vector<double>> ErrorPoints( const sitk::Image &image )
+{
+  const unsigned int dimension = image.GetDimension();
+  std::vector<std::vector<double>> points;
+  for ( unsigned int corner = 0; corner < ( 1u << dimension ); ++corner )
+    {
+    std::vector<double> index( dimension );
+    for ( unsigned int d = 0; d < dimension; ++d )
+      {
+      const double size = image.GetSize()[d] - 1;
+      index[d] = ( corner & ( 1u << d ) ) ? 0.75 * size : 0.25 * size;
+      }
+    points.push_back( image.TransformContinuousIndexToPhysicalPoint( index ) );
+    }
+  return points;
+}
+
+
+double TransformError( const sitk::Transform &transform,
+                       const sitk::Transform &truth,
+                       const std::vector<std::vector<double>> &points )
+{
+  double sum = 0.0;
+  for ( const std::vector<double> &point : points )
+    {
+    const std::vector<double> p = transform.TransformPoint( point );
+    const std::vector<double> q = truth.TransformPoint( point );
+    double squared = 0.0;
+    for ( size_t d = 0; d < p.size(); ++d )
+      {
+      squared += ( p[d] - q[d] ) * ( p[d] - q[d] );
+      }
+    sum += std::sqrt( squared );
+    }
+  return sum / points.size();
+}
+
+
+// The transform the registration should find, a rotation and a
+// translation of a few pixels about the center.
+sitk::Transform KnownTransform( const sitk::Image &fixed, bool rigid )
+{
+  const unsigned int dimension = fixed.GetDimension();
+  const std::vector<double> spacings = fixed.GetSpacing();
+  const double spacing = *std::min_element( spacings.begin(), spacings.end() );
+
+  sitk::AffineTransform truth( dimension );
+  truth.SetCenter( ImageCenter( fixed ) );
+  if ( rigid )
+    {
+    truth.Rotate( 0, 1, 0.08 );
+    if ( dimension > 2 )
+      {
+      truth.Rotate( 1, 2, -0.05 );
+      }
+    }
+  std::vector<double> translation( dimension, 0.0 );
+  translation[0] = 4.0 * spacing;
+  translation[1] = -3.0 * spacing;
+  if ( dimension > 2 )
+    {
+    translation[2] = 2.0 * spacing;
+    }
+  truth.SetTranslation( translation );
+  return truth;
+}
+
+
+sitk::Transform CreateRigid( const sitk::Image &fixed )
+{
+  if ( fixed.GetDimension() == 2 )
+    {
+    return sitk::Euler2DTransform( ImageCenter( fixed ) );
+    }
+  return sitk::Euler3DTransform( ImageCenter( fixed ) );
+}
+
+
+sitk::Transform CreateAffine( const sitk::Image &fixed )
+{
+  sitk::AffineTransform affine( fixed.GetDimension() );
+  affine.SetCenter( ImageCenter( fixed ) );
+  return affine;
+}
+
+
+std::vector<Method> CreateMethods( const Options &options )
+{
+  const double samplingPercentage = options.samplingPercentage;
+  const unsigned int iterations = options.numberOfIterations;
+
+  auto sampling = [samplingPercentage]( sitk::ImageRegistrationMethod &registration )
+    {
+      if ( samplingPercentage < 1.0 )
+        {
+        registration.SetMetricSamplingStrategy( sitk::ImageRegistrationMethod::REGULAR );
+        registration.SetMetricSamplingPercentage( samplingPercentage, 1u );
+        }
+    };
+  auto translation = []( const sitk::Image &fixed ) { return sitk::TranslationTransform( fixed.GetDimension() ); };
+
+  return {
+    { "MeanSquares_RegularStep_Translation", false, translation,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsMeanSquares();
+          sampling( registration );
+          registration.SetOptimizerAsRegularStepGradientDescent( 4.0, 1e-4, iterations );
+        } },
+    { "MeanSquares_GradientDescent_Euler", true, CreateRigid,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsMeanSquares();
+          sampling( registration );
+          registration.SetOptimizerAsGradientDescent( 1.0, iterations, 1e-8, 10 );
+        } },
+    { "Correlation_ConjugateGradient_Euler", true, CreateRigid,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsCorrelation();
+          sampling( registration );
+          registration.SetOptimizerAsConjugateGradientLineSearch( 1.0, iterations, 1e-8, 10 );
+        } },
+    { "MattesMutualInformation_RegularStep_Euler", true, CreateRigid,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsMattesMutualInformation( 50 );
+          sampling( registration );
+          registration.SetOptimizerAsRegularStepGradientDescent( 2.0, 1e-4, iterations );
+        } },
+    { "MattesMutualInformation_GradientDescent_Affine", true, CreateAffine,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsMattesMutualInformation( 50 );
+          sampling( registration );
+          registration.SetOptimizerAsGradientDescent( 1.0, iterations, 1e-8, 10 );
+        } },
+    { "JointHistogramMutualInformation_GradientDescent_Euler", true, CreateRigid,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsJointHistogramMutualInformation();
+          sampling( registration );
+          registration.SetOptimizerAsGradientDescent( 1.0, iterations, 1e-8, 10 );
+        } },
+    { "MattesMutualInformation_LBFGSB_Affine", true, CreateAffine,
+      [=]( sitk::ImageRegistrationMethod &registration )
+        {
+          registration.SetMetricAsMattesMutualInformation( 50 );
+          sampling( registration );
+          registration.SetOptimizerAsLBFGSB( 1e-5, iterations );
+        } } };
+}
+
+
+std::vector<Dataset> LoadDatasets( const Options &options )
+{
+  std::vector<Dataset> datasets;
+
+  const char *fileNames[] = { "Input/cthead1-Float.mha",
+                              "Input/BrainProtonDensitySliceBorder20.png",
+                              "Input/RA-Float.nrrd",
+                              "Input/OAS1_0001_MR1_mpr-1_anon.nrrd" };
+  for ( const char *fileName : fileNames )
+    {
+    try
+      {
+      sitk::Image image = sitk::ReadImage( options.dataDirectory + "/" + fileName );
+      datasets.push_back( Dataset{ fileName, sitk::Cast( image, sitk::sitkFloat32 ) } );
+      }
+    catch ( std::exception &e )
+      {
+      std::cerr << "Skipping " << fileName << ": " << e.what() << std::endl;
+      }
+    }
+
+  if ( options.syntheticSize )
+    {
+    const unsigned int size = options.syntheticSize;
+    sitk::Image blob = sitk::GaussianSource( sitk::sitkFloat32,
+                                             std::vector<unsigned int>{ size, size, size },
+                                             std::vector<double>{ 0.15 * size, 0.25 * size, 0.2 * size },
+                                             std::vector<double>( 3, 0.5 * size ) );
+    blob = sitk::AdditiveGaussianNoise( blob, 5.0, 0.0, 1u );
+    datasets.push_back( Dataset{ "Synthetic" + std::to_string( size ), blob } );
+    }
+
+  return datasets;
+}
+
+
+Result RunRegistration( const Dataset &dataset, const Method &method, const Options &options )
+{
+  Result result;
+  result.dataset = dataset.name;
+  result.method = method.name;
+
+  const sitk::Image &fixed = dataset.fixed;
+  const std::vector<double> spacings = fixed.GetSpacing();
+  const double spacing = *std::min_element( spacings.begin(), spacings.end() );
+  result.targetError = options.targetError * spacing;
+
+  // the moving image is the fixed image in the known transform, so
+  // the registration finds it from the fixed to the moving domain
+  const sitk::Transform truth = KnownTransform( fixed, method.rigid );
+  const sitk::Image moving = sitk::Resample( fixed, truth.GetInverse(), sitk::sitkLinear );
+  const std::vector<std::vector<double>> points = ErrorPoints( fixed );
+
+  const sitk::Transform initial = method.createTransform( fixed );
+  result.initialError = TransformError( initial, truth, points );
+
+  sitk::ImageRegistrationMethod registration;
+  method.configure( registration );
+  registration.SetInterpolator( sitk::sitkLinear );
+  registration.SetOptimizerScalesFromPhysicalShift();
+  registration.SetInitialTransform( initial );
+
+  Clock::time_point start;
+  registration.AddCommand( sitk::sitkStartEvent, [&start] { start = Clock::now(); } );
+  registration.AddCommand( sitk::sitkIterationEvent, [&]
+    {
+      ++result.iterations;
+      result.metricPoints += registration.GetMetricNumberOfValidPoints();
+      if ( result.secondsToTarget < 0.0 )
+        {
+        // measure the error on a copy, the position is of the initial transform's parameters
+        sitk::Transform current( initial );
+        current.SetParameters( registration.GetOptimizerPosition() );
+        if ( TransformError( current, truth, points ) <= result.targetError )
+          {
+          result.secondsToTarget = std::chrono::duration<double>( Clock::now() - start ).count();
+          result.iterationsToTarget = result.iterations;
+          }
+        }
+    } );
+
+  try
+    {
+    const Clock::time_point executeStart = Clock::now();
+    const sitk::Transform outTransform = registration.Execute( fixed, moving );
+    result.seconds = std::chrono::duration<double>( Clock::now() - executeStart ).count();
+    result.finalError = TransformError( outTransform, truth, points );
+    result.stopCondition = registration.GetOptimizerStopConditionDescription();
+    }
+  catch ( std::exception &e )
+    {
+    result.error = e.what();
+    }
+  return result;
+}
+
+
+std::string Escape( const std::string &s )
+{
+  std::string escaped;
+  for ( char c : s )
+    {
+    if ( c == '"' || c == '\\' )
+      {
+      escaped += '\\';
+      }
+    escaped += ( static_cast<unsigned char>( c ) < 0x20 ) ? ' ' : c;
+    }
+  return escaped;
+}
+
+
+void WriteResults( std::ostream &os, const Options &options, const std::vector<Result> &results )
+{
+  os.precision( 9 );
+  os << "{\n"
+     << "  \"context\": {\n"
+     << "    \"simpleitk_version\": \"" << Escape( sitk::Version::VersionString() ) << "\",\n"
+     << "    \"itk_version\": \"" << Escape( sitk::Version::ITKVersionString() ) << "\",\n"
+     << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+     << "    \"threads\": " << sitk::ProcessObject::GetGlobalDefaultNumberOfThreads() << ",\n"
+     << "    \"sampling_percentage\": " << options.samplingPercentage << ",\n"
+     << "    \"maximum_iterations\": " << options.numberOfIterations << "\n"
+     << "  },\n"
+     << "  \"benchmarks\": [";
+  for ( size_t r = 0; r < results.size(); ++r )
+    {
+    const Result &result = results[r];
+    os << ( r ? "," : "" ) << "\n    {\"dataset\": \"" << Escape( result.dataset ) << "\", \"method\": \"" << result.method << "\"";
+    if ( !result.error.empty() )
+      {
+      os << ", \"error\": \"" << Escape( result.error ) << "\"}";
+      continue;
+      }
+    os << ", \"seconds\": " << result.seconds
+       << ", \"iterations\": " << result.iterations
+       << ", \"iterations_per_second\": " << ( result.seconds > 0.0 ? result.iterations / result.seconds : 0.0 )
+       << ", \"metric_points_per_second\": " << ( result.seconds > 0.0 ? result.metricPoints / result.seconds : 0.0 )
+       << ", \"initial_error\": " << result.initialError
+       << ", \"final_error\": " << result.finalError
+       << ", \"target_error\": " << result.targetError
+       << ", \"reached_target\": " << ( result.secondsToTarget >= 0.0 ? "true" : "false" );
+    if ( result.secondsToTarget >= 0.0 )
+      {
+      os << ", \"seconds_to_target\": " << result.secondsToTarget
+         << ", \"iterations_to_target\": " << result.iterationsToTarget;
+      }
+    os << ", \"stop_condition\": \"" << Escape( result.stopCondition ) << "\"}";
+    }
+  os << "\n  ]\n}" << std::endl;
+}
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  Options options;
+
+  try
+    {
+    for ( int i = 1; i < argc; ++i )
+      {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if ( arg == "--help" )
+        {
+        PrintUsage( argv[0] );
+        return 0;
+        }
+      else if ( arg == "--data" && hasValue )
+        {
+        options.dataDirectory = argv[++i];
+        }
+      else if ( arg == "--filter" && hasValue )
+        {
+        options.filter = std::regex( argv[++i] );
+        }
+      else if ( arg == "--synthetic-size" && hasValue )
+        {
+        options.syntheticSize = static_cast<unsigned int>( std::stoul( argv[++i] ) );
+        }
+      else if ( arg == "--iterations" && hasValue )
+        {
+        options.numberOfIterations = static_cast<unsigned int>( std::stoul( argv[++i] ) );
+        }
+      else if ( arg == "--sampling" && hasValue )
+        {
+        options.samplingPercentage = std::stod( argv[++i] );
+        }
+      else if ( arg == "--target-error" && hasValue )
+        {
+        options.targetError = std::stod( argv[++i] );
+        }
+      else if ( arg == "--threads" && hasValue )
+        {
+        options.numberOfThreads = static_cast<unsigned int>( std::stoul( argv[++i] ) );
+        }
+      else if ( arg == "--output" && hasValue )
+        {
+        options.outputFileName = argv[++i];
+        }
+      else
+        {
+        std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+        PrintUsage( argv[0] );
+        return 1;
+        }
+      }
+    }
+  catch ( std::exception &e )
+    {
+    std::cerr << "Invalid argument: " << e.what() << std::endl;
+    return 1;
+    }
+
+  if ( options.numberOfThreads )
+    {
+    sitk::ProcessObject::SetGlobalDefaultNumberOfThreads( options.numberOfThreads );
+    }
+
+  std::vector<Result> results;
+  bool failed = false;
+
+  std::cout << std::left << std::setw( 44 ) << "Dataset" << std::setw( 54 ) << "Method" << std::right
+            << std::setw( 10 ) << "Seconds" << std::setw( 8 ) << "Iter" << std::setw( 12 ) << "To target"
+            << std::setw( 12 ) << "Error" << std::endl;
+
+  const std::vector<Method> methods = CreateMethods( options );
+  for ( const Dataset &dataset : LoadDatasets( options ) )
+    {
+    for ( const Method &method : methods )
+      {
+      if ( !std::regex_search( dataset.name + "." + method.name, options.filter ) )
+        {
+        continue;
+        }
+
+      results.push_back( RunRegistration( dataset, method, options ) );
+      const Result &result = results.back();
+      if ( !result.error.empty() )
+        {
+        std::cerr << dataset.name << "." << method.name << " failed: " << result.error << std::endl;
+        failed = true;
+        continue;
+        }
+
+      std::ostringstream toTarget;
+      if ( result.secondsToTarget >= 0.0 )
+        {
+        toTarget << std::fixed << std::setprecision( 3 ) << result.secondsToTarget;
+        }
+      else
+        {
+        toTarget << "-";
+        }
+      std::cout << std::left << std::setw( 44 ) << dataset.name << std::setw( 54 ) << method.name << std::right
+                << std::fixed << std::setprecision( 3 )
+                << std::setw( 10 ) << result.seconds << std::setw( 8 ) << result.iterations
+                << std::setw( 12 ) << toTarget.str() << std::setw( 12 ) << result.finalError << std::endl;
+      }
+    }
+
+  if ( !options.outputFileName.empty() )
+    {
+    std::ofstream ofs( options.outputFileName );
+    if ( !ofs )
+      {
+      std::cerr << "Failed to open " << options.outputFileName << " for writing." << std::endl;
+      return 1;
+      }
+    WriteResults( ofs, options, results );
+    }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,497 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#include <sitkAdditionalProcedures.h>
+#include <sitkAdditiveGaussianNoiseImageFilter.h>
+#include <sitkBinaryThresholdImageFilter.h>
+#include <sitkConnectedComponentImageFilter.h>
+#include <sitkEuler3DTransform.h>
+#include <sitkGaussianImageSource.h>
+#include <sitkImageFileReader.h>
+#include <sitkImageFileWriter.h>
+#include <sitkImageOperators.h>
+#include <sitkImageRegistrationMethod.h>
+#include <sitkN4BiasFieldCorrectionImageFilter.h>
+#include <sitkProcessObject.h>
+#include <sitkSmoothingRecursiveGaussianImageFilter.h>
+#include <sitkVersion.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <psapi.h>
+#elif !defined( __linux__ )
+#include <sys/resource.h>
+#endif
+
+#ifndef SITK_BENCHMARK_TEMP_DIRECTORY
+#define SITK_BENCHMARK_TEMP_DIRECTORY "."
+#endif
+
+namespace sitk = itk::simple;
+
+namespace
+{
+
+//
+// The peak resident set size of the process. On Linux the peak is
+// reset before each measurement, elsewhere it is the peak since the
+// process started so the increase of an operation is unknown.
+//
+bool ResetPeakMemory()
+{
+#if defined( __linux__ )
+  std::ofstream clearRefs( "/proc/self/clear_refs" );
+  clearRefs << "5";
+  return static_cast<bool>( clearRefs.flush() );
+#else
+  return false;
+#endif
+}
+
+#if defined( __linux__ )
+uint64_t ReadStatusBytes( const char *field )
+{
+  std::ifstream status( "/proc/self/status" );
+  std::string line;
+  while ( std::getline( status, line ) )
+    {
+    if ( line.compare( 0, std::char_traits<char>::length( field ), field ) == 0 )
+      {
+      std::istringstream iss( line.substr( std::char_traits<char>::length( field ) ) );
+      uint64_t kB = 0;
+      iss >> kB;
+      return kB * 1024;
+      }
+    }
+  return 0;
+}
+#endif
+
+uint64_t GetPeakMemory()
+{
+#if defined( __linux__ )
+  return ReadStatusBytes( "VmHWM:" );
+#elif defined( _WIN32 )
+  PROCESS_MEMORY_COUNTERS counters;
+  if ( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) )
+    {
+    return counters.PeakWorkingSetSize;
+    }
+  return 0;
+#else
+  struct rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+#if defined( __APPLE__ )
+  return static_cast<uint64_t>( usage.ru_maxrss );
+#else
+  return static_cast<uint64_t>( usage.ru_maxrss ) * 1024;
+#endif
+#endif
+}
+
+uint64_t GetCurrentMemory()
+{
+#if defined( __linux__ )
+  return ReadStatusBytes( "VmRSS:" );
+#else
+  return GetPeakMemory();
+#endif
+}
+
+
+struct Operation
+{
+  std::string name;
+  std::function<void()> execute;
+  /** The least speedup over one thread, divided by the number of threads. */
+  double minimumEfficiency;
+  /** The most peak memory increase, as a multiple of the input volume's size. */
+  double maximumMemoryRatio;
+};
+
+
+struct Measurement
+{
+  unsigned int numberOfThreads = 0;
+  double seconds = 0.0;
+  double speedup = 0.0;
+  double efficiency = 0.0;
+  uint64_t peakMemory = 0;
+  uint64_t peakMemoryIncrease = 0;
+};
+
+
+struct Options
+{
+  unsigned int size = 128;
+  std::vector<unsigned int> numberOfThreads;
+  unsigned int repetitions = 3;
+  unsigned int checkedThreads = 4;
+  double efficiencyFactor = 1.0;
+  double memoryFactor = 1.0;
+  bool checkThresholds = true;
+  std::string outputFileName;
+  std::string temporaryDirectory = SITK_BENCHMARK_TEMP_DIRECTORY;
+};
+
+
+void PrintUsage( const char *program )
+{
+  std::cout << "Usage: " << program << " [options]\n"
+            << "Times common operations with increasing global default numbers of threads, and fails when\n"
+            << "their scaling efficiency or their peak memory is past a threshold.\n\n"
+            << "\t--size N              Length of the sides of the synthetic volume, 128 by default\n"
+            << "\t--threads N[,N...]    Numbers of threads, powers of two up to the number of cores by default\n"
+            << "\t--repetitions N       Number of executions, of which the fastest is kept\n"
+            << "\t--check-threads N     Check the scaling efficiency up to this number of threads, 4 by default\n"
+            << "\t--efficiency-factor F Multiply the minimum efficiencies by F\n"
+            << "\t--memory-factor F     Multiply the maximum memory ratios by F\n"
+            << "\t--no-thresholds       Only report the measurements\n"
+            << "\t--temp DIRECTORY      Directory of the file read by ReadImage\n"
+            << "\t--output FILE         JSON file of the measurements" << std::endl;
+}
+
+
+std::vector<unsigned int> ParseList( const std::string &value )
+{
+  std::vector<unsigned int> values;
+  std::istringstream iss( value );
+  std::string item;
+  while ( std::getline( iss, item, ',' ) )
+    {
+    values.push_back( static_cast<unsigned int>( std::stoul( item ) ) );
+    }
+  return values;
+}
+
+
+void WriteResults( std::ostream &os,
+                   const Options &options,
+                   const std::vector<Operation> &operations,
+                   const std::vector<std::vector<Measurement>> &measurements,
+                   const std::vector<std::string> &failures )
+{
+  os.precision( 9 );
+  os << "{\n"
+     << "  \"context\": {\n"
+     << "    \"simpleitk_version\": \"" << sitk::Version::VersionString() << "\",\n"
+     << "    \"itk_version\": \"" << sitk::Version::ITKVersionString() << "\",\n"
+     << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+     << "    \"size\": " << options.size << "\n"
+     << "  },\n"
+     << "  \"operations\": [";
+  for ( size_t o = 0; o < operations.size(); ++o )
+    {
+    os << ( o ? "," : "" ) << "\n    {\"name\": \"" << operations[o].name << "\", \"measurements\": [";
+    for ( size_t m = 0; m < measurements[o].size(); ++m )
+      {
+      const Measurement &measurement = measurements[o][m];
+      os << ( m ? ", " : "" )
+         << "{\"threads\": " << measurement.numberOfThreads
+         << ", \"seconds\": " << measurement.seconds
+         << ", \"speedup\": " << measurement.speedup
+         << ", \"efficiency\": " << measurement.efficiency
+         << ", \"peak_rss_bytes\": " << measurement.peakMemory
+         << ", \"peak_rss_increase_bytes\": " << measurement.peakMemoryIncrease << "}";
+      }
+    os << "]}";
+    }
+  os << "\n  ],\n  \"failures\": [";
+  for ( size_t f = 0; f < failures.size(); ++f )
+    {
+    os << ( f ? ", " : "" ) << "\"" << failures[f] << "\"";
+    }
+  os << "]\n}" << std::endl;
+}
+
+}
+
+
+int main( int argc, char *argv[] )
+{
+  Options options;
+
+  try
+    {
+    for ( int i = 1; i < argc; ++i )
+      {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      if ( arg == "--help" )
+        {
+        PrintUsage( argv[0] );
+        return 0;
+        }
+      else if ( arg == "--no-thresholds" )
+        {
+        options.checkThresholds = false;
+        }
+      else if ( arg == "--size" && hasValue )
+        {
+        options.size = static_cast<unsigned int>( std::stoul( argv[++i] ) );
+        }
+      else if ( arg == "--threads" && hasValue )
+        {
+        options.numberOfThreads = ParseList( argv[++i] );
+        }
+      else if ( arg == "--repetitions" && hasValue )
+        {
+        options.repetitions = std::max( 1u, static_cast<unsigned int>( std::stoul( argv[++i] ) ) );
+        }
+      else if ( arg == "--check-threads" && hasValue )
+        {
+        options.checkedThreads = static_cast<unsigned int>( std::stoul( argv[++i] ) );
+        }
+      else if ( arg == "--efficiency-factor" && hasValue )
+        {
+        options.efficiencyFactor = std::stod( argv[++i] );
+        }
+      else if ( arg == "--memory-factor" && hasValue )
+        {
+        options.memoryFactor = std::stod( argv[++i] );
+        }
+      else if ( arg == "--temp" && hasValue )
+        {
+        options.temporaryDirectory = argv[++i];
+        }
+      else if ( arg == "--output" && hasValue )
+        {
+        options.outputFileName = argv[++i];
+        }
+      else
+        {
+        std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+        PrintUsage( argv[0] );
+        return 1;
+        }
+      }
+    }
+  catch ( std::exception &e )
+    {
+    std::cerr << "Invalid argument: " << e.what() << std::endl;
+    return 1;
+    }
+
+  if ( options.numberOfThreads.empty() )
+    {
+    const unsigned int cores = std::max( 1u, std::thread::hardware_concurrency() );
+    for ( unsigned int n = 1; n < cores; n *= 2 )
+      {
+      options.numberOfThreads.push_back( n );
+      }
+    options.numberOfThreads.push_back( cores );
+    }
+  // the speedups are relative to one thread
+  if ( std::find( options.numberOfThreads.begin(), options.numberOfThreads.end(), 1u ) == options.numberOfThreads.end() )
+    {
+    options.numberOfThreads.insert( options.numberOfThreads.begin(), 1u );
+    }
+
+  std::vector<Operation> operations;
+  std::vector<std::vector<Measurement>> measurements;
+  std::vector<std::string> failures;
+  uint64_t inputBytes = 0;
+
+  //
+  // The synthetic inputs, a noisy blob and a shifted copy of it
+  //
+  const double halfSize = 0.5 * options.size;
+  const std::string fileName = options.temporaryDirectory + "/SimpleITKScalingDriver.nrrd";
+  const sitk::Euler3DTransform shift( std::vector<double>( 3, halfSize ), 0.0, 0.0, 0.05, std::vector<double>{ 2.0, 1.0, 0.0 } );
+  sitk::Image volume;
+  sitk::Image moving;
+  sitk::Image binary;
+
+  try
+    {
+    volume = sitk::GaussianSource( sitk::sitkFloat32,
+                                   std::vector<unsigned int>( 3, options.size ),
+                                   std::vector<double>( 3, 0.25 * options.size ),
+                                   std::vector<double>( 3, halfSize ) );
+    volume = sitk::AdditiveGaussianNoise( volume, 10.0, 0.0, 1u );
+    inputBytes = volume.GetNumberOfPixels() * volume.GetSizeOfPixelComponent();
+
+    moving = sitk::Resample( volume, shift, sitk::sitkLinear );
+    binary = sitk::BinaryThreshold( volume, 128.0, 1e6 );
+
+    sitk::WriteImage( volume, fileName );
+
+    operations.push_back( Operation{ "ReadImage",
+                                     [&] { sitk::ReadImage( fileName ); },
+                                     0.0, 3.0 } );
+    operations.push_back( Operation{ "Resample",
+                                     [&] { sitk::Resample( volume, shift, sitk::sitkLinear ); },
+                                     0.5, 3.0 } );
+    operations.push_back( Operation{ "SmoothingRecursiveGaussian",
+                                     [&] { sitk::SmoothingRecursiveGaussian( volume, std::vector<double>( 3, 2.0 ) ); },
+                                     0.4, 4.0 } );
+    operations.push_back( Operation{ "ConnectedComponent",
+                                     [&] { sitk::ConnectedComponent( binary ); },
+                                     0.2, 8.0 } );
+    operations.push_back( Operation{ "RegistrationMattesMutualInformation",
+                                     [&] {
+                                       sitk::ImageRegistrationMethod registration;
+                                       registration.SetMetricAsMattesMutualInformation( 32 );
+                                       registration.SetMetricSamplingStrategy( sitk::ImageRegistrationMethod::REGULAR );
+                                       registration.SetMetricSamplingPercentage( 0.2, 1u );
+                                       registration.SetInterpolator( sitk::sitkLinear );
+                                       // no convergence, so every run executes all the iterations
+                                       registration.SetOptimizerAsGradientDescent( 1.0, 20, 0.0, 20 );
+                                       registration.SetOptimizerScalesFromPhysicalShift();
+                                       registration.SetInitialTransform( sitk::Euler3DTransform( std::vector<double>( 3, halfSize ) ) );
+                                       registration.Execute( volume, moving );
+                                     },
+                                     0.3, 10.0 } );
+    operations.push_back( Operation{ "N4BiasFieldCorrection",
+                                     [&] {
+                                       sitk::N4BiasFieldCorrectionImageFilter n4;
+                                       n4.SetMaximumNumberOfIterations( std::vector<uint32_t>( 2, 10 ) );
+                                       n4.SetShrinkFactor( 2 );
+                                       n4.Execute( volume + 300.0 );
+                                     },
+                                     0.3, 12.0 } );
+    }
+  catch ( std::exception &e )
+    {
+    std::cerr << "Failed to create the inputs: " << e.what() << std::endl;
+    return 1;
+    }
+
+  const bool canResetPeak = ResetPeakMemory();
+  const unsigned int defaultNumberOfThreads = sitk::ProcessObject::GetGlobalDefaultNumberOfThreads();
+
+  std::cout << std::left << std::setw( 38 ) << "Operation" << std::right
+            << std::setw( 8 ) << "Threads" << std::setw( 12 ) << "Seconds" << std::setw( 10 ) << "Speedup"
+            << std::setw( 12 ) << "Efficiency" << std::setw( 14 ) << "Peak MiB" << std::endl;
+
+  for ( const Operation &operation : operations )
+    {
+    measurements.emplace_back();
+    double singleThreadSeconds = 0.0;
+
+    for ( unsigned int numberOfThreads : options.numberOfThreads )
+      {
+      sitk::ProcessObject::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+
+      Measurement measurement;
+      measurement.numberOfThreads = numberOfThreads;
+      try
+        {
+        // the first execution is not timed
+        operation.execute();
+
+        const uint64_t baseline = GetCurrentMemory();
+        ResetPeakMemory();
+        for ( unsigned int i = 0; i < options.repetitions; ++i )
+          {
+          const auto start = std::chrono::steady_clock::now();
+          operation.execute();
+          const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+          if ( i == 0 || elapsed.count() < measurement.seconds )
+            {
+            measurement.seconds = elapsed.count();
+            }
+          }
+        measurement.peakMemory = GetPeakMemory();
+        measurement.peakMemoryIncrease = measurement.peakMemory > baseline ? measurement.peakMemory - baseline : 0;
+        }
+      catch ( std::exception &e )
+        {
+        failures.push_back( operation.name + " failed with " + std::to_string( numberOfThreads ) + " threads." );
+        std::cerr << e.what() << std::endl;
+        continue;
+        }
+
+      if ( numberOfThreads == 1 )
+        {
+        singleThreadSeconds = measurement.seconds;
+        }
+      if ( singleThreadSeconds > 0.0 && measurement.seconds > 0.0 )
+        {
+        measurement.speedup = singleThreadSeconds / measurement.seconds;
+        measurement.efficiency = measurement.speedup / numberOfThreads;
+        }
+
+      std::cout << std::left << std::setw( 38 ) << operation.name << std::right << std::fixed
+                << std::setw( 8 ) << numberOfThreads
+                << std::setw( 12 ) << std::setprecision( 4 ) << measurement.seconds
+                << std::setw( 10 ) << std::setprecision( 2 ) << measurement.speedup
+                << std::setw( 12 ) << std::setprecision( 2 ) << measurement.efficiency
+                << std::setw( 14 ) << std::setprecision( 1 ) << measurement.peakMemory / ( 1024.0 * 1024.0 ) << std::endl;
+
+      if ( options.checkThresholds )
+        {
+        const double minimumEfficiency = operation.minimumEfficiency * options.efficiencyFactor;
+        if ( numberOfThreads > 1 && numberOfThreads <= options.checkedThreads
+             && measurement.efficiency < minimumEfficiency )
+          {
+          std::ostringstream msg;
+          msg << operation.name << " efficiency " << measurement.efficiency << " with " << numberOfThreads
+              << " threads is less than " << minimumEfficiency << ".";
+          failures.push_back( msg.str() );
+          }
+
+        const double maximumMemory = operation.maximumMemoryRatio * options.memoryFactor * inputBytes;
+        if ( canResetPeak && measurement.peakMemoryIncrease > maximumMemory )
+          {
+          std::ostringstream msg;
+          msg << operation.name << " peak memory increase of " << measurement.peakMemoryIncrease << " bytes with "
+              << numberOfThreads << " threads is more than " << static_cast<uint64_t>( maximumMemory ) << " bytes.";
+          failures.push_back( msg.str() );
+          }
+        }
+
+      measurements.back().push_back( measurement );
+      }
+    }
+
+  sitk::ProcessObject::SetGlobalDefaultNumberOfThreads( defaultNumberOfThreads );
+
+  if ( !canResetPeak )
+    {
+    std::cout << "The peak memory is of the process, it can not be measured for each operation." << std::endl;
+    }
+
+  if ( !options.outputFileName.empty() )
+    {
+    std::ofstream ofs( options.outputFileName );
+    if ( !ofs )
+      {
+      std::cerr << "Failed to open " << options.outputFileName << " for writing." << std::endl;
+      return 1;
+      }
+    WriteResults( ofs, options, operations, measurements, failures );
+    }
+
+  for ( const std::string &failure : failures )
+    {
+    std::cerr << failure << std::endl;
+    }
+  return failures.empty() ? 0 : 1;
+}
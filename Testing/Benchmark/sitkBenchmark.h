@@ -0,0 +1,70 @@
+/*=========================================================================
+*
+*  Copyright NumFOCUS
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*         http://www.apache.org/licenses/LICENSE-2.0.txt
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*
+*=========================================================================*/
+#ifndef sitkBenchmark_h
+#define sitkBenchmark_h
+
+#include <sitkImage.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+namespace simple
+{
+namespace benchmark
+{
+
+/** The function executing a configured filter on the inputs. */
+using ExecuteFunctionType = std::function<void( const std::vector<Image> & )>;
+
+/** \brief A benchmark of a filter, generated from a test of its JSON
+ * description.
+ *
+ * The inputs are read from the files of the test and prepared with
+ * the casts of the test, then the driver scales them to the sizes
+ * benchmarked. The create function returns the filter configured
+ * with the settings of the test and the number of threads.
+ */
+struct BenchmarkCase
+{
+  std::string filterName;
+  std::string tag;
+  std::vector<std::string> inputFileNames;
+  std::function<void( std::vector<Image> & )> prepare;
+  std::function<ExecuteFunctionType( unsigned int numberOfThreads )> create;
+};
+
+/** The benchmarks of all the filters linked into the driver. */
+std::vector<BenchmarkCase> &GetBenchmarkCases();
+
+/** Adds a benchmark when a generated file is initialized. */
+struct BenchmarkRegistrar
+{
+  explicit BenchmarkRegistrar( BenchmarkCase benchmarkCase )
+    {
+      GetBenchmarkCases().push_back( std::move( benchmarkCase ) );
+    }
+};
+
+}
+}
+}
+
+#endif
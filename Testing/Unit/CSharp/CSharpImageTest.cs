@@ -118,6 +118,34 @@ namespace itk.simple {
                   Console.WriteLine("GetBufferAsVoid returned 0.");
                 }
 
+                // bulk copies of the buffer
+                image = new Image(100, 100, PixelId.sitkInt16);
+                image.SetPixelAsInt16( idx, -3 );
+                short[] shorts = new short[100 * 100];
+                image.CopyBufferTo(shorts);
+                if (shorts[0] != -3)
+                {
+                  success = ExitFailure;
+                  Console.WriteLine("CopyBufferTo did not copy the pixel.");
+                }
+                shorts[1] = 7;
+                image.CopyBufferFrom(shorts);
+                idx[0] = 1;
+                if (image.GetPixelAsInt16(idx) != 7)
+                {
+                  success = ExitFailure;
+                  Console.WriteLine("CopyBufferFrom did not copy the pixel.");
+                }
+                try
+                {
+                  image.CopyBufferTo(new float[100 * 100]);
+                  success = ExitFailure;
+                  Console.WriteLine("CopyBufferTo accepted an array of the wrong type.");
+                }
+                catch (ArgumentException)
+                {
+                }
+
             } catch (Exception ex) {
                 success = ExitFailure;
                 Console.WriteLine(ex);
@@ -197,7 +197,41 @@ class sitkImageTests
         return false;
       }
 
+    byte[] bytes = new byte[size];
+    image.copyBufferTo(bytes);
+    if (bytes[2+7*3+7*8*4] != 99)
+      {
+        System.out.println("Expected 99 value in the copied bytes");
+        return false;
+      }
 
+    Image shortImage = new Image(7,8,9, PixelIDValueEnum.sitkInt16);
+    shortImage.setPixelAsInt16(idx, (short)-3);
+    short[] shorts = new short[size];
+    shortImage.copyBufferTo(shorts);
+    if (shorts[2+7*3+7*8*4] != -3)
+      {
+        System.out.println("Expected -3 value in the copied shorts");
+        return false;
+      }
+
+    shorts[2+7*3+7*8*4] = 1234;
+    shortImage.copyBufferFrom(shorts);
+    if (shortImage.getPixelAsInt16(idx) != 1234)
+      {
+        System.out.println("Expected 1234 value after the copy from shorts");
+        return false;
+      }
+
+    try
+      {
+        shortImage.copyBufferTo(new int[size]);
+        System.out.println("Expected an exception for the int array");
+        return false;
+      }
+    catch (IllegalArgumentException e)
+      {
+      }
 
     return true;
     }
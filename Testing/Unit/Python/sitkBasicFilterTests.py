@@ -156,6 +156,41 @@ class BasicFiltersTests(unittest.TestCase):
         img[10, 10] = 255
         self.assertEqual(sitk.MinimumMaximum(img), (1.0, 255.0))
 
+    def test_pipeline(self):
+        """Test the Pipeline of filters and procedures"""
+
+        img = sitk.GaussianSource(sitk.sitkUInt8, [32, 32, 8], sigma=[8, 8, 4], mean=[16, 16, 4])
+
+        median = sitk.MedianImageFilter()
+        median.SetRadius([1, 1, 1])
+
+        pipeline = sitk.Pipeline().Add(sitk.Cast, sitk.sitkFloat32).Add(median).Add(sitk.Multiply, 2.0)
+        self.assertEqual(len(pipeline), 3)
+        self.assertImageAlmostEqual(pipeline.Execute(img),
+                                    sitk.Median(sitk.Cast(img, sitk.sitkFloat32), [1, 1, 1]) * 2.0)
+        self.assertImageAlmostEqual(pipeline(img), pipeline.Execute(img))
+
+        # the filter object is not copied
+        median.SetRadius([2, 2, 2])
+        self.assertImageAlmostEqual(pipeline.Execute(img),
+                                    sitk.Median(sitk.Cast(img, sitk.sitkFloat32), [2, 2, 2]) * 2.0)
+
+        # a branch is executed on the input of the pipeline
+        smooth = sitk.Pipeline([(sitk.Cast, sitk.sitkFloat32), (sitk.Median, [1, 1, 1])])
+        difference = sitk.Pipeline().Add(sitk.Cast, sitk.sitkFloat32).Add(sitk.Subtract, smooth)
+        fimg = sitk.Cast(img, sitk.sitkFloat32)
+        self.assertImageAlmostEqual(difference.Execute(img), fimg - sitk.Median(fimg, [1, 1, 1]))
+
+        # the input read from a file
+        fname = os.path.join(self.test_dir, "pipeline.mha")
+        sitk.WriteImage(img, fname)
+        self.assertImageAlmostEqual(pipeline.Execute(fname), pipeline.Execute(img))
+
+        self.assertImageAlmostEqual(sitk.Pipeline().Execute(img), img)
+
+        with self.assertRaises(TypeError):
+            sitk.Pipeline().Add(1)
+
 
 if __name__ == '__main__':
     unittest.main()
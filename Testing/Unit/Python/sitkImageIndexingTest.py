@@ -250,6 +250,44 @@ class TestImageIndexingInterface(unittest.TestCase):
         self.assertEqual(4, img.GetPixel([1, 2, 3, 0, 0]))
         self.assertTrue(all([px == 4 for px in img[1:3, 2:4, 3:5, 0:2, 0:2]]))
 
+    def test_strided_setitem(self):
+        """ testing __setitem__ with strided slices and numpy masks"""
+
+        nda = np.linspace(0, 59, 60).reshape(3, 4, 5)
+        img = sitk.GetImageFromArray(nda)
+
+        img[::2, 1::2, :] = 100
+        nda[:, 1::2, ::2] = 100
+        self.assertImageNDArrayEquals(img, nda)
+
+        src = sitk.GetImageFromArray(np.arange(6, dtype=np.float64).reshape(3, 2))
+        img[4:0:-3, 0, :] = src
+        nda[:, 0, 4:0:-3] = np.arange(6).reshape(3, 2)
+        self.assertImageNDArrayEquals(img, nda)
+
+        img[::2, ::2, ::2] = img[::-2, 1::2, ::-2]
+        nda[::2, ::2, ::2] = nda[::-2, 1::2, ::-2]
+        self.assertImageNDArrayEquals(img, nda)
+
+        img[::-1, :, :] = img
+        nda[:, :, :] = nda[:, :, ::-1].copy()
+        self.assertImageNDArrayEquals(img, nda)
+
+        vimg = sitk.Image([4, 5], sitk.sitkVectorUInt8, 3)
+        vimg[::3, ::2] = 7
+        self.assertTrue(all([vimg[x, y] == ((7, 7, 7) if x % 3 == 0 and y % 2 == 0 else (0, 0, 0))
+                             for y in range(5) for x in range(4)]))
+
+        with self.assertRaises(RuntimeError):
+            img[::2, :, :] = sitk.Image([3, 4, 3], sitk.sitkFloat32)
+        with self.assertRaises(IndexError):
+            img[::2, :, :] = sitk.Image([2, 4, 3], sitk.sitkFloat64)
+
+        mask = nda > 50
+        img[mask] = -1
+        nda[mask] = -1
+        self.assertImageNDArrayEquals(img, nda)
+
     def test_3d_extract(self):
          """testing __getitem__ for extracting 2D slices from 3D image"""
 
@@ -20,6 +20,10 @@ import os
 import unittest
 import tempfile
 import shutil
+import threading
+import http.server
+import functools
+import io
 
 
 import SimpleITK as sitk
@@ -96,6 +100,151 @@ class ImageReadWrite(unittest.TestCase):
         sitk.WriteImage(img, fns, compressionLevel=90)
         img = sitk.ReadImage(fns, imageIO="TIFFImageIO")
 
+    def test_prefetch_reader(self):
+        """ Test iterating over the ImageFilePrefetchReader """
+
+        fns = []
+        for i in range(5):
+            img = sitk.Image([16,16], sitk.sitkUInt8)
+            img[i,i] = i+1
+            fns.append(os.path.join(self.test_dir, "prefetch_{}.mha".format(i)))
+            sitk.WriteImage(img, fns[-1])
+
+        prefetcher = sitk.ImageFilePrefetchReader(fns, 2)
+        hashes = [sitk.Hash(img) for img in prefetcher]
+        self.assertEqual(hashes, [sitk.Hash(sitk.ReadImage(fn)) for fn in fns])
+        self.assertFalse(prefetcher.HasNext())
+
+        prefetcher.Reset()
+        self.assertEqual(len(list(prefetcher)), len(fns))
+
+    def test_buffer_read_write(self):
+        """ Test encoding and decoding images in memory """
+
+        img = sitk.Image([32, 24], sitk.sitkUInt8)
+        img[3, 4] = 200
+
+        for imageIO in ["PNGImageIO", "MetaImageIO", "NrrdImageIO"]:
+            writer = sitk.ImageFileWriter()
+            content = writer.ExecuteToBuffer(img, imageIO)
+            self.assertIsInstance(content, bytes)
+
+            reader = sitk.ImageFileReader()
+            reader.SetBuffer(content, imageIO)
+            self.assertEqual(sitk.Hash(reader.Execute()), sitk.Hash(img))
+
+            reader.SetBuffer(memoryview(bytearray(content)), imageIO)
+            self.assertEqual(sitk.Hash(reader.Execute()), sitk.Hash(img))
+
+        with self.assertRaises(RuntimeError):
+            sitk.ImageFileReader().SetBuffer(42, "PNGImageIO")
+
+    def test_image_chunks(self):
+        """ Test iterating over the chunks of an image and of a file """
+
+        try:
+            import numpy
+        except ImportError:
+            self.skipTest("NumPy not available.")
+
+        img = sitk.Image([7, 5, 4], sitk.sitkInt16)
+        for z in range(4):
+            for y in range(5):
+                img[0, y, z] = y + 10 * z
+        fn = os.path.join(self.test_dir, "chunks.mha")
+        sitk.WriteImage(img, fn)
+
+        chunks = list(sitk.IterateImageChunks(img, [0, 2, 1]))
+        self.assertEqual(len(chunks), 12)
+        self.assertEqual([c.index for c in chunks[:4]], [(0, 0, 0), (0, 2, 0), (0, 4, 0), (0, 0, 1)])
+        self.assertEqual(chunks[2].size, (7, 1, 1))
+        for c in chunks:
+            self.assertEqual(c.array.shape, c.size[::-1])
+            self.assertEqual(c.array[0, 0, 0], img[c.index])
+
+        file_chunks = list(sitk.IterateImageChunks(fn, [0, 2, 1]))
+        self.assertEqual([c.index for c in file_chunks], [c.index for c in chunks])
+        for c, fc in zip(chunks, file_chunks):
+            self.assertTrue((c.array == fc.array).all())
+
+        for c in sitk.IterateImageChunks(img, [4, 0, 3], writable=True):
+            c.array[...] = 1
+        self.assertEqual(sitk.GetArrayViewFromImage(img).min(), 1)
+
+        with self.assertRaises(ValueError):
+            next(sitk.IterateImageChunks(img, [1, 1, 1, 1]))
+
+    def test_remote_read(self):
+        """ Test reading from an HTTP server with range requests """
+        import SimpleITK.remote as remote
+
+        class RangeHandler(http.server.SimpleHTTPRequestHandler):
+            """ Serve files with single byte range requests """
+            def send_head(self):
+                if "Range" not in self.headers:
+                    return super().send_head()
+                path = self.translate_path(self.path)
+                with open(path, "rb") as fp:
+                    data = fp.read()
+                start, end = self.headers["Range"][len("bytes="):].split("-")
+                start, end = int(start), min(int(end), len(data) - 1)
+                requested.append((start, end))
+                self.send_response(206)
+                self.send_header("Content-Range", "bytes {}-{}/{}".format(start, end, len(data)))
+                self.send_header("Content-Length", str(end - start + 1))
+                self.send_header("Accept-Ranges", "bytes")
+                self.send_header("ETag", str(os.path.getmtime(path)))
+                self.end_headers()
+                return io.BytesIO(data[start:end+1])
+
+            def end_headers(self):
+                if "Range" not in self.headers:
+                    self.send_header("Accept-Ranges", "bytes")
+                super().end_headers()
+
+            def log_message(self, *args):
+                pass
+
+        requested = []
+        server = http.server.ThreadingHTTPServer(("127.0.0.1", 0),
+                                                 functools.partial(RangeHandler, directory=self.test_dir))
+        thread = threading.Thread(target=server.serve_forever, daemon=True)
+        thread.start()
+        try:
+            img = sitk.Image([64, 64, 32], sitk.sitkInt16)
+            img[3, 4, 20] = 17
+            sitk.WriteImage(img, os.path.join(self.test_dir, "remote.mha"))
+            url = "http://127.0.0.1:{}/remote.mha".format(server.server_address[1])
+
+            cache = remote.RemoteFileCache(os.path.join(self.test_dir, "cache"), block_size=16*1024)
+
+            # only the header and the blocks of the region are requested
+            region = remote.ReadRemoteImage(url, extractIndex=[0, 0, 20], extractSize=[64, 64, 1], cache=cache)
+            self.assertEqual(region.GetSize(), (64, 64, 1))
+            self.assertEqual(region[3, 4, 0], 17)
+            self.assertFalse(cache.Open(url).complete)
+
+            reader = remote.ReadRemoteImageInformation(url, cache=cache)
+            self.assertEqual(reader.GetSize(), img.GetSize())
+
+            requested.clear()
+            self.assertEqual(sitk.Hash(remote.ReadRemoteImage(url, cache=cache)), sitk.Hash(img))
+            self.assertTrue(cache.Open(url).complete)
+            self.assertGreater(len(requested), 1)
+
+            # the blocks are reused from the cache
+            requested.clear()
+            remote.ReadRemoteImage(url, cache=cache)
+            self.assertEqual(len(requested), 0)
+
+            self.assertEqual(remote.ResolveURL("s3://bucket/a/b.nii.gz"), "https://bucket.s3.amazonaws.com/a/b.nii.gz")
+            self.assertEqual(remote.ResolveURL("gs://bucket/b.mha"), "https://storage.googleapis.com/bucket/b.mha")
+            self.assertTrue(remote.IsRemoteFileName(url))
+            self.assertFalse(remote.IsRemoteFileName(os.path.join(self.test_dir, "remote.mha")))
+        finally:
+            server.shutdown()
+            server.server_close()
+
     def _read_write_test(self, img, tmp_filename):
         """ """
 
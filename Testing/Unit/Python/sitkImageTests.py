@@ -208,6 +208,63 @@ class ImageTests(unittest.TestCase):
            ret = pickle.loads(p)
            self.assertEqual(img, ret, msg="pickle with {0} protocol".format(prot))
 
+    def test_pickle_out_of_band(self):
+       """Test pickling with out-of-band buffers of protocol 5"""
+
+       try:
+           import pickle5 as pickle
+       except ImportError:
+           import pickle
+
+       if pickle.HIGHEST_PROTOCOL < 5:
+           self.skipTest("pickle protocol 5 is not available")
+
+       img = sitk.Image( [10, 9, 11], sitk.sitkInt16 )
+       img = sitk.AdditiveGaussianNoise(img, standardDeviation=100.0)
+       img.SetSpacing([0.5, 1.5, 2.0])
+       img.SetMetaData("key", "value")
+
+       buffers = []
+       p = pickle.dumps(img, protocol=5, buffer_callback=buffers.append)
+       self.assertEqual(len(buffers), 1)
+       self.assertLess(len(p), 10*9*11*2)
+
+       # the buffer stays valid after the image is deleted
+       h = sitk.Hash(img)
+       del img
+       ret = pickle.loads(p, buffers=buffers)
+       self.assertEqual(sitk.Hash(ret), h)
+       self.assertEqual(ret.GetSpacing(), (0.5, 1.5, 2.0))
+       self.assertEqual(ret.GetMetaData("key"), "value")
+
+       # the unpickled image is copied before it is modified
+       ret[0, 0, 0] = 7
+       self.assertEqual(sitk.Hash(pickle.loads(p, buffers=buffers)), h)
+
+    def test_shared_image(self):
+       """Test pickling an image in shared memory"""
+
+       try:
+           import numpy
+       except ImportError:
+           self.skipTest("numpy is not available")
+       import pickle
+
+       img = sitk.Image( [10, 9, 11], sitk.sitkFloat32 )
+       img = sitk.AdditiveGaussianNoise(img)
+       img.SetOrigin([1.0, 2.0, 3.0])
+
+       with sitk.SharedImage(img) as shared:
+           p = pickle.dumps(shared)
+           self.assertLess(len(p), 10*9*11*4)
+
+           ret = pickle.loads(p).GetImage()
+           self.assertEqual(sitk.Hash(ret), sitk.Hash(img))
+           self.assertEqual(ret.GetOrigin(), (1.0, 2.0, 3.0))
+
+           ret[0, 0, 0] = 7.0
+           self.assertEqual(shared.GetImage()[0, 0, 0], img[0, 0, 0])
+
     def test_iterable(self):
         """Test that the Image object is iterable"""
 
@@ -265,6 +265,39 @@ class TestNumpySimpleITKInterface(unittest.TestCase):
         img = sitk.GetImageFromArray(arr[2:,:,::3])
         self.assertEqual(img.GetSize(), (4, 7, 3))
 
+    def test_image_view_from_array(self):
+        """Test a SimpleITK Image referring to a numpy array without a copy"""
+
+        arr = np.arange(5*7*11, dtype=np.int16)
+        arr.shape = (5, 7, 11)
+
+        img = sitk.GetImageViewFromArray(arr)
+        self.assertEqual(img.GetSize(), (11, 7, 5))
+        self.assertEqual(img.GetPixelID(), sitk.sitkInt16)
+        self.assertEqual(sitk.Hash(img), sitk.Hash(sitk.GetImageFromArray(arr)))
+
+        # the image refers to the array, and holds it
+        arr[0, 0, 1] = 100
+        self.assertEqual(img[1, 0, 0], 100)
+        del arr
+        self.assertEqual(img[2, 0, 0], 2)
+
+        # the array is copied before the image is modified
+        arr = np.zeros((4, 6, 3), dtype=np.float32)
+        img = sitk.GetImageViewFromArray(arr, isVector=True)
+        self.assertEqual(img.GetSize(), (6, 4))
+        self.assertEqual(img.GetNumberOfComponentsPerPixel(), 3)
+        img[1, 2] = (1.0, 2.0, 3.0)
+        self.assertEqual(img[1, 2], (1.0, 2.0, 3.0))
+        self.assertEqual(arr[2, 1].tolist(), [0.0, 0.0, 0.0])
+
+        filtered = sitk.Add(sitk.GetImageViewFromArray(arr), 1.0)
+        self.assertEqual(filtered[0, 0, 0], 1.0)
+        self.assertEqual(arr[0, 0, 0], 0.0)
+
+        self.assertRaises(ValueError, sitk.GetImageViewFromArray, np.zeros((4, 6), dtype=np.int32)[:, ::2])
+        self.assertRaises(ValueError, sitk.GetImageViewFromArray, np.zeros((4, 6), dtype=np.complex64))
+
     def test_image_from_native_type(self):
         """Test converting from native numpy scalar types to SimpleITK """
         for ntype in ('byte','ubyte','short','ushort','intc', 'uintc', 'uint', 'longlong', 'ulonglong'):
@@ -320,5 +353,53 @@ class TestNumpySimpleITKInterface(unittest.TestCase):
       self.assertEqual(image[1,1,1], 25)
       self.assertEqual(image[2,2,2], 50)
 
+    @unittest.skipUnless(hasattr(np, "from_dlpack"), "NumPy does not support DLPack")
+    def test_dlpack(self):
+      "export and import images with the DLPack protocol"
+
+      image = sitk.Image(sizeX, sizeY, sitk.sitkFloat32)
+      image[1, 2] = 3.0
+
+      self.assertEqual(image.__dlpack_device__(), (1, 0))
+
+      arr = np.from_dlpack(image)
+      self.assertEqual(arr.shape, (sizeY, sizeX))
+      self.assertEqual(arr.dtype, np.float32)
+      self.assertEqual(arr[2, 1], 3.0)
+
+      # the exported buffer is the image's and outlives it
+      arr[0, 0] = 5.0
+      self.assertEqual(image[0, 0], 5.0)
+      del image
+      self.assertEqual(arr[2, 1], 3.0)
+
+      image = sitk.GetImageFromDLPack(arr)
+      self.assertEqual(image.GetSize(), (sizeX, sizeY))
+      self.assertEqual(image[0, 0], 5.0)
+
+      vector = sitk.Image([sizeX, sizeY, sizeZ], sitk.sitkVectorUInt8, 2)
+      vector[1, 2, 0] = (7, 9)
+      arr = np.from_dlpack(vector)
+      self.assertEqual(arr.shape, (sizeZ, sizeY, sizeX, 2))
+      self.assertEqual(tuple(arr[0, 2, 1]), (7, 9))
+      self.assertEqual(sitk.GetImageFromDLPack(arr, isVector=True)[1, 2, 0], (7, 9))
+
+      # an image referring to the tensor, with the physical information of a reference
+      reference = sitk.Image(sizeX, sizeY, sitk.sitkUInt8)
+      reference.SetOrigin((1.0, 2.0))
+      reference.SetSpacing((0.5, 0.25))
+      arr = np.zeros((sizeY, sizeX), dtype=np.float32)
+      image = sitk.Image.from_dlpack(arr, reference=reference, spacing=(2.0, 3.0))
+      self.assertEqual(image.GetOrigin(), (1.0, 2.0))
+      self.assertEqual(image.GetSpacing(), (2.0, 3.0))
+      arr[2, 1] = 4.0
+      self.assertEqual(image[1, 2], 4.0)
+
+      image = sitk.Image.from_dlpack(arr[:, ::2])
+      self.assertEqual(image.GetSize(), ((sizeX + 1) // 2, sizeY))
+      with self.assertRaises(ValueError):
+        sitk.Image.from_dlpack(arr[:, ::2], copy=False)
+
+
 if __name__ == '__main__':
     unittest.main()
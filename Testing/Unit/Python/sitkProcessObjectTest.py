@@ -92,6 +92,45 @@ class ProcessObjectTest(unittest.TestCase):
         f.Execute(sitk.Image(10,10,sitk.sitkFloat32))
         self.assertEqual(p,[0.0])
 
+    def test_ProcessObject_ExecuteAsync(self):
+        """Testing awaiting filter execution"""
+        import asyncio
+
+        img = sitk.Image(10,10,sitk.sitkFloat32)
+        img[2,3] = 1.5
+
+        async def run():
+            f1 = sitk.AddImageFilter()
+            f2 = sitk.CastImageFilter()
+            f2.SetOutputPixelType(sitk.sitkInt16)
+            return await asyncio.gather(f1.ExecuteAsync(img, img), f2.ExecuteAsync(img))
+
+        added, cast = asyncio.run(run())
+        self.assertEqual(added[2,3], 3.0)
+        self.assertEqual(cast.GetPixelID(), sitk.sitkInt16)
+
+    def test_ProcessObject_ThreadPool_Command(self):
+        """Testing commands of filters executed concurrently by Python threads"""
+        from concurrent.futures import ThreadPoolExecutor
+
+        img = sitk.Image(64,64,8,sitk.sitkFloat32)
+        img[2,3,4] = 1.5
+
+        def run(i):
+            f = sitk.SmoothingRecursiveGaussianImageFilter()
+            f.SetSigma(1.0 + i)
+            progress = [0.0]
+            f.AddCommand(sitk.sitkProgressEvent, lambda: progress.__setitem__(0, f.GetProgress()))
+            out = f.Execute(img)
+            return progress[0], out.GetSize()
+
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            results = list(executor.map(run, range(8)))
+
+        for progress, size in results:
+            self.assertEqual(progress, 1.0)
+            self.assertEqual(size, img.GetSize())
+
 
 if __name__ == '__main__':
     unittest.main()
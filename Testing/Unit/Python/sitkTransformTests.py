@@ -426,6 +426,38 @@ class TransformTests(unittest.TestCase):
         for i, itx in enumerate(tx_list):
             self.assertEqual(ctx.GetNthTransform(i).__class__, itx.__class__)
 
+    def test_transform_points(self):
+        """Test the transform of many points with numpy arrays and sequences."""
+
+        try:
+            import numpy as np
+        except ImportError:
+            self.skipTest("numpy is not available")
+
+        tx = sitk.Euler3DTransform((1, 2, 3), 0.1, -0.2, 0.3, (4, -5, 6))
+        points = np.linspace(-5, 5, 3 * 1000).reshape(1000, 3)
+        vectors = np.ones((1000, 3))
+
+        out = tx.TransformPoints(points)
+        self.assertIsInstance(out, np.ndarray)
+        self.assertEqual(out.shape, points.shape)
+        for i in range(0, 1000, 101):
+            np.testing.assert_allclose(out[i], tx.TransformPoint(points[i].tolist()), atol=1e-12)
+
+        out = tx.TransformVectors(vectors, points)
+        np.testing.assert_allclose(out[0], tx.TransformVector(vectors[0].tolist(), points[0].tolist()), atol=1e-12)
+
+        # non contiguous arrays are converted
+        np.testing.assert_allclose(tx.TransformPoints(np.asfortranarray(points)), tx.TransformPoints(points))
+
+        # a sequence of coordinates returns a tuple
+        seq = tx.TransformPoints(points[:2].flatten().tolist())
+        self.assertIsInstance(seq, tuple)
+        np.testing.assert_allclose(seq, tx.TransformPoints(points[:2]).flatten())
+
+        with self.assertRaises(ValueError):
+            tx.TransformPoints(np.zeros((10, 2)))
+
 if __name__ == '__main__':
 
     unittest.main()
@@ -16,13 +16,167 @@
 *
 *=========================================================================*/
 #include <SimpleITK.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <itksys/SystemTools.hxx>
 
 #include "sitkImageCompare.h"
 
 namespace sitk = itk::simple;
 
+namespace
+{
+
+bool isLabelType( const sitk::Image &image )
+{
+  const sitk::PixelIDValueEnum id = image.GetPixelID();
+  return id == sitk::sitkLabelUInt8 || id == sitk::sitkLabelUInt16 || id == sitk::sitkLabelUInt32 || id == sitk::sitkLabelUInt64;
+}
+
+bool isComplexType( const sitk::Image &image )
+{
+  return image.GetPixelID() == sitk::sitkComplexFloat32 || image.GetPixelID() == sitk::sitkComplexFloat64;
+}
+
+
+// The squared difference image, for saving the difference of a failed
+// comparison.
+sitk::Image differenceSquared( const sitk::Image &testImage, const sitk::Image &baselineImage )
+{
+  if ( isComplexType( baselineImage ) )
+    {
+    const sitk::Image diff =  sitk::Subtract( testImage, baselineImage );
+    // for complex number we multiply the image by it's complex
+    // conjugate, this will produce only a real value result
+    const sitk::Image conj = sitk::RealAndImaginaryToComplex( sitk::ComplexToReal( diff ),
+                                                              sitk::Multiply( sitk::ComplexToImaginary( diff ), -1.0 ) );
+    return sitk::ComplexToReal( sitk::Multiply( diff, conj ) );
+    }
+  else if ( baselineImage.GetNumberOfComponentsPerPixel() > 1 )
+    {
+    const sitk::Image diff =  sitk::Subtract( sitk::Cast( testImage, sitk::sitkVectorFloat32 ), sitk::Cast( baselineImage, sitk::sitkVectorFloat32 ) );
+
+    // for vector image just do a sum of the components
+    sitk::Image diffSquared  = sitk::Pow( sitk::VectorIndexSelectionCast( diff, 0 ), 2.0 );
+    for ( unsigned int i = 1; i < diff.GetNumberOfComponentsPerPixel(); ++i )
+      {
+      const sitk::Image temp = sitk::Pow( sitk::VectorIndexSelectionCast( diff, i ), 2.0 );
+      diffSquared = sitk::Add( temp, diffSquared );
+      }
+
+    return sitk::Divide( diffSquared, diff.GetNumberOfComponentsPerPixel() );
+    }
+
+  sitk::Image diff =  sitk::Subtract( sitk::Cast( testImage, sitk::sitkFloat32 ), sitk::Cast( baselineImage, sitk::sitkFloat32 ) );
+  return sitk::Multiply( diff, diff );
+}
+
+
+// The sums of a block of pixels, merged into the image's difference.
+struct DifferenceSums
+{
+  double minimum = std::numeric_limits<double>::max();
+  double maximum = 0.0;
+  double sum = 0.0;
+  double sumOfSquares = 0.0;
+  uint64_t mismatches = 0;
+  uint64_t count = 0;
+
+  void merge( const DifferenceSums &other )
+    {
+      minimum = std::min( minimum, other.minimum );
+      maximum = std::max( maximum, other.maximum );
+      sum += other.sum;
+      sumOfSquares += other.sumOfSquares;
+      mismatches += other.mismatches;
+      count += other.count;
+    }
+};
+
+
+template <typename TComponent>
+DifferenceSums accumulateDifference( const sitk::Image &testImage,
+                                     const sitk::Image &baselineImage,
+                                     double tolerance,
+                                     bool stopEarly )
+{
+  const TComponent *test = static_cast<const TComponent *>( testImage.GetBufferAsVoid() );
+  const TComponent *baseline = static_cast<const TComponent *>( baselineImage.GetBufferAsVoid() );
+
+  const uint64_t numberOfPixels = testImage.GetNumberOfPixels();
+  const bool isComplex = isComplexType( testImage );
+  const unsigned int numberOfComponents = isComplex ? 2 : testImage.GetNumberOfComponentsPerPixel();
+  // the components of a vector are averaged, those of a complex are not
+  const double divisor = isComplex ? 1.0 : numberOfComponents;
+
+  constexpr uint64_t blockSize = 1u << 16;
+  const uint64_t numberOfBlocks = ( numberOfPixels + blockSize - 1 ) / blockSize;
+  const unsigned int numberOfThreads =
+    static_cast<unsigned int>( std::max<uint64_t>( 1u, std::min<uint64_t>( std::thread::hardware_concurrency(), numberOfBlocks ) ) );
+
+  DifferenceSums total;
+  std::mutex mutex;
+  std::atomic<uint64_t> nextBlock( 0 );
+  std::atomic<bool> exceeded( false );
+
+  auto worker = [&]()
+    {
+      uint64_t block;
+      while ( !exceeded && ( block = nextBlock++ ) < numberOfBlocks )
+        {
+        DifferenceSums sums;
+        const uint64_t last = std::min( numberOfPixels, ( block + 1 ) * blockSize );
+        for ( uint64_t p = block * blockSize; p < last; ++p )
+          {
+          double squared = 0.0;
+          for ( unsigned int c = 0; c < numberOfComponents; ++c )
+            {
+            const double d = static_cast<double>( test[p * numberOfComponents + c] ) - static_cast<double>( baseline[p * numberOfComponents + c] );
+            squared += d * d;
+            }
+          squared /= divisor;
+
+          const double magnitude = std::sqrt( squared );
+          sums.minimum = std::min( sums.minimum, magnitude );
+          sums.maximum = std::max( sums.maximum, magnitude );
+          sums.sum += magnitude;
+          sums.sumOfSquares += squared;
+          sums.mismatches += ( magnitude > tolerance );
+          }
+        sums.count = last - block * blockSize;
+
+        std::lock_guard<std::mutex> lock( mutex );
+        total.merge( sums );
+        // the pixels not compared can only increase the mean
+        if ( stopEarly && std::sqrt( total.sumOfSquares / numberOfPixels ) > tolerance )
+          {
+          exceeded = true;
+          }
+        }
+    };
+
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 1; t < numberOfThreads; ++t )
+    {
+    threads.emplace_back( worker );
+    }
+  worker();
+  for ( std::thread &thread : threads )
+    {
+    thread.join();
+    }
+
+  return total;
+}
+
+}
+
 void ImageCompare::NormalizeAndSave ( const sitk::Image &input, const std::string &filename )
 {
   sitk::Image image = input;
@@ -64,6 +218,93 @@ void ImageCompare::NormalizeAndSave ( const sitk::Image &input, const std::strin
 }
 
 
+ImageCompare::Difference ImageCompare::computeDifference( const sitk::Image &inTestImage,
+                                                         const sitk::Image &inBaselineImage,
+                                                         double tolerance,
+                                                         bool stopEarly )
+{
+  if ( inTestImage.GetSize() != inBaselineImage.GetSize() )
+    {
+    throw std::invalid_argument( "The images have different sizes." );
+    }
+  if ( inTestImage.GetNumberOfComponentsPerPixel() != inBaselineImage.GetNumberOfComponentsPerPixel() )
+    {
+    throw std::invalid_argument( "The images have different numbers of components." );
+    }
+
+  // the images must occupy the same physical space, with the
+  // tolerances of the ITK filters
+  const double coordinateTolerance =
+    std::fabs( sitk::ProcessObject::GetGlobalDefaultCoordinateTolerance() * inTestImage.GetSpacing()[0] );
+  const double directionTolerance = sitk::ProcessObject::GetGlobalDefaultDirectionTolerance();
+  auto isEqual = []( const std::vector<double> &a, const std::vector<double> &b, double t )
+    {
+      return a.size() == b.size() && std::equal( a.begin(), a.end(), b.begin(),
+                                                 [t]( double x, double y ) { return std::fabs( x - y ) <= t; } );
+    };
+  if ( !isEqual( inTestImage.GetOrigin(), inBaselineImage.GetOrigin(), coordinateTolerance )
+       || !isEqual( inTestImage.GetSpacing(), inBaselineImage.GetSpacing(), coordinateTolerance )
+       || !isEqual( inTestImage.GetDirection(), inBaselineImage.GetDirection(), directionTolerance ) )
+    {
+    throw std::invalid_argument( "The images do not occupy the same physical space." );
+    }
+
+  sitk::Image testImage = inTestImage;
+  sitk::Image baselineImage = inBaselineImage;
+  if ( testImage.GetPixelID() != baselineImage.GetPixelID() || isLabelType( testImage ) )
+    {
+    if ( isComplexType( testImage ) || isComplexType( baselineImage ) )
+      {
+      throw std::invalid_argument( "A complex image can only be compared to an image of the same pixel type." );
+      }
+    const sitk::PixelIDValueEnum floatType =
+      testImage.GetNumberOfComponentsPerPixel() > 1 ? sitk::sitkVectorFloat32 : sitk::sitkFloat32;
+    testImage = sitk::Cast( testImage, floatType );
+    baselineImage = sitk::Cast( baselineImage, floatType );
+    }
+
+  tolerance = std::fabs( tolerance );
+
+  DifferenceSums sums;
+  const sitk::PixelIDValueEnum id = testImage.GetPixelID();
+  if ( id == sitk::sitkUInt8 || id == sitk::sitkVectorUInt8 )
+    sums = accumulateDifference<uint8_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkInt8 || id == sitk::sitkVectorInt8 )
+    sums = accumulateDifference<int8_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkUInt16 || id == sitk::sitkVectorUInt16 )
+    sums = accumulateDifference<uint16_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkInt16 || id == sitk::sitkVectorInt16 )
+    sums = accumulateDifference<int16_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkUInt32 || id == sitk::sitkVectorUInt32 )
+    sums = accumulateDifference<uint32_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkInt32 || id == sitk::sitkVectorInt32 )
+    sums = accumulateDifference<int32_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkUInt64 || id == sitk::sitkVectorUInt64 )
+    sums = accumulateDifference<uint64_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkInt64 || id == sitk::sitkVectorInt64 )
+    sums = accumulateDifference<int64_t>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkFloat32 || id == sitk::sitkVectorFloat32 || id == sitk::sitkComplexFloat32 )
+    sums = accumulateDifference<float>( testImage, baselineImage, tolerance, stopEarly );
+  else if ( id == sitk::sitkFloat64 || id == sitk::sitkVectorFloat64 || id == sitk::sitkComplexFloat64 )
+    sums = accumulateDifference<double>( testImage, baselineImage, tolerance, stopEarly );
+  else
+    throw std::invalid_argument( "Unsupported pixel type: " + testImage.GetPixelIDTypeAsString() );
+
+  Difference difference;
+  const uint64_t numberOfPixels = testImage.GetNumberOfPixels();
+  difference.incomplete = sums.count < numberOfPixels;
+  if ( sums.count )
+    {
+    difference.minimum = sums.minimum;
+    difference.maximum = sums.maximum;
+    difference.mean = sums.sum / sums.count;
+    difference.rms = std::sqrt( sums.sumOfSquares / numberOfPixels );
+    }
+  difference.mismatches = sums.mismatches;
+  return difference;
+}
+
+
 ImageCompare::ImageCompare()
 {
   mTolerance = 0.0;
@@ -73,7 +314,8 @@ ImageCompare::ImageCompare()
 float ImageCompare::testImages( const itk::simple::Image& testImage,
                                 const itk::simple::Image& baselineImage,
                                 bool reportErrors,
-                                const std::string &baselineImageFilename)
+                                const std::string &baselineImageFilename,
+                                bool stopEarly )
 {
 
   const std::string OutputDir = dataFinder.GetOutputDirectory();
@@ -90,66 +332,36 @@ float ImageCompare::testImages( const itk::simple::Image& testImage,
     }
 
 
-    // Compute image difference squared
-    sitk::Image diffSquared( 0, 0, itk::simple::sitkUInt8 );
+    // Compute the difference in one pass, stopping early when only
+    // checking the tolerance
+    Difference difference;
     try
       {
-
-      if ( baselineImage.GetPixelID() == sitk::sitkComplexFloat32 ||
-           baselineImage.GetPixelID() == sitk::sitkComplexFloat64 )
-        {
-
-        const sitk::Image diff =  sitk::Subtract( testImage, baselineImage );
-        // for complex number we multiply the image by it's complex
-        // conjugate, this will produce only a real value result
-        const sitk::Image conj = sitk::RealAndImaginaryToComplex( sitk::ComplexToReal( diff ),
-                                                                  sitk::Multiply( sitk::ComplexToImaginary( diff ), -1.0 ) );
-        diffSquared = sitk::ComplexToReal( sitk::Multiply( diff, conj ) );
-        }
-      else if ( baselineImage.GetNumberOfComponentsPerPixel() > 1 )
-        {
-        const sitk::Image diff =  sitk::Subtract( sitk::Cast( testImage, sitk::sitkVectorFloat32 ), sitk::Cast( baselineImage, sitk::sitkVectorFloat32 ) );
-
-        // for vector image just do a sum of the components
-        diffSquared  = sitk::Pow( sitk::VectorIndexSelectionCast( diff, 0 ), 2.0 );
-        for ( unsigned int i = 1; i < diff.GetNumberOfComponentsPerPixel(); ++i )
-          {
-          const sitk::Image temp = sitk::Pow( sitk::VectorIndexSelectionCast( diff, i ), 2.0 );
-          diffSquared = sitk::Add( temp, diffSquared );
-          }
-
-        diffSquared = sitk::Divide( diffSquared, diff.GetNumberOfComponentsPerPixel() );
-        }
-      else
-        {
-        sitk::Image diff =  sitk::Subtract( sitk::Cast( testImage, sitk::sitkFloat32 ), sitk::Cast( baselineImage, sitk::sitkFloat32 ) );
-        diffSquared = sitk::Multiply( diff, diff );
-        }
-
+      difference = computeDifference( testImage, baselineImage, mTolerance, !reportErrors && stopEarly );
       }
     catch ( std::exception& e )
       {
-      mMessage = "ImageCompare: Failed to subtract image " + baselineImageFilename + " because: " + e.what();
+      mMessage = "ImageCompare: Failed to compare image " + baselineImageFilename + " because: " + e.what();
       return -1;
       }
-
-
-
-    sitk::StatisticsImageFilter stats;
-    stats.Execute ( diffSquared );
-    const double rms = std::sqrt ( stats.GetMean() );
+    const double rms = difference.rms;
 
     if ( !reportErrors )
       {
       // The measurement errors should be reported for both success and errors
       // to facilitate setting tight tolerances of tests.
-      std::cout << "<DartMeasurement name=\"RMSEDifference " << shortFilename <<  "\" type=\"numeric/float\">" << rms << "</DartMeasurement>" << std::endl;
+      if ( !difference.incomplete )
+        {
+        std::cout << "<DartMeasurement name=\"RMSEDifference " << shortFilename <<  "\" type=\"numeric/float\">" << rms << "</DartMeasurement>" << std::endl;
+        }
       }
     else
       {
       std::ostringstream msg;
       msg << "ImageCompare: image Root Mean Square (RMS) difference was " << rms << " which exceeds the tolerance of " << mTolerance;
       msg << "\n";
+      msg << "ImageCompare: the maximum difference was " << difference.maximum << " and "
+          << difference.mismatches << " pixels differ by more than the tolerance\n";
       mMessage = msg.str();
 
       std::cout << "<DartMeasurement name=\"RMSEDifference\" type=\"numeric/float\">" << rms << "</DartMeasurement>" << std::endl;
@@ -167,7 +379,7 @@ float ImageCompare::testImages( const itk::simple::Image& testImage,
         {
         NormalizeAndSave ( baselineImage, ExpectedImageFilename );
         NormalizeAndSave ( testImage, ActualImageFilename );
-        NormalizeAndSave ( sitk::Sqrt(diffSquared), DifferenceImageFilename );
+        NormalizeAndSave ( sitk::Sqrt( differenceSquared( testImage, baselineImage ) ), DifferenceImageFilename );
 
         // Let ctest know about it
         std::cout << "<DartMeasurementFile name=\"ExpectedImage\" type=\"image/png\">";
@@ -177,16 +389,17 @@ float ImageCompare::testImages( const itk::simple::Image& testImage,
         std::cout << "<DartMeasurementFile name=\"DifferenceImage\" type=\"image/png\">";
         std::cout << DifferenceImageFilename << "</DartMeasurementFile>" << std::endl;
 
-        stats.Execute( sitk::Sqrt(diffSquared) );
-
         std::cout << "<DartMeasurement name=\"DifferenceImage Minimum\" type=\"numeric/double\">";
-        std::cout << stats.GetMinimum() << "</DartMeasurement>" << std::endl;
+        std::cout << difference.minimum << "</DartMeasurement>" << std::endl;
 
         std::cout << "<DartMeasurement name=\"DifferenceImage Maximum\" type=\"numeric/double\">";
-        std::cout << stats.GetMaximum() << "</DartMeasurement>" << std::endl;
+        std::cout << difference.maximum << "</DartMeasurement>" << std::endl;
 
         std::cout << "<DartMeasurement name=\"DifferenceImage Mean\" type=\"numeric/double\">";
-        std::cout << stats.GetMean() << "</DartMeasurement>" << std::endl;
+        std::cout << difference.mean << "</DartMeasurement>" << std::endl;
+
+        std::cout << "<DartMeasurement name=\"DifferenceImage Mismatches\" type=\"numeric/integer\">";
+        std::cout << difference.mismatches << "</DartMeasurement>" << std::endl;
 
         }
       catch( std::exception &e )
@@ -311,7 +524,8 @@ bool ImageCompare::compare ( const sitk::Image& image, std::string inTestCase, s
       return false;
       }
 
-    float RMS = testImages( centerSlice, baseline, false,  *iterName);
+    // the full rms is needed to choose between several baselines
+    float RMS = testImages( centerSlice, baseline, false,  *iterName, baselineFileNames.size() == 1 );
 
     if ( RMS >= 0.0 && RMS < bestRMS )
       {
@@ -32,10 +32,38 @@ public:
   float testImages( const itk::simple::Image& testImage,
                     const itk::simple::Image& baselineImage,
                     bool retportErrors,
-                    const std::string &baselineImageFilename );
+                    const std::string &baselineImageFilename,
+                    bool stopEarly = false );
 
   static itk::simple::Image extractSlice( const itk::simple::Image & image );
 
+  // The difference of the pixels of two images of the same size. The
+  // difference of a pixel is the root of the mean squared difference
+  // of its components, or the modulus of the difference for complex
+  // pixels.
+  struct Difference
+  {
+    double minimum = 0.0;
+    double maximum = 0.0;
+    double mean = 0.0;
+    double rms = 0.0;
+    // the number of pixels with a difference greater than the tolerance
+    uint64_t mismatches = 0;
+    // when stopped early, the values are of the pixels compared and
+    // the rms is a lower bound of the rms of the images
+    bool incomplete = false;
+  };
+
+  // Compute the difference in one multi-threaded pass over the
+  // buffers, optionally stopping once the rms is known to exceed the
+  // tolerance. Images of different pixel types are compared as
+  // float. An exception is thrown if the images can not be compared,
+  // such as when their origins, spacings or directions differ.
+  static Difference computeDifference( const itk::simple::Image &testImage,
+                                       const itk::simple::Image &baselineImage,
+                                       double tolerance,
+                                       bool stopEarly );
+
   // Return the message from the previous image comparison.
   std::string getMessage() { return mMessage; }
   void setTolerance ( double t ) { mTolerance = t; }
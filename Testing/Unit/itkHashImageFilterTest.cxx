@@ -21,6 +21,8 @@
 #include <sitkHashImageFilter.h>
 #include <sitkImageFileReader.h>
 #include <sitkCastImageFilter.h>
+#include <sitkRegionOfInterestImageFilter.h>
+#include <itkVectorImage.h>
 
 class HashImageFilterTest
   : public ::testing::Test {
@@ -198,3 +200,101 @@ TEST_F(HashImageFilterTest, Coverage ) {
  hasher->SetHashFunction( UCHAR2HasherType::SHA1 );
  EXPECT_EQ(  hasher->GetHashFunction(), UCHAR2HasherType::SHA1 ) << "expected default hash type to be SHA1";
 }
+
+TEST_F(HashImageFilterTest, XXH64 ) {
+
+  using ImageType = itk::Image<float, 3>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( dataFinder.GetFile ( "Input/RA-Float.nrrd" ) );
+  reader->Update();
+
+  using HasherType = itk::HashImageFilter< ImageType >;
+  HasherType::Pointer  hasher = HasherType::New();
+  hasher->SetHashFunction( HasherType::XXH64 );
+  hasher->SetInput( reader->GetOutput() );
+  hasher->Update();
+
+  const std::string hash = hasher->GetHash();
+  EXPECT_EQ( hash.size(), 16u );
+  EXPECT_EQ( hasher->GetOutput()->GetBufferPointer(), reader->GetOutput()->GetBufferPointer() ) << "the input is not copied";
+
+  // the same buffer of another pixel type has the same digest
+  using VectorImageType = itk::VectorImage<float, 3>;
+  itk::ImageFileReader<VectorImageType>::Pointer vectorReader = itk::ImageFileReader<VectorImageType>::New();
+  vectorReader->SetFileName( dataFinder.GetFile ( "Input/RA-Float.nrrd" ) );
+  using VectorHasherType = itk::HashImageFilter< VectorImageType >;
+  VectorHasherType::Pointer vectorHasher = VectorHasherType::New();
+  vectorHasher->SetHashFunction( VectorHasherType::XXH64 );
+  vectorHasher->SetInput( vectorReader->GetOutput() );
+  vectorHasher->Update();
+  EXPECT_EQ( vectorHasher->GetHash(), hash );
+}
+
+TEST_F(HashImageFilterTest, TreeHash ) {
+
+  namespace sitk = itk::simple;
+
+  sitk::Image image = sitk::ReadImage( dataFinder.GetFile ( "Input/RA-Float.nrrd" ) );
+
+  for ( sitk::HashImageFilter::HashFunction function : { sitk::HashImageFilter::SHA1, sitk::HashImageFilter::MD5, sitk::HashImageFilter::XXH64 } )
+    {
+    sitk::HashImageFilter hasher;
+    hasher.SetHashFunction( function );
+    const std::string sequentialHash = hasher.Execute( image );
+
+    hasher.SetTreeHashChunkSize( 1000 );
+    EXPECT_EQ( hasher.GetTreeHashChunkSize(), 1000u );
+    const std::string treeHash = hasher.Execute( image );
+    EXPECT_NE( treeHash, sequentialHash );
+    EXPECT_EQ( treeHash.size(), sequentialHash.size() );
+
+    // the tree hash does not depend on the number of threads
+    hasher.SetNumberOfThreads( 1 );
+    EXPECT_EQ( hasher.Execute( image ), treeHash );
+
+    // a single chunk is hashed once more
+    hasher.SetTreeHashChunkSize( 1u << 30 );
+    EXPECT_NE( hasher.Execute( image ), sequentialHash );
+
+    hasher.SetTreeHashChunkSize( 0 );
+    EXPECT_EQ( hasher.Execute( image ), sequentialHash );
+    }
+}
+
+TEST_F(HashImageFilterTest, HashRegion ) {
+
+  namespace sitk = itk::simple;
+
+  sitk::Image image = sitk::ReadImage( dataFinder.GetFile ( "Input/RA-Float.nrrd" ) );
+
+  const std::vector<int> index = { 2, 3, 1 };
+  const std::vector<unsigned int> size = { 5, 7, 4 };
+
+  sitk::HashImageFilter hasher;
+  hasher.SetHashRegion( index, size );
+  EXPECT_EQ( hasher.GetHashRegionIndex(), index );
+  EXPECT_EQ( hasher.GetHashRegionSize(), size );
+
+  sitk::Image region = sitk::RegionOfInterest( image, size, index );
+  for ( sitk::HashImageFilter::HashFunction function : { sitk::HashImageFilter::SHA1, sitk::HashImageFilter::XXH64 } )
+    {
+    hasher.SetHashFunction( function );
+    EXPECT_EQ( hasher.Execute( image ), sitk::Hash( region, function ) );
+    }
+
+  hasher.SetTreeHashChunkSize( 12 );
+  sitk::HashImageFilter regionHasher;
+  regionHasher.SetHashFunction( sitk::HashImageFilter::XXH64 );
+  regionHasher.SetTreeHashChunkSize( 12 );
+  EXPECT_EQ( hasher.Execute( image ), regionHasher.Execute( region ) );
+
+  // the region must be inside the image
+  hasher.SetHashRegion( { 0, 0, 0 }, { 1000, 1, 1 } );
+  EXPECT_THROW( hasher.Execute( image ), sitk::GenericException );
+  EXPECT_THROW( hasher.SetHashRegion( { 0, 0 }, { 1, 1, 1 } ), sitk::GenericException );
+
+  hasher.RemoveHashRegion();
+  hasher.SetTreeHashChunkSize( 0 );
+  EXPECT_EQ( hasher.Execute( image ), sitk::Hash( image, sitk::HashImageFilter::XXH64 ) );
+}
@@ -21,6 +21,8 @@
 #include <sitkImageFileReader.h>
 #include <sitkImageFileWriter.h>
 #include <sitkHashImageFilter.h>
+#include <sitkOtsuMultipleThresholdsImageFilter.h>
+#include <sitkScalarImageKmeansImageFilter.h>
 #include <sitkGaussianImageSource.h>
 #include <sitkRecursiveGaussianImageFilter.h>
 #include <sitkCastImageFilter.h>
@@ -28,16 +30,20 @@
 #include <sitkStatisticsImageFilter.h>
 #include <sitkExtractImageFilter.h>
 #include <sitkFastMarchingBaseImageFilter.h>
+#include <sitkFastMarchingImageFilter.h>
 #include <sitkInverseDeconvolutionImageFilter.h>
 #include <sitkTikhonovDeconvolutionImageFilter.h>
 #include <sitkWienerDeconvolutionImageFilter.h>
 #include <sitkLandweberDeconvolutionImageFilter.h>
 #include <sitkProjectedLandweberDeconvolutionImageFilter.h>
 #include <sitkRichardsonLucyDeconvolutionImageFilter.h>
+#include <sitkConvolutionImageFilter.h>
+#include <sitkFFTConvolutionImageFilter.h>
 #include <sitkScalarToRGBColormapImageFilter.h>
 #include <sitkJoinSeriesImageFilter.h>
 #include <sitkGradientAnisotropicDiffusionImageFilter.h>
 #include <sitkCurvatureAnisotropicDiffusionImageFilter.h>
+#include <sitkCurvatureFlowImageFilter.h>
 #include <sitkLabelMapContourOverlayImageFilter.h>
 #include <sitkPatchBasedDenoisingImageFilter.h>
 #include <sitkConnectedThresholdImageFilter.h>
@@ -49,14 +55,101 @@
 #include <sitkCenteredTransformInitializerFilter.h>
 #include <sitkCenteredVersorTransformInitializerFilter.h>
 #include <sitkLandmarkBasedTransformInitializerFilter.h>
+#include <sitkMultiResolutionDemonsRegistrationFilter.h>
 #include <sitkAdditionalProcedures.h>
 #include <sitkCommand.h>
 #include <sitkResampleImageFilter.h>
 #include <sitkSignedMaurerDistanceMapImageFilter.h>
+#include <sitkEuclideanDistanceMapImageFilter.h>
 #include <sitkSignedDanielssonDistanceMapImageFilter.h>
 #include <sitkDICOMOrientImageFilter.h>
+#include <sitkPermuteAxesImageFilter.h>
+#include <sitkFlipImageFilter.h>
+#include <sitkCyclicShiftImageFilter.h>
+#include <sitkTransformGeometryImageFilter.h>
 #include <sitkPasteImageFilter.h>
 #include <sitkN4BiasFieldCorrectionImageFilter.h>
+#include <sitkScalarChanAndVeseSparseLevelSetImageFilter.h>
+#include <sitkAddImageFilter.h>
+#include <sitkSubtractImageFilter.h>
+#include <sitkAbsImageFilter.h>
+#include <sitkMaximumImageFilter.h>
+#include <sitkMinimumImageFilter.h>
+#include <sitkMultiplyImageFilter.h>
+#include <sitkDivideImageFilter.h>
+#include <sitkExpImageFilter.h>
+#include <sitkNaryAddImageFilter.h>
+#include <sitkShiftScaleImageFilter.h>
+#include <sitkSigmoidImageFilter.h>
+#include <sitkBinaryThresholdImageFilter.h>
+#include <sitkForwardFFTImageFilter.h>
+#include <sitkFFTConfiguration.h>
+#include <sitkPointwiseExpressionImageFilter.h>
+#include <sitkFusedStatisticsImageFilter.h>
+#include <sitkMultiChannelLabelStatisticsImageFilter.h>
+#include <sitkMultiProjectionImageFilter.h>
+#include <sitkMultiResolutionPyramidImageFilter.h>
+#include <sitkBinShrinkImageFilter.h>
+#include <sitkMaximumProjectionImageFilter.h>
+#include <sitkMinimumProjectionImageFilter.h>
+#include <sitkMedianProjectionImageFilter.h>
+#include <sitkMeanProjectionImageFilter.h>
+#include <sitkSumProjectionImageFilter.h>
+#include <sitkStandardDeviationProjectionImageFilter.h>
+#include <sitkLabelEvaluationImageFilter.h>
+#include <sitkLabelOverlapMeasuresImageFilter.h>
+#include <sitkHausdorffDistanceImageFilter.h>
+#include <sitkLabelContourImageFilter.h>
+#include <sitkLabelStatisticsImageFilter.h>
+#include <sitkLabelImageToLabelMapFilter.h>
+#include <sitkLabelMapToLabelImageFilter.h>
+#include <sitkChangeLabelLabelMapFilter.h>
+#include <sitkConnectedComponentImageFilter.h>
+#include <sitkRelabelComponentImageFilter.h>
+#include <sitkBinaryDilateImageFilter.h>
+#include <sitkBinaryErodeImageFilter.h>
+#include <sitkGrayscaleDilateImageFilter.h>
+#include <sitkGrayscaleMorphologicalOpeningImageFilter.h>
+#include <sitkMorphologicalWatershedImageFilter.h>
+#include <sitkMorphologicalWatershedFromMarkersImageFilter.h>
+#include <sitkThresholdMaximumConnectedComponentsImageFilter.h>
+#include <sitkVolumeOpeningImageFilter.h>
+#include <sitkAreaOpeningImageFilter.h>
+#include <sitkAreaClosingImageFilter.h>
+#include <sitkHMaximaImageFilter.h>
+#include <sitkHMinimaImageFilter.h>
+#include <sitkHConvexImageFilter.h>
+#include <sitkHConcaveImageFilter.h>
+#include <sitkRegionalMaximaImageFilter.h>
+#include <sitkRegionalMinimaImageFilter.h>
+#include <sitkReconstructionByDilationImageFilter.h>
+#include <sitkReconstructionByErosionImageFilter.h>
+#include <sitkMedianImageFilter.h>
+#include <sitkMultiLabelSTAPLEImageFilter.h>
+#include <sitkNotEqualImageFilter.h>
+#include <sitkInvertIntensityImageFilter.h>
+#include <sitkHistogramMatchingImageFilter.h>
+#include <sitkIntensityWindowingImageFilter.h>
+#include <sitkRescaleIntensityImageFilter.h>
+#include <sitkRegionOfInterestImageFilter.h>
+#include <sitkBilateralImageFilter.h>
+#include <sitkDiscreteGaussianImageFilter.h>
+#include <sitkGradientMagnitudeRecursiveGaussianImageFilter.h>
+#include <sitkGradientRecursiveGaussianImageFilter.h>
+#include <sitkLaplacianRecursiveGaussianImageFilter.h>
+#include <sitkSqrtImageFilter.h>
+#include <sitkSTAPLEImageFilter.h>
+#include <sitkSLICImageFilter.h>
+#include <sitkComposeImageFilter.h>
+#include <sitkVectorIndexSelectionCastImageFilter.h>
+#include <sitkVectorToPlanarImageFilter.h>
+#include <sitkPlanarToVectorImageFilter.h>
+#include <sitkAdditiveGaussianNoiseImageFilter.h>
+#include <sitkSaltAndPepperNoiseImageFilter.h>
+#include <sitkShotNoiseImageFilter.h>
+#include <sitkSpeckleNoiseImageFilter.h>
+#include <sitkResampler.h>
+#include <sitkResamplingOperator.h>
 
 #include "itkVectorImage.h"
 #include "itkVector.h"
@@ -76,6 +169,7 @@
 #include "itkMergeLabelMapFilter.h"
 #include "itkDiffeomorphicDemonsRegistrationFilter.h"
 #include "itkFastSymmetricForcesDemonsRegistrationFilter.h"
+#include "itkPhiloxRandomStream.h"
 
 #include "sitkShow.h"
 
@@ -83,9 +177,19 @@
 #include "sitkSimilarity3DTransform.h"
 #include "sitkAffineTransform.h"
 #include "sitkEuler2DTransform.h"
+#include "sitkTranslationTransform.h"
 #include "sitkSimilarity2DTransform.h"
 #include "sitkVersorTransform.h"
 #include "sitkScaleVersor3DTransform.h"
+#include "sitkCompositeTransform.h"
+#include "sitkBSplineTransform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <tuple>
 
 TEST(BasicFilter,FastSymmetricForcesDemonsRegistrationFilter_ENUMCHECK) {
   using ImageType = itk::Image<float,3>;
@@ -296,6 +400,87 @@ TEST(BasicFilter,CurvatureAnisotropicDiffusion_EstimateOptimalTimeStep) {
 
 }
 
+TEST(BasicFilters,Diffusion_InPlaceIterations) {
+  namespace sitk = itk::simple;
+
+  // a noisy sphere, with an anisotropic spacing
+  sitk::Image image( 40, 36, 12, sitk::sitkFloat32 );
+  image.SetSpacing( { 1.0, 1.0, 2.0 } );
+  for ( unsigned int z = 0; z < 12; ++z )
+    {
+    for ( unsigned int y = 0; y < 36; ++y )
+      {
+      for ( unsigned int x = 0; x < 40; ++x )
+        {
+        const int r2 = ( x - 20 ) * ( x - 20 ) + ( y - 18 ) * ( y - 18 ) + 4 * ( z - 6 ) * ( z - 6 );
+        const float noise = static_cast<float>( ( x * 7 + y * 13 + z * 29 ) % 11 ) - 5.0f;
+        image.SetPixelAsFloat( { x, y, z }, ( r2 < 144 ? 100.0f : 20.0f ) + noise );
+        }
+      }
+    }
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( sitk::Cast( a, sitk::sitkFloat64 ), sitk::Cast( b, sitk::sitkFloat64 ) ) ) );
+      return stats.GetMaximum();
+    };
+
+  // the explicit iterations are the iterations of the finite
+  // difference solver
+  sitk::GradientAnisotropicDiffusionImageFilter gradient;
+  EXPECT_FALSE ( gradient.GetInPlaceIterations() );
+  EXPECT_FALSE ( gradient.GetSinglePrecision() );
+  EXPECT_EQ ( 0.0, gradient.GetMaximumRMSError() );
+  gradient.SetTimeStep( 0.05 );
+  gradient.SetNumberOfIterations( 6 );
+  const sitk::Image expectedGradient = gradient.Execute( image );
+  EXPECT_EQ ( 6u, gradient.GetElapsedIterations() );
+  gradient.InPlaceIterationsOn();
+  EXPECT_LT ( maximumDifference( expectedGradient, gradient.Execute( image ) ), 1e-3 );
+  EXPECT_EQ ( 6u, gradient.GetElapsedIterations() );
+  EXPECT_GT ( gradient.GetRMSChange(), 0.0 );
+
+  sitk::CurvatureAnisotropicDiffusionImageFilter curvature;
+  curvature.SetTimeStep( 0.05 );
+  curvature.SetNumberOfIterations( 6 );
+  const sitk::Image expectedCurvature = curvature.Execute( image );
+  curvature.InPlaceIterationsOn();
+  EXPECT_LT ( maximumDifference( expectedCurvature, curvature.Execute( image ) ), 1e-3 );
+
+  // the curvature flow of an integer image
+  const sitk::Image integerImage = sitk::Cast( image, sitk::sitkInt16 );
+  sitk::CurvatureFlowImageFilter flow;
+  flow.SetNumberOfIterations( 6 );
+  const sitk::Image expectedFlow = flow.Execute( integerImage );
+  flow.InPlaceIterationsOn();
+  const sitk::Image explicitFlow = flow.Execute( integerImage );
+  EXPECT_EQ ( expectedFlow.GetPixelID(), explicitFlow.GetPixelID() );
+  EXPECT_LT ( maximumDifference( expectedFlow, explicitFlow ), 1e-6 );
+
+  // the iterations of a double image in single precision, and in place
+  const sitk::Image doubleImage = sitk::Cast( image, sitk::sitkFloat64 );
+  gradient.InPlaceIterationsOff();
+  const sitk::Image expectedDouble = gradient.Execute( doubleImage );
+  gradient.SinglePrecisionOn();
+  const sitk::Image singlePrecision = gradient.Execute( doubleImage );
+  EXPECT_EQ ( sitk::sitkFloat64, singlePrecision.GetPixelID() );
+  EXPECT_LT ( maximumDifference( expectedDouble, singlePrecision ), 1e-3 );
+  gradient.SinglePrecisionOff();
+  gradient.InPlaceIterationsOn();
+  const sitk::Image inPlace = gradient.Execute( sitk::Cast( image, sitk::sitkFloat64 ) );
+  EXPECT_LT ( maximumDifference( expectedDouble, inPlace ), 1e-9 );
+
+  // the iterations stop when the change is small
+  gradient.InPlaceIterationsOff();
+  gradient.SetNumberOfIterations( 200 );
+  gradient.SetMaximumRMSError( 0.05 );
+  gradient.Execute( image );
+  EXPECT_LT ( gradient.GetElapsedIterations(), 200u );
+  EXPECT_GT ( gradient.GetElapsedIterations(), 1u );
+  EXPECT_LT ( gradient.GetRMSChange(), 0.05 );
+}
+
 TEST(BasicFilters,ImageFilter) {
   namespace sitk = itk::simple;
 
@@ -525,21 +710,1932 @@ TEST(BasicFilters,Cast_UInt8) {
         }
 
     }
-    EXPECT_FALSE ( failed ) << "Cast failed, or could not take the hash of the imoge";
+    EXPECT_FALSE ( failed ) << "Cast failed, or could not take the hash of the imoge";
+
+}
+
+TEST(BasicFilters,HashImageFilter) {
+  itk::simple::HashImageFilter hasher;
+  std::string out = hasher.ToString();
+  EXPECT_TRUE ( out.find("itk::simple::HashImageFilter") != std::string::npos );
+  EXPECT_TRUE ( out.find("HashFunction: SHA1") != std::string::npos );
+  EXPECT_TRUE ( out.find("Debug:") != std::string::npos );
+  EXPECT_TRUE ( out.find("NumberOfThreads:") != std::string::npos );
+  EXPECT_EQ ( itk::simple::HashImageFilter::SHA1, hasher.SetHashFunction ( itk::simple::HashImageFilter::SHA1 ).GetHashFunction() );
+  EXPECT_EQ ( itk::simple::HashImageFilter::MD5, hasher.SetHashFunction ( itk::simple::HashImageFilter::MD5 ).GetHashFunction() );
+}
+
+
+TEST(BasicFilters,FusedStatistics) {
+  namespace sitk = itk::simple;
+
+  sitk::FusedStatisticsImageFilter filter;
+  EXPECT_EQ ( "FusedStatistics", filter.GetName() );
+  EXPECT_TRUE ( filter.ToString().find("itk::simple::FusedStatisticsImageFilter") != std::string::npos );
+  EXPECT_EQ ( 256u, filter.GetNumberOfHistogramBins() );
+  EXPECT_TRUE ( filter.GetAutoMinimumMaximum() );
+  EXPECT_THROW ( filter.ComputeThreshold( sitk::FusedStatisticsImageFilter::Otsu ), sitk::GenericException );
+  EXPECT_THROW ( filter.SetQuantiles( {0.5, 1.5} ), sitk::GenericException );
+
+  // the values 0 to 99
+  sitk::Image image( 10, 10, sitk::sitkFloat32 );
+  for ( unsigned int i = 0; i < 100; ++i )
+    {
+    image.SetPixelAsFloat( { i % 10, i / 10 }, static_cast<float>( i ) );
+    }
+
+  sitk::StatisticsImageFilter stats;
+  stats.Execute( image );
+
+  filter.SetNumberOfHistogramBins( 10 );
+  filter.SetQuantiles( {0.0, 0.5, 1.0} );
+  filter.Execute( image );
+  EXPECT_EQ ( stats.GetMinimum(), filter.GetMinimum() );
+  EXPECT_EQ ( stats.GetMaximum(), filter.GetMaximum() );
+  EXPECT_DOUBLE_EQ ( stats.GetMean(), filter.GetMean() );
+  EXPECT_NEAR ( stats.GetVariance(), filter.GetVariance(), 1e-8 );
+  EXPECT_NEAR ( stats.GetSigma(), filter.GetSigma(), 1e-8 );
+  EXPECT_DOUBLE_EQ ( stats.GetSum(), filter.GetSum() );
+  EXPECT_EQ ( 100u, filter.GetCount() );
+
+  std::vector<uint64_t> frequencies = filter.GetHistogramFrequencies();
+  ASSERT_EQ ( 10u, frequencies.size() );
+  EXPECT_EQ ( 100u, std::accumulate( frequencies.begin(), frequencies.end(), uint64_t(0) ) );
+  const std::vector<double> edges = filter.GetHistogramBinEdges();
+  ASSERT_EQ ( 11u, edges.size() );
+  EXPECT_DOUBLE_EQ ( 0.0, edges.front() );
+  EXPECT_DOUBLE_EQ ( 99.0, edges.back() );
+
+  const std::vector<double> quantiles = filter.GetQuantileValues();
+  ASSERT_EQ ( 3u, quantiles.size() );
+  EXPECT_DOUBLE_EQ ( 0.0, quantiles[0] );
+  EXPECT_NEAR ( 49.5, quantiles[1], 1.5 );
+  EXPECT_DOUBLE_EQ ( 99.0, quantiles[2] );
+
+  // a fixed range bins each pixel exactly, outside values are not binned
+  filter.AutoMinimumMaximumOff();
+  filter.SetHistogramMinimum( 0.0 );
+  filter.SetHistogramMaximum( 50.0 );
+  filter.Execute( image );
+  frequencies = filter.GetHistogramFrequencies();
+  EXPECT_EQ ( std::vector<uint64_t>( 9, 5u ), std::vector<uint64_t>( frequencies.begin(), frequencies.end() - 1 ) );
+  EXPECT_EQ ( 6u, frequencies.back() );
+  EXPECT_EQ ( 100u, filter.GetCount() );
+
+  // only the pixels of the mask
+  sitk::Image mask( 10, 10, sitk::sitkUInt8 );
+  for ( unsigned int y = 0; y < 10; ++y )
+    {
+    mask.SetPixelAsUInt8( { 0, y }, 1 );
+    }
+  filter.AutoMinimumMaximumOn();
+  filter.Execute( image, mask );
+  EXPECT_EQ ( 10u, filter.GetCount() );
+  EXPECT_EQ ( 0.0, filter.GetMinimum() );
+  EXPECT_EQ ( 90.0, filter.GetMaximum() );
+  EXPECT_DOUBLE_EQ ( 45.0, filter.GetMean() );
+
+  EXPECT_THROW ( filter.Execute( image, sitk::Image( 10, 10, sitk::sitkFloat32 ) ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( image, sitk::Image( 5, 10, sitk::sitkUInt8 ) ), sitk::GenericException );
+
+  // the threshold of two classes is between them
+  sitk::Image twoClasses( 32, 32, sitk::sitkUInt8 );
+  for ( unsigned int y = 0; y < 32; ++y )
+    {
+    for ( unsigned int x = 0; x < 32; ++x )
+      {
+      twoClasses.SetPixelAsUInt8( { x, y }, ( x < 16 ) ? 10 + y % 3 : 200 + y % 5 );
+      }
+    }
+  filter.SetNumberOfHistogramBins( 256 );
+  filter.Execute( twoClasses );
+  for ( auto method : { sitk::FusedStatisticsImageFilter::Otsu,
+                        sitk::FusedStatisticsImageFilter::Li,
+                        sitk::FusedStatisticsImageFilter::Huang,
+                        sitk::FusedStatisticsImageFilter::IsoData } )
+    {
+    const double threshold = filter.ComputeThreshold( method );
+    EXPECT_GE ( threshold, 12.0 ) << "method: " << method;
+    EXPECT_LT ( threshold, 200.0 ) << "method: " << method;
+    }
+
+  // a constant image
+  filter.Execute( sitk::Image( 8, 8, sitk::sitkInt16 ) );
+  EXPECT_EQ ( 0.0, filter.ComputeThreshold( sitk::FusedStatisticsImageFilter::Otsu ) );
+  EXPECT_EQ ( 64u, filter.GetHistogramFrequencies()[0] );
+}
+
+
+TEST(BasicFilters,MultiResolutionPyramid) {
+  namespace sitk = itk::simple;
+
+  sitk::MultiResolutionPyramidImageFilter filter;
+  EXPECT_EQ ( "MultiResolutionPyramid", filter.GetName() );
+  EXPECT_TRUE ( filter.ToString().find("itk::simple::MultiResolutionPyramidImageFilter") != std::string::npos );
+  EXPECT_EQ ( std::vector<unsigned int>({4, 2, 1}), filter.GetShrinkFactorsPerLevel() );
+  EXPECT_TRUE ( filter.GetSmoothingSigmasAreSpecifiedInPhysicalUnits() );
+
+  sitk::Image image( 70, 33, 12, sitk::sitkFloat32 );
+  for ( unsigned int z = 0; z < 12; ++z )
+    {
+    for ( unsigned int y = 0; y < 33; ++y )
+      {
+      for ( unsigned int x = 0; x < 70; ++x )
+        {
+        image.SetPixelAsFloat( { x, y, z }, static_cast<float>( ( x * 37 + y * y * 11 + z * 101 ) % 251 ) );
+        }
+      }
+    }
+  image.SetSpacing( { 0.5, 1.5, 2.0 } );
+  image.SetOrigin( { 1.0, -2.0, 3.0 } );
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( a, b ) ) );
+      return stats.GetMaximum();
+    };
+
+  // without smoothing, the levels are those of the BinShrinkImageFilter
+  filter.SetSmoothingSigmasPerLevel( { 0.0, 0.0, 0.0 } );
+  std::vector<sitk::Image> levels = filter.Execute( image );
+  ASSERT_EQ ( 3u, levels.size() );
+  const std::vector<unsigned int> factors = filter.GetShrinkFactorsPerLevel();
+  for ( unsigned int level = 0; level < levels.size(); ++level )
+    {
+    const unsigned int f = factors[level];
+    const sitk::Image expected = sitk::BinShrink( image, { f, f, f } );
+    EXPECT_EQ ( sitk::sitkFloat32, levels[level].GetPixelID() );
+    EXPECT_EQ ( expected.GetSize(), levels[level].GetSize() ) << "level: " << level;
+    EXPECT_VECTOR_DOUBLE_NEAR ( expected.GetOrigin(), levels[level].GetOrigin(), 1e-10 );
+    EXPECT_VECTOR_DOUBLE_NEAR ( expected.GetSpacing(), levels[level].GetSpacing(), 1e-10 );
+    EXPECT_LT ( maximumDifference( expected, levels[level] ), 1e-3 ) << "level: " << level;
+    }
+  EXPECT_EQ ( sitk::Hash( image ), sitk::Hash( levels[2] ) );
+
+  // the normalized smoothing of a constant image is constant
+  sitk::Image constant( 40, 20, 10, sitk::sitkUInt8 );
+  constant = sitk::Add( constant, 7 );
+  levels = sitk::MultiResolutionPyramid( constant, { 8, 3 }, { 3.0, 0.7 }, false );
+  ASSERT_EQ ( 2u, levels.size() );
+  EXPECT_EQ ( std::vector<unsigned int>({5, 2, 1}), levels[0].GetSize() );
+  EXPECT_EQ ( std::vector<unsigned int>({13, 6, 3}), levels[1].GetSize() );
+  for ( const sitk::Image &level : levels )
+    {
+    stats.Execute( level );
+    EXPECT_NEAR ( 7.0, stats.GetMinimum(), 1e-5 );
+    EXPECT_NEAR ( 7.0, stats.GetMaximum(), 1e-5 );
+    }
+
+  EXPECT_EQ ( sitk::sitkFloat64, sitk::MultiResolutionPyramid( sitk::Cast( constant, sitk::sitkFloat64 ), { 2 }, { 1.0 } )[0].GetPixelID() );
+  EXPECT_THROW ( sitk::MultiResolutionPyramid( constant, { 2, 1 }, { 1.0 } ), sitk::GenericException );
+  EXPECT_THROW ( sitk::MultiResolutionPyramid( constant, {}, {} ), sitk::GenericException );
+}
+
+TEST(BasicFilters,MultiProjection) {
+  namespace sitk = itk::simple;
+
+  sitk::MultiProjectionImageFilter filter;
+  EXPECT_EQ ( "MultiProjection", filter.GetName() );
+  EXPECT_TRUE ( filter.ToString().find("itk::simple::MultiProjectionImageFilter") != std::string::npos );
+  EXPECT_EQ ( 0u, filter.GetProjectionDimension() );
+  EXPECT_TRUE ( filter.GetComputeMedian() );
+  EXPECT_THROW ( filter.GetMaximumProjection(), sitk::GenericException );
+
+  // a volume with an odd and an even length
+  sitk::Image image( 70, 33, 12, sitk::sitkInt16 );
+  for ( unsigned int z = 0; z < 12; ++z )
+    {
+    for ( unsigned int y = 0; y < 33; ++y )
+      {
+      for ( unsigned int x = 0; x < 70; ++x )
+        {
+        image.SetPixelAsInt16( { x, y, z }, static_cast<int16_t>( ( x * 37 + y * y * 11 + z * 101 ) % 251 - 60 ) );
+        }
+      }
+    }
+  image.SetSpacing( { 0.5, 1.5, 2.0 } );
+
+  sitk::MaximumProjectionImageFilter maximum;
+  sitk::MinimumProjectionImageFilter minimum;
+  sitk::MedianProjectionImageFilter median;
+  sitk::MeanProjectionImageFilter mean;
+  sitk::SumProjectionImageFilter sum;
+  sitk::StandardDeviationProjectionImageFilter standardDeviation;
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( a, b ) ) );
+      return stats.GetMaximum();
+    };
+
+  // the projections of the projection filters, along each dimension
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkInt16, sitk::sitkFloat32 } )
+    {
+    const sitk::Image input = sitk::Cast( image, pixelType );
+    for ( unsigned int dimension = 0; dimension < 3; ++dimension )
+      {
+      filter.SetProjectionDimension( dimension );
+      filter.Execute( input );
+      maximum.SetProjectionDimension( dimension );
+      minimum.SetProjectionDimension( dimension );
+      median.SetProjectionDimension( dimension );
+      mean.SetProjectionDimension( dimension );
+      sum.SetProjectionDimension( dimension );
+      standardDeviation.SetProjectionDimension( dimension );
+
+      const sitk::Image expected = maximum.Execute( input );
+      EXPECT_EQ ( sitk::Hash( expected ), sitk::Hash( filter.GetMaximumProjection() ) ) << "dimension: " << dimension;
+      EXPECT_EQ ( expected.GetSize(), filter.GetMaximumProjection().GetSize() );
+      EXPECT_EQ ( expected.GetOrigin(), filter.GetMaximumProjection().GetOrigin() );
+      EXPECT_EQ ( expected.GetSpacing(), filter.GetMeanProjection().GetSpacing() );
+      EXPECT_EQ ( sitk::Hash( minimum.Execute( input ) ), sitk::Hash( filter.GetMinimumProjection() ) ) << "dimension: " << dimension;
+      EXPECT_EQ ( sitk::Hash( median.Execute( input ) ), sitk::Hash( filter.GetMedianProjection() ) ) << "dimension: " << dimension;
+      EXPECT_EQ ( mean.Execute( input ).GetPixelID(), filter.GetMeanProjection().GetPixelID() );
+      EXPECT_LT ( maximumDifference( mean.Execute( input ), filter.GetMeanProjection() ), 1e-10 );
+      EXPECT_LT ( maximumDifference( sum.Execute( input ), filter.GetSumProjection() ), 1e-8 );
+      EXPECT_LT ( maximumDifference( standardDeviation.Execute( input ), filter.GetStandardDeviationProjection() ), 1e-8 );
+      }
+    }
+
+  // only the selected projections are computed
+  filter.ComputeMedianOff();
+  filter.ComputeSumOff();
+  filter.Execute( image );
+  EXPECT_NO_THROW ( filter.GetMaximumProjection() );
+  EXPECT_THROW ( filter.GetMedianProjection(), sitk::GenericException );
+  EXPECT_THROW ( filter.GetSumProjection(), sitk::GenericException );
+
+  filter.SetProjectionDimension( 3 );
+  EXPECT_THROW ( filter.Execute( image ), sitk::GenericException );
+}
+
+TEST(BasicFilters,MultiChannelLabelStatistics) {
+  namespace sitk = itk::simple;
+
+  sitk::MultiChannelLabelStatisticsImageFilter filter;
+  EXPECT_EQ ( "MultiChannelLabelStatistics", filter.GetName() );
+  EXPECT_TRUE ( filter.ToString().find("itk::simple::MultiChannelLabelStatisticsImageFilter") != std::string::npos );
+
+  sitk::Image channel0( 16, 12, sitk::sitkFloat32 );
+  sitk::Image channel1( 16, 12, sitk::sitkFloat32 );
+  sitk::Image labels( 16, 12, sitk::sitkUInt16 );
+  for ( unsigned int y = 0; y < 12; ++y )
+    {
+    for ( unsigned int x = 0; x < 16; ++x )
+      {
+      channel0.SetPixelAsFloat( { x, y }, static_cast<float>( x * y ) );
+      channel1.SetPixelAsFloat( { x, y }, static_cast<float>( 100 - x - 3 * y ) );
+      labels.SetPixelAsUInt16( { x, y }, ( x < 4 ) ? 0 : ( y < 6 ) ? 7 : 1000 );
+      }
+    }
+
+  const std::vector<sitk::Image> channels = { channel0, channel1 };
+  sitk::Image vectorImage = sitk::Compose( channels );
+
+  auto check = [&]()
+    {
+      ASSERT_EQ ( 2u, filter.GetNumberOfChannels() );
+      EXPECT_EQ ( std::vector<int64_t>( {0, 7, 1000} ), filter.GetLabels() );
+      EXPECT_EQ ( 3u, filter.GetNumberOfLabels() );
+      EXPECT_TRUE ( filter.HasLabel( 7 ) );
+      EXPECT_FALSE ( filter.HasLabel( 8 ) );
+      EXPECT_THROW ( filter.GetMean( 8 ), sitk::GenericException );
+
+      for ( unsigned int c = 0; c < channels.size(); ++c )
+        {
+        sitk::LabelStatisticsImageFilter stats;
+        stats.Execute( channels[c], labels );
+        for ( int64_t label : filter.GetLabels() )
+          {
+          EXPECT_EQ ( stats.GetCount( label ), filter.GetCount( label ) );
+          EXPECT_EQ ( stats.GetMinimum( label ), filter.GetMinimum( label )[c] );
+          EXPECT_EQ ( stats.GetMaximum( label ), filter.GetMaximum( label )[c] );
+          EXPECT_NEAR ( stats.GetMean( label ), filter.GetMean( label )[c], 1e-8 );
+          EXPECT_NEAR ( stats.GetVariance( label ), filter.GetVariance( label )[c], 1e-6 );
+          EXPECT_NEAR ( stats.GetSigma( label ), filter.GetSigma( label )[c], 1e-8 );
+          EXPECT_NEAR ( stats.GetSum( label ), filter.GetSum( label )[c], 1e-6 );
+          }
+        }
+    };
+
+  filter.Execute( vectorImage, labels );
+  check();
+
+  filter.Execute( channels, labels );
+  check();
+
+  // a single scalar channel
+  filter.Execute( channel1, labels );
+  EXPECT_EQ ( 1u, filter.GetNumberOfChannels() );
+  EXPECT_EQ ( 64u, filter.GetCount( 0 ) );
+
+  EXPECT_THROW ( filter.Execute( std::vector<sitk::Image>(), labels ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( { channel0, sitk::Image( 16, 12, sitk::sitkInt32 ) }, labels ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( { channel0, sitk::Image( 16, 11, sitk::sitkFloat32 ) }, labels ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( channel0, sitk::Image( 16, 12, sitk::sitkFloat32 ) ), sitk::GenericException );
+}
+
+
+TEST(BasicFilters,LabelEvaluation) {
+  namespace sitk = itk::simple;
+
+  sitk::LabelEvaluationImageFilter filter;
+  EXPECT_EQ ( "LabelEvaluation", filter.GetName() );
+  EXPECT_TRUE ( filter.ToString().find("itk::simple::LabelEvaluationImageFilter") != std::string::npos );
+
+  sitk::Image reference( 30, 26, 20, sitk::sitkUInt8 );
+  sitk::Image prediction( 30, 26, 20, sitk::sitkUInt8 );
+  reference.SetSpacing( { 1.5, 1.0, 2.0 } );
+  prediction.SetSpacing( { 1.5, 1.0, 2.0 } );
+
+  auto box = []( sitk::Image &image, uint8_t label,
+                 std::vector<unsigned int> lower, std::vector<unsigned int> upper )
+    {
+      for ( unsigned int z = lower[2]; z < upper[2]; ++z )
+        {
+        for ( unsigned int y = lower[1]; y < upper[1]; ++y )
+          {
+          for ( unsigned int x = lower[0]; x < upper[0]; ++x )
+            {
+            image.SetPixelAsUInt8( { x, y, z }, label );
+            }
+          }
+        }
+    };
+
+  // label 1 is shifted by 2 pixels along x, label 2 is the same in both
+  // images and label 3 is only predicted
+  box( reference, 1, { 4, 5, 3 }, { 14, 15, 11 } );
+  box( prediction, 1, { 6, 5, 3 }, { 16, 15, 11 } );
+  box( reference, 2, { 18, 3, 12 }, { 26, 9, 18 } );
+  box( prediction, 2, { 18, 3, 12 }, { 26, 9, 18 } );
+  box( prediction, 3, { 20, 16, 2 }, { 25, 22, 6 } );
+
+  filter.Execute( reference, prediction );
+  EXPECT_EQ ( std::vector<int64_t>( {1, 2, 3} ), filter.GetLabels() );
+  EXPECT_EQ ( 3u, filter.GetNumberOfLabels() );
+  EXPECT_TRUE ( filter.HasLabel( 3 ) );
+  EXPECT_FALSE ( filter.HasLabel( 0 ) );
+  EXPECT_THROW ( filter.GetDiceCoefficient( 4 ), sitk::GenericException );
+
+  sitk::LabelOverlapMeasuresImageFilter overlap;
+  overlap.Execute( reference, prediction );
+  for ( int64_t label : { 1, 2 } )
+    {
+    EXPECT_NEAR ( overlap.GetDiceCoefficient( label ), filter.GetDiceCoefficient( label ), 1e-12 );
+    EXPECT_NEAR ( overlap.GetJaccardCoefficient( label ), filter.GetJaccardCoefficient( label ), 1e-12 );
+    }
+  EXPECT_NEAR ( 0.8, filter.GetDiceCoefficient( 1 ), 1e-12 );
+  EXPECT_NEAR ( 2.0 / 3.0, filter.GetJaccardCoefficient( 1 ), 1e-12 );
+  EXPECT_EQ ( 1.0, filter.GetVolumeSimilarity( 1 ) );
+
+  // the shift is 3 in physical units, which is also the Hausdorff
+  // distance of the pixels
+  sitk::HausdorffDistanceImageFilter hausdorff;
+  hausdorff.Execute( sitk::BinaryThreshold( reference, 1, 1, 1, 0 ), sitk::BinaryThreshold( prediction, 1, 1, 1, 0 ) );
+  EXPECT_NEAR ( 3.0, filter.GetHausdorffDistance( 1 ), 1e-6 );
+  EXPECT_NEAR ( hausdorff.GetHausdorffDistance(), filter.GetHausdorffDistance( 1 ), 1e-6 );
+  EXPECT_GT ( filter.GetHausdorffDistance95( 1 ), 0.0 );
+  EXPECT_LE ( filter.GetHausdorffDistance95( 1 ), filter.GetHausdorffDistance( 1 ) );
+
+  // the average distance of the contours, with distance maps of the
+  // whole image
+  sitk::Image referenceContour = sitk::LabelContour( reference );
+  sitk::Image predictionContour = sitk::LabelContour( prediction );
+  sitk::EuclideanDistanceMapImageFilter distance;
+  sitk::LabelStatisticsImageFilter stats;
+  double sum = 0.0;
+  double count = 0.0;
+  for ( const auto &contours : { std::make_pair( referenceContour, predictionContour ),
+                                 std::make_pair( predictionContour, referenceContour ) } )
+    {
+    stats.Execute( distance.Execute( sitk::BinaryThreshold( contours.second, 1, 1, 1, 0 ) ),
+                   sitk::BinaryThreshold( contours.first, 1, 1, 1, 0 ) );
+    sum += stats.GetSum( 1 );
+    count += stats.GetCount( 1 );
+    }
+  EXPECT_NEAR ( sum / count, filter.GetAverageSymmetricSurfaceDistance( 1 ), 1e-5 );
+
+  EXPECT_EQ ( 1.0, filter.GetDiceCoefficient( 2 ) );
+  EXPECT_EQ ( 1.0, filter.GetVolumeSimilarity( 2 ) );
+  EXPECT_EQ ( 0.0, filter.GetHausdorffDistance( 2 ) );
+  EXPECT_EQ ( 0.0, filter.GetHausdorffDistance95( 2 ) );
+  EXPECT_EQ ( 0.0, filter.GetAverageSymmetricSurfaceDistance( 2 ) );
+
+  EXPECT_EQ ( 0.0, filter.GetDiceCoefficient( 3 ) );
+  EXPECT_EQ ( 0.0, filter.GetVolumeSimilarity( 3 ) );
+  EXPECT_TRUE ( std::isinf( filter.GetHausdorffDistance( 3 ) ) );
+  EXPECT_TRUE ( std::isinf( filter.GetAverageSymmetricSurfaceDistance( 3 ) ) );
+
+  // the same measures with one thread
+  const double hd95 = filter.GetHausdorffDistance95( 1 );
+  const double assd = filter.GetAverageSymmetricSurfaceDistance( 1 );
+  filter.SetNumberOfThreads( 1 );
+  filter.Execute( reference, prediction );
+  EXPECT_EQ ( hd95, filter.GetHausdorffDistance95( 1 ) );
+  EXPECT_EQ ( assd, filter.GetAverageSymmetricSurfaceDistance( 1 ) );
+
+  // the distances in pixels, and bounded
+  filter.UseImageSpacingOff();
+  filter.Execute( reference, prediction );
+  EXPECT_NEAR ( 2.0, filter.GetHausdorffDistance( 1 ), 1e-6 );
+  filter.SetMaximumDistance( 1.0 );
+  filter.Execute( reference, prediction );
+  EXPECT_NEAR ( 1.0, filter.GetHausdorffDistance( 1 ), 1e-6 );
+  EXPECT_NEAR ( 0.8, filter.GetDiceCoefficient( 1 ), 1e-12 );
+
+  EXPECT_THROW ( filter.SetMaximumDistance( -1.0 ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( reference, sitk::Image( 30, 26, 19, sitk::sitkUInt8 ) ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( reference, sitk::Image( 30, 26, 20, sitk::sitkUInt16 ) ), sitk::GenericException );
+  EXPECT_THROW ( filter.Execute( sitk::Image( 30, 26, 20, sitk::sitkFloat32 ), sitk::Image( 30, 26, 20, sitk::sitkFloat32 ) ), sitk::GenericException );
+}
+
+
+TEST(BasicFilters,LabelMapConversions) {
+  namespace sitk = itk::simple;
+
+  // labels in runs of varying length across the lines, with holes of
+  // background
+  sitk::Image labels( 37, 29, 7, sitk::sitkUInt32 );
+  for ( unsigned int z = 0; z < 7; ++z )
+    {
+    for ( unsigned int y = 0; y < 29; ++y )
+      {
+      for ( unsigned int x = 0; x < 37; ++x )
+        {
+        const uint32_t label = ( ( x / ( 1 + y % 5 ) + z ) % 6 == 0 ) ? 0u : 1u + ( x * 7 + y * 3 + z ) % 11 + ( x / 9 ) * 100000;
+        labels.SetPixelAsUInt32( { x, y, z }, label );
+        }
+      }
+    }
+  const std::string hash = sitk::Hash( labels );
+
+  sitk::Image labelMap = sitk::Cast( labels, sitk::sitkLabelUInt32 );
+  ASSERT_EQ ( sitk::sitkLabelUInt32, labelMap.GetPixelID() );
+  EXPECT_EQ ( hash, sitk::Hash( sitk::Cast( labelMap, sitk::sitkUInt32 ) ) );
+
+  sitk::LabelImageToLabelMapFilter toLabelMap;
+  sitk::LabelMapToLabelImageFilter toLabelImage;
+  for ( unsigned int threads : { 1u, 3u, 8u } )
+    {
+    toLabelMap.SetNumberOfThreads( threads );
+    toLabelImage.SetNumberOfThreads( threads );
+    labelMap = toLabelMap.Execute( labels );
+    EXPECT_EQ ( hash, sitk::Hash( toLabelImage.Execute( labelMap ) ) ) << "threads: " << threads;
+    }
+
+  // the label map filters chain without a dense image
+  sitk::ChangeLabelLabelMapFilter change;
+  change.SetChangeMap( { { 1.0, 2.0 } } );
+  sitk::Image changed = toLabelImage.Execute( change.Execute( labelMap ) );
+  for ( unsigned int x = 0; x < 37; ++x )
+    {
+    const uint32_t label = labels.GetPixelAsUInt32( { x, 3, 2 } );
+    EXPECT_EQ ( label == 1u ? 2u : label, changed.GetPixelAsUInt32( { x, 3, 2 } ) );
+    }
+
+  // a background value of the label image
+  toLabelMap.SetBackgroundValue( 2.0 );
+  labelMap = toLabelMap.Execute( labels );
+  sitk::Image image = toLabelImage.Execute( labelMap );
+  for ( unsigned int x = 0; x < 37; ++x )
+    {
+    EXPECT_EQ ( labels.GetPixelAsUInt32( { x, 5, 4 } ), image.GetPixelAsUInt32( { x, 5, 4 } ) );
+    }
+}
+
+
+TEST(BasicFilters,ConnectedComponentRelabel) {
+  namespace sitk = itk::simple;
+
+  // blobs of several sizes, some touching only by a corner
+  sitk::Image image( 64, 48, 5, sitk::sitkUInt8 );
+  for ( unsigned int z = 0; z < 5; ++z )
+    {
+    for ( unsigned int y = 0; y < 48; ++y )
+      {
+      for ( unsigned int x = 0; x < 64; ++x )
+        {
+        const unsigned int h = ( x * 73856093u ) ^ ( y * 19349663u ) ^ ( z * 83492791u );
+        image.SetPixelAsUInt8( { x, y, z }, ( h % 7 < 3 ) ? 1 : 0 );
+        }
+      }
+    }
+
+  sitk::ConnectedComponentImageFilter connected;
+  sitk::RelabelComponentImageFilter relabel;
+  for ( bool fullyConnected : { false, true } )
+    {
+    connected.SetFullyConnected( fullyConnected );
+    connected.SortByObjectSizeOff();
+    connected.SetMinimumObjectSize( 0 );
+    connected.SetNumberOfObjectsToKeep( 0 );
+    sitk::Image components = connected.Execute( image );
+    const uint32_t numberOfComponents = connected.GetObjectCount();
+    EXPECT_EQ ( numberOfComponents, connected.GetOriginalObjectCount() );
+    ASSERT_GT ( numberOfComponents, 10u );
+
+    // the same result with the threads
+    connected.SetNumberOfThreads( 1 );
+    EXPECT_EQ ( sitk::Hash( components ), sitk::Hash( connected.Execute( image ) ) );
+    connected.SetNumberOfThreads( 7 );
+    EXPECT_EQ ( sitk::Hash( components ), sitk::Hash( connected.Execute( image ) ) );
+
+    // the fused relabeling is the same as the relabel filter
+    relabel.SetMinimumObjectSize( 4 );
+    sitk::Image relabeled = relabel.Execute( components );
+    connected.SortByObjectSizeOn();
+    connected.SetMinimumObjectSize( 4 );
+    EXPECT_EQ ( sitk::Hash( relabeled ), sitk::Hash( connected.Execute( image ) ) ) << "fully connected: " << fullyConnected;
+    EXPECT_EQ ( relabel.GetNumberOfObjects(), connected.GetObjectCount() );
+    EXPECT_EQ ( numberOfComponents, connected.GetOriginalObjectCount() );
+
+    // keep the largest objects
+    connected.SetNumberOfObjectsToKeep( 3 );
+    sitk::Image largest = connected.Execute( image );
+    EXPECT_EQ ( 3u, connected.GetObjectCount() );
+    for ( unsigned int z = 0; z < 5; ++z )
+      {
+      for ( unsigned int y = 0; y < 48; ++y )
+        {
+        for ( unsigned int x = 0; x < 64; ++x )
+          {
+          const uint32_t label = relabeled.GetPixelAsUInt32( { x, y, z } );
+          ASSERT_EQ ( label <= 3u ? label : 0u, largest.GetPixelAsUInt32( { x, y, z } ) );
+          }
+        }
+      }
+    }
+}
+
+
+TEST(BasicFilters,MorphologyAlgorithms) {
+  namespace sitk = itk::simple;
+
+  // a binary image of 0, 1 and other values, with objects on the border
+  sitk::Image image( 57, 43, sitk::sitkUInt8 );
+  for ( unsigned int y = 0; y < 43; ++y )
+    {
+    for ( unsigned int x = 0; x < 57; ++x )
+      {
+      const unsigned int h = ( x * 73856093u ) ^ ( y * 19349663u );
+      const bool blob = ( ( x - 20 ) * ( x - 20 ) + ( y - 15 ) * ( y - 15 ) < 120 ) || ( x > 45 && y > 30 );
+      image.SetPixelAsUInt8( { x, y }, blob ? 1 : ( h % 97 == 0 ) ? 1 : ( h % 31 == 0 ) ? 7 : 0 );
+      }
+    }
+
+  sitk::BinaryDilateImageFilter dilate;
+  sitk::BinaryErodeImageFilter erode;
+  EXPECT_EQ ( sitk::BinaryDilateImageFilter::Automatic, dilate.GetAlgorithm() );
+  for ( unsigned int radius : { 1u, 3u, 6u } )
+    {
+    for ( bool boundaryToForeground : { false, true } )
+      {
+      dilate.SetKernelRadius( radius );
+      dilate.SetBoundaryToForeground( boundaryToForeground );
+      dilate.SetAlgorithm( sitk::BinaryDilateImageFilter::StructuringElement );
+      const std::string expected = sitk::Hash( dilate.Execute( image ) );
+      dilate.SetAlgorithm( sitk::BinaryDilateImageFilter::DistanceMap );
+      EXPECT_EQ ( expected, sitk::Hash( dilate.Execute( image ) ) ) << "radius: " << radius;
+
+      erode.SetKernelRadius( radius );
+      erode.SetBoundaryToForeground( boundaryToForeground );
+      erode.SetBackgroundValue( 3.0 );
+      erode.SetAlgorithm( sitk::BinaryErodeImageFilter::StructuringElement );
+      const std::string expectedErode = sitk::Hash( erode.Execute( image ) );
+      erode.SetAlgorithm( sitk::BinaryErodeImageFilter::DistanceMap );
+      EXPECT_EQ ( expectedErode, sitk::Hash( erode.Execute( image ) ) ) << "radius: " << radius;
+      }
+    }
+
+  // the distance map requires an isotropic ball
+  dilate.SetKernelRadius( std::vector<unsigned int>{ 2, 3 } );
+  EXPECT_THROW ( dilate.Execute( image ), sitk::GenericException );
+  dilate.SetKernelType( sitk::sitkBox );
+  dilate.SetKernelRadius( 2 );
+  EXPECT_THROW ( dilate.Execute( image ), sitk::GenericException );
+  dilate.SetAlgorithm( sitk::BinaryDilateImageFilter::Automatic );
+  EXPECT_NO_THROW ( dilate.Execute( image ) );
+
+  // the grayscale algorithms have the same results for a box
+  sitk::Image gray = sitk::Cast( sitk::Multiply( image, 30 ), sitk::sitkFloat32 );
+  sitk::GrayscaleDilateImageFilter grayDilate;
+  grayDilate.SetKernelType( sitk::sitkBox );
+  grayDilate.SetKernelRadius( std::vector<unsigned int>{ 4, 2 } );
+  const std::string expected = sitk::Hash( grayDilate.Execute( gray ) );
+  for ( auto algorithm : { sitk::GrayscaleDilateImageFilter::Basic,
+                           sitk::GrayscaleDilateImageFilter::Histogram,
+                           sitk::GrayscaleDilateImageFilter::Anchor,
+                           sitk::GrayscaleDilateImageFilter::VanHerkGilWerman } )
+    {
+    grayDilate.SetAlgorithm( algorithm );
+    EXPECT_EQ ( expected, sitk::Hash( grayDilate.Execute( gray ) ) ) << "algorithm: " << algorithm;
+    }
+
+  sitk::GrayscaleMorphologicalOpeningImageFilter opening;
+  opening.SetKernelType( sitk::sitkBox );
+  opening.SetKernelRadius( 3 );
+  const std::string expectedOpening = sitk::Hash( opening.Execute( gray ) );
+  opening.SetAlgorithm( sitk::GrayscaleMorphologicalOpeningImageFilter::VanHerkGilWerman );
+  EXPECT_EQ ( expectedOpening, sitk::Hash( opening.Execute( gray ) ) );
+
+  // the anchor algorithm needs a decomposable kernel
+  opening.SetKernelType( sitk::sitkBall );
+  opening.SetAlgorithm( sitk::GrayscaleMorphologicalOpeningImageFilter::Anchor );
+  EXPECT_ANY_THROW ( opening.Execute( gray ) );
+}
+
+
+TEST(BasicFilters,MorphologicalWatershedParallelFlooding) {
+  namespace sitk = itk::simple;
+
+  // basins around three centers, with distinct values so that there
+  // are no plateaus
+  const unsigned int centers[3][3] = { { 8, 9, 1 }, { 30, 7, 3 }, { 19, 28, 5 } };
+  sitk::Image image( 40, 36, 6, sitk::sitkFloat32 );
+  sitk::Image markers( 40, 36, 6, sitk::sitkUInt32 );
+  for ( unsigned int z = 0; z < 6; ++z )
+    {
+    for ( unsigned int y = 0; y < 36; ++y )
+      {
+      for ( unsigned int x = 0; x < 40; ++x )
+        {
+        int distance = std::numeric_limits<int>::max();
+        for ( const auto &c : centers )
+          {
+          const int dx = int( x ) - int( c[0] ), dy = int( y ) - int( c[1] ), dz = int( z ) - int( c[2] );
+          distance = std::min( distance, dx * dx + dy * dy + 4 * dz * dz );
+          }
+        image.SetPixelAsFloat( { x, y, z }, float( distance * 8640 + ( z * 36 + y ) * 40 + x ) );
+        }
+      }
+    }
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    markers.SetPixelAsUInt32( { centers[i][0], centers[i][1], centers[i][2] }, 3 * i + 2 );
+    }
+
+  // without plateaus the flooding is the same as the default
+  sitk::MorphologicalWatershedFromMarkersImageFilter fromMarkers;
+  EXPECT_FALSE ( fromMarkers.GetParallelFlooding() );
+  fromMarkers.MarkWatershedLineOff();
+  const std::string expected = sitk::Hash( fromMarkers.Execute( image, markers ) );
+  fromMarkers.ParallelFloodingOn();
+  for ( unsigned int threads : { 1u, 3u, 7u } )
+    {
+    fromMarkers.SetNumberOfThreads( threads );
+    EXPECT_EQ ( expected, sitk::Hash( fromMarkers.Execute( image, markers ) ) ) << "threads: " << threads;
+    }
+
+  sitk::MorphologicalWatershedImageFilter watershed;
+  watershed.MarkWatershedLineOff();
+  const std::string expectedMinima = sitk::Hash( watershed.Execute( image ) );
+  watershed.ParallelFloodingOn();
+  EXPECT_EQ ( expectedMinima, sitk::Hash( watershed.Execute( image ) ) );
+
+  // the lines separate the labels, and with the plateaus of a coarse
+  // image the labels do not depend on the threads
+  sitk::Image coarse = sitk::Cast( sitk::Divide( image, 8640.0 * 16.0 ), sitk::sitkUInt8 );
+  for ( bool fullyConnected : { false, true } )
+    {
+    fromMarkers.MarkWatershedLineOn();
+    fromMarkers.SetFullyConnected( fullyConnected );
+    fromMarkers.SetNumberOfThreads( 1 );
+    sitk::Image labels = fromMarkers.Execute( coarse, markers );
+    fromMarkers.SetNumberOfThreads( 5 );
+    EXPECT_EQ ( sitk::Hash( labels ), sitk::Hash( fromMarkers.Execute( coarse, markers ) ) );
+
+    if ( !fullyConnected )
+      {
+      for ( unsigned int z = 0; z < 6; ++z )
+        {
+        for ( unsigned int y = 0; y < 36; ++y )
+          {
+          for ( unsigned int x = 0; x + 1 < 40; ++x )
+            {
+            const uint32_t a = labels.GetPixelAsUInt32( { x, y, z } );
+            const uint32_t b = labels.GetPixelAsUInt32( { x + 1, y, z } );
+            ASSERT_TRUE ( a == b || a == 0 || b == 0 );
+            }
+          }
+        }
+      }
+
+    watershed.SetFullyConnected( fullyConnected );
+    watershed.SetLevel( 2.0 );
+    watershed.MarkWatershedLineOn();
+    watershed.SetNumberOfThreads( 1 );
+    const std::string expectedLevel = sitk::Hash( watershed.Execute( coarse ) );
+    watershed.SetNumberOfThreads( 6 );
+    EXPECT_EQ ( expectedLevel, sitk::Hash( watershed.Execute( coarse ) ) );
+    }
+}
+
+
+TEST(BasicFilters,HistogramMedian) {
+  namespace sitk = itk::simple;
+
+  // the small integers use a moving histogram, which must match the
+  // median of the same values as floats
+  const std::vector<std::tuple<sitk::PixelIDValueEnum, int, int> > types = {
+    std::make_tuple( sitk::sitkUInt8, 0, 255 ),
+    std::make_tuple( sitk::sitkInt8, -128, 127 ),
+    std::make_tuple( sitk::sitkUInt16, 0, 65535 ),
+    std::make_tuple( sitk::sitkInt16, -32768, 32767 ),
+    std::make_tuple( sitk::sitkInt16, -7, 12 ) };
+
+  sitk::MedianImageFilter median;
+  for ( const auto &type : types )
+    {
+    const sitk::PixelIDValueEnum pixelID = std::get<0>( type );
+    const int minimum = std::get<1>( type );
+    const int maximum = std::get<2>( type );
+
+    sitk::Image floatImage( 31, 23, 11, sitk::sitkFloat32 );
+    for ( unsigned int z = 0; z < 11; ++z )
+      {
+      for ( unsigned int y = 0; y < 23; ++y )
+        {
+        for ( unsigned int x = 0; x < 31; ++x )
+          {
+          const unsigned int h = ( x * 73856093u ) ^ ( y * 19349663u ) ^ ( z * 83492791u );
+          floatImage.SetPixelAsFloat( { x, y, z }, static_cast<float>( minimum + static_cast<int>( h % ( maximum - minimum + 1 ) ) ) );
+          }
+        }
+      }
+    const sitk::Image image = sitk::Cast( floatImage, pixelID );
+
+    for ( const std::vector<unsigned int> &radius : { std::vector<unsigned int>{ 1, 1, 1 },
+                                                      std::vector<unsigned int>{ 3, 3, 3 },
+                                                      std::vector<unsigned int>{ 5, 1, 0 },
+                                                      std::vector<unsigned int>{ 0, 2, 7 },
+                                                      std::vector<unsigned int>{ 40, 1, 1 } } )
+      {
+      median.SetRadius( radius );
+      const sitk::Image expected = sitk::Cast( median.Execute( floatImage ), pixelID );
+      const sitk::Image result = median.Execute( image );
+      EXPECT_EQ ( pixelID, result.GetPixelID() );
+      EXPECT_EQ ( sitk::Hash( expected ), sitk::Hash( result ) ) << "pixel: " << sitk::GetPixelIDValueAsString( pixelID )
+                                                                 << " radius: " << radius[0] << ", " << radius[1] << ", " << radius[2];
+      }
+    }
+
+  // the components of the vector images
+  const sitk::Image channel = sitk::Cast( sitk::ReadImage( dataFinder.GetFile( "Input/RA-Short.nrrd" ) ), sitk::sitkUInt16 );
+  const sitk::Image vectorImage = sitk::Compose( channel, sitk::InvertIntensity( channel, 65535 ) );
+  median.SetRadius( 2 );
+  const sitk::Image vectorResult = median.Execute( vectorImage );
+  EXPECT_EQ ( sitk::sitkVectorUInt16, vectorResult.GetPixelID() );
+  EXPECT_EQ ( sitk::Hash( median.Execute( sitk::InvertIntensity( channel, 65535 ) ) ),
+              sitk::Hash( sitk::VectorIndexSelectionCast( vectorResult, 1 ) ) );
+}
+
+
+TEST(BasicFilters,VectorImageComponents) {
+  namespace sitk = itk::simple;
+
+  // a vector image of odd size with four components
+  std::vector<sitk::Image> channels;
+  for ( unsigned int c = 0; c < 4; ++c )
+    {
+    sitk::Image channel( 37, 29, 5, sitk::sitkFloat32 );
+    for ( unsigned int z = 0; z < 5; ++z )
+      {
+      for ( unsigned int y = 0; y < 29; ++y )
+        {
+        for ( unsigned int x = 0; x < 37; ++x )
+          {
+          channel.SetPixelAsFloat( { x, y, z }, static_cast<float>( ( x * ( c + 3 ) + y * 7 + z * 13 ) % 17 ) - 8.0f );
+          }
+        }
+      }
+    channel.SetOrigin( { 1.0, -2.0, 3.5 } );
+    channel.SetSpacing( { 0.5, 1.0, 2.0 } );
+    channels.push_back( channel );
+    }
+  const sitk::Image image = sitk::Compose( channels );
+
+  // each component of the output is the output of its component
+  sitk::AbsImageFilter abs;
+  sitk::MeanProjectionImageFilter projection;
+  projection.SetProjectionDimension( 1 );
+  sitk::ShiftScaleImageFilter shiftScale;
+  shiftScale.SetShift( 2.0 );
+  shiftScale.SetScale( 3.0 );
+  for ( const unsigned int threads : { 1u, 3u } )
+    {
+    abs.SetNumberOfThreads( threads );
+    projection.SetNumberOfThreads( threads );
+    shiftScale.SetNumberOfThreads( threads );
+    const sitk::Image absolute = abs.Execute( image );
+    const sitk::Image projected = projection.Execute( image );
+    const sitk::Image shifted = shiftScale.Execute( image );
+    EXPECT_EQ ( image.GetOrigin(), absolute.GetOrigin() );
+    EXPECT_EQ ( image.GetSpacing(), absolute.GetSpacing() );
+    EXPECT_EQ ( 4u, projected.GetNumberOfComponentsPerPixel() );
+    for ( unsigned int c = 0; c < 4; ++c )
+      {
+      EXPECT_EQ ( sitk::Hash( abs.Execute( channels[c] ) ), sitk::Hash( sitk::VectorIndexSelectionCast( absolute, c ) ) );
+      EXPECT_EQ ( sitk::Hash( projection.Execute( channels[c] ) ), sitk::Hash( sitk::VectorIndexSelectionCast( projected, c ) ) );
+      EXPECT_EQ ( sitk::Hash( shiftScale.Execute( channels[c] ) ), sitk::Hash( sitk::VectorIndexSelectionCast( shifted, c ) ) );
+      }
+    }
+}
+
+TEST(BasicFilters,PlanarImage) {
+  namespace sitk = itk::simple;
+
+  // a vector image of odd size with three components
+  std::vector<sitk::Image> channels;
+  for ( unsigned int c = 0; c < 3; ++c )
+    {
+    sitk::Image channel( 37, 29, 5, sitk::sitkInt16 );
+    for ( unsigned int z = 0; z < 5; ++z )
+      {
+      for ( unsigned int y = 0; y < 29; ++y )
+        {
+        for ( unsigned int x = 0; x < 37; ++x )
+          {
+          channel.SetPixelAsInt16( { x, y, z }, static_cast<int16_t>( ( x * ( c + 3 ) + y * 7 + z * 13 ) % 101 ) - 50 );
+          }
+        }
+      }
+    channel.SetOrigin( { 1.0, -2.0, 3.5 } );
+    channel.SetSpacing( { 0.5, 1.0, 2.0 } );
+    channels.push_back( channel );
+    }
+  const sitk::Image image = sitk::Compose( channels );
+
+  for ( const unsigned int threads : { 1u, 3u } )
+    {
+    sitk::VectorToPlanarImageFilter toPlanar;
+    toPlanar.SetNumberOfThreads( threads );
+    const sitk::Image planar = toPlanar.Execute( image );
+    ASSERT_EQ ( 4u, planar.GetDimension() );
+    EXPECT_EQ ( sitk::sitkInt16, planar.GetPixelID() );
+    EXPECT_EQ ( std::vector<unsigned int>( { 37, 29, 5, 3 } ), planar.GetSize() );
+    EXPECT_EQ ( std::vector<double>( { 1.0, -2.0, 3.5, 0.0 } ), planar.GetOrigin() );
+    EXPECT_EQ ( std::vector<double>( { 0.5, 1.0, 2.0, 1.0 } ), planar.GetSpacing() );
+
+    // each component is a contiguous plane of the buffer
+    const int16_t *buffer = planar.GetBufferAsInt16();
+    const size_t numberOfPixels = 37 * 29 * 5;
+    for ( unsigned int c = 0; c < 3; ++c )
+      {
+      const int16_t *channel = channels[c].GetBufferAsInt16();
+      EXPECT_TRUE ( std::equal( channel, channel + numberOfPixels, buffer + c * numberOfPixels ) ) << "component " << c;
+      }
+
+    sitk::PlanarToVectorImageFilter toVector;
+    toVector.SetNumberOfThreads( threads );
+    const sitk::Image vector = toVector.Execute( planar );
+    EXPECT_EQ ( sitk::sitkVectorInt16, vector.GetPixelID() );
+    EXPECT_EQ ( image.GetOrigin(), vector.GetOrigin() );
+    EXPECT_EQ ( image.GetSpacing(), vector.GetSpacing() );
+    EXPECT_EQ ( image.GetDirection(), vector.GetDirection() );
+    EXPECT_EQ ( sitk::Hash( image ), sitk::Hash( vector ) );
+    }
+
+  // the planar image of a 2D vector image, and the dimensions which
+  // are not supported
+  const sitk::Image slice = sitk::Extract( image, std::vector<unsigned int>( { 37, 29, 0 } ), std::vector<int>( { 0, 0, 2 } ) );
+  const sitk::Image planarSlice = sitk::VectorToPlanar( slice );
+  EXPECT_EQ ( std::vector<unsigned int>( { 37, 29, 3 } ), planarSlice.GetSize() );
+  EXPECT_EQ ( sitk::Hash( slice ), sitk::Hash( sitk::PlanarToVector( planarSlice ) ) );
+  EXPECT_THROW ( sitk::PlanarToVector( sitk::Image( 37, 29, sitk::sitkInt16 ) ), sitk::GenericException );
+  EXPECT_THROW ( sitk::VectorToPlanar( channels[0] ), sitk::GenericException );
+}
+
+namespace
+{
+// the hashes of the outputs of a noise filter for one and three threads
+template <class TFilter>
+void CheckCounterBasedNoise( TFilter &filter, const itk::simple::Image &image )
+{
+  namespace sitk = itk::simple;
+
+  filter.SetSeed( 123u );
+  filter.UseCounterBasedGeneratorOn();
+  filter.SetNumberOfThreads( 1 );
+  const std::string hash = sitk::Hash( filter.Execute( image ) );
+  filter.SetNumberOfThreads( 3 );
+  EXPECT_EQ ( hash, sitk::Hash( filter.Execute( image ) ) ) << filter.GetName();
+  filter.SetSeed( 124u );
+  EXPECT_NE ( hash, sitk::Hash( filter.Execute( image ) ) ) << filter.GetName();
+}
+}
+
+TEST(BasicFilters,Noise_CounterBasedGenerator) {
+  namespace sitk = itk::simple;
+
+  // the known answers of the Philox4x32-10 generator
+  const uint32_t zeroCounter[4] = { 0, 0, 0, 0 };
+  const uint32_t zeroKey[2] = { 0, 0 };
+  const uint32_t piCounter[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  const uint32_t piKey[2] = { 0xa4093822, 0x299f31d0 };
+  uint32_t words[4];
+  itk::PhiloxRandomStream::Generate( zeroCounter, zeroKey, words );
+  EXPECT_EQ ( std::vector<uint32_t>( { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } ), std::vector<uint32_t>( words, words + 4 ) );
+  itk::PhiloxRandomStream::Generate( piCounter, piKey, words );
+  EXPECT_EQ ( std::vector<uint32_t>( { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } ), std::vector<uint32_t>( words, words + 4 ) );
+
+  sitk::Image image( 67, 51, 3, sitk::sitkFloat32 );
+  image = sitk::Add( image, 20.0 );
+
+  sitk::AdditiveGaussianNoiseImageFilter gaussian;
+  gaussian.SetStandardDeviation( 2.0 );
+  CheckCounterBasedNoise( gaussian, image );
+  sitk::SaltAndPepperNoiseImageFilter saltAndPepper;
+  saltAndPepper.SetProbability( 0.1 );
+  CheckCounterBasedNoise( saltAndPepper, image );
+  sitk::ShotNoiseImageFilter shot;
+  CheckCounterBasedNoise( shot, image );
+  shot.SetScale( 10.0 );
+  CheckCounterBasedNoise( shot, image );
+  sitk::SpeckleNoiseImageFilter speckle;
+  speckle.SetStandardDeviation( 0.5 );
+  CheckCounterBasedNoise( speckle, image );
+
+  // the distribution of the Gaussian noise
+  gaussian.SetSeed( 123u );
+  sitk::StatisticsImageFilter stats;
+  stats.Execute( sitk::Subtract( gaussian.Execute( image ), image ) );
+  EXPECT_NEAR ( 0.0, stats.GetMean(), 0.1 );
+  EXPECT_NEAR ( 2.0, std::sqrt( stats.GetVariance() ), 0.1 );
+
+  // the speckle noise is multiplicative of mean 1
+  speckle.SetSeed( 123u );
+  stats.Execute( speckle.Execute( image ) );
+  EXPECT_NEAR ( 20.0, stats.GetMean(), 0.5 );
+  EXPECT_NEAR ( 10.0, std::sqrt( stats.GetVariance() ), 0.5 );
+}
+
+
+TEST(BasicFilters,EuclideanDistanceMap) {
+  namespace sitk = itk::simple;
+
+  sitk::Image image( 47, 39, 13, sitk::sitkUInt8 );
+  for ( unsigned int z = 0; z < 13; ++z )
+    {
+    for ( unsigned int y = 0; y < 39; ++y )
+      {
+      for ( unsigned int x = 0; x < 47; ++x )
+        {
+        const unsigned int h = ( x * 73856093u ) ^ ( y * 19349663u ) ^ ( z * 83492791u );
+        const bool blob = ( x - 30 ) * ( x - 30 ) + ( y - 12 ) * ( y - 12 ) + ( z - 6 ) * ( z - 6 ) < 50;
+        image.SetPixelAsUInt8( { x, y, z }, ( blob || h % 401 == 0 ) ? 1 : 0 );
+        }
+      }
+    }
+  image.SetSpacing( { 0.7, 1.3, 2.5 } );
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( a, b ) ) );
+      return stats.GetMaximum();
+    };
+
+  // the distances of the background to the object are the positive
+  // distances of the Maurer distance map to the border of the object
+  sitk::SignedMaurerDistanceMapImageFilter maurer;
+  maurer.SetUseImageSpacing( true );
+  maurer.SetSquaredDistance( false );
+  const sitk::Image outside = sitk::Maximum( maurer.Execute( image ), 0.0 );
+
+  sitk::EuclideanDistanceMapImageFilter distance;
+  EXPECT_FALSE ( distance.GetSignedDistance() );
+  EXPECT_TRUE ( distance.GetUseImageSpacing() );
+  sitk::Image unsignedDistance = distance.Execute( image );
+  EXPECT_EQ ( sitk::sitkFloat32, unsignedDistance.GetPixelID() );
+  EXPECT_LT ( maximumDifference( outside, unsignedDistance ), 1e-4 );
+
+  distance.SetSquaredDistance( true );
+  EXPECT_LT ( maximumDifference( sitk::Multiply( outside, outside ), distance.Execute( image ) ), 1e-3 );
+  distance.SetSquaredDistance( false );
+
+  // the object has the distances to the background
+  distance.SetBackgroundValue( 1.0 );
+  const sitk::Image inside = distance.Execute( image );
+  distance.SetBackgroundValue( 0.0 );
+  distance.SetSignedDistance( true );
+  EXPECT_LT ( maximumDifference( sitk::Subtract( unsignedDistance, inside ), distance.Execute( image ) ), 1e-6 );
+  distance.SetInsideIsPositive( true );
+  EXPECT_LT ( maximumDifference( sitk::Subtract( inside, unsignedDistance ), distance.Execute( image ) ), 1e-6 );
+
+  // the bounded distances are the same up to the bound
+  distance.SetSignedDistance( false );
+  distance.SetMaximumDistance( 4.0 );
+  EXPECT_EQ ( sitk::Hash( sitk::Minimum( unsignedDistance, 4.0 ) ), sitk::Hash( distance.Execute( image ) ) );
+
+  distance.SetMaximumDistance( -1.0 );
+  EXPECT_THROW ( distance.Execute( image ), sitk::GenericException );
+}
+
+
+TEST(BasicFilters,ScalarChanAndVeseSparseLevelSet) {
+  namespace sitk = itk::simple;
+
+  sitk::Image seed = sitk::ReadImage( dataFinder.GetFile( "Input/cthead1-ls-seed.nrrd" ), sitk::sitkFloat32 );
+  sitk::Image feature = sitk::ReadImage( dataFinder.GetFile( "Input/cthead1-Float.mha" ), sitk::sitkFloat32 );
+
+  sitk::ScalarChanAndVeseSparseLevelSetImageFilter sparse;
+  EXPECT_EQ ( sitk::ScalarChanAndVeseSparseLevelSetImageFilter::AtanRegularizedHeaviside, sparse.GetHeavisideStepFunction() );
+  sparse.SetNumberOfIterations( 5u );
+
+  sitk::Image output = sparse.Execute( seed, feature );
+  EXPECT_EQ ( seed.GetSize(), output.GetSize() );
+  EXPECT_EQ ( seed.GetPixelID(), output.GetPixelID() );
+  EXPECT_VECTOR_DOUBLE_NEAR ( seed.GetOrigin(), output.GetOrigin(), 1e-8 );
+  EXPECT_LE ( sparse.GetElapsedIterations(), 5u );
+  EXPECT_GT ( sparse.GetElapsedIterations(), 0u );
+
+  sparse.SetNumberOfIterations( 0u );
+  EXPECT_NO_THROW ( sparse.Execute( seed, feature ) );
+  EXPECT_EQ ( 0u, sparse.GetElapsedIterations() );
+}
+
+
+TEST(BasicFilters,FastMarchingAlgorithms) {
+  namespace sitk = itk::simple;
+
+  // a speed image of smooth variations, with an anisotropic spacing
+  sitk::Image speed( 67, 53, 11, sitk::sitkFloat32 );
+  for ( unsigned int z = 0; z < 11; ++z )
+    {
+    for ( unsigned int y = 0; y < 53; ++y )
+      {
+      for ( unsigned int x = 0; x < 67; ++x )
+        {
+        speed.SetPixelAsFloat( { x, y, z }, static_cast<float>( 1.5 + std::sin( 0.2 * x ) * std::cos( 0.3 * y ) + 0.05 * z ) );
+        }
+      }
+    }
+  speed.SetSpacing( { 0.8, 1.1, 2.0 } );
+
+  sitk::FastMarchingImageFilter fastMarching;
+  EXPECT_EQ ( sitk::FastMarchingImageFilter::FastMarching, fastMarching.GetAlgorithm() );
+  fastMarching.AddTrialPoint( { 10, 20, 5 } );
+  fastMarching.AddTrialPoint( { 50, 40, 2, 3 } );
+  const sitk::Image expected = fastMarching.Execute( speed );
+
+  fastMarching.SetAlgorithm( sitk::FastMarchingImageFilter::FastIterativeMethod );
+  const sitk::Image output = fastMarching.Execute( speed );
+  EXPECT_EQ ( expected.GetPixelID(), output.GetPixelID() );
+
+  sitk::StatisticsImageFilter stats;
+  stats.Execute( expected );
+  const double maximum = stats.GetMaximum();
+  stats.Execute( sitk::Abs( sitk::Subtract( expected, output ) ) );
+  EXPECT_LT ( stats.GetMaximum(), 1e-4 * maximum );
+  EXPECT_FLOAT_EQ ( 0.0f, output.GetPixelAsFloat( { 10, 20, 5 } ) );
+  EXPECT_FLOAT_EQ ( 3.0f, output.GetPixelAsFloat( { 50, 40, 2 } ) );
+
+  // the pixels beyond the stopping value are not reached
+  fastMarching.SetStoppingValue( 5.0 );
+  const sitk::Image stopped = fastMarching.Execute( speed );
+  EXPECT_NEAR ( expected.GetPixelAsFloat( { 12, 21, 5 } ), stopped.GetPixelAsFloat( { 12, 21, 5 } ), 1e-4 );
+  EXPECT_GT ( stopped.GetPixelAsFloat( { 66, 0, 10 } ), 1e30f );
+}
+
+
+TEST(BasicFilters,BilateralGrid) {
+  namespace sitk = itk::simple;
+
+  // a step edge with a deterministic noise
+  sitk::Image image( 80, 60, sitk::sitkFloat32 );
+  for ( unsigned int y = 0; y < 60; ++y )
+    {
+    for ( unsigned int x = 0; x < 80; ++x )
+      {
+      const double noise = 10.0 * std::sin( 12.9898 * x + 78.233 * y + 0.5 * x * y );
+      image.SetPixelAsFloat( { x, y }, static_cast<float>( ( x < 40 ? 100.0 : 200.0 ) + noise ) );
+      }
+    }
+
+  sitk::BilateralImageFilter bilateral;
+  EXPECT_EQ ( sitk::BilateralImageFilter::Neighborhood, bilateral.GetAlgorithm() );
+  bilateral.SetDomainSigma( 3.0 );
+  bilateral.SetRangeSigma( 20.0 );
+  const sitk::Image expected = bilateral.Execute( image );
+
+  bilateral.SetAlgorithm( sitk::BilateralImageFilter::BilateralGrid );
+  const sitk::Image output = bilateral.Execute( image );
+  EXPECT_EQ ( expected.GetPixelID(), output.GetPixelID() );
+
+  // the approximation is close to the exact filter, and keeps the edge
+  sitk::StatisticsImageFilter stats;
+  stats.Execute( sitk::Abs( sitk::Subtract( expected, output ) ) );
+  EXPECT_LT ( stats.GetMean(), 1.5 );
+  EXPECT_NEAR ( 100.0, output.GetPixelAsFloat( { 38, 30 } ), 5.0 );
+  EXPECT_NEAR ( 200.0, output.GetPixelAsFloat( { 41, 30 } ), 5.0 );
+
+  // a constant image is unchanged, for the components of a vector image
+  const sitk::Image component = sitk::Add( sitk::Image( 31, 17, 9, sitk::sitkUInt8 ), 7.0 );
+  const sitk::Image constant = sitk::Compose( component, component, component );
+  const sitk::Image filtered = bilateral.Execute( constant );
+  EXPECT_EQ ( sitk::Hash( constant ), sitk::Hash( filtered ) );
+}
+
+TEST(BasicFilters,DiscreteGaussian_Algorithm) {
+  namespace sitk = itk::simple;
+
+  // a square, with an anisotropic spacing
+  sitk::Image image( 64, 48, sitk::sitkFloat32 );
+  image.SetSpacing( { 1.0, 0.5 } );
+  for ( unsigned int y = 12; y < 36; ++y )
+    {
+    for ( unsigned int x = 20; x < 44; ++x )
+      {
+      image.SetPixelAsFloat( { x, y }, 100.0f );
+      }
+    }
+
+  sitk::DiscreteGaussianImageFilter gaussian;
+  EXPECT_EQ ( sitk::DiscreteGaussianImageFilter::FIR, gaussian.GetAlgorithm() );
+  gaussian.SetVariance( 4.0 );
+  gaussian.SetMaximumError( 0.001 );
+  gaussian.SetMaximumKernelWidth( 128u );
+  const sitk::Image expected = gaussian.Execute( image );
+
+  // the approximations are close to the discrete kernels
+  sitk::StatisticsImageFilter stats;
+  for ( auto algorithm : { sitk::DiscreteGaussianImageFilter::IIR,
+                           sitk::DiscreteGaussianImageFilter::BoxCascade,
+                           sitk::DiscreteGaussianImageFilter::FFT,
+                           sitk::DiscreteGaussianImageFilter::Automatic } )
+    {
+    gaussian.SetAlgorithm( algorithm );
+    const sitk::Image output = gaussian.Execute( image );
+    EXPECT_EQ ( expected.GetPixelID(), output.GetPixelID() );
+    stats.Execute( sitk::Abs( sitk::Subtract( expected, output ) ) );
+    EXPECT_LT ( stats.GetMean(), 0.5 ) << "Algorithm: " << algorithm;
+    EXPECT_LT ( stats.GetMaximum(), 2.0 ) << "Algorithm: " << algorithm;
+    }
+
+  // the small kernels are the discrete kernels
+  EXPECT_EQ ( sitk::Hash( sitk::DiscreteGaussian( image, 1.0 ) ),
+              sitk::Hash( sitk::DiscreteGaussian( image, 1.0, 32u, 0.01, true, sitk::DiscreteGaussianImageFilter::Automatic ) ) );
+
+  // a constant image of integers is unchanged
+  const sitk::Image constant = sitk::Add( sitk::Image( 31, 17, 9, sitk::sitkUInt8 ), 7.0 );
+  for ( auto algorithm : { sitk::DiscreteGaussianImageFilter::IIR,
+                           sitk::DiscreteGaussianImageFilter::BoxCascade,
+                           sitk::DiscreteGaussianImageFilter::FFT } )
+    {
+    gaussian.SetAlgorithm( algorithm );
+    EXPECT_EQ ( sitk::Hash( constant ), sitk::Hash( gaussian.Execute( constant ) ) ) << "Algorithm: " << algorithm;
+    }
+}
+
+TEST(BasicFilters,Convolution_PreparedKernel) {
+  namespace sitk = itk::simple;
+
+  sitk::Image image( 64, 50, sitk::sitkFloat32 );
+  for ( unsigned int y = 0; y < 50; ++y )
+    {
+    for ( unsigned int x = 0; x < 64; ++x )
+      {
+      image.SetPixelAsFloat( { x, y }, static_cast<float>( ( x * 7 + y * y ) % 23 ) );
+      }
+    }
+  sitk::GaussianImageSource source;
+  source.SetOutputPixelType( sitk::sitkFloat32 );
+  source.SetSize( { 15, 15 } );
+  source.SetMean( { 7.0, 7.0 } );
+  source.SetSigma( { 3.0, 3.0 } );
+  sitk::Image kernel = source.Execute();
+  source.SetSize( { 3, 3 } );
+  source.SetMean( { 1.0, 1.0 } );
+  const sitk::Image smallKernel = source.Execute();
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( a, b ) ) );
+      return stats.GetMaximum();
+    };
+
+  // the kept spectrum of the kernel gives the same convolutions
+  sitk::FFTConvolutionImageFilter fftConvolution;
+  fftConvolution.NormalizeOn();
+  const sitk::Image expected = fftConvolution.Execute( image, kernel );
+  fftConvolution.ReuseITKFilterOn();
+  EXPECT_EQ ( sitk::Hash( expected ), sitk::Hash( fftConvolution.Execute( image, kernel ) ) );
+  EXPECT_EQ ( sitk::Hash( expected ), sitk::Hash( fftConvolution.Execute( image, kernel ) ) );
+  EXPECT_EQ ( sitk::Hash( expected ), sitk::Hash( fftConvolution.Execute( sitk::Image( image ), sitk::Image( kernel ) ) ) );
+
+  // a changed kernel, image size or normalization is prepared again
+  const sitk::Image otherImage = sitk::RegionOfInterest( image, { 40, 30 }, { 3, 5 } );
+  kernel.SetPixelAsFloat( { 2, 9 }, 0.5f );
+  sitk::FFTConvolutionImageFilter fresh;
+  fresh.NormalizeOn();
+  EXPECT_EQ ( sitk::Hash( fresh.Execute( image, kernel ) ), sitk::Hash( fftConvolution.Execute( image, kernel ) ) );
+  EXPECT_EQ ( sitk::Hash( fresh.Execute( otherImage, kernel ) ), sitk::Hash( fftConvolution.Execute( otherImage, kernel ) ) );
+  fresh.NormalizeOff();
+  fftConvolution.NormalizeOff();
+  EXPECT_EQ ( sitk::Hash( fresh.Execute( otherImage, kernel ) ), sitk::Hash( fftConvolution.Execute( otherImage, kernel ) ) );
+
+  // the automatic method keeps the spatial convolution of the small
+  // kernels, and gives the FFT convolution of the large ones
+  sitk::ConvolutionImageFilter convolution;
+  EXPECT_FALSE ( convolution.GetAutomaticFFT() );
+  convolution.NormalizeOn();
+  const sitk::Image spatial = convolution.Execute( image, kernel );
+  const sitk::Image smallSpatial = convolution.Execute( image, smallKernel );
+  convolution.AutomaticFFTOn();
+  EXPECT_EQ ( sitk::Hash( smallSpatial ), sitk::Hash( convolution.Execute( image, smallKernel ) ) );
+  const sitk::Image automatic = convolution.Execute( image, kernel );
+  EXPECT_LT ( maximumDifference( spatial, automatic ), 1e-4 );
+  fresh.NormalizeOn();
+  EXPECT_EQ ( sitk::Hash( fresh.Execute( image, kernel ) ), sitk::Hash( automatic ) );
+
+  convolution.SetOutputRegionMode( sitk::ConvolutionImageFilter::VALID );
+  convolution.ReuseITKFilterOn();
+  const sitk::Image valid = convolution.Execute( image, kernel );
+  EXPECT_EQ ( sitk::Hash( valid ), sitk::Hash( convolution.Execute( image, kernel ) ) );
+  convolution.AutomaticFFTOff();
+  EXPECT_LT ( maximumDifference( convolution.Execute( image, kernel ), valid ), 1e-4 );
+}
+
+TEST(BasicFilters,Deconvolution_InPlaceIterations) {
+  namespace sitk = itk::simple;
+
+  // positive blobs blurred by a Gaussian kernel
+  sitk::Image image( 48, 40, 12, sitk::sitkFloat32 );
+  for ( unsigned int z = 0; z < 12; ++z )
+    {
+    for ( unsigned int y = 0; y < 40; ++y )
+      {
+      for ( unsigned int x = 0; x < 48; ++x )
+        {
+        const bool blob = ( x - 15 ) * ( x - 15 ) + ( y - 20 ) * ( y - 20 ) < 50 || ( x > 30 && x < 40 && y > 8 && y < 16 );
+        image.SetPixelAsFloat( { x, y, z }, blob ? 100.0f : 10.0f );
+        }
+      }
+    }
+  sitk::GaussianImageSource source;
+  source.SetOutputPixelType( sitk::sitkFloat32 );
+  source.SetSize( { 7, 7, 5 } );
+  source.SetMean( v3( 3.0, 3.0, 2.0 ) );
+  source.SetSigma( v3( 1.5, 1.5, 1.0 ) );
+  const sitk::Image kernel = source.Execute();
+  const sitk::Image blurred = sitk::DiscreteGaussian( image, 2.0 );
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( a, b ) ) );
+      return stats.GetMaximum();
+    };
+
+  // the in place iterations are the iterations of the superclass
+  sitk::RichardsonLucyDeconvolutionImageFilter richardsonLucy;
+  EXPECT_FALSE ( richardsonLucy.GetInPlaceIterations() );
+  richardsonLucy.SetNumberOfIterations( 8 );
+  richardsonLucy.NormalizeOn();
+  const sitk::Image expected = richardsonLucy.Execute( blurred, kernel );
+  EXPECT_EQ ( 8u, richardsonLucy.GetNumberOfElapsedIterations() );
+  richardsonLucy.InPlaceIterationsOn();
+  EXPECT_LT ( maximumDifference( expected, richardsonLucy.Execute( blurred, kernel ) ), 1e-2 );
+
+  sitk::LandweberDeconvolutionImageFilter landweber;
+  landweber.SetNumberOfIterations( 6 );
+  landweber.NormalizeOn();
+  const sitk::Image expectedLandweber = landweber.Execute( blurred, kernel );
+  landweber.InPlaceIterationsOn();
+  EXPECT_LT ( maximumDifference( expectedLandweber, landweber.Execute( blurred, kernel ) ), 1e-2 );
+
+  sitk::ProjectedLandweberDeconvolutionImageFilter projected;
+  projected.SetNumberOfIterations( 6 );
+  projected.SetAlpha( 1.5 );
+  projected.NormalizeOn();
+  const sitk::Image expectedProjected = projected.Execute( blurred, kernel );
+  projected.InPlaceIterationsOn();
+  const sitk::Image projectedOutput = projected.Execute( blurred, kernel );
+  EXPECT_LT ( maximumDifference( expectedProjected, projectedOutput ), 1e-2 );
+  stats.Execute( projectedOutput );
+  EXPECT_GE ( stats.GetMinimum(), 0.0 );
+
+  // the accelerated iterations stay non negative, and the iterations
+  // stop early on a small change
+  richardsonLucy.AccelerationOn();
+  richardsonLucy.SetNumberOfIterations( 20 );
+  stats.Execute( richardsonLucy.Execute( blurred, kernel ) );
+  EXPECT_GE ( stats.GetMinimum(), 0.0 );
+  EXPECT_EQ ( 20u, richardsonLucy.GetNumberOfElapsedIterations() );
+
+  CountCommand iterationCmd( richardsonLucy );
+  richardsonLucy.AddCommand( sitk::sitkIterationEvent, iterationCmd );
+  richardsonLucy.SetRelativeChangeThreshold( 0.05 );
+  richardsonLucy.Execute( blurred, kernel );
+  EXPECT_LT ( richardsonLucy.GetNumberOfElapsedIterations(), 20u );
+  EXPECT_GT ( iterationCmd.m_Count, 0 );
+
+  landweber.SetNumberOfIterations( 50 );
+  landweber.SetRelativeChangeThreshold( 0.05 );
+  landweber.Execute( blurred, kernel );
+  EXPECT_LT ( landweber.GetNumberOfElapsedIterations(), 50u );
+}
+
+TEST(BasicFilters,HistogramMatching_ReferenceTable) {
+  namespace sitk = itk::simple;
+
+  // two ramps with different intensity profiles
+  sitk::Image image( 96, 80, sitk::sitkInt16 );
+  sitk::Image reference( 90, 70, sitk::sitkInt16 );
+  for ( unsigned int y = 0; y < 80; ++y )
+    {
+    for ( unsigned int x = 0; x < 96; ++x )
+      {
+      image.SetPixelAsInt16( { x, y }, static_cast<int16_t>( ( x * x + 7 * y ) % 900 - 100 ) );
+      }
+    }
+  for ( unsigned int y = 0; y < 70; ++y )
+    {
+    for ( unsigned int x = 0; x < 90; ++x )
+      {
+      reference.SetPixelAsInt16( { x, y }, static_cast<int16_t>( 3 * ( x + y * y ) % 2000 ) );
+      }
+    }
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&stats]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( sitk::Cast( a, sitk::sitkFloat64 ), sitk::Cast( b, sitk::sitkFloat64 ) ) ) );
+      return stats.GetMaximum();
+    };
+
+  // the table of the reference replaces the reference image
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkInt16, sitk::sitkFloat32 } )
+    {
+    sitk::HistogramMatchingImageFilter matching;
+    matching.SetNumberOfMatchPoints( 7 );
+    EXPECT_TRUE ( matching.GetReferenceTable().empty() );
+    const sitk::Image expected = matching.Execute( sitk::Cast( image, pixelType ), sitk::Cast( reference, pixelType ) );
+    const std::vector<double> table = matching.GetComputedReferenceTable();
+    ASSERT_EQ ( 10u, table.size() );
+    EXPECT_LE ( table[0], table[1] );
+    EXPECT_LE ( table[1], table[9] );
+
+    matching.SetReferenceTable( table );
+    EXPECT_LE ( maximumDifference( expected, matching.Execute( sitk::Cast( image, pixelType ) ) ), 1.0 ) << "pixel type: " << pixelType;
+    EXPECT_EQ ( table, matching.GetComputedReferenceTable() );
+
+    matching.SetNumberOfMatchPoints( 6 );
+    EXPECT_THROW ( matching.Execute( sitk::Cast( image, pixelType ) ), sitk::GenericException );
+    matching.SetReferenceTable( std::vector<double>() );
+    EXPECT_THROW ( matching.Execute( sitk::Cast( image, pixelType ) ), sitk::GenericException );
+    }
+
+  // the lookup tables of the integer images, for the images with more
+  // pixels than values, give the values of the functors
+  sitk::IntensityWindowingImageFilter windowing;
+  windowing.SetWindowMinimum( 20.0 );
+  windowing.SetWindowMaximum( 150.0 );
+  windowing.SetOutputMinimum( -20.0 );
+  windowing.SetOutputMaximum( 1000.0 );
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkUInt8, sitk::sitkInt16, sitk::sitkUInt16 } )
+    {
+    const sitk::Image input = sitk::Cast( sitk::Divide( sitk::Abs( image ), 4 ), pixelType );
+    const sitk::Image small = sitk::RegionOfInterest( input, { 9, 9 }, { 20, 30 } );
+    EXPECT_EQ ( sitk::Hash( windowing.Execute( small ) ),
+                sitk::Hash( sitk::RegionOfInterest( windowing.Execute( input ), { 9, 9 }, { 20, 30 } ) ) ) << "pixel type: " << pixelType;
+    }
+
+  sitk::Image larger( 300, 300, sitk::sitkInt16 );
+  for ( unsigned int y = 0; y < 300; ++y )
+    {
+    for ( unsigned int x = 0; x < 300; ++x )
+      {
+      larger.SetPixelAsInt16( { x, y }, static_cast<int16_t>( ( x * y ) % 3000 - 1000 ) );
+      }
+    }
+  const sitk::Image rescaled = sitk::RescaleIntensity( larger, 0.0, 255.0 );
+  const sitk::Image expectedRescaled = sitk::Cast( sitk::RescaleIntensity( sitk::Cast( larger, sitk::sitkFloat64 ), 0.0, 255.0 ), sitk::sitkInt16 );
+  EXPECT_EQ ( sitk::Hash( expectedRescaled ), sitk::Hash( rescaled ) );
+}
+
+TEST(BasicFilters,MultiClass_Histogram) {
+  namespace sitk = itk::simple;
+
+  // five noisy intensity classes, separated by empty intensities
+  sitk::Image image( 80, 60, 8, sitk::sitkUInt8 );
+  for ( unsigned int z = 0; z < 8; ++z )
+    {
+    for ( unsigned int y = 0; y < 60; ++y )
+      {
+      for ( unsigned int x = 0; x < 80; ++x )
+        {
+        const unsigned int value = 16 + 45 * ( x / 16 ) + ( x * 7 + y * 3 + z * 11 ) % 9;
+        image.SetPixelAsUInt8( { x, y, z }, static_cast<uint8_t>( value ) );
+        }
+      }
+    }
+
+  // the dynamic programming finds the classes of the search of all the
+  // thresholds
+  sitk::OtsuMultipleThresholdsImageFilter otsu;
+  EXPECT_FALSE ( otsu.GetDynamicProgramming() );
+  otsu.SetNumberOfThresholds( 4 );
+  otsu.SetNumberOfHistogramBins( 64u );
+  const sitk::Image expectedOtsu = otsu.Execute( image );
+  const std::vector<double> expectedThresholds = otsu.GetThresholds();
+  otsu.DynamicProgrammingOn();
+  EXPECT_EQ ( sitk::Hash( expectedOtsu ), sitk::Hash( otsu.Execute( image ) ) );
+  const std::vector<double> thresholds = otsu.GetThresholds();
+  ASSERT_EQ ( 4u, thresholds.size() );
+  for ( unsigned int j = 0; j < 4; ++j )
+    {
+    EXPECT_GE ( thresholds[j], 24.0 + 45.0 * j ) << "threshold: " << j;
+    EXPECT_LT ( thresholds[j], 61.0 + 45.0 * j ) << "threshold: " << j;
+    }
+
+  // the valley emphasis searches all the thresholds
+  otsu.SetNumberOfThresholds( 2 );
+  otsu.ValleyEmphasisOn();
+  otsu.DynamicProgrammingOff();
+  const sitk::Image expectedValley = otsu.Execute( image );
+  const std::vector<double> valleyThresholds = otsu.GetThresholds();
+  otsu.DynamicProgrammingOn();
+  EXPECT_EQ ( sitk::Hash( expectedValley ), sitk::Hash( otsu.Execute( image ) ) );
+  EXPECT_EQ ( valleyThresholds, otsu.GetThresholds() );
+  otsu.ValleyEmphasisOff();
+
+  otsu.SetNumberOfThresholds( 4 );
+  otsu.SetNumberOfHistogramBins( 3u );
+  EXPECT_THROW ( otsu.Execute( image ), sitk::GenericException );
+
+  // the k-means of the histogram are the k-means of the pixels
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkUInt8, sitk::sitkInt16 } )
+    {
+    const sitk::Image input = sitk::Cast( image, pixelType );
+    sitk::ScalarImageKmeansImageFilter kmeans;
+    EXPECT_FALSE ( kmeans.GetUseHistogram() );
+    kmeans.SetClassWithInitialMean( { 10.0, 60.0, 90.0, 170.0, 250.0 } );
+    kmeans.SetUseNonContiguousLabels( pixelType == sitk::sitkInt16 );
+    const sitk::Image expectedKmeans = kmeans.Execute( input );
+    const std::vector<double> expectedMeans = kmeans.GetFinalMeans();
+    kmeans.UseHistogramOn();
+    EXPECT_EQ ( sitk::Hash( expectedKmeans ), sitk::Hash( kmeans.Execute( input ) ) ) << "pixel type: " << pixelType;
+    EXPECT_VECTOR_DOUBLE_NEAR ( expectedMeans, kmeans.GetFinalMeans(), 1e-6 );
+    }
+}
+
+TEST(BasicFilters,ComponentTree_Thresholds) {
+  namespace sitk = itk::simple;
+
+  // blobs of several heights and sizes on a noisy background
+  sitk::Image image( 64, 48, sitk::sitkUInt8 );
+  std::set<unsigned int> values;
+  for ( unsigned int y = 0; y < 48; ++y )
+    {
+    for ( unsigned int x = 0; x < 64; ++x )
+      {
+      unsigned int value = ( x * 13 + y * 7 ) % 23;
+      if ( ( x / 8 ) % 2 == 1 && ( y / 6 ) % 2 == 1 )
+        {
+        value += 40 + 9 * ( x / 16 ) + 5 * ( y / 12 ) + ( x + y ) % 4;
+        }
+      if ( x > 50 && y > 36 )
+        {
+        value = 230;
+        }
+      image.SetPixelAsUInt8( { x, y }, static_cast<uint8_t>( value ) );
+      values.insert( value );
+      }
+    }
+  const double upperBoundary = 200.0;
+  const uint32_t minimumSize = 5u;
+
+  // the number of objects of each threshold, by labeling its components
+  auto numberOfObjects = [&]( const sitk::Image &input, double threshold )
+    {
+      sitk::RelabelComponentImageFilter relabel;
+      relabel.SetMinimumObjectSize( minimumSize );
+      relabel.Execute( sitk::ConnectedComponent( sitk::BinaryThreshold( input, threshold, upperBoundary, 1u, 0u ) ) );
+      return relabel.GetNumberOfObjects();
+    };
+
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkUInt8, sitk::sitkFloat32 } )
+    {
+    const sitk::Image input = sitk::Cast( image, pixelType );
+
+    // the lowest value with the largest number of objects
+    double expectedThreshold = 0.0;
+    uint64_t expectedNumberOfObjects = 0;
+    for ( const unsigned int value : values )
+      {
+      if ( value > upperBoundary )
+        {
+        continue;
+        }
+      const uint64_t n = numberOfObjects( input, value );
+      if ( n > expectedNumberOfObjects )
+        {
+        expectedThreshold = value;
+        expectedNumberOfObjects = n;
+        }
+      }
+
+    sitk::ThresholdMaximumConnectedComponentsImageFilter filter;
+    EXPECT_FALSE ( filter.GetUseComponentTree() );
+    filter.SetMinimumObjectSizeInPixels( minimumSize );
+    filter.SetUpperBoundary( upperBoundary );
+    filter.Execute( input );
+    EXPECT_LE ( filter.GetNumberOfObjects(), expectedNumberOfObjects ) << "pixel type: " << pixelType;
+
+    filter.UseComponentTreeOn();
+    const sitk::Image output = filter.Execute( input );
+    EXPECT_EQ ( expectedThreshold, filter.GetThresholdValue() ) << "pixel type: " << pixelType;
+    EXPECT_EQ ( expectedNumberOfObjects, filter.GetNumberOfObjects() ) << "pixel type: " << pixelType;
+    EXPECT_EQ ( sitk::Hash( sitk::BinaryThreshold( input, expectedThreshold, upperBoundary, 1u, 0u ) ), sitk::Hash( output ) );
+    }
+
+  // a wide and flat peak, and a narrow and high one
+  sitk::Image peaks( 64, 48, sitk::sitkUInt8 );
+  for ( unsigned int y = 0; y < 48; ++y )
+    {
+    for ( unsigned int x = 0; x < 64; ++x )
+      {
+      uint8_t value = 10;
+      if ( x >= 5 && x < 25 && y >= 5 && y < 25 )
+        {
+        value = 15;
+        }
+      else if ( x >= 40 && x < 43 && y >= 30 && y < 33 )
+        {
+        value = 110;
+        }
+      peaks.SetPixelAsUInt8( { x, y }, value );
+      }
+    }
+
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkUInt8, sitk::sitkFloat32 } )
+    {
+    sitk::Image input = sitk::Cast( peaks, pixelType );
+    sitk::VolumeOpeningImageFilter opening;
+    EXPECT_EQ ( sitk::Hash( input ), sitk::Hash( opening.Execute( input ) ) );
+
+    // the volume of the wide peak is 2000, and of the narrow one 900
+    opening.SetLambda( 1000.0 );
+    const sitk::Image output = sitk::Cast( opening.Execute( input ), sitk::sitkUInt8 );
+    EXPECT_EQ ( 15u, output.GetPixelAsUInt8( { 10, 10 } ) );
+    EXPECT_EQ ( 10u, output.GetPixelAsUInt8( { 41, 31 } ) );
+    EXPECT_EQ ( 10u, output.GetPixelAsUInt8( { 60, 40 } ) );
+    EXPECT_EQ ( sitk::Hash( output ), sitk::Hash( sitk::Cast( opening.Execute( sitk::Cast( output, pixelType ) ), sitk::sitkUInt8 ) ) );
+
+    // and a quarter of it in physical units
+    input.SetSpacing( { 0.5, 0.5 } );
+    EXPECT_EQ ( 10u, sitk::Cast( opening.Execute( input ), sitk::sitkUInt8 ).GetPixelAsUInt8( { 10, 10 } ) );
+    opening.UseImageSpacingOff();
+    EXPECT_EQ ( 15u, sitk::Cast( opening.Execute( input ), sitk::sitkUInt8 ).GetPixelAsUInt8( { 10, 10 } ) );
+    }
+}
+
+TEST(BasicFilters,ComponentTree_Morphology) {
+  namespace sitk = itk::simple;
+
+  // plateaus and peaks of several heights and areas, with a ramp
+  sitk::Image image( 64, 48, sitk::sitkUInt8 );
+  for ( unsigned int y = 0; y < 48; ++y )
+    {
+    for ( unsigned int x = 0; x < 64; ++x )
+      {
+      unsigned int value = 40 + ( x * 13 + y * 7 ) % 17 + x / 4;
+      if ( ( x / 8 ) % 2 == 1 && ( y / 6 ) % 2 == 1 )
+        {
+        value += 30 + 11 * ( x / 16 ) + 7 * ( y / 12 ) + ( x + y ) % 5;
+        }
+      if ( x > 50 && y > 36 )
+        {
+        value = 60;
+        }
+      image.SetPixelAsUInt8( { x, y }, static_cast<uint8_t>( value ) );
+      }
+    }
+
+  // the same output with and without the component tree
+  auto check = [] ( auto &filter, auto &&execute, const sitk::PixelIDValueEnum pixelType )
+    {
+      EXPECT_FALSE ( filter.GetUseComponentTree() );
+      const std::string expected = sitk::Hash( execute() );
+      filter.UseComponentTreeOn();
+      EXPECT_EQ ( expected, sitk::Hash( execute() ) ) << filter.GetName() << " pixel type: " << pixelType;
+      filter.UseComponentTreeOff();
+    };
+
+  for ( const sitk::PixelIDValueEnum pixelType : { sitk::sitkUInt8, sitk::sitkFloat32 } )
+    {
+    const sitk::Image input = sitk::Cast( image, pixelType );
+    const sitk::Image below = sitk::Subtract( input, 25.0 );
+    const sitk::Image above = sitk::Add( input, 25.0 );
+
+    for ( const bool fullyConnected : { false, true } )
+      {
+      sitk::AreaOpeningImageFilter areaOpening;
+      areaOpening.SetLambda( 20.0 );
+      areaOpening.SetFullyConnected( fullyConnected );
+      check( areaOpening, [&] { return areaOpening.Execute( input ); }, pixelType );
+
+      sitk::AreaClosingImageFilter areaClosing;
+      areaClosing.SetLambda( 20.0 );
+      areaClosing.SetFullyConnected( fullyConnected );
+      check( areaClosing, [&] { return areaClosing.Execute( input ); }, pixelType );
+
+      sitk::HMinimaImageFilter hMinima;
+      hMinima.SetHeight( 6.0 );
+      hMinima.SetFullyConnected( fullyConnected );
+      check( hMinima, [&] { return hMinima.Execute( input ); }, pixelType );
+
+      sitk::HConvexImageFilter hConvex;
+      hConvex.SetHeight( 6.0 );
+      hConvex.SetFullyConnected( fullyConnected );
+      check( hConvex, [&] { return hConvex.Execute( input ); }, pixelType );
+
+      sitk::HConcaveImageFilter hConcave;
+      hConcave.SetHeight( 6.0 );
+      hConcave.SetFullyConnected( fullyConnected );
+      check( hConcave, [&] { return hConcave.Execute( input ); }, pixelType );
+
+      sitk::RegionalMaximaImageFilter regionalMaxima;
+      regionalMaxima.SetFullyConnected( fullyConnected );
+      check( regionalMaxima, [&] { return regionalMaxima.Execute( input ); }, pixelType );
+
+      sitk::RegionalMinimaImageFilter regionalMinima;
+      regionalMinima.SetFullyConnected( fullyConnected );
+      check( regionalMinima, [&] { return regionalMinima.Execute( input ); }, pixelType );
+
+      sitk::ReconstructionByDilationImageFilter dilation;
+      dilation.SetFullyConnected( fullyConnected );
+      check( dilation, [&] { return dilation.Execute( below, input ); }, pixelType );
+
+      sitk::ReconstructionByErosionImageFilter erosion;
+      erosion.SetFullyConnected( fullyConnected );
+      check( erosion, [&] { return erosion.Execute( above, input ); }, pixelType );
+      }
+
+    sitk::HMaximaImageFilter hMaxima;
+    hMaxima.SetHeight( 6.0 );
+    check( hMaxima, [&] { return hMaxima.Execute( input ); }, pixelType );
+
+    // a flat image is an extremum, or not
+    const sitk::Image flat = sitk::Cast( sitk::Add( sitk::Image( 16, 12, sitk::sitkUInt8 ), 7.0 ), pixelType );
+    sitk::RegionalMaximaImageFilter regionalMaxima;
+    regionalMaxima.FlatIsMaximaOff();
+    check( regionalMaxima, [&] { return regionalMaxima.Execute( flat ); }, pixelType );
+    sitk::RegionalMinimaImageFilter regionalMinima;
+    check( regionalMinima, [&] { return regionalMinima.Execute( flat ); }, pixelType );
+    }
+}
+
+TEST(BasicFilters,RecursiveGaussianDerivatives_Tiled) {
+  namespace sitk = itk::simple;
+
+  // blobs in an image of several slabs, with an anisotropic spacing
+  sitk::Image image( 72, 66, 40, sitk::sitkFloat32 );
+  image.SetSpacing( { 1.0, 1.2, 2.0 } );
+  for ( unsigned int z = 0; z < 40; ++z )
+    {
+    for ( unsigned int y = 0; y < 66; ++y )
+      {
+      for ( unsigned int x = 0; x < 72; ++x )
+        {
+        const double value = 100.0 * std::sin( 0.2 * x ) * std::cos( 0.15 * y + 0.1 * z ) + ( ( x / 9 + y / 11 + z / 7 ) % 2 ) * 50.0;
+        image.SetPixelAsFloat( { x, y, z }, static_cast<float>( value ) );
+        }
+      }
+    }
+  const double sigma = 2.0;
+
+  // the derivatives of each axis with the separable recursive filters
+  auto derivative = [&]( unsigned int axis, sitk::RecursiveGaussianImageFilter::OrderType order )
+    {
+      sitk::Image result = image;
+      sitk::RecursiveGaussianImageFilter recursive;
+      recursive.SetSigma( sigma );
+      for ( unsigned int d = 0; d < 3; ++d )
+        {
+        recursive.SetDirection( d );
+        recursive.SetOrder( ( d == axis ) ? order : sitk::RecursiveGaussianImageFilter::ZeroOrder );
+        result = recursive.Execute( result );
+        }
+      return result;
+    };
+
+  sitk::StatisticsImageFilter stats;
+  auto maximumDifference = [&]( const sitk::Image &a, const sitk::Image &b )
+    {
+      stats.Execute( sitk::Abs( sitk::Subtract( a, b ) ) );
+      return stats.GetMaximum();
+    };
+
+  sitk::Image squares( 72, 66, 40, sitk::sitkFloat32 );
+  sitk::Image laplacian( 72, 66, 40, sitk::sitkFloat32 );
+  squares.CopyInformation( image );
+  laplacian.CopyInformation( image );
+  const sitk::Image gradient = sitk::GradientRecursiveGaussian( image, sigma );
+  for ( unsigned int d = 0; d < 3; ++d )
+    {
+    const sitk::Image first = derivative( d, sitk::RecursiveGaussianImageFilter::FirstOrder );
+    squares = sitk::Add( squares, sitk::Multiply( first, first ) );
+    laplacian = sitk::Add( laplacian, derivative( d, sitk::RecursiveGaussianImageFilter::SecondOrder ) );
+    EXPECT_LT( maximumDifference( first, sitk::VectorIndexSelectionCast( gradient, d ) ), 1e-3 ) << "Axis: " << d;
+    }
+
+  EXPECT_LT( maximumDifference( sitk::Sqrt( squares ), sitk::GradientMagnitudeRecursiveGaussian( image, sigma ) ), 1e-3 );
+  EXPECT_LT( maximumDifference( laplacian, sitk::LaplacianRecursiveGaussian( image, sigma ) ), 1e-3 );
+
+  // the magnitude computed in place of the input
+  sitk::Image inPlace = image;
+  sitk::GradientMagnitudeRecursiveGaussianImageFilter magnitude;
+  magnitude.SetSigma( sigma );
+  const sitk::Image expected = magnitude.Execute( image );
+  EXPECT_EQ( sitk::Hash( expected ), sitk::Hash( magnitude.Execute( std::move( inPlace ) ) ) );
+}
+
+TEST(BasicFilters,STAPLE_StreamingFusion) {
+  namespace sitk = itk::simple;
+
+  // segmentations of four labels by raters with decreasing accuracy
+  std::vector<sitk::Image> raters;
+  std::vector<sitk::Image> binaryRaters;
+  for ( unsigned int k = 0; k < 5; ++k )
+    {
+    sitk::Image rater( 30, 24, 10, sitk::sitkUInt8 );
+    sitk::Image binaryRater( 30, 24, 10, sitk::sitkUInt8 );
+    for ( unsigned int z = 0; z < 10; ++z )
+      {
+      for ( unsigned int y = 0; y < 24; ++y )
+        {
+        for ( unsigned int x = 0; x < 30; ++x )
+          {
+          unsigned int label = ( x * x + y * y < 300 ) ? 1 : ( ( x > 20 ) ? 2 : 0 );
+          if ( z > 6 && y < 5 )
+            {
+            label = 3;
+            }
+          if ( ( x * 73 + y * 151 + z * 37 + k * 97 ) % ( 19 - 2 * k ) == 0 )
+            {
+            label = ( label + 1 + k ) % 4;
+            }
+          rater.SetPixelAsUInt8( { x, y, z }, static_cast<uint8_t>( label ) );
+          binaryRater.SetPixelAsUInt8( { x, y, z }, static_cast<uint8_t>( label == 1 ) );
+          }
+        }
+      }
+    raters.push_back( rater );
+    binaryRaters.push_back( binaryRater );
+    }
+
+  sitk::StatisticsImageFilter stats;
+
+  sitk::STAPLEImageFilter staple;
+  EXPECT_FALSE( staple.GetStreamingFusion() );
+  const sitk::Image probabilities = staple.Execute( binaryRaters );
+  const std::vector<double> sensitivity = staple.GetSensitivity();
+  const std::vector<double> specificity = staple.GetSpecificity();
+
+  staple.StreamingFusionOn();
+  staple.SetNumberOfThreads( 4 );
+  const sitk::Image streamed = staple.Execute( binaryRaters );
+  stats.Execute( sitk::Abs( sitk::Subtract( probabilities, streamed ) ) );
+  EXPECT_LT( stats.GetMaximum(), 1e-6 );
+  ASSERT_EQ( sensitivity.size(), staple.GetSensitivity().size() );
+  ASSERT_EQ( specificity.size(), staple.GetSpecificity().size() );
+  for ( unsigned int k = 0; k < sensitivity.size(); ++k )
+    {
+    EXPECT_NEAR( sensitivity[k], staple.GetSensitivity()[k], 1e-8 ) << "Rater: " << k;
+    EXPECT_NEAR( specificity[k], staple.GetSpecificity()[k], 1e-8 ) << "Rater: " << k;
+    }
+
+  staple.SetNumberOfThreads( 1 );
+  EXPECT_EQ( sitk::Hash( streamed ), sitk::Hash( staple.Execute( binaryRaters ) ) );
+
+  // the labels of the multi-label STAPLE agree
+  sitk::MultiLabelSTAPLEImageFilter multiLabel;
+  EXPECT_FALSE( multiLabel.GetStreamingFusion() );
+  const sitk::Image labels = multiLabel.Execute( raters );
+  const std::vector<float> confusion = multiLabel.GetConfusionMatrix( 4 );
+
+  multiLabel.StreamingFusionOn();
+  multiLabel.SetNumberOfThreads( 4 );
+  const sitk::Image streamedLabels = multiLabel.Execute( raters );
+  stats.Execute( sitk::NotEqual( labels, streamedLabels ) );
+  EXPECT_LT( stats.GetMean(), 0.01 );
+
+  const std::vector<float> streamedConfusion = multiLabel.GetConfusionMatrix( 4 );
+  ASSERT_EQ( confusion.size(), streamedConfusion.size() );
+  for ( unsigned int i = 0; i < confusion.size(); ++i )
+    {
+    EXPECT_NEAR( confusion[i], streamedConfusion[i], 0.02 ) << "Element: " << i;
+    }
+
+  multiLabel.SetNumberOfThreads( 1 );
+  EXPECT_EQ( sitk::Hash( streamedLabels ), sitk::Hash( multiLabel.Execute( raters ) ) );
+}
+
+TEST(BasicFilters,SLIC_VectorizedClustering) {
+  namespace sitk = itk::simple;
+
+  // two channels, the first with a strong edge which no superpixel
+  // crosses, the second a smooth ramp
+  sitk::Image image( 40, 36, 20, sitk::sitkVectorFloat32, 2 );
+  for ( unsigned int z = 0; z < 20; ++z )
+    {
+    for ( unsigned int y = 0; y < 36; ++y )
+      {
+      for ( unsigned int x = 0; x < 40; ++x )
+        {
+        const float edge = ( x + y / 3 < 22 ) ? 0.0f : 1000.0f;
+        image.SetPixelAsVectorFloat32( { x, y, z }, { edge, static_cast<float>( 2 * x + y + z ) } );
+        }
+      }
+    }
+
+  sitk::SLICImageFilter slic;
+  EXPECT_FALSE( slic.GetVectorizedClustering() );
+  EXPECT_EQ( 0.0, slic.GetCenterShiftThreshold() );
+  slic.SetSuperGridSize( { 8, 8, 8 } );
+  slic.VectorizedClusteringOn();
+  slic.EnforceConnectivityOff();
+  slic.SetNumberOfThreads( 4 );
+  const sitk::Image labels = slic.Execute( image );
+  EXPECT_EQ( sitk::sitkUInt32, labels.GetPixelID() );
+  EXPECT_EQ( 5u, slic.GetNumberOfElapsedIterations() );
+  EXPECT_GT( slic.GetAverageResidual(), 0.0 );
+
+  sitk::LabelStatisticsImageFilter stats;
+  stats.Execute( sitk::VectorIndexSelectionCast( image, 0 ), labels );
+  for ( int64_t label : stats.GetLabels() )
+    {
+    EXPECT_EQ( stats.GetMinimum( label ), stats.GetMaximum( label ) ) << "Label: " << label;
+    }
+
+  slic.SetNumberOfThreads( 1 );
+  EXPECT_EQ( sitk::Hash( labels ), sitk::Hash( slic.Execute( image ) ) );
+
+  // the connected superpixels do not depend on the threads either
+  slic.EnforceConnectivityOn();
+  const std::string connectedHash = sitk::Hash( slic.Execute( image ) );
+  slic.SetNumberOfThreads( 3 );
+  EXPECT_EQ( connectedHash, sitk::Hash( slic.Execute( image ) ) );
+
+  // a threshold on the shift of the centers stops the iterations, and
+  // implies the vectorized clustering
+  slic.VectorizedClusteringOff();
+  slic.SetMaximumNumberOfIterations( 50 );
+  slic.SetCenterShiftThreshold( 0.05 );
+  slic.Execute( image );
+  EXPECT_LT( slic.GetNumberOfElapsedIterations(), 50u );
+  EXPECT_LE( slic.GetAverageResidual(), 0.05 );
+}
+
+TEST(BasicFilters,PatchBasedDenoisingNonLocalMeans) {
+  namespace sitk = itk::simple;
+
+  // a disk with a deterministic noise
+  sitk::Image truth( 47, 39, sitk::sitkFloat32 );
+  sitk::Image image( 47, 39, sitk::sitkFloat32 );
+  for ( unsigned int y = 0; y < 39; ++y )
+    {
+    for ( unsigned int x = 0; x < 47; ++x )
+      {
+      const double dx = x - 23.0;
+      const double dy = y - 19.0;
+      const double value = ( dx * dx + dy * dy < 100.0 ) ? 200.0 : 100.0;
+      truth.SetPixelAsFloat( { x, y }, static_cast<float>( value ) );
+      image.SetPixelAsFloat( { x, y }, static_cast<float>( value + 10.0 * std::sin( 12.9898 * x + 78.233 * y + 0.5 * x * y ) ) );
+      }
+    }
 
-}
+  sitk::StatisticsImageFilter stats;
+  stats.Execute( sitk::Abs( sitk::Subtract( image, truth ) ) );
+  const double noise = stats.GetMean();
 
-TEST(BasicFilters,HashImageFilter) {
-  itk::simple::HashImageFilter hasher;
-  std::string out = hasher.ToString();
-  EXPECT_TRUE ( out.find("itk::simple::HashImageFilter") != std::string::npos );
-  EXPECT_TRUE ( out.find("HashFunction: SHA1") != std::string::npos );
-  EXPECT_TRUE ( out.find("Debug:") != std::string::npos );
-  EXPECT_TRUE ( out.find("NumberOfThreads:") != std::string::npos );
-  EXPECT_EQ ( itk::simple::HashImageFilter::SHA1, hasher.SetHashFunction ( itk::simple::HashImageFilter::SHA1 ).GetHashFunction() );
-  EXPECT_EQ ( itk::simple::HashImageFilter::MD5, hasher.SetHashFunction ( itk::simple::HashImageFilter::MD5 ).GetHashFunction() );
-}
+  sitk::PatchBasedDenoisingImageFilter filter;
+  EXPECT_EQ ( sitk::PatchBasedDenoisingImageFilter::Sampling, filter.GetAlgorithm() );
+  EXPECT_EQ ( 5u, filter.GetSearchRadius() );
+  filter.SetPatchRadius( 2u );
+  filter.SetSearchRadius( 4u );
+  filter.SetKernelBandwidthSigma( 60.0 );
 
+  for ( auto algorithm : { sitk::PatchBasedDenoisingImageFilter::NonLocalMeans,
+                           sitk::PatchBasedDenoisingImageFilter::BlockwiseNonLocalMeans } )
+    {
+    filter.SetAlgorithm( algorithm );
+    const sitk::Image output = filter.Execute( image );
+    EXPECT_EQ ( image.GetPixelID(), output.GetPixelID() );
+    stats.Execute( sitk::Abs( sitk::Subtract( output, truth ) ) );
+    EXPECT_LT ( stats.GetMean(), 0.5 * noise ) << "Algorithm: " << algorithm;
+
+    // a constant image is unchanged
+    const sitk::Image constant = sitk::Add( sitk::Image( 13, 11, 7, sitk::sitkUInt16 ), 300.0 );
+    EXPECT_EQ ( sitk::Hash( constant ), sitk::Hash( filter.Execute( constant ) ) ) << "Algorithm: " << algorithm;
+    }
+}
 
 TEST(BasicFilters,BSplineTransformInitializer) {
   namespace sitk = itk::simple;
@@ -652,6 +2748,23 @@ TEST(BasicFilters,CenteredTransformInitializer) {
   EXPECT_FLOAT_EQ ( 111.20356, params[0] );
   EXPECT_FLOAT_EQ ( 131.59097, params[1] );
 
+  // the zero background has no mass, so excluding it does not change the center
+  EXPECT_EQ ( 1u, filter.GetMomentsSamplingFactor() );
+  filter.SetMomentsLowerThreshold( 1.0 );
+  EXPECT_EQ ( 1.0, filter.GetMomentsLowerThreshold() );
+  params = filter.Execute( fixed, moving, tx ).GetFixedParameters();
+  EXPECT_FLOAT_EQ ( 111.20356, params[0] );
+  EXPECT_FLOAT_EQ ( 131.59097, params[1] );
+
+  filter.SetMomentsSamplingFactor( 3 );
+  EXPECT_EQ ( 3u, filter.GetMomentsSamplingFactor() );
+  params = filter.Execute( fixed, moving, tx ).GetFixedParameters();
+  EXPECT_NEAR ( 111.20356, params[0], 0.5 );
+  EXPECT_NEAR ( 131.59097, params[1], 0.5 );
+  EXPECT_EQ ( 1u, filter.SetMomentsSamplingFactor( 0 ).GetMomentsSamplingFactor() );
+
+  filter.SetMomentsLowerThreshold( 1000.0 );
+  EXPECT_THROW ( filter.Execute( fixed, moving, tx ), sitk::GenericException );
 }
 
 
@@ -730,6 +2843,21 @@ TEST(BasicFilters,CenteredVersorTransformInitializer) {
   EXPECT_VECTOR_DOUBLE_NEAR( tx.GetVersor(), v4(-0.5, -0.5,0.5,0.5), 1e-5 );
   }
 
+  {
+  // the moments of the subsampled images with the background excluded
+  filter.ComputeRotationOn();
+  filter.SetMomentsSamplingFactor( 2 );
+  filter.SetMomentsLowerThreshold( 0.01 );
+  EXPECT_EQ ( 2u, filter.GetMomentsSamplingFactor() );
+  EXPECT_EQ ( 0.01, filter.GetMomentsLowerThreshold() );
+  sitk::VersorRigid3DTransform tx( filter.Execute(g1, g3, sitk::VersorRigid3DTransform() ) );
+  EXPECT_VECTOR_DOUBLE_NEAR( tx.GetTranslation(), v3(-1.0,-2.0,-3.0), 0.1 );
+  EXPECT_VECTOR_DOUBLE_NEAR( tx.GetCenter(), v3(64.0,64.0,64.0), 0.1 );
+  EXPECT_VECTOR_DOUBLE_NEAR( tx.GetVersor(), v4(-0.5, -0.5,0.5,0.5), 1e-3 );
+  filter.SetMomentsSamplingFactor( 1 );
+  filter.SetMomentsLowerThreshold( std::numeric_limits<double>::lowest() );
+  }
+
   EXPECT_THROW( sitk::CenteredVersorTransformInitializer(g1, g2, sitk::Transform(2,sitk::sitkSimilarity)), sitk::GenericException );
   EXPECT_THROW( sitk::CenteredVersorTransformInitializer(g1, g2, sitk::Transform(3,sitk::sitkVersor)), sitk::GenericException );
   EXPECT_THROW( sitk::CenteredVersorTransformInitializer(g1, g2, sitk::Transform(3,sitk::sitkAffine)), sitk::GenericException );
@@ -859,6 +2987,688 @@ TEST(BasicFilters,LandmarkBasedTransformInitializer) {
 }
 
 
+TEST(BasicFilters,LandmarkBasedTransformInitializer_RANSAC) {
+  namespace sitk = itk::simple;
+
+  // pairs mapped by a rigid transform, with every fifth pair an outlier
+  sitk::Euler2DTransform reference( v2(5.0, 5.0), 0.3, v2(2.0, -3.0) );
+  std::vector<double> fixedPoints;
+  std::vector<double> movingPoints;
+  for ( unsigned int i = 0; i < 100; ++i )
+    {
+    const std::vector<double> pt = v2( (i % 10) * 1.5, (i / 10) * 1.5 );
+    std::vector<double> movingPt = reference.TransformPoint( pt );
+    if ( i % 5 == 0 )
+      {
+      movingPt[0] += 20.0 + i;
+      movingPt[1] -= 10.0;
+      }
+    fixedPoints.insert( fixedPoints.end(), pt.begin(), pt.end() );
+    movingPoints.insert( movingPoints.end(), movingPt.begin(), movingPt.end() );
+    }
+
+  sitk::LandmarkBasedTransformInitializerFilter filter;
+  filter.SetFixedLandmarks( fixedPoints );
+  filter.SetMovingLandmarks( movingPoints );
+
+  EXPECT_EQ( 0u, filter.GetRANSACNumberOfIterations() );
+  filter.SetRANSACNumberOfIterations( 50 );
+  filter.SetRANSACInlierThreshold( 0.01 );
+  filter.SetRANSACSeed( 42 );
+
+  sitk::Transform out = filter.Execute( sitk::Euler2DTransform() );
+  EXPECT_EQ( 80u, filter.GetRANSACInliers().size() );
+  for ( unsigned int i = 0; i < 20; ++i )
+    {
+    const std::vector<double> pt = v2( fixedPoints[2*i], fixedPoints[2*i+1] );
+    EXPECT_VECTOR_DOUBLE_NEAR( reference.TransformPoint( pt ), out.TransformPoint( pt ), 1e-6 );
+    }
+
+  // the result only depends on the seed
+  filter.SetNumberOfThreads( 1 );
+  sitk::Transform out1 = filter.Execute( sitk::Euler2DTransform() );
+  EXPECT_VECTOR_DOUBLE_NEAR( out.GetParameters(), out1.GetParameters(), 1e-12 );
+
+  out = filter.Execute( sitk::AffineTransform(2) );
+  EXPECT_EQ( 80u, filter.GetRANSACInliers().size() );
+
+  sitk::Image image( 16, 16, sitk::sitkFloat32 );
+  filter.SetReferenceImage( image );
+  EXPECT_ANY_THROW( filter.Execute( sitk::BSplineTransform(2) ) );
+
+  filter.SetRANSACNumberOfIterations( 0 );
+  filter.Execute( sitk::Euler2DTransform() );
+  EXPECT_TRUE( filter.GetRANSACInliers().empty() );
+}
+
+
+TEST(BasicFilters,MultiResolutionDemonsRegistration) {
+  namespace sitk = itk::simple;
+
+  const std::vector<unsigned int> size(2, 64u);
+  sitk::Image fixed = sitk::GaussianSource( sitk::sitkFloat32, size, v2(10.0,10.0), v2(32.0,32.0), 100.0 );
+  sitk::Image moving = sitk::GaussianSource( sitk::sitkFloat32, size, v2(10.0,10.0), v2(34.0,31.0), 100.0 );
+
+  sitk::MultiResolutionDemonsRegistrationFilter filter;
+
+  EXPECT_EQ ( "MultiResolutionDemonsRegistrationFilter", filter.GetName() );
+  EXPECT_EQ ( sitk::MultiResolutionDemonsRegistrationFilter::Demons, filter.GetDemonsRegistrationType() );
+  EXPECT_TRUE ( filter.GetShrinkFactorsPerLevel().empty() );
+  EXPECT_EQ ( std::vector<double>(3,2.0), filter.SetStandardDeviations(2.0).GetStandardDeviations() );
+  filter.SetStandardDeviations(1.0);
+
+  const std::vector<uint32_t> iterations = { 20u, 10u, 5u };
+  filter.SetNumberOfIterations( iterations );
+  EXPECT_EQ ( iterations, filter.GetNumberOfIterations() );
+
+  sitk::Image field = filter.Execute( fixed, moving );
+  EXPECT_EQ ( sitk::sitkVectorFloat64, field.GetPixelID() );
+  EXPECT_EQ ( fixed.GetSize(), field.GetSize() );
+  EXPECT_GE ( filter.GetElapsedIterations(), 1u );
+  EXPECT_LE ( filter.GetElapsedIterations(), 35u );
+  EXPECT_GT ( filter.GetMetric(), 0.0 );
+
+  // the field of a previous registration initializes the next one
+  filter.SetDemonsRegistrationType( sitk::MultiResolutionDemonsRegistrationFilter::FastSymmetricForces );
+  sitk::Image refined = filter.Execute( fixed, moving, field );
+  EXPECT_EQ ( fixed.GetSize(), refined.GetSize() );
+
+  filter.SetDemonsRegistrationType( sitk::MultiResolutionDemonsRegistrationFilter::SymmetricForces );
+  EXPECT_NO_THROW ( filter.Execute( fixed, moving ) );
+
+  filter.SetDemonsRegistrationType( sitk::MultiResolutionDemonsRegistrationFilter::Diffeomorphic );
+  filter.SetShrinkFactorsPerLevel( std::vector<uint32_t>{ 2u, 2u, 1u } );
+  EXPECT_NO_THROW ( filter.Execute( fixed, moving ) );
+
+  filter.SetShrinkFactorsPerLevel( std::vector<uint32_t>{ 2u, 1u } );
+  EXPECT_ANY_THROW ( filter.Execute( fixed, moving ) );
+
+  EXPECT_ANY_THROW ( filter.Execute( fixed, sitk::Image( 64, 64, sitk::sitkUInt8 ) ) );
+}
+
+
+TEST(BasicFilters,Cast_SameType) {
+  // casting to the same pixel type does not copy the buffer
+
+  namespace sitk = itk::simple;
+  sitk::Image img( {16, 16, 4}, sitk::sitkVectorUInt16, 2 );
+  img.SetPixelAsVectorUInt16( {1, 2, 3}, {7, 11} );
+
+  sitk::Image out = sitk::Cast( img, sitk::sitkVectorUInt16 );
+  const sitk::Image &constImg = img;
+  const sitk::Image &constOut = out;
+  EXPECT_EQ( constImg.GetBufferAsVoid(), constOut.GetBufferAsVoid() );
+  EXPECT_FALSE( img.IsUnique() );
+
+  // copy on write keeps the input unchanged
+  out.SetPixelAsVectorUInt16( {1, 2, 3}, {0, 0} );
+  EXPECT_EQ( std::vector<uint16_t>({7, 11}), img.GetPixelAsVectorUInt16( {1, 2, 3} ) );
+  EXPECT_TRUE( img.IsUnique() );
+
+  // the commands are run and the cancellation is honored
+  sitk::CastImageFilter caster;
+  caster.SetOutputPixelType( sitk::sitkVectorUInt16 );
+  unsigned int startCount = 0;
+  unsigned int endCount = 0;
+  caster.AddCommand( sitk::sitkStartEvent, [&startCount] { ++startCount; } );
+  caster.AddCommand( sitk::sitkEndEvent, [&endCount] { ++endCount; } );
+  out = caster.Execute( img );
+  EXPECT_EQ( constImg.GetBufferAsVoid(), constOut.GetBufferAsVoid() );
+  EXPECT_EQ( 1u, startCount );
+  EXPECT_EQ( 1u, endCount );
+  EXPECT_EQ( 1.0f, caster.GetProgress() );
+
+  sitk::CancellationToken token;
+  token.Cancel();
+  caster.SetCancellationToken( token );
+  EXPECT_THROW( caster.Execute( img ), sitk::GenericException );
+  EXPECT_EQ( 1u, startCount );
+
+  // the meta-data follows the global propagation
+  img.SetMetaData( "key", "value" );
+  EXPECT_EQ( "value", sitk::Cast( img, sitk::sitkVectorUInt16 ).GetMetaData( "key" ) );
+  sitk::ProcessObject::GlobalMetaDataPropagationOff();
+  out = sitk::Cast( img, sitk::sitkVectorUInt16 );
+  sitk::ProcessObject::GlobalMetaDataPropagationOn();
+  EXPECT_FALSE( out.HasMetaDataKey( "key" ) );
+  EXPECT_EQ( "value", img.GetMetaData( "key" ) );
+  EXPECT_EQ( constImg.GetBufferAsVoid(), constOut.GetBufferAsVoid() );
+}
+
+TEST(BasicFilters,Cast_Saturate) {
+  // numeric casts with and without saturation of the out of range values
+
+  namespace sitk = itk::simple;
+  sitk::Image img( {64, 32, 3}, sitk::sitkFloat32 );
+  img.SetOrigin( {1.0, 2.0, 3.0} );
+  img.SetPixelAsFloat( {1, 2, 1}, -5.0f );
+  img.SetPixelAsFloat( {2, 2, 1}, 300.0f );
+  img.SetPixelAsFloat( {3, 2, 1}, 42.75f );
+  img.SetPixelAsFloat( {4, 2, 1}, std::numeric_limits<float>::quiet_NaN() );
+
+  sitk::CastImageFilter caster;
+  EXPECT_FALSE( caster.GetSaturate() );
+  caster.SetOutputPixelType( sitk::sitkUInt8 );
+  caster.SaturateOn();
+  EXPECT_TRUE( caster.GetSaturate() );
+
+  sitk::Image out = caster.Execute( img );
+  EXPECT_EQ( sitk::sitkUInt8, out.GetPixelID() );
+  EXPECT_EQ( img.GetOrigin(), out.GetOrigin() );
+  EXPECT_EQ( 0u, out.GetPixelAsUInt8( {1, 2, 1} ) );
+  EXPECT_EQ( 255u, out.GetPixelAsUInt8( {2, 2, 1} ) );
+  EXPECT_EQ( 42u, out.GetPixelAsUInt8( {3, 2, 1} ) );
+  EXPECT_EQ( 0u, out.GetPixelAsUInt8( {4, 2, 1} ) );
+  EXPECT_EQ( 0u, out.GetPixelAsUInt8( {0, 0, 0} ) );
+
+  // without saturation the in range values are truncated as before
+  caster.SaturateOff();
+  out = caster.Execute( img );
+  EXPECT_EQ( 42u, out.GetPixelAsUInt8( {3, 2, 1} ) );
+
+  sitk::Image shorts( {40, 30}, sitk::sitkInt16 );
+  shorts.SetPixelAsInt16( {5, 6}, -1000 );
+  shorts.SetPixelAsInt16( {6, 6}, 1000 );
+  shorts.SetPixelAsInt16( {7, 6}, 17 );
+  caster.SaturateOn();
+  out = caster.Execute( shorts );
+  EXPECT_EQ( 0u, out.GetPixelAsUInt8( {5, 6} ) );
+  EXPECT_EQ( 255u, out.GetPixelAsUInt8( {6, 6} ) );
+  EXPECT_EQ( 17u, out.GetPixelAsUInt8( {7, 6} ) );
+
+  // the conversion to a wider type is exact
+  sitk::Image words( {40, 30}, sitk::sitkUInt16 );
+  words.SetPixelAsUInt16( {5, 6}, 65535 );
+  out = sitk::Cast( words, sitk::sitkFloat32 );
+  EXPECT_EQ( 65535.0f, out.GetPixelAsFloat( {5, 6} ) );
+  EXPECT_EQ( 0.0f, out.GetPixelAsFloat( {6, 6} ) );
+
+  // a scalar image is cast to a vector image of one component
+  out = sitk::Cast( words, sitk::sitkVectorFloat64 );
+  EXPECT_EQ( 1u, out.GetNumberOfComponentsPerPixel() );
+  EXPECT_EQ( std::vector<double>({65535.0}), out.GetPixelAsVectorFloat64( {5, 6} ) );
+
+  // the meta-data is kept, and the commands are run
+  words.SetMetaData( "key", "value" );
+  sitk::CastImageFilter wordsCaster;
+  wordsCaster.SetOutputPixelType( sitk::sitkInt32 );
+  wordsCaster.SetNumberOfThreads( 2 );
+  unsigned int startCount = 0;
+  unsigned int endCount = 0;
+  wordsCaster.AddCommand( sitk::sitkStartEvent, [&startCount] { ++startCount; } );
+  wordsCaster.AddCommand( sitk::sitkEndEvent, [&endCount] { ++endCount; } );
+  out = wordsCaster.Execute( words );
+  EXPECT_EQ( "value", out.GetMetaData( "key" ) );
+  EXPECT_EQ( 65535, out.GetPixelAsInt32( {5, 6} ) );
+  EXPECT_EQ( 1u, startCount );
+  EXPECT_EQ( 1u, endCount );
+  EXPECT_EQ( 1.0f, wordsCaster.GetProgress() );
+  EXPECT_EQ( 2u, wordsCaster.GetLastExecutionNumberOfThreads() );
+}
+
+TEST(BasicFilters,ExecuteAsync) {
+  // asynchronous execution of generated filters
+
+  namespace sitk = itk::simple;
+  sitk::Image img( 32, 32, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {3, 4}, 2.0f );
+
+  sitk::AddImageFilter add;
+  std::future<sitk::Image> added = add.ExecuteAsync( img, img );
+  sitk::NaryAddImageFilter naryAdd;
+  std::future<sitk::Image> naryAdded = naryAdd.ExecuteAsync( {img, img, img} );
+  sitk::GaussianImageSource source;
+  source.SetSize( {16, 16} );
+  std::future<sitk::Image> sourced = source.ExecuteAsync();
+
+  EXPECT_EQ( 4.0f, added.get().GetPixelAsFloat( {3, 4} ) );
+  EXPECT_EQ( 6.0f, naryAdded.get().GetPixelAsFloat( {3, 4} ) );
+  EXPECT_EQ( sitk::Hash( source.Execute() ), sitk::Hash( sourced.get() ) );
+
+  // exceptions are raised by the future
+  std::future<sitk::Image> failed = add.ExecuteAsync( img, sitk::Image( 8, 8, sitk::sitkFloat32 ) );
+  EXPECT_THROW( failed.get(), sitk::GenericException );
+}
+
+TEST(BasicFilters,CanRunInPlace) {
+  // filters report if a moved input buffer is reused
+
+  namespace sitk = itk::simple;
+  EXPECT_TRUE( sitk::AddImageFilter().CanRunInPlace() );
+  EXPECT_TRUE( sitk::NaryAddImageFilter().CanRunInPlace() );
+  EXPECT_TRUE( sitk::PasteImageFilter().CanRunInPlace() );
+  EXPECT_FALSE( sitk::ShiftScaleImageFilter().CanRunInPlace() );
+  EXPECT_FALSE( sitk::ResampleImageFilter().CanRunInPlace() );
+
+  sitk::Image img( 32, 32, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {3, 4}, 2.0f );
+  const sitk::Image other = img;
+
+  // the first image is shared so it is not reused
+  sitk::NaryAddImageFilter naryAdd;
+  std::vector<sitk::Image> images{ img, other, other };
+  sitk::Image out = naryAdd.Execute( std::move( images ) );
+  EXPECT_EQ( 6.0f, out.GetPixelAsFloat( {3, 4} ) );
+  EXPECT_EQ( 2.0f, img.GetPixelAsFloat( {3, 4} ) );
+
+  sitk::Image unique( 32, 32, sitk::sitkFloat32 );
+  unique.SetPixelAsFloat( {3, 4}, 1.0f );
+  const void *buffer = unique.GetBufferAsVoid();
+  images = { std::move( unique ), other };
+  out = naryAdd.Execute( std::move( images ) );
+  EXPECT_EQ( 3.0f, out.GetPixelAsFloat( {3, 4} ) );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( out ).GetBufferAsVoid() );
+  EXPECT_EQ( 2.0f, other.GetPixelAsFloat( {3, 4} ) );
+}
+
+TEST(BasicFilters,SetOutputImage) {
+  // a provided unique image's buffer is reused for the output
+
+  namespace sitk = itk::simple;
+  sitk::Image img( 32, 32, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {3, 4}, 2.0f );
+
+  sitk::ShiftScaleImageFilter shiftScale;
+  shiftScale.SetShift( 1.0 );
+  EXPECT_FALSE( shiftScale.HasOutputImage() );
+
+  sitk::Image out = shiftScale.Execute( img );
+  const void *buffer = static_cast<const sitk::Image &>( out ).GetBufferAsVoid();
+
+  shiftScale.SetOutputImage( std::move( out ) );
+  EXPECT_TRUE( shiftScale.HasOutputImage() );
+  shiftScale.SetScale( 2.0 );
+  out = shiftScale.Execute( img );
+  EXPECT_FALSE( shiftScale.HasOutputImage() );
+  EXPECT_EQ( 6.0f, out.GetPixelAsFloat( {3, 4} ) );
+  EXPECT_EQ( 2.0f, out.GetPixelAsFloat( {0, 0} ) );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( out ).GetBufferAsVoid() );
+
+  // a shared image is not written to
+  const sitk::Image shared = out;
+  shiftScale.SetOutputImage( shared );
+  out = shiftScale.Execute( img );
+  EXPECT_FALSE( shiftScale.HasOutputImage() );
+  EXPECT_EQ( 6.0f, shared.GetPixelAsFloat( {3, 4} ) );
+  EXPECT_NE( static_cast<const sitk::Image &>( shared ).GetBufferAsVoid(),
+             static_cast<const sitk::Image &>( out ).GetBufferAsVoid() );
+
+  // a mismatched pixel type falls back to a new buffer
+  shiftScale.SetOutputImage( sitk::Image( 32, 32, sitk::sitkUInt8 ) );
+  out = shiftScale.Execute( img );
+  EXPECT_EQ( sitk::sitkFloat32, out.GetPixelID() );
+  EXPECT_EQ( 6.0f, out.GetPixelAsFloat( {3, 4} ) );
+
+  shiftScale.SetOutputImage( sitk::Image( 32, 32, sitk::sitkFloat32 ) );
+  shiftScale.RemoveOutputImage();
+  EXPECT_FALSE( shiftScale.HasOutputImage() );
+
+  // a streamed output is allocated with the provided buffer
+  sitk::SigmoidImageFilter sigmoid;
+  sigmoid.SetNumberOfStreamDivisions( 4 );
+  const sitk::Image expected = sigmoid.Execute( img );
+  out = sigmoid.Execute( img );
+  buffer = static_cast<const sitk::Image &>( out ).GetBufferAsVoid();
+  sigmoid.SetOutputImage( std::move( out ) );
+  out = sigmoid.Execute( img );
+  EXPECT_FALSE( sigmoid.HasOutputImage() );
+  EXPECT_EQ( buffer, static_cast<const sitk::Image &>( out ).GetBufferAsVoid() );
+  EXPECT_EQ( sitk::Hash( expected ), sitk::Hash( out ) );
+}
+
+TEST(BasicFilters,ExecuteBatch) {
+  // a batch matches executing each image in turn
+
+  namespace sitk = itk::simple;
+  std::vector<sitk::Image> images;
+  for ( unsigned int i = 0; i < 50; ++i )
+    {
+    sitk::Image img( 8, 8, sitk::sitkFloat32 );
+    img.SetPixelAsFloat( {1, 2}, static_cast<float>( i ) );
+    images.push_back( img );
+    }
+
+  sitk::BinaryThresholdImageFilter threshold;
+  threshold.SetLowerThreshold( 10.0 );
+  threshold.SetUpperThreshold( 20.0 );
+  threshold.SetInsideValue( 7 );
+  threshold.SetNumberOfThreads( 4 );
+
+  std::vector<sitk::Image> outputs = threshold.ExecuteBatch( images );
+  ASSERT_EQ( images.size(), outputs.size() );
+  for ( unsigned int i = 0; i < images.size(); ++i )
+    {
+    EXPECT_EQ( sitk::Hash( threshold.Execute( images[i] ) ), sitk::Hash( outputs[i] ) ) << "image " << i;
+    EXPECT_EQ( ( i >= 10 && i <= 20 ) ? 7u : 0u, outputs[i].GetPixelAsUInt8( {1, 2} ) );
+    }
+
+  EXPECT_TRUE( threshold.ExecuteBatch( {} ).empty() );
+
+  // the workers stream as this filter, and only the batch acquires
+  // the threads of the executor
+  sitk::Executor executor( 2 );
+  threshold.SetExecutor( executor );
+  threshold.SetNumberOfStreamDivisions( 4 );
+  outputs = threshold.ExecuteBatch( images );
+  ASSERT_EQ( images.size(), outputs.size() );
+  for ( unsigned int i = 0; i < images.size(); ++i )
+    {
+    EXPECT_EQ( ( i >= 10 && i <= 20 ) ? 7u : 0u, outputs[i].GetPixelAsUInt8( {1, 2} ) ) << "image " << i;
+    }
+  EXPECT_EQ( 0u, executor.GetNumberOfActiveThreads() );
+  EXPECT_EQ( 0u, executor.GetNumberOfActiveExecutions() );
+  threshold.RemoveExecutor();
+  threshold.SetNumberOfStreamDivisions( 1 );
+
+  // an unsupported pixel type stops the batch
+  images[25] = sitk::Image( 8, 8, sitk::sitkVectorFloat32, 2 );
+  EXPECT_THROW( threshold.ExecuteBatch( images ), sitk::GenericException );
+}
+
+TEST(BasicFilters,ExecuteSliceBySlice) {
+  // the slices match executing each extracted slice in turn
+
+  namespace sitk = itk::simple;
+  sitk::Image img( 20, 18, 12, sitk::sitkFloat32 );
+  img.SetSpacing( { 0.5, 0.75, 2.0 } );
+  img.SetOrigin( { 3.0, -2.0, 1.0 } );
+  for ( unsigned int z = 0; z < 12; ++z )
+    {
+    for ( unsigned int y = 0; y < 18; ++y )
+      {
+      for ( unsigned int x = 0; x < 20; ++x )
+        {
+        img.SetPixelAsFloat( { x, y, z }, static_cast<float>( ( x * 7 + y * 13 + z * 29 ) % 31 ) );
+        }
+      }
+    }
+
+  sitk::MedianImageFilter median;
+  median.SetRadius( 1 );
+  median.SetNumberOfThreads( 4 );
+
+  for ( unsigned int axis = 0; axis < 3; ++axis )
+    {
+    const sitk::Image out = median.ExecuteSliceBySlice( img, axis );
+    EXPECT_EQ( img.GetSize(), out.GetSize() );
+    EXPECT_EQ( img.GetSpacing(), out.GetSpacing() );
+    EXPECT_EQ( img.GetOrigin(), out.GetOrigin() );
+    EXPECT_EQ( sitk::sitkFloat32, out.GetPixelID() );
+
+    std::vector<unsigned int> size = img.GetSize();
+    size[axis] = 0;
+    for ( unsigned int k = 0; k < img.GetSize()[axis]; ++k )
+      {
+      std::vector<int> index( 3, 0 );
+      index[axis] = static_cast<int>( k );
+      EXPECT_EQ( sitk::Hash( median.Execute( sitk::Extract( img, size, index ) ) ),
+                 sitk::Hash( sitk::Extract( out, size, index ) ) ) << "axis " << axis << " slice " << k;
+      }
+    }
+  EXPECT_EQ( sitk::Hash( median.ExecuteSliceBySlice( img ) ), sitk::Hash( sitk::SliceBySlice( median, img, 2 ) ) );
+
+  // the output has the pixel type of the results
+  sitk::BinaryThresholdImageFilter threshold;
+  threshold.SetLowerThreshold( 10.0 );
+  threshold.SetUpperThreshold( 20.0 );
+  const sitk::Image label = sitk::SliceBySlice( threshold, img, 1 );
+  EXPECT_EQ( sitk::sitkUInt8, label.GetPixelID() );
+  EXPECT_EQ( sitk::Hash( threshold.Execute( img ) ), sitk::Hash( label ) );
+
+  EXPECT_THROW( median.ExecuteSliceBySlice( img, 3 ), sitk::GenericException );
+  EXPECT_THROW( median.ExecuteSliceBySlice( sitk::Image( 8, 8, sitk::sitkFloat32 ) ), sitk::GenericException );
+}
+
+TEST(BasicFilters,ReuseITKFilter) {
+  // a kept ITK filter gives the same results and leaves the images alone
+
+  namespace sitk = itk::simple;
+  sitk::Image img( 16, 16, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {1, 2}, 15.0f );
+
+  sitk::BinaryThresholdImageFilter threshold;
+  EXPECT_FALSE( threshold.GetReuseITKFilter() );
+  threshold.ReuseITKFilterOn();
+  EXPECT_TRUE( threshold.GetReuseITKFilter() );
+  threshold.SetLowerThreshold( 10.0 );
+  threshold.SetUpperThreshold( 20.0 );
+
+  sitk::Image first = threshold.Execute( img );
+  EXPECT_TRUE( img.IsUnique() );
+  EXPECT_EQ( 1u, first.GetPixelAsUInt8( {1, 2} ) );
+
+  threshold.SetInsideValue( 3 );
+  sitk::Image second = threshold.Execute( img );
+  EXPECT_EQ( 3u, second.GetPixelAsUInt8( {1, 2} ) );
+  EXPECT_EQ( 1u, first.GetPixelAsUInt8( {1, 2} ) );
+  EXPECT_NE( static_cast<const sitk::Image &>( first ).GetBufferAsVoid(),
+             static_cast<const sitk::Image &>( second ).GetBufferAsVoid() );
+
+  // a different pixel type constructs a new ITK filter
+  sitk::Image other = threshold.Execute( sitk::Image( 16, 16, sitk::sitkInt16 ) );
+  EXPECT_EQ( 0u, other.GetPixelAsUInt8( {1, 2} ) );
+  EXPECT_EQ( sitk::Hash( second ), sitk::Hash( threshold.Execute( img ) ) );
+
+  // a failed execution does not affect the next
+  EXPECT_THROW( threshold.Execute( sitk::Image( 16, 16, sitk::sitkVectorFloat32, 2 ) ), sitk::GenericException );
+  EXPECT_EQ( sitk::Hash( second ), sitk::Hash( threshold.Execute( img ) ) );
+
+  threshold.ReleaseITKFilter();
+  threshold.ReuseITKFilterOff();
+  EXPECT_EQ( sitk::Hash( second ), sitk::Hash( threshold.Execute( img ) ) );
+}
+
+TEST(BasicFilters,FFTConfiguration) {
+  // the FFTW planning options are only available with FFTW
+
+  namespace sitk = itk::simple;
+
+  if ( !sitk::HasFFTW() )
+    {
+    EXPECT_FALSE( sitk::SetGlobalDefaultFFTPlanRigor( "FFTW_MEASURE" ) );
+    EXPECT_EQ( "", sitk::GetGlobalDefaultFFTPlanRigor() );
+    EXPECT_FALSE( sitk::ImportFFTWisdom() );
+    return;
+    }
+
+  const std::string rigor = sitk::GetGlobalDefaultFFTPlanRigor();
+  EXPECT_FALSE( sitk::SetGlobalDefaultFFTPlanRigor( "FFTW_FAST" ) );
+  EXPECT_EQ( rigor, sitk::GetGlobalDefaultFFTPlanRigor() );
+
+  EXPECT_TRUE( sitk::SetGlobalDefaultFFTPlanRigor( "FFTW_MEASURE" ) );
+  EXPECT_EQ( "FFTW_MEASURE", sitk::GetGlobalDefaultFFTPlanRigor() );
+
+  sitk::Image img( 32, 32, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {3, 4}, 1.0f );
+
+  // the second execution plans from the wisdom of the first
+  sitk::ForwardFFTImageFilter fft;
+  const std::string hash = sitk::Hash( fft.Execute( img ) );
+  EXPECT_EQ( hash, sitk::Hash( fft.Execute( img ) ) );
+
+  EXPECT_TRUE( sitk::SetGlobalDefaultFFTPlanRigor( rigor ) );
+}
+
+TEST(BasicFilters,PointwiseExpression) {
+  // a chain of operations matches the individual filters
+
+  namespace sitk = itk::simple;
+  sitk::Image img = sitk::Cast( sitk::ReadImage( dataFinder.GetFile ( "Input/RA-Short.nrrd" ) ), sitk::sitkFloat32 );
+
+  sitk::PointwiseExpressionImageFilter expression;
+  expression.Multiply( 2.0 ).Add( 5.0 ).Subtract( 1.0 ).Divide( 4.0 );
+  EXPECT_EQ( 4u, expression.GetNumberOfOperations() );
+  EXPECT_EQ( sitk::sitkUnknown, expression.GetOutputPixelType() );
+
+  sitk::Image expected = sitk::Divide( sitk::Subtract( sitk::Add( sitk::Multiply( img, 2.0 ), 5.0 ), 1.0 ), 4.0 );
+  sitk::Image out = expression.Execute( img );
+  EXPECT_EQ( sitk::sitkFloat32, out.GetPixelID() );
+  EXPECT_EQ( img.GetOrigin(), out.GetOrigin() );
+  EXPECT_EQ( sitk::Hash( expected ), sitk::Hash( out ) );
+
+  // the result is clamped to the output type
+  expression.ClearOperations().Multiply( -1.0 ).Clamp( -10.0, 300.0 ).Abs();
+  expression.SetOutputPixelType( sitk::sitkUInt8 );
+  sitk::Image img16( {4, 4}, sitk::sitkInt16 );
+  img16.SetPixelAsInt16( {1, 1}, -1000 );
+  img16.SetPixelAsInt16( {2, 1}, 7 );
+  out = expression.Execute( img16 );
+  EXPECT_EQ( sitk::sitkUInt8, out.GetPixelID() );
+  EXPECT_EQ( 255u, out.GetPixelAsUInt8( {1, 1} ) );
+  EXPECT_EQ( 7u, out.GetPixelAsUInt8( {2, 1} ) );
+
+  // vectors are evaluated by component
+  sitk::Image vimg( {3, 3}, sitk::sitkVectorFloat64, 2 );
+  vimg.SetPixelAsVectorFloat64( {0, 2}, {4.0, 9.0} );
+  expression.ClearOperations().Sqrt().Square().Sqrt();
+  expression.SetOutputPixelType( sitk::sitkVectorFloat32 );
+  EXPECT_EQ( std::vector<float>( {2.0f, 3.0f} ), expression.Execute( vimg ).GetPixelAsVectorFloat32( {0, 2} ) );
+
+  expression.SetOutputPixelType( sitk::sitkFloat32 );
+  EXPECT_THROW( expression.Execute( vimg ), sitk::GenericException );
+  expression.SetOutputPixelType( sitk::sitkUnknown );
+  EXPECT_THROW( expression.Execute( sitk::Image( {3, 3}, sitk::sitkComplexFloat32 ) ), sitk::GenericException );
+  EXPECT_THROW( expression.Clamp( 1.0, -1.0 ), sitk::GenericException );
+}
+
+TEST(BasicFilters,InstructionSet) {
+  // the dispatched kernels produce the same results for all the
+  // instruction sets supported by the processor
+
+  namespace sitk = itk::simple;
+  sitk::Image img = sitk::Cast( sitk::ReadImage( dataFinder.GetFile ( "Input/RA-Short.nrrd" ) ), sitk::sitkFloat32 );
+
+  const std::string instructionSet = sitk::ProcessObject::GetGlobalDefaultInstructionSet();
+  EXPECT_FALSE( sitk::ProcessObject::SetGlobalDefaultInstructionSet( "NotAnInstructionSet" ) );
+  EXPECT_EQ( instructionSet, sitk::ProcessObject::GetGlobalDefaultInstructionSet() );
+
+  auto execute = [&img]()
+    {
+      sitk::PointwiseExpressionImageFilter expression;
+      expression.Multiply( 1.25 ).Add( -3.0 ).Sqrt();
+      std::string hashes = sitk::Hash( expression.Execute( img ) );
+      hashes += sitk::Hash( sitk::Cast( sitk::Multiply( img, 0.37 ), sitk::sitkInt16 ) );
+      const sitk::TranslationTransform translation( img.GetDimension(), std::vector<double>( img.GetDimension(), 0.3 ) );
+      hashes += sitk::Hash( sitk::Resample( img, translation, sitk::sitkLinear ) );
+      sitk::FusedStatisticsImageFilter statistics;
+      statistics.Execute( img );
+      hashes += std::to_string( statistics.GetMean() ) + std::to_string( statistics.GetSigma() );
+      return hashes;
+    };
+
+  ASSERT_TRUE( sitk::ProcessObject::SetGlobalDefaultInstructionSet( "baseline" ) );
+  EXPECT_EQ( "BASELINE", sitk::ProcessObject::GetGlobalDefaultInstructionSet() );
+  const std::string expected = execute();
+
+  for ( const char * name : { "AVX2", "AVX512" } )
+    {
+    if ( sitk::ProcessObject::SetGlobalDefaultInstructionSet( name ) )
+      {
+      EXPECT_EQ( name, sitk::ProcessObject::GetGlobalDefaultInstructionSet() );
+      EXPECT_EQ( expected, execute() ) << "Instruction set: " << name;
+      }
+    }
+
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultInstructionSet( "AUTO" ) );
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultInstructionSet( instructionSet ) );
+}
+
+TEST(BasicFilters,MetadataOnlyAxes) {
+  // the axis operations which keep the order of the pixels in the
+  // buffer refer to the buffer of the input
+
+  namespace sitk = itk::simple;
+  sitk::Image img( {8, 6, 1}, sitk::sitkInt16 );
+  img.SetOrigin( {1.0, 2.0, 3.0} );
+  img.SetSpacing( {0.5, 1.0, 2.0} );
+  int16_t *buffer = img.GetBufferAsInt16();
+  for ( unsigned int i = 0; i < img.GetNumberOfPixels(); ++i )
+    {
+    buffer[i] = static_cast<int16_t>( i );
+    }
+  const sitk::Image &cimg = img;
+
+  sitk::PermuteAxesImageFilter permute;
+  permute.SetOrder( {0, 2, 1} );
+  const sitk::Image permuted = permute.Execute( img );
+  EXPECT_EQ( std::vector<unsigned int>({8, 1, 6}), permuted.GetSize() );
+  EXPECT_EQ( std::vector<double>({0.5, 2.0, 1.0}), permuted.GetSpacing() );
+  EXPECT_EQ( cimg.GetBufferAsInt16(), permuted.GetBufferAsInt16() );
+  EXPECT_EQ( img.GetPixelAsInt16( {3, 4, 0} ), permuted.GetPixelAsInt16( {3, 0, 4} ) );
+  EXPECT_VECTOR_DOUBLE_NEAR( img.TransformIndexToPhysicalPoint( {3, 4, 0} ),
+                             permuted.TransformIndexToPhysicalPoint( {3, 0, 4} ), 1e-10 );
+
+  // a permutation which reorders the buffer is copied
+  permute.SetOrder( {1, 0, 2} );
+  const sitk::Image transposed = permute.Execute( img );
+  EXPECT_NE( cimg.GetBufferAsInt16(), transposed.GetBufferAsInt16() );
+  EXPECT_EQ( img.GetPixelAsInt16( {3, 4, 0} ), transposed.GetPixelAsInt16( {4, 3, 0} ) );
+
+  sitk::FlipImageFilter flip;
+  flip.SetFlipAxes( {false, false, true} );
+  const sitk::Image flipped = flip.Execute( img );
+  EXPECT_EQ( cimg.GetBufferAsInt16(), flipped.GetBufferAsInt16() );
+  EXPECT_EQ( sitk::Hash( img ), sitk::Hash( flipped ) );
+  EXPECT_EQ( img.GetSize(), flipped.GetSize() );
+  flip.SetFlipAxes( {true, false, true} );
+  EXPECT_EQ( img.GetPixelAsInt16( {0, 4, 0} ), flip.Execute( img ).GetPixelAsInt16( {7, 4, 0} ) );
+
+  sitk::CyclicShiftImageFilter shift;
+  shift.SetShift( {8, -6, 3} );
+  const sitk::Image shifted = shift.Execute( img );
+  EXPECT_EQ( cimg.GetBufferAsInt16(), shifted.GetBufferAsInt16() );
+  EXPECT_EQ( sitk::Hash( img ), sitk::Hash( shifted ) );
+  EXPECT_EQ( img.GetOrigin(), shifted.GetOrigin() );
+
+  sitk::DICOMOrientImageFilter orient;
+  orient.SetDesiredCoordinateOrientation( "LSP" );
+  const sitk::Image oriented = orient.Execute( img );
+  EXPECT_EQ( std::vector<unsigned int>({0, 2, 1}), orient.GetPermuteOrder() );
+  EXPECT_EQ( cimg.GetBufferAsInt16(), oriented.GetBufferAsInt16() );
+  EXPECT_EQ( "LSP", sitk::DICOMOrientImageFilter::GetOrientationFromDirectionCosines( oriented.GetDirection() ) );
+
+  // only the geometry is transformed
+  const sitk::TranslationTransform translation( 3, {1.0, 2.0, 3.0} );
+  const sitk::Image transformed = sitk::TransformGeometry( img, translation );
+  EXPECT_EQ( cimg.GetBufferAsInt16(), transformed.GetBufferAsInt16() );
+  EXPECT_EQ( img.GetSize(), transformed.GetSize() );
+  EXPECT_VECTOR_DOUBLE_NEAR( transformed.GetOrigin(), std::vector<double>({0.0, 0.0, 0.0}), 1e-10 );
+
+  // modifying the output does not modify the input
+  sitk::Image output = permute.SetOrder( {0, 2, 1} ).Execute( img );
+  output.SetPixelAsInt16( {0, 0, 0}, -1 );
+  EXPECT_EQ( 0, img.GetPixelAsInt16( {0, 0, 0} ) );
+}
+
+TEST(BasicFilters,StreamDivisions) {
+  // streamed execution produces the same output
+
+  namespace sitk = itk::simple;
+  sitk::Image img = sitk::ReadImage( dataFinder.GetFile ( "Input/RA-Short.nrrd" ) );
+
+  sitk::MedianImageFilter median;
+  EXPECT_EQ( 1u, median.GetNumberOfStreamDivisions() );
+  median.SetRadius( 2 );
+  const std::string expected = sitk::Hash( median.Execute( img ) );
+
+  median.SetNumberOfStreamDivisions( 4 );
+  EXPECT_EQ( 4u, median.GetNumberOfStreamDivisions() );
+  sitk::Image out = median.Execute( img );
+  EXPECT_EQ( expected, sitk::Hash( out ) );
+  EXPECT_EQ( img.GetSize(), out.GetSize() );
+  EXPECT_EQ( img.GetOrigin(), out.GetOrigin() );
+
+  sitk::BinaryThresholdImageFilter threshold;
+  threshold.SetLowerThreshold( 100 );
+  const std::string thresholdExpected = sitk::Hash( threshold.Execute( img ) );
+  threshold.SetNumberOfStreamDivisions( 3 );
+  EXPECT_EQ( thresholdExpected, sitk::Hash( threshold.Execute( sitk::Image( img ) ) ) );
+
+  // zero is treated as a single division
+  median.SetNumberOfStreamDivisions( 0 );
+  EXPECT_EQ( 1u, median.GetNumberOfStreamDivisions() );
+}
+
 TEST(BasicFilters,Cast_Commands) {
   // test cast filter with a bunch of commands
 
@@ -1022,6 +3832,306 @@ TEST(BasicFilters,ResampleImageFilter_DefaultParameters)
 }
 
 
+TEST(BasicFilters,ResampleImageFilter_LinearTransformScanline)
+{
+  namespace sitk = itk::simple;
+
+  const std::vector<unsigned int> size(2, 64u);
+  sitk::Image img = sitk::GaussianSource( sitk::sitkFloat32, size, v2(10.0,10.0), v2(32.0,32.0), 100.0 );
+
+  sitk::AffineTransform affine( 2 );
+  affine.SetMatrix( { 0.9, -0.3, 0.35, 1.1 } );
+  affine.SetTranslation( v2( 2.5, -3.25 ) );
+  affine.SetCenter( v2( 32.0, 32.0 ) );
+
+  // a composite with a non-linear transform of zero displacement is
+  // resampled without the scanline fast path of the linear transforms
+  sitk::CompositeTransform composite( std::vector<sitk::Transform>{ affine, sitk::BSplineTransform( 2 ) } );
+
+  for ( sitk::InterpolatorEnum interpolator : { sitk::sitkLinear, sitk::sitkNearestNeighbor } )
+    {
+    sitk::ResampleImageFilter filter;
+    filter.SetReferenceImage( img );
+    filter.SetInterpolator( interpolator );
+    filter.SetDefaultPixelValue( -1.0 );
+
+    filter.SetTransform( affine );
+    sitk::Image fast = filter.Execute( img );
+
+    filter.SetTransform( composite );
+    sitk::Image reference = filter.Execute( img );
+
+    sitk::StatisticsImageFilter stats;
+    stats.Execute( sitk::Subtract( fast, reference ) );
+    EXPECT_NEAR( 0.0, stats.GetMinimum(), 1e-4 ) << "Interpolator: " << interpolator;
+    EXPECT_NEAR( 0.0, stats.GetMaximum(), 1e-4 ) << "Interpolator: " << interpolator;
+
+    // the pixels outside of the input have the default value
+    stats.Execute( fast );
+    EXPECT_EQ( -1.0, stats.GetMinimum() ) << "Interpolator: " << interpolator;
+    }
+}
+
+TEST(BasicFilters,Resampler)
+{
+  namespace sitk = itk::simple;
+
+  const std::vector<unsigned int> size(2, 32u);
+  sitk::Image img = sitk::GaussianSource( sitk::sitkFloat32, size, v2(6.0,8.0), v2(16.0,15.0), 100.0 );
+  sitk::Image img2 = sitk::Multiply( img, 2.0 );
+
+  sitk::Euler2DTransform transform( v2( 16.0, 16.0 ), 0.2, v2( 1.25, -0.5 ) );
+
+  const std::vector<double> points = { 12.3, 17.6, 4.1, 20.9 };
+
+  for ( sitk::InterpolatorEnum interpolator : { sitk::sitkBSpline, sitk::sitkBSpline1, sitk::sitkLinear } )
+    {
+    // the vector image is compared with the resampling of each component
+    for ( const std::vector<sitk::Image> &components : { std::vector<sitk::Image>{ img },
+                                                         std::vector<sitk::Image>{ img, img2 } } )
+      {
+      const sitk::Image image = ( components.size() == 1 ) ? components[0] : sitk::Compose( components );
+
+      sitk::Resampler resampler( image, interpolator );
+      resampler.SetDefaultPixelValue( -1.0 );
+      EXPECT_EQ( interpolator, resampler.GetInterpolator() );
+      EXPECT_EQ( "Resampler", resampler.GetName() );
+
+      std::vector<double> expectedValues( points.size() / 2 * components.size() );
+
+      for ( unsigned int c = 0; c < components.size(); ++c )
+        {
+        const sitk::Image expected = sitk::Resample( components[c], components[c], transform, interpolator, -1.0 );
+
+        // repeated executions use the same state
+        for ( unsigned int i = 0; i < 2; ++i )
+          {
+          sitk::Image out = resampler.Execute( transform, image );
+          EXPECT_EQ( image.GetPixelID(), out.GetPixelID() );
+          if ( components.size() > 1 )
+            {
+            out = sitk::VectorIndexSelectionCast( out, c );
+            }
+
+          sitk::StatisticsImageFilter stats;
+          stats.Execute( sitk::Subtract( out, expected ) );
+          EXPECT_NEAR( 0.0, stats.GetMinimum(), 1e-4 ) << "Interpolator: " << interpolator;
+          EXPECT_NEAR( 0.0, stats.GetMaximum(), 1e-4 ) << "Interpolator: " << interpolator;
+          }
+
+        for ( unsigned int p = 0; p < points.size() / 2; ++p )
+          {
+          const std::vector<double> point( points.begin() + 2*p, points.begin() + 2*p + 2 );
+          expectedValues[p * components.size() + c] = components[c].EvaluateAtPhysicalPoint( point, interpolator )[0];
+          }
+        }
+
+      const std::vector<double> firstValues( expectedValues.begin(), expectedValues.begin() + components.size() );
+      EXPECT_VECTOR_DOUBLE_NEAR( firstValues, resampler.EvaluateAtPhysicalPoint( v2( 12.3, 17.6 ) ), 1e-4 );
+      EXPECT_VECTOR_DOUBLE_NEAR( expectedValues, resampler.EvaluateAtPhysicalPoints( points ), 1e-4 );
+      }
+    }
+
+  sitk::Resampler resampler( img, sitk::sitkBSpline );
+  resampler.SetOutputPixelType( sitk::sitkVectorFloat32 );
+  EXPECT_THROW( resampler.Execute( transform, img ), sitk::GenericException );
+  resampler.SetOutputPixelType( sitk::sitkFloat64 );
+  EXPECT_EQ( sitk::sitkFloat64, resampler.Execute( transform, img ).GetPixelID() );
+}
+
+TEST(BasicFilters,JointResampler)
+{
+  namespace sitk = itk::simple;
+
+  const std::vector<unsigned int> size(2, 32u);
+  sitk::Image img = sitk::GaussianSource( sitk::sitkFloat32, size, v2(6.0,8.0), v2(16.0,15.0), 100.0 );
+  sitk::Image labels = sitk::BinaryThreshold( img, 20.0, 200.0, 3u, 0u );
+  sitk::Image vectorImg = sitk::Compose( std::vector<sitk::Image>{ img, sitk::Multiply( img, 2.0 ) } );
+  sitk::Image shifted = sitk::Image( img );
+  shifted.SetOrigin( v2( 2.0, -1.5 ) );
+
+  sitk::Euler2DTransform transform( v2( 16.0, 16.0 ), 0.2, v2( 1.25, -0.5 ) );
+
+  sitk::JointResampler resampler;
+  EXPECT_EQ( "JointResampler", resampler.GetName() );
+  resampler.AddImage( img, sitk::sitkLinear, -1.0 )
+    .AddImage( labels, sitk::sitkNearestNeighbor )
+    .AddImage( labels, sitk::sitkLabelGaussian, 0.0, sitk::sitkUInt16 )
+    .AddImage( vectorImg, sitk::sitkLinear, -2.0 )
+    .AddImage( shifted, sitk::sitkBSpline, -3.0, sitk::sitkFloat64 );
+  EXPECT_EQ( 5u, resampler.GetNumberOfImages() );
+  EXPECT_NO_THROW( resampler.ToString() );
+
+  const std::vector<uint32_t> outputSize = { 40, 30 };
+  const std::vector<double> origin = v2( -2.0, 1.0 );
+  const std::vector<double> spacing = v2( 0.9, 1.1 );
+  const std::vector<sitk::Image> outputs = resampler.Execute( transform, outputSize, origin, spacing );
+  ASSERT_EQ( 5u, outputs.size() );
+
+  const std::vector<sitk::Image> expected = {
+    sitk::Resample( img, outputSize, transform, sitk::sitkLinear, origin, spacing, std::vector<double>(), -1.0 ),
+    sitk::Resample( labels, outputSize, transform, sitk::sitkNearestNeighbor, origin, spacing ),
+    sitk::Resample( labels, outputSize, transform, sitk::sitkLabelGaussian, origin, spacing, std::vector<double>(), 0.0, sitk::sitkUInt16 ),
+    sitk::Resample( vectorImg, outputSize, transform, sitk::sitkLinear, origin, spacing, std::vector<double>(), -2.0 ),
+    sitk::Resample( shifted, outputSize, transform, sitk::sitkBSpline, origin, spacing, std::vector<double>(), -3.0, sitk::sitkFloat64 ) };
+
+  for ( unsigned int i = 0; i < outputs.size(); ++i )
+    {
+    EXPECT_EQ( expected[i].GetPixelID(), outputs[i].GetPixelID() ) << "Image: " << i;
+    EXPECT_EQ( expected[i].GetSize(), outputs[i].GetSize() ) << "Image: " << i;
+    EXPECT_VECTOR_DOUBLE_NEAR( expected[i].GetOrigin(), outputs[i].GetOrigin(), 1e-10 );
+
+    for ( unsigned int c = 0; c < outputs[i].GetNumberOfComponentsPerPixel(); ++c )
+      {
+      sitk::Image out = outputs[i];
+      sitk::Image ref = expected[i];
+      if ( out.GetNumberOfComponentsPerPixel() > 1 )
+        {
+        out = sitk::VectorIndexSelectionCast( out, c );
+        ref = sitk::VectorIndexSelectionCast( ref, c );
+        }
+      sitk::StatisticsImageFilter stats;
+      stats.Execute( sitk::Subtract( sitk::Cast( out, sitk::sitkFloat64 ), sitk::Cast( ref, sitk::sitkFloat64 ) ) );
+      EXPECT_NEAR( 0.0, stats.GetMinimum(), 1e-4 ) << "Image: " << i;
+      EXPECT_NEAR( 0.0, stats.GetMaximum(), 1e-4 ) << "Image: " << i;
+      }
+    }
+
+  EXPECT_THROW( resampler.AddImage( img, sitk::sitkLinear, 0.0, sitk::sitkVectorFloat32 ), sitk::GenericException );
+  EXPECT_THROW( resampler.AddImage( vectorImg, sitk::sitkLinear, 0.0, sitk::sitkFloat32 ), sitk::GenericException );
+  EXPECT_THROW( resampler.Execute( transform, std::vector<uint32_t>( 3, 10u ), origin, spacing ), sitk::GenericException );
+
+  resampler.ClearImages();
+  EXPECT_EQ( 0u, resampler.GetNumberOfImages() );
+  EXPECT_TRUE( resampler.Execute( transform, img ).empty() );
+}
+
+TEST(BasicFilters,JointResampler_MappingCache)
+{
+  namespace sitk = itk::simple;
+
+  const std::vector<unsigned int> size(2, 32u);
+  sitk::Image img = sitk::GaussianSource( sitk::sitkFloat32, size, v2(6.0,8.0), v2(16.0,15.0), 100.0 );
+  sitk::Image shifted = sitk::Image( img );
+  shifted.SetOrigin( v2( 2.0, -1.5 ) );
+
+  sitk::Euler2DTransform transform( v2( 16.0, 16.0 ), 0.2, v2( 1.25, -0.5 ) );
+  const sitk::Image reference = sitk::Image( std::vector<unsigned int>{ 300, 270 }, sitk::sitkUInt8 );
+
+  auto maximumDifference = []( const sitk::Image &a, const sitk::Image &b )
+    {
+      sitk::StatisticsImageFilter stats;
+      stats.Execute( sitk::Abs( sitk::Subtract( sitk::Cast( a, sitk::sitkFloat64 ), sitk::Cast( b, sitk::sitkFloat64 ) ) ) );
+      return stats.GetMaximum();
+    };
+
+  sitk::JointResampler resampler;
+  EXPECT_FALSE( resampler.GetUseMappingCache() );
+  resampler.UseMappingCacheOn();
+  EXPECT_TRUE( resampler.GetUseMappingCache() );
+  resampler.AddImage( img, sitk::sitkLinear, -1.0 );
+
+  // the output is larger than one block
+  const std::vector<sitk::Image> first = resampler.Execute( transform, reference );
+  const std::vector<sitk::Image> cached = resampler.Execute( transform, reference );
+  ASSERT_EQ( 1u, cached.size() );
+  EXPECT_EQ( 0.0, maximumDifference( first[0], cached[0] ) );
+  EXPECT_NEAR( 0.0, maximumDifference( cached[0], sitk::Resample( img, reference, transform, sitk::sitkLinear, -1.0 ) ), 1e-4 );
+
+  // an image with another geometry is added to the cached mapping
+  resampler.AddImage( shifted, sitk::sitkNearestNeighbor, -2.0 );
+  std::vector<sitk::Image> outputs = resampler.Execute( transform, reference );
+  ASSERT_EQ( 2u, outputs.size() );
+  EXPECT_EQ( 0.0, maximumDifference( first[0], outputs[0] ) );
+  EXPECT_EQ( 0.0, maximumDifference( outputs[1], sitk::Resample( shifted, reference, transform, sitk::sitkNearestNeighbor, -2.0 ) ) );
+
+  // a modified transform is not mapped with the cache
+  transform.SetAngle( -0.3 );
+  outputs = resampler.Execute( transform, reference );
+  EXPECT_NEAR( 0.0, maximumDifference( outputs[0], sitk::Resample( img, reference, transform, sitk::sitkLinear, -1.0 ) ), 1e-4 );
+  EXPECT_EQ( 0.0, maximumDifference( outputs[1], sitk::Resample( shifted, reference, transform, sitk::sitkNearestNeighbor, -2.0 ) ) );
+
+  // the same for another output grid
+  outputs = resampler.Execute( transform, std::vector<uint32_t>{ 20, 25 }, v2( -2.0, 1.0 ), v2( 0.9, 1.1 ) );
+  EXPECT_EQ( std::vector<unsigned int>( { 20, 25 } ), outputs[0].GetSize() );
+  EXPECT_NEAR( 0.0,
+               maximumDifference( outputs[0], sitk::Resample( img, std::vector<uint32_t>{ 20, 25 }, transform, sitk::sitkLinear,
+                                                              v2( -2.0, 1.0 ), v2( 0.9, 1.1 ), std::vector<double>(), -1.0 ) ),
+               1e-4 );
+
+  resampler.ClearMappingCache();
+  EXPECT_NO_THROW( resampler.ToString() );
+  resampler.UseMappingCacheOff();
+  EXPECT_FALSE( resampler.GetUseMappingCache() );
+  outputs = resampler.Execute( transform, reference );
+  EXPECT_NEAR( 0.0, maximumDifference( outputs[0], sitk::Resample( img, reference, transform, sitk::sitkLinear, -1.0 ) ), 1e-4 );
+}
+
+TEST(BasicFilters,ResamplingOperator)
+{
+  namespace sitk = itk::simple;
+
+  const std::vector<unsigned int> size(2, 32u);
+  sitk::Image img = sitk::GaussianSource( sitk::sitkFloat32, size, v2(6.0,8.0), v2(16.0,15.0), 100.0 );
+  img.SetOrigin( v2( 2.0, -1.5 ) );
+  sitk::Image labels = sitk::BinaryThreshold( img, 20.0, 200.0, 3u, 0u );
+  sitk::Image vectorImg = sitk::Compose( std::vector<sitk::Image>{ img, sitk::Multiply( img, 2.0 ) } );
+
+  sitk::Euler2DTransform transform( v2( 16.0, 16.0 ), 0.2, v2( 1.25, -0.5 ) );
+  sitk::Image reference( std::vector<unsigned int>{ 300, 270 }, sitk::sitkUInt8 );
+  reference.SetSpacing( v2( 0.125, 0.1 ) );
+  reference.SetOrigin( v2( -2.0, 1.0 ) );
+
+  auto maximumDifference = []( const sitk::Image &a, const sitk::Image &b )
+    {
+      sitk::StatisticsImageFilter stats;
+      stats.Execute( sitk::Abs( sitk::Subtract( sitk::Cast( a, sitk::sitkFloat64 ), sitk::Cast( b, sitk::sitkFloat64 ) ) ) );
+      return stats.GetMaximum();
+    };
+
+  const sitk::ResamplingOperator linearOperator( transform, img, reference, sitk::sitkLinear );
+  EXPECT_EQ( "ResamplingOperator", linearOperator.GetName() );
+  EXPECT_NO_THROW( linearOperator.ToString() );
+  EXPECT_EQ( sitk::sitkLinear, linearOperator.GetInterpolator() );
+  EXPECT_EQ( img.GetSize(), linearOperator.GetInputSize() );
+  EXPECT_EQ( reference.GetSize(), linearOperator.GetOutputSize() );
+  EXPECT_GT( linearOperator.GetNumberOfWeights(), 0u );
+
+  sitk::Image output = linearOperator.Execute( img, -1.0 );
+  EXPECT_EQ( sitk::sitkFloat32, output.GetPixelID() );
+  EXPECT_VECTOR_DOUBLE_NEAR( reference.GetOrigin(), output.GetOrigin(), 1e-10 );
+  EXPECT_NEAR( 0.0, maximumDifference( output, sitk::Resample( img, reference, transform, sitk::sitkLinear, -1.0 ) ), 1e-4 );
+
+  output = linearOperator.Execute( vectorImg, -2.0, sitk::sitkVectorFloat64 );
+  EXPECT_EQ( 2u, output.GetNumberOfComponentsPerPixel() );
+  const sitk::Image expected = sitk::Resample( vectorImg, reference, transform, sitk::sitkLinear, -2.0, sitk::sitkVectorFloat64 );
+  for ( unsigned int c = 0; c < 2u; ++c )
+    {
+    EXPECT_NEAR( 0.0, maximumDifference( sitk::VectorIndexSelectionCast( output, c ), sitk::VectorIndexSelectionCast( expected, c ) ), 1e-4 );
+    }
+
+  const sitk::ResamplingOperator nearestOperator( transform, labels, reference, sitk::sitkNearestNeighbor );
+  output = nearestOperator.Execute( labels );
+  EXPECT_EQ( sitk::sitkUInt8, output.GetPixelID() );
+  EXPECT_EQ( 0.0, maximumDifference( output, sitk::Resample( labels, reference, transform, sitk::sitkNearestNeighbor ) ) );
+
+  // serialization
+  const std::string filename = dataFinder.GetOutputFile( "BasicFilters.ResamplingOperator.bin" );
+  linearOperator.WriteToFile( filename );
+  sitk::ResamplingOperator readOperator;
+  EXPECT_EQ( 0u, readOperator.GetNumberOfWeights() );
+  readOperator.ReadFromFile( filename );
+  EXPECT_EQ( linearOperator.GetNumberOfWeights(), readOperator.GetNumberOfWeights() );
+  EXPECT_EQ( linearOperator.GetOutputSize(), readOperator.GetOutputSize() );
+  EXPECT_VECTOR_DOUBLE_NEAR( linearOperator.GetOutputSpacing(), readOperator.GetOutputSpacing(), 0.0 );
+  EXPECT_EQ( 0.0, maximumDifference( readOperator.Execute( img, -1.0 ), linearOperator.Execute( img, -1.0 ) ) );
+
+  EXPECT_THROW( readOperator.ReadFromFile( dataFinder.GetOutputFile( "BasicFilters.ResamplingOperator.missing" ) ), sitk::GenericException );
+  EXPECT_THROW( sitk::ResamplingOperator( transform, img, reference, sitk::sitkBSpline ), sitk::GenericException );
+  EXPECT_THROW( linearOperator.Execute( reference ), sitk::GenericException );
+  EXPECT_THROW( linearOperator.Execute( img, 0.0, sitk::sitkVectorFloat32 ), sitk::GenericException );
+}
+
 TEST(BasicFilters,OtsuThreshold_CheckNamesInputCompatibility)
 {
   namespace sitk = itk::simple;
@@ -1392,6 +4502,59 @@ TEST(BasicFilters, PasteImageFilter_3D_2D)
 
 }
 
+TEST(BasicFilters, PasteImageFilter_Batched)
+{
+  namespace sitk = itk::simple;
+
+  sitk::Image img = sitk::Image({32,32}, sitk::sitkUInt16);
+  std::vector<sitk::Image> sources;
+  std::vector< std::vector<int> > indices;
+  for ( unsigned int i = 0; i < 5; ++i )
+    {
+    sitk::Image simg = sitk::Add( sitk::Image({7,5}, sitk::sitkUInt16), 10.0 * ( i + 1 ) );
+    simg.SetPixelAsUInt16({1,2}, 100 + i);
+    sources.push_back( simg );
+    indices.push_back( { static_cast<int>( 6 * i ) - 3, static_cast<int>( 5 * i ) } );
+    }
+
+  // the same as pasting the sources one at a time, with the
+  // overlapping sources and the sources outside the destination
+  sitk::PasteImageFilter paster;
+  sitk::Image expected = img;
+  for ( unsigned int i = 0; i < sources.size(); ++i )
+    {
+    paster.SetSourceSize( sources[i].GetSize() );
+    paster.SetDestinationIndex( indices[i] );
+    expected = paster.Execute( expected, sources[i] );
+    }
+
+  sitk::Image output = paster.Execute( img, sources, indices );
+  EXPECT_EQ( sitk::Hash( expected ), sitk::Hash( output ) );
+  EXPECT_EQ( 0, img.GetPixelAsUInt16({4, 0}) );
+  EXPECT_EQ( 20, output.GetPixelAsUInt16({3, 5}) );
+  EXPECT_EQ( 104, output.GetPixelAsUInt16({22, 22}) );
+
+  // the buffer of a moved destination is reused
+  const void *buffer = img.GetBufferAsVoid();
+  output = sitk::Paste( std::move( img ), sources, indices );
+  EXPECT_EQ( buffer, output.GetBufferAsVoid() );
+  EXPECT_EQ( sitk::Hash( expected ), sitk::Hash( output ) );
+
+  // the slices of a volume
+  std::vector<sitk::Image> slices;
+  std::vector< std::vector<int> > sliceIndices;
+  for ( unsigned int z = 0; z < 6; ++z )
+    {
+    slices.push_back( sitk::Add( sitk::Image({9,8}, sitk::sitkFloat32), z ) );
+    sliceIndices.push_back( { 0, 0, static_cast<int>( z ) } );
+    }
+  const sitk::Image volume = sitk::Paste( sitk::Image({9,8,6}, sitk::sitkFloat32), slices, sliceIndices );
+  EXPECT_EQ( sitk::Hash( sitk::JoinSeries( slices ) ), sitk::Hash( volume ) );
+
+  EXPECT_THROW( paster.Execute( volume, slices, indices ), sitk::GenericException );
+  EXPECT_THROW( paster.Execute( volume, { sources[0] }, { { 0, 0, 0 } } ), sitk::GenericException );
+}
+
 TEST(BasicFilters, N4BiasFieldCorrectionImageFilter_GetLogBiasField)
 {
   namespace sitk = itk::simple;
@@ -1419,3 +4582,28 @@ TEST(BasicFilters, N4BiasFieldCorrectionImageFilter_GetLogBiasField)
   EXPECT_VECTOR_DOUBLE_NEAR( reference.GetDirection(), logBiasField.GetDirection(), 1e-8 );
 
 }
+
+TEST(BasicFilters, N4BiasFieldCorrectionImageFilter_ShrinkFactor)
+{
+  namespace sitk = itk::simple;
+  sitk::Image img = sitk::ReadImage( dataFinder.GetFile( "Input/cthead1-Float.mha" ) );
+  sitk::Image mask = sitk::ReadImage( dataFinder.GetFile( "Input/2th_cthead1.mha" ), sitk::sitkUInt8 );
+
+  sitk::N4BiasFieldCorrectionImageFilter n4;
+  EXPECT_EQ( 1u, n4.GetShrinkFactor() );
+  n4.SetMaximumNumberOfIterations( std::vector<uint32_t>( 2, 20 ) );
+  n4.SetShrinkFactor( 4 );
+  EXPECT_EQ( 4u, n4.GetShrinkFactor() );
+
+  sitk::Image output = n4.Execute( img, mask );
+  EXPECT_EQ( img.GetSize(), output.GetSize() );
+  EXPECT_EQ( img.GetPixelID(), output.GetPixelID() );
+  EXPECT_GT( n4.GetElapsedIterations(), 0u );
+
+  // the output is the input corrected by the log bias field of the
+  // fitting on the shrunk image
+  sitk::Image expected = sitk::Divide( img, sitk::Exp( n4.GetLogBiasFieldAsImage( img ) ) );
+  sitk::StatisticsImageFilter stats;
+  stats.Execute( sitk::Abs( sitk::Subtract( expected, output ) ) );
+  EXPECT_LT( stats.GetMaximum(), 1e-2 );
+}
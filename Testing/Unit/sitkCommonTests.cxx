@@ -20,14 +20,20 @@
 #include <sitkConditional.h>
 #include <sitkCommand.h>
 #include <sitkFunctionCommand.h>
+#include <sitkAbsImageFilter.h>
 #include <sitkCastImageFilter.h>
+#include <sitkImageOperators.h>
 
 #include <sitkKernel.h>
 #include <sitkVersion.h>
 #include <sitkVersionConfig.h>
 #include <itkConfigure.h>
 #include "sitkLogger.h"
+#include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iterator>
 
 #include "itkMacro.h"
 
@@ -91,6 +97,39 @@ TEST( ProcessObject, GlobalWarning ) {
 
 }
 
+TEST( ProcessObject, GlobalMetaDataPropagation ) {
+  namespace sitk = itk::simple;
+
+  EXPECT_TRUE( sitk::ProcessObject::GetGlobalMetaDataPropagation() );
+
+  sitk::Image img( 10, 10, sitk::sitkFloat32 );
+  img.SetMetaData( "key", "value" );
+
+  // the output of an ITK filter carries the input dictionary
+  sitk::Image out = sitk::Abs( img );
+  ASSERT_TRUE( out.HasMetaDataKey( "key" ) );
+  EXPECT_EQ( "value", out.GetMetaData( "key" ) );
+  EXPECT_EQ( "value", sitk::Cast( img, sitk::sitkInt16 ).GetMetaData( "key" ) );
+
+  sitk::ProcessObject::GlobalMetaDataPropagationOff();
+  EXPECT_FALSE( sitk::ProcessObject::GetGlobalMetaDataPropagation() );
+
+  // the image keeps its meta-data, which is not given to the filter
+  out = sitk::Abs( img );
+  EXPECT_EQ( "value", img.GetMetaData( "key" ) );
+  EXPECT_FALSE( out.HasMetaDataKey( "key" ) );
+  EXPECT_FALSE( sitk::Cast( img, sitk::sitkInt16 ).HasMetaDataKey( "key" ) );
+
+  sitk::ProcessObject::GlobalMetaDataPropagationOn();
+  EXPECT_TRUE( sitk::ProcessObject::GetGlobalMetaDataPropagation() );
+
+  sitk::ProcessObject::SetGlobalMetaDataPropagation( false );
+  EXPECT_FALSE( sitk::ProcessObject::GetGlobalMetaDataPropagation() );
+
+  sitk::ProcessObject::SetGlobalMetaDataPropagation( true );
+  EXPECT_TRUE( sitk::ProcessObject::GetGlobalMetaDataPropagation() );
+}
+
 
 TEST( ProcessObject, Command_Register ) {
   // Test the references between Process Objects and command.
@@ -607,6 +646,301 @@ TEST( ProcessObject, Threads )
   EXPECT_EQ( "POOL", strupper(sitk::ProcessObject::GetGlobalDefaultThreader()) );
 }
 
+TEST( ProcessObject, ImageBufferAllocator )
+{
+  namespace sitk = itk::simple;
+
+  EXPECT_EQ( "DEFAULT", sitk::ProcessObject::GetGlobalDefaultImageBufferAllocator() );
+  EXPECT_FALSE( sitk::ProcessObject::SetGlobalDefaultImageBufferAllocator("NotAnAllocator") );
+
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultImageBufferAllocator("aligned") );
+  EXPECT_EQ( "ALIGNED", sitk::ProcessObject::GetGlobalDefaultImageBufferAllocator() );
+  {
+  sitk::Image img( 17, 13, sitk::sitkFloat64 );
+  EXPECT_EQ( 0u, reinterpret_cast<uintptr_t>( img.GetBufferAsDouble() ) % 64u );
+  EXPECT_EQ( 0.0, img.GetPixelAsDouble( {16, 12} ) );
+  }
+
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultImageBufferAllocator("POOL") );
+  {
+  sitk::Image img( {64, 64}, sitk::sitkVectorFloat32, 3 );
+  }
+  const uint64_t allocated = sitk::ProcessObject::GetGlobalImageBufferBytesAllocated();
+  const uint64_t reused = sitk::ProcessObject::GetGlobalImageBufferBytesReused();
+  {
+  // the released buffer is recycled and initialized
+  sitk::Image img( {64, 64}, sitk::sitkVectorFloat32, 3 );
+  EXPECT_EQ( allocated, sitk::ProcessObject::GetGlobalImageBufferBytesAllocated() );
+  EXPECT_LT( reused, sitk::ProcessObject::GetGlobalImageBufferBytesReused() );
+  EXPECT_EQ( std::vector<float>( 3, 0.0f ), img.GetPixelAsVectorFloat32( {63, 63} ) );
+  }
+
+  // a buffer from the pool may outlive the pool
+  sitk::Image pooled( 32, 32, sitk::sitkUInt8 );
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultImageBufferAllocator("HugePages") );
+  sitk::Image large( 1024, 1024, 4, sitk::sitkUInt8 );
+  pooled = large;
+
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultImageBufferAllocator("DEFAULT") );
+}
+
+TEST( ProcessObject, NUMAPolicy )
+{
+  namespace sitk = itk::simple;
+
+  ASSERT_LE( 1u, sitk::ProcessObject::GetNumberOfNUMANodes() );
+  size_t numberOfCPUs = 0;
+  for ( unsigned int node = 0; node < sitk::ProcessObject::GetNumberOfNUMANodes(); ++node )
+    {
+    numberOfCPUs += sitk::ProcessObject::GetNUMANodeCPUs( node ).size();
+    }
+  EXPECT_LE( 1u, numberOfCPUs );
+  EXPECT_TRUE( sitk::ProcessObject::GetNUMANodeCPUs( sitk::ProcessObject::GetNumberOfNUMANodes() ).empty() );
+
+  EXPECT_EQ( "NONE", sitk::ProcessObject::GetGlobalDefaultNUMAPolicy() );
+  EXPECT_FALSE( sitk::ProcessObject::SetGlobalDefaultNUMAPolicy("NotAPolicy") );
+
+  for ( const char * policy : { "first_touch", "INTERLEAVE" } )
+    {
+    EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultNUMAPolicy( policy ) );
+    // large enough to be initialized in parallel
+    sitk::Image img( {512, 512, 8}, sitk::sitkFloat32 );
+    EXPECT_EQ( 0.0f, img.GetPixelAsFloat( {0, 0, 0} ) );
+    EXPECT_EQ( 0.0f, img.GetPixelAsFloat( {511, 511, 7} ) );
+    sitk::Image vimg( {512, 512, 2}, sitk::sitkVectorFloat64, 3 );
+    EXPECT_EQ( std::vector<double>( 3, 0.0 ), vimg.GetPixelAsVectorFloat64( {511, 511, 1} ) );
+    }
+
+  EXPECT_TRUE( sitk::ProcessObject::SetGlobalDefaultNUMAPolicy("none") );
+  EXPECT_EQ( "NONE", sitk::ProcessObject::GetGlobalDefaultNUMAPolicy() );
+}
+
+TEST( ProcessObject, Executor )
+{
+  namespace sitk = itk::simple;
+
+  sitk::Executor executor( 4 );
+  executor.SetMaximumNumberOfThreadsPerExecution( 3 );
+  EXPECT_EQ( 4u, executor.GetMaximumNumberOfThreads() );
+  EXPECT_EQ( 3u, executor.AcquireThreads( 8 ) );
+  EXPECT_EQ( 1u, executor.AcquireThreads( 2 ) );
+  // a share is always granted when the budget is used
+  EXPECT_EQ( 1u, executor.AcquireThreads( 2 ) );
+  EXPECT_EQ( 5u, executor.GetNumberOfActiveThreads() );
+  EXPECT_EQ( 3u, executor.GetNumberOfActiveExecutions() );
+  executor.ReleaseThreads( 1 );
+  executor.ReleaseThreads( 1 );
+  executor.ReleaseThreads( 3 );
+  EXPECT_EQ( 0u, executor.GetNumberOfActiveThreads() );
+  EXPECT_EQ( 0u, executor.GetNumberOfActiveExecutions() );
+  executor.SetMaximumNumberOfThreadsPerExecution( 0 );
+
+  sitk::CastImageFilter caster;
+  EXPECT_FALSE( caster.HasExecutor() );
+  EXPECT_ANY_THROW( caster.GetExecutor() );
+  caster.SetExecutor( executor );
+  EXPECT_EQ( executor, caster.GetExecutor() );
+  caster.SetNumberOfThreads( 8 );
+  caster.SetOutputPixelType( sitk::sitkFloat32 );
+
+  unsigned int activeThreads = 0;
+  caster.AddCommand( sitk::sitkStartEvent, [&activeThreads, &executor] {
+    activeThreads = executor.GetNumberOfActiveThreads(); } );
+
+  // threads held by another execution reduce the grant
+  const unsigned int held = executor.AcquireThreads( 3 );
+  caster.Execute( sitk::Image( 10, 10, sitk::sitkUInt8 ) );
+  EXPECT_EQ( 4u, activeThreads );
+  EXPECT_EQ( held, executor.GetNumberOfActiveThreads() );
+  executor.ReleaseThreads( held );
+
+  caster.Execute( sitk::Image( 10, 10, sitk::sitkUInt8 ) );
+  EXPECT_EQ( 4u, activeThreads );
+  EXPECT_EQ( 0u, executor.GetNumberOfActiveThreads() );
+
+  EXPECT_FALSE( sitk::ProcessObject::HasGlobalDefaultExecutor() );
+  sitk::ProcessObject::SetGlobalDefaultExecutor( executor );
+  EXPECT_EQ( executor, sitk::CastImageFilter().GetExecutor() );
+  sitk::ProcessObject::RemoveGlobalDefaultExecutor();
+  EXPECT_FALSE( sitk::CastImageFilter().HasExecutor() );
+}
+
+
+TEST( ProcessObject, ExecutionMeasurements )
+{
+  namespace sitk = itk::simple;
+
+  sitk::CastImageFilter caster;
+  EXPECT_EQ( 0.0, caster.GetLastExecutionWallTime() );
+  EXPECT_EQ( 0u, caster.GetLastExecutionNumberOfThreads() );
+  EXPECT_EQ( 0u, caster.GetLastExecutionBytesAllocated() );
+
+  const std::string fileName = dataFinder.GetOutputDirectory() + "/ProcessObject_ExecutionMeasurements.json";
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalTraceFileName() );
+  sitk::ProcessObject::SetGlobalTraceFileName( fileName );
+  EXPECT_EQ( fileName, sitk::ProcessObject::GetGlobalTraceFileName() );
+
+  caster.SetNumberOfThreads( 2 );
+  caster.SetOutputPixelType( sitk::sitkFloat32 );
+  caster.Execute( sitk::Image( 10, 10, sitk::sitkUInt8 ) );
+
+  sitk::ProcessObject::SetGlobalTraceFileName( "" );
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalTraceFileName() );
+
+  EXPECT_GE( caster.GetLastExecutionWallTime(), 0.0 );
+  EXPECT_GE( caster.GetLastExecutionCPUTime(), 0.0 );
+  EXPECT_EQ( 2u, caster.GetLastExecutionNumberOfThreads() );
+  EXPECT_EQ( 10u*10u*sizeof(float), caster.GetLastExecutionBytesAllocated() );
+
+  std::ifstream trace( fileName.c_str() );
+  const std::string contents( (std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>() );
+  EXPECT_EQ( '[', contents.front() );
+  EXPECT_NE( std::string::npos, contents.find( "\"name\":\"CastImageFilter\"" ) );
+  EXPECT_NE( std::string::npos, contents.find( "\"ph\":\"X\"" ) );
+  EXPECT_NE( std::string::npos, contents.find( "]" ) );
+
+  EXPECT_ANY_THROW( sitk::ProcessObject::SetGlobalTraceFileName( dataFinder.GetOutputDirectory() + "/no_such_directory/trace.json" ) );
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalTraceFileName() );
+}
+
+
+TEST( ProcessObject, ExecutionLog )
+{
+  namespace sitk = itk::simple;
+
+  EXPECT_EQ( 0u, sitk::ProcessObject::GetGlobalExecutionLogCapacity() );
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalExecutionLog() );
+
+  sitk::CastImageFilter caster;
+  caster.SetOutputPixelType( sitk::sitkFloat32 );
+  caster.Execute( sitk::Image( 10, 12, sitk::sitkUInt8 ) );
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalExecutionLog() );
+
+  sitk::ProcessObject::SetGlobalExecutionLogCapacity( 2 );
+  EXPECT_EQ( 2u, sitk::ProcessObject::GetGlobalExecutionLogCapacity() );
+  caster.SetNumberOfThreads( 2 );
+  caster.Execute( sitk::Image( 10, 12, sitk::sitkUInt8 ) );
+
+  std::string log = sitk::ProcessObject::GetGlobalExecutionLog();
+  EXPECT_EQ( 1, std::count( log.begin(), log.end(), '\n' ) );
+  EXPECT_NE( std::string::npos, log.find( "\"name\":\"CastImageFilter\"" ) );
+  EXPECT_NE( std::string::npos, log.find( "\"threads\":2" ) );
+  EXPECT_NE( std::string::npos, log.find( "\"input_size\":[10,12]" ) );
+  EXPECT_NE( std::string::npos, log.find( "\"output_size\":[10,12]" ) );
+  EXPECT_NE( std::string::npos, log.find( "OutputPixelType: " ) );
+
+  // the oldest entries are replaced
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    caster.Execute( sitk::Image( 10 + i, 12, sitk::sitkUInt8 ) );
+    }
+  log = sitk::ProcessObject::GetGlobalExecutionLog();
+  EXPECT_EQ( 2, std::count( log.begin(), log.end(), '\n' ) );
+  EXPECT_EQ( std::string::npos, log.find( "\"input_size\":[10,12]" ) );
+  EXPECT_NE( std::string::npos, log.find( "\"input_size\":[11,12]" ) );
+  EXPECT_NE( std::string::npos, log.find( "\"input_size\":[12,12]" ) );
+
+  sitk::ProcessObject::ClearGlobalExecutionLog();
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalExecutionLog() );
+
+  const std::string fileName = dataFinder.GetOutputDirectory() + "/ProcessObject_ExecutionLog.jsonl";
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalExecutionLogCrashFileName() );
+  sitk::ProcessObject::SetGlobalExecutionLogCrashFileName( fileName );
+  EXPECT_EQ( fileName, sitk::ProcessObject::GetGlobalExecutionLogCrashFileName() );
+  sitk::ProcessObject::SetGlobalExecutionLogCrashFileName( "" );
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalExecutionLogCrashFileName() );
+
+  sitk::ProcessObject::SetGlobalExecutionLogCapacity( 0 );
+  EXPECT_EQ( 0u, sitk::ProcessObject::GetGlobalExecutionLogCapacity() );
+  EXPECT_EQ( "", sitk::ProcessObject::GetGlobalExecutionLog() );
+}
+
+
+TEST( ProcessObject, Command_ProgressLimits )
+{
+  namespace sitk = itk::simple;
+
+  sitk::CastImageFilter caster;
+  caster.SetOutputPixelType( sitk::sitkFloat32 );
+  caster.SetNumberOfWorkUnits( 64 );
+  sitk::Image img( 256, 256, sitk::sitkUInt8 );
+
+  unsigned int allCount = 0;
+  caster.AddCommand( sitk::sitkProgressEvent, [&allCount] { ++allCount; } );
+
+  unsigned int limitedCount = 0;
+  float lastProgress = 0.0f;
+  caster.AddCommand( sitk::sitkProgressEvent, [&limitedCount, &lastProgress, &caster] {
+    ++limitedCount;
+    lastProgress = caster.GetProgress(); }, 0.0, 1.0f );
+
+  unsigned int startCount = 0;
+  caster.AddCommand( sitk::sitkStartEvent, [&startCount] { ++startCount; }, 3600.0 );
+
+  caster.Execute( img );
+  EXPECT_EQ( 1u, startCount );
+  EXPECT_LE( limitedCount, allCount );
+  // only the first and the completed events
+  EXPECT_EQ( 2u, limitedCount );
+  EXPECT_EQ( 1.0f, lastProgress );
+
+  // the limits are restarted with each execution
+  caster.Execute( img );
+  EXPECT_EQ( 2u, startCount );
+  EXPECT_EQ( 4u, limitedCount );
+}
+
+
+TEST( ProcessObject, CancellationToken )
+{
+  namespace sitk = itk::simple;
+
+  sitk::CancellationToken token;
+  EXPECT_FALSE( token.IsCancelled() );
+  EXPECT_FALSE( token.HasDeadline() );
+  EXPECT_EQ( 0.0, token.GetRemainingTime() );
+
+  token.SetDeadline( 3600.0 );
+  EXPECT_TRUE( token.HasDeadline() );
+  EXPECT_FALSE( token.IsCancelled() );
+  EXPECT_LT( 3500.0, token.GetRemainingTime() );
+  token.SetDeadline( -1.0 );
+  EXPECT_TRUE( token.IsCancelled() );
+  token.RemoveDeadline();
+  EXPECT_FALSE( token.IsCancelled() );
+
+  // copies share the state
+  sitk::CancellationToken copy( token );
+  EXPECT_EQ( token, copy );
+  EXPECT_NE( token, sitk::CancellationToken() );
+  copy.Cancel();
+  EXPECT_TRUE( token.IsCancelled() );
+  token.Reset();
+  EXPECT_FALSE( copy.IsCancelled() );
+  EXPECT_FALSE( token.ToString().empty() );
+
+  sitk::CastImageFilter caster;
+  caster.SetOutputPixelType( sitk::sitkFloat32 );
+  EXPECT_FALSE( caster.HasCancellationToken() );
+  EXPECT_ANY_THROW( caster.GetCancellationToken() );
+  caster.SetCancellationToken( token );
+  EXPECT_EQ( token, caster.GetCancellationToken() );
+
+  sitk::Image img( 256, 256, sitk::sitkUInt8 );
+  EXPECT_NO_THROW( caster.Execute( img ) );
+
+  token.Cancel();
+  bool started = false;
+  caster.AddCommand( sitk::sitkStartEvent, [&started] { started = true; } );
+  EXPECT_THROW( caster.Execute( img ), sitk::GenericException );
+  EXPECT_FALSE( started );
+
+  caster.RemoveCancellationToken();
+  EXPECT_FALSE( caster.HasCancellationToken() );
+  EXPECT_NO_THROW( caster.Execute( img ) );
+  EXPECT_TRUE( started );
+}
+
 TEST( Command, Test2 ) {
   // Check basic name functionality
   namespace sitk = itk::simple;
@@ -885,3 +1219,63 @@ TEST(Logger, MockLogger)
   EXPECT_EQ( testing::internal::GetCapturedStderr(), expectedLogOutput);
 
 }
+
+
+TEST(ImageCompare, Difference)
+{
+  namespace sitk = itk::simple;
+
+  sitk::Image baseline( 300, 300, sitk::sitkFloat32 );
+  sitk::Image image( baseline );
+  image.SetPixelAsFloat( { 10, 10 }, 3.0f );
+  image.SetPixelAsFloat( { 20, 20 }, -4.0f );
+
+  ImageCompare::Difference difference = ImageCompare::computeDifference( image, baseline, 1.0, false );
+  EXPECT_FALSE( difference.incomplete );
+  EXPECT_DOUBLE_EQ( difference.minimum, 0.0 );
+  EXPECT_DOUBLE_EQ( difference.maximum, 4.0 );
+  EXPECT_DOUBLE_EQ( difference.mean, 7.0 / ( 300 * 300 ) );
+  EXPECT_DOUBLE_EQ( difference.rms, std::sqrt( 25.0 / ( 300 * 300 ) ) );
+  EXPECT_EQ( difference.mismatches, 2u );
+
+  // the same values when the pixel types are different
+  ImageCompare::Difference castDifference = ImageCompare::computeDifference( image, sitk::Cast( baseline, sitk::sitkInt16 ), 1.0, false );
+  EXPECT_DOUBLE_EQ( castDifference.rms, difference.rms );
+  EXPECT_EQ( castDifference.mismatches, 2u );
+
+  // the components of a vector are averaged
+  sitk::Image vectorBaseline( 300, 300, sitk::sitkVectorFloat64, 2 );
+  sitk::Image vectorImage( vectorBaseline );
+  vectorImage.SetPixelAsVectorFloat64( { 5, 5 }, { 2.0, 2.0 } );
+  difference = ImageCompare::computeDifference( vectorImage, vectorBaseline, 0.0, false );
+  EXPECT_DOUBLE_EQ( difference.maximum, 2.0 );
+  EXPECT_EQ( difference.mismatches, 1u );
+
+  // stopping early gives a lower bound which exceeds the tolerance
+  sitk::Image large( 512, 512, sitk::sitkUInt8 );
+  large = large + 10;
+  difference = ImageCompare::computeDifference( large, sitk::Image( 512, 512, sitk::sitkUInt8 ), 1.0, true );
+  EXPECT_GT( difference.rms, 1.0 );
+  EXPECT_LE( difference.rms, 10.0 );
+  EXPECT_DOUBLE_EQ( difference.maximum, 10.0 );
+
+  EXPECT_THROW( ImageCompare::computeDifference( image, sitk::Image( 30, 30, sitk::sitkFloat32 ), 0.0, false ), std::exception );
+
+  // the images must have the same origin, spacing and direction
+  sitk::Image moved( baseline );
+  moved.SetOrigin( { 0.5, 0.0 } );
+  EXPECT_THROW( ImageCompare::computeDifference( moved, baseline, 0.0, false ), std::invalid_argument );
+  moved = baseline;
+  moved.SetSpacing( { 1.0, 2.0 } );
+  EXPECT_THROW( ImageCompare::computeDifference( moved, baseline, 0.0, false ), std::invalid_argument );
+  moved = baseline;
+  moved.SetDirection( { 0.0, 1.0, 1.0, 0.0 } );
+  EXPECT_THROW( ImageCompare::computeDifference( moved, baseline, 0.0, false ), std::invalid_argument );
+  moved = baseline;
+  moved.SetOrigin( { 1e-9, 0.0 } );
+  EXPECT_NO_THROW( ImageCompare::computeDifference( moved, baseline, 0.0, false ) );
+
+  ImageCompare imageCompare;
+  moved.SetOrigin( { 0.5, 0.0 } );
+  EXPECT_LT( imageCompare.testImages( moved, baseline, false, "baseline.nrrd" ), 0.0f );
+}
@@ -4,8 +4,12 @@
 #include "sitkImageFileReader.h"
 #include "sitkImageFileWriter.h"
 #include "sitkBinaryThresholdImageFilter.h"
+#include "sitkLogger.h"
+
+#include "itkMultiThreaderBase.h"
 
 #include <fstream>
+#include <sstream>
 
 namespace itk {
   namespace simple {
@@ -347,7 +351,282 @@ TEST( ElastixImageFilter, SetNumberOfThreads )
   EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
   EXPECT_NO_THROW( silx.SetParameter("MaximumNumberOfIterations", "1" ) );
   EXPECT_NO_THROW( silx.SetNumberOfThreads( 1 ) );
+  EXPECT_EQ( silx.GetNumberOfThreads(), 1 );
+
+  // the global maximum number of threads set by elastix is restored
+  const itk::ThreadIdType globalMaximumNumberOfThreads = itk::MultiThreaderBase::GetGlobalMaximumNumberOfThreads();
   EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( itk::MultiThreaderBase::GetGlobalMaximumNumberOfThreads(), globalMaximumNumberOfThreads );
+  EXPECT_NO_THROW( silx.ExecuteBatch( { fixedImage }, { movingImage, movingImage } ) );
+  EXPECT_EQ( itk::MultiThreaderBase::GetGlobalMaximumNumberOfThreads(), globalMaximumNumberOfThreads );
+}
+
+
+namespace {
+// A logger which saves the text of the ITK output window.
+class StringLogger
+  : public LoggerBase
+{
+public:
+  void DisplayText( const char * t ) override { m_Text << t; }
+
+  std::stringstream m_Text;
+};
+}
+
+TEST( ElastixImageFilter, InMemory )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  // the output directory does not exist, and must not be written to
+  const std::string outputDirectory = dataFinder.GetOutputFile( "ElastixImageFilter.InMemory.missing" );
+
+  ElastixImageFilter silx;
+  EXPECT_FALSE( silx.GetInMemory() );
+  EXPECT_NO_THROW( silx.InMemoryOn() );
+  EXPECT_TRUE( silx.GetInMemory() );
+  EXPECT_NO_THROW( silx.SetFixedImage( fixedImage ) );
+  EXPECT_NO_THROW( silx.SetMovingImage( movingImage ) );
+  EXPECT_NO_THROW( silx.SetParameter( "MaximumNumberOfIterations", "8" ) );
+  EXPECT_NO_THROW( silx.SetParameter( "WriteIterationInfo", "true" ) );
+  EXPECT_NO_THROW( silx.SetOutputDirectory( outputDirectory ) );
+  EXPECT_NO_THROW( silx.LogToFileOn() );
+  EXPECT_NO_THROW( silx.LogToConsoleOn() );
+
+  StringLogger logger;
+  ITKLogger previousLogger = logger.SetAsGlobalITKLogger();
+  Image resultImage;
+  EXPECT_NO_THROW( resultImage = silx.Execute() );
+  previousLogger.SetAsGlobalITKLogger();
+
+  EXPECT_FALSE( silxIsEmpty( resultImage ) );
+  EXPECT_GT( silx.GetTransformParameterMap().size(), 0u );
+  EXPECT_FALSE( logger.m_Text.str().empty() );
+  EXPECT_FALSE( std::ifstream( outputDirectory + "/elastix.log" ).good() );
+  EXPECT_FALSE( std::ifstream( outputDirectory + "/TransformParameters.0.txt" ).good() );
+
+  EXPECT_NO_THROW( silx.InMemoryOff() );
+  EXPECT_FALSE( silx.GetInMemory() );
+}
+
+TEST( ElastixImageFilter, ExecuteBatch )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  typedef ElastixImageFilter::ParameterMapVectorType ParameterMapVectorType;
+  ElastixImageFilter::ParameterMapType translation = GetDefaultParameterMap( "translation" );
+  translation[ "MaximumNumberOfIterations" ] = ElastixImageFilter::ParameterValueVectorType( 1, "8" );
+  ElastixImageFilter::ParameterMapType affine = GetDefaultParameterMap( "affine" );
+  affine[ "MaximumNumberOfIterations" ] = ElastixImageFilter::ParameterValueVectorType( 1, "8" );
+
+  ElastixImageFilter silx;
+  silx.LogToConsoleOff();
+  silx.SetNumberOfThreads( 4 );
+
+  std::vector< Image > resultImages;
+  EXPECT_NO_THROW( resultImages = silx.ExecuteBatch( { fixedImage },
+                                                     { movingImage, movingImage, fixedImage },
+                                                     { ParameterMapVectorType( 1, translation ),
+                                                       ParameterMapVectorType( 1, affine ),
+                                                       ParameterMapVectorType( 1, translation ) } ) );
+  ASSERT_EQ( resultImages.size(), 3u );
+  for( const Image & resultImage : resultImages )
+  {
+    EXPECT_FALSE( silxIsEmpty( resultImage ) );
+    EXPECT_EQ( resultImage.GetSize(), fixedImage.GetSize() );
+  }
+
+  std::vector< ParameterMapVectorType > transformParameterMaps = silx.GetBatchTransformParameterMap();
+  ASSERT_EQ( transformParameterMaps.size(), 3u );
+  EXPECT_EQ( transformParameterMaps[ 0 ][ 0 ][ "Transform" ][ 0 ], "TranslationTransform" );
+  EXPECT_EQ( transformParameterMaps[ 1 ][ 0 ][ "Transform" ][ 0 ], "AffineTransform" );
+
+  EXPECT_THROW( silx.ExecuteBatch( { fixedImage, fixedImage }, { movingImage, movingImage, movingImage } ), GenericException );
+}
+
+
+TEST( ElastixImageFilter, Commands )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  ElastixImageFilter::ParameterMapType parameterMap = GetDefaultParameterMap( "translation", 2 );
+  parameterMap[ "MaximumNumberOfIterations" ] = ElastixImageFilter::ParameterValueVectorType( 1, "8" );
+
+  ElastixImageFilter silx;
+  silx.LogToConsoleOff();
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.SetParameterMap( parameterMap );
+
+  unsigned int numberOfIterations = 0;
+  unsigned int numberOfLevels = 0;
+  unsigned int numberOfEnds = 0;
+  float lastProgress = 0.0f;
+  bool progressIncreases = true;
+  silx.AddCommand( sitkIterationEvent, [&]() { ++numberOfIterations; } );
+  silx.AddCommand( sitkMultiResolutionIterationEvent, [&]() { ++numberOfLevels; } );
+  silx.AddCommand( sitkEndEvent, [&]() { ++numberOfEnds; } );
+  silx.AddCommand( sitkProgressEvent, [&]() {
+      progressIncreases = progressIncreases && silx.GetProgress() >= lastProgress;
+      lastProgress = silx.GetProgress();
+    } );
+  EXPECT_TRUE( silx.HasCommand( sitkIterationEvent ) );
+  EXPECT_FALSE( silx.HasCommand( sitkAbortEvent ) );
+
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( numberOfIterations, 16u );
+  EXPECT_EQ( numberOfLevels, 2u );
+  EXPECT_EQ( numberOfEnds, 1u );
+  EXPECT_TRUE( progressIncreases );
+  EXPECT_FLOAT_EQ( silx.GetProgress(), 1.0f );
+  EXPECT_EQ( silx.GetCurrentLevel(), 1u );
+  EXPECT_EQ( silx.GetOptimizerIteration(), 7u );
+
+  // abort at the third iteration
+  unsigned int numberOfAborts = 0;
+  silx.RemoveAllCommands();
+  EXPECT_FALSE( silx.HasCommand( sitkIterationEvent ) );
+  numberOfIterations = 0;
+  silx.AddCommand( sitkIterationEvent, [&]() {
+      if( ++numberOfIterations == 3 )
+      {
+        silx.Abort();
+      }
+    } );
+  silx.AddCommand( sitkAbortEvent, [&]() { ++numberOfAborts; } );
+  EXPECT_THROW( silx.Execute(), GenericException );
+  EXPECT_EQ( numberOfIterations, 3u );
+  EXPECT_EQ( numberOfAborts, 1u );
+  EXPECT_LT( silx.GetProgress(), 1.0f );
+}
+
+TEST( ElastixImageFilter, FixedImagePyramidCache )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  ElastixImageFilter::ParameterMapType parameterMap = GetDefaultParameterMap( "translation", 2 );
+  parameterMap[ "MaximumNumberOfIterations" ] = ElastixImageFilter::ParameterValueVectorType( 1, "8" );
+  parameterMap[ "ImageSampler" ] = ElastixImageFilter::ParameterValueVectorType( 1, "Full" );
+
+  ElastixImageFilter silx;
+  silx.LogToConsoleOff();
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.SetParameterMap( parameterMap );
+  EXPECT_FALSE( silx.GetUseFixedImagePyramidCache() );
+  EXPECT_NO_THROW( silx.Execute() );
+  const ElastixImageFilter::ParameterValueVectorType transformParameters = silx.GetTransformParameterMap( 0 )[ "TransformParameters" ];
+
+  silx.UseFixedImagePyramidCacheOn();
+  EXPECT_TRUE( silx.GetUseFixedImagePyramidCache() );
+  for( unsigned int i = 0; i < 2; ++i )
+  {
+    EXPECT_NO_THROW( silx.Execute() );
+    EXPECT_EQ( silx.GetTransformParameterMap( 0 )[ "TransformParameters" ], transformParameters );
+  }
+
+  std::vector< Image > resultImages;
+  EXPECT_NO_THROW( resultImages = silx.ExecuteBatch( { fixedImage }, { movingImage, movingImage } ) );
+  ASSERT_EQ( resultImages.size(), 2u );
+  for( const ElastixImageFilter::ParameterMapVectorType & transformParameterMaps : silx.GetBatchTransformParameterMap() )
+  {
+    EXPECT_EQ( transformParameterMaps[ 0 ].at( "TransformParameters" ), transformParameters );
+  }
+
+  silx.ClearFixedImagePyramidCache();
+  EXPECT_NO_THROW( silx.Execute() );
+  EXPECT_EQ( silx.GetTransformParameterMap( 0 )[ "TransformParameters" ], transformParameters );
+
+  silx.UseFixedImagePyramidCacheOff();
+  EXPECT_FALSE( silx.GetUseFixedImagePyramidCache() );
+}
+
+
+TEST( ElastixImageFilter, TransformParameterMapToTransform )
+{
+  typedef ElastixImageFilter::ParameterValueVectorType ParameterValueVectorType;
+
+  ElastixImageFilter::ParameterMapType translation;
+  translation[ "Transform" ] = ParameterValueVectorType( 1, "TranslationTransform" );
+  translation[ "FixedImageDimension" ] = ParameterValueVectorType( 1, "2" );
+  translation[ "TransformParameters" ] = ParameterValueVectorType{ "13", "-17.5" };
+  translation[ "InitialTransformParametersFileName" ] = ParameterValueVectorType( 1, "NoInitialTransform" );
+
+  ElastixImageFilter::ParameterMapType affine;
+  affine[ "Transform" ] = ParameterValueVectorType( 1, "AffineTransform" );
+  affine[ "FixedImageDimension" ] = ParameterValueVectorType( 1, "2" );
+  affine[ "TransformParameters" ] = ParameterValueVectorType{ "2", "0", "0", "1", "1", "0" };
+  affine[ "CenterOfRotationPoint" ] = ParameterValueVectorType{ "10", "0" };
+  affine[ "HowToCombineTransforms" ] = ParameterValueVectorType( 1, "Compose" );
+
+  Transform transform;
+  EXPECT_NO_THROW( transform = TransformParameterMapToTransform( translation ) );
+  EXPECT_EQ( transform.GetName(), "TranslationTransform" );
+  EXPECT_VECTOR_DOUBLE_NEAR( transform.TransformPoint( { 1.0, 2.0 } ), std::vector< double >( { 14.0, -15.5 } ), 1e-12 );
+
+  // the translation is applied first
+  EXPECT_NO_THROW( transform = TransformParameterMapToTransform( { translation, affine } ) );
+  EXPECT_EQ( transform.GetName(), "CompositeTransform" );
+  EXPECT_VECTOR_DOUBLE_NEAR( transform.TransformPoint( { 1.0, 2.0 } ), std::vector< double >( { 19.0, -15.5 } ), 1e-12 );
+
+  affine[ "HowToCombineTransforms" ] = ParameterValueVectorType( 1, "Add" );
+  EXPECT_THROW( TransformParameterMapToTransform( { translation, affine } ), GenericException );
+
+  translation[ "Transform" ] = ParameterValueVectorType( 1, "SplineKernelTransform" );
+  EXPECT_THROW( TransformParameterMapToTransform( translation ), GenericException );
+
+  // the transform of a registration maps the points as transformix does
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  ElastixImageFilter silx;
+  silx.LogToConsoleOff();
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.SetParameterMap( "translation" );
+  silx.SetParameter( "MaximumNumberOfIterations", "8" );
+  silx.Execute();
+
+  EXPECT_NO_THROW( transform = TransformParameterMapToTransform( silx.GetTransformParameterMap() ) );
+  std::vector< double > parameters;
+  for( const std::string & value : silx.GetTransformParameterMap( 0 )[ "TransformParameters" ] )
+  {
+    parameters.push_back( std::stod( value ) );
+  }
+  EXPECT_VECTOR_DOUBLE_NEAR( transform.GetParameters(), parameters, 1e-12 );
+}
+
+
+TEST( ElastixImageFilter, SharedParameterMaps )
+{
+  // the default parameter maps are shared until edited
+  ElastixImageFilter silx1;
+  ElastixImageFilter silx2;
+  silx1.SetParameterMap( "affine" );
+  silx2.SetParameterMap( "affine" );
+  const ElastixImageFilter::ParameterMapType affine = GetDefaultParameterMap( "affine", 4, 10.0 );
+  EXPECT_EQ( silx1.GetParameterMap()[ 0 ], affine );
+
+  EXPECT_NO_THROW( silx1.SetParameter( "MaximumNumberOfIterations", 8 ) );
+  EXPECT_EQ( silx1.GetParameter( "MaximumNumberOfIterations" ), ElastixImageFilter::ParameterValueVectorType( 1, "8" ) );
+  EXPECT_EQ( silx2.GetParameterMap()[ 0 ], affine );
+  EXPECT_EQ( GetDefaultParameterMap( "affine", 4, 10.0 ), affine );
+
+  // the numbers are read back exactly
+  EXPECT_NO_THROW( silx1.SetParameter( 0, "FinalGridSpacingInPhysicalUnits", std::vector< double >( { 0.1, 2.5, -1e-20 } ) ) );
+  const ElastixImageFilter::ParameterValueVectorType values = silx1.GetParameter( "FinalGridSpacingInPhysicalUnits" );
+  ASSERT_EQ( values.size(), 3u );
+  EXPECT_EQ( values[ 0 ], "0.1" );
+  EXPECT_EQ( values[ 1 ], "2.5" );
+  EXPECT_EQ( std::stod( values[ 2 ] ), -1e-20 );
+
+  EXPECT_NO_THROW( silx1.RemoveParameter( "FinalGridSpacingInPhysicalUnits" ) );
+  EXPECT_TRUE( silx1.GetParameter( "FinalGridSpacingInPhysicalUnits" ).empty() );
+  EXPECT_THROW( silx1.SetParameter( 1, "MaximumNumberOfIterations", 8.0 ), GenericException );
 }
 
 
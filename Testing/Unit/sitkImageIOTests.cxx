@@ -18,6 +18,9 @@
 #include <SimpleITKTestHarness.h>
 #include <sitkImageFileReader.h>
 #include <sitkImageSeriesReader.h>
+#include <sitkDICOMSeriesIndex.h>
+#include <sitkDICOMSeriesConverter.h>
+#include <sitkImageFilePrefetchReader.h>
 #include <sitkImageFileWriter.h>
 #include <sitkImageSeriesWriter.h>
 #include <sitkHashImageFilter.h>
@@ -25,6 +28,18 @@
 #include <sitkAdditiveGaussianNoiseImageFilter.h>
 #include <sitkExtractImageFilter.h>
 #include <sitkRegionOfInterestImageFilter.h>
+#include <sitkCastImageFilter.h>
+#include <sitkJoinSeriesImageFilter.h>
+#include <sitkStreamingResample.h>
+#include <sitkGaussianImageSource.h>
+#include <sitkStatisticsImageFilter.h>
+#include <sitkSubtractImageFilter.h>
+#include <sitkAdditionalProcedures.h>
+#include <sitkEuler3DTransform.h>
+
+#include <fstream>
+#include <iterator>
+#include <thread>
 
 TEST(IO,ImageFileReader) {
 
@@ -47,6 +62,11 @@ TEST(IO,ImageFileReader) {
   reader.SetLoadPrivateTags(false);
   EXPECT_EQ( reader.GetLoadPrivateTags(), false );
 
+  EXPECT_EQ( reader.GetMultiscaleLevel(), 0u );
+  reader.SetMultiscaleLevel(2);
+  EXPECT_EQ( reader.GetMultiscaleLevel(), 2u );
+  reader.SetMultiscaleLevel(0);
+
   using MapType = std::map<std::string,std::string>;
   MapType mapping;
 
@@ -199,6 +219,62 @@ TEST(IO,ImageFileWriter) {
 
 }
 
+TEST(IO,ImageFileWriter_WriteRegion)
+{
+  const std::string filename = dataFinder.GetOutputFile ( "IO.ImageFileWriter_WriteRegion.mha" );
+
+  sitk::ImageFileReader reader;
+  reader.SetFileName( dataFinder.GetFile( "Input/cthead1-Float.mha" ) );
+  sitk::Image fullImage = reader.Execute();
+
+  const std::vector<unsigned int> size = fullImage.GetSize();
+  const std::vector<unsigned int> tileSize = {100, 100};
+
+  sitk::ImageFileWriter writer;
+  EXPECT_FALSE( writer.IsOpen() );
+  EXPECT_ANY_THROW( writer.WriteRegion( fullImage, {0, 0} ) );
+  EXPECT_ANY_THROW( writer.Open( size ) );
+
+  writer.SetFileName( filename );
+  writer.Open( size );
+  EXPECT_TRUE( writer.IsOpen() );
+
+  const uint64_t numberOfTiles = reader.GetNumberOfTiles( tileSize );
+  std::vector<sitk::Image> tiles;
+  std::vector<std::vector<unsigned int> > indices;
+  for ( uint64_t t = 0; t < numberOfTiles; ++t )
+    {
+    tiles.push_back( reader.ReadTile( tileSize, t ) );
+    const std::vector<int64_t> index = fullImage.TransformPhysicalPointToIndex( tiles.back().GetOrigin() );
+    indices.push_back( std::vector<unsigned int>( index.begin(), index.end() ) );
+    }
+
+  EXPECT_ANY_THROW( writer.WriteRegion( tiles[0], {size[0], 0} ) );
+  EXPECT_ANY_THROW( writer.WriteRegion( tiles[0], {0, 0, 0} ) );
+
+  // The first region creates the file, the others are written concurrently
+  writer.WriteRegion( tiles[0], indices[0] );
+  std::vector<std::thread> threads;
+  for ( uint64_t t = 1; t < numberOfTiles; ++t )
+    {
+    threads.emplace_back( [&writer, &tiles, &indices, t]() { writer.WriteRegion( tiles[t], indices[t] ); } );
+    }
+  for ( auto &thread : threads )
+    {
+    thread.join();
+    }
+
+  EXPECT_ANY_THROW( writer.WriteRegion( sitk::Cast( tiles[0], sitk::sitkUInt8 ), indices[0] ) );
+
+  writer.Close();
+  EXPECT_FALSE( writer.IsOpen() );
+
+  sitk::Image result = sitk::ReadImage( filename );
+  EXPECT_EQ( sitk::Hash( fullImage ), sitk::Hash( result ) );
+  EXPECT_VECTOR_DOUBLE_NEAR( fullImage.GetOrigin(), result.GetOrigin(), 1e-8 );
+  EXPECT_VECTOR_DOUBLE_NEAR( fullImage.GetSpacing(), result.GetSpacing(), 1e-8 );
+}
+
 TEST(IO,ImageFileWriter_Compression)
 {
   namespace sitk = itk::simple;
@@ -251,6 +327,52 @@ TEST(IO,ImageFileWriter_Compression)
   EXPECT_EQ(expectedHash, sitk::Hash(sitk::ReadImage(filename)));
 }
 
+TEST(IO,ImageFileWriter_ParallelCompression)
+{
+  sitk::Image image = sitk::Image( {128, 128, 64}, sitk::sitkUInt16 );
+  image = sitk::AdditiveGaussianNoise( image, 32.0, 100.0, 99u );
+  image.SetSpacing( {0.5, 0.75, 2.0} );
+  image.SetOrigin( {-10.0, 2.5, 3.25} );
+  image.SetDirection( {0.0, 1.0, 0.0,
+                       1.0, 0.0, 0.0,
+                       0.0, 0.0, -1.0} );
+  image.SetMetaData( "Description", "parallel compression" );
+  const std::string expectedHash = sitk::Hash( image );
+
+  sitk::ImageFileWriter writer;
+  writer.UseCompressionOn();
+  writer.SetNumberOfThreads( 4 );
+  writer.SetNumberOfWorkUnits( 8 );
+
+  for ( const std::string extension : { ".mha", ".mhd" } )
+    {
+    const std::string filename = dataFinder.GetOutputFile( "IO.ImageFileWriter_ParallelCompression" + extension );
+    writer.SetFileName( filename );
+    ASSERT_NO_THROW( writer.Execute( image ) );
+
+    sitk::Image result = sitk::ReadImage( filename );
+    EXPECT_EQ( expectedHash, sitk::Hash( result ) );
+    EXPECT_VECTOR_DOUBLE_NEAR( image.GetSpacing(), result.GetSpacing(), 1e-10 );
+    EXPECT_VECTOR_DOUBLE_NEAR( image.GetOrigin(), result.GetOrigin(), 1e-10 );
+    EXPECT_VECTOR_DOUBLE_NEAR( image.GetDirection(), result.GetDirection(), 1e-10 );
+    EXPECT_EQ( "parallel compression", result.GetMetaData( "Description" ) );
+    }
+
+  // a single block and a vector image
+  const std::string filename = dataFinder.GetOutputFile( "IO.ImageFileWriter_ParallelCompression2.mha" );
+  sitk::Image vectorImage = sitk::ReadImage( dataFinder.GetFile( "Input/fruit.png" ) );
+  writer.SetNumberOfWorkUnits( 1 );
+  writer.SetCompressionLevel( 9 );
+  writer.SetFileName( filename );
+  ASSERT_NO_THROW( writer.Execute( vectorImage ) );
+  EXPECT_EQ( sitk::Hash( vectorImage ), sitk::Hash( sitk::ReadImage( filename ) ) );
+
+  // ITK compresses on one thread
+  writer.SetNumberOfThreads( 1 );
+  ASSERT_NO_THROW( writer.Execute( vectorImage ) );
+  EXPECT_EQ( sitk::Hash( vectorImage ), sitk::Hash( sitk::ReadImage( filename ) ) );
+}
+
 TEST(IO,ReadWrite) {
   namespace sitk = itk::simple;
   sitk::HashImageFilter hasher;
@@ -432,6 +554,108 @@ TEST(IO, SeriesReader) {
 }
 
 
+TEST(IO, SeriesReader_TimeSeries) {
+
+  // a time series of 3D volumes with the same geometry
+  std::vector< std::string > fileNames;
+  std::vector< sitk::Image > volumes;
+  for ( unsigned int t = 0; t < 5; ++t )
+    {
+    sitk::Image volume( 6, 5, 4, sitk::sitkInt16 );
+    volume.SetOrigin( {1.0, 2.0, 3.0} );
+    volume.SetSpacing( {0.5, 0.5, 2.0} );
+    for ( unsigned int z = 0; z < 4; ++z )
+      {
+      volume.SetPixelAsInt16( {t, 1, z}, static_cast<int16_t>( 10 * t + z ) );
+      }
+    fileNames.push_back( dataFinder.GetOutputFile( "SeriesReader_TimeSeries_" + std::to_string( t ) + ".mha" ) );
+    sitk::WriteImage( volume, fileNames.back() );
+    volumes.push_back( volume );
+    }
+
+  sitk::ImageSeriesReader reader;
+  EXPECT_EQ( 0.0, reader.GetSeriesSpacing() );
+  EXPECT_ANY_THROW( reader.SetSeriesSpacing( -1.0 ) );
+  reader.SetSeriesSpacing( 2.5 );
+  EXPECT_EQ( 2.5, reader.GetSeriesSpacing() );
+  EXPECT_NO_THROW( reader.ToString() );
+  reader.SetFileNames( fileNames );
+
+  sitk::Image joined = sitk::JoinSeries( volumes, 0.0, 2.5 );
+
+  sitk::Image image = reader.Execute();
+  EXPECT_EQ( 4u, image.GetDimension() );
+  EXPECT_EQ( std::vector<unsigned int>( {6, 5, 4, 5} ), image.GetSize() );
+  EXPECT_EQ( std::vector<double>( {0.5, 0.5, 2.0, 2.5} ), image.GetSpacing() );
+  EXPECT_EQ( sitk::Hash( joined ), sitk::Hash( image ) );
+
+  reader.SetNumberOfParallelReads( 3 );
+  image = reader.Execute();
+  EXPECT_EQ( std::vector<unsigned int>( {6, 5, 4, 5} ), image.GetSize() );
+  EXPECT_EQ( std::vector<double>( {0.5, 0.5, 2.0, 2.5} ), image.GetSpacing() );
+  EXPECT_EQ( joined.GetOrigin(), image.GetOrigin() );
+  EXPECT_EQ( sitk::Hash( joined ), sitk::Hash( image ) );
+  EXPECT_EQ( 32, image.GetPixelAsInt16( {3, 1, 2, 3} ) );
+}
+
+
+TEST(IO, SeriesReader_Parallel) {
+
+  std::vector< std::string > fileNames;
+  fileNames.push_back( dataFinder.GetFile ( "Input/BlackDots.png" ) );
+  fileNames.push_back( dataFinder.GetFile ( "Input/WhiteDots.png" ) );
+  fileNames.push_back( dataFinder.GetFile ( "Input/BlackDots.png" ) );
+  fileNames.push_back( dataFinder.GetFile ( "Input/WhiteDots.png" ) );
+
+  sitk::ImageSeriesReader reader;
+  EXPECT_EQ( 1u, reader.GetNumberOfParallelReads() );
+  reader.SetNumberOfParallelReads( 0 );
+  EXPECT_EQ( 1u, reader.GetNumberOfParallelReads() );
+
+  reader.SetFileNames( fileNames );
+  const std::string expectedHash = sitk::Hash( reader.Execute() );
+
+  reader.SetNumberOfParallelReads( 3 );
+  EXPECT_EQ( 3u, reader.GetNumberOfParallelReads() );
+  sitk::Image image = reader.Execute();
+  EXPECT_EQ( expectedHash, sitk::Hash( image ) );
+  EXPECT_EQ( 4u, image.GetDepth() );
+
+  // with conversion of the pixel type while decoding
+  reader.SetOutputPixelType( sitk::sitkFloat32 );
+  EXPECT_EQ( sitk::Hash( sitk::Cast( sitk::ReadImage( fileNames ), sitk::sitkFloat32 ) ), sitk::Hash( reader.Execute() ) );
+  reader.SetOutputPixelType( sitk::sitkUnknown );
+
+  fileNames.assign( 3, dataFinder.GetFile ( "Input/VM1111Shrink-RGB.png" ) );
+  reader.SetFileNames( fileNames );
+  EXPECT_EQ ( "bb42b8d3991132b4860adbc4b3f6c38313f52b4c", sitk::Hash( reader.Execute() ) );
+
+  // a missing file stops the read
+  fileNames.insert( fileNames.begin() + 1, dataFinder.GetOutputFile ( "this_file_does_not_exist.png" ) );
+  reader.SetFileNames( fileNames );
+  EXPECT_ANY_THROW( reader.Execute() );
+
+  // the meta-data dictionaries match the sequential read
+  const std::string dicomDir = dataFinder.GetDirectory( ) + "/Input/DicomSeries";
+  reader.SetFileNames( sitk::ImageSeriesReader::GetGDCMSeriesFileNames( dicomDir ) );
+  reader.MetaDataDictionaryArrayUpdateOn();
+  image = reader.Execute();
+  EXPECT_EQ( "f5ad2854d68fc87a141e112e529d47424b58acfb", sitk::Hash( image ) );
+  EXPECT_EQ( 0u, image.GetMetaDataKeys().size() );
+  for ( unsigned int i = 0; i < image.GetSize()[2]; ++i )
+    {
+    std::vector<std::string> keys = reader.GetMetaDataKeys(i);
+    EXPECT_EQ( 95u, keys.size() );
+    for ( unsigned int j = 0; j < keys.size(); ++j )
+      {
+      EXPECT_TRUE( reader.HasMetaDataKey(i, keys[j]) );
+      EXPECT_NO_THROW( reader.GetMetaData(i, keys[j]) );
+      }
+    }
+  EXPECT_ANY_THROW( reader.GetMetaDataKeys(99) );
+}
+
+
 TEST(IO,Write_BadName) {
 
   sitk::Image image = sitk::ReadImage( dataFinder.GetFile ( "Input/BlackDots.png" ) );
@@ -507,6 +731,117 @@ TEST(IO, DicomSeriesReader) {
   EXPECT_ANY_THROW( reader.GetMetaDataKeys(99) );
   EXPECT_ANY_THROW( reader.HasMetaDataKey(99, "nothing") );
   EXPECT_ANY_THROW( reader.GetMetaData(99, "nothing") );
+  EXPECT_ANY_THROW( reader.GetMetaData(0, "nothing") );
+
+  // the values shared by the slices and the values of each slice
+  EXPECT_EQ( reader.GetMetaData(0, "0020|000e"), reader.GetMetaData(2, "0020|000e") );
+  EXPECT_NE( reader.GetMetaData(0, "0020|0013"), reader.GetMetaData(1, "0020|0013") );
+  EXPECT_NE( reader.GetMetaData(1, "0020|0032"), reader.GetMetaData(2, "0020|0032") );
+  EXPECT_EQ( reader.GetMetaDataKeys(0), reader.GetMetaDataKeys(2) );
+}
+
+
+TEST(IO, DICOMSeriesIndex) {
+
+  const std::string dicomDir = dataFinder.GetDirectory( ) + "/Input/DicomSeries";
+  const std::string indexFileName = dataFinder.GetOutputFile ( "IO.DICOMSeriesIndex.txt" );
+  const std::string seriesID = "1.2.840.113619.2.133.1762890640.1886.1055165015.999";
+
+  sitk::DICOMSeriesIndex index( dicomDir );
+  EXPECT_EQ( dicomDir, index.GetDirectory() );
+  EXPECT_FALSE( index.GetRecursive() );
+  EXPECT_TRUE( index.GetSeriesIDs().empty() );
+  EXPECT_TRUE( index.GetFileNames().empty() );
+
+  index.SetIndexFileName( indexFileName );
+  index.SetNumberOfThreads( 2 );
+  EXPECT_EQ( 2u, index.GetNumberOfThreads() );
+  EXPECT_NO_THROW( index.Update() );
+  EXPECT_NO_THROW( index.ToString() );
+  EXPECT_LT( 0u, index.GetNumberOfFilesParsed() );
+
+  EXPECT_EQ( sitk::ImageSeriesReader::GetGDCMSeriesIDs( dicomDir ), index.GetSeriesIDs() );
+
+  std::vector< std::string > fileNames = index.GetFileNames( seriesID );
+  EXPECT_EQ( 3u, fileNames.size() );
+  EXPECT_EQ( fileNames, index.GetFileNames() );
+
+  sitk::ImageSeriesReader reader;
+  reader.SetFileNames( fileNames );
+  EXPECT_EQ( "f5ad2854d68fc87a141e112e529d47424b58acfb", sitk::Hash( reader.Execute() ) );
+
+  // Nothing has changed so nothing is parsed again
+  index.Update();
+  EXPECT_EQ( 0u, index.GetNumberOfFilesParsed() );
+
+  // A new object loads the saved index file
+  sitk::DICOMSeriesIndex index2;
+  index2.SetDirectory( dicomDir );
+  index2.SetIndexFileName( indexFileName );
+  index2.Update();
+  EXPECT_EQ( 0u, index2.GetNumberOfFilesParsed() );
+  EXPECT_EQ( index.GetSeriesIDs(), index2.GetSeriesIDs() );
+  EXPECT_EQ( fileNames, index2.GetFileNames( seriesID ) );
+
+  EXPECT_TRUE( index2.GetFileNames( "not a series" ).empty() );
+
+  index2.SetDirectory( dicomDir + "/does_not_exist" );
+  EXPECT_ANY_THROW( index2.Update() );
+}
+
+
+TEST(IO, DICOMSeriesConverter) {
+
+  const std::string dicomDir = dataFinder.GetDirectory( ) + "/Input/DicomSeries";
+  const std::string outputDir = dataFinder.GetOutputDirectory();
+  const std::string seriesID = "1.2.840.113619.2.133.1762890640.1886.1055165015.999";
+
+  sitk::DICOMSeriesConverter converter;
+  EXPECT_EQ( "DICOMSeriesConverter", converter.GetName() );
+  EXPECT_EQ( ".nrrd", converter.GetOutputExtension() );
+  EXPECT_EQ( sitk::sitkUnknown, converter.GetOutputPixelType() );
+  EXPECT_TRUE( converter.GetOutputSpacing().empty() );
+  EXPECT_EQ( 2u, converter.GetQueueSize() );
+  converter.SetQueueSize( 0 );
+  EXPECT_EQ( 1u, converter.GetQueueSize() );
+  EXPECT_ANY_THROW( converter.SetOutputSpacing( {1.0, 0.0, 1.0} ) );
+
+  converter.SetInputDirectory( dicomDir );
+  EXPECT_ANY_THROW( converter.Execute() );
+
+  converter.SetOutputDirectory( outputDir );
+  converter.SetOutputExtension( ".mha" );
+  converter.SetNumberOfReaders( 2 );
+  converter.SetNumberOfWriters( 2 );
+  EXPECT_NO_THROW( converter.ToString() );
+  EXPECT_EQ( 1u, converter.Execute() );
+  EXPECT_TRUE( converter.GetFailedSeriesIDs().empty() );
+  ASSERT_EQ( std::vector<std::string>( {seriesID} ), converter.GetConvertedSeriesIDs() );
+  ASSERT_EQ( 1u, converter.GetOutputFileNames().size() );
+  EXPECT_EQ( outputDir + "/" + seriesID + ".mha", converter.GetOutputFileNames()[0] );
+  EXPECT_EQ( "f5ad2854d68fc87a141e112e529d47424b58acfb", sitk::Hash( sitk::ReadImage( converter.GetOutputFileNames()[0] ) ) );
+
+  sitk::Image original = sitk::ReadImage( sitk::ImageSeriesReader::GetGDCMSeriesFileNames( dicomDir ) );
+  std::vector<double> spacing = original.GetSpacing();
+  for ( double &s : spacing )
+    {
+    s *= 2.0;
+    }
+  converter.SetOutputPixelType( sitk::sitkFloat32 );
+  converter.SetOutputSpacing( spacing );
+  EXPECT_EQ( 1u, converter.Execute() );
+  sitk::Image resampled = sitk::ReadImage( converter.GetOutputFileNames()[0] );
+  EXPECT_EQ( sitk::sitkFloat32, resampled.GetPixelID() );
+  EXPECT_VECTOR_DOUBLE_NEAR( spacing, resampled.GetSpacing(), 1e-6 );
+  EXPECT_VECTOR_DOUBLE_NEAR( original.GetOrigin(), resampled.GetOrigin(), 1e-6 );
+  EXPECT_EQ( ( original.GetWidth() + 1 ) / 2, resampled.GetWidth() );
+
+  // a spacing not matching the dimension fails the series
+  converter.SetOutputSpacing( {1.0, 1.0} );
+  EXPECT_EQ( 0u, converter.Execute() );
+  EXPECT_EQ( std::vector<std::string>( {seriesID} ), converter.GetFailedSeriesIDs() );
+  EXPECT_EQ( 1u, converter.GetErrorMessages().size() );
+  EXPECT_TRUE( converter.GetOutputFileNames().empty() );
 }
 
 
@@ -612,6 +947,92 @@ TEST(IO, VectorImageSeriesWriter )
   EXPECT_EQ ( "1729319806705e94181c9b9f4bd5e0ac854935db", sitk::Hash( result ) );
 }
 
+TEST(IO, ImageSeriesWriter_Parallel )
+{
+  sitk::Image volume( 10, 12, 5, sitk::sitkUInt16 );
+  for ( unsigned int z = 0; z < volume.GetDepth(); ++z )
+    {
+    volume.SetPixelAsUInt16( { z, z+1, z }, 1000 + z );
+    }
+  volume.SetOrigin( {1.0, 2.0, 3.0} );
+  volume.SetSpacing( {0.5, 0.75, 2.0} );
+
+  std::vector< std::string > sequentialFileNames;
+  std::vector< std::string > parallelFileNames;
+  std::vector< std::string > failFileNames;
+  for ( unsigned int i = 0; i < volume.GetDepth(); ++i )
+    {
+    const std::string n = std::to_string( i ) + ".mha";
+    sequentialFileNames.push_back( dataFinder.GetOutputDirectory() + "/ImageSeriesWriter_Parallel_seq_" + n );
+    parallelFileNames.push_back( dataFinder.GetOutputDirectory() + "/ImageSeriesWriter_Parallel_" + n );
+    failFileNames.push_back( dataFinder.GetOutputDirectory() + "/ImageSeriesWriter_Parallel_fail_" + n );
+    }
+
+  sitk::ImageSeriesWriter writer;
+  EXPECT_EQ( 1u, writer.GetNumberOfParallelWrites() );
+  writer.SetNumberOfParallelWrites( 0 );
+  EXPECT_EQ( 1u, writer.GetNumberOfParallelWrites() );
+
+  writer.UseCompressionOn();
+  writer.SetFileNames( sequentialFileNames );
+  writer.Execute( volume );
+
+  writer.SetNumberOfParallelWrites( 3 );
+  EXPECT_EQ( 3u, writer.GetNumberOfParallelWrites() );
+  EXPECT_NO_THROW( writer.ToString() );
+  writer.SetFileNames( parallelFileNames );
+
+  ProgressUpdate progressCmd( writer );
+  writer.AddCommand( sitk::sitkProgressEvent, progressCmd );
+  CountCommand progressCount( writer );
+  writer.AddCommand( sitk::sitkProgressEvent, progressCount );
+  CountCommand startCmd( writer );
+  writer.AddCommand( sitk::sitkStartEvent, startCmd );
+  CountCommand endCmd( writer );
+  writer.AddCommand( sitk::sitkEndEvent, endCmd );
+
+  EXPECT_NO_THROW( writer.Execute( volume ) );
+  EXPECT_EQ( 1.0f, progressCmd.m_Progress );
+  EXPECT_GE( progressCount.m_Count, 2 );
+  EXPECT_LE( progressCount.m_Count, 6 );
+  EXPECT_EQ( 1, startCmd.m_Count );
+  EXPECT_EQ( 1, endCmd.m_Count );
+
+  for ( unsigned int i = 0; i < volume.GetDepth(); ++i )
+    {
+    sitk::Image sequential = sitk::ReadImage( sequentialFileNames[i] );
+    sitk::Image parallel = sitk::ReadImage( parallelFileNames[i] );
+    EXPECT_EQ( sitk::Hash( sequential ), sitk::Hash( parallel ) );
+    EXPECT_EQ( sequential.GetOrigin(), parallel.GetOrigin() );
+    EXPECT_EQ( sequential.GetSpacing(), parallel.GetSpacing() );
+    }
+
+  // a failing slice does not stop the others
+  const std::string badFileName = dataFinder.GetOutputDirectory() + "/no_such_directory/ImageSeriesWriter_Parallel.mha";
+  failFileNames[1] = badFileName;
+  writer.SetFileNames( failFileNames );
+  try
+    {
+    writer.Execute( volume );
+    FAIL() << "Expected an exception for the slice which can not be written.";
+    }
+  catch ( sitk::GenericException &e )
+    {
+    EXPECT_NE( std::string::npos, std::string( e.what() ).find( "Failed to write 1 of 5 slices" ) );
+    EXPECT_NE( std::string::npos, std::string( e.what() ).find( badFileName ) );
+    }
+  for ( unsigned int i : { 0u, 2u, 3u, 4u } )
+    {
+    EXPECT_EQ( sitk::Hash( sitk::ReadImage( sequentialFileNames[i] ) ), sitk::Hash( sitk::ReadImage( failFileNames[i] ) ) );
+    }
+
+  // the number of file names must match the number of slices
+  failFileNames.pop_back();
+  writer.SetFileNames( failFileNames );
+  EXPECT_ANY_THROW( writer.Execute( volume ) );
+}
+
+
 TEST(IO, ImageFileReader_ImageInformation )
 {
   const std::string dicomFile1 = dataFinder.GetDirectory( ) + "/Input/DicomSeries/Image0075.dcm";
@@ -678,6 +1099,49 @@ TEST(IO, ImageFileReader_ImageInformation )
 }
 
 
+TEST(IO, ImageFileReader_LazyMetaData )
+{
+  const std::string dicomFile1 = dataFinder.GetDirectory( ) + "/Input/DicomSeries/Image0075.dcm";
+
+  sitk::ImageFileReader eagerReader;
+  eagerReader.SetFileName(dicomFile1);
+  eagerReader.LoadPrivateTagsOn();
+  eagerReader.ReadImageInformation();
+
+  sitk::ImageFileReader reader;
+  EXPECT_FALSE(reader.GetLazyMetaDataLoading());
+  reader.LazyMetaDataLoadingOn();
+  EXPECT_TRUE(reader.GetLazyMetaDataLoading());
+  reader.LoadPrivateTagsOn();
+  reader.SetFileName(dicomFile1);
+  reader.ReadImageInformation();
+
+  EXPECT_TRUE(reader.GetLoadPrivateTags());
+  EXPECT_EQ(reader.GetPixelID(), eagerReader.GetPixelID());
+  EXPECT_VECTOR_NEAR(reader.GetSize(), eagerReader.GetSize(), 1e-10);
+  EXPECT_VECTOR_DOUBLE_NEAR(reader.GetSpacing(), eagerReader.GetSpacing(), 1e-8);
+
+  // the private tags are loaded on first access
+  EXPECT_EQ(reader.GetMetaDataKeys(), eagerReader.GetMetaDataKeys());
+  EXPECT_EQ(reader.GetMetaData( "0008|0031"), "153128");
+
+  sitk::ImageFileReader allowReader;
+  EXPECT_TRUE(allowReader.GetMetaDataKeysToLoad().empty());
+  allowReader.SetMetaDataKeysToLoad( {"0008|0031", "not a key"} );
+  EXPECT_EQ(2u, allowReader.GetMetaDataKeysToLoad().size());
+  allowReader.SetFileName(dicomFile1);
+  allowReader.LazyMetaDataLoadingOn();
+  sitk::Image image = allowReader.Execute();
+
+  EXPECT_EQ(allowReader.GetMetaDataKeys(), std::vector<std::string>{"0008|0031"});
+  EXPECT_FALSE(allowReader.HasMetaDataKey("not a key"));
+  EXPECT_EQ(allowReader.GetMetaData( "0008|0031"), "153128");
+
+  // the image meta-data is not filtered
+  EXPECT_EQ(image.GetMetaDataKeys().size(), sitk::ReadImage(dicomFile1).GetMetaDataKeys().size());
+}
+
+
 TEST(IO, ImageFileReader_SetImageIO )
 {
   namespace sitk = itk::simple;
@@ -740,6 +1204,455 @@ TEST(IO, ImageFileReader_GetImageIOFromFileName )
 }
 
 
+TEST(IO, ImageFileReader_ImageIOProbeCache )
+{
+  const std::string fileName = dataFinder.GetOutputFile( "ImageFileReader_ImageIOProbeCache.png" );
+
+  sitk::Image image( 10, 12, sitk::sitkUInt8 );
+  image.SetPixel( {2, 3}, 7 );
+
+  sitk::WriteImage( image, fileName );
+  EXPECT_EQ( "PNGImageIO", sitk::ImageFileReader::GetImageIOFromFileName( fileName ) );
+  // the second probe of the file is cached
+  EXPECT_EQ( "PNGImageIO", sitk::ImageFileReader::GetImageIOFromFileName( fileName ) );
+  EXPECT_EQ( 7u, sitk::ReadImage( fileName ).GetPixel( {2, 3} ) );
+
+  // the file is replaced by another format with the same name, which
+  // does not match the extension or the cached ImageIO
+  image.SetPixel( {2, 3}, 9 );
+  sitk::ImageFileWriter writer;
+  writer.SetImageIO( "NrrdImageIO" );
+  writer.SetFileName( fileName );
+  writer.Execute( image );
+
+  EXPECT_EQ( "NrrdImageIO", sitk::ImageFileReader::GetImageIOFromFileName( fileName ) );
+  EXPECT_EQ( "NrrdImageIO", sitk::ImageFileReader::GetImageIOFromFileName( fileName ) );
+  EXPECT_EQ( 9u, sitk::ReadImage( fileName ).GetPixel( {2, 3} ) );
+}
+
+
+TEST(IO, ImageFileReader_OpenReadRegion )
+{
+  sitk::ImageFileReader reader;
+  reader.SetFileName( dataFinder.GetFile( "Input/cthead1-Float.mha" ) );
+
+  EXPECT_FALSE( reader.IsOpen() );
+  EXPECT_ANY_THROW( reader.GetNumberOfTiles( {100, 100} ) );
+
+  sitk::Image fullImage = reader.Execute();
+  EXPECT_FALSE( reader.IsOpen() );
+
+  reader.Open();
+  EXPECT_TRUE( reader.IsOpen() );
+  EXPECT_NO_THROW( reader.ToString() );
+
+  const std::vector<int> index  = {10, 20};
+  const std::vector<unsigned int> size = {30, 40};
+  sitk::Image region = reader.ReadRegion( index, size );
+  EXPECT_EQ( size, region.GetSize() );
+  EXPECT_EQ( fullImage.TransformIndexToPhysicalPoint( {10, 20} ), region.GetOrigin() );
+  EXPECT_EQ( fullImage.GetPixelAsFloat( {10, 20} ), region.GetPixelAsFloat( {0, 0} ) );
+  EXPECT_EQ( fullImage.GetPixelAsFloat( {39, 59} ), region.GetPixelAsFloat( {29, 39} ) );
+
+  // the region read does not change the extraction settings
+  EXPECT_TRUE( reader.GetExtractSize().empty() );
+  EXPECT_TRUE( reader.GetExtractIndex().empty() );
+
+  EXPECT_EQ( sitk::Hash( fullImage ), sitk::Hash( reader.ReadRegion( {}, {} ) ) );
+  EXPECT_ANY_THROW( reader.ReadRegion( { int(fullImage.GetWidth()) - 5, 0 }, {10, 10} ) );
+
+  const std::vector<unsigned int> tileSize = {100, 100};
+  const uint64_t tilesX = ( fullImage.GetWidth() + 99 ) / 100;
+  const uint64_t numberOfTiles = reader.GetNumberOfTiles( tileSize );
+  EXPECT_EQ( tilesX * ( ( fullImage.GetHeight() + 99 ) / 100 ), numberOfTiles );
+  EXPECT_EQ( fullImage.GetHeight(), reader.GetNumberOfTiles( {0, 1} ) );
+
+  uint64_t numberOfPixels = 0;
+  for ( uint64_t t = 0; t < numberOfTiles; ++t )
+    {
+    sitk::Image tile = reader.ReadTile( tileSize, t );
+    numberOfPixels += tile.GetNumberOfPixels();
+
+    const std::vector<int64_t> tileIndex = fullImage.TransformPhysicalPointToIndex( tile.GetOrigin() );
+    EXPECT_EQ( int64_t( (t % tilesX) * 100 ), tileIndex[0] );
+    EXPECT_EQ( int64_t( (t / tilesX) * 100 ), tileIndex[1] );
+    EXPECT_EQ( fullImage.GetPixelAsFloat( { uint32_t(tileIndex[0]), uint32_t(tileIndex[1]) } ),
+               tile.GetPixelAsFloat( {0, 0} ) );
+    }
+  EXPECT_EQ( fullImage.GetNumberOfPixels(), numberOfPixels );
+  EXPECT_ANY_THROW( reader.ReadTile( tileSize, numberOfTiles ) );
+
+  // the output pixel type may change while the file is open
+  reader.SetOutputPixelType( sitk::sitkUInt8 );
+  EXPECT_EQ( sitk::sitkUInt8, reader.ReadRegion( index, size ).GetPixelID() );
+
+  reader.SetFileName( dataFinder.GetFile( "Input/fruit.png" ) );
+  EXPECT_FALSE( reader.IsOpen() );
+
+  reader.Open();
+  reader.Close();
+  EXPECT_FALSE( reader.IsOpen() );
+}
+
+
+TEST(IO, StreamingResample )
+{
+  const std::string inputFileName = dataFinder.GetOutputFile( "IO.StreamingResample.input.mha" );
+  const std::string outputFileName = dataFinder.GetOutputFile( "IO.StreamingResample.output.mha" );
+
+  const std::vector<unsigned int> inputSize = { 40, 36, 30 };
+  sitk::Image image = sitk::GaussianSource( sitk::sitkFloat32, inputSize, {8.0, 10.0, 6.0}, {20.0, 17.0, 14.0}, 100.0 );
+  image.SetOrigin( {1.0, -2.0, 3.0} );
+  sitk::WriteImage( image, inputFileName );
+
+  sitk::Euler3DTransform transform( {20.0, 16.0, 18.0}, 0.1, -0.05, 0.2, {1.5, -2.0, 0.5} );
+
+  const std::vector<uint32_t> size = { 45, 40, 23 };
+  const std::vector<double> origin = { -1.0, -3.0, 2.0 };
+  const std::vector<double> spacing = { 0.9, 0.95, 1.3 };
+
+  for ( sitk::InterpolatorEnum interpolator : { sitk::sitkLinear, sitk::sitkNearestNeighbor } )
+    {
+    sitk::ImageFileReader reader;
+    reader.SetFileName( inputFileName );
+    sitk::ImageFileWriter writer;
+    writer.SetFileName( outputFileName );
+    writer.UseCompressionOff();
+
+    sitk::StreamingResample( reader, writer, size, transform, interpolator, origin, spacing,
+                             std::vector<double>(), -1.0, sitk::sitkUnknown, 7u );
+    EXPECT_FALSE( writer.IsOpen() );
+
+    sitk::Image expected = sitk::Resample( image, size, transform, interpolator, origin, spacing,
+                                           std::vector<double>(), -1.0 );
+    sitk::Image out = sitk::ReadImage( outputFileName );
+    EXPECT_EQ( size, out.GetSize() );
+    EXPECT_VECTOR_DOUBLE_NEAR( origin, out.GetOrigin(), 1e-6 );
+    EXPECT_VECTOR_DOUBLE_NEAR( spacing, out.GetSpacing(), 1e-6 );
+
+    sitk::StatisticsImageFilter stats;
+    stats.Execute( sitk::Subtract( out, expected ) );
+    EXPECT_NEAR( 0.0, stats.GetMinimum(), 1e-4 ) << "Interpolator: " << interpolator;
+    EXPECT_NEAR( 0.0, stats.GetMaximum(), 1e-4 ) << "Interpolator: " << interpolator;
+    }
+
+  sitk::ImageFileReader reader;
+  reader.SetFileName( inputFileName );
+  sitk::ImageFileWriter writer;
+  writer.SetFileName( outputFileName );
+  EXPECT_ANY_THROW( sitk::StreamingResample( reader, writer, {45, 40}, transform ) );
+  EXPECT_ANY_THROW( sitk::StreamingResample( reader, writer, size, transform, sitk::sitkLinear,
+                                             origin, spacing, std::vector<double>(), 0.0, sitk::sitkUnknown, 0u ) );
+}
+
+
+TEST(IO, ImageFileReader_ReadInto )
+{
+  const std::string fileName = dataFinder.GetFile( "Input/cthead1-Float.mha" );
+  const sitk::Image expected = sitk::ReadImage( fileName );
+  const unsigned int width = expected.GetWidth();
+  const unsigned int height = expected.GetHeight();
+
+  sitk::ImageFileReader reader;
+  reader.SetFileName( fileName );
+
+  // slices of a volume, with conversion of the pixel type
+  sitk::Image volume( width, height, 3, sitk::sitkFloat64 );
+  reader.ReadInto( volume, {0, 0, 1} );
+  reader.ReadInto( volume, {0, 0, 2} );
+  EXPECT_EQ( sitk::sitkUnknown, reader.GetOutputPixelType() );
+
+  const sitk::Image expectedFloat64 = sitk::ReadImage( fileName, sitk::sitkFloat64 );
+  EXPECT_EQ( 0.0, volume.GetPixelAsDouble( {10, 20, 0} ) );
+  for ( unsigned int z = 1; z < 3; ++z )
+    {
+    EXPECT_EQ( sitk::Hash( expectedFloat64 ),
+               sitk::Hash( sitk::Extract( volume, {width, height, 0}, {0, 0, int(z)} ) ) );
+    }
+
+  // the destination is made unique before it is written
+  sitk::Image shared = volume;
+  reader.ReadInto( volume, {0, 0, 0} );
+  EXPECT_EQ( 0.0, shared.GetPixelAsDouble( {10, 20, 0} ) );
+  EXPECT_EQ( expectedFloat64.GetPixelAsDouble( {10, 20} ), volume.GetPixelAsDouble( {10, 20, 0} ) );
+
+  EXPECT_ANY_THROW( reader.ReadInto( volume, {1, 0, 0} ) );
+  EXPECT_ANY_THROW( reader.ReadInto( volume, {0, 0, 3} ) );
+  sitk::Image wider( width + 1, height, 1, sitk::sitkFloat32 );
+  EXPECT_ANY_THROW( reader.ReadInto( wider, {} ) );
+  sitk::Image vector( {width, height}, sitk::sitkVectorFloat32, 3 );
+  EXPECT_ANY_THROW( reader.ReadInto( vector, {} ) );
+
+  // a raw buffer
+  std::vector<float> buffer( uint64_t( width ) * height );
+  reader.ReadInto( buffer.data(), buffer.size() * sizeof(float) );
+  EXPECT_TRUE( std::equal( buffer.begin(), buffer.end(), expected.GetBufferAsFloat() ) );
+  EXPECT_ANY_THROW( reader.ReadInto( buffer.data(), buffer.size() * sizeof(float) - 1 ) );
+
+  // the extraction region is read
+  reader.SetExtractIndex( {5, 6} );
+  reader.SetExtractSize( {10, 20} );
+  const sitk::Image region = reader.Execute();
+  std::vector<float> regionBuffer( 10 * 20 );
+  reader.ReadInto( regionBuffer.data(), regionBuffer.size() * sizeof(float) );
+  EXPECT_TRUE( std::equal( regionBuffer.begin(), regionBuffer.end(), region.GetBufferAsFloat() ) );
+}
+
+
+TEST(IO, ImageFileReader_DirectIO )
+{
+  const sitk::Image expected = sitk::ReadImage( dataFinder.GetFile( "Input/RA-Float.nrrd" ) );
+  const std::string expectedHash = sitk::Hash( expected );
+
+  sitk::ImageFileReader reader;
+  EXPECT_FALSE( reader.GetUseDirectIO() );
+  EXPECT_FALSE( reader.GetSequentialReadAhead() );
+  reader.UseDirectIOOn();
+  EXPECT_TRUE( reader.GetUseDirectIO() );
+  reader.SequentialReadAheadOn();
+  EXPECT_TRUE( reader.GetSequentialReadAhead() );
+  EXPECT_NO_THROW( reader.ToString() );
+
+  // uncompressed files with attached and detached data, and a
+  // compressed file read by the ImageIO
+  const std::vector<std::string> fileNames = { dataFinder.GetOutputFile( "IO.ImageFileReader_DirectIO.mha" ),
+                                               dataFinder.GetOutputFile( "IO.ImageFileReader_DirectIO.mhd" ),
+                                               dataFinder.GetOutputFile( "IO.ImageFileReader_DirectIO.nrrd" ),
+                                               dataFinder.GetOutputFile( "IO.ImageFileReader_DirectIO.nhdr" ) };
+  for ( const std::string &fileName : fileNames )
+    {
+    for ( bool useCompression : {false, true} )
+      {
+      sitk::WriteImage( expected, fileName, useCompression );
+      reader.SetFileName( fileName );
+      for ( bool directIO : {false, true} )
+        {
+        reader.SetUseDirectIO( directIO );
+        sitk::Image image = reader.Execute();
+        EXPECT_EQ( expectedHash, sitk::Hash( image ) ) << fileName;
+        EXPECT_EQ( expected.GetSpacing(), image.GetSpacing() );
+        EXPECT_EQ( expected.GetOrigin(), image.GetOrigin() );
+        }
+
+      std::vector<float> buffer( expected.GetNumberOfPixels() );
+      reader.ReadInto( buffer.data(), buffer.size() * sizeof(float) );
+      EXPECT_TRUE( std::equal( buffer.begin(), buffer.end(), expected.GetBufferAsFloat() ) ) << fileName;
+      }
+    }
+
+  // with a pixel conversion the file is read by the ImageIO
+  reader.SetFileName( fileNames[0] );
+  reader.SetOutputPixelType( sitk::sitkFloat64 );
+  EXPECT_EQ( sitk::Hash( sitk::Cast( expected, sitk::sitkFloat64 ) ), sitk::Hash( reader.Execute() ) );
+}
+
+
+TEST(IO, ImageFileReader_IntensityWindow )
+{
+  const std::string fileName = dataFinder.GetFile( "Input/RA-Short.nrrd" );
+  const sitk::Image native = sitk::ReadImage( fileName );
+  ASSERT_EQ( sitk::sitkInt16, native.GetPixelID() );
+
+  sitk::ImageFileReader reader;
+  reader.SetFileName( fileName );
+  EXPECT_TRUE( reader.GetIntensityWindow().empty() );
+  EXPECT_ANY_THROW( reader.SetIntensityWindow( 10.0, 10.0, 0.0, 1.0 ) );
+
+  const double windowMinimum = -100.0;
+  const double windowMaximum = 400.0;
+  reader.SetIntensityWindow( windowMinimum, windowMaximum, 0.0, 1.0 );
+  EXPECT_EQ( std::vector<double>( {windowMinimum, windowMaximum, 0.0, 1.0} ), reader.GetIntensityWindow() );
+  EXPECT_NO_THROW( reader.ToString() );
+
+  reader.SetOutputPixelType( sitk::sitkFloat32 );
+  sitk::Image image = reader.Execute();
+  ASSERT_EQ( sitk::sitkFloat32, image.GetPixelID() );
+  EXPECT_EQ( native.GetSize(), image.GetSize() );
+  EXPECT_EQ( native.GetOrigin(), image.GetOrigin() );
+  EXPECT_EQ( native.GetSpacing(), image.GetSpacing() );
+
+  const int16_t *in = native.GetBufferAsInt16();
+  const float *out = image.GetBufferAsFloat();
+  for ( uint64_t i = 0; i < native.GetNumberOfPixels(); ++i )
+    {
+    const double v = std::min( std::max( double( in[i] ), windowMinimum ), windowMaximum );
+    ASSERT_NEAR( ( v - windowMinimum ) / ( windowMaximum - windowMinimum ), out[i], 1e-6 );
+    }
+
+  // into an integer pixel type and an existing image
+  reader.SetIntensityWindow( windowMinimum, windowMaximum, 0.0, 255.0 );
+  sitk::Image destination( native.GetSize(), sitk::sitkUInt8 );
+  reader.ReadInto( destination );
+  const uint8_t *out8 = destination.GetBufferAsUInt8();
+  for ( uint64_t i = 0; i < native.GetNumberOfPixels(); ++i )
+    {
+    const double v = std::min( std::max( double( in[i] ), windowMinimum ), windowMaximum );
+    ASSERT_NEAR( 255.0 * ( v - windowMinimum ) / ( windowMaximum - windowMinimum ), double( out8[i] ), 1.0 );
+    }
+
+  // only the whole image is supported
+  reader.SetExtractSize( {2, 2} );
+  EXPECT_ANY_THROW( reader.Execute() );
+  reader.SetExtractSize( {} );
+
+  reader.SetOutputPixelType( sitk::sitkComplexFloat32 );
+  EXPECT_ANY_THROW( reader.Execute() );
+
+  reader.RemoveIntensityWindow();
+  EXPECT_TRUE( reader.GetIntensityWindow().empty() );
+  reader.SetOutputPixelType( sitk::sitkUnknown );
+  EXPECT_EQ( sitk::Hash( native ), sitk::Hash( reader.Execute() ) );
+}
+
+
+TEST(IO, ImageFileReader_SetBuffer )
+{
+  const std::string fileName = dataFinder.GetFile( "Input/RA-Slice-Short.png" );
+  std::ifstream in( fileName.c_str(), std::ios::binary );
+  const std::vector<char> content( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+  ASSERT_FALSE( content.empty() );
+
+  const std::string expectedHash = sitk::Hash( sitk::ReadImage( fileName ) );
+
+  sitk::ImageFileReader reader;
+  reader.SetBuffer( content.data(), content.size(), "PNGImageIO" );
+  EXPECT_EQ( "PNGImageIO", reader.GetImageIO() );
+  const std::string bufferFileName = reader.GetFileName();
+  EXPECT_TRUE( dataFinder.FileExists( bufferFileName ) );
+  EXPECT_EQ( expectedHash, sitk::Hash( reader.Execute() ) );
+
+  // the ImageIO is determined from the content
+  reader.SetBuffer( content.data(), content.size(), "" );
+  EXPECT_FALSE( dataFinder.FileExists( bufferFileName ) );
+  EXPECT_EQ( expectedHash, sitk::Hash( reader.Execute() ) );
+
+  EXPECT_ANY_THROW( reader.SetBuffer( nullptr, 10, "PNGImageIO" ) );
+  EXPECT_ANY_THROW( reader.SetBuffer( content.data(), content.size(), "NoSuchImageIO" ) );
+
+  reader.SetBuffer( content.data(), content.size(), "PNGImageIO" );
+  const std::string otherBufferFileName = reader.GetFileName();
+  reader.SetFileName( fileName );
+  EXPECT_FALSE( dataFinder.FileExists( otherBufferFileName ) );
+  EXPECT_EQ( expectedHash, sitk::Hash( reader.Execute() ) );
+}
+
+TEST(IO, ImageFileWriter_ExecuteToBuffer )
+{
+  sitk::Image image = sitk::ReadImage( dataFinder.GetFile( "Input/RA-Short.nrrd" ) );
+  const std::string expectedHash = sitk::Hash( image );
+
+  sitk::ImageFileWriter writer;
+  EXPECT_ANY_THROW( writer.ExecuteToBuffer( image, "" ) );
+  writer.SetFileName( "unchanged.mha" );
+
+  sitk::ImageFileReader reader;
+  for ( const std::string imageIO : { "MetaImageIO", "NrrdImageIO", "NiftiImageIO" } )
+    {
+    writer.SetUseCompression( imageIO == "NrrdImageIO" );
+    const std::vector<uint8_t> content = writer.ExecuteToBuffer( image, imageIO );
+    EXPECT_FALSE( content.empty() ) << imageIO;
+    EXPECT_EQ( "unchanged.mha", writer.GetFileName() );
+    EXPECT_EQ( "", writer.GetImageIO() );
+
+    reader.SetBuffer( content.data(), content.size(), imageIO );
+    EXPECT_EQ( expectedHash, sitk::Hash( reader.Execute() ) ) << imageIO;
+    }
+}
+
+TEST(IO, ImageFileWriter_MultiscaleLevels )
+{
+  const std::string fileName = dataFinder.GetOutputFile( "ImageFileWriter_MultiscaleLevels.mha" );
+
+  sitk::Image image( 64, 33, sitk::sitkUInt16 );
+  image.SetSpacing( {0.5, 2.0} );
+  image.SetPixel( {10, 10}, 100 );
+
+  sitk::ImageFileWriter writer;
+  EXPECT_EQ( 1u, writer.GetNumberOfMultiscaleLevels() );
+  writer.SetNumberOfMultiscaleLevels( 0 );
+  EXPECT_EQ( 1u, writer.GetNumberOfMultiscaleLevels() );
+  writer.SetNumberOfMultiscaleLevels( 3 );
+  EXPECT_EQ( 3u, writer.GetNumberOfMultiscaleLevels() );
+  EXPECT_NO_THROW( writer.ToString() );
+  writer.SetFileName( fileName );
+  writer.Execute( image );
+
+  sitk::ImageFileReader reader;
+  reader.SetFileName( fileName );
+  EXPECT_EQ( 3u, reader.GetNumberOfMultiscaleLevels() );
+
+  EXPECT_EQ( image.GetSize(), reader.Execute().GetSize() );
+
+  reader.SetMultiscaleLevel( 1 );
+  sitk::Image level1 = reader.Execute();
+  EXPECT_EQ( std::vector<unsigned int>( {32, 16} ), level1.GetSize() );
+  EXPECT_EQ( std::vector<double>( {1.0, 4.0} ), level1.GetSpacing() );
+
+  reader.SetMultiscaleLevel( 2 );
+  sitk::Image level2 = reader.Execute();
+  EXPECT_EQ( std::vector<unsigned int>( {16, 8} ), level2.GetSize() );
+
+  reader.SetMultiscaleLevel( 5 );
+  EXPECT_ANY_THROW( reader.Execute() );
+
+  // rewriting with fewer levels removes the stale ones
+  writer.SetNumberOfMultiscaleLevels( 1 );
+  writer.Execute( image );
+  reader.SetMultiscaleLevel( 0 );
+  EXPECT_EQ( 1u, reader.GetNumberOfMultiscaleLevels() );
+  reader.SetMultiscaleLevel( 1 );
+  EXPECT_ANY_THROW( reader.Execute() );
+}
+
+TEST(IO, ImageFilePrefetchReader )
+{
+  const std::vector<std::string> fileNames = { dataFinder.GetFile( "Input/cthead1-Float.mha" ),
+                                               dataFinder.GetFile( "Input/fruit.png" ),
+                                               dataFinder.GetFile( "Input/RA-Short.nrrd" ),
+                                               dataFinder.GetOutputFile( "IO.ImageFilePrefetchReader.missing.mha" ),
+                                               dataFinder.GetFile( "Input/cthead1-Float.mha" ) };
+
+  sitk::ImageFilePrefetchReader prefetcher( fileNames, 3 );
+  EXPECT_EQ( fileNames, prefetcher.GetFileNames() );
+  EXPECT_EQ( 3u, prefetcher.GetNumberOfPrefetchedImages() );
+  EXPECT_EQ( 0u, prefetcher.GetMaximumPrefetchedBytes() );
+  EXPECT_EQ( "ImageFilePrefetchReader", prefetcher.GetName() );
+  EXPECT_NO_THROW( prefetcher.ToString() );
+
+  for ( unsigned int i = 0; i < fileNames.size(); ++i )
+    {
+    ASSERT_TRUE( prefetcher.HasNext() );
+    EXPECT_EQ( i, prefetcher.GetNextIndex() );
+    if ( i == 3 )
+      {
+      EXPECT_ANY_THROW( prefetcher.Next() );
+      continue;
+      }
+    EXPECT_EQ( sitk::Hash( sitk::ReadImage( fileNames[i] ) ), sitk::Hash( prefetcher.Next() ) );
+    }
+  EXPECT_FALSE( prefetcher.HasNext() );
+  EXPECT_ANY_THROW( prefetcher.Next() );
+
+  // a memory bound smaller than one image still reads every file
+  prefetcher.SetMaximumPrefetchedBytes( 1 );
+  prefetcher.SetOutputPixelType( sitk::sitkFloat64 );
+  EXPECT_EQ( 0u, prefetcher.GetNextIndex() );
+  sitk::Image image = prefetcher.Next();
+  EXPECT_EQ( sitk::sitkFloat64, image.GetPixelID() );
+  EXPECT_EQ( sitk::Hash( sitk::ReadImage( fileNames[0], sitk::sitkFloat64 ) ), sitk::Hash( image ) );
+
+  // reset before all the files are consumed
+  prefetcher.Reset();
+  EXPECT_EQ( 0u, prefetcher.GetNextIndex() );
+  EXPECT_EQ( sitk::Hash( image ), sitk::Hash( prefetcher.Next() ) );
+
+  prefetcher.SetNumberOfPrefetchedImages( 0 );
+  EXPECT_EQ( 1u, prefetcher.GetNumberOfPrefetchedImages() );
+  prefetcher.SetFileNames( std::vector<std::string>() );
+  EXPECT_FALSE( prefetcher.HasNext() );
+}
+
+
 TEST(IO, ImageFileReader_Extract1 )
 {
 
@@ -18,7 +18,10 @@
 #include <SimpleITKTestHarness.h>
 #include <SimpleITK.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <numeric>
 
 namespace
 {
@@ -247,6 +250,140 @@ TEST_F(sitkRegistrationMethodTest, Metric_Evaluate)
   EXPECT_NEAR(3.34e-09 ,R3.MetricEvaluate(fixedBlobs,movingBlobs), 1e-10);
 }
 
+TEST_F(sitkRegistrationMethodTest, Metric_Evaluator)
+{
+  sitk::Image fixed = fixedBlobs;
+  sitk::Image moving = fixedBlobs;
+
+  sitk::ImageRegistrationMethod R;
+  R.SetMetricAsMeanSquares();
+  R.SetInitialTransform(sitk::TranslationTransform(fixed.GetDimension()));
+  R.SetMovingInitialTransform(sitk::TranslationTransform(fixed.GetDimension(),v2(-5,7)));
+
+  sitk::ImageRegistrationMetricEvaluator evaluator = R.CreateMetricEvaluator(fixed, moving);
+  EXPECT_EQ(2u, evaluator.GetNumberOfParameters());
+
+  // the evaluator uses copies of the transforms
+  R.SetMovingInitialTransform(sitk::TranslationTransform(fixed.GetDimension()));
+
+  EXPECT_NEAR(0.0036468516797954148, evaluator.Evaluate(v2(0.0,0.0)), 1e-10 );
+  EXPECT_NEAR(0.0, evaluator.Evaluate(v2(5.0,-7.0)), 1e-10 );
+
+  R.SetInitialTransform(sitk::TranslationTransform(fixed.GetDimension(),v2(2,-3)));
+  const double expected = R.MetricEvaluate(fixed, moving);
+  EXPECT_NEAR(expected, R.CreateMetricEvaluator(fixed, moving).Evaluate(v2(2.0,-3.0)), 1e-10);
+
+  std::vector<double> derivative;
+  EXPECT_NEAR(expected, evaluator.EvaluateWithDerivative(v2(7.0,-10.0), derivative), 1e-10 );
+  ASSERT_EQ(2u, derivative.size());
+  EXPECT_NE(0.0, derivative[0]);
+
+  // the derivative is in the direction of decrease of the metric
+  const double step = 1e-3;
+  std::vector<double> moved = v2(7.0 + step*derivative[0], -10.0 + step*derivative[1]);
+  EXPECT_LT(evaluator.Evaluate(moved), expected);
+
+  std::vector< std::vector<double> > parameters;
+  for ( int x = -3; x <= 3; ++x )
+    {
+    for ( int y = -3; y <= 3; ++y )
+      {
+      parameters.push_back(v2(5.0+x, -7.0+y));
+      }
+    }
+  std::vector<double> values = evaluator.Evaluate(parameters);
+  ASSERT_EQ(parameters.size(), values.size());
+  for ( size_t i = 0; i < parameters.size(); ++i )
+    {
+    EXPECT_NEAR(evaluator.Evaluate(parameters[i]), values[i], 1e-10) << "parameters " << i;
+    }
+  EXPECT_EQ(24, std::min_element(values.begin(), values.end()) - values.begin());
+
+  EXPECT_THROW(evaluator.Evaluate(std::vector<double>(3, 0.0)), sitk::GenericException);
+  EXPECT_THROW(R.CreateMetricEvaluator(fixed, sitk::Cast(moving, sitk::sitkFloat64)), sitk::GenericException);
+}
+
+TEST_F(sitkRegistrationMethodTest, Metric_MattesPDFDerivatives)
+{
+  sitk::Image fixed = fixedBlobs;
+  sitk::Image moving = movingBlobs;
+
+  sitk::ImageRegistrationMethod R;
+  R.SetMetricAsMattesMutualInformation();
+
+  // the implicit PDF derivatives of the BSpline give the same value
+  // and derivative as the explicit ones of the equivalent translation
+  R.SetInitialTransform(sitk::TranslationTransform(fixed.GetDimension()));
+  sitk::ImageRegistrationMetricEvaluator translationEvaluator = R.CreateMetricEvaluator(fixed, moving);
+
+  sitk::BSplineTransform bspline = sitk::BSplineTransformInitializer(fixed, std::vector<unsigned int>(2,2u));
+  R.SetInitialTransform(bspline);
+  sitk::ImageRegistrationMetricEvaluator bsplineEvaluator = R.CreateMetricEvaluator(fixed, moving);
+
+  const std::vector<double> translation = v2(3.0, -2.0);
+  std::vector<double> bsplineParameters(bsplineEvaluator.GetNumberOfParameters());
+  for ( size_t i = 0; i < bsplineParameters.size(); ++i )
+    {
+    bsplineParameters[i] = translation[2*i/bsplineParameters.size()];
+    }
+
+  std::vector<double> translationDerivative;
+  std::vector<double> bsplineDerivative;
+  const double translationValue = translationEvaluator.EvaluateWithDerivative(translation, translationDerivative);
+  const double bsplineValue =  bsplineEvaluator.EvaluateWithDerivative(bsplineParameters, bsplineDerivative);
+  EXPECT_NEAR(translationValue, bsplineValue, 1e-5);
+
+  ASSERT_EQ(bsplineParameters.size(), bsplineDerivative.size());
+  for ( unsigned int d = 0; d < 2; ++d )
+    {
+    const size_t n = bsplineDerivative.size()/2;
+    const double sum = std::accumulate(bsplineDerivative.begin()+d*n, bsplineDerivative.begin()+(d+1)*n, 0.0);
+    EXPECT_NEAR(translationDerivative[d], sum, 1e-5*std::max(1.0, std::abs(sum))) << "dimension " << d;
+    }
+}
+
+TEST_F(sitkRegistrationMethodTest, Metric_BSplineSparseDerivative)
+{
+  sitk::Image fixed = fixedBlobs;
+  sitk::Image moving = movingBlobs;
+
+  sitk::ImageRegistrationMethod R;
+  R.SetMetricAsMeanSquares();
+
+  // the derivative accumulated over the support of the control points
+  // matches the one of the equivalent translation
+  R.SetInitialTransform(sitk::TranslationTransform(fixed.GetDimension()));
+  sitk::ImageRegistrationMetricEvaluator translationEvaluator = R.CreateMetricEvaluator(fixed, moving);
+
+  for ( unsigned int order = 1; order <= 3; order += 2 )
+    {
+    sitk::BSplineTransform bspline = sitk::BSplineTransformInitializer(fixed, std::vector<unsigned int>(2,8u), order);
+    R.SetInitialTransform(bspline);
+    sitk::ImageRegistrationMetricEvaluator bsplineEvaluator = R.CreateMetricEvaluator(fixed, moving);
+
+    const std::vector<double> translation = v2(3.0, -2.0);
+    std::vector<double> bsplineParameters(bsplineEvaluator.GetNumberOfParameters());
+    for ( size_t i = 0; i < bsplineParameters.size(); ++i )
+      {
+      bsplineParameters[i] = translation[2*i/bsplineParameters.size()];
+      }
+
+    std::vector<double> translationDerivative;
+    std::vector<double> bsplineDerivative;
+    const double translationValue = translationEvaluator.EvaluateWithDerivative(translation, translationDerivative);
+    const double bsplineValue =  bsplineEvaluator.EvaluateWithDerivative(bsplineParameters, bsplineDerivative);
+    EXPECT_NEAR(translationValue, bsplineValue, 1e-8) << "order " << order;
+
+    ASSERT_EQ(bsplineParameters.size(), bsplineDerivative.size());
+    for ( unsigned int d = 0; d < 2; ++d )
+      {
+      const size_t n = bsplineDerivative.size()/2;
+      const double sum = std::accumulate(bsplineDerivative.begin()+d*n, bsplineDerivative.begin()+(d+1)*n, 0.0);
+      EXPECT_NEAR(translationDerivative[d], sum, 1e-6*std::max(1e-3, std::abs(sum))) << "order " << order << " dimension " << d;
+      }
+    }
+}
+
 TEST_F(sitkRegistrationMethodTest, Transform_InPlaceOn)
 {
   // This test is to check the in-place operation of the initial
@@ -481,6 +618,56 @@ TEST_F(sitkRegistrationMethodTest, Mask_Test2)
 }
 
 
+TEST_F(sitkRegistrationMethodTest, Mask_BoundingBox)
+{
+  // This test is to check that cropping the virtual domain to the
+  // fixed mask does not change the result.
+
+  sitk::Image mask( fixedBlobs.GetSize(), sitk::sitkUInt8 );
+  mask.CopyInformation( fixedBlobs );
+  for ( unsigned int y = 24; y < 104; ++y )
+    {
+    for ( unsigned int x = 24; x < 104; ++x )
+      {
+      mask.SetPixelAsUInt8( {x, y}, 1 );
+      }
+    }
+
+  sitk::ImageRegistrationMethod R;
+  R.SetOptimizerAsRegularStepGradientDescent(2.0, 1e-7, 100, 0.5, 1e-8);
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(fixedBlobs.GetDimension());
+  R.SetInitialTransform(tx, false);
+
+  R.SetMetricAsCorrelation();
+  R.SetMetricFixedMask(mask);
+
+  EXPECT_FALSE(R.GetMetricUseFixedMaskBoundingBox());
+  R.MetricUseFixedMaskBoundingBoxOn();
+  EXPECT_TRUE(R.GetMetricUseFixedMaskBoundingBox());
+  sitk::Transform outTx1 = R.Execute(fixedBlobs,movingBlobs);
+  const uint64_t numberOfValidPoints1 = R.GetMetricNumberOfValidPoints();
+  const double metricValue1 = R.MetricEvaluate(fixedBlobs,movingBlobs);
+
+  R.MetricUseFixedMaskBoundingBoxOff();
+  EXPECT_FALSE(R.GetMetricUseFixedMaskBoundingBox());
+  sitk::Transform outTx2 = R.Execute(fixedBlobs,movingBlobs);
+
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-10,10), outTx1.GetParameters(), 1e-3);
+  EXPECT_VECTOR_DOUBLE_NEAR(outTx2.GetParameters(), outTx1.GetParameters(), 1e-6);
+  EXPECT_EQ(R.GetMetricNumberOfValidPoints(), numberOfValidPoints1);
+  EXPECT_NEAR(R.MetricEvaluate(fixedBlobs,movingBlobs), metricValue1, 1e-10);
+
+  // with multiple levels, the cropped domain is shrunk
+  R.MetricUseFixedMaskBoundingBoxOn();
+  R.SetShrinkFactorsPerLevel({2, 1});
+  R.SetSmoothingSigmasPerLevel({1.0, 0.0});
+  outTx1 = R.Execute(fixedBlobs,movingBlobs);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-10,10), outTx1.GetParameters(), 1e-3);
+}
+
+
 TEST_F(sitkRegistrationMethodTest, VirtualDomain_Test)
 {
   // Test usage of setting virtual domain
@@ -873,6 +1060,54 @@ TEST_F(sitkRegistrationMethodTest, Optimizer_Exhaustive)
 }
 
 
+TEST_F(sitkRegistrationMethodTest, Optimizer_ExhaustiveSearch)
+{
+  sitk::Image image = MakeGaussianBlob( v2(64, 64), std::vector<unsigned int>(2,256) );
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(image.GetDimension());
+  tx.SetOffset(v2(-1.3,-2.2));
+  R.SetInitialTransform(tx, false);
+
+  R.SetMetricAsMeanSquares();
+
+  R.SetOptimizerAsGradientDescent(1.0, 10);
+  EXPECT_ANY_THROW(R.ExecuteExhaustiveSearch(image, image));
+
+  // Search grid of size 7x7, refined to steps of 1/8
+  R.SetOptimizerAsExhaustive(std::vector<unsigned int>(2,3), 1.0);
+
+  sitk::Transform outTx = R.ExecuteExhaustiveSearch(image, image, 2, 3);
+
+  std::cout << "Optimizer stop condition: " << R.GetOptimizerStopConditionDescription() << std::endl;
+  std::cout << " Iteration: " << R.GetOptimizerIteration() << std::endl;
+  std::cout << " Metric value: " << R.GetMetricValue() << std::endl;
+
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(0.0,0.0), outTx.GetParameters(), 0.07);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-1.3,-2.2), tx.GetParameters(), 1e-10);
+  EXPECT_GT(R.GetOptimizerIteration(), 49u);
+  EXPECT_LE(R.GetOptimizerIteration(), 49u + 3u*2u*8u);
+
+  double metric_value = R.GetMetricValue();
+  R.SetInitialTransform(outTx);
+  EXPECT_NEAR(R.MetricEvaluate(image,image), metric_value, 1e-10);
+  R.SetInitialTransform(tx, false);
+
+  // the scales sample the second parameter only
+  R.SetOptimizerScales(v2(0.0, 1.0));
+  outTx = R.ExecuteExhaustiveSearch(image, image, 2, 3);
+  EXPECT_DOUBLE_EQ(-1.3, outTx.GetParameters()[0]);
+  EXPECT_NEAR(0.0, outTx.GetParameters()[1], 0.07);
+
+  // the time budget stops the search after the first evaluations
+  R.SetOptimizerAsExhaustive(std::vector<unsigned int>(2,50), 0.1);
+  outTx = R.ExecuteExhaustiveSearch(image, image, 2, 3, 1e-9);
+  EXPECT_LT(R.GetOptimizerIteration(), 101u*101u);
+  EXPECT_NE(std::string::npos, R.GetOptimizerStopConditionDescription().find("maximum time"));
+}
+
 TEST_F(sitkRegistrationMethodTest, Optimizer_Amoeba)
 {
   sitk::Image image = MakeGaussianBlob( v2(64, 64), std::vector<unsigned int>(2,256) );
@@ -1078,6 +1313,13 @@ TEST_F(sitkRegistrationMethodTest, Optimizer_ScalesEstimator)
   EXPECT_VECTOR_DOUBLE_NEAR(v3(130049,1.0,1.0), cmd.scales, 1.0);
   EXPECT_TRUE( cmd.toString.find("ScalesFromPhysicalShift") != std::string::npos );
 
+  // the Jacobian at the corners of the pixels at the ends of the image
+  R.SetOptimizerScalesFromImageExtent();
+  outTx = R.Execute(fixedImage, movingImage);
+
+  EXPECT_VECTOR_DOUBLE_NEAR(v3(0.0,-2.8,9.5), outTx.GetParameters(), 0.6);
+  EXPECT_VECTOR_DOUBLE_NEAR(v3(65280.5,1.0,1.0), cmd.scales, 1e-6);
+
   R.SetOptimizerScales(v3(200000,1.0,1.0));
   outTx = R.Execute(fixedImage, movingImage);
 
@@ -1088,6 +1330,139 @@ TEST_F(sitkRegistrationMethodTest, Optimizer_ScalesEstimator)
 }
 
 
+TEST_F(sitkRegistrationMethodTest, Optimizer_ScalesReuseAcrossLevels)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(54, 74), std::vector<unsigned int>(2,256) );
+  sitk::Image movingImage = MakeDualGaussianBlobs( v2(61.2, 73.5), v2(51.2, 83.5), std::vector<unsigned int>(2,256) );
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsGradientDescent(1.0, 5, 0.0, 1000);
+  R.SetShrinkFactorsPerLevel({4, 2, 1});
+  R.SetSmoothingSigmasPerLevel({2.0, 1.0, 0.0});
+
+  EXPECT_FALSE(R.GetOptimizerScalesReuseAcrossLevels());
+  R.OptimizerScalesReuseAcrossLevelsOn();
+  EXPECT_TRUE(R.GetOptimizerScalesReuseAcrossLevels());
+
+  std::vector<std::vector<double>> scalesPerLevel;
+  R.AddCommand(sitk::sitkIterationEvent, [&R, &scalesPerLevel] {
+      if ( R.GetOptimizerIteration() == 0 )
+        {
+        scalesPerLevel.push_back(R.GetOptimizerScales());
+        }
+    });
+
+  sitk::Euler2DTransform tx;
+  R.SetInitialTransform(tx, false);
+  R.SetOptimizerScalesFromPhysicalShift();
+  R.Execute(fixedImage, movingImage);
+
+  ASSERT_EQ(3u, scalesPerLevel.size());
+  EXPECT_VECTOR_DOUBLE_NEAR(scalesPerLevel[0], scalesPerLevel[1], 1e-10);
+  EXPECT_VECTOR_DOUBLE_NEAR(scalesPerLevel[0], scalesPerLevel[2], 1e-10);
+
+  // the scales are estimated again when the BSpline is refined
+  sitk::BSplineTransform bspline = sitk::BSplineTransformInitializer(fixedImage, {4, 4});
+  R.SetInitialTransformAsBSpline(bspline, false, {1, 2, 2});
+  R.SetOptimizerScalesFromJacobian();
+  scalesPerLevel.clear();
+  R.Execute(fixedImage, movingImage);
+
+  ASSERT_EQ(3u, scalesPerLevel.size());
+  EXPECT_EQ(bspline.GetNumberOfParameters(), scalesPerLevel[0].size());
+  EXPECT_LT(scalesPerLevel[0].size(), scalesPerLevel[1].size());
+  EXPECT_VECTOR_DOUBLE_NEAR(scalesPerLevel[1], scalesPerLevel[2], 1e-10);
+
+  // only linear transforms have scales from the image extent
+  R.SetInitialTransform(bspline, false);
+  R.SetOptimizerScalesFromImageExtent();
+  EXPECT_THROW(R.Execute(fixedImage, movingImage), sitk::GenericException);
+}
+
+
+TEST_F(sitkRegistrationMethodTest, DisplacementField_NotInPlace)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(32, 32), v2(27, 37), std::vector<unsigned int>(2,128) );
+  sitk::Image movingImage = MakeDualGaussianBlobs( v2(30.6, 32.7), v2(25.6, 37.7), std::vector<unsigned int>(2,128) );
+
+  sitk::Image field(fixedImage.GetSize(), sitk::sitkVectorFloat64);
+  field.CopyInformation(fixedImage);
+
+  // the field shared with another image is copied
+  sitk::Image sharedField = field;
+  sitk::DisplacementFieldTransform tx(sharedField);
+  EXPECT_EQ(field.GetSize(), tx.GetDisplacementField().GetSize());
+  EXPECT_EQ(0u, sharedField.GetNumberOfPixels());
+  EXPECT_EQ(fixedImage.GetSize(), field.GetSize());
+  tx.SetSmoothingGaussianOnUpdate(0.0, 1.5);
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsGradientDescent(1.0, 10, 0.0, 1000);
+  R.SetOptimizerScalesFromPhysicalShift();
+  R.SetInitialTransform(tx, false);
+
+  sitk::Transform outTx = R.Execute(fixedImage, movingImage);
+
+  sitk::DisplacementFieldTransform outDisplacement(outTx);
+  EXPECT_EQ(fixedImage.GetSize(), outDisplacement.GetDisplacementField().GetSize());
+  EXPECT_EQ(tx.GetNumberOfParameters(), outDisplacement.GetNumberOfParameters());
+
+  const std::vector<double> initialParameters = tx.GetParameters();
+  EXPECT_TRUE(std::all_of(initialParameters.begin(), initialParameters.end(), [](double p) { return p == 0.0; }));
+  const std::vector<double> parameters = outDisplacement.GetParameters();
+  EXPECT_TRUE(std::any_of(parameters.begin(), parameters.end(), [](double p) { return p != 0.0; }));
+}
+
+
+TEST_F(sitkRegistrationMethodTest, DisplacementField_Mask)
+{
+  // The domain of a displacement field is not cropped to the fixed
+  // mask, as it must match the virtual domain.
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(32, 32), v2(27, 37), std::vector<unsigned int>(2,64) );
+  sitk::Image movingImage = MakeDualGaussianBlobs( v2(30.6, 32.7), v2(25.6, 37.7), std::vector<unsigned int>(2,64) );
+
+  sitk::Image mask( fixedImage.GetSize(), sitk::sitkUInt8 );
+  mask.CopyInformation( fixedImage );
+  for ( unsigned int y = 16; y < 48; ++y )
+    {
+    for ( unsigned int x = 16; x < 48; ++x )
+      {
+      mask.SetPixelAsUInt8( {x, y}, 1 );
+      }
+    }
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+  R.SetMetricAsMeanSquares();
+  R.SetMetricFixedMask(mask);
+  R.SetOptimizerAsGradientDescent(1.0, 10, 0.0, 1000);
+  R.SetOptimizerScalesFromPhysicalShift();
+
+  std::vector<double> parameters[2];
+  for ( const bool useBoundingBox : { false, true } )
+    {
+    sitk::Image field(fixedImage.GetSize(), sitk::sitkVectorFloat64);
+    field.CopyInformation(fixedImage);
+    sitk::DisplacementFieldTransform tx(field);
+    tx.SetSmoothingGaussianOnUpdate(0.0, 1.5);
+    R.SetInitialTransform(tx, false);
+    R.SetMetricUseFixedMaskBoundingBox(useBoundingBox);
+
+    sitk::Transform outTx;
+    ASSERT_NO_THROW( outTx = R.Execute(fixedImage, movingImage) );
+    sitk::DisplacementFieldTransform outDisplacement(outTx);
+    EXPECT_EQ(fixedImage.GetSize(), outDisplacement.GetDisplacementField().GetSize());
+    parameters[useBoundingBox] = outDisplacement.GetParameters();
+    }
+  EXPECT_TRUE(std::any_of(parameters[0].begin(), parameters[0].end(), [](double p) { return p != 0.0; }));
+  EXPECT_VECTOR_DOUBLE_NEAR(parameters[0], parameters[1], 1e-6);
+}
+
+
 TEST_F(sitkRegistrationMethodTest, Optimizer_Sampling)
 {
   sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(54, 74), std::vector<unsigned int>(2,256) );
@@ -1175,6 +1550,50 @@ TEST_F(sitkRegistrationMethodTest, Optimizer_Sampling)
 }
 
 
+TEST_F(sitkRegistrationMethodTest, Optimizer_Sampling_Strategies)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(54, 74), std::vector<unsigned int>(2,256) );
+  sitk::Image movingImage = MakeDualGaussianBlobs( v2(61.2, 65.5), v2(51.2, 75.5), std::vector<unsigned int>(2,256) );
+
+  fixedImage = sitk::AdditiveGaussianNoise(fixedImage,  0.5, 0, 1u);
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100, 0.5, 1e-5);
+
+  const sitk::ImageRegistrationMethod::MetricSamplingStrategyType strategies[] =
+    { R.STRATIFIED, R.HALTON, R.SOBOL, R.GRADIENT_WEIGHTED };
+  for ( auto strategy : strategies )
+    {
+    R.SetMetricSamplingStrategy(strategy);
+    R.SetMetricSamplingPercentage(.02,1u);
+
+    // set fixed seed and expect the same results
+    sitk::Transform outTx1 = R.Execute(fixedImage, movingImage);
+    EXPECT_GT( R.GetMetricNumberOfValidPoints(), 1000u ) << "strategy: " << strategy;
+    EXPECT_LT( R.GetMetricNumberOfValidPoints(), 1400u ) << "strategy: " << strategy;
+    sitk::Transform outTx2 = R.Execute(fixedImage, movingImage);
+
+    EXPECT_VECTOR_DOUBLE_NEAR(outTx1.GetParameters(), outTx2.GetParameters(), 1e-10) << "Same registration with fixed seed and strategy: " << strategy;
+    EXPECT_VECTOR_DOUBLE_NEAR(v2(-2.8, 1.5), outTx1.GetParameters(), 0.5) << "strategy: " << strategy;
+    }
+
+  // another seed gives other points
+  R.SetMetricSamplingStrategy(R.SOBOL);
+  R.SetMetricSamplingPercentage(.02,1u);
+  R.Execute(fixedImage, movingImage);
+  const double firstValue = R.GetMetricValue();
+  R.SetMetricSamplingPercentage(.02,2u);
+  R.Execute(fixedImage, movingImage);
+  EXPECT_NE(firstValue, R.GetMetricValue());
+}
+
+
 TEST_F(sitkRegistrationMethodTest, StopRegistration)
 {
   sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
@@ -1232,6 +1651,526 @@ TEST_F(sitkRegistrationMethodTest, StopRegistration)
 }
 
 
+TEST_F(sitkRegistrationMethodTest, OptimizerStoppingPolicy)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
+  sitk::Image movingImage = MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256});
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+
+  EXPECT_THROW(R.SetOptimizerStoppingPolicy(1e-3, 1), sitk::GenericException);
+  EXPECT_THROW(R.SetOptimizerStoppingPolicy(-1.0), sitk::GenericException);
+  EXPECT_THROW(R.SetOptimizerStoppingPolicy(0.0, 10, -1.0), sitk::GenericException);
+
+  std::function< void(void) > set_optimizer_funcs[] = {
+    [&R] () {R.SetOptimizerAsConjugateGradientLineSearch(1.0, 100);},
+    [&R] () {R.SetOptimizerAsGradientDescent(1.0, 100);},
+    [&R] () {R.SetOptimizerAsRegularStepGradientDescent(1.0, 0.001, 100, 0.5, 1e-6);}
+  };
+
+  // maximum number of iterations
+  R.SetOptimizerStoppingPolicy(0.0, 10, 0.0, 4);
+  for (const auto &setOptimizer : set_optimizer_funcs)
+  {
+    setOptimizer();
+
+    R.Execute(fixedImage, movingImage);
+
+    std::cout << "Stop Condition: " << R.GetOptimizerStopConditionDescription() << std::endl;
+    EXPECT_EQ(4u, R.GetOptimizerIteration());
+    EXPECT_NE(R.GetOptimizerStopConditionDescription().find("Maximum number of iterations"), std::string::npos);
+  }
+
+  // metric plateau, without the convergence criterion of the optimizer
+  R.SetOptimizerAsGradientDescent(1.0, 1000, 0.0, 1000);
+  R.SetOptimizerStoppingPolicy(1e-3, 5);
+  R.Execute(fixedImage, movingImage);
+  std::cout << "Stop Condition: " << R.GetOptimizerStopConditionDescription() << std::endl;
+  EXPECT_LT(R.GetOptimizerIteration(), 1000u);
+  EXPECT_NE(R.GetOptimizerStopConditionDescription().find("plateau"), std::string::npos);
+
+  // disabled
+  R.SetOptimizerStoppingPolicy(0.0);
+  R.SetOptimizerAsGradientDescent(1.0, 20, 0.0, 1000);
+  R.Execute(fixedImage, movingImage);
+  EXPECT_EQ(20u, R.GetOptimizerIteration());
+}
+
+
+TEST_F(sitkRegistrationMethodTest, Profile)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
+  sitk::Image movingImage = MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256});
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+  R.SetMetricSamplingStrategy(R.RANDOM);
+  R.SetMetricSamplingPercentage(0.5);
+  R.SetOptimizerAsGradientDescent(1.0, 10, 0.0, 1000);
+  R.SetOptimizerScalesFromPhysicalShift();
+  R.SetShrinkFactorsPerLevel({4, 2});
+  R.SetSmoothingSigmasPerLevel({2.0, 1.0});
+
+  EXPECT_FALSE(R.GetProfiling());
+  R.Execute(fixedImage, movingImage);
+  EXPECT_TRUE(R.GetProfile().empty());
+
+  R.ProfilingOn();
+  EXPECT_TRUE(R.GetProfiling());
+  R.Execute(fixedImage, movingImage);
+
+  const std::vector<sitk::ImageRegistrationLevelProfile> profile = R.GetProfile();
+  ASSERT_EQ(2u, profile.size());
+  unsigned int numberOfIterations = 0;
+  for (unsigned int level = 0; level < profile.size(); ++level)
+  {
+    const sitk::ImageRegistrationLevelProfile &p = profile[level];
+    std::cout << p.ToString();
+    EXPECT_EQ(level, p.GetLevel());
+    EXPECT_GT(p.GetInitializationTime(), 0.0);
+    EXPECT_GE(p.GetInitializationTime(), p.GetSamplingTime());
+    EXPECT_GE(p.GetOptimizationTime(), p.GetScalesEstimationTime());
+    EXPECT_GT(p.GetNumberOfIterations(), 0u);
+    EXPECT_EQ(p.GetNumberOfIterations(), p.GetIterationTimes().size());
+    EXPECT_EQ(p.GetNumberOfIterations(), p.GetMetricValues().size());
+    EXPECT_GT(p.GetMetricNumberOfValidPoints(), 0u);
+    numberOfIterations += p.GetNumberOfIterations();
+  }
+  EXPECT_EQ(R.GetMetricValue(), profile.back().GetMetricValues().back());
+  EXPECT_EQ(R.GetMetricNumberOfValidPoints(), profile.back().GetMetricNumberOfValidPoints());
+  EXPECT_EQ(20u, numberOfIterations);
+
+  R.ProfilingOff();
+  R.Execute(fixedImage, movingImage);
+  EXPECT_TRUE(R.GetProfile().empty());
+}
+
+
+TEST_F(sitkRegistrationMethodTest, IterationRecorder)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
+  sitk::Image movingImage = MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256});
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsGradientDescent(1.0, 10, 0.0, 1000);
+  R.SetOptimizerScalesFromPhysicalShift();
+  R.SetShrinkFactorsPerLevel({4, 2});
+  R.SetSmoothingSigmasPerLevel({2.0, 1.0});
+
+  sitk::IterationRecorderCommand recorder(R, 20);
+  EXPECT_EQ("IterationRecorderCommand", recorder.GetName());
+  EXPECT_EQ(0u, recorder.GetNumberOfRecords());
+  EXPECT_EQ(0u, recorder.GetNumberOfParameters());
+
+  R.AddCommand(sitk::sitkIterationEvent, recorder);
+  sitk::Transform outTx = R.Execute(fixedImage, movingImage);
+
+  ASSERT_EQ(20u, recorder.GetNumberOfRecords());
+  EXPECT_EQ(2u, recorder.GetNumberOfParameters());
+  EXPECT_EQ(20u, recorder.GetLevels().size());
+  EXPECT_EQ(20u, recorder.GetMetricValues().size());
+  EXPECT_EQ(20u, recorder.GetLearningRates().size());
+  EXPECT_EQ(20u, recorder.GetConvergenceValues().size());
+  ASSERT_EQ(40u, recorder.GetPositions().size());
+
+  EXPECT_EQ(0u, recorder.GetLevels().front());
+  EXPECT_EQ(1u, recorder.GetLevels().back());
+  EXPECT_EQ(0u, recorder.GetIterations()[10]);
+  EXPECT_EQ(9u, recorder.GetIterations().back());
+  EXPECT_EQ(R.GetMetricValue(), recorder.GetMetricValues().back());
+
+  const std::vector<double> lastPosition(recorder.GetPositions().end() - 2, recorder.GetPositions().end());
+  EXPECT_VECTOR_DOUBLE_NEAR(lastPosition, outTx.GetParameters(), 1e-6);
+
+  // the records are kept between executions
+  R.Execute(fixedImage, movingImage);
+  EXPECT_EQ(40u, recorder.GetNumberOfRecords());
+
+  recorder.Clear();
+  EXPECT_EQ(0u, recorder.GetNumberOfRecords());
+  EXPECT_TRUE(recorder.GetPositions().empty());
+}
+
+
+TEST_F(sitkRegistrationMethodTest, SinglePrecision)
+{
+  sitk::Image fixedImage = sitk::Cast(MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,}), sitk::sitkFloat64);
+  sitk::Image movingImage = sitk::Cast(MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256}), sitk::sitkFloat64);
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100);
+  R.SetOptimizerScalesFromPhysicalShift();
+
+  EXPECT_FALSE(R.GetUseSinglePrecision());
+  sitk::Transform outTx1 = R.Execute(fixedImage, movingImage);
+  const double metricValue1 = R.GetMetricValue();
+
+  R.UseSinglePrecisionOn();
+  EXPECT_TRUE(R.GetUseSinglePrecision());
+  sitk::Transform outTx2 = R.Execute(fixedImage, movingImage);
+  EXPECT_VECTOR_DOUBLE_NEAR(outTx1.GetParameters(), outTx2.GetParameters(), 1e-3);
+  EXPECT_NEAR(metricValue1, R.GetMetricValue(), 1e-5);
+
+  // a float64 image is cast to the pixel type of a float32 image
+  EXPECT_NO_THROW(R.Execute(fixedImage, sitk::Cast(movingImage, sitk::sitkFloat32)));
+
+  R.UseSinglePrecisionOff();
+  EXPECT_ANY_THROW(R.Execute(fixedImage, sitk::Cast(movingImage, sitk::sitkFloat32)));
+}
+
+
+TEST_F(sitkRegistrationMethodTest, DeterministicReduction)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
+  sitk::Image movingImage = MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256});
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+  R.SetMetricSamplingStrategy(R.RANDOM);
+  R.SetMetricSamplingPercentage(0.2, 42u);
+  R.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100);
+
+  EXPECT_FALSE(R.GetMetricUseDeterministicReduction());
+  R.MetricUseDeterministicReductionOn();
+  EXPECT_TRUE(R.GetMetricUseDeterministicReduction());
+
+  R.SetNumberOfThreads(1);
+  sitk::Transform outTx1 = R.Execute(fixedImage, movingImage);
+  const double metricValue1 = R.GetMetricValue();
+  const double evaluate1 = R.MetricEvaluate(fixedImage, movingImage);
+
+  R.SetNumberOfThreads(4);
+  sitk::Transform outTx2 = R.Execute(fixedImage, movingImage);
+
+  // bit for bit the same result
+  EXPECT_EQ(outTx1.GetParameters(), outTx2.GetParameters());
+  EXPECT_EQ(metricValue1, R.GetMetricValue());
+  EXPECT_EQ(evaluate1, R.MetricEvaluate(fixedImage, movingImage));
+
+  // the concurrent registrations of a batch have the same result
+  std::vector<sitk::Transform> outTxs = R.ExecuteBatch(fixedImage, { movingImage, movingImage });
+  ASSERT_EQ(2u, outTxs.size());
+  EXPECT_EQ(outTx1.GetParameters(), outTxs[0].GetParameters());
+  EXPECT_EQ(outTx1.GetParameters(), outTxs[1].GetParameters());
+
+  R.MetricUseDeterministicReductionOff();
+  EXPECT_FALSE(R.GetMetricUseDeterministicReduction());
+}
+
+
+TEST_F(sitkRegistrationMethodTest, WarmStart)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
+  sitk::Image movingImage1 = MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256});
+  sitk::Image movingImage2 = MakeDualGaussianBlobs({61.2, 65.1}, {51.4, 75.6}, {256,256});
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsGradientDescent(1.0, 100, 1e-8, 10, R.EachIteration);
+  R.SetOptimizerScalesFromPhysicalShift();
+  R.SetShrinkFactorsPerLevel({4, 2, 1});
+  R.SetSmoothingSigmasPerLevel({2.0, 1.0, 0.0});
+
+  EXPECT_TRUE(R.GetRegistrationState().IsEmpty());
+  EXPECT_FALSE(R.HasWarmStart());
+  EXPECT_ANY_THROW(R.SetWarmStart(R.GetRegistrationState()));
+
+  sitk::Transform outTx1 = R.Execute(fixedImage, movingImage1);
+  sitk::ImageRegistrationState state = R.GetRegistrationState();
+  EXPECT_FALSE(state.IsEmpty());
+  EXPECT_EQ(outTx1.GetParameters(), state.GetTransformParameters());
+  EXPECT_EQ(2u, state.GetOptimizerScales().size());
+  EXPECT_EQ(2u, state.GetLevel());
+  EXPECT_EQ(R.GetMetricValue(), state.GetMetricValue());
+
+  R.SetWarmStart(state);
+  EXPECT_TRUE(R.HasWarmStart());
+
+  sitk::Transform outTx2 = R.Execute(fixedImage, movingImage2);
+  EXPECT_EQ(2u, R.GetRegistrationState().GetLevel());
+  const unsigned int warmIterations = R.GetOptimizerIteration();
+
+  // the configuration and the initial transform are not modified
+  EXPECT_EQ(std::vector<double>({ 0.0, 0.0 }), tx.GetParameters());
+  EXPECT_TRUE(R.GetOptimizerScales().empty());
+
+  // the parameters must match the initial transform
+  R.SetInitialTransform(sitk::AffineTransform(2u), false);
+  EXPECT_ANY_THROW(R.Execute(fixedImage, movingImage2));
+
+  R.ClearWarmStart();
+  EXPECT_FALSE(R.HasWarmStart());
+  R.SetInitialTransform(tx, false);
+  sitk::Transform outTx3 = R.Execute(fixedImage, movingImage2);
+  EXPECT_VECTOR_DOUBLE_NEAR(outTx3.GetParameters(), outTx2.GetParameters(), 1e-2);
+  EXPECT_LE(warmIterations, R.GetOptimizerIteration());
+}
+
+
+TEST_F(sitkRegistrationMethodTest, CancellationToken)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs({ 64, 64}, {54, 74}, {256, 256,});
+  sitk::Image movingImage = MakeDualGaussianBlobs({61, 65}, {51.2, 75.5}, {256,256});
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+
+  sitk::TranslationTransform tx(2u);
+  R.SetInitialTransform(tx, false);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsGradientDescent(1.0, 100);
+
+  sitk::CancellationToken token;
+  R.SetCancellationToken(token);
+  EXPECT_TRUE(R.HasCancellationToken());
+  EXPECT_EQ(token, R.GetCancellationToken());
+
+  // a cancelled token prevents the execution
+  token.Cancel();
+  unsigned int numberOfIterations = 0;
+  R.AddCommand(sitk::sitkIterationEvent, [&numberOfIterations] { ++numberOfIterations; });
+  EXPECT_THROW(R.Execute(fixedImage, movingImage), sitk::GenericException);
+  EXPECT_EQ(0u, numberOfIterations);
+
+  // cancelling during the execution stops the optimizer
+  token.Reset();
+  constexpr unsigned int stop_iteration = 3;
+  R.AddCommand(sitk::sitkIterationEvent, [&R, &token, stop_iteration] {
+    if ( R.GetOptimizerIteration() >= stop_iteration )
+      {
+      token.Cancel();
+      }
+  });
+  EXPECT_THROW(R.Execute(fixedImage, movingImage), sitk::GenericException);
+  EXPECT_EQ(stop_iteration+1, R.GetOptimizerIteration());
+
+  // an expired deadline also cancels
+  token.Reset();
+  token.SetDeadline(0.0);
+  EXPECT_TRUE(token.IsCancelled());
+  EXPECT_THROW(R.Execute(fixedImage, movingImage), sitk::GenericException);
+
+  token.Reset();
+  R.RemoveCancellationToken();
+  EXPECT_FALSE(R.HasCancellationToken());
+  EXPECT_NO_THROW(R.Execute(fixedImage, movingImage));
+}
+
+
+TEST_F(sitkRegistrationMethodTest, ExecuteBatch)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(192, 192), std::vector<unsigned int>(2,256) );
+
+  std::vector<sitk::Image> movingImages;
+  std::vector<std::vector<double> > offsets;
+  for ( unsigned int i = 0; i < 4; ++i )
+    {
+    const double dx = 1.0 + i;
+    const double dy = -2.0 + 0.5*i;
+    offsets.push_back( v2(-dx, -dy) );
+    movingImages.push_back( MakeDualGaussianBlobs( v2(64-dx, 64-dy), v2(192-dx, 192-dy), std::vector<unsigned int>(2,256) ) );
+    }
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100, 0.5, 1e-10);
+
+  sitk::TranslationTransform tx(fixedImage.GetDimension());
+  R.SetInitialTransform(tx, true);
+
+  unsigned int numberOfIterations = 0;
+  R.AddCommand(sitk::sitkIterationEvent, [&numberOfIterations] { ++numberOfIterations; });
+
+  R.SetNumberOfThreads(3);
+  std::vector<sitk::Transform> outTxs = R.ExecuteBatch(fixedImage, movingImages);
+  ASSERT_EQ(movingImages.size(), outTxs.size());
+  for ( unsigned int i = 0; i < outTxs.size(); ++i )
+    {
+    EXPECT_VECTOR_DOUBLE_NEAR(offsets[i], outTxs[i].GetParameters(), 1e-2) << " registration: " << i;
+
+    // the same result as a single execution, on a copy of the initial transform
+    sitk::ImageRegistrationMethod S;
+    S.SetInterpolator(sitk::sitkLinear);
+    S.SetMetricAsMeanSquares();
+    S.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100, 0.5, 1e-10);
+    S.SetInitialTransform(sitk::TranslationTransform(fixedImage.GetDimension()), true);
+    sitk::Transform expectedTx = S.Execute(fixedImage, movingImages[i]);
+    EXPECT_VECTOR_DOUBLE_NEAR(expectedTx.GetParameters(), outTxs[i].GetParameters(), 1e-4) << " registration: " << i;
+    }
+
+  // neither the initial transform nor the commands are used by the batch
+  EXPECT_EQ(v2(0.0, 0.0), tx.GetParameters());
+  EXPECT_EQ(v2(0.0, 0.0), R.GetInitialTransform().GetParameters());
+  EXPECT_EQ(0u, numberOfIterations);
+
+  // pairs of fixed and moving images
+  std::vector<sitk::Image> fixedImages(movingImages.size(), fixedImage);
+  outTxs = R.ExecuteBatch(fixedImages, movingImages);
+  ASSERT_EQ(movingImages.size(), outTxs.size());
+  EXPECT_VECTOR_DOUBLE_NEAR(offsets.back(), outTxs.back().GetParameters(), 1e-2);
+
+  EXPECT_TRUE(R.ExecuteBatch(fixedImage, std::vector<sitk::Image>()).empty());
+  EXPECT_THROW(R.ExecuteBatch(std::vector<sitk::Image>(1, fixedImage), movingImages), sitk::GenericException);
+
+  // the first failure is rethrown
+  movingImages.push_back( sitk::Image(32,32,sitk::sitkUInt8) );
+  EXPECT_THROW(R.ExecuteBatch(fixedImage, movingImages), sitk::GenericException);
+
+  sitk::CancellationToken token;
+  token.Cancel();
+  R.SetCancellationToken(token);
+  movingImages.pop_back();
+  EXPECT_THROW(R.ExecuteBatch(fixedImage, movingImages), sitk::GenericException);
+}
+
+
+TEST_F(sitkRegistrationMethodTest, PyramidCache)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(192, 192), std::vector<unsigned int>(2,256) );
+  sitk::Image movingImage = MakeDualGaussianBlobs( v2(60, 66), v2(188, 194), std::vector<unsigned int>(2,256) );
+
+  sitk::ImageRegistrationMethod R;
+  EXPECT_FALSE(R.GetUsePyramidCache());
+  R.SetInterpolator(sitk::sitkLinear);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100, 0.5, 1e-10);
+  R.SetShrinkFactorsPerLevel({4, 2, 1});
+  R.SetSmoothingSigmasPerLevel({4.0, 2.0, 1.0});
+  R.SetInitialTransform(sitk::TranslationTransform(fixedImage.GetDimension()), false);
+
+  const std::vector<double> expected = R.Execute(fixedImage, movingImage).GetParameters();
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), expected, 1e-2);
+
+  R.UsePyramidCacheOn();
+  EXPECT_TRUE(R.GetUsePyramidCache());
+  EXPECT_NE(R.ToString().find("UsePyramidCache: 1"), std::string::npos);
+
+  // the first execution fills the cache, the second uses it
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+
+  // other initial transforms for the same images
+  sitk::TranslationTransform tx(fixedImage.GetDimension(), v2(-2.0, 1.0));
+  R.SetInitialTransform(tx, false);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), R.Execute(fixedImage, movingImage).GetParameters(), 1e-2);
+
+  // other images, and a modified image, are smoothed again
+  R.SetInitialTransform(sitk::TranslationTransform(fixedImage.GetDimension()), false);
+  sitk::Image shifted = MakeDualGaussianBlobs( v2(62, 66), v2(190, 194), std::vector<unsigned int>(2,256) );
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-2.0, 2.0), R.Execute(fixedImage, shifted).GetParameters(), 1e-2);
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+  const sitk::Image &constMovingImage = movingImage;
+  const void *buffer = constMovingImage.GetBufferAsVoid();
+  movingImage.SetPixelAsFloat({128, 128}, movingImage.GetPixelAsFloat({128, 128}));
+  EXPECT_NE(buffer, constMovingImage.GetBufferAsVoid());
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+
+  // the cache is shared by a batch
+  std::vector<sitk::Transform> outTxs = R.ExecuteBatch(fixedImage, {movingImage, shifted, movingImage});
+  ASSERT_EQ(3u, outTxs.size());
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), outTxs[0].GetParameters(), 1e-2);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-2.0, 2.0), outTxs[1].GetParameters(), 1e-2);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), outTxs[2].GetParameters(), 1e-2);
+
+  R.ClearPyramidCache();
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+
+  // the gradients of the levels are also cached
+  EXPECT_FALSE(R.GetPyramidCacheImageGradients());
+  R.PyramidCacheImageGradientsOn();
+  EXPECT_TRUE(R.GetPyramidCacheImageGradients());
+  EXPECT_NE(R.ToString().find("PyramidCacheImageGradients: 1"), std::string::npos);
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+  outTxs = R.ExecuteBatch(fixedImage, {movingImage, shifted});
+  ASSERT_EQ(2u, outTxs.size());
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), outTxs[0].GetParameters(), 1e-2);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-2.0, 2.0), outTxs[1].GetParameters(), 1e-2);
+  R.PyramidCacheImageGradientsOff();
+
+  R.UsePyramidCacheOff();
+  EXPECT_FALSE(R.GetUsePyramidCache());
+  EXPECT_VECTOR_DOUBLE_NEAR(expected, R.Execute(fixedImage, movingImage).GetParameters(), 1e-10);
+}
+
+
+TEST_F(sitkRegistrationMethodTest, ExecuteMultiStart)
+{
+  sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(192, 192), std::vector<unsigned int>(2,256) );
+  sitk::Image movingImage = MakeDualGaussianBlobs( v2(60, 66), v2(188, 194), std::vector<unsigned int>(2,256) );
+
+  sitk::ImageRegistrationMethod R;
+  R.SetInterpolator(sitk::sitkLinear);
+  R.SetMetricAsMeanSquares();
+  R.SetOptimizerAsRegularStepGradientDescent(1.0, 1e-4, 100, 0.5, 1e-10);
+  R.SetShrinkFactorsPerLevel({2, 1});
+  R.SetSmoothingSigmasPerLevel({2.0, 0.0});
+
+  std::vector<sitk::Transform> starts;
+  starts.push_back( sitk::TranslationTransform(2, v2(100.0, -100.0)) );
+  starts.push_back( sitk::TranslationTransform(2, v2(0.0, 0.0)) );
+  starts.push_back( sitk::TranslationTransform(2, v2(-3.0, 1.0)) );
+
+  R.SetNumberOfThreads(2);
+  sitk::Transform outTx = R.ExecuteMultiStart(fixedImage, movingImage, starts);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), outTx.GetParameters(), 1e-2);
+
+  std::vector<double> values = R.GetMultiStartMetricValues();
+  ASSERT_EQ(3u, values.size());
+  const unsigned int best = R.GetMultiStartBestIndex();
+  ASSERT_LT(best, 3u);
+  EXPECT_NE(0u, best);
+  EXPECT_DOUBLE_EQ(values[best], R.GetMetricValue());
+  for ( double value : values )
+    {
+    if ( !std::isnan(value) )
+      {
+      EXPECT_LE(values[best], value);
+      }
+    }
+  // the initial transforms are not modified
+  EXPECT_EQ(v2(-3.0, 1.0), starts[2].GetParameters());
+
+  // keep only the best start after the first level
+  outTx = R.ExecuteMultiStart(fixedImage, movingImage, starts, 1);
+  EXPECT_VECTOR_DOUBLE_NEAR(v2(-4.0, 2.0), outTx.GetParameters(), 1e-2);
+  values = R.GetMultiStartMetricValues();
+  ASSERT_EQ(3u, values.size());
+  EXPECT_EQ(2, std::count_if(values.begin(), values.end(), [](double v) { return std::isnan(v); }));
+  EXPECT_FALSE(std::isnan(values[R.GetMultiStartBestIndex()]));
+
+  EXPECT_THROW(R.ExecuteMultiStart(fixedImage, movingImage, std::vector<sitk::Transform>()), sitk::GenericException);
+}
+
+
 TEST_F(sitkRegistrationMethodTest, BSpline_adaptor)
 {
   sitk::Image fixedImage = MakeDualGaussianBlobs( v2(64, 64), v2(54, 74), std::vector<unsigned int>(2,256) );
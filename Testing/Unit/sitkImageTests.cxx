@@ -31,6 +31,7 @@
 #include "sitkComplexToImaginaryImageFilter.h"
 #include "sitkRealAndImaginaryToComplexImageFilter.h"
 #include "sitkImportImageFilter.h"
+#include "sitkMemoryStatistics.h"
 
 #include <itkIntTypes.h>
 
@@ -38,6 +39,7 @@
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
 #include <type_traits>
+#include <thread>
 
 const double adir[] = {0.0, 0.0, 1.0,
                        -1.0, 0.0, 0.0,
@@ -375,6 +377,44 @@ TEST_F(Image,Transforms) {
   }
 }
 
+TEST_F(Image,BatchTransforms) {
+
+  sitk::Image img( 10, 20, 30, sitk::sitkUInt8 );
+  img.SetOrigin( {1.1, -2.2, 3.3} );
+  img.SetSpacing( {0.5, 1.5, 2.0} );
+  img.SetDirection( {0.0, 1.0, 0.0,
+                     -1.0, 0.0, 0.0,
+                     0.0, 0.0, 1.0} );
+
+  const std::vector<int64_t> indices = { 0, 0, 0,
+                                         1, 2, 3,
+                                         -4, 50, 7 };
+  const std::vector<double> points = img.TransformIndicesToPhysicalPoints( indices );
+  ASSERT_EQ( indices.size(), points.size() );
+
+  const std::vector<double> cindices = img.TransformPhysicalPointsToContinuousIndices( points );
+  const std::vector<int64_t> roundTrip = img.TransformPhysicalPointsToIndices( points );
+  const std::vector<double> cpoints = img.TransformContinuousIndicesToPhysicalPoints( cindices );
+  EXPECT_EQ( indices, roundTrip );
+
+  for ( unsigned int p = 0; p < 3; ++p )
+    {
+    const std::vector<int64_t> idx( &indices[3*p], &indices[3*p+3] );
+    const std::vector<double> pt = img.TransformIndexToPhysicalPoint( idx );
+    const std::vector<double> cidx = img.TransformPhysicalPointToContinuousIndex( pt );
+    for ( unsigned int d = 0; d < 3; ++d )
+      {
+      EXPECT_NEAR( pt[d], points[3*p+d], 1e-12 );
+      EXPECT_NEAR( cidx[d], cindices[3*p+d], 1e-12 );
+      EXPECT_NEAR( pt[d], cpoints[3*p+d], 1e-12 );
+      }
+    }
+
+  EXPECT_TRUE( img.TransformPhysicalPointsToIndices( std::vector<double>() ).empty() );
+  EXPECT_ANY_THROW( img.TransformPhysicalPointsToIndices( {1.0, 2.0} ) ) << "Length not a multiple of the dimension";
+  EXPECT_ANY_THROW( img.TransformIndicesToPhysicalPoints( {1, 2, 3, 4} ) ) << "Length not a multiple of the dimension";
+}
+
 TEST_F(Image,Properties) {
 
   // GetOrigin
@@ -818,6 +858,18 @@ TEST_F(Image,Operators_InPlace)
 
   img = ( img *= 0 ) + 5;
   EXPECT_EQ( img.GetPixelAsUInt16({1,1}), 5);
+
+  // a temporary right-hand operand of a commutative operator is reused
+  sitk::Image a(10, 10, sitk::sitkFloat32);
+  a.SetPixelAsFloat( {2,3}, 3.0f );
+  sitk::Image temp = a * 2.0;
+  const void * tempBuffer = static_cast<const sitk::Image &>(temp).GetBufferAsVoid();
+  sitk::Image result = a + std::move(temp);
+  EXPECT_EQ( tempBuffer, static_cast<const sitk::Image &>(result).GetBufferAsVoid() );
+  EXPECT_EQ( 9.0f, result.GetPixelAsFloat( {2,3} ) );
+
+  result = 2.0 * ( a * a ) + a * ( a + 1.0 );
+  EXPECT_EQ( 30.0f, result.GetPixelAsFloat( {2,3} ) );
 }
 sitkClangDiagnosticPop();
 
@@ -1671,6 +1723,75 @@ TEST_F(Image, GetBufferVector)
 
 }
 
+TEST_F(Image, RegionAccess)
+{
+  sitk::Image img = sitk::Image( 10, 8, 6, sitk::sitkFloat32 );
+  float *buffer = img.GetBufferAsFloat();
+  for ( unsigned int i = 0; i < img.GetNumberOfPixels(); ++i )
+    {
+    buffer[i] = static_cast<float>(i);
+    }
+
+  std::vector<float> region( 3*2*4, -1.0f );
+  img.GetRegionAsFloat( {2, 1, 3}, {3, 2, 4}, &region[0] );
+  EXPECT_EQ( region[0], img.GetPixelAsFloat( {2, 1, 3} ) );
+  EXPECT_EQ( region[2], img.GetPixelAsFloat( {4, 1, 3} ) );
+  EXPECT_EQ( region[3], img.GetPixelAsFloat( {2, 2, 3} ) );
+  EXPECT_EQ( region[6], img.GetPixelAsFloat( {2, 1, 4} ) );
+  EXPECT_EQ( region.back(), img.GetPixelAsFloat( {4, 2, 5} ) );
+
+  ASSERT_ANY_THROW( img.GetRegionAsFloat( {8, 0, 0}, {3, 1, 1}, &region[0] ) ) << "Region out of bounds";
+  ASSERT_ANY_THROW( img.GetRegionAsFloat( {0, 0}, {1, 1}, &region[0] ) ) << "Dimension mismatch";
+  ASSERT_ANY_THROW( img.GetRegionAsDouble( {0, 0, 0}, {1, 1, 1}, nullptr ) ) << "Get with wrong type";
+
+  // copy on write is honored when setting a region
+  sitk::Image copy = img;
+  std::fill( region.begin(), region.end(), 99.0f );
+  copy.SetRegionFromFloat( {2, 1, 3}, {3, 2, 4}, &region[0] );
+  EXPECT_EQ( copy.GetPixelAsFloat( {2, 1, 3} ), 99.0f );
+  EXPECT_EQ( copy.GetPixelAsFloat( {4, 2, 5} ), 99.0f );
+  EXPECT_EQ( copy.GetPixelAsFloat( {5, 2, 5} ), img.GetPixelAsFloat( {5, 2, 5} ) );
+  EXPECT_NE( img.GetPixelAsFloat( {2, 1, 3} ), 99.0f );
+
+  // vector images copy all components of each pixel
+  sitk::Image vimg = sitk::Image( {5, 5}, sitk::sitkVectorUInt8, 3 );
+  std::vector<uint8_t> vregion( 2*2*3 );
+  for ( unsigned int i = 0; i < vregion.size(); ++i )
+    {
+    vregion[i] = static_cast<uint8_t>(i+1);
+    }
+  vimg.SetRegionFromUInt8( {1, 1}, {2, 2}, &vregion[0] );
+  EXPECT_EQ( vimg.GetPixelAsVectorUInt8( {1, 1} ), std::vector<uint8_t>({1, 2, 3}) );
+  EXPECT_EQ( vimg.GetPixelAsVectorUInt8( {2, 2} ), std::vector<uint8_t>({10, 11, 12}) );
+  EXPECT_EQ( vimg.GetPixelAsVectorUInt8( {0, 0} ), std::vector<uint8_t>({0, 0, 0}) );
+
+  sitk::Image limg = sitk::Image( 10, 10, sitk::sitkLabelUInt8 );
+  std::vector<uint8_t> lregion( 4 );
+  ASSERT_ANY_THROW( limg.GetRegionAsUInt8( {0, 0}, {2, 2}, &lregion[0] ) ) << "Label images are not supported";
+}
+
+TEST_F(Image, RegionOverwrite)
+{
+  sitk::Image img = sitk::Image( {6, 5}, sitk::sitkVectorFloat32, 2 );
+  img.SetSpacing( {0.5, 2.0} );
+  img.SetOrigin( {1.0, -1.0} );
+  img.SetMetaData( "key", "value" );
+
+  // overwriting the whole region of a shared image does not need the old values
+  sitk::Image copy = img;
+  std::vector<float> values( 6*5*2, 7.0f );
+  copy.SetRegionFromFloat( {0, 0}, {6, 5}, &values[0] );
+
+  EXPECT_TRUE( copy.IsUnique() );
+  EXPECT_TRUE( img.IsUnique() );
+  EXPECT_EQ( copy.GetPixelAsVectorFloat32( {5, 4} ), std::vector<float>({7.0f, 7.0f}) );
+  EXPECT_EQ( img.GetPixelAsVectorFloat32( {5, 4} ), std::vector<float>({0.0f, 0.0f}) );
+  EXPECT_EQ( copy.GetSpacing(), img.GetSpacing() );
+  EXPECT_EQ( copy.GetOrigin(), img.GetOrigin() );
+  EXPECT_EQ( copy.GetNumberOfComponentsPerPixel(), 2u );
+  EXPECT_EQ( copy.GetMetaData( "key" ), "value" );
+}
+
 TEST_F(Image,MetaDataDictionary)
 {
   sitk::Image img = sitk::Image( 10,10, 10, sitk::sitkFloat32 );
@@ -1724,6 +1845,36 @@ TEST_F(Image,MetaDataDictionary)
 
 }
 
+TEST_F(Image, CopyMetaData)
+{
+  sitk::Image img( {8, 6}, sitk::sitkUInt8 );
+  img.SetMetaData( "0010|0010", "name" );
+  img.SetMetaData( "0020|0013", "1" );
+
+  sitk::Image out( {4, 3}, sitk::sitkFloat32 );
+  out.SetMetaData( "other", "value" );
+  out.CopyMetaData( img );
+  EXPECT_EQ( img.GetMetaDataKeys(), out.GetMetaDataKeys() );
+  EXPECT_FALSE( out.HasMetaDataKey( "other" ) );
+  EXPECT_EQ( "name", out.GetMetaData( "0010|0010" ) );
+  EXPECT_EQ( std::vector<unsigned int>({4, 3}), out.GetSize() );
+
+  // the shared dictionary is copied on write
+  out.SetMetaData( "0020|0013", "2" );
+  EXPECT_TRUE( out.EraseMetaData( "0010|0010" ) );
+  EXPECT_EQ( "1", img.GetMetaData( "0020|0013" ) );
+  EXPECT_EQ( "2", out.GetMetaData( "0020|0013" ) );
+  EXPECT_TRUE( img.HasMetaDataKey( "0010|0010" ) );
+
+  // an image sharing the pixels of another one
+  sitk::Image copy = img;
+  copy.CopyMetaData( out );
+  EXPECT_FALSE( copy.HasMetaDataKey( "0010|0010" ) );
+  EXPECT_TRUE( img.HasMetaDataKey( "0010|0010" ) );
+  img.CopyMetaData( img );
+  EXPECT_EQ( 2u, img.GetMetaDataKeys().size() );
+}
+
 TEST_F(Image, MoveOperations)
 {
   sitk::Image img;
@@ -1942,6 +2093,283 @@ TEST_F(Image, Evaluate)
   }
 }
 
+TEST_F(Image, EvaluateBatch)
+{
+  sitk::Image img( 32, 24, sitk::sitkFloat32 );
+  img.SetSpacing( {0.5, 2.0} );
+  img.SetOrigin( {-3.0, 1.0} );
+  float *buffer = img.GetBufferAsFloat();
+  for ( unsigned int i = 0; i < img.GetNumberOfPixels(); ++i )
+    {
+    buffer[i] = static_cast<float>( i % 32 ) * 0.25f + static_cast<float>( i / 32 );
+    }
+
+  // enough points to be evaluated in parallel
+  std::vector<double> points;
+  for ( unsigned int i = 0; i < 2000; ++i )
+    {
+    points.push_back( -3.0 + 0.5 * ( ( i % 300 ) / 10.0 ) );
+    points.push_back( 1.0 + 2.0 * ( ( i % 220 ) / 10.0 ) );
+    }
+
+  for ( auto interp : {sitk::sitkNearestNeighbor, sitk::sitkLinear, sitk::sitkBSpline} )
+    {
+    const std::vector<double> values = img.EvaluateAtPhysicalPoints( points, interp );
+    ASSERT_EQ( points.size() / 2, values.size() );
+    for ( unsigned int i = 0; i < values.size(); i += 97 )
+      {
+      const std::vector<double> value = img.EvaluateAtPhysicalPoint( {points[2*i], points[2*i+1]}, interp );
+      EXPECT_NEAR( value[0], values[i], 1e-10 ) << " with interp as" << interp;
+      }
+    }
+
+  // the cached interpolator does not share the image, and the next
+  // write does not copy the buffer
+  EXPECT_TRUE( img.IsUnique() );
+  img.EvaluateAtPhysicalPoints( points, sitk::sitkLinear );
+  const uint64_t deepCopies = sitk::GetMemoryStatistics().NumberOfDeepCopies;
+  const void *evaluatedBuffer = static_cast<const sitk::Image &>( img ).GetBufferAsVoid();
+  img.SetPixelAsFloat( {1, 1}, 2.0f );
+  EXPECT_EQ( deepCopies, sitk::GetMemoryStatistics().NumberOfDeepCopies );
+  EXPECT_EQ( evaluatedBuffer, img.GetBufferAsVoid() );
+  img.EvaluateAtPhysicalPoints( points, sitk::sitkLinear );
+  img.SetOrigin( {-3.0, 1.0} );
+  EXPECT_EQ( evaluatedBuffer, img.GetBufferAsVoid() );
+  EXPECT_EQ( deepCopies, sitk::GetMemoryStatistics().NumberOfDeepCopies );
+
+  // modifying the image releases the cached interpolator
+  const std::vector<double> before = img.EvaluateAtContinuousIndices( {4.0, 5.0}, sitk::sitkBSpline );
+  img.SetPixelAsFloat( {4, 5}, 1000.0f );
+  const std::vector<double> after = img.EvaluateAtContinuousIndices( {4.0, 5.0}, sitk::sitkBSpline );
+  EXPECT_NE( before[0], after[0] );
+  EXPECT_NEAR( 1000.0, after[0], 1e-4 );
+
+  sitk::Image vimg( {8, 8}, sitk::sitkVectorFloat32, 3 );
+  vimg.SetPixelAsVectorFloat32( {1, 1}, {1.0f, 2.0f, 3.0f} );
+  EXPECT_VECTOR_DOUBLE_NEAR( vimg.EvaluateAtContinuousIndices( {1.0, 1.0, 0.0, 0.0}, sitk::sitkNearestNeighbor ),
+                             std::vector<double>({1.0, 2.0, 3.0, 0.0, 0.0, 0.0}), 1e-10 );
+
+  EXPECT_TRUE( img.EvaluateAtContinuousIndices( {} ).empty() );
+  EXPECT_ANY_THROW( img.EvaluateAtContinuousIndices( {1.0, 1.0, 1.0} ) ) << "Length not a multiple of the dimension";
+  EXPECT_ANY_THROW( img.EvaluateAtContinuousIndices( {1.0, 1.0, 40.0, 1.0} ) ) << "Index out of bounds";
+  EXPECT_ANY_THROW( vimg.EvaluateAtContinuousIndices( {1.0, 1.0}, sitk::sitkBSpline ) ) << "Unsupported interpolator";
+  EXPECT_ANY_THROW( sitk::Image( {3, 3}, sitk::sitkLabelUInt8 ).EvaluateAtContinuousIndices( {1.0, 1.0} ) );
+}
+
+TEST_F(Image, SubImage)
+{
+  sitk::Image img( {8, 6, 4}, sitk::sitkInt16 );
+  img.SetOrigin( {1.0, 2.0, 3.0} );
+  img.SetSpacing( {0.5, 1.0, 2.0} );
+  int16_t *buffer = img.GetBufferAsInt16();
+  for ( unsigned int i = 0; i < img.GetNumberOfPixels(); ++i )
+    {
+    buffer[i] = static_cast<int16_t>( i );
+    }
+
+  // full rows of one slice are contiguous and refer to the buffer
+  sitk::Image view = img.GetSubImage( {0, 2, 1}, {8, 3, 1} );
+  EXPECT_EQ( std::vector<unsigned int>({8, 3, 1}), view.GetSize() );
+  EXPECT_VECTOR_DOUBLE_NEAR( view.GetOrigin(), img.TransformIndexToPhysicalPoint( {0, 2, 1} ), 1e-10 );
+  EXPECT_EQ( img.GetSpacing(), view.GetSpacing() );
+  const sitk::Image &cimg = img;
+  const sitk::Image &cview = view;
+  EXPECT_EQ( cimg.GetBufferAsInt16() + 8 * 6 + 8 * 2, cview.GetBufferAsInt16() );
+  EXPECT_EQ( 64, view.GetPixelAsInt16( {0, 0, 0} ) );
+
+  // modifying either image does not modify the other
+  view.SetPixelAsInt16( {0, 0, 0}, -1 );
+  EXPECT_EQ( 64, img.GetPixelAsInt16( {0, 2, 1} ) );
+  EXPECT_EQ( -1, view.GetPixelAsInt16( {0, 0, 0} ) );
+
+  view = img.GetSubImage( {0, 0, 2}, {8, 6, 2} );
+  img.SetPixelAsInt16( {0, 0, 2}, -2 );
+  EXPECT_EQ( 96, view.GetPixelAsInt16( {0, 0, 0} ) );
+  EXPECT_EQ( -2, img.GetPixelAsInt16( {0, 0, 2} ) );
+
+  // a region which is not contiguous is copied
+  const sitk::Image copy = img.GetSubImage( {2, 1, 1}, {3, 2, 2} );
+  EXPECT_EQ( std::vector<unsigned int>({3, 2, 2}), copy.GetSize() );
+  EXPECT_EQ( img.GetPixelAsInt16( {4, 2, 2} ), copy.GetPixelAsInt16( {2, 1, 1} ) );
+  EXPECT_EQ( img.GetPixelAsInt16( {2, 1, 1} ), copy.GetPixelAsInt16( {0, 0, 0} ) );
+
+  sitk::Image vimg( {4, 4}, sitk::sitkVectorFloat32, 2 );
+  vimg.SetPixelAsVectorFloat32( {1, 3}, {1.0f, 2.0f} );
+  vimg.SetPixelAsVectorFloat32( {2, 2}, {3.0f, 4.0f} );
+  EXPECT_EQ( std::vector<float>({1.0f, 2.0f}), vimg.GetSubImage( {0, 3}, {4, 1} ).GetPixelAsVectorFloat32( {1, 0} ) );
+  EXPECT_EQ( std::vector<float>({3.0f, 4.0f}), vimg.GetSubImage( {1, 1}, {2, 2} ).GetPixelAsVectorFloat32( {1, 1} ) );
+
+  sitk::Image cplx( {4, 4}, sitk::sitkComplexFloat32 );
+  cplx.SetPixelAsComplexFloat32( {1, 2}, std::complex<float>( 1.0f, 2.0f ) );
+  cplx.SetPixelAsComplexFloat32( {3, 3}, std::complex<float>( 3.0f, 4.0f ) );
+  const sitk::Image cplxView = cplx.GetSubImage( {0, 2}, {4, 2} );
+  EXPECT_EQ( std::vector<unsigned int>({4, 2}), cplxView.GetSize() );
+  EXPECT_EQ( std::complex<float>( 1.0f, 2.0f ), cplxView.GetPixelAsComplexFloat32( {1, 0} ) );
+  EXPECT_EQ( std::complex<float>( 3.0f, 4.0f ), cplxView.GetPixelAsComplexFloat32( {3, 1} ) );
+  const sitk::Image &ccplx = cplx;
+  EXPECT_EQ( static_cast<const void *>( static_cast<const float *>( ccplx.GetBufferAsVoid() ) + 2 * 4 * 2 ), cplxView.GetBufferAsVoid() );
+  EXPECT_EQ( std::complex<float>( 3.0f, 4.0f ), cplx.GetSubImage( {2, 2}, {2, 2} ).GetPixelAsComplexFloat32( {1, 1} ) );
+
+  EXPECT_ANY_THROW( img.GetSubImage( {0, 0, 0}, {9, 1, 1} ) );
+  EXPECT_ANY_THROW( img.GetSubImage( {0, 0}, {1, 1} ) );
+  EXPECT_ANY_THROW( sitk::Image( {3, 3}, sitk::sitkLabelUInt8 ).GetSubImage( {0, 0}, {1, 1} ) );
+}
+
+TEST_F(Image, ReshapedView)
+{
+  sitk::Image img( {8, 6, 1}, sitk::sitkUInt16 );
+  img.SetOrigin( {1.0, 2.0, 3.0} );
+  uint16_t *buffer = img.GetBufferAsUInt16();
+  for ( unsigned int i = 0; i < img.GetNumberOfPixels(); ++i )
+    {
+    buffer[i] = static_cast<uint16_t>( i );
+    }
+
+  // the axes (x, y, 1) as (x, 1, y) refer to the same buffer
+  sitk::Image view = img.GetReshapedView( {8, 1, 6}, {1.0, 2.0, 3.0}, {1.0, 2.0, 3.0},
+                                          {1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0} );
+  EXPECT_EQ( std::vector<unsigned int>({8, 1, 6}), view.GetSize() );
+  EXPECT_EQ( std::vector<double>({1.0, 2.0, 3.0}), view.GetSpacing() );
+  EXPECT_EQ( std::vector<double>({1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0}), view.GetDirection() );
+  const sitk::Image &cimg = img;
+  const sitk::Image &cview = view;
+  EXPECT_EQ( cimg.GetBufferAsUInt16(), cview.GetBufferAsUInt16() );
+  EXPECT_EQ( 8 * 4 + 3, view.GetPixelAsUInt16( {3, 0, 4} ) );
+
+  // modifying the view does not modify the image
+  view.SetPixelAsUInt16( {3, 0, 4}, 1000 );
+  EXPECT_EQ( 8 * 4 + 3, img.GetPixelAsUInt16( {3, 4, 0} ) );
+  EXPECT_EQ( 1000, view.GetPixelAsUInt16( {3, 0, 4} ) );
+
+  sitk::Image vimg( {4, 1}, sitk::sitkVectorFloat32, 2 );
+  vimg.SetPixelAsVectorFloat32( {2, 0}, {1.0f, 2.0f} );
+  EXPECT_EQ( std::vector<float>({1.0f, 2.0f}),
+             vimg.GetReshapedView( {1, 4}, {0.0, 0.0}, {1.0, 1.0}, {0.0, 1.0, 1.0, 0.0} ).GetPixelAsVectorFloat32( {0, 2} ) );
+
+  EXPECT_ANY_THROW( img.GetReshapedView( {8, 6, 2}, {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}, img.GetDirection() ) );
+  EXPECT_ANY_THROW( img.GetReshapedView( {48}, {0.0}, {1.0}, {1.0} ) );
+  EXPECT_ANY_THROW( sitk::Image( {3, 3}, sitk::sitkLabelUInt8 ).GetReshapedView( {9, 1}, {0.0, 0.0}, {1.0, 1.0}, {1.0, 0.0, 0.0, 1.0} ) );
+}
+
+TEST_F(Image, InformationWrite)
+{
+  sitk::Image img( {16, 8, 4}, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {1, 2, 3}, 5.0f );
+  img.SetMetaData( "key", "value" );
+  const sitk::Image &cimg = img;
+
+  // the geometry of a shared image is modified without a copy of the pixels
+  const sitk::MemoryStatistics start = sitk::GetMemoryStatistics();
+  sitk::Image moved = img;
+  moved.SetOrigin( {1.0, 2.0, 3.0} );
+  moved.SetSpacing( {0.5, 0.5, 2.0} );
+  moved.SetDirection( {0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0} );
+  moved.SetMetaData( "other", "value" );
+  const sitk::Image &cmoved = moved;
+  EXPECT_EQ( cimg.GetBufferAsFloat(), cmoved.GetBufferAsFloat() );
+  EXPECT_EQ( start.NumberOfDeepCopies, sitk::GetMemoryStatistics().NumberOfDeepCopies );
+  EXPECT_EQ( start.NumberOfBuffers, sitk::GetMemoryStatistics().NumberOfBuffers );
+
+  EXPECT_EQ( std::vector<double>({0.0, 0.0, 0.0}), img.GetOrigin() );
+  EXPECT_EQ( std::vector<double>({1.0, 1.0, 1.0}), img.GetSpacing() );
+  EXPECT_FALSE( img.HasMetaDataKey( "other" ) );
+  EXPECT_EQ( std::vector<double>({1.0, 2.0, 3.0}), moved.GetOrigin() );
+  EXPECT_EQ( "value", moved.GetMetaData( "key" ) );
+
+  sitk::Image copy = img;
+  copy.CopyInformation( moved );
+  EXPECT_EQ( moved.GetDirection(), copy.GetDirection() );
+  EXPECT_EQ( cimg.GetBufferAsFloat(), static_cast<const sitk::Image &>( copy ).GetBufferAsFloat() );
+  EXPECT_TRUE( copy.EraseMetaData( "key" ) );
+  EXPECT_TRUE( img.HasMetaDataKey( "key" ) );
+
+  // the pixels are still copied on write
+  moved.SetPixelAsFloat( {1, 2, 3}, 1.0f );
+  EXPECT_EQ( 5.0f, img.GetPixelAsFloat( {1, 2, 3} ) );
+  EXPECT_EQ( 5.0f, copy.GetPixelAsFloat( {1, 2, 3} ) );
+  EXPECT_EQ( 1.0f, moved.GetPixelAsFloat( {1, 2, 3} ) );
+  img.SetPixelAsFloat( {1, 2, 3}, 2.0f );
+  EXPECT_EQ( 5.0f, copy.GetPixelAsFloat( {1, 2, 3} ) );
+}
+
+TEST_F(Image, MemoryStatistics)
+{
+  const sitk::MemoryStatistics start = sitk::GetMemoryStatistics();
+
+  sitk::Image img( {64, 32}, sitk::sitkFloat32 );
+  sitk::MemoryStatistics stats = sitk::GetMemoryStatistics();
+  EXPECT_EQ( start.NumberOfBuffers + 1, stats.NumberOfBuffers );
+  EXPECT_EQ( start.Bytes + 64 * 32 * sizeof(float), stats.Bytes );
+  EXPECT_LE( stats.Bytes, stats.PeakBytes );
+
+  // shared buffers and views are counted once
+  sitk::Image shared = img;
+  const sitk::Image view = img.GetSubImage( {0, 4}, {64, 8} );
+  EXPECT_EQ( stats.NumberOfBuffers, sitk::GetMemoryStatistics().NumberOfBuffers );
+  EXPECT_EQ( stats.Bytes, sitk::GetMemoryStatistics().Bytes );
+
+  shared.SetPixelAsFloat( {0, 0}, 1.0f );
+  stats = sitk::GetMemoryStatistics();
+  EXPECT_EQ( start.NumberOfBuffers + 2, stats.NumberOfBuffers );
+  EXPECT_EQ( start.NumberOfDeepCopies + 1, stats.NumberOfDeepCopies );
+
+  // the view keeps the original buffer alive
+  shared = sitk::Image();
+  img = sitk::Image();
+  stats = sitk::GetMemoryStatistics();
+  EXPECT_EQ( start.NumberOfBuffers + 1, stats.NumberOfBuffers );
+  EXPECT_EQ( start.Bytes + 64 * 32 * sizeof(float), stats.Bytes );
+  EXPECT_FALSE( stats.ToString().empty() );
+}
+
+TEST_F(Image, ConcurrentConstAccess)
+{
+  sitk::Image img( {32, 32, 8}, sitk::sitkFloat32 );
+  img.SetPixelAsFloat( {3, 4, 5}, 2.0f );
+  const std::string inputHash = sitk::Hash( img );
+  const std::string expectedHash = sitk::Hash( sitk::Add( img, img ) );
+  const sitk::Image &cimg = img;
+  const float *buffer = cimg.GetBufferAsFloat();
+
+  // separate filter instances share the input without copies
+  constexpr unsigned int numberOfThreads = 4;
+  std::vector<std::string> hashes( numberOfThreads );
+  std::vector<std::thread> threads;
+  for ( unsigned int t = 0; t < numberOfThreads; ++t )
+    {
+    threads.emplace_back( [&cimg, &hashes, t]()
+                          {
+                            for ( unsigned int i = 0; i < 4; ++i )
+                              {
+                              const sitk::Image copy = cimg;
+                              sitk::AddImageFilter filter;
+                              filter.SetNumberOfThreads( 1 );
+                              hashes[t] = sitk::Hash( filter.Execute( copy, cimg ) );
+                              }
+                          } );
+    }
+  for ( auto &thread : threads )
+    {
+    thread.join();
+    }
+
+  for ( const auto &hash : hashes )
+    {
+    EXPECT_EQ( expectedHash, hash );
+    }
+  EXPECT_EQ( inputHash, sitk::Hash( img ) );
+  EXPECT_EQ( buffer, cimg.GetBufferAsFloat() );
+  EXPECT_TRUE( img.IsUnique() );
+
+  // an image sharing the buffer with an ITK image is not unique
+  using ImageType = itk::Image<float, 3>;
+  ImageType::Pointer grafted = ImageType::New();
+  grafted->Graft( dynamic_cast<const ImageType *>( cimg.GetITKBase() ) );
+  EXPECT_FALSE( img.IsUnique() );
+  grafted = nullptr;
+  EXPECT_TRUE( img.IsUnique() );
+}
+
 TEST_F(Image, Evaluate_boundary) {
 
   sitk::Image img;
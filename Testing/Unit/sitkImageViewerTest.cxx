@@ -21,6 +21,7 @@
 #include "sitkImageViewerTest.h"
 #include <SimpleITKTestHarness.h>
 #include <itksys/SystemTools.hxx>
+#include <itksys/Directory.hxx>
 
 
 
@@ -112,6 +113,11 @@ TEST(ImageViewerTest,GlobalDefaults)
 
   iv.SetGlobalDefaultApplication( "testapp" );
   EXPECT_EQ( iv.GetGlobalDefaultApplication(), "testapp" );
+
+  iv.SetGlobalDefaultTempDirectory( "testdir" );
+  EXPECT_EQ( iv.GetGlobalDefaultTempDirectory(), "testdir" );
+  iv.SetGlobalDefaultTempDirectory( "" );
+  EXPECT_EQ( iv.GetGlobalDefaultTempDirectory(), "" );
   }
 
 TEST(ImageViewerTest,Execute)
@@ -125,6 +131,18 @@ TEST(ImageViewerTest,Execute)
   iv.SetFileExtension( ".png" );
   iv.Execute( img );
 
+  // the temporary file is written into the selected directory
+  const std::string dir = dataFinder.GetOutputDirectory() + "/ImageViewerTest";
+  itksys::SystemTools::RemoveADirectory( dir );
+  itksys::SystemTools::MakeDirectory( dir );
+  iv.SetGlobalDefaultTempDirectory( dir );
+  iv.Execute( img );
+  iv.SetGlobalDefaultTempDirectory( "" );
+  itksys::Directory files;
+  ASSERT_TRUE( files.Load( dir ) );
+  // the entries are ".", ".." and the image file
+  EXPECT_EQ( 3u, files.GetNumberOfFiles() );
+
   // strings to exercise the command conversion code
   itk::simple::ImageViewer iv2;
   iv2.SetTitle( "" );
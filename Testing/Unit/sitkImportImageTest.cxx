@@ -19,6 +19,8 @@
 #include <sitkHashImageFilter.h>
 #include <SimpleITKTestHarness.h>
 
+#include <fstream>
+
 // Common fixture for Import tests
 class Import
   : public ::testing::Test {
@@ -228,6 +230,154 @@ TEST_F(Import,Shallow) {
 
 }
 
+TEST_F(Import,OwnershipTransfer) {
+
+  // This test is designed to verify the image takes ownership of the buffer
+
+  int deleteCount = 0;
+  auto deleter = [&deleteCount]( void * p ) { ++deleteCount; delete [] static_cast<float *>(p); };
+
+  float * buffer = new float[16*16*3];
+  std::fill( buffer, buffer + 16*16*3, 5.0f );
+
+  sitk::Image image;
+  {
+  sitk::ImportImageFilter importer;
+  importer.SetSize( {16, 16} );
+  importer.SetBufferAsFloat( buffer, deleter, 3 );
+
+  image = importer.Execute();
+  EXPECT_EQ( sitk::sitkVectorFloat32, image.GetPixelID() );
+  EXPECT_EQ( static_cast<void *>( buffer ), image.GetBufferAsVoid() ) << " buffer is not copied";
+  }
+  EXPECT_EQ( 0, deleteCount ) << " the image holds the buffer";
+
+  sitk::Image shallow = image;
+  image = sitk::Image();
+  EXPECT_EQ( 0, deleteCount );
+  EXPECT_EQ( std::vector<float>( 3, 5.0f ), shallow.GetPixelAsVectorFloat32( {15, 15} ) );
+
+  shallow = sitk::Image();
+  EXPECT_EQ( 1, deleteCount ) << " the buffer is released with the last image";
+
+  // the filter's reference is released when a new buffer is set
+  sitk::ImportImageFilter importer;
+  importer.SetSize( {16, 16} );
+  importer.SetBufferAsFloat( new float[16*16*3], deleter, 3 );
+  float_buffer = std::vector< float >( 16*16 );
+  importer.SetBufferAsFloat( &float_buffer[0] );
+  EXPECT_EQ( 2, deleteCount );
+
+  ASSERT_ANY_THROW( importer.SetBufferAsFloat( &float_buffer[0], std::function<void(void*)>() ) ) << "Checking empty deleter";
+
+  // a failed call does not replace the buffer
+  float * owned = new float[16*16];
+  std::fill( owned, owned + 16*16, 3.0f );
+  importer.SetBufferAsFloat( owned, deleter );
+  std::vector< float > other( 16*16, 4.0f );
+  ASSERT_ANY_THROW( importer.SetBufferAsFloat( &other[0], std::function<void(void*)>() ) );
+  image = importer.Execute();
+  EXPECT_EQ( sitk::sitkFloat32, image.GetPixelID() );
+  EXPECT_EQ( static_cast<void *>( owned ), image.GetBufferAsVoid() );
+  EXPECT_EQ( 3.0f, image.GetPixelAsFloat( {2, 3} ) );
+  EXPECT_EQ( 2, deleteCount );
+  image = sitk::Image();
+  importer.SetBufferAsFloat( &float_buffer[0] );
+  EXPECT_EQ( 3, deleteCount );
+}
+
+TEST_F(Import,CopyOnWrite) {
+
+  // This test is designed to verify the buffer is only read with copy on write
+
+  uint8_buffer = std::vector< uint8_t >( 32*32, 17 );
+
+  sitk::ImportImageFilter importer;
+  importer.SetSize( std::vector< unsigned int >( 2, 32u ) );
+  importer.SetBufferAsUInt8( &uint8_buffer[0] );
+  EXPECT_FALSE( importer.GetCopyOnWrite() );
+  importer.CopyOnWriteOn();
+  EXPECT_TRUE( importer.GetCopyOnWrite() );
+
+  sitk::Image image = importer.Execute();
+  const sitk::Image &constImage = image;
+  EXPECT_EQ( static_cast<const void *>( &uint8_buffer[0] ), constImage.GetBufferAsVoid() ) << " buffer is not copied";
+  EXPECT_FALSE( image.IsUnique() );
+
+  uint8_buffer[1] = 19;
+  EXPECT_EQ ( 19,  image.GetPixelAsUInt8( {1, 0} ) ) << " buffer modifying image";
+
+  image.SetPixelAsUInt8( {0, 0}, 23 );
+  EXPECT_EQ ( 23,  image.GetPixelAsUInt8( {0, 0} ) ) << " direct setting of image";
+  EXPECT_EQ ( 17,  uint8_buffer[0] ) << " image not modifying buffer";
+  EXPECT_EQ ( 19,  image.GetPixelAsUInt8( {1, 0} ) ) << " copy of the buffer";
+  EXPECT_NE( static_cast<const void *>( &uint8_buffer[0] ), constImage.GetBufferAsVoid() );
+  EXPECT_TRUE( image.IsUnique() );
+}
+
+TEST_F(Import,MemoryMappedFile) {
+
+  // This test is designed to verify a raw file can be mapped as the buffer
+
+  const std::string filename = dataFinder.GetOutputFile( "Import.MemoryMappedFile.raw" );
+
+  const uint64_t offset = 16;
+  float_buffer = std::vector< float >( 11*7*3*2 );
+  for ( unsigned int i = 0; i < float_buffer.size(); ++i )
+    {
+    float_buffer[i] = static_cast<float>(i);
+    }
+  {
+  std::ofstream out( filename.c_str(), std::ios::binary );
+  const std::vector<char> header( offset, 'x' );
+  out.write( &header[0], header.size() );
+  out.write( reinterpret_cast<const char *>( &float_buffer[0] ), float_buffer.size()*sizeof(float) );
+  }
+
+  sitk::ImportImageFilter importer;
+  importer.SetSize( {11, 7, 3} );
+  importer.SetSpacing( spacing1 );
+  importer.SetMemoryMappedFile( filename, sitk::sitkVectorFloat32, 2, offset );
+  EXPECT_EQ( filename, importer.GetMemoryMappedFile() );
+
+  sitk::Image image = importer.Execute();
+  EXPECT_EQ( sitk::sitkVectorFloat32, image.GetPixelID() );
+  EXPECT_EQ( 2u, image.GetNumberOfComponentsPerPixel() );
+  EXPECT_EQ( std::vector<float>({0.0f, 1.0f}), image.GetPixelAsVectorFloat32( {0, 0, 0} ) );
+  EXPECT_EQ( std::vector<float>({460.0f, 461.0f}), image.GetPixelAsVectorFloat32( {10, 6, 2} ) );
+
+  // modifying the image does not modify the file
+  image.SetPixelAsVectorFloat32( {0, 0, 0}, {-1.0f, -2.0f} );
+  sitk::Image image2 = sitk::ImportFromMemoryMappedFile( filename, sitk::sitkVectorFloat32, {11, 7, 3},
+                                                         spacing1, origin0, direction3D, 2, offset );
+  EXPECT_EQ( std::vector<float>({0.0f, 1.0f}), image2.GetPixelAsVectorFloat32( {0, 0, 0} ) );
+
+  // setting a buffer replaces the file
+  importer.SetBufferAsFloat( &float_buffer[0], 2 );
+  EXPECT_TRUE( importer.GetMemoryMappedFile().empty() );
+
+  importer.SetMemoryMappedFile( filename, sitk::sitkFloat32, 1, offset + 2 );
+  ASSERT_ANY_THROW( importer.Execute() ) << "Checking misaligned offset";
+
+  importer.SetMemoryMappedFile( filename, sitk::sitkFloat32, 3, offset );
+  ASSERT_ANY_THROW( importer.Execute() ) << "Checking components of scalar type";
+
+  importer.SetMemoryMappedFile( dataFinder.GetOutputFile( "Import.NotAFile.raw" ), sitk::sitkFloat32 );
+  ASSERT_ANY_THROW( importer.Execute() ) << "Checking missing file";
+
+  importer.SetMemoryMappedFile( filename, sitk::sitkFloat32, 1, offset );
+  importer.SetSize( {11, 0, 3} );
+  try
+    {
+    importer.Execute();
+    FAIL() << "Checking empty size";
+    }
+  catch ( sitk::GenericException &e )
+    {
+    EXPECT_NE( std::string( e.what() ).find( "[11, 0, 3]" ), std::string::npos ) << e.what();
+    }
+}
+
 TEST_F(Import,ExhaustiveTypes) {
 
   sitk::ImportImageFilter importer;
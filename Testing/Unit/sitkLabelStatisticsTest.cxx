@@ -208,6 +208,46 @@ TEST(LabelStatistics,Shape_OBB) {
 
 
 
+TEST(LabelStatistics,Shape_LineAttributes) {
+
+  namespace sitk = itk::simple;
+
+  itk::simple::Image labelImage     = sitk::ReadImage( dataFinder.GetFile ( "Input/2th_cthead1.png" ), sitk::sitkUInt8 );
+  labelImage.SetSpacing( v2(0.5, 2.0) );
+  labelImage.SetOrigin( v2(-10.0, 3.0) );
+  labelImage.SetDirection( v4(0.0, -1.0, 1.0, 0.0) );
+
+  itk::simple::LabelShapeStatisticsImageFilter full;
+  EXPECT_TRUE(full.GetComputeMoments());
+  full.Execute( labelImage );
+
+  // only the attributes computed from the lines of the labels
+  itk::simple::LabelShapeStatisticsImageFilter lines;
+  lines.ComputeMomentsOff();
+  lines.ComputePerimeterOff();
+  EXPECT_FALSE(lines.GetComputeMoments());
+  lines.Execute( labelImage );
+
+  ASSERT_EQ( full.GetLabels(), lines.GetLabels() );
+  for (auto l : full.GetLabels())
+    {
+    EXPECT_EQ( full.GetNumberOfPixels(l), lines.GetNumberOfPixels(l) );
+    EXPECT_DOUBLE_EQ( full.GetPhysicalSize(l), lines.GetPhysicalSize(l) );
+    EXPECT_VECTOR_DOUBLE_NEAR( full.GetCentroid(l), lines.GetCentroid(l), 1e-8 );
+    EXPECT_EQ( full.GetBoundingBox(l), lines.GetBoundingBox(l) );
+    EXPECT_EQ( full.GetNumberOfPixelsOnBorder(l), lines.GetNumberOfPixelsOnBorder(l) );
+    EXPECT_DOUBLE_EQ( full.GetPerimeterOnBorder(l), lines.GetPerimeterOnBorder(l) );
+    EXPECT_DOUBLE_EQ( full.GetEquivalentSphericalRadius(l), lines.GetEquivalentSphericalRadius(l) );
+    EXPECT_DOUBLE_EQ( full.GetEquivalentSphericalPerimeter(l), lines.GetEquivalentSphericalPerimeter(l) );
+
+    // the moments are not computed
+    EXPECT_NE( 0.0, full.GetElongation(l) );
+    EXPECT_EQ( 0.0, lines.GetElongation(l) );
+    EXPECT_EQ( 0.0, lines.GetPerimeter(l) );
+    }
+}
+
+
 
 
 TEST(LabelStatistics,Shape_GetIndexes) {
@@ -18,6 +18,7 @@
 
 #include "itksys/SystemTools.hxx"
 #include "itksys/SystemInformation.hxx"
+#include "sitkProcessObject.h"
 
 #include <iostream>
 #include <fstream>
@@ -119,6 +120,31 @@ void SystemInformationPrint(std::ostream& os)
      << mySys.GetTotalPhysicalMemory() << std::endl;
   os << "AvailablePhysicalMemory:      "
      << mySys.GetAvailablePhysicalMemory() << std::endl;
+
+  namespace sitk = itk::simple;
+
+  os << "---------- Threading Information ----------" << std::endl;
+
+  os << "GlobalDefaultThreader:        "
+     << sitk::ProcessObject::GetGlobalDefaultThreader() << std::endl;
+  os << "GlobalDefaultNumberOfThreads: "
+     << sitk::ProcessObject::GetGlobalDefaultNumberOfThreads() << std::endl;
+  os << "GlobalDefaultNUMAPolicy:      "
+     << sitk::ProcessObject::GetGlobalDefaultNUMAPolicy() << std::endl;
+  os << "GlobalDefaultInstructionSet:  "
+     << sitk::ProcessObject::GetGlobalDefaultInstructionSet() << std::endl;
+  os << "NumberOfNUMANodes:            "
+     << sitk::ProcessObject::GetNumberOfNUMANodes() << std::endl;
+  for ( unsigned int node = 0; node < sitk::ProcessObject::GetNumberOfNUMANodes(); ++node )
+    {
+    const std::vector<unsigned int> cpus = sitk::ProcessObject::GetNUMANodeCPUs( node );
+    os << "NUMANode" << node << "CPUs:" << std::string( node < 10 ? 16 : 15, ' ' ) << cpus.size() << " [";
+    for ( size_t i = 0; i < cpus.size(); ++i )
+      {
+      os << ( i ? "," : "" ) << cpus[i];
+      }
+    os << "]" << std::endl;
+    }
 }
 
 
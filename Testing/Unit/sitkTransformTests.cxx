@@ -45,6 +45,8 @@
 #include "itkMath.h"
 #include "itkVectorImage.h"
 
+#include <fstream>
+
 namespace sitk = itk::simple;
 
 TEST(TransformTest, Construction) {
@@ -538,6 +540,82 @@ TEST(TransformTest, ReadTransformConvert) {
 
 }
 
+TEST(TransformTest, ReadWriteBinaryTransform) {
+
+  const std::string filename = dataFinder.GetOutputFile ( "TransformTest.ReadWriteBinaryTransform.sitktx" );
+  const std::vector<double> point = {1.5, -2.25, 3.0};
+
+  {
+  sitk::AffineTransform tx(3);
+  tx.SetMatrix( {1.0, 0.1, 0.0, 0.0, 1.2, 0.3, 0.2, 0.0, 0.9} );
+  tx.SetTranslation( {1.0, 2.0, 3.0} );
+  tx.SetCenter( {0.5, 0.5, 0.5} );
+  sitk::WriteTransform( tx, filename );
+  sitk::Transform read = sitk::ReadTransform( filename );
+  EXPECT_EQ( sitk::sitkAffine, read.GetTransformEnum() );
+  EXPECT_EQ( tx.GetParameters(), read.GetParameters() );
+  EXPECT_EQ( tx.GetFixedParameters(), read.GetFixedParameters() );
+  }
+  {
+  sitk::Image coefficients( 8, 7, 6, sitk::sitkFloat64 );
+  coefficients.SetSpacing( {2.0, 3.0, 4.0} );
+  sitk::BSplineTransform tx( {coefficients, coefficients, coefficients}, 2 );
+  std::vector<double> parameters = tx.GetParameters();
+  for ( size_t i = 0; i < parameters.size(); ++i )
+    {
+    parameters[i] = 0.001 * i;
+    }
+  tx.SetParameters( parameters );
+  sitk::WriteTransform( tx, filename );
+  sitk::BSplineTransform read = sitk::BSplineTransform( sitk::ReadTransform( filename ) );
+  EXPECT_EQ( 2u, read.GetOrder() );
+  EXPECT_EQ( tx.GetParameters(), read.GetParameters() );
+  EXPECT_EQ( tx.GetFixedParameters(), read.GetFixedParameters() );
+  EXPECT_EQ( tx.TransformPoint( point ), read.TransformPoint( point ) );
+  }
+  {
+  sitk::Image field( {10, 11, 12}, sitk::sitkVectorFloat64 );
+  field.SetOrigin( {-1.0, 2.0, 0.5} );
+  field.SetSpacing( {1.0, 0.5, 2.0} );
+  double *buffer = field.GetBufferAsDouble();
+  for ( size_t i = 0; i < field.GetNumberOfPixels() * 3; ++i )
+    {
+    buffer[i] = 0.01 * ( i % 97 );
+    }
+  const std::string fieldHash = sitk::Hash( field );
+  sitk::DisplacementFieldTransform tx( field );
+  sitk::WriteTransform( tx, filename );
+  sitk::DisplacementFieldTransform read = sitk::DisplacementFieldTransform( sitk::ReadTransform( filename ) );
+  EXPECT_EQ( sitk::sitkDisplacementField, read.GetTransformEnum() );
+  sitk::Image readField = read.GetDisplacementField();
+  EXPECT_EQ( fieldHash, sitk::Hash( readField ) );
+  EXPECT_EQ( std::vector<double>( {-1.0, 2.0, 0.5} ), readField.GetOrigin() );
+  EXPECT_EQ( std::vector<double>( {1.0, 0.5, 2.0} ), readField.GetSpacing() );
+  EXPECT_EQ( tx.TransformPoint( point ), read.TransformPoint( point ) );
+  }
+  {
+  sitk::TranslationTransform translation( 2, {1.0, -1.0} );
+  sitk::Euler2DTransform rotation( {0.5, 0.5}, 0.3 );
+  sitk::CompositeTransform nested( {translation, rotation} );
+  sitk::CompositeTransform tx( {nested, sitk::ScaleTransform( 2, {2.0, 0.5} )} );
+  sitk::WriteTransform( tx, filename );
+  sitk::Transform read = sitk::ReadTransform( filename );
+  EXPECT_EQ( sitk::sitkComposite, read.GetTransformEnum() );
+  EXPECT_EQ( tx.TransformPoint( {3.0, 4.0} ), read.TransformPoint( {3.0, 4.0} ) );
+  }
+
+  // not a binary transform file
+  const std::string textFile = dataFinder.GetOutputFile ( "TransformTest.ReadWriteBinaryTransform.txt" );
+  sitk::WriteTransform( sitk::AffineTransform( 2 ), textFile );
+  const std::string badFile = dataFinder.GetOutputFile ( "TransformTest.ReadWriteBinaryTransform.bad.sitktx" );
+  {
+  std::ifstream in( textFile.c_str(), std::ios::binary );
+  std::ofstream out( badFile.c_str(), std::ios::binary );
+  out << in.rdbuf();
+  }
+  EXPECT_ANY_THROW( sitk::ReadTransform( badFile ) );
+}
+
 TEST(TransformTest, TransformPoint) {
   sitk::Transform tx2 = sitk::Transform( 2, sitk::sitkIdentity );
   sitk::Transform tx3 = sitk::Transform( 3, sitk::sitkIdentity );
@@ -595,6 +673,60 @@ TEST(TransformTest, TransformVector) {
 }
 
 
+TEST(TransformTest, TransformPoints) {
+
+  sitk::Euler3DTransform euler( v3( 1.0, 2.0, 3.0 ), 0.1, -0.2, 0.3, v3( 4.0, -5.0, 6.0 ) );
+
+  sitk::BSplineTransform bspline( 3 );
+  bspline.SetTransformDomainOrigin( v3( -10.0, -10.0, -10.0 ) );
+  bspline.SetTransformDomainPhysicalDimensions( v3( 40.0, 40.0, 40.0 ) );
+  std::vector<double> parameters( bspline.GetNumberOfParameters() );
+  for ( size_t i = 0; i < parameters.size(); ++i )
+    {
+    parameters[i] = 0.01 * ( i % 7 );
+    }
+  bspline.SetParameters( parameters );
+
+  // more points than one block, so that they are transformed concurrently
+  const size_t numberOfPoints = 10001;
+  std::vector<double> points( 3 * numberOfPoints );
+  std::vector<double> vectors( 3 * numberOfPoints );
+  for ( size_t i = 0; i < points.size(); ++i )
+    {
+    points[i] = 0.002 * i - 5.0;
+    vectors[i] = 1.0 + ( i % 5 );
+    }
+
+  for ( const sitk::Transform &tx : { sitk::Transform( euler ), sitk::Transform( bspline ) } )
+    {
+    const std::vector<double> outputPoints = tx.TransformPoints( points );
+    const std::vector<double> outputVectors = tx.TransformVectors( vectors, points );
+    ASSERT_EQ( points.size(), outputPoints.size() );
+    ASSERT_EQ( vectors.size(), outputVectors.size() );
+    for ( size_t i = 0; i < numberOfPoints; i += 97 )
+      {
+      const std::vector<double> pt( points.begin() + 3 * i, points.begin() + 3 * ( i + 1 ) );
+      const std::vector<double> vec( vectors.begin() + 3 * i, vectors.begin() + 3 * ( i + 1 ) );
+      EXPECT_VECTOR_DOUBLE_NEAR( tx.TransformPoint( pt ),
+                                 std::vector<double>( outputPoints.begin() + 3 * i, outputPoints.begin() + 3 * ( i + 1 ) ),
+                                 1e-12 );
+      EXPECT_VECTOR_DOUBLE_NEAR( tx.TransformVector( vec, pt ),
+                                 std::vector<double>( outputVectors.begin() + 3 * i, outputVectors.begin() + 3 * ( i + 1 ) ),
+                                 1e-12 );
+      }
+
+    // the output may be the input
+    std::vector<double> inPlace( points );
+    tx.TransformPoints( inPlace.data(), inPlace.data(), numberOfPoints );
+    EXPECT_EQ( outputPoints, inPlace );
+    }
+
+  EXPECT_TRUE( euler.TransformPoints( std::vector<double>() ).empty() );
+  EXPECT_ANY_THROW( euler.TransformPoints( v2( 1.0, 2.0 ) ) );
+  EXPECT_ANY_THROW( euler.TransformVectors( v3( 1.0, 2.0, 3.0 ), std::vector<double>() ) );
+}
+
+
 TEST(TransformTest,AffineTransform)
 {
   // test AffineTransform
@@ -1124,6 +1256,93 @@ TEST(TransformTest,DisplacementFieldTransform_Points)
 
 }
 
+TEST(TransformTest,DisplacementFieldTransform_Float32)
+{
+  sitk::Image disImage( std::vector<unsigned int>(2,5u), sitk::sitkVectorFloat32 );
+  disImage.SetSpacing( v2( 2.0, 2.0 ) );
+  disImage.SetPixelAsVectorFloat32( {1,1}, std::vector<float>{ 0.5f, -0.25f } );
+
+  sitk::DisplacementFieldTransform tx( disImage );
+  EXPECT_EQ( 0u, disImage.GetNumberOfPixels() );
+  EXPECT_VECTOR_DOUBLE_NEAR( tx.TransformPoint( v2( 2.0, 2.0 ) ), v2( 2.5, 1.75 ), 1e-15 );
+  EXPECT_VECTOR_DOUBLE_NEAR( tx.TransformPoint( v2( 3.0, 2.0 ) ), v2( 3.25, 1.875 ), 1e-15 );
+
+  const sitk::Image field = tx.GetDisplacementField();
+  EXPECT_EQ( sitk::sitkVectorFloat64, field.GetPixelID() );
+  EXPECT_VECTOR_DOUBLE_NEAR( field.GetSpacing(), v2( 2.0, 2.0 ), 1e-15 );
+
+  sitk::Image inverse( std::vector<unsigned int>(2,5u), sitk::sitkVectorFloat32 );
+  EXPECT_NO_THROW( tx.SetInverseDisplacementField( inverse ) );
+
+  sitk::Image wrongComponents( std::vector<unsigned int>(2,5u), sitk::sitkVectorFloat32, 3 );
+  EXPECT_THROW( tx.SetDisplacementField( wrongComponents ), sitk::GenericException );
+  sitk::Image wrongType( std::vector<unsigned int>(2,5u), sitk::sitkVectorInt16 );
+  EXPECT_THROW( tx.SetDisplacementField( wrongType ), sitk::GenericException );
+}
+
+TEST(TransformTest,DisplacementFieldTransform_ComposeAndInvert)
+{
+  const unsigned int n = 32;
+  auto makeField = [n]( double amplitude, double phase )
+    {
+      sitk::Image field( std::vector<unsigned int>(2,n), sitk::sitkVectorFloat64 );
+      for ( unsigned int j = 0; j < n; ++j )
+        {
+        for ( unsigned int i = 0; i < n; ++i )
+          {
+          const double x = 2.0 * itk::Math::pi * i / ( n - 1 );
+          const double y = 2.0 * itk::Math::pi * j / ( n - 1 );
+          field.SetPixelAsVectorFloat64( {i,j}, v2( amplitude * std::sin( y + phase ), amplitude * std::cos( x + phase ) ) );
+          }
+        }
+      return field;
+    };
+
+  sitk::Image field1 = makeField( 0.5, 0.0 );
+  sitk::Image field2 = makeField( 0.75, 1.0 );
+  const sitk::DisplacementFieldTransform tx1( field1 );
+  const sitk::DisplacementFieldTransform tx2( field2 );
+
+  sitk::CompositeTransform composite( 2 );
+  composite.AddTransform( tx2 );
+  composite.AddTransform( tx1 );
+
+  // composing with a translation adds a constant displacement
+  sitk::DisplacementFieldTransform translated( tx1 );
+  translated.ComposeTransform( sitk::TranslationTransform( 2, v2( 1.0, -0.5 ) ) );
+  const std::vector<double> point = tx1.TransformPoint( v2( 10.0, 20.0 ) );
+  EXPECT_VECTOR_DOUBLE_NEAR( translated.TransformPoint( v2( 10.0, 20.0 ) ), v2( point[0] + 1.0, point[1] - 0.5 ), 1e-12 );
+
+  sitk::DisplacementFieldTransform composed( tx1 );
+  composed.ComposeTransform( tx2 );
+  EXPECT_EQ( composed.GetDisplacementField().GetSize(), tx1.GetDisplacementField().GetSize() );
+  for ( double p = 2.0; p < 26.0; p += 3.0 )
+    {
+    EXPECT_VECTOR_DOUBLE_NEAR( composed.TransformPoint( v2( p, 27.0 - p ) ), composite.TransformPoint( v2( p, 27.0 - p ) ), 1e-12 );
+    }
+
+  // copy on write, tx1 is not modified
+  EXPECT_VECTOR_DOUBLE_NEAR( tx1.TransformPoint( v2( 10.0, 20.0 ) ), v2( 10.0 + 0.5 * std::sin( 2.0 * itk::Math::pi * 20 / ( n - 1 ) ), 20.0 + 0.5 * std::cos( 2.0 * itk::Math::pi * 10 / ( n - 1 ) ) ), 1e-12 );
+
+  EXPECT_THROW( composed.ComposeTransform( sitk::TranslationTransform( 3 ) ), sitk::GenericException );
+
+  sitk::DisplacementFieldTransform inverted( tx1 );
+  const double residual = inverted.ComputeInverseDisplacementField( 50, 1e-6 );
+  EXPECT_LT( residual, 1e-6 );
+  const sitk::Image inverse = inverted.GetInverseDisplacementField();
+  EXPECT_EQ( inverse.GetSize(), tx1.GetDisplacementField().GetSize() );
+
+  const sitk::Transform inverseTransform = inverted.GetInverse();
+  for ( unsigned int p = 4; p < n - 4; p += 3 )
+    {
+    const std::vector<double> y = v2( p, n - 1 - p );
+    EXPECT_VECTOR_DOUBLE_NEAR( tx1.TransformPoint( inverseTransform.TransformPoint( y ) ), y, 1e-5 );
+    }
+
+  // warm started from the current inverse
+  EXPECT_LT( inverted.ComputeInverseDisplacementField( 0, 1e-6 ), 1e-6 );
+}
+
 TEST(BasicFilters, DisplacementField_GetDisplacementField)
   {
     // A test case where a double free was occurring, due to change in
@@ -2734,6 +2953,68 @@ TEST(TransformTest, Composite_FlattenTransform) {
   EXPECT_NO_THROW(sitk::WriteTransform(tx1, filename));
 }
 
+TEST(TransformTest, Composite_CollapseTransform) {
+
+  sitk::Euler2DTransform rigid( v2( 1.0, 2.0 ), 0.3, v2( 3.0, -4.0 ) );
+  sitk::AffineTransform affine( 2 );
+  affine.SetMatrix( { 1.1, 0.1, -0.2, 0.9 } );
+  affine.SetTranslation( v2( -1.0, 0.5 ) );
+
+  sitk::BSplineTransform bspline( 2 );
+  bspline.SetTransformDomainOrigin( v2( -20.0, -20.0 ) );
+  bspline.SetTransformDomainPhysicalDimensions( v2( 60.0, 60.0 ) );
+  std::vector<double> parameters( bspline.GetNumberOfParameters() );
+  for ( size_t i = 0; i < parameters.size(); ++i )
+    {
+    parameters[i] = 0.1 * ( i % 3 );
+    }
+  bspline.SetParameters( parameters );
+
+  sitk::CompositeTransform nested( { sitk::TranslationTransform( 2, v2( 0.5, 0.25 ) ), sitk::Transform( 2, sitk::sitkIdentity ) } );
+  sitk::CompositeTransform ctx( { rigid, nested, affine, bspline } );
+  const sitk::CompositeTransform original( ctx );
+
+  ctx.CollapseTransform();
+
+  // the linear transforms are merged into one affine, the identity is removed
+  ASSERT_EQ( 2u, ctx.GetNumberOfTransforms() );
+  EXPECT_EQ( sitk::sitkAffine, ctx.GetNthTransform( 0 ).GetTransformEnum() );
+  EXPECT_EQ( sitk::sitkBSplineTransform, ctx.GetBackTransform().GetTransformEnum() );
+  EXPECT_EQ( 4u, original.GetNumberOfTransforms() );
+
+  for ( double x = -5.0; x <= 15.0; x += 2.5 )
+    {
+    EXPECT_VECTOR_DOUBLE_NEAR( original.TransformPoint( v2( x, 2.0 * x ) ), ctx.TransformPoint( v2( x, 2.0 * x ) ), 1e-10 );
+    }
+
+  // a run of one transform is kept
+  sitk::CompositeTransform single( { rigid, bspline } );
+  single.CollapseTransform();
+  ASSERT_EQ( 2u, single.GetNumberOfTransforms() );
+  EXPECT_EQ( sitk::sitkEuler, single.GetNthTransform( 0 ).GetTransformEnum() );
+
+  // a transform and its inverse compose to the identity
+  sitk::CompositeTransform inverse( { rigid, rigid.GetInverse() } );
+  inverse.CollapseTransform();
+  EXPECT_LE( inverse.GetNumberOfTransforms(), 1u );
+
+  // the non-linear tail is baked into a displacement field on the grid
+  sitk::CompositeTransform baked( { rigid, affine, bspline } );
+  const sitk::CompositeTransform unbaked( baked );
+  baked.CollapseTransform( { 21u, 21u }, v2( -5.0, -5.0 ), v2( 1.0, 1.0 ) );
+  ASSERT_EQ( 2u, baked.GetNumberOfTransforms() );
+  EXPECT_EQ( sitk::sitkAffine, baked.GetNthTransform( 0 ).GetTransformEnum() );
+  EXPECT_EQ( sitk::sitkDisplacementField, baked.GetBackTransform().GetTransformEnum() );
+  for ( double x = -5.0; x <= 15.0; x += 1.0 )
+    {
+    // at the grid points the displacement field is exact
+    EXPECT_VECTOR_DOUBLE_NEAR( unbaked.TransformPoint( v2( x, 10.0 - x ) ), baked.TransformPoint( v2( x, 10.0 - x ) ), 1e-8 );
+    }
+
+  EXPECT_ANY_THROW( baked.CollapseTransform( { 21u }, v2( -5.0, -5.0 ), v2( 1.0, 1.0 ) ) );
+}
+
+
 TEST(TransformTest, CompositeTransform_Nested) {
 
   sitk::CompositeTransform ctx1( {
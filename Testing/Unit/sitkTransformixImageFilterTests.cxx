@@ -3,6 +3,9 @@
 #include "sitkCastImageFilter.h"
 #include "sitkElastixImageFilter.h"
 #include "sitkTransformixImageFilter.h"
+#include "sitkStatisticsImageFilter.h"
+#include "sitkSubtractImageFilter.h"
+#include "sitkAbsImageFilter.h"
 
 namespace itk {
   namespace simple {
@@ -115,6 +118,95 @@ TEST( TransformixImageFilter, ComputeDeformationField )
   EXPECT_GT( deformationVector[1], 1.0);
 }
 
+TEST( TransformixImageFilter, ExecuteBatch )
+{
+  Image fixedImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) ), sitkFloat32 );
+  Image movingImage = Cast( ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) ), sitkFloat32 );
+  Image labelImage = Cast( movingImage, sitkUInt8 );
+
+  ElastixImageFilter silx;
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.SetParameter( "MaximumNumberOfIterations", "20" );
+  silx.Execute();
+
+  TransformixImageFilter stfx;
+  ASSERT_THROW( stfx.PrepareTransform(), GenericException );
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  stfx.SetMovingImage( movingImage );
+  const Image expected = stfx.Execute();
+
+  std::vector< Image > results;
+  EXPECT_NO_THROW( results = stfx.ExecuteBatch( { movingImage, labelImage }, { sitkBSpline, sitkNearestNeighbor } ) );
+  ASSERT_EQ( results.size(), 2u );
+  EXPECT_EQ( results[0].GetPixelID(), sitkFloat32 );
+  EXPECT_EQ( results[0].GetSize(), expected.GetSize() );
+  EXPECT_EQ( results[1].GetPixelID(), sitkUInt8 );
+  EXPECT_EQ( results[1].GetSize(), expected.GetSize() );
+
+  StatisticsImageFilter stats;
+  stats.Execute( Abs( Subtract( results[0], expected ) ) );
+  EXPECT_LT( stats.GetMaximum(), 0.5 );
+
+  // the prepared transform is reused with the interpolator of the parameter map
+  EXPECT_NO_THROW( stfx.PrepareTransform() );
+  EXPECT_NO_THROW( results = stfx.ExecuteBatch( { movingImage } ) );
+  ASSERT_EQ( results.size(), 1u );
+  stats.Execute( Abs( Subtract( results[0], expected ) ) );
+  EXPECT_LT( stats.GetMaximum(), 0.5 );
+
+  ASSERT_THROW( stfx.ExecuteBatch( { movingImage }, { sitkLinear, sitkLinear } ), GenericException );
+}
+
+TEST( TransformixImageFilter, ComputeSpatialJacobian )
+{
+  Image fixedImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceBorder20.png" ) );
+  Image movingImage = ReadImage( dataFinder.GetFile( "Input/BrainProtonDensitySliceShifted13x17y.png" ) );
+
+  ElastixImageFilter silx;
+  silx.SetFixedImage( fixedImage );
+  silx.SetMovingImage( movingImage );
+  silx.SetParameterMap( "translation" );
+  silx.SetParameter( "MaximumNumberOfIterations", "8" );
+  silx.Execute();
+
+  TransformixImageFilter stfx;
+  stfx.SetTransformParameterMap( silx.GetTransformParameterMap() );
+  EXPECT_THROW( stfx.GetDeterminantOfSpatialJacobian(), GenericException );
+  stfx.ComputeSpatialJacobianOn();
+  stfx.ComputeDeterminantOfSpatialJacobianOn();
+  stfx.Execute();
+
+  // the spatial Jacobian of a translation is the identity
+  Image spatialJacobian = stfx.GetSpatialJacobian();
+  EXPECT_EQ( spatialJacobian.GetPixelID(), sitkVectorFloat64 );
+  EXPECT_EQ( spatialJacobian.GetNumberOfComponentsPerPixel(), 4u );
+  EXPECT_EQ( spatialJacobian.GetSize(), fixedImage.GetSize() );
+  EXPECT_VECTOR_DOUBLE_NEAR( spatialJacobian.GetPixelAsVectorFloat64( { 10, 20 } ), std::vector< double >( { 1.0, 0.0, 0.0, 1.0 } ), 1e-6 );
+
+  Image determinant = stfx.GetDeterminantOfSpatialJacobian();
+  EXPECT_EQ( determinant.GetPixelID(), sitkFloat64 );
+  StatisticsImageFilter stats;
+  stats.Execute( determinant );
+  EXPECT_NEAR( stats.GetMinimum(), 1.0, 1e-6 );
+  EXPECT_NEAR( stats.GetMaximum(), 1.0, 1e-6 );
+
+  // a float determinant of a region only
+  stfx.ComputeSpatialJacobianOff();
+  stfx.SetSpatialJacobianOutputPixelType( sitkFloat32 );
+  stfx.SetSpatialJacobianRegion( { 10, 20 }, { 30, 40 } );
+  stfx.Execute();
+  EXPECT_THROW( stfx.GetSpatialJacobian(), GenericException );
+  determinant = stfx.GetDeterminantOfSpatialJacobian();
+  EXPECT_EQ( determinant.GetPixelID(), sitkFloat32 );
+  EXPECT_EQ( determinant.GetSize(), std::vector< unsigned int >( { 30, 40 } ) );
+  EXPECT_VECTOR_DOUBLE_NEAR( determinant.GetOrigin(), fixedImage.TransformIndexToPhysicalPoint( { 10, 20 } ), 1e-6 );
+
+  EXPECT_THROW( stfx.SetSpatialJacobianOutputPixelType( sitkUInt8 ), GenericException );
+  stfx.SetSpatialJacobianRegion( { 10, 20 }, { 3000, 40 } );
+  EXPECT_THROW( stfx.Execute(), GenericException );
+}
+
 #if SITK_MAX_DIMENSIONS >= 4
 
 TEST( TransformixImageFilter, Transformation4D )
@@ -92,6 +92,29 @@ TEST_F(TypeListTest, typelist)
   static_assert(has_type<t1, int>::value, "OK");
   static_assert(has_type<t1, char>::value, "OK");
   static_assert(has_type<t1, float>::value == false, "OK");
+
+  using t2 = typelist2::typelist<float, char, int>;
+  static_assert(std::is_same<intersect<t1, t2>::type, t1>::value, "intersect order");
+  static_assert(std::is_same<intersect<t2, t1>::type, typelist2::typelist<char, int>>::value, "intersect order");
+  static_assert(length<intersect<t1, typelist2::typelist<float>>::type>::value == 0, "intersect empty");
+}
+
+
+TEST_F(TypeListTest, ProfilePixelIDTypeList)
+{
+  namespace sitk = itk::simple;
+  using namespace typelist2;
+
+  using RealList = sitk::ProfilePixelIDTypeList<sitk::RealPixelIDTypeList>;
+  static_assert(has_type<RealList, sitk::BasicPixelID<float>>::value, "float is in all profiles");
+
+  using ProfileList = sitk::ProfilePixelIDTypeList<sitk::InstantiatedPixelIDTypeList>;
+  static_assert(std::is_same<ProfileList, sitk::FilterProfilePixelIDTypeList>::value, "profile of all types");
+#ifdef SITK_PIXEL_TYPE_PROFILE_MINIMAL
+  static_assert(length<RealList>::value == 1, "minimal profile");
+#else
+  static_assert(std::is_same<RealList, sitk::RealPixelIDTypeList>::value, "full profile");
+#endif
 }
 
 
@@ -286,6 +286,100 @@
 
   #endregion
 
+  #region Bulk buffer copies
+
+  // Check the array matches the number and size of the components
+  // of the image's buffer.
+  private void CheckBulkCopy(int length, int elementSize) {
+    ulong componentSize = GetSizeOfPixelComponent();
+    bool isComplex = (GetPixelID() == PixelIDValueEnum.sitkComplexFloat32 ||
+                      GetPixelID() == PixelIDValueEnum.sitkComplexFloat64);
+    if (componentSize != (ulong)((isComplex ? 2 : 1) * elementSize)) {
+      throw new System.ArgumentException("The array elements do not match the pixel component type " + GetPixelIDTypeAsString() + ".");
+    }
+    ulong size = GetNumberOfPixels() * GetNumberOfComponentsPerPixel() * componentSize;
+    if ((ulong)length * (ulong)elementSize != size) {
+      throw new System.ArgumentException("The array has " + length + " elements, the image's buffer has " + size / (ulong)elementSize + ".");
+    }
+  }
+
+  ///<summary>Copy the image's buffer to the array with a single Marshal.Copy.
+  ///The array must have an element for each component of each pixel, or two for complex pixels, and the components
+  ///must have the size of the array elements. The buffer is not made unique, so a buffer shared with other images is
+  ///not copied first.</summary>
+  public void CopyBufferTo(byte[] array) {
+    CheckBulkCopy(array.Length, 1);
+    System.Runtime.InteropServices.Marshal.Copy(GetConstBufferAsVoid(), array, 0, array.Length);
+  }
+
+  ///<summary>Copy the array to the image's buffer with a single Marshal.Copy, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferFrom(byte[] array) {
+    CheckBulkCopy(array.Length, 1);
+    System.Runtime.InteropServices.Marshal.Copy(array, 0, GetBufferAsVoid(), array.Length);
+  }
+
+  ///<summary>Copy the image's buffer to the array, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferTo(short[] array) {
+    CheckBulkCopy(array.Length, 2);
+    System.Runtime.InteropServices.Marshal.Copy(GetConstBufferAsVoid(), array, 0, array.Length);
+  }
+
+  ///<summary>Copy the array to the image's buffer, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferFrom(short[] array) {
+    CheckBulkCopy(array.Length, 2);
+    System.Runtime.InteropServices.Marshal.Copy(array, 0, GetBufferAsVoid(), array.Length);
+  }
+
+  ///<summary>Copy the image's buffer to the array, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferTo(int[] array) {
+    CheckBulkCopy(array.Length, 4);
+    System.Runtime.InteropServices.Marshal.Copy(GetConstBufferAsVoid(), array, 0, array.Length);
+  }
+
+  ///<summary>Copy the array to the image's buffer, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferFrom(int[] array) {
+    CheckBulkCopy(array.Length, 4);
+    System.Runtime.InteropServices.Marshal.Copy(array, 0, GetBufferAsVoid(), array.Length);
+  }
+
+  ///<summary>Copy the image's buffer to the array, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferTo(long[] array) {
+    CheckBulkCopy(array.Length, 8);
+    System.Runtime.InteropServices.Marshal.Copy(GetConstBufferAsVoid(), array, 0, array.Length);
+  }
+
+  ///<summary>Copy the array to the image's buffer, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferFrom(long[] array) {
+    CheckBulkCopy(array.Length, 8);
+    System.Runtime.InteropServices.Marshal.Copy(array, 0, GetBufferAsVoid(), array.Length);
+  }
+
+  ///<summary>Copy the image's buffer to the array, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferTo(float[] array) {
+    CheckBulkCopy(array.Length, 4);
+    System.Runtime.InteropServices.Marshal.Copy(GetConstBufferAsVoid(), array, 0, array.Length);
+  }
+
+  ///<summary>Copy the array to the image's buffer, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferFrom(float[] array) {
+    CheckBulkCopy(array.Length, 4);
+    System.Runtime.InteropServices.Marshal.Copy(array, 0, GetBufferAsVoid(), array.Length);
+  }
+
+  ///<summary>Copy the image's buffer to the array, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferTo(double[] array) {
+    CheckBulkCopy(array.Length, 8);
+    System.Runtime.InteropServices.Marshal.Copy(GetConstBufferAsVoid(), array, 0, array.Length);
+  }
+
+  ///<summary>Copy the array to the image's buffer, see CopyBufferTo(byte[]).</summary>
+  public void CopyBufferFrom(double[] array) {
+    CheckBulkCopy(array.Length, 8);
+    System.Runtime.InteropServices.Marshal.Copy(array, 0, GetBufferAsVoid(), array.Length);
+  }
+
+  #endregion
+
 %}
 
 #endif // End of C# specific sections
@@ -54,6 +54,29 @@
   }
 }
 
+// The ownership transfer methods of ImportImageFilter take a C++
+// callable, which is not wrapped by the languages
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt8( int8_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt8( int8_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt8( uint8_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt8( uint8_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt16( int16_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt16( int16_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt16( uint16_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt16( uint16_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt32( int32_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt32( int32_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt32( uint32_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt32( uint32_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt64( int64_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsInt64( int64_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt64( uint64_t *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsUInt64( uint64_t *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsFloat( float *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsFloat( float *, std::function<void(void*)> );
+%ignore itk::simple::ImportImageFilter::SetBufferAsDouble( double *, std::function<void(void*)>, unsigned int );
+%ignore itk::simple::ImportImageFilter::SetBufferAsDouble( double *, std::function<void(void*)> );
+
 // Global Tweaks to sitk::Image
 %ignore itk::simple::Image::GetITKBase( void );
 %ignore itk::simple::Image::GetITKBase( void ) const;
@@ -84,6 +107,32 @@
 #endif
 
 
+// The region copy methods operate on raw pointers to caller managed memory
+%ignore itk::simple::Image::GetRegionAsInt8;
+%ignore itk::simple::Image::GetRegionAsUInt8;
+%ignore itk::simple::Image::GetRegionAsInt16;
+%ignore itk::simple::Image::GetRegionAsUInt16;
+%ignore itk::simple::Image::GetRegionAsInt32;
+%ignore itk::simple::Image::GetRegionAsUInt32;
+%ignore itk::simple::Image::GetRegionAsInt64;
+%ignore itk::simple::Image::GetRegionAsUInt64;
+%ignore itk::simple::Image::GetRegionAsFloat;
+%ignore itk::simple::Image::GetRegionAsDouble;
+%ignore itk::simple::Image::SetRegionFromInt8;
+%ignore itk::simple::Image::SetRegionFromUInt8;
+%ignore itk::simple::Image::SetRegionFromInt16;
+%ignore itk::simple::Image::SetRegionFromUInt16;
+%ignore itk::simple::Image::SetRegionFromInt32;
+%ignore itk::simple::Image::SetRegionFromUInt32;
+%ignore itk::simple::Image::SetRegionFromInt64;
+%ignore itk::simple::Image::SetRegionFromUInt64;
+%ignore itk::simple::Image::SetRegionFromFloat;
+%ignore itk::simple::Image::SetRegionFromDouble;
+
+// The batch transforms of caller managed memory
+%ignore itk::simple::Transform::TransformPoints( const double *, double *, size_t ) const;
+%ignore itk::simple::Transform::TransformVectors( const double *, const double *, double *, size_t ) const;
+
 #if !(defined(SWIGCSHARP) || defined(SWIGJAVA))
 %ignore itk::simple::Image::GetBufferAsVoid();
 %ignore itk::simple::Image::GetBufferAsVoid() const;
@@ -114,7 +163,10 @@ namespace std
   %template(VectorDouble) vector<double>;
   %template(VectorOfImage) vector< itk::simple::Image >;
   %template(VectorOfTransform) vector< itk::simple::Transform >;
+  %template(VectorOfImageRegistrationLevelProfile) vector< itk::simple::ImageRegistrationLevelProfile >;
   %template(VectorUIntList) vector< vector<unsigned int> >;
+  %template(VectorIntList) vector< vector<int> >;
+  %template(VectorOfVectorDouble) vector< vector<double> >;
   %template(VectorString) vector< std::string >;
 
   %template(DoubleDoubleMap) map<double, double>;
@@ -179,6 +231,7 @@ namespace std
 %include "sitkKernel.h"
 %include "sitkEvent.h"
 %include "sitkRandomSeed.h"
+%include "sitkMemoryStatistics.h"
 
 // Transforms
 %include "sitkTransform.h"
@@ -200,6 +253,8 @@ namespace std
 
 
 // Basic Filter Base
+%include "sitkExecutor.h"
+%include "sitkCancellationToken.h"
 %include "sitkProcessObject.h"
 %include "sitkImageFilter.h"
 
@@ -209,19 +264,35 @@ namespace std
 %include "sitkImageSeriesWriter.h"
 %include "sitkImageReaderBase.h"
 %include "sitkImageSeriesReader.h"
+%include "sitkDICOMSeriesIndex.h"
+%include "sitkDICOMSeriesConverter.h"
 %include "sitkImageFileReader.h"
+%include "sitkImageFilePrefetchReader.h"
+%include "sitkStreamingResample.h"
 %include "sitkImageViewer.h"
 
  // Basic Filters
 %include "sitkHashImageFilter.h"
+%include "sitkFusedStatisticsImageFilter.h"
+%include "sitkLabelEvaluationImageFilter.h"
+%include "sitkMultiChannelLabelStatisticsImageFilter.h"
+%include "sitkMultiProjectionImageFilter.h"
+%include "sitkMultiResolutionPyramidImageFilter.h"
+%include "sitkPlanarToVectorImageFilter.h"
+%include "sitkVectorToPlanarImageFilter.h"
 %include "sitkBSplineTransformInitializerFilter.h"
 %include "sitkCenteredTransformInitializerFilter.h"
 %include "sitkCenteredVersorTransformInitializerFilter.h"
 %include "sitkLandmarkBasedTransformInitializerFilter.h"
+%include "sitkMultiResolutionDemonsRegistrationFilter.h"
 %include "sitkCastImageFilter.h"
 %include "sitkExtractImageFilter.h"
 %include "sitkPasteImageFilter.h"
+%include "sitkPointwiseExpressionImageFilter.h"
+%include "sitkFFTConfiguration.h"
 %include "sitkAdditionalProcedures.h"
+%include "sitkResampler.h"
+%include "sitkResamplingOperator.h"
 
 #ifdef SITK_USE_ELASTIX
 %{
@@ -232,12 +303,17 @@ namespace std
 // Elastix and Transformix
 %template( ParameterMap ) std::map< std::string, std::vector< std::string > >;
 %template( VectorOfParameterMap ) std::vector< std::map< std::string, std::vector< std::string > > >;
+%template( VectorOfParameterMapVector ) std::vector< std::vector< std::map< std::string, std::vector< std::string > > > >;
 %include "sitkElastixImageFilter.h"
 %include "sitkTransformixImageFilter.h"
 #endif
 
 // Registration
+%include "sitkImageRegistrationMetricEvaluator.h"
+%include "sitkImageRegistrationLevelProfile.h"
+%include "sitkImageRegistrationState.h"
 %include "sitkImageRegistrationMethod.h"
+%include "sitkIterationRecorderCommand.h"
 
 
 // Auto-generated headers
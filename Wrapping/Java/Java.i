@@ -56,11 +56,26 @@
 %ignore itk::simple::Image::GetBufferAsFloat();
 %ignore itk::simple::Image::GetBufferAsDouble();
 
-%ignore itk::simple::Image::GetBufferAsVoid( ) const;
+//
+// const void * typemap for returning a ByteBuffer, which is made
+// read-only in Java, from the const Image::GetBufferAsVoid
+//
+%typemap(jni) const void * itk::simple::Image::GetBufferAsVoid() const "jobject"
+%typemap(jtype) const void * itk::simple::Image::GetBufferAsVoid() const "java.nio.ByteBuffer"
+%typemap(jstype) const void * itk::simple::Image::GetBufferAsVoid() const "java.nio.ByteBuffer"
+%typemap(javaout) const void * itk::simple::Image::GetBufferAsVoid() const {
+  return $jnicall;
+}
+%typemap(out) const void * itk::simple::Image::GetBufferAsVoid() const {
+  const size_t size = arg1->GetNumberOfPixels()*arg1->GetNumberOfComponentsPerPixel()*arg1->GetSizeOfPixelComponent();
+  $result = JCALL2(NewDirectByteBuffer, jenv, const_cast<void *>($1), size);
+}
 
+%javamethodmodifiers itk::simple::Image::GetBufferAsVoid( ) const "private";
 
 
 %rename( getBufferAsByteBuffer ) itk::simple::Image::GetBufferAsVoid;
+%rename( getConstBufferAsDirectByteBuffer ) itk::simple::Image::GetBufferAsVoid( ) const;
 
 
 %extend itk::simple::Image {
@@ -75,7 +90,7 @@
    */
   public java.nio.Buffer getBufferAsBuffer()
     {
-      java.nio.ByteBuffer b = getBufferAsByteBuffer();
+      java.nio.ByteBuffer b = getBufferAsByteBuffer().order(java.nio.ByteOrder.nativeOrder());
       if (getPixelID() == PixelIDValueEnum.sitkInt16 ||
           getPixelID() == PixelIDValueEnum.sitkVectorInt16)
         {
@@ -106,6 +121,110 @@
        // sitkInt8 and sitkVectorInt8 are returned as ByteBuffer too.
        return b;
     }
+
+  /** Return a read-only ByteBuffer, in the native byte order, of the
+   * Image's buffer.
+   *
+   * Unlike getBufferAsByteBuffer the image is not made unique, so a
+   * buffer shared with other images is not copied. The returned
+   * object refers to the image's memory, and must not be used after
+   * the image is modified or released.
+   */
+  public java.nio.ByteBuffer getConstBufferAsByteBuffer()
+    {
+      return getConstBufferAsDirectByteBuffer().asReadOnlyBuffer().order(java.nio.ByteOrder.nativeOrder());
+    }
+
+  // Check the array matches the number and size of the components
+  // of the image's buffer.
+  private void checkBulkCopy(int length, int elementSize)
+    {
+      final long componentSize = getSizeOfPixelComponent();
+      final boolean isComplex = (getPixelID() == PixelIDValueEnum.sitkComplexFloat32 ||
+                                 getPixelID() == PixelIDValueEnum.sitkComplexFloat64);
+      if (componentSize != (isComplex ? 2 : 1) * elementSize)
+        {
+          throw new IllegalArgumentException("The array elements do not match the pixel component type "
+                                             + getPixelIDTypeAsString() + ".");
+        }
+      final long capacity = getConstBufferAsDirectByteBuffer().capacity();
+      if ((long) length * elementSize != capacity)
+        {
+          throw new IllegalArgumentException("The array has " + length + " elements, the image's buffer has "
+                                             + capacity / elementSize + ".");
+        }
+    }
+
+  /** Copy the image's buffer to an array, or from an array to the
+   * image's buffer.
+   *
+   * The whole buffer is copied in a single bulk operation, without
+   * per-element calls through JNI. The array must have an element for
+   * each component of each pixel, or two for complex pixels, in the
+   * order of the buffer, and the components must have the size of
+   * the array elements. Unsigned component types are copied to the
+   * signed array of the same size.
+   */
+  public void copyBufferTo(byte[] array)
+    {
+      checkBulkCopy(array.length, 1);
+      getConstBufferAsByteBuffer().get(array);
+    }
+  public void copyBufferTo(short[] array)
+    {
+      checkBulkCopy(array.length, 2);
+      getConstBufferAsByteBuffer().asShortBuffer().get(array);
+    }
+  public void copyBufferTo(int[] array)
+    {
+      checkBulkCopy(array.length, 4);
+      getConstBufferAsByteBuffer().asIntBuffer().get(array);
+    }
+  public void copyBufferTo(long[] array)
+    {
+      checkBulkCopy(array.length, 8);
+      getConstBufferAsByteBuffer().asLongBuffer().get(array);
+    }
+  public void copyBufferTo(float[] array)
+    {
+      checkBulkCopy(array.length, 4);
+      getConstBufferAsByteBuffer().asFloatBuffer().get(array);
+    }
+  public void copyBufferTo(double[] array)
+    {
+      checkBulkCopy(array.length, 8);
+      getConstBufferAsByteBuffer().asDoubleBuffer().get(array);
+    }
+  public void copyBufferFrom(byte[] array)
+    {
+      checkBulkCopy(array.length, 1);
+      getBufferAsByteBuffer().put(array);
+    }
+  public void copyBufferFrom(short[] array)
+    {
+      checkBulkCopy(array.length, 2);
+      getBufferAsByteBuffer().order(java.nio.ByteOrder.nativeOrder()).asShortBuffer().put(array);
+    }
+  public void copyBufferFrom(int[] array)
+    {
+      checkBulkCopy(array.length, 4);
+      getBufferAsByteBuffer().order(java.nio.ByteOrder.nativeOrder()).asIntBuffer().put(array);
+    }
+  public void copyBufferFrom(long[] array)
+    {
+      checkBulkCopy(array.length, 8);
+      getBufferAsByteBuffer().order(java.nio.ByteOrder.nativeOrder()).asLongBuffer().put(array);
+    }
+  public void copyBufferFrom(float[] array)
+    {
+      checkBulkCopy(array.length, 4);
+      getBufferAsByteBuffer().order(java.nio.ByteOrder.nativeOrder()).asFloatBuffer().put(array);
+    }
+  public void copyBufferFrom(double[] array)
+    {
+      checkBulkCopy(array.length, 8);
+      getBufferAsByteBuffer().order(java.nio.ByteOrder.nativeOrder()).asDoubleBuffer().put(array);
+    }
 %}
 
 
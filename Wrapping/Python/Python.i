@@ -53,15 +53,54 @@
 // Numpy array conversion support
 %native(_GetMemoryViewFromImage) PyObject *sitk_GetMemoryViewFromImage( PyObject *self, PyObject *args );
 %native(_SetImageFromArray) PyObject *sitk_SetImageFromArray( PyObject *self, PyObject *args );
+%native(_GetImageViewFromArray) PyObject *sitk_GetImageViewFromArray( PyObject *self, PyObject *args );
 
 // Enable Python classes derived from Command Execute method to be
 // called from C++
 %feature("director") itk::simple::Command;
 
 %extend itk::simple::ProcessObject {
+ int AddCommand( itk::simple::EventEnum e, PyObject *obj, double minimumInterval = 0.0, float minimumProgressDelta = 0.0f )
+ {
+   // the GIL is released around the wrapped calls
+   int callable;
+   {
+   SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+   callable = PyCallable_Check(obj);
+   SWIG_PYTHON_THREAD_END_BLOCK;
+   }
+   if (!callable)
+     {
+     return 0;
+     }
+   itk::simple::PyCommand *cmd = NULL;
+   try
+     {
+       cmd = new itk::simple::PyCommand();
+       cmd->SetCallbackPyCallable(obj);
+       int ret = self->AddCommand(e,*cmd,minimumInterval,minimumProgressDelta);
+       cmd->OwnedByObjectsOn();
+       return ret;
+     }
+   catch(...)
+     {
+       delete cmd;
+       throw;
+     }
+ }
+};
+
+#ifdef SITK_USE_ELASTIX
+%extend itk::simple::ElastixImageFilter {
  int AddCommand( itk::simple::EventEnum e, PyObject *obj )
  {
-   if (!PyCallable_Check(obj))
+   int callable;
+   {
+   SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+   callable = PyCallable_Check(obj);
+   SWIG_PYTHON_THREAD_END_BLOCK;
+   }
+   if (!callable)
      {
      return 0;
      }
@@ -81,9 +120,99 @@
      }
  }
 };
+#endif
 
 %feature("director") itk::simple::LoggerBase;
 
+%extend itk::simple::ImageFilter {
+%pythoncode %{
+    def ExecuteAsync(self, *args):
+        """Execute the filter in the default executor of the running
+        asyncio event loop, and return an awaitable future of the
+        result.
+
+        The GIL is released while the filter executes. The filter must
+        not be modified until the future is done.
+        """
+        import asyncio
+        return asyncio.get_running_loop().run_in_executor(None, lambda: self.Execute(*args))
+%}
+};
+
+
+
+%extend itk::simple::ImageFilePrefetchReader {
+%pythoncode %{
+    def __iter__(self):
+        """Iterate over the images in the order of the file names.
+
+        The GIL is released while an image is waited for, so other
+        Python threads run while the files are read.
+        """
+        while self.HasNext():
+            yield self.Next()
+%}
+};
+
+
+// The in-memory buffers are Python bytes-like objects
+%ignore itk::simple::ImageFileReader::SetBuffer( const void *, size_t, const std::string & );
+%ignore itk::simple::ImageFileWriter::ExecuteToBuffer( const Image &, const std::string & );
+
+%extend itk::simple::ImageFileReader {
+ void SetBuffer( PyObject *data, const std::string &imageIO = "" )
+ {
+   Py_buffer view;
+   int ret;
+   {
+   SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+   ret = PyObject_GetBuffer( data, &view, PyBUF_CONTIG_RO );
+   if ( ret != 0 )
+     {
+     PyErr_Clear();
+     }
+   SWIG_PYTHON_THREAD_END_BLOCK;
+   }
+   if ( ret != 0 )
+     {
+     throw std::invalid_argument( "The buffer must be a contiguous bytes-like object." );
+     }
+
+   // release the view with the GIL held, also when SetBuffer throws
+   struct ReleaseView
+   {
+     Py_buffer *view;
+     ~ReleaseView()
+       {
+         SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+         PyBuffer_Release( view );
+         SWIG_PYTHON_THREAD_END_BLOCK;
+       }
+   } releaseView{ &view };
+   self->SetBuffer( view.buf, static_cast<size_t>( view.len ), imageIO );
+ }
+};
+
+%extend itk::simple::ImageFileWriter {
+ PyObject *_ExecuteToBytes( const Image &image, const std::string &imageIO )
+ {
+   const std::vector<uint8_t> content = self->ExecuteToBuffer( image, imageIO );
+   PyObject *bytes;
+   {
+   SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+   bytes = PyBytes_FromStringAndSize( reinterpret_cast<const char *>( content.data() ), static_cast<Py_ssize_t>( content.size() ) );
+   SWIG_PYTHON_THREAD_END_BLOCK;
+   }
+   return bytes;
+ }
+%pythoncode %{
+    def ExecuteToBuffer(self, image, imageIO):
+        """Encode the image with the ImageIO, e.g. "PNGImageIO", and
+        return the content of the file as bytes.
+        """
+        return self._ExecuteToBytes(image, imageIO)
+%}
+};
 
 
 %pythonappend itk::simple::ImageRegistrationMethod::Execute(const Image &, const Image &)
@@ -101,4 +230,34 @@
   val = val.Downcast()
 };
 
+// the recorder refers to the registration method, which is kept alive
+%pythonappend itk::simple::IterationRecorderCommand::IterationRecorderCommand
+{
+  self._method = args[0]
+};
+
+%extend itk::simple::IterationRecorderCommand {
+%pythoncode %{
+    def GetArrays(self):
+        """Return the records as a dictionary of numpy arrays.
+
+        The keys are "level", "iteration", "metric_value",
+        "learning_rate", "convergence_value" and "position". The
+        positions are a 2D array with a row for each record, when the
+        number of parameters is the same for all the records.
+        """
+        import numpy
+        arrays = { "level": numpy.array(self.GetLevels(), dtype=numpy.uint32),
+                   "iteration": numpy.array(self.GetIterations(), dtype=numpy.uint32),
+                   "metric_value": numpy.array(self.GetMetricValues()),
+                   "learning_rate": numpy.array(self.GetLearningRates()),
+                   "convergence_value": numpy.array(self.GetConvergenceValues()),
+                   "position": numpy.array(self.GetPositions()) }
+        n = self.GetNumberOfRecords()
+        if n and arrays["position"].size == n * self.GetNumberOfParameters():
+            arrays["position"] = arrays["position"].reshape(n, self.GetNumberOfParameters())
+        return arrays
+%}
+};
+
 #endif
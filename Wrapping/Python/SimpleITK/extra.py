@@ -20,8 +20,10 @@ from pathlib import Path
 from SimpleITK.SimpleITK import *
 from SimpleITK.SimpleITK import _GetMemoryViewFromImage
 from SimpleITK.SimpleITK import _SetImageFromArray
+from SimpleITK.SimpleITK import _GetImageViewFromArray
+from SimpleITK.remote import IsRemoteFileName, ReadRemoteImage
 
-from typing import Iterable, List, Optional, Type, Union, Tuple
+from typing import Iterable, Iterator, List, NamedTuple, Optional, Type, Union, Tuple
 
 
 PathType = Union[str, Path, Iterable[str], Iterable[Path]]
@@ -290,6 +292,75 @@ def GetArrayFromImage(image: Image) -> "numpy.ndarray":
     return numpy.array(array_view, copy=True)
 
 
+class _ImageArrayInterface:
+    """Exposes an image buffer through the numpy array interface, holding a shallow copy of the image so the buffer
+    outlives the original image object."""
+
+    def __init__(self, image: Image, array_view: "numpy.ndarray"):
+        self._image = Image(image)
+        interface = dict(array_view.__array_interface__)
+        interface["data"] = (interface["data"][0], False)
+        self.__array_interface__ = interface
+
+
+def _GetWritableArrayViewFromImage(image: Image) -> "numpy.ndarray":
+    """Get a writable NumPy ndarray view of the SimpleITK Image's buffer, which keeps the buffer alive.
+
+    Writes to the array modify the image. Because the array holds a reference to the buffer, modifying the image
+    through SimpleITK while the array is alive copies the buffer first.
+    """
+
+    array_view = GetArrayViewFromImage(image)
+    return numpy.asarray(_ImageArrayInterface(image, array_view))
+
+
+def GetPlanarArrayFromImage(image: Image) -> "numpy.ndarray":
+    """Get a NumPy ndarray in channel first order from a SimpleITK vector Image.
+
+    The components are copied once to the planes of a scalar image with VectorToPlanar, and the returned array is a
+    view of that image's buffer with the shape (C,Y,X) for a 2D image or (C,Z,Y,X) for a 3D image, without a numpy
+    transpose copy. The array holds a reference to the planar image's buffer.
+    """
+
+    return _GetWritableArrayViewFromImage(VectorToPlanar(image))
+
+
+def GetImageFromPlanarArray(arr: "numpy.ndarray") -> Image:
+    """Get a SimpleITK vector Image from a NumPy array in channel first order.
+
+    The first axis of the array is the component index, such as an array from GetPlanarArrayFromImage, and the
+    components are copied once from the planes with PlanarToVector.
+    """
+
+    return PlanarToVector(GetImageFromArray(arr, isVector=False))
+
+
+def GetImageFromDLPack(tensor, isVector: Optional[bool] = None, copy: Optional[bool] = True) -> Image:
+    """Get a SimpleITK Image from an object supporting the DLPack protocol, such as a PyTorch tensor.
+
+    The tensor must be in host memory, see GetImageFromArray for the meaning of isVector and the axis order. By default
+    the pixels are copied into the new image. When copy is False the image refers to the tensor's memory as
+    GetImageViewFromArray, and a ValueError is raised when that is not possible. When copy is None the memory is
+    referred to when possible, otherwise it is copied.
+    """
+
+    if not HAVE_NUMPY:
+        raise ImportError('Numpy not available.')
+
+    if not hasattr(numpy, "from_dlpack"):
+        raise ImportError('NumPy 1.22 or later is required for DLPack.')
+
+    arr = numpy.from_dlpack(tensor)
+    if copy is None:
+        try:
+            return GetImageViewFromArray(arr, isVector=isVector)
+        except ValueError:
+            return GetImageFromArray(arr, isVector=isVector)
+    if not copy:
+        return GetImageViewFromArray(arr, isVector=isVector)
+    return GetImageFromArray(arr, isVector=isVector)
+
+
 def GetImageFromArray(arr: "numpy.ndarray", isVector: Optional[bool] = None) -> Image:
     """ Get a SimpleITK Image from a numpy array.
 
@@ -328,6 +399,306 @@ def GetImageFromArray(arr: "numpy.ndarray", isVector: Optional[bool] = None) ->
     return img
 
 
+def GetImageViewFromArray(arr: "numpy.ndarray", isVector: Optional[bool] = None) -> Image:
+    """Get a SimpleITK Image which refers to the buffer of a C contiguous numpy array, without a copy.
+
+    The image holds a reference to the array's buffer until it and its copies are released. The array's memory is
+     copied before it would be modified through SimpleITK, so the array is only read, but changes to the array are
+     seen by the image. See GetImageFromArray for the meaning of isVector and the axis order. A ValueError is raised
+     when the array is not C contiguous, or its pixel type or dimension can not be imported, then GetImageFromArray
+     copies it.
+    """
+
+    if not HAVE_NUMPY:
+        raise ImportError('Numpy not available.')
+
+    z = numpy.asarray(arr)
+
+    if not z.flags.c_contiguous:
+        raise ValueError("The array is not C contiguous.")
+
+    if isVector is None:
+        if z.ndim == 4 and z.dtype != numpy.complex64 and z.dtype != numpy.complex128:
+            isVector = True
+
+    if isVector:
+        id = _get_sitk_vector_pixelid(z)
+        if z.ndim < 3 or z.shape[-1] < 2:
+            raise ValueError("A vector image view requires more than one component along the last axis.")
+        number_of_components = z.shape[-1]
+        shape = z.shape[-2::-1]
+    else:
+        number_of_components = 1
+        id = _get_sitk_pixelid(z)
+        shape = z.shape[::-1]
+
+    if len(shape) not in (2, 3):
+        raise ValueError(f"A image view of dimension {len(shape)} is not supported.")
+
+    return _GetImageViewFromArray(z, id, shape, number_of_components)
+
+
+class _SharedMemoryArrayInterface:
+    """Exposes a shared memory block through the numpy array interface, holding the block so it is not closed while
+    the arrays, or the images referring to them, are alive."""
+
+    def __init__(self, shm, shape, dtype):
+        self._shm = shm
+        self.__array_interface__ = numpy.ndarray(shape, dtype=dtype, buffer=shm.buf).__array_interface__
+
+
+class SharedImage:
+    """A SimpleITK Image whose buffer is in a multiprocessing.shared_memory block.
+
+    The pixels are copied once into the block. A SharedImage is pickled by the name of the block and the image
+    information, without the pixels, so it can be passed to ProcessPoolExecutor workers, and GetImage returns an image
+    which refers to the block without a copy in any process. The images are copied before they are modified, so the
+    block is only written by its creator.
+
+    The creator owns the block: it must outlive the images and SharedImage objects of the other processes, and is
+    released with unlink, or when the SharedImage is used as a context manager.
+    """
+
+    def __init__(self, image: Image, name: Optional[str] = None):
+        if not HAVE_NUMPY:
+            raise ImportError('Numpy not available.')
+
+        from multiprocessing import shared_memory
+
+        array_view = GetArrayViewFromImage(image)
+        self._shm = shared_memory.SharedMemory(name=name, create=True, size=max(array_view.nbytes, 1))
+        self._owner = True
+        numpy.ndarray(array_view.shape, dtype=array_view.dtype, buffer=self._shm.buf)[...] = array_view
+
+        self._state = (self._shm.name,
+                       array_view.shape,
+                       array_view.dtype.str,
+                       image.GetPixelIDValue(),
+                       image.GetNumberOfComponentsPerPixel(),
+                       image.GetOrigin(),
+                       image.GetSpacing(),
+                       image.GetDirection(),
+                       {k: image.GetMetaData(k) for k in image.GetMetaDataKeys()})
+
+    @classmethod
+    def _Attach(cls, state) -> "SharedImage":
+        from multiprocessing import shared_memory
+
+        self = cls.__new__(cls)
+        try:
+            # Python 3.13, the block is not unlinked when the worker exits
+            self._shm = shared_memory.SharedMemory(name=state[0], track=False)
+        except TypeError:
+            self._shm = shared_memory.SharedMemory(name=state[0])
+        self._owner = False
+        self._state = state
+        return self
+
+    def __reduce__(self):
+        return SharedImage._Attach, (self._state,)
+
+    @property
+    def name(self) -> str:
+        """The name of the shared memory block."""
+        return self._state[0]
+
+    def GetImage(self) -> Image:
+        """Get an image referring to the shared memory block.
+
+        The images which can not refer to the block, such as the complex images, are copies of it.
+        """
+        name, shape, dtype, pixel_id, number_of_components, origin, spacing, direction, metadata = self._state
+
+        arr = numpy.asarray(_SharedMemoryArrayInterface(self._shm, shape, numpy.dtype(dtype)))
+        is_vector = number_of_components > 1
+
+        try:
+            img = GetImageViewFromArray(arr, isVector=is_vector)
+        except ValueError:
+            img = None
+        if img is None or img.GetPixelIDValue() != pixel_id:
+            img = Image(shape[-2::-1] if is_vector else shape[::-1], pixel_id, number_of_components)
+            _SetImageFromArray(arr, img)
+
+        img.SetOrigin(origin)
+        img.SetSpacing(spacing)
+        img.SetDirection(direction)
+        for k, v in metadata.items():
+            img.SetMetaData(k, v)
+        return img
+
+    def unlink(self) -> None:
+        """Release the shared memory block, by its creator, after the other processes are done with it."""
+        if self._owner:
+            self._shm.unlink()
+            self._owner = False
+
+    def __enter__(self) -> "SharedImage":
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.unlink()
+
+
+class ImageChunk(NamedTuple):
+    """A chunk of an image yielded by IterateImageChunks.
+
+    The index and size of the chunk's region are in the image's axis order, (x, y, z), and the array is in the numpy
+    axis order, (z, y, x), as GetArrayViewFromImage.
+    """
+
+    index: Tuple[int, ...]
+    size: Tuple[int, ...]
+    array: "numpy.ndarray"
+
+
+def _chunk_regions(image_size: Tuple[int, ...], chunkSize: List[int]) -> Iterator[Tuple[Tuple[int, ...], Tuple[int, ...]]]:
+    """The regions of the chunks in buffer order, dividing the axes as ImageFileReader.ReadTile."""
+
+    if len(chunkSize) > len(image_size):
+        raise ValueError(f"The chunk size has {len(chunkSize)} elements but the image dimension is {len(image_size)}.")
+    if 0 in image_size:
+        return
+
+    chunk_size = [c if c != 0 else s for s, c in zip(image_size, list(chunkSize) + [0] * len(image_size))]
+    counts = [(s + c - 1) // c for s, c in zip(image_size, chunk_size)]
+
+    position = [0] * len(image_size)
+    while True:
+        index = tuple(p * c for p, c in zip(position, chunk_size))
+        size = tuple(min(c, s - i) for i, c, s in zip(index, chunk_size, image_size))
+        yield index, size
+
+        # the first axis varies fastest
+        for d in range(len(position)):
+            position[d] += 1
+            if position[d] < counts[d]:
+                break
+            position[d] = 0
+        else:
+            return
+
+
+def IterateImageChunks(
+    image: Union[Image, PathType],
+    chunkSize: List[int],
+    writable: bool = False,
+    outputPixelType: int = sitkUnknown,
+    imageIO: str = "",
+) -> Iterator[ImageChunk]:
+    """Iterate over the chunks of an image, in buffer order, as NumPy ndarray views.
+
+    The image is divided into chunks of chunkSize, the first axis varying fastest, and the last chunks along an axis
+    are truncated at the image boundary. A missing or zero chunk size along an axis uses the whole extent of that
+    axis, so [0, 0, 1] iterates over the slices of a volume.
+
+    When image is an Image, each array is a view of the image's buffer without a copy. With writable, writes to the
+    arrays modify the image, otherwise the arrays are read-only.
+
+    When image is a file name, the file is opened once by an ImageFileReader and each chunk is read with ReadRegion.
+    When the ImageIO supports streaming, such as for MetaImage files, only the chunk is read from the file, so volumes
+    larger than memory can be processed. The arrays refer to the buffer of the chunk read, and writes to them do not
+    modify the file. The outputPixelType and imageIO are used as in ReadImage.
+
+    Yields
+    ------
+     An ImageChunk of the index and size of the chunk in the image, and its array.
+    """
+
+    if not HAVE_NUMPY:
+        raise ImportError('NumPy not available.')
+
+    if isinstance(image, Image):
+        if writable:
+            array_view = _GetWritableArrayViewFromImage(image)
+        else:
+            array_view = GetArrayViewFromImage(image)
+        for index, size in _chunk_regions(image.GetSize(), chunkSize):
+            region = tuple(slice(i, i + s) for i, s in zip(index, size))[::-1]
+            yield ImageChunk(index, size, array_view[region])
+        return
+
+    reader = ImageFileReader()
+    reader.SetFileName(str(image))
+    reader.SetImageIO(imageIO)
+    reader.SetOutputPixelType(outputPixelType)
+    reader.Open()
+    try:
+        for index, size in _chunk_regions(reader.GetSize(), chunkSize):
+            chunk = reader.ReadRegion(index, size)
+            yield ImageChunk(index, size, _GetWritableArrayViewFromImage(chunk))
+    finally:
+        reader.Close()
+
+
+class Pipeline:
+    """A sequence of filters executed as one, without holding the intermediate images.
+
+    Each step is a configured filter object, such as MedianImageFilter, or a procedural function, such as Median,
+    with the arguments after its first input image. The output of a step is the first input of the next step, and the
+    reference to an intermediate image is dropped as soon as the next step has executed, so at most the input and
+    output of a step are in memory at once.
+
+    An argument of a step which is itself a Pipeline is executed on the input of this pipeline, and its output is
+    the argument, so the steps form a graph with several inputs such as a difference of smoothings:
+
+    .. code-block:: python
+
+      pipeline = sitk.Pipeline()
+      pipeline.Add(sitk.Cast, sitk.sitkFloat32)
+      pipeline.Add(sitk.Subtract, sitk.Pipeline().Add(sitk.Cast, sitk.sitkFloat32).Add(sitk.Median, [2] * 3))
+      output = pipeline.Execute("image.nrrd")
+
+    A filter object is not copied, so changes to it after it is added are used by the next execution of the pipeline.
+    Each filter releases the GIL while it executes.
+    """
+
+    def __init__(self, steps: Iterable = ()):
+        self._steps = []
+        for step in steps:
+            if isinstance(step, tuple):
+                self.Add(*step)
+            else:
+                self.Add(step)
+
+    def Add(self, step, *args, **kwargs) -> "Pipeline":
+        """Add a filter object or a procedural function, with its arguments after the input image, as the last step.
+
+        The pipeline is returned, so the calls may be chained.
+        """
+
+        if not callable(getattr(step, "Execute", None)) and not callable(step):
+            raise TypeError(f"The step {step!r} is neither a filter with an Execute method nor a callable.")
+        self._steps.append((step, args, kwargs))
+        return self
+
+    def __len__(self) -> int:
+        return len(self._steps)
+
+    def Execute(self, image: Union[Image, PathType], outputPixelType: int = sitkUnknown, imageIO: str = "") -> Image:
+        """Execute the steps on an image, or on an image read from a file with outputPixelType and imageIO as in
+        ReadImage, and return the output of the last step."""
+
+        if not isinstance(image, Image):
+            image = ReadImage(image, outputPixelType, imageIO)
+
+        # the input is only held for the steps which branch from it
+        source = image if self._HasBranches() else None
+
+        for step, args, kwargs in self._steps:
+            args = [a.Execute(source) if isinstance(a, Pipeline) else a for a in args]
+            kwargs = {k: (v.Execute(source) if isinstance(v, Pipeline) else v) for k, v in kwargs.items()}
+            execute = step.Execute if callable(getattr(step, "Execute", None)) else step
+            image = execute(image, *args, **kwargs)
+            del args, kwargs
+        return image
+
+    __call__ = Execute
+
+    def _HasBranches(self) -> bool:
+        return any(isinstance(a, Pipeline) for _, args, kwargs in self._steps for a in (*args, *kwargs.values()))
+
+
 def ReadImage(
     fileName: PathType,
     outputPixelType: int = sitkUnknown,
@@ -341,7 +712,8 @@ def ReadImage(
     Parameters
     ----------
     fileName
-     A single or a list of file names. the filename of an Image e.g. "cthead.mha"
+     A single or a list of file names. the filename of an Image e.g. "cthead.mha". A single file may be an
+     "http://", "https://", "s3://" or "gs://" URI which is read with SimpleITK.remote.ReadRemoteImage.
     outputPixelType
      The pixel type of the returned Image. By default the value is sitkUnknown, which enable the output pixel type to
      be same as the file. If the pixel type is specified then the itk::ConvertPixelBuffer will be used to convert the
@@ -363,6 +735,9 @@ def ReadImage(
 
     """
 
+    if IsRemoteFileName(fileName):
+        return ReadRemoteImage(fileName, outputPixelType, imageIO)
+
     if isinstance(fileName, (str, Path)):
         reader = ImageFileReader()
         reader.SetFileName(str(fileName))
@@ -479,6 +854,14 @@ __all__ = ["MinimumMaximum",
            "GetArrayViewFromImage",
            "GetArrayFromImage",
            "GetImageFromArray",
+           "GetImageViewFromArray",
+           "SharedImage",
+           "ImageChunk",
+           "IterateImageChunks",
+           "Pipeline",
+           "GetImageFromDLPack",
+           "GetPlanarArrayFromImage",
+           "GetImageFromPlanarArray",
            "ReadImage",
            "WriteImage",
            "SmoothingRecursiveGaussian",
@@ -66,6 +66,139 @@
 %rename( __EvaluateAtContinuousIndex__ ) itk::simple::Image::EvaluateAtContinuousIndex;
 %rename( __EvaluateAtPhysicalPoint__ ) itk::simple::Image::EvaluateAtPhysicalPoint;
 
+%{
+#include <cstring>
+
+namespace
+{
+
+// The bytes of a pixel of the image's type with each component set
+// to the constant, and the imaginary part of complex pixels zero.
+template <typename TComponent>
+void ConstantToPixelBytes( double constant, unsigned int numberOfComponents, bool isComplex, std::vector<char> &pixel )
+{
+  const TComponent value = static_cast<TComponent>( constant );
+  const TComponent zero = TComponent();
+  const unsigned int numberOfElements = isComplex ? 2 : numberOfComponents;
+  pixel.resize( numberOfElements * sizeof( TComponent ) );
+  for ( unsigned int i = 0; i < numberOfElements; ++i )
+    {
+    std::memcpy( &pixel[i * sizeof( TComponent )], ( isComplex && i == 1 ) ? &zero : &value, sizeof( TComponent ) );
+    }
+}
+
+std::vector<char> ConstantToPixelBytes( const itk::simple::Image &image, double constant )
+{
+  using namespace itk::simple;
+  const PixelIDValueEnum id = image.GetPixelID();
+  const unsigned int n = image.GetNumberOfComponentsPerPixel();
+  std::vector<char> pixel;
+
+  if ( id == sitkUInt8 || id == sitkVectorUInt8 ) ConstantToPixelBytes<uint8_t>( constant, n, false, pixel );
+  else if ( id == sitkInt8 || id == sitkVectorInt8 ) ConstantToPixelBytes<int8_t>( constant, n, false, pixel );
+  else if ( id == sitkUInt16 || id == sitkVectorUInt16 ) ConstantToPixelBytes<uint16_t>( constant, n, false, pixel );
+  else if ( id == sitkInt16 || id == sitkVectorInt16 ) ConstantToPixelBytes<int16_t>( constant, n, false, pixel );
+  else if ( id == sitkUInt32 || id == sitkVectorUInt32 ) ConstantToPixelBytes<uint32_t>( constant, n, false, pixel );
+  else if ( id == sitkInt32 || id == sitkVectorInt32 ) ConstantToPixelBytes<int32_t>( constant, n, false, pixel );
+  else if ( id == sitkUInt64 || id == sitkVectorUInt64 ) ConstantToPixelBytes<uint64_t>( constant, n, false, pixel );
+  else if ( id == sitkInt64 || id == sitkVectorInt64 ) ConstantToPixelBytes<int64_t>( constant, n, false, pixel );
+  else if ( id == sitkFloat32 || id == sitkVectorFloat32 ) ConstantToPixelBytes<float>( constant, n, false, pixel );
+  else if ( id == sitkFloat64 || id == sitkVectorFloat64 ) ConstantToPixelBytes<double>( constant, n, false, pixel );
+  else if ( id == sitkComplexFloat32 ) ConstantToPixelBytes<float>( constant, n, true, pixel );
+  else if ( id == sitkComplexFloat64 ) ConstantToPixelBytes<double>( constant, n, true, pixel );
+  else
+    {
+    sitkExceptionMacro( "Assignment is not supported for the pixel type " << image.GetPixelIDTypeAsString() << "." );
+    }
+  return pixel;
+}
+
+
+// Copy pixels into the strided region of the image, described by the
+// start index, the step and the number of pixels of each
+// dimension. The pixels are consecutive in the source buffer, or the
+// same pixel when sourceIncrement is zero. Each line of the region is
+// a single copy when the step of the first dimension is one.
+void StridedAssign( itk::simple::Image &image,
+                    const char *source,
+                    size_t sourceIncrement,
+                    const std::vector<int> &start,
+                    const std::vector<int> &step,
+                    const std::vector<unsigned int> &size )
+{
+  const unsigned int dimension = image.GetDimension();
+  if ( start.size() != dimension || step.size() != dimension || size.size() != dimension )
+    {
+    sitkExceptionMacro( "The strided region must have " << dimension << " dimensions." );
+    }
+
+  const std::vector<unsigned int> imageSize = image.GetSize();
+  for ( unsigned int d = 0; d < dimension; ++d )
+    {
+    if ( size[d] == 0 )
+      {
+      return;
+      }
+    const int64_t last = int64_t( start[d] ) + int64_t( step[d] ) * ( int64_t( size[d] ) - 1 );
+    if ( start[d] < 0 || int64_t( start[d] ) >= imageSize[d] || last < 0 || last >= imageSize[d] )
+      {
+      sitkExceptionMacro( "The strided region is outside the image in dimension " << d << "." );
+      }
+    }
+
+  char *buffer = static_cast<char *>( image.GetBufferAsVoid() );
+  const size_t pixelSize = image.GetSizeOfPixelComponent() * image.GetNumberOfComponentsPerPixel();
+
+  // the offset in bytes of a step of each dimension
+  std::vector<int64_t> increment( dimension );
+  int64_t stride = pixelSize;
+  int64_t offset = 0;
+  for ( unsigned int d = 0; d < dimension; ++d )
+    {
+    increment[d] = stride * step[d];
+    offset += stride * start[d];
+    stride *= imageSize[d];
+    }
+
+  const bool lineCopy = ( step[0] == 1 && sourceIncrement == pixelSize );
+  std::vector<unsigned int> position( dimension, 0 );
+  while ( true )
+    {
+    if ( lineCopy )
+      {
+      std::memcpy( buffer + offset, source, pixelSize * size[0] );
+      source += pixelSize * size[0];
+      }
+    else
+      {
+      for ( unsigned int i = 0; i < size[0]; ++i )
+        {
+        std::memcpy( buffer + offset + i * increment[0], source, pixelSize );
+        source += sourceIncrement;
+        }
+      }
+
+    unsigned int d = 1;
+    for ( ; d < dimension; ++d )
+      {
+      offset += increment[d];
+      if ( ++position[d] < size[d] )
+        {
+        break;
+        }
+      offset -= increment[d] * size[d];
+      position[d] = 0;
+      }
+    if ( d == dimension )
+      {
+      break;
+      }
+    }
+}
+
+}
+%}
+
 %pythoncode %{
    import operator
    import sys
@@ -188,6 +321,45 @@
         paster.SetDestinationSkipAxes(std::move(destinationSkipAxes));
         return (*$self) = paster.Execute(std::move(*$self), constant);
         }
+        // A wrapper for assigning to a strided region in place
+        Image __istrided_assign(const Image & sourceImage,
+                   std::vector< int > start,
+                   std::vector< int > step,
+                   std::vector< unsigned int > size)
+        {
+        if ( sourceImage.GetPixelID() != $self->GetPixelID() ||
+             sourceImage.GetNumberOfComponentsPerPixel() != $self->GetNumberOfComponentsPerPixel() )
+          {
+          sitkExceptionMacro( "The source image must have the pixel type " << $self->GetPixelIDTypeAsString() << "." );
+          }
+        uint64_t numberOfPixels = 1;
+        for ( unsigned int sz : size )
+          {
+          numberOfPixels *= sz;
+          }
+        if ( sourceImage.GetNumberOfPixels() != numberOfPixels )
+          {
+          sitkExceptionMacro( "The source image has " << sourceImage.GetNumberOfPixels()
+                              << " pixels, the strided region has "  << numberOfPixels << "." );
+          }
+
+        // holding a reference to the source makes the image copy its
+        // buffer before writing when the two share it
+        const itk::simple::Image source( sourceImage );
+        const char *buffer = static_cast<const char *>( source.GetBufferAsVoid() );
+        const size_t pixelSize = $self->GetSizeOfPixelComponent() * $self->GetNumberOfComponentsPerPixel();
+        StridedAssign( *$self, buffer, pixelSize, start, step, size );
+        return *$self;
+        }
+        Image __istrided_assign(double constant,
+                   std::vector< int > start,
+                   std::vector< int > step,
+                   std::vector< unsigned int > size)
+        {
+        const std::vector<char> pixel = ConstantToPixelBytes( *$self, constant );
+        StridedAssign( *$self, pixel.data(), 0, start, step, size );
+        return *$self;
+        }
         Image __imasked_assign(const Image &mask,  const Image &assign)
         {
           itk::simple::MaskedAssignImageFilter ma;
@@ -208,6 +380,46 @@
           """Create a SimpleITK shallow copy, where the internal image share is shared with copy on write implementation."""
           return Image(self)
 
+        def __dlpack__(self, stream=None, **kwargs):
+          """Export the image buffer with the DLPack protocol, without a copy.
+
+          The exported tensor has the axis order of GetArrayViewFromImage, and writes to it modify the image. The
+          buffer stays valid after the image is deleted. Modifying the image through SimpleITK while the tensor is
+          alive copies the buffer first, so the tensor no longer reflects the image.
+          """
+          from SimpleITK.extra import _GetWritableArrayViewFromImage
+          if stream is not None:
+            raise BufferError("SimpleITK images are in host memory, a stream is not supported.")
+          return _GetWritableArrayViewFromImage(self).__dlpack__(**kwargs)
+
+        def __dlpack_device__(self):
+          """The DLPack device of the image buffer, which is always the host memory."""
+          kDLCPU = 1
+          return (kDLCPU, 0)
+
+        @staticmethod
+        def from_dlpack(x, isVector=None, *, copy=None, reference=None, origin=None, spacing=None, direction=None):
+          """Create an image from an object supporting the DLPack protocol, such as a PyTorch or CuPy tensor.
+
+          The tensor must be in host memory. By default the image refers to the tensor's memory when it is C
+          contiguous, otherwise the pixels are copied, see GetImageFromDLPack for the copy argument. The DLPack protocol
+          has no physical information, so the origin, spacing and direction are copied from the reference image, or
+          set from the origin, spacing and direction arguments, which take precedence.
+          """
+          from SimpleITK.extra import GetImageFromDLPack
+          img = GetImageFromDLPack(x, isVector=isVector, copy=copy)
+          if reference is not None:
+            img.SetOrigin(reference.GetOrigin())
+            img.SetSpacing(reference.GetSpacing())
+            img.SetDirection(reference.GetDirection())
+          if origin is not None:
+            img.SetOrigin(origin)
+          if spacing is not None:
+            img.SetSpacing(spacing)
+          if direction is not None:
+            img.SetDirection(direction)
+          return img
+
         def __deepcopy__(self, memo):
           """Create a new copy of the data and image class."""
           dc = Image(self)
@@ -248,12 +460,43 @@
                 import pickle5 as pickle
               except ImportError:
                 raise ImportError("Pickle protocol 5 requires the pickle5 module for Python 3.6, 3.7")
-            P = (version, pickle.PickleBuffer(mv), origin, spacing, direction, metadata)
-          else:
-            P = (version, mv.tobytes(), origin, spacing, direction, metadata)
+
+            # the buffer of an array view holds the image, so it stays
+            # valid as an out-of-band buffer after the image is deleted
+            try:
+              from SimpleITK.extra import _GetWritableArrayViewFromImage
+              buffer = _GetWritableArrayViewFromImage(self)
+            except ImportError:
+              buffer = mv
+            return Image._FromPickleBuffer, (size, t, ncomponents, pickle.PickleBuffer(buffer),
+                                              origin, spacing, direction, metadata)
+
+          P = (version, mv.tobytes(), origin, spacing, direction, metadata)
 
           return self.__class__, (size, t, ncomponents), P
 
+        @staticmethod
+        def _FromPickleBuffer(size, t, ncomponents, buffer, origin, spacing, direction, metadata):
+          """Reconstruct an image pickled with protocol 5.
+
+          The image refers to the buffer without a copy when its pixel type and dimension can be imported, e.g. to an
+          out-of-band buffer or to the bytes of the pickle, and copies it before it is modified.
+          """
+          image = None
+          try:
+            image = _GetImageViewFromArray(buffer, t, size, ncomponents)
+          except (ValueError, RuntimeError):
+            pass
+          if image is None or image.GetPixelIDValue() != t:
+            image = Image(size, t, ncomponents)
+            _SetImageFromArray(buffer, image)
+          image.SetOrigin(origin)
+          image.SetSpacing(spacing)
+          image.SetDirection(direction)
+          for k,v in metadata.items():
+            image.SetMetaData(k,v)
+          return image
+
 
 
         # mathematical operators
@@ -636,6 +879,12 @@
               # extract each element of the indices rages together
               (start, stop, step) = zip(*sidx)
 
+              if not slice_dims and all( st == 1 for st in step ) and all( e > b for b, e in zip(start, stop) ) \
+                 and not self.GetPixelIDTypeAsString().startswith("label"):
+                # a unit step region can be extracted without the
+                # filter, referring to this image's buffer when possible
+                return self.GetSubImage(start, [ e - b for b, e in zip(start, stop) ])
+
               # run the slice filter
               img = Slice(self, start=start, stop=stop, step=step)
 
@@ -678,7 +927,12 @@
             the same pixel type and equal or lesser dimension than self. The
             region defined by idx and rvalue's size must be compatible. The
             region defined by idx will collapse one sized idx dimensions when it
-            does not match the rvalue image's size.
+            does not match the rvalue image's size. When a slice has a step other
+            than 1, the pixels are copied to the strided region directly in the
+            image's buffer.
+
+            If idx is a boolean numpy array with the shape of the array view of
+            the image, it is used as a mask in the same way as an image mask.
             """
 
             if isinstance(idx, str):
@@ -696,6 +950,13 @@
             if isinstance(idx, Image):
                return self.__imasked_assign(idx, rvalue)
 
+            if getattr(idx, "dtype", None) == bool and getattr(idx, "ndim", 0) == self.GetDimension():
+               # a boolean numpy array is a mask in the array's axis order
+               from SimpleITK.extra import GetImageFromArray
+               mask = GetImageFromArray(idx.astype("uint8"))
+               mask.CopyInformation(self)
+               return self.__imasked_assign(mask, rvalue)
+
             if sys.version_info[0] < 3:
               def isint( i ):
                 return type(i) == int or type(i) == long
@@ -751,16 +1012,12 @@
               sidx = [ idx[i].indices(size[i]) for i in range(len(idx ))]
 
               (start, stop, step) = zip(*sidx)
-              size = [ e-b for b, e in zip(start, stop) ]
+              size = [ len(range(b, e, st)) for b, e, st in sidx ]
               try:
                 sourceSize = rvalue.GetSize()
               except AttributeError:
                 sourceSize = size
 
-              for i in range(dim):
-                if step[i] != 1:
-                  raise IndexError("step {0} is not 1 for dimension {1}".format(step[i], i))
-
               skipAxes = [False] * dim
 
               s = 0;
@@ -774,6 +1031,12 @@
                   raise IndexError("cannot paste source with size {0} into destination with size {1}".format(size, sourceSize))
                 s += 1
 
+              if any( st != 1 for st in step ):
+                # copy to the strided region over the buffer
+                if min(size) == 0:
+                  return self
+                return self.__istrided_assign( rvalue, start, step, size)
+
               size = [ sz for sz,skip  in zip(size, skipAxes) if not skip ]
               return self.__ipaste( rvalue, size, [0]*len(size), start, skipAxes)
 
@@ -21,11 +21,28 @@
 #include <functional>
 
 #include "sitkImage.h"
+#include "sitkImportImageFilter.h"
 #include "sitkConditional.h"
 #include "sitkExceptionObject.h"
 
 namespace sitk = itk::simple;
 
+namespace
+{
+// Release the GIL for the lifetime of the object, also when an
+// exception is thrown, around the work which does not use Python.
+class PyAllowThreads
+{
+public:
+  PyAllowThreads() : m_State( PyEval_SaveThread() ) {}
+  ~PyAllowThreads() { PyEval_RestoreThread( m_State ); }
+  PyAllowThreads( const PyAllowThreads & ) = delete;
+  PyAllowThreads &operator=( const PyAllowThreads & ) = delete;
+private:
+  PyThreadState *m_State;
+};
+}
+
 // Python is written in C
 #ifdef __cplusplus
 extern "C"
@@ -69,7 +86,11 @@ sitk_GetMemoryViewFromImage( PyObject *SWIGUNUSEDPARM(self), PyObject *args )
     PyErr_SetString( PyExc_RuntimeError, "Unknown pixel type." );
     SWIG_fail;
     }
+  {
+  // making the buffer unique may copy the image
+  PyAllowThreads allowThreads;
   sitkBufferPtr = sitkImage->GetBufferAsVoid();
+  }
 
   len = size_t(sitkImage->GetNumberOfPixels()) * sitkImage->GetSizeOfPixelComponent();
   len *= sitkImage->GetNumberOfComponentsPerPixel();
@@ -139,6 +160,7 @@ sitk_SetImageFromArray( PyObject *SWIGUNUSEDPARM(self), PyObject *args )
       SWIG_fail;
       }
 
+    PyAllowThreads allowThreads;
     sitkBufferPtr = sitkImage->GetBufferAsVoid();
     }
   catch( const std::exception &e )
@@ -153,8 +175,14 @@ sitk_SetImageFromArray( PyObject *SWIGUNUSEDPARM(self), PyObject *args )
   len = size_t(sitkImage->GetNumberOfPixels()) * sitkImage->GetSizeOfPixelComponent();
   len *= sitkImage->GetNumberOfComponentsPerPixel();
 
+  if ( PyBuffer_IsContiguous( &pyBuffer, 'C' ) && static_cast<size_t>( pyBuffer.len ) == len )
+    {
+    // the copy of a contiguous buffer does not use Python
+    PyAllowThreads allowThreads;
+    memcpy( sitkBufferPtr, pyBuffer.buf, len );
+    }
   // checks len matches pyBuffer.len
-  if (PyBuffer_ToContiguous( sitkBufferPtr, &pyBuffer, len, 'C') != 0)
+  else if (PyBuffer_ToContiguous( sitkBufferPtr, &pyBuffer, len, 'C') != 0)
     {
     goto fail;
     }
@@ -168,6 +196,160 @@ fail:
   return NULL;
 }
 
+/** An internal function that returns a SimpleITK Image which refers
+ * to the buffer of a C contiguous object, such as a numpy array,
+ * without a copy. The image holds the buffer, and so a reference to
+ * the object, until it and its shallow copies are released, and it
+ * copies the buffer before it is modified.
+ */
+static PyObject*
+sitk_GetImageViewFromArray( PyObject *SWIGUNUSEDPARM(self), PyObject *args )
+{
+  PyObject * pyObj = NULL;
+  PyObject * pySize = NULL;
+  int pixelID = sitk::sitkUnknown;
+  unsigned int numberOfComponents = 1;
+
+  std::vector<unsigned int> size;
+  size_t len = 1;
+  Py_buffer * pyBuffer = NULL;
+
+  if (!PyArg_ParseTuple( args, "OiOI", &pyObj, &pixelID, &pySize, &numberOfComponents ))
+    {
+    return NULL;
+    }
+
+  {
+    PyObject * sequence = PySequence_Fast( pySize, "the size must be a sequence" );
+    if ( sequence == NULL )
+      {
+      return NULL;
+      }
+    for ( Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE( sequence ); ++i )
+      {
+      size.push_back( static_cast<unsigned int>( PyLong_AsUnsignedLong( PySequence_Fast_GET_ITEM( sequence, i ) ) ) );
+      len *= size.back();
+      }
+    Py_DECREF( sequence );
+    if ( PyErr_Occurred() )
+      {
+      return NULL;
+      }
+  }
+
+  // the buffer is released with the image, by the deleter
+  pyBuffer = new Py_buffer;
+  memset(pyBuffer, 0, sizeof(Py_buffer));
+  if (PyObject_GetBuffer(pyObj, pyBuffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+    {
+    delete pyBuffer;
+    return NULL;
+    }
+
+  {
+    auto deleter = [pyBuffer]( void * )
+      {
+        PyGILState_STATE gstate = PyGILState_Ensure();
+        PyBuffer_Release( pyBuffer );
+        PyGILState_Release( gstate );
+        delete pyBuffer;
+      };
+    bool released = false;
+
+    try
+      {
+      sitk::ImportImageFilter import;
+      import.SetSize( size );
+      import.SetSpacing( std::vector<double>( size.size(), 1.0 ) );
+      import.SetOrigin( std::vector<double>( size.size(), 0.0 ) );
+      import.CopyOnWriteOn();
+
+      void * buffer = pyBuffer->buf;
+      switch ( pixelID )
+        {
+        case sitk::sitkInt8:
+        case sitk::sitkVectorInt8:
+          len *= sizeof(int8_t);
+          import.SetBufferAsInt8( static_cast<int8_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkUInt8:
+        case sitk::sitkVectorUInt8:
+          len *= sizeof(uint8_t);
+          import.SetBufferAsUInt8( static_cast<uint8_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkInt16:
+        case sitk::sitkVectorInt16:
+          len *= sizeof(int16_t);
+          import.SetBufferAsInt16( static_cast<int16_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkUInt16:
+        case sitk::sitkVectorUInt16:
+          len *= sizeof(uint16_t);
+          import.SetBufferAsUInt16( static_cast<uint16_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkInt32:
+        case sitk::sitkVectorInt32:
+          len *= sizeof(int32_t);
+          import.SetBufferAsInt32( static_cast<int32_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkUInt32:
+        case sitk::sitkVectorUInt32:
+          len *= sizeof(uint32_t);
+          import.SetBufferAsUInt32( static_cast<uint32_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkInt64:
+        case sitk::sitkVectorInt64:
+          len *= sizeof(int64_t);
+          import.SetBufferAsInt64( static_cast<int64_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkUInt64:
+        case sitk::sitkVectorUInt64:
+          len *= sizeof(uint64_t);
+          import.SetBufferAsUInt64( static_cast<uint64_t*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkFloat32:
+        case sitk::sitkVectorFloat32:
+          len *= sizeof(float);
+          import.SetBufferAsFloat( static_cast<float*>( buffer ), deleter, numberOfComponents );
+          break;
+        case sitk::sitkFloat64:
+        case sitk::sitkVectorFloat64:
+          len *= sizeof(double);
+          import.SetBufferAsDouble( static_cast<double*>( buffer ), deleter, numberOfComponents );
+          break;
+        default:
+          PyBuffer_Release( pyBuffer );
+          delete pyBuffer;
+          PyErr_SetString( PyExc_ValueError, "The pixel type can not be imported without a copy." );
+          return NULL;
+        }
+      // the filter holds the buffer from here on
+      released = true;
+
+      if ( static_cast<Py_ssize_t>( len * numberOfComponents ) != pyBuffer->len )
+        {
+        PyErr_SetString( PyExc_ValueError, "The size of the buffer does not match the size of the image." );
+        return NULL;
+        }
+
+      sitk::Image * sitkImage = new sitk::Image( import.Execute() );
+      return SWIG_NewPointerObj( SWIG_as_voidptr( sitkImage ), SWIGTYPE_p_itk__simple__Image, SWIG_POINTER_OWN );
+      }
+    catch( const std::exception &e )
+      {
+      if ( !released )
+        {
+        PyBuffer_Release( pyBuffer );
+        delete pyBuffer;
+        }
+      std::string msg = "Exception thrown in SimpleITK image view: ";
+      msg += e.what();
+      PyErr_SetString( PyExc_RuntimeError, msg.c_str() );
+      return NULL;
+      }
+  }
+}
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
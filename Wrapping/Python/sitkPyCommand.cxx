@@ -104,6 +104,10 @@ void PyCommand::Execute()
     return;
     }
 
+  // the command is executed from the filter's thread, which does not
+  // hold the GIL
+  PyGILStateEnsure gil;
+
   // make sure that the CommandCallable is in fact callable
   if (!PyCallable_Check(this->m_Object))
     {
@@ -115,8 +119,6 @@ void PyCommand::Execute()
     }
   else
     {
-    PyGILStateEnsure gil;
-
     PyObject *result;
 
     result = PyObject_CallObject(this->m_Object, (PyObject *)NULL);
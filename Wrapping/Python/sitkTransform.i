@@ -48,10 +48,133 @@
   filename = str(filename)
 %}
 
+// The coordinate sequence versions are used by TransformPoints and
+// TransformVectors when the points are not a numpy array
+%rename(_TransformPoints) itk::simple::Transform::TransformPoints( const std::vector< double > & ) const;
+%rename(_TransformVectors) itk::simple::Transform::TransformVectors( const std::vector< double > &, const std::vector< double > & ) const;
+
 %extend itk::simple::Transform {
+ void _TransformToBuffer( PyObject *input, PyObject *points, PyObject *output )
+ {
+   // input is the vectors when points is not None, else the points
+   const bool vectors = ( points != Py_None );
+
+   Py_buffer inputView;
+   Py_buffer pointsView;
+   Py_buffer outputView;
+   bool hasInput = false;
+   bool hasPoints = false;
+   bool hasOutput = false;
+
+   // release the views with the GIL held, also when transforming throws
+   struct ReleaseViews
+   {
+     Py_buffer *views[3];
+     bool *has[3];
+     ~ReleaseViews()
+       {
+         SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+         for ( unsigned int i = 0; i < 3; ++i )
+           {
+           if ( *has[i] )
+             {
+             PyBuffer_Release( views[i] );
+             }
+           }
+         SWIG_PYTHON_THREAD_END_BLOCK;
+       }
+   } releaseViews{ { &inputView, &pointsView, &outputView }, { &hasInput, &hasPoints, &hasOutput } };
+
+   {
+   SWIG_PYTHON_THREAD_BEGIN_BLOCK;
+   hasInput = ( PyObject_GetBuffer( input, &inputView, PyBUF_CONTIG_RO ) == 0 );
+   if ( hasInput && vectors )
+     {
+     hasPoints = ( PyObject_GetBuffer( points, &pointsView, PyBUF_CONTIG_RO ) == 0 );
+     }
+   if ( hasInput && ( hasPoints || !vectors ) )
+     {
+     hasOutput = ( PyObject_GetBuffer( output, &outputView, PyBUF_CONTIG ) == 0 );
+     }
+   if ( !hasOutput )
+     {
+     PyErr_Clear();
+     }
+   SWIG_PYTHON_THREAD_END_BLOCK;
+   }
+   if ( !hasOutput )
+     {
+     throw std::invalid_argument( "The buffers must be contiguous arrays and the output writable." );
+     }
+
+   const size_t pointSize = sizeof( double ) * self->GetDimension();
+   if ( inputView.len % pointSize != 0
+        || outputView.len != inputView.len
+        || ( vectors && pointsView.len != inputView.len ) )
+     {
+     throw std::invalid_argument( "The buffers must have the same number of points of the dimension of the transform." );
+     }
+
+   const size_t numberOfPoints = static_cast<size_t>( inputView.len ) / pointSize;
+   if ( vectors )
+     {
+     self->TransformVectors( static_cast<const double *>( inputView.buf ),
+                             static_cast<const double *>( pointsView.buf ),
+                             static_cast<double *>( outputView.buf ),
+                             numberOfPoints );
+     }
+   else
+     {
+     self->TransformPoints( static_cast<const double *>( inputView.buf ),
+                            static_cast<double *>( outputView.buf ),
+                            numberOfPoints );
+     }
+ }
+
    %pythoncode
 %{
 
+        def _AsPointArray(self, points):
+          import numpy
+          points = numpy.ascontiguousarray(points, dtype=numpy.float64)
+          if points.ndim != 2 or points.shape[1] != self.GetDimension():
+            raise ValueError("Expected an array of shape (N, {0}).".format(self.GetDimension()))
+          return points
+
+        def TransformPoints(self, points):
+          """Apply the transform to many points.
+
+          When points is a numpy array of shape (N, D), the points are
+          transformed without copy if the array is contiguous float64,
+          and a numpy array of the transformed points is returned.
+          Otherwise points is a sequence of the N x D coordinates and a
+          tuple of the transformed coordinates is returned.
+          """
+          if hasattr(points, "__array_interface__"):
+            points = self._AsPointArray(points)
+            import numpy
+            output = numpy.empty_like(points)
+            self._TransformToBuffer(points, None, output)
+            return output
+          return self._TransformPoints(points)
+
+        def TransformVectors(self, vectors, points):
+          """Apply the transform to many vectors, each at a point.
+
+          The vectors and the points are numpy arrays of shape (N, D) or
+          sequences of coordinates, as with TransformPoints.
+          """
+          if hasattr(vectors, "__array_interface__") or hasattr(points, "__array_interface__"):
+            vectors = self._AsPointArray(vectors)
+            points = self._AsPointArray(points)
+            if vectors.shape != points.shape:
+              raise ValueError("Expected as many points as vectors.")
+            import numpy
+            output = numpy.empty_like(vectors)
+            self._TransformToBuffer(vectors, points, output)
+            return output
+          return self._TransformVectors(vectors, points)
+
         def __copy__(self):
           """Create a SimpleITK shallow copy, where the internal transform is shared with a copy on write implementation."""
           return self.__class__(self)
@@ -160,6 +160,7 @@ void delete_Transform_void(SEXP p)
 #endif
 
 SEXP ImAsArray(itk::simple::Image src);
+SEXP ImAsArrayView(itk::simple::Image src);
 itk::simple::Image ArrayAsIm(SEXP arr,
                              std::vector<unsigned int> size,
                              std::vector<double> spacing,
@@ -18,33 +18,77 @@
 
 
 #include <iostream>
+#include <cstring>
+#include <type_traits>
 
 #include <Rdefines.h>
 #include <Rversion.h>
+#if defined(R_VERSION) && R_VERSION >= R_Version(3, 6, 0)
+#  include <R_ext/Altrep.h>
+#  include <R_ext/Rdynload.h>
+#  define SITK_R_ALTREP
+#endif
 
 #include "sitkImage.h"
 #include "sitkConditional.h"
 #include "sitkImportImageFilter.h"
 
+namespace
+{
+
+// Copy the pixels of the buffer to the R vector. The components of
+// vector images are copied to consecutive planes, so the R array has
+// the component as the last axis. A buffer of the R type is a
+// single memcpy.
+template <typename TBuffer, typename TR>
+void CopyBufferToR( const TBuffer *buffer, TR *out, size_t numberOfPixels, unsigned int numberOfComponents )
+{
+  if ( numberOfComponents == 1 )
+    {
+    if ( std::is_same<TBuffer, TR>::value )
+      {
+      std::memcpy( out, buffer, numberOfPixels * sizeof( TR ) );
+      }
+    else
+      {
+      std::copy( buffer, buffer + numberOfPixels, out );
+      }
+    return;
+    }
+
+  for ( unsigned int c = 0; c < numberOfComponents; ++c )
+    {
+    TR *plane = out + c * numberOfPixels;
+    const TBuffer *in = buffer + c;
+    for ( size_t p = 0; p < numberOfPixels; ++p, in += numberOfComponents )
+      {
+      plane[p] = static_cast<TR>( *in );
+      }
+    }
+}
+
+}
+
 SEXP ImAsArray(itk::simple::Image src)
 {
-  // tricky to make this efficient with memory and fast.
-  // Ideally we want multithreaded casting directly to the
-  // R array. We could use a Cast filter and then a memory copy,
-  // obviously producing a redundant copy. If we do a direct cast,
-  // then we're probably not multi-threaded.
-  // Lets be slow but memory efficient.
+  // The pixels are copied once from the buffer to the R array,
+  // converting the type and moving the components of vector images to
+  // the last axis. The buffer is only read, so an image sharing it is
+  // not copied first.
+  const itk::simple::Image &constSrc = src;
 
   std::vector<unsigned int> sz = src.GetSize();
   itk::simple::PixelIDValueType  PID=src.GetPixelIDValue();
   SEXP res = 0;
   double *dans=0;
   int *ians=0;
-  unsigned pixcount=src.GetNumberOfComponentsPerPixel();
+  const unsigned int ncomp=src.GetNumberOfComponentsPerPixel();
+  size_t npix=1;
   for (unsigned k = 0; k < sz.size();k++)
     {
-    pixcount *= sz[k];
+    npix *= sz[k];
     }
+  const size_t pixcount=npix*ncomp;
   switch (PID)
     {
     case itk::simple::sitkUnknown:
@@ -90,72 +134,62 @@ SEXP ImAsArray(itk::simple::Image src)
     case itk::simple::ConditionalValue< itk::simple::sitkUInt8 != itk::simple::sitkUnknown, itk::simple::sitkUInt8, -2 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorUInt8 != itk::simple::sitkUnknown, itk::simple::sitkVectorUInt8, -14 >::Value:
     {
-    uint8_t * buff = src.GetBufferAsUInt8();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsUInt8(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkInt8 != itk::simple::sitkUnknown, itk::simple::sitkInt8, -3 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorInt8 != itk::simple::sitkUnknown, itk::simple::sitkVectorInt8, -15 >::Value:
     {
-    int8_t * buff = src.GetBufferAsInt8();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsInt8(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkUInt16 != itk::simple::sitkUnknown, itk::simple::sitkUInt16, -4 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorUInt16 != itk::simple::sitkUnknown, itk::simple::sitkVectorUInt16, -16 >::Value:
     {
-    uint16_t * buff = src.GetBufferAsUInt16();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsUInt16(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkInt16 != itk::simple::sitkUnknown, itk::simple::sitkInt16, -5 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorInt16 != itk::simple::sitkUnknown, itk::simple::sitkVectorInt16, -17 >::Value:
     {
-    int16_t * buff = src.GetBufferAsInt16();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsInt16(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkUInt32 != itk::simple::sitkUnknown, itk::simple::sitkUInt32, -6 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorUInt32 != itk::simple::sitkUnknown, itk::simple::sitkVectorUInt32, -18 >::Value:
     {
-    uint32_t * buff = src.GetBufferAsUInt32();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsUInt32(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkInt32 != itk::simple::sitkUnknown, itk::simple::sitkInt32, -7 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorInt32 != itk::simple::sitkUnknown, itk::simple::sitkVectorInt32, -19 >::Value:
     {
-    int32_t * buff = src.GetBufferAsInt32();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsInt32(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkUInt64 != itk::simple::sitkUnknown, itk::simple::sitkUInt64, -8 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorUInt64 != itk::simple::sitkUnknown, itk::simple::sitkVectorUInt64, -20 >::Value:
 
     {
-    uint64_t * buff = src.GetBufferAsUInt64();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsUInt64(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkInt64 != itk::simple::sitkUnknown, itk::simple::sitkInt64, -9 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorInt64 != itk::simple::sitkUnknown, itk::simple::sitkVectorInt64, -21 >::Value:
     {
-    int64_t * buff = src.GetBufferAsInt64();
-    std::copy(buff,buff + pixcount,ians);
+    CopyBufferToR(constSrc.GetBufferAsInt64(), ians, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkFloat32 != itk::simple::sitkUnknown, itk::simple::sitkFloat32, -10 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorFloat32 != itk::simple::sitkUnknown, itk::simple::sitkVectorFloat32, -22 >::Value:
     {
-    float * buff = src.GetBufferAsFloat();
-    std::copy(buff,buff + pixcount,dans);
+    CopyBufferToR(constSrc.GetBufferAsFloat(), dans, npix, ncomp);
     }
     break;
     case itk::simple::ConditionalValue< itk::simple::sitkFloat64 != itk::simple::sitkUnknown, itk::simple::sitkFloat64, -11 >::Value:
     case itk::simple::ConditionalValue< itk::simple::sitkVectorFloat64 != itk::simple::sitkUnknown, itk::simple::sitkVectorFloat64, -23 >::Value:
     {
-    double * buff = src.GetBufferAsDouble();
-    std::copy(buff,buff + pixcount,dans);
+    CopyBufferToR(constSrc.GetBufferAsDouble(), dans, npix, ncomp);
     }
     break;
     default:
@@ -167,6 +201,118 @@ SEXP ImAsArray(itk::simple::Image src)
   return(res);
 }
 
+#ifdef SITK_R_ALTREP
+namespace
+{
+
+// The ALTREP view refers to the buffer of a copy of the image, held
+// by an external pointer in data1, so the buffer lives as long as the
+// view and is not modified through SimpleITK, which copies it before
+// writing. When R asks for a writable pointer the pixels are copied
+// once to a standard vector in data2, which is used from then on.
+
+void *VectorDataptr( SEXP v )
+{
+  return TYPEOF( v ) == REALSXP ? static_cast<void *>( REAL( v ) ) : static_cast<void *>( INTEGER( v ) );
+}
+
+void FinalizeImageView( SEXP ptr )
+{
+  delete static_cast<itk::simple::Image *>( R_ExternalPtrAddr( ptr ) );
+  R_ClearExternalPtr( ptr );
+}
+
+const itk::simple::Image &ViewImage( SEXP x )
+{
+  return *static_cast<const itk::simple::Image *>( R_ExternalPtrAddr( R_altrep_data1( x ) ) );
+}
+
+R_xlen_t ImageViewLength( SEXP x )
+{
+  return static_cast<R_xlen_t>( ViewImage( x ).GetNumberOfPixels() );
+}
+
+const void *ImageViewDataptrOrNull( SEXP x )
+{
+  if ( R_altrep_data2( x ) != R_NilValue )
+    {
+    return VectorDataptr( R_altrep_data2( x ) );
+    }
+  return ViewImage( x ).GetBufferAsVoid();
+}
+
+void *ImageViewDataptr( SEXP x, Rboolean writeable )
+{
+  if ( writeable && R_altrep_data2( x ) == R_NilValue )
+    {
+    const R_xlen_t n = ImageViewLength( x );
+    SEXP copy = PROTECT( Rf_allocVector( TYPEOF( x ), n ) );
+    std::memcpy( VectorDataptr( copy ), ViewImage( x ).GetBufferAsVoid(), n * ( TYPEOF( x ) == REALSXP ? sizeof( double ) : sizeof( int ) ) );
+    R_set_altrep_data2( x, copy );
+    UNPROTECT( 1 );
+    }
+  return const_cast<void *>( ImageViewDataptrOrNull( x ) );
+}
+
+double ImageViewRealElt( SEXP x, R_xlen_t i )
+{
+  return static_cast<const double *>( ImageViewDataptrOrNull( x ) )[i];
+}
+
+int ImageViewIntegerElt( SEXP x, R_xlen_t i )
+{
+  return static_cast<const int *>( ImageViewDataptrOrNull( x ) )[i];
+}
+
+template <typename TClass>
+void SetImageViewMethods( TClass cls )
+{
+  R_set_altrep_Length_method( cls, ImageViewLength );
+  R_set_altvec_Dataptr_method( cls, ImageViewDataptr );
+  R_set_altvec_Dataptr_or_null_method( cls, ImageViewDataptrOrNull );
+}
+
+R_altrep_class_t ImageViewClass( SEXPTYPE type )
+{
+  static bool initialized = false;
+  static R_altrep_class_t realClass;
+  static R_altrep_class_t integerClass;
+  if ( !initialized )
+    {
+    DllInfo *dll = R_getDllInfo( "SimpleITK" );
+    realClass = R_make_altreal_class( "sitk_image_view_real", "SimpleITK", dll );
+    SetImageViewMethods( realClass );
+    R_set_altreal_Elt_method( realClass, ImageViewRealElt );
+    integerClass = R_make_altinteger_class( "sitk_image_view_integer", "SimpleITK", dll );
+    SetImageViewMethods( integerClass );
+    R_set_altinteger_Elt_method( integerClass, ImageViewIntegerElt );
+    initialized = true;
+    }
+  return type == REALSXP ? realClass : integerClass;
+}
+
+}
+#endif
+
+SEXP ImAsArrayView(itk::simple::Image src)
+{
+  // A view is possible when the buffer has the layout and type of an
+  // R vector, otherwise the pixels are copied.
+#ifdef SITK_R_ALTREP
+  const itk::simple::PixelIDValueType PID = src.GetPixelIDValue();
+  if ( PID == itk::simple::sitkFloat64 || ( PID == itk::simple::sitkInt32 && sizeof( int32_t ) == sizeof( int ) ) )
+    {
+    const SEXPTYPE type = ( PID == itk::simple::sitkFloat64 ) ? REALSXP : INTSXP;
+    SEXP ptr = PROTECT( R_MakeExternalPtr( new itk::simple::Image( src ), R_NilValue, R_NilValue ) );
+    R_RegisterCFinalizerEx( ptr, FinalizeImageView, TRUE );
+    SEXP res = R_new_altrep( ImageViewClass( type ), ptr, R_NilValue );
+    UNPROTECT( 1 );
+    return res;
+    }
+#endif
+  return ImAsArray( src );
+}
+
 itk::simple::Image ArrayAsIm(SEXP arr,
                              std::vector<unsigned int> size,
                              std::vector<double> spacing,